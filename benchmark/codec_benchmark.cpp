@@ -0,0 +1,158 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * Uvarint, multihash, CID and PeerId codecs, parsed from every identify, DHT
+ * and gossip message. Multiaddress and multibase are covered by their own
+ * benchmarks. Run on two revisions to compare implementations.
+ *
+ * Usage: codec_benchmark --benchmark_out=codec.json --benchmark_out_format=json
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <libp2p/multi/content_identifier_codec.hpp>
+#include <libp2p/multi/multihash.hpp>
+#include <libp2p/multi/uvarint.hpp>
+#include <libp2p/peer/peer_id.hpp>
+
+namespace libp2p::benchmarks {
+  using multi::ContentIdentifier;
+  using multi::ContentIdentifierCodec;
+  using multi::Multihash;
+  using multi::MultihashView;
+  using multi::UVarint;
+
+  /// Ed25519 key inlined into identity multihash
+  constexpr std::string_view kIdentityPeer =
+      "12D3KooWEgUjBV5FJAuBSoNMRYFRHjV7PjZwRQ7b43EKX9g7D6xV";
+  /// Sha256 multihash of RSA key
+  constexpr std::string_view kSha256Peer =
+      "QmcgpsyWgH8Y8ajJz1Cu72KnS5uo2Aa2LpzU7kinSupNKC";
+
+  Multihash sha256Multihash() {
+    Bytes hash(32);
+    for (size_t i = 0; i < hash.size(); ++i) {
+      hash[i] = static_cast<uint8_t>(i * 7);
+    }
+    return Multihash::create(multi::sha256, hash).value();
+  }
+
+  ContentIdentifier cidV1() {
+    return {ContentIdentifier::Version::V1,
+            multi::MulticodecType::Code::DAG_PB,
+            sha256Multihash()};
+  }
+
+  void uvarintEncode(benchmark::State &state) {
+    auto value = static_cast<uint64_t>(state.range(0));
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(UVarint{value});
+    }
+  }
+
+  void uvarintDecode(benchmark::State &state) {
+    UVarint varint{static_cast<uint64_t>(state.range(0))};
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(UVarint::decode(varint.toBytes()));
+    }
+  }
+
+  void varints(benchmark::internal::Benchmark *b) {
+    b->Arg(1)->Arg(300)->Arg(1 << 20)->Arg(int64_t{1} << 62);
+  }
+
+  BENCHMARK(uvarintEncode)->Apply(varints);
+  BENCHMARK(uvarintDecode)->Apply(varints);
+
+  void multihashCreate(benchmark::State &state) {
+    auto bytes = sha256Multihash().toBuffer();
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(Multihash::createFromBytes(bytes));
+    }
+  }
+
+  void multihashView(benchmark::State &state) {
+    auto bytes = sha256Multihash().toBuffer();
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(MultihashView::create(bytes));
+    }
+  }
+
+  BENCHMARK(multihashCreate);
+  BENCHMARK(multihashView);
+
+  void cidEncode(benchmark::State &state) {
+    auto cid = cidV1();
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(ContentIdentifierCodec::encode(cid));
+    }
+  }
+
+  void cidDecode(benchmark::State &state) {
+    auto bytes = ContentIdentifierCodec::encode(cidV1()).value();
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(ContentIdentifierCodec::decode(bytes));
+    }
+  }
+
+  void cidDecodeView(benchmark::State &state) {
+    auto bytes = ContentIdentifierCodec::encode(cidV1()).value();
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(ContentIdentifierCodec::decodeView(bytes));
+    }
+  }
+
+  void cidToString(benchmark::State &state) {
+    auto cid = cidV1();
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(ContentIdentifierCodec::toString(cid));
+    }
+  }
+
+  void cidFromString(benchmark::State &state) {
+    auto str = ContentIdentifierCodec::toString(cidV1()).value();
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(ContentIdentifierCodec::fromString(str));
+    }
+  }
+
+  BENCHMARK(cidEncode);
+  BENCHMARK(cidDecode);
+  BENCHMARK(cidDecodeView);
+  BENCHMARK(cidToString);
+  BENCHMARK(cidFromString);
+
+  void peerIdFromBytes(benchmark::State &state, std::string_view base58) {
+    auto bytes = peer::PeerId::fromBase58(base58).value().toVector();
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(peer::PeerId::fromBytes(bytes));
+    }
+  }
+
+  void peerIdFromBase58(benchmark::State &state, std::string_view base58) {
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(peer::PeerId::fromBase58(base58));
+    }
+  }
+
+  void peerIdToBase58(benchmark::State &state, std::string_view base58) {
+    auto peer_id = peer::PeerId::fromBase58(base58).value();
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(peer_id.toBase58());
+    }
+  }
+
+#define PEER_ID_BENCHMARK(f)                     \
+  BENCHMARK_CAPTURE(f, Identity, kIdentityPeer); \
+  BENCHMARK_CAPTURE(f, Sha256, kSha256Peer)
+
+  PEER_ID_BENCHMARK(peerIdFromBytes);
+  PEER_ID_BENCHMARK(peerIdFromBase58);
+  PEER_ID_BENCHMARK(peerIdToBase58);
+}  // namespace libp2p::benchmarks
+
+BENCHMARK_MAIN();
@@ -0,0 +1,289 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * Throughput and latency of the connection pipeline over loopback TCP:
+ * raw TcpConnection, then host streams over Plaintext or Noise with Yamux or
+ * Mplex. Every iteration each of N concurrent streams sends one message and
+ * waits for its echo. Reports bytes/s and messages/s of one direction, and
+ * round trip percentiles as p50_us and p99_us counters.
+ *
+ * Usage: connection_benchmark --benchmark_filter=Noise
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <tuple>
+
+#include <benchmark/benchmark.h>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/di/extension/scopes/shared.hpp>
+
+#include <libp2p/basic/read_return_size.hpp>
+#include <libp2p/basic/readwriter.hpp>
+#include <libp2p/basic/write_return_size.hpp>
+#include <libp2p/injector/host_injector.hpp>
+#include <libp2p/log/configurator.hpp>
+#include <libp2p/log/logger.hpp>
+#include <libp2p/muxer/mplex.hpp>
+#include <libp2p/muxer/yamux.hpp>
+#include <libp2p/security/noise.hpp>
+#include <libp2p/security/plaintext.hpp>
+#include <libp2p/transport/tcp/tcp_connection.hpp>
+
+namespace libp2p::benchmarks {
+  using Clock = std::chrono::steady_clock;
+
+  const peer::ProtocolName kProtocol = "/benchmark/echo/1.0.0";
+
+  /// Listen ports are not reused, closed sockets may linger in TIME_WAIT
+  uint16_t nextPort() {
+    static std::atomic<uint16_t> port{41000};
+    return port++;
+  }
+
+  void runUntil(boost::asio::io_context &io, const std::function<bool()> &done) {
+    io.restart();
+    while (not done()) {
+      if (io.run_one() == 0) {
+        throw std::runtime_error{"io_context ran out of work"};
+      }
+    }
+  }
+
+  /// Reads whole messages and writes them back until error
+  template <typename Connection>
+  void echo(std::shared_ptr<Connection> conn, std::shared_ptr<Bytes> buf) {
+    readReturnSize(conn, *buf, [conn, buf](outcome::result<size_t> r) {
+      if (not r) {
+        return;
+      }
+      writeReturnSize(conn, *buf, [conn, buf](outcome::result<size_t> r) {
+        if (not r) {
+          return;
+        }
+        echo(conn, buf);
+      });
+    });
+  }
+
+  /// Client side of one stream, makes one round trip per ping()
+  struct Pinger {
+    std::shared_ptr<basic::ReadWriter> conn;
+    Bytes out;
+    Bytes in;
+    Clock::time_point started;
+
+    void ping(size_t &pending, std::vector<double> &samples) {
+      started = Clock::now();
+      writeReturnSize(conn, out, [this, &pending, &samples](auto r) {
+        if (not r) {
+          throw std::runtime_error{r.error().message()};
+        }
+        readReturnSize(conn, in, [this, &pending, &samples](auto r) {
+          if (not r) {
+            throw std::runtime_error{r.error().message()};
+          }
+          samples.push_back(
+              std::chrono::duration<double, std::micro>(Clock::now() - started)
+                  .count());
+          --pending;
+        });
+      });
+    }
+  };
+
+  double percentile(std::vector<double> &samples, double p) {
+    if (samples.empty()) {
+      return 0;
+    }
+    auto n = static_cast<size_t>(p * static_cast<double>(samples.size() - 1));
+    std::nth_element(samples.begin(), samples.begin() + n, samples.end());
+    return samples[n];
+  }
+
+  void runRounds(benchmark::State &state,
+                 boost::asio::io_context &io,
+                 std::vector<Pinger> &pingers) {
+    auto payload = static_cast<size_t>(state.range(0));
+    std::vector<double> samples;
+    for (auto _ : state) {
+      size_t pending = pingers.size();
+      for (auto &pinger : pingers) {
+        pinger.ping(pending, samples);
+      }
+      runUntil(io, [&] { return pending == 0; });
+    }
+    auto messages = static_cast<int64_t>(state.iterations() * pingers.size());
+    state.SetItemsProcessed(messages);
+    state.SetBytesProcessed(messages * static_cast<int64_t>(payload));
+    state.counters["p50_us"] = percentile(samples, 0.5);
+    state.counters["p99_us"] = percentile(samples, 0.99);
+  }
+
+  void rawTcp(benchmark::State &state) {
+    using Tcp = boost::asio::ip::tcp;
+    auto payload = static_cast<size_t>(state.range(0));
+    boost::asio::io_context io;
+
+    Tcp::acceptor acceptor{io, {boost::asio::ip::make_address("127.0.0.1"), 0}};
+    Tcp::socket client_socket{io};
+    client_socket.connect(acceptor.local_endpoint());
+    auto server_socket = acceptor.accept();
+    client_socket.set_option(Tcp::no_delay{true});
+    server_socket.set_option(Tcp::no_delay{true});
+
+    auto layers = multi::Multiaddress::create("/ip4/127.0.0.1/tcp/0")
+                      .value()
+                      .getProtocolsWithValues();
+    auto server = std::make_shared<transport::TcpConnection>(
+        layers, std::move(server_socket));
+    echo(server, std::make_shared<Bytes>(payload));
+
+    auto client = std::make_shared<transport::TcpConnection>(
+        layers, std::move(client_socket));
+    std::vector<Pinger> pingers(1);
+    pingers[0].conn = client;
+    pingers[0].out.resize(payload, 0x42);
+    pingers[0].in.resize(payload);
+
+    runRounds(state, io, pingers);
+
+    std::ignore = client->close();
+    std::ignore = server->close();
+    io.restart();
+    io.poll();
+  }
+
+  template <typename Security, typename Muxer>
+  std::shared_ptr<Host> makeHost(std::shared_ptr<boost::asio::io_context> io) {
+    muxer::MuxedConnectionConfig muxer_config;
+    // leave room for streams opened by host protocols
+    muxer_config.maximum_streams = 2000;
+    auto injector =
+        injector::makeHostInjector<boost::di::extension::shared_config>(
+            boost::di::bind<boost::asio::io_context>.to(
+                io)[boost::di::override],
+            boost::di::bind<muxer::MuxedConnectionConfig>.to(
+                muxer_config)[boost::di::override],
+            boost::di::bind<muxer::MuxerAdaptor *[]>()
+                .template to<Muxer>()[boost::di::override],
+            injector::useSecurityAdaptors<Security>());
+    return injector.template create<std::shared_ptr<Host>>();
+  }
+
+  template <typename Security, typename Muxer>
+  void hostStreams(benchmark::State &state) {
+    auto payload = static_cast<size_t>(state.range(0));
+    auto streams = static_cast<size_t>(state.range(1));
+    auto io = std::make_shared<boost::asio::io_context>();
+
+    auto server = makeHost<Security, Muxer>(io);
+    auto client = makeHost<Security, Muxer>(io);
+    server->setProtocolHandler({kProtocol}, [payload](StreamAndProtocol s) {
+      echo(std::move(s.stream), std::make_shared<Bytes>(payload));
+    });
+    auto listen_to = multi::Multiaddress::create(
+                         fmt::format("/ip4/127.0.0.1/tcp/{}", nextPort()))
+                         .value();
+    if (auto r = server->listen(listen_to); not r) {
+      state.SkipWithError(r.error().message().c_str());
+      return;
+    }
+    server->start();
+    client->start();
+
+    std::vector<Pinger> pingers(streams);
+    size_t opened = 0;
+    std::optional<std::error_code> error;
+    peer::PeerInfo server_info{server->getId(), {listen_to}};
+    // first stream establishes the connection, others reuse it
+    auto open = [&](size_t i) {
+      client->newStream(server_info, {kProtocol}, [&, i](auto r) {
+        if (not r) {
+          error = r.error();
+          return;
+        }
+        pingers[i].conn = std::move(r.value().stream);
+        pingers[i].out.resize(payload, 0x42);
+        pingers[i].in.resize(payload);
+        ++opened;
+      });
+    };
+    open(0);
+    runUntil(*io, [&] { return opened == 1 or error; });
+    for (size_t i = 1; i < streams; ++i) {
+      open(i);
+    }
+    runUntil(*io, [&] { return opened == streams or error; });
+    if (error) {
+      state.SkipWithError(error->message().c_str());
+      return;
+    }
+
+    runRounds(state, *io, pingers);
+
+    client->getNetwork().getConnectionManager().closeConnectionsToPeer(
+        server->getId());
+    client->stop();
+    server->stop();
+    io->restart();
+    io->poll();
+  }
+
+  void payloads(benchmark::internal::Benchmark *b) {
+    b->ArgNames({"payload"})->Arg(64)->Arg(1024)->Arg(64 * 1024);
+  }
+
+  void payloadsAndStreams(benchmark::internal::Benchmark *b) {
+    b->ArgNames({"payload", "streams"})
+        ->ArgsProduct({{64, 1024, 64 * 1024}, {1, 100, 1000}});
+  }
+
+  void prepareLoggers() {
+    auto logging_system = std::make_shared<soralog::LoggingSystem>(
+        std::make_shared<log::Configurator>());
+    auto r = logging_system->configure();
+    if (r.has_error) {
+      std::cerr << r.message << std::endl;
+    }
+    log::setLoggingSystem(logging_system);
+    log::setLevelOfGroup(log::defaultGroupName, soralog::Level::ERROR);
+  }
+}  // namespace libp2p::benchmarks
+
+namespace bm = libp2p::benchmarks;
+using libp2p::muxer::Mplex;
+using libp2p::muxer::Yamux;
+using libp2p::security::Noise;
+using libp2p::security::Plaintext;
+
+BENCHMARK(bm::rawTcp)->Name("Tcp")->Apply(bm::payloads);
+BENCHMARK(bm::hostStreams<Plaintext, Yamux>)
+    ->Name("Tcp+Plaintext+Yamux")
+    ->Apply(bm::payloadsAndStreams);
+BENCHMARK(bm::hostStreams<Plaintext, Mplex>)
+    ->Name("Tcp+Plaintext+Mplex")
+    ->Apply(bm::payloadsAndStreams);
+BENCHMARK(bm::hostStreams<Noise, Yamux>)
+    ->Name("Tcp+Noise+Yamux")
+    ->Apply(bm::payloadsAndStreams);
+BENCHMARK(bm::hostStreams<Noise, Mplex>)
+    ->Name("Tcp+Noise+Mplex")
+    ->Apply(bm::payloadsAndStreams);
+
+int main(int argc, char **argv) {
+  bm::prepareLoggers();
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return 0;
+}
@@ -0,0 +1,74 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * Signing and verification by CryptoProviderImpl for each key type, as done
+ * by identify, gossip and handshakes. Message size is of typical signed
+ * handshake payload and gossip message.
+ *
+ * Usage: crypto_benchmark --benchmark_filter=Ed25519
+ *   --benchmark_out=crypto.json --benchmark_out_format=json
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <libp2p/crypto/crypto_provider/crypto_provider_impl.hpp>
+#include <libp2p/crypto/ecdsa_provider/ecdsa_provider_impl.hpp>
+#include <libp2p/crypto/ed25519_provider/ed25519_provider_impl.hpp>
+#include <libp2p/crypto/hmac_provider/hmac_provider_impl.hpp>
+#include <libp2p/crypto/random_generator/boost_generator.hpp>
+#include <libp2p/crypto/rsa_provider/rsa_provider_impl.hpp>
+#include <libp2p/crypto/secp256k1_provider/secp256k1_provider_impl.hpp>
+
+namespace libp2p::benchmarks {
+  using crypto::Key;
+
+  const crypto::CryptoProvider &provider() {
+    static auto random =
+        std::make_shared<crypto::random::BoostRandomGenerator>();
+    static crypto::CryptoProviderImpl provider{
+        random,
+        std::make_shared<crypto::ed25519::Ed25519ProviderImpl>(),
+        std::make_shared<crypto::rsa::RsaProviderImpl>(),
+        std::make_shared<crypto::ecdsa::EcdsaProviderImpl>(),
+        std::make_shared<crypto::secp256k1::Secp256k1ProviderImpl>(random),
+        std::make_shared<crypto::hmac::HmacProviderImpl>()};
+    return provider;
+  }
+
+  void sign(benchmark::State &state, Key::Type type) {
+    auto keys = provider().generateKeys(type).value();
+    Bytes message(state.range(0), 0x42);
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(provider().sign(message, keys.privateKey));
+    }
+  }
+
+  void verify(benchmark::State &state, Key::Type type) {
+    auto keys = provider().generateKeys(type).value();
+    Bytes message(state.range(0), 0x42);
+    auto signature = provider().sign(message, keys.privateKey).value();
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(
+          provider().verify(message, signature, keys.publicKey));
+    }
+  }
+
+  void sizes(benchmark::internal::Benchmark *b) {
+    b->Arg(64)->Arg(1024);
+  }
+
+#define CRYPTO_BENCHMARK(f)                                            \
+  BENCHMARK_CAPTURE(f, Ed25519, Key::Type::Ed25519)->Apply(sizes);     \
+  BENCHMARK_CAPTURE(f, Secp256k1, Key::Type::Secp256k1)->Apply(sizes); \
+  BENCHMARK_CAPTURE(f, Ecdsa, Key::Type::ECDSA)->Apply(sizes);         \
+  BENCHMARK_CAPTURE(f, Rsa, Key::Type::RSA)->Apply(sizes)
+
+  CRYPTO_BENCHMARK(sign);
+  CRYPTO_BENCHMARK(verify);
+}  // namespace libp2p::benchmarks
+
+BENCHMARK_MAIN();
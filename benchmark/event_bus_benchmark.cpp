@@ -0,0 +1,52 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * Cost of publishing an event to a channel of the event bus with a varying
+ * number of subscribers, and of subscribing and unsubscribing. Run on two
+ * revisions to compare implementations.
+ *
+ * Usage: event_bus_benchmark --benchmark_filter=Publish
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <libp2p/event/bus.hpp>
+
+namespace libp2p::benchmarks {
+  using PeerChannel = event::channel_decl<struct PeerEvent, std::string>;
+
+  void publish(benchmark::State &state) {
+    event::Bus bus;
+    auto &channel = bus.getChannel<PeerChannel>();
+    size_t calls = 0;
+    std::vector<event::Handle> handles;
+    for (int64_t i = 0; i < state.range(0); ++i) {
+      handles.emplace_back(
+          channel.subscribe([&calls](const std::string &) { ++calls; }));
+    }
+    std::string peer(38, 'x');
+    for (auto _ : state) {
+      channel.publish(peer);
+    }
+    benchmark::DoNotOptimize(calls);
+    state.SetItemsProcessed(state.iterations());
+  }
+
+  void subscribe(benchmark::State &state) {
+    event::Bus bus;
+    auto &channel = bus.getChannel<PeerChannel>();
+    for (auto _ : state) {
+      auto handle = channel.subscribe([](const std::string &) {});
+      benchmark::DoNotOptimize(handle);
+    }
+  }
+
+  BENCHMARK(publish)->Arg(0)->Arg(1)->Arg(4)->Arg(16);
+  BENCHMARK(subscribe);
+}  // namespace libp2p::benchmarks
+
+BENCHMARK_MAIN();
@@ -0,0 +1,214 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * Gossip propagation at scale: N gossip instances in one process, all
+ * subscribed to one topic, connected by simulated streams with configurable
+ * latency and loss. Time is virtual, so heartbeats cost only their CPU work.
+ *
+ * Each node bootstraps with a few random peers, meshes settle during warmup.
+ * Every iteration publishes one message from a random node and waits until
+ * all others receive it or kDeliveryTimeout passes. Reports delivery time
+ * percentiles over all receivers as p50_ms and p99_ms, share of receivers
+ * reached, duplicates received per node per message and bytes sent per node
+ * per message, heartbeat traffic included.
+ *
+ * Arguments: nodes, latency_ms, loss_permille, D_min, D_max,
+ * heartbeat_interval_msec. Edit configs() to try other values.
+ *
+ * Usage: gossip_simulation --benchmark_filter=nodes:1000
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <libp2p/common/metrics/registry.hpp>
+#include <libp2p/protocol/gossip/gossip.hpp>
+
+#include "simulation.hpp"
+
+namespace libp2p::benchmarks {
+  using namespace std::chrono_literals;
+  namespace gossip = protocol::gossip;
+
+  const gossip::TopicId kTopic = "simulation";
+
+  /// Bootstrap peers of each node
+  constexpr size_t kSeeds = 12;
+
+  /// Virtual time for meshes to settle, in heartbeats
+  constexpr size_t kWarmupHeartbeats = 30;
+
+  /// Receivers not reached by then are counted as missed
+  constexpr auto kDeliveryTimeout = 30s;
+
+  /// Published data, starts with index of message
+  constexpr size_t kPayloadSize = 256;
+
+  struct SimNode {
+    std::shared_ptr<SimHost> host;
+    std::shared_ptr<gossip::Gossip> gossip;
+    protocol::Subscription subscription;
+  };
+
+  /// Publish time of every message and delivery time samples
+  struct Deliveries {
+    std::vector<std::chrono::milliseconds> published;
+    std::vector<double> latencies;
+    /// Receivers of the last message yet to get it
+    size_t pending = 0;
+  };
+
+  uint64_t duplicates() {
+    // the same counter gossip instances increment
+    return metrics::Registry::instance()
+        .counter("libp2p_gossip_duplicate_messages_total",
+                 "Gossip messages received again")
+        .value();
+  }
+
+  void gossipPropagation(benchmark::State &state) {
+    auto nodes_count = static_cast<size_t>(state.range(0));
+    gossip::Config config;
+    config.D_min = static_cast<size_t>(state.range(3));
+    config.D_max = static_cast<size_t>(state.range(4));
+    config.heartbeat_interval_msec = std::chrono::milliseconds{state.range(5)};
+
+    auto network = std::make_shared<SimNetwork>(
+        LinkModel{
+            .latency = std::chrono::milliseconds{state.range(1)},
+            .loss = static_cast<double>(state.range(2)) / 1000,
+        },
+        static_cast<std::mt19937::result_type>(nodes_count));
+    auto &backend = network->backend();
+    auto &rng = network->rng();
+    auto deliveries = std::make_shared<Deliveries>();
+
+    auto memory_before = residentBytes();
+    std::vector<SimNode> nodes;
+    nodes.reserve(nodes_count);
+    for (size_t i = 0; i < nodes_count; ++i) {
+      auto info = nodeInfo(i);
+      auto host = std::make_shared<SimHost>(network, info, makePeerRepository());
+      // messages are not signed, so crypto is not needed
+      auto node = gossip::create(network->scheduler(),
+                                 host,
+                                 std::make_shared<SimIdentityManager>(info.id),
+                                 nullptr,
+                                 nullptr,
+                                 config);
+      nodes.push_back({std::move(host), std::move(node), {}});
+    }
+    std::uniform_int_distribution<size_t> random_node{0, nodes_count - 1};
+    for (auto &node : nodes) {
+      for (size_t i = 0; i < kSeeds; ++i) {
+        auto peer = nodes[random_node(rng)].host->getPeerInfo();
+        node.gossip->addBootstrapPeer(peer.id, peer.addresses.front());
+      }
+      node.gossip->start();
+      node.subscription = node.gossip->subscribe(
+          {kTopic},
+          [&backend, deliveries](gossip::Gossip::SubscriptionData data) {
+            if (not data or data->data.size() < sizeof(uint64_t)) {
+              return;
+            }
+            uint64_t index = 0;
+            std::copy_n(data->data.begin(),
+                        sizeof(index),
+                        reinterpret_cast<uint8_t *>(&index));
+            if (index >= deliveries->published.size()) {
+              return;
+            }
+            auto latency = backend.now() - deliveries->published[index];
+            deliveries->latencies.push_back(
+                static_cast<double>(latency.count()));
+            // late deliveries of previous messages are sampled only
+            if (index + 1 == deliveries->published.size()) {
+              --deliveries->pending;
+            }
+          });
+    }
+    backend.shift(config.heartbeat_interval_msec * kWarmupHeartbeats);
+    auto memory_after = residentBytes();
+
+    auto before = network->counters();
+    auto duplicates_before = duplicates();
+    for (auto _ : state) {
+      uint64_t index = deliveries->published.size();
+      Bytes data(kPayloadSize);
+      std::copy_n(reinterpret_cast<const uint8_t *>(&index),
+                  sizeof(index),
+                  data.begin());
+      deliveries->published.push_back(backend.now());
+      deliveries->pending = nodes_count - 1;
+      nodes[random_node(rng)].gossip->publish(kTopic, std::move(data));
+      auto deadline = backend.now() + kDeliveryTimeout;
+      while (deliveries->pending != 0 and backend.now() < deadline
+             and not backend.empty()) {
+        backend.shiftToTimer();
+      }
+    }
+    auto messages = static_cast<double>(state.iterations());
+    auto receivers = messages * static_cast<double>(nodes_count - 1);
+    auto per_node_message = messages * static_cast<double>(nodes_count);
+
+    state.counters["delivered"] =
+        static_cast<double>(deliveries->latencies.size()) / receivers;
+    state.counters["p50_ms"] = percentile(deliveries->latencies, 0.5);
+    state.counters["p99_ms"] = percentile(deliveries->latencies, 0.99);
+    state.counters["duplicates"] =
+        static_cast<double>(duplicates() - duplicates_before)
+        / per_node_message;
+    state.counters["bytes_per_node"] =
+        static_cast<double>(network->counters().bytes - before.bytes)
+        / per_node_message;
+    state.counters["kb_per_node"] =
+        static_cast<double>(memory_after - std::min(memory_before, memory_after))
+        / 1024 / static_cast<double>(nodes_count);
+
+    for (auto &node : nodes) {
+      node.subscription.cancel();
+      node.gossip->stop();
+    }
+    nodes.clear();
+    backend.shift(config.rw_timeout_msec);
+  }
+
+  /// {nodes, latency_ms, loss_permille, D_min, D_max, heartbeat_ms}
+  void configs(benchmark::internal::Benchmark *b) {
+    b->ArgNames({"nodes",
+                 "latency_ms",
+                 "loss_permille",
+                 "D_min",
+                 "D_max",
+                 "heartbeat_ms"});
+    for (int64_t nodes : {100, 1000}) {
+      b->Args({nodes, 50, 0, 5, 10, 1000});
+      b->Args({nodes, 50, 50, 5, 10, 1000});
+      b->Args({nodes, 50, 0, 3, 6, 1000});
+      b->Args({nodes, 50, 0, 8, 12, 1000});
+      b->Args({nodes, 50, 0, 5, 10, 700});
+    }
+  }
+}  // namespace libp2p::benchmarks
+
+namespace bm = libp2p::benchmarks;
+
+BENCHMARK(bm::gossipPropagation)
+    ->Name("Gossip")
+    ->Apply(bm::configs)
+    ->Iterations(200)
+    ->Unit(benchmark::kMicrosecond);
+
+int main(int argc, char **argv) {
+  bm::prepareLoggers();
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return 0;
+}
@@ -0,0 +1,345 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * Security handshakes between two peers over in-memory pipes, which deliver
+ * data through io_context, so only CPU work and scheduling is measured.
+ * Every iteration runs N concurrent Noise or TLS handshakes and waits for all
+ * of them. Reports handshakes/s as items_per_second, share of failed ones,
+ * and mean time per handshake end of each phase in microseconds, taken from
+ * the histograms handshakes export:
+ * Noise - dh_us, signature_us, marshal_us, io_us;
+ * TLS - ssl_us (key exchange and I/O inside SSL), signature_us, marshal_us.
+ *
+ * Arguments: concurrency and key_pool size for Noise, concurrency and
+ * session resumption for TLS.
+ *
+ * Usage: handshake_benchmark --benchmark_filter=Noise
+ */
+
+#include <deque>
+#include <iostream>
+#include <map>
+#include <optional>
+
+#include <benchmark/benchmark.h>
+#include <boost/asio/post.hpp>
+#include <boost/di/extension/scopes/shared.hpp>
+
+#include <libp2p/common/metrics/registry.hpp>
+#include <libp2p/injector/network_injector.hpp>
+#include <libp2p/log/configurator.hpp>
+#include <libp2p/log/logger.hpp>
+#include <libp2p/security/noise.hpp>
+#include <libp2p/security/tls.hpp>
+
+namespace libp2p::benchmarks {
+
+  /// One end of an in-memory byte pipe
+  class Pipe : public connection::LayerConnection,
+               public std::enable_shared_from_this<Pipe> {
+   public:
+    Pipe(std::shared_ptr<boost::asio::io_context> io, bool initiator)
+        : io_{std::move(io)}, initiator_{initiator} {}
+
+    static std::pair<std::shared_ptr<Pipe>, std::shared_ptr<Pipe>> makePair(
+        const std::shared_ptr<boost::asio::io_context> &io) {
+      auto dialer = std::make_shared<Pipe>(io, true);
+      auto listener = std::make_shared<Pipe>(io, false);
+      dialer->remote_ = listener;
+      listener->remote_ = dialer;
+      return {dialer, listener};
+    }
+
+    void read(BytesOut out, size_t bytes, ReadCallbackFunc cb) override {
+      startRead(out, bytes, true, std::move(cb));
+    }
+
+    void readSome(BytesOut out, size_t bytes, ReadCallbackFunc cb) override {
+      startRead(out, bytes, false, std::move(cb));
+    }
+
+    void deferReadCallback(outcome::result<size_t> res,
+                           ReadCallbackFunc cb) override {
+      boost::asio::post(*io_, [res, cb{std::move(cb)}] { cb(res); });
+    }
+
+    void writeSome(BytesIn in, size_t bytes, WriteCallbackFunc cb) override {
+      auto remote = remote_.lock();
+      if (closed_ or not remote) {
+        return deferWriteCallback(Error::CONNECTION_CLOSED_BY_PEER,
+                                  std::move(cb));
+      }
+      remote->buffer_.insert(
+          remote->buffer_.end(), in.begin(), in.begin() + bytes);
+      boost::asio::post(*io_, [remote] { remote->deliver(); });
+      boost::asio::post(*io_, [bytes, cb{std::move(cb)}] { cb(bytes); });
+    }
+
+    void deferWriteCallback(std::error_code ec,
+                            WriteCallbackFunc cb) override {
+      deferReadCallback(ec, std::move(cb));
+    }
+
+    bool isClosed() const override {
+      return closed_;
+    }
+
+    outcome::result<void> close() override {
+      closed_ = true;
+      if (auto remote = remote_.lock()) {
+        remote->closed_ = true;
+        boost::asio::post(*io_, [remote] { remote->deliver(); });
+      }
+      boost::asio::post(*io_, [self{shared_from_this()}] { self->deliver(); });
+      return outcome::success();
+    }
+
+    bool isInitiator() const override {
+      return initiator_;
+    }
+
+    outcome::result<multi::Multiaddress> localMultiaddr() override {
+      return multi::Multiaddress::create(initiator_ ? "/memory/0"
+                                                    : "/memory/1");
+    }
+
+    outcome::result<multi::Multiaddress> remoteMultiaddr() override {
+      return multi::Multiaddress::create(initiator_ ? "/memory/1"
+                                                    : "/memory/0");
+    }
+
+   private:
+    struct PendingRead {
+      BytesOut out;
+      size_t bytes;
+      bool exact;
+      ReadCallbackFunc cb;
+    };
+
+    void startRead(BytesOut out,
+                   size_t bytes,
+                   bool exact,
+                   ReadCallbackFunc cb) {
+      read_.emplace(PendingRead{out, bytes, exact, std::move(cb)});
+      // callback is never called before read returns
+      boost::asio::post(*io_, [self{shared_from_this()}] { self->deliver(); });
+    }
+
+    void deliver() {
+      if (not read_) {
+        return;
+      }
+      size_t need =
+          read_->exact ? read_->bytes : std::min<size_t>(read_->bytes, 1);
+      if (buffer_.size() < need) {
+        if (closed_) {
+          auto read = std::move(*read_);
+          read_.reset();
+          read.cb(Error::CONNECTION_CLOSED_BY_PEER);
+        }
+        return;
+      }
+      auto n = std::min(read_->bytes, buffer_.size());
+      std::copy_n(buffer_.begin(), n, read_->out.begin());
+      buffer_.erase(buffer_.begin(), buffer_.begin() + n);
+      auto read = std::move(*read_);
+      read_.reset();
+      read.cb(n);
+    }
+
+    std::shared_ptr<boost::asio::io_context> io_;
+    bool initiator_;
+    std::weak_ptr<Pipe> remote_;
+    std::deque<uint8_t> buffer_;
+    std::optional<PendingRead> read_;
+    bool closed_ = false;
+  };
+
+  struct Peer {
+    std::shared_ptr<security::SecurityAdaptor> security;
+    peer::PeerId id;
+  };
+
+  template <typename Security>
+  Peer makePeer(std::shared_ptr<boost::asio::io_context> io,
+                security::NoiseConfig noise_config,
+                security::TlsConfig tls_config) {
+    auto injector =
+        injector::makeNetworkInjector<boost::di::extension::shared_config>(
+            boost::di::bind<boost::asio::io_context>.to(
+                io)[boost::di::override],
+            boost::di::bind<security::NoiseConfig>.to(
+                noise_config)[boost::di::override],
+            boost::di::bind<security::TlsConfig>.to(
+                tls_config)[boost::di::override]);
+    auto security = injector.template create<std::shared_ptr<Security>>();
+    auto id =
+        injector.template create<std::shared_ptr<peer::IdentityManager>>()
+            ->getId();
+    return {std::move(security), std::move(id)};
+  }
+
+  /// Counter name and histogram of a handshake phase
+  using Phases = std::vector<std::pair<std::string, std::string>>;
+
+  /// Sums of histograms, which handshakes create on first use
+  class PhaseSums : public metrics::Exporter {
+   public:
+    PhaseSums() {
+      metrics::Registry::instance().collect(*this);
+    }
+
+    double operator[](const std::string &name) const {
+      auto it = sums_.find(name);
+      return it == sums_.end() ? 0 : it->second;
+    }
+
+    void counter(std::string_view, std::string_view, uint64_t) override {}
+
+    void gauge(std::string_view, std::string_view, int64_t) override {}
+
+    void histogram(std::string_view name,
+                   std::string_view,
+                   const metrics::Histogram::Snapshot &snapshot) override {
+      sums_.emplace(name, snapshot.sum);
+    }
+
+    void instanceCount(std::string_view, size_t) override {}
+
+   private:
+    std::map<std::string, double, std::less<>> sums_;
+  };
+
+  void runUntil(boost::asio::io_context &io, const std::function<bool()> &done) {
+    io.restart();
+    while (not done()) {
+      if (io.run_one() == 0) {
+        throw std::runtime_error{"io_context ran out of work"};
+      }
+    }
+  }
+
+  void runHandshakes(benchmark::State &state,
+                     const std::shared_ptr<boost::asio::io_context> &io,
+                     const Peer &client,
+                     const Peer &server,
+                     const Phases &phases) {
+    auto concurrency = static_cast<size_t>(state.range(0));
+    PhaseSums before;
+    size_t failed = 0;
+    for (auto _ : state) {
+      size_t pending = 2 * concurrency;
+      std::vector<std::shared_ptr<connection::SecureConnection>> secured;
+      auto on_secured =
+          [&](outcome::result<std::shared_ptr<connection::SecureConnection>>
+                  r) {
+            if (r) {
+              secured.emplace_back(std::move(r.value()));
+            } else {
+              ++failed;
+            }
+            --pending;
+          };
+      for (size_t i = 0; i < concurrency; ++i) {
+        auto [dialer, listener] = Pipe::makePair(io);
+        server.security->secureInbound(listener, on_secured);
+        client.security->secureOutbound(dialer, server.id, on_secured);
+      }
+      runUntil(*io, [&] { return pending == 0; });
+
+      state.PauseTiming();
+      for (auto &conn : secured) {
+        std::ignore = conn->close();
+      }
+      secured.clear();
+      io->restart();
+      io->poll();
+      state.ResumeTiming();
+    }
+
+    auto handshakes = static_cast<double>(state.iterations() * concurrency);
+    state.SetItemsProcessed(static_cast<int64_t>(handshakes));
+    state.counters["failed"] = 2 * static_cast<double>(failed) / handshakes;
+    PhaseSums after;
+    for (const auto &[counter, histogram] : phases) {
+      state.counters[counter] =
+          (after[histogram] - before[histogram]) * 1e6 / (2 * handshakes);
+    }
+  }
+
+  void noiseHandshakes(benchmark::State &state) {
+    auto io = std::make_shared<boost::asio::io_context>();
+    security::NoiseConfig config;
+    config.key_pool_size = static_cast<size_t>(state.range(1));
+    auto client = makePeer<security::Noise>(io, config, {});
+    auto server = makePeer<security::Noise>(io, config, {});
+    runHandshakes(state,
+                  io,
+                  client,
+                  server,
+                  {
+                      {"dh_us", "libp2p_noise_handshake_dh_seconds"},
+                      {"signature_us",
+                       "libp2p_noise_handshake_signature_seconds"},
+                      {"marshal_us", "libp2p_noise_handshake_marshal_seconds"},
+                      {"io_us", "libp2p_noise_handshake_io_seconds"},
+                  });
+  }
+
+  void tlsHandshakes(benchmark::State &state) {
+    auto io = std::make_shared<boost::asio::io_context>();
+    security::TlsConfig config;
+    config.session_resumption = state.range(1) != 0;
+    auto client = makePeer<security::TlsAdaptor>(io, {}, config);
+    auto server = makePeer<security::TlsAdaptor>(io, {}, config);
+    runHandshakes(state,
+                  io,
+                  client,
+                  server,
+                  {
+                      {"ssl_us", "libp2p_tls_handshake_ssl_seconds"},
+                      {"signature_us",
+                       "libp2p_tls_handshake_signature_seconds"},
+                      {"marshal_us", "libp2p_tls_handshake_marshal_seconds"},
+                  });
+  }
+
+  void prepareLoggers() {
+    auto logging_system = std::make_shared<soralog::LoggingSystem>(
+        std::make_shared<log::Configurator>());
+    auto r = logging_system->configure();
+    if (r.has_error) {
+      std::cerr << r.message << std::endl;
+    }
+    log::setLoggingSystem(logging_system);
+    log::setLevelOfGroup(log::defaultGroupName, soralog::Level::ERROR);
+  }
+}  // namespace libp2p::benchmarks
+
+namespace bm = libp2p::benchmarks;
+
+BENCHMARK(bm::noiseHandshakes)
+    ->Name("Noise")
+    ->ArgNames({"concurrency", "key_pool"})
+    ->ArgsProduct({{1, 100}, {0, 256}})
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(bm::tlsHandshakes)
+    ->Name("Tls")
+    ->ArgNames({"concurrency", "resumption"})
+    ->ArgsProduct({{1, 100}, {0, 1}})
+    ->Unit(benchmark::kMicrosecond);
+
+int main(int argc, char **argv) {
+  bm::prepareLoggers();
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return 0;
+}
@@ -0,0 +1,208 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * DHT lookups at scale: thousands of KademliaImpl nodes in one process,
+ * connected by simulated streams which deliver data after configurable
+ * latency and jitter. Lost streams silently drop data, so requests sent over
+ * them time out. Time is virtual, driven by ManualSchedulerBackend, so only
+ * CPU work of lookups takes real time.
+ *
+ * Routing tables are seeded with a few random peers, then every node makes a
+ * random walk. Every iteration is findPeer of a random node from another
+ * random node. Reports lookup latency percentiles as p50_ms and p99_ms,
+ * messages and streams per lookup, share of failed lookups and resident
+ * memory per node.
+ *
+ * Arguments: nodes, latency_ms, loss_permille, requestConcurency,
+ * closerPeerCount, maxBucketSize. Edit configs() to try other values.
+ *
+ * Usage: kademlia_simulation --benchmark_filter=nodes:5000
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <libp2p/protocol/kademlia/impl/content_routing_table_impl.hpp>
+#include <libp2p/protocol/kademlia/impl/kademlia_impl.hpp>
+#include <libp2p/protocol/kademlia/impl/peer_routing_table_impl.hpp>
+#include <libp2p/protocol/kademlia/impl/storage_backend_default.hpp>
+#include <libp2p/protocol/kademlia/impl/storage_impl.hpp>
+#include <libp2p/protocol/kademlia/impl/validator_default.hpp>
+
+#include "simulation.hpp"
+
+namespace libp2p::benchmarks {
+  using namespace std::chrono_literals;
+  using protocol::kademlia::Config;
+  using protocol::kademlia::KademliaImpl;
+
+  /// Routing table seeds of each node
+  constexpr size_t kSeeds = 8;
+
+  /// Virtual time given to random walks of all nodes
+  constexpr auto kWarmup = 60s;
+
+  struct SimNode {
+    std::shared_ptr<SimHost> host;
+    std::shared_ptr<KademliaImpl> kademlia;
+  };
+
+  SimNode makeNode(const Config &config,
+                   const std::shared_ptr<SimNetwork> &network,
+                   const std::shared_ptr<SimRandomGenerator> &random,
+                   size_t index) {
+    auto info = nodeInfo(index);
+    auto host = std::make_shared<SimHost>(network, info, makePeerRepository());
+    // the bus of Kademlia is the bus of host
+    auto bus = std::shared_ptr<event::Bus>(host, &host->getBus());
+    auto &scheduler = network->scheduler();
+    auto kademlia = std::make_shared<KademliaImpl>(
+        config,
+        host,
+        std::make_shared<protocol::kademlia::StorageImpl>(
+            config,
+            std::make_shared<protocol::kademlia::StorageBackendDefault>(),
+            scheduler),
+        std::make_shared<protocol::kademlia::ContentRoutingTableImpl>(
+            config, *scheduler, bus),
+        std::make_shared<protocol::kademlia::PeerRoutingTableImpl>(
+            config, std::make_shared<SimIdentityManager>(info.id), bus),
+        std::make_shared<protocol::kademlia::ValidatorDefault>(),
+        scheduler,
+        bus,
+        random);
+    host->setOnDialed(
+        [weak_kademlia{std::weak_ptr{kademlia}}](const peer::PeerInfo &peer) {
+          if (auto kademlia = weak_kademlia.lock()) {
+            kademlia->addPeer(peer, false, true);
+          }
+        });
+    return {std::move(host), std::move(kademlia)};
+  }
+
+  void kademliaLookups(benchmark::State &state) {
+    auto nodes_count = static_cast<size_t>(state.range(0));
+    Config config;
+    config.requestConcurency = static_cast<size_t>(state.range(3));
+    config.closerPeerCount = static_cast<size_t>(state.range(4));
+    config.maxBucketSize = static_cast<size_t>(state.range(5));
+    config.randomWalk.enabled = false;
+
+    auto network = std::make_shared<SimNetwork>(
+        LinkModel{
+            .latency = std::chrono::milliseconds{state.range(1)},
+            .loss = static_cast<double>(state.range(2)) / 1000,
+        },
+        static_cast<std::mt19937::result_type>(nodes_count));
+    auto &backend = network->backend();
+    auto &rng = network->rng();
+    auto random = std::make_shared<SimRandomGenerator>(rng);
+
+    auto memory_before = residentBytes();
+    std::vector<SimNode> nodes;
+    nodes.reserve(nodes_count);
+    for (size_t i = 0; i < nodes_count; ++i) {
+      nodes.emplace_back(makeNode(config, network, random, i));
+    }
+    std::uniform_int_distribution<size_t> random_node{0, nodes_count - 1};
+    for (auto &node : nodes) {
+      node.kademlia->start();
+      for (size_t i = 0; i < kSeeds; ++i) {
+        node.kademlia->addPeer(nodes[random_node(rng)].host->getPeerInfo(),
+                               false);
+      }
+    }
+    for (auto &node : nodes) {
+      std::ignore = node.kademlia->findRandomPeer();
+    }
+    backend.shift(kWarmup);
+    auto memory_after = residentBytes();
+
+    std::vector<double> latencies;
+    size_t failed = 0;
+    Counters total;
+    for (auto _ : state) {
+      auto from = random_node(rng);
+      auto to = random_node(rng);
+      while (to == from) {
+        to = random_node(rng);
+      }
+      auto before = network->counters();
+      auto started = backend.now();
+      // handler may outlive iteration if lookup never ends
+      auto result = std::make_shared<std::optional<bool>>();
+      auto latency = std::make_shared<std::chrono::milliseconds>();
+      std::ignore = nodes[from].kademlia->findPeer(
+          nodes[to].host->getId(),
+          [&backend, result, latency, started](
+              outcome::result<peer::PeerInfo> r, std::vector<peer::PeerId>) {
+            *result = r.has_value();
+            *latency = backend.now() - started;
+          });
+      while (not *result and not backend.empty()) {
+        backend.shiftToTimer();
+      }
+      if (not result->value_or(false)) {
+        ++failed;
+        continue;
+      }
+      latencies.push_back(static_cast<double>(latency->count()));
+      total.messages += network->counters().messages - before.messages;
+      total.streams += network->counters().streams - before.streams;
+    }
+
+    auto found = static_cast<double>(std::max<size_t>(latencies.size(), 1));
+    state.counters["p50_ms"] = percentile(latencies, 0.5);
+    state.counters["p99_ms"] = percentile(latencies, 0.99);
+    state.counters["messages"] = static_cast<double>(total.messages) / found;
+    state.counters["streams"] = static_cast<double>(total.streams) / found;
+    state.counters["failed"] =
+        static_cast<double>(failed) / static_cast<double>(state.iterations());
+    state.counters["kb_per_node"] =
+        static_cast<double>(memory_after - std::min(memory_before, memory_after))
+        / 1024 / static_cast<double>(nodes_count);
+
+    // requests in flight hold nodes until they end
+    nodes.clear();
+    backend.shift(config.responseTimeout * 2);
+  }
+
+  /// {nodes, latency_ms, loss_permille, concurrency, closer peers, bucket}
+  void configs(benchmark::internal::Benchmark *b) {
+    b->ArgNames({"nodes",
+                 "latency_ms",
+                 "loss_permille",
+                 "concurrency",
+                 "closer",
+                 "bucket"});
+    for (int64_t nodes : {1000, 5000}) {
+      b->Args({nodes, 50, 0, 3, 6, 20});
+      b->Args({nodes, 50, 50, 3, 6, 20});
+      b->Args({nodes, 50, 50, 6, 6, 20});
+      b->Args({nodes, 50, 0, 3, 20, 20});
+      b->Args({nodes, 50, 0, 3, 6, 10});
+    }
+  }
+}  // namespace libp2p::benchmarks
+
+namespace bm = libp2p::benchmarks;
+
+BENCHMARK(bm::kademliaLookups)
+    ->Name("Kademlia")
+    ->Apply(bm::configs)
+    ->Iterations(500)
+    ->Unit(benchmark::kMicrosecond);
+
+int main(int argc, char **argv) {
+  bm::prepareLoggers();
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return 0;
+}
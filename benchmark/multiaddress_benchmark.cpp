@@ -0,0 +1,80 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * Conversion of typical multiaddrs from identify and DHT responses between
+ * text and binary forms. Run on two revisions to compare implementations.
+ *
+ * Usage: multiaddress_benchmark --benchmark_filter=ToBytes
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <libp2p/multi/converters/converter_utils.hpp>
+#include <libp2p/multi/multiaddress.hpp>
+
+namespace libp2p::benchmarks {
+  using namespace multi::converters;  // NOLINT
+
+  constexpr std::string_view kIp4 = "/ip4/192.168.100.200/tcp/30333";
+  constexpr std::string_view kIp6 = "/ip6/2001:db8::ff00:42:8329/udp/30333";
+  constexpr std::string_view kDns = "/dns4/bootnode.example.org/tcp/443/wss";
+  constexpr std::string_view kPeer =
+      "/ip4/192.168.100.200/tcp/30333/p2p/"
+      "QmcgpsyWgH8Y8ajJz1Cu72KnS5uo2Aa2LpzU7kinSupNKC";
+
+  void toBytes(benchmark::State &state, std::string_view str) {
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(multiaddrToBytes(str));
+    }
+  }
+
+  /// Output buffer is reused, as by parsers of address lists
+  void appendBytes(benchmark::State &state, std::string_view str) {
+    Bytes out;
+    for (auto _ : state) {
+      out.clear();
+      benchmark::DoNotOptimize(appendMultiaddrBytes(out, str));
+    }
+  }
+
+  void toString(benchmark::State &state, std::string_view str) {
+    auto bytes = multiaddrToBytes(str).value();
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(bytesToMultiaddrString(bytes));
+    }
+  }
+
+  void appendString(benchmark::State &state, std::string_view str) {
+    auto bytes = multiaddrToBytes(str).value();
+    std::string out;
+    for (auto _ : state) {
+      out.clear();
+      benchmark::DoNotOptimize(appendMultiaddrString(out, bytes));
+    }
+  }
+
+  /// Both conversions, as done by Multiaddress::create
+  void create(benchmark::State &state, std::string_view str) {
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(multi::Multiaddress::create(str));
+    }
+  }
+
+#define MULTIADDRESS_BENCHMARK(f)   \
+  BENCHMARK_CAPTURE(f, Ip4, kIp4);  \
+  BENCHMARK_CAPTURE(f, Ip6, kIp6);  \
+  BENCHMARK_CAPTURE(f, Dns, kDns);  \
+  BENCHMARK_CAPTURE(f, Peer, kPeer)
+
+  MULTIADDRESS_BENCHMARK(toBytes);
+  MULTIADDRESS_BENCHMARK(appendBytes);
+  MULTIADDRESS_BENCHMARK(toString);
+  MULTIADDRESS_BENCHMARK(appendString);
+  MULTIADDRESS_BENCHMARK(create);
+}  // namespace libp2p::benchmarks
+
+BENCHMARK_MAIN();
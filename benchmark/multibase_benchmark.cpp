@@ -0,0 +1,68 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * Encoding and decoding of multibase codecs for sizes of typical peer ids
+ * (38 bytes of identity multihash, 34 bytes of sha256 multihash) and CIDs,
+ * and a larger buffer. Run on two revisions to compare implementations.
+ *
+ * Usage: multibase_benchmark --benchmark_filter=Base58
+ */
+
+#include <random>
+
+#include <benchmark/benchmark.h>
+
+#include <libp2p/multi/multibase_codec/codecs/base32.hpp>
+#include <libp2p/multi/multibase_codec/codecs/base58.hpp>
+#include <libp2p/multi/multibase_codec/codecs/base64.hpp>
+
+namespace libp2p::benchmarks {
+  using Encode = std::string (*)(BytesIn);
+  using Decode = outcome::result<Bytes> (*)(std::string_view);
+
+  Bytes randomBytes(size_t size) {
+    std::mt19937 random{static_cast<uint32_t>(size)};
+    Bytes bytes(size);
+    for (auto &byte : bytes) {
+      byte = static_cast<uint8_t>(random());
+    }
+    return bytes;
+  }
+
+  void encode(benchmark::State &state, Encode encode) {
+    auto bytes = randomBytes(state.range(0));
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(encode(bytes));
+    }
+    state.SetBytesProcessed(state.iterations() * bytes.size());
+  }
+
+  void decode(benchmark::State &state, Encode encode, Decode decode) {
+    auto bytes = randomBytes(state.range(0));
+    auto str = encode(bytes);
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(decode(str));
+    }
+    state.SetBytesProcessed(state.iterations() * bytes.size());
+  }
+
+  void sizes(benchmark::internal::Benchmark *b) {
+    b->Arg(34)->Arg(38)->Arg(64)->Arg(1024);
+  }
+
+  using namespace multi::detail;  // NOLINT
+
+  BENCHMARK_CAPTURE(encode, Base58, encodeBase58)->Apply(sizes);
+  BENCHMARK_CAPTURE(decode, Base58, encodeBase58, decodeBase58)->Apply(sizes);
+  BENCHMARK_CAPTURE(encode, Base64, encodeBase64)->Apply(sizes);
+  BENCHMARK_CAPTURE(decode, Base64, encodeBase64, decodeBase64)->Apply(sizes);
+  BENCHMARK_CAPTURE(encode, Base32, encodeBase32Lower)->Apply(sizes);
+  BENCHMARK_CAPTURE(decode, Base32, encodeBase32Lower, decodeBase32Lower)
+      ->Apply(sizes);
+}  // namespace libp2p::benchmarks
+
+BENCHMARK_MAIN();
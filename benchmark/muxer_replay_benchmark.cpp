@@ -0,0 +1,439 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * Replays frame traces of production connections through a pair of Yamux or
+ * Mplex connections over in-memory secure pipes, which deliver data through
+ * io_context, so muxer work of the real traffic mix (stream count, frame
+ * sizes, interleaving) is measured instead of synthetic one.
+ *
+ * Traces are captured by installing a sink before host starts:
+ *   libp2p::muxer::setFrameTraceSink(
+ *       std::make_shared<libp2p::muxer::FrameTraceFiles>("/tmp/traces"));
+ * Every traced connection is a benchmark, named after its file.
+ *
+ * Streams are opened, written, closed and reset by the side which did it in
+ * trace, data frames become writes of zeros of traced length, and all
+ * streams are read till the end. Muxers make their own control frames
+ * (window updates, pings), so traced ones are skipped. Operations are issued
+ * in trace order, each after the previous one of its stream and side
+ * completes, traced times are not waited for. Reports stream data as
+ * bytes_per_second and data frames as items_per_second.
+ *
+ * Usage: muxer_replay_benchmark --traces=/tmp/traces
+ */
+
+#include <array>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <optional>
+
+#include <benchmark/benchmark.h>
+#include <boost/asio/post.hpp>
+
+#include <libp2p/basic/scheduler/asio_scheduler_backend.hpp>
+#include <libp2p/basic/scheduler/scheduler_impl.hpp>
+#include <libp2p/basic/write.hpp>
+#include <libp2p/muxer/frame_trace.hpp>
+#include <libp2p/muxer/mplex/mplex_frame.hpp>
+#include <libp2p/muxer/mplex/mplexed_connection.hpp>
+#include <libp2p/muxer/yamux/yamux_frame.hpp>
+#include <libp2p/muxer/yamux/yamuxed_connection.hpp>
+
+#include "secure_pipe.hpp"
+
+namespace libp2p::benchmarks {
+
+  /// Stream operations of a trace, by its local (0) and remote (1) sides
+  struct Script {
+    enum class Kind : uint8_t { OPEN, DATA, CLOSE, RESET };
+
+    struct Op {
+      size_t stream;
+      size_t side;
+      Kind kind;
+      size_t length;
+    };
+
+    std::string muxer;
+    bool initiator = false;
+    size_t streams = 0;
+    std::vector<Op> ops;
+    size_t data_bytes = 0;
+    size_t data_frames = 0;
+
+    bool isYamux() const {
+      return muxer.starts_with("/yamux/");
+    }
+
+    /// Adds ops of frame sent by side, opening stream of key if `open`
+    void add(std::map<std::pair<uint64_t, size_t>, size_t> &streams_by_key,
+             std::pair<uint64_t, size_t> key,
+             bool open,
+             size_t side,
+             std::optional<Kind> kind,
+             uint64_t length) {
+      auto it = streams_by_key.find(key);
+      if (open and it == streams_by_key.end()) {
+        it = streams_by_key.emplace(key, streams++).first;
+        ops.emplace_back(Op{it->second, side, Kind::OPEN, 0});
+      }
+      // streams opened before capture are not replayed
+      if (it == streams_by_key.end() or not kind) {
+        return;
+      }
+      if (kind == Kind::DATA) {
+        if (length == 0) {
+          return;
+        }
+        data_bytes += length;
+        ++data_frames;
+      }
+      ops.emplace_back(Op{it->second, side, *kind, length});
+    }
+
+    static Script fromTrace(const muxer::FrameTrace &trace) {
+      Script script;
+      script.muxer = trace.muxer;
+      script.initiator = trace.initiator;
+      std::map<std::pair<uint64_t, size_t>, size_t> streams_by_key;
+      for (auto &frame : trace.frames) {
+        size_t side = frame.inbound ? 1 : 0;
+        if (script.isYamux()) {
+          using Type = connection::YamuxFrame::FrameType;
+          using Flag = connection::YamuxFrame::Flag;
+          auto type = static_cast<Type>(frame.type);
+          auto flag = [&](Flag f) {
+            return (frame.flags & static_cast<uint16_t>(f)) != 0;
+          };
+          if ((type != Type::DATA and type != Type::WINDOW_UPDATE)
+              or frame.stream_id == 0) {
+            continue;
+          }
+          // stream ids are unique within connection
+          std::pair key{frame.stream_id, size_t{0}};
+          auto open = flag(Flag::SYN);
+          auto data = type == Type::DATA and frame.length != 0;
+          if (data) {
+            script.add(streams_by_key, key, open, side, Kind::DATA,
+                       frame.length);
+            open = false;
+          }
+          if (flag(Flag::FIN)) {
+            script.add(streams_by_key, key, open, side, Kind::CLOSE, 0);
+          } else if (flag(Flag::RST)) {
+            script.add(streams_by_key, key, open, side, Kind::RESET, 0);
+          } else if (not data) {
+            script.add(streams_by_key, key, open, side, std::nullopt, 0);
+          }
+        } else {
+          using Flag = connection::MplexFrame::Flag;
+          auto flag = static_cast<Flag>(frame.flags);
+          // flags of stream initiator are even, of receiver odd
+          auto from_opener = static_cast<uint8_t>(flag) % 2 == 0;
+          std::pair key{frame.stream_id, from_opener ? side : 1 - side};
+          std::optional<Kind> kind;
+          switch (flag) {
+            case Flag::NEW_STREAM:
+              break;
+            case Flag::MESSAGE_RECEIVER:
+            case Flag::MESSAGE_INITIATOR:
+              kind = Kind::DATA;
+              break;
+            case Flag::CLOSE_RECEIVER:
+            case Flag::CLOSE_INITIATOR:
+              kind = Kind::CLOSE;
+              break;
+            case Flag::RESET_RECEIVER:
+            case Flag::RESET_INITIATOR:
+              kind = Kind::RESET;
+              break;
+          }
+          script.add(streams_by_key,
+                     key,
+                     flag == Flag::NEW_STREAM,
+                     side,
+                     kind,
+                     frame.length);
+        }
+      }
+      return script;
+    }
+  };
+
+  /// One run of script over new pair of connections
+  class Replay : public std::enable_shared_from_this<Replay> {
+   public:
+    Replay(const Script &script,
+           const std::shared_ptr<boost::asio::io_context> &io,
+           const std::shared_ptr<basic::Scheduler> &scheduler,
+           const Bytes &zeros)
+        : script_{script}, zeros_{zeros}, streams_(script.streams) {
+      auto [dialer, listener] = SecurePipe::makePair(io);
+      // local side of trace dials if it did
+      auto local = script.initiator ? dialer : listener;
+      auto remote = script.initiator ? listener : dialer;
+      for (auto [side, pipe] : {std::pair{size_t{0}, local},
+                                std::pair{size_t{1}, remote}}) {
+        std::shared_ptr<connection::CapableConnection> conn;
+        if (script.isYamux()) {
+          conn = std::make_shared<connection::YamuxedConnection>(
+              pipe, scheduler, nullptr, muxer::MuxedConnectionConfig{});
+        } else {
+          conn = std::make_shared<connection::MplexedConnection>(
+              pipe, muxer::MuxedConnectionConfig{});
+        }
+        conns_[side] = std::move(conn);
+      }
+    }
+
+    void start() {
+      for (size_t side : {0, 1}) {
+        conns_[side]->onStream(
+            [weak{weak_from_this()}, side](
+                std::shared_ptr<connection::Stream> stream) {
+              if (auto self = weak.lock()) {
+                self->accepted(side, std::move(stream));
+              }
+            });
+        conns_[side]->start();
+      }
+      pump();
+    }
+
+    bool done() const {
+      return failed_ or (next_ == script_.ops.size() and inflight_ == 0);
+    }
+
+    bool failed() const {
+      return failed_;
+    }
+
+    void stop() {
+      for (auto &conn : conns_) {
+        std::ignore = conn->close();
+      }
+    }
+
+   private:
+    struct StreamSide {
+      std::shared_ptr<connection::Stream> stream;
+      /// Operation of this stream and side is in progress
+      bool busy = false;
+      Bytes buffer;
+    };
+
+    using Sides = std::array<StreamSide, 2>;
+
+    /// Issues operations in order, till one has to wait
+    void pump() {
+      while (not failed_ and next_ < script_.ops.size()) {
+        auto &op = script_.ops[next_];
+        auto &side = streams_[op.stream][op.side];
+        if (side.busy
+            or (op.kind != Script::Kind::OPEN and side.stream == nullptr)) {
+          return;
+        }
+        ++next_;
+        issue(op, side);
+      }
+    }
+
+    void issue(const Script::Op &op, StreamSide &side) {
+      ++inflight_;
+      side.busy = true;
+      auto completed = [weak{weak_from_this()}, stream{op.stream}, s{op.side}](
+                           outcome::result<void> r) {
+        if (auto self = weak.lock()) {
+          self->completed(self->streams_[stream][s], r);
+        }
+      };
+      switch (op.kind) {
+        case Script::Kind::OPEN:
+          accepting_[1 - op.side].push_back(op.stream);
+          conns_[op.side]->newStream(
+              [weak{weak_from_this()}, stream{op.stream}, s{op.side}](
+                  outcome::result<std::shared_ptr<connection::Stream>> r) {
+                auto self = weak.lock();
+                if (not self) {
+                  return;
+                }
+                auto &side = self->streams_[stream][s];
+                outcome::result<void> opened = outcome::success();
+                if (r) {
+                  side.stream = std::move(r.value());
+                  self->startReading(side);
+                } else {
+                  opened = r.error();
+                }
+                self->completed(side, opened);
+              });
+          break;
+        case Script::Kind::DATA:
+          libp2p::write(
+              side.stream, BytesIn{zeros_}.first(op.length), completed);
+          break;
+        case Script::Kind::CLOSE:
+          side.stream->close(completed);
+          break;
+        case Script::Kind::RESET:
+          side.stream->reset();
+          completed(outcome::success());
+          break;
+      }
+    }
+
+    void completed(StreamSide &side, outcome::result<void> r) {
+      --inflight_;
+      side.busy = false;
+      // only failed open stops replay, writes to streams reset by peer fail
+      // as they did in production
+      if (not r and side.stream == nullptr) {
+        failed_ = true;
+      }
+      pump();
+    }
+
+    void accepted(size_t s, std::shared_ptr<connection::Stream> stream) {
+      auto &accepting = accepting_[s];
+      if (accepting.empty()) {
+        failed_ = true;
+        return;
+      }
+      auto &side = streams_[accepting.front()][s];
+      accepting.pop_front();
+      side.stream = std::move(stream);
+      startReading(side);
+      pump();
+    }
+
+    void startReading(StreamSide &side) {
+      side.buffer.resize(64 << 10);
+      readNext(side.stream, side.buffer);
+    }
+
+    void readNext(std::shared_ptr<connection::Stream> stream, BytesOut buffer) {
+      auto reader = stream.get();
+      reader->readSome(
+          buffer,
+          buffer.size(),
+          [buffer, stream{std::move(stream)}, weak{weak_from_this()}](
+              outcome::result<size_t> r) mutable {
+            auto self = weak.lock();
+            if (self and r and r.value() != 0) {
+              self->readNext(std::move(stream), buffer);
+            }
+          });
+    }
+
+    const Script &script_;
+    const Bytes &zeros_;
+    std::array<std::shared_ptr<connection::CapableConnection>, 2> conns_;
+    std::vector<Sides> streams_;
+    /// Streams opened by the other side, in order, to be accepted by side
+    std::array<std::deque<size_t>, 2> accepting_;
+    size_t next_ = 0;
+    size_t inflight_ = 0;
+    bool failed_ = false;
+  };
+
+  void replay(benchmark::State &state, const Script &script) {
+    auto io = std::make_shared<boost::asio::io_context>();
+    auto scheduler = std::make_shared<basic::SchedulerImpl>(
+        std::make_shared<basic::AsioSchedulerBackend>(io),
+        basic::Scheduler::Config{});
+    size_t max_length = 0;
+    for (auto &op : script.ops) {
+      max_length = std::max(max_length, op.length);
+    }
+    Bytes zeros(max_length);
+    size_t failed = 0;
+    for (auto _ : state) {
+      auto run = std::make_shared<Replay>(script, io, scheduler, zeros);
+      run->start();
+      runUntil(*io, [&] { return run->done(); });
+      failed += run->failed() ? 1 : 0;
+
+      state.PauseTiming();
+      run->stop();
+      run.reset();
+      io->restart();
+      io->poll();
+      state.ResumeTiming();
+    }
+    state.SetBytesProcessed(
+        static_cast<int64_t>(state.iterations() * script.data_bytes));
+    state.SetItemsProcessed(
+        static_cast<int64_t>(state.iterations() * script.data_frames));
+    state.counters["streams"] = static_cast<double>(script.streams);
+    state.counters["failed"] =
+        static_cast<double>(failed) / static_cast<double>(state.iterations());
+  }
+
+  /// Scripts of trace files in directory, by file name
+  std::map<std::string, Script> loadScripts(const std::filesystem::path &dir) {
+    std::map<std::string, Script> scripts;
+    for (auto &entry : std::filesystem::directory_iterator{dir}) {
+      if (entry.path().extension() != ".trace") {
+        continue;
+      }
+      std::ifstream file{entry.path(), std::ios::binary};
+      Bytes bytes{std::istreambuf_iterator<char>{file},
+                  std::istreambuf_iterator<char>{}};
+      auto trace = muxer::FrameTrace::decode(bytes);
+      if (not trace) {
+        std::cerr << entry.path() << ": " << trace.error().message()
+                  << std::endl;
+        continue;
+      }
+      scripts.emplace(entry.path().filename().string(),
+                      Script::fromTrace(trace.value()));
+    }
+    return scripts;
+  }
+}  // namespace libp2p::benchmarks
+
+namespace bm = libp2p::benchmarks;
+
+int main(int argc, char **argv) {
+  bm::prepareLoggers();
+  // takes --traces= out of arguments of benchmark library
+  std::optional<std::filesystem::path> traces;
+  constexpr std::string_view kTraces = "--traces=";
+  auto end = std::remove_if(argv + 1, argv + argc, [&](char *arg) {
+    std::string_view view{arg};
+    if (not view.starts_with(kTraces)) {
+      return false;
+    }
+    traces = view.substr(kTraces.size());
+    return true;
+  });
+  argc = static_cast<int>(end - argv);
+  if (not traces) {
+    std::cerr << "Usage: " << argv[0] << " --traces=<directory of .trace files>"
+              << std::endl;
+    return 1;
+  }
+  static auto scripts = bm::loadScripts(*traces);
+  for (auto &[name, script] : scripts) {
+    auto benchmark_name = script.muxer + "/" + name;
+    benchmark::RegisterBenchmark(benchmark_name.c_str(),
+                                 [&script](benchmark::State &state) {
+                                   bm::replay(state, script);
+                                 })
+        ->Unit(benchmark::kMicrosecond);
+  }
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return 0;
+}
@@ -0,0 +1,60 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * Map based scheduler against timer wheel, on a workload mimicking muxer
+ * connections: every timer handle is re-armed a few times (like inactivity
+ * or ping timers), then the remaining timers expire.
+ *
+ * Usage: scheduler_benchmark --benchmark_filter=TimerWheel
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+
+#include <libp2p/basic/scheduler/manual_scheduler_backend.hpp>
+#include <libp2p/basic/scheduler/scheduler_impl.hpp>
+#include <libp2p/basic/scheduler/timer_wheel_scheduler.hpp>
+
+namespace libp2p::benchmarks {
+  constexpr auto kMaxDelay = std::chrono::milliseconds(150'000);
+
+  template <typename T>
+  void rearmTimers(benchmark::State &state) {
+    auto timers = static_cast<size_t>(state.range(0));
+    auto rearms = static_cast<size_t>(state.range(1));
+    std::mt19937 random{0};
+    std::uniform_int_distribution<int64_t> delay{1, kMaxDelay.count()};
+    size_t called = 0;
+    for (auto _ : state) {
+      auto backend = std::make_shared<basic::ManualSchedulerBackend>();
+      auto scheduler =
+          std::make_shared<T>(backend, basic::Scheduler::Config{});
+      std::vector<basic::Scheduler::Handle> handles(timers);
+      for (size_t rearm = 0; rearm < rearms; ++rearm) {
+        for (auto &handle : handles) {
+          handle = scheduler->scheduleWithHandle(
+              [&] { ++called; }, std::chrono::milliseconds(delay(random)));
+        }
+        backend->shift(std::chrono::milliseconds(1));
+      }
+      backend->run();
+    }
+    benchmark::DoNotOptimize(called);
+    state.SetItemsProcessed(
+        state.iterations() * static_cast<int64_t>(timers * rearms));
+  }
+
+  BENCHMARK(rearmTimers<basic::SchedulerImpl>)
+      ->Name("SchedulerImpl")
+      ->Args({20'000, 4});
+  BENCHMARK(rearmTimers<basic::TimerWheelScheduler>)
+      ->Name("TimerWheel")
+      ->Args({20'000, 4});
+}  // namespace libp2p::benchmarks
+
+BENCHMARK_MAIN();
@@ -0,0 +1,210 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <iostream>
+#include <optional>
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/post.hpp>
+
+#include <libp2p/common/bytestr.hpp>
+#include <libp2p/connection/secure_connection.hpp>
+#include <libp2p/crypto/sha/sha256.hpp>
+#include <libp2p/log/configurator.hpp>
+#include <libp2p/log/logger.hpp>
+
+namespace libp2p::benchmarks {
+
+  /// Fixed peer id of dialer or listener end of pipe
+  inline peer::PeerId makePeerId(bool initiator) {
+    std::string_view name = initiator ? "dialer" : "listener";
+    auto hash = crypto::sha256(bytestr(name));
+    return peer::PeerId::fromHash(
+               multi::Multihash::create(multi::HashType::sha256, hash.value())
+                   .value())
+        .value();
+  }
+
+  /// One end of an in-memory secure connection
+  class SecurePipe : public connection::SecureConnection,
+                     public std::enable_shared_from_this<SecurePipe> {
+   public:
+    SecurePipe(std::shared_ptr<boost::asio::io_context> io, bool initiator)
+        : io_{std::move(io)},
+          initiator_{initiator},
+          local_{makePeerId(initiator)},
+          remote_peer_{makePeerId(not initiator)} {}
+
+    static std::pair<std::shared_ptr<SecurePipe>, std::shared_ptr<SecurePipe>>
+    makePair(const std::shared_ptr<boost::asio::io_context> &io) {
+      auto dialer = std::make_shared<SecurePipe>(io, true);
+      auto listener = std::make_shared<SecurePipe>(io, false);
+      dialer->remote_ = listener;
+      listener->remote_ = dialer;
+      return {dialer, listener};
+    }
+
+    void read(BytesOut out, size_t bytes, ReadCallbackFunc cb) override {
+      startRead(out, bytes, true, std::move(cb));
+    }
+
+    void readSome(BytesOut out, size_t bytes, ReadCallbackFunc cb) override {
+      startRead(out, bytes, false, std::move(cb));
+    }
+
+    void deferReadCallback(outcome::result<size_t> res,
+                           ReadCallbackFunc cb) override {
+      boost::asio::post(*io_, [res, cb{std::move(cb)}] { cb(res); });
+    }
+
+    void writeSome(BytesIn in, size_t bytes, WriteCallbackFunc cb) override {
+      writeSomeVectored(std::span{&in, 1}.first(bytes != 0 ? 1 : 0),
+                        std::move(cb));
+    }
+
+    void writeSomeVectored(std::span<const BytesIn> in,
+                           WriteCallbackFunc cb) override {
+      auto remote = remote_.lock();
+      if (closed_ or not remote) {
+        return deferWriteCallback(Error::CONNECTION_CLOSED_BY_PEER,
+                                  std::move(cb));
+      }
+      size_t bytes = 0;
+      for (auto &buffer : in) {
+        remote->buffer_.insert(
+            remote->buffer_.end(), buffer.begin(), buffer.end());
+        bytes += buffer.size();
+      }
+      boost::asio::post(*io_, [remote] { remote->deliver(); });
+      boost::asio::post(*io_, [bytes, cb{std::move(cb)}] { cb(bytes); });
+    }
+
+    void deferWriteCallback(std::error_code ec,
+                            WriteCallbackFunc cb) override {
+      deferReadCallback(ec, std::move(cb));
+    }
+
+    bool isClosed() const override {
+      return closed_;
+    }
+
+    outcome::result<void> close() override {
+      closed_ = true;
+      if (auto remote = remote_.lock()) {
+        remote->closed_ = true;
+        boost::asio::post(*io_, [remote] { remote->deliver(); });
+      }
+      boost::asio::post(*io_, [self{shared_from_this()}] { self->deliver(); });
+      return outcome::success();
+    }
+
+    bool isInitiator() const override {
+      return initiator_;
+    }
+
+    outcome::result<multi::Multiaddress> localMultiaddr() override {
+      return multi::Multiaddress::create(initiator_ ? "/memory/0"
+                                                    : "/memory/1");
+    }
+
+    outcome::result<multi::Multiaddress> remoteMultiaddr() override {
+      return multi::Multiaddress::create(initiator_ ? "/memory/1"
+                                                    : "/memory/0");
+    }
+
+    outcome::result<peer::PeerId> localPeer() const override {
+      return local_;
+    }
+
+    outcome::result<peer::PeerId> remotePeer() const override {
+      return remote_peer_;
+    }
+
+    outcome::result<crypto::PublicKey> remotePublicKey() const override {
+      return crypto::PublicKey{};
+    }
+
+   private:
+    struct PendingRead {
+      BytesOut out;
+      size_t bytes;
+      bool exact;
+      ReadCallbackFunc cb;
+    };
+
+    void startRead(BytesOut out,
+                   size_t bytes,
+                   bool exact,
+                   ReadCallbackFunc cb) {
+      read_.emplace(PendingRead{out, bytes, exact, std::move(cb)});
+      // callback is never called before read returns
+      boost::asio::post(*io_, [self{shared_from_this()}] { self->deliver(); });
+    }
+
+    void deliver() {
+      if (not read_) {
+        return;
+      }
+      auto available = buffer_.size() - begin_;
+      size_t need =
+          read_->exact ? read_->bytes : std::min<size_t>(read_->bytes, 1);
+      if (available < need) {
+        if (closed_) {
+          auto read = std::move(*read_);
+          read_.reset();
+          read.cb(Error::CONNECTION_CLOSED_BY_PEER);
+        }
+        return;
+      }
+      auto n = std::min(read_->bytes, available);
+      std::copy_n(buffer_.begin() + begin_, n, read_->out.begin());
+      begin_ += n;
+      if (begin_ == buffer_.size()) {
+        buffer_.clear();
+        begin_ = 0;
+      }
+      auto read = std::move(*read_);
+      read_.reset();
+      read.cb(n);
+    }
+
+    std::shared_ptr<boost::asio::io_context> io_;
+    bool initiator_;
+    peer::PeerId local_;
+    peer::PeerId remote_peer_;
+    std::weak_ptr<SecurePipe> remote_;
+    /// Bytes not read yet are [begin_, end)
+    Bytes buffer_;
+    size_t begin_ = 0;
+    std::optional<PendingRead> read_;
+    bool closed_ = false;
+  };
+
+  /// Runs handlers one by one until done
+  inline void runUntil(boost::asio::io_context &io,
+                       const std::function<bool()> &done) {
+    io.restart();
+    while (not done()) {
+      if (io.run_one() == 0) {
+        throw std::runtime_error{"io_context ran out of work"};
+      }
+    }
+  }
+
+  /// Logs errors only, so that logging is not measured
+  inline void prepareLoggers() {
+    auto logging_system = std::make_shared<soralog::LoggingSystem>(
+        std::make_shared<log::Configurator>());
+    auto r = logging_system->configure();
+    if (r.has_error) {
+      std::cerr << r.message << std::endl;
+    }
+    log::setLoggingSystem(logging_system);
+    log::setLevelOfGroup(log::defaultGroupName, soralog::Level::ERROR);
+  }
+}  // namespace libp2p::benchmarks
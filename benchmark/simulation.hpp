@@ -0,0 +1,600 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <unordered_map>
+#include <unistd.h>
+
+#include <libp2p/basic/read_return_size.hpp>
+#include <libp2p/basic/scheduler/manual_scheduler_backend.hpp>
+#include <libp2p/basic/scheduler/scheduler_impl.hpp>
+#include <libp2p/common/ambigous_size.hpp>
+#include <libp2p/common/bytestr.hpp>
+#include <libp2p/connection/stream.hpp>
+#include <libp2p/crypto/random_generator.hpp>
+#include <libp2p/crypto/sha/sha256.hpp>
+#include <libp2p/host/host.hpp>
+#include <libp2p/log/configurator.hpp>
+#include <libp2p/log/logger.hpp>
+#include <libp2p/network/dnsaddr_resolver.hpp>
+#include <libp2p/peer/address_repository/inmem_address_repository.hpp>
+#include <libp2p/peer/identity_manager.hpp>
+#include <libp2p/peer/impl/peer_repository_impl.hpp>
+#include <libp2p/peer/key_repository/inmem_key_repository.hpp>
+#include <libp2p/peer/protocol_repository/inmem_protocol_repository.hpp>
+
+namespace libp2p::benchmarks {
+  using connection::Stream;
+
+  /// Link delay is latency plus up to that much of random jitter
+  constexpr double kJitter = 0.5;
+
+  struct LinkModel {
+    std::chrono::milliseconds latency;
+    double loss;
+  };
+
+  struct Counters {
+    size_t messages = 0;
+    size_t bytes = 0;
+    size_t streams = 0;
+  };
+
+  class SimHost;
+
+  /**
+   * Hosts and links between them, owns the only scheduler of all nodes.
+   * Time is virtual, driven by ManualSchedulerBackend
+   */
+  class SimNetwork : public std::enable_shared_from_this<SimNetwork> {
+   public:
+    SimNetwork(LinkModel model, std::mt19937::result_type seed)
+        : model_{model},
+          rng_{seed},
+          backend_{std::make_shared<basic::ManualSchedulerBackend>()},
+          scheduler_{std::make_shared<basic::SchedulerImpl>(
+              backend_, basic::Scheduler::Config{})} {}
+
+    basic::ManualSchedulerBackend &backend() {
+      return *backend_;
+    }
+
+    const std::shared_ptr<basic::Scheduler> &scheduler() const {
+      return scheduler_;
+    }
+
+    std::mt19937 &rng() {
+      return rng_;
+    }
+
+    Counters &counters() {
+      return counters_;
+    }
+
+    void add(SimHost &host);
+
+    /// One way delay of next packet
+    std::chrono::milliseconds delay() {
+      auto jitter = static_cast<std::chrono::milliseconds::rep>(
+          static_cast<double>(model_.latency.count()) * kJitter);
+      return model_.latency
+           + std::chrono::milliseconds{
+               std::uniform_int_distribution<decltype(jitter)>{0,
+                                                               jitter}(rng_)};
+    }
+
+    /// Opens stream to the host of peer, if it handles one of protocols
+    void dial(const peer::PeerInfo &from,
+              const peer::PeerId &to,
+              const StreamProtocols &protocols,
+              StreamAndProtocolOrErrorCb cb);
+
+   private:
+    LinkModel model_;
+    std::mt19937 rng_;
+    std::shared_ptr<basic::ManualSchedulerBackend> backend_;
+    std::shared_ptr<basic::Scheduler> scheduler_;
+    std::unordered_map<peer::PeerId, SimHost *> hosts_;
+    Counters counters_;
+  };
+
+  /**
+   * One end of simulated stream. Data and close or reset reach the other end
+   * after link delay, in order
+   */
+  class SimStream : public Stream,
+                    public std::enable_shared_from_this<SimStream> {
+   public:
+    SimStream(std::weak_ptr<SimNetwork> network,
+              bool initiator,
+              bool lost,
+              peer::PeerInfo local,
+              peer::PeerInfo remote)
+        : network_{std::move(network)},
+          initiator_{initiator},
+          lost_{lost},
+          local_{std::move(local)},
+          remote_{std::move(remote)} {}
+
+    static void connect(const std::shared_ptr<SimStream> &a,
+                        const std::shared_ptr<SimStream> &b) {
+      a->other_ = b;
+      b->other_ = a;
+    }
+
+    bool isClosedForRead() const override {
+      return reset_ or (eof_ and inbound_.empty());
+    }
+
+    bool isClosedForWrite() const override {
+      return reset_ or closed_;
+    }
+
+    bool isClosed() const override {
+      return isClosedForRead() and isClosedForWrite();
+    }
+
+    void close(VoidResultHandlerFunc cb) override {
+      if (not reset_ and not closed_) {
+        closed_ = true;
+        send({}, Signal::CLOSE);
+      }
+      cb(outcome::success());
+    }
+
+    void reset() override {
+      if (reset_) {
+        return;
+      }
+      reset_ = true;
+      inbound_.clear();
+      send({}, Signal::RESET);
+      completeRead(Error::STREAM_RESET_BY_HOST);
+    }
+
+    void adjustWindowSize(uint32_t, VoidResultHandlerFunc cb) override {
+      cb(outcome::success());
+    }
+
+    outcome::result<bool> isInitiator() const override {
+      return initiator_;
+    }
+
+    outcome::result<peer::PeerId> remotePeerId() const override {
+      return remote_.id;
+    }
+
+    outcome::result<multi::Multiaddress> localMultiaddr() const override {
+      return local_.addresses.front();
+    }
+
+    outcome::result<multi::Multiaddress> remoteMultiaddr() const override {
+      return remote_.addresses.front();
+    }
+
+    void read(BytesOut out, size_t bytes, ReadCallbackFunc cb) override {
+      ambigousSize(out, bytes);
+      readReturnSize(shared_from_this(), out, std::move(cb));
+    }
+
+    void readSome(BytesOut out, size_t bytes, ReadCallbackFunc cb) override {
+      ambigousSize(out, bytes);
+      if (read_cb_) {
+        return deferReadCallback(Error::STREAM_IS_READING, std::move(cb));
+      }
+      if (reset_) {
+        return deferReadCallback(Error::STREAM_RESET_BY_HOST, std::move(cb));
+      }
+      read_out_ = out;
+      read_cb_ = std::move(cb);
+      tryRead();
+    }
+
+    void writeSome(BytesIn in, size_t bytes, WriteCallbackFunc cb) override {
+      ambigousSize(in, bytes);
+      if (reset_) {
+        return deferWriteCallback(Error::STREAM_RESET_BY_HOST, std::move(cb));
+      }
+      if (closed_) {
+        return deferWriteCallback(Error::STREAM_NOT_WRITABLE, std::move(cb));
+      }
+      send(Bytes{in.begin(), in.end()}, Signal::DATA);
+      defer(std::move(cb), in.size());
+    }
+
+    void deferReadCallback(outcome::result<size_t> res,
+                           ReadCallbackFunc cb) override {
+      defer(std::move(cb), res);
+    }
+
+    void deferWriteCallback(std::error_code ec, WriteCallbackFunc cb) override {
+      defer(std::move(cb), ec);
+    }
+
+   private:
+    enum class Signal { DATA, CLOSE, RESET };
+
+    template <typename Cb>
+    void defer(Cb cb, outcome::result<size_t> res) {
+      auto network = network_.lock();
+      if (not network) {
+        return;
+      }
+      network->scheduler()->schedule(
+          [weak_self{weak_from_this()}, cb{std::move(cb)}, res]() mutable {
+            if (not weak_self.expired()) {
+              cb(res);
+            }
+          });
+    }
+
+    /// Passes data or signal to the other end, unless the stream is lost
+    void send(Bytes data, Signal signal) {
+      auto network = network_.lock();
+      if (not network or lost_) {
+        return;
+      }
+      if (signal == Signal::DATA) {
+        ++network->counters().messages;
+        network->counters().bytes += data.size();
+      }
+      // packets of stream must not overtake each other
+      auto now = network->backend().now();
+      arrival_ = std::max(arrival_, now + network->delay());
+      network->scheduler()->schedule(
+          [other{other_}, data{std::move(data)}, signal]() mutable {
+            if (auto stream = other.lock()) {
+              stream->onReceived(std::move(data), signal);
+            }
+          },
+          arrival_ - now);
+    }
+
+    void onReceived(Bytes data, Signal signal) {
+      if (reset_) {
+        return;
+      }
+      switch (signal) {
+        case Signal::DATA:
+          inbound_.insert(inbound_.end(), data.begin(), data.end());
+          break;
+        case Signal::CLOSE:
+          eof_ = true;
+          break;
+        case Signal::RESET:
+          reset_ = true;
+          inbound_.clear();
+          completeRead(Error::STREAM_RESET_BY_PEER);
+          return;
+      }
+      tryRead();
+    }
+
+    void tryRead() {
+      if (not read_cb_) {
+        return;
+      }
+      if (not inbound_.empty()) {
+        auto n = std::min(inbound_.size(), read_out_.size());
+        std::copy_n(inbound_.begin(), n, read_out_.begin());
+        inbound_.erase(inbound_.begin(), inbound_.begin() + n);
+        completeRead(n);
+      } else if (eof_) {
+        completeRead(Error::STREAM_CLOSED_BY_PEER);
+      }
+    }
+
+    void completeRead(outcome::result<size_t> res) {
+      if (auto cb = std::exchange(read_cb_, {})) {
+        deferReadCallback(res, std::move(cb));
+      }
+    }
+
+    std::weak_ptr<SimNetwork> network_;
+    std::weak_ptr<SimStream> other_;
+    bool initiator_;
+    bool lost_;
+    peer::PeerInfo local_;
+    peer::PeerInfo remote_;
+    std::deque<uint8_t> inbound_;
+    BytesOut read_out_;
+    ReadCallbackFunc read_cb_;
+    std::chrono::milliseconds arrival_{};
+    bool eof_ = false;
+    bool closed_ = false;
+    bool reset_ = false;
+  };
+
+  /**
+   * Host with what Kademlia needs: peer repository, bus and streams of
+   * simulated network. Outbound streams are reported like new connections
+   */
+  class SimHost : public Host {
+   public:
+    using OnDialed = std::function<void(const peer::PeerInfo &)>;
+
+    SimHost(std::shared_ptr<SimNetwork> network,
+            peer::PeerInfo info,
+            std::shared_ptr<peer::PeerRepository> repo)
+        : network_{std::move(network)},
+          info_{std::move(info)},
+          repo_{std::move(repo)} {
+      network_->add(*this);
+    }
+
+    void setOnDialed(OnDialed on_dialed) {
+      on_dialed_ = std::move(on_dialed);
+    }
+
+    /// Passes inbound stream to protocol handler, false if none matches
+    bool accept(const StreamProtocols &protocols,
+                std::shared_ptr<Stream> stream) {
+      for (auto &protocol : protocols) {
+        if (std::ranges::find(protocols_, protocol) != protocols_.end()) {
+          handler_({std::move(stream), protocol});
+          return true;
+        }
+      }
+      return false;
+    }
+
+    std::string_view getLibp2pVersion() const override {
+      return "0.0.0";
+    }
+
+    event::Handle setOnNewConnectionHandler(
+        const NewConnectionHandler &) const override {
+      return {};
+    }
+
+    std::string_view getLibp2pClientVersion() const override {
+      return "simulation";
+    }
+
+    peer::PeerId getId() const override {
+      return info_.id;
+    }
+
+    peer::PeerInfo getPeerInfo() const override {
+      return info_;
+    }
+
+    std::vector<multi::Multiaddress> getAddresses() const override {
+      return info_.addresses;
+    }
+
+    std::vector<multi::Multiaddress> getAddressesInterfaces() const override {
+      return info_.addresses;
+    }
+
+    std::vector<multi::Multiaddress> getObservedAddresses() const override {
+      return {};
+    }
+
+    Connectedness connectedness(const peer::PeerInfo &p) const override {
+      if (not p.addresses.empty()
+          or not repo_->getAddressRepository().peekAddresses(p.id).empty()) {
+        return Connectedness::CAN_CONNECT;
+      }
+      return Connectedness::CAN_NOT_CONNECT;
+    }
+
+    void setProtocolHandler(StreamProtocols protocols,
+                            StreamAndProtocolCb cb,
+                            ProtocolPredicate) override {
+      protocols_ = std::move(protocols);
+      handler_ = std::move(cb);
+    }
+
+    void connect(const peer::PeerInfo &,
+                 const ConnectionResultHandler &handler) override {
+      // there are streams only, not connections
+      handler(make_error_code(std::errc::operation_not_supported));
+    }
+
+    void disconnect(const peer::PeerId &) override {}
+
+    void newStream(const peer::PeerInfo &peer_info,
+                   StreamProtocols protocols,
+                   StreamAndProtocolOrErrorCb cb) override {
+      network_->dial(
+          info_,
+          peer_info.id,
+          protocols,
+          [on_dialed{on_dialed_}, cb{std::move(cb)}](
+              StreamAndProtocolOrError r) {
+            if (r and on_dialed) {
+              auto remote = r.value().stream->remoteMultiaddr().value();
+              on_dialed({r.value().stream->remotePeerId().value(), {remote}});
+            }
+            cb(std::move(r));
+          });
+    }
+
+    outcome::result<void> listen(const multi::Multiaddress &) override {
+      return outcome::success();
+    }
+
+    outcome::result<void> closeListener(const multi::Multiaddress &) override {
+      return outcome::success();
+    }
+
+    outcome::result<void> removeListener(
+        const multi::Multiaddress &) override {
+      return outcome::success();
+    }
+
+    void start() override {}
+
+    void stop() override {}
+
+    network::Network &getNetwork() override {
+      throw std::logic_error{"SimHost::getNetwork is not simulated"};
+    }
+
+    peer::PeerRepository &getPeerRepository() override {
+      return *repo_;
+    }
+
+    network::Router &getRouter() override {
+      throw std::logic_error{"SimHost::getRouter is not simulated"};
+    }
+
+    event::Bus &getBus() override {
+      return bus_;
+    }
+
+   private:
+    std::shared_ptr<SimNetwork> network_;
+    peer::PeerInfo info_;
+    std::shared_ptr<peer::PeerRepository> repo_;
+    event::Bus bus_;
+    StreamProtocols protocols_;
+    StreamAndProtocolCb handler_;
+    OnDialed on_dialed_;
+  };
+
+  inline void SimNetwork::add(SimHost &host) {
+    hosts_.emplace(host.getId(), &host);
+  }
+
+  inline void SimNetwork::dial(const peer::PeerInfo &from,
+                        const peer::PeerId &to,
+                        const StreamProtocols &protocols,
+                        StreamAndProtocolOrErrorCb cb) {
+    ++counters_.streams;
+    auto it = hosts_.find(to);
+    auto round_trip = delay() + delay();
+    if (it == hosts_.end()) {
+      scheduler_->schedule(
+          [cb{std::move(cb)}] {
+            cb(make_error_code(std::errc::host_unreachable));
+          },
+          round_trip);
+      return;
+    }
+    auto lost = std::bernoulli_distribution{model_.loss}(rng_);
+    auto &host = *it->second;
+    auto outbound = std::make_shared<SimStream>(
+        weak_from_this(), true, lost, from, host.getPeerInfo());
+    auto inbound = std::make_shared<SimStream>(
+        weak_from_this(), false, lost, host.getPeerInfo(), from);
+    SimStream::connect(outbound, inbound);
+    if (not host.accept(protocols, inbound)) {
+      scheduler_->schedule(
+          [cb{std::move(cb)}] {
+            cb(make_error_code(std::errc::protocol_not_supported));
+          },
+          round_trip);
+      return;
+    }
+    // protocol negotiation takes a round trip
+    scheduler_->schedule(
+        [outbound, protocol{protocols.front()}, cb{std::move(cb)}] {
+          cb(StreamAndProtocol{outbound, protocol});
+        },
+        round_trip);
+  }
+
+  class SimDnsaddrResolver : public network::DnsaddrResolver {
+   public:
+    void load(multi::Multiaddress, AddressesCallback callback) override {
+      callback(make_error_code(std::errc::not_supported));
+    }
+  };
+
+  class SimIdentityManager : public peer::IdentityManager {
+   public:
+    explicit SimIdentityManager(peer::PeerId id) : id_{std::move(id)} {}
+
+    const peer::PeerId &getId() const override {
+      return id_;
+    }
+
+    const crypto::KeyPair &getKeyPair() const override {
+      return key_pair_;
+    }
+
+    const crypto::ProtobufKey &getMarshalledPublicKey() const override {
+      return proto_key_;
+    }
+
+   private:
+    peer::PeerId id_;
+    crypto::KeyPair key_pair_;
+    crypto::ProtobufKey proto_key_{{}};
+  };
+
+  /// Seeded, so runs of same arguments walk the same way
+  class SimRandomGenerator : public crypto::random::RandomGenerator {
+   public:
+    explicit SimRandomGenerator(std::mt19937 &rng) : rng_{rng} {}
+
+    uint8_t randomByte() override {
+      return std::uniform_int_distribution<uint16_t>{0, 255}(rng_);
+    }
+
+    std::vector<uint8_t> randomBytes(size_t len) override {
+      std::vector<uint8_t> bytes(len);
+      std::ranges::generate(bytes, [this] { return randomByte(); });
+      return bytes;
+    }
+
+   private:
+    std::mt19937 &rng_;
+  };
+
+  inline peer::PeerInfo nodeInfo(size_t index) {
+    auto hash = crypto::sha256(bytestr(std::to_string(index))).value();
+    return {
+        peer::PeerId::fromHash(
+            multi::Multihash::create(multi::HashType::sha256, hash).value())
+            .value(),
+        {multi::Multiaddress::create("/memory/" + std::to_string(index))
+             .value()},
+    };
+  }
+
+  inline std::shared_ptr<peer::PeerRepository> makePeerRepository() {
+    return std::make_shared<peer::PeerRepositoryImpl>(
+        std::make_shared<peer::InmemAddressRepository>(
+            std::make_shared<SimDnsaddrResolver>()),
+        std::make_shared<peer::InmemKeyRepository>(),
+        std::make_shared<peer::InmemProtocolRepository>());
+  }
+
+  inline size_t residentBytes() {
+    size_t pages = 0, resident = 0;
+    std::ifstream{"/proc/self/statm"} >> pages >> resident;
+    return resident * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+  }
+
+  inline double percentile(std::vector<double> &samples, double p) {
+    if (samples.empty()) {
+      return 0;
+    }
+    auto n = static_cast<size_t>(p * static_cast<double>(samples.size() - 1));
+    std::nth_element(samples.begin(), samples.begin() + n, samples.end());
+    return samples[n];
+  }
+
+  inline void prepareLoggers() {
+    auto logging_system = std::make_shared<soralog::LoggingSystem>(
+        std::make_shared<log::Configurator>());
+    auto r = logging_system->configure();
+    if (r.has_error) {
+      std::cerr << r.message << std::endl;
+    }
+    log::setLoggingSystem(logging_system);
+    log::setLevelOfGroup(log::defaultGroupName, soralog::Level::ERROR);
+  }
+}  // namespace libp2p::benchmarks
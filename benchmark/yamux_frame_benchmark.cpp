@@ -0,0 +1,142 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * Heap allocations and time per yamux data frame: a stream of a pair of
+ * YamuxedConnection over in-memory secure pipes is written one frame at a
+ * time, and read by the other side. Includes callbacks of connection and
+ * stream reads and writes, scheduler calls and window updates, as they are
+ * made by real traffic. Run on two revisions to compare implementations.
+ *
+ * Reports allocations per frame as allocs_per_frame, they include posts of
+ * the in-memory pipe.
+ *
+ * Usage: yamux_frame_benchmark --benchmark_filter=dataFrame/1024
+ */
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#include <benchmark/benchmark.h>
+
+#include <libp2p/basic/scheduler/asio_scheduler_backend.hpp>
+#include <libp2p/basic/scheduler/scheduler_impl.hpp>
+#include <libp2p/basic/write.hpp>
+#include <libp2p/muxer/yamux/yamuxed_connection.hpp>
+
+#include "secure_pipe.hpp"
+
+namespace {
+  /// Counted by replaced operator new of this executable
+  std::atomic<size_t> allocations{0};
+}  // namespace
+
+void *operator new(size_t size) {
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  if (auto p = std::malloc(size == 0 ? 1 : size)) {
+    return p;
+  }
+  throw std::bad_alloc{};
+}
+
+void operator delete(void *p) noexcept {
+  std::free(p);
+}
+
+void operator delete(void *p, size_t) noexcept {
+  std::free(p);
+}
+
+namespace libp2p::benchmarks {
+
+  void dataFrame(benchmark::State &state) {
+    auto frame_size = static_cast<size_t>(state.range(0));
+    auto io = std::make_shared<boost::asio::io_context>();
+    auto scheduler = std::make_shared<basic::SchedulerImpl>(
+        std::make_shared<basic::AsioSchedulerBackend>(io),
+        basic::Scheduler::Config{});
+    auto [dialer, listener] = SecurePipe::makePair(io);
+    auto writer = std::make_shared<connection::YamuxedConnection>(
+        dialer, scheduler, nullptr, muxer::MuxedConnectionConfig{});
+    auto reader = std::make_shared<connection::YamuxedConnection>(
+        listener, scheduler, nullptr, muxer::MuxedConnectionConfig{});
+
+    size_t received = 0;
+    Bytes buffer(64 << 10);
+    std::function<void(std::shared_ptr<connection::Stream>)> read_next =
+        [&](std::shared_ptr<connection::Stream> stream) {
+          auto raw = stream.get();
+          raw->readSome(buffer,
+                        buffer.size(),
+                        [&, stream{std::move(stream)}](
+                            outcome::result<size_t> r) mutable {
+                          if (r and r.value() != 0) {
+                            received += r.value();
+                            read_next(std::move(stream));
+                          }
+                        });
+        };
+    reader->onStream([&](std::shared_ptr<connection::Stream> stream) {
+      read_next(std::move(stream));
+    });
+    writer->start();
+    reader->start();
+
+    std::shared_ptr<connection::Stream> stream;
+    writer->newStream(
+        [&](outcome::result<std::shared_ptr<connection::Stream>> r) {
+          stream = r.value();
+        });
+    runUntil(*io, [&] { return stream != nullptr; });
+
+    Bytes zeros(frame_size);
+    size_t sent = 0;
+    bool written = false;
+    bool failed = false;
+    std::function<bool()> done = [&] {
+      return failed or (written and received == sent);
+    };
+    auto before = allocations.load();
+    for (auto _ : state) {
+      written = false;
+      sent += frame_size;
+      libp2p::write(stream, zeros, [&](outcome::result<void> r) {
+        written = true;
+        failed = r.has_error();
+      });
+      runUntil(*io, done);
+      if (failed) {
+        state.SkipWithError("stream write failed");
+        break;
+      }
+    }
+    auto frames = static_cast<double>(state.iterations());
+    state.counters["allocs_per_frame"] =
+        static_cast<double>(allocations.load() - before) / frames;
+    state.SetBytesProcessed(static_cast<int64_t>(sent));
+    state.SetItemsProcessed(state.iterations());
+
+    stream->reset();
+    std::ignore = writer->close();
+    std::ignore = reader->close();
+    io->restart();
+    io->poll();
+  }
+
+  BENCHMARK(dataFrame)->Arg(64)->Arg(1024)->Arg(16 << 10);
+}  // namespace libp2p::benchmarks
+
+int main(int argc, char **argv) {
+  libp2p::benchmarks::prepareLoggers();
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return 0;
+}
@@ -15,6 +15,11 @@ if (TESTING)
   find_package(GTest CONFIG REQUIRED)
 endif()
 
+if (BENCHMARKS)
+  hunter_add_package(benchmark)
+  find_package(benchmark CONFIG REQUIRED)
+endif()
+
 if (PACKAGE_MANAGER STREQUAL "hunter")
   hunter_add_package(Boost COMPONENTS random filesystem program_options)
   find_package(Boost CONFIG REQUIRED filesystem random program_options)
@@ -68,3 +73,8 @@ if (SQLITE_ENABLED)
 endif ()
 
 find_package(ZLIB REQUIRED)
+
+if (IO_URING_ENABLED)
+  find_package(PkgConfig REQUIRED)
+  pkg_check_modules(liburing REQUIRED IMPORTED_TARGET liburing)
+endif ()
@@ -9,6 +9,7 @@
 #include <string>
 
 #include <libp2p/common/literals.hpp>
+#include <libp2p/common/metrics/startup.hpp>
 #include <libp2p/host/basic_host.hpp>
 #include <libp2p/injector/host_injector.hpp>
 #include <libp2p/layer/websocket.hpp>
@@ -183,6 +184,7 @@ dPtse4GVRA2swbXcZX5iFVi/V8poIpdVrgn5iMadkQnYf9APWJuGcebK
 
     host->start();
     log->info("Server started");
+    log->debug("Startup phases: {}", libp2p::metrics::startupReport());
     log->info("Listening on: {}", ma.getStringAddress());
     log->info("Peer id: {}", host->getPeerInfo().id.toBase58());
     log->info("Connection string: {}/p2p/{}",
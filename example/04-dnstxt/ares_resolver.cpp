@@ -10,7 +10,7 @@
 #include <libp2p/injector/host_injector.hpp>
 #include <libp2p/log/configurator.hpp>
 #include <libp2p/log/logger.hpp>
-#include <libp2p/network/cares/cares.hpp>
+#include <libp2p/network/cares/ares_channel.hpp>
 
 namespace {
   const std::string logger_config(R"(
@@ -55,7 +55,9 @@ int main(int argc, char *argv[]) {
   // create a default Host via an injector
   auto injector = libp2p::injector::makeHostInjector();
 
-  libp2p::network::c_ares::Ares ares;
+  // c-ares channel driven by the io_context of the injector
+  auto ares =
+      injector.create<std::shared_ptr<libp2p::network::c_ares::AresChannel>>();
 
   // create io_context - in fact, thing, which allows us to execute async
   // operations
@@ -63,9 +65,8 @@ int main(int argc, char *argv[]) {
   // the guard to preserve context's running state when tasks queue is empty
   auto work_guard = boost::asio::make_work_guard(*context);
   post(*context, [&] {
-    ares.resolveTxt(
+    ares->resolveTxt(
         "_dnsaddr.bootstrap.libp2p.io",
-        context,
         [&](outcome::result<std::vector<std::string>> result) -> void {
           if (result.has_error()) {
             fmt::println("{}", result.error());
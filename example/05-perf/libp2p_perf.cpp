@@ -0,0 +1,317 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <libp2p/common/literals.hpp>
+#include <libp2p/injector/host_injector.hpp>
+#include <libp2p/log/configurator.hpp>
+#include <libp2p/log/logger.hpp>
+#include <libp2p/protocol/perf/perf.hpp>
+
+namespace {
+  const std::string logger_config(R"(
+# ----------------
+sinks:
+  - name: console
+    type: console
+    color: true
+groups:
+  - name: main
+    sink: console
+    level: info
+    children:
+      - name: libp2p
+# ----------------
+  )");
+
+  using Clock = std::chrono::steady_clock;
+  using libp2p::protocol::PerfResult;
+
+  struct Options {
+    std::string address;
+    uint64_t upload = 1 << 20;
+    uint64_t download = 1 << 20;
+    size_t streams = 1;
+    size_t connections = 1;
+  };
+
+  /// Results of all connections, filled from their threads
+  struct Report {
+    std::mutex mutex;
+    std::vector<Clock::duration> connection_setup;
+    std::vector<PerfResult> runs;
+    size_t errors = 0;
+  };
+
+  double seconds(Clock::duration d) {
+    return std::chrono::duration<double>(d).count();
+  }
+
+  double ms(Clock::duration d) {
+    return std::chrono::duration<double, std::milli>(d).count();
+  }
+
+  void printTimes(std::string_view name, std::vector<Clock::duration> times) {
+    if (times.empty()) {
+      return;
+    }
+    std::ranges::sort(times);
+    Clock::duration sum{};
+    for (auto &t : times) {
+      sum += t;
+    }
+    fmt::print(
+        "{}: min {:.3f}ms, median {:.3f}ms, max {:.3f}ms, avg {:.3f}ms\n",
+        name,
+        ms(times.front()),
+        ms(times[times.size() / 2]),
+        ms(times.back()),
+        ms(sum / times.size()));
+  }
+
+  libp2p::crypto::KeyPair serverKeyPair() {
+    using libp2p::crypto::Key;
+    using libp2p::crypto::PrivateKey;
+    using libp2p::crypto::PublicKey;
+    using libp2p::common::operator""_unhex;
+    // resulting PeerId should be
+    // 12D3KooWEgUjBV5FJAuBSoNMRYFRHjV7PjZwRQ7b43EKX9g7D6xV
+    return {PublicKey{{Key::Type::Ed25519,
+                       "48453469c62f4885373099421a7365520b5ffb"
+                       "0d93726c124166be4b81d852e6"_unhex}},
+            PrivateKey{{Key::Type::Ed25519,
+                        "4a9361c525840f7086b893d584ebbe475b4ec"
+                        "7069951d2e897e8bceb0a3f35ce"_unhex}}};
+  }
+
+  int runServer(const libp2p::log::Logger &log) {
+    auto injector = libp2p::injector::makeHostInjector(
+        libp2p::injector::useKeyPair(serverKeyPair()));
+    auto host = injector.create<std::shared_ptr<libp2p::Host>>();
+    auto io_context =
+        injector.create<std::shared_ptr<boost::asio::io_context>>();
+    auto perf = std::make_shared<libp2p::protocol::Perf>(*host);
+    auto ma =
+        libp2p::multi::Multiaddress::create("/ip4/127.0.0.1/tcp/40020").value();
+
+    post(*io_context, [&] {
+      auto listen_res = host->listen(ma);
+      if (!listen_res) {
+        log->error("host cannot listen the given multiaddress: {}",
+                   listen_res.error());
+        std::exit(EXIT_FAILURE);
+      }
+      perf->start();
+      host->start();
+      log->info("Connection string: {}/p2p/{}",
+                ma.getStringAddress(),
+                host->getPeerInfo().id.toBase58());
+    });
+
+    io_context->run();
+    return EXIT_SUCCESS;
+  }
+
+  /// One client host with its own connection and io context
+  void runConnection(const libp2p::log::Logger &log,
+                     const Options &options,
+                     const libp2p::peer::PeerInfo &peer_info,
+                     Report &report) {
+    auto injector = libp2p::injector::makeHostInjector();
+    auto host = injector.create<std::shared_ptr<libp2p::Host>>();
+    auto io_context =
+        injector.create<std::shared_ptr<boost::asio::io_context>>();
+    auto perf = std::make_shared<libp2p::protocol::Perf>(*host);
+
+    size_t left = options.streams;
+    auto failed = [&](const std::error_code &error) {
+      log->error("perf failed: {}", error);
+      std::lock_guard lock{report.mutex};
+      ++report.errors;
+    };
+    post(*io_context, [&] {
+      auto started = Clock::now();
+      host->connect(peer_info, [&, started](auto &&r) {
+        if (not r) {
+          failed(r.error());
+          return io_context->stop();
+        }
+        {
+          std::lock_guard lock{report.mutex};
+          report.connection_setup.emplace_back(Clock::now() - started);
+        }
+        for (size_t i = 0; i < options.streams; ++i) {
+          perf->run(peer_info,
+                    options.upload,
+                    options.download,
+                    [&](auto r) {
+                      if (r) {
+                        std::lock_guard lock{report.mutex};
+                        report.runs.emplace_back(r.value());
+                      } else {
+                        failed(r.error());
+                      }
+                      if (--left == 0) {
+                        host->disconnect(peer_info.id);
+                        io_context->stop();
+                      }
+                    });
+        }
+      });
+    });
+    io_context->run();
+  }
+
+  int runClient(const libp2p::log::Logger &log, const Options &options) {
+    auto ma = libp2p::multi::Multiaddress::create(options.address);
+    if (not ma) {
+      log->error("unable to create server multiaddress: {}", ma.error());
+      return EXIT_FAILURE;
+    }
+    auto peer_id_str = ma.value().getPeerId();
+    if (not peer_id_str) {
+      log->error("unable to get peer id");
+      return EXIT_FAILURE;
+    }
+    auto peer_id = libp2p::peer::PeerId::fromBase58(*peer_id_str);
+    if (not peer_id) {
+      log->error("Unable to decode peer id from base 58: {}",
+                 peer_id.error());
+      return EXIT_FAILURE;
+    }
+    libp2p::peer::PeerInfo peer_info{peer_id.value(), {ma.value()}};
+
+    Report report;
+    auto started = Clock::now();
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < options.connections; ++i) {
+      threads.emplace_back(
+          [&] { runConnection(log, options, peer_info, report); });
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+    auto total = Clock::now() - started;
+
+    std::vector<Clock::duration> stream_setup;
+    uint64_t uploaded = 0;
+    uint64_t downloaded = 0;
+    Clock::duration upload{};
+    Clock::duration download{};
+    for (auto &run : report.runs) {
+      stream_setup.emplace_back(run.stream_setup);
+      uploaded += run.uploaded;
+      downloaded += run.downloaded;
+      upload = std::max(upload, run.upload);
+      download = std::max(download, run.download);
+    }
+    fmt::print("{} connections x {} streams: {} ok, {} failed in {:.3f}s\n",
+               options.connections,
+               options.streams,
+               report.runs.size(),
+               report.errors,
+               seconds(total));
+    printTimes("connection setup", report.connection_setup);
+    printTimes("stream setup", stream_setup);
+    // streams run in parallel, so aggregate goodput is total bytes over the
+    // slowest stream
+    if (upload != Clock::duration{}) {
+      fmt::print("upload: {} bytes, {:.3f} MiB/s\n",
+                 uploaded,
+                 uploaded / seconds(upload) / (1 << 20));
+    }
+    if (download != Clock::duration{}) {
+      fmt::print("download: {} bytes, {:.3f} MiB/s\n",
+                 downloaded,
+                 downloaded / seconds(download) / (1 << 20));
+    }
+    return report.errors == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+  }
+}  // namespace
+
+int main(int argc, char **argv) {
+  auto args = std::span(argv, argc).subspan(1);
+  Options options;
+  for (size_t i = 0; i < args.size(); ++i) {
+    std::string_view arg = args[i];
+    if (arg == "-h" or arg == "--help") {
+      fmt::print("Usage:\n");
+      fmt::print("  libp2p_perf\n");
+      fmt::print("    Start server\n");
+      fmt::print("  libp2p_perf <server multiaddress> [options]\n");
+      fmt::print("    Run client\n");
+      fmt::print("Options:\n");
+      fmt::print("  --upload <bytes>\n");
+      fmt::print("    Bytes sent by each stream, default {}\n",
+                 options.upload);
+      fmt::print("  --download <bytes>\n");
+      fmt::print("    Bytes received by each stream, default {}\n",
+                 options.download);
+      fmt::print("  --streams <n>\n");
+      fmt::print("    Parallel streams on each connection, default {}\n",
+                 options.streams);
+      fmt::print("  --connections <n>\n");
+      fmt::print("    Parallel connections, default {}\n",
+                 options.connections);
+      return 0;
+    }
+    auto value = [&] {
+      if (i + 1 == args.size()) {
+        fmt::print(stderr, "{} requires value\n", arg);
+        std::exit(EXIT_FAILURE);
+      }
+      return std::stoull(args[++i]);
+    };
+    if (arg == "--upload") {
+      options.upload = value();
+    } else if (arg == "--download") {
+      options.download = value();
+    } else if (arg == "--streams") {
+      options.streams = std::max<size_t>(value(), 1);
+    } else if (arg == "--connections") {
+      options.connections = std::max<size_t>(value(), 1);
+    } else {
+      options.address = arg;
+    }
+  }
+
+  // prepare log system
+  auto logging_system = std::make_shared<soralog::LoggingSystem>(
+      std::make_shared<soralog::ConfiguratorFromYAML>(
+          // Original LibP2P logging config
+          std::make_shared<libp2p::log::Configurator>(),
+          // Additional logging config for application
+          logger_config));
+  auto r = logging_system->configure();
+  if (not r.message.empty()) {
+    (r.has_error ? std::cerr : std::cout) << r.message << std::endl;
+  }
+  if (r.has_error) {
+    exit(EXIT_FAILURE);
+  }
+
+  libp2p::log::setLoggingSystem(logging_system);
+  if (std::getenv("TRACE_DEBUG") != nullptr) {
+    libp2p::log::setLevelOfGroup("main", soralog::Level::TRACE);
+  } else {
+    libp2p::log::setLevelOfGroup("main", soralog::Level::INFO);
+  }
+
+  auto log = libp2p::log::createLogger("Perf");
+
+  if (options.address.empty()) {
+    return runServer(log);
+  }
+  return runClient(log, options);
+}
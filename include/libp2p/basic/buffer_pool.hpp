@@ -0,0 +1,180 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <libp2p/common/types.hpp>
+
+namespace libp2p::basic {
+
+  class BufferPool;
+
+  /// Reference to a part of pooled memory chunk, chunk is returned to its pool
+  /// when the last reference is released. Copying a slice doesn't copy data.
+  /// Slices of one chunk can be held in different threads
+  class BufferSlice {
+   public:
+    BufferSlice() = default;
+    BufferSlice(const BufferSlice &other);
+    BufferSlice(BufferSlice &&other) noexcept;
+    BufferSlice &operator=(const BufferSlice &other);
+    BufferSlice &operator=(BufferSlice &&other) noexcept;
+    ~BufferSlice();
+
+    uint8_t *data() const {
+      return data_;
+    }
+
+    size_t size() const {
+      return size_;
+    }
+
+    bool empty() const {
+      return size_ == 0;
+    }
+
+    uint8_t *begin() const {
+      return data_;
+    }
+
+    uint8_t *end() const {
+      return data_ + size_;  // NOLINT
+    }
+
+    BytesOut span() const {
+      return {data_, size_};
+    }
+
+    /// Returns another reference to the same memory, offset + size must not
+    /// exceed this slice size
+    BufferSlice subslice(size_t offset, size_t size) const;
+
+    /// Returns number of slices referring to the same chunk, 0 if empty
+    size_t useCount() const;
+
+    /// Releases the reference
+    void reset();
+
+   private:
+    friend class BufferPool;
+
+    struct Chunk;
+
+    BufferSlice(Chunk *chunk, uint8_t *data, size_t size);
+
+    Chunk *chunk_ = nullptr;
+    uint8_t *data_ = nullptr;
+    size_t size_ = 0;
+  };
+
+  /// Recycles fixed size memory chunks to avoid allocator churn and heap
+  /// fragmentation caused by large per connection/per message buffers.
+  /// Thread safe
+  class BufferPool : public std::enable_shared_from_this<BufferPool> {
+   public:
+    static constexpr size_t kDefaultChunkSize = 64 * 1024;
+    static constexpr size_t kDefaultMaxFreeChunks = 256;
+
+    /// Size of slabs chunks are carved from when huge pages are used
+    static constexpr size_t kHugePageSize = 2 * 1024 * 1024;
+
+    /// Backing memory of chunks
+    struct MemoryConfig {
+      /// Chunks are carved from slabs of 2 MiB huge pages to cut TLB misses,
+      /// transparent huge pages are used if none are reserved. Slab chunks
+      /// are kept for reuse until the pool is destroyed
+      bool huge_pages = false;
+
+      /// Free chunks are kept per NUMA node and reused by threads running on
+      /// the same node, so that threads pinned to CPUs of one node work with
+      /// local memory, which is placed by first touch
+      bool numa_local = false;
+    };
+
+    BufferPool(const BufferPool &) = delete;
+    BufferPool &operator=(const BufferPool &) = delete;
+    BufferPool(BufferPool &&) = delete;
+    BufferPool &operator=(BufferPool &&) = delete;
+    ~BufferPool();
+
+    /// Creates a pool, at most max_free_chunks are kept for reuse
+    static std::shared_ptr<BufferPool> create(
+        size_t chunk_size = kDefaultChunkSize,
+        size_t max_free_chunks = kDefaultMaxFreeChunks);
+
+    static std::shared_ptr<BufferPool> create(size_t chunk_size,
+                                              size_t max_free_chunks,
+                                              MemoryConfig memory);
+
+    /**
+     * Memory config of pools created without one, including process-wide
+     * pools of muxers and security layers. Must be set before the host is
+     * created
+     */
+    static void setDefaultMemoryConfig(MemoryConfig memory);
+
+    /// Process-wide pool with default parameters
+    static const std::shared_ptr<BufferPool> &defaultPool();
+
+    /// Returns slice of size bytes from the beginning of a chunk,
+    /// size must not exceed chunkSize()
+    BufferSlice allocate(size_t size);
+
+    /// Returns slice of the whole chunk
+    BufferSlice allocate() {
+      return allocate(chunk_size_);
+    }
+
+    size_t chunkSize() const {
+      return chunk_size_;
+    }
+
+    /// Returns number of chunks kept for reuse
+    size_t freeChunks() const;
+
+    /// Returns number of chunks referred by slices
+    size_t chunksInUse() const;
+
+   private:
+    friend class BufferSlice;
+
+    BufferPool(size_t chunk_size, size_t max_free_chunks, MemoryConfig memory);
+
+    /// Called when the last slice released the chunk
+    void release(BufferSlice::Chunk *chunk);
+
+    /// Free chunks of NUMA node of the calling thread, under mutex
+    std::vector<BufferSlice::Chunk *> &freeChunks(size_t node);
+
+    /// Carves chunks of new slab into free chunks of node, under mutex.
+    /// Returns false if huge pages are not available
+    bool allocateSlab(size_t node);
+
+    struct Slab {
+      void *memory;
+      size_t size;
+    };
+
+    const size_t chunk_size_;
+    const size_t max_free_chunks_;
+    const MemoryConfig memory_;
+    mutable std::mutex mutex_;
+
+    /// Free chunks by NUMA node
+    std::vector<std::vector<BufferSlice::Chunk *>> free_chunks_;
+    size_t chunks_in_use_ = 0;
+    std::vector<Slab> slabs_;
+
+    /// Slab allocation failed, heap chunks are used then
+    bool no_huge_pages_ = false;
+  };
+
+}  // namespace libp2p::basic
@@ -0,0 +1,41 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <memory>
+
+#include <libp2p/common/types.hpp>
+#include <libp2p/outcome/outcome.hpp>
+
+namespace libp2p::basic {
+  enum class CodecError {
+    COMPRESS_FAILED = 1,
+    DECOMPRESS_FAILED,
+    DECOMPRESSED_TOO_LARGE,
+  };
+
+  /**
+   * Compression codec of payloads, e.g. adapter of snappy or zstd.
+   * Used by gossip topics and CompressedStream
+   */
+  class Codec {
+   public:
+    virtual ~Codec() = default;
+
+    virtual outcome::result<Bytes> compress(BytesIn input) const = 0;
+
+    /// Fails as soon as output exceeds limit, so that small malicious input
+    /// cannot exhaust memory
+    virtual outcome::result<Bytes> decompress(BytesIn input,
+                                              size_t limit) const = 0;
+  };
+
+  /// zlib deflate codec, built in as zlib is a dependency already
+  std::shared_ptr<Codec> deflateCodec(int level = 1);
+}  // namespace libp2p::basic
+
+OUTCOME_HPP_DECLARE_ERROR(libp2p::basic, CodecError)
@@ -0,0 +1,149 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <chrono>
+#include <coroutine>
+#include <memory>
+#include <optional>
+#include <system_error>
+#include <utility>
+
+#include <libp2p/basic/coro/task.hpp>
+#include <libp2p/basic/reader.hpp>
+#include <libp2p/basic/scheduler.hpp>
+#include <libp2p/basic/writer.hpp>
+
+namespace libp2p::coro {
+
+  /**
+   * Awaits callback based operation. Initiate is called with callback which
+   * keeps only pointer to the awaiter living in coroutine frame, so
+   * std::function stores it inline without allocation. Callback called
+   * before initiate returns doesn't suspend the coroutine
+   */
+  template <typename Result, typename Initiate>
+  class CallbackAwaiter {
+   public:
+    explicit CallbackAwaiter(Initiate initiate)
+        : initiate_{std::move(initiate)} {}
+
+    bool await_ready() const noexcept {
+      return false;
+    }
+
+    bool await_suspend(std::coroutine_handle<> handle) {
+      handle_ = handle;
+      initiate_(Callback{this});
+      if (state_ == State::DONE) {
+        return false;
+      }
+      state_ = State::SUSPENDED;
+      return true;
+    }
+
+    Result await_resume() {
+      return std::move(*result_);
+    }
+
+   private:
+    enum class State : uint8_t { INITIATING, SUSPENDED, DONE };
+
+    struct Callback {
+      template <typename R>
+      void operator()(R &&result) const {
+        self->result_.emplace(std::forward<R>(result));
+        if (std::exchange(self->state_, State::DONE) == State::SUSPENDED) {
+          self->handle_.resume();
+        }
+      }
+
+      CallbackAwaiter *self;
+    };
+
+    Initiate initiate_;
+    std::coroutine_handle<> handle_;
+    std::optional<Result> result_;
+    State state_ = State::INITIATING;
+  };
+
+  template <typename Result, typename Initiate>
+  auto awaitCallback(Initiate initiate) {
+    return CallbackAwaiter<Result, std::decay_t<Initiate>>{
+        std::move(initiate)};
+  }
+
+  /// Reads exactly out.size() bytes
+  inline auto read(const std::shared_ptr<basic::Reader> &reader,
+                   BytesOut out) {
+    return awaitCallback<outcome::result<size_t>>(
+        [reader = reader.get(), out](auto cb) {
+          reader->read(out, out.size(), std::move(cb));
+        });
+  }
+
+  /// Reads up to out.size() bytes
+  inline auto readSome(const std::shared_ptr<basic::Reader> &reader,
+                       BytesOut out) {
+    return awaitCallback<outcome::result<size_t>>(
+        [reader = reader.get(), out](auto cb) {
+          reader->readSome(out, out.size(), std::move(cb));
+        });
+  }
+
+  /// Writes up to in.size() bytes
+  inline auto writeSome(const std::shared_ptr<basic::Writer> &writer,
+                        BytesIn in) {
+    return awaitCallback<outcome::result<size_t>>(
+        [writer = writer.get(), in](auto cb) {
+          writer->writeSome(in, in.size(), std::move(cb));
+        });
+  }
+
+  /// Writes all bytes, unlike libp2p::write() it keeps state in coroutine
+  /// frame instead of allocated callbacks
+  inline Task<outcome::result<void>> write(
+      std::shared_ptr<basic::Writer> writer, BytesIn in) {
+    while (not in.empty()) {
+      auto written = co_await writeSome(writer, in);
+      if (not written) {
+        co_return written.error();
+      }
+      if (written.value() == 0 or written.value() > in.size()) {
+        co_return make_error_code(std::errc::io_error);
+      }
+      in = in.subspan(written.value());
+    }
+    co_return outcome::success();
+  }
+
+  /// Resumes coroutine by scheduler after delay, or on next loop cycle
+  inline auto sleep(basic::Scheduler &scheduler,
+                    std::chrono::milliseconds delay) {
+    struct Awaiter {
+      bool await_ready() const noexcept {
+        return false;
+      }
+
+      void await_suspend(std::coroutine_handle<> handle) {
+        scheduler.schedule([handle] { handle.resume(); }, delay);
+      }
+
+      void await_resume() const noexcept {}
+
+      basic::Scheduler &scheduler;
+      std::chrono::milliseconds delay;
+    };
+    return Awaiter{scheduler, delay};
+  }
+
+  /// Resumes coroutine on next loop cycle, e.g. to yield after long work
+  inline auto post(basic::Scheduler &scheduler) {
+    return sleep(scheduler, std::chrono::milliseconds::zero());
+  }
+
+}  // namespace libp2p::coro
@@ -0,0 +1,203 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <utility>
+
+namespace libp2p::coro {
+
+  template <typename T = void>
+  class Task;
+
+  namespace detail {
+    /// Resumes awaiting coroutine by symmetric transfer, so chains of
+    /// completed tasks don't grow the stack
+    template <typename Promise>
+    struct FinalAwaiter {
+      bool await_ready() const noexcept {
+        return false;
+      }
+
+      std::coroutine_handle<> await_suspend(
+          std::coroutine_handle<Promise> handle) noexcept {
+        if (auto continuation = handle.promise().continuation) {
+          return continuation;
+        }
+        return std::noop_coroutine();
+      }
+
+      void await_resume() const noexcept {}
+    };
+
+    template <typename Promise>
+    struct PromiseBase {
+      std::suspend_always initial_suspend() const noexcept {
+        return {};
+      }
+
+      FinalAwaiter<Promise> final_suspend() const noexcept {
+        return {};
+      }
+
+      void unhandled_exception() noexcept {
+        exception = std::current_exception();
+      }
+
+      void rethrow() const {
+        if (exception) {
+          std::rethrow_exception(exception);
+        }
+      }
+
+      std::coroutine_handle<> continuation;
+      std::exception_ptr exception;
+    };
+
+    template <typename T>
+    struct Promise : PromiseBase<Promise<T>> {
+      Task<T> get_return_object() noexcept;
+
+      template <typename U>
+      void return_value(U &&result) {
+        value.emplace(std::forward<U>(result));
+      }
+
+      T result() {
+        this->rethrow();
+        return std::move(*value);
+      }
+
+      std::optional<T> value;
+    };
+
+    template <>
+    struct Promise<void> : PromiseBase<Promise<void>> {
+      Task<void> get_return_object() noexcept;
+
+      void return_void() const noexcept {}
+
+      void result() const {
+        rethrow();
+      }
+    };
+  }  // namespace detail
+
+  /**
+   * Lazily started coroutine, runs when awaited, and resumes awaiting one
+   * when finished. Use spawn() to start top level task
+   */
+  template <typename T>
+  class [[nodiscard]] Task {
+   public:
+    using promise_type = detail::Promise<T>;
+    using Handle = std::coroutine_handle<promise_type>;
+
+    explicit Task(Handle handle) noexcept : handle_{handle} {}
+
+    Task(Task &&other) noexcept
+        : handle_{std::exchange(other.handle_, nullptr)} {}
+
+    Task &operator=(Task &&other) noexcept {
+      if (this != &other) {
+        reset();
+        handle_ = std::exchange(other.handle_, nullptr);
+      }
+      return *this;
+    }
+
+    Task(const Task &) = delete;
+    Task &operator=(const Task &) = delete;
+
+    ~Task() {
+      reset();
+    }
+
+    auto operator co_await() && noexcept {
+      struct Awaiter {
+        bool await_ready() const noexcept {
+          return not handle or handle.done();
+        }
+
+        std::coroutine_handle<> await_suspend(
+            std::coroutine_handle<> continuation) noexcept {
+          handle.promise().continuation = continuation;
+          return handle;
+        }
+
+        T await_resume() {
+          return handle.promise().result();
+        }
+
+        Handle handle;
+      };
+      return Awaiter{handle_};
+    }
+
+   private:
+    void reset() {
+      if (handle_) {
+        handle_.destroy();
+        handle_ = nullptr;
+      }
+    }
+
+    Handle handle_;
+  };
+
+  namespace detail {
+    template <typename T>
+    Task<T> Promise<T>::get_return_object() noexcept {
+      return Task<T>{std::coroutine_handle<Promise<T>>::from_promise(*this)};
+    }
+
+    inline Task<void> Promise<void>::get_return_object() noexcept {
+      return Task<void>{
+          std::coroutine_handle<Promise<void>>::from_promise(*this)};
+    }
+
+    /// Coroutine which owns itself, frame is freed when it finishes
+    struct Detached {
+      struct promise_type {
+        Detached get_return_object() const noexcept {
+          return {};
+        }
+
+        std::suspend_never initial_suspend() const noexcept {
+          return {};
+        }
+
+        std::suspend_never final_suspend() const noexcept {
+          return {};
+        }
+
+        void return_void() const noexcept {}
+
+        /// Same as exception thrown from callback
+        void unhandled_exception() const {
+          throw;
+        }
+      };
+    };
+
+    inline Detached detach(Task<void> task) {
+      co_await std::move(task);
+    }
+  }  // namespace detail
+
+  /**
+   * Starts task in current thread, it runs until the first suspension.
+   * Suspended task must be resumed by the operation it awaits, so objects
+   * performing operations must outlive it or complete it with error
+   */
+  inline void spawn(Task<void> task) {
+    detail::detach(std::move(task));
+  }
+
+}  // namespace libp2p::coro
@@ -0,0 +1,22 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <cstddef>
+
+#include <libp2p/outcome/outcome.hpp>
+
+namespace libp2p::basic {
+
+  /**
+   * Pins the calling thread to the CPU, e.g. thread running io_context shard,
+   * so that NUMA local buffer pools give it memory of its node
+   * @return error if not supported or CPU is not available
+   */
+  outcome::result<void> pinCurrentThread(size_t cpu);
+
+}  // namespace libp2p::basic
@@ -0,0 +1,75 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace libp2p::basic {
+
+  /// Keeps memory blocks of released objects for objects allocated next, so
+  /// that churn of short-lived objects of one type doesn't reach the heap.
+  /// Blocks of the size allocated first are reused, other sizes are passed to
+  /// operator new and delete. Thread safe
+  class FreeList {
+   public:
+    explicit FreeList(size_t max_free);
+    FreeList(const FreeList &) = delete;
+    FreeList &operator=(const FreeList &) = delete;
+    ~FreeList();
+
+    void *allocate(size_t size);
+
+    void deallocate(void *block, size_t size);
+
+    /// Returns number of blocks kept for reuse
+    size_t freeBlocks() const;
+
+   private:
+    const size_t max_free_;
+    mutable std::mutex mutex_;
+    size_t block_size_ = 0;
+    std::vector<void *> free_;
+  };
+
+  /// Allocator for std::allocate_shared(), control block and object are
+  /// allocated together from the free list. Allocated objects keep the free
+  /// list alive
+  template <typename T>
+  class FreeListAllocator {
+   public:
+    using value_type = T;
+
+    explicit FreeListAllocator(std::shared_ptr<FreeList> free_list)
+        : free_list_{std::move(free_list)} {}
+
+    template <typename U>
+    FreeListAllocator(const FreeListAllocator<U> &other)  // NOLINT
+        : free_list_{other.free_list_} {}
+
+    T *allocate(size_t n) {
+      return static_cast<T *>(free_list_->allocate(n * sizeof(T)));
+    }
+
+    void deallocate(T *p, size_t n) {
+      free_list_->deallocate(p, n * sizeof(T));
+    }
+
+    template <typename U>
+    bool operator==(const FreeListAllocator<U> &other) const {
+      return free_list_ == other.free_list_;
+    }
+
+   private:
+    template <typename U>
+    friend class FreeListAllocator;
+
+    std::shared_ptr<FreeList> free_list_;
+  };
+
+}  // namespace libp2p::basic
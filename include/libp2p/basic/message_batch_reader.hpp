@@ -0,0 +1,71 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <memory>
+#include <span>
+
+#include <libp2p/basic/reader.hpp>
+
+namespace libp2p::basic {
+
+  /**
+   * Reads messages prepended with uvarint length in batches: each readSome()
+   * takes everything available from the reader, all complete messages
+   * received are delivered with one callback
+   */
+  class MessageBatchReader
+      : public std::enable_shared_from_this<MessageBatchReader> {
+   public:
+    /// Views into reader's buffer, valid until callback returns
+    using Messages = std::span<const BytesIn>;
+    using ReadCallbackFunc = std::function<void(outcome::result<Messages>)>;
+
+    static constexpr size_t kDefaultMaxMessageSize = 16 << 20;
+
+    /// Buffer is at least this big, so that small messages come in batches
+    static constexpr size_t kMinReadSize = 16 << 10;
+
+    /// Larger buffers are released when drained
+    static constexpr size_t kMaxReusedBuffer = 64 << 10;
+
+    /**
+     * @param reader to read messages from
+     * @param max_message_size longer messages fail the read
+     */
+    explicit MessageBatchReader(
+        std::shared_ptr<Reader> reader,
+        size_t max_message_size = kDefaultMaxMessageSize);
+
+    /**
+     * Reads at least one message, callback is called once with all messages
+     * received or with error
+     */
+    void readMany(ReadCallbackFunc cb);
+
+   private:
+    /// Reads into buffer with room for at least `needed` bytes
+    void readSome(size_t needed, ReadCallbackFunc cb);
+
+    /// Decodes complete messages from buffer, returns bytes needed for the
+    /// next one or error
+    outcome::result<size_t> decode();
+
+    std::shared_ptr<Reader> reader_;
+    const size_t max_message_size_;
+
+    /// Received bytes are `buffer_[0, size_)`
+    Bytes buffer_;
+    size_t size_ = 0;
+
+    /// Bytes of messages delivered by previous callback
+    size_t consumed_ = 0;
+
+    std::vector<BytesIn> messages_;
+  };
+
+}  // namespace libp2p::basic
@@ -13,7 +13,8 @@ namespace libp2p::basic {
     SUCCESS = 0,
     BUFFER_IS_EMPTY,
     VARINT_EXPECTED,
-    INTERNAL_ERROR
+    INTERNAL_ERROR,
+    MESSAGE_TOO_LONG
   };
 }
 
@@ -18,6 +18,9 @@ namespace libp2p::basic {
       : public MessageReadWriter,
         public std::enable_shared_from_this<MessageReadWriterUvarint> {
    public:
+    /// Larger buffers are not kept for reuse
+    static constexpr size_t kMaxReusedBuffer = 64 << 10;
+
     /**
      * Create an instance of MessageReadWriter
      * @param conn, from which to read/write messages
@@ -38,6 +41,10 @@ namespace libp2p::basic {
     void write(BytesIn buffer, Writer::WriteCallbackFunc cb) override;
 
    private:
+    /// Buffer of previous message, is reused if nobody else holds it
+    std::shared_ptr<std::vector<uint8_t>> takeBuffer(size_t size);
+
     std::shared_ptr<ReadWriter> conn_;
+    std::shared_ptr<std::vector<uint8_t>> buffer_;
   };
 }  // namespace libp2p::basic
@@ -0,0 +1,106 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <memory>
+#include <new>
+
+namespace libp2p::basic {
+
+  /// Bounded lock-free queue for many producer and many consumer threads.
+  /// Same cells as MpscQueue, but consumers also race for the head index.
+  /// Values must be default constructible and move assignable
+  template <typename T>
+  class MpmcQueue {
+   public:
+    /// Capacity is rounded up to power of two
+    explicit MpmcQueue(size_t capacity)
+        : mask_{std::bit_ceil(std::max<size_t>(capacity, 2)) - 1},
+          cells_{std::make_unique<Cell[]>(mask_ + 1)} {
+      for (size_t i = 0; i <= mask_; ++i) {
+        cells_[i].sequence.store(i, std::memory_order_relaxed);
+      }
+    }
+
+    MpmcQueue(const MpmcQueue &) = delete;
+    MpmcQueue &operator=(const MpmcQueue &) = delete;
+
+    size_t capacity() const {
+      return mask_ + 1;
+    }
+
+    /// Called from any thread, returns false if queue is full
+    bool tryPush(T &&value) {
+      auto pos = tail_.load(std::memory_order_relaxed);
+      Cell *cell = nullptr;
+      while (true) {
+        cell = &cells_[pos & mask_];
+        auto sequence = cell->sequence.load(std::memory_order_acquire);
+        auto diff =
+            static_cast<ptrdiff_t>(sequence) - static_cast<ptrdiff_t>(pos);
+        if (diff == 0) {
+          if (tail_.compare_exchange_weak(
+                  pos, pos + 1, std::memory_order_relaxed)) {
+            break;
+          }
+        } else if (diff < 0) {
+          return false;
+        } else {
+          pos = tail_.load(std::memory_order_relaxed);
+        }
+      }
+      cell->value = std::move(value);
+      cell->sequence.store(pos + 1, std::memory_order_release);
+      return true;
+    }
+
+    /// Called from any thread, returns false if queue is empty
+    bool tryPop(T &value) {
+      auto pos = head_.load(std::memory_order_relaxed);
+      Cell *cell = nullptr;
+      while (true) {
+        cell = &cells_[pos & mask_];
+        auto sequence = cell->sequence.load(std::memory_order_acquire);
+        auto diff = static_cast<ptrdiff_t>(sequence)
+                  - static_cast<ptrdiff_t>(pos + 1);
+        if (diff == 0) {
+          if (head_.compare_exchange_weak(
+                  pos, pos + 1, std::memory_order_relaxed)) {
+            break;
+          }
+        } else if (diff < 0) {
+          return false;
+        } else {
+          pos = head_.load(std::memory_order_relaxed);
+        }
+      }
+      value = std::move(cell->value);
+      // release resources held by moved-from value
+      cell->value = T{};
+      cell->sequence.store(pos + mask_ + 1, std::memory_order_release);
+      return true;
+    }
+
+   private:
+    struct Cell {
+      std::atomic<size_t> sequence;
+      T value{};
+    };
+
+    static constexpr size_t kCacheLine = 64;
+
+    const size_t mask_;
+    std::unique_ptr<Cell[]> cells_;
+    alignas(kCacheLine) std::atomic<size_t> tail_{0};
+    alignas(kCacheLine) std::atomic<size_t> head_{0};
+  };
+
+}  // namespace libp2p::basic
@@ -6,18 +6,22 @@
 
 #pragma once
 
-#include <deque>
+#include <memory>
 #include <vector>
 
 #include <boost/optional.hpp>
 
+#include <libp2p/basic/buffer_pool.hpp>
 #include <libp2p/common/types.hpp>
 
 namespace libp2p::basic {
 
+  /// Buffer of incoming data, kept in fixed size chunks taken from pool.
+  /// Chunks are returned to the pool as soon as they are consumed, so empty
+  /// buffer holds no memory
   class ReadBuffer {
    public:
-    static constexpr size_t kDefaultAllocGranularity = 65536;
+    static constexpr size_t kDefaultChunkSize = 16 * 1024;
 
     ReadBuffer(const ReadBuffer &) = delete;
     ReadBuffer &operator=(const ReadBuffer &) = delete;
@@ -26,7 +30,10 @@ namespace libp2p::basic {
     ReadBuffer(ReadBuffer &&) = default;
     ReadBuffer &operator=(ReadBuffer &&) = default;
 
-    explicit ReadBuffer(size_t alloc_granularity = kDefaultAllocGranularity);
+    explicit ReadBuffer(std::shared_ptr<BufferPool> pool = defaultPool());
+
+    /// Pool of `kDefaultChunkSize` chunks shared by read buffers
+    static const std::shared_ptr<BufferPool> &defaultPool();
 
     size_t size() const {
       return total_size_;
@@ -45,32 +52,42 @@ namespace libp2p::basic {
     /// Returns # of bytes actually copied into out
     size_t addAndConsume(BytesIn in, BytesOut out);
 
+    /// Returns contiguous unconsumed bytes from the beginning, which may be
+    /// less than size(). Valid until buffer is modified
+    BytesIn peek() const;
+
+    /// Consumes n bytes without copying
+    void skip(size_t n);
+
+    /// Consumes up to n contiguous bytes without copying, returned slice
+    /// keeps its chunk out of the pool
+    BufferSlice take(size_t n);
+
     /// Clears and deallocates
     void clear();
 
    private:
-    using Fragment = std::vector<uint8_t>;
+    /// Unconsumed bytes of the 1st chunk
+    size_t frontSize() const;
 
-    /// Consumes all data into out
-    size_t consumeAll(BytesOut out);
+    std::shared_ptr<BufferPool> pool_;
 
-    /// Consumes the 1st fragment or part of it
-    size_t consumePart(uint8_t *out, size_t n);
+    /// Chunks in use from `first_chunk_`, which is consumed from
+    /// `first_byte_offset_`, the last is filled up to `last_chunk_size_`.
+    /// Unlike deque, empty vector allocates nothing, so do idle buffers
+    std::vector<BufferSlice> chunks_;
 
-    /// Granularity for coarse allocation
-    size_t alloc_granularity_;
+    /// Consumed chunks before it are released and erased in batches
+    size_t first_chunk_ = 0;
 
     /// Total size of unconsumed bytes
-    size_t total_size_;
-
-    /// The 1st fragment may advance
-    size_t first_byte_offset_;
+    size_t total_size_ = 0;
 
-    /// Available allocated bytes remains in the last fragment
-    size_t capacity_remains_;
+    /// The 1st chunk may advance
+    size_t first_byte_offset_ = 0;
 
-    /// Fragments allocated
-    std::deque<Fragment> fragments_;
+    /// Bytes written to the last chunk
+    size_t last_chunk_size_ = 0;
   };
 
   /// Temporary buffer for incoming messages, filled from incoming (network)
@@ -6,9 +6,9 @@
 
 #pragma once
 
-#include <functional>
 #include <vector>
 
+#include <libp2p/common/inline_function.hpp>
 #include <libp2p/common/types.hpp>
 #include <libp2p/outcome/outcome.hpp>
 
@@ -16,7 +16,7 @@ namespace libp2p::basic {
 
   struct Reader {
     using ReadCallback = void(outcome::result<size_t> /*read bytes*/);
-    using ReadCallbackFunc = std::function<ReadCallback>;
+    using ReadCallbackFunc = InlineFunction<ReadCallback>;
 
     virtual ~Reader() = default;
 
@@ -7,10 +7,14 @@
 #pragma once
 
 #include <chrono>
+#include <cstdint>
 #include <functional>
 #include <memory>
+#include <source_location>
 
 #include <libp2p/basic/cancel.hpp>
+#include <libp2p/basic/timer.hpp>
+#include <libp2p/common/inline_function.hpp>
 
 namespace libp2p::basic {
   /**
@@ -27,21 +31,75 @@ namespace libp2p::basic {
        * Performance concerns
        */
       std::chrono::milliseconds max_timer_threshold = kMaxTimerThreshold;
+
+      static constexpr std::chrono::milliseconds kStallThreshold =
+          std::chrono::milliseconds(100);
+
+      /**
+       * Callbacks running longer block the event loop, they are logged with
+       * place where they were scheduled. Zero disables logging
+       */
+      std::chrono::milliseconds stall_threshold = kStallThreshold;
+
+      static constexpr size_t kDrainBudget = 64;
+
+      /**
+       * Deferred callbacks run per IO loop cycle, then the loop gets back to
+       * socket completions
+       */
+      size_t drain_budget = kDrainBudget;
+
+      static constexpr size_t kMaxSkips = 4;
+
+      /**
+       * Cycles a lower priority class may be skipped while higher ones use
+       * up the budget, then one of its callbacks runs first
+       */
+      size_t max_skips = kMaxSkips;
     };
 
+    /// Class of deferred callback, lower value runs first
+    enum class Priority : uint8_t {
+      /// Completions of socket, stream and crypto operations
+      IO,
+      /// Protocol replies, timeouts and heartbeats, default
+      CONTROL,
+      /// Maintenance, runs one per cycle when other classes are empty
+      BACKGROUND,
+    };
+    static constexpr size_t kPriorities = 3;
+
     using Handle = Cancel;
 
-    using Callback = std::function<void()>;
+    using Callback = InlineFunction<void()>;
     using Time = std::chrono::milliseconds;
 
+    /// Place where callback was scheduled, reported for slow callbacks
+    using Origin = std::source_location;
+
     virtual ~Scheduler() = default;
 
     /**
-     * Defers callback to be executed during the next IO loop cycle
+     * Defers callback to be executed during the next IO loop cycle.
+     * Only posts to the backend, so it may be called from other threads,
+     * e.g. by workers passing results back
      * @param cb callback
      */
-    void schedule(Callback &&cb) {
-      std::ignore = scheduleImpl(std::move(cb), Time::zero(), false);
+    void schedule(Callback &&cb, Origin origin = Origin::current()) {
+      schedule(std::move(cb), Priority::CONTROL, origin);
+    }
+
+    /**
+     * Defers callback to be executed during the next IO loop cycle,
+     * after deferred callbacks of higher priority
+     * @param cb callback
+     * @param priority class of callback
+     */
+    void schedule(Callback &&cb,
+                  Priority priority,
+                  Origin origin = Origin::current()) {
+      std::ignore = scheduleImpl(
+          std::move(cb), Time::zero(), false, priority, origin);
     }
 
     /**
@@ -49,8 +107,25 @@ namespace libp2p::basic {
      * @param cb callback
      * @param delay_from_now time interval
      */
-    void schedule(Callback &&cb, std::chrono::milliseconds delay_from_now) {
-      std::ignore = scheduleImpl(std::move(cb), delay_from_now, false);
+    void schedule(Callback &&cb,
+                  std::chrono::milliseconds delay_from_now,
+                  Origin origin = Origin::current()) {
+      schedule(std::move(cb), delay_from_now, Priority::CONTROL, origin);
+    }
+
+    /**
+     * Schedules callback to be executed after interval given.
+     * Due background callbacks are deferred as if scheduled without delay
+     * @param cb callback
+     * @param delay_from_now time interval
+     * @param priority class of callback
+     */
+    void schedule(Callback &&cb,
+                  std::chrono::milliseconds delay_from_now,
+                  Priority priority,
+                  Origin origin = Origin::current()) {
+      std::ignore = scheduleImpl(
+          std::move(cb), delay_from_now, false, priority, origin);
     }
 
     /**
@@ -59,8 +134,10 @@ namespace libp2p::basic {
      * @return handle which can be used for cancelling, rescheduling, and scoped
      * lifetime
      */
-    [[nodiscard]] Handle scheduleWithHandle(Callback &&cb) {
-      return scheduleImpl(std::move(cb), Time::zero(), true);
+    [[nodiscard]] Handle scheduleWithHandle(Callback &&cb,
+                                            Origin origin = Origin::current()) {
+      return scheduleImpl(
+          std::move(cb), Time::zero(), true, Priority::CONTROL, origin);
     }
 
     /**
@@ -71,8 +148,44 @@ namespace libp2p::basic {
      * lifetime
      */
     [[nodiscard]] Handle scheduleWithHandle(
-        Callback &&cb, std::chrono::milliseconds delay_from_now) {
-      return scheduleImpl(std::move(cb), delay_from_now, true);
+        Callback &&cb,
+        std::chrono::milliseconds delay_from_now,
+        Origin origin = Origin::current()) {
+      return scheduleWithHandle(
+          std::move(cb), delay_from_now, Priority::CONTROL, origin);
+    }
+
+    /**
+     * Schedules callback of priority given to be executed after interval
+     * @param cb callback
+     * @param delay_from_now time interval, zero for deferring
+     * @param priority class of callback
+     * @return handle which can be used for cancelling, rescheduling, and scoped
+     * lifetime
+     */
+    [[nodiscard]] Handle scheduleWithHandle(
+        Callback &&cb,
+        std::chrono::milliseconds delay_from_now,
+        Priority priority,
+        Origin origin = Origin::current()) {
+      return scheduleImpl(
+          std::move(cb), delay_from_now, true, priority, origin);
+    }
+
+    /**
+     * Arms timer embedded in the caller to call callback after interval
+     * given, but not earlier than the next tick. Armed timer is rearmed.
+     * Schedulers with intrusive timers allocate nothing here, others fall
+     * back to scheduleWithHandle
+     * @param timer timer, which owns callback until it is called or cancelled
+     * @param cb callback
+     * @param delay_from_now time interval
+     */
+    void arm(Timer &timer,
+             Callback &&cb,
+             std::chrono::milliseconds delay_from_now,
+             Origin origin = Origin::current()) {
+      armImpl(timer, std::move(cb), delay_from_now, origin);
     }
 
     /**
@@ -86,7 +199,9 @@ namespace libp2p::basic {
      */
     [[maybe_unused]] Handle scheduleImpl(Callback &cb,
                                          std::chrono::milliseconds,
-                                         bool) = delete;
+                                         bool,
+                                         Priority,
+                                         const Origin &) = delete;
 
    protected:
     /**
@@ -94,10 +209,26 @@ namespace libp2p::basic {
      * @param cb callback
      * @param delay_from_now time interval, zero for deferring
      * @param make_handle if true, then active Handle is returned
+     * @param priority class of callback, when deferred or due
+     * @param origin place where callback was scheduled
      * @return actie or empty Handle, depending on make_handle argument
      */
     virtual Handle scheduleImpl(Callback &&cb,
                                 std::chrono::milliseconds delay_from_now,
-                                bool make_handle) = 0;
+                                bool make_handle,
+                                Priority priority,
+                                const Origin &origin) = 0;
+
+    /**
+     * Called from arm()
+     */
+    virtual void armImpl(Timer &timer,
+                         Callback &&cb,
+                         std::chrono::milliseconds delay_from_now,
+                         const Origin &origin) {
+      timer.cancel();
+      timer.handle_ = scheduleImpl(
+          std::move(cb), delay_from_now, true, Priority::CONTROL, origin);
+    }
   };
 }  // namespace libp2p::basic
@@ -27,7 +27,7 @@ namespace libp2p::basic {
     explicit AsioSchedulerBackend(
         std::shared_ptr<boost::asio::io_context> io_context);
 
-    void post(std::function<void()> &&) override;
+    void post(Callback &&) override;
 
     /**
      * @return Milliseconds since steady clock's epoch
@@ -55,4 +55,22 @@ namespace libp2p::basic {
     boost::asio::steady_timer timer_;
   };
 
+  /// Busy polling run mode of io_context
+  struct BusyPollConfig {
+    /// Time to keep polling for ready handlers after the last one, before
+    /// sleeping in epoll. Zero sleeps at once, as io_context::run()
+    std::chrono::microseconds budget{50};
+  };
+
+  /**
+   * Runs io_context like io_context::run(), but spins with poll() for
+   * budget after handlers before blocking, so that thread doesn't pay
+   * wakeup latency of sleeping in epoll. Burns CPU while spinning, so it is
+   * meant for threads of latency sensitive io_context shards, the other
+   * shards keep run(). Pairs with TcpSocketOptions::busy_poll
+   * @return number of handlers executed
+   */
+  size_t runBusyPolling(boost::asio::io_context &io_context,
+                        BusyPollConfig config);
+
 }  // namespace libp2p::basic
@@ -7,9 +7,10 @@
 #pragma once
 
 #include <chrono>
-#include <functional>
 #include <memory>
 
+#include <libp2p/common/inline_function.hpp>
+
 namespace libp2p::basic {
   /**
    * Feedback from scheduler backend to Scheduler implementation.
@@ -33,12 +34,14 @@ namespace libp2p::basic {
    */
   class SchedulerBackend {
    public:
+    using Callback = InlineFunction<void()>;
+
     virtual ~SchedulerBackend() = default;
 
     /**
      * boost::asio::io_context::post
      */
-    virtual void post(std::function<void()> &&) = 0;
+    virtual void post(Callback &&) = 0;
 
     /**
      * Current async
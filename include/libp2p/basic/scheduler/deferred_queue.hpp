@@ -0,0 +1,93 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <deque>
+
+#include <libp2p/basic/scheduler.hpp>
+
+namespace libp2p::basic {
+
+  /**
+   * Deferred callbacks of scheduler, queued by priority.
+   * Each drain runs up to budget callbacks, higher classes first, and at most
+   * one background callback, only when other classes are empty.
+   * Class skipped for `max_skips` drains in a row runs one callback first in
+   * the next drain, so no class starves under load
+   */
+  template <typename T>
+  class DeferredQueue {
+   public:
+    using Priority = Scheduler::Priority;
+
+    explicit DeferredQueue(const Scheduler::Config &config)
+        : budget_{std::max<size_t>(config.drain_budget, 1)},
+          max_skips_{config.max_skips} {}
+
+    void push(Priority priority, T &&item) {
+      queues_.at(static_cast<size_t>(priority)).emplace_back(std::move(item));
+    }
+
+    bool empty() const {
+      return std::ranges::all_of(queues_,
+                                 [](const auto &queue) { return queue.empty(); });
+    }
+
+    size_t size(Priority priority) const {
+      return queues_.at(static_cast<size_t>(priority)).size();
+    }
+
+    /**
+     * Runs callbacks of one IO loop cycle
+     * @param run called with each item taken from queue
+     * @return true if items remain for next drain
+     */
+    template <typename F>
+    bool drain(const F &run) {
+      constexpr auto kBackground = static_cast<size_t>(Priority::BACKGROUND);
+      std::array<bool, Scheduler::kPriorities> ran{};
+      size_t count = 0;
+      auto run_one = [&](size_t i) {
+        // popped before run, callback may push
+        auto item = std::move(queues_[i].front());
+        queues_[i].pop_front();
+        ran[i] = true;
+        ++count;
+        run(item);
+      };
+      for (size_t i = 1; i < queues_.size(); ++i) {
+        if (skipped_[i] >= max_skips_ and not queues_[i].empty()) {
+          run_one(i);
+        }
+      }
+      for (size_t i = 0; i < kBackground; ++i) {
+        while (count < budget_ and not queues_[i].empty()) {
+          run_one(i);
+        }
+      }
+      if (not ran[kBackground] and count < budget_
+          and not queues_[kBackground].empty()
+          and std::all_of(queues_.begin(),
+                          queues_.begin() + kBackground,
+                          [](const auto &queue) { return queue.empty(); })) {
+        run_one(kBackground);
+      }
+      for (size_t i = 1; i < queues_.size(); ++i) {
+        skipped_[i] = ran[i] or queues_[i].empty() ? 0 : skipped_[i] + 1;
+      }
+      return not empty();
+    }
+
+   private:
+    size_t budget_;
+    size_t max_skips_;
+    std::array<std::deque<T>, Scheduler::kPriorities> queues_;
+    std::array<size_t, Scheduler::kPriorities> skipped_{};
+  };
+}  // namespace libp2p::basic
@@ -0,0 +1,95 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+
+#include <libp2p/basic/mpsc_queue.hpp>
+#include <libp2p/basic/scheduler.hpp>
+
+namespace libp2p::basic {
+
+  /**
+   * Passes messages from other threads into scheduler thread.
+   * Messages go to bounded lock-free queue, and only the first message
+   * after drain schedules a call, so posting doesn't allocate nor lock per
+   * message. Queue is drained in batches, the handler is called for each
+   * message in order of posting.
+   * Use Scheduler::Callback as message to post arbitrary calls.
+   * Scheduler must accept schedule() without delay from other threads, as
+   * SchedulerImpl and TimerWheelScheduler over asio backend do
+   */
+  template <typename Message>
+  class SchedulerInbox
+      : public std::enable_shared_from_this<SchedulerInbox<Message>> {
+   public:
+    using Handler = std::function<void(Message &&)>;
+
+    /// Drained messages per scheduled call, rest are drained by next call
+    static constexpr size_t kDefaultBatch = 256;
+
+    SchedulerInbox(std::shared_ptr<Scheduler> scheduler,
+                   size_t capacity,
+                   Handler handler,
+                   size_t batch = kDefaultBatch)
+        : scheduler_{std::move(scheduler)},
+          queue_{capacity},
+          handler_{std::move(handler)},
+          batch_{std::max<size_t>(batch, 1)} {}
+
+    /**
+     * Called from any thread.
+     * @return false if inbox is full, message is not taken
+     */
+    bool post(Message &&message) {
+      if (not queue_.tryPush(std::move(message))) {
+        return false;
+      }
+      wakeup();
+      return true;
+    }
+
+    size_t capacity() const {
+      return queue_.capacity();
+    }
+
+   private:
+    void wakeup() {
+      if (scheduled_.exchange(true)) {
+        return;
+      }
+      scheduler_->schedule([weak_self{this->weak_from_this()}] {
+        if (auto self = weak_self.lock()) {
+          self->drain();
+        }
+      });
+    }
+
+    void drain() {
+      // messages pushed after this point schedule next drain
+      scheduled_.store(false);
+      Message message;
+      for (size_t i = 0; i < batch_; ++i) {
+        if (not queue_.tryPop(message)) {
+          return;
+        }
+        handler_(std::move(message));
+      }
+      // let other callbacks run before the rest
+      wakeup();
+    }
+
+    std::shared_ptr<Scheduler> scheduler_;
+    MpscQueue<Message> queue_;
+    Handler handler_;
+    const size_t batch_;
+    std::atomic_bool scheduled_ = false;
+  };
+
+}  // namespace libp2p::basic
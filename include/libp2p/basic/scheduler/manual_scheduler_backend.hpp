@@ -18,12 +18,10 @@ namespace libp2p::basic {
    * internal pseudo timer. Injected into SchedulerImpl.
    */
   class ManualSchedulerBackend : public SchedulerBackend {
-    using Callback = std::function<void()>;
-
    public:
     ManualSchedulerBackend() : current_clock_(1) {}
 
-    void post(std::function<void()> &&) override;
+    void post(Callback &&) override;
 
     /**
      * @return Milliseconds since clock's epoch. Clock is set manually
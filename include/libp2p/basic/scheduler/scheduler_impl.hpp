@@ -13,6 +13,8 @@
 
 #include <libp2p/basic/scheduler.hpp>
 #include <libp2p/basic/scheduler/backend.hpp>
+#include <libp2p/basic/scheduler/deferred_queue.hpp>
+#include <libp2p/basic/scheduler/watchdog.hpp>
 
 namespace libp2p::basic {
 
@@ -33,24 +35,61 @@ namespace libp2p::basic {
     /// Scheduler API impl
     Handle scheduleImpl(Callback &&cb,
                         std::chrono::milliseconds delay_from_now,
-                        bool make_handle) override;
+                        bool make_handle,
+                        Priority priority,
+                        const Origin &origin) override;
 
     /// Timer callback, called from SchedulerBackend
     void pulse() override;
 
+   protected:
+    /// Timers are kept in intrusive list apart from other callbacks
+    void armImpl(Timer &timer,
+                 Callback &&cb,
+                 std::chrono::milliseconds delay_from_now,
+                 const Origin &origin) override;
+
    private:
+    struct Pending;
+
     size_t callReady(Time now);
 
+    /// Runs callback unless cancelled
+    void call(Pending &pending);
+
+    /// Queues callback by priority for the next IO loop cycle
+    void defer(Pending &&pending);
+
+    /// Posts drain of deferred callbacks unless posted
+    void postDrain();
+
+    /// Runs deferred callbacks of one IO loop cycle
+    void drain();
+
+    /// Calls due intrusive timers
+    size_t fireTimers(Time now);
+
+    /// Sets backend timer unless the one set fires in time for `min`
+    void setTimer(Time now, Time min);
+
     /// Backend implementation
     std::shared_ptr<SchedulerBackend> backend_;
 
     /// Config
     const Scheduler::Config config_;
 
+    /// Measures callbacks and logs slow ones
+    CallbackWatchdog watchdog_;
+
     struct CancelCb;
     using CancelCbPtr = std::shared_ptr<CancelCb>;
     using CancelOrCb = std::variant<CancelCbPtr, Callback>;
-    using Callbacks = std::multimap<Time, CancelOrCb>;
+    struct Pending {
+      CancelOrCb cb;
+      Origin origin;
+      Priority priority;
+    };
+    using Callbacks = std::multimap<Time, Pending>;
     struct CancelCb {
       CancelCb(Callback &&cb) : cb{std::move(cb)} {}
 
@@ -60,6 +99,11 @@ namespace libp2p::basic {
     };
     Callbacks callbacks_;
 
-    Time timer_;
+    DeferredQueue<Pending> deferred_;
+    bool drain_posted_ = false;
+
+    TimerList timers_;
+
+    Time timer_{};
   };
 }  // namespace libp2p::basic
@@ -0,0 +1,149 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <vector>
+
+#include <libp2p/basic/scheduler.hpp>
+#include <libp2p/basic/scheduler/backend.hpp>
+#include <libp2p/basic/scheduler/deferred_queue.hpp>
+#include <libp2p/basic/scheduler/watchdog.hpp>
+
+namespace libp2p::basic {
+
+  /**
+   * Scheduler implementation over hierarchical timer wheel.
+   * Timers are inserted and cancelled in O(1), deferred calls without delay
+   * bypass the wheel and are queued by priority.
+   * Drop-in replacement of SchedulerImpl.
+   */
+  class TimerWheelScheduler
+      : public std::enable_shared_from_this<TimerWheelScheduler>,
+        public Scheduler,
+        public SchedulerBackendFeedback {
+   public:
+    /// One tick is one millisecond, each level has 2^kSlotBits slots
+    static constexpr size_t kSlotBits = 6;
+    static constexpr size_t kSlots = size_t{1} << kSlotBits;
+    /// Levels cover 2^24 ms (4.6 hours), later timers are reinserted
+    static constexpr size_t kLevels = 4;
+
+    /// Ctor, backend is injected
+    TimerWheelScheduler(std::shared_ptr<SchedulerBackend> backend,
+                        Scheduler::Config config);
+
+    /// Returns current async
+    std::chrono::milliseconds now() const override;
+
+    /// Scheduler API impl
+    Handle scheduleImpl(Callback &&cb,
+                        std::chrono::milliseconds delay_from_now,
+                        bool make_handle,
+                        Priority priority,
+                        const Origin &origin) override;
+
+    /// Timer callback, called from SchedulerBackend
+    void pulse() override;
+
+    /// Number of timers in the wheel
+    size_t size() const;
+
+   protected:
+    /// Timers are kept in intrusive list apart from other callbacks
+    void armImpl(Timer &timer,
+                 Callback &&cb,
+                 std::chrono::milliseconds delay_from_now,
+                 const Origin &origin) override;
+
+   private:
+    struct Entry {
+      Entry(Callback &&cb, const Origin &origin, Priority priority)
+          : cb{std::move(cb)}, origin{origin}, priority{priority} {}
+
+      std::atomic_flag cancelled = false;
+      Callback cb;
+      Origin origin;
+      Priority priority;
+      uint64_t tick = 0;
+      /// Position in the wheel, valid while linked
+      bool linked = false;
+      uint8_t level = 0;
+      uint8_t slot = 0;
+      size_t index = 0;
+    };
+    using EntryPtr = std::shared_ptr<Entry>;
+
+    /// Cancelled entries leave null holes, compacted when half are holes
+    struct Slot {
+      std::vector<EntryPtr> entries;
+      size_t live = 0;
+    };
+
+    /// Deferred call, entry is set if cancellable
+    struct Deferred {
+      EntryPtr entry;
+      Callback cb;
+      Origin origin;
+    };
+
+    /// Queues callback by priority for the next IO loop cycle
+    void defer(Priority priority, Deferred &&deferred);
+
+    /// Posts drain of deferred callbacks unless posted
+    void postDrain();
+
+    /// Runs deferred callbacks of one IO loop cycle
+    void drain();
+
+    void insert(EntryPtr entry);
+
+    void remove(Entry &entry);
+
+    /// Unlinks all entries of the slot
+    std::vector<EntryPtr> take(size_t level, size_t slot);
+
+    /// Moves entries of current slot of the level to lower levels
+    void cascade(size_t level);
+
+    /// Fires timers till the tick
+    void advance(uint64_t now);
+
+    /// Next tick where timer expires or cascade is due
+    uint64_t nextTick() const;
+
+    /// Calls due intrusive timers
+    size_t fireTimers(Time now);
+
+    /// Sets backend timer unless the one set fires in time for `min`
+    void setTimer(Time now, Time min);
+
+    /// Backend implementation
+    std::shared_ptr<SchedulerBackend> backend_;
+
+    /// Config
+    const Scheduler::Config config_;
+
+    /// Measures callbacks and logs slow ones
+    CallbackWatchdog watchdog_;
+
+    DeferredQueue<Deferred> deferred_;
+    bool drain_posted_ = false;
+
+    std::array<std::array<Slot, kSlots>, kLevels> wheel_;
+    /// Bitmap of non-empty slots per level
+    std::array<uint64_t, kLevels> occupied_{};
+    /// Next tick to process
+    uint64_t current_tick_;
+    size_t size_ = 0;
+
+    TimerList timers_;
+
+    Time timer_{};
+  };
+}  // namespace libp2p::basic
@@ -0,0 +1,28 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <libp2p/basic/scheduler.hpp>
+
+namespace libp2p::basic {
+
+  /**
+   * Runs scheduler callbacks and measures their execution time.
+   * Callbacks running longer than threshold block the event loop, they are
+   * logged with place where they were scheduled
+   */
+  class CallbackWatchdog {
+   public:
+    /// Zero threshold disables logging, time is measured anyway
+    explicit CallbackWatchdog(std::chrono::milliseconds threshold);
+
+    void run(Scheduler::Callback &cb, const Scheduler::Origin &origin) const;
+
+   private:
+    std::chrono::steady_clock::duration threshold_;
+  };
+}  // namespace libp2p::basic
@@ -0,0 +1,151 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <chrono>
+#include <source_location>
+
+#include <libp2p/basic/cancel.hpp>
+#include <libp2p/common/inline_function.hpp>
+
+namespace libp2p::basic {
+  class Scheduler;
+  class TimerList;
+
+  /**
+   * Timer embedded in the owning object, armed with Scheduler::arm.
+   * It is a node of intrusive list of scheduler, so arming, rearming and
+   * cancelling allocate nothing, and the node is unlinked in O(1) when timer
+   * is cancelled or destroyed. Used from scheduler thread only.
+   */
+  class Timer {
+   public:
+    Timer() = default;
+
+    ~Timer() {
+      cancel();
+    }
+
+    // node is linked by address
+    Timer(const Timer &) = delete;
+    Timer(Timer &&) = delete;
+    Timer &operator=(const Timer &) = delete;
+    Timer &operator=(Timer &&) = delete;
+
+    /// Callback is not called unless timer is armed again
+    inline void cancel();
+
+   private:
+    friend class Scheduler;
+    friend class TimerList;
+
+    TimerList *list_ = nullptr;
+    Timer *prev_ = nullptr;
+    Timer *next_ = nullptr;
+    std::chrono::milliseconds due_{};
+    InlineFunction<void()> cb_;
+    std::source_location origin_;
+
+    /// Handle of schedulers without intrusive timers
+    Cancel handle_;
+  };
+
+  /**
+   * Armed timers of scheduler ordered by due time.
+   * Timers are inserted from the tail, so insertion is O(1) for timers due
+   * not earlier than the latest one, which is the case of fixed timeouts
+   */
+  class TimerList {
+   public:
+    using Time = std::chrono::milliseconds;
+
+    TimerList() = default;
+
+    /// Timers outliving scheduler are left unlinked
+    ~TimerList() {
+      while (head_ != nullptr) {
+        remove(*head_);
+      }
+    }
+
+    TimerList(const TimerList &) = delete;
+    TimerList(TimerList &&) = delete;
+    TimerList &operator=(const TimerList &) = delete;
+    TimerList &operator=(TimerList &&) = delete;
+
+    void insert(Timer &timer,
+                Time due,
+                InlineFunction<void()> &&cb,
+                const std::source_location &origin) {
+      timer.cancel();
+      timer.cb_ = std::move(cb);
+      timer.due_ = due;
+      timer.origin_ = origin;
+      auto *prev = tail_;
+      while (prev != nullptr and due < prev->due_) {
+        prev = prev->prev_;
+      }
+      timer.list_ = this;
+      timer.prev_ = prev;
+      timer.next_ = prev != nullptr ? prev->next_ : head_;
+      (timer.next_ != nullptr ? timer.next_->prev_ : tail_) = &timer;
+      (prev != nullptr ? prev->next_ : head_) = &timer;
+    }
+
+    void remove(Timer &timer) {
+      (timer.prev_ != nullptr ? timer.prev_->next_ : head_) = timer.next_;
+      (timer.next_ != nullptr ? timer.next_->prev_ : tail_) = timer.prev_;
+      timer.list_ = nullptr;
+      timer.prev_ = nullptr;
+      timer.next_ = nullptr;
+      timer.cb_ = nullptr;
+    }
+
+    bool empty() const {
+      return head_ == nullptr;
+    }
+
+    /// Due time of the first timer, list must not be empty
+    Time nextDue() const {
+      return head_->due_;
+    }
+
+    /**
+     * Unlinks and calls timers due by `now`. Callbacks may arm, cancel and
+     * destroy timers. Timers are armed at least a tick ahead, so the ones
+     * armed by callbacks are not called until next time
+     * @param run calls callback, given its lag and origin
+     * @return number of called timers
+     */
+    template <typename Run>
+    size_t fire(Time now, const Run &run) {
+      size_t fired = 0;
+      while (head_ != nullptr and head_->due_ <= now) {
+        auto &timer = *head_;
+        auto lag = now - timer.due_;
+        auto origin = timer.origin_;
+        // timer may be destroyed by its callback
+        auto cb = std::move(timer.cb_);
+        remove(timer);
+        ++fired;
+        run(lag, cb, origin);
+      }
+      return fired;
+    }
+
+   private:
+    Timer *head_ = nullptr;
+    Timer *tail_ = nullptr;
+  };
+
+  inline void Timer::cancel() {
+    if (list_ != nullptr) {
+      list_->remove(*this);
+    }
+    handle_.reset();
+  }
+}  // namespace libp2p::basic
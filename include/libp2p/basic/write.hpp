@@ -9,6 +9,7 @@
 #include <boost/asio/error.hpp>
 #include <libp2p/basic/writer.hpp>
 #include <memory>
+#include <vector>
 
 namespace libp2p {
   /// Write exactly `in.size()` bytes
@@ -43,4 +44,50 @@ namespace libp2p {
           write(writer, in.subspan(n), std::move(cb));
         });
   }
+
+  /// Write all bytes of `in` buffers in order, `writeSomeVectored` may take
+  /// several of them at once
+  inline void writeVectored(const std::shared_ptr<basic::Writer> &writer,
+                            std::vector<BytesIn> in,
+                            std::function<void(outcome::result<void>)> cb) {
+    std::erase_if(in, [](BytesIn buffer) { return buffer.empty(); });
+    if (in.empty()) {
+      return cb(outcome::success());
+    }
+    // moved vector keeps its storage, so the span stays valid
+    std::span<const BytesIn> buffers{in};
+    writer->writeSomeVectored(
+        buffers,
+        [weak{std::weak_ptr{writer}}, in{std::move(in)}, cb{std::move(cb)}](
+            outcome::result<size_t> n_res) mutable {
+          if (n_res.has_error()) {
+            return cb(n_res.error());
+          }
+          auto n = n_res.value();
+          if (n == 0) {
+            throw std::logic_error{"libp2p::writeVectored zero bytes written"};
+          }
+          size_t i = 0;
+          while (i < in.size() and n >= in[i].size()) {
+            n -= in[i].size();
+            ++i;
+          }
+          if (i == in.size()) {
+            if (n != 0) {
+              throw std::logic_error{
+                  "libp2p::writeVectored too much bytes written"};
+            }
+            // successfully wrote last bytes
+            return cb(outcome::success());
+          }
+          in[i] = in[i].subspan(n);
+          in.erase(in.begin(), in.begin() + static_cast<ptrdiff_t>(i));
+          // write remaining bytes
+          auto writer = weak.lock();
+          if (not writer) {
+            return cb(make_error_code(boost::asio::error::operation_aborted));
+          }
+          writeVectored(writer, std::move(in), std::move(cb));
+        });
+  }
 }  // namespace libp2p
@@ -6,7 +6,7 @@
 
 #pragma once
 
-#include <deque>
+#include <span>
 #include <vector>
 
 #include <libp2p/basic/writer.hpp>
@@ -19,9 +19,17 @@ namespace libp2p::basic {
 
     static constexpr size_t kDefaultSizeLimit = 64 * 1024 * 1024;
 
+    /// Acknowledged items are kept for reuse up to this number
+    static constexpr size_t kMaxFreeItems = 16;
+
     explicit WriteQueue(size_t size_limit = kDefaultSizeLimit)
         : size_limit_(size_limit) {}
 
+    WriteQueue(const WriteQueue &) = delete;
+    WriteQueue &operator=(const WriteQueue &) = delete;
+
+    ~WriteQueue();
+
     /// Returns false if size will overflow the buffer
     bool canEnqueue(size_t size) const;
 
@@ -34,6 +42,11 @@ namespace libp2p::basic {
     /// Returns new window size
     size_t dequeue(size_t window_size, DataRef &out);
 
+    /// Dequeues unsent parts of as many items as fit into window and out,
+    /// to be sent by one gather write. Shrinks out to chunks dequeued,
+    /// returns new window size
+    size_t dequeueMany(size_t window_size, std::span<DataRef> &out);
+
     struct AckResult {
       // callback to be called to ack data was sent
       Writer::WriteCallbackFunc cb;
@@ -41,11 +54,15 @@ namespace libp2p::basic {
       // size to acknowledge, may differ from ack()'s size arg
       size_t size_to_ack = 0;
 
+      // bytes of size arg accounted, the rest belongs to next items
+      size_t size_acked = 0;
+
       // set to false if invalid arg or inconsistency
       bool data_consistent = true;
     };
 
-    /// Calls write callback if full message was sent,
+    /// Acknowledges bytes sent of the oldest item, calls write callback if
+    /// full message was sent. Call again while size_acked < size,
     /// returns callback to ack + true if ok or false on inconsistency
     [[nodiscard]] AckResult ackDataSent(size_t size);
 
@@ -56,28 +73,49 @@ namespace libp2p::basic {
     void clear();
 
    private:
-    /// Data item w/callback
+    /// Data item w/callback, node of intrusive list
     struct Data {
       // data reference
       BytesIn data;
 
       // allow to send large messages partially
-      size_t acknowledged;
+      size_t acknowledged = 0;
 
       // was sent during write operation, not acknowledged yet
-      size_t unacknowledged;
+      size_t unacknowledged = 0;
 
       // remaining bytes to dequeue
-      size_t unsent;
+      size_t unsent = 0;
 
       // callback
       basic::Writer::WriteCallbackFunc cb;
+
+      // next item in queue or in free list
+      Data *next = nullptr;
     };
 
+    /// Takes item from free list or allocates it
+    Data *allocate();
+
+    /// Returns item to free list or deallocates it
+    void recycle(Data *item);
+
     size_t size_limit_;
-    size_t active_index_ = 0;
     size_t total_unsent_size_ = 0;
-    std::deque<Data> queue_;
+    size_t items_count_ = 0;
+    size_t free_count_ = 0;
+
+    /// Oldest item, the one to be acknowledged next
+    Data *head_ = nullptr;
+
+    /// Newest item
+    Data *tail_ = nullptr;
+
+    /// Item to dequeue from, null if everything was dequeued
+    Data *active_ = nullptr;
+
+    /// Items for reuse
+    Data *free_ = nullptr;
   };
 
 }  // namespace libp2p::basic
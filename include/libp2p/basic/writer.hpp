@@ -6,8 +6,7 @@
 
 #pragma once
 
-#include <functional>
-
+#include <libp2p/common/inline_function.hpp>
 #include <libp2p/common/types.hpp>
 #include <libp2p/outcome/outcome.hpp>
 
@@ -15,7 +14,7 @@ namespace libp2p::basic {
 
   struct Writer {
     using WriteCallback = void(outcome::result<size_t> /*written bytes*/);
-    using WriteCallbackFunc = std::function<WriteCallback>;
+    using WriteCallbackFunc = InlineFunction<WriteCallback>;
 
     virtual ~Writer() = default;
 
@@ -34,6 +33,30 @@ namespace libp2p::basic {
      */
     virtual void writeSome(BytesIn in, size_t bytes, WriteCallbackFunc cb) = 0;
 
+    /**
+     * @brief Scatter/gather version of writeSome(): writes up to total size
+     * of \param in bytes taken from buffers in order.
+     * Calls \param cb after only some bytes has been successfully written,
+     * so doesn't guarantee that all will be. Returns immediately.
+     * Default implementation writes some bytes of the first non-empty buffer,
+     * layers capable of vectored writes override it
+     * @param in data buffers to write
+     * @param cb callback with result of operation
+     *
+     * @note caller should maintain validity of buffers referred by \param in
+     * until callback is executed, the span of buffers itself may be
+     * released right after this call
+     */
+    virtual void writeSomeVectored(std::span<const BytesIn> in,
+                                   WriteCallbackFunc cb) {
+      for (const auto &buffer : in) {
+        if (not buffer.empty()) {
+          return writeSome(buffer, buffer.size(), std::move(cb));
+        }
+      }
+      writeSome(BytesIn{}, 0, std::move(cb));
+    }
+
     /**
      * @brief Defers reporting error state to callback to avoid reentrancy
      * (i.e. callback will not be called before initiator function returns)
@@ -7,6 +7,8 @@
 #pragma once
 
 #include <cstdint>
+#include <span>
+#include <stdexcept>
 
 namespace libp2p {
   // TODO(turuslan): https://github.com/libp2p/cpp-libp2p/issues/203
@@ -0,0 +1,208 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace libp2p {
+
+  /// Inline buffer size, so that the whole function takes 64 bytes
+  constexpr size_t kInlineFunctionSize = 64 - sizeof(void *);
+
+  template <typename Signature, size_t kInlineSize = kInlineFunctionSize>
+  class InlineFunction;
+
+  /**
+   * Drop-in replacement of std::function for callbacks on hot paths.
+   * std::function keeps inline only small trivially copyable callables, so
+   * every lambda capturing smart pointer or another callback allocates.
+   * InlineFunction keeps any nothrow movable callable up to kInlineSize
+   * bytes inline, larger ones are allocated.
+   */
+  template <typename R, typename... Args, size_t kInlineSize>
+  class InlineFunction<R(Args...), kInlineSize> {
+    template <typename F>
+    static constexpr bool kIsInline =
+        sizeof(F) <= kInlineSize and alignof(F) <= alignof(void *)
+        and std::is_nothrow_move_constructible_v<F>;
+
+    template <typename Signature>
+    static std::true_type isFunction(const std::function<Signature> *);
+    template <typename Signature, size_t kSize>
+    static std::true_type isFunction(const InlineFunction<Signature, kSize> *);
+    static std::false_type isFunction(const void *);
+
+    /// Null pointers and empty functions make empty InlineFunction
+    template <typename F>
+    static constexpr bool kIsNullable =
+        std::is_pointer_v<F> or std::is_member_pointer_v<F>
+        or decltype(isFunction(static_cast<F *>(nullptr)))::value;
+
+    /// Copyability is checked last, it may refer back to InlineFunction
+    template <typename F>
+    static constexpr bool kIsCallable = std::conjunction_v<
+        std::negation<std::is_same<std::decay_t<F>, InlineFunction>>,
+        std::is_invocable_r<R, std::decay_t<F> &, Args...>,
+        std::is_copy_constructible<std::decay_t<F>>>;
+
+   public:
+    InlineFunction() = default;
+
+    InlineFunction(std::nullptr_t) {}  // NOLINT
+
+    template <typename F, typename = std::enable_if_t<kIsCallable<F>>>
+    InlineFunction(F &&f) {  // NOLINT
+      using T = std::decay_t<F>;
+      if constexpr (kIsNullable<T>) {
+        if (not f) {
+          return;
+        }
+      }
+      if constexpr (kIsInline<T>) {
+        new (&storage_) T(std::forward<F>(f));
+      } else {
+        *reinterpret_cast<T **>(&storage_) = new T(std::forward<F>(f));
+      }
+      ops_ = &kOps<T>;
+    }
+
+    InlineFunction(const InlineFunction &other) : ops_{other.ops_} {
+      if (ops_ != nullptr) {
+        ops_->copy(&other.storage_, &storage_);
+      }
+    }
+
+    InlineFunction(InlineFunction &&other) noexcept : ops_{other.ops_} {
+      if (ops_ != nullptr) {
+        ops_->move(&other.storage_, &storage_);
+        other.ops_ = nullptr;
+      }
+    }
+
+    ~InlineFunction() {
+      reset();
+    }
+
+    InlineFunction &operator=(const InlineFunction &other) {
+      if (this != &other) {
+        *this = InlineFunction{other};
+      }
+      return *this;
+    }
+
+    InlineFunction &operator=(InlineFunction &&other) noexcept {
+      if (this != &other) {
+        reset();
+        if (other.ops_ != nullptr) {
+          other.ops_->move(&other.storage_, &storage_);
+          ops_ = std::exchange(other.ops_, nullptr);
+        }
+      }
+      return *this;
+    }
+
+    InlineFunction &operator=(std::nullptr_t) {
+      reset();
+      return *this;
+    }
+
+    template <typename F, typename = std::enable_if_t<kIsCallable<F>>>
+    InlineFunction &operator=(F &&f) {
+      return *this = InlineFunction{std::forward<F>(f)};
+    }
+
+    explicit operator bool() const {
+      return ops_ != nullptr;
+    }
+
+    friend bool operator==(const InlineFunction &f, std::nullptr_t) {
+      return not f;
+    }
+
+    /// Calls callable, which may modify its state like std::function does
+    R operator()(Args... args) const {
+      if (ops_ == nullptr) {
+        throw std::bad_function_call{};
+      }
+      return ops_->invoke(const_cast<Storage *>(&storage_),
+                          std::forward<Args>(args)...);
+    }
+
+    void swap(InlineFunction &other) noexcept {
+      std::swap(*this, other);
+    }
+
+   private:
+    struct Storage {
+      alignas(void *) std::byte bytes[kInlineSize];
+    };
+
+    struct Ops {
+      R (*invoke)(Storage *, Args &&...);
+      void (*copy)(const Storage *, Storage *);
+      void (*move)(Storage *, Storage *) noexcept;
+      void (*destroy)(Storage *) noexcept;
+    };
+
+    template <typename T>
+    static T &get(Storage *storage) {
+      if constexpr (kIsInline<T>) {
+        return *std::launder(reinterpret_cast<T *>(storage));
+      } else {
+        return **reinterpret_cast<T **>(storage);
+      }
+    }
+
+    template <typename T>
+    static const T &get(const Storage *storage) {
+      return get<T>(const_cast<Storage *>(storage));
+    }
+
+    template <typename T>
+    static constexpr Ops kOps{
+        [](Storage *storage, Args &&...args) -> R {
+          return std::invoke(get<T>(storage), std::forward<Args>(args)...);
+        },
+        [](const Storage *from, Storage *to) {
+          if constexpr (kIsInline<T>) {
+            new (to) T(get<T>(from));
+          } else {
+            *reinterpret_cast<T **>(to) = new T(get<T>(from));
+          }
+        },
+        [](Storage *from, Storage *to) noexcept {
+          if constexpr (kIsInline<T>) {
+            new (to) T(std::move(get<T>(from)));
+            get<T>(from).~T();
+          } else {
+            *reinterpret_cast<T **>(to) = *reinterpret_cast<T **>(from);
+          }
+        },
+        [](Storage *storage) noexcept {
+          if constexpr (kIsInline<T>) {
+            get<T>(storage).~T();
+          } else {
+            delete &get<T>(storage);
+          }
+        },
+    };
+
+    void reset() {
+      if (ops_ != nullptr) {
+        std::exchange(ops_, nullptr)->destroy(&storage_);
+      }
+    }
+
+    Storage storage_;
+    const Ops *ops_ = nullptr;
+  };
+
+}  // namespace libp2p
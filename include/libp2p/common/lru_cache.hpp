@@ -0,0 +1,73 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <list>
+#include <unordered_map>
+
+namespace libp2p {
+
+  /**
+   * Cache of limited size, least recently used entry is evicted on overflow
+   */
+  template <typename K, typename V>
+  class LruCache {
+   public:
+    explicit LruCache(size_t capacity) : capacity_(capacity) {}
+
+    /// Value of key, which becomes the most recently used, or null
+    V *get(const K &key) {
+      auto it = index_.find(key);
+      if (it == index_.end()) {
+        return nullptr;
+      }
+      entries_.splice(entries_.begin(), entries_, it->second);
+      return &it->second->second;
+    }
+
+    /// Inserts or replaces value of key
+    V &put(const K &key, V value) {
+      if (auto existing = get(key)) {
+        *existing = std::move(value);
+        return *existing;
+      }
+      if (capacity_ != 0 and entries_.size() >= capacity_) {
+        index_.erase(entries_.back().first);
+        entries_.pop_back();
+      }
+      entries_.emplace_front(key, std::move(value));
+      index_.emplace(key, entries_.begin());
+      return entries_.front().second;
+    }
+
+    void erase(const K &key) {
+      auto it = index_.find(key);
+      if (it == index_.end()) {
+        return;
+      }
+      entries_.erase(it->second);
+      index_.erase(it);
+    }
+
+    void clear() {
+      index_.clear();
+      entries_.clear();
+    }
+
+    size_t size() const {
+      return entries_.size();
+    }
+
+   private:
+    using Entries = std::list<std::pair<K, V>>;
+
+    size_t capacity_;
+    Entries entries_;
+    std::unordered_map<K, typename Entries::iterator> index_;
+  };
+
+}  // namespace libp2p
@@ -0,0 +1,78 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <vector>
+
+#include <libp2p/common/metrics/instance_list.hpp>
+#include <libp2p/common/metrics/traffic.hpp>
+
+namespace libp2p::metrics {
+
+  /// Memory buffered by connection or stream
+  struct MemoryUsage {
+    /// Bytes received and not yet consumed by reader
+    size_t read_buffer = 0;
+
+    /// Bytes queued and not yet written, including caller's buffers held
+    /// until write callback
+    size_t write_queue = 0;
+
+    /// Read, write and close callbacks waiting
+    size_t pending_callbacks = 0;
+
+    MemoryUsage &operator+=(const MemoryUsage &other);
+
+    size_t bytes() const {
+      return read_buffer + write_queue;
+    }
+
+    bool operator==(const MemoryUsage &) const = default;
+  };
+
+  /// Memory of live objects with the same layer, peer and protocol
+  struct MemoryUsageEntry {
+    TrafficKey key;
+
+    /// Number of objects
+    size_t objects = 0;
+
+    MemoryUsage usage;
+  };
+
+  /**
+   * Connection or stream, which reports its buffered memory.
+   * Live reporters are listed when metrics are enabled, so that memory held
+   * by each peer and protocol can be found without walking host state
+   */
+  class MemoryReporter {
+   public:
+    MemoryReporter() = default;
+    MemoryReporter(const MemoryReporter &) = delete;
+    MemoryReporter &operator=(const MemoryReporter &) = delete;
+    virtual ~MemoryReporter() = default;
+
+    virtual MemoryUsage memoryUsage() const = 0;
+
+    /// Layer, peer and protocol the memory is attributed to
+    virtual TrafficKey memoryKey() const = 0;
+
+   private:
+    friend std::vector<MemoryUsageEntry> dumpMemoryUsage();
+
+    LIBP2P_METRICS_INSTANCE_LIST_IF_ENABLED(libp2p::metrics::MemoryReporter);
+  };
+
+  /**
+   * Aggregates memory of live reporters by layer, peer and protocol.
+   * Must be called from the thread of connections, as reporters are read
+   * without synchronization.
+   * Returns nothing unless built with metrics enabled
+   */
+  std::vector<MemoryUsageEntry> dumpMemoryUsage();
+
+}  // namespace libp2p::metrics
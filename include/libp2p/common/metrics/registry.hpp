@@ -0,0 +1,151 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace libp2p::metrics {
+
+  /// Monotonic counter
+  class Counter {
+   public:
+    void inc(uint64_t n = 1) {
+      value_.fetch_add(n, std::memory_order_relaxed);
+    }
+
+    uint64_t value() const {
+      return value_.load(std::memory_order_relaxed);
+    }
+
+   private:
+    std::atomic<uint64_t> value_{0};
+  };
+
+  /// Value which may go up and down
+  class Gauge {
+   public:
+    void add(int64_t n) {
+      value_.fetch_add(n, std::memory_order_relaxed);
+    }
+
+    void sub(int64_t n) {
+      value_.fetch_sub(n, std::memory_order_relaxed);
+    }
+
+    void set(int64_t n) {
+      value_.store(n, std::memory_order_relaxed);
+    }
+
+    int64_t value() const {
+      return value_.load(std::memory_order_relaxed);
+    }
+
+   private:
+    std::atomic<int64_t> value_{0};
+  };
+
+  /// Distribution of observed values over fixed buckets
+  class Histogram {
+   public:
+    struct Snapshot {
+      /// Upper bounds of buckets, +Inf bucket is implicit
+      std::vector<double> bounds;
+      /// Cumulative counts, one per bound plus +Inf
+      std::vector<uint64_t> counts;
+      double sum = 0;
+    };
+
+    explicit Histogram(std::vector<double> bounds);
+
+    void observe(double value);
+
+    /// Observes duration in seconds
+    template <typename Rep, typename Period>
+    void observe(std::chrono::duration<Rep, Period> duration) {
+      observe(std::chrono::duration<double>(duration).count());
+    }
+
+    Snapshot snapshot() const;
+
+   private:
+    const std::vector<double> bounds_;
+    std::unique_ptr<std::atomic<uint64_t>[]> counts_;
+    std::atomic<double> sum_{0};
+  };
+
+  /// Bucket bounds in seconds, from 100us to 10s
+  const std::vector<double> &latencyBuckets();
+
+  /// Receives metrics values from Registry::collect()
+  class Exporter {
+   public:
+    virtual ~Exporter() = default;
+
+    virtual void counter(std::string_view name,
+                         std::string_view help,
+                         uint64_t value) = 0;
+
+    virtual void gauge(std::string_view name,
+                       std::string_view help,
+                       int64_t value) = 0;
+
+    virtual void histogram(std::string_view name,
+                           std::string_view help,
+                           const Histogram::Snapshot &snapshot) = 0;
+
+    /// Live objects of the type, see instance_count.hpp
+    virtual void instanceCount(std::string_view type, size_t count) = 0;
+  };
+
+  /**
+   * Process-wide registry of named metrics.
+   * Metrics are created once under lock, updates of counters, gauges and
+   * histograms are lock-free. References stay valid till the end of process,
+   * so call sites keep them in function-local statics.
+   */
+  class Registry {
+   public:
+    static Registry &instance();
+
+    Counter &counter(const std::string &name, std::string help);
+
+    Gauge &gauge(const std::string &name, std::string help);
+
+    /// Bounds are used only by the first call with the name
+    Histogram &histogram(const std::string &name,
+                         std::string help,
+                         const std::vector<double> &bounds = latencyBuckets());
+
+    /// Reports all metrics in name order
+    void collect(Exporter &exporter) const;
+
+    /// Prometheus text exposition format of all metrics
+    std::string exportText() const;
+
+   private:
+    template <typename T>
+    struct Entry {
+      std::string help;
+      std::unique_ptr<T> metric;
+    };
+
+    Registry() = default;
+
+    mutable std::mutex mutex_;
+    std::map<std::string, Entry<Counter>, std::less<>> counters_;
+    std::map<std::string, Entry<Gauge>, std::less<>> gauges_;
+    std::map<std::string, Entry<Histogram>, std::less<>> histograms_;
+  };
+
+}  // namespace libp2p::metrics
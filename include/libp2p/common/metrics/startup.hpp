@@ -0,0 +1,44 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace libp2p::metrics {
+
+  /// Startup phase which took `duration` of wall time
+  struct StartupPhaseTime {
+    std::string name;
+    std::chrono::steady_clock::duration duration;
+  };
+
+  /**
+   * Measures wall time of scope as startup phase: key generation, SSL
+   * contexts, transport sockets. Each phase is observed by histogram
+   * "libp2p_startup_<name>_seconds" and recorded for startupReport().
+   */
+  class StartupPhase {
+   public:
+    explicit StartupPhase(std::string name);
+    StartupPhase(const StartupPhase &) = delete;
+    StartupPhase &operator=(const StartupPhase &) = delete;
+    ~StartupPhase();
+
+   private:
+    std::string name_;
+    std::chrono::steady_clock::time_point started_;
+  };
+
+  /// Phases ended so far, in order of ending
+  std::vector<StartupPhaseTime> startupPhases();
+
+  /// Phases ended so far as "name 1.23ms, ..." line, for CLI tools to log
+  std::string startupReport();
+
+}  // namespace libp2p::metrics
@@ -0,0 +1,79 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <memory>
+#include <string_view>
+#include <system_error>
+
+namespace libp2p::metrics {
+
+  /**
+   * Span of tracing backend, e.g. adapter of opentelemetry::trace::Span.
+   * Attribute keys and span names are string literals
+   */
+  class TraceSpan {
+   public:
+    virtual ~TraceSpan() = default;
+
+    virtual void setAttribute(std::string_view key, std::string_view value) = 0;
+
+    /// Ends span, with error status unless error is empty. Called once
+    virtual void end(std::error_code error) = 0;
+  };
+
+  /**
+   * Tracing backend, e.g. adapter of opentelemetry::trace::Tracer.
+   * There is none by default, spans cost a null check then
+   */
+  class Tracer {
+   public:
+    virtual ~Tracer() = default;
+
+    /// @param parent span, nullptr for root one
+    virtual std::shared_ptr<TraceSpan> startSpan(std::string_view name,
+                                                 TraceSpan *parent) = 0;
+  };
+
+  /**
+   * Installs tracing backend, nullptr removes it.
+   * Must be called before host starts, spans started before keep old one
+   */
+  void setTracer(std::shared_ptr<Tracer> tracer);
+
+  /**
+   * Copyable handle of span, empty if there is no tracer.
+   * Span ends with end() or when the last copy is destroyed.
+   * Values of attributes should be computed only if span is not empty
+   */
+  class Span {
+   public:
+    /// Empty span
+    Span() = default;
+
+    /// Starts root span
+    explicit Span(std::string_view name);
+
+    /// Starts child span, empty if parent is empty
+    Span child(std::string_view name) const;
+
+    explicit operator bool() const {
+      return impl_ != nullptr;
+    }
+
+    void setAttribute(std::string_view key, std::string_view value) const;
+
+    /// Ends span for all copies
+    void end(std::error_code error = {}) const;
+
+   private:
+    struct Impl;
+
+    std::shared_ptr<Impl> impl_;
+  };
+
+}  // namespace libp2p::metrics
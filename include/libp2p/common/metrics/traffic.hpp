@@ -0,0 +1,175 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <libp2p/peer/peer_id.hpp>
+#include <libp2p/peer/protocol.hpp>
+
+namespace libp2p::metrics {
+
+  /// Connection layer traffic is counted at
+  enum class TrafficLayer : uint8_t {
+    /// Bytes on the wire, as seen by transport connection
+    RAW,
+    /// Plaintext bytes and muxer frames, as seen by muxer
+    SECURE,
+    /// Stream payload, frames and completed reads and writes
+    MUXED,
+  };
+
+  struct TrafficStats {
+    uint64_t bytes_read = 0;
+    uint64_t bytes_written = 0;
+    uint64_t frames_read = 0;
+    uint64_t frames_written = 0;
+    uint64_t messages_read = 0;
+    uint64_t messages_written = 0;
+
+    TrafficStats &operator+=(const TrafficStats &other);
+
+    bool operator==(const TrafficStats &) const = default;
+  };
+
+  /**
+   * Traffic is broken down by layer, peer and protocol.
+   * Peer is unknown until connection is secured, protocol is known only on
+   * muxed layer after multiselect negotiation.
+   */
+  struct TrafficKey {
+    TrafficLayer layer = TrafficLayer::RAW;
+    std::optional<peer::PeerId> peer;
+    peer::ProtocolName protocol;
+
+    bool operator==(const TrafficKey &) const = default;
+  };
+
+  /**
+   * Process-wide traffic accounting.
+   * Counters are per-thread, so updates are plain loads and stores of
+   * thread-owned cells. Totals are aggregated lazily by readers.
+   * Keys are never freed, since cells of other threads point to them, so
+   * their number is capped. Once the cap is reached, traffic of new keys is
+   * counted by the "other" key of their layer, without peer.
+   */
+  class Traffic {
+   public:
+    static constexpr size_t kDefaultMaxKeys = 4096;
+    /// Protocol of the key counting traffic of keys over the cap
+    static constexpr std::string_view kOtherProtocol = "other";
+
+    static Traffic &instance();
+
+    /// Returns stable pointer to the key, valid till the end of process
+    const TrafficKey *intern(TrafficKey key);
+
+    /// Keys interned after the cap is reached are counted as "other"
+    void setMaxKeys(size_t max_keys);
+
+    /// Number of interned keys, including "other" ones
+    size_t keyCount() const;
+
+    void add(const TrafficKey *key,
+             bool read,
+             uint64_t bytes,
+             uint64_t frames,
+             uint64_t messages);
+
+    /// Aggregated counters of all keys
+    std::vector<std::pair<TrafficKey, TrafficStats>> snapshot() const;
+
+    TrafficStats total(TrafficLayer layer) const;
+
+    std::unordered_map<peer::PeerId, TrafficStats> byPeer(
+        TrafficLayer layer) const;
+
+    /// Muxed layer counters by negotiated protocol
+    std::unordered_map<peer::ProtocolName, TrafficStats> byProtocol() const;
+
+   private:
+    struct KeyHash {
+      size_t operator()(const TrafficKey &key) const;
+    };
+
+    /// Written by owner thread only
+    struct Cell {
+      std::array<std::atomic<uint64_t>, 6> values{};
+
+      void add(size_t i, uint64_t value) {
+        values[i].store(values[i].load(std::memory_order_relaxed) + value,
+                        std::memory_order_relaxed);
+      }
+
+      TrafficStats load() const;
+    };
+
+    struct Shard {
+      /// Guards insertions against readers, not taken by owner on lookup
+      mutable std::mutex mutex;
+      std::unordered_map<const TrafficKey *, Cell> cells;
+      const TrafficKey *last_key = nullptr;
+      Cell *last_cell = nullptr;
+    };
+
+    /// Unregisters shard of exiting thread
+    struct ShardOwner {
+      ShardOwner();
+      ~ShardOwner();
+      std::shared_ptr<Shard> shard;
+    };
+
+    Traffic() = default;
+
+    Cell &cell(const TrafficKey *key);
+
+    std::unordered_map<const TrafficKey *, TrafficStats> aggregate() const;
+
+    mutable std::mutex mutex_;
+    std::unordered_map<TrafficKey, std::unique_ptr<TrafficKey>, KeyHash> keys_;
+    size_t max_keys_ = kDefaultMaxKeys;
+    std::vector<std::shared_ptr<Shard>> shards_;
+    /// Counters of exited threads
+    std::unordered_map<const TrafficKey *, TrafficStats> retired_;
+  };
+
+  /**
+   * Counts traffic of one connection or stream on its layer.
+   * Must be used from one thread at a time, like the connection itself.
+   */
+  class TrafficMeter {
+   public:
+    explicit TrafficMeter(TrafficLayer layer);
+
+    /// Following traffic is attributed to the peer
+    void attribute(const peer::PeerId &peer);
+
+    /// Following traffic is attributed to the peer and protocol
+    void attribute(const peer::PeerId &peer,
+                   const peer::ProtocolName &protocol);
+
+    void onRead(uint64_t bytes, uint64_t frames = 0, uint64_t messages = 0);
+
+    void onWritten(uint64_t bytes, uint64_t frames = 0, uint64_t messages = 0);
+
+    /// Layer, peer and protocol traffic is attributed to
+    const TrafficKey &key() const {
+      return *key_;
+    }
+
+   private:
+    const TrafficKey *key_;
+  };
+
+}  // namespace libp2p::metrics
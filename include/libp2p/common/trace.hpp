@@ -8,13 +8,51 @@
 
 #include <libp2p/log/logger.hpp>
 
-#if TRACE_ENABLED
+/**
+ * Logging of hot paths, gated at compile time in translation units which
+ * include this header.
+ *
+ * LIBP2P_MIN_LOG_LEVEL is set by the cmake option of the same name:
+ * 0 keeps all messages, 1 removes SL_TRACE, 2 removes SL_TRACE and SL_DEBUG.
+ * Removed messages cost nothing at runtime, their arguments are still
+ * compiled, but never evaluated.
+ */
+#ifndef LIBP2P_MIN_LOG_LEVEL
+#define LIBP2P_MIN_LOG_LEVEL 0
+#endif
 
-#define TRACE(FMT, ...)                            \
-  do {                                             \
-    auto log = libp2p::log::createLogger("debug"); \
-    SL_TRACE(log, (FMT), ##__VA_ARGS__);           \
+namespace libp2p::log {
+  /// Logger of TRACE macro, created once
+  inline const Logger &traceLogger() {
+    static auto logger = createLogger("debug");
+    return logger;
+  }
+
+  template <typename... Args>
+  void discard(const Args &...) {}
+}  // namespace libp2p::log
+
+#define LIBP2P_LOG_DISCARD(...)          \
+  do {                                   \
+    if constexpr (false) {               \
+      libp2p::log::discard(__VA_ARGS__); \
+    }                                    \
   } while (false)
+
+#if LIBP2P_MIN_LOG_LEVEL >= 1
+#undef SL_TRACE
+#define SL_TRACE(...) LIBP2P_LOG_DISCARD(__VA_ARGS__)
+#endif
+
+#if LIBP2P_MIN_LOG_LEVEL >= 2
+#undef SL_DEBUG
+#define SL_DEBUG(...) LIBP2P_LOG_DISCARD(__VA_ARGS__)
+#endif
+
+#if TRACE_ENABLED
+
+#define TRACE(FMT, ...) \
+  SL_TRACE(libp2p::log::traceLogger(), (FMT), ##__VA_ARGS__)
 #else
 #define TRACE(...)
 #endif
@@ -6,8 +6,10 @@
 
 #pragma once
 
+#include <boost/asio/buffer.hpp>
 #include <boost/asio/detail/buffer_sequence_adapter.hpp>
 #include <boost/asio/io_context.hpp>
+#include <boost/container/small_vector.hpp>
 #include <libp2p/common/asio_buffer.hpp>
 #include <libp2p/common/shared_fn.hpp>
 #include <libp2p/connection/layer_connection.hpp>
@@ -71,14 +73,21 @@ namespace libp2p {
           asioBuffer(buffer), buffer.size(), wrapCb(std::forward<Cb>(cb)));
     }
 
+    /// Writes whole sequence (e.g. frame header and payload) by one vectored
+    /// write, without copying
     template <typename ConstBufferSequence, typename Cb>
     void async_write_some(const ConstBufferSequence &buffers, Cb &&cb) {
-      boost::asio::const_buffer buffer{
-          boost::asio::detail::buffer_sequence_adapter<
-              boost::asio::const_buffer,
-              ConstBufferSequence>::first(buffers)};
-      impl->writeSome(
-          asioBuffer(buffer), buffer.size(), wrapCb(std::forward<Cb>(cb)));
+      boost::container::small_vector<BytesIn, 4> in;
+      for (auto it = boost::asio::buffer_sequence_begin(buffers);
+           it != boost::asio::buffer_sequence_end(buffers);
+           ++it) {
+        boost::asio::const_buffer buffer{*it};
+        if (buffer.size() != 0) {
+          in.emplace_back(asioBuffer(buffer));
+        }
+      }
+      impl->writeSomeVectored(std::span<const BytesIn>{in.data(), in.size()},
+                              wrapCb(std::forward<Cb>(cb)));
     }
 
     std::shared_ptr<boost::asio::io_context> io;
@@ -0,0 +1,120 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <chrono>
+#include <optional>
+
+#include <libp2p/basic/scheduler.hpp>
+#include <libp2p/connection/layer_connection.hpp>
+
+namespace libp2p::connection {
+
+  /**
+   * Decorator of connection below security layer, which coalesces small
+   * reads and writes of upper layers (length prefixes, frame headers) into
+   * fewer reads and writes of the connection.
+   * Reads are served from read-ahead buffer, which is filled by one
+   * readSome() of its size. Writes are copied into write buffer and complete
+   * at once. The buffer is written when full, on flush(), or after delay
+   * since the first write gathered, errors are reported by following writes.
+   * Buffered bytes are written before the connection is closed.
+   * Used from scheduler thread only.
+   */
+  class BufferedConnection final
+      : public LayerConnection,
+        public std::enable_shared_from_this<BufferedConnection> {
+   public:
+    struct Config {
+      /// Size of read-ahead buffer, larger reads are not buffered.
+      /// Zero disables read buffering
+      size_t read_buffer = 0;
+
+      /// Size of write buffer, larger writes are not buffered.
+      /// Zero disables write coalescing
+      size_t write_buffer = 0;
+
+      /// Writes are gathered for this delay (Nagle-like micro-delay), zero
+      /// gathers them till the next scheduler timer tick
+      std::chrono::milliseconds write_delay{0};
+
+      bool enabled() const {
+        return read_buffer != 0 or write_buffer != 0;
+      }
+    };
+
+    BufferedConnection(std::shared_ptr<LayerConnection> connection,
+                       std::shared_ptr<basic::Scheduler> scheduler,
+                       Config config);
+
+    ~BufferedConnection() override = default;
+
+    /// Writes gathered bytes now, unless previous flush is in progress
+    void flush();
+
+    bool isClosed() const override;
+
+    outcome::result<void> close() override;
+
+    void read(BytesOut out, size_t bytes, ReadCallbackFunc cb) override;
+
+    void readSome(BytesOut out, size_t bytes, ReadCallbackFunc cb) override;
+
+    void deferReadCallback(outcome::result<size_t> res,
+                           ReadCallbackFunc cb) override;
+
+    void writeSome(BytesIn in, size_t bytes, WriteCallbackFunc cb) override;
+
+    /// Gathers buffers into write buffer
+    void writeSomeVectored(std::span<const BytesIn> in,
+                           WriteCallbackFunc cb) override;
+
+    void deferWriteCallback(std::error_code ec, WriteCallbackFunc cb) override;
+
+    bool isInitiator() const override;
+
+    outcome::result<multi::Multiaddress> localMultiaddr() override;
+
+    outcome::result<multi::Multiaddress> remoteMultiaddr() override;
+
+   private:
+    /// Copies buffered bytes, completes synchronously unless nested too deep
+    void serveRead(BytesOut out, ReadCallbackFunc cb);
+
+    /// Copies buffers into write buffer, completes with copied size
+    void writeBuffered(std::span<const BytesIn> in, WriteCallbackFunc cb);
+
+    void onFlushed(std::error_code ec);
+
+    void armFlushTimer();
+
+    std::shared_ptr<LayerConnection> connection_;
+    std::shared_ptr<basic::Scheduler> scheduler_;
+    const Config config_;
+
+    /// Bytes read ahead in [read_begin_, read_end_)
+    Bytes read_buffer_;
+    size_t read_begin_ = 0;
+    size_t read_end_ = 0;
+    /// Nested synchronous completions of buffered reads
+    size_t sync_reads_ = 0;
+
+    /// Writes gathered till the next flush
+    Bytes write_buffer_;
+    /// Bytes being written by flush
+    Bytes flush_buffer_;
+    bool flushing_ = false;
+    basic::Timer flush_timer_;
+    /// Write waiting till flush frees write_buffer_
+    std::optional<std::pair<BytesIn, WriteCallbackFunc>> blocked_write_;
+    /// Error of buffered write, reported to following writes
+    std::error_code write_error_;
+    /// Connection is closed once buffered bytes are written
+    bool closing_ = false;
+  };
+
+}  // namespace libp2p::connection
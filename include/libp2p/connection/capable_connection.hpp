@@ -6,23 +6,44 @@
 
 #pragma once
 
+#include <chrono>
 #include <functional>
+#include <optional>
 
 #include <libp2p/connection/secure_connection.hpp>
+#include <libp2p/multi/multiaddress_protocol_list.hpp>
 
 namespace libp2p::connection {
   struct Stream;
 
+  /// Load of connection, lets connection manager choose among connections to
+  /// the same peer
+  struct ConnectionLoad {
+    /// Streams open over the connection
+    size_t streams = 0;
+
+    /// Bytes queued for writing
+    size_t unsent_bytes = 0;
+
+    /// Smoothed round trip time, if measured
+    std::optional<std::chrono::microseconds> rtt;
+  };
+
   /**
    * Connection that provides basic libp2p requirements to the connection: it is
    * both secured and muxed (streams can be created over that connection)
    */
   struct CapableConnection : public SecureConnection {
     using StreamHandler = void(outcome::result<std::shared_ptr<Stream>>);
-    using StreamHandlerFunc = std::function<StreamHandler>;
+    using StreamHandlerFunc = InlineFunction<StreamHandler>;
 
     using NewStreamHandlerFunc = std::function<void(std::shared_ptr<Stream>)>;
 
+    using DatagramHandler = std::function<void(BytesIn)>;
+
+    using PingHandler = void(outcome::result<std::chrono::microseconds>);
+    using PingHandlerFunc = std::function<PingHandler>;
+
     using ConnectionClosedCallback = std::function<void(
         const peer::PeerId &,
         const std::shared_ptr<connection::CapableConnection> &)>;
@@ -66,6 +87,62 @@ namespace libp2p::connection {
      * reset
      */
     virtual void onStream(NewStreamHandlerFunc cb) = 0;
+
+    /// Current load, nothing is known by default
+    virtual ConnectionLoad load() const {
+      return {};
+    }
+
+    /**
+     * Enables or disables closing of connection without streams by muxer
+     * inactivity timer (MuxedConnectionConfig::no_streams_interval).
+     * Muxers without inactivity timer ignore it
+     */
+    virtual void setCloseWhenIdle(bool /*close*/) {}
+
+    /// Muxer has its own ping frames, so liveness and round trip time are
+    /// measured without /ipfs/ping stream
+    virtual bool supportsPing() const {
+      return false;
+    }
+
+    /**
+     * Sends ping frame of muxer, callback gets round trip time when it is
+     * answered, or error if connection is closed before. No timeout is
+     * applied. Fails if ping is not supported
+     */
+    virtual void ping(PingHandlerFunc cb) {
+      cb(make_error_code(std::errc::not_supported));
+    }
+
+    /**
+     * Max size of unreliable datagram (RFC 9221), zero if connection doesn't
+     * support them, e.g. peer didn't negotiate them
+     */
+    virtual size_t maxDatagramSize() const {
+      return 0;
+    }
+
+    /**
+     * Sends unreliable datagram, which may be lost or reordered, but is not
+     * delayed by losses of streams
+     */
+    virtual outcome::result<void> sendDatagram(BytesIn /*datagram*/) {
+      return std::errc::not_supported;
+    }
+
+    /**
+     * Sets handler of received datagrams. Datagrams are not multiplexed by
+     * protocol, so a single protocol per connection may use them
+     */
+    virtual void onDatagram(DatagramHandler /*handler*/) {}
   };
 
+  /// Connection is relayed, if its remote address is a /p2p-circuit one
+  inline bool isRelayed(CapableConnection &conn) {
+    auto addr = conn.remoteMultiaddr();
+    return addr
+       and addr.value().hasProtocol(multi::Protocol::Code::P2P_CIRCUIT);
+  }
+
 }  // namespace libp2p::connection
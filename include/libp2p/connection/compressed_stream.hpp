@@ -0,0 +1,96 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <array>
+
+#include <libp2p/basic/codec.hpp>
+#include <libp2p/connection/stream.hpp>
+
+namespace libp2p::connection {
+
+  /**
+   * Stream, which compresses written data and decompresses read data.
+   * Each write is sent as frames of 4-byte big-endian length and compressed
+   * payload, which decompresses to at most kMaxFrameSize bytes, so memory
+   * used by reader is bounded whatever peer sends.
+   * Both sides must wrap the stream, so protocols negotiate it as a distinct
+   * protocol id, e.g. "/proto/1.0.0/deflate", and wrap negotiated stream
+   */
+  class CompressedStream
+      : public Stream,
+        public std::enable_shared_from_this<CompressedStream> {
+   public:
+    /// Max decompressed size of frame, larger writes are split
+    static constexpr size_t kMaxFrameSize = 64 * 1024;
+
+    CompressedStream(std::shared_ptr<Stream> stream,
+                     std::shared_ptr<basic::Codec> codec);
+
+    void read(BytesOut out, size_t bytes, ReadCallbackFunc cb) override;
+
+    void readSome(BytesOut out, size_t bytes, ReadCallbackFunc cb) override;
+
+    void deferReadCallback(outcome::result<size_t> res,
+                           ReadCallbackFunc cb) override;
+
+    void writeSome(BytesIn in, size_t bytes, WriteCallbackFunc cb) override;
+
+    void deferWriteCallback(std::error_code ec, WriteCallbackFunc cb) override;
+
+    bool isClosedForRead() const override;
+
+    bool isClosedForWrite() const override;
+
+    bool isClosed() const override;
+
+    void close(VoidResultHandlerFunc cb) override;
+
+    void reset() override;
+
+    void adjustWindowSize(uint32_t new_size,
+                          VoidResultHandlerFunc cb) override;
+
+    outcome::result<bool> isInitiator() const override;
+
+    outcome::result<peer::PeerId> remotePeerId() const override;
+
+    outcome::result<multi::Multiaddress> localMultiaddr() const override;
+
+    outcome::result<multi::Multiaddress> remoteMultiaddr() const override;
+
+    void attributeTraffic(const peer::ProtocolName &protocol) override;
+
+    bool admitProtocol(const peer::ProtocolName &protocol) override;
+
+    void setWriteWeight(uint8_t weight) override;
+
+   private:
+    static constexpr size_t kHeaderSize = 4;
+
+    /// Copies decoded bytes to `out` and reports them
+    void readDecoded(BytesOut out, size_t bytes, ReadCallbackFunc cb);
+
+    void onFrameRead(BytesOut out, size_t bytes, ReadCallbackFunc cb);
+
+    std::shared_ptr<Stream> stream_;
+    std::shared_ptr<basic::Codec> codec_;
+
+    std::array<uint8_t, kHeaderSize> read_header_{};
+
+    /// Compressed payload of frame being read
+    Bytes read_frame_;
+
+    /// Decompressed frame, not yet read by caller from offset
+    Bytes decoded_;
+    size_t decoded_offset_ = 0;
+
+    /// Frame being written
+    Bytes write_frame_;
+  };
+
+}  // namespace libp2p::connection
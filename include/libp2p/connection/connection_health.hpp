@@ -0,0 +1,196 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <chrono>
+#include <map>
+#include <memory>
+
+#include <libp2p/basic/scheduler.hpp>
+
+namespace libp2p::connection {
+  class ConnectionHealth;
+  class HealthList;
+
+  /**
+   * Keepalive of connection, checked by ConnectionHealth.
+   * Embedded in the connection as a node of intrusive list, ordered by due
+   * time, so marking activity allocates nothing and takes O(1).
+   * Used from scheduler thread only.
+   */
+  class HealthCheck {
+   public:
+    using Time = std::chrono::milliseconds;
+
+    HealthCheck() = default;
+
+    /// Stops being checked
+    virtual ~HealthCheck() {
+      stopHealthCheck();
+    }
+
+    // node is linked by address
+    HealthCheck(const HealthCheck &) = delete;
+    HealthCheck(HealthCheck &&) = delete;
+    HealthCheck &operator=(const HealthCheck &) = delete;
+    HealthCheck &operator=(HealthCheck &&) = delete;
+
+    /// Marks inbound traffic, connection is not idle for next interval
+    inline void healthActive();
+
+    /// Called on idle connections until stopped
+    inline void stopHealthCheck();
+
+   protected:
+    /**
+     * Called once connection had no inbound traffic for interval, then
+     * each next interval while it stays idle, e.g. to send ping
+     * @param idle time since last inbound traffic
+     */
+    virtual void onHealthIdle(Time idle) = 0;
+
+   private:
+    friend class ConnectionHealth;
+    friend class HealthList;
+
+    HealthList *list_ = nullptr;
+    HealthCheck *prev_ = nullptr;
+    HealthCheck *next_ = nullptr;
+    Time due_{};
+    Time active_{};
+  };
+
+  /**
+   * Checks of the same interval, ordered by due time.
+   * Checks are appended to the tail with due time of current tick plus
+   * interval, which is not earlier than any linked one
+   */
+  class HealthList {
+   public:
+    using Time = HealthCheck::Time;
+
+    HealthList(ConnectionHealth &health, Time interval)
+        : health_{health}, interval_{interval} {}
+
+    /// Checks outliving service are left unlinked
+    ~HealthList() {
+      while (head_ != nullptr) {
+        remove(*head_);
+      }
+    }
+
+    HealthList(const HealthList &) = delete;
+    HealthList(HealthList &&) = delete;
+    HealthList &operator=(const HealthList &) = delete;
+    HealthList &operator=(HealthList &&) = delete;
+
+    inline void append(HealthCheck &check);
+
+    void remove(HealthCheck &check) {
+      (check.prev_ != nullptr ? check.prev_->next_ : head_) = check.next_;
+      (check.next_ != nullptr ? check.next_->prev_ : tail_) = check.prev_;
+      check.list_ = nullptr;
+      check.prev_ = nullptr;
+      check.next_ = nullptr;
+    }
+
+   private:
+    friend class ConnectionHealth;
+    friend class HealthCheck;
+
+    ConnectionHealth &health_;
+    const Time interval_;
+    HealthCheck *head_ = nullptr;
+    HealthCheck *tail_ = nullptr;
+  };
+
+  /**
+   * Shared keepalive of connections, instead of timers of each connection.
+   * Idle connections are swept on coarse ticks in batches, connections with
+   * recent inbound traffic are not visited at all, so that their pings are
+   * suppressed for free
+   */
+  class ConnectionHealth {
+   public:
+    using Time = HealthCheck::Time;
+
+    struct Config {
+      /// Precision of idle intervals
+      std::chrono::milliseconds tick = std::chrono::seconds(1);
+
+      /// Idle connections handled per tick, the rest are handled on next
+      /// ticks, so that bursts of idleness don't block event loop
+      size_t batch = 1024;
+    };
+
+    ConnectionHealth(Config config,
+                     std::shared_ptr<basic::Scheduler> scheduler);
+
+    ConnectionHealth(const ConnectionHealth &) = delete;
+    ConnectionHealth(ConnectionHealth &&) = delete;
+    ConnectionHealth &operator=(const ConnectionHealth &) = delete;
+    ConnectionHealth &operator=(ConnectionHealth &&) = delete;
+    ~ConnectionHealth() = default;
+
+    /**
+     * Starts checking connection, which is idle after `interval` without
+     * inbound traffic. Checked connection is moved to new interval
+     */
+    void add(HealthCheck &check, Time interval);
+
+    /// Number of checked connections
+    size_t size() const {
+      return size_;
+    }
+
+   private:
+    friend class HealthList;
+    friend class HealthCheck;
+
+    void setTimer();
+    void onTick();
+
+    Config config_;
+    std::shared_ptr<basic::Scheduler> scheduler_;
+    std::map<Time, HealthList> lists_;
+    size_t size_ = 0;
+
+    /// Time of last tick, activity is marked without reading clock
+    Time now_{};
+    basic::Timer timer_;
+  };
+
+  inline void HealthList::append(HealthCheck &check) {
+    check.due_ = health_.now_ + interval_;
+    check.list_ = this;
+    check.prev_ = tail_;
+    check.next_ = nullptr;
+    (tail_ != nullptr ? tail_->next_ : head_) = &check;
+    tail_ = &check;
+  }
+
+  inline void HealthCheck::healthActive() {
+    if (list_ == nullptr) {
+      return;
+    }
+    active_ = list_->health_.now_;
+    if (list_->tail_ == this) {
+      due_ = active_ + list_->interval_;
+      return;
+    }
+    auto &list = *list_;
+    list.remove(*this);
+    list.append(*this);
+  }
+
+  inline void HealthCheck::stopHealthCheck() {
+    if (list_ != nullptr) {
+      --list_->health_.size_;
+      list_->remove(*this);
+    }
+  }
+}  // namespace libp2p::connection
@@ -7,6 +7,7 @@
 #pragma once
 
 #include <libp2p/connection/layer_connection.hpp>
+#include <libp2p/peer/peer_id.hpp>
 
 namespace libp2p::connection {
 
@@ -15,6 +16,13 @@ namespace libp2p::connection {
    */
   struct RawConnection : public virtual LayerConnection {
     ~RawConnection() override = default;
+
+    /**
+     * Called once the remote peer is known after security upgrade, further
+     * traffic of this connection is accounted to the peer
+     * @param peer remote peer
+     */
+    virtual void attributeTraffic(const peer::PeerId & /*peer*/) {}
   };
 
 }  // namespace libp2p::connection
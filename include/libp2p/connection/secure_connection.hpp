@@ -6,9 +6,12 @@
 
 #pragma once
 
+#include <boost/optional.hpp>
+
 #include <libp2p/connection/raw_connection.hpp>
 #include <libp2p/crypto/key.hpp>
 #include <libp2p/peer/peer_id.hpp>
+#include <libp2p/peer/protocol.hpp>
 
 namespace libp2p::connection {
 
@@ -37,6 +40,15 @@ namespace libp2p::connection {
      */
     virtual outcome::result<crypto::PublicKey> remotePublicKey() const = 0;
 
+    /**
+     * Muxer agreed on during security handshake, so that multiselect for
+     * muxer can be skipped
+     * @return muxer protocol, none if peer didn't offer muxers
+     */
+    virtual boost::optional<peer::ProtocolName> negotiatedMuxer() const {
+      return boost::none;
+    }
+
     // TODO(warchant): figure out, if it is needed
     // virtual crypto::PrivateKey localPrivateKey() const = 0;
   };
@@ -9,6 +9,7 @@
 #include <libp2p/basic/readwriter.hpp>
 #include <libp2p/connection/capable_connection.hpp>
 #include <libp2p/multi/multiaddress.hpp>
+#include <libp2p/peer/protocol.hpp>
 
 namespace libp2p::peer {
   class PeerId;
@@ -115,6 +116,35 @@ namespace libp2p::connection {
      * @return multiaddress or error
      */
     virtual outcome::result<multi::Multiaddress> remoteMultiaddr() const = 0;
+
+    /**
+     * Called once the protocol is negotiated, further traffic of this stream
+     * is accounted to the protocol
+     * @param protocol negotiated protocol
+     */
+    virtual void attributeTraffic(const peer::ProtocolName & /*protocol*/) {}
+
+    /**
+     * Called once the protocol is negotiated, before its handler gets the
+     * stream. Muxers with stream limits count the stream in limits of the
+     * protocol
+     * @param protocol negotiated protocol
+     * @return false if limit of the protocol is exceeded, stream is to be
+     * reset
+     */
+    virtual bool admitProtocol(const peer::ProtocolName & /*protocol*/) {
+      return true;
+    }
+
+    static constexpr uint8_t kDefaultWriteWeight = 16;
+
+    /**
+     * Sets share of connection write bandwidth relative to other streams of
+     * the connection with pending writes. Muxers without write scheduling
+     * ignore it
+     * @param weight from 1 to 255, default is kDefaultWriteWeight
+     */
+    virtual void setWriteWeight(uint8_t /*weight*/) {}
   };
 }  // namespace libp2p::connection
 
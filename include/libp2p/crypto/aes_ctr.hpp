@@ -27,6 +27,13 @@ namespace libp2p::crypto::aes {
      */
     virtual outcome::result<Bytes> crypt(BytesIn data) const = 0;
 
+    /**
+     * Encrypts or decrypts user data without allocation
+     * @param data to be processed, replaced with processed data
+     * @return error if any
+     */
+    virtual outcome::result<void> cryptInPlace(BytesOut data) const = 0;
+
     /**
      * Does stream data finalization
      * @return bytes buffer to correctly pad all the previously processed
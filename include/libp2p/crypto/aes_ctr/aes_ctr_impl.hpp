@@ -35,6 +35,8 @@ namespace libp2p::crypto::aes {
 
     outcome::result<Bytes> crypt(BytesIn data) const override;
 
+    outcome::result<void> cryptInPlace(BytesOut data) const override;
+
     outcome::result<Bytes> finalize() override;
 
    private:
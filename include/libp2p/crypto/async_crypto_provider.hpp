@@ -0,0 +1,62 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <functional>
+#include <vector>
+
+#include <libp2p/crypto/crypto_provider.hpp>
+
+namespace libp2p::crypto {
+  /**
+   * Signs and verifies off the network thread, callbacks are called through
+   * the scheduler of the caller
+   */
+  class AsyncCryptoProvider {
+   public:
+    using Buffer = CryptoProvider::Buffer;
+    using SignCallback = std::function<void(outcome::result<Buffer>)>;
+    using VerifyCallback = std::function<void(outcome::result<bool>)>;
+
+    struct VerifyJob {
+      Bytes message;
+      Bytes signature;
+      PublicKey public_key;
+    };
+    /// Results are in order of jobs
+    using VerifyBatchCallback =
+        std::function<void(std::vector<outcome::result<bool>>)>;
+
+    virtual ~AsyncCryptoProvider() = default;
+
+    /**
+     * Sign a message
+     * @param message - bytes to sign
+     * @param private_key - key to sign with
+     * @param cb - receives signature
+     */
+    virtual void sign(Bytes message,
+                      PrivateKey private_key,
+                      SignCallback cb) = 0;
+
+    /**
+     * Verify signature of a message
+     * @param cb - receives true when signature is valid
+     */
+    virtual void verify(Bytes message,
+                        Bytes signature,
+                        PublicKey public_key,
+                        VerifyCallback cb) = 0;
+
+    /**
+     * Verify a burst of signatures, jobs are spread across workers
+     * @param cb - called once when all the jobs are done
+     */
+    virtual void verifyBatch(std::vector<VerifyJob> jobs,
+                             VerifyBatchCallback cb) = 0;
+  };
+}  // namespace libp2p::crypto
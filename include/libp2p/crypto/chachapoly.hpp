@@ -43,18 +43,39 @@ namespace libp2p::crypto::chachapoly {
                                            BytesIn ciphertext,
                                            BytesIn aad) = 0;
 
+    /**
+     * Does authenticated encryption into caller provided buffer
+     * @param out - buffer for ciphertext and 16 bytes tag, may start at the
+     * same address as plaintext to encrypt in place
+     * @return ciphertext size
+     */
+    virtual outcome::result<size_t> encrypt(const Nonce &nonce,
+                                            BytesIn plaintext,
+                                            BytesIn aad,
+                                            BytesOut out) = 0;
+
+    /**
+     * Does authenticated decryption into caller provided buffer
+     * @param out - buffer for plaintext, at least ciphertext size minus tag,
+     * may start at the same address as ciphertext to decrypt in place
+     * @return plaintext size
+     */
+    virtual outcome::result<size_t> decrypt(const Nonce &nonce,
+                                            BytesIn ciphertext,
+                                            BytesIn aad,
+                                            BytesOut out) = 0;
+
     /**
      * Convert 64-bit integer to 12-bit long byte sequence with four zero bytes
      * at the beginning
      * @param n - an integer to convert
-     * @return - bytes vector
+     * @return - nonce bytes
      */
     inline Nonce uint64toNonce(uint64_t n) const {
-      Bytes result(4, 0);
-      result.reserve(12);
-      libp2p::common::putUint64LE(result, n);
-      Nonce nonce;
-      std::copy_n(result.begin(), nonce.size(), nonce.begin());
+      Nonce nonce{};
+      for (size_t i = 4; i < nonce.size(); ++i, n >>= 8) {
+        nonce[i] = static_cast<uint8_t>(n & 0xff);
+      }
       return nonce;
     }
   };
@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <openssl/aead.h>
 #include <openssl/evp.h>
 #include <libp2p/crypto/chachapoly.hpp>
 #include <libp2p/log/logger.hpp>
@@ -24,12 +25,27 @@ namespace libp2p::crypto::chachapoly {
                                    BytesIn ciphertext,
                                    BytesIn aad) override;
 
+    outcome::result<size_t> encrypt(const Nonce &nonce,
+                                    BytesIn plaintext,
+                                    BytesIn aad,
+                                    BytesOut out) override;
+
+    outcome::result<size_t> decrypt(const Nonce &nonce,
+                                    BytesIn ciphertext,
+                                    BytesIn aad,
+                                    BytesOut out) override;
+
    private:
-    outcome::result<void> init(EVP_AEAD_CTX *ctx, bool encrypt);
+    /// keyed context of the direction, set up on first use
+    outcome::result<EVP_AEAD_CTX *> context(bool encrypt);
 
     const Key key_;
     const EVP_AEAD *aead_;
     const size_t overhead_;
+    bssl::ScopedEVP_AEAD_CTX seal_ctx_;
+    bssl::ScopedEVP_AEAD_CTX open_ctx_;
+    bool seal_ready_ = false;
+    bool open_ready_ = false;
     libp2p::log::Logger log_ = libp2p::log::createLogger("ChaChaPoly");
   };
 
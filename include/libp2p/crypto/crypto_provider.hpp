@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <memory>
 #include <vector>
 
 #include <boost/filesystem.hpp>
@@ -14,6 +15,16 @@
 #include <libp2p/outcome/outcome.hpp>
 
 namespace libp2p::crypto {
+  /**
+   * Private key prepared by CryptoProvider::prepareSigningKey(), providers
+   * keep their parsed key objects in derived types
+   */
+  struct SigningKey {
+    virtual ~SigningKey() = default;
+
+    PrivateKey private_key;
+  };
+
   /**
    * @class CryptoProvider provides interface for key generation, singing,
    * signature verification functions for private/public key cryptography
@@ -51,6 +62,31 @@ namespace libp2p::crypto {
     virtual outcome::result<Buffer> sign(
         BytesIn message, const PrivateKey &private_key) const = 0;
 
+    /**
+     * @brief prepares private key, which signs many messages, so that key is
+     * parsed and expanded once instead of on each sign()
+     * @param private_key key to prepare
+     * @return key to be passed to sign()
+     */
+    virtual outcome::result<std::shared_ptr<const SigningKey>>
+    prepareSigningKey(const PrivateKey &private_key) const {
+      auto key = std::make_shared<SigningKey>();
+      key->private_key = private_key;
+      return key;
+    }
+
+    /**
+     * @brief signs a given message using prepared key, signature is the same
+     * as of sign() with its private key
+     * @param message bytes to be signed
+     * @param key returned by prepareSigningKey() of this provider
+     * @return signature bytes
+     */
+    virtual outcome::result<Buffer> sign(BytesIn message,
+                                         const SigningKey &key) const {
+      return sign(message, key.private_key);
+    }
+
     /**
      * @brief verifies validness of the signature for a given message and public
      * key
@@ -0,0 +1,54 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <boost/asio/thread_pool.hpp>
+
+#include <libp2p/basic/scheduler.hpp>
+#include <libp2p/crypto/async_crypto_provider.hpp>
+
+namespace libp2p::crypto {
+  /**
+   * Runs CryptoProvider calls on a pool of worker threads.
+   * Pending callbacks are dropped on destruction.
+   */
+  class AsyncCryptoProviderImpl : public AsyncCryptoProvider {
+   public:
+    struct Config {
+      /// Worker threads, zero means hardware concurrency
+      size_t threads = 0;
+      /// Batch jobs verified by one worker task
+      size_t batch_chunk_size = 32;
+    };
+
+    /**
+     * @param crypto_provider - must be safe to call from several threads
+     * @param scheduler - callbacks are scheduled here, without delay
+     */
+    AsyncCryptoProviderImpl(std::shared_ptr<CryptoProvider> crypto_provider,
+                            std::shared_ptr<basic::Scheduler> scheduler,
+                            Config config);
+
+    ~AsyncCryptoProviderImpl() override;
+
+    void sign(Bytes message, PrivateKey private_key, SignCallback cb) override;
+
+    void verify(Bytes message,
+                Bytes signature,
+                PublicKey public_key,
+                VerifyCallback cb) override;
+
+    void verifyBatch(std::vector<VerifyJob> jobs,
+                     VerifyBatchCallback cb) override;
+
+   private:
+    std::shared_ptr<CryptoProvider> crypto_provider_;
+    std::shared_ptr<basic::Scheduler> scheduler_;
+    Config config_;
+    boost::asio::thread_pool pool_;
+  };
+}  // namespace libp2p::crypto
@@ -6,6 +6,8 @@
 
 #pragma once
 
+#include <mutex>
+
 #include <libp2p/crypto/crypto_provider.hpp>
 
 namespace libp2p::crypto {
@@ -54,6 +56,14 @@ namespace libp2p::crypto {
     outcome::result<Buffer> sign(BytesIn message,
                                  const PrivateKey &private_key) const override;
 
+    /// Ed25519 keys are prepared by Ed25519Provider, the rest are signed as
+    /// usual
+    outcome::result<std::shared_ptr<const SigningKey>> prepareSigningKey(
+        const PrivateKey &private_key) const override;
+
+    outcome::result<Buffer> sign(BytesIn message,
+                                 const SigningKey &key) const override;
+
     outcome::result<bool> verify(BytesIn message,
                                  BytesIn signature,
                                  const PublicKey &public_key) const override;
@@ -67,7 +77,8 @@ namespace libp2p::crypto {
         const Buffer &secret) const override;
 
    private:
-    void initialize();
+    /// Seeds RAND, done once by first RSA key generation
+    void initialize() const;
     static std::function<outcome::result<Buffer>(Buffer)>
     prepareSharedSecretGenerator(int curve_nid, Buffer own_private_key);
 
@@ -113,6 +124,7 @@ namespace libp2p::crypto {
     std::shared_ptr<ecdsa::EcdsaProvider> ecdsa_provider_;
     std::shared_ptr<secp256k1::Secp256k1Provider> secp256k1_provider_;
     std::shared_ptr<hmac::HmacProvider> hmac_provider_;
+    mutable std::once_flag initialized_;
   };
 }  // namespace libp2p::crypto
 
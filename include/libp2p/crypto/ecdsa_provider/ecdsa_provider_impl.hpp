@@ -11,6 +11,7 @@
 #include <openssl/ec.h>
 
 #include <libp2p/crypto/ecdsa_provider.hpp>
+#include <libp2p/crypto/parsed_key_cache.hpp>
 
 namespace libp2p::crypto::ecdsa {
 
@@ -58,5 +59,8 @@ namespace libp2p::crypto::ecdsa {
     outcome::result<std::shared_ptr<EC_KEY>> convertBytesToEcKey(
         const KeyType &key,
         EC_KEY *(*converter)(EC_KEY **, const uint8_t **, long)) const;
+
+    /// Checked public keys, decoded once for repeated verifies
+    mutable ParsedKeyCache<std::shared_ptr<EC_KEY>> key_cache_;
   };
 }  // namespace libp2p::crypto::ecdsa
@@ -7,6 +7,9 @@
 #pragma once
 
 #include <array>
+#include <memory>
+#include <span>
+#include <vector>
 
 #include <libp2p/common/types.hpp>
 #include <libp2p/outcome/outcome.hpp>
@@ -21,6 +24,23 @@ namespace libp2p::crypto::ed25519 {
   };
   using Signature = std::array<uint8_t, 64u>;
 
+  /// Signature to check by verifyBatch()
+  struct VerifyJob {
+    BytesIn message;
+    Signature signature;
+    PublicKey public_key;
+  };
+
+  /**
+   * Private key prepared by Ed25519Provider::prepare(), providers keep their
+   * parsed key object in derived types
+   */
+  struct PreparedKey {
+    virtual ~PreparedKey() = default;
+
+    PrivateKey private_key;
+  };
+
   /**
    * An interface for Ed25519 private/public key cryptography operations.
    */
@@ -49,6 +69,29 @@ namespace libp2p::crypto::ed25519 {
     virtual outcome::result<Signature> sign(
         BytesIn message, const PrivateKey &private_key) const = 0;
 
+    /**
+     * Prepare private key for repeated signing, so that key is expanded once
+     * @param private_key - private key bytes
+     * @return key to be passed to sign()
+     */
+    virtual outcome::result<std::shared_ptr<const PreparedKey>> prepare(
+        const PrivateKey &private_key) const {
+      auto key = std::make_shared<PreparedKey>();
+      key->private_key = private_key;
+      return key;
+    }
+
+    /**
+     * Sign a message using prepared key, same as sign() with its private key
+     * @param message - the source message as bytes sequence
+     * @param key - key returned by prepare() of this provider
+     * @return signature as bytes sequence
+     */
+    virtual outcome::result<Signature> sign(BytesIn message,
+                                            const PreparedKey &key) const {
+      return sign(message, key.private_key);
+    }
+
     /**
      * Verify signature of a message against a given public key
      * @param message - the source message as bytes sequence
@@ -60,6 +103,14 @@ namespace libp2p::crypto::ed25519 {
                                          const Signature &signature,
                                          const PublicKey &public_key) const = 0;
 
+    /**
+     * Verify several signatures at once
+     * @param jobs - messages with signatures and public keys
+     * @return results of verify() in order of jobs
+     */
+    virtual std::vector<outcome::result<bool>> verifyBatch(
+        std::span<const VerifyJob> jobs) const = 0;
+
     virtual ~Ed25519Provider() = default;
   };
 
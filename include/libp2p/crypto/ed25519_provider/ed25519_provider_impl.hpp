@@ -22,9 +22,20 @@ namespace libp2p::crypto::ed25519 {
     outcome::result<Signature> sign(
         BytesIn message, const PrivateKey &private_key) const override;
 
+    /// Keeps OpenSSL key object, which has expanded the secret
+    outcome::result<std::shared_ptr<const PreparedKey>> prepare(
+        const PrivateKey &private_key) const override;
+
+    outcome::result<Signature> sign(BytesIn message,
+                                    const PreparedKey &key) const override;
+
     outcome::result<bool> verify(BytesIn message,
                                  const Signature &signature,
                                  const PublicKey &public_key) const override;
+
+    /// OpenSSL has no batch verification, jobs are verified in parallel
+    std::vector<outcome::result<bool>> verifyBatch(
+        std::span<const VerifyJob> jobs) const override;
   };
 
 }  // namespace libp2p::crypto::ed25519
@@ -37,6 +37,8 @@ namespace libp2p::crypto::hmac {
     Bytes key_;
     const EVP_MD *hash_st_;
     HMAC_CTX *hmac_ctx_;
+    /// Reused by digestOut to finalize copy of state
+    mutable HMAC_CTX *digest_ctx_{nullptr};
     bool initialized_;
   };
 
@@ -0,0 +1,52 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <mutex>
+
+#include <libp2p/common/byteutil.hpp>
+#include <libp2p/common/lru_cache.hpp>
+#include <libp2p/common/types.hpp>
+#include <libp2p/outcome/outcome.hpp>
+
+namespace libp2p::crypto {
+
+  /**
+   * Verification keys parsed from their bytes, so repeated verifies with the
+   * same key skip decoding. Failed parses are not cached.
+   * Shared by threads verifying with one provider, so access is locked.
+   */
+  template <typename Parsed>
+  class ParsedKeyCache {
+   public:
+    static constexpr size_t kDefaultCapacity = 1024;
+
+    explicit ParsedKeyCache(size_t capacity = kDefaultCapacity)
+        : cache_{capacity} {}
+
+    /// Parsed key of bytes, parse() is called on miss
+    template <typename Parse>
+    outcome::result<Parsed> get(BytesIn bytes, const Parse &parse) {
+      Bytes key{bytes.begin(), bytes.end()};
+      {
+        std::lock_guard lock{mutex_};
+        if (auto parsed = cache_.get(key)) {
+          return *parsed;
+        }
+      }
+      // parsed out of lock, concurrent misses of one key may parse it twice
+      OUTCOME_TRY(parsed, parse());
+      std::lock_guard lock{mutex_};
+      return cache_.put(key, std::move(parsed));
+    }
+
+   private:
+    std::mutex mutex_;
+    LruCache<Bytes, Parsed> cache_;
+  };
+
+}  // namespace libp2p::crypto
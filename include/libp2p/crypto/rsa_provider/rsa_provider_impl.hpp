@@ -10,6 +10,7 @@
 
 #include <openssl/rsa.h>
 #include <libp2p/crypto/error.hpp>
+#include <libp2p/crypto/parsed_key_cache.hpp>
 #include <libp2p/crypto/rsa_provider.hpp>
 
 namespace libp2p::crypto::rsa {
@@ -39,5 +40,11 @@ namespace libp2p::crypto::rsa {
      */
     static outcome::result<std::shared_ptr<X509_PUBKEY>> getPublicKeyFromBytes(
         const PublicKey &input_key);
+
+    /// RSA key of public key bytes, decoded once for repeated verifies
+    outcome::result<std::shared_ptr<RSA>> verificationKey(
+        const PublicKey &public_key) const;
+
+    mutable ParsedKeyCache<std::shared_ptr<RSA>> key_cache_;
   };
 };  // namespace libp2p::crypto::rsa
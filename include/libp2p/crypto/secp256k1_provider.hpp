@@ -6,12 +6,22 @@
 
 #pragma once
 
+#include <span>
+#include <vector>
+
 #include <libp2p/common/types.hpp>
 #include <libp2p/crypto/secp256k1_types.hpp>
 #include <libp2p/outcome/outcome.hpp>
 
 namespace libp2p::crypto::secp256k1 {
 
+  /// Signature to check by verifyBatch()
+  struct VerifyJob {
+    BytesIn message;
+    Signature signature;
+    PublicKey public_key;
+  };
+
   /**
    * @class Secp256k1 provider interface
    */
@@ -50,6 +60,14 @@ namespace libp2p::crypto::secp256k1 {
                                          const Signature &signature,
                                          const PublicKey &key) const = 0;
 
+    /**
+     * @brief Verify several signatures at once
+     * @param jobs - messages with signatures and public keys
+     * @return Results of verify() in order of jobs
+     */
+    virtual std::vector<outcome::result<bool>> verifyBatch(
+        std::span<const VerifyJob> jobs) const = 0;
+
     virtual ~Secp256k1Provider() = default;
   };
 };  // namespace libp2p::crypto::secp256k1
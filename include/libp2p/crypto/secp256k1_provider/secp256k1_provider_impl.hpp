@@ -9,6 +9,7 @@
 #include <secp256k1.h>
 #include <memory>
 
+#include <libp2p/crypto/parsed_key_cache.hpp>
 #include <libp2p/crypto/secp256k1_provider.hpp>
 
 namespace libp2p::crypto::random {
@@ -31,8 +32,13 @@ namespace libp2p::crypto::secp256k1 {
                                  const Signature &signature,
                                  const PublicKey &key) const override;
 
+    /// libsecp256k1 has no batch verification, jobs are verified in parallel
+    std::vector<outcome::result<bool>> verifyBatch(
+        std::span<const VerifyJob> jobs) const override;
+
    private:
     std::shared_ptr<random::CSPRNG> random_;
     std::unique_ptr<secp256k1_context, void (*)(secp256k1_context *)> ctx_;
+    mutable ParsedKeyCache<secp256k1_pubkey> key_cache_;
   };
 }  // namespace libp2p::crypto::secp256k1
@@ -44,4 +44,12 @@ namespace libp2p::crypto {
    * @return hashed bytes
    */
   outcome::result<libp2p::common::Hash256> sha256(BytesIn input);
+
+  /**
+   * Take SHA-256 hashes of many inputs, e.g. peer ids of kademlia response
+   * @param inputs to be hashed
+   * @param out hashes of inputs, must have the same size as inputs
+   */
+  void sha256Batch(std::span<const BytesIn> inputs,
+                   std::span<libp2p::common::Hash256> out);
 }  // namespace libp2p::crypto
@@ -0,0 +1,53 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <span>
+#include <thread>
+#include <vector>
+
+#include <libp2p/outcome/outcome.hpp>
+
+namespace libp2p::crypto {
+  /// Smaller batches are verified on the calling thread
+  constexpr size_t kMinParallelVerifyBatch = 64;
+
+  /**
+   * Verifies jobs in parallel, for providers without batch verification
+   * @param jobs - jobs to verify
+   * @param verify - called for each job, possibly from several threads
+   * @return results in order of jobs
+   */
+  template <typename Job, typename Verify>
+  std::vector<outcome::result<bool>> verifyBatchParallel(
+      std::span<const Job> jobs, const Verify &verify) {
+    std::vector<outcome::result<bool>> results(jobs.size(), false);
+    auto range = [&](size_t begin, size_t end) {
+      for (auto i = begin; i < end; ++i) {
+        results[i] = verify(jobs[i]);
+      }
+    };
+    size_t threads = std::min<size_t>(std::thread::hardware_concurrency(),
+                                      jobs.size() / kMinParallelVerifyBatch);
+    if (threads < 2) {
+      range(0, jobs.size());
+      return results;
+    }
+    auto chunk = (jobs.size() + threads - 1) / threads;
+    std::vector<std::thread> workers;
+    workers.reserve(threads - 1);
+    for (size_t begin = chunk; begin < jobs.size(); begin += chunk) {
+      workers.emplace_back(range, begin, std::min(begin + chunk, jobs.size()));
+    }
+    range(0, chunk);
+    for (auto &worker : workers) {
+      worker.join();
+    }
+    return results;
+  }
+}  // namespace libp2p::crypto
@@ -6,13 +6,16 @@
 
 #pragma once
 
+#include <cstdint>
+#include <functional>
 #include <map>
 #include <memory>
 #include <typeindex>
+#include <vector>
 
 #include <boost/asio.hpp>
 #include <boost/exception/diagnostic_information.hpp>
-#include <boost/signals2.hpp>
+#include <boost/noncopyable.hpp>
 
 #include <libp2p/log/logger.hpp>
 
@@ -31,25 +34,34 @@ namespace libp2p::event {
     drop_exceptions() = default;
     using result_type = void;
 
-    template <typename InputIterator>
-    result_type operator()(InputIterator first, InputIterator last) {
-      while (first != last) {
-        try {
-          *first;
-        } catch (const std::exception &e) {
-          // drop
-          log::createLogger("Bus")->error(
-              "Exception in signal handler, ignored, what={}", e.what());
-        } catch (...) {
-          // drop
-          log::createLogger("Bus")->error(
-              "Exception in signal handler, ignored");
-        }
-        ++first;
+    template <typename Slot, typename Data>
+    result_type operator()(const Slot &slot, const Data &data) {
+      try {
+        slot(data);
+      } catch (const std::exception &e) {
+        // drop
+        log::createLogger("Bus")->error(
+            "Exception in signal handler, ignored, what={}", e.what());
+      } catch (...) {
+        // drop
+        log::createLogger("Bus")->error("Exception in signal handler, ignored");
       }
     }
   };
 
+  namespace detail {
+    /**
+     * Part of the channel, which outlives it as long as there are handles to
+     * its subscriptions
+     */
+    class Subscriptions {
+     public:
+      virtual ~Subscriptions() = default;
+
+      virtual void unsubscribe(uint64_t id) = 0;
+    };
+  }  // namespace detail
+
   /**
    * Type that represents an active subscription to a channel allowing
    * for ownership via RAII and also explicit unsubscribe actions
@@ -65,54 +77,52 @@ namespace libp2p::event {
      * of this object expires
      */
     void unsubscribe() {
-      if (handle_.connected()) {
-        try {
-          handle_.disconnect();
-        } catch (...) {
-          log::createLogger("Bus")->error("disconnect handle caused exception");
-        }
+      if (auto subscriptions = subscriptions_.lock()) {
+        subscriptions->unsubscribe(id_);
       }
+      subscriptions_.reset();
     }
 
     // This handle can be constructed and moved
     Handle() = default;
 
     /// Cancels existing connection
-    Handle &operator=(Handle &&rhs) {
-      unsubscribe();
-      handle_ = std::move(rhs.handle_);
-
-      assert(!rhs.handle_.connected());  // move was correct?
-
+    Handle &operator=(Handle &&rhs) noexcept {
+      if (this != &rhs) {
+        unsubscribe();
+        subscriptions_ = std::move(rhs.subscriptions_);
+        id_ = rhs.id_;
+        rhs.subscriptions_.reset();
+      }
       return *this;
     }
 
-    // no way they can be noexcept because of none-noexcept
-    // boost::signal2::connection move ctor
-    Handle(Handle &&) = default;  // NOLINT
+    Handle(Handle &&rhs) noexcept
+        : subscriptions_{std::move(rhs.subscriptions_)}, id_{rhs.id_} {
+      rhs.subscriptions_.reset();
+    }
 
     // dont allow copying since this protects the resource
     Handle(const Handle &) = delete;
     Handle &operator=(const Handle &) = delete;
 
    private:
-    using handle_type = boost::signals2::scoped_connection;
-    handle_type handle_;
+    std::weak_ptr<detail::Subscriptions> subscriptions_;
+    uint64_t id_ = 0;
 
-    /**
-     * Construct a handle from an internal representation of a handle
-     * In this case a boost::signals2::connection
-     *
-     * @param _handle - the boost::signals2::connection to wrap
-     */
-    explicit Handle(handle_type &&handle) : handle_(std::move(handle)) {}
+    Handle(std::weak_ptr<detail::Subscriptions> subscriptions, uint64_t id)
+        : subscriptions_{std::move(subscriptions)}, id_{id} {}
 
     template <typename D, typename DP>
     friend class Channel;
   };
 
   /**
-   * Channel, which can emit events and allows to subscribe to them
+   * Channel, which can emit events and allows to subscribe to them.
+   * Subscribers are kept in a contiguous vector and are called with a
+   * reference to the published data. Subscribing and unsubscribing from a
+   * handler is allowed; both are applied after the dispatch is over.
+   * Not thread-safe, the channel must be used from one thread.
    */
   template <typename Data, typename DispatchPolicy>
   class Channel {
@@ -125,7 +135,12 @@ namespace libp2p::event {
      */
     template <typename Callback>
     Handle subscribe(Callback &&cb) {
-      return Handle(signal_.connect(std::forward<Callback>(cb)));
+      auto id = ++slots_->last_id;
+      ++slots_->count;
+      auto &target =
+          slots_->dispatching == 0 ? slots_->active : slots_->pending;
+      target.push_back(Slot{id, std::forward<Callback>(cb)});
+      return Handle(slots_, id);
     }
 
     /**
@@ -133,8 +148,19 @@ namespace libp2p::event {
      * @param data to be published
      */
     void publish(const Data &data) {
-      if (hasSubscribers()) {
-        signal_(data);
+      if (!hasSubscribers()) {
+        return;
+      }
+      // handlers may destroy this channel, so keep subscribers alive
+      auto slots = slots_;
+      DispatchPolicy policy;
+      DispatchGuard guard{*slots};
+      // subscribers added by handlers go to pending, so size doesn't change
+      for (size_t i = 0, n = slots->active.size(); i < n; ++i) {
+        auto &slot = slots->active[i];
+        if (slot.id != 0) {
+          policy(slot.callback, data);
+        }
       }
     }
 
@@ -142,13 +168,95 @@ namespace libp2p::event {
      * Returns whether or not there are subscribers
      */
     bool hasSubscribers() {
-      auto connections = signal_.num_slots();
-      return connections > 0;
+      return slots_->count != 0;
     }
 
    private:
+    using Callback = std::function<void(const Data &)>;
+
+    struct Slot {
+      /// zero marks slot unsubscribed during dispatch
+      uint64_t id;
+      Callback callback;
+    };
+
+    struct Slots : detail::Subscriptions {
+      std::vector<Slot> active;
+      std::vector<Slot> pending;
+      uint64_t last_id = 0;
+      size_t count = 0;
+      size_t dispatching = 0;
+      bool dirty = false;
+
+      void unsubscribe(uint64_t id) override {
+        for (auto *slots : {&active, &pending}) {
+          for (auto it = slots->begin(); it != slots->end(); ++it) {
+            if (it->id != id) {
+              continue;
+            }
+            --count;
+            if (dispatching != 0 and slots == &active) {
+              // the callback may be running now, so erase it later
+              it->id = 0;
+              dirty = true;
+            } else {
+              slots->erase(it);
+            }
+            return;
+          }
+        }
+      }
+
+      /// Releases callbacks, which outstanding handles don't need
+      void close() {
+        pending.clear();
+        count = 0;
+        if (dispatching == 0) {
+          active.clear();
+          return;
+        }
+        for (auto &slot : active) {
+          slot.id = 0;
+        }
+        dirty = true;
+      }
+
+      /// Applies changes deferred during dispatch
+      void dispatched() {
+        if (dirty) {
+          std::erase_if(active, [](const Slot &slot) { return slot.id == 0; });
+          dirty = false;
+        }
+        for (auto &slot : pending) {
+          active.emplace_back(std::move(slot));
+        }
+        pending.clear();
+      }
+    };
+
+    /// Tracks nested dispatch, handlers may publish to the same channel
+    struct DispatchGuard {
+      explicit DispatchGuard(Slots &slots) : slots{slots} {
+        ++slots.dispatching;
+      }
+
+      ~DispatchGuard() {
+        if (--slots.dispatching == 0) {
+          slots.dispatched();
+        }
+      }
+
+      DispatchGuard(const DispatchGuard &) = delete;
+      DispatchGuard &operator=(const DispatchGuard &) = delete;
+
+      Slots &slots;
+    };
+
     Channel() = default;
-    virtual ~Channel() = default;
+
+    virtual ~Channel() {
+      slots_->close();
+    }
 
     /**
      * Proper deleter for type-erased channel
@@ -179,7 +287,7 @@ namespace libp2p::event {
       return erased_channel_ptr(new Channel(), &deleter);
     }
 
-    boost::signals2::signal<void(const Data &), DispatchPolicy> signal_;
+    std::shared_ptr<Slots> slots_ = std::make_shared<Slots>();
 
     friend class Bus;
   };
@@ -226,11 +334,10 @@ namespace libp2p::event {
       using channel_type = typename ChannelDecl::channel_type;
       auto key = std::type_index(typeid(ChannelDecl));
       auto itr = channels_.find(key);
-      if (itr != channels_.end()) {
-        return *channel_type::get_channel(itr->second);
+      if (itr == channels_.end()) {
+        itr = channels_.emplace(key, channel_type::make_unique()).first;
       }
-      channels_.emplace(std::make_pair(key, channel_type::make_unique()));
-      return *channel_type::get_channel(channels_.at(key));
+      return *channel_type::get_channel(itr->second);
     }
 
    private:
@@ -6,8 +6,12 @@
 
 #pragma once
 
+#include <libp2p/basic/scheduler.hpp>
 #include <libp2p/event/bus.hpp>
+#include <libp2p/host/basic_host/broadcast.hpp>
+#include <libp2p/host/basic_host/keep_warm.hpp>
 #include <libp2p/host/host.hpp>
+#include <libp2p/network/reachability.hpp>
 #include <libp2p/network/transport_manager.hpp>
 #include <libp2p/peer/identity_manager.hpp>
 
@@ -19,6 +23,8 @@ namespace libp2p::host {
    * - has access to a network
    * - has event bus
    * - has peer repository
+   * Addresses, which other peers failed to dial back, are not advertised,
+   * confirmed ones go first
    */
   class BasicHost : public Host {
    public:
@@ -31,6 +37,15 @@ namespace libp2p::host {
               std::shared_ptr<network::TransportManager> transport_manager,
               Libp2pClientVersion libp2p_client_version);
 
+    /// @param scheduler for redials of warm peers, nullptr disables keepWarm()
+    BasicHost(std::shared_ptr<peer::IdentityManager> idmgr,
+              std::unique_ptr<network::Network> network,
+              std::unique_ptr<peer::PeerRepository> repo,
+              std::shared_ptr<event::Bus> bus,
+              std::shared_ptr<network::TransportManager> transport_manager,
+              Libp2pClientVersion libp2p_client_version,
+              std::shared_ptr<basic::Scheduler> scheduler);
+
     std::string_view getLibp2pVersion() const override;
 
     std::string_view getLibp2pClientVersion() const override;
@@ -60,6 +75,24 @@ namespace libp2p::host {
                    StreamProtocols protocols,
                    StreamAndProtocolOrErrorCb cb) override;
 
+    void stripeConnections(const peer::PeerInfo &peer_info,
+                           size_t connections,
+                           StreamProtocols protocols,
+                           const ConnectionResultHandler &handler) override;
+
+    void keepWarm(const peer::PeerInfo &peer_info,
+                  StreamProtocols protocols) override;
+
+    void stopKeepWarm(const peer::PeerId &peer_id) override;
+
+    void broadcast(StreamProtocols protocols,
+                   std::shared_ptr<const Bytes> payload,
+                   std::vector<peer::PeerInfo> peers,
+                   BroadcastConfig config,
+                   BroadcastHandler handler) override;
+
+    std::vector<metrics::MemoryUsageEntry> dumpMemoryUsage() const override;
+
     outcome::result<void> listen(const multi::Multiaddress &ma) override;
 
     outcome::result<void> closeListener(const multi::Multiaddress &ma) override;
@@ -89,6 +122,18 @@ namespace libp2p::host {
     std::shared_ptr<event::Bus> bus_;
     std::shared_ptr<network::TransportManager> transport_manager_;
     Libp2pClientVersion libp2p_client_version_;
+    /// known reachability of our addresses, unknown ones are not stored
+    std::unordered_map<multi::Multiaddress, network::Reachability>
+        reachability_;
+    event::Handle reachability_sub_;
+    /// protocols, which streams are spread over stripe of connections to peer
+    std::unordered_map<peer::PeerId, StreamProtocols> striped_;
+    /// peers, connections to which are kept open
+    std::shared_ptr<KeepWarm> keep_warm_;
+    /// streams kept open by broadcasts
+    std::shared_ptr<BroadcastStreams> broadcast_streams_ =
+        std::make_shared<BroadcastStreams>();
+    event::Handle disconnected_sub_;
   };
 
 }  // namespace libp2p::host
@@ -0,0 +1,96 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <chrono>
+#include <deque>
+#include <unordered_map>
+#include <unordered_set>
+
+#include <libp2p/basic/scheduler.hpp>
+#include <libp2p/host/host.hpp>
+#include <libp2p/network/dnsaddr_resolver.hpp>
+
+namespace libp2p::host {
+
+  /**
+   * Connects to bootstrap peers, shared by protocols instead of each of them
+   * dialing bootstrap peers on its own.
+   * /dnsaddr/ addresses are resolved concurrently, and peers are dialed as
+   * soon as they are known, at most `max_dials` at once, so that readiness is
+   * bounded by the fastest peers and not by the slowest. Remaining peers are
+   * still dialed after ready. Addresses without /p2p/ are skipped.
+   * Not thread-safe, has to be used from the io context thread.
+   */
+  class Bootstrap : public std::enable_shared_from_this<Bootstrap> {
+   public:
+    struct Config {
+      /// Max number of dials at once
+      size_t max_dials = 8;
+      /// Ready once this number of peers are connected, zero waits for all
+      size_t ready_after = 4;
+      /// Ready with fewer connected peers after timeout, zero disables
+      std::chrono::milliseconds timeout = std::chrono::seconds{10};
+      /// Max depth of /dnsaddr/ resolving to other /dnsaddr/
+      size_t max_dnsaddr_depth = 4;
+    };
+
+    /// Called for each connected peer, e.g. to add it to routing table
+    using PeerHandler = std::function<void(const peer::PeerInfo &)>;
+    /// Called once with number of connected peers, error if there are none
+    using ReadyHandler = std::function<void(outcome::result<size_t>)>;
+
+    /// @param scheduler for timeout, nullptr disables timeout
+    Bootstrap(Host &host,
+              std::shared_ptr<network::DnsaddrResolver> resolver,
+              std::shared_ptr<basic::Scheduler> scheduler,
+              Config config);
+
+    /// Completes synchronously if there are no dialable addresses
+    void start(std::vector<multi::Multiaddress> addresses,
+               PeerHandler on_peer,
+               ReadyHandler on_ready);
+
+    /// Number of connected peers
+    size_t connected() const {
+      return connected_;
+    }
+
+   private:
+    void add(const multi::Multiaddress &address, size_t depth);
+
+    void resolve(const multi::Multiaddress &address, size_t depth);
+
+    void dialNext();
+
+    void readyIfDone();
+
+    void ready();
+
+    Host &host_;
+    std::shared_ptr<network::DnsaddrResolver> resolver_;
+    std::shared_ptr<basic::Scheduler> scheduler_;
+    Config config_;
+    PeerHandler on_peer_;
+    ReadyHandler on_ready_;
+
+    /// Addresses of peers, which are not dialed yet
+    std::unordered_map<peer::PeerId, std::vector<multi::Multiaddress>>
+        candidates_;
+    /// Peers in order they became known, dialed in this order
+    std::deque<peer::PeerId> queue_;
+    /// Peers being dialed or dialed
+    std::unordered_set<peer::PeerId> dialed_;
+    /// Resolved /dnsaddr/ addresses, to skip circular references
+    std::unordered_set<multi::Multiaddress> resolved_;
+    size_t resolving_ = 0;
+    size_t dialing_ = 0;
+    size_t connected_ = 0;
+    basic::Scheduler::Handle timeout_;
+  };
+
+}  // namespace libp2p::host
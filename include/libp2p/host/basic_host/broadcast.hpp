@@ -0,0 +1,88 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <chrono>
+#include <optional>
+#include <unordered_map>
+
+#include <libp2p/connection/stream_and_protocol.hpp>
+#include <libp2p/host/host.hpp>
+
+namespace libp2p::host {
+
+  /**
+   * Streams left open by broadcasts with `keep_streams`, one per peer and
+   * protocol, taken by the next broadcasts.
+   * Not thread-safe, has to be used from the io context thread.
+   */
+  class BroadcastStreams {
+   public:
+    /// Takes open stream of the first of protocols, which has one
+    std::optional<StreamAndProtocol> take(const peer::PeerId &peer_id,
+                                          const StreamProtocols &protocols);
+
+    /// Keeps stream, replaced stream of the same protocol is closed
+    void put(const peer::PeerId &peer_id, StreamAndProtocol stream);
+
+    /// Forgets streams of disconnected peer
+    void remove(const peer::PeerId &peer_id);
+
+   private:
+    std::unordered_map<
+        peer::PeerId,
+        std::unordered_map<peer::ProtocolName,
+                           std::shared_ptr<connection::Stream>>>
+        streams_;
+  };
+
+  /**
+   * One Host::broadcast() call.
+   * Peers are taken in order, streams are opened with Host::newStream() and
+   * written with shared payload, at most `max_streams` at once. Kept stream,
+   * which fails to write, is replaced with new one once.
+   */
+  class Broadcast : public std::enable_shared_from_this<Broadcast> {
+   public:
+    /// @param streams to reuse and keep streams, nullptr closes streams
+    Broadcast(Host &host,
+              std::shared_ptr<BroadcastStreams> streams,
+              StreamProtocols protocols,
+              std::shared_ptr<const Bytes> payload,
+              std::vector<peer::PeerInfo> peers,
+              size_t max_streams,
+              Host::BroadcastHandler handler);
+
+    /// Completes synchronously if there are no peers
+    void start();
+
+   private:
+    void sendNext();
+
+    void open(size_t i);
+
+    void send(size_t i, StreamAndProtocol stream, bool kept);
+
+    void sent(size_t i, outcome::result<void> result);
+
+    Host &host_;
+    std::shared_ptr<BroadcastStreams> streams_;
+    StreamProtocols protocols_;
+    std::shared_ptr<const Bytes> payload_;
+    std::vector<peer::PeerInfo> peers_;
+    size_t max_streams_;
+    Host::BroadcastHandler handler_;
+
+    Host::BroadcastResult result_;
+    std::chrono::steady_clock::time_point started_;
+    /// Index of the next peer to open stream to
+    size_t next_ = 0;
+    size_t inflight_ = 0;
+    size_t done_ = 0;
+  };
+
+}  // namespace libp2p::host
@@ -0,0 +1,102 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <chrono>
+#include <optional>
+#include <unordered_map>
+#include <unordered_set>
+
+#include <libp2p/basic/scheduler.hpp>
+#include <libp2p/connection/stream_and_protocol.hpp>
+#include <libp2p/event/bus.hpp>
+#include <libp2p/network/network.hpp>
+#include <libp2p/peer/stream_protocols.hpp>
+
+namespace libp2p::host {
+
+  /**
+   * Peers, connections to which are kept open.
+   * Connections to them are not closed when idle and are protected from
+   * trimming. Lost connection is redialed at once, failed redials are
+   * retried with exponential backoff. Streams of given protocols are
+   * negotiated in advance, one per protocol, and replaced when taken.
+   * Not thread-safe, has to be used from the io context thread.
+   */
+  class KeepWarm : public std::enable_shared_from_this<KeepWarm> {
+   public:
+    struct Config {
+      /// delay of redial after the first failure, doubled by each next one
+      std::chrono::milliseconds retry_base = std::chrono::seconds{1};
+      std::chrono::milliseconds retry_max = std::chrono::minutes{1};
+    };
+
+    KeepWarm(network::Network &network,
+             event::Bus &bus,
+             std::shared_ptr<basic::Scheduler> scheduler,
+             Config config);
+
+    KeepWarm(const KeepWarm &) = delete;
+    KeepWarm &operator=(const KeepWarm &) = delete;
+
+    ~KeepWarm();
+
+    /// Adds peer or replaces its addresses and protocols, dials it
+    void add(const peer::PeerInfo &peer_info, StreamProtocols protocols);
+
+    /// Removes peer, closes its pre-opened streams, connections to it are
+    /// closed when idle again
+    void remove(const peer::PeerId &peer_id);
+
+    bool contains(const peer::PeerId &peer_id) const;
+
+    /// Takes pre-opened stream of the first of protocols, which has one
+    std::optional<StreamAndProtocol> takeStream(
+        const peer::PeerId &peer_id, const StreamProtocols &protocols);
+
+   private:
+    struct Peer {
+      peer::PeerInfo info;
+      StreamProtocols protocols;
+      /// negotiated streams, waiting for newStream()
+      std::unordered_map<peer::ProtocolName,
+                         std::shared_ptr<connection::Stream>>
+          streams;
+      /// protocols, which streams are being negotiated
+      std::unordered_set<peer::ProtocolName> opening;
+      /// delay of the next redial, zero after success
+      std::chrono::milliseconds retry{};
+      basic::Scheduler::Handle redial;
+      bool dialing = false;
+    };
+
+    void onConnection(
+        const std::shared_ptr<connection::CapableConnection> &conn);
+
+    void onDisconnected(const peer::PeerId &peer_id);
+
+    void dial(const peer::PeerId &peer_id);
+
+    void onDialed(const peer::PeerId &peer_id, bool success);
+
+    void openStreams(const peer::PeerId &peer_id);
+
+    void onStream(const peer::PeerId &peer_id,
+                  const peer::ProtocolName &protocol,
+                  StreamAndProtocolOrError r);
+
+    void setCloseWhenIdle(const peer::PeerId &peer_id, bool close);
+
+    network::Network &network_;
+    std::shared_ptr<basic::Scheduler> scheduler_;
+    const Config config_;
+    std::unordered_map<peer::PeerId, Peer> peers_;
+    event::Handle connection_sub_;
+    event::Handle disconnected_sub_;
+  };
+
+}  // namespace libp2p::host
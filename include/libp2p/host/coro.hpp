@@ -0,0 +1,41 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <libp2p/basic/coro/awaiter.hpp>
+#include <libp2p/host/host.hpp>
+#include <libp2p/network/dialer.hpp>
+
+namespace libp2p::coro {
+
+  /// @see Host::newStream
+  inline auto newStream(Host &host,
+                        const peer::PeerInfo &peer_info,
+                        StreamProtocols protocols) {
+    return awaitCallback<StreamAndProtocolOrError>(
+        [&host, &peer_info, protocols{std::move(protocols)}](auto cb) mutable {
+          host.newStream(peer_info, std::move(protocols), std::move(cb));
+        });
+  }
+
+  /// @see Host::connect
+  inline auto connect(Host &host, const peer::PeerInfo &peer_info) {
+    return awaitCallback<Host::ConnectionResult>(
+        [&host, &peer_info](auto cb) {
+          host.connect(peer_info, std::move(cb));
+        });
+  }
+
+  /// @see Dialer::dial
+  inline auto dial(network::Dialer &dialer, const peer::PeerInfo &peer_info) {
+    return awaitCallback<network::Dialer::DialResult>(
+        [&dialer, &peer_info](auto cb) {
+          dialer.dial(peer_info, std::move(cb));
+        });
+  }
+
+}  // namespace libp2p::coro
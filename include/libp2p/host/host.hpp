@@ -10,6 +10,7 @@
 #include <functional>
 #include <string_view>
 
+#include <libp2p/common/metrics/memory_usage.hpp>
 #include <libp2p/connection/stream.hpp>
 #include <libp2p/connection/stream_and_protocol.hpp>
 #include <libp2p/event/bus.hpp>
@@ -49,6 +50,22 @@ namespace libp2p {
 
     using NewConnectionHandler = std::function<void(peer::PeerInfo &&)>;
 
+    struct BroadcastConfig {
+      /// Max number of streams being opened or written at once
+      size_t max_streams = 16;
+      /// Streams are left open after write and are reused by the next
+      /// broadcasts of the protocol, instead of being closed
+      bool keep_streams = false;
+    };
+
+    struct BroadcastResult {
+      /// Outcome of write to each peer, in order of peers
+      std::vector<std::pair<peer::PeerId, outcome::result<void>>> peers;
+      /// Time from broadcast() till the last peer is done
+      std::chrono::microseconds latency{};
+    };
+    using BroadcastHandler = std::function<void(BroadcastResult)>;
+
     enum class Connectedness {
       NOT_CONNECTED,  ///< we don't know peer's addresses, and are not connected
       CONNECTED,      ///< we have at least one connection to this peer
@@ -167,6 +184,60 @@ namespace libp2p {
       newStream(PeerInfo{.id = peer_id}, std::move(protocols), std::move(cb));
     }
 
+    /**
+     * @brief Keeps {@param connections} parallel connections to the peer
+     * {@param peer_info}, new streams of {@param protocols} are spread over
+     * them. Bulk transfers are not limited by congestion window of one
+     * connection then. Striped connections are trimmed as one.
+     * Less than 2 connections stops striping
+     * @param handler callback, will be executed when the first connection is
+     * established or fails
+     */
+    virtual void stripeConnections(const peer::PeerInfo &peer_info,
+                                   size_t connections,
+                                   StreamProtocols protocols,
+                                   const ConnectionResultHandler &handler) {
+      connect(peer_info, handler);
+    }
+
+    /**
+     * @brief Keeps connection to the peer {@param peer_info} warm: it is not
+     * closed when idle nor trimmed, and is redialed with backoff when lost.
+     * One stream of each of {@param protocols} is negotiated in advance,
+     * newStream() to the peer takes it and the stream is replaced. Calling
+     * again replaces addresses and protocols of the peer
+     */
+    virtual void keepWarm(const peer::PeerInfo &peer_info,
+                          StreamProtocols protocols) {
+      connect(peer_info);
+    }
+
+    /**
+     * @brief Stops keeping connection to the peer {@param peer_id} warm,
+     * its pre-opened streams are closed
+     */
+    virtual void stopKeepWarm(const peer::PeerId &peer_id) {}
+
+    /**
+     * @brief Writes {@param payload} to each of {@param peers} over stream of
+     * the first supported of {@param protocols}. Payload is shared by all
+     * writes, not copied per peer, at most `config.max_streams` streams are
+     * opened or written at once
+     * @param handler called once, when all peers are done
+     */
+    virtual void broadcast(StreamProtocols protocols,
+                           std::shared_ptr<const Bytes> payload,
+                           std::vector<peer::PeerInfo> peers,
+                           BroadcastConfig config,
+                           BroadcastHandler handler) {
+      BroadcastResult result;
+      for (auto &peer : peers) {
+        result.peers.emplace_back(std::move(peer.id),
+                                  make_error_code(std::errc::not_supported));
+      }
+      handler(std::move(result));
+    }
+
     /**
      * @brief Create listener on given multiaddress.
      * @param ma address
@@ -219,5 +290,13 @@ namespace libp2p {
      * @brief Getter for event bus.
      */
     virtual event::Bus &getBus() = 0;
+
+    /**
+     * @brief Memory buffered by live connections and streams, aggregated by
+     * layer, peer and protocol. Empty unless built with metrics enabled
+     */
+    virtual std::vector<metrics::MemoryUsageEntry> dumpMemoryUsage() const {
+      return {};
+    }
   };
 }  // namespace libp2p
@@ -12,6 +12,7 @@
 #include <libp2p/host/basic_host.hpp>
 #include <libp2p/peer/impl/peer_repository_impl.hpp>
 #include <libp2p/peer/key_repository/inmem_key_repository.hpp>
+#include <libp2p/peer/latency_repository/inmem_latency_repository.hpp>
 #include <libp2p/peer/protocol_repository/inmem_protocol_repository.hpp>
 
 namespace libp2p::injector {
@@ -32,6 +33,7 @@ namespace libp2p::injector {
         di::bind<peer::PeerRepository>.to<peer::PeerRepositoryImpl>(),
         di::bind<peer::KeyRepository>.to<peer::InmemKeyRepository>(),
         di::bind<peer::ProtocolRepository>.to<peer::InmemProtocolRepository>(),
+        di::bind<peer::LatencyRepository>.to<peer::InmemLatencyRepository>(),
 
         di::bind<Libp2pClientVersion>.to(Libp2pClientVersion{"cpp-libp2p"}),
 
@@ -6,11 +6,15 @@
 
 #pragma once
 
+#include <optional>
+
 #include <boost/di.hpp>
 
 // implementations
 #include <libp2p/basic/scheduler/asio_scheduler_backend.hpp>
 #include <libp2p/basic/scheduler/scheduler_impl.hpp>
+#include <libp2p/connection/connection_health.hpp>
+#include <libp2p/common/metrics/startup.hpp>
 #include <libp2p/crypto/aes_ctr/aes_ctr_impl.hpp>
 #include <libp2p/crypto/crypto_provider/crypto_provider_impl.hpp>
 #include <libp2p/crypto/ecdsa_provider/ecdsa_provider_impl.hpp>
@@ -24,10 +28,12 @@
 #include <libp2p/layer/websocket.hpp>
 #include <libp2p/muxer/mplex.hpp>
 #include <libp2p/muxer/yamux.hpp>
+#include <libp2p/network/impl/connection_gater_impl.hpp>
 #include <libp2p/network/impl/connection_manager_impl.hpp>
 #include <libp2p/network/impl/dialer_impl.hpp>
 #include <libp2p/network/impl/dnsaddr_resolver_impl.hpp>
 #include <libp2p/network/impl/listener_manager_impl.hpp>
+#include <libp2p/network/impl/load_aware_connection_selector.hpp>
 #include <libp2p/network/impl/network_impl.hpp>
 #include <libp2p/network/impl/router_impl.hpp>
 #include <libp2p/network/impl/transport_manager_impl.hpp>
@@ -43,6 +49,7 @@
 #include <libp2p/security/tls.hpp>
 #include <libp2p/security/tls/ssl_context.hpp>
 #include <libp2p/transport/impl/upgrader_impl.hpp>
+#include <libp2p/transport/memory/transport.hpp>
 #include <libp2p/transport/quic/transport.hpp>
 #include <libp2p/transport/tcp.hpp>
 
@@ -282,6 +289,7 @@ namespace libp2p::injector {
   inline auto makeNetworkInjector(Ts &&...args) {
     namespace di = boost::di;
 
+    std::optional<metrics::StartupPhase> phase{std::in_place, "keypair"};
     auto csprng = std::make_shared<crypto::random::BoostRandomGenerator>();
     auto ed25519_provider =
         std::make_shared<crypto::ed25519::Ed25519ProviderImpl>();
@@ -304,6 +312,8 @@ namespace libp2p::injector {
     auto keypair =
         crypto_provider->generateKeys(crypto::Key::Type::Ed25519).value();
 
+    phase.reset();
+
     // clang-format off
     return di::make_injector<InjectorConfig>(
         di::bind<crypto::random::RandomGenerator>.to<crypto::random::BoostRandomGenerator>(),
@@ -325,15 +335,26 @@ namespace libp2p::injector {
         di::bind<security::secio::ExchangeMessageMarshaller>().to<security::secio::ExchangeMessageMarshallerImpl>(),
         di::bind<layer::WsConnectionConfig>.to(layer::WsConnectionConfig{}),
         di::bind<layer::WssCertificate>.to(layer::WssCertificate{}),
+        di::bind<security::NoiseConfig>.to(security::NoiseConfig{}),
+        di::bind<security::TlsConfig>.to(security::TlsConfig{}),
+        di::bind<transport::QuicConfig>.to(transport::QuicConfig{}),
+        di::bind<transport::InboundGateConfig>.to(transport::InboundGateConfig{}),
+        di::bind<transport::UpgraderConfig>.to(transport::UpgraderConfig{}),
+        di::bind<transport::TcpSocketOptions>.to(transport::TcpSocketOptions{}),
 
         di::bind<basic::Scheduler::Config>.to(basic::Scheduler::Config{}),
+        di::bind<connection::ConnectionHealth::Config>.to(connection::ConnectionHealth::Config{}),
         di::bind<basic::SchedulerBackend>().to<basic::AsioSchedulerBackend>(),
         di::bind<basic::Scheduler>().to<basic::SchedulerImpl>(),
 
         // internal
         di::bind<network::DnsaddrResolver>().to <network::DnsaddrResolverImpl>(),
         di::bind<network::Router>().to<network::RouterImpl>(),
+        di::bind<network::ConnectionManagerConfig>.to(network::ConnectionManagerConfig{}),
         di::bind<network::ConnectionManager>().to<network::ConnectionManagerImpl>(),
+        di::bind<network::ConnectionSelector>().to<network::LoadAwareConnectionSelector>(),
+        di::bind<network::ConnectionGaterImpl::Config>.to(network::ConnectionGaterImpl::Config{}),
+        di::bind<network::ConnectionGater>().to<network::ConnectionGaterImpl>(),
         di::bind<network::ListenerManager>().to<network::ListenerManagerImpl>(),
         di::bind<network::Dialer>().to<network::DialerImpl>(),
         di::bind<network::Network>().to<network::NetworkImpl>(),
@@ -343,10 +364,13 @@ namespace libp2p::injector {
 
         // default adaptors
         di::bind<muxer::MuxedConnectionConfig>.to(muxer::MuxedConnectionConfig{}),
+        di::bind<muxer::MemoryLimits>.to(muxer::MemoryLimits{}),
+        di::bind<muxer::BandwidthLimits>.to(muxer::BandwidthLimits{}),
+        di::bind<muxer::StreamLimits>.to(muxer::StreamLimits{}),
         di::bind<layer::LayerAdaptor *[]>().to<layer::WsAdaptor, layer::WssAdaptor>(),  // NOLINT
         di::bind<security::SecurityAdaptor *[]>().to<security::Plaintext, security::Secio, security::Noise, security::TlsAdaptor>(),  // NOLINT
         di::bind<muxer::MuxerAdaptor *[]>().to<muxer::Yamux, muxer::Mplex>(),  // NOLINT
-        di::bind<transport::TransportAdaptor *[]>().to<transport::TcpTransport, transport::QuicTransport>(),  // NOLINT
+        di::bind<transport::TransportAdaptor *[]>().to<transport::TcpTransport, transport::QuicTransport, transport::MemoryTransport>(),  // NOLINT
 
         di::bind<peer::AddressRepository>.to<peer::InmemAddressRepository>(),
 
@@ -16,9 +16,14 @@ namespace libp2p::layer {
 
   class WsAdaptor : public LayerAdaptor {
    public:
+    /**
+     * @param health shared keepalive of connections, nullptr means timers
+     * of each connection
+     */
     WsAdaptor(std::shared_ptr<basic::Scheduler> scheduler,
               std::shared_ptr<boost::asio::io_context> io_context,
-              WsConnectionConfig config);
+              WsConnectionConfig config,
+              std::shared_ptr<connection::ConnectionHealth> health = nullptr);
 
     multi::Protocol::Code getProtocol() const override;
 
@@ -33,6 +38,7 @@ namespace libp2p::layer {
     std::shared_ptr<basic::Scheduler> scheduler_;
     std::shared_ptr<boost::asio::io_context> io_context_;
     WsConnectionConfig config_;
+    std::shared_ptr<connection::ConnectionHealth> health_;
 
     log::Logger log_ = log::createLogger("WsAdaptor");
   };
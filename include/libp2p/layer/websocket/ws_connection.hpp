@@ -11,6 +11,7 @@
 #include <libp2p/basic/scheduler.hpp>
 #include <libp2p/common/metrics/instance_count.hpp>
 #include <libp2p/connection/as_asio_read_write.hpp>
+#include <libp2p/connection/connection_health.hpp>
 #include <libp2p/connection/layer_connection.hpp>
 #include <libp2p/layer/websocket/ws_connection_config.hpp>
 #include <libp2p/log/logger.hpp>
@@ -38,6 +39,7 @@ namespace libp2p {
 namespace libp2p::connection {
 
   class WsConnection final : public LayerConnection,
+                             public HealthCheck,
                              public std::enable_shared_from_this<WsConnection> {
    public:
     WsConnection(const WsConnection &other) = delete;
@@ -49,11 +51,14 @@ namespace libp2p::connection {
     /**
      * Create a new WsConnection instance
      * @param connection to be wrapped to websocket by this instance
+     * @param health shared keepalive, pings idle connection instead of
+     * own ping timer, nullptr means own timer
      */
     explicit WsConnection(layer::WsConnectionConfig config,
                           std::shared_ptr<boost::asio::io_context> io_context,
                           std::shared_ptr<LayerConnection> connection,
-                          std::shared_ptr<basic::Scheduler> scheduler);
+                          std::shared_ptr<basic::Scheduler> scheduler,
+                          std::shared_ptr<ConnectionHealth> health = nullptr);
 
     bool isInitiator() const override;
 
@@ -81,8 +86,12 @@ namespace libp2p::connection {
 
    private:
     void setTimerPing();
+    void sendPing();
     void onPong(BytesIn payload);
 
+    /// HealthCheck override, pings connection without inbound traffic
+    void onHealthIdle(Time idle) override;
+
     /// Config
     layer::WsConnectionConfig config_;
 
@@ -93,6 +102,9 @@ namespace libp2p::connection {
     /// Scheduler
     std::shared_ptr<basic::Scheduler> scheduler_;
 
+    /// Shared keepalive, replaces ping timer
+    std::shared_ptr<ConnectionHealth> health_;
+
     /// True if started
     bool started_ = false;
 
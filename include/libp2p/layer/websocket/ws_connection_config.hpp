@@ -7,6 +7,7 @@
 #pragma once
 
 #include <chrono>
+#include <cstddef>
 
 namespace libp2p::layer {
   /**
@@ -15,5 +16,15 @@ namespace libp2p::layer {
   struct WsConnectionConfig {
     std::chrono::milliseconds ping_interval{60'000};
     std::chrono::milliseconds ping_timeout{10'000};
+
+    /// Split written messages into frames of write_buffer_bytes
+    bool auto_fragment = false;
+
+    /// Size of buffer used for masking of client frames and for fragments
+    size_t write_buffer_bytes = 64 << 10;
+
+    /// Compression costs cpu and copying, and libp2p streams are usually
+    /// encrypted and thus incompressible
+    bool permessage_deflate = false;
   };
 }  // namespace libp2p::layer
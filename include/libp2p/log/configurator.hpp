@@ -6,12 +6,35 @@
 
 #pragma once
 
+#include <chrono>
+#include <string>
+
 #include <soralog/impl/configurator_from_yaml.hpp>
 
 #include <boost/di.hpp>
 
+#include <libp2p/log/logger.hpp>
+
 namespace libp2p::log {
 
+  /**
+   * Sink of libp2p loggers, which doesn't write on the logging thread.
+   * Messages are put into a ring buffer, a background thread writes them,
+   * so debug logs may be enabled without blocking the network thread on I/O.
+   */
+  struct AsyncSinkConfig {
+    /// file to write to, console if empty
+    std::string path;
+    /// max number of buffered messages
+    size_t capacity = 8192;
+    /// bytes of ring buffer
+    size_t buffer = 4 << 20;
+    /// max delay of writing a message
+    std::chrono::milliseconds latency{200};
+    /// level of libp2p group
+    Level level = Level::DEBUG;
+  };
+
   class Configurator : public soralog::ConfiguratorFromYAML {
    public:
     BOOST_DI_INJECT_TRAITS();
@@ -19,6 +42,9 @@ namespace libp2p::log {
     Configurator();
 
     explicit Configurator(std::string config);
+
+    /// Libp2p loggers configuration, which routes them to async sink
+    explicit Configurator(const AsyncSinkConfig &sink);
   };
 
 }  // namespace libp2p::log
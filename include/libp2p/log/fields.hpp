@@ -0,0 +1,57 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+#include <fmt/format.h>
+
+#include <libp2p/peer/peer_id.hpp>
+
+namespace libp2p::log {
+
+  /**
+   * Context of a message, passed as a logger argument instead of formatting it
+   * into a string beforehand. Fields are formatted as "key=value" pairs only
+   * if the message passes the level of logger.
+   * Refers to the values, so it must not outlive them.
+   */
+  struct Fields {
+    const peer::PeerId *peer = nullptr;
+    std::optional<uint32_t> stream;
+    std::string_view protocol;
+  };
+
+}  // namespace libp2p::log
+
+template <>
+struct fmt::formatter<libp2p::log::Fields> {
+  constexpr auto parse(format_parse_context &ctx) -> decltype(ctx.begin()) {
+    return ctx.begin();
+  }
+
+  template <typename FormatContext>
+  auto format(const libp2p::log::Fields &fields, FormatContext &ctx) const
+      -> decltype(ctx.out()) {
+    auto out = ctx.out();
+    std::string_view separator;
+    if (fields.peer != nullptr) {
+      out = fmt::format_to(out, "peer={}", fields.peer->toBase58());
+      separator = " ";
+    }
+    if (fields.stream) {
+      out = fmt::format_to(out, "{}stream={}", separator, *fields.stream);
+      separator = " ";
+    }
+    if (not fields.protocol.empty()) {
+      out = fmt::format_to(out, "{}protocol={}", separator, fields.protocol);
+    }
+    return out;
+  }
+};
@@ -43,4 +43,20 @@ namespace libp2p::multi {
     Multihash content_address;
   };
 
+  /**
+   * Validated CID, which references the buffer it was decoded from.
+   * Used by parsers to avoid allocations, the buffer must outlive the view.
+   * Convert to ContentIdentifier to store it
+   */
+  struct ContentIdentifierView {
+    /// @return owned copy of the CID
+    ContentIdentifier toContentIdentifier() const;
+
+    ContentIdentifier::Version version;
+    MulticodecType::Code content_type;
+    MultihashView content_address;
+    /// Whole encoded CID
+    BytesIn bytes;
+  };
+
 }  // namespace libp2p::multi
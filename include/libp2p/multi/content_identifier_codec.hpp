@@ -46,6 +46,13 @@ namespace libp2p::multi {
 
     static outcome::result<ContentIdentifier> decode(BytesIn bytes);
 
+    /**
+     * @brief Validates CID without copying it
+     * @param bytes - encoded CID, must outlive the view
+     * @return view of CID
+     */
+    static outcome::result<ContentIdentifierView> decodeView(BytesIn bytes);
+
     /**
      * @brief Encode CID to string representation
      * @param cid - input CID for encode
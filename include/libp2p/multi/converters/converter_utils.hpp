@@ -20,6 +20,14 @@ namespace libp2p::multi::converters {
   outcome::result<Bytes> addressToBytes(const Protocol &protocol,
                                         std::string_view addr);
 
+  /**
+   * Appends byte representation of the address of the specified protocol to
+   * `out`. On failure `out` may contain a part of the address
+   */
+  outcome::result<void> appendAddressBytes(Bytes &out,
+                                           const Protocol &protocol,
+                                           std::string_view addr);
+
   /**
    * Converts the given multiaddr string to a byte sequence representing
    * the multiaddr, if provided multiaddr was valid
@@ -27,6 +35,14 @@ namespace libp2p::multi::converters {
   auto multiaddrToBytes(std::string_view multiaddr_str)
       -> outcome::result<Bytes>;
 
+  /**
+   * Parses the multiaddr string in a single pass, appending its byte
+   * representation to `out`, which may be reused between calls.
+   * On failure `out` may contain a part of the multiaddr
+   */
+  outcome::result<void> appendMultiaddrBytes(Bytes &out,
+                                             std::string_view multiaddr_str);
+
   /**
    * Converts the given byte sequence representing
    * a multiaddr to a string containing the multiaddr in a human-readable
@@ -34,4 +50,10 @@ namespace libp2p::multi::converters {
    */
   auto bytesToMultiaddrString(BytesIn bytes) -> outcome::result<std::string>;
 
+  /**
+   * Appends human-readable multiaddr string of the byte sequence to `out`.
+   * On failure `out` may contain a part of the multiaddr
+   */
+  outcome::result<void> appendMultiaddrString(std::string &out, BytesIn bytes);
+
 }  // namespace libp2p::multi::converters
@@ -139,6 +139,15 @@ namespace libp2p::multi {
     outcome::result<std::string> getFirstValueForProtocol(
         Protocol::Code proto) const;
 
+    /**
+     * Get first value for protocol without copying it
+     * @param proto to be searched for
+     * @return view of value, which is valid until this multiaddress is
+     * modified, or error if protocol is not found
+     */
+    outcome::result<std::string_view> peekFirstValueForProtocol(
+        Protocol::Code proto) const;
+
     /**
      * Get protocols contained in the multiaddress. Repetitions are possible
      * @return list of contained protocols
@@ -155,6 +164,13 @@ namespace libp2p::multi {
 
     bool operator==(const Multiaddress &other) const;
 
+    /**
+     * @return Pre-calculated hash for std containers
+     */
+    size_t stdHash() const {
+      return std_hash_;
+    }
+
     /**
      * Lexicographical comparison of string representations of the
      * Multiaddresses
@@ -189,8 +205,12 @@ namespace libp2p::multi {
     bool decapsulateStringFromAddress(std::string_view proto,
                                       const ByteBuffer &bytes);
 
+    /// Updates `std_hash_` after bytes are changed
+    void rehash();
+
     std::string stringified_address_;
     ByteBuffer bytes_;
+    size_t std_hash_ = 0;
 
     boost::optional<std::string> peer_id_;
   };
@@ -207,7 +227,9 @@ namespace libp2p {
 namespace std {
   template <>
   struct hash<libp2p::multi::Multiaddress> {
-    size_t operator()(const libp2p::multi::Multiaddress &x) const;
+    size_t operator()(const libp2p::multi::Multiaddress &x) const {
+      return x.stdHash();
+    }
   };
 }  // namespace std
 
@@ -46,6 +46,9 @@ namespace libp2p::multi {
       GARLIC64 = 446,
       QUIC = 460,
       QUIC_V1 = 461,
+      // parsed and printed only, there is no WebTransport transport
+      WEBTRANSPORT = 465,
+      CERTHASH = 466,
       HTTP = 480,
       HTTPS = 443,
       WS = 477,
@@ -55,6 +58,7 @@ namespace libp2p::multi {
       P2P_WEBRTC_STAR = 275,
       P2P_WEBRTC_DIRECT = 276,
       P2P_CIRCUIT = 290,
+      MEMORY = 777,
       // https://github.com/multiformats/rust-multiaddr/blob/3c7e813c3b1fdd4187a9ca9ff67e10af0e79231d/src/protocol.rs#L50-L53
       X_PARITY_WS = 4770,
       X_PARITY_WSS = 4780,
@@ -82,9 +86,9 @@ namespace libp2p::multi {
    public:
     /**
      * The total number of known protocols
-     * (31 ordinal + 4 debug)
+     * (34 ordinal + 4 debug)
      */
-    static constexpr size_t kProtocolsNum = 31 + 4;
+    static constexpr size_t kProtocolsNum = 34 + 4;
 
     /**
      * Returns a protocol with the corresponding name if it exists, or nullptr
@@ -150,6 +154,9 @@ namespace libp2p::multi {
         {Protocol::Code::GARLIC64, Protocol::kVarLen, "garlic64"},
         {Protocol::Code::QUIC, 0, "quic"},
         {Protocol::Code::QUIC_V1, 0, "quic-v1"},
+        {Protocol::Code::WEBTRANSPORT, 0, "webtransport"},
+        // multibase-encoded multihash of certificate
+        {Protocol::Code::CERTHASH, Protocol::kVarLen, "certhash"},
         {Protocol::Code::HTTP, 0, "http"},
         {Protocol::Code::HTTPS, 0, "https"},
         {Protocol::Code::WS, 0, "ws"},
@@ -159,6 +166,7 @@ namespace libp2p::multi {
         {Protocol::Code::P2P_WEBRTC_STAR, 0, "p2p-webrtc-star"},
         {Protocol::Code::P2P_WEBRTC_DIRECT, 0, "p2p-webrtc-direct"},
         {Protocol::Code::P2P_CIRCUIT, 0, "p2p-circuit"},
+        {Protocol::Code::MEMORY, 64, "memory"},
         {Protocol::Code::X_PARITY_WS, Protocol::kVarLen, "x-parity-ws"},
         {Protocol::Code::X_PARITY_WSS, Protocol::kVarLen, "x-parity-wss"},
 // Debug section
@@ -33,7 +33,8 @@ namespace libp2p::multi {
       BASE32_LOWER = 'b',
       BASE32_UPPER = 'B',
       BASE58 = 'z',
-      BASE64 = 'm'
+      BASE64 = 'm',
+      BASE64_URL = 'u',
     };
 
     /**
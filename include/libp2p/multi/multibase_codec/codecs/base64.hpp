@@ -30,4 +30,18 @@ namespace libp2p::multi::detail {
    * @return decoded bytes in case of success
    */
   outcome::result<Bytes> decodeBase64(std::string_view string);
+
+  /**
+   * Encode bytes to url-safe base64 string without padding (RFC 4648 §5)
+   * @param bytes to be encoded
+   * @return encoded string
+   */
+  std::string encodeBase64Url(BytesIn bytes);
+
+  /**
+   * Decode url-safe base64 string without padding
+   * @param string to be decoded
+   * @return decoded bytes in case of success
+   */
+  outcome::result<Bytes> decodeBase64Url(std::string_view string);
 }  // namespace libp2p::multi::detail
@@ -14,6 +14,8 @@
 
 namespace libp2p::multi {
 
+  class MultihashView;
+
   /**
    * Special format of hash used in Libp2p. Allows to differentiate between
    * outputs of different hash functions. More
@@ -97,6 +99,8 @@ namespace libp2p::multi {
     bool operator<(const Multihash &other) const;
 
    private:
+    friend class MultihashView;
+
     /**
      * Header consists of hash type and hash size, both 1 byte or 2 hex digits
      * long, thus 4 hex digits long in total
@@ -132,6 +136,51 @@ namespace libp2p::multi {
     std::shared_ptr<const Data> data_;
   };
 
+  /**
+   * Validated multihash, which references the buffer it was parsed from.
+   * Used by parsers to avoid allocations, the buffer must outlive the view.
+   * Convert to Multihash to store it
+   */
+  class MultihashView {
+   public:
+    /**
+     * @brief Validates a binary buffer with the multihash, the same way as
+     * Multihash::createFromBytes does
+     * @param bytes - the buffer with the multihash
+     * @return result with the view in case of success
+     */
+    static outcome::result<MultihashView> create(BytesIn bytes);
+
+    /**
+     * @return the info about hash type
+     */
+    HashType getType() const;
+
+    /**
+     * @return the hash referenced by this view
+     */
+    BytesIn getHash() const;
+
+    /**
+     * @return the multihash, including its type, length and hash
+     */
+    BytesIn toBuffer() const;
+
+    /**
+     * @return owned copy of the multihash
+     */
+    Multihash toMultihash() const;
+
+    bool operator==(const MultihashView &other) const;
+
+   private:
+    MultihashView(HashType type, BytesIn bytes, size_t hash_offset);
+
+    HashType type_;
+    BytesIn bytes_;
+    size_t hash_offset_;
+  };
+
 }  // namespace libp2p::multi
 
 namespace std {
@@ -6,6 +6,8 @@
 
 #pragma once
 
+#include <array>
+#include <optional>
 #include <string>
 
 #include <boost/optional.hpp>
@@ -17,14 +19,33 @@ namespace libp2p::multi {
   /**
    * @class Encodes and decodes unsigned integers into and from
    * variable-length byte arrays using LEB128 algorithm.
+   * Encoding is stored inline, so varints don't allocate.
    */
   class UVarint {
    public:
+    /// Max size of encoded uint64_t, as 64 == 9*7 + 1
+    static constexpr size_t kMaxSize = 10;
+
+    /// Value and size of varint decoded from the beginning of bytes
+    struct Decoded {
+      uint64_t value;
+      size_t size;
+    };
+
     /**
      * Constructs a varint from an unsigned integer 'number'
      * @param number
      */
-    explicit UVarint(uint64_t number);
+    constexpr explicit UVarint(uint64_t number) : value_{number} {
+      do {
+        auto byte = static_cast<uint8_t>(number & 0x7f);
+        number >>= 7;
+        if (number != 0) {
+          byte |= 0x80;
+        }
+        bytes_[size_++] = byte;
+      } while (number != 0);
+    }
 
     /**
      * Constructs a varint from an array of raw bytes, which are
@@ -41,21 +62,34 @@ namespace libp2p::multi {
      */
     static boost::optional<UVarint> create(BytesIn varint_bytes);
 
+    /**
+     * Decodes a varint from the beginning of bytes, reading 8 bytes at once
+     * when they are available
+     * @return value and size of the varint, or none if bytes don't start with
+     * a complete varint fitting uint64_t
+     */
+    static std::optional<Decoded> decode(BytesIn varint_bytes);
+
     /**
      * Converts a varint back to a usual unsigned integer.
      * @return an integer previously encoded to the varint
      */
-    uint64_t toUInt64() const;
+    uint64_t toUInt64() const {
+      return value_;
+    }
 
     /**
      * @return an array view to raw bytes of the stored varint
      */
-    BytesIn toBytes() const &;
+    BytesIn toBytes() const & {
+      return BytesIn{bytes_}.first(size_);
+    }
 
     /// Disable to return span to inner data of temporary object
     BytesIn toBytes() const && = delete;
 
-    const std::vector<uint8_t> &toVector() const;
+    /// Copies raw bytes of the stored varint
+    Bytes toVector() const;
 
     /**
      * Assigns the varint to an unsigned integer, encoding the latter
@@ -71,7 +105,9 @@ namespace libp2p::multi {
     /**
      * @return the number of bytes currently stored in a varint
      */
-    size_t size() const;
+    size_t size() const {
+      return size_;
+    }
 
     /**
      * @param varint_bytes an array with a raw byte representation of a varint
@@ -82,9 +118,11 @@ namespace libp2p::multi {
 
    private:
     /// private ctor for unsafe creation
-    UVarint(BytesIn varint_bytes, size_t varint_size);
+    UVarint(BytesIn varint_bytes, Decoded decoded);
 
-    std::vector<uint8_t> bytes_{};
+    uint64_t value_ = 0;
+    std::array<uint8_t, kMaxSize> bytes_{};
+    uint8_t size_ = 0;
   };
 
 }  // namespace libp2p::multi
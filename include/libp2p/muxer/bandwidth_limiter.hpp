@@ -0,0 +1,138 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include <libp2p/peer/peer_id.hpp>
+#include <libp2p/peer/protocol.hpp>
+
+namespace libp2p::muxer {
+
+  struct BandwidthRate {
+    /// Zero means unlimited
+    uint64_t bytes_per_second = 0;
+
+    /// Bytes which may pass at once after idle period, zero means one second
+    /// of traffic
+    size_t burst = 0;
+  };
+
+  /**
+   * Stream payload rates, each stream is limited by all of them.
+   * Upload is limited by pacing writes, download by pacing receive window
+   * updates, so that remote side slows down instead of being buffered
+   */
+  struct BandwidthLimits {
+    struct Direction {
+      /// All streams of process
+      BandwidthRate total;
+
+      /// Streams to each peer
+      BandwidthRate peer;
+
+      /// Streams of each protocol to all peers, applied after negotiation
+      std::unordered_map<peer::ProtocolName, BandwidthRate> protocols;
+    };
+
+    Direction upload;
+    Direction download;
+  };
+
+  enum class BandwidthDirection : uint8_t { UPLOAD, DOWNLOAD };
+
+  /// Token bucket, shared by streams and threads
+  class TokenBucket {
+   public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit TokenBucket(BandwidthRate rate);
+
+    TokenBucket(const TokenBucket &) = delete;
+    TokenBucket &operator=(const TokenBucket &) = delete;
+
+    /// Bytes which may pass now, up to `bytes`
+    size_t available(size_t bytes);
+
+    /// Bytes passed, tokens go below zero if streams raced for them
+    void consume(size_t bytes);
+
+    /// Time until `bytes` tokens accumulate
+    Clock::duration delay(size_t bytes);
+
+   private:
+    void refill(Clock::time_point now);
+
+    const double rate_;
+    const double burst_;
+    std::mutex mutex_;
+    double tokens_;
+    Clock::time_point updated_;
+  };
+
+  /**
+   * Buckets limiting one direction of one stream.
+   * Default constructed limiter has no limits
+   */
+  class BandwidthLimiter {
+   public:
+    BandwidthLimiter() = default;
+
+    BandwidthLimiter(BandwidthDirection direction,
+                     std::vector<std::shared_ptr<TokenBucket>> buckets);
+
+    bool limited() const {
+      return not buckets_.empty();
+    }
+
+    /// Bytes which may pass now through all buckets, up to `bytes`
+    size_t available(size_t bytes) const;
+
+    void consume(size_t bytes);
+
+    /// Time to wait for `bytes` to pass, counted as stream throttling
+    std::chrono::milliseconds throttle(size_t bytes) const;
+
+   private:
+    BandwidthDirection direction_ = BandwidthDirection::UPLOAD;
+    std::vector<std::shared_ptr<TokenBucket>> buckets_;
+  };
+
+  /// Process-wide, per peer and per protocol buckets of muxed streams
+  class BandwidthManager {
+   public:
+    explicit BandwidthManager(BandwidthLimits limits);
+
+    /// Limiter of stream to the peer, protocol is empty until negotiated
+    BandwidthLimiter limiter(BandwidthDirection direction,
+                             const peer::PeerId &peer,
+                             const peer::ProtocolName &protocol);
+
+   private:
+    struct Buckets {
+      std::shared_ptr<TokenBucket> total;
+      std::unordered_map<peer::ProtocolName, std::shared_ptr<TokenBucket>>
+          protocols;
+      std::unordered_map<peer::PeerId, std::weak_ptr<TokenBucket>> peers;
+    };
+
+    const BandwidthLimits::Direction &limits(
+        BandwidthDirection direction) const;
+
+    const BandwidthLimits limits_;
+    std::mutex mutex_;
+    Buckets upload_;
+    Buckets download_;
+  };
+
+}  // namespace libp2p::muxer
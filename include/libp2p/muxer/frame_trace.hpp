@@ -0,0 +1,136 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <libp2p/common/types.hpp>
+#include <libp2p/outcome/outcome.hpp>
+
+namespace libp2p::muxer {
+
+  /// Header of one muxer frame, payload is never recorded
+  struct TracedFrame {
+    /// Since the connection was created
+    std::chrono::microseconds time{};
+
+    /// Yamux stream id, or mplex stream number
+    uint64_t stream_id = 0;
+
+    /// Payload length, or yamux window delta and ping value
+    uint64_t length = 0;
+
+    /// Yamux frame type, zero for mplex
+    uint8_t type = 0;
+
+    /// Yamux flags, or mplex flag
+    uint16_t flags = 0;
+
+    /// Received from peer, otherwise sent
+    bool inbound = false;
+
+    bool operator==(const TracedFrame &) const = default;
+  };
+
+  /**
+   * Frames of one muxed connection, in order of their reading and writing.
+   * Encoded compactly, times and sizes as varints, so that traces of long
+   * connections are small
+   */
+  struct FrameTrace {
+    enum class Error {
+      INVALID_TRACE = 1,
+    };
+
+    /// Muxer protocol, e.g. "/yamux/1.0.0"
+    std::string muxer;
+
+    /// Whether this side dialed the connection
+    bool initiator = false;
+
+    /// Frames were dropped after kMaxFrames
+    bool truncated = false;
+
+    std::vector<TracedFrame> frames;
+
+    Bytes encode() const;
+
+    static outcome::result<FrameTrace> decode(BytesIn bytes);
+  };
+
+  /**
+   * Receives traces of connections, when they are destroyed.
+   * There is none by default, muxers cost a null check per frame then.
+   * Called from io context threads, has to be thread-safe
+   */
+  class FrameTraceSink {
+   public:
+    virtual ~FrameTraceSink() = default;
+
+    virtual void onTrace(FrameTrace trace) = 0;
+  };
+
+  /**
+   * Installs trace sink, nullptr removes it.
+   * Only connections created after the call are traced
+   */
+  void setFrameTraceSink(std::shared_ptr<FrameTraceSink> sink);
+
+  /**
+   * Trace of one connection, owned by muxer.
+   * Empty if there was no sink when it was created
+   */
+  class FrameRecorder {
+   public:
+    /// Frames of larger traces are dropped
+    static constexpr size_t kMaxFrames = size_t{1} << 20;
+
+    FrameRecorder(std::string_view muxer, bool initiator);
+
+    FrameRecorder(const FrameRecorder &) = delete;
+    FrameRecorder &operator=(const FrameRecorder &) = delete;
+
+    /// Passes trace to sink
+    ~FrameRecorder();
+
+    explicit operator bool() const {
+      return sink_ != nullptr;
+    }
+
+    void record(bool inbound,
+                uint8_t type,
+                uint16_t flags,
+                uint64_t stream_id,
+                uint64_t length);
+
+   private:
+    std::shared_ptr<FrameTraceSink> sink_;
+    FrameTrace trace_;
+    std::chrono::steady_clock::time_point start_;
+  };
+
+  /// Writes each trace to new file "<n>.trace" in directory
+  class FrameTraceFiles : public FrameTraceSink {
+   public:
+    explicit FrameTraceFiles(std::filesystem::path dir);
+
+    void onTrace(FrameTrace trace) override;
+
+   private:
+    std::filesystem::path dir_;
+    std::atomic_size_t next_ = 0;
+  };
+
+}  // namespace libp2p::muxer
+
+OUTCOME_HPP_DECLARE_ERROR(libp2p::muxer, FrameTrace::Error);
@@ -0,0 +1,115 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include <libp2p/peer/peer_id.hpp>
+
+namespace libp2p::muxer {
+
+  /**
+   * Memory muxers may pin for buffered stream data: received but not yet
+   * consumed, and queued but not yet written
+   */
+  struct MemoryLimits {
+    static constexpr size_t kDefaultConnectionLimit = 512 * 1024 * 1024;
+    size_t connection = kDefaultConnectionLimit;
+
+    static constexpr size_t kDefaultPeerLimit = 1024 * 1024 * 1024;
+    size_t peer = kDefaultPeerLimit;
+
+    static constexpr size_t kDefaultProcessLimit = 4ull * 1024 * 1024 * 1024;
+    size_t process = kDefaultProcessLimit;
+  };
+
+  /**
+   * Memory accounting node. Reservation succeeds only if it fits both into
+   * this scope and into all its parents
+   */
+  class MemoryScope {
+   public:
+    MemoryScope(size_t limit, std::shared_ptr<MemoryScope> parent);
+
+    MemoryScope(const MemoryScope &) = delete;
+    MemoryScope &operator=(const MemoryScope &) = delete;
+
+    /// Returns false and reserves nothing if limit would be exceeded
+    bool reserve(size_t bytes);
+
+    void release(size_t bytes);
+
+    size_t used() const;
+
+    size_t limit() const {
+      return limit_;
+    }
+
+    /// More than 3/4 of this scope or of its parent is used
+    bool underPressure() const;
+
+   private:
+    const size_t limit_;
+    const std::shared_ptr<MemoryScope> parent_;
+    std::atomic<size_t> used_{0};
+  };
+
+  /**
+   * Bytes reserved in scope by one owner, released on destruction.
+   * Null scope means no limits
+   */
+  class MemoryReservation {
+   public:
+    explicit MemoryReservation(std::shared_ptr<MemoryScope> scope = nullptr);
+
+    MemoryReservation(const MemoryReservation &) = delete;
+    MemoryReservation &operator=(const MemoryReservation &) = delete;
+
+    ~MemoryReservation();
+
+    bool reserve(size_t bytes);
+
+    void release(size_t bytes);
+
+    void releaseAll();
+
+    size_t size() const {
+      return size_;
+    }
+
+    bool underPressure() const;
+
+   private:
+    std::shared_ptr<MemoryScope> scope_;
+    size_t size_ = 0;
+  };
+
+  /// Process-wide, per peer and per connection memory scopes of muxers
+  class MemoryManager {
+   public:
+    explicit MemoryManager(MemoryLimits limits);
+
+    /// New scope for connection to the peer, shares peer scope with other
+    /// connections to the same peer
+    std::shared_ptr<MemoryScope> connectionScope(const peer::PeerId &peer);
+
+    const MemoryScope &processScope() const {
+      return *process_;
+    }
+
+   private:
+    const MemoryLimits limits_;
+    const std::shared_ptr<MemoryScope> process_;
+    std::mutex mutex_;
+    std::unordered_map<peer::PeerId, std::weak_ptr<MemoryScope>> peers_;
+  };
+
+}  // namespace libp2p::muxer
@@ -6,13 +6,23 @@
 
 #pragma once
 
+#include <libp2p/muxer/memory_budget.hpp>
 #include <libp2p/muxer/muxed_connection_config.hpp>
 #include <libp2p/muxer/muxer_adaptor.hpp>
+#include <libp2p/muxer/stream_limits.hpp>
 
 namespace libp2p::muxer {
   class Mplex : public MuxerAdaptor {
    public:
-    explicit Mplex(MuxedConnectionConfig config);
+    /**
+     * @param config of muxers to be created over the connections
+     * @param memory budget of connections, nullptr means no limit
+     * @param streams limits of streams, nullptr means only maximum streams
+     * of config
+     */
+    explicit Mplex(MuxedConnectionConfig config,
+                   std::shared_ptr<MemoryManager> memory = nullptr,
+                   std::shared_ptr<StreamManager> streams = nullptr);
 
     peer::ProtocolName getProtocolId() const override;
 
@@ -21,5 +31,7 @@ namespace libp2p::muxer {
 
    private:
     MuxedConnectionConfig config_;
+    std::shared_ptr<MemoryManager> memory_;
+    std::shared_ptr<StreamManager> streams_;
   };
 }  // namespace libp2p::muxer
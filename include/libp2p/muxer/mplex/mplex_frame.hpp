@@ -6,6 +6,8 @@
 
 #pragma once
 
+#include <optional>
+
 #include <libp2p/muxer/mplex/mplex_stream.hpp>
 
 namespace libp2p::connection {
@@ -45,19 +47,58 @@ namespace libp2p::connection {
                          Bytes data = {});
 
   /**
-   * Create an MplexFrame
-   * @param id_flag - stream_id and flag, joined in a specific way, came from
-   * the network
-   * @param data to be in this frame
-   * @return created frame or error
+   * Parses mplex frames from data read into its buffer, so that one read
+   * from the connection yields as many frames as it contains.
+   * Payloads of parsed frames refer to the buffer
    */
-  outcome::result<MplexFrame> createFrame(uint64_t id_flag, Bytes data);
+  class MplexFrameDecoder {
+   public:
+    /// Frame parsed from the buffer
+    struct Frame {
+      MplexFrame::Flag flag;
+      MplexStream::StreamNumber stream_number;
 
-  /**
-   * Read and parse MplexFrame bytes
-   * @param reader, from which to read the bytes
-   * @param cb, which is called, when bytes are and parsed, or error happens
-   */
-  void readFrame(std::shared_ptr<basic::ReadWriter> reader,
-                 std::function<void(outcome::result<MplexFrame>)> cb);
+      /// Valid until next call of buffer()
+      BytesIn data;
+    };
+
+    /// Size of buffer, which grows to fit a larger frame
+    static constexpr size_t kBufferSize = 64 * 1024;
+
+    /**
+     * @param max_data_size - frames with larger data are protocol errors
+     */
+    explicit MplexFrameDecoder(size_t max_data_size);
+
+    /**
+     * Space to read the next bytes into; moves unparsed bytes to the
+     * beginning of the buffer, invalidates data of parsed frames
+     */
+    BytesOut buffer();
+
+    /// Accounts bytes read into buffer()
+    void onRead(size_t bytes);
+
+    /**
+     * Parses the next frame from bytes read
+     * @return frame, none if no complete frame left or error
+     */
+    outcome::result<std::optional<Frame>> next();
+
+    /// Bytes of buffer allocated
+    size_t capacity() const {
+      return buffer_.capacity();
+    }
+
+   private:
+    size_t max_data_size_;
+    Bytes buffer_;
+
+    /// Unparsed bytes are [begin_, end_) of buffer_
+    size_t begin_ = 0;
+    size_t end_ = 0;
+
+    /// Size of incomplete frame at begin_, if known
+    size_t incomplete_ = 0;
+  };
 }  // namespace libp2p::connection
@@ -11,8 +11,13 @@
 
 #include <boost/asio/streambuf.hpp>
 #include <boost/noncopyable.hpp>
+#include <libp2p/common/metrics/memory_usage.hpp>
+#include <libp2p/common/metrics/traffic.hpp>
 #include <libp2p/connection/stream.hpp>
 #include <libp2p/log/logger.hpp>
+#include <libp2p/muxer/memory_budget.hpp>
+#include <libp2p/muxer/muxed_connection_config.hpp>
+#include <libp2p/muxer/stream_limits.hpp>
 
 namespace libp2p::connection {
   class MplexedConnection;
@@ -21,6 +26,7 @@ namespace libp2p::connection {
    * Stream implementation, used by Mplex multiplexer
    */
   class MplexStream : public Stream,
+                      public metrics::MemoryReporter,
                       public std::enable_shared_from_this<MplexStream>,
                       private boost::noncopyable {
    public:
@@ -44,9 +50,17 @@ namespace libp2p::connection {
      * Create an instance of Mplex stream
      * @param connection, over which this stream is opened
      * @param stream_id of this stream
+     * @param memory budget for buffered data, nullptr means no limit
+     * @param write_queue_limit - how much bytes can be queued while the stream
+     * is writing
+     * @param permit counts the stream in stream limits
      */
     MplexStream(std::weak_ptr<MplexedConnection> connection,
-                StreamId stream_id);
+                StreamId stream_id,
+                std::shared_ptr<muxer::MemoryScope> memory = nullptr,
+                size_t write_queue_limit =
+                    muxer::MuxedConnectionConfig::kDefaultMaxStreamWriteQueueSize,
+                muxer::StreamPermit permit = {});
 
     ~MplexStream() override = default;
 
@@ -81,6 +95,14 @@ namespace libp2p::connection {
 
     outcome::result<multi::Multiaddress> remoteMultiaddr() const override;
 
+    void attributeTraffic(const peer::ProtocolName &protocol) override;
+
+    bool admitProtocol(const peer::ProtocolName &protocol) override;
+
+    metrics::MemoryUsage memoryUsage() const override;
+
+    metrics::TrafficKey memoryKey() const override;
+
    private:
     struct Reading {
       BytesOut out;
@@ -106,6 +128,9 @@ namespace libp2p::connection {
 
     mutable std::mutex write_queue_mutex_;
 
+    /// Writes exceeding this size of the queue fail
+    size_t write_queue_limit_;
+
     /// is the stream opened for reads?
     bool is_readable_ = true;
 
@@ -116,10 +141,22 @@ namespace libp2p::connection {
     /// was the stream reset?
     bool is_reset_ = false;
 
+    /// Payload bytes, data frames and completed reads and writes
+    metrics::TrafficMeter meter_{metrics::TrafficLayer::MUXED};
+
     /// how much unread data can be in this stream at one time; if new data
     /// exceeding this value is received, the stream is reset
     uint32_t receive_window_size_ = 256 * 1024;  // 256 MB
 
+    /// Connection memory budget reserved for unread data
+    muxer::MemoryReservation read_memory_;
+
+    /// Connection memory budget reserved for queued writes
+    muxer::MemoryReservation write_memory_;
+
+    /// Stream counted in stream limits, released on reset or removal
+    muxer::StreamPermit permit_;
+
     /// MplexedConnection API starts here
     friend class MplexedConnection;
 
@@ -6,29 +6,37 @@
 
 #pragma once
 
-#include <queue>
+#include <deque>
 #include <unordered_map>
 #include <utility>
 
+#include <libp2p/common/metrics/memory_usage.hpp>
+#include <libp2p/common/metrics/traffic.hpp>
 #include <libp2p/connection/capable_connection.hpp>
 #include <libp2p/log/logger.hpp>
+#include <libp2p/muxer/frame_trace.hpp>
+#include <libp2p/muxer/mplex/mplex_frame.hpp>
 #include <libp2p/muxer/mplex/mplex_stream.hpp>
 #include <libp2p/muxer/muxed_connection_config.hpp>
 
 namespace libp2p::connection {
-  struct MplexFrame;
-
   class MplexedConnection
       : public CapableConnection,
+        public metrics::MemoryReporter,
         public std::enable_shared_from_this<MplexedConnection> {
    public:
     /**
      * Create a new instance of MplexedConnection
      * @param connection to be multiplexed
      * @param config of the multiplexer
+     * @param memory budget of stream buffers, nullptr means no limit
+     * @param streams limits of streams with the peer, nullptr means only
+     * maximum streams of config
      */
     MplexedConnection(std::shared_ptr<SecureConnection> connection,
-                      muxer::MuxedConnectionConfig config);
+                      muxer::MuxedConnectionConfig config,
+                      std::shared_ptr<muxer::MemoryScope> memory = nullptr,
+                      std::shared_ptr<muxer::StreamScope> streams = nullptr);
 
     MplexedConnection(const MplexedConnection &other) = delete;
     MplexedConnection &operator=(const MplexedConnection &other) = delete;
@@ -72,61 +80,155 @@ namespace libp2p::connection {
                            ReadCallbackFunc cb) override;
     void deferWriteCallback(std::error_code ec, WriteCallbackFunc cb) override;
 
+    metrics::MemoryUsage memoryUsage() const override;
+
+    metrics::TrafficKey memoryKey() const override;
+
    private:
+    using Frame = MplexFrameDecoder::Frame;
+
     struct WriteData {
       Bytes data;
       WriteCallbackFunc cb;
+
+      /// Payload bytes of stream data frame, counted in the queued size
+      size_t stream_bytes = 0;
     };
-    std::queue<WriteData> write_queue_;
+    std::deque<WriteData> write_queue_;
     bool is_writing_ = false;
 
+    /// Frames being written by one vectored write operation
+    struct WriteBatch {
+      /// Buffers not yet written
+      std::span<const BytesIn> unwritten() const;
+
+      /// Advances unwritten buffers, returns false if bytes exceed them
+      bool advance(size_t bytes);
+
+      std::vector<WriteData> items;
+
+      /// Data of items, in order
+      std::vector<BytesIn> buffers;
+
+      /// Index of the 1st unwritten buffer
+      size_t unwritten_index = 0;
+
+      /// Bytes written so far
+      size_t written = 0;
+    };
+    WriteBatch writing_;
+
+    /// Stream write waiting for the queue to drain, empty data means close
+    /// frame
+    struct BlockedWrite {
+      MplexStream::StreamId stream_id;
+      BytesIn data;
+      WriteCallbackFunc cb;
+    };
+    std::deque<BlockedWrite> blocked_writes_;
+
+    /// Payload bytes of stream data queued or being written
+    size_t queued_stream_bytes_ = 0;
+
+    /// Max frames coalesced into one write, keeps iovec count in asio limits
+    static constexpr size_t kMaxFramesPerWrite = 32;
+
+    /// Max message size allowed by mplex spec, larger writes are partial
+    static constexpr size_t kMaxMessageSize = 1024 * 1024;
+
     /**
      * Write (\param data) to the connection
      */
     void write(WriteData data);
 
+    /// Records header of frame to be written
+    void recordWritten(BytesIn frame);
+
+    /// Counts new stream in stream limits, none if they are exceeded
+    std::optional<muxer::StreamPermit> admitStream(
+        muxer::StreamDirection direction);
+
     /**
-     * Write next message from the queue
+     * Write next frames from the queue
      */
     void doWrite();
 
+    /**
+     * Write the rest of the current batch
+     */
+    void continueWriting();
+
     /**
      * Called, when write is complete
      */
     void onWriteCompleted(outcome::result<size_t> write_res);
 
     /**
-     * Read next frame from the connection
+     * Whether stream data of (\param bytes) fits into the queue
+     */
+    bool writeQueueFits(size_t bytes) const;
+
+    /**
+     * Queue stream data frame
+     */
+    void writeStreamData(MplexStream::StreamId stream_id,
+                         BytesIn data,
+                         WriteCallbackFunc cb);
+
+    /**
+     * Queue stream close frame
+     */
+    void writeStreamClose(MplexStream::StreamId stream_id,
+                          WriteCallbackFunc cb);
+
+    /**
+     * Queue blocked writes, which fit into the queue now
+     */
+    void unblockWrites();
+
+    /**
+     * Fail blocked writes of the stream or of all streams if nothing passed
+     */
+    void failBlockedWrites(
+        boost::optional<MplexStream::StreamId> stream_id = boost::none);
+
+    /**
+     * Read next bytes from the connection
      */
     void readNextFrame();
 
+    /**
+     * Process frames read into the decoder
+     */
+    void onRead(outcome::result<size_t> res);
+
     /**
      * Process a received (\param frame)
      */
-    void processFrame(const MplexFrame &frame);
+    void processFrame(const Frame &frame);
 
     /**
      * Process a new stream (\package frame)
      */
-    void processNewStreamFrame(const MplexFrame &frame,
+    void processNewStreamFrame(const Frame &frame,
                                MplexStream::StreamId stream_id);
 
     /**
      * Process a message stream (\package frame)
      */
-    void processMessageFrame(const MplexFrame &frame,
+    void processMessageFrame(const Frame &frame,
                              MplexStream::StreamId stream_id);
 
     /**
      * Process a close stream (\package frame)
      */
-    void processCloseFrame(const MplexFrame &frame,
+    void processCloseFrame(const Frame &frame,
                            MplexStream::StreamId stream_id);
 
     /**
      * Process a reset stream (\package frame)
      */
-    void processResetFrame(const MplexFrame &frame,
+    void processResetFrame(const Frame &frame,
                            MplexStream::StreamId stream_id);
 
     /**
@@ -159,21 +261,36 @@ namespace libp2p::connection {
 
     std::shared_ptr<SecureConnection> connection_;
     muxer::MuxedConnectionConfig config_;
+    std::shared_ptr<muxer::MemoryScope> memory_;
+    std::shared_ptr<muxer::StreamScope> stream_limits_;
+
+    /// Frames read from the connection
+    MplexFrameDecoder decoder_{kMaxMessageSize};
 
     std::unordered_map<MplexStream::StreamId, std::shared_ptr<MplexStream>>
         streams_;
+    /// Stream limits counts of outbound streams, whose frame is being written
+    std::unordered_map<MplexStream::StreamId, muxer::StreamPermit>
+        pending_permits_;
     MplexStream::StreamNumber last_issued_stream_number_ = 1;
     NewStreamHandlerFunc new_stream_handler_;
 
     bool is_active_ = false;
     log::Logger log_ = log::createLogger("MplexConn");
 
+    /// Plaintext bytes and mplex frames
+    metrics::TrafficMeter meter_{metrics::TrafficLayer::SECURE};
+
+    /// Frame headers, if capture is enabled
+    muxer::FrameRecorder recorder_;
+
     /// MPLEX STREAM API
     friend class MplexStream;
 
     /**
      * Write bytes to the connection; before calling this method, the stream
-     * must ensure that no write operations are currently running
+     * must ensure that no write operations are currently running. Waits while
+     * the connection write queue is full, writes at most kMaxMessageSize
      * @param stream_id, for which the bytes are to be written
      * @param in - bytes to be written
      * @param bytes - number of bytes to be written
@@ -19,10 +19,34 @@ namespace libp2p::muxer {
     static constexpr size_t kDefaultMaxWindowSize = 64 * 1024 * 1024;
     size_t maximum_window_size = kDefaultMaxWindowSize;
 
+    /// Receive windows start at the initial yamux window and grow up to
+    /// maximum_window_size while reader consumes whole window within a couple
+    /// of round trips. Each connection measures round trip with an extra
+    /// ping, so it is disabled by default
+    bool window_auto_tuning = false;
+
+    /// How much all streams of connection can grow their receive windows in
+    /// total, windows of slow readers shrink when exhausted
+    static constexpr size_t kDefaultMaxConnectionWindowGrowth =
+        256 * 1024 * 1024;
+    size_t maximum_connection_window_growth = kDefaultMaxConnectionWindowGrowth;
+
     /// how much streams can be supported by Yamux at one time
     static constexpr size_t kDefaultMaxStreamsNumber = 1000;
     size_t maximum_streams = kDefaultMaxStreamsNumber;
 
+    /// Bytes a stream may queue while its previous write is in progress,
+    /// writes beyond it fail (mplex)
+    static constexpr size_t kDefaultMaxStreamWriteQueueSize = 4 * 1024 * 1024;
+    size_t maximum_stream_write_queue_size = kDefaultMaxStreamWriteQueueSize;
+
+    /// Bytes of stream data a connection may queue for writing, stream writes
+    /// beyond it wait until the queue drains (mplex)
+    static constexpr size_t kDefaultMaxConnectionWriteQueueSize =
+        16 * 1024 * 1024;
+    size_t maximum_connection_write_queue_size =
+        kDefaultMaxConnectionWriteQueueSize;
+
     /// Ping interval for muxers with internal ping feature
     static constexpr std::chrono::milliseconds kDefaultPingInterval =
         std::chrono::milliseconds(5000);
@@ -36,5 +60,11 @@ namespace libp2p::muxer {
     /// Dial timeout for outgoing connection
     static constexpr std::chrono::seconds kDefaultDialTimeout{10};
     std::chrono::milliseconds dial_timeout = kDefaultDialTimeout;
+
+    /// Stream data is read from the wire directly into client's buffer
+    /// (bypassing muxer buffers) if at least this number of bytes is expected,
+    /// zero disables direct reads
+    static constexpr size_t kDefaultMinDirectReadSize = 16 * 1024;
+    size_t min_direct_read_size = kDefaultMinDirectReadSize;
   };
 }  // namespace libp2p::muxer
@@ -0,0 +1,158 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+
+#include <libp2p/peer/peer_id.hpp>
+#include <libp2p/peer/protocol.hpp>
+
+namespace libp2p::muxer {
+
+  enum class StreamDirection : uint8_t { INBOUND, OUTBOUND };
+
+  /// Maximal number of open streams, zero means no limit
+  struct StreamCountLimit {
+    size_t inbound = 0;
+    size_t outbound = 0;
+  };
+
+  /**
+   * Stream limits of muxers, checked before stream is created, and before
+   * handler is called for protocol limits.
+   * Default limits are not set, muxers still have maximum streams per
+   * connection in MuxedConnectionConfig
+   */
+  struct StreamLimits {
+    /// Streams of all peers
+    StreamCountLimit process;
+
+    /// Streams of each peer, over all connections to it
+    StreamCountLimit peer;
+
+    struct Protocol {
+      /// Streams of the protocol with all peers
+      StreamCountLimit process;
+
+      /// Streams of the protocol with each peer
+      StreamCountLimit peer;
+    };
+    std::unordered_map<peer::ProtocolName, Protocol> protocols;
+  };
+
+  class StreamScope;
+
+  /**
+   * Stream counted in scope and its parents, uncounted on destruction.
+   * Default constructed permit is not limited
+   */
+  class StreamPermit {
+   public:
+    StreamPermit() = default;
+
+    StreamPermit(StreamPermit &&other) noexcept;
+    StreamPermit &operator=(StreamPermit &&other) noexcept;
+
+    StreamPermit(const StreamPermit &) = delete;
+    StreamPermit &operator=(const StreamPermit &) = delete;
+
+    ~StreamPermit();
+
+    /**
+     * Counts stream in limits of negotiated protocol
+     * @return false if protocol limit is exceeded, stream is to be reset
+     */
+    bool admitProtocol(const peer::ProtocolName &protocol);
+
+   private:
+    friend class StreamScope;
+
+    StreamPermit(std::shared_ptr<StreamScope> scope,
+                 StreamDirection direction);
+
+    void release();
+
+    std::shared_ptr<StreamScope> scope_;
+    StreamDirection direction_ = StreamDirection::INBOUND;
+    std::optional<peer::ProtocolName> protocol_;
+  };
+
+  /**
+   * Stream counting node. Stream is admitted only if it fits both into this
+   * scope and into all its parents
+   */
+  class StreamScope : public std::enable_shared_from_this<StreamScope> {
+   public:
+    StreamScope(StreamCountLimit limit,
+                const std::unordered_map<peer::ProtocolName, StreamCountLimit>
+                    &protocols,
+                std::shared_ptr<StreamScope> parent);
+
+    StreamScope(const StreamScope &) = delete;
+    StreamScope &operator=(const StreamScope &) = delete;
+
+    /// Returns none and counts nothing if limit would be exceeded
+    std::optional<StreamPermit> admit(StreamDirection direction);
+
+    size_t count(StreamDirection direction) const;
+
+    /// Streams of protocol, only protocols with limits are counted
+    size_t count(StreamDirection direction,
+                 const peer::ProtocolName &protocol) const;
+
+   private:
+    friend class StreamPermit;
+
+    struct Counter {
+      explicit Counter(StreamCountLimit limit) : limit{limit} {}
+
+      bool add(StreamDirection direction);
+      void remove(StreamDirection direction);
+
+      const StreamCountLimit limit;
+      std::array<std::atomic<size_t>, 2> count{};
+    };
+
+    /// Counts in total or protocol counter, null protocol means total
+    bool add(StreamDirection direction, const peer::ProtocolName *protocol);
+    void remove(StreamDirection direction, const peer::ProtocolName *protocol);
+
+    Counter *counter(const peer::ProtocolName *protocol);
+
+    Counter total_;
+    /// Not modified after construction, so no lock is needed
+    std::unordered_map<peer::ProtocolName, Counter> protocols_;
+    const std::shared_ptr<StreamScope> parent_;
+  };
+
+  /// Process-wide and per peer stream scopes of muxers
+  class StreamManager {
+   public:
+    explicit StreamManager(StreamLimits limits);
+
+    /// Scope of streams with the peer, shared by all connections to it
+    std::shared_ptr<StreamScope> peerScope(const peer::PeerId &peer);
+
+    const StreamScope &processScope() const {
+      return *process_;
+    }
+
+   private:
+    std::unordered_map<peer::ProtocolName, StreamCountLimit> peer_protocols_;
+    const std::shared_ptr<StreamScope> process_;
+    const StreamCountLimit peer_limit_;
+    std::mutex mutex_;
+    std::unordered_map<peer::PeerId, std::weak_ptr<StreamScope>> peers_;
+  };
+
+}  // namespace libp2p::muxer
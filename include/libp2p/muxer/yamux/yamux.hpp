@@ -7,8 +7,12 @@
 #pragma once
 
 #include <libp2p/basic/scheduler.hpp>
+#include <libp2p/connection/connection_health.hpp>
+#include <libp2p/muxer/bandwidth_limiter.hpp>
+#include <libp2p/muxer/memory_budget.hpp>
 #include <libp2p/muxer/muxed_connection_config.hpp>
 #include <libp2p/muxer/muxer_adaptor.hpp>
+#include <libp2p/muxer/stream_limits.hpp>
 #include <libp2p/network/connection_manager.hpp>
 
 namespace libp2p::muxer {
@@ -22,10 +26,20 @@ namespace libp2p::muxer {
      * @param scheduler scheduler
      * @param cmgr connection manager. May be nullptr in tests, otherwise
      * close_cb_ is created using it
+     * @param memory budget of connections, nullptr means no limit
+     * @param bandwidth limits of streams, nullptr means no limit
+     * @param health shared keepalive of connections, nullptr means timers
+     * of each connection
+     * @param streams limits of streams, nullptr means only maximum streams
+     * of config
      */
     Yamux(MuxedConnectionConfig config,
           std::shared_ptr<basic::Scheduler> scheduler,
-          std::shared_ptr<network::ConnectionManager> cmgr);
+          std::shared_ptr<network::ConnectionManager> cmgr,
+          std::shared_ptr<MemoryManager> memory = nullptr,
+          std::shared_ptr<BandwidthManager> bandwidth = nullptr,
+          std::shared_ptr<connection::ConnectionHealth> health = nullptr,
+          std::shared_ptr<StreamManager> streams = nullptr);
 
     peer::ProtocolName getProtocolId() const override;
 
@@ -35,6 +49,10 @@ namespace libp2p::muxer {
    private:
     MuxedConnectionConfig config_;
     std::shared_ptr<basic::Scheduler> scheduler_;
+    std::shared_ptr<MemoryManager> memory_;
+    std::shared_ptr<BandwidthManager> bandwidth_;
+    std::shared_ptr<connection::ConnectionHealth> health_;
+    std::shared_ptr<StreamManager> streams_;
     connection::CapableConnection::ConnectionClosedCallback close_cb_;
   };
 }  // namespace libp2p::muxer
@@ -74,6 +74,12 @@ namespace libp2p::connection {
    */
   Bytes newStreamMsg(YamuxFrame::StreamId stream_id);
 
+  /**
+   * Set SYN flag in serialized frame, so that the frame opens its stream
+   * @param frame bytes of the frame header
+   */
+  void setSynFlag(Bytes &frame);
+
   /**
    * Create a message, which acknowledges a new stream creation
    * @param stream_id to be put into the message
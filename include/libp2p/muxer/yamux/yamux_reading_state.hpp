@@ -31,6 +31,16 @@ namespace libp2p::connection {
     /// NOTE: cuts bytes from the head of bytes_read
     void onDataReceived(BytesOut &bytes_read);
 
+    /// Returns id of stream whose data is expected next from the wire
+    /// (zero if none or is being discarded) and number of bytes expected
+    std::pair<StreamId, size_t> expectedData() const;
+
+    /// Accounts bytes of current data message, which were read from the wire
+    /// directly into stream's buffer, bypassing onDataReceived().
+    /// Returns RST and FIN flags to be processed if the message is complete,
+    /// none if the message was discarded while being read
+    std::pair<bool, bool> onDataReadDirectly(size_t bytes);
+
     /// Discards data for current message being read.
     /// Reentrant function, called from callbacks
     void discardDataMessage();
@@ -6,12 +6,19 @@
 
 #pragma once
 
+#include <chrono>
 #include <optional>
 
 #include <libp2p/basic/read_buffer.hpp>
+#include <libp2p/basic/scheduler.hpp>
 #include <libp2p/basic/write_queue.hpp>
 #include <libp2p/common/metrics/instance_count.hpp>
+#include <libp2p/common/metrics/memory_usage.hpp>
+#include <libp2p/common/metrics/traffic.hpp>
 #include <libp2p/connection/stream.hpp>
+#include <libp2p/muxer/bandwidth_limiter.hpp>
+#include <libp2p/muxer/memory_budget.hpp>
+#include <libp2p/muxer/stream_limits.hpp>
 
 namespace libp2p::connection {
 
@@ -22,24 +29,52 @@ namespace libp2p::connection {
    public:
     virtual ~YamuxStreamFeedback() = default;
 
-    /// Stream transfers data to connection
-    virtual void writeStreamData(uint32_t stream_id, BytesIn data) = 0;
+    /// Stream transfers data chunks to connection, they are sent contiguously.
+    /// Data is not copied and must stay valid until acknowledged via
+    /// onDataWritten() or until the callback passed to
+    /// deferUntilDataReleased() is called
+    virtual void writeStreamData(uint32_t stream_id,
+                                 std::span<const BytesIn> data) = 0;
 
     /// Stream acknowledges received bytes
     virtual void ackReceivedBytes(uint32_t stream_id, uint32_t bytes) = 0;
 
+    /// Smoothed ping round trip time, zero until measured
+    virtual std::chrono::microseconds rtt() const = 0;
+
+    /// Stream asks to grow its receive window, returns bytes granted within
+    /// connection-wide limit
+    virtual size_t growReceiveWindow(size_t bytes) = 0;
+
+    /// Stream returns receive window growth granted before
+    virtual void shrinkReceiveWindow(size_t bytes) = 0;
+
+    /// True if connection-wide limit of receive window growth is exhausted
+    virtual bool receiveWindowPressure() const = 0;
+
     /// Stream defers callback to avoid reentrancy
     virtual void deferCall(std::function<void()>) = 0;
 
+    /// Stream waits, e.g. for bandwidth, callback is called after delay
+    /// unless handle is released
+    virtual basic::Scheduler::Handle scheduleCall(
+        std::function<void()> cb, std::chrono::milliseconds delay) = 0;
+
     /// Stream closes
     virtual void resetStream(uint32_t stream_id) = 0;
 
     /// Stream closed, remove from active streams if 2FINs were sent
     virtual void streamClosed(uint32_t stream_id) = 0;
+
+    /// Stream drops its unacknowledged data, cb is called (maybe
+    /// immediately) when connection no longer refers to that data
+    virtual void deferUntilDataReleased(uint32_t stream_id,
+                                        std::function<void()> cb) = 0;
   };
 
   /// Stream implementation, used by Yamux multiplexer
   class YamuxStream final : public Stream,
+                            public metrics::MemoryReporter,
                             public std::enable_shared_from_this<YamuxStream> {
    public:
     YamuxStream(const YamuxStream &other) = delete;
@@ -52,7 +87,11 @@ namespace libp2p::connection {
                 YamuxStreamFeedback &feedback,
                 uint32_t stream_id,
                 size_t maximum_window_size,
-                size_t write_queue_limit);
+                size_t write_queue_limit,
+                bool window_auto_tuning = false,
+                std::shared_ptr<muxer::MemoryScope> memory = nullptr,
+                std::shared_ptr<muxer::BandwidthManager> bandwidth = nullptr,
+                muxer::StreamPermit permit = {});
 
     void read(BytesOut out, size_t bytes, ReadCallbackFunc cb) override;
 
@@ -85,6 +124,25 @@ namespace libp2p::connection {
 
     outcome::result<multi::Multiaddress> remoteMultiaddr() const override;
 
+    void attributeTraffic(const peer::ProtocolName &protocol) override;
+
+    bool admitProtocol(const peer::ProtocolName &protocol) override;
+
+    void setWriteWeight(uint8_t weight) override;
+
+    metrics::MemoryUsage memoryUsage() const override;
+
+    metrics::TrafficKey memoryKey() const override;
+
+    uint8_t writeWeight() const {
+      return write_weight_;
+    }
+
+    /// Bytes queued by writes and not sent yet
+    size_t unsentBytes() const {
+      return write_queue_.unsentBytes();
+    }
+
     /// Increases send window. Called from Connection
     void increaseSendWindow(size_t delta);
 
@@ -98,6 +156,26 @@ namespace libp2p::connection {
     /// Returns kRemoveStreamAndSendRst on window overflow
     DataFromConnectionResult onDataReceived(BytesOut bytes);
 
+    /// Returns client's read buffer if data may be read from the wire directly
+    /// into it, empty span otherwise. Called from Connection
+    BytesOut directReadBuffer() const;
+
+    /// Connection started reading data into directReadBuffer(), the buffer
+    /// must not be released until onDirectReadCompleted()
+    void onDirectReadStarted();
+
+    /// Connection completed reading data into directReadBuffer()
+    void onDirectReadCompleted(outcome::result<size_t> res);
+
+    /// Receive window advertised to peer, it must not send more unacknowledged
+    /// data
+    size_t receiveWindow() const {
+      return peers_window_size_;
+    }
+
+    /// Called from Connection, peer sends more data than receive window
+    void onReceiveOverflow();
+
     /// Called from Connection on FIN received
     /// Returns kRemoveStream if FIN was sent from this side
     DataFromConnectionResult onFINReceived();
@@ -105,16 +183,36 @@ namespace libp2p::connection {
     /// Called from Connection, stream was reset by peer
     void onRSTReceived();
 
-    /// Data written into the wire. Called from Connection
+    /// Data written into the wire, may span several writes. Called from
+    /// Connection
     void onDataWritten(size_t bytes);
 
     /// Connection closed by network error
     void closedByConnection(std::error_code ec);
 
+    /// Receive window growth granted by growReceiveWindow()
+    size_t receiveWindowGrowth() const {
+      return window_growth_;
+    }
+
    private:
+    /// Max pending writes gathered into one data frame
+    static constexpr size_t kMaxChunksPerFrame = 16;
+
+    /// Bandwidth limited streams wait for this many bytes, unless less is
+    /// pending, so that they do not send tiny frames
+    static constexpr size_t kMinPacedBytes = 16 * 1024;
+
     /// Performs close-related cleanup and notifications
     void doClose(std::error_code ec, bool notify_read_side);
 
+    /// Acknowledges bytes consumed by reader, tunes receive window
+    void ackConsumedBytes(size_t bytes);
+
+    /// Acknowledges unacked bytes as download bandwidth allows, the rest
+    /// later
+    void ackPaced();
+
     /// Called by read*() functions
     void doRead(BytesOut out, size_t bytes, ReadCallbackFunc cb);
 
@@ -162,6 +260,48 @@ namespace libp2p::connection {
     /// Maximum window size allowed for peer
     size_t maximum_window_size_;
 
+    /// Grow receive window while reader keeps up, see ackConsumedBytes()
+    bool window_auto_tuning_;
+
+    /// Part of receive window granted by growReceiveWindow()
+    size_t window_growth_ = 0;
+
+    /// Bytes consumed since the window tuning epoch started
+    size_t epoch_consumed_ = 0;
+
+    /// Window tuning epoch ends when whole receive window is consumed
+    std::chrono::steady_clock::time_point epoch_started_;
+
+    /// Connection memory budget reserved for receive window growth
+    muxer::MemoryReservation window_memory_;
+
+    /// Connection memory budget reserved for unsent data
+    muxer::MemoryReservation write_memory_;
+
+    /// Share of connection write bandwidth
+    uint8_t write_weight_ = kDefaultWriteWeight;
+
+    /// Bandwidth buckets of the stream, known after protocol is negotiated
+    std::shared_ptr<muxer::BandwidthManager> bandwidth_;
+
+    /// Limits of data sent
+    muxer::BandwidthLimiter upload_;
+
+    /// Limits of window updates, i.e. of data peer may send
+    muxer::BandwidthLimiter download_;
+
+    /// Stream counted in stream limits
+    muxer::StreamPermit permit_;
+
+    /// Bytes consumed by reader, window update waits for download bandwidth
+    size_t unacked_bytes_ = 0;
+
+    /// Retries writing when upload bandwidth is available
+    basic::Scheduler::Handle upload_timer_;
+
+    /// Retries window update when download bandwidth is available
+    basic::Scheduler::Handle download_timer_;
+
     /// Write queue with callbacks
     basic::WriteQueue write_queue_;
 
@@ -171,6 +311,9 @@ namespace libp2p::connection {
     /// True if read operation is active
     bool is_reading_ = false;
 
+    /// True while connection reads from the wire into client's read buffer
+    bool is_direct_reading_ = false;
+
     /// Read callback, it is non-zero during async data receive
     ReadCallbackFunc read_cb_;
 
@@ -187,6 +330,9 @@ namespace libp2p::connection {
     /// Close callback
     VoidResultHandlerFunc close_cb_;
 
+    /// Payload bytes, data frames and completed reads and writes
+    metrics::TrafficMeter meter_{metrics::TrafficLayer::MUXED};
+
    public:
     LIBP2P_METRICS_INSTANCE_COUNT_IF_ENABLED(libp2p::connection::YamuxStream);
   };
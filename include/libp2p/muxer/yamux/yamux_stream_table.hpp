@@ -0,0 +1,99 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <array>
+#include <deque>
+#include <limits>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include <libp2p/muxer/yamux/yamux_frame.hpp>
+
+namespace libp2p::connection {
+  class YamuxStream;
+
+  /**
+   * Streams of yamux connection by id, stored in a compact vector.
+   * Ids of each side grow monotonically by parity, so id is mapped to index
+   * in the vector by window of slots per parity, which starts at the lowest
+   * live id, without hashing. Ids are never reused, so entry keeps its id
+   * instead of generation. Long lived streams, which would stretch window
+   * beyond limit, are moved to overflow map.
+   * Erase moves the last entry into place, iterators to it are invalidated
+   */
+  class YamuxStreamTable {
+   public:
+    using StreamId = YamuxFrame::StreamId;
+    using Entry = std::pair<StreamId, std::shared_ptr<YamuxStream>>;
+    using Iterator = std::vector<Entry>::iterator;
+    using ConstIterator = std::vector<Entry>::const_iterator;
+
+    /// Slots of window of each parity
+    static constexpr size_t kMaxWindow = 1 << 16;
+
+    size_t size() const {
+      return entries_.size();
+    }
+
+    bool empty() const {
+      return entries_.empty();
+    }
+
+    Iterator begin() {
+      return entries_.begin();
+    }
+    Iterator end() {
+      return entries_.end();
+    }
+    ConstIterator begin() const {
+      return entries_.begin();
+    }
+    ConstIterator end() const {
+      return entries_.end();
+    }
+
+    /// Returns end() if not found
+    Iterator find(StreamId id);
+
+    bool contains(StreamId id) const {
+      return slot(id) != nullptr;
+    }
+
+    /// Inserts stream or replaces existing one
+    void insert(StreamId id, std::shared_ptr<YamuxStream> stream);
+
+    void erase(StreamId id);
+
+    void swap(YamuxStreamTable &other) noexcept;
+
+   private:
+    using Index = uint32_t;
+    static constexpr Index kNone = std::numeric_limits<Index>::max();
+
+    /// Slots of ids (base .. base + slots.size()) * 2 + parity
+    struct Window {
+      StreamId base = 0;
+      std::deque<Index> slots;
+    };
+
+    /// Index of id in window or overflow, nullptr if none
+    const Index *slot(StreamId id) const;
+    Index *slot(StreamId id);
+
+    /// Links id to index of new entry
+    void place(StreamId id, Index index);
+
+    /// Drops unused slots at window ends
+    static void trim(Window &window);
+
+    std::vector<Entry> entries_;
+    std::array<Window, 2> windows_;
+    std::unordered_map<StreamId, Index> overflow_;
+  };
+}  // namespace libp2p::connection
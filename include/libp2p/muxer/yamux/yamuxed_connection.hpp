@@ -7,14 +7,24 @@
 #pragma once
 
 #include <unordered_map>
+#include <unordered_set>
 
+#include <boost/container/small_vector.hpp>
+
+#include <libp2p/basic/buffer_pool.hpp>
+#include <libp2p/basic/free_list.hpp>
 #include <libp2p/basic/read_buffer.hpp>
 #include <libp2p/basic/scheduler.hpp>
 #include <libp2p/common/metrics/instance_count.hpp>
+#include <libp2p/common/metrics/memory_usage.hpp>
+#include <libp2p/common/metrics/traffic.hpp>
 #include <libp2p/connection/capable_connection.hpp>
+#include <libp2p/connection/connection_health.hpp>
+#include <libp2p/muxer/frame_trace.hpp>
 #include <libp2p/muxer/muxed_connection_config.hpp>
 #include <libp2p/muxer/yamux/yamux_reading_state.hpp>
 #include <libp2p/muxer/yamux/yamux_stream.hpp>
+#include <libp2p/muxer/yamux/yamux_stream_table.hpp>
 
 namespace libp2p::connection {
 
@@ -27,37 +37,69 @@ namespace libp2p::connection {
   class YamuxedConnection final
       : public CapableConnection,
         public YamuxStreamFeedback,
+        public HealthCheck,
+        public metrics::MemoryReporter,
         public std::enable_shared_from_this<YamuxedConnection> {
    public:
     using StreamId = uint32_t;
 
+    /// Max frames coalesced into one write, keeps iovec count in asio limits
+    static constexpr size_t kMaxFramesPerWrite = 32;
+
     YamuxedConnection(const YamuxedConnection &other) = delete;
     YamuxedConnection &operator=(const YamuxedConnection &other) = delete;
     YamuxedConnection(YamuxedConnection &&other) = delete;
     YamuxedConnection &operator=(YamuxedConnection &&other) = delete;
-    ~YamuxedConnection() override = default;
+    ~YamuxedConnection() override;
 
     /**
      * Create a new YamuxedConnection instance
      * @param connection to be multiplexed by this instance
      * @param config to configure this instance
-     * @param logger to output messages
+     * @param memory budget of stream buffers, nullptr means no limit
+     * @param bandwidth limits of streams, nullptr means no limit
+     * @param health shared keepalive, pings idle connection instead of
+     * own ping timer, nullptr means own timer
+     * @param streams limits of streams with the peer, nullptr means only
+     * maximum streams of config
      */
-    explicit YamuxedConnection(std::shared_ptr<SecureConnection> connection,
-                               std::shared_ptr<basic::Scheduler> scheduler,
-                               ConnectionClosedCallback closed_callback,
-                               muxer::MuxedConnectionConfig config = {});
+    explicit YamuxedConnection(
+        std::shared_ptr<SecureConnection> connection,
+        std::shared_ptr<basic::Scheduler> scheduler,
+        ConnectionClosedCallback closed_callback,
+        muxer::MuxedConnectionConfig config = {},
+        std::shared_ptr<muxer::MemoryScope> memory = nullptr,
+        std::shared_ptr<muxer::BandwidthManager> bandwidth = nullptr,
+        std::shared_ptr<ConnectionHealth> health = nullptr,
+        std::shared_ptr<muxer::StreamScope> streams = nullptr);
 
     void start() override;
 
     void stop() override;
 
+    /// Stream is usable at once, without waiting for ACK. SYN flag goes
+    /// with the first frame of the stream, usually data, or alone if nothing
+    /// is written till the end of the current io context handler
     outcome::result<std::shared_ptr<Stream>> newStream() override;
 
     void newStream(StreamHandlerFunc cb) override;
 
     void onStream(NewStreamHandlerFunc cb) override;
 
+    /// Open streams, their queued data and ping round trip time
+    ConnectionLoad load() const override;
+
+    void setCloseWhenIdle(bool close) override;
+
+    bool supportsPing() const override;
+
+    /// Sends PING frame, callback gets time till its ACK
+    void ping(PingHandlerFunc cb) override;
+
+    metrics::MemoryUsage memoryUsage() const override;
+
+    metrics::TrafficKey memoryKey() const override;
+
     outcome::result<peer::PeerId> localPeer() const override;
 
     outcome::result<peer::PeerId> remotePeer() const override;
@@ -79,36 +121,116 @@ namespace libp2p::connection {
     void deferWriteCallback(std::error_code ec, WriteCallbackFunc cb) override;
 
    private:
-    using Streams = std::unordered_map<StreamId, std::shared_ptr<YamuxStream>>;
+    using Streams = YamuxStreamTable;
 
     using PendingOutboundStreams =
         std::unordered_map<StreamId, StreamHandlerFunc>;
 
     using Buffer = Bytes;
 
+    /// Stream data chunks of one frame
+    using Payload = boost::container::small_vector<BytesIn, 2>;
+
     struct WriteQueueItem {
-      // TODO(artem): reform in buffers (shared + vector writes)
+      /// Bytes of stream data
+      size_t payloadSize() const;
 
+      /// Frame header or the whole control frame
       Buffer packet;
+
+      /// Stream data following the header, refers to bytes owned by stream's
+      /// write queue, i.e. not copied
+      Payload payload;
+
       StreamId stream_id;
     };
 
+    /// Frames of one stream waiting to be written, in order
+    struct StreamWrites {
+      std::deque<WriteQueueItem> items;
+
+      /// Bytes the stream may still write in the current round
+      size_t deficit = 0;
+
+      /// Quantum of the current round was added to deficit
+      bool visited = false;
+
+      uint8_t weight = Stream::kDefaultWriteWeight;
+
+      /// The first item carries SYN, so control frames of the stream wait
+      /// behind it, peer must not see them before the stream is opened
+      bool syn = false;
+    };
+
+    /// Frames being written by one vectored write operation
+    struct WriteBatch {
+      /// Calls deferred callbacks and releases streams
+      void release();
+
+      /// Buffers not yet written
+      std::span<const BytesIn> unwritten() const;
+
+      /// Advances unwritten buffers, returns false if bytes exceed them
+      bool advance(size_t bytes);
+
+      std::vector<WriteQueueItem> items;
+
+      /// Headers and payloads of items, in order
+      std::vector<BytesIn> buffers;
+
+      /// Index of the 1st unwritten buffer
+      size_t unwritten_index = 0;
+
+      /// Streams whose data is being written, keeps that data alive
+      std::vector<std::shared_ptr<YamuxStream>> streams;
+
+      /// Callbacks deferred until the data is no longer referenced
+      std::vector<std::function<void()>> on_released;
+    };
+
+    /// Stream data is split into frames of at most this size, so that
+    /// streams take turns on the wire
+    static constexpr size_t kMaxDataFrameSize =
+        64 * 1024 - YamuxFrame::kHeaderLength;
+
+    /// Bytes per round of a stream per unit of its write weight
+    static constexpr size_t kWriteQuantumPerWeight = 4 * 1024;
+
+    /// Memory blocks of released streams kept for new ones
+    static constexpr size_t kMaxFreeStreams = 16;
+
     // YamuxStreamFeedback interface overrides
 
     /// Stream transfers data to connection
-    void writeStreamData(uint32_t stream_id, BytesIn data) override;
+    void writeStreamData(uint32_t stream_id,
+                         std::span<const BytesIn> data) override;
 
     /// Stream acknowledges received bytes
     void ackReceivedBytes(uint32_t stream_id, uint32_t bytes) override;
 
+    std::chrono::microseconds rtt() const override;
+
+    size_t growReceiveWindow(size_t bytes) override;
+
+    void shrinkReceiveWindow(size_t bytes) override;
+
+    bool receiveWindowPressure() const override;
+
     /// Stream defers callback to avoid reentrancy
     void deferCall(std::function<void()>) override;
 
+    /// Stream waits for bandwidth
+    basic::Scheduler::Handle scheduleCall(
+        std::function<void()> cb, std::chrono::milliseconds delay) override;
+
     /// Stream closes (if immediately==false then all pending data will be sent)
     void resetStream(uint32_t stream_id) override;
 
     void streamClosed(uint32_t stream_id) override;
 
+    void deferUntilDataReleased(uint32_t stream_id,
+                                std::function<void()> cb) override;
+
     /// usage of these four methods is highly not recommended or even forbidden:
     /// use stream over this connection instead
     void read(BytesOut out, size_t bytes, ReadCallbackFunc cb) override;
@@ -118,15 +240,36 @@ namespace libp2p::connection {
     /// Initiates async readSome on connection
     void continueReading();
 
+    /// Starts reading data message remainder directly into the buffer of
+    /// stream waiting for data, returns false if not applicable
+    bool continueReadingDirectly();
+
     /// Read callback
     void onRead(outcome::result<size_t> res);
 
+    /// Direct read callback
+    void onDirectRead(const std::shared_ptr<YamuxStream> &stream,
+                      outcome::result<size_t> res);
+
+    /// Closes connection on read error
+    void onReadError(std::error_code ec);
+
     /// Processes incoming header, called from YamuxReadingState
     bool processHeader(boost::optional<YamuxFrame> header);
 
     /// Processes incoming data, called from YamuxReadingState
     void processData(BytesOut segment, StreamId stream_id);
 
+    /// Passes data segment to stream
+    void deliverData(BytesOut segment, StreamId stream_id);
+
+    /// Delivers data of stream collected during the read
+    void flushData(StreamId stream_id);
+
+    /// Delivers data of all streams collected during the read, stream by
+    /// stream
+    void flushData();
+
     /// FIN received from peer to stream (either in header or with last data
     /// segment)
     void processFin(StreamId stream_id);
@@ -147,22 +290,67 @@ namespace libp2p::connection {
     /// Processes incoming WINDOW_UPDATE message
     bool processWindowUpdate(const YamuxFrame &frame);
 
+    /// Applies window updates received and sends acks, aggregated per stream
+    /// while frames of one read were processed
+    void flushWindows();
+
+    /// Sets SYN flag in the frame if it is the first one of outbound stream,
+    /// returns true if it was set
+    bool openWith(StreamId stream_id, Buffer &frame);
+
+    /// Sends window update of the stream behind its SYN frame, if it is
+    /// still queued, otherwise as a control frame
+    void enqueueWindowUpdate(StreamId stream_id, uint32_t bytes);
+
+    /// Sends SYN alone for outbound streams which wrote nothing yet
+    void flushSyn();
+
     /// Closes everything, notifies streams and handlers
     void close(std::error_code notify_streams_code,
                boost::optional<YamuxFrame::GoAwayError> reply_to_peer_code);
 
-    /// Writes data to underlying connection or (if is_writing_) enqueues them
-    /// If stream_id != 0, stream will be acknowledged about data written
-    void enqueue(Buffer packet, StreamId stream_id = 0);
+    /// Enqueues control frame and writes it to underlying connection if not
+    /// is_writing_. Control frames are written before stream frames
+    void enqueue(Buffer packet);
+
+    /// Enqueues frame which must stay in order with stream data. If payload
+    /// is not empty, stream will be acknowledged about data written. Without
+    /// pending stream data the frame is a control one. `syn` tells that the
+    /// frame opens the stream
+    void enqueueStreamFrame(Buffer packet,
+                            StreamId stream_id,
+                            Payload payload = {},
+                            bool syn = false);
+
+    /// Moves frames of streams into the batch by deficit round robin
+    void takeStreamFrames(WriteBatch &batch);
+
+    /// Number of frames waiting to be written
+    size_t queuedFrames() const;
+
+    /// Drops all frames waiting to be written
+    void clearWriteQueues();
 
-    /// Performs write into connection
-    void doWrite(WriteQueueItem packet);
+    /// Moves queued frames into a batch and starts writing
+    void doWrite();
+
+    /// Writes the rest of the current batch into connection
+    void continueWriting();
 
     /// Write callback
-    void onDataWritten(outcome::result<size_t> res, StreamId stream_id);
+    void onDataWritten(outcome::result<size_t> res);
+
+    /// Copies queued payloads of the stream (or all streams if stream_id==0)
+    /// into frames since stream data may be released
+    void detachStreamData(StreamId stream_id);
+
+    /// Counts new stream in stream limits, none if they are exceeded
+    std::optional<muxer::StreamPermit> admitStream(
+        muxer::StreamDirection direction);
 
     /// Creates new yamux stream
-    std::shared_ptr<Stream> createStream(StreamId stream_id);
+    std::shared_ptr<Stream> createStream(StreamId stream_id,
+                                          muxer::StreamPermit permit);
 
     /// Erases stream by id, may affect incactivity timer
     void eraseStream(StreamId stream_id);
@@ -180,6 +368,15 @@ namespace libp2p::connection {
     void setTimerCleanup();
     void setTimerPing();
 
+    /// HealthCheck override, pings connection without inbound traffic
+    void onHealthIdle(Time idle) override;
+
+    /// Sends ping and remembers when, pong updates rtt_
+    void sendPing();
+
+    /// Returns receive window growth of stream being erased
+    void releaseReceiveWindow(StreamId stream_id);
+
     /// Copy of config
     const muxer::MuxedConnectionConfig config_;
 
@@ -192,20 +389,35 @@ namespace libp2p::connection {
     /// True if started
     bool started_ = false;
 
-    /// TODO(artem): change read() interface to reduce copying
-    std::shared_ptr<Buffer> raw_read_buffer_;
+    /// Buffer for headers and small data messages, large data goes directly
+    /// into streams' buffers if they are waiting for it
+    /// Taken from the pool shared by all yamux connections
+    basic::BufferSlice raw_read_buffer_;
 
     /// Buffering and segmenting
     YamuxReadingState reading_state_;
 
+    /// Plaintext bytes and yamux frames
+    metrics::TrafficMeter meter_{metrics::TrafficLayer::SECURE};
+
+    /// Frame headers, if capture is enabled
+    muxer::FrameRecorder recorder_;
+
     /// True if waiting for current write operation to complete
     bool is_writing_ = false;
 
-    std::shared_ptr<Bytes> writing_buf_ = std::make_shared<Bytes>();
+    /// Frames being written
+    std::shared_ptr<WriteBatch> writing_;
 
-    /// Write queue
+    /// Control frames queue
     std::deque<WriteQueueItem> write_queue_;
 
+    /// Frames of streams
+    std::unordered_map<StreamId, StreamWrites> stream_writes_;
+
+    /// Streams with frames to write, in round robin order
+    std::deque<StreamId> active_writers_;
+
     /// Active streams
     Streams streams_;
 
@@ -222,14 +434,21 @@ namespace libp2p::connection {
     /// Pending outbound streams
     PendingOutboundStreams pending_outbound_streams_;
 
-    /// Timer handle for pings
-    basic::Scheduler::Handle ping_handle_;
+    /// Stream limits counts of pending outbound streams
+    std::unordered_map<StreamId, muxer::StreamPermit> pending_permits_;
+
+    /// Outbound streams opened without ACK, whose SYN is not sent yet
+    std::unordered_set<StreamId> unsent_syn_;
+
+    /// Timer for pings, unless shared keepalive is used
+    basic::Timer ping_timer_;
+    std::shared_ptr<ConnectionHealth> health_;
 
     /// Cleanup for detached streams
-    basic::Scheduler::Handle cleanup_handle_;
+    basic::Timer cleanup_timer_;
 
-    /// Timer handle for auto closing if inactive
-    basic::Scheduler::Handle inactivity_handle_;
+    /// Timer for auto closing if inactive
+    basic::Timer inactivity_timer_;
 
     /// Called on connection close
     ConnectionClosedCallback closed_callback_;
@@ -239,8 +458,60 @@ namespace libp2p::connection {
 
     uint32_t ping_counter_ = 0;
 
+    /// When the last ping was sent, to measure round trip time
+    std::chrono::steady_clock::time_point ping_sent_at_;
+
+    /// Smoothed ping round trip time
+    std::chrono::microseconds rtt_{};
+
+    /// Pings requested by ping(), waiting for ACK
+    struct PendingPing {
+      uint32_t id;
+      std::chrono::steady_clock::time_point sent_at;
+      PingHandlerFunc cb;
+    };
+    std::vector<PendingPing> pending_pings_;
+
+    /// Receive window growth granted to streams
+    size_t window_growth_ = 0;
+
+    /// Frames of one read are being processed, data segments, window updates
+    /// and acks are aggregated per stream till the end of read
+    bool batching_reads_ = false;
+
+    /// Data of stream received during the read
+    struct ReceivedData {
+      StreamId stream_id;
+      /// The only segment, refers to read buffer
+      BytesOut segment;
+      /// Segments joined, if there are more than one
+      Bytes joined;
+    };
+    std::vector<ReceivedData> received_data_;
+
+    /// Send window increments received from peer during the read
+    std::vector<std::pair<StreamId, size_t>> received_windows_;
+
+    /// Bytes consumed by streams during the read, to acknowledge to peer
+    std::vector<std::pair<StreamId, size_t>> acked_windows_;
+
+    /// Memory budget shared by streams
+    std::shared_ptr<muxer::MemoryScope> memory_;
+
+    /// Bandwidth buckets shared by streams
+    std::shared_ptr<muxer::BandwidthManager> bandwidth_;
+
+    /// Stream limits shared by connections to the peer
+    std::shared_ptr<muxer::StreamScope> stream_limits_;
+
+    /// Memory of released streams, short-lived streams reuse it
+    std::shared_ptr<basic::FreeList> stream_memory_;
+
     bool close_after_write_ = false;
 
+    /// Inactivity timer closes connection without streams
+    bool close_when_idle_ = true;
+
    public:
     LIBP2P_METRICS_INSTANCE_COUNT_IF_ENABLED(
         libp2p::connection::YamuxedConnection);
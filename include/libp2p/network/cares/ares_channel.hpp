@@ -0,0 +1,104 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/address.hpp>
+#include <boost/asio/posix/stream_descriptor.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <libp2p/network/cares/cares.hpp>
+#include <libp2p/network/dns_cache.hpp>
+
+namespace libp2p::network::c_ares {
+
+  /**
+   * Long-lived c-ares channel driven by io context.
+   * Sockets of the channel are watched by asio descriptors and its timeouts
+   * by asio timer, so queries need neither threads nor select().
+   * TXT responses are cached according to records TTL, concurrent requests of
+   * the same uri share one query.
+   * Not thread-safe, has to be used from the io context thread.
+   */
+  class AresChannel : public std::enable_shared_from_this<AresChannel> {
+   public:
+    using TxtCallback =
+        std::function<void(outcome::result<std::vector<std::string>>)>;
+
+    /// Resolved addresses of name
+    struct Addresses {
+      std::vector<boost::asio::ip::address> addresses;
+      /// minimal TTL of the records
+      std::chrono::seconds ttl{};
+    };
+    using AddressesCallback = std::function<void(outcome::result<Addresses>)>;
+
+    AresChannel(std::shared_ptr<boost::asio::io_context> io_context,
+                const Ares &ares);
+    ~AresChannel();
+
+    AresChannel(const AresChannel &) = delete;
+    AresChannel(AresChannel &&) = delete;
+    void operator=(const AresChannel &) = delete;
+    void operator=(AresChannel &&) = delete;
+
+    /// Callback is posted to io context
+    void resolveTxt(const std::string &uri, TxtCallback callback);
+
+    /**
+     * Resolves A or AAAA records of name, callback is posted to io context
+     * @param v4 true for A records, false for AAAA, none for both
+     */
+    void resolveAddresses(const std::string &name,
+                          std::optional<bool> v4,
+                          AddressesCallback callback);
+
+   private:
+    using TxtCache = DnsCache<std::vector<std::string>>;
+
+    struct Socket;
+
+    static void sockStateCallback(void *arg,
+                                  ares_socket_t fd,
+                                  int readable,
+                                  int writable);
+    static void txtCallback(
+        void *arg, int status, int timeouts, unsigned char *abuf, int alen);
+    static void addressesCallback(void *arg,
+                                  int status,
+                                  int timeouts,
+                                  ::ares_addrinfo *result);
+
+    /// waits for readiness of socket requested by c-ares
+    void watch(const std::shared_ptr<Socket> &socket);
+
+    /// processes ready socket, or timeouts if both are bad
+    void process(ares_socket_t read_fd, ares_socket_t write_fd);
+
+    /// schedules processing of the nearest query timeout
+    void updateTimer();
+
+    /// caches result of the query and posts it to all waiting callbacks
+    void finishTxt(const std::string &uri,
+                   const TxtCache::Result &result,
+                   std::optional<TxtCache::Clock::duration> ttl);
+
+    std::shared_ptr<boost::asio::io_context> io_context_;
+    ::ares_channel channel_{nullptr};
+    boost::asio::steady_timer timer_;
+    std::unordered_map<ares_socket_t, std::shared_ptr<Socket>> sockets_;
+    TxtCache txt_cache_;
+  };
+
+}  // namespace libp2p::network::c_ares
@@ -7,34 +7,26 @@
 #pragma once
 
 #include <atomic>
-#include <functional>
-#include <list>
-#include <memory>
-#include <string>
-#include <vector>
+#include <map>
 
 #include <ares.h>
-#include <boost/asio.hpp>
 #include <libp2p/log/logger.hpp>
 #include <libp2p/outcome/outcome.hpp>
 
 namespace libp2p::network::c_ares {
 
   /**
-   *
+   * Initializes c-ares library for the lifetime of the instance.
    * Only one instance is allowed to exist.
+   * Queries are made by AresChannel, which requires the instance.
    * Has to be initialized prior any threads spawn.
    * Designed for use only via Boost injector passing by a reference.
    */
   class Ares final {
    public:
-    using TxtCallback =
-        std::function<void(outcome::result<std::vector<std::string>>)>;
-
     enum class Error {
       NOT_INITIALIZED = 1,
       CHANNEL_INIT_FAILURE,
-      THREAD_FAILED,
       // the following are the codes returned to callback by ::ares_query
       E_NO_DATA,
       E_BAD_QUERY,
@@ -76,41 +68,10 @@ namespace libp2p::network::c_ares {
     void operator=(const Ares &) = delete;
     void operator=(Ares &&) = delete;
 
-    static void resolveTxt(
-        const std::string &uri,
-        const std::weak_ptr<boost::asio::io_context> &io_context,
-        TxtCallback callback);
-
    private:
-    struct RequestContext {
-      std::weak_ptr<boost::asio::io_context> io_context;
-      std::string uri;
-      TxtCallback callback;
-
-      RequestContext(std::weak_ptr<boost::asio::io_context> io_context_,
-                     std::string uri_,
-                     TxtCallback callback_)
-          : io_context{std::move(io_context_)},
-            uri{std::move(uri_)},
-            callback{std::move(callback_)} {}
-    };
-
-    /// schedules to user's io_context the call of callback with specified error
-    static void reportError(
-        const std::weak_ptr<boost::asio::io_context> &io_context,
-        TxtCallback callback,
-        Error error);
-
-    static void txtCallback(
-        void *arg, int status, int timeouts, unsigned char *abuf, int alen);
-
-    /// does ares sockets processing for the channel, to be in a separate thread
-    static void waitAresChannel(::ares_channel channel);
-
-    static void removeRequest(RequestContext *request_ptr);
+    friend class AresChannel;
 
     static std::atomic_bool initialized_;
-    static std::list<std::shared_ptr<RequestContext>> requests_;
 
     /// Returns "ares" logger
     static log::Logger log();
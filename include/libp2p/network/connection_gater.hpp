@@ -0,0 +1,51 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <boost/asio/ip/address.hpp>
+
+#include <libp2p/multi/multiaddress.hpp>
+#include <libp2p/peer/peer_id.hpp>
+
+namespace libp2p::connection {
+  struct CapableConnection;
+}  // namespace libp2p::connection
+
+namespace libp2p::network {
+
+  /**
+   * Decides which connections are allowed at each stage of their setup, so
+   * that unwanted ones are dropped as early and as cheaply as possible:
+   * - before dial, by peer id and address;
+   * - at accept, by remote ip, before anything is read and any crypto runs;
+   * - after security handshake, by authenticated peer id;
+   * - after muxer upgrade, by connection.
+   * Called from io context threads of all transports, has to be thread-safe
+   */
+  class ConnectionGater {
+   public:
+    virtual ~ConnectionGater() = default;
+
+    /// Called before dial to peer is started
+    virtual bool allowDialPeer(const peer::PeerId &peer) const = 0;
+
+    /// Called before each address of peer is dialed
+    virtual bool allowDialAddress(const peer::PeerId &peer,
+                                  const multi::Multiaddress &address) const = 0;
+
+    /// Called for inbound connection, or QUIC datagram, right after accept
+    virtual bool allowAccept(const boost::asio::ip::address &address) const = 0;
+
+    /// Called once remote peer is authenticated by security handshake
+    virtual bool allowSecured(const peer::PeerId &peer,
+                              bool initiator) const = 0;
+
+    /// Called for connection ready to open streams, before it is reported
+    virtual bool allowUpgraded(connection::CapableConnection &conn) const = 0;
+  };
+
+}  // namespace libp2p::network
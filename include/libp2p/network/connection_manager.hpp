@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <chrono>
 #include <memory>
 
 #include <libp2p/basic/garbage_collectable.hpp>
@@ -28,6 +29,34 @@ namespace libp2p::event::network {
 
 namespace libp2p::network {
 
+  /**
+   * Limits of connection manager
+   */
+  struct ConnectionManagerConfig {
+    /// Trimming closes connections down to this number
+    size_t low_water = 160;
+
+    /// Trimming starts when number of connections exceeds this
+    size_t high_water = 192;
+
+    /// Peers connected more recently are not trimmed
+    std::chrono::milliseconds grace_period = std::chrono::minutes{1};
+
+    /// Minimal interval between starts of trimming rounds
+    std::chrono::milliseconds silence_period = std::chrono::seconds{10};
+
+    /// How many peers are disconnected per scheduler cycle while trimming
+    size_t trim_batch = 8;
+
+    /// Relayed connections to peer are closed after this period, once there
+    /// is a direct connection to it
+    std::chrono::milliseconds relay_drain_period = std::chrono::seconds{30};
+
+    /// Connection chosen for new streams to peer is kept for this period,
+    /// unless connections to peer change
+    std::chrono::milliseconds selection_period = std::chrono::milliseconds{100};
+  };
+
   /**
    * @brief Connection Manager stores all known connections, and is capable of
    * selecting subset of connections
@@ -61,6 +90,32 @@ namespace libp2p::network {
     virtual void onConnectionClosed(
         const peer::PeerId &peer_id,
         const std::shared_ptr<connection::CapableConnection> &conn) = 0;
+
+    /// Sets value of tag of connected peer, peers with lower sum of tag
+    /// values are disconnected first when connections are trimmed. Tags are
+    /// dropped when peer disconnects
+    virtual void tagPeer(const peer::PeerId &p,
+                         const std::string &tag,
+                         int value) = 0;
+
+    virtual void untagPeer(const peer::PeerId &p, const std::string &tag) = 0;
+
+    /// Protects connections to peer from trimming until all tags are
+    /// unprotected
+    virtual void protect(const peer::PeerId &p, const std::string &tag) = 0;
+
+    /// @return true if peer is still protected by other tags
+    virtual bool unprotect(const peer::PeerId &p, const std::string &tag) = 0;
+
+    virtual bool isProtected(const peer::PeerId &p) const = 0;
+
+    /// Groups up to `width` connections to peer into stripe, which trimming
+    /// counts and closes as one connection. Width below 2 removes the stripe
+    virtual void setStripe(const peer::PeerId &p, size_t width) = 0;
+
+    /// @return open direct connection of stripe to peer, in round-robin
+    /// order, or nullptr if peer has no stripe
+    virtual ConnectionSPtr getStripedConnection(const peer::PeerId &p) = 0;
   };
 
 }  // namespace libp2p::network
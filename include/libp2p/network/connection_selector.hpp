@@ -0,0 +1,29 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <memory>
+#include <span>
+
+#include <libp2p/connection/capable_connection.hpp>
+
+namespace libp2p::network {
+
+  /// Strategy of ConnectionManager, chooses connection for new streams among
+  /// open connections to the same peer
+  class ConnectionSelector {
+   public:
+    using ConnectionSPtr = std::shared_ptr<connection::CapableConnection>;
+
+    virtual ~ConnectionSelector() = default;
+
+    /// Returns one of connections, the list is not empty
+    virtual ConnectionSPtr select(
+        std::span<const ConnectionSPtr> connections) const = 0;
+  };
+
+}  // namespace libp2p::network
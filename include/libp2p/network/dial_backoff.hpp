@@ -0,0 +1,87 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <unordered_set>
+
+#include <libp2p/common/lru_cache.hpp>
+#include <libp2p/peer/peer_info.hpp>
+
+namespace libp2p::network {
+
+  /**
+   * Negative cache of dials, which failed to all addresses of peer.
+   * Peer is backed off exponentially with each failed dial, unless dial has
+   * addresses which were not tried yet. Backoff of single addresses is kept
+   * by address repository.
+   * Not thread-safe.
+   */
+  class DialBackoff {
+   public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Config {
+      /// backoff after first failure, doubled by each next one
+      Clock::duration base = std::chrono::seconds{5};
+      Clock::duration max = std::chrono::minutes{5};
+      size_t capacity = 1024;
+    };
+
+    DialBackoff() : DialBackoff{Config{}} {}
+
+    explicit DialBackoff(Config config)
+        : config_{config}, entries_{config.capacity} {}
+
+    /// Whether dial to peer should be rejected, as it has failed recently
+    /// and no new address is given
+    bool blocked(const peer::PeerInfo &peer, Clock::time_point now) {
+      auto entry = entries_.get(peer.id);
+      if (entry == nullptr or now >= entry->until) {
+        return false;
+      }
+      return std::ranges::all_of(peer.addresses, [&](const auto &addr) {
+        return entry->addresses.contains(addr);
+      });
+    }
+
+    /// Records failure of dial to all given addresses of peer
+    void failed(const peer::PeerInfo &peer, Clock::time_point now) {
+      auto entry = entries_.get(peer.id);
+      if (entry == nullptr) {
+        entry = &entries_.put(peer.id, Entry{});
+      }
+      auto shift = std::min<size_t>(entry->failures, 16);
+      ++entry->failures;
+      entry->until = now + std::min(config_.base * (1 << shift), config_.max);
+      entry->addresses.insert(peer.addresses.begin(), peer.addresses.end());
+    }
+
+    /// Forgets failures of peer
+    void succeeded(const peer::PeerId &peer_id) {
+      entries_.erase(peer_id);
+    }
+
+    /// Number of peers, which have failed since last success
+    size_t size() const {
+      return entries_.size();
+    }
+
+   private:
+    struct Entry {
+      size_t failures = 0;
+      Clock::time_point until;
+      /// Addresses, which failed since last success
+      std::unordered_set<multi::Multiaddress> addresses;
+    };
+
+    Config config_;
+    LruCache<peer::PeerId, Entry> entries_;
+  };
+
+}  // namespace libp2p::network
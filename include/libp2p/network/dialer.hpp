@@ -33,6 +33,15 @@ namespace libp2p::network {
      */
     virtual void dial(const PeerInfo &p, DialResultFunc cb) = 0;
 
+    /**
+     * Establishes one more connection to a given peer, even if there are
+     * connections to it already. Used to stripe bulk transfers over several
+     * connections
+     */
+    virtual void dialAnother(const PeerInfo &p, DialResultFunc cb) {
+      dial(p, std::move(cb));
+    }
+
     /**
      * NewStream returns a new stream to given peer p.
      * If there is no connection to p, returns error.
@@ -41,6 +50,24 @@ namespace libp2p::network {
                            StreamProtocols protocols,
                            StreamAndProtocolOrErrorCb cb) = 0;
 
+    /**
+     * Opens a new stream over given connection
+     */
+    virtual void newStream(std::shared_ptr<connection::CapableConnection> conn,
+                           StreamProtocols protocols,
+                           StreamAndProtocolOrErrorCb cb) = 0;
+
+    /**
+     * Opens a new stream to given peer for protocol, which is known to be
+     * supported by the peer, without waiting for negotiation round trip.
+     * Negotiation failure is reported to the first read from the stream
+     */
+    virtual void newStreamLazy(const PeerInfo &peer_info,
+                               const peer::ProtocolName &protocol,
+                               StreamAndProtocolOrErrorCb cb) {
+      newStream(peer_info, {protocol}, std::move(cb));
+    }
+
     void newStream(const PeerId &peer_id,
                    StreamProtocols protocols,
                    StreamAndProtocolOrErrorCb cb) {
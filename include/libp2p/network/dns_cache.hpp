@@ -0,0 +1,109 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <libp2p/common/lru_cache.hpp>
+#include <libp2p/outcome/outcome.hpp>
+
+namespace libp2p::network {
+
+  /**
+   * Cache of DNS lookup results, both positive and negative, which also
+   * coalesces concurrent lookups of the same name into one query.
+   * Not thread-safe.
+   */
+  template <typename V>
+  class DnsCache {
+   public:
+    using Clock = std::chrono::steady_clock;
+    using Result = outcome::result<V>;
+    using Callback = std::function<void(Result)>;
+
+    struct Config {
+      /// lifetime of results, when the record TTL is unknown
+      Clock::duration ttl = std::chrono::minutes{5};
+      /// upper bound of TTL reported by records
+      Clock::duration max_ttl = std::chrono::hours{1};
+      /// lifetime of failed lookups
+      Clock::duration negative_ttl = std::chrono::seconds{30};
+      size_t capacity = 256;
+    };
+
+    DnsCache() : DnsCache{Config{}} {}
+
+    explicit DnsCache(Config config)
+        : config_{config}, entries_{config.capacity} {}
+
+    /// Result of a previous lookup of name, unless it has expired
+    std::optional<Result> get(const std::string &name, Clock::time_point now) {
+      auto entry = entries_.get(name);
+      if (entry == nullptr) {
+        return std::nullopt;
+      }
+      if (now >= entry->expires) {
+        entries_.erase(name);
+        return std::nullopt;
+      }
+      return entry->result;
+    }
+
+    /**
+     * Subscribes callback to the lookup of name
+     * @return true if caller has to start the query, false if the query is
+     * already in flight
+     */
+    bool wait(const std::string &name, Callback cb) {
+      auto &waiters = in_flight_[name];
+      waiters.emplace_back(std::move(cb));
+      return waiters.size() == 1;
+    }
+
+    /**
+     * Stores result of the query and returns callbacks waiting for it, which
+     * caller has to invoke
+     * @param ttl lifetime reported by the records, zero disables caching
+     */
+    std::vector<Callback> resolved(
+        const std::string &name,
+        const Result &result,
+        Clock::time_point now,
+        std::optional<Clock::duration> ttl = std::nullopt) {
+      auto lifetime = result.has_value() ? config_.ttl : config_.negative_ttl;
+      if (ttl) {
+        lifetime = std::min(*ttl, config_.max_ttl);
+      }
+      if (lifetime > Clock::duration::zero()) {
+        entries_.put(name, Entry{result, now + lifetime});
+      }
+      auto it = in_flight_.find(name);
+      if (it == in_flight_.end()) {
+        return {};
+      }
+      auto waiters = std::move(it->second);
+      in_flight_.erase(it);
+      return waiters;
+    }
+
+   private:
+    struct Entry {
+      Result result;
+      Clock::time_point expires;
+    };
+
+    Config config_;
+    LruCache<std::string, Entry> entries_;
+    std::unordered_map<std::string, std::vector<Callback>> in_flight_;
+  };
+
+}  // namespace libp2p::network
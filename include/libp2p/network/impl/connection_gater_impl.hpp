@@ -0,0 +1,93 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <shared_mutex>
+#include <span>
+#include <unordered_set>
+#include <vector>
+
+#include <libp2p/network/connection_gater.hpp>
+
+namespace libp2p::network {
+
+  /**
+   * Gater with subnet rules and peer blocklist.
+   * Subnets are allowed or denied by rule of the longest matching prefix, kept
+   * in binary prefix trie per address family, so accept costs one walk of at
+   * most 32 or 128 nodes. Blocked peers are denied after security handshake
+   * and before dial. Rules may be changed from any thread, checks take shared
+   * lock only if there are rules at all
+   */
+  class ConnectionGaterImpl : public ConnectionGater {
+   public:
+    struct Config {
+      /// Whether addresses matching no subnet rule are allowed
+      bool allow_by_default = true;
+    };
+
+    ConnectionGaterImpl();
+
+    explicit ConnectionGaterImpl(Config config);
+
+    /// Allows subnet, e.g. within wider denied one
+    void allowSubnet(const boost::asio::ip::address &address, uint8_t prefix);
+
+    void denySubnet(const boost::asio::ip::address &address, uint8_t prefix);
+
+    /// Removes rule of exactly this subnet
+    void removeSubnet(const boost::asio::ip::address &address, uint8_t prefix);
+
+    void blockPeer(const peer::PeerId &peer);
+
+    void unblockPeer(const peer::PeerId &peer);
+
+    bool isPeerBlocked(const peer::PeerId &peer) const;
+
+    bool allowAddress(const boost::asio::ip::address &address) const;
+
+    // ConnectionGater
+    bool allowDialPeer(const peer::PeerId &peer) const override;
+    bool allowDialAddress(const peer::PeerId &peer,
+                          const multi::Multiaddress &address) const override;
+    bool allowAccept(const boost::asio::ip::address &address) const override;
+    bool allowSecured(const peer::PeerId &peer, bool initiator) const override;
+    bool allowUpgraded(connection::CapableConnection &conn) const override;
+
+   private:
+    enum class Rule : uint8_t { NONE, ALLOW, DENY };
+
+    struct Node {
+      /// Indices of children for bit 0 and 1, zero if there is none, as root
+      /// is never a child
+      std::array<uint32_t, 2> children{};
+      Rule rule = Rule::NONE;
+    };
+
+    using Trie = std::vector<Node>;
+
+    void setRule(const boost::asio::ip::address &address,
+                 uint8_t prefix,
+                 Rule rule);
+
+    /// Rule of the longest prefix of `bytes`, which has one
+    static Rule match(const Trie &trie, std::span<const uint8_t> bytes);
+
+    const Config config_;
+    mutable std::shared_mutex mutex_;
+    /// Removed rules don't shrink tries, they are as large as rules set ever
+    Trie v4_{1}, v6_{1};
+    size_t subnet_rules_ = 0;
+    std::unordered_set<peer::PeerId> blocked_peers_;
+    /// Uncontended checks while there are no rules
+    std::atomic_bool has_subnets_ = false;
+    std::atomic_bool has_peers_ = false;
+  };
+
+}  // namespace libp2p::network
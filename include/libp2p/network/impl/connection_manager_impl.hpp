@@ -6,18 +6,38 @@
 
 #pragma once
 
+#include <queue>
 #include <unordered_set>
 
+#include <libp2p/basic/scheduler.hpp>
 #include <libp2p/event/bus.hpp>
 #include <libp2p/network/connection_manager.hpp>
+#include <libp2p/network/connection_selector.hpp>
 #include <libp2p/network/transport_manager.hpp>
 #include <libp2p/peer/peer_id.hpp>
 
 namespace libp2p::network {
 
-  class ConnectionManagerImpl : public ConnectionManager {
+  /**
+   * Keeps number of connections between watermarks. When it exceeds
+   * `high_water`, peers are disconnected in order of their tag scores until
+   * `low_water` is reached, a batch per scheduler cycle. Protected peers and
+   * peers within grace period are never disconnected.
+   * Direct connections are preferred over relayed ones, which are closed
+   * after drain period once peer is connected directly.
+   * Connection for new streams is chosen by ConnectionSelector, choice is
+   * cached per peer for `selection_period`.
+   * Connections of stripe to peer count as one towards watermarks
+   */
+  class ConnectionManagerImpl
+      : public ConnectionManager,
+        public std::enable_shared_from_this<ConnectionManagerImpl> {
    public:
-    explicit ConnectionManagerImpl(std::shared_ptr<libp2p::event::Bus> bus);
+    ConnectionManagerImpl(
+        std::shared_ptr<libp2p::event::Bus> bus,
+        std::shared_ptr<basic::Scheduler> scheduler,
+        ConnectionManagerConfig config,
+        std::shared_ptr<ConnectionSelector> selector = nullptr);
 
     std::vector<ConnectionSPtr> getConnections() const override;
 
@@ -37,15 +57,107 @@ namespace libp2p::network {
         const peer::PeerId &peer_id,
         const std::shared_ptr<connection::CapableConnection> &conn) override;
 
+    void tagPeer(const peer::PeerId &p,
+                 const std::string &tag,
+                 int value) override;
+
+    void untagPeer(const peer::PeerId &p, const std::string &tag) override;
+
+    void protect(const peer::PeerId &p, const std::string &tag) override;
+
+    bool unprotect(const peer::PeerId &p, const std::string &tag) override;
+
+    bool isProtected(const peer::PeerId &p) const override;
+
+    void setStripe(const peer::PeerId &p, size_t width) override;
+
+    ConnectionSPtr getStripedConnection(const peer::PeerId &p) override;
+
    private:
+    /// State of connected peer
+    struct PeerMeta {
+      basic::Scheduler::Time connected_at;
+      std::unordered_map<std::string, int> tags;
+      /// Sum of tag values
+      int score = 0;
+    };
+
+    /// Connection chosen for new streams to peer
+    struct Selected {
+      ConnectionSPtr connection;
+      basic::Scheduler::Time until;
+    };
+
+    /// Connections to peer used together for bulk transfers
+    struct Stripe {
+      size_t width;
+      /// Round-robin position of the next stream
+      size_t next = 0;
+    };
+
+    struct Victim {
+      int score;
+      peer::PeerId peer;
+
+      bool operator>(const Victim &other) const {
+        return score > other.score;
+      }
+    };
+
+    /// Number of connections, stripe counts as one
+    size_t countedConnections() const;
+
+    /// Drops cached choice of connection to peer
+    void forgetSelected(const peer::PeerId &p);
+
+    /// Closes relayed connections after drain period, if there is direct one
+    void drainRelayed(const std::unordered_set<ConnectionSPtr> &connections);
+
+    /// Starts trimming round if there are too many connections
+    void maybeTrim();
+
+    /// Collects candidates for disconnection
+    void startTrim();
+
+    /// Disconnects a batch of candidates, continues on the next cycle
+    void trimStep();
+
     std::unordered_map<peer::PeerId, std::unordered_set<ConnectionSPtr>>
         connections_;
 
     std::shared_ptr<libp2p::event::Bus> bus_;
+    std::shared_ptr<basic::Scheduler> scheduler_;
+    ConnectionManagerConfig config_;
+    std::shared_ptr<ConnectionSelector> selector_;
+
+    /// Cached results of selector_, peers with one connection need no choice
+    mutable std::unordered_map<peer::PeerId, Selected> selected_;
 
     /// Reentrancy resolver between closeConnectionsToPeer and
     /// onConnectionClosed
     boost::optional<peer::PeerId> closing_connections_to_peer_;
+
+    /// Number of connections in `connections_`
+    size_t connection_count_ = 0;
+
+    std::unordered_map<peer::PeerId, PeerMeta> peers_;
+
+    /// Protection tags of peers, connected or not
+    std::unordered_map<peer::PeerId, std::unordered_set<std::string>>
+        protected_;
+
+    /// Candidates of current trimming round, lowest score on top
+    std::priority_queue<Victim, std::vector<Victim>, std::greater<>> victims_;
+
+    /// Stripes of peers, connected or not
+    std::unordered_map<peer::PeerId, Stripe> stripes_;
+
+    bool trimming_ = false;
+
+    /// Trimming round is scheduled after silence period
+    bool trim_scheduled_ = false;
+
+    boost::optional<basic::Scheduler::Time> last_trim_;
   };
 
 }  // namespace libp2p::network
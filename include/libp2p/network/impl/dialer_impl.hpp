@@ -11,7 +11,10 @@
 #include <unordered_set>
 
 #include <libp2p/basic/scheduler.hpp>
+#include <libp2p/common/metrics/tracing.hpp>
+#include <libp2p/network/connection_gater.hpp>
 #include <libp2p/network/connection_manager.hpp>
+#include <libp2p/network/dial_backoff.hpp>
 #include <libp2p/network/dialer.hpp>
 #include <libp2p/network/listener_manager.hpp>
 #include <libp2p/network/transport_manager.hpp>
@@ -23,6 +26,15 @@ namespace libp2p::network {
   class DialerImpl : public Dialer,
                      public std::enable_shared_from_this<DialerImpl> {
    public:
+    /// Delay before the next parallel attempt starts, as in RFC 8305
+    static constexpr std::chrono::milliseconds kDialStagger{250};
+
+    /// Maximum number of attempts to one peer in flight at once
+    static constexpr size_t kMaxParallelDials = 4;
+
+    /// Maximum number of peers we remember last successful address for
+    static constexpr size_t kMaxRememberedPeers = 1024;
+
     ~DialerImpl() override = default;
 
     DialerImpl(std::shared_ptr<protocol_muxer::ProtocolMuxer> multiselect,
@@ -32,17 +44,43 @@ namespace libp2p::network {
                std::shared_ptr<peer::AddressRepository> addr_repo,
                std::shared_ptr<basic::Scheduler> scheduler);
 
+    /// @param gater checks peers and addresses before dial, and connections
+    /// once they are upgraded
+    DialerImpl(std::shared_ptr<protocol_muxer::ProtocolMuxer> multiselect,
+               std::shared_ptr<TransportManager> tmgr,
+               std::shared_ptr<ConnectionManager> cmgr,
+               std::shared_ptr<ListenerManager> listener,
+               std::shared_ptr<peer::AddressRepository> addr_repo,
+               std::shared_ptr<basic::Scheduler> scheduler,
+               std::shared_ptr<ConnectionGater> gater);
+
     // Establishes a connection to a given peer
     void dial(const PeerInfo &p, DialResultFunc cb) override;
 
+    // Establishes a new connection, existing ones and dials in progress are
+    // ignored. Addresses are tried one by one, relayed ones are skipped
+    void dialAnother(const PeerInfo &p, DialResultFunc cb) override;
+
     void newStream(const PeerInfo &peer_id,
                    StreamProtocols protocols,
                    StreamAndProtocolOrErrorCb cb) override;
 
+    void newStreamLazy(const PeerInfo &peer_info,
+                       const peer::ProtocolName &protocol,
+                       StreamAndProtocolOrErrorCb cb) override;
+
+    void newStream(std::shared_ptr<connection::CapableConnection> conn,
+                   StreamProtocols protocols,
+                   StreamAndProtocolOrErrorCb cb) override;
+
    private:
     // A context to handle an intermediary state of the peer we are dialing to
     // but the connection is not yet established
     struct DialCtx {
+      /// Distinguishes dials to the same peer, attempts and timers of a
+      /// finished dial must not touch the next one
+      uint64_t id = 0;
+
       /// Queue of addresses to try connect to
       std::deque<Multiaddress> addr_queue;
 
@@ -60,18 +98,39 @@ namespace libp2p::network {
       // indicates that at least one attempt to dial was happened
       // (at least one supported network transport was found and used)
       bool dialled = false;
+
+      /// Number of attempts started and not yet finished
+      size_t in_flight = 0;
+
+      /// Starts the next attempt unless the current ones finish earlier
+      basic::Scheduler::Handle stagger_timer;
+
+      /// Spans the whole dial, attempts are its children
+      metrics::Span span;
     };
 
-    // Perform a single attempt to dial to the peer via the next known address
-    void rotate(const peer::PeerId &peer_id);
+    // Start an attempt to dial to the peer via the next known address, and
+    // schedule the next one after `kDialStagger`. The first established
+    // connection wins, connections of late attempts are closed.
+    // Does nothing if dial `dial_id` to the peer is already finished
+    void rotate(const peer::PeerId &peer_id, uint64_t dial_id);
+
+    void onDialed(
+        const peer::PeerId &peer_id,
+        uint64_t dial_id,
+        const Multiaddress &addr,
+        std::chrono::steady_clock::time_point started,
+        outcome::result<std::shared_ptr<connection::CapableConnection>>
+            result);
 
     // Finalize dialing to the peer and propagate a given result to all
     // connection requesters
     void completeDial(const peer::PeerId &peer_id, const DialResult &result);
 
-    void newStream(std::shared_ptr<connection::CapableConnection> conn,
-                   StreamProtocols protocols,
-                   StreamAndProtocolOrErrorCb cb);
+    // Dials addresses of additional connection one by one until one succeeds
+    void dialAnotherVia(const peer::PeerId &peer_id,
+                        std::shared_ptr<std::deque<Multiaddress>> addrs,
+                        DialResultFunc cb);
 
     std::shared_ptr<protocol_muxer::ProtocolMuxer> multiselect_;
     std::shared_ptr<TransportManager> tmgr_;
@@ -79,10 +138,21 @@ namespace libp2p::network {
     std::shared_ptr<ListenerManager> listener_;
     std::shared_ptr<peer::AddressRepository> addr_repo_;
     std::shared_ptr<basic::Scheduler> scheduler_;
+    std::shared_ptr<ConnectionGater> gater_;
     log::Logger log_;
 
     // peers we are currently dialing to
     std::unordered_map<peer::PeerId, DialCtx> dialing_peers_;
+
+    // id of the next dial, see `DialCtx::id`
+    uint64_t next_dial_id_ = 0;
+
+    // address of the last successful dial to peer, tried first next time
+    std::unordered_map<peer::PeerId, Multiaddress> last_dialled_;
+
+    // peers, which failed to dial via all their addresses, shared by all
+    // protocols dialing through host
+    DialBackoff backoff_;
   };
 
 }  // namespace libp2p::network
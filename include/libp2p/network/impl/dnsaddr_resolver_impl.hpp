@@ -11,8 +11,7 @@
 #include <memory>
 #include <string>
 
-#include <boost/asio.hpp>
-#include <libp2p/network/cares/cares.hpp>
+#include <libp2p/network/cares/ares_channel.hpp>
 
 namespace libp2p::network {
 
@@ -26,8 +25,7 @@ namespace libp2p::network {
       BAD_ADDR_IN_RESPONSE,
     };
 
-    DnsaddrResolverImpl(std::shared_ptr<boost::asio::io_context> io_context,
-                        const c_ares::Ares &cares);
+    explicit DnsaddrResolverImpl(std::shared_ptr<c_ares::AresChannel> ares);
 
     void load(multi::Multiaddress address, AddressesCallback callback) override;
 
@@ -36,9 +34,7 @@ namespace libp2p::network {
     static outcome::result<std::string> dnsaddrUriFromMultiaddr(
         const multi::Multiaddress &address);
 
-    std::shared_ptr<boost::asio::io_context> io_context_;
-    // captured by reference intentionally to force DI use the single instance
-    const c_ares::Ares &cares_;
+    std::shared_ptr<c_ares::AresChannel> ares_;
   };
 
 }  // namespace libp2p::network
@@ -7,6 +7,7 @@
 #pragma once
 
 #include <libp2p/connection/capable_connection.hpp>
+#include <libp2p/network/connection_gater.hpp>
 #include <libp2p/network/connection_manager.hpp>
 #include <libp2p/network/listener_manager.hpp>
 #include <libp2p/network/transport_manager.hpp>
@@ -25,6 +26,14 @@ namespace libp2p::network {
         std::shared_ptr<TransportManager> tmgr,
         std::shared_ptr<ConnectionManager> cmgr);
 
+    /// @param gater checks connections once they are upgraded
+    ListenerManagerImpl(
+        std::shared_ptr<protocol_muxer::ProtocolMuxer> multiselect,
+        std::shared_ptr<Router> router,
+        std::shared_ptr<TransportManager> tmgr,
+        std::shared_ptr<ConnectionManager> cmgr,
+        std::shared_ptr<ConnectionGater> gater);
+
     bool isStarted() const override;
 
     void start() override;
@@ -60,6 +69,7 @@ namespace libp2p::network {
     std::shared_ptr<network::Router> router_;
     std::shared_ptr<TransportManager> tmgr_;
     std::shared_ptr<ConnectionManager> cmgr_;
+    std::shared_ptr<ConnectionGater> gater_;
   };
 
 }  // namespace libp2p::network
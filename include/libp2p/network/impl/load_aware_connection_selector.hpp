@@ -0,0 +1,30 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <libp2p/network/connection_selector.hpp>
+
+namespace libp2p::network {
+
+  /**
+   * Prefers direct connections over relayed ones, then connection with
+   * noticeably lower round trip time, then the least loaded one by open
+   * streams and queued bytes
+   */
+  class LoadAwareConnectionSelector : public ConnectionSelector {
+   public:
+    /// Round trip times closer than by this ratio are considered equal
+    static constexpr double kRttTolerance = 1.25;
+
+    /// Queued bytes which weigh as much as one open stream
+    static constexpr size_t kBytesPerStream = 64 * 1024;
+
+    ConnectionSPtr select(
+        std::span<const ConnectionSPtr> connections) const override;
+  };
+
+}  // namespace libp2p::network
@@ -6,11 +6,18 @@
 
 #pragma once
 
-#include <tsl/htrie_map.h>
+#include <map>
+#include <unordered_map>
+
 #include <libp2p/network/router.hpp>
 
 namespace libp2p::network {
 
+  /**
+   * Protocol names are interned when handlers are set. Exact matches are
+   * looked up in hash table by string_view, predicates are only tried when
+   * there is no exact match
+   */
   class RouterImpl : public Router {
    public:
     ~RouterImpl() override = default;
@@ -21,11 +28,14 @@ namespace libp2p::network {
 
     std::vector<peer::ProtocolName> getSupportedProtocols() const override;
 
+    std::shared_ptr<const StreamProtocols> getSupportedProtocolsShared()
+        const override;
+
     void removeProtocolHandlers(const peer::ProtocolName &protocol) override;
 
     void removeAll() override;
 
-    enum class Error { NO_HANDLER_FOUND = 1 };
+    enum class Error { NO_HANDLER_FOUND = 1, STREAM_LIMIT_EXCEEDED };
 
     outcome::result<void> handle(
         const peer::ProtocolName &p,
@@ -36,7 +46,25 @@ namespace libp2p::network {
       ProtocolPredicate predicate;
       StreamAndProtocolCb handler;
     };
-    tsl::htrie_map<char, PredicateAndHandler> proto_handlers_;
+    using Handlers =
+        std::map<peer::ProtocolName, PredicateAndHandler, std::less<>>;
+
+    /// Rebuilds lookup tables after handlers change
+    void update();
+
+    /// Handler of the longest protocol, which is a prefix of p
+    Handlers::const_iterator longestPrefix(std::string_view p) const;
+
+    /// Owns interned names, map nodes keep views stable
+    Handlers handlers_;
+
+    std::unordered_map<std::string_view, Handlers::const_iterator> exact_;
+
+    /// Handlers with predicate, for fallback matching
+    std::vector<Handlers::const_iterator> predicates_;
+
+    std::shared_ptr<const StreamProtocols> protocols_ =
+        std::make_shared<const StreamProtocols>();
   };
 
 }  // namespace libp2p::network
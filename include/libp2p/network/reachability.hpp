@@ -0,0 +1,31 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <libp2p/event/bus.hpp>
+#include <libp2p/multi/multiaddress.hpp>
+
+namespace libp2p::network {
+  /// Whether other peers can dial our address
+  enum class Reachability {
+    UNKNOWN,
+    PUBLIC,
+    PRIVATE,
+  };
+
+  struct AddressReachability {
+    multi::Multiaddress address;
+    Reachability reachability;
+  };
+}  // namespace libp2p::network
+
+namespace libp2p::event::network {
+  /// Reachability of our address changed, as confirmed by other peers
+  using AddressReachabilityChannel =
+      channel_decl<struct AddressReachabilityChanged,
+                   libp2p::network::AddressReachability>;
+}  // namespace libp2p::event::network
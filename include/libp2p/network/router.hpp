@@ -55,6 +55,15 @@ namespace libp2p::network {
      */
     virtual std::vector<peer::ProtocolName> getSupportedProtocols() const = 0;
 
+    /**
+     * Get handled protocols without copying them, for every inbound stream
+     * @return immutable list, which is replaced when handlers change
+     */
+    virtual std::shared_ptr<const StreamProtocols> getSupportedProtocolsShared()
+        const {
+      return std::make_shared<const StreamProtocols>(getSupportedProtocols());
+    }
+
     /**
      * Remove handlers, associated with the given protocol prefix
      * @param protocol prefix, for which the handlers are to be removed
@@ -7,6 +7,7 @@
 #pragma once
 
 #include <chrono>
+#include <optional>
 #include <unordered_set>
 #include <vector>
 
@@ -42,6 +43,28 @@ namespace libp2p::peer {
 
   }  // namespace ttl
 
+  /**
+   * Outcomes of dials to one address of peer, used to rank addresses and to
+   * back off from failing ones
+   */
+  struct DialStats {
+    size_t successes = 0;
+    size_t failures = 0;
+    /// Failures since last success, backoff doubles with each of them
+    size_t consecutive_failures = 0;
+    std::optional<std::chrono::steady_clock::time_point> last_failure;
+    /// Smoothed connect latency of successful dials
+    std::optional<std::chrono::milliseconds> latency;
+    /// Address should not be dialed before this time, unless it is the only
+    /// one left
+    std::chrono::steady_clock::time_point backoff_until{};
+
+    double successRate() const {
+      auto total = successes + failures;
+      return total == 0 ? 0 : static_cast<double>(successes) / total;
+    }
+  };
+
   /**
    * @brief Address Repository is a storage of multiaddresses for observed
    * peers.
@@ -130,6 +153,23 @@ namespace libp2p::peer {
     virtual void dialFailed(const PeerId &peer_id,
                             const Multiaddress &addr) = 0;
 
+    /**
+     * Move connected address to front, and remember its connect latency.
+     */
+    virtual void dialSucceeded(const PeerId &peer_id,
+                               const Multiaddress &addr,
+                               Milliseconds latency) {}
+
+    /**
+     * @brief Get dial outcomes of address {@param addr} of peer {@param
+     * peer_id}, for dialer to order addresses
+     * @return stats, or none if address is unknown
+     */
+    virtual std::optional<DialStats> dialStats(
+        const PeerId &peer_id, const Multiaddress &addr) const {
+      return std::nullopt;
+    }
+
     /**
      * @brief Get all addresses associated with this Peer {@param p}. May
      * contain duplicates.
@@ -140,6 +180,15 @@ namespace libp2p::peer {
     virtual outcome::result<std::vector<multi::Multiaddress>> getAddresses(
         const PeerId &p) const = 0;
 
+    /**
+     * @brief Get addresses of Peer {@param p} without copying them.
+     * @param p peer
+     * @return addresses in dial order, empty if peer is not found. View is
+     * valid until repository is modified
+     */
+    virtual std::span<const multi::Multiaddress> peekAddresses(
+        const PeerId &p) const = 0;
+
     /**
      * @brief Clear all addresses of given Peer {@param p}. Does not evict peer
      * from the list of known peers up to the next garbage collection.
@@ -9,11 +9,14 @@
 #include <libp2p/peer/address_repository.hpp>
 
 #include <memory>
+#include <optional>
+#include <queue>
 #include <set>
 #include <unordered_map>
 #include <vector>
 
 #include <libp2p/network/dnsaddr_resolver.hpp>
+#include <libp2p/peer/peer_index.hpp>
 
 namespace libp2p::peer {
 
@@ -25,6 +28,9 @@ namespace libp2p::peer {
 
   /**
    * @brief IN-memory implementation of Address repository.
+   * Addresses of peer are kept in flat vector in dial order, expiration of
+   * peers is indexed by heap, so garbage collection visits only peers with
+   * expired addresses.
    */
   class InmemAddressRepository
       : public AddressRepository,
@@ -32,9 +38,18 @@ namespace libp2p::peer {
    public:
     static constexpr auto kDefaultTtl = std::chrono::milliseconds(1000);
 
+    /// Backoff after first failure of address, doubled by each next one
+    static constexpr auto kDialBackoff = std::chrono::seconds(1);
+    static constexpr auto kMaxDialBackoff = std::chrono::minutes(10);
+
     explicit InmemAddressRepository(
         std::shared_ptr<network::DnsaddrResolver> dnsaddr_resolver);
 
+    /// @param index is updated with peers having entries in repository
+    InmemAddressRepository(
+        std::shared_ptr<network::DnsaddrResolver> dnsaddr_resolver,
+        std::shared_ptr<PeerIndex> index);
+
     void bootstrap(const multi::Multiaddress &ma,
                    std::function<BootstrapCallback> cb) override;
 
@@ -52,9 +67,19 @@ namespace libp2p::peer {
 
     void dialFailed(const PeerId &peer_id, const Multiaddress &addr) override;
 
+    void dialSucceeded(const PeerId &peer_id,
+                       const Multiaddress &addr,
+                       Milliseconds latency) override;
+
+    std::optional<DialStats> dialStats(const PeerId &peer_id,
+                                       const Multiaddress &addr) const override;
+
     outcome::result<std::vector<multi::Multiaddress>> getAddresses(
         const PeerId &p) const override;
 
+    std::span<const multi::Multiaddress> peekAddresses(
+        const PeerId &p) const override;
+
     void collectGarbage() override;
 
     void clear(const PeerId &p) override;
@@ -63,17 +88,49 @@ namespace libp2p::peer {
 
    private:
     struct Peer {
-      std::unordered_map<Multiaddress, Clock::time_point> expires;
-      std::vector<Multiaddress> order;
-
-      bool eraseOrder(const Multiaddress &addr);
+      /// Addresses in dial order
+      std::vector<Multiaddress> addresses;
+      /// Expiration time of `addresses[i]`
+      std::vector<Clock::time_point> expires;
+      /// Dial outcomes of `addresses[i]`
+      std::vector<DialStats> stats;
+      /// Time of entry of this peer in `expiry_`
+      std::optional<Clock::time_point> scheduled;
+
+      std::optional<size_t> find(const Multiaddress &addr) const;
+      void erase(size_t i);
+      void moveToFront(size_t i);
+      void moveToBack(size_t i);
     };
     using peer_db = std::unordered_map<PeerId, Peer>;
 
+    struct Expiry {
+      Clock::time_point at;
+      PeerId peer;
+
+      bool operator>(const Expiry &other) const {
+        return at > other.at;
+      }
+    };
+
+    /// Saturates at max time point, for permanent addresses
+    static Clock::time_point expiresAt(Milliseconds ttl);
+
+    /// Ensures peer is visited by garbage collection when its first address
+    /// expires, or on next collection if it has no addresses
+    void schedule(const PeerId &peer_id, Peer &peer);
+
     bool isNewDnsAddr(const multi::Multiaddress &ma);
 
+    /// Entry of peer, created and indexed if missing
+    Peer &emplace(const PeerId &peer_id);
+
     std::shared_ptr<network::DnsaddrResolver> dnsaddr_resolver_;
+    std::shared_ptr<PeerIndex> index_;
     peer_db db_;
+    /// Earliest expiration on top, entries not matching `Peer::scheduled`
+    /// are stale and skipped
+    std::priority_queue<Expiry, std::vector<Expiry>, std::greater<>> expiry_;
     std::set<multi::Multiaddress> resolved_dns_addrs_;
   };
 
@@ -6,7 +6,9 @@
 
 #pragma once
 
+#include <libp2p/crypto/crypto_provider.hpp>
 #include <libp2p/crypto/key.hpp>
+#include <libp2p/crypto/protobuf/protobuf_key.hpp>
 #include <libp2p/event/bus.hpp>
 #include <libp2p/peer/peer_id.hpp>
 
@@ -28,6 +30,18 @@ namespace libp2p::peer {
     virtual const peer::PeerId &getId() const = 0;
 
     virtual const crypto::KeyPair &getKeyPair() const = 0;
+
+    /**
+     * Private key of getKeyPair() prepared once, so that signatures of
+     * handshakes and messages don't expand the key each time
+     */
+    virtual const crypto::SigningKey &getSigningKey() const = 0;
+
+    /**
+     * Public key of getKeyPair() in protobuf, marshalled once, so that
+     * handshakes and identify messages reference the same bytes
+     */
+    virtual const crypto::ProtobufKey &getMarshalledPublicKey() const = 0;
   };
 
 }  // namespace libp2p::peer
@@ -20,13 +20,25 @@ namespace libp2p::peer {
         crypto::KeyPair keyPair,
         const std::shared_ptr<crypto::marshaller::KeyMarshaller> &marshaller);
 
+    /// Prepares signing key with crypto provider
+    IdentityManagerImpl(
+        crypto::KeyPair keyPair,
+        const std::shared_ptr<crypto::marshaller::KeyMarshaller> &marshaller,
+        const std::shared_ptr<crypto::CryptoProvider> &crypto_provider);
+
     const peer::PeerId &getId() const override;
 
     const crypto::KeyPair &getKeyPair() const override;
 
+    const crypto::SigningKey &getSigningKey() const override;
+
+    const crypto::ProtobufKey &getMarshalledPublicKey() const override;
+
    private:
     std::unique_ptr<peer::PeerId> id_;
     std::unique_ptr<crypto::KeyPair> keyPair_;
+    std::unique_ptr<crypto::ProtobufKey> marshalledPublicKey_;
+    std::shared_ptr<const crypto::SigningKey> signingKey_;
   };
 
 }  // namespace libp2p::peer
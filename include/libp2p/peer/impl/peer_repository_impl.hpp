@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <libp2p/peer/peer_index.hpp>
 #include <libp2p/peer/peer_repository.hpp>
 
 namespace libp2p::peer {
@@ -16,20 +17,39 @@ namespace libp2p::peer {
                        std::shared_ptr<KeyRepository> keyRepo,
                        std::shared_ptr<ProtocolRepository> protocolRepo);
 
+    PeerRepositoryImpl(std::shared_ptr<AddressRepository> addrRepo,
+                       std::shared_ptr<KeyRepository> keyRepo,
+                       std::shared_ptr<ProtocolRepository> protocolRepo,
+                       std::shared_ptr<LatencyRepository> latencyRepo);
+
+    /// @param index is shared with the repositories, peers are enumerated by
+    /// it instead of merging their sets
+    PeerRepositoryImpl(std::shared_ptr<AddressRepository> addrRepo,
+                       std::shared_ptr<KeyRepository> keyRepo,
+                       std::shared_ptr<ProtocolRepository> protocolRepo,
+                       std::shared_ptr<LatencyRepository> latencyRepo,
+                       std::shared_ptr<PeerIndex> index);
+
     AddressRepository &getAddressRepository() override;
 
     KeyRepository &getKeyRepository() override;
 
     ProtocolRepository &getProtocolRepository() override;
 
+    LatencyRepository &getLatencyRepository() override;
+
     std::unordered_set<PeerId> getPeers() const override;
 
+    void forEachPeer(const PeerVisitor &visitor) const override;
+
     PeerInfo getPeerInfo(const PeerId &peer_id) const override;
 
    private:
     std::shared_ptr<AddressRepository> addr_;
     std::shared_ptr<KeyRepository> key_;
     std::shared_ptr<ProtocolRepository> proto_;
+    std::shared_ptr<LatencyRepository> latency_;
+    std::shared_ptr<PeerIndex> index_;
   };
 
 }  // namespace libp2p::peer
@@ -0,0 +1,117 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <libp2p/peer/peer_repository.hpp>
+
+#include <chrono>
+#include <limits>
+#include <unordered_set>
+
+#include <libp2p/basic/scheduler.hpp>
+#include <libp2p/log/logger.hpp>
+#include <libp2p/storage/sqlite_reader_pool.hpp>
+#include <libp2p/storage/sqlite_writer.hpp>
+
+namespace libp2p::peer {
+
+  /**
+   * Peer repository, which keeps addresses, public keys and protocols of
+   * peers in SQLite, so that the node dials known peers right after restart.
+   * In-memory repository stays primary storage, changed peers are written
+   * behind by SQLiteWriter once per interval.
+   * On start most recently seen peers are loaded at once, the rest are
+   * loaded by batches on scheduler. Readers must be opened after writer, as
+   * writer creates database
+   */
+  class PersistentPeerRepository
+      : public PeerRepository,
+        public std::enable_shared_from_this<PersistentPeerRepository> {
+   public:
+    struct Config {
+      /// Interval of writing changed peers
+      std::chrono::milliseconds flush_interval = std::chrono::seconds(10);
+
+      /// Peers loaded at once on start, and by each next batch
+      size_t hot_peers = 256;
+      size_t load_batch = 1024;
+
+      /// TTL of loaded addresses
+      std::chrono::milliseconds address_ttl = ttl::kDay;
+    };
+
+    PersistentPeerRepository(const Config &config,
+                             std::shared_ptr<PeerRepository> repository,
+                             std::shared_ptr<storage::SQLiteWriter> writer,
+                             std::shared_ptr<storage::SQLiteReaderPool> readers,
+                             std::shared_ptr<basic::Scheduler> scheduler);
+
+    /// Writes changed peers
+    ~PersistentPeerRepository() override;
+
+    /// Creates table, loads hot peers, schedules loading of the rest
+    void start();
+
+    /**
+     * Marks peer to be written on next flush. Changes of addresses are
+     * tracked by signals, changes of keys and protocols are to be reported,
+     * e.g. by identify
+     */
+    void markChanged(const PeerId &peer_id);
+
+    /// Writes changed peers
+    void flush();
+
+    AddressRepository &getAddressRepository() override;
+
+    KeyRepository &getKeyRepository() override;
+
+    ProtocolRepository &getProtocolRepository() override;
+
+    LatencyRepository &getLatencyRepository() override;
+
+    std::unordered_set<PeerId> getPeers() const override;
+
+    void forEachPeer(const PeerVisitor &visitor) const override;
+
+    PeerInfo getPeerInfo(const PeerId &peer_id) const override;
+
+   private:
+    /// Prepared statements, used on writer thread only
+    struct Statements;
+
+    /// Loads next `limit` most recently seen peers, false if none are left
+    bool load(size_t limit);
+
+    void loadNext();
+    void setFlushTimer();
+
+    Config config_;
+    std::shared_ptr<PeerRepository> repository_;
+    std::shared_ptr<storage::SQLiteWriter> writer_;
+    std::shared_ptr<storage::SQLiteReaderPool> readers_;
+    std::shared_ptr<basic::Scheduler> scheduler_;
+
+    std::unordered_set<PeerId> changed_;
+    boost::signals2::scoped_connection on_address_added_;
+    boost::signals2::scoped_connection on_address_removed_;
+
+    std::shared_ptr<Statements> statements_;
+
+    // Loaded peers don't count as changed. Peers are loaded in order of
+    // (last seen, id) descending, starting below the last loaded one
+    bool loading_ = false;
+    int64_t cursor_seen_ = std::numeric_limits<int64_t>::max();
+    Bytes cursor_peer_;
+
+    basic::Scheduler::Handle load_timer_;
+    basic::Scheduler::Handle flush_timer_;
+
+    log::Logger log_;
+  };
+
+}  // namespace libp2p::peer
@@ -10,6 +10,7 @@
 
 #include <libp2p/crypto/key.hpp>
 #include <libp2p/peer/key_repository.hpp>
+#include <libp2p/peer/peer_index.hpp>
 
 namespace libp2p::peer {
 
@@ -19,6 +20,9 @@ namespace libp2p::peer {
 
     InmemKeyRepository();
 
+    /// @param index is updated with peers having public keys
+    explicit InmemKeyRepository(std::shared_ptr<PeerIndex> index);
+
     void clear(const PeerId &p) override;
 
     outcome::result<PubVecPtr> getPublicKeys(const PeerId &p) override;
@@ -35,6 +39,7 @@ namespace libp2p::peer {
    private:
     std::unordered_map<PeerId, PubVecPtr> pub_;
     KeyPairVecPtr kp_;
+    std::shared_ptr<PeerIndex> index_;
   };
 
 }  // namespace libp2p::peer
@@ -0,0 +1,86 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <optional>
+#include <unordered_set>
+
+#include <libp2p/peer/peer_id.hpp>
+
+namespace libp2p::peer {
+
+  /**
+   * @brief Round trip time statistics of a peer.
+   */
+  struct Latency {
+    using Milliseconds = std::chrono::duration<double, std::milli>;
+
+    /// upper bounds of histogram buckets, last bucket counts slower samples
+    static constexpr std::array<std::chrono::milliseconds, 10> kBucketBounds{
+        std::chrono::milliseconds{1},
+        std::chrono::milliseconds{2},
+        std::chrono::milliseconds{5},
+        std::chrono::milliseconds{10},
+        std::chrono::milliseconds{20},
+        std::chrono::milliseconds{50},
+        std::chrono::milliseconds{100},
+        std::chrono::milliseconds{200},
+        std::chrono::milliseconds{500},
+        std::chrono::milliseconds{1000},
+    };
+
+    /// weight of the newest sample in exponentially weighted moving average
+    static constexpr double kEwmaSmoothing = 0.1;
+
+    /// moving average, which peer selection should compare
+    Milliseconds ewma{};
+
+    /// most recent sample
+    std::chrono::milliseconds last{};
+
+    uint64_t samples = 0;
+
+    std::array<uint32_t, kBucketBounds.size() + 1> histogram{};
+  };
+
+  /**
+   * @brief Storage of round trip times measured to peers, e.g. by Ping.
+   */
+  class LatencyRepository {
+   public:
+    virtual ~LatencyRepository() = default;
+
+    /**
+     * @brief Add round trip time measurement of a peer.
+     * @param p peer
+     * @param rtt measured time
+     */
+    virtual void recordRtt(const PeerId &p, std::chrono::milliseconds rtt) = 0;
+
+    /**
+     * @brief Get latency statistics of a peer.
+     * @param p peer
+     * @return statistics or none, if latency of peer was never measured
+     */
+    virtual std::optional<Latency> getLatency(const PeerId &p) const = 0;
+
+    /**
+     * @brief Forget measurements of a peer.
+     * @param p peer
+     */
+    virtual void clear(const PeerId &p) = 0;
+
+    /**
+     * @brief Returns set of peer ids known by this repository.
+     * @return unordered set of peers
+     */
+    virtual std::unordered_set<PeerId> getPeers() const = 0;
+  };
+
+}  // namespace libp2p::peer
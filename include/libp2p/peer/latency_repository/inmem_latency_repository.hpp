@@ -0,0 +1,34 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <unordered_map>
+
+#include <libp2p/peer/latency_repository.hpp>
+
+namespace libp2p::peer {
+
+  /**
+   * @brief In-memory implementation of Latency repository.
+   */
+  class InmemLatencyRepository : public LatencyRepository {
+   public:
+    ~InmemLatencyRepository() override = default;
+
+    void recordRtt(const PeerId &p, std::chrono::milliseconds rtt) override;
+
+    std::optional<Latency> getLatency(const PeerId &p) const override;
+
+    void clear(const PeerId &p) override;
+
+    std::unordered_set<PeerId> getPeers() const override;
+
+   private:
+    std::unordered_map<PeerId, Latency> latencies_;
+  };
+
+}  // namespace libp2p::peer
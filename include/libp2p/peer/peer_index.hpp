@@ -0,0 +1,62 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+
+#include <libp2p/peer/peer_id.hpp>
+
+namespace libp2p::peer {
+
+  /**
+   * Peers stored by address, key and protocol repositories, shared by them,
+   * so peer repository enumerates peers without merging copies of their sets.
+   * Each repository marks peers it stores by its own bit, and peer is removed
+   * from index when no repository stores it.
+   * Not thread-safe, as the repositories.
+   */
+  class PeerIndex {
+   public:
+    enum Source : uint8_t {
+      ADDRESS = 1 << 0,
+      KEY = 1 << 1,
+      PROTOCOL = 1 << 2,
+    };
+
+    void add(const PeerId &peer, Source source) {
+      peers_[peer] |= source;
+    }
+
+    void remove(const PeerId &peer, Source source) {
+      auto it = peers_.find(peer);
+      if (it == peers_.end()) {
+        return;
+      }
+      it->second &= ~source;
+      if (it->second == 0) {
+        peers_.erase(it);
+      }
+    }
+
+    /// Visits peers in place, visitor must not modify the repositories
+    template <typename F>
+    void forEach(const F &visitor) const {
+      for (const auto &[peer, sources] : peers_) {
+        visitor(peer);
+      }
+    }
+
+    size_t size() const {
+      return peers_.size();
+    }
+
+   private:
+    std::unordered_map<PeerId, uint8_t> peers_;
+  };
+
+}  // namespace libp2p::peer
@@ -6,10 +6,12 @@
 
 #pragma once
 
+#include <functional>
 #include <memory>
 
 #include <libp2p/peer/address_repository.hpp>
 #include <libp2p/peer/key_repository.hpp>
+#include <libp2p/peer/latency_repository.hpp>
 #include <libp2p/peer/peer_id.hpp>
 #include <libp2p/peer/peer_info.hpp>
 #include <libp2p/peer/protocol_repository.hpp>
@@ -20,6 +22,8 @@ namespace libp2p::peer {
    * this peer.
    */
   struct PeerRepository {
+    using PeerVisitor = std::function<void(const PeerId &)>;
+
     virtual ~PeerRepository() = default;
 
     /**
@@ -40,12 +44,29 @@ namespace libp2p::peer {
      */
     virtual ProtocolRepository &getProtocolRepository() = 0;
 
+    /**
+     * @brief Getter for a latency repository.
+     * @return associated instance of a latency repository.
+     */
+    virtual LatencyRepository &getLatencyRepository() = 0;
+
     /**
      * @brief Returns set of peer ids known by this peer repository.
      * @return unordered set of peers
      */
     virtual std::unordered_set<PeerId> getPeers() const = 0;
 
+    /**
+     * @brief Calls visitor once for each peer known by this peer repository,
+     * without copying set of peers. Visitor must not modify the repositories.
+     * @param visitor called with each peer
+     */
+    virtual void forEachPeer(const PeerVisitor &visitor) const {
+      for (const auto &peer : getPeers()) {
+        visitor(peer);
+      }
+    }
+
     /**
      * @brief Derive a PeerInfo object from the PeerId; can be useful, for
      * example, to establish connections, when only a PeerId is known at the
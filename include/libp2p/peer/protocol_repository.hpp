@@ -7,6 +7,7 @@
 #pragma once
 
 #include <set>
+#include <string_view>
 #include <unordered_set>
 
 #include <libp2p/basic/garbage_collectable.hpp>
@@ -17,6 +18,8 @@ namespace libp2p::peer {
 
   /**
    * @brief Storage for mapping between peer and its known protocols.
+   * Returned protocol names view into repository, they stay valid until it
+   * is modified.
    */
   class ProtocolRepository : public basic::GarbageCollectable {
    public:
@@ -46,7 +49,7 @@ namespace libp2p::peer {
      * @return list of protocols (may be empty) or peer error, if no peer
      * @param p} found
      */
-    virtual outcome::result<std::vector<ProtocolName>> getProtocols(
+    virtual outcome::result<std::vector<std::string_view>> getProtocols(
         const PeerId &p) const = 0;
 
     /**
@@ -54,10 +57,10 @@ namespace libp2p::peer {
      * protocols.
      * @param p peer
      * @param protocols check if given protocols are supported by a peer
-     * @return list of supported protocols (may be empty) or peer error, if no
-     * peer {@param p} found
+     * @return ordered list of supported protocols (may be empty) or peer
+     * error, if no peer {@param p} found
      */
-    virtual outcome::result<std::vector<ProtocolName>> supportsProtocols(
+    virtual outcome::result<std::vector<std::string_view>> supportsProtocols(
         const PeerId &p, const std::set<ProtocolName> &protocols) const = 0;
 
     /**
@@ -6,19 +6,27 @@
 
 #pragma once
 
-#include <set>
+#include <deque>
+#include <optional>
 #include <unordered_map>
 
+#include <libp2p/peer/peer_index.hpp>
 #include <libp2p/peer/protocol_repository.hpp>
 
 namespace libp2p::peer {
 
   /**
-   * @brief In-memory implementation of Protocol repository. For each peer
-   * stores ordered set of protocols.
+   * @brief In-memory implementation of Protocol repository. Protocol names
+   * are interned to small integer ids, for each peer stores bitset of ids of
+   * protocols it supports.
    */
   class InmemProtocolRepository : public ProtocolRepository {
    public:
+    InmemProtocolRepository() = default;
+
+    /// @param index is updated with peers having entries in repository
+    explicit InmemProtocolRepository(std::shared_ptr<PeerIndex> index);
+
     ~InmemProtocolRepository() override = default;
 
     outcome::result<void> addProtocols(
@@ -27,27 +35,41 @@ namespace libp2p::peer {
     outcome::result<void> removeProtocols(
         const PeerId &p, std::span<const ProtocolName> ms) override;
 
-    outcome::result<std::vector<ProtocolName>> getProtocols(
+    outcome::result<std::vector<std::string_view>> getProtocols(
         const PeerId &p) const override;
 
-    outcome::result<std::vector<ProtocolName>> supportsProtocols(
+    outcome::result<std::vector<std::string_view>> supportsProtocols(
         const PeerId &p,
         const std::set<ProtocolName> &protocols) const override;
 
     void clear(const PeerId &p) override;
 
+    /// Also releases ids of protocols no peer supports
     void collectGarbage() override;
 
     std::unordered_set<PeerId> getPeers() const override;
 
    private:
-    using set = std::set<ProtocolName>;
-    using set_ptr = std::shared_ptr<set>;
+    using ProtocolId = size_t;
+    /// Bit `id % 64` of word `id / 64` is set if protocol is supported
+    using ProtocolBits = std::vector<uint64_t>;
+
+    static bool test(const ProtocolBits &bits, ProtocolId id);
+
+    ProtocolId intern(const ProtocolName &name);
+    std::optional<ProtocolId> find(std::string_view name) const;
+
+    outcome::result<const ProtocolBits *> getProtocolBits(
+        const PeerId &p) const;
 
-    outcome::result<set_ptr> getProtocolSet(const PeerId &p) const;
-    set_ptr getOrAllocateProtocolSet(const PeerId &p);
+    /// Keys view into `names_`, deque keeps them in place
+    std::unordered_map<std::string_view, ProtocolId> ids_;
+    std::deque<ProtocolName> names_;
+    /// Ids released by collectGarbage, not in `ids_`
+    std::vector<ProtocolId> free_ids_;
 
-    std::unordered_map<PeerId, set_ptr> db_;
+    std::unordered_map<PeerId, ProtocolBits> db_;
+    std::shared_ptr<PeerIndex> index_;
   };
 
 }  // namespace libp2p::peer
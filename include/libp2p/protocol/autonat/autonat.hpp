@@ -0,0 +1,101 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <unordered_map>
+
+#include <libp2p/basic/scheduler.hpp>
+#include <libp2p/event/bus.hpp>
+#include <libp2p/host/host.hpp>
+#include <libp2p/network/reachability.hpp>
+#include <libp2p/network/transport_manager.hpp>
+#include <libp2p/protocol/autonat/config.hpp>
+#include <libp2p/protocol/base_protocol.hpp>
+
+namespace libp2p::basic {
+  class ProtobufMessageReadWriter;
+}  // namespace libp2p::basic
+
+namespace autonat::pb {
+  class Message;
+}  // namespace autonat::pb
+
+namespace libp2p::protocol::autonat {
+  /**
+   * AutoNAT v1 client and server.
+   * Client asks connected peers to dial its candidate addresses back, and
+   * publishes reachability of addresses to event bus, so that host doesn't
+   * advertise unreachable ones in identify and kademlia.
+   * Server dials back only addresses with the same IP, which it observes
+   * client connected from, with fresh connections, which are closed at once.
+   */
+  class Autonat : public BaseProtocol,
+                  public std::enable_shared_from_this<Autonat> {
+   public:
+    /// Receives our address, which server dialed back
+    using ProbeCb = std::function<void(outcome::result<Multiaddress>)>;
+
+    Autonat(Host &host,
+            event::Bus &bus,
+            std::shared_ptr<network::TransportManager> transports,
+            std::shared_ptr<basic::Scheduler> scheduler,
+            AutonatConfig config = {});
+
+    peer::ProtocolName getProtocolId() const override;
+
+    /// Serves dial request of client
+    void handle(StreamAndProtocol stream) override;
+
+    /// Sets protocol handler to serve dial requests
+    void start();
+
+    /// Asks server to dial our candidate addresses back
+    void probe(const PeerId &server, ProbeCb cb);
+
+    network::Reachability reachability(const Multiaddress &address) const;
+
+   private:
+    using ReadWriter = basic::ProtobufMessageReadWriter;
+
+    struct DialBack;
+
+    /// Reachability of our address, changed by enough opposite observations
+    struct Status {
+      network::Reachability reachability = network::Reachability::UNKNOWN;
+      size_t confidence = 0;
+    };
+
+    void onDial(std::shared_ptr<connection::Stream> stream,
+                std::shared_ptr<ReadWriter> rw,
+                const ::autonat::pb::Message &msg);
+
+    /// Dials next address of client, responds if none is left
+    void dialBack(std::shared_ptr<DialBack> dial);
+
+    void finishDial(std::shared_ptr<DialBack> dial,
+                    const ::autonat::pb::Message &response);
+
+    void onResponse(const std::vector<Multiaddress> &addresses,
+                    const ::autonat::pb::Message &msg,
+                    const ProbeCb &cb);
+
+    void observe(const Multiaddress &address,
+                 network::Reachability reachability);
+
+    /// Listen and observed addresses, which are neither relayed nor
+    /// unspecified
+    std::vector<Multiaddress> candidates() const;
+
+    Host &host_;
+    event::Bus &bus_;
+    std::shared_ptr<network::TransportManager> transports_;
+    std::shared_ptr<basic::Scheduler> scheduler_;
+    AutonatConfig config_;
+    size_t dials_ = 0;
+    std::unordered_map<Multiaddress, Status> status_;
+  };
+}  // namespace libp2p::protocol::autonat
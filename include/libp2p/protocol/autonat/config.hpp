@@ -0,0 +1,33 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+
+namespace libp2p::protocol::autonat {
+  const std::string kAutonatProto = "/libp2p/autonat/1.0.0";
+
+  struct AutonatConfig {
+    /// dial backs served at once
+    size_t max_dials = 8;
+
+    /// how long server may take to dial one address back
+    std::chrono::milliseconds dial_timeout = std::chrono::seconds{15};
+
+    /// how long probe may take, including dial backs
+    std::chrono::milliseconds timeout = std::chrono::seconds{60};
+
+    /// addresses sent to server and accepted from client
+    size_t max_addresses = 16;
+
+    /// observations opposite to the current reachability of address, which
+    /// are needed to change it
+    size_t max_confidence = 3;
+  };
+}  // namespace libp2p::protocol::autonat
@@ -0,0 +1,38 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <qtils/enum_error_code.hpp>
+
+namespace libp2p {
+  enum class AutonatError {
+    DIAL_ERROR,
+    DIAL_REFUSED,
+    BAD_REQUEST,
+    INTERNAL_ERROR,
+    NO_ADDRESSES,
+    UNEXPECTED_MESSAGE,
+  };
+  Q_ENUM_ERROR_CODE(AutonatError) {
+    using E = decltype(e);
+    switch (e) {
+      case E::DIAL_ERROR:
+        return "Server failed to dial our addresses back";
+      case E::DIAL_REFUSED:
+        return "Server refused to dial our addresses back";
+      case E::BAD_REQUEST:
+        return "Server rejected dial request";
+      case E::INTERNAL_ERROR:
+        return "Server internal error";
+      case E::NO_ADDRESSES:
+        return "No addresses to check reachability of";
+      case E::UNEXPECTED_MESSAGE:
+        return "Unexpected AutoNAT message";
+    }
+    abort();
+  }
+}  // namespace libp2p
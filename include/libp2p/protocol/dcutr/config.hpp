@@ -0,0 +1,26 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+
+namespace libp2p::protocol::dcutr {
+  const std::string kDcutrProto = "/libp2p/dcutr";
+
+  struct DcutrConfig {
+    /// hole punching rounds before giving up
+    size_t max_attempts = 3;
+
+    /// how long one round of message exchange may take
+    std::chrono::milliseconds timeout = std::chrono::seconds{10};
+
+    /// addresses sent to peer and accepted from it
+    size_t max_addresses = 16;
+  };
+}  // namespace libp2p::protocol::dcutr
@@ -0,0 +1,83 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <libp2p/basic/scheduler.hpp>
+#include <libp2p/host/host.hpp>
+#include <libp2p/protocol/base_protocol.hpp>
+#include <libp2p/protocol/dcutr/config.hpp>
+
+namespace libp2p::basic {
+  class ProtobufMessageReadWriter;
+}  // namespace libp2p::basic
+
+namespace holepunch::pb {
+  class HolePunch;
+}  // namespace holepunch::pb
+
+namespace libp2p::protocol::dcutr {
+  /**
+   * Direct connection upgrade through relay.
+   * Peers connected through relay exchange their observed and listen
+   * addresses over relayed stream, measuring round trip time, then dial each
+   * other at the same moment, so that both NATs let the connection through.
+   * Once direct connection is up, connection manager prefers it for new
+   * streams and drains relayed one.
+   * Needs relayed connection to peer, i.e. transport for `/p2p-circuit`
+   * addresses, which secures and multiplexes streams of `RelayClient`.
+   * The library has no such transport yet, it is up to user to provide one.
+   */
+  class Dcutr : public BaseProtocol,
+                public std::enable_shared_from_this<Dcutr> {
+   public:
+    Dcutr(Host &host,
+          std::shared_ptr<basic::Scheduler> scheduler,
+          DcutrConfig config = {});
+
+    peer::ProtocolName getProtocolId() const override;
+
+    /// Responds to hole punching initiated by peer
+    void handle(StreamAndProtocol stream) override;
+
+    /// Sets protocol handler
+    void start();
+
+    /**
+     * Punches hole to peer, which is connected through relay.
+     * Called by peer, which accepted relayed connection
+     */
+    void upgrade(const PeerId &peer, Host::ConnectionResultHandler cb);
+
+   private:
+    using ReadWriter = basic::ProtobufMessageReadWriter;
+
+    struct Round;
+
+    /// Starts exchange of addresses
+    void attempt(std::shared_ptr<Round> round);
+
+    void onConnect(std::shared_ptr<Round> round,
+                   const ::holepunch::pb::HolePunch &msg);
+
+    /// Starts next round or reports error
+    void retry(std::shared_ptr<Round> round, std::error_code error);
+
+    /// Fails round of destroyed instance
+    static void abort(const std::shared_ptr<Round> &round);
+
+    /// Observed and listen addresses, which are not relayed
+    std::vector<Multiaddress> localAddresses() const;
+
+    /// Direct addresses sent by peer
+    std::vector<Multiaddress> remoteAddresses(
+        const ::holepunch::pb::HolePunch &msg) const;
+
+    Host &host_;
+    std::shared_ptr<basic::Scheduler> scheduler_;
+    DcutrConfig config_;
+  };
+}  // namespace libp2p::protocol::dcutr
@@ -0,0 +1,29 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <qtils/enum_error_code.hpp>
+
+namespace libp2p {
+  enum class DcutrError {
+    NO_ADDRESSES,
+    UNEXPECTED_MESSAGE,
+    TIMEOUT,
+  };
+  Q_ENUM_ERROR_CODE(DcutrError) {
+    using E = decltype(e);
+    switch (e) {
+      case E::NO_ADDRESSES:
+        return "No direct addresses to punch hole to";
+      case E::UNEXPECTED_MESSAGE:
+        return "Unexpected hole punching message";
+      case E::TIMEOUT:
+        return "Hole punching timeout";
+    }
+    abort();
+  }
+}  // namespace libp2p
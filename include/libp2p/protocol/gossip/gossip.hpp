@@ -8,21 +8,28 @@
 
 #include <chrono>
 #include <functional>
+#include <map>
 #include <set>
+#include <span>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include <boost/optional.hpp>
 
 #include <libp2p/common/byteutil.hpp>
+#include <libp2p/common/metrics/registry.hpp>
 #include <libp2p/multi/multiaddress.hpp>
 #include <libp2p/peer/peer_id.hpp>
 #include <libp2p/protocol/common/subscription.hpp>
+#include <libp2p/protocol/gossip/message_id.hpp>
+#include <libp2p/protocol/gossip/score_config.hpp>
 
 namespace libp2p {
   struct Host;
   namespace basic {
     class Scheduler;
+    class Codec;
   }
   namespace crypto {
     class CryptoProvider;
@@ -60,10 +67,25 @@ namespace libp2p::protocol::gossip {
     /// Read or write timeout per whole network operation
     std::chrono::milliseconds rw_timeout_msec{std::chrono::seconds(10)};
 
-    /// Lifetime of a message in message cache
+    /// Lifetime of a message in message cache, rounded up to whole
+    /// heartbeat intervals
     std::chrono::milliseconds message_cache_lifetime_msec{
         std::chrono::minutes(2)};
 
+    /// Number of the most recent heartbeat windows of message cache
+    /// announced to peers
+    size_t message_cache_gossip_windows = 3;
+
+    /// Lifetime of ids in probabilistic filter of seen messages, which keeps
+    /// rejecting duplicates after they leave message cache. Disabled if zero
+    std::chrono::milliseconds seen_filter_lifetime_msec{0};
+
+    /// Expected number of messages during seen filter lifetime
+    size_t seen_filter_capacity = 1'000'000;
+
+    /// Probability of seen filter to take a new message for a duplicate
+    double seen_filter_false_positive_rate = 1e-6;
+
     /// Topic's message seen cache lifetime
     std::chrono::milliseconds seen_cache_lifetime_msec{
         message_cache_lifetime_msec * 3 / 4};
@@ -71,18 +93,66 @@ namespace libp2p::protocol::gossip {
     /// Topic's seen cache limit
     unsigned seen_cache_limit = 100;
 
+    /// Mesh peers are asked not to send received messages with data of this
+    /// size or larger (gossipsub v1.2 IDONTWANT). Disabled if zero
+    size_t idontwant_message_size_threshold = 1024;
+
+    /// Time to keep IDONTWANT message ids received from peer
+    std::chrono::milliseconds idontwant_lifetime_msec{std::chrono::seconds(3)};
+
+    /// Max number of IDONTWANT message ids kept per peer
+    size_t idontwant_max_messages = 1000;
+
+    /// Max number of messages sent to peer in reply to IWANT per heartbeat
+    /// interval, further requests are ignored. Disabled if zero
+    size_t iwant_max_replies = 5000;
+
+    /// Worker threads for synchronous validators. If zero, validators are
+    /// called on the scheduler thread
+    size_t validation_threads = 0;
+
+    /// Max messages of a topic being validated at once. Reading from gossip
+    /// streams is paused while any topic is at the limit
+    size_t validation_queue_limit = 1024;
+
     /// Heartbeat interval
     std::chrono::milliseconds heartbeat_interval_msec{1000};
 
+    /// Heartbeat work is spread over this many ticks of the interval, each
+    /// tick maintains its share of topics round-robin. Not spread if one
+    size_t heartbeat_slices = 4;
+
     /// Ban interval between dial attempts to peer
     std::chrono::milliseconds ban_interval_msec{std::chrono::minutes(1)};
 
     /// Max number of dial attempts before peer is forgotten
     unsigned max_dial_attempts = 3;
 
+    /// Max number of other topic peers suggested in PRUNE, and dialed at once
+    /// from received PRUNE (gossipsub v1.1 peer exchange). Disabled if zero
+    size_t prune_peers = 16;
+
     /// Expiration of gossip peers' addresses in address repository
     std::chrono::milliseconds address_expiration_msec{std::chrono::hours(1)};
 
+    /// Low latency writes to peers are delayed for this window, so that
+    /// following ones are coalesced into one RPC per peer. Disabled if zero
+    std::chrono::milliseconds write_coalescing_window_msec{0};
+
+    /// Messages queued to peer are written regardless of the window or a
+    /// write in progress once they reach this size
+    size_t write_coalescing_bytes = 64 * 1024;
+
+    /// Bytes queued to slow peer beyond this are shed, IHAVE gossip first and
+    /// then forwarded messages. Control and own messages are never shed.
+    /// Disabled if zero
+    size_t max_pending_bytes = 4 << 20;
+
+    /// IHAVE and IDONTWANT are sent as unreliable datagrams over connections
+    /// supporting them (e.g. QUIC with datagrams), so that they are not
+    /// delayed by losses of stream data. Both may be lost, as they are hints
+    bool datagram_control = false;
+
     /// Max RPC message size
     size_t max_message_size = 1 << 24;
 
@@ -91,12 +161,21 @@ namespace libp2p::protocol::gossip {
 
     /// Sign published messages
     bool sign_messages = false;
+
+    /// Publish local messages to all topic subscribers with score above
+    /// publish threshold, not only to mesh
+    bool flood_publish = false;
+
+    /// Peer scoring
+    ScoreConfig score;
   };
 
   using TopicId = std::string;
   using TopicList = std::vector<TopicId>;
   using TopicSet = std::set<TopicId>;
 
+  class SubscriptionQueue;
+
   /// Gossip protocol interface
   class Gossip {
    public:
@@ -125,19 +204,52 @@ namespace libp2p::protocol::gossip {
       const Bytes &data;
     };
 
-    /// Validator of messages arriving from the wire
+    /// Validator of messages arriving from the wire. Called on worker threads
+    /// if `Config::validation_threads` is not zero
     using Validator = std::function<bool(const Bytes &from, const Bytes &data)>;
 
     /// Sets message validator for topic
     virtual void setValidator(const TopicId &topic, Validator validator) = 0;
 
-    /// Creates unique message ID out of message fields
-    using MessageIdFn = std::function<Bytes(
+    /// Outcome of message validation
+    enum class ValidationResult {
+      /// Message is delivered and forwarded
+      ACCEPT,
+      /// Message is dropped and its sender is penalized
+      REJECT,
+      /// Message is dropped
+      IGNORE,
+    };
+
+    using ValidationCallback = std::function<void(ValidationResult)>;
+
+    /// Asynchronous validator, `from` and `data` remain valid until callback
+    /// is called. Callback must be called on the scheduler thread
+    using AsyncValidator = std::function<void(
+        const Bytes &from, const Bytes &data, ValidationCallback cb)>;
+
+    /// Sets asynchronous message validator for topic
+    virtual void setAsyncValidator(const TopicId &topic,
+                                   AsyncValidator validator) = 0;
+
+    /// Creates unique message ID out of message fields. Hashing functions
+    /// should feed fields to hasher one by one and return digest, which is
+    /// stored inline, functions returning Bytes are still accepted
+    using MessageIdFn = std::function<MessageId(
         const Bytes &from, const Bytes &seq, const Bytes &data)>;
 
     /// Sets message ID funtion that differs from default (from+sec_no)
     virtual void setMessageIdFn(MessageIdFn fn) = 0;
 
+    /// Sets compression of topic data, all peers of topic must use the same
+    /// codec. Published data is compressed, data from the wire is
+    /// decompressed up to `Config::max_message_size` before validation, and
+    /// validators and subscribers get decompressed data. Message ids are
+    /// computed on compressed data, or on decompressed if `decoded_ids`
+    virtual void setCodec(const TopicId &topic,
+                          std::shared_ptr<basic::Codec> codec,
+                          bool decoded_ids = false) = 0;
+
     /// Empty message means EOS (end of subscription data stream)
     using SubscriptionData = boost::optional<const Message &>;
     using SubscriptionCallback = std::function<void(SubscriptionData)>;
@@ -146,8 +258,50 @@ namespace libp2p::protocol::gossip {
     virtual Subscription subscribe(TopicSet topics,
                                    SubscriptionCallback callback) = 0;
 
+    /// Subscribes to topics, messages are pushed to queue to be taken by
+    /// application threads instead of callback. Queue is closed when
+    /// subscription ends, EOS is not pushed
+    virtual Subscription subscribe(
+        TopicSet topics, std::shared_ptr<SubscriptionQueue> queue) = 0;
+
     /// Publishes to topics. Returns false if validation fails or not started
     virtual bool publish(TopicId topic, Bytes data) = 0;
+
+    /// Publishes messages to their topics at once, each peer gets all the
+    /// messages for it in one RPC. Topics and data are moved out.
+    /// Returns false if not started
+    virtual bool publishMany(std::span<std::pair<TopicId, Bytes>> messages) = 0;
+
+    /// Sets application specific score of peer (P5 of peer score)
+    virtual void setAppScore(const peer::PeerId &peer, double score) = 0;
+
+    /// Returns current score of peer, zero if scoring is disabled
+    virtual double peerScore(const peer::PeerId &peer) const = 0;
+
+    /// Delivery counters of topic
+    struct TopicStats {
+      /// Messages received from peers, including duplicates
+      uint64_t received = 0;
+      /// Messages from peers accepted and delivered to local subscribers
+      uint64_t delivered = 0;
+      uint64_t duplicates = 0;
+      /// Messages rejected by validator or failed to decompress
+      uint64_t invalid = 0;
+      /// Wire data size of messages received from peers
+      uint64_t bytes_in = 0;
+      /// Wire data size of messages queued to peers, once per peer
+      uint64_t bytes_out = 0;
+      size_t mesh_size = 0;
+      /// Seconds from receiving till validator completes
+      metrics::Histogram::Snapshot validation_latency;
+      /// Seconds from the first IHAVE of message, or its receiving if it was
+      /// not announced, till delivery
+      metrics::Histogram::Snapshot first_delivery_latency;
+    };
+
+    /// Returns delivery counters of topics, which are subscribed to locally
+    /// or by peers. Counters of topic are kept while topic is known
+    virtual std::map<TopicId, TopicStats> topicStats() const = 0;
   };
 
   // Creates Gossip object
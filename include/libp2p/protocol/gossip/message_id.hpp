@@ -0,0 +1,105 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <string_view>
+
+#include <libp2p/common/types.hpp>
+
+namespace libp2p::protocol::gossip {
+
+  /**
+   * Message id, copied into message cache, seen cache, score and outgoing
+   * RPCs. Ids up to kInlineSize bytes, i.e. default ids (peer id and
+   * sequence number) and 20/32 byte digests, are stored inline and never
+   * allocate. Longer ids are allocated once and shared by copies
+   */
+  class MessageId {
+   public:
+    static constexpr size_t kInlineSize = 48;
+
+    MessageId() = default;
+
+    // NOLINTNEXTLINE(google-explicit-constructor)
+    MessageId(BytesIn bytes) {
+      append(bytes);
+    }
+
+    /// Id functions returning Bytes convert implicitly
+    // NOLINTNEXTLINE(google-explicit-constructor)
+    MessageId(const Bytes &bytes) : MessageId{BytesIn{bytes}} {}
+
+    /// Appends part of id, so that id is built without concatenation
+    void append(BytesIn bytes) {
+      auto size = size_ + bytes.size();
+      if (size <= kInlineSize) {
+        std::ranges::copy(bytes, inline_.begin() + size_);
+      } else {
+        if (heap_ == nullptr or heap_.use_count() != 1) {
+          auto heap = std::make_shared<Bytes>();
+          heap->reserve(size);
+          auto current = view();
+          heap->assign(current.begin(), current.end());
+          heap_ = std::move(heap);
+        }
+        heap_->insert(heap_->end(), bytes.begin(), bytes.end());
+      }
+      size_ = size;
+    }
+
+    BytesIn view() const {
+      return heap_ != nullptr ? BytesIn{*heap_}
+                              : BytesIn{inline_.data(), size_};
+    }
+
+    const uint8_t *data() const {
+      return view().data();
+    }
+
+    size_t size() const {
+      return size_;
+    }
+
+    bool empty() const {
+      return size_ == 0;
+    }
+
+    auto begin() const {
+      return view().begin();
+    }
+
+    auto end() const {
+      return view().end();
+    }
+
+    bool operator==(const MessageId &other) const {
+      return std::ranges::equal(view(), other.view());
+    }
+
+    bool operator<(const MessageId &other) const {
+      return std::ranges::lexicographical_compare(view(), other.view());
+    }
+
+   private:
+    std::array<uint8_t, kInlineSize> inline_{};
+    std::shared_ptr<Bytes> heap_;
+    size_t size_ = 0;
+  };
+
+}  // namespace libp2p::protocol::gossip
+
+template <>
+struct std::hash<libp2p::protocol::gossip::MessageId> {
+  size_t operator()(const libp2p::protocol::gossip::MessageId &id) const {
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    return std::hash<std::string_view>{}(
+        {reinterpret_cast<const char *>(id.data()), id.size()});
+  }
+};
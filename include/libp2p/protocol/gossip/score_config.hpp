@@ -0,0 +1,102 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <chrono>
+#include <map>
+#include <string>
+
+namespace libp2p::protocol::gossip {
+
+  /// Gossipsub v1.1 score parameters of one topic (P1-P4)
+  struct TopicScoreParams {
+    /// Weight of the topic in peer score
+    double topic_weight = 1;
+
+    /// P1: time in mesh, counted in quanta and capped
+    double time_in_mesh_weight = 0.01;
+    std::chrono::milliseconds time_in_mesh_quantum{std::chrono::seconds(1)};
+    double time_in_mesh_cap = 3600;
+
+    /// P2: first message deliveries
+    double first_message_deliveries_weight = 1;
+    double first_message_deliveries_decay = 0.5;
+    double first_message_deliveries_cap = 100;
+
+    /// P3: mesh message deliveries, penalty for delivering less than
+    /// threshold after activation interval since graft. Duplicates
+    /// within the window since first delivery are counted too.
+    /// Disabled by default, as the threshold depends on topic rate
+    double mesh_message_deliveries_weight = 0;
+    double mesh_message_deliveries_decay = 0.5;
+    double mesh_message_deliveries_threshold = 1;
+    double mesh_message_deliveries_cap = 100;
+    std::chrono::milliseconds mesh_message_deliveries_activation{
+        std::chrono::seconds(5)};
+    std::chrono::milliseconds mesh_message_deliveries_window{10};
+
+    /// P3b: sticky mesh delivery deficit of pruned peers
+    double mesh_failure_penalty_weight = 0;
+    double mesh_failure_penalty_decay = 0.5;
+
+    /// P4: invalid messages
+    double invalid_message_deliveries_weight = -1;
+    double invalid_message_deliveries_decay = 0.3;
+  };
+
+  /// Gossipsub v1.1 peer scoring config
+  struct ScoreConfig {
+    /// Scoring is off by default: all peers have zero score
+    bool enabled = false;
+
+    /// Params of topics, topics not mentioned use `default_topic`
+    std::map<std::string, TopicScoreParams> topics;
+    TopicScoreParams default_topic;
+
+    /// Cap of positive sum of topic scores, zero means no cap
+    double topic_score_cap = 0;
+
+    /// P5: application specific score
+    double app_specific_weight = 1;
+
+    /// P6: number of peers sharing ip address above threshold
+    double ip_colocation_factor_weight = -1;
+    size_t ip_colocation_factor_threshold = 10;
+
+    /// P7: behaviour penalty above threshold, i.e. grafts during backoff
+    double behaviour_penalty_weight = -1;
+    double behaviour_penalty_decay = 0.9;
+    double behaviour_penalty_threshold = 0;
+
+    /// Counters are decayed once per interval, and zeroed below the value
+    std::chrono::milliseconds decay_interval{std::chrono::seconds(1)};
+    double decay_to_zero = 0.01;
+
+    /// Score of disconnected peer is kept for this time
+    std::chrono::milliseconds retain_score{std::chrono::minutes(1)};
+
+    /// Gossip from and to peers below threshold is ignored
+    double gossip_threshold = -10;
+
+    /// Flood published messages are not sent to peers below threshold
+    double publish_threshold = -50;
+
+    /// All RPCs of peers below threshold are ignored
+    double graylist_threshold = -80;
+
+    /// Peers suggested in PRUNE are dialed only if pruner's score is at
+    /// least threshold
+    double accept_px_threshold = 0;
+
+    /// Peers with score above median are grafted if median score of mesh is
+    /// below threshold, checked every `opportunistic_graft_ticks` heartbeats
+    double opportunistic_graft_threshold = 1;
+    size_t opportunistic_graft_ticks = 60;
+    size_t opportunistic_graft_peers = 2;
+  };
+
+}  // namespace libp2p::protocol::gossip
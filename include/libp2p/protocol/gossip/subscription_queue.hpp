@@ -0,0 +1,102 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <memory>
+
+#include <libp2p/basic/mpmc_queue.hpp>
+#include <libp2p/protocol/gossip/gossip.hpp>
+
+namespace libp2p::protocol::gossip {
+
+  /**
+   * Messages of subscription, which are taken by application threads instead
+   * of being delivered by callback on the scheduler thread.
+   * Gossip pushes refcounted handles of received messages, which share their
+   * buffers and stay valid as long as handles are held. Any number of threads
+   * may pop them
+   */
+  class SubscriptionQueue {
+   public:
+    /// Immutable message shared with gossip
+    using MessagePtr = std::shared_ptr<const Gossip::Message>;
+
+    /// What happens to message arriving into full queue
+    enum class Overflow {
+      /// New message is dropped
+      DROP_NEWEST,
+      /// The oldest queued message is dropped to make space
+      DROP_OLDEST,
+      /// Reading from gossip streams is paused until the queue is drained to
+      /// half of capacity, messages already read are dropped while it is full
+      PAUSE_READING,
+    };
+
+    struct Config {
+      /// Max number of queued messages, rounded up to power of two
+      size_t capacity = 1024;
+      Overflow overflow = Overflow::DROP_NEWEST;
+    };
+
+    /// Result of push()
+    enum class PushResult {
+      PUSHED,
+      /// Pushed and queue became full, reading is to be paused
+      PAUSE,
+      DROPPED,
+    };
+
+    explicit SubscriptionQueue(Config config);
+
+    SubscriptionQueue(const SubscriptionQueue &) = delete;
+    SubscriptionQueue &operator=(const SubscriptionQueue &) = delete;
+
+    /// Takes message on any thread, returns false if queue is empty
+    bool tryPop(MessagePtr &msg);
+
+    /// Waits for message, returns false if queue is closed and empty
+    bool pop(MessagePtr &msg);
+
+    /// Messages in queue, approximate while other threads push or pop
+    size_t size() const;
+
+    /// Messages dropped by overflow policy
+    size_t dropped() const;
+
+    /// Queue is closed when unsubscribed, the rest of messages may be popped
+    bool closed() const;
+
+    /// Called by gossip on its thread
+    PushResult push(MessagePtr msg);
+
+    /// Called by gossip when subscription ends, wakes waiting threads
+    void close();
+
+    /// Called by gossip, `resume` is called once on thread, which has drained
+    /// paused queue, to resume reading
+    void onResume(std::function<void()> resume);
+
+   private:
+    /// Called after pop
+    void popped();
+
+    void notify();
+
+    const Config config_;
+    basic::MpmcQueue<MessagePtr> queue_;
+    std::atomic<size_t> size_{0};
+    std::atomic<size_t> dropped_{0};
+    std::atomic_bool closed_{false};
+    std::atomic_bool paused_{false};
+    /// Changed on each push and close, so that pop() waits on it
+    std::atomic<uint32_t> version_{0};
+    std::function<void()> resume_;
+  };
+
+}  // namespace libp2p::protocol::gossip
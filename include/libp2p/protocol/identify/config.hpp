@@ -6,6 +6,9 @@
 
 #pragma once
 
+#include <chrono>
+#include <cstddef>
+
 #include <libp2p/peer/stream_protocols.hpp>
 
 namespace {
@@ -19,4 +22,13 @@ namespace libp2p::protocol {
     StreamProtocols protocols = {::kIdentifyProto};
   };
 
+  /// Broadcast of Identify-Push and Identify-Delta to connected peers
+  struct IdentifyBroadcastConfig {
+    /// changes within this window after the first one are sent at once
+    std::chrono::milliseconds debounce = std::chrono::milliseconds{200};
+
+    /// streams opened simultaneously, other peers wait in queue
+    size_t max_concurrent_streams = 16;
+  };
+
 }  // namespace libp2p::protocol
@@ -0,0 +1,95 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <deque>
+#include <functional>
+#include <memory>
+
+#include <libp2p/basic/scheduler.hpp>
+#include <libp2p/common/types.hpp>
+#include <libp2p/host/host.hpp>
+#include <libp2p/log/logger.hpp>
+#include <libp2p/network/connection_manager.hpp>
+#include <libp2p/peer/peer_info.hpp>
+#include <libp2p/protocol/identify/config.hpp>
+
+namespace libp2p::protocol {
+  /**
+   * Sends one serialized message to each connected peer. Changes reported
+   * within debounce window are coalesced into one broadcast, message is
+   * serialized once and written over bounded number of concurrent streams
+   */
+  class IdentifyBroadcaster
+      : public std::enable_shared_from_this<IdentifyBroadcaster> {
+   public:
+    /// Makes length-prefixed message, nullptr if there is nothing to send
+    using MakeMessage = std::function<std::shared_ptr<const Bytes>()>;
+
+    /**
+     * @param scheduler to wait for debounce window, if nullptr, changes are
+     * broadcast immediately and coalesced only while broadcast is running
+     * @param protocol to open streams with
+     * @param make_message called once per broadcast
+     */
+    IdentifyBroadcaster(Host &host,
+                        network::ConnectionManager &conn_manager,
+                        std::shared_ptr<basic::Scheduler> scheduler,
+                        IdentifyBroadcastConfig config,
+                        peer::ProtocolName protocol,
+                        MakeMessage make_message);
+
+    /**
+     * Report a change, which must be broadcast to connected peers
+     */
+    void changed();
+
+    /// Number of streams being opened or written
+    size_t inflight() const {
+      return inflight_;
+    }
+
+   private:
+    /**
+     * Make message and queue connected peers, or remember to do it when
+     * current broadcast completes, so peers receive messages in order
+     */
+    void broadcast();
+
+    /**
+     * Open streams to queued peers up to concurrency limit
+     */
+    void sendNext();
+
+    /**
+     * Write message to the opened stream
+     */
+    void send(std::shared_ptr<connection::Stream> stream,
+              std::shared_ptr<const Bytes> message);
+
+    /**
+     * Called, when stream to a peer is done or failed
+     */
+    void sent();
+
+    Host &host_;
+    network::ConnectionManager &conn_manager_;
+    std::shared_ptr<basic::Scheduler> scheduler_;
+    IdentifyBroadcastConfig config_;
+    peer::ProtocolName protocol_;
+    MakeMessage make_message_;
+
+    basic::Scheduler::Handle timer_;
+    bool timer_pending_ = false;
+    bool dirty_ = false;
+    std::shared_ptr<const Bytes> message_;
+    std::deque<peer::PeerInfo> queue_;
+    size_t inflight_ = 0;
+
+    log::Logger log_ = log::createLogger("IdentifyBroadcaster");
+  };
+}  // namespace libp2p::protocol
@@ -6,8 +6,10 @@
 
 #pragma once
 
+#include <set>
 #include <vector>
 
+#include <libp2p/basic/scheduler.hpp>
 #include <libp2p/event/bus.hpp>
 #include <libp2p/host/host.hpp>
 #include <libp2p/log/logger.hpp>
@@ -16,6 +18,8 @@
 #include <libp2p/peer/peer_info.hpp>
 #include <libp2p/peer/protocol_repository.hpp>
 #include <libp2p/protocol/base_protocol.hpp>
+#include <libp2p/protocol/identify/config.hpp>
+#include <libp2p/protocol/identify/identify_broadcaster.hpp>
 
 namespace identify::pb {
   class Identify;
@@ -40,6 +44,17 @@ namespace libp2p::protocol {
                   network::ConnectionManager &conn_manager,
                   event::Bus &bus);
 
+    /**
+     * Create an instance of Identify-Delta, which coalesces changes
+     * @param scheduler to wait for debounce window
+     * @param config of broadcast
+     */
+    IdentifyDelta(Host &host,
+                  network::ConnectionManager &conn_manager,
+                  event::Bus &bus,
+                  std::shared_ptr<basic::Scheduler> scheduler,
+                  IdentifyBroadcastConfig config = {});
+
     peer::ProtocolName getProtocolId() const override;
 
     /**
@@ -64,24 +79,29 @@ namespace libp2p::protocol {
                        const std::shared_ptr<connection::Stream> &stream);
 
     /**
-     * Send a Delta message
+     * Remember changed protocols until the next Delta message is sent
      * @param added protocols
      * @param removed protocols
      */
-    void sendDelta(std::span<const peer::ProtocolName> added,
-                   std::span<const peer::ProtocolName> removed);
+    void protocolsChanged(std::span<const peer::ProtocolName> added,
+                          std::span<const peer::ProtocolName> removed);
 
     /**
-     * Send a Delta message
-     * @param stream for the message to be sent over
-     * @param msg to be sent
+     * Make a Delta message of changes since the previous one
+     * @return length-prefixed message, nullptr if nothing changed
      */
-    void sendDelta(std::shared_ptr<connection::Stream> stream,
-                   const std::shared_ptr<identify::pb::Identify> &msg) const;
+    std::shared_ptr<const Bytes> makeDelta();
 
     Host &host_;
     network::ConnectionManager &conn_manager_;
     event::Bus &bus_;
+    std::shared_ptr<basic::Scheduler> scheduler_;
+    IdentifyBroadcastConfig config_;
+    std::shared_ptr<IdentifyBroadcaster> broadcaster_;
+
+    /// changes, which are not sent yet
+    std::set<peer::ProtocolName> added_;
+    std::set<peer::ProtocolName> removed_;
 
     event::Handle new_protos_sub_;
     event::Handle rm_protos_sub_;
@@ -9,15 +9,21 @@
 #include <memory>
 #include <optional>
 #include <string>
+#include <vector>
 
+#include <boost/signals2.hpp>
+
+#include <libp2p/common/lru_cache.hpp>
 #include <libp2p/connection/stream.hpp>
 #include <libp2p/crypto/key_marshaller.hpp>
+#include <libp2p/event/bus.hpp>
 #include <libp2p/host/host.hpp>
 #include <libp2p/log/logger.hpp>
 #include <libp2p/multi/multiaddress.hpp>
 #include <libp2p/network/connection_manager.hpp>
 #include <libp2p/peer/identity_manager.hpp>
 #include <libp2p/peer/peer_id.hpp>
+#include <libp2p/peer/stream_protocols.hpp>
 #include <libp2p/protocol/identify/observed_addresses.hpp>
 
 namespace identify::pb {
@@ -35,6 +41,10 @@ namespace libp2p::protocol {
    public:
     using IdentifyCallback = void(const peer::PeerId &);
 
+    /// Number of recently received public keys, which are not unmarshalled
+    /// again, when their peers reconnect
+    static constexpr size_t kKeyCacheSize = 1024;
+
     IdentifyMessageProcessor(
         Host &host,
         network::ConnectionManager &conn_manager,
@@ -50,6 +60,13 @@ namespace libp2p::protocol {
      */
     void sendIdentify(StreamSPtr stream);
 
+    /**
+     * Serialize an Identify message of this peer without observed address,
+     * so the same bytes can be pushed to any peer
+     * @return length-prefixed message
+     */
+    std::shared_ptr<const Bytes> serializeIdentify();
+
     /**
      * Receive an Identify message from the provided stream
      * @param stream to be identified over
@@ -75,12 +92,35 @@ namespace libp2p::protocol {
     const ObservedAddresses &getObservedAddresses() const;
 
    private:
+    /**
+     * Serialized Identify message of this peer without observed address.
+     * It is split at that field, so the address of each connection is
+     * inserted in field number order
+     */
+    struct CachedIdentify {
+      /// protocols the message was built with
+      std::shared_ptr<const StreamProtocols> protocols;
+      /// public key, listen addresses and protocols
+      Bytes head;
+      /// versions
+      Bytes tail;
+      /// length-prefixed head and tail, the message to be pushed
+      std::shared_ptr<const Bytes> serialized;
+    };
+
+    /**
+     * Get serialized Identify message, build it again only if protocols have
+     * changed, or addresses or key have changed since the last call
+     * @return cached message, valid until the next call
+     */
+    const CachedIdentify &cachedIdentify();
+
     /**
      * Called, when an identify message is written to the stream
-     * @param written_bytes - how much bytes were written
+     * @param write_res - result of the write
      * @param stream with the other side
      */
-    void identifySent(outcome::result<size_t> written_bytes,
+    void identifySent(outcome::result<void> write_res,
                       const StreamSPtr &stream);
 
     /**
@@ -102,6 +142,23 @@ namespace libp2p::protocol {
     boost::optional<peer::PeerId> consumePublicKey(const StreamSPtr &stream,
                                                    std::string_view pubkey_str);
 
+    /// Public key unmarshalled from Identify message and its peer id
+    struct ResolvedKey {
+      crypto::PublicKey key;
+      peer::PeerId peer_id;
+    };
+
+    /**
+     * Unmarshal a received public key and derive peer id from it, or take
+     * both from cache
+     * @param pubkey_str - marshalled public key
+     * @param stream_peer_id - peer id from the stream, used for logging
+     * @return cached key, valid until the next call, or nullptr on error
+     */
+    const ResolvedKey *resolvePublicKey(
+        std::string_view pubkey_str,
+        const boost::optional<peer::PeerId> &stream_peer_id);
+
     /**
      * Process received address, which the other peer used to connect to us
      * @param address - observed address string
@@ -135,7 +192,11 @@ namespace libp2p::protocol {
     peer::IdentityManager &identity_manager_;
     std::shared_ptr<crypto::marshaller::KeyMarshaller> key_marshaller_;
     ObservedAddresses observed_addresses_;
+    LruCache<std::string, ResolvedKey> key_cache_{kKeyCacheSize};
     boost::signals2::signal<IdentifyCallback> signal_identify_received_;
+    std::optional<CachedIdentify> cached_identify_;
+    /// subscriptions to changes of our addresses and key, which reset cache
+    std::vector<event::Handle> cache_subs_;
 
     log::Logger log_ = log::createLogger("IdentifyMsgProcessor");
   };
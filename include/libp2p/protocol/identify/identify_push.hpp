@@ -9,8 +9,11 @@
 #include <memory>
 #include <vector>
 
+#include <libp2p/basic/scheduler.hpp>
 #include <libp2p/event/bus.hpp>
 #include <libp2p/protocol/base_protocol.hpp>
+#include <libp2p/protocol/identify/config.hpp>
+#include <libp2p/protocol/identify/identify_broadcaster.hpp>
 #include <libp2p/protocol/identify/identify_msg_processor.hpp>
 
 namespace libp2p::protocol {
@@ -26,6 +29,15 @@ namespace libp2p::protocol {
     IdentifyPush(std::shared_ptr<IdentifyMessageProcessor> msg_processor,
                  event::Bus &bus);
 
+    /**
+     * @param scheduler to coalesce changes within debounce window
+     * @param config of broadcast
+     */
+    IdentifyPush(std::shared_ptr<IdentifyMessageProcessor> msg_processor,
+                 event::Bus &bus,
+                 std::shared_ptr<basic::Scheduler> scheduler,
+                 IdentifyBroadcastConfig config = {});
+
     peer::ProtocolName getProtocolId() const override;
 
     /**
@@ -41,14 +53,12 @@ namespace libp2p::protocol {
     void start();
 
    private:
-    /**
-     * Send an Identify message to all peers we are connected to
-     */
-    void sendPush();
-
     std::shared_ptr<IdentifyMessageProcessor> msg_processor_;
 
     event::Bus &bus_;
+    std::shared_ptr<basic::Scheduler> scheduler_;
+    IdentifyBroadcastConfig config_;
+    std::shared_ptr<IdentifyBroadcaster> broadcaster_;
     std::vector<event::Handle> sub_handles_;
   };
 }  // namespace libp2p::protocol
@@ -7,6 +7,7 @@
 #pragma once
 
 #include <chrono>
+#include <span>
 #include <unordered_map>
 #include <vector>
 
@@ -18,27 +19,38 @@ namespace libp2p::protocol {
   /**
    * Smart storage of mappings of our "official" listen addresses to the ones,
    * actually observed by other peers; this is needed, for example, if we use
-   * NAT and want to understand, by which addresses we really are available
+   * NAT and want to understand, by which addresses we really are available.
+   * Memory is bounded: observers are counted per group (/16 for IPv4, /56 for
+   * IPv6) and numbers of tracked addresses and groups are capped
    */
   class ObservedAddresses {
     using Clock = std::chrono::steady_clock;
     using Milliseconds = std::chrono::milliseconds;
 
    public:
+    /// local addresses, for which observations are kept
+    static constexpr size_t kMaxLocalAddresses = 64;
+
+    /// observed addresses per local one, least recently seen is evicted
+    static constexpr size_t kMaxObservedPerLocal = 16;
+
+    /// observer groups remembered per observed address
+    static constexpr size_t kMaxObserverGroups = 8;
+
     /**
      * Get a set of addresses, which were observed by other peers, when they
      * tried to connect to the given (\param address)
      * @param address, for which the mapping is to be extracted
-     * @return set of addresses
+     * @return set of addresses, valid until the next call to this object
      */
-    std::vector<multi::Multiaddress> getAddressesFor(
+    std::span<const multi::Multiaddress> getAddressesFor(
         const multi::Multiaddress &address) const;
 
     /**
      * Get all addresses, which were observed by other peers
-     * @return the addresses
+     * @return the addresses, valid until the next call to this object
      */
-    std::vector<multi::Multiaddress> getAllAddresses() const;
+    std::span<const multi::Multiaddress> getAllAddresses() const;
 
     /**
      * Add an address, which was observed by another peer
@@ -64,23 +76,27 @@ namespace libp2p::protocol {
     static constexpr uint8_t kActivationThresh = 4;
 
     struct Observation {
+      uint64_t group{};
       Clock::time_point seen_time;
       bool observer_is_initiator{};
     };
 
     struct ObservedAddress {
       multi::Multiaddress address;
-      std::unordered_map<multi::Multiaddress, Observation> seen_by;
+      std::vector<Observation> seen_by;
       Clock::time_point last_seen;
       Milliseconds ttl = peer::ttl::kOwnObserved;
+      bool activated = false;
     };
 
-    std::unordered_map<multi::Multiaddress, std::vector<ObservedAddress>>
-        observed_addresses_;
+    struct LocalAddress {
+      std::vector<ObservedAddress> observed;
+      std::vector<multi::Multiaddress> activated;
+    };
 
     /**
      * Check if the address is activated: it was observed by a number of
-     * different peers in some period of time
+     * different peer groups in some period of time
      * @param address to be checked
      * @param now - current time
      * @return true, if it is activated, false otherwise
@@ -89,11 +105,34 @@ namespace libp2p::protocol {
                             Clock::time_point now) const;
 
     /**
-     * Get "general" address of the provided (\param addr) to avoid issues, when
-     * one peer under one IP address gets different ports because of NAT
+     * Time, when activated address may become deactivated
+     */
+    static Clock::time_point expiresAt(const ObservedAddress &address,
+                                       Clock::time_point now);
+
+    /**
+     * Recalculate activated addresses, if some of them may have expired
+     */
+    void refresh(Clock::time_point now) const;
+
+    /**
+     * Rebuild lists of activated addresses
+     */
+    void rebuild(Clock::time_point now) const;
+
+    /**
+     * Get group of the observer to avoid issues, when one peer under one IP
+     * address gets different ports because of NAT, and to count peers from
+     * one network once
      * @param addr, from which an observer group is to be extracted
      * @return the group
      */
-    multi::Multiaddress observerGroup(const multi::Multiaddress &addr) const;
+    static uint64_t observerGroup(const multi::Multiaddress &addr);
+
+    // lists of activated addresses are updated lazily from const getters
+    mutable std::unordered_map<multi::Multiaddress, LocalAddress>
+        observed_addresses_;
+    mutable std::vector<multi::Multiaddress> all_activated_;
+    mutable Clock::time_point next_expiry_ = Clock::time_point::max();
   };
 }  // namespace libp2p::protocol
@@ -11,11 +11,16 @@
 #include <string>
 #include <tuple>
 
+#include <libp2p/common/types.hpp>
 #include <libp2p/connection/stream.hpp>
 #include <libp2p/host/host.hpp>
 #include <libp2p/network/connection_manager.hpp>
 #include <libp2p/peer/protocol.hpp>
 
+namespace google::protobuf {
+  class MessageLite;
+}  // namespace google::protobuf
+
 namespace libp2p::protocol::detail {
   /**
    * Get a tuple of stringified <PeerId, Multiaddress> of the peer the (\param
@@ -47,4 +52,13 @@ namespace libp2p::protocol::detail {
                                  network::ConnectionManager &conn_manager,
                                  StreamProtocols protocols,
                                  StreamAndProtocolOrErrorCb handler);
+
+  /**
+   * Serialize a message with uvarint length prefix, as it is written by
+   * ProtobufMessageReadWriter
+   * @param msg to be serialized
+   * @return bytes, which can be written to any number of streams
+   */
+  std::shared_ptr<const Bytes> serializeWithLength(
+      const google::protobuf::MessageLite &msg);
 }  // namespace libp2p::protocol::detail
@@ -32,4 +32,15 @@ namespace libp2p::protocol::kademlia {
       std::function<void(outcome::result<std::vector<PeerInfo>>)>;
   using FoundValueHandler = std::function<void(outcome::result<Value>)>;
 
+  /// Called for each provider as soon as it is found
+  using ProviderStreamHandler = std::function<void(const PeerInfo &)>;
+  /// Called for each distinct valid value as soon as it arrives
+  using ValueStreamHandler = std::function<void(const Value &)>;
+
+  /// Called once for each key of batch lookup
+  using BatchValueHandler =
+      std::function<void(const Key &, outcome::result<Value>)>;
+  using BatchProvidersHandler = std::function<void(
+      const Key &, outcome::result<std::vector<PeerInfo>>)>;
+
 }  // namespace libp2p::protocol::kademlia
@@ -6,6 +6,8 @@
 
 #pragma once
 
+#include <string>
+
 #include <libp2p/peer/stream_protocols.hpp>
 #include <libp2p/protocol/kademlia/common.hpp>
 
@@ -120,6 +122,30 @@ namespace libp2p::protocol::kademlia {
      */
     size_t maxProvidersPerKey = 6;
 
+    /**
+     * Number of keys which values or providers are cached by persistent
+     * storage (SQLite)
+     * @note Default: 1024
+     */
+    size_t storageCacheSize = 1024;
+
+    /**
+     * Persistent storage writes changes in batches, once per interval or
+     * when batch is full
+     * @note Default: 1s, 256
+     */
+    std::chrono::milliseconds storageFlushInterval = 1s;
+    size_t storageFlushBatch = 256;
+
+    /**
+     * Log of memory mapped storage is compacted when overwritten and erased
+     * records take this percent of it, live records are copied by batches
+     * on scheduler. Zero percent disables background compaction
+     * @note Default: 50, 1024
+     */
+    size_t storageCompactionGarbage = 50;
+    size_t storageCompactionBatch = 1024;
+
     /**
      * Maximum size of bucket
      * This is implementation specified property.
@@ -141,16 +167,157 @@ namespace libp2p::protocol::kademlia {
      */
     std::chrono::seconds connectionTimeout = 3s;
 
+    /**
+     * Batch reprovider takes keys close in XOR space by regions of at most
+     * batch size keys, and paces ADD_PROVIDER messages to rate per second.
+     * Zero rate disables pacing
+     * @note Default: 256, 1000
+     */
+    size_t reprovideBatchSize = 256;
+    size_t reprovideRate = 1000;
+
+    /**
+     * Lookups of batch GET_VALUE and GET_PROVIDERS run at once, keys are
+     * taken in order of position in XOR space
+     * @note Default: 16
+     */
+    size_t batchLookupConcurrency = 16;
+
+    /**
+     * Accelerated client mode: the whole network is crawled periodically
+     * into in-memory table, and lookups start from its closest peers, so
+     * they take a single hop. Crawl sends at most concurrency requests at
+     * once and rate requests per second, zero rate disables pacing
+     * @note Default: false, 1h, 64, 200
+     */
+    bool fullRoutingTable = false;
+    std::chrono::seconds crawlInterval = 1h;
+    size_t crawlConcurrency = 64;
+    size_t crawlRate = 200;
+
+    /**
+     * Streams kept open per peer for outgoing requests, and number of
+     * requests pipelined over one stream. Streams idle for timeout are
+     * closed, it should be less than responseTimeout of remote side.
+     * Zero streams disables reuse, so each request opens new stream
+     * @note Default: 2, 4, 5s
+     */
+    size_t maxStreamsPerPeer = 2;
+    size_t maxPipelinedRequests = 4;
+    std::chrono::milliseconds streamIdleTimeout = 5s;
+
+    /**
+     * Serialized FIND_NODE and GET_PROVIDERS responses are cached by key
+     * for TTL, and dropped when routing table or providers of key change.
+     * Zero TTL disables the cache
+     * @note Default: 1s, 1024
+     */
+    std::chrono::milliseconds responseCacheTtl = 1s;
+    size_t responseCacheSize = 1024;
+
+    /**
+     * Worker threads validating records of PUT_VALUE requests and GET_VALUE
+     * responses, and selecting the best of them, so validator must be thread
+     * safe. If zero, validator is called on the scheduler thread
+     * @note Default: 0
+     */
+    size_t validationThreads = 0;
+
+    /**
+     * Worker threads completing FIND_NODE, GET_PROVIDERS and GET_VALUE
+     * responses: nearest peers are selected from snapshot of routing table
+     * and responses are serialized off the network thread. Storage and
+     * providers are still looked up on the network thread. If zero, requests
+     * are answered on the network thread
+     * @note Default: 0
+     */
+    size_t requestThreads = 0;
+
+    /**
+     * Snapshot of routing table peers with their addresses, read by request
+     * threads, is rebuilt when peers are added or removed, and after TTL, as
+     * addresses and connectedness of peers change
+     * @note Default: 1s
+     */
+    std::chrono::milliseconds nearestPeersSnapshotTtl = 1s;
+
     /**
      * Random walk config
      */
     RandomWalk randomWalk{};
 
+    /**
+     * If random walk is enabled, buckets not looked up for interval are
+     * refreshed by lookup of random id in their range instead, which is
+     * checked every check period. Ids for buckets deeper than 15 bits take
+     * too long to generate, so those are not refreshed. Zero interval
+     * enables plain random walk
+     * @note Default: 10min, 1min
+     */
+    std::chrono::seconds bucketRefreshInterval = 10min;
+    std::chrono::seconds bucketRefreshCheck = 1min;
+
+    /**
+     * File where peers of routing table and their addresses are saved
+     * periodically, and loaded from on start. Empty path disables snapshots
+     * @note Default: empty
+     */
+    std::string routingTableSnapshotPath;
+
+    /**
+     * Interval of saving routing table snapshot
+     * @note Default: 5m
+     */
+    std::chrono::seconds routingTableSnapshotInterval = 5min;
+
+    /**
+     * Number of concurrent connections checking that peers loaded from
+     * snapshot are alive. Unreachable peers are removed from routing table
+     * @note Default: 3
+     */
+    size_t routingTableLivenessChecks = 3;
+
+    /**
+     * Number of requests failed in a row, after which routing table peer is
+     * replaced by new one even while connected, and goes after responsive
+     * peers in nearest peers
+     * @note Default: 3
+     */
+    size_t routingTableMaxFailures = 3;
+
     // https://github.com/libp2p/rust-libp2p/blob/c6cf7fec6913aa590622aeea16709fce6e9c99a5/protocols/kad/src/query/peers/closest.rs#L110-L120
     size_t query_initial_peers = K_VALUE;
 
     // https://github.com/libp2p/rust-libp2p/blob/9a45db3f82b760c93099e66ec77a7a772d1f6cd3/protocols/kad/src/query/peers/closest.rs#L336-L346
     size_t replication_factor = K_VALUE;
+
+    /**
+     * Number of disjoint paths of lookup (S/Kademlia). Each path has its own
+     * candidates and concurrency, peer is queried by one path only
+     * @note Default: 1
+     */
+    size_t query_disjoint_paths = 1;
+
+    /**
+     * Maximum number of concurrent requests of one path. Request stalled for
+     * longer than `query_stall_timeout` lets path spawn one more request
+     * above `requestConcurency`, up to this limit
+     * @note Default: 6
+     */
+    size_t query_max_concurrency = 6;
+
+    /**
+     * Request is stalled when elapsed twice the average latency of peers,
+     * but not longer than this
+     * @note Default: 1s
+     */
+    std::chrono::milliseconds query_stall_timeout = 1s;
+
+    /**
+     * Number of peers which latency is kept to prefer faster peers
+     * @note Default: 1024
+     */
+    size_t query_latency_peers = 1024;
   };
 
 }  // namespace libp2p::protocol::kademlia
@@ -7,6 +7,7 @@
 #pragma once
 
 #include <libp2p/common/byteutil.hpp>
+#include <libp2p/multi/content_identifier.hpp>
 #include <string_view>
 
 namespace libp2p::protocol::kademlia {
@@ -14,4 +15,7 @@ namespace libp2p::protocol::kademlia {
   using ContentId = Bytes;
 
   ContentId makeKeySha256(std::string_view str);
+
+  /// Key of CID, decoded without copying by ContentIdentifierCodec::decodeView
+  ContentId makeKey(const multi::ContentIdentifierView &cid);
 }  // namespace libp2p::protocol::kademlia
@@ -20,9 +20,58 @@ namespace libp2p::protocol::kademlia {
     // the local accounting of which objects are being provided.
     virtual outcome::result<void> provide(const Key &key, bool need_notify) = 0;
 
+    // Provides and announces many keys, e.g. to reprovide them periodically.
+    // Implementation may share lookups and messages between keys.
+    virtual outcome::result<void> provideBatch(const std::vector<Key> &keys) {
+      for (auto &key : keys) {
+        OUTCOME_TRY(provide(key, true));
+      }
+      return outcome::success();
+    }
+
     // Search for peers who are able to provide a given key.
     virtual outcome::result<void> findProviders(
         const Key &key, size_t limit, FoundProvidersHandler handler) = 0;
+
+    // Search for providers, passing each one to 'on_provider' as it is found.
+    // Search completes as soon as 'limit' providers are found, if not zero,
+    // then 'handler' gets all of them.
+    virtual outcome::result<void> streamProviders(
+        const Key &key,
+        size_t limit,
+        ProviderStreamHandler on_provider,
+        FoundProvidersHandler handler) {
+      return findProviders(
+          key,
+          limit,
+          [on_provider{std::move(on_provider)}, handler{std::move(handler)}](
+              outcome::result<std::vector<PeerInfo>> res) {
+            if (res.has_value()) {
+              for (auto &provider : res.value()) {
+                on_provider(provider);
+              }
+            }
+            handler(std::move(res));
+          });
+    }
+
+    // Search for providers of many keys at once, 'handler' is called once
+    // for each key. Implementation may share peers and sessions between
+    // lookups of keys.
+    virtual outcome::result<void> findProvidersBatch(
+        const std::vector<Key> &keys,
+        size_t limit,
+        BatchProvidersHandler handler) {
+      for (auto &key : keys) {
+        OUTCOME_TRY(findProviders(
+            key,
+            limit,
+            [key, handler](outcome::result<std::vector<PeerInfo>> res) {
+              handler(key, std::move(res));
+            }));
+      }
+      return outcome::success();
+    }
   };
 
 }  // namespace libp2p::protocol::kademlia
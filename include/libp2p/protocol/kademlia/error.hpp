@@ -24,7 +24,8 @@ namespace libp2p::protocol::kademlia {
     FULFILLED,
     NOT_IMPLEMENTED,
     INTERNAL_ERROR,
-    SESSION_CLOSED
+    SESSION_CLOSED,
+    STORAGE_ERROR
   };
 }
 
@@ -0,0 +1,59 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include <libp2p/protocol/kademlia/common.hpp>
+#include <libp2p/protocol/kademlia/node_id.hpp>
+
+namespace libp2p::protocol::kademlia {
+
+  /**
+   * Runs lookups of many keys with bounded concurrency. Keys are taken in
+   * order of position in XOR space, so lookups in progress at once share
+   * closest peers, and their requests are pipelined over the same pooled
+   * sessions instead of dialing peers of distant regions
+   */
+  class BatchLookup : public std::enable_shared_from_this<BatchLookup> {
+   public:
+    using OnDone = std::function<void()>;
+    /// Starts lookup of key, `on_done` must be called once it completes
+    using Start = std::function<void(const ContentId &key, OnDone on_done)>;
+
+    BatchLookup(size_t concurrency, Start start);
+
+    /// Queues keys, duplicates are looked up once
+    void lookup(const std::vector<ContentId> &keys);
+
+    /// Keys waiting for lookup
+    size_t queued() const {
+      return queue_.size();
+    }
+
+    /// Lookups in progress
+    size_t inProgress() const {
+      return in_progress_;
+    }
+
+   private:
+    /// Starts queued lookups up to concurrency
+    void next();
+
+    const size_t concurrency_;
+    Start start_;
+
+    /// Keys ordered by hash
+    std::map<Hash256, ContentId> queue_;
+    size_t in_progress_ = 0;
+    bool starting_ = false;
+  };
+
+}  // namespace libp2p::protocol::kademlia
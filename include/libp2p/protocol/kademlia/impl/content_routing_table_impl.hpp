@@ -8,45 +8,17 @@
 
 #include <libp2p/protocol/kademlia/impl/content_routing_table.hpp>
 
-#include <boost/multi_index/hashed_index_fwd.hpp>
-#include <boost/multi_index/member.hpp>
-#include <boost/multi_index/ordered_index_fwd.hpp>
-#include <boost/multi_index_container_fwd.hpp>
+#include <unordered_map>
+
+#include <boost/container/small_vector.hpp>
 
 #include <libp2p/basic/scheduler.hpp>
 #include <libp2p/protocol/kademlia/common.hpp>
 #include <libp2p/protocol/kademlia/config.hpp>
+#include <libp2p/protocol/kademlia/impl/expiry_buckets.hpp>
 
 namespace libp2p::protocol::kademlia {
 
-  struct ByKey;
-  struct ByExpireTime;
-
-  namespace {
-
-    namespace mi = boost::multi_index;
-
-    struct Record {
-      ContentId key;
-      peer::PeerId peer;
-      Time expire_time = Time::zero();
-    };
-
-    /// Table of Record with 2 indices (by key and expire time)
-    using Table = boost::multi_index_container<
-        Record,
-        mi::indexed_by<
-            // hashed_non_unique by key means unordered index, non-unique
-            mi::hashed_non_unique<mi::tag<ByKey>,
-                                  mi::member<Record, ContentId, &Record::key>,
-                                  std::hash<ContentId>>,
-            // ordered_non_unique by expire time means accending order
-            mi::ordered_non_unique<
-                mi::tag<ByExpireTime>,
-                mi::member<Record, Time, &Record::expire_time>>>>;
-
-  }  // namespace
-
   class ContentRoutingTableImpl
       : public ContentRoutingTable,
         public std::enable_shared_from_this<ContentRoutingTableImpl> {
@@ -64,14 +36,63 @@ namespace libp2p::protocol::kademlia {
 
     void addProvider(const ContentId &key, const peer::PeerId &peer) override;
 
+    /// Max expiry entries swept per scheduler tick
+    static constexpr size_t kSweepSlice = 4096;
+
+    /// Providers of a key stored without allocation, as by default config
+    static constexpr size_t kInlineProviders = 6;
+
    private:
+    /// Index of interned key or peer
+    using Handle = uint32_t;
+
+    struct Provider {
+      Handle peer = 0;
+      Time expire_time = Time::zero();
+    };
+
+    /// Providers of a key, at most maxProvidersPerKey
+    struct KeyRecord {
+      Handle handle = 0;
+      boost::container::small_vector<Provider, kInlineProviders> providers;
+    };
+
+    /// Interned peer, referenced by providers
+    struct PeerRecord {
+      Handle handle = 0;
+      size_t refs = 0;
+    };
+
     void onCleanupTimer();
-    void setTimerCleanup();
+    void setTimerCleanup(std::chrono::milliseconds delay);
+
+    /// Interns peer for one more provider
+    Handle acquirePeer(const peer::PeerId &peer);
+
+    /// Releases peer of the provider, erases it with last one
+    void releasePeer(Handle handle);
 
     const Config &config_;
     basic::Scheduler &scheduler_;
     std::shared_ptr<event::Bus> bus_;
-    std::unique_ptr<Table> table_;
+
+    /// Providers by key, each key is stored once
+    std::unordered_map<ContentId, KeyRecord> table_;
+
+    /// Keys of table_ by handle, null if free
+    std::vector<const ContentId *> keys_;
+    std::vector<Handle> free_keys_;
+
+    /// Peers providing something, each peer is stored once
+    std::unordered_map<peer::PeerId, PeerRecord> peer_records_;
+
+    /// Peers of peer_records_ by handle, null if free
+    std::vector<const peer::PeerId *> peers_;
+    std::vector<Handle> free_peers_;
+
+    /// Key handles by expire time of their providers
+    ExpiryBuckets<Handle> expiry_;
+
     basic::Scheduler::Handle cleanup_timer_;
   };
 
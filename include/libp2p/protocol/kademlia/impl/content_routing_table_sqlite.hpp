@@ -0,0 +1,90 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <libp2p/protocol/kademlia/impl/content_routing_table.hpp>
+
+#include <boost/optional.hpp>
+
+#include <libp2p/basic/scheduler.hpp>
+#include <libp2p/common/lru_cache.hpp>
+#include <libp2p/protocol/kademlia/common.hpp>
+#include <libp2p/protocol/kademlia/config.hpp>
+#include <libp2p/storage/sqlite.hpp>
+
+namespace libp2p::protocol::kademlia {
+
+  /**
+   * Provider records kept in SQLite database, so they survive restart.
+   * Providers of recently used keys are cached, changes are written in
+   * batches
+   */
+  class ContentRoutingTableSqlite
+      : public ContentRoutingTable,
+        public std::enable_shared_from_this<ContentRoutingTableSqlite> {
+   public:
+    ContentRoutingTableSqlite(const Config &config,
+                              basic::Scheduler &scheduler,
+                              std::shared_ptr<event::Bus> bus,
+                              std::shared_ptr<storage::SQLite> db);
+
+    /// Writes pending changes
+    ~ContentRoutingTableSqlite() override;
+
+    void start() override;
+
+    std::vector<PeerId> getProvidersFor(const ContentId &key,
+                                        size_t limit = 0) const override;
+
+    void addProvider(const ContentId &key, const peer::PeerId &peer) override;
+
+    /// Writes pending changes in one transaction
+    outcome::result<void> flush() const;
+
+   private:
+    struct Provider {
+      PeerId peer;
+      /// Wall clock time
+      Time expire_time;
+    };
+
+    /// Provider to write, or to erase if expire time is none
+    struct Change {
+      ContentId key;
+      PeerId peer;
+      boost::optional<Time> expire_time;
+    };
+
+    /// Providers of key, loaded to cache if missing
+    std::vector<Provider> &providers(const ContentId &key) const;
+
+    void addChange(Change change);
+    void setFlushTimer() const;
+
+    void onCleanupTimer();
+    void setTimerCleanup();
+
+    const Config &config_;
+    basic::Scheduler &scheduler_;
+    std::shared_ptr<event::Bus> bus_;
+    std::shared_ptr<storage::SQLite> db_;
+
+    storage::SQLite::StatementHandle begin_;
+    storage::SQLite::StatementHandle commit_;
+    storage::SQLite::StatementHandle rollback_;
+    storage::SQLite::StatementHandle select_;
+    storage::SQLite::StatementHandle upsert_;
+    storage::SQLite::StatementHandle delete_;
+    storage::SQLite::StatementHandle delete_expired_;
+
+    mutable LruCache<ContentId, std::vector<Provider>> cache_;
+    mutable std::vector<Change> changes_;
+    mutable basic::Scheduler::Handle flush_timer_;
+    basic::Scheduler::Handle cleanup_timer_;
+  };
+
+}  // namespace libp2p::protocol::kademlia
@@ -0,0 +1,90 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <deque>
+#include <unordered_set>
+#include <vector>
+
+#include <libp2p/basic/scheduler.hpp>
+#include <libp2p/host/host.hpp>
+#include <libp2p/log/sublogger.hpp>
+#include <libp2p/protocol/kademlia/config.hpp>
+#include <libp2p/protocol/kademlia/impl/full_routing_table.hpp>
+#include <libp2p/protocol/kademlia/impl/session_host.hpp>
+#include <libp2p/protocol/kademlia/message.hpp>
+
+namespace libp2p::protocol::kademlia {
+
+  /**
+   * Crawls the whole network into full routing table. Each peer found is
+   * asked once for peers closest to itself, every peer is among closest
+   * peers of its neighbours, so crawl reaches all peers reachable from
+   * seeds. Peers which responded replace the table when crawl is done.
+   * Crawl repeats every `crawlInterval`
+   */
+  class Crawler : public std::enable_shared_from_this<Crawler> {
+   public:
+    Crawler(const Config &config,
+            std::shared_ptr<Host> host,
+            std::shared_ptr<basic::Scheduler> scheduler,
+            std::weak_ptr<SessionHost> session_host,
+            std::shared_ptr<PeerRoutingTable> seeds,
+            std::shared_ptr<FullRoutingTable> table);
+
+    ~Crawler();
+
+    /// Starts crawl now, and then periodically
+    void start();
+
+    /// Crawl is in progress
+    bool crawling() const {
+      return crawling_;
+    }
+
+   private:
+    class Request;
+
+    void crawl();
+
+    /// Sends requests up to concurrency and rate
+    void next();
+
+    void request(const PeerId &peer_id);
+
+    void onResponse(const PeerId &peer_id, outcome::result<Message> msg_res);
+
+    void onRequestDone();
+
+    void finish();
+
+    const Config &config_;
+    std::shared_ptr<Host> host_;
+    std::shared_ptr<basic::Scheduler> scheduler_;
+    std::weak_ptr<SessionHost> session_host_;
+    std::shared_ptr<PeerRoutingTable> seeds_;
+    std::shared_ptr<FullRoutingTable> table_;
+
+    /// Peers to query, and peers queued ever in current crawl
+    std::deque<PeerId> queue_;
+    std::unordered_set<PeerId> seen_;
+
+    /// Peers responded in current crawl
+    std::vector<PeerId> found_;
+
+    bool crawling_ = false;
+    bool starting_ = false;
+    size_t in_progress_ = 0;
+    std::chrono::milliseconds next_request_{};
+
+    /// Pacing or next crawl
+    basic::Scheduler::Handle timer_;
+
+    log::SubLogger log_;
+  };
+
+}  // namespace libp2p::protocol::kademlia
@@ -37,13 +37,18 @@ namespace libp2p::protocol::kademlia {
         ContentId key, ContentValue value, std::vector<PeerId> addressees) = 0;
 
     virtual std::shared_ptr<GetValueExecutor> createGetValueExecutor(
-        ContentId sought_key, FoundValueHandler handler) = 0;
+        ContentId sought_key,
+        FoundValueHandler handler,
+        ValueStreamHandler on_value) = 0;
 
     virtual std::shared_ptr<AddProviderExecutor> createAddProviderExecutor(
         ContentId key) = 0;
 
     virtual std::shared_ptr<FindProvidersExecutor> createGetProvidersExecutor(
-        ContentId sought_key, FoundProvidersHandler handler) = 0;
+        ContentId sought_key,
+        size_t limit,
+        FoundProvidersHandler handler,
+        ProviderStreamHandler on_provider) = 0;
 
     virtual std::shared_ptr<FindPeerExecutor> createFindPeerExecutor(
         HashedKey key, FoundPeerInfoHandler handler) = 0;
@@ -0,0 +1,107 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <deque>
+#include <vector>
+
+#include <boost/assert.hpp>
+
+#include <libp2p/protocol/kademlia/common.hpp>
+
+namespace libp2p::protocol::kademlia {
+
+  /**
+   * Expiry of keys by time buckets. Adding a key appends it to the bucket of
+   * its expire time, in O(1). Refreshed key is just added again, its stale
+   * entries are skipped by the owner when swept. Buckets are swept after
+   * they elapse, in slices of limited size
+   */
+  template <typename Key>
+  class ExpiryBuckets {
+   public:
+    /// Key expired at its bucket sweep, to check against current record
+    struct Entry {
+      Key key;
+      Time expire_time;
+    };
+
+    explicit ExpiryBuckets(Time granularity) : granularity_(granularity) {
+      BOOST_ASSERT(granularity_.count() > 0);
+    }
+
+    /// Adds key to be swept after expire time
+    void add(const Key &key, Time expire_time) {
+      auto bucket = std::max(expire_time / granularity_, next_bucket_);
+      if (buckets_.empty()) {
+        first_bucket_ = bucket;
+      } else if (bucket < first_bucket_) {
+        if (swept_ == 0) {
+          buckets_.insert(buckets_.begin(),
+                          static_cast<size_t>(first_bucket_ - bucket),
+                          std::vector<Entry>{});
+          first_bucket_ = bucket;
+        } else {
+          // the front bucket is being swept, so the key is due
+          bucket = first_bucket_;
+        }
+      }
+      auto index = static_cast<size_t>(bucket - first_bucket_);
+      if (index >= buckets_.size()) {
+        buckets_.resize(index + 1);
+      }
+      buckets_[index].push_back({key, expire_time});
+    }
+
+    /// Calls on_expired for up to limit entries of buckets elapsed by now.
+    /// Returns true if more entries are due
+    template <typename F>
+    bool sweep(Time now, size_t limit, const F &on_expired) {
+      while (not buckets_.empty()
+             and (first_bucket_ + 1) * granularity_ <= now) {
+        auto &bucket = buckets_.front();
+        for (; swept_ < bucket.size(); ++swept_) {
+          if (limit == 0) {
+            return true;
+          }
+          --limit;
+          on_expired(bucket[swept_]);
+        }
+        buckets_.pop_front();
+        next_bucket_ = ++first_bucket_;
+        swept_ = 0;
+      }
+      return false;
+    }
+
+    /// Number of entries, stale ones included
+    size_t size() const {
+      size_t n = 0;
+      for (auto &bucket : buckets_) {
+        n += bucket.size();
+      }
+      return n - swept_;
+    }
+
+   private:
+    Time granularity_;
+
+    /// Buckets of consecutive time ranges, starting from the oldest
+    std::deque<std::vector<Entry>> buckets_;
+
+    /// Index of the front bucket since epoch
+    Time::rep first_bucket_ = 0;
+
+    /// Buckets before this one were swept
+    Time::rep next_bucket_ = 0;
+
+    /// Entries of the front bucket already swept
+    size_t swept_ = 0;
+  };
+
+}  // namespace libp2p::protocol::kademlia
@@ -9,7 +9,6 @@
 #include <libp2p/protocol/kademlia/impl/response_handler.hpp>
 
 #include <memory>
-#include <queue>
 #include <unordered_set>
 
 #include <libp2p/basic/scheduler.hpp>
@@ -18,8 +17,8 @@
 #include <libp2p/log/sublogger.hpp>
 #include <libp2p/protocol/kademlia/common.hpp>
 #include <libp2p/protocol/kademlia/config.hpp>
-#include <libp2p/protocol/kademlia/impl/peer_id_with_distance.hpp>
 #include <libp2p/protocol/kademlia/impl/peer_routing_table.hpp>
+#include <libp2p/protocol/kademlia/impl/query.hpp>
 #include <libp2p/protocol/kademlia/impl/session.hpp>
 #include <libp2p/protocol/kademlia/impl/session_host.hpp>
 
@@ -35,6 +34,7 @@ namespace libp2p::protocol::kademlia {
         std::shared_ptr<basic::Scheduler> scheduler,
         std::shared_ptr<SessionHost> session_host,
         const std::shared_ptr<PeerRoutingTable> &peer_routing_table,
+        std::shared_ptr<PeerLatencies> latencies,
         HashedKey target,
         FoundPeerInfoHandler handler);
 
@@ -59,7 +59,8 @@ namespace libp2p::protocol::kademlia {
     void spawn();
 
     /// Handles result of connection
-    void onConnected(StreamAndProtocolOrError stream_res);
+    void onConnected(const PeerId &peer_id,
+                     SessionOrError session_res);
 
     static std::atomic_size_t instance_number;
 
@@ -71,14 +72,13 @@ namespace libp2p::protocol::kademlia {
 
     // Secondary
     HashedKey target_;
-    std::unordered_set<PeerId> nearest_peer_ids_;
     std::vector<PeerId> succeeded_peers_;
     FoundPeerInfoHandler handler_;
 
     // Auxiliary
     std::shared_ptr<std::vector<uint8_t>> serialized_request_;
-    std::priority_queue<PeerIdWithDistance> queue_;
-    size_t requests_in_progress_ = 0;
+    Query query_;
+    basic::Scheduler::Handle stall_timer_;
     bool started_ = false;
     std::atomic_bool done_ = false;
 
@@ -9,7 +9,6 @@
 #include <libp2p/protocol/kademlia/impl/response_handler.hpp>
 
 #include <memory>
-#include <queue>
 #include <unordered_set>
 
 #include <libp2p/common/types.hpp>
@@ -17,8 +16,8 @@
 #include <libp2p/log/sublogger.hpp>
 #include <libp2p/protocol/kademlia/common.hpp>
 #include <libp2p/protocol/kademlia/config.hpp>
-#include <libp2p/protocol/kademlia/impl/peer_id_with_distance.hpp>
 #include <libp2p/protocol/kademlia/impl/peer_routing_table.hpp>
+#include <libp2p/protocol/kademlia/impl/query.hpp>
 #include <libp2p/protocol/kademlia/impl/session.hpp>
 #include <libp2p/protocol/kademlia/impl/session_host.hpp>
 #include <libp2p/protocol/kademlia/peer_routing.hpp>
@@ -35,8 +34,11 @@ namespace libp2p::protocol::kademlia {
         std::shared_ptr<basic::Scheduler> scheduler,
         std::shared_ptr<SessionHost> session_host,
         const std::shared_ptr<PeerRoutingTable> &peer_routing_table,
+        std::shared_ptr<PeerLatencies> latencies,
         ContentId key,
-        FoundProvidersHandler handler);
+        size_t limit,
+        FoundProvidersHandler handler,
+        ProviderStreamHandler on_provider);
 
     ~FindProvidersExecutor() override;
 
@@ -59,7 +61,12 @@ namespace libp2p::protocol::kademlia {
     void spawn();
 
     /// Handles result of connection
-    void onConnected(StreamAndProtocolOrError stream_res);
+    void onConnected(const PeerId &peer_id,
+                     SessionOrError session_res);
+
+    /// Drops pending connections, so that executor is released
+    /// without waiting for slow peers
+    void cancel();
 
     static std::atomic_size_t instance_number;
 
@@ -69,16 +76,23 @@ namespace libp2p::protocol::kademlia {
     std::shared_ptr<basic::Scheduler> scheduler_;
     std::shared_ptr<SessionHost> session_host_;
     const Key content_id_;
+    /// Enough providers to complete search
+    const size_t limit_;
     FoundProvidersHandler handler_;
+    ProviderStreamHandler on_provider_;
 
     // Secondary
     const NodeId target_;
-    std::unordered_set<PeerId> nearest_peer_ids_;
 
     // Auxiliary
     std::shared_ptr<std::vector<uint8_t>> serialized_request_;
-    std::priority_queue<PeerIdWithDistance> queue_;
-    size_t requests_in_progress_ = 0;
+    Query query_;
+    basic::Scheduler::Handle stall_timer_;
+
+    using Connecting = std::pair<std::shared_ptr<FindProvidersExecutor>,
+                                 basic::Scheduler::Handle>;
+    std::vector<std::shared_ptr<Connecting>> connecting_;
+
     bool started_ = false;
     std::atomic_bool done_ = false;
 
@@ -0,0 +1,63 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <vector>
+
+#include <libp2p/protocol/kademlia/impl/peer_routing_table.hpp>
+
+namespace libp2p::protocol::kademlia {
+
+  /**
+   * In-memory table of all peers of network found by crawler, sorted by
+   * node id, so that it works as binary trie: peers sharing prefix with
+   * target are contiguous. Lookups start from its closest peers and finish
+   * in a single hop. Until the first crawl is done, nearest peers are taken
+   * from fallback routing table
+   */
+  class FullRoutingTable : public PeerRoutingTable {
+   public:
+    explicit FullRoutingTable(std::shared_ptr<PeerRoutingTable> fallback);
+
+    /// Replaces peers with ones found by crawl
+    void assign(const std::vector<peer::PeerId> &peers);
+
+    outcome::result<bool> update(const peer::PeerId &peer,
+                                 bool is_permanent,
+                                 bool is_connected) override;
+
+    void remove(const peer::PeerId &peer) override;
+
+    std::vector<peer::PeerId> getAllPeers() const override;
+
+    std::vector<peer::PeerId> getNearestPeers(const NodeId &node,
+                                              size_t count) override;
+
+    size_t size() const override;
+
+    /// Forwarded to fallback, which keeps peer quality
+    void onResponse(const peer::PeerId &peer, Time rtt) override;
+
+    void onFailure(const peer::PeerId &peer) override;
+
+   private:
+    struct Entry {
+      Hash256 hash;
+      peer::PeerId peer;
+    };
+
+    /// Range of peers sharing first `bits` of `target`
+    std::pair<size_t, size_t> prefixRange(const Hash256 &target,
+                                          size_t bits) const;
+
+    std::shared_ptr<PeerRoutingTable> fallback_;
+
+    /// Sorted by hash
+    std::vector<Entry> peers_;
+  };
+
+}  // namespace libp2p::protocol::kademlia
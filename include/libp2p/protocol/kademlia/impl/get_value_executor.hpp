@@ -12,7 +12,6 @@
 #include <boost/multi_index/member.hpp>
 #include <boost/multi_index_container_fwd.hpp>
 #include <memory>
-#include <queue>
 #include <unordered_set>
 
 #include <libp2p/common/types.hpp>
@@ -22,11 +21,11 @@
 #include <libp2p/protocol/kademlia/config.hpp>
 #include <libp2p/protocol/kademlia/impl/content_routing_table.hpp>
 #include <libp2p/protocol/kademlia/impl/executors_factory.hpp>
-#include <libp2p/protocol/kademlia/impl/peer_id_with_distance.hpp>
 #include <libp2p/protocol/kademlia/impl/peer_routing_table.hpp>
+#include <libp2p/protocol/kademlia/impl/query.hpp>
 #include <libp2p/protocol/kademlia/impl/session.hpp>
 #include <libp2p/protocol/kademlia/impl/session_host.hpp>
-#include <libp2p/protocol/kademlia/validator.hpp>
+#include <libp2p/protocol/kademlia/impl/validation_pool.hpp>
 
 namespace libp2p::protocol::kademlia {
 
@@ -41,10 +40,12 @@ namespace libp2p::protocol::kademlia {
         std::shared_ptr<SessionHost> session_host,
         std::shared_ptr<ContentRoutingTable> content_routing_table,
         const std::shared_ptr<PeerRoutingTable> &peer_routing_table,
+        std::shared_ptr<PeerLatencies> latencies,
         std::shared_ptr<ExecutorsFactory> executor_factory,
-        std::shared_ptr<Validator> validator,
+        std::shared_ptr<ValidationPool> validation_pool,
         ContentId key,
-        FoundValueHandler handler);
+        FoundValueHandler handler,
+        ValueStreamHandler on_value);
 
     ~GetValueExecutor() override;
 
@@ -65,10 +66,23 @@ namespace libp2p::protocol::kademlia {
     void spawn();
 
     /// Handles result of connection
-    void onConnected(StreamAndProtocolOrError stream_res);
+    void onConnected(const PeerId &peer_id,
+                     SessionOrError session_res);
 
+    /// Counts valid record, finishes if quorum of peers agree on value
+    void onValidated(const PeerId &peer,
+                     Value value,
+                     outcome::result<void> res);
+
+    /// Selects the best of received values
     void finish();
 
+    void onSelected(outcome::result<Value> best_res);
+
+    /// Drops pending connections, so that executor is released
+    /// without waiting for slow peers
+    void cancel();
+
     static std::atomic_size_t instance_number;
 
     // Primary
@@ -78,18 +92,22 @@ namespace libp2p::protocol::kademlia {
     std::shared_ptr<SessionHost> session_host_;
     std::shared_ptr<ContentRoutingTable> content_routing_table_;
     std::shared_ptr<ExecutorsFactory> executor_factory_;
-    std::shared_ptr<Validator> validator_;
+    std::shared_ptr<ValidationPool> validation_pool_;
     const ContentId key_;
     FoundValueHandler handler_;
+    ValueStreamHandler on_value_;
 
     // Secondary
     const NodeId target_;
-    std::unordered_set<PeerId> nearest_peer_ids_;
 
     // Auxiliary
     std::shared_ptr<std::vector<uint8_t>> serialized_request_;
-    std::priority_queue<PeerIdWithDistance> queue_;
-    size_t requests_in_progress_ = 0;
+    Query query_;
+    basic::Scheduler::Handle stall_timer_;
+
+    using Connecting = std::pair<std::shared_ptr<GetValueExecutor>,
+                                 basic::Scheduler::Handle>;
+    std::vector<std::shared_ptr<Connecting>> connecting_;
 
     struct ByPeerId;
     struct ByValue;
@@ -115,6 +133,10 @@ namespace libp2p::protocol::kademlia {
     bool started_ = false;
     bool done_ = false;
 
+    // Records being validated, and flag if best value is being selected
+    size_t validating_ = 0;
+    bool selecting_ = false;
+
     log::SubLogger log_;
   };
 
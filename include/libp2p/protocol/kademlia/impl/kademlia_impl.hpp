@@ -10,6 +10,7 @@
 #include <libp2p/protocol/kademlia/impl/session_host.hpp>
 #include <libp2p/protocol/kademlia/kademlia.hpp>
 
+#include <deque>
 #include <unordered_map>
 
 #include <libp2p/crypto/random_generator.hpp>
@@ -18,8 +19,15 @@
 #include <libp2p/log/sublogger.hpp>
 #include <libp2p/protocol/kademlia/config.hpp>
 #include <libp2p/protocol/kademlia/impl/content_routing_table.hpp>
+#include <libp2p/protocol/kademlia/impl/crawler.hpp>
 #include <libp2p/protocol/kademlia/impl/peer_routing_table.hpp>
+#include <libp2p/protocol/kademlia/impl/query.hpp>
+#include <libp2p/protocol/kademlia/impl/reprovider.hpp>
+#include <libp2p/protocol/kademlia/impl/request_pool.hpp>
+#include <libp2p/protocol/kademlia/impl/response_cache.hpp>
+#include <libp2p/protocol/kademlia/impl/session_pool.hpp>
 #include <libp2p/protocol/kademlia/impl/storage.hpp>
+#include <libp2p/protocol/kademlia/impl/validation_pool.hpp>
 #include <libp2p/protocol/kademlia/validator.hpp>
 
 namespace libp2p::protocol::kademlia {
@@ -59,14 +67,39 @@ namespace libp2p::protocol::kademlia {
     outcome::result<void> getValue(const Key &key,
                                    FoundValueHandler handler) override;
 
+    /// @see ValueStore::getValues
+    outcome::result<void> getValues(const std::vector<Key> &keys,
+                                    BatchValueHandler handler) override;
+
+    /// @see ValueStore::streamValues
+    outcome::result<void> streamValues(const Key &key,
+                                       ValueStreamHandler on_value,
+                                       FoundValueHandler handler) override;
+
     /// @see ContentRouting::provide
     outcome::result<void> provide(const Key &key, bool need_notify) override;
 
+    /// @see ContentRouting::provideBatch
+    outcome::result<void> provideBatch(const std::vector<Key> &keys) override;
+
     /// @see ContentRouting::findProviders
     outcome::result<void> findProviders(const Key &key,
                                         size_t limit,
                                         FoundProvidersHandler handler) override;
 
+    /// @see ContentRouting::findProvidersBatch
+    outcome::result<void> findProvidersBatch(
+        const std::vector<Key> &keys,
+        size_t limit,
+        BatchProvidersHandler handler) override;
+
+    /// @see ContentRouting::streamProviders
+    outcome::result<void> streamProviders(
+        const Key &key,
+        size_t limit,
+        ProviderStreamHandler on_provider,
+        FoundProvidersHandler handler) override;
+
     /// @see PeerRouting::addPeer
     void addPeer(const PeerInfo &peer_info,
                  bool permanent,
@@ -84,14 +117,35 @@ namespace libp2p::protocol::kademlia {
     std::shared_ptr<Session> openSession(
         std::shared_ptr<connection::Stream> stream) override;
 
+    /// @see SessionHost::getSession
+    void getSession(const PeerInfo &peer, OnSession on_session) override;
+
    private:
     void onPutValue(const std::shared_ptr<Session> &session, Message &&msg);
+    void onPutValueValidated(const std::shared_ptr<Session> &session,
+                             Message &&msg);
     void onGetValue(const std::shared_ptr<Session> &session, Message &&msg);
     void onAddProvider(const std::shared_ptr<Session> &session, Message &&msg);
     void onGetProviders(const std::shared_ptr<Session> &session, Message &&msg);
     void onFindNode(const std::shared_ptr<Session> &session, Message &&msg);
     void onPing(const std::shared_ptr<Session> &session, Message &&msg);
 
+    /// Writes response, caches it by key if cache is given
+    void respond(const std::shared_ptr<Session> &session,
+                 const Message &msg,
+                 ResponseCache *cache);
+
+    /// Fills and serializes response on request thread, then writes and
+    /// caches it like respond()
+    void respondOnWorker(const std::shared_ptr<Session> &session,
+                         Message &&msg,
+                         RequestPool::Fill fill,
+                         ResponseCache *cache);
+
+    /// Snapshot of routing table for request threads, rebuilt if routing
+    /// table changed or snapshot is older than TTL
+    std::shared_ptr<const NearestPeersSnapshot> nearestPeersSnapshot();
+
     void handleProtocol(StreamAndProtocol stream);
 
     std::shared_ptr<PutValueExecutor> createPutValueExecutor(
@@ -100,13 +154,18 @@ namespace libp2p::protocol::kademlia {
         std::vector<PeerId> addressees) override;
 
     std::shared_ptr<GetValueExecutor> createGetValueExecutor(
-        ContentId key, FoundValueHandler handler) override;
+        ContentId key,
+        FoundValueHandler handler,
+        ValueStreamHandler on_value) override;
 
     std::shared_ptr<AddProviderExecutor> createAddProviderExecutor(
         ContentId content_id) override;
 
     std::shared_ptr<FindProvidersExecutor> createGetProvidersExecutor(
-        ContentId content_id, FoundProvidersHandler handler) override;
+        ContentId content_id,
+        size_t limit,
+        FoundProvidersHandler handler,
+        ProviderStreamHandler on_provider) override;
 
     std::shared_ptr<FindPeerExecutor> createFindPeerExecutor(
         HashedKey key, FoundPeerInfoHandler handler) override;
@@ -114,6 +173,24 @@ namespace libp2p::protocol::kademlia {
     outcome::result<void> findRandomPeer() override;
     void randomWalk();
 
+    /// Looks up peer, adds it to routing table if found
+    outcome::result<void> findAndAddPeer(const PeerId &peer_id);
+
+    /// Looks up random ids in range of stale buckets, schedules next check
+    void refreshBuckets();
+
+    /// Adds peers of snapshot to routing table, checks them in background
+    void loadRoutingTable();
+
+    /// Saves routing table snapshot, schedules next saving
+    void saveRoutingTable();
+
+    /// Connects to loaded peers, removes unreachable ones
+    void checkLiveness();
+
+    /// Table lookups start from, full one in accelerated client mode
+    const std::shared_ptr<PeerRoutingTable> &lookupTable() const;
+
     // --- Primary (Injected) ---
 
     const Config &config_;
@@ -130,6 +207,38 @@ namespace libp2p::protocol::kademlia {
 
     const PeerId self_id_;
 
+    // Latencies of peers, shared by queries
+    std::shared_ptr<PeerLatencies> latencies_;
+
+    // Outgoing sessions kept for reuse
+    std::shared_ptr<SessionPool> session_pool_;
+
+    // Validates records off the network thread
+    std::shared_ptr<ValidationPool> validation_pool_;
+
+    // Completes responses off the network thread, if there are request
+    // threads
+    std::unique_ptr<RequestPool> request_pool_;
+
+    // Announces batches of provided keys, created on first use
+    std::shared_ptr<Reprovider> reprovider_;
+
+    // All peers of network, if accelerated client mode is enabled
+    std::shared_ptr<PeerRoutingTable> full_routing_table_;
+    std::shared_ptr<Crawler> crawler_;
+
+    // Serialized responses to hot keys
+    ResponseCache find_node_cache_;
+    ResponseCache get_providers_cache_;
+
+    // Incremented when caches are cleared, responses completed on request
+    // threads since older generation are not cached
+    size_t response_generation_ = 0;
+
+    // Routing table peers, shared with request threads
+    std::shared_ptr<const NearestPeersSnapshot> nearest_snapshot_;
+    Time nearest_snapshot_time_{};
+
     // --- Auxiliary ---
 
     // Flag if started early
@@ -139,12 +248,24 @@ namespace libp2p::protocol::kademlia {
     event::Handle new_connection_subscription_;
     event::Handle on_disconnected_;
 
+    // Invalidation of cached responses
+    event::Handle on_peer_added_;
+    event::Handle on_peer_removed_;
+    event::Handle on_provided_;
+
     // Random walk's auxiliary data
     struct {
       size_t iteration = 0;
       basic::Scheduler::Handle handle{};
     } random_walking_;
 
+    // Routing table snapshot's auxiliary data
+    struct {
+      std::deque<PeerInfo> unchecked;
+      size_t checking = 0;
+      basic::Scheduler::Handle handle{};
+    } snapshot_;
+
     log::SubLogger log_;
   };
 
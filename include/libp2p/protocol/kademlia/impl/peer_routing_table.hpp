@@ -49,6 +49,22 @@ namespace libp2p::protocol::kademlia {
 
     /// Returns the total number of peers in the routing table
     virtual size_t size() const = 0;
+
+    /// Remembers lookup of @param target, so that its bucket is fresh
+    virtual void onLookup(const NodeId & /*target*/, Time /*now*/) {}
+
+    /// Request to @param peer was answered within @param rtt
+    virtual void onResponse(const peer::PeerId & /*peer*/, Time /*rtt*/) {}
+
+    /// Request to @param peer failed or timed out
+    virtual void onFailure(const peer::PeerId & /*peer*/) {}
+
+    /// Returns common prefix lengths of buckets not looked up since
+    /// @param since, up to the deepest nonempty bucket and @param max_cpl
+    virtual std::vector<size_t> staleBuckets(Time /*since*/,
+                                             size_t /*max_cpl*/) const {
+      return {};
+    }
   };
 
 }  // namespace libp2p::protocol::kademlia
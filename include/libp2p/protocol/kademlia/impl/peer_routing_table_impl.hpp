@@ -10,7 +10,7 @@
 
 #include <boost/assert.hpp>
 #include <boost/optional.hpp>
-#include <list>
+#include <vector>
 
 #include <libp2p/event/bus.hpp>
 #include <libp2p/log/sublogger.hpp>
@@ -26,6 +26,10 @@ namespace libp2p::protocol::kademlia {
     bool is_replaceable;
     bool is_connected;
     NodeId node_id;
+    /// Moving average of request round trip time, zero if unknown
+    Time rtt{};
+    /// Requests failed in a row
+    size_t failures = 0;
     BucketPeerInfo(const PeerId &peer_id,
                    bool is_replaceable,
                    bool is_connected)
@@ -49,16 +53,14 @@ namespace libp2p::protocol::kademlia {
   };
 
   /**
-   * Single bucket which holds peers.
+   * Single bucket which holds peers, most recent first.
+   * Buckets are small, so peers are kept contiguous.
    */
   class Bucket {
    public:
     size_t size() const;
 
-    void append(const Bucket &bucket);
-
-    // sort bucket in ascending order by XOR distance from node_id
-    void sort(const NodeId &node_id);
+    const std::vector<BucketPeerInfo> &peers() const;
 
     auto find(const peer::PeerId &p) const;
 
@@ -68,9 +70,16 @@ namespace libp2p::protocol::kademlia {
                         bool is_replaceable,
                         bool is_connected);
 
-    boost::optional<PeerId> removeReplaceableItem();
+    /// Counts request answered within rtt, returns false if peer is unknown
+    bool onResponse(const PeerId &pid, Time rtt);
+
+    /// Counts failed request, returns false if peer is unknown
+    bool onFailure(const PeerId &pid);
 
-    void truncate(size_t limit);
+    /// Removes replaceable peer, which is not connected or has failed
+    /// `max_failures` requests in a row. The one with most failures, then
+    /// with the highest rtt, then the least recent is removed
+    boost::optional<PeerId> removeReplaceableItem(size_t max_failures);
 
     std::vector<peer::PeerId> peerIds() const;
 
@@ -79,7 +88,7 @@ namespace libp2p::protocol::kademlia {
     bool remove(const peer::PeerId &p);
 
    private:
-    std::list<BucketPeerInfo> peers_;
+    std::vector<BucketPeerInfo> peers_;
   };
 
   class PeerRoutingTableImpl
@@ -112,6 +121,15 @@ namespace libp2p::protocol::kademlia {
 
     size_t size() const override;
 
+    void onLookup(const NodeId &target, Time now) override;
+
+    void onResponse(const peer::PeerId &peer, Time rtt) override;
+
+    void onFailure(const peer::PeerId &peer) override;
+
+    std::vector<size_t> staleBuckets(Time since,
+                                     size_t max_cpl) const override;
+
    private:
     std::optional<size_t> getBucketIndex(const NodeId &key) const;
 
@@ -122,6 +140,20 @@ namespace libp2p::protocol::kademlia {
     const NodeId local_;
 
     std::array<Bucket, kBucketCount> buckets_;
+
+    /// Time of the last lookup of target in bucket
+    std::array<Time, kBucketCount> last_lookup_{};
+
+    struct Nearest {
+      /// Peers failing requests go after responsive ones
+      bool failing;
+      Hash256 distance;
+      const peer::PeerId *peer;
+    };
+
+    /// Candidates of getNearestPeers() with distances computed once, reused
+    /// between calls
+    std::vector<Nearest> nearest_;
   };
 
 }  // namespace libp2p::protocol::kademlia
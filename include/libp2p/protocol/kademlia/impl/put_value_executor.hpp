@@ -58,7 +58,7 @@ namespace libp2p::protocol::kademlia {
     void spawn();
 
     /// Handles result of connection
-    void onConnected(StreamAndProtocolOrError stream_res);
+    void onConnected(SessionOrError session_res);
 
     static std::atomic_size_t instance_number;
 
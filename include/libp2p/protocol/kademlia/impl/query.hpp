@@ -0,0 +1,130 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <boost/optional.hpp>
+
+#include <libp2p/protocol/kademlia/common.hpp>
+#include <libp2p/protocol/kademlia/config.hpp>
+#include <libp2p/protocol/kademlia/impl/peer_routing_table.hpp>
+#include <libp2p/protocol/kademlia/node_id.hpp>
+
+namespace libp2p::protocol::kademlia {
+
+  /**
+   * Moving average of request latency of peers, shared by queries.
+   * Number of peers is bounded, arbitrary peer is forgotten on overflow
+   */
+  class PeerLatencies {
+   public:
+    explicit PeerLatencies(size_t limit);
+
+    /// Adds sample of request latency
+    void update(const PeerId &peer, Time latency);
+
+    /// Average latency of peer, if known
+    boost::optional<Time> get(const PeerId &peer) const;
+
+    /// Average latency of known peers, if any
+    boost::optional<Time> average() const;
+
+   private:
+    size_t limit_;
+    std::unordered_map<PeerId, Time> latencies_;
+    Time sum_{};
+  };
+
+  /**
+   * Iterative lookup of peers closest to target, shared by executors.
+   * Candidates are split among disjoint paths, each path queries peers
+   * closest to target with `requestConcurency` requests, or more while some
+   * of them are stalled. Among the closest waiting candidates the one with
+   * lowest latency is queried first. Lookup is finished when `K` closest
+   * candidates of each path have responded
+   */
+  class Query {
+   public:
+    /// @param routing_table gets round trip times and failures of requests,
+    /// may be nullptr
+    Query(const Config &config,
+          const NodeId &target,
+          std::shared_ptr<PeerLatencies> latencies,
+          const std::vector<PeerId> &peers,
+          std::shared_ptr<PeerRoutingTable> routing_table = nullptr);
+
+    /// Next peer to query, marked as in progress
+    boost::optional<PeerId> next(Time now);
+
+    /// Peer responded with closer peers
+    void onSuccess(const PeerId &peer,
+                   const std::vector<PeerId> &closer_peers,
+                   Time now);
+
+    /// Peer failed to respond
+    void onFailure(const PeerId &peer, Time now);
+
+    /// Peer can't be queried, i.e. has no addresses
+    void onSkipped(const PeerId &peer);
+
+    /// All paths are finished
+    bool finished() const;
+
+    /// Number of requests in progress
+    size_t inProgress() const;
+
+    /// Number of candidates not queried yet
+    size_t waiting() const;
+
+    /// Request in progress for longer than this is stalled
+    Time stallTimeout() const;
+
+   private:
+    enum class State { WAITING, IN_PROGRESS, SUCCEEDED, FAILED };
+
+    struct Candidate {
+      PeerId peer;
+      Hash256 distance;
+      size_t path;
+      State state = State::WAITING;
+      Time started{};
+    };
+
+    struct Path {
+      size_t in_progress = 0;
+      bool finished = false;
+    };
+
+    /// Adds new candidate to path, keeping candidates sorted by distance
+    void add(const PeerId &peer, const NodeId &node_id, size_t path);
+
+    /// Ends request of the peer
+    Candidate *end(const PeerId &peer);
+
+    /// Updates finished flag of path
+    void updatePath(size_t path);
+
+    /// Number of requests path may have in progress
+    size_t concurrency(size_t path, Time now) const;
+
+    const Config &config_;
+    const NodeId target_;
+    std::shared_ptr<PeerLatencies> latencies_;
+    std::shared_ptr<PeerRoutingTable> routing_table_;
+    std::vector<Candidate> candidates_;
+    std::unordered_set<PeerId> seen_;
+    std::vector<Path> paths_;
+    size_t next_path_ = 0;
+    size_t in_progress_ = 0;
+    size_t waiting_ = 0;
+  };
+
+}  // namespace libp2p::protocol::kademlia
@@ -0,0 +1,88 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+#include <libp2p/basic/scheduler.hpp>
+#include <libp2p/host/host.hpp>
+#include <libp2p/log/sublogger.hpp>
+#include <libp2p/protocol/kademlia/common.hpp>
+#include <libp2p/protocol/kademlia/config.hpp>
+#include <libp2p/protocol/kademlia/impl/peer_routing_table.hpp>
+#include <libp2p/protocol/kademlia/impl/session_host.hpp>
+#include <libp2p/protocol/kademlia/node_id.hpp>
+
+namespace libp2p::protocol::kademlia {
+
+  /// Keys to announce grouped by peer they are sent to
+  using ProviderBatches = std::unordered_map<PeerId, std::vector<ContentId>>;
+
+  /**
+   * Assigns each key to its closest peers among candidates, so candidates
+   * are looked up once for keys of the same region
+   */
+  ProviderBatches batchProviderRecords(const std::vector<ContentId> &keys,
+                                       const std::vector<PeerId> &candidates,
+                                       size_t closest);
+
+  /**
+   * Leading bits shared by keys which have the same closest peers among
+   * known peers
+   */
+  size_t reproviderRegionBits(size_t known_peers, size_t closest);
+
+  /**
+   * Announces many provided keys at once. Keys are sorted by position in XOR
+   * space and taken region by region, candidates are looked up once per
+   * region, and all ADD_PROVIDER messages for one peer are written together.
+   * Regions are paced to reprovideRate messages per second
+   */
+  class Reprovider : public std::enable_shared_from_this<Reprovider> {
+   public:
+    Reprovider(const Config &config,
+               std::shared_ptr<Host> host,
+               std::shared_ptr<basic::Scheduler> scheduler,
+               std::weak_ptr<SessionHost> session_host,
+               std::shared_ptr<PeerRoutingTable> peer_routing_table);
+
+    ~Reprovider();
+
+    /// Queues keys for announcement
+    void provide(const std::vector<ContentId> &keys);
+
+    /// Keys waiting for announcement
+    size_t queued() const {
+      return queue_.size();
+    }
+
+   private:
+    /// Takes next region from queue and sends its messages
+    void announceRegion();
+    void sendBatch(const PeerId &peer_id, const std::vector<ContentId> &keys);
+    void onBatchDone(size_t messages, bool success);
+
+    const Config &config_;
+    std::shared_ptr<Host> host_;
+    std::shared_ptr<basic::Scheduler> scheduler_;
+    std::weak_ptr<SessionHost> session_host_;
+    std::shared_ptr<PeerRoutingTable> peer_routing_table_;
+
+    /// Keys ordered by hash
+    std::map<Hash256, ContentId> queue_;
+    /// Batches of current region not finished yet
+    size_t batches_in_progress_ = 0;
+    /// Messages of current region, to pace the next one
+    size_t region_messages_ = 0;
+    basic::Scheduler::Handle pacing_timer_;
+
+    log::SubLogger log_;
+  };
+
+}  // namespace libp2p::protocol::kademlia
@@ -0,0 +1,72 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include <boost/asio/thread_pool.hpp>
+
+#include <libp2p/basic/scheduler.hpp>
+#include <libp2p/protocol/kademlia/message.hpp>
+#include <libp2p/protocol/kademlia/node_id.hpp>
+
+namespace libp2p::protocol::kademlia {
+
+  /**
+   * Immutable copy of routing table peers, which have addresses, with their
+   * addresses and connectedness. Read by worker threads without locks and
+   * replaced as a whole by the network thread (RCU-style), so readers keep
+   * the copy they took
+   */
+  class NearestPeersSnapshot {
+   public:
+    struct Entry {
+      NodeId node_id;
+      Message::Peer peer;
+    };
+
+    explicit NearestPeersSnapshot(std::vector<Entry> entries);
+
+    /// Up to `count` peers nearest to node, the nearest first
+    Message::Peers nearest(const NodeId &node, size_t count) const;
+
+    size_t size() const {
+      return entries_.size();
+    }
+
+   private:
+    std::vector<Entry> entries_;
+  };
+
+  /**
+   * Completes responses to requests on worker threads: selects nearest peers
+   * from snapshot and serializes response, so that large responses don't
+   * block network thread. Handlers are called on scheduler thread
+   */
+  class RequestPool {
+   public:
+    /// Fills response on worker, returns whether it may be cached
+    using Fill = std::function<bool(Message &)>;
+    using Handler = std::function<void(Bytes frame, bool cacheable)>;
+
+    RequestPool(std::shared_ptr<basic::Scheduler> scheduler, size_t threads);
+
+    /// Waits for running requests, pending ones are dropped and their
+    /// handlers are not called
+    ~RequestPool();
+
+    /// Handler is not called if response fails to serialize
+    void respond(Message msg, Fill fill, Handler handler);
+
+   private:
+    std::shared_ptr<basic::Scheduler> scheduler_;
+    boost::asio::thread_pool pool_;
+  };
+
+}  // namespace libp2p::protocol::kademlia
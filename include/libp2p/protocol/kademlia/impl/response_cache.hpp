@@ -0,0 +1,58 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <deque>
+#include <optional>
+#include <unordered_map>
+
+#include <libp2p/protocol/kademlia/common.hpp>
+
+namespace libp2p::protocol::kademlia {
+
+  /**
+   * Serialized responses to requests by key, kept for short TTL. All entries
+   * have the same TTL, so the oldest one is evicted when cache is full.
+   * Owner clears entries when data they were built from changes
+   */
+  class ResponseCache {
+   public:
+    /// Zero TTL or size disables cache
+    ResponseCache(Time ttl, size_t max_size);
+
+    /// Returns response frame if cached and not expired
+    std::optional<BytesIn> get(const ContentId &key, Time now) const;
+
+    /// Caches response frame
+    void put(const ContentId &key, Bytes frame, Time now);
+
+    /// Drops response to key
+    void erase(const ContentId &key);
+
+    /// Drops all responses
+    void clear();
+
+    size_t size() const {
+      return entries_.size();
+    }
+
+   private:
+    struct Entry {
+      Bytes frame;
+      Time expires;
+    };
+
+    const Time ttl_;
+    const size_t max_size_;
+    std::unordered_map<ContentId, Entry> entries_;
+
+    /// Keys in order of insertion, i.e. of expiry. Stale if entry was erased
+    /// or put again
+    std::deque<std::pair<ContentId, Time>> order_;
+  };
+
+}  // namespace libp2p::protocol::kademlia
@@ -0,0 +1,33 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <libp2p/protocol/kademlia/common.hpp>
+
+namespace libp2p::protocol::kademlia {
+
+  /**
+   * Encodes peers of routing table with their addresses: uvarint version,
+   * uvarint number of peers, then for each peer length prefixed id, uvarint
+   * number of addresses and length prefixed addresses
+   */
+  Bytes encodeRoutingTableSnapshot(const std::vector<PeerInfo> &peers);
+
+  outcome::result<std::vector<PeerInfo>> decodeRoutingTableSnapshot(
+      BytesIn bytes);
+
+  /// Writes snapshot to temporary file, then renames it to the path
+  outcome::result<void> saveRoutingTableSnapshot(
+      const std::string &path, const std::vector<PeerInfo> &peers);
+
+  outcome::result<std::vector<PeerInfo>> loadRoutingTableSnapshot(
+      const std::string &path);
+
+}  // namespace libp2p::protocol::kademlia
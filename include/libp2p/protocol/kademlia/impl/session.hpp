@@ -7,12 +7,14 @@
 #pragma once
 
 #include <atomic>
+#include <deque>
 #include <functional>
 
+#include <libp2p/basic/timer.hpp>
 #include <libp2p/protocol/kademlia/message.hpp>
 
 namespace libp2p::basic {
-  class MessageReadWriterUvarint;
+  class MessageBatchReader;
   class Scheduler;
 }  // namespace libp2p::basic
 
@@ -38,22 +40,63 @@ namespace libp2p::protocol::kademlia {
     void read(std::shared_ptr<ResponseHandler> response_handler);
     void write(const Message &msg,
                std::weak_ptr<SessionHost> weak_session_host);
+    /// Writes serialized response, then reads next request
+    void write(BytesIn frame, std::weak_ptr<SessionHost> weak_session_host);
+    /**
+     * Sends request and passes response to handler. Several requests may be
+     * pipelined over the session, responses are matched in order of requests
+     */
     void write(BytesIn frame,
                std::shared_ptr<ResponseHandler> response_handler);
     void write(BytesIn frame);
 
+    /**
+     * Queues frames which have no response, they are written in order with
+     * pipelined requests
+     */
+    void send(BytesIn frames, OnWrite on_write);
+
     std::shared_ptr<connection::Stream> stream() const {
       return stream_;
     }
 
+    /// Number of requests waiting for response
+    size_t pending() const {
+      return response_handlers_.size();
+    }
+
+    /// Session failed and can't be used for requests anymore
+    bool closed() const;
+
    private:
     void setTimer();
 
+    void writeRequests();
+    void readResponse();
+    /// Resets stream and fails all pending requests
+    void fail(const std::error_code &error);
+
     std::weak_ptr<basic::Scheduler> scheduler_;
     std::shared_ptr<connection::Stream> stream_;
     const Time operations_timeout_;
 
-    std::shared_ptr<basic::MessageReadWriterUvarint> framing_;
-    Cancel timer_;
+    std::shared_ptr<basic::MessageBatchReader> reader_;
+    basic::Timer timer_;
+
+    /// Messages received in one batch with previous ones, not read yet
+    std::deque<outcome::result<Message>> received_;
+
+    struct Request {
+      Bytes frames;
+      /// Called when written, if any
+      OnWrite on_write;
+    };
+
+    /// Requests not written yet
+    std::deque<Request> requests_;
+    std::deque<std::shared_ptr<ResponseHandler>> response_handlers_;
+    bool writing_ = false;
+    bool reading_ = false;
+    bool failed_ = false;
   };
 }  // namespace libp2p::protocol::kademlia
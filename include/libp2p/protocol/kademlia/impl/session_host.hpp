@@ -8,10 +8,16 @@
 
 #include <libp2p/protocol/kademlia/impl/message_observer.hpp>
 
+#include <functional>
+
+#include <libp2p/peer/peer_info.hpp>
+
 namespace libp2p::protocol::kademlia {
 
   class Session;
 
+  using SessionOrError = outcome::result<std::shared_ptr<Session>>;
+
   class SessionHost : public MessageObserver {
    public:
     virtual ~SessionHost() = default;
@@ -19,6 +25,13 @@ namespace libp2p::protocol::kademlia {
     /// Opens new session for stream
     virtual std::shared_ptr<Session> openSession(
         std::shared_ptr<connection::Stream> stream) = 0;
+
+    using OnSession = std::function<void(SessionOrError)>;
+
+    /// Gives session to send requests to peer, reusing open stream if
+    /// possible
+    virtual void getSession(const peer::PeerInfo &peer,
+                            OnSession on_session) = 0;
   };
 
 }  // namespace libp2p::protocol::kademlia
@@ -0,0 +1,69 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+#include <libp2p/basic/scheduler.hpp>
+#include <libp2p/host/host.hpp>
+#include <libp2p/protocol/kademlia/common.hpp>
+#include <libp2p/protocol/kademlia/config.hpp>
+#include <libp2p/protocol/kademlia/impl/session.hpp>
+#include <libp2p/protocol/kademlia/impl/session_host.hpp>
+
+namespace libp2p::protocol::kademlia {
+
+  /**
+   * Keeps outgoing sessions open, so requests to the same peer don't pay
+   * for new stream and its protocol negotiation. Idle session is preferred,
+   * then new stream while there are less than allowed, then pipelining over
+   * the least loaded session. When all sessions are full, extra session is
+   * opened, which is not kept after request
+   */
+  class SessionPool : public std::enable_shared_from_this<SessionPool> {
+   public:
+    using OnSession = SessionHost::OnSession;
+
+    SessionPool(const Config &config,
+                std::shared_ptr<Host> host,
+                std::shared_ptr<basic::Scheduler> scheduler);
+
+    /// Gives session to send requests to peer, opens stream if needed
+    void getSession(const PeerInfo &peer, OnSession on_session);
+
+    /// Number of kept sessions with peer
+    size_t sessions(const PeerId &peer_id) const;
+
+   private:
+    struct Entry {
+      std::shared_ptr<Session> session;
+      Time used;
+    };
+
+    void openSession(const PeerInfo &peer, bool keep, OnSession on_session);
+    void onStream(const PeerId &peer_id,
+                  bool keep,
+                  StreamAndProtocolOrError stream_res,
+                  const OnSession &on_session);
+
+    /// Closes failed sessions and ones idle for timeout
+    void onCleanupTimer();
+    void setCleanupTimer();
+
+    const Config &config_;
+    std::shared_ptr<Host> host_;
+    std::shared_ptr<basic::Scheduler> scheduler_;
+
+    std::unordered_map<PeerId, std::vector<Entry>> sessions_;
+    /// Streams being opened to be kept
+    std::unordered_map<PeerId, size_t> opening_;
+    basic::Scheduler::Handle cleanup_timer_;
+  };
+
+}  // namespace libp2p::protocol::kademlia
@@ -0,0 +1,164 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <libp2p/protocol/kademlia/storage_backend.hpp>
+
+#include <functional>
+#include <string>
+#include <unordered_map>
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <boost/optional.hpp>
+
+#include <libp2p/basic/scheduler.hpp>
+#include <libp2p/protocol/kademlia/config.hpp>
+
+namespace libp2p::protocol::kademlia {
+
+  /**
+   * Backend keeping values in memory mapped append-only log, so value sets
+   * larger than RAM are paged in by OS on demand, and survive restart.
+   * Only keys and positions of their latest records are kept in memory.
+   * Overwritten and erased records are garbage, when it exceeds configured
+   * part of log, live records are copied to new log by steps of batch size
+   * on scheduler, then new log replaces old one
+   */
+  class StorageBackendMmap
+      : public StorageBackend,
+        public std::enable_shared_from_this<StorageBackendMmap> {
+   public:
+    static outcome::result<std::shared_ptr<StorageBackendMmap>> create(
+        const Config &config,
+        std::string path,
+        std::shared_ptr<basic::Scheduler> scheduler);
+
+    /// Syncs mapped log to file
+    ~StorageBackendMmap() override;
+
+    outcome::result<void> putValue(Key key, Value value) override;
+
+    /// Copies value straight from mapped log
+    outcome::result<Value> getValue(const Key &key) const override;
+
+    outcome::result<void> erase(const Key &key) override;
+
+    std::vector<std::pair<Key, Time>> storedValues() const override;
+
+    /// Value in mapped log without copying, valid until next change of
+    /// backend
+    outcome::result<BytesIn> viewValue(const Key &key) const;
+
+    /// Compacts log at once, finishing compaction in progress if any
+    outcome::result<void> compact();
+
+    /// Bytes used by log, and by garbage records of it
+    size_t logSize() const;
+    size_t garbageSize() const;
+
+   private:
+    /// Position of value of record in log
+    struct Location {
+      size_t offset = 0;
+      uint32_t value_size = 0;
+      Time stored_at{};
+    };
+
+    using Index = std::unordered_map<Key, Location>;
+
+    /// Mapped file, grown by doubling when appended record doesn't fit
+    class Log {
+     public:
+      /// Opens log, calls `on_record` for records in order they were written
+      static outcome::result<std::unique_ptr<Log>> open(
+          const std::string &path,
+          const std::function<void(
+              BytesIn key, boost::optional<Location> location)> &on_record);
+
+      /// Appends record, none value for erase
+      outcome::result<Location> append(BytesIn key,
+                                       boost::optional<BytesIn> value,
+                                       Time stored_at);
+
+      BytesIn view(const Location &location) const;
+
+      outcome::result<void> sync();
+
+      /// Renames file, mapping stays valid
+      outcome::result<void> rename(const std::string &path);
+
+      const std::string &path() const;
+      size_t size() const;
+
+     private:
+      Log(std::string path, size_t capacity);
+
+      /// Resizes file to capacity and maps it again
+      outcome::result<void> map(size_t capacity);
+
+      uint8_t *data() const;
+
+      std::string path_;
+      size_t capacity_;
+      size_t end_;
+      boost::interprocess::file_mapping mapping_;
+      boost::interprocess::mapped_region region_;
+    };
+
+    /// Log being compacted into, and keys of old log left to copy
+    struct Compaction {
+      std::unique_ptr<Log> log;
+      Index index;
+      size_t garbage = 0;
+      std::vector<Key> keys;
+      size_t next = 0;
+    };
+
+    StorageBackendMmap(const Config &config,
+                       std::unique_ptr<Log> log,
+                       Index index,
+                       size_t garbage,
+                       std::shared_ptr<basic::Scheduler> scheduler);
+
+    /// Bytes taken by record in log
+    static size_t recordSize(const Key &key, const Location &location);
+
+    /// Points key to its latest record, none location for erase, counts
+    /// garbage left by previous record
+    static void indexRecord(Index &index,
+                            size_t &garbage,
+                            Key key,
+                            boost::optional<Location> location);
+
+    /// Appends record to log and to compacted log if any, updates indices
+    outcome::result<void> write(const Key &key,
+                                boost::optional<BytesIn> value,
+                                Time stored_at);
+
+    /// Starts compaction in background if there is enough garbage
+    void maybeCompact();
+
+    outcome::result<void> startCompaction();
+    void abortCompaction();
+
+    /// Copies batch of live records, replaces log when all are copied
+    outcome::result<void> compactStep(size_t batch);
+
+    void scheduleCompactStep();
+
+    const Config &config_;
+    std::unique_ptr<Log> log_;
+    Index index_;
+    size_t garbage_;
+    std::shared_ptr<basic::Scheduler> scheduler_;
+
+    boost::optional<Compaction> compaction_;
+    basic::Scheduler::Handle compaction_timer_;
+  };
+
+}  // namespace libp2p::protocol::kademlia
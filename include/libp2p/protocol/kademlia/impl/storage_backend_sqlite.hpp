@@ -0,0 +1,75 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <libp2p/protocol/kademlia/storage_backend.hpp>
+
+#include <unordered_map>
+
+#include <boost/optional.hpp>
+
+#include <libp2p/basic/scheduler.hpp>
+#include <libp2p/common/lru_cache.hpp>
+#include <libp2p/protocol/kademlia/config.hpp>
+#include <libp2p/storage/sqlite.hpp>
+
+namespace libp2p::protocol::kademlia {
+
+  /**
+   * Backend keeping values in SQLite database, so they survive restart.
+   * Recently used values are cached, changes are written in batches
+   */
+  class StorageBackendSqlite
+      : public StorageBackend,
+        public std::enable_shared_from_this<StorageBackendSqlite> {
+   public:
+    StorageBackendSqlite(const Config &config,
+                         std::shared_ptr<storage::SQLite> db,
+                         std::shared_ptr<basic::Scheduler> scheduler);
+
+    /// Writes pending changes
+    ~StorageBackendSqlite() override;
+
+    outcome::result<void> putValue(Key key, Value value) override;
+
+    outcome::result<Value> getValue(const Key &key) const override;
+
+    outcome::result<void> erase(const Key &key) override;
+
+    std::vector<std::pair<Key, Time>> storedValues() const override;
+
+    /// Writes pending changes in one transaction
+    outcome::result<void> flush();
+
+   private:
+    /// Value to write, none to erase
+    struct Change {
+      boost::optional<Value> value;
+      Time stored_at{};
+    };
+
+    void addChange(const Key &key, Change change);
+    void setFlushTimer();
+
+    const Config &config_;
+    std::shared_ptr<storage::SQLite> db_;
+    std::shared_ptr<basic::Scheduler> scheduler_;
+
+    storage::SQLite::StatementHandle begin_;
+    storage::SQLite::StatementHandle commit_;
+    storage::SQLite::StatementHandle rollback_;
+    storage::SQLite::StatementHandle select_;
+    storage::SQLite::StatementHandle select_ages_;
+    storage::SQLite::StatementHandle upsert_;
+    storage::SQLite::StatementHandle delete_;
+
+    mutable LruCache<Key, Value> cache_;
+    std::unordered_map<Key, Change> changes_;
+    basic::Scheduler::Handle flush_timer_;
+  };
+
+}  // namespace libp2p::protocol::kademlia
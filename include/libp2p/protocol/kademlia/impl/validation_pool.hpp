@@ -0,0 +1,50 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include <boost/asio/thread_pool.hpp>
+
+#include <libp2p/basic/scheduler.hpp>
+#include <libp2p/protocol/kademlia/validator.hpp>
+
+namespace libp2p::protocol::kademlia {
+
+  /**
+   * Runs validator on worker threads, so that signature checks of records
+   * don't block network thread. Handlers are called on scheduler thread.
+   * With zero threads validator is called in place and handlers are called
+   * before return
+   */
+  class ValidationPool {
+   public:
+    using ValidateHandler = std::function<void(outcome::result<void>)>;
+    using SelectHandler = std::function<void(outcome::result<Value>)>;
+
+    ValidationPool(std::shared_ptr<Validator> validator,
+                   std::shared_ptr<basic::Scheduler> scheduler,
+                   size_t threads);
+
+    /// Waits for running validations, pending ones are dropped and their
+    /// handlers are not called
+    ~ValidationPool();
+
+    void validate(Key key, Value value, ValidateHandler handler);
+
+    /// Selects the best of candidate values in one call, handler gets it
+    void select(Key key, std::vector<Value> values, SelectHandler handler);
+
+   private:
+    std::shared_ptr<Validator> validator_;
+    std::shared_ptr<basic::Scheduler> scheduler_;
+    std::unique_ptr<boost::asio::thread_pool> pool_;
+  };
+
+}  // namespace libp2p::protocol::kademlia
@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <bit>
 #include <bitset>
 #include <climits>
 #include <cstring>
@@ -26,16 +27,7 @@ namespace libp2p::protocol::kademlia {
 
   /// count number of leading zeros in bin representation
   inline size_t leadingZerosInByte(uint8_t byte) {
-    size_t ret = 0u;
-    static constexpr const uint8_t msb = 1u << 7u;
-
-    // if most significant bit is set, terminate the loop
-    while ((byte & msb) == 0) {
-      ret++;
-      byte <<= 1u;
-    }
-
-    return ret;
+    return std::countl_zero(byte);
   }
 
   inline auto xor_distance(const Hash256 &a, const Hash256 &b) {
@@ -67,6 +59,23 @@ namespace libp2p::protocol::kademlia {
       return prehashed(crypto::sha256(key).value());
     }
 
+    /// Node ids of peers, hashed as one batch
+    static std::vector<NodeId> fromPeers(std::span<const peer::PeerId> peers) {
+      std::vector<BytesIn> inputs;
+      inputs.reserve(peers.size());
+      for (auto &peer : peers) {
+        inputs.emplace_back(peer.toVector());
+      }
+      std::vector<Hash256> hashes(peers.size());
+      crypto::sha256Batch(inputs, hashes);
+      std::vector<NodeId> ids;
+      ids.reserve(hashes.size());
+      for (auto &hash : hashes) {
+        ids.emplace_back(prehashed(hash));
+      }
+      return ids;
+    }
+
     inline bool operator==(const NodeId &other) const {
       return data_ == other.data_;
     }
@@ -25,6 +25,12 @@ namespace libp2p::protocol::kademlia {
 
     /// Removes value corresponded to given @param key.
     virtual outcome::result<void> erase(const Key &key) = 0;
+
+    /// Keys of values kept by persistent backend since previous run, with
+    /// time elapsed since they were put
+    virtual std::vector<std::pair<Key, Time>> storedValues() const {
+      return {};
+    }
   };
 
 }  // namespace libp2p::protocol::kademlia
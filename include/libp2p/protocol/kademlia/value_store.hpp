@@ -23,6 +23,37 @@ namespace libp2p::protocol::kademlia {
     /// Searches for the @return value corresponding to given @param key.
     virtual outcome::result<void> getValue(const Key &key,
                                            FoundValueHandler handler) = 0;
+
+    /// Searches for value, passing each distinct valid value to @param
+    /// on_value as it arrives. Search completes as soon as
+    /// `Config::valueLookupsQuorum` peers agree on value, then @param handler
+    /// gets the best one.
+    virtual outcome::result<void> streamValues(const Key &key,
+                                               ValueStreamHandler on_value,
+                                               FoundValueHandler handler) {
+      return getValue(
+          key,
+          [on_value{std::move(on_value)}, handler{std::move(handler)}](
+              outcome::result<Value> res) {
+            if (res.has_value()) {
+              on_value(res.value());
+            }
+            handler(std::move(res));
+          });
+    }
+
+    /// Searches for values of many @param keys at once, @param handler is
+    /// called once for each key. Implementation may share peers and sessions
+    /// between lookups of keys.
+    virtual outcome::result<void> getValues(const std::vector<Key> &keys,
+                                            BatchValueHandler handler) {
+      for (auto &key : keys) {
+        OUTCOME_TRY(getValue(key, [key, handler](outcome::result<Value> res) {
+          handler(key, std::move(res));
+        }));
+      }
+      return outcome::success();
+    }
   };
 
 }  // namespace libp2p::protocol::kademlia
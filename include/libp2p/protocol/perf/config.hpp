@@ -0,0 +1,20 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace libp2p::protocol {
+  struct PerfConfig {
+    /// bytes read or written by one stream operation
+    size_t buffer_size = 64 << 10;
+
+    /// max bytes server sends on one stream, larger requests are reset
+    uint64_t max_download = uint64_t{16} << 30;
+  };
+}  // namespace libp2p::protocol
@@ -0,0 +1,78 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <chrono>
+
+#include <libp2p/host/host.hpp>
+#include <libp2p/protocol/base_protocol.hpp>
+#include <libp2p/protocol/perf/config.hpp>
+
+namespace libp2p::protocol {
+  /// Times of one perf run, as measured by client
+  struct PerfResult {
+    using Duration = std::chrono::steady_clock::duration;
+
+    /// from opening stream till protocol is negotiated, connection setup
+    /// included if there was no connection
+    Duration stream_setup{};
+
+    /// from negotiation till all bytes are written and stream is closed for
+    /// writes
+    Duration upload{};
+
+    /// from end of upload till all bytes are read
+    Duration download{};
+
+    uint64_t uploaded = 0;
+    uint64_t downloaded = 0;
+  };
+
+  /**
+   * Perf protocol "/perf/1.0.0" measuring throughput between peers.
+   * Client writes 8 bytes big endian size of download, uploads data and
+   * closes stream for writes. Server reads till end of stream, writes
+   * requested bytes and closes stream.
+   */
+  class Perf : public BaseProtocol, public std::enable_shared_from_this<Perf> {
+   public:
+    static constexpr auto kProtocolId = "/perf/1.0.0";
+
+    using Callback = std::function<void(outcome::result<PerfResult>)>;
+
+    explicit Perf(Host &host, PerfConfig config = {});
+
+    peer::ProtocolName getProtocolId() const override;
+
+    void handle(StreamAndProtocol stream) override;
+
+    /// Sets protocol handler to serve incoming streams
+    void start();
+
+    /**
+     * Uploads bytes to peer and downloads bytes from it over new stream
+     * @param cb is called once, with times or error
+     */
+    void run(const peer::PeerInfo &peer,
+             uint64_t upload,
+             uint64_t download,
+             Callback cb);
+
+   private:
+    struct Session;
+
+    void serveRead(std::shared_ptr<Session> session);
+    void serveWrite(std::shared_ptr<Session> session);
+    void upload(std::shared_ptr<Session> session);
+    void download(std::shared_ptr<Session> session);
+
+    Host &host_;
+    PerfConfig config_;
+    /// zeros written by uploads and downloads
+    Bytes zeros_;
+  };
+}  // namespace libp2p::protocol
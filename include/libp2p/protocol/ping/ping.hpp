@@ -48,7 +48,8 @@ namespace libp2p::protocol {
     void handle(StreamAndProtocol stream) override;
 
     /**
-     * Start pinging the peer
+     * Start pinging the peer, with muxer ping frames if connection supports
+     * them, otherwise over a stream of this protocol
      * @param conn to the peer we want to ping
      * @param cb to be called, when a ping session is started, or error happens
      */
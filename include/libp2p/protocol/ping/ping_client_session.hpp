@@ -10,6 +10,7 @@
 #include <vector>
 
 #include <libp2p/basic/scheduler.hpp>
+#include <libp2p/connection/capable_connection.hpp>
 #include <libp2p/connection/stream.hpp>
 #include <libp2p/crypto/random_generator.hpp>
 #include <libp2p/event/bus.hpp>
@@ -33,11 +34,22 @@ namespace libp2p::protocol {
   class PingClientSession
       : public std::enable_shared_from_this<PingClientSession> {
    public:
+    /// Called with round trip time of each successful ping
+    using OnRtt = std::function<void(std::chrono::milliseconds)>;
+
     PingClientSession(std::shared_ptr<basic::Scheduler> scheduler,
                       libp2p::event::Bus &bus,
                       std::shared_ptr<connection::Stream> stream,
                       std::shared_ptr<crypto::random::RandomGenerator> rand_gen,
-                      PingConfig config);
+                      PingConfig config,
+                      OnRtt on_rtt = {});
+
+    /// Pings with muxer ping frames of connection, which supports them
+    PingClientSession(std::shared_ptr<basic::Scheduler> scheduler,
+                      libp2p::event::Bus &bus,
+                      const std::shared_ptr<connection::CapableConnection> &conn,
+                      PingConfig config,
+                      OnRtt on_rtt = {});
 
     void start();
 
@@ -52,6 +64,14 @@ namespace libp2p::protocol {
 
     void readCompleted(outcome::result<size_t> r);
 
+    /// Sends muxer ping instead of writing to stream
+    void ping();
+
+    void pingCompleted(outcome::result<std::chrono::microseconds> r);
+
+    /// Schedules the next ping after round trip time was measured
+    void pinged();
+
     void close();
 
     std::shared_ptr<basic::Scheduler> scheduler_;
@@ -59,10 +79,14 @@ namespace libp2p::protocol {
     decltype(bus_.getChannel<event::protocol::PeerIsDeadChannel>()) channel_;
 
     std::shared_ptr<connection::Stream> stream_;
+    /// Set instead of stream_ for muxer pings
+    std::weak_ptr<connection::CapableConnection> conn_;
     std::shared_ptr<crypto::random::RandomGenerator> rand_gen_;
     PingConfig config_;
+    OnRtt on_rtt_;
 
     std::vector<uint8_t> write_buffer_, read_buffer_;
+    std::chrono::milliseconds sent_at_{};
     basic::Scheduler::Handle timer_;
     bool closed_ = false;
 
@@ -0,0 +1,63 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <libp2p/host/host.hpp>
+#include <libp2p/protocol/base_protocol.hpp>
+#include <libp2p/protocol/relay/config.hpp>
+
+namespace libp2p::protocol::relay {
+  /**
+   * Circuit relay v2 client.
+   * Reserves slots on relays to be reachable through them, connects to peers
+   * through relays, and accepts circuits over stop protocol.
+   * Relayed streams are raw, it is up to user to secure and multiplex them.
+   */
+  class RelayClient : public BaseProtocol,
+                      public std::enable_shared_from_this<RelayClient> {
+   public:
+    struct Reservation {
+      std::chrono::system_clock::time_point expire;
+      /// addresses of relay
+      std::vector<Multiaddress> addresses;
+      /// limits of circuits
+      Limit limit;
+    };
+
+    using ReserveCb = std::function<void(outcome::result<Reservation>)>;
+
+    using ConnectCb = std::function<void(
+        outcome::result<std::shared_ptr<connection::Stream>>)>;
+
+    /// Receives circuit from peer, connected through relay
+    using CircuitHandler =
+        std::function<void(const PeerId &peer,
+                           const Limit &limit,
+                           std::shared_ptr<connection::Stream> stream)>;
+
+    explicit RelayClient(Host &host);
+
+    peer::ProtocolName getProtocolId() const override;
+
+    void handle(StreamAndProtocol stream) override;
+
+    /// Sets stop protocol handler to accept circuits
+    void start(CircuitHandler handler);
+
+    /// Reserves slot on relay, reservation must be refreshed before expiry
+    void reserve(const peer::PeerInfo &relay, ReserveCb cb);
+
+    /// Connects to peer, which has reservation on relay
+    void connect(const peer::PeerInfo &relay,
+                 const PeerId &peer,
+                 ConnectCb cb);
+
+   private:
+    Host &host_;
+    CircuitHandler handler_;
+  };
+}  // namespace libp2p::protocol::relay
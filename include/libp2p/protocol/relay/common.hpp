@@ -0,0 +1,17 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <string>
+
+namespace libp2p::protocol::relay {
+  /// Protocol of clients talking to relay
+  const std::string kHopProto = "/libp2p/circuit/relay/0.2.0/hop";
+
+  /// Protocol of relay talking to circuit target
+  const std::string kStopProto = "/libp2p/circuit/relay/0.2.0/stop";
+}  // namespace libp2p::protocol::relay
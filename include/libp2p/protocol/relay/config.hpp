@@ -0,0 +1,52 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace libp2p::protocol::relay {
+  /// Limits of one relayed circuit, zero means unlimited
+  struct Limit {
+    std::chrono::seconds duration{0};
+
+    /// bytes relayed in each direction
+    uint64_t data = 0;
+
+    bool operator==(const Limit &) const = default;
+  };
+
+  struct RelayConfig {
+    /// reservations held at once
+    size_t max_reservations = 128;
+
+    /// how long reservation lasts, unless it is refreshed
+    std::chrono::seconds reservation_ttl = std::chrono::hours{1};
+
+    /// circuits relayed at once
+    size_t max_circuits = 1024;
+
+    /// circuits relayed at once from or to one peer
+    size_t max_circuits_per_peer = 16;
+
+    /// limits of each circuit
+    Limit limit{
+        .duration = std::chrono::minutes{2},
+        .data = 128 << 10,
+    };
+
+    /// how long target may take to accept circuit
+    std::chrono::milliseconds connect_timeout = std::chrono::seconds{10};
+
+    /// size of pooled buffer of each circuit direction
+    size_t buffer_size = 16 << 10;
+
+    /// pooled buffers kept for reuse
+    size_t max_free_buffers = 256;
+  };
+}  // namespace libp2p::protocol::relay
@@ -0,0 +1,42 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <qtils/enum_error_code.hpp>
+
+namespace libp2p {
+  /// Non-OK statuses of relay messages
+  enum class RelayError {
+    RESERVATION_REFUSED,
+    RESOURCE_LIMIT_EXCEEDED,
+    PERMISSION_DENIED,
+    CONNECTION_FAILED,
+    NO_RESERVATION,
+    MALFORMED_MESSAGE,
+    UNEXPECTED_MESSAGE,
+  };
+  Q_ENUM_ERROR_CODE(RelayError) {
+    using E = decltype(e);
+    switch (e) {
+      case E::RESERVATION_REFUSED:
+        return "RESERVATION_REFUSED";
+      case E::RESOURCE_LIMIT_EXCEEDED:
+        return "RESOURCE_LIMIT_EXCEEDED";
+      case E::PERMISSION_DENIED:
+        return "PERMISSION_DENIED";
+      case E::CONNECTION_FAILED:
+        return "CONNECTION_FAILED";
+      case E::NO_RESERVATION:
+        return "NO_RESERVATION";
+      case E::MALFORMED_MESSAGE:
+        return "MALFORMED_MESSAGE";
+      case E::UNEXPECTED_MESSAGE:
+        return "UNEXPECTED_MESSAGE";
+    }
+    abort();
+  }
+}  // namespace libp2p
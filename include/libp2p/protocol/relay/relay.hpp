@@ -0,0 +1,99 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <unordered_map>
+
+#include <libp2p/basic/scheduler.hpp>
+#include <libp2p/host/host.hpp>
+#include <libp2p/protocol/base_protocol.hpp>
+#include <libp2p/protocol/relay/config.hpp>
+
+namespace libp2p::basic {
+  class BufferPool;
+  class ProtobufMessageReadWriter;
+}  // namespace libp2p::basic
+
+namespace relay::pb {
+  class HopMessage;
+}  // namespace relay::pb
+
+namespace libp2p::protocol::relay {
+  /**
+   * Circuit relay v2 relay, serving hop protocol.
+   * Peers reserve a slot, then other peers connect to them through it:
+   * relay opens stop stream to reserved peer and splices it with hop stream
+   * of connecting peer, within duration and data limits of a circuit.
+   */
+  class Relay : public BaseProtocol,
+                public std::enable_shared_from_this<Relay> {
+   public:
+    Relay(Host &host,
+          std::shared_ptr<basic::Scheduler> scheduler,
+          RelayConfig config = {});
+
+    peer::ProtocolName getProtocolId() const override;
+
+    void handle(StreamAndProtocol stream) override;
+
+    /// Sets hop protocol handler
+    void start();
+
+    /// Reservations, including expired ones which are not dropped yet
+    size_t reservations() const {
+      return reservations_.size();
+    }
+
+    /// Circuits being connected or relayed
+    size_t circuits() const {
+      return circuits_;
+    }
+
+   private:
+    using ReadWriter = basic::ProtobufMessageReadWriter;
+
+    void onHop(std::shared_ptr<connection::Stream> stream,
+               std::shared_ptr<ReadWriter> rw,
+               const PeerId &peer,
+               const ::relay::pb::HopMessage &msg);
+
+    void reserve(std::shared_ptr<connection::Stream> stream,
+                 std::shared_ptr<ReadWriter> rw,
+                 const PeerId &peer);
+
+    void connect(std::shared_ptr<connection::Stream> stream,
+                 std::shared_ptr<ReadWriter> rw,
+                 const PeerId &src,
+                 const PeerId &dst);
+
+    /// Relays between streams of connected peers
+    void splice(std::shared_ptr<connection::Stream> src_stream,
+                std::shared_ptr<connection::Stream> dst_stream,
+                const PeerId &src,
+                const PeerId &dst);
+
+    /// Writes response, closes stream after it
+    void reply(std::shared_ptr<connection::Stream> stream,
+               std::shared_ptr<ReadWriter> rw,
+               const ::relay::pb::HopMessage &msg);
+
+    bool hasReservation(const PeerId &peer) const;
+
+    void acquireCircuit(const PeerId &src, const PeerId &dst);
+
+    void releaseCircuit(const PeerId &src, const PeerId &dst);
+
+    Host &host_;
+    std::shared_ptr<basic::Scheduler> scheduler_;
+    RelayConfig config_;
+    std::shared_ptr<basic::BufferPool> pool_;
+    /// expiry of reservation, in scheduler time
+    std::unordered_map<PeerId, std::chrono::milliseconds> reservations_;
+    size_t circuits_ = 0;
+    std::unordered_map<PeerId, size_t> peer_circuits_;
+  };
+}  // namespace libp2p::protocol::relay
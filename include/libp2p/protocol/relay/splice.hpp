@@ -0,0 +1,73 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <array>
+#include <functional>
+
+#include <libp2p/basic/buffer_pool.hpp>
+#include <libp2p/outcome/outcome.hpp>
+
+namespace libp2p::connection {
+  struct Stream;
+}  // namespace libp2p::connection
+
+namespace libp2p::protocol::relay {
+  /**
+   * Forwards bytes between two streams in both directions.
+   * Each direction reads into one pooled buffer and writes it out before
+   * reading again, so nothing is allocated per read. When one stream is
+   * closed for read, the other one is closed for write. Errors and exceeded
+   * data limit reset both streams.
+   * Pending reads and writes keep splice alive, buffers are returned to pool
+   * after the last of them completes.
+   */
+  class Splice : public std::enable_shared_from_this<Splice> {
+   public:
+    /// Called once, when both directions are done or splice is stopped
+    using OnDone = std::function<void()>;
+
+    /**
+     * @param max_bytes forwarded in each direction, zero is unlimited
+     */
+    Splice(std::shared_ptr<connection::Stream> a,
+           std::shared_ptr<connection::Stream> b,
+           std::shared_ptr<basic::BufferPool> pool,
+           uint64_t max_bytes);
+
+    void start(OnDone on_done);
+
+    /// Resets both streams
+    void stop();
+
+    /// Bytes forwarded from a to b, and from b to a
+    uint64_t forwarded(bool a_to_b) const {
+      return directions_[a_to_b ? 0 : 1].forwarded;
+    }
+
+   private:
+    struct Direction {
+      std::shared_ptr<connection::Stream> from;
+      std::shared_ptr<connection::Stream> to;
+      basic::BufferSlice buffer;
+      uint64_t forwarded = 0;
+      bool done = false;
+    };
+
+    void read(size_t i);
+    void onRead(size_t i, outcome::result<size_t> r);
+    void onWritten(size_t i, outcome::result<void> r);
+    void done(size_t i);
+    void finish();
+
+    std::array<Direction, 2> directions_;
+    std::shared_ptr<basic::BufferPool> pool_;
+    uint64_t max_bytes_;
+    OnDone on_done_;
+    bool stopped_ = false;
+  };
+}  // namespace libp2p::protocol::relay
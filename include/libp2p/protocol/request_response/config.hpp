@@ -0,0 +1,33 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+
+namespace libp2p::protocol {
+  struct RequestResponseConfig {
+    /// how long request may take, from opening stream to reading response
+    std::chrono::milliseconds timeout = std::chrono::seconds{10};
+
+    /// requests to one peer in flight at once, others wait in queue
+    size_t max_outstanding = 8;
+
+    /// requests to one peer waiting in queue, others are rejected
+    size_t max_queued = 64;
+
+    /// keep streams open after response, and send next requests over them
+    bool reuse_streams = false;
+
+    /// idle streams kept open per peer, if streams are reused
+    size_t max_idle_streams = 2;
+
+    /// same request to same peer joins the one in flight instead of being
+    /// sent again
+    bool deduplicate = true;
+  };
+}  // namespace libp2p::protocol
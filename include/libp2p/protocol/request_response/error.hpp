@@ -0,0 +1,26 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <qtils/enum_error_code.hpp>
+
+namespace libp2p {
+  enum class RequestResponseError {
+    TIMEOUT,
+    TOO_MANY_REQUESTS,
+  };
+  Q_ENUM_ERROR_CODE(RequestResponseError) {
+    using E = decltype(e);
+    switch (e) {
+      case E::TIMEOUT:
+        return "Request timed out";
+      case E::TOO_MANY_REQUESTS:
+        return "Too many requests to peer";
+    }
+    abort();
+  }
+}  // namespace libp2p
@@ -0,0 +1,118 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <deque>
+#include <map>
+#include <unordered_map>
+
+#include <libp2p/basic/scheduler.hpp>
+#include <libp2p/host/host.hpp>
+#include <libp2p/protocol/base_protocol.hpp>
+#include <libp2p/protocol/request_response/config.hpp>
+#include <libp2p/protocol/request_response/error.hpp>
+
+namespace libp2p::basic {
+  class MessageReadWriterUvarint;
+}  // namespace libp2p::basic
+
+namespace libp2p::metrics {
+  class Counter;
+  class Histogram;
+}  // namespace libp2p::metrics
+
+namespace libp2p::protocol {
+  /**
+   * Generic request-response protocol.
+   * Each request and response is one uvarint length-prefixed message.
+   * Requests to a peer are limited and queued, optionally deduplicated and
+   * sent over reused streams. Latency and sizes are reported to
+   * metrics::Registry under names derived from the first protocol.
+   */
+  class RequestResponse
+      : public BaseProtocol,
+        public std::enable_shared_from_this<RequestResponse> {
+   public:
+    /// Response is valid only during the call
+    using ResponseCb = std::function<void(outcome::result<BytesIn>)>;
+
+    /// Sends response, or resets stream on error
+    using Respond = std::function<void(outcome::result<Bytes>)>;
+
+    /// Request is valid only during the call, respond may be called later
+    using Handler = std::function<void(
+        const PeerId &peer, BytesIn request, Respond respond)>;
+
+    /**
+     * @param protocols to request with, supported when serving
+     * @param handler of incoming requests, requests are not served if empty
+     */
+    RequestResponse(Host &host,
+                    std::shared_ptr<basic::Scheduler> scheduler,
+                    StreamProtocols protocols,
+                    Handler handler = {},
+                    RequestResponseConfig config = {});
+
+    peer::ProtocolName getProtocolId() const override;
+
+    void handle(StreamAndProtocol stream) override;
+
+    /// Sets protocol handler to serve incoming requests
+    void start();
+
+    /**
+     * Sends request to peer and reads response
+     * @param cb is called once, with response or error
+     */
+    void request(const PeerId &peer, Bytes request, ResponseCb cb);
+
+   private:
+    struct Call;
+
+    struct PeerState {
+      size_t outstanding = 0;
+      std::deque<std::shared_ptr<Call>> queue;
+      std::vector<std::shared_ptr<connection::Stream>> idle;
+      /// queued and outstanding calls by request, if deduplicated
+      std::map<Bytes, std::shared_ptr<Call>, std::less<>> calls;
+    };
+
+    struct Metrics {
+      metrics::Histogram &latency;
+      metrics::Histogram &request_size;
+      metrics::Histogram &response_size;
+      metrics::Counter &failures;
+      metrics::Counter &timeouts;
+      metrics::Counter &deduplicated;
+    };
+
+    static Metrics makeMetrics(const peer::ProtocolName &protocol);
+
+    void start(const std::shared_ptr<Call> &call);
+    void open(const std::shared_ptr<Call> &call);
+    void send(const std::shared_ptr<Call> &call,
+              std::shared_ptr<connection::Stream> stream,
+              bool reused);
+    /// Retries failed request once if it was sent over reused stream
+    void fail(const std::shared_ptr<Call> &call,
+              bool reused,
+              std::error_code ec);
+    void finish(const std::shared_ptr<Call> &call,
+                outcome::result<BytesIn> response);
+
+    void serve(std::shared_ptr<connection::Stream> stream,
+               std::shared_ptr<basic::MessageReadWriterUvarint> rw);
+
+    Host &host_;
+    std::shared_ptr<basic::Scheduler> scheduler_;
+    StreamProtocols protocols_;
+    Handler handler_;
+    RequestResponseConfig config_;
+    Metrics metrics_;
+    std::unordered_map<PeerId, PeerState> peers_;
+  };
+}  // namespace libp2p::protocol
@@ -29,6 +29,13 @@ namespace libp2p::protocol_muxer::multiselect {
                      bool negotiate_multiselect,
                      ProtocolHandlerFunc cb) override;
 
+    /// Implements ProtocolMuxer API
+    void selectOneOf(std::shared_ptr<const StreamProtocols> protocols,
+                     std::shared_ptr<basic::ReadWriter> connection,
+                     bool is_initiator,
+                     bool negotiate_multiselect,
+                     ProtocolHandlerFunc cb) override;
+
     /// Simple single stream negotiate procedure
     void simpleStreamNegotiate(
         const std::shared_ptr<connection::Stream> &stream,
@@ -36,6 +43,17 @@ namespace libp2p::protocol_muxer::multiselect {
         std::function<void(
             outcome::result<std::shared_ptr<connection::Stream>>)> cb) override;
 
+    /// Lazy single stream negotiate procedure
+    outcome::result<std::shared_ptr<connection::Stream>> lazyStreamNegotiate(
+        std::shared_ptr<connection::Stream> stream,
+        const peer::ProtocolName &protocol_id) override;
+
+    /// Lazy security negotiate procedure
+    outcome::result<std::shared_ptr<connection::LayerConnection>>
+    lazyConnectionNegotiate(
+        std::shared_ptr<connection::LayerConnection> connection,
+        const peer::ProtocolName &protocol_id) override;
+
     /// Called from instance on close
     void instanceClosed(Instance instance,
                         const ProtocolHandlerFunc &cb,
@@ -0,0 +1,117 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <boost/optional.hpp>
+
+#include <libp2p/connection/layer_connection.hpp>
+#include <libp2p/peer/protocol.hpp>
+#include <libp2p/protocol_muxer/multiselect/common.hpp>
+
+namespace libp2p::protocol_muxer::multiselect {
+
+  /**
+   * Outbound connection with optimistic negotiation of security protocol.
+   * Multistream header and proposal are sent together with the first write
+   * (first handshake message), so dial takes one flight less per
+   * negotiation step. Echo of proposal is checked before the first read.
+   * Rejection is reported to the first read and to writes after it, and the
+   * connection is closed, as peer has already got handshake bytes as
+   * multistream messages
+   */
+  class LazyConnection : public connection::LayerConnection,
+                         public std::enable_shared_from_this<LazyConnection> {
+   public:
+    /// Creates connection, fails if protocol name is too long
+    static outcome::result<std::shared_ptr<LazyConnection>> create(
+        std::shared_ptr<connection::LayerConnection> connection,
+        const peer::ProtocolName &protocol);
+
+    LazyConnection(std::shared_ptr<connection::LayerConnection> connection,
+                   MsgBuf proposal,
+                   size_t first_part_size);
+
+    void read(BytesOut out, size_t bytes, ReadCallbackFunc cb) override;
+
+    void readSome(BytesOut out, size_t bytes, ReadCallbackFunc cb) override;
+
+    void deferReadCallback(outcome::result<size_t> res,
+                           ReadCallbackFunc cb) override;
+
+    void writeSome(BytesIn in, size_t bytes, WriteCallbackFunc cb) override;
+
+    void writeSomeVectored(std::span<const BytesIn> in,
+                           WriteCallbackFunc cb) override;
+
+    void deferWriteCallback(std::error_code ec, WriteCallbackFunc cb) override;
+
+    bool isClosed() const override;
+
+    outcome::result<void> close() override;
+
+    bool isInitiator() const override;
+
+    outcome::result<multi::Multiaddress> localMultiaddr() override;
+
+    outcome::result<multi::Multiaddress> remoteMultiaddr() override;
+
+   private:
+    enum class ProposalState { kNotSent, kSending, kSent };
+
+    struct PendingRead {
+      BytesOut out;
+      size_t bytes;
+      bool some;
+      ReadCallbackFunc cb;
+    };
+
+    struct PendingWrite {
+      BytesIn in;
+      size_t bytes;
+      WriteCallbackFunc cb;
+    };
+
+    void doRead(PendingRead read);
+
+    /// Sends proposal without handshake data
+    void sendProposal();
+
+    void onProposalSent(outcome::result<void> res);
+
+    /// Reads reply in two parts, as LazyStream does, so "na" reply doesn't
+    /// hang waiting for bytes of echoed proposal
+    void readReply();
+
+    void onReplyRead(outcome::result<size_t> res, bool first_part);
+
+    void onNegotiated(outcome::result<void> res);
+
+    std::shared_ptr<connection::LayerConnection> connection_;
+
+    /// Multistream header and protocol messages, peer echoes them on success
+    MsgBuf proposal_;
+
+    /// Size of multistream header and varint prefix of protocol message
+    size_t first_part_size_;
+
+    MsgBuf reply_;
+
+    ProposalState proposal_state_ = ProposalState::kNotSent;
+
+    bool reading_reply_ = false;
+
+    /// Has value when negotiation completed
+    boost::optional<outcome::result<void>> negotiated_;
+
+    /// Read issued before negotiation completed
+    boost::optional<PendingRead> pending_read_;
+
+    /// Write issued while proposal is being sent
+    boost::optional<PendingWrite> pending_write_;
+  };
+
+}  // namespace libp2p::protocol_muxer::multiselect
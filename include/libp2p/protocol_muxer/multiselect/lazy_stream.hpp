@@ -0,0 +1,128 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <boost/optional.hpp>
+
+#include <libp2p/connection/stream.hpp>
+#include <libp2p/protocol_muxer/multiselect/common.hpp>
+
+namespace libp2p::protocol_muxer::multiselect {
+
+  /**
+   * Outbound stream with optimistic (0-RTT) negotiation of protocol, which is
+   * known to be supported by peer. Proposal is sent together with the first
+   * write, reply is checked before the first read. Negotiation failure is
+   * reported to the first read and to writes after it
+   */
+  class LazyStream : public connection::Stream,
+                     public std::enable_shared_from_this<LazyStream> {
+   public:
+    /// Creates stream, fails if protocol name is too long
+    static outcome::result<std::shared_ptr<LazyStream>> create(
+        std::shared_ptr<connection::Stream> stream,
+        const peer::ProtocolName &protocol);
+
+    LazyStream(std::shared_ptr<connection::Stream> stream,
+               MsgBuf proposal,
+               size_t first_part_size);
+
+    void read(BytesOut out, size_t bytes, ReadCallbackFunc cb) override;
+
+    void readSome(BytesOut out, size_t bytes, ReadCallbackFunc cb) override;
+
+    void deferReadCallback(outcome::result<size_t> res,
+                           ReadCallbackFunc cb) override;
+
+    void writeSome(BytesIn in, size_t bytes, WriteCallbackFunc cb) override;
+
+    void deferWriteCallback(std::error_code ec, WriteCallbackFunc cb) override;
+
+    bool isClosedForRead() const override;
+
+    bool isClosedForWrite() const override;
+
+    bool isClosed() const override;
+
+    void close(VoidResultHandlerFunc cb) override;
+
+    void reset() override;
+
+    void adjustWindowSize(uint32_t new_size,
+                          VoidResultHandlerFunc cb) override;
+
+    outcome::result<bool> isInitiator() const override;
+
+    outcome::result<peer::PeerId> remotePeerId() const override;
+
+    outcome::result<multi::Multiaddress> localMultiaddr() const override;
+
+    outcome::result<multi::Multiaddress> remoteMultiaddr() const override;
+
+    void attributeTraffic(const peer::ProtocolName &protocol) override;
+
+    bool admitProtocol(const peer::ProtocolName &protocol) override;
+
+    void setWriteWeight(uint8_t weight) override;
+
+   private:
+    enum class ProposalState { kNotSent, kSending, kSent };
+
+    struct PendingRead {
+      BytesOut out;
+      size_t bytes;
+      bool some;
+      ReadCallbackFunc cb;
+    };
+
+    struct PendingWrite {
+      BytesIn in;
+      size_t bytes;
+      WriteCallbackFunc cb;
+    };
+
+    void doRead(PendingRead read);
+
+    /// Sends proposal without application data
+    void sendProposal();
+
+    void onProposalSent(outcome::result<void> res);
+
+    /// Reads reply in two parts: multistream header with varint prefix of
+    /// protocol message, then the rest of protocol message. "na" reply
+    /// differs within the first part, so it doesn't hang waiting for bytes
+    void readReply();
+
+    void onReplyRead(outcome::result<size_t> res, bool first_part);
+
+    void onNegotiated(outcome::result<void> res);
+
+    std::shared_ptr<connection::Stream> stream_;
+
+    /// Multistream header and protocol messages, peer echoes them on success
+    MsgBuf proposal_;
+
+    /// Size of multistream header and varint prefix of protocol message
+    size_t first_part_size_;
+
+    MsgBuf reply_;
+
+    ProposalState proposal_state_ = ProposalState::kNotSent;
+
+    bool reading_reply_ = false;
+
+    /// Has value when negotiation completed
+    boost::optional<outcome::result<void>> negotiated_;
+
+    /// Read issued before negotiation completed
+    boost::optional<PendingRead> pending_read_;
+
+    /// Write issued while proposal is being sent
+    boost::optional<PendingWrite> pending_write_;
+  };
+
+}  // namespace libp2p::protocol_muxer::multiselect
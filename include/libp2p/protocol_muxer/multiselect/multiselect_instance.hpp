@@ -6,6 +6,9 @@
 
 #pragma once
 
+#include <deque>
+
+#include <libp2p/common/metrics/tracing.hpp>
 #include <libp2p/protocol_muxer/multiselect.hpp>
 #include "parser.hpp"
 
@@ -30,12 +33,26 @@ namespace libp2p::protocol_muxer::multiselect {
                      bool negotiate_multiselect,
                      Multiselect::ProtocolHandlerFunc cb);
 
+    /// Implements ProtocolMuxer API, views shared protocols without copying
+    void selectOneOf(std::shared_ptr<const StreamProtocols> protocols,
+                     std::shared_ptr<basic::ReadWriter> connection,
+                     bool is_initiator,
+                     bool negotiate_multiselect,
+                     Multiselect::ProtocolHandlerFunc cb);
+
    private:
-    using Protocols = boost::container::small_vector<std::string, 4>;
+    using Protocols = boost::container::small_vector<std::string_view, 4>;
+    using OwnedProtocols = boost::container::small_vector<std::string, 4>;
     using Packet = std::shared_ptr<MsgBuf>;
     using Parser = detail::Parser;
     using MaybeResult = boost::optional<outcome::result<std::string>>;
 
+    /// Starts negotiation over protocols_
+    void start(std::shared_ptr<basic::ReadWriter> connection,
+               bool is_initiator,
+               bool negotiate_multiselect,
+               Multiselect::ProtocolHandlerFunc cb);
+
     /// Sends the first message with multistream protocol ID
     void sendOpening();
 
@@ -81,15 +98,25 @@ namespace libp2p::protocol_muxer::multiselect {
     /// be passed to expired destination)
     size_t current_round_ = 0;
 
-    /// List of protocols
+    /// List of protocols, views either owned_protocols_ or
+    /// shared_protocols_
     Protocols protocols_;
 
+    /// Copies of protocols given by span, reused by next negotiations
+    OwnedProtocols owned_protocols_;
+
+    /// Protocols shared by caller, kept until the next negotiation
+    std::shared_ptr<const StreamProtocols> shared_protocols_;
+
     /// Connection or stream
     std::shared_ptr<basic::ReadWriter> connection_;
 
     /// ProtocolMuxer callback
     Multiselect::ProtocolHandlerFunc callback_;
 
+    /// Spans the negotiation
+    metrics::Span span_;
+
     /// True for client-side instance
     bool is_initiator_ = false;
 
@@ -8,8 +8,10 @@
 
 #include <memory>
 
+#include <libp2p/connection/layer_connection.hpp>
 #include <libp2p/connection/stream.hpp>
 #include <libp2p/peer/protocol.hpp>
+#include <libp2p/peer/stream_protocols.hpp>
 
 namespace libp2p::protocol_muxer {
   /**
@@ -49,6 +51,22 @@ namespace libp2p::protocol_muxer {
                              bool negotiate_multistream,
                              ProtocolHandlerFunc cb) = 0;
 
+    /**
+     * Select a protocol from immutable shared list, which is not copied
+     * @see selectOneOf(...) above
+     */
+    virtual void selectOneOf(std::shared_ptr<const StreamProtocols> protocols,
+                             std::shared_ptr<basic::ReadWriter> connection,
+                             bool is_initiator,
+                             bool negotiate_multistream,
+                             ProtocolHandlerFunc cb) {
+      selectOneOf(*protocols,
+                  std::move(connection),
+                  is_initiator,
+                  negotiate_multistream,
+                  std::move(cb));
+    }
+
     /**
      * Simple (Yes/No) negotiation of a single protocol on a fresh outbound
      * stream
@@ -62,6 +80,33 @@ namespace libp2p::protocol_muxer {
         std::function<
             void(outcome::result<std::shared_ptr<connection::Stream>>)> cb) = 0;
 
+    /**
+     * Optimistic negotiation of a single protocol, which is known to be
+     * supported by peer, on a fresh outbound stream. Returned stream sends
+     * proposal with the first write and doesn't wait for reply, negotiation
+     * failure is reported to the first read
+     * @param stream Stream, just connected
+     * @param protocol_id Protocol to negotiate
+     * @return stream to use instead of given one
+     */
+    virtual outcome::result<std::shared_ptr<connection::Stream>>
+    lazyStreamNegotiate(std::shared_ptr<connection::Stream> stream,
+                        const peer::ProtocolName &protocol_id) = 0;
+
+    /**
+     * Optimistic negotiation of security protocol on a fresh outbound
+     * connection. Returned connection sends multistream header and proposal
+     * with the first handshake message, negotiation failure is reported to
+     * the first read
+     * @param connection Connection, just dialed
+     * @param protocol_id Protocol to negotiate
+     * @return connection to use instead of given one
+     */
+    virtual outcome::result<std::shared_ptr<connection::LayerConnection>>
+    lazyConnectionNegotiate(
+        std::shared_ptr<connection::LayerConnection> connection,
+        const peer::ProtocolName &protocol_id) = 0;
+
     virtual ~ProtocolMuxer() = default;
   };
 }  // namespace libp2p::protocol_muxer
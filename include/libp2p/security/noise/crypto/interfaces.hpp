@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <span>
 #include <tuple>
 
 #include <boost/optional.hpp>
@@ -87,6 +88,28 @@ namespace libp2p::security::noise {
                                            uint64_t nonce,
                                            BytesIn ciphertext,
                                            BytesIn aad) = 0;
+
+    /// encrypts into the given buffer (with room for the tag), which may
+    /// alias the plaintext, returns ciphertext size
+    virtual outcome::result<size_t> encryptInto(uint64_t nonce,
+                                                BytesIn plaintext,
+                                                BytesIn aad,
+                                                BytesOut out) = 0;
+
+    /// decrypts into the given buffer, which may alias the ciphertext,
+    /// returns plaintext size
+    virtual outcome::result<size_t> decryptInto(uint64_t nonce,
+                                                BytesIn ciphertext,
+                                                BytesIn aad,
+                                                BytesOut out) = 0;
+
+    /// encrypts plaintexts[i] into outs[i] with nonce first_nonce + i,
+    /// buffers are as of encryptInto
+    virtual outcome::result<void> encryptManyInto(
+        uint64_t first_nonce,
+        std::span<const BytesIn> plaintexts,
+        BytesIn aad,
+        std::span<const BytesOut> outs) = 0;
   };
 
   class NamedAEADCipher {
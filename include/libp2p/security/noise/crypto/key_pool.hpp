@@ -0,0 +1,79 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+#include <libp2p/basic/scheduler.hpp>
+#include <libp2p/security/noise/crypto/interfaces.hpp>
+
+namespace libp2p::security::noise {
+
+  /**
+   * Keys generated ahead of handshakes. A taken key leaves the pool, so no
+   * key is given twice. Refilled on its own thread, or on the scheduler one
+   * key per callback when the scheduler is given.
+   */
+  class KeyPool : public std::enable_shared_from_this<KeyPool> {
+   public:
+    KeyPool(std::shared_ptr<DiffieHellman> dh,
+            size_t capacity,
+            std::shared_ptr<basic::Scheduler> scheduler);
+
+    ~KeyPool();
+
+    /// begins filling the pool
+    void start();
+
+    /// a ready key if any, or one generated in place
+    outcome::result<DHKey> take();
+
+    /// number of ready keys
+    size_t size() const;
+
+   private:
+    void refill();
+
+    void refillLoop();
+
+    void scheduleRefill();
+
+    std::shared_ptr<DiffieHellman> dh_;
+    const size_t capacity_;
+    std::shared_ptr<basic::Scheduler> scheduler_;
+    mutable std::mutex mutex_;
+    std::condition_variable refill_cv_;
+    std::deque<DHKey> keys_;
+    bool stop_ = false;
+    bool refill_scheduled_ = false;
+    std::thread thread_;
+  };
+
+  /// Generates keys from the pool, computes DH with the given one
+  class PooledDiffieHellman : public DiffieHellman {
+   public:
+    PooledDiffieHellman(std::shared_ptr<DiffieHellman> dh,
+                        std::shared_ptr<KeyPool> pool);
+
+    outcome::result<DHKey> generate() override;
+
+    outcome::result<Bytes> dh(const Bytes &private_key,
+                              const Bytes &public_key) override;
+
+    int dhSize() const override;
+
+    std::string dhName() const override;
+
+   private:
+    std::shared_ptr<DiffieHellman> dh_;
+    std::shared_ptr<KeyPool> pool_;
+  };
+
+}  // namespace libp2p::security::noise
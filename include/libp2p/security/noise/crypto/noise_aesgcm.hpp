@@ -0,0 +1,72 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <openssl/aead.h>
+#include <libp2p/security/noise/crypto/interfaces.hpp>
+
+namespace libp2p::security::noise {
+  /**
+   * AES-256-GCM cipher of noise spec, nonce is four zero bytes followed by
+   * big endian counter.
+   * Uses AES-NI and carry-less multiplication where CPU has them, which is
+   * faster than ChaChaPoly there
+   */
+  class NoiseAESGCMImpl : public AEADCipher {
+   public:
+    NoiseAESGCMImpl(Key32 key);
+
+    outcome::result<Bytes> encrypt(BytesIn precompiled_out,
+                                   uint64_t nonce,
+                                   BytesIn plaintext,
+                                   BytesIn aad) override;
+
+    outcome::result<Bytes> decrypt(BytesIn precompiled_out,
+                                   uint64_t nonce,
+                                   BytesIn ciphertext,
+                                   BytesIn aad) override;
+
+    outcome::result<size_t> encryptInto(uint64_t nonce,
+                                        BytesIn plaintext,
+                                        BytesIn aad,
+                                        BytesOut out) override;
+
+    outcome::result<size_t> decryptInto(uint64_t nonce,
+                                        BytesIn ciphertext,
+                                        BytesIn aad,
+                                        BytesOut out) override;
+
+    outcome::result<void> encryptManyInto(
+        uint64_t first_nonce,
+        std::span<const BytesIn> plaintexts,
+        BytesIn aad,
+        std::span<const BytesOut> outs) override;
+
+   private:
+    using Nonce = std::array<uint8_t, 12>;
+
+    static Nonce toNonce(uint64_t n);
+
+    /// keyed context of the direction, set up on first use
+    outcome::result<EVP_AEAD_CTX *> context(bool encrypt);
+
+    const Key32 key_;
+    bssl::ScopedEVP_AEAD_CTX seal_ctx_;
+    bssl::ScopedEVP_AEAD_CTX open_ctx_;
+    bool seal_ready_ = false;
+    bool open_ready_ = false;
+  };
+
+  class NamedAESGCMImpl : public NamedAEADCipher {
+   public:
+    ~NamedAESGCMImpl() override = default;
+
+    std::shared_ptr<AEADCipher> cipher(Key32 key) override;
+
+    std::string cipherName() const override;
+  };
+}  // namespace libp2p::security::noise
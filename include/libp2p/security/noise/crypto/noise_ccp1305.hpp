@@ -24,6 +24,22 @@ namespace libp2p::security::noise {
                                    BytesIn ciphertext,
                                    BytesIn aad) override;
 
+    outcome::result<size_t> encryptInto(uint64_t nonce,
+                                        BytesIn plaintext,
+                                        BytesIn aad,
+                                        BytesOut out) override;
+
+    outcome::result<size_t> decryptInto(uint64_t nonce,
+                                        BytesIn ciphertext,
+                                        BytesIn aad,
+                                        BytesOut out) override;
+
+    outcome::result<void> encryptManyInto(
+        uint64_t first_nonce,
+        std::span<const BytesIn> plaintexts,
+        BytesIn aad,
+        std::span<const BytesOut> outs) override;
+
    private:
     std::unique_ptr<crypto::chachapoly::ChaCha20Poly1305> ccp_;
   };
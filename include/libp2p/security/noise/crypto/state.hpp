@@ -43,6 +43,35 @@ namespace libp2p::security::noise {
                                    BytesIn ciphertext,
                                    BytesIn aad);
 
+    /**
+     * Encrypts without allocation
+     * @param out - at least plaintext size + kTagSize bytes, may start at
+     * plaintext to encrypt in place
+     * @return ciphertext size
+     */
+    outcome::result<size_t> encryptInto(BytesIn plaintext,
+                                        BytesIn aad,
+                                        BytesOut out);
+
+    /**
+     * Decrypts without allocation
+     * @param out - at least ciphertext size - kTagSize bytes, may start at
+     * ciphertext to decrypt in place
+     * @return plaintext size
+     */
+    outcome::result<size_t> decryptInto(BytesIn ciphertext,
+                                        BytesIn aad,
+                                        BytesOut out);
+
+    /**
+     * Encrypts several messages with consecutive nonces, as many calls of
+     * encryptInto would do
+     * @param outs - one buffer per plaintext, as of encryptInto
+     */
+    outcome::result<void> encryptManyInto(std::span<const BytesIn> plaintexts,
+                                          BytesIn aad,
+                                          std::span<const BytesOut> outs);
+
     outcome::result<void> rekey();
 
     std::shared_ptr<CipherSuite> cipherSuite() const;
@@ -6,6 +6,9 @@
 
 #pragma once
 
+#include <chrono>
+
+#include <libp2p/basic/scheduler.hpp>
 #include <libp2p/connection/raw_connection.hpp>
 #include <libp2p/crypto/crypto_provider.hpp>
 #include <libp2p/crypto/key_marshaller.hpp>
@@ -13,14 +16,20 @@
 #include <libp2p/log/logger.hpp>
 #include <libp2p/peer/peer_id.hpp>
 #include <libp2p/security/noise/crypto/interfaces.hpp>
+#include <libp2p/security/noise/crypto/key_pool.hpp>
 #include <libp2p/security/noise/crypto/state.hpp>
 #include <libp2p/security/noise/handshake_message_marshaller.hpp>
 #include <libp2p/security/noise/insecure_rw.hpp>
+#include <libp2p/security/noise/noise_config.hpp>
 #include <libp2p/security/security_adaptor.hpp>
 
 namespace libp2p::security::noise {
 
-  std::shared_ptr<CipherSuite> defaultCipherSuite();
+  /// @param key_pool - source of generated keys, optional
+  /// @param cipher - AEAD cipher, ChaChaPoly if not set
+  std::shared_ptr<CipherSuite> defaultCipherSuite(
+      std::shared_ptr<KeyPool> key_pool = nullptr,
+      std::shared_ptr<NamedAEADCipher> cipher = nullptr);
 
   class Handshake : public std::enable_shared_from_this<Handshake> {
    public:
@@ -29,15 +38,31 @@ namespace libp2p::security::noise {
         std::unique_ptr<security::noise::HandshakeMessageMarshaller>
             noise_marshaller,
         crypto::KeyPair local_key,
+        std::shared_ptr<const crypto::SigningKey> signing_key,
         std::shared_ptr<connection::LayerConnection> connection,
         bool is_initiator,
         boost::optional<peer::PeerId> remote_peer_id,
         SecurityAdaptor::SecConnCallbackFunc cb,
-        std::shared_ptr<crypto::marshaller::KeyMarshaller> key_marshaller);
+        std::shared_ptr<crypto::marshaller::KeyMarshaller> key_marshaller,
+        std::shared_ptr<basic::Scheduler> scheduler,
+        NoiseConfig config,
+        std::shared_ptr<KeyPool> key_pool,
+        std::vector<peer::ProtocolName> muxers,
+        std::shared_ptr<NamedAEADCipher> cipher = nullptr);
 
     void connect();
 
    private:
+    using Clock = std::chrono::steady_clock;
+
+    /// Time spent in each phase, observed as histograms when handshake ends
+    struct PhaseTimes {
+      Clock::duration dh{};
+      Clock::duration signature{};
+      Clock::duration marshal{};
+      Clock::duration io{};
+    };
+
     const std::string kPayloadPrefix = "noise-libp2p-static-key:";
 
     void setCipherStates(std::shared_ptr<CipherState> cs1,
@@ -58,16 +83,26 @@ namespace libp2p::security::noise {
     // handshake callback
     void hscb(outcome::result<bool> secured);
 
+    void observePhases() const;
+
     // constructor params
     std::shared_ptr<crypto::CryptoProvider> crypto_provider_;
     std::unique_ptr<security::noise::HandshakeMessageMarshaller>
         noise_marshaller_;
     const crypto::KeyPair local_key_;
+    /// Prepared private key of local_key_, signs payload if set
+    std::shared_ptr<const crypto::SigningKey> signing_key_;
     std::shared_ptr<connection::LayerConnection> conn_;
     bool initiator_;  /// false for incoming connections
     SecurityAdaptor::SecConnCallbackFunc connection_cb_;
 
     std::shared_ptr<crypto::marshaller::KeyMarshaller> key_marshaller_;
+    std::shared_ptr<basic::Scheduler> scheduler_;
+    NoiseConfig config_;
+    std::shared_ptr<KeyPool> key_pool_;
+    /// Muxers offered in handshake payload
+    std::vector<peer::ProtocolName> muxers_;
+    std::shared_ptr<NamedAEADCipher> cipher_;
     std::shared_ptr<Bytes> read_buffer_;
     std::shared_ptr<InsecureReadWriter> rw_;
 
@@ -78,6 +113,9 @@ namespace libp2p::security::noise {
     std::shared_ptr<CipherState> dec_;
     boost::optional<peer::PeerId> remote_peer_id_;
     boost::optional<crypto::PublicKey> remote_peer_pubkey_;
+    /// The first muxer of initiator supported by responder
+    boost::optional<peer::ProtocolName> muxer_;
+    PhaseTimes times_;
 
     log::Logger log_ = log::createLogger("NoiseHandshake");
   };
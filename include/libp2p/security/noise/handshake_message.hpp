@@ -8,6 +8,7 @@
 
 #include <libp2p/common/types.hpp>
 #include <libp2p/crypto/key.hpp>
+#include <libp2p/peer/protocol.hpp>
 
 namespace libp2p::security::noise {
 
@@ -15,5 +16,7 @@ namespace libp2p::security::noise {
     crypto::PublicKey identity_key;
     Bytes identity_sig;
     Bytes data;
+    /// Muxers offered for early negotiation, "stream_muxers" extension
+    std::vector<peer::ProtocolName> stream_muxers;
   };
 }  // namespace libp2p::security::noise
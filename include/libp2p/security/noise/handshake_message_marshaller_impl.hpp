@@ -19,8 +19,15 @@ namespace libp2p::security::noise {
       MESSAGE_DESERIALIZING_ERROR,
     };
 
+    /// Local identity key with its protobuf, marshalled once per adaptor
+    struct LocalKey {
+      crypto::PublicKey key;
+      crypto::ProtobufKey proto;
+    };
+
     explicit HandshakeMessageMarshallerImpl(
-        std::shared_ptr<crypto::marshaller::KeyMarshaller> marshaller);
+        std::shared_ptr<crypto::marshaller::KeyMarshaller> marshaller,
+        std::shared_ptr<const LocalKey> local_key = nullptr);
 
     outcome::result<protobuf::NoiseHandshakePayload> handyToProto(
         const HandshakeMessage &msg) const override;
@@ -36,6 +43,8 @@ namespace libp2p::security::noise {
 
    private:
     std::shared_ptr<crypto::marshaller::KeyMarshaller> marshaller_;
+    /// Identity key of messages we send, not marshalled again
+    std::shared_ptr<const LocalKey> local_key_;
   };
 }  // namespace libp2p::security::noise
 
@@ -6,8 +6,11 @@
 
 #pragma once
 
+#include <functional>
 #include <memory>
+#include <optional>
 
+#include <libp2p/basic/buffer_pool.hpp>
 #include <libp2p/basic/message_read_writer.hpp>
 #include <libp2p/common/types.hpp>
 #include <libp2p/connection/raw_connection.hpp>
@@ -30,20 +33,60 @@ namespace libp2p::security::noise {
      * Initializes read writer
      * @param connection - raw connection
      * @param buffer - pointer to buffer where to store bytes from network
+     * @param read_ahead - size of read-ahead buffer for readFrame(), zero if
+     * only read() is used
      */
     InsecureReadWriter(std::shared_ptr<connection::LayerConnection> connection,
-                       std::shared_ptr<Bytes> buffer);
+                       std::shared_ptr<Bytes> buffer,
+                       size_t read_ahead = 0);
 
     /// read next message from the network
     void read(ReadCallbackFunc cb) override;
 
+    using ReadFrameCallback = std::function<void(outcome::result<BytesOut>)>;
+
+    /**
+     * Reads as many bytes as read-ahead buffer takes and returns the first
+     * message received. The message may be modified in place and is valid
+     * till the next takeFrame() or readFrame() call
+     */
+    void readFrame(ReadFrameCallback cb);
+
+    /// Returns the next message already received by readFrame(), if any
+    std::optional<BytesOut> takeFrame();
+
+    /// Capacity of read-ahead buffer
+    size_t readAheadCapacity() const;
+
     /// write the given bytes to the network
     void write(BytesIn buffer, basic::Writer::WriteCallbackFunc cb) override;
 
+    /**
+     * Allocates pooled frame with length prefix set, message bytes are to be
+     * filled by the caller
+     * @param size - message size, not greater than kMaxMsgLen
+     */
+    static basic::BufferSlice allocateFrame(size_t size);
+
+    /// write the frame allocated by allocateFrame() to the network
+    void writeFrame(basic::BufferSlice frame,
+                    basic::Writer::WriteCallbackFunc cb);
+
+    /**
+     * Writes message built after kLengthPrefixSize reserved bytes, the prefix
+     * is set in place, so the message is not copied into a frame
+     * @param frame - reserved prefix followed by message
+     */
+    void writeFramed(Bytes frame, basic::Writer::WriteCallbackFunc cb);
+
    private:
     std::shared_ptr<connection::LayerConnection> connection_;
     std::shared_ptr<Bytes> buffer_;
-    Bytes outbuf_;
+    /// Received bytes in [ahead_begin_, ahead_end_), a partial message is
+    /// moved to the front before the next read
+    Bytes ahead_;
+    size_t ahead_begin_ = 0;
+    size_t ahead_end_ = 0;
   };
 
 }  // namespace libp2p::security::noise
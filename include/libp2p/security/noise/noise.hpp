@@ -6,12 +6,20 @@
 
 #pragma once
 
+#include <libp2p/basic/scheduler.hpp>
 #include <libp2p/crypto/crypto_provider.hpp>
 #include <libp2p/crypto/key.hpp>
 #include <libp2p/crypto/key_marshaller.hpp>
 #include <libp2p/log/logger.hpp>
+#include <libp2p/security/noise/handshake_message_marshaller_impl.hpp>
+#include <libp2p/security/noise/noise_config.hpp>
 #include <libp2p/security/security_adaptor.hpp>
 
+namespace libp2p::security::noise {
+  class KeyPool;
+  class NamedAEADCipher;
+}  // namespace libp2p::security::noise
+
 namespace libp2p::security {
 
   class Noise : public SecurityAdaptor,
@@ -21,7 +29,9 @@ namespace libp2p::security {
 
     Noise(crypto::KeyPair local_key,
           std::shared_ptr<crypto::CryptoProvider> crypto_provider,
-          std::shared_ptr<crypto::marshaller::KeyMarshaller> key_marshaller);
+          std::shared_ptr<crypto::marshaller::KeyMarshaller> key_marshaller,
+          std::shared_ptr<basic::Scheduler> scheduler,
+          NoiseConfig config);
 
     ~Noise() override = default;
 
@@ -34,11 +44,56 @@ namespace libp2p::security {
                         const peer::PeerId &p,
                         SecConnCallbackFunc cb) override;
 
+    void offerMuxers(std::vector<peer::ProtocolName> muxers) override;
+
+   protected:
+    /// Noise with cipher other than ChaChaPoly, negotiated by its protocol id
+    Noise(crypto::KeyPair local_key,
+          std::shared_ptr<crypto::CryptoProvider> crypto_provider,
+          std::shared_ptr<crypto::marshaller::KeyMarshaller> key_marshaller,
+          std::shared_ptr<basic::Scheduler> scheduler,
+          NoiseConfig config,
+          peer::ProtocolName protocol_id,
+          std::shared_ptr<noise::NamedAEADCipher> cipher);
+
    private:
     log::Logger log_ = log::createLogger("Noise");
     libp2p::crypto::KeyPair local_key_;
+    /// Prepared once, signs payloads of all handshakes
+    std::shared_ptr<const crypto::SigningKey> signing_key_;
+    /// Marshalled once, referenced by payloads of all handshakes
+    std::shared_ptr<const noise::HandshakeMessageMarshallerImpl::LocalKey>
+        local_proto_key_;
     std::shared_ptr<crypto::CryptoProvider> crypto_provider_;
     std::shared_ptr<crypto::marshaller::KeyMarshaller> key_marshaller_;
+    std::shared_ptr<basic::Scheduler> scheduler_;
+    NoiseConfig config_;
+    std::shared_ptr<noise::KeyPool> key_pool_;
+    std::vector<peer::ProtocolName> muxers_;
+    peer::ProtocolName protocol_id_;
+    std::shared_ptr<noise::NamedAEADCipher> cipher_;
+  };
+
+  /**
+   * Noise_XX_25519_AESGCM_SHA256, faster than ChaChaPoly on CPUs with AES-NI.
+   * Other libp2p implementations do not support it, so it is not in default
+   * adaptors. List it before Noise to prefer it when both sides support it:
+   * @code
+   * useSecurityAdaptors<NoiseAesGcm, Noise>()
+   * @endcode
+   * Peers without it reject its protocol id and fall back to Noise, at cost
+   * of one more multistream round trip
+   */
+  class NoiseAesGcm : public Noise {
+   public:
+    static constexpr auto kProtocolId = "/noise-aesgcm";
+
+    NoiseAesGcm(
+        crypto::KeyPair local_key,
+        std::shared_ptr<crypto::CryptoProvider> crypto_provider,
+        std::shared_ptr<crypto::marshaller::KeyMarshaller> key_marshaller,
+        std::shared_ptr<basic::Scheduler> scheduler,
+        NoiseConfig config);
   };
 
 }  // namespace libp2p::security
@@ -0,0 +1,48 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+
+namespace libp2p::security {
+  /**
+   * Config of noise secured connections
+   */
+  struct NoiseConfig {
+    /**
+     * Small writes are gathered and sealed into one noise message, which is
+     * sent when it is full or this delay elapses since the first write.
+     * Writes complete once copied, errors are reported by following writes.
+     * Data not yet sent is flushed on close.
+     * Zero disables write coalescing.
+     */
+    std::chrono::milliseconds write_coalescing_delay{0};
+
+    /**
+     * Secured connections read up to this many bytes at once and decrypt all
+     * noise messages received, instead of two reads per message. Rounded up
+     * to the max message size.
+     * Zero disables read-ahead.
+     */
+    size_t read_ahead{128 * 1024};
+
+    /**
+     * X25519 keys generated ahead of handshakes, each handshake takes two of
+     * them, the static and the ephemeral one. Handshakes generate keys in
+     * place while the pool is empty.
+     * Zero disables the pool.
+     */
+    size_t key_pool_size{0};
+
+    /**
+     * Key pool is refilled on its own thread, otherwise on the scheduler one
+     * key per callback.
+     */
+    bool key_pool_thread{true};
+  };
+}  // namespace libp2p::security
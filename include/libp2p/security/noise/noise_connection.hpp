@@ -6,11 +6,13 @@
 
 #pragma once
 
-#include <list>
+#include <optional>
 
 #include <libp2p/connection/secure_connection.hpp>
 
+#include <libp2p/basic/scheduler.hpp>
 #include <libp2p/common/metrics/instance_count.hpp>
+#include <libp2p/common/metrics/memory_usage.hpp>
 #include <libp2p/crypto/crypto_provider.hpp>
 #include <libp2p/crypto/key.hpp>
 #include <libp2p/crypto/key_marshaller.hpp>
@@ -19,17 +21,17 @@
 #include <libp2p/security/noise/crypto/state.hpp>
 #include <libp2p/security/noise/handshake_message_marshaller_impl.hpp>
 #include <libp2p/security/noise/insecure_rw.hpp>
+#include <libp2p/security/noise/noise_config.hpp>
 
 namespace libp2p::connection {
-  class NoiseConnection : public SecureConnection,
-                          public std::enable_shared_from_this<NoiseConnection> {
+  class NoiseConnection final
+      : public SecureConnection,
+        public metrics::MemoryReporter,
+        public std::enable_shared_from_this<NoiseConnection> {
    public:
-    using BufferList = std::list<Bytes>;
-
     struct OperationContext {
-      size_t bytes_served;                /// written or read bytes count
-      const size_t total_bytes;           /// total size to process
-      BufferList::iterator write_buffer;  /// temporary data storage
+      size_t bytes_served;       /// written or read bytes count
+      const size_t total_bytes;  /// total size to process
     };
 
     ~NoiseConnection() override = default;
@@ -40,10 +42,14 @@ namespace libp2p::connection {
         crypto::PublicKey remotePubkey,
         std::shared_ptr<crypto::marshaller::KeyMarshaller> key_marshaller,
         std::shared_ptr<security::noise::CipherState> encoder,
-        std::shared_ptr<security::noise::CipherState> decoder);
+        std::shared_ptr<security::noise::CipherState> decoder,
+        std::shared_ptr<basic::Scheduler> scheduler,
+        security::NoiseConfig config,
+        boost::optional<peer::ProtocolName> muxer);
 
     bool isClosed() const override;
 
+    /// Sends coalesced bytes before closing underlying connection
     outcome::result<void> close() override;
 
     void read(BytesOut out, size_t bytes, ReadCallbackFunc cb) override;
@@ -53,8 +59,13 @@ namespace libp2p::connection {
     void deferReadCallback(outcome::result<size_t> res,
                            ReadCallbackFunc cb) override;
 
+    /// Seals bytes at once, or gathers them when write coalescing is enabled
     void writeSome(BytesIn in, size_t bytes, WriteCallbackFunc cb) override;
 
+    /// Gathers buffers into one noise message (up to max plaintext size)
+    void writeSomeVectored(std::span<const BytesIn> in,
+                           WriteCallbackFunc cb) override;
+
     void deferWriteCallback(std::error_code ec, WriteCallbackFunc cb) override;
 
     bool isInitiator() const override;
@@ -69,29 +80,74 @@ namespace libp2p::connection {
 
     outcome::result<crypto::PublicKey> remotePublicKey() const override;
 
+    boost::optional<peer::ProtocolName> negotiatedMuxer() const override;
+
+    metrics::MemoryUsage memoryUsage() const override;
+
+    metrics::TrafficKey memoryKey() const override;
+
    private:
     void readSome(BytesOut out,
                   size_t bytes,
                   OperationContext ctx,
                   ReadCallbackFunc cb);
 
+    /// Serves decrypted messages received ahead, reads more if none
+    void readAhead(BytesOut out, ReadCallbackFunc cb);
+
+    /// Copies plaintext of messages already received, decrypting them in
+    /// place one after another until out is full
+    outcome::result<size_t> takePlaintext(BytesOut out);
+
     void write(BytesIn in,
                size_t bytes,
                OperationContext ctx,
                WriteCallbackFunc cb);
 
-    void eraseWriteBuffer(BufferList::iterator &iterator);
+    bool coalescing() const;
+
+    /// Copies buffers into coalesce_buffer_, completes with copied size
+    void writeCoalesced(std::span<const BytesIn> in, WriteCallbackFunc cb);
+
+    /// Seals and writes coalesced bytes unless previous flush is in progress
+    void flush();
+
+    void onFlushed(std::error_code ec);
+
+    void armFlushTimer();
 
     std::shared_ptr<LayerConnection> connection_;
     crypto::PublicKey local_;
     crypto::PublicKey remote_;
     std::shared_ptr<crypto::marshaller::KeyMarshaller> key_marshaller_;
+    /// Computed once, asked for by muxers and connection manager
+    outcome::result<peer::PeerId> local_peer_;
+    outcome::result<peer::PeerId> remote_peer_;
     std::shared_ptr<security::noise::CipherState> encoder_cs_;
     std::shared_ptr<security::noise::CipherState> decoder_cs_;
     std::shared_ptr<Bytes> frame_buffer_;
     std::shared_ptr<security::noise::InsecureReadWriter> framer_;
-    BufferList write_buffers_;
-    log::Logger log_ = log::createLogger("NoiseConnection");
+    /// Decrypted message in read-ahead buffer of framer_, not read yet
+    BytesOut plaintext_;
+    /// Decryption error of message received ahead, reported to the next read
+    std::error_code read_error_;
+    /// Plaintext gathered by writeSomeVectored(), encrypted before return
+    Bytes gather_buffer_;
+    std::shared_ptr<basic::Scheduler> scheduler_;
+    security::NoiseConfig config_;
+    /// Muxer agreed on in handshake payloads
+    boost::optional<peer::ProtocolName> muxer_;
+    /// Plaintext of coalesced writes to be sealed into one message
+    Bytes coalesce_buffer_;
+    /// Coalesced message is being written
+    bool flushing_ = false;
+    basic::Scheduler::Handle flush_handle_;
+    /// Write waiting till flush frees coalesce_buffer_
+    std::optional<std::pair<BytesIn, WriteCallbackFunc>> blocked_write_;
+    /// Error of coalesced write, reported to following writes
+    std::error_code write_error_;
+    /// close() was called, underlying connection is closed after flush
+    bool closing_ = false;
 
    public:
     LIBP2P_METRICS_INSTANCE_COUNT_IF_ENABLED(
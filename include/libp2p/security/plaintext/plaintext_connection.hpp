@@ -44,6 +44,9 @@ namespace libp2p::connection {
 
     void writeSome(BytesIn in, size_t bytes, WriteCallbackFunc cb) override;
 
+    void writeSomeVectored(std::span<const BytesIn> in,
+                           WriteCallbackFunc cb) override;
+
     void deferWriteCallback(std::error_code ec, WriteCallbackFunc cb) override;
 
     bool isClosed() const override;
@@ -9,7 +9,6 @@
 #include <atomic>
 #include <condition_variable>
 #include <mutex>
-#include <queue>
 
 #include <libp2p/common/metrics/instance_count.hpp>
 #include <libp2p/connection/secure_connection.hpp>
@@ -23,6 +22,7 @@ namespace libp2p::crypto {
   }
   namespace hmac {
     class HmacProvider;
+    class HmacProviderCtrImpl;
   }
 }  // namespace libp2p::crypto
 
@@ -52,6 +52,8 @@ namespace libp2p::connection {
      */
     static constexpr auto kMaxFrameSize = 8 * 1024 * 1024;
     static constexpr auto kLenMarkerSize = sizeof(uint32_t);
+    /// Digest size of SHA512, the longest supported hash
+    static constexpr size_t kMaxMacSize = 64;
 
     template <typename SecretType>
     struct AesSecrets {
@@ -126,18 +128,15 @@ namespace libp2p::connection {
     void popUserData(BytesOut out, size_t bytes);
 
     /**
-     * Computes MAC digest to sign a message using local peer key
+     * Computes MAC digest to sign a message
+     * @param hmac context with local or remote peer key
      * @param message bytes to be signed
-     * @return signature bytes or an error if happened
+     * @param out buffer of macSize() for signature bytes
+     * @return error if happened
      */
-    outcome::result<Bytes> macLocal(BytesIn message) const;
-
-    /**
-     * Computes MAC digest to sign a message using remote peer key
-     * @param message bytes to be signed
-     * @return signature bytes or an error if happened
-     */
-    outcome::result<Bytes> macRemote(BytesIn message) const;
+    static outcome::result<void> mac(crypto::hmac::HmacProviderCtrImpl &hmac,
+                                     BytesIn message,
+                                     BytesOut out);
 
     /// Returns MAC digest size in bytes for the chosen algorithm
     outcome::result<size_t> macSize() const;
@@ -160,10 +159,17 @@ namespace libp2p::connection {
     boost::optional<std::unique_ptr<crypto::aes::AesCtr>> local_encryptor_;
     boost::optional<std::unique_ptr<crypto::aes::AesCtr>> remote_decryptor_;
 
-    std::queue<uint8_t> user_data_buffer_;
+    std::unique_ptr<crypto::hmac::HmacProviderCtrImpl> local_mac_;
+    std::unique_ptr<crypto::hmac::HmacProviderCtrImpl> remote_mac_;
+
+    /// Decrypted bytes of last frame, not yet read, inside read_buffer_
+    BytesIn user_data_;
 
     std::shared_ptr<Bytes> read_buffer_;
 
+    /// Frame being written, reused when previous write completed
+    std::shared_ptr<Bytes> write_buffer_;
+
     log::Logger log_ = log::createLogger("SecIoConnection");
 
    public:
@@ -46,5 +46,12 @@ namespace libp2p::security {
         std::shared_ptr<connection::LayerConnection> outbound,
         const peer::PeerId &p,
         SecConnCallbackFunc cb) = 0;
+
+    /**
+     * @brief Sets muxers offered during handshake, when security protocol
+     * supports it, in order of preference
+     * @param muxers protocols of available muxers
+     */
+    virtual void offerMuxers(std::vector<peer::ProtocolName> /*muxers*/) {}
   };
 }  // namespace libp2p::security
@@ -8,6 +8,8 @@
 
 #include <memory>
 
+#include <libp2p/security/tls/tls_config.hpp>
+
 namespace boost::asio::ssl {
   class context;
 }
@@ -21,14 +23,43 @@ namespace libp2p::crypto::marshaller {
 }  // namespace libp2p::crypto::marshaller
 
 namespace libp2p::security {
+  class TlsSessions;
+
   /**
-   * SSL context with libp2p TLS 1.3 certificate
+   * SSL context with libp2p TLS 1.3 certificate.
+   * Certificate and contexts are built on first access, so hosts which use
+   * neither TLS nor QUIC don't pay for them. Copies share the contexts.
    */
   struct SslContext {
-    SslContext(const peer::IdentityManager &idmgr,
-               const crypto::marshaller::KeyMarshaller &key_marshaller);
+    SslContext(
+        std::shared_ptr<peer::IdentityManager> idmgr,
+        std::shared_ptr<crypto::marshaller::KeyMarshaller> key_marshaller);
+
+    SslContext(
+        std::shared_ptr<peer::IdentityManager> idmgr,
+        std::shared_ptr<crypto::marshaller::KeyMarshaller> key_marshaller,
+        const TlsConfig &config);
+
+    /// Context of TLS security adaptor
+    std::shared_ptr<boost::asio::ssl::context> tls() const;
+
+    /// Context of QUIC transport
+    std::shared_ptr<boost::asio::ssl::context> quic() const;
 
-    std::shared_ptr<boost::asio::ssl::context> tls;
-    std::shared_ptr<boost::asio::ssl::context> quic;
+    /// Sessions of peers dialed with `tls`, null if resumption is disabled
+    std::shared_ptr<TlsSessions> tlsSessions() const;
+
+    const TlsConfig &config() const;
+
+   private:
+    struct Contexts;
+
+    const Contexts &contexts() const;
+
+    std::shared_ptr<Contexts> contexts_;
   };
+
+  /// Index of SSL ex data with muxers and "libp2p" in ALPN wire format, which
+  /// TLS server selects from in order of preference
+  int alpnMuxersIndex();
 }  // namespace libp2p::security
@@ -12,11 +12,10 @@
 #include <libp2p/crypto/key_marshaller.hpp>
 #include <libp2p/peer/identity_manager.hpp>
 #include <libp2p/security/security_adaptor.hpp>
+#include <libp2p/security/tls/ssl_context.hpp>
 #include <libp2p/security/tls/tls_errors.hpp>
 
 namespace libp2p::security {
-  struct SslContext;
-
   /// TLS 1.3 security adaptor
   class TlsAdaptor : public SecurityAdaptor,
                      public std::enable_shared_from_this<TlsAdaptor> {
@@ -43,6 +42,9 @@ namespace libp2p::security {
                         const peer::PeerId &p,
                         SecConnCallbackFunc cb) override;
 
+    /// Offers muxers via ALPN
+    void offerMuxers(std::vector<peer::ProtocolName> muxers) override;
+
    private:
     /// Creates TLSConnection and starts handshake
     void asyncHandshake(std::shared_ptr<connection::LayerConnection> conn,
@@ -58,7 +60,10 @@ namespace libp2p::security {
     /// Key marshaller, needed for custom cert extension
     std::shared_ptr<crypto::marshaller::KeyMarshaller> key_marshaller_;
 
-    /// Shared ssl context
-    std::shared_ptr<boost::asio::ssl::context> ssl_context_;
+    /// Shared ssl context, built by first handshake
+    SslContext ssl_context_;
+
+    /// Muxers and "libp2p" in ALPN wire format, none if no muxers offered
+    std::shared_ptr<const Bytes> alpn_;
   };
 }  // namespace libp2p::security
@@ -0,0 +1,44 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+
+namespace libp2p::security {
+  /**
+   * Config of TLS secured connections
+   */
+  struct TlsConfig {
+    /**
+     * Server issues session tickets, and dials to peers with cached ticket
+     * resume the session instead of full handshake.
+     */
+    bool session_resumption = true;
+
+    /// Max dialed peers whose sessions are kept
+    size_t max_sessions = 1024;
+
+    /// Lifetime of issued session tickets
+    std::chrono::seconds session_lifetime{std::chrono::hours{2}};
+
+    /**
+     * Interval of rotation of keys encrypting issued tickets. Tickets
+     * encrypted with previous key are accepted and renewed.
+     */
+    std::chrono::seconds ticket_key_rotation{std::chrono::hours{2}};
+
+    /**
+     * Linux only. After handshake over plain TCP connection, encryption of
+     * written records moves to kernel (kTLS TX), so writes are plain socket
+     * writes. Connection stays with SSL if kernel or cipher doesn't support
+     * it. Decryption stays with SSL. Connection fails if peer requests key
+     * update.
+     */
+    bool kernel_tls = false;
+  };
+}  // namespace libp2p::security
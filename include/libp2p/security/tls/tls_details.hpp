@@ -6,6 +6,9 @@
 
 #pragma once
 
+#include <chrono>
+#include <memory>
+
 #include <libp2p/crypto/key_marshaller.hpp>
 #include <libp2p/log/logger.hpp>
 #include <libp2p/peer/peer_id.hpp>
@@ -18,6 +21,9 @@ namespace boost::asio::ssl {
 
 namespace libp2p::security::tls_details {
 
+  /// ALPN protocol of libp2p, selected when no muxer is agreed on
+  constexpr std::string_view kAlpnLibp2p = "libp2p";
+
   /// Returns "tls" logger
   log::Logger log();
 
@@ -27,12 +33,21 @@ namespace libp2p::security::tls_details {
   /// \return verify result
   bool verifyCallback(bool status, boost::asio::ssl::verify_context &ctx);
 
+  /// Validity period of generated certificates
+  constexpr std::chrono::hours kCertificateValidity{24 * 365 * 10};
+
+  /// Cached certificate is regenerated when it expires sooner than this
+  constexpr std::chrono::hours kCertificateRenewal{24 * 30};
+
   struct CertificateAndKey {
     /// self-signed certificate in ASN1 DER format
     std::vector<uint8_t> certificate;
 
     /// private key in ASN1 DER format
     std::array<uint8_t, 121> private_key{};
+
+    /// end of certificate validity
+    std::chrono::system_clock::time_point not_after;
   };
 
   /// Creates self-signed certificate with libp2p-specific extension
@@ -43,6 +58,15 @@ namespace libp2p::security::tls_details {
       const crypto::KeyPair &host_key_pair,
       const crypto::marshaller::KeyMarshaller &key_marshaller);
 
+  /// Certificate of host key pair, generated once and shared by all ssl
+  /// contexts of the identity until it approaches expiry
+  /// \param host_key_pair key pair of this host
+  /// \param key_marshaller key marshaller needed to construct the extension
+  /// \return cached or generated cert and key, throws on failure
+  std::shared_ptr<const CertificateAndKey> sharedCertificate(
+      const crypto::KeyPair &host_key_pair,
+      const crypto::marshaller::KeyMarshaller &key_marshaller);
+
   struct PubkeyAndPeerId {
     /// remote peer's public key
     crypto::PublicKey public_key;
@@ -16,6 +16,7 @@ namespace libp2p::security {
     TLS_UNEXPECTED_PEER_ID,
     TLS_REMOTE_PEER_NOT_AVAILABLE,
     TLS_REMOTE_PUBKEY_NOT_AVAILABLE,
+    TLS_KERNEL_KEY_UPDATE,
   };
 }  // namespace libp2p::security
 
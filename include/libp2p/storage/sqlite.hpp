@@ -22,6 +22,11 @@ namespace libp2p::storage {
 
     explicit SQLite(const std::string &db_file);
     SQLite(const std::string &db_file, const std::string &logger_tag);
+
+    /// Opens database with given flags, e.g. read-only
+    SQLite(const std::string &db_file,
+           const std::string &logger_tag,
+           const ::sqlite::sqlite_config &config);
     ~SQLite();
 
     template <typename T>
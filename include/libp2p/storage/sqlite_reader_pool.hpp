@@ -0,0 +1,57 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <libp2p/storage/sqlite.hpp>
+
+namespace libp2p::storage {
+
+  /**
+   * Read-only connections to database, so that threads read concurrently
+   * with each other and with SQLiteWriter. Each connection is used by one
+   * thread at a time, and keeps statements prepared on it
+   */
+  class SQLiteReaderPool {
+   public:
+    /// Connection taken from pool, returned on destruction
+    class Lease {
+     public:
+      Lease(Lease &&other) noexcept;
+      Lease &operator=(Lease &&) = delete;
+      ~Lease();
+
+      SQLite &operator*() const;
+      SQLite *operator->() const;
+
+     private:
+      friend class SQLiteReaderPool;
+
+      Lease(SQLiteReaderPool &pool, std::unique_ptr<SQLite> db);
+
+      SQLiteReaderPool *pool_;
+      std::unique_ptr<SQLite> db_;
+    };
+
+    SQLiteReaderPool(const std::string &db_file, size_t size);
+
+    /// Blocks while all connections are leased
+    Lease acquire();
+
+   private:
+    void release(std::unique_ptr<SQLite> db);
+
+    std::mutex mutex_;
+    std::condition_variable released_;
+    std::vector<std::unique_ptr<SQLite>> free_;
+  };
+
+}  // namespace libp2p::storage
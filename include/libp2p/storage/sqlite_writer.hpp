@@ -0,0 +1,99 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#include <libp2p/basic/mpsc_queue.hpp>
+#include <libp2p/storage/sqlite.hpp>
+
+namespace libp2p::storage {
+
+  /**
+   * Writes to SQLite database on dedicated thread, so that callers are not
+   * blocked by fsync. Commands are posted to lock-free queue, and writer
+   * runs them in transactions, committed when batch is full, interval
+   * elapsed since the first command of transaction, or flush is requested.
+   * Database is switched to WAL mode with synchronous=NORMAL, so readers on
+   * other connections (see SQLiteReaderPool) don't block writer and see
+   * committed transactions
+   */
+  class SQLiteWriter {
+   public:
+    /// Runs on writer thread, inside transaction
+    using Command = std::function<void(SQLite &db)>;
+
+    /// Called on writer thread after transaction of command is over
+    using OnCommit = std::function<void(bool committed)>;
+
+    struct Config {
+      /// Max time command waits for commit
+      std::chrono::milliseconds interval{100};
+
+      /// Max commands of one transaction
+      size_t batch = 256;
+
+      /// Max commands waiting for writer, post fails above it
+      size_t queue_capacity = 4096;
+    };
+
+    SQLiteWriter(const std::string &db_file, const Config &config);
+
+    /// Commits posted commands and stops writer
+    ~SQLiteWriter();
+
+    SQLiteWriter(const SQLiteWriter &) = delete;
+    SQLiteWriter &operator=(const SQLiteWriter &) = delete;
+
+    /**
+     * Called from any thread. Commands are run in order of posting
+     * @return false if queue is full, command is not taken
+     */
+    bool post(Command command, OnCommit on_commit = {});
+
+    /// Blocks until commands posted before are committed, must not be
+    /// called from commands
+    bool flush();
+
+   private:
+    struct Item {
+      Command command;
+      OnCommit on_commit;
+      bool urgent = false;
+    };
+
+    bool push(Item &&item);
+
+    void run();
+
+    /// Waits for command until deadline or stop, false if there is none
+    bool pop(Item &item, std::chrono::steady_clock::time_point deadline);
+
+    Config config_;
+    SQLite db_;
+    SQLite::StatementHandle begin_;
+    SQLite::StatementHandle commit_;
+    SQLite::StatementHandle rollback_;
+
+    basic::MpscQueue<Item> queue_;
+
+    // Writer sleeps while queue is empty, producers wake it only if it
+    // sleeps
+    std::mutex mutex_;
+    std::condition_variable wakeup_;
+    std::atomic_bool sleeping_ = false;
+    bool stop_ = false;
+
+    std::thread thread_;
+  };
+
+}  // namespace libp2p::storage
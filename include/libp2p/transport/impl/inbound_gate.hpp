@@ -0,0 +1,115 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+
+#include <boost/asio/ip/address.hpp>
+
+#include <libp2p/basic/cancel.hpp>
+#include <libp2p/network/connection_gater.hpp>
+
+namespace libp2p::transport {
+
+  /**
+   * Limits of inbound connections
+   */
+  struct InboundGateConfig {
+    /// Connections accepted per second from one subnet
+    double accept_rate = 8;
+
+    /// Connections accepted from one subnet at once
+    size_t accept_burst = 32;
+
+    /// Prefix lengths which define subnet of remote address
+    uint8_t ipv4_prefix = 32;
+    uint8_t ipv6_prefix = 64;
+
+    /// Subnets tracked before idle ones are forgotten
+    size_t max_tracked_subnets = 4096;
+
+    /// Security and muxer negotiations running at once
+    size_t max_inflight_upgrades = 128;
+
+    /// Accepted connections waiting for upgrade, the rest are closed
+    size_t max_queued_upgrades = 1024;
+  };
+
+  /**
+   * Admission of inbound connections before any crypto is done: connection
+   * gater, token bucket per remote subnet, and cap of concurrent upgrades
+   * with queue
+   */
+  class InboundGate : public std::enable_shared_from_this<InboundGate> {
+   public:
+    using Clock = std::chrono::steady_clock;
+
+    /// Held while upgrade is running, next queued upgrade starts on release
+    using Permit = std::shared_ptr<CancelDtor>;
+
+    using StartUpgrade = std::function<void(Permit)>;
+
+    explicit InboundGate(InboundGateConfig config);
+
+    InboundGate(InboundGateConfig config,
+                std::shared_ptr<network::ConnectionGater> gater);
+
+    /// Checks gater, then takes token from bucket of subnet of `address`
+    /// @return false if connection should be closed
+    bool admit(const boost::asio::ip::address &address);
+
+    bool admit(const boost::asio::ip::address &address, Clock::time_point now);
+
+    /// Starts upgrade now, or queues it while too many are running
+    /// @return false if queue is full and connection should be closed
+    bool enqueue(StartUpgrade start);
+
+    size_t inflight() const {
+      return inflight_;
+    }
+
+    size_t queued() const {
+      return queue_.size();
+    }
+
+   private:
+    using Subnet = std::array<uint8_t, 17>;
+
+    struct SubnetHash {
+      size_t operator()(const Subnet &subnet) const;
+    };
+
+    struct Bucket {
+      double tokens;
+      Clock::time_point updated;
+    };
+
+    Subnet subnetOf(const boost::asio::ip::address &address) const;
+
+    /// Refills bucket up to burst
+    void refill(Bucket &bucket, Clock::time_point now) const;
+
+    /// Forgets buckets which refilled completely
+    void forgetIdle(Clock::time_point now);
+
+    void start(StartUpgrade start);
+
+    void release();
+
+    InboundGateConfig config_;
+    std::shared_ptr<network::ConnectionGater> gater_;
+    std::unordered_map<Subnet, Bucket, SubnetHash> buckets_;
+    size_t inflight_ = 0;
+    std::deque<StartUpgrade> queue_;
+  };
+
+}  // namespace libp2p::transport
@@ -6,10 +6,15 @@
 
 #pragma once
 
+#include <optional>
+#include <unordered_set>
 #include <vector>
 
+#include <libp2p/basic/scheduler.hpp>
+#include <libp2p/connection/buffered_connection.hpp>
 #include <libp2p/layer/layer_adaptor.hpp>
 #include <libp2p/muxer/muxer_adaptor.hpp>
+#include <libp2p/network/connection_gater.hpp>
 #include <libp2p/peer/peer_id.hpp>
 #include <libp2p/peer/protocol.hpp>
 #include <libp2p/protocol_muxer/protocol_muxer.hpp>
@@ -17,6 +22,24 @@
 #include <libp2p/transport/upgrader.hpp>
 
 namespace libp2p::transport {
+  /**
+   * Options of connection upgrade
+   */
+  struct UpgraderConfig {
+    /// Security protocol proposed optimistically on dial, e.g. "/noise".
+    /// Multistream header, proposal and the first handshake message are sent
+    /// in one write instead of three round trips, so with TCP fast open new
+    /// secure connection takes about 1.5 RTT. Connection to peer rejecting
+    /// the proposal fails, and further dials to it negotiate as usual
+    std::optional<peer::ProtocolName> optimistic_security;
+
+    /// Connections are buffered below security layer, so that small reads
+    /// and writes of security and muxer layers take fewer syscalls.
+    /// Kernel TLS needs plain TCP connection, so it is not used for buffered
+    /// ones. Disabled by default
+    connection::BufferedConnection::Config buffering;
+  };
+
   class UpgraderImpl : public Upgrader,
                        public std::enable_shared_from_this<UpgraderImpl> {
     using LayerAdaptorSPtr = std::shared_ptr<layer::LayerAdaptor>;
@@ -38,6 +61,28 @@ namespace libp2p::transport {
                  std::vector<SecAdaptorSPtr> security_adaptors,
                  std::vector<MuxAdaptorSPtr> muxer_adaptors);
 
+    UpgraderImpl(std::shared_ptr<protocol_muxer::ProtocolMuxer> protocol_muxer,
+                 std::vector<LayerAdaptorSPtr> layer_adaptors,
+                 std::vector<SecAdaptorSPtr> security_adaptors,
+                 std::vector<MuxAdaptorSPtr> muxer_adaptors,
+                 UpgraderConfig config);
+
+    UpgraderImpl(std::shared_ptr<protocol_muxer::ProtocolMuxer> protocol_muxer,
+                 std::vector<LayerAdaptorSPtr> layer_adaptors,
+                 std::vector<SecAdaptorSPtr> security_adaptors,
+                 std::vector<MuxAdaptorSPtr> muxer_adaptors,
+                 UpgraderConfig config,
+                 std::shared_ptr<basic::Scheduler> scheduler);
+
+    /// @param gater checks remote peer once it is authenticated
+    UpgraderImpl(std::shared_ptr<protocol_muxer::ProtocolMuxer> protocol_muxer,
+                 std::vector<LayerAdaptorSPtr> layer_adaptors,
+                 std::vector<SecAdaptorSPtr> security_adaptors,
+                 std::vector<MuxAdaptorSPtr> muxer_adaptors,
+                 UpgraderConfig config,
+                 std::shared_ptr<basic::Scheduler> scheduler,
+                 std::shared_ptr<network::ConnectionGater> gater);
+
     ~UpgraderImpl() override = default;
 
     void upgradeLayersInbound(RawSPtr conn,
@@ -57,7 +102,11 @@ namespace libp2p::transport {
 
     void upgradeToMuxed(SecSPtr conn, OnMuxedCallbackFunc cb) override;
 
-    enum class Error { SUCCESS = 0, NO_ADAPTOR_FOUND = 1 };
+    enum class Error {
+      SUCCESS = 0,
+      NO_ADAPTOR_FOUND = 1,
+      CONNECTION_GATED = 2,
+    };
 
    private:
     /**
@@ -87,6 +136,31 @@ namespace libp2p::transport {
                                    size_t layer_index,
                                    OnLayerCallbackFunc cb);
 
+    /**
+     * Upgrade a secure connection to the muxed one with a given muxer
+     */
+    static void muxConnection(const MuxAdaptorSPtr &adaptor,
+                              SecSPtr conn,
+                              OnMuxedCallbackFunc cb);
+
+    /**
+     * Secures outbound connection with optimistically proposed protocol
+     * @return false if optimistic negotiation doesn't apply to the peer
+     */
+    bool secureOptimistic(const LayerSPtr &conn,
+                          const peer::PeerId &remoteId,
+                          OnSecuredCallbackFunc &cb);
+
+    /// Wraps connection into buffered one, if configured
+    LayerSPtr buffered(LayerSPtr conn) const;
+
+    /// Closes secured connection to peer denied by gater
+    OnSecuredCallbackFunc gated(OnSecuredCallbackFunc cb) const;
+
+    UpgraderConfig config_;
+    std::shared_ptr<basic::Scheduler> scheduler_;
+    std::shared_ptr<network::ConnectionGater> gater_;
+
     std::shared_ptr<protocol_muxer::ProtocolMuxer> protocol_muxer_;
 
     std::vector<LayerAdaptorSPtr> layer_adaptors_;
@@ -95,6 +169,9 @@ namespace libp2p::transport {
 
     std::vector<peer::ProtocolName> security_protocols_;
     std::vector<peer::ProtocolName> muxer_protocols_;
+
+    /// Peers which rejected optimistic security proposal
+    std::unordered_set<peer::PeerId> optimistic_rejected_;
   };
 }  // namespace libp2p::transport
 
@@ -9,6 +9,7 @@
 #include <memory>
 
 #include <libp2p/common/metrics/instance_count.hpp>
+#include <libp2p/common/metrics/tracing.hpp>
 #include <libp2p/connection/capable_connection.hpp>
 #include <libp2p/transport/upgrader.hpp>
 
@@ -39,6 +40,12 @@ namespace libp2p::transport {
     std::shared_ptr<connection::RawConnection> raw_;
     HandlerFunc handler_;
 
+    /// Spans the whole upgrade, handshake is its child
+    metrics::Span span_;
+
+    /// Starts span, which ends when handler is called
+    void startSpan(std::string_view name);
+
     void secureOutbound(std::shared_ptr<connection::LayerConnection> conn,
                         const peer::PeerId &remoteId);
 
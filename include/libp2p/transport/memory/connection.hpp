@@ -0,0 +1,106 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <atomic>
+#include <vector>
+
+#include <libp2p/connection/capable_connection.hpp>
+
+namespace boost::asio {
+  class io_context;
+}  // namespace boost::asio
+
+namespace libp2p::connection {
+  class MemoryStream;
+}  // namespace libp2p::connection
+
+namespace libp2p::transport {
+  /**
+   * One end of an in-process connection pair.
+   * Peers are known to each other, so neither security nor muxer is
+   * negotiated, each stream is a pair of connection::MemoryStream.
+   */
+  class MemoryConnection
+      : public connection::CapableConnection,
+        public std::enable_shared_from_this<MemoryConnection> {
+   public:
+    /// Identity of a connection end
+    struct Endpoint {
+      std::shared_ptr<boost::asio::io_context> io_context;
+      Multiaddress address;
+      PeerId peer;
+      crypto::PublicKey key;
+    };
+
+    MemoryConnection(Endpoint local, const Endpoint &remote, bool initiator);
+    ~MemoryConnection() override;
+
+    // clang-tidy cppcoreguidelines-special-member-functions
+    MemoryConnection(const MemoryConnection &) = delete;
+    void operator=(const MemoryConnection &) = delete;
+    MemoryConnection(MemoryConnection &&) = delete;
+    void operator=(MemoryConnection &&) = delete;
+
+    /// Creates ends of the connection, first one is the dialer
+    static std::pair<std::shared_ptr<MemoryConnection>,
+                     std::shared_ptr<MemoryConnection>>
+    makePair(Endpoint dialer, Endpoint listener);
+
+    // Reader
+    void read(BytesOut out, size_t bytes, ReadCallbackFunc cb) override;
+    void readSome(BytesOut out, size_t bytes, ReadCallbackFunc cb) override;
+    void deferReadCallback(outcome::result<size_t> res,
+                           ReadCallbackFunc cb) override;
+
+    // Writer
+    void writeSome(BytesIn in, size_t bytes, WriteCallbackFunc cb) override;
+    void deferWriteCallback(std::error_code ec, WriteCallbackFunc cb) override;
+
+    // Closeable
+    bool isClosed() const override;
+    outcome::result<void> close() override;
+
+    // LayerConnection
+    bool isInitiator() const noexcept override;
+    outcome::result<Multiaddress> remoteMultiaddr() override;
+    outcome::result<Multiaddress> localMultiaddr() override;
+
+    // SecureConnection
+    outcome::result<PeerId> localPeer() const override;
+    outcome::result<PeerId> remotePeer() const override;
+    outcome::result<crypto::PublicKey> remotePublicKey() const override;
+
+    // CapableConnection
+    void start() override;
+    void stop() override;
+    void newStream(StreamHandlerFunc cb) override;
+    outcome::result<std::shared_ptr<libp2p::connection::Stream>> newStream()
+        override;
+    void onStream(NewStreamHandlerFunc cb) override;
+
+    const std::shared_ptr<boost::asio::io_context> &ioContext() const {
+      return local_.io_context;
+    }
+
+   private:
+    /// Passes stream opened by the other end to stream handler
+    void onRemoteStream(std::shared_ptr<connection::MemoryStream> stream);
+
+    Endpoint local_;
+    Multiaddress remote_address_;
+    PeerId remote_peer_;
+    crypto::PublicKey remote_key_;
+    bool initiator_;
+    std::weak_ptr<MemoryConnection> remote_;
+    /// shared by both ends, closing one end closes both
+    std::shared_ptr<std::atomic_bool> closed_;
+    NewStreamHandlerFunc on_stream_;
+    /// streams to reset on close
+    std::vector<std::weak_ptr<connection::MemoryStream>> streams_;
+  };
+}  // namespace libp2p::transport
@@ -0,0 +1,35 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <qtils/enum_error_code.hpp>
+
+namespace libp2p {
+  enum class MemoryError {
+    INVALID_ADDRESS,
+    ADDRESS_IN_USE,
+    NO_LISTENER,
+    PEER_MISMATCH,
+    CONN_CLOSED,
+  };
+  Q_ENUM_ERROR_CODE(MemoryError) {
+    using E = decltype(e);
+    switch (e) {
+      case E::INVALID_ADDRESS:
+        return "INVALID_ADDRESS";
+      case E::ADDRESS_IN_USE:
+        return "ADDRESS_IN_USE";
+      case E::NO_LISTENER:
+        return "NO_LISTENER";
+      case E::PEER_MISMATCH:
+        return "PEER_MISMATCH";
+      case E::CONN_CLOSED:
+        return "CONN_CLOSED";
+    }
+    abort();
+  }
+}  // namespace libp2p
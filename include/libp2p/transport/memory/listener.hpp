@@ -0,0 +1,60 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <optional>
+
+#include <libp2p/transport/memory/connection.hpp>
+#include <libp2p/transport/transport_listener.hpp>
+
+namespace libp2p::transport {
+  namespace detail {
+    /// Id of memory listener, from "/memory/<id>[/p2p/<peer>]" multiaddress
+    outcome::result<uint64_t> asMemory(const Multiaddress &ma);
+  }  // namespace detail
+
+  /**
+   * Listener of in-process connections, registered by its "/memory/<id>"
+   * address, which is unique in the process. Id 0 picks a free one.
+   */
+  class MemoryListener : public TransportListener,
+                         public std::enable_shared_from_this<MemoryListener> {
+   public:
+    MemoryListener(MemoryConnection::Endpoint local,
+                   TransportListener::HandlerFunc handler);
+    ~MemoryListener() override;
+
+    // Closeable
+    bool isClosed() const override;
+    outcome::result<void> close() override;
+
+    // TransportListener
+    outcome::result<void> listen(const Multiaddress &address) override;
+    bool canListen(const Multiaddress &ma) const override;
+    outcome::result<Multiaddress> getListenMultiaddr() const override;
+
+    /// Listener registered with given id, if any
+    static std::shared_ptr<MemoryListener> find(uint64_t id);
+
+    /**
+     * Connects dialer to this listener, which gets the other end of
+     * connection
+     * @return dialer end of connection
+     */
+    std::shared_ptr<MemoryConnection> accept(
+        MemoryConnection::Endpoint dialer);
+
+    const PeerId &peer() const {
+      return local_.peer;
+    }
+
+   private:
+    MemoryConnection::Endpoint local_;
+    TransportListener::HandlerFunc handler_;
+    std::optional<uint64_t> id_;
+  };
+}  // namespace libp2p::transport
@@ -0,0 +1,101 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <array>
+#include <mutex>
+#include <optional>
+
+#include <libp2p/connection/stream.hpp>
+
+namespace boost::asio {
+  class io_context;
+}  // namespace boost::asio
+
+namespace libp2p::transport {
+  class MemoryConnection;
+}  // namespace libp2p::transport
+
+namespace libp2p::connection {
+  /**
+   * One end of an in-process stream pair.
+   * Nothing is buffered: a write waits until the other end reads, and data is
+   * copied once, from the writer's buffer straight into the reader's one.
+   * Ends may belong to different io_contexts, callbacks are posted to the
+   * io_context of the end which started the operation.
+   */
+  class MemoryStream : public Stream,
+                       public std::enable_shared_from_this<MemoryStream> {
+   public:
+    /// State shared by both ends
+    struct Pipe;
+
+    MemoryStream(std::shared_ptr<transport::MemoryConnection> conn,
+                 std::shared_ptr<Pipe> pipe,
+                 size_t end);
+    ~MemoryStream() override;
+
+    // clang-tidy cppcoreguidelines-special-member-functions
+    MemoryStream(const MemoryStream &) = delete;
+    void operator=(const MemoryStream &) = delete;
+    MemoryStream(MemoryStream &&) = delete;
+    void operator=(MemoryStream &&) = delete;
+
+    /// Creates ends of the stream, first one is the initiator
+    static std::pair<std::shared_ptr<MemoryStream>,
+                     std::shared_ptr<MemoryStream>>
+    makePair(std::shared_ptr<transport::MemoryConnection> initiator,
+             std::shared_ptr<transport::MemoryConnection> responder);
+
+    // Reader
+    void read(BytesOut out, size_t bytes, ReadCallbackFunc cb) override;
+    void readSome(BytesOut out, size_t bytes, ReadCallbackFunc cb) override;
+    void deferReadCallback(outcome::result<size_t> res,
+                           ReadCallbackFunc cb) override;
+
+    // Writer
+    void writeSome(BytesIn in, size_t bytes, WriteCallbackFunc cb) override;
+    void deferWriteCallback(std::error_code ec, WriteCallbackFunc cb) override;
+
+    // Stream
+    bool isClosedForRead() const override;
+    bool isClosedForWrite() const override;
+    bool isClosed() const override;
+    void close(VoidResultHandlerFunc cb) override;
+    void reset() override;
+    void adjustWindowSize(uint32_t new_size, VoidResultHandlerFunc cb) override;
+    outcome::result<bool> isInitiator() const override;
+    outcome::result<PeerId> remotePeerId() const override;
+    outcome::result<Multiaddress> localMultiaddr() const override;
+    outcome::result<Multiaddress> remoteMultiaddr() const override;
+
+   private:
+    std::shared_ptr<transport::MemoryConnection> conn_;
+    std::shared_ptr<Pipe> pipe_;
+    /// index of this end in pipe
+    size_t end_;
+  };
+
+  struct MemoryStream::Pipe {
+    /// Data flowing from one end to the other
+    struct Direction {
+      /// write of the sending end, waiting for the receiving end
+      std::optional<std::pair<BytesIn, WriteCallbackFunc>> writing;
+      /// read of the receiving end, waiting for the sending end
+      std::optional<std::pair<BytesOut, ReadCallbackFunc>> reading;
+      /// sending end was closed
+      bool closed = false;
+    };
+
+    std::mutex mutex;
+    /// directions[i] carries data written by end i
+    std::array<Direction, 2> directions;
+    /// io_contexts of ends
+    std::array<std::shared_ptr<boost::asio::io_context>, 2> io_contexts;
+    bool reset = false;
+  };
+}  // namespace libp2p::connection
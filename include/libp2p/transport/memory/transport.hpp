@@ -0,0 +1,47 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <libp2p/transport/transport_adaptor.hpp>
+
+namespace boost::asio {
+  class io_context;
+}  // namespace boost::asio
+
+namespace libp2p::peer {
+  struct IdentityManager;
+}  // namespace libp2p::peer
+
+namespace libp2p::transport {
+  /**
+   * In-process transport of "/memory/<id>" addresses, connecting hosts which
+   * run in the same process. Connections need no upgrade, stream data is
+   * handed over between paired streams without intermediate buffers.
+   */
+  class MemoryTransport : public TransportAdaptor,
+                          public std::enable_shared_from_this<MemoryTransport> {
+   public:
+    MemoryTransport(std::shared_ptr<boost::asio::io_context> io_context,
+                    const peer::IdentityManager &id_mgr);
+
+    // Adaptor
+    peer::ProtocolName getProtocolId() const override;
+
+    // TransportAdaptor
+    void dial(const PeerId &peer,
+              Multiaddress address,
+              TransportAdaptor::HandlerFunc cb) override;
+    std::shared_ptr<TransportListener> createListener(
+        TransportListener::HandlerFunc cb) override;
+    bool canDial(const Multiaddress &ma) const override;
+
+   private:
+    std::shared_ptr<boost::asio::io_context> io_context_;
+    PeerId local_peer_;
+    crypto::PublicKey local_key_;
+  };
+}  // namespace libp2p::transport
@@ -0,0 +1,127 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+
+namespace libp2p::transport {
+  /// Congestion controller of quic connections
+  enum class QuicCongestionControl {
+    /// Keeps lsquic default
+    DEFAULT = 0,
+    /// Loss based, backs off on every loss. Fair to TCP flows, but
+    /// underuses lossy links with high bandwidth-delay product
+    CUBIC = 1,
+    /// Model based (BBRv1), keeps throughput on lossy and long links and
+    /// keeps queues short, but may take bandwidth from loss based flows
+    BBR = 2,
+    /// BBR for connections with high RTT, Cubic otherwise
+    ADAPTIVE = 3,
+  };
+
+  /**
+   * Config of quic transport.
+   * Zero values of engine settings keep defaults, derived from
+   * MuxedConnectionConfig where it has the same setting and otherwise
+   * taken from lsquic, whose defaults are tuned for web browsing
+   */
+  struct QuicConfig {
+    /**
+     * Number of SO_REUSEPORT sockets serving each listen address, each with
+     * its own engine. Kernel spreads new connections across sockets, packets
+     * of established connections are steered to their engine by connection
+     * id (Linux).
+     */
+    size_t listen_sockets = 1;
+
+    /**
+     * Engines of listen sockets except the first run on their own threads
+     * and io_contexts. Accept handler and callbacks of connections accepted
+     * by these engines are called on their threads.
+     */
+    bool listen_threads = false;
+
+    /**
+     * Dials to peers with cached session ticket complete immediately, streams
+     * opened before the handshake is confirmed are sent as 0-RTT data, and
+     * listeners accept 0-RTT data.
+     * Early data may be replayed by an attacker, so it is disabled by default,
+     * enable only if all protocols used over QUIC are idempotent.
+     */
+    bool early_data = false;
+
+    /**
+     * Negotiates unreliable datagrams (RFC 9221) with peers, see
+     * CapableConnection::sendDatagram. Datagrams are not retransmitted and
+     * not blocked by losses of streams, peers without support are not
+     * affected
+     */
+    bool datagrams = false;
+
+    /**
+     * Keeps accepted connections when peer address changes, e.g. on NAT
+     * rebinding or when mobile peer switches network. New path is validated
+     * before use, then remote address of connection is updated and
+     * QuicConnection::onRemoteChanged handler is called
+     */
+    bool migration = true;
+
+    /// Congestion controller, see QuicCongestionControl
+    QuicCongestionControl congestion_control = QuicCongestionControl::DEFAULT;
+
+    /**
+     * Spreads packets of congestion window over RTT instead of sending them
+     * in bursts. Bursts get higher throughput on short idle links at cost
+     * of losses in shallow router buffers. BBR relies on pacing
+     */
+    bool pacing = true;
+
+    /**
+     * Flow control window of each stream at start, in bytes. Small window
+     * limits first round trips of bulk transfers to window per RTT, large
+     * lets a peer buffer much unread data in memory.
+     * @note Default: MuxedConnectionConfig::maximum_window_size
+     */
+    size_t initial_stream_window = 0;
+
+    /// Stream window auto-tuning grows up to this size, in bytes
+    size_t max_stream_window = 0;
+
+    /**
+     * Flow control window of connection at start and its auto-tuning limit,
+     * in bytes. Limits sum of data in flight over all streams, must be not
+     * less than stream window for a single stream to use it fully
+     */
+    size_t initial_connection_window = 0;
+    size_t max_connection_window = 0;
+
+    /**
+     * Bidirectional streams opened by peer at once. More streams let
+     * request-response protocols run in parallel at cost of memory per
+     * stream.
+     * @note Default: MuxedConnectionConfig::maximum_streams
+     */
+    size_t max_streams = 0;
+
+    /**
+     * Connection without packets for this time is closed. Short timeout
+     * releases dead peers early, long one keeps quiet peers connected
+     * without keepalive traffic.
+     * @note Default: MuxedConnectionConfig::no_streams_interval
+     */
+    std::chrono::seconds idle_timeout{0};
+
+    /**
+     * Packet size used before path MTU discovery completes and its upper
+     * limit, in bytes. Larger packets cost less CPU per byte, but are lost
+     * on paths with smaller MTU until discovery backs off
+     */
+    size_t base_packet_size = 0;
+    size_t max_packet_size = 0;
+  };
+}  // namespace libp2p::transport
@@ -22,6 +22,8 @@ namespace libp2p::transport {
   class QuicConnection : public connection::CapableConnection,
                          public std::enable_shared_from_this<QuicConnection> {
    public:
+    using RemoteChangedHandler = std::function<void(const Multiaddress &)>;
+
     QuicConnection(std::shared_ptr<boost::asio::io_context> io_context,
                    lsquic::ConnCtx *conn_ctx,
                    bool initiator,
@@ -69,8 +71,18 @@ namespace libp2p::transport {
     outcome::result<std::shared_ptr<libp2p::connection::Stream>> newStream()
         override;
     void onStream(NewStreamHandlerFunc cb) override;
+    size_t maxDatagramSize() const override;
+    outcome::result<void> sendDatagram(BytesIn datagram) override;
+    void onDatagram(DatagramHandler handler) override;
+
+    /// Sets handler of remote address changes by path migration
+    void onRemoteChanged(RemoteChangedHandler handler);
 
     void onClose();
+    /// Calls datagram handler later, as lsquic is processing
+    void datagramIn(BytesIn datagram);
+    /// Updates remote address, calls handler later
+    void remoteChanged(Multiaddress remote);
     auto &onStream() const {
       return on_stream_;
     }
@@ -83,6 +95,8 @@ namespace libp2p::transport {
     PeerId local_peer_, peer_;
     crypto::PublicKey key_;
     NewStreamHandlerFunc on_stream_;
+    DatagramHandler on_datagram_;
+    RemoteChangedHandler on_remote_changed_;
 
    public:
     LIBP2P_METRICS_INSTANCE_COUNT_IF_ENABLED(libp2p::transport::QuicConnection);
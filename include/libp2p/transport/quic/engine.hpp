@@ -9,10 +9,15 @@
 #include <lsquic.h>
 #include <boost/asio/ip/udp.hpp>
 #include <boost/asio/steady_timer.hpp>
+#include <libp2p/crypto/key.hpp>
 #include <libp2p/multi/multiaddress.hpp>
 #include <libp2p/peer/peer_id.hpp>
+#include <libp2p/transport/quic/config.hpp>
+#include <deque>
 #include <memory>
 #include <optional>
+#include <span>
+#include <unordered_map>
 #include <qtils/bytes.hpp>
 #include <qtils/outcome.hpp>
 
@@ -49,6 +54,8 @@ namespace libp2p::transport::lsquic {
 
   using OnConnect =
       std::function<void(outcome::result<std::shared_ptr<QuicConnection>>)>;
+  using OnNewStream =
+      std::function<void(outcome::result<std::shared_ptr<QuicStream>>)>;
   /**
    * Connect operation arguments.
    */
@@ -56,6 +63,16 @@ namespace libp2p::transport::lsquic {
     boost::asio::ip::udp::endpoint remote;
     PeerId peer;
     OnConnect cb;
+    /// Key of resumed peer, connection is reported before handshake
+    std::optional<crypto::PublicKey> early_key{};
+  };
+
+  /**
+   * Session resumption state received from dialed peer.
+   */
+  struct SessionTicket {
+    Bytes resume;
+    crypto::PublicKey key;
   };
   /**
    * `lsquic_conn_ctx_t` for libp2p connection.
@@ -65,7 +82,17 @@ namespace libp2p::transport::lsquic {
     lsquic_conn_t *ls_conn;
     std::optional<Connecting> connecting{};
     std::optional<std::shared_ptr<QuicStream>> new_stream{};
+    /// Streams requested, but not yet created by lsquic
+    std::deque<OnNewStream> pending_streams{};
     std::weak_ptr<QuicConnection> conn{};
+    /// Dialed peer, its session tickets are cached
+    std::optional<PeerId> peer{};
+    /// Connection was reported before handshake to send early data
+    bool early = false;
+    /// Datagrams waiting for space in packets
+    std::deque<Bytes> datagrams{};
+    /// Peer address of current path, changes on migration
+    boost::asio::ip::udp::endpoint remote{};
   };
 
   /**
@@ -77,15 +104,31 @@ namespace libp2p::transport::lsquic {
     std::weak_ptr<QuicStream> stream{};
     /**
      * Stream read operation arguments.
+     * `all` read completes only when whole `out` is filled, `done` bytes of
+     * it are already read.
      */
     struct Reading {
       BytesOut out;
       std::function<void(outcome::result<size_t>)> cb;
+      bool all = false;
+      size_t done = 0;
     };
     std::optional<Reading> reading{};
   };
 
+  /**
+   * lsquic engine settings of config, zero fields keep defaults.
+   * Throws `std::invalid_argument` if lsquic rejects the settings.
+   * @param flags - `LSENG_SERVER` for server engine
+   */
+  lsquic_engine_settings engineSettings(
+      const muxer::MuxedConnectionConfig &mux_config,
+      const QuicConfig &config,
+      unsigned flags);
+
   using OnAccept = std::function<void(std::shared_ptr<QuicConnection>)>;
+  /// Whether datagrams from remote address are fed into lsquic
+  using AdmitRemote = std::function<bool(const boost::asio::ip::address &)>;
 
   /**
    * libp2p wrapper and adapter for lsquic server/client socket.
@@ -95,10 +138,13 @@ namespace libp2p::transport::lsquic {
     Engine(std::shared_ptr<boost::asio::io_context> io_context,
            std::shared_ptr<boost::asio::ssl::context> ssl_context,
            const muxer::MuxedConnectionConfig &mux_config,
+           const QuicConfig &config,
            PeerId local_peer,
            std::shared_ptr<crypto::marshaller::KeyMarshaller> key_codec,
            boost::asio::ip::udp::socket &&socket,
-           bool client);
+           bool client,
+           size_t cid_index = 0,
+           size_t cid_count = 1);
     ~Engine();
 
     // clang-tidy cppcoreguidelines-special-member-functions
@@ -115,14 +161,57 @@ namespace libp2p::transport::lsquic {
                  const PeerId &peer,
                  OnConnect cb);
     outcome::result<std::shared_ptr<QuicStream>> newStream(ConnCtx *conn_ctx);
+    /// Calls back later if lsquic postpones stream creation
+    void newStream(ConnCtx *conn_ctx, OnNewStream cb);
+    /// Zero if peer didn't negotiate datagrams
+    size_t maxDatagramSize(ConnCtx *conn_ctx) const;
+    /// Queues datagram to be sent with next packets
+    outcome::result<void> sendDatagram(ConnCtx *conn_ctx, BytesIn datagram);
     void onAccept(OnAccept cb) {
       on_accept_ = std::move(cb);
     }
+    /// Datagrams of denied remotes are dropped before lsquic sees them
+    void admitRemote(AdmitRemote admit) {
+      admit_remote_ = std::move(admit);
+    }
     void process();
 
+    /// Max dialed peers whose session tickets are kept
+    static constexpr size_t kMaxSessionTickets = 1024;
+
+    /// Datagram fits into packet of minimal QUIC path MTU (1200 bytes)
+    /// with headers of short packet and DATAGRAM frame
+    static constexpr size_t kMaxDatagramSize = 1150;
+
+    /// Queued datagrams per connection, oldest are dropped above limit
+    static constexpr size_t kMaxQueuedDatagrams = 64;
+
    private:
+    /// Updates remote address of connection after path migration
+    static void checkPath(ConnCtx *conn_ctx);
+
     void readLoop();
 
+    /**
+     * Feeds received datagram into lsquic, splits it into segments coalesced
+     * by GRO.
+     */
+    void packetIn(BytesIn datagram,
+                  size_t segment_size,
+                  const boost::asio::ip::udp::endpoint &remote);
+
+    /**
+     * Sends packets for `ea_packets_out`, batched by `sendmmsg` and coalesced
+     * by GSO where supported.
+     * @return number of packets sent
+     */
+    int packetsOut(std::span<const lsquic_out_spec> specs);
+
+    /**
+     * Keeps ticket to resume next connection to the peer.
+     */
+    void cacheSessionTicket(const PeerId &peer, SessionTicket ticket);
+
     std::shared_ptr<boost::asio::io_context> io_context_;
     std::shared_ptr<boost::asio::ssl::context> ssl_context_;
     PeerId local_peer_;
@@ -133,13 +222,33 @@ namespace libp2p::transport::lsquic {
     Multiaddress local_;
     lsquic_engine_t *engine_ = nullptr;
     OnAccept on_accept_;
+    AdmitRemote admit_remote_;
     bool started_ = false;
     std::optional<Connecting> connecting_;
     struct Reading {
       static constexpr size_t kMaxUdpPacketSize = 64 << 10;
-      qtils::BytesN<kMaxUdpPacketSize> buf;
-      boost::asio::ip::udp::endpoint remote;
+      /// Datagrams received by one `recvmmsg`
+#ifdef __linux__
+      static constexpr size_t kBatch = 16;
+#else
+      static constexpr size_t kBatch = 1;
+#endif
+      std::array<qtils::BytesN<kMaxUdpPacketSize>, kBatch> bufs;
+      std::array<boost::asio::ip::udp::endpoint, kBatch> remotes;
     };
     Reading reading_;
+    /// First byte of connection ids this engine issues is `cid_index_` modulo
+    /// `cid_count_`, so that SO_REUSEPORT group steers packets to it
+    size_t cid_index_;
+    size_t cid_count_;
+    /// Dials with session ticket report connection immediately and send
+    /// streams as 0-RTT data
+    bool early_data_;
+    /// Single use, taken by next dial to the peer
+    std::unordered_map<PeerId, SessionTicket> session_tickets_;
+    /// Kernel coalesces received datagrams (UDP_GRO)
+    bool gro_ = false;
+    /// Kernel segments sent datagrams (UDP_SEGMENT), disabled on first error
+    bool gso_ = false;
   };
 }  // namespace libp2p::transport::lsquic
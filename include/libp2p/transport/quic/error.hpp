@@ -16,6 +16,8 @@ namespace libp2p {
     TOO_MANY_STREAMS,
     CANT_CREATE_CONNECTION,
     CANT_OPEN_STREAM,
+    DATAGRAMS_UNSUPPORTED,
+    DATAGRAM_TOO_LARGE,
   };
   Q_ENUM_ERROR_CODE(QuicError) {
     using E = decltype(e);
@@ -32,6 +34,10 @@ namespace libp2p {
         return "CANT_CREATE_CONNECTION";
       case E::CANT_OPEN_STREAM:
         return "CANT_OPEN_STREAM";
+      case E::DATAGRAMS_UNSUPPORTED:
+        return "DATAGRAMS_UNSUPPORTED";
+      case E::DATAGRAM_TOO_LARGE:
+        return "DATAGRAM_TOO_LARGE";
     }
     abort();
   }
@@ -6,7 +6,11 @@
 
 #pragma once
 
+#include <thread>
+#include <vector>
+
 #include <libp2p/muxer/muxed_connection_config.hpp>
+#include <libp2p/transport/quic/config.hpp>
 #include <libp2p/transport/transport_listener.hpp>
 
 namespace boost::asio {
@@ -21,6 +25,10 @@ namespace libp2p::crypto::marshaller {
   class KeyMarshaller;
 }  // namespace libp2p::crypto::marshaller
 
+namespace libp2p::network {
+  class ConnectionGater;
+}  // namespace libp2p::network
+
 namespace libp2p::transport::lsquic {
   class Engine;
 }  // namespace libp2p::transport::lsquic
@@ -32,9 +40,12 @@ namespace libp2p::transport {
     QuicListener(std::shared_ptr<boost::asio::io_context> io_context,
                  std::shared_ptr<boost::asio::ssl::context> ssl_context,
                  const muxer::MuxedConnectionConfig &mux_config,
+                 const QuicConfig &config,
                  PeerId local_peer,
                  std::shared_ptr<crypto::marshaller::KeyMarshaller> key_codec,
+                 std::shared_ptr<network::ConnectionGater> gater,
                  TransportListener::HandlerFunc handler);
+    ~QuicListener() override;
 
     // Closeable
     bool isClosed() const override;
@@ -49,9 +60,15 @@ namespace libp2p::transport {
     std::shared_ptr<boost::asio::io_context> io_context_;
     std::shared_ptr<boost::asio::ssl::context> ssl_context_;
     muxer::MuxedConnectionConfig mux_config_;
+    QuicConfig config_;
     PeerId local_peer_;
     std::shared_ptr<crypto::marshaller::KeyMarshaller> key_codec_;
+    std::shared_ptr<network::ConnectionGater> gater_;
     TransportListener::HandlerFunc handler_;
-    std::shared_ptr<lsquic::Engine> server_;
+    /// One engine per SO_REUSEPORT socket, in order sockets joined the group
+    std::vector<std::shared_ptr<lsquic::Engine>> servers_;
+    /// io_contexts of engines running on own threads
+    std::vector<std::shared_ptr<boost::asio::io_context>> worker_io_;
+    std::vector<std::thread> workers_;
   };
 }  // namespace libp2p::transport
@@ -0,0 +1,155 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <span>
+#include <vector>
+
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+#ifdef __linux__
+#include <netinet/udp.h>
+#endif
+
+namespace libp2p::transport::lsquic {
+
+  struct SendBatchResult {
+    /// Number of packets from the start of batch, which were sent or dropped
+    size_t sent = 0;
+    /// Packets dropped on errors other than full socket buffer
+    size_t dropped = 0;
+    /// Socket buffer is full, packets after `sent` wait till it is writable
+    bool wait_writable = false;
+  };
+
+  inline socklen_t sockaddrLen(const sockaddr *sa) {
+    return sa->sa_family == AF_INET ? sizeof(sockaddr_in)
+                                    : sizeof(sockaddr_in6);
+  }
+
+#ifdef __linux__
+  /**
+   * Sends packets by `sendmmsg`, coalescing packets of equal size to the same
+   * destination by GSO while `gso` is set. GSO is disabled on EIO, when the
+   * device can't offload checksums.
+   * Packet failing with error other than EAGAIN, e.g. EHOSTUNREACH, is
+   * dropped, as if it was lost on the path, so that the engine doesn't wait
+   * for socket, which is writable.
+   * @tparam Spec has `iov`, `iovlen` and `dest_sa` like `lsquic_out_spec`
+   * @param send is `sendmmsg` of the socket, writes `errno` on failure
+   */
+  template <typename Spec, typename Send>
+  SendBatchResult sendBatch(std::span<const Spec> specs,
+                            bool &gso,
+                            Send &&send) {
+    constexpr size_t kBatch = 64;
+    // kernel limits of UDP_SEGMENT
+    constexpr size_t kMaxSegments = 64;
+    constexpr size_t kMaxGsoBytes = 65507;
+    auto spec_size = [](const Spec &spec) {
+      size_t size = 0;
+      for (auto &iov : std::span{spec.iov, spec.iovlen}) {
+        size += iov.iov_len;
+      }
+      return size;
+    };
+
+    SendBatchResult result;
+    while (result.sent < specs.size()) {
+      std::array<mmsghdr, kBatch> msgs{};
+      std::array<size_t, kBatch> msg_packets{};
+      std::array<std::array<char, CMSG_SPACE(sizeof(uint16_t))>, kBatch>
+          controls{};
+      // message iovs refer to it, no reallocations allowed
+      std::vector<iovec> iovs;
+      size_t n_iov = 0;
+      for (auto &spec : specs.subspan(result.sent)) {
+        n_iov += spec.iovlen;
+      }
+      iovs.reserve(n_iov);
+
+      size_t n_msgs = 0;
+      size_t i = result.sent;
+      while (n_msgs < kBatch and i < specs.size()) {
+        auto &first = specs[i];
+        auto segment = spec_size(first);
+        auto total = segment;
+        auto &hdr = msgs[n_msgs].msg_hdr;
+        hdr.msg_iov = iovs.data() + iovs.size();
+        iovs.insert(iovs.end(), first.iov, first.iov + first.iovlen);
+        size_t packets = 1;
+        ++i;
+        // GSO: same destination, equal sizes, only the last may be smaller
+        while (gso and i < specs.size() and packets < kMaxSegments) {
+          auto &spec = specs[i];
+          auto size = spec_size(spec);
+          auto len = sockaddrLen(first.dest_sa);
+          if (size > segment or total + size > kMaxGsoBytes
+              or sockaddrLen(spec.dest_sa) != len
+              or memcmp(spec.dest_sa, first.dest_sa, len) != 0) {
+            break;
+          }
+          iovs.insert(iovs.end(), spec.iov, spec.iov + spec.iovlen);
+          total += size;
+          ++packets;
+          ++i;
+          if (size < segment) {
+            break;
+          }
+        }
+        hdr.msg_iovlen = iovs.data() + iovs.size() - hdr.msg_iov;
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+        hdr.msg_name = const_cast<sockaddr *>(first.dest_sa);
+        hdr.msg_namelen = sockaddrLen(first.dest_sa);
+        if (packets > 1) {
+          hdr.msg_control = controls[n_msgs].data();
+          hdr.msg_controllen = controls[n_msgs].size();
+          auto cmsg = CMSG_FIRSTHDR(&hdr);
+          cmsg->cmsg_level = SOL_UDP;
+          cmsg->cmsg_type = UDP_SEGMENT;
+          cmsg->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+          auto segment16 = static_cast<uint16_t>(segment);
+          memcpy(CMSG_DATA(cmsg), &segment16, sizeof(segment16));
+        }
+        msg_packets[n_msgs] = packets;
+        ++n_msgs;
+      }
+
+      auto n = send(msgs.data(), static_cast<unsigned>(n_msgs));
+      if (n == -1) {
+        if (errno == EAGAIN or errno == EWOULDBLOCK) {
+          result.wait_writable = true;
+          break;
+        }
+        if (errno == EINTR) {
+          continue;
+        }
+        if (errno == EIO and gso) {
+          gso = false;
+          continue;
+        }
+        result.sent += msg_packets[0];
+        result.dropped += msg_packets[0];
+        continue;
+      }
+      if (n == 0) {
+        result.wait_writable = true;
+        break;
+      }
+      // error of the first message not sent is reported by the next call
+      for (size_t j = 0; j < static_cast<size_t>(n); ++j) {
+        result.sent += msg_packets[j];
+      }
+    }
+    return result;
+  }
+#endif
+}  // namespace libp2p::transport::lsquic
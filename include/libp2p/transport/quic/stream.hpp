@@ -39,6 +39,8 @@ namespace libp2p::connection {
 
     // Writer
     void writeSome(BytesIn in, size_t bytes, WriteCallbackFunc cb) override;
+    void writeSomeVectored(std::span<const BytesIn> in,
+                           WriteCallbackFunc cb) override;
     void deferWriteCallback(std::error_code ec, WriteCallbackFunc cb) override;
 
     // Stream
@@ -8,28 +8,31 @@
 
 #include <boost/asio/ip/udp.hpp>
 #include <libp2p/muxer/muxed_connection_config.hpp>
+#include <libp2p/network/dns_cache.hpp>
+#include <libp2p/security/tls/ssl_context.hpp>
+#include <libp2p/transport/quic/config.hpp>
 #include <libp2p/transport/transport_adaptor.hpp>
 
 namespace boost::asio {
   class io_context;
 }  // namespace boost::asio
 
-namespace boost::asio::ssl {
-  class context;
-}  // namespace boost::asio::ssl
-
 namespace libp2p::crypto::marshaller {
   class KeyMarshaller;
 }  // namespace libp2p::crypto::marshaller
 
+namespace libp2p::network::c_ares {
+  class AresChannel;
+}  // namespace libp2p::network::c_ares
+
+namespace libp2p::network {
+  class ConnectionGater;
+}  // namespace libp2p::network
+
 namespace libp2p::peer {
   struct IdentityManager;
 }  // namespace libp2p::peer
 
-namespace libp2p::security {
-  struct SslContext;
-}  // namespace libp2p::security
-
 namespace libp2p::transport::lsquic {
   class Engine;
 }  // namespace libp2p::transport::lsquic
@@ -41,8 +44,20 @@ namespace libp2p::transport {
     QuicTransport(std::shared_ptr<boost::asio::io_context> io_context,
                   const security::SslContext &ssl_context,
                   const muxer::MuxedConnectionConfig &mux_config,
+                  const QuicConfig &config,
+                  const peer::IdentityManager &id_mgr,
+                  std::shared_ptr<crypto::marshaller::KeyMarshaller> key_codec,
+                  std::shared_ptr<network::c_ares::AresChannel> ares);
+
+    /// @param gater filters datagrams of inbound connections
+    QuicTransport(std::shared_ptr<boost::asio::io_context> io_context,
+                  const security::SslContext &ssl_context,
+                  const muxer::MuxedConnectionConfig &mux_config,
+                  const QuicConfig &config,
                   const peer::IdentityManager &id_mgr,
-                  std::shared_ptr<crypto::marshaller::KeyMarshaller> key_codec);
+                  std::shared_ptr<crypto::marshaller::KeyMarshaller> key_codec,
+                  std::shared_ptr<network::c_ares::AresChannel> ares,
+                  std::shared_ptr<network::ConnectionGater> gater);
 
     // Adaptor
     peer::ProtocolName getProtocolId() const override;
@@ -56,15 +71,22 @@ namespace libp2p::transport {
     bool canDial(const Multiaddress &ma) const override;
 
    private:
-    std::shared_ptr<lsquic::Engine> makeClient(
-        boost::asio::ip::udp protocol) const;
+    /// Client engine of protocol, socket is opened by first dial
+    const std::shared_ptr<lsquic::Engine> &client(
+        boost::asio::ip::udp protocol);
 
     std::shared_ptr<boost::asio::io_context> io_context_;
-    std::shared_ptr<boost::asio::ssl::context> ssl_context_;
+    security::SslContext ssl_context_;
     muxer::MuxedConnectionConfig mux_config_;
+    QuicConfig config_;
     PeerId local_peer_;
     std::shared_ptr<crypto::marshaller::KeyMarshaller> key_codec_;
+    std::shared_ptr<network::c_ares::AresChannel> ares_;
+    std::shared_ptr<network::ConnectionGater> gater_;
     boost::asio::ip::udp::resolver resolver_;
+    std::shared_ptr<
+        network::DnsCache<boost::asio::ip::udp::resolver::results_type>>
+        dns_cache_;
     std::shared_ptr<lsquic::Engine> client4_, client6_;
   };
 }  // namespace libp2p::transport
@@ -0,0 +1,68 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <stdexcept>
+
+#include <sys/socket.h>
+
+namespace libp2p::transport {
+
+  /**
+   * Integer socket option not provided by asio, e.g. SO_REUSEPORT.
+   * Satisfies GettableSocketOption and SettableSocketOption of asio, so works
+   * with `set_option` and `get_option` of any asio socket or acceptor.
+   */
+  template <int Level, int Name>
+  class IntegerSocketOption {
+   public:
+    IntegerSocketOption() = default;
+
+    explicit IntegerSocketOption(int value) : value_{value} {}
+
+    int value() const {
+      return value_;
+    }
+
+    template <typename Protocol>
+    int level(const Protocol &) const {
+      return Level;
+    }
+
+    template <typename Protocol>
+    int name(const Protocol &) const {
+      return Name;
+    }
+
+    template <typename Protocol>
+    int *data(const Protocol &) {
+      return &value_;
+    }
+
+    template <typename Protocol>
+    const int *data(const Protocol &) const {
+      return &value_;
+    }
+
+    template <typename Protocol>
+    socklen_t size(const Protocol &) const {
+      return sizeof(value_);
+    }
+
+    template <typename Protocol>
+    void resize(const Protocol &, size_t size) {
+      if (size != sizeof(value_)) {
+        throw std::length_error{"integer socket option resize"};
+      }
+    }
+
+   private:
+    int value_ = 0;
+  };
+
+}  // namespace libp2p::transport
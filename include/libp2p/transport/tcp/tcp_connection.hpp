@@ -8,13 +8,16 @@
 
 #include <atomic>
 #include <chrono>
+#include <deque>
 #include <optional>
 
 #include <boost/asio.hpp>
 #include <boost/noncopyable.hpp>
 #include <libp2p/common/metrics/instance_count.hpp>
+#include <libp2p/common/metrics/traffic.hpp>
 #include <libp2p/connection/raw_connection.hpp>
 #include <libp2p/multi/multiaddress.hpp>
+#include <libp2p/transport/tcp/tcp_socket_options.hpp>
 
 namespace libp2p::security {
   class TlsAdaptor;
@@ -24,10 +27,15 @@ namespace libp2p::transport {
 
   /**
    * @brief boost::asio implementation of TCP connection (socket).
+   * Timers and callbacks run on the executor of the socket. Connections are
+   * not sharded across io_context threads: security, muxers, connection
+   * manager and protocols on top of them share the scheduler and state of
+   * one thread, so the socket has to stay on the io_context of the host.
    */
-  class TcpConnection : public connection::RawConnection,
-                        public std::enable_shared_from_this<TcpConnection>,
-                        private boost::noncopyable {
+  class TcpConnection final
+      : public connection::RawConnection,
+        public std::enable_shared_from_this<TcpConnection>,
+        private boost::noncopyable {
    public:
     ~TcpConnection() override = default;
 
@@ -39,9 +47,21 @@ namespace libp2p::transport {
 
     explicit TcpConnection(boost::asio::io_context &ctx, ProtoAddrVec layers);
 
+    /// @param options are applied to socket on connect
     TcpConnection(boost::asio::io_context &ctx,
                   ProtoAddrVec layers,
-                  Tcp::socket &&socket);
+                  TcpSocketOptions options);
+
+    /**
+     * Wraps accepted socket. Timers and deferred callbacks run on the
+     * executor of the socket.
+     */
+    TcpConnection(ProtoAddrVec layers, Tcp::socket &&socket);
+
+    /// Wraps accepted socket, which options were applied to
+    TcpConnection(ProtoAddrVec layers,
+                  Tcp::socket &&socket,
+                  TcpSocketOptions options);
 
     /**
      * @brief Connect to a remote service.
@@ -70,6 +90,9 @@ namespace libp2p::transport {
 
     void writeSome(BytesIn in, size_t bytes, WriteCallbackFunc cb) override;
 
+    void writeSomeVectored(std::span<const BytesIn> in,
+                           WriteCallbackFunc cb) override;
+
     void deferWriteCallback(std::error_code ec, WriteCallbackFunc cb) override;
 
     outcome::result<multi::Multiaddress> remoteMultiaddr() override;
@@ -91,19 +114,60 @@ namespace libp2p::transport {
       return debug_str_;
     }
 
+    void attributeTraffic(const peer::PeerId &peer) override;
+
+    /// Counts completed socket reads and writes
+    void onTransferred(bool read, size_t bytes);
+
+    /// Totals of raw layer of all connections, see metrics::Traffic
     static uint64_t getBytesRead();
     static uint64_t getBytesWritten();
 
    private:
     outcome::result<void> saveMultiaddresses();
 
-    boost::asio::io_context &context_;
+    /// Tries resolved endpoints one by one, like boost::asio::async_connect,
+    /// but applies options to socket before connect
+    void connectNext(ResolverResultsType endpoints,
+                     ResolverResultsType::const_iterator it,
+                     ConnectCallbackFunc cb);
+
+    /// Large writes are sent with MSG_ZEROCOPY
+    bool useZeroCopy(size_t bytes) const;
+
+    /// Sends buffers with MSG_ZEROCOPY, callback is called when kernel has
+    /// released them
+    void writeZeroCopy(std::vector<boost::asio::const_buffer> buffers,
+                       WriteCallbackFunc cb);
+
+    /// Reads completions of zero-copy sends from socket error queue and
+    /// waits for more while sends are pending
+    void onZeroCopyCompleted();
+
+    /// Sent by writeZeroCopy(), waiting for kernel to release buffers
+    struct ZeroCopyWrite {
+      /// Sequence number of send assigned by kernel
+      uint32_t id;
+      size_t bytes;
+      WriteCallbackFunc cb;
+      bool completed = false;
+    };
+
     ProtoAddrVec layers_;
+    TcpSocketOptions options_;
     Tcp::socket socket_;
     bool initiator_ = false;
     bool connecting_with_timeout_ = false;
     std::atomic_bool connection_phase_done_;
     boost::asio::deadline_timer deadline_timer_;
+    metrics::TrafficMeter meter_;
+
+    /// Zero means zero-copy sends are disabled or not supported by socket
+    size_t zero_copy_threshold_ = 0;
+    /// Sequence number of the next zero-copy send
+    uint32_t zero_copy_next_ = 0;
+    std::deque<ZeroCopyWrite> zero_copy_writes_;
+    bool zero_copy_waiting_ = false;
 
     /// If true then no more callbacks will be issued
     bool closed_by_host_ = false;
@@ -6,7 +6,10 @@
 
 #pragma once
 
+#include <thread>
+
 #include <boost/asio.hpp>
+#include <libp2p/transport/impl/inbound_gate.hpp>
 #include <libp2p/transport/tcp/tcp_connection.hpp>
 #include <libp2p/transport/transport_listener.hpp>
 #include <libp2p/transport/upgrader.hpp>
@@ -19,10 +22,15 @@ namespace libp2p::transport {
   class TcpListener : public TransportListener,
                       public std::enable_shared_from_this<TcpListener> {
    public:
-    ~TcpListener() override = default;
+    /// Stops accept threads
+    ~TcpListener() override;
 
+    /// @param gate limits inbound connections, may be null
+    /// @param options are applied to listening and accepted sockets
     TcpListener(boost::asio::io_context &context,
                 std::shared_ptr<Upgrader> upgrader,
+                std::shared_ptr<InboundGate> gate,
+                TcpSocketOptions options,
                 TransportListener::HandlerFunc handler);
 
     outcome::result<void> listen(const multi::Multiaddress &address) override;
@@ -36,15 +44,39 @@ namespace libp2p::transport {
     outcome::result<void> close() override;
 
    private:
+    /// Extra listening socket, accepting on own thread
+    struct Shard {
+      boost::asio::io_context context;
+      boost::asio::ip::tcp::acceptor acceptor{context};
+      std::thread thread;
+    };
+
     boost::asio::io_context &context_;
     std::shared_ptr<Upgrader> upgrader_;
+    std::shared_ptr<InboundGate> gate_;
+    TcpSocketOptions options_;
     TransportListener::HandlerFunc handle_;
 
     boost::asio::ip::tcp::acceptor acceptor_;
+    std::vector<std::unique_ptr<Shard>> shards_;
 
     ProtoAddrVec layers_;
 
+    /// Opens and binds acceptor, throws
+    void open(boost::asio::ip::tcp::acceptor &acceptor,
+              const boost::asio::ip::tcp::endpoint &endpoint);
+
     void doAccept();
+
+    /// Accepts on shard thread, hands sockets over to `context_`
+    void doAccept(Shard &shard);
+
+    void stopShards();
+
+    void onAccepted(boost::asio::ip::tcp::socket sock);
+
+    void upgrade(std::shared_ptr<TcpConnection> conn,
+                 InboundGate::Permit permit);
   };
 
 }  // namespace libp2p::transport
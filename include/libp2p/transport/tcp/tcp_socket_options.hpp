@@ -0,0 +1,92 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <chrono>
+
+#include <boost/asio/ip/tcp.hpp>
+
+namespace libp2p::transport {
+
+  /**
+   * Options of dialed and accepted TCP sockets. Zero values keep system
+   * defaults. Options unsupported by platform are silently skipped
+   */
+  struct TcpSocketOptions {
+    /// Disables Nagle's algorithm (TCP_NODELAY)
+    bool no_delay = true;
+
+    /// Kernel buffer sizes (SO_SNDBUF, SO_RCVBUF), set before connect and
+    /// on listening socket, so window scale is negotiated for them
+    int send_buffer = 0;
+    int receive_buffer = 0;
+
+    /// Disables delayed acks (TCP_QUICKACK), Linux only. Kernel may switch
+    /// back to delayed acks, so this only affects start of connection
+    bool quick_ack = false;
+
+    /// Unsent bytes kept in kernel before socket stops being writable
+    /// (TCP_NOTSENT_LOWAT). Small value keeps data in muxer queues, where
+    /// streams are prioritized, instead of kernel buffer
+    int not_sent_lowat = 0;
+
+    /// Sends data in SYN of dialed connections (TCP_FASTOPEN_CONNECT)
+    bool fast_open_connect = false;
+
+    /// Queue of pending fast open requests of listener (TCP_FASTOPEN),
+    /// zero disables fast open on listen
+    int fast_open_queue = 0;
+
+    /// Listening sockets bound to the same address with SO_REUSEPORT, so
+    /// that kernel spreads incoming connections over them. First one
+    /// accepts on io_context of listener, each other one on its own thread,
+    /// accepted sockets are handed over to io_context of listener.
+    /// Zero or one keeps a single listening socket. Linux and BSD only.
+    /// @note Other processes of the same user may bind the port too
+    int reuse_port_acceptors = 0;
+
+    /// Time kernel spins on device queue for data, when socket is read and
+    /// nothing was received yet (SO_BUSY_POLL), cuts interrupt latency of
+    /// receive. Linux only, may require CAP_NET_ADMIN
+    std::chrono::microseconds busy_poll{0};
+
+    /// Writes of at least this size are sent with MSG_ZEROCOPY, kernel sends
+    /// pages of the buffer instead of copying them (SO_ZEROCOPY). Such write
+    /// completes when kernel releases the buffer, usually once data is
+    /// acknowledged, so only writes of hundreds of KiB gain from it.
+    /// Linux only, zero disables
+    size_t zero_copy_threshold = 0;
+
+    /// Keepalive probes (SO_KEEPALIVE) and their timing
+    bool keepalive = false;
+    std::chrono::seconds keepalive_idle{0};
+    std::chrono::seconds keepalive_interval{0};
+    int keepalive_count = 0;
+  };
+
+  /// Applies options which must be set before connect to open socket
+  void applyBeforeConnect(boost::asio::ip::tcp::socket &socket,
+                          const TcpSocketOptions &options);
+
+  /// Applies options to connected socket, dialed or accepted
+  void applyConnected(boost::asio::ip::tcp::socket &socket,
+                      const TcpSocketOptions &options);
+
+  /// Returns true if zero-copy sends were enabled on socket by
+  /// applyConnected()
+  bool zeroCopyEnabled(boost::asio::ip::tcp::socket &socket);
+
+  /// Applies options to open acceptor before listen, accepted sockets
+  /// inherit buffer sizes from it
+  void applyBeforeListen(boost::asio::ip::tcp::acceptor &acceptor,
+                         const TcpSocketOptions &options);
+
+  /// Number of listening sockets to open, one if SO_REUSEPORT is disabled
+  /// or unsupported
+  size_t listenSockets(const TcpSocketOptions &options);
+
+}  // namespace libp2p::transport
@@ -8,10 +8,15 @@
 
 #include <boost/asio/ip/tcp.hpp>
 #include <libp2p/muxer/muxed_connection_config.hpp>
+#include <libp2p/network/dns_cache.hpp>
 #include <libp2p/transport/tcp/tcp_listener.hpp>
 #include <libp2p/transport/transport_adaptor.hpp>
 #include <libp2p/transport/upgrader.hpp>
 
+namespace libp2p::network::c_ares {
+  class AresChannel;
+}  // namespace libp2p::network::c_ares
+
 namespace libp2p::transport {
 
   /**
@@ -26,6 +31,27 @@ namespace libp2p::transport {
                  const muxer::MuxedConnectionConfig &mux_config,
                  std::shared_ptr<Upgrader> upgrader);
 
+    /// @param inbound_gate limits inbound connections of listeners
+    TcpTransport(std::shared_ptr<boost::asio::io_context> context,
+                 const muxer::MuxedConnectionConfig &mux_config,
+                 std::shared_ptr<Upgrader> upgrader,
+                 std::shared_ptr<InboundGate> inbound_gate);
+
+    /// @param socket_options are applied to dialed and accepted sockets
+    TcpTransport(std::shared_ptr<boost::asio::io_context> context,
+                 const muxer::MuxedConnectionConfig &mux_config,
+                 std::shared_ptr<Upgrader> upgrader,
+                 std::shared_ptr<InboundGate> inbound_gate,
+                 TcpSocketOptions socket_options);
+
+    /// @param ares resolves dns names instead of system resolver
+    TcpTransport(std::shared_ptr<boost::asio::io_context> context,
+                 const muxer::MuxedConnectionConfig &mux_config,
+                 std::shared_ptr<Upgrader> upgrader,
+                 std::shared_ptr<InboundGate> inbound_gate,
+                 TcpSocketOptions socket_options,
+                 std::shared_ptr<network::c_ares::AresChannel> ares);
+
     void dial(const peer::PeerId &remoteId,
               multi::Multiaddress address,
               TransportAdaptor::HandlerFunc handler) override;
@@ -41,6 +67,12 @@ namespace libp2p::transport {
     std::shared_ptr<boost::asio::io_context> context_;
     muxer::MuxedConnectionConfig mux_config_;
     std::shared_ptr<Upgrader> upgrader_;
+    std::shared_ptr<InboundGate> inbound_gate_;
+    TcpSocketOptions socket_options_;
+    std::shared_ptr<network::c_ares::AresChannel> ares_;
     boost::asio::ip::tcp::resolver resolver_;
+    std::shared_ptr<
+        network::DnsCache<boost::asio::ip::tcp::resolver::results_type>>
+        dns_cache_;
   };
 }  // namespace libp2p::transport
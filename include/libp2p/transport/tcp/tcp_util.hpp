@@ -11,6 +11,7 @@
 #include <charconv>
 #include <libp2p/boost/outcome.hpp>
 #include <libp2p/multi/multiaddress.hpp>
+#include <libp2p/network/dns_cache.hpp>
 #include <variant>
 
 namespace libp2p::transport::detail {
@@ -137,6 +138,10 @@ namespace libp2p::transport::detail {
     if (it->first.code != P::QUIC_V1) {
       return std::errc::protocol_not_supported;
     }
+    // QUIC of WebTransport runs HTTP/3, not libp2p, and no transport dials it
+    if (++it != v.end() and it->first.code == P::WEBTRANSPORT) {
+      return std::errc::protocol_not_supported;
+    }
     return addr;
   }
 
@@ -167,6 +172,79 @@ namespace libp2p::transport::detail {
     }
   }
 
+  template <typename T>
+  using ResolveCache = network::DnsCache<typename T::results_type>;
+
+  /**
+   * Resolves dns name once for concurrent dials, and reuses the result
+   * @param ares c-ares channel, system resolver is used if it is null
+   */
+  template <typename T, typename Ares>
+  void resolve(T &resolver,
+               const std::shared_ptr<Ares> &ares,
+               const std::shared_ptr<ResolveCache<T>> &cache,
+               const TcpOrUdp &addr,
+               auto &&cb) {
+    auto dns = std::get_if<Dns>(&addr.ip);
+    if (dns == nullptr) {
+      return resolve(resolver, addr, std::forward<decltype(cb)>(cb));
+    }
+    using Clock = typename ResolveCache<T>::Clock;
+    auto key = fmt::format("{}/{}/{}",
+                           dns->name,
+                           dns->v4 ? (*dns->v4 ? "4" : "6") : "",
+                           addr.port);
+    if (auto cached = cache->get(key, Clock::now())) {
+      return cb(std::move(*cached));
+    }
+    if (not cache->wait(key, std::forward<decltype(cb)>(cb))) {
+      return;
+    }
+    auto resolved = [weak_cache{std::weak_ptr{cache}}, key](
+                        outcome::result<typename T::results_type> r,
+                        std::optional<typename Clock::duration> ttl) {
+      auto cache = weak_cache.lock();
+      if (not cache) {
+        return;
+      }
+      // failed lookups are not cached
+      auto waiters = cache->resolved(
+          key,
+          r,
+          Clock::now(),
+          r.has_value() ? ttl : std::make_optional(Clock::duration::zero()));
+      for (auto &waiter : waiters) {
+        waiter(r);
+      }
+    };
+    if (ares) {
+      return ares->resolveAddresses(
+          dns->name,
+          dns->v4,
+          [resolved, name{dns->name}, port{addr.port}](auto r) {
+            if (not r) {
+              return resolved(r.error(), std::nullopt);
+            }
+            std::vector<typename T::endpoint_type> endpoints;
+            for (auto &ip : r.value().addresses) {
+              endpoints.emplace_back(ip, port);
+            }
+            resolved(T::results_type::create(endpoints.begin(),
+                                             endpoints.end(),
+                                             name,
+                                             std::to_string(port)),
+                     r.value().ttl);
+          });
+    }
+    // system resolver does not report TTL, so results are cached for the
+    // default time
+    resolve(resolver,
+            addr,
+            [resolved](outcome::result<typename T::results_type> r) {
+              resolved(std::move(r), std::nullopt);
+            });
+  }
+
   template <typename T>
   outcome::result<std::string> toMultiaddr(const T &endpoint) {
     constexpr auto tcp = std::is_same_v<T, boost::asio::ip::tcp::endpoint>;
@@ -0,0 +1,280 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/basic/buffer_pool.hpp>
+
+#include <cassert>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace libp2p::basic {
+  namespace {
+    std::mutex default_memory_mutex;
+    BufferPool::MemoryConfig default_memory;
+
+    /// NUMA node of CPU the calling thread runs on
+    size_t currentNode() {
+#ifdef SYS_getcpu
+      unsigned cpu = 0;
+      unsigned node = 0;
+      if (syscall(SYS_getcpu, &cpu, &node, nullptr) == 0) {
+        return node;
+      }
+#endif
+      return 0;
+    }
+
+    /// Maps anonymous memory, of reserved huge pages if possible
+    void *mapHugePages(size_t size) {
+#ifdef __linux__
+      auto *memory = mmap(nullptr,
+                          size,
+                          PROT_READ | PROT_WRITE,
+                          MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB,
+                          -1,
+                          0);
+      if (memory != MAP_FAILED) {
+        return memory;
+      }
+      memory = mmap(nullptr,
+                    size,
+                    PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE | MAP_ANONYMOUS,
+                    -1,
+                    0);
+      if (memory == MAP_FAILED) {
+        return nullptr;
+      }
+      // transparent huge pages
+      madvise(memory, size, MADV_HUGEPAGE);
+      return memory;
+#else
+      return nullptr;
+#endif
+    }
+
+    void unmapHugePages(void *memory, size_t size) {
+#ifdef __linux__
+      munmap(memory, size);
+#endif
+    }
+  }  // namespace
+
+  struct BufferSlice::Chunk {
+    /// Chunk of heap memory
+    explicit Chunk(size_t size, size_t node)
+        : memory(new uint8_t[size]), owned(memory), node(node) {}
+
+    /// Chunk of slab memory, not owned
+    Chunk(uint8_t *memory, size_t node) : memory(memory), node(node) {}
+
+    std::atomic<size_t> refs = 0;
+
+    /// Set while the chunk is in use, keeps the pool alive
+    std::shared_ptr<BufferPool> pool;
+
+    uint8_t *memory;
+    std::unique_ptr<uint8_t[]> owned;
+
+    /// NUMA node, free chunk is returned to
+    size_t node;
+  };
+
+  BufferSlice::BufferSlice(Chunk *chunk, uint8_t *data, size_t size)
+      : chunk_(chunk), data_(data), size_(size) {
+    assert(chunk_);
+    chunk_->refs.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  BufferSlice::BufferSlice(const BufferSlice &other)
+      : chunk_(other.chunk_), data_(other.data_), size_(other.size_) {
+    if (chunk_) {
+      chunk_->refs.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  BufferSlice::BufferSlice(BufferSlice &&other) noexcept
+      : chunk_(other.chunk_), data_(other.data_), size_(other.size_) {
+    other.chunk_ = nullptr;
+    other.data_ = nullptr;
+    other.size_ = 0;
+  }
+
+  BufferSlice &BufferSlice::operator=(const BufferSlice &other) {
+    if (this != &other) {
+      *this = BufferSlice(other);
+    }
+    return *this;
+  }
+
+  BufferSlice &BufferSlice::operator=(BufferSlice &&other) noexcept {
+    if (this != &other) {
+      reset();
+      std::swap(chunk_, other.chunk_);
+      std::swap(data_, other.data_);
+      std::swap(size_, other.size_);
+    }
+    return *this;
+  }
+
+  BufferSlice::~BufferSlice() {
+    reset();
+  }
+
+  BufferSlice BufferSlice::subslice(size_t offset, size_t size) const {
+    assert(offset + size <= size_);
+    if (!chunk_) {
+      return {};
+    }
+    return {chunk_, data_ + offset, size};  // NOLINT
+  }
+
+  size_t BufferSlice::useCount() const {
+    return chunk_ ? chunk_->refs.load(std::memory_order_relaxed) : 0;
+  }
+
+  void BufferSlice::reset() {
+    auto *chunk = chunk_;
+    chunk_ = nullptr;
+    data_ = nullptr;
+    size_ = 0;
+    if (chunk && chunk->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      auto pool = std::move(chunk->pool);
+      pool->release(chunk);
+    }
+  }
+
+  BufferPool::BufferPool(size_t chunk_size,
+                         size_t max_free_chunks,
+                         MemoryConfig memory)
+      : chunk_size_(chunk_size),
+        max_free_chunks_(max_free_chunks),
+        memory_(memory) {
+    assert(chunk_size_ > 0);
+  }
+
+  BufferPool::~BufferPool() {
+    assert(chunks_in_use_ == 0);
+    for (auto &chunks : free_chunks_) {
+      for (auto *chunk : chunks) {
+        delete chunk;  // NOLINT
+      }
+    }
+    for (auto &slab : slabs_) {
+      unmapHugePages(slab.memory, slab.size);
+    }
+  }
+
+  std::shared_ptr<BufferPool> BufferPool::create(size_t chunk_size,
+                                                 size_t max_free_chunks) {
+    MemoryConfig memory;
+    {
+      std::lock_guard lock{default_memory_mutex};
+      memory = default_memory;
+    }
+    return create(chunk_size, max_free_chunks, memory);
+  }
+
+  std::shared_ptr<BufferPool> BufferPool::create(size_t chunk_size,
+                                                 size_t max_free_chunks,
+                                                 MemoryConfig memory) {
+    return std::shared_ptr<BufferPool>(
+        new BufferPool(chunk_size, max_free_chunks, memory));
+  }
+
+  void BufferPool::setDefaultMemoryConfig(MemoryConfig memory) {
+    std::lock_guard lock{default_memory_mutex};
+    default_memory = memory;
+  }
+
+  const std::shared_ptr<BufferPool> &BufferPool::defaultPool() {
+    static auto pool = create();
+    return pool;
+  }
+
+  BufferSlice BufferPool::allocate(size_t size) {
+    assert(size <= chunk_size_);
+    BufferSlice::Chunk *chunk = nullptr;
+    auto node = memory_.numa_local ? currentNode() : 0;
+    {
+      std::lock_guard lock(mutex_);
+      auto &free = freeChunks(node);
+      if (free.empty() and memory_.huge_pages and not no_huge_pages_) {
+        no_huge_pages_ = not allocateSlab(node);
+      }
+      if (!free.empty()) {
+        chunk = free.back();
+        free.pop_back();
+      }
+      ++chunks_in_use_;
+    }
+    if (!chunk) {
+      chunk = new BufferSlice::Chunk(chunk_size_, node);  // NOLINT
+    }
+    chunk->pool = shared_from_this();
+    return {chunk, chunk->memory, std::min(size, chunk_size_)};
+  }
+
+  size_t BufferPool::freeChunks() const {
+    std::lock_guard lock(mutex_);
+    size_t count = 0;
+    for (auto &chunks : free_chunks_) {
+      count += chunks.size();
+    }
+    return count;
+  }
+
+  size_t BufferPool::chunksInUse() const {
+    std::lock_guard lock(mutex_);
+    return chunks_in_use_;
+  }
+
+  void BufferPool::release(BufferSlice::Chunk *chunk) {
+    {
+      std::lock_guard lock(mutex_);
+      assert(chunks_in_use_ > 0);
+      --chunks_in_use_;
+      auto &free = freeChunks(chunk->node);
+      // slab memory is not freed by chunks
+      if (not chunk->owned or free.size() < max_free_chunks_) {
+        free.push_back(chunk);
+        return;
+      }
+    }
+    delete chunk;  // NOLINT
+  }
+
+  std::vector<BufferSlice::Chunk *> &BufferPool::freeChunks(size_t node) {
+    if (node >= free_chunks_.size()) {
+      free_chunks_.resize(node + 1);
+    }
+    return free_chunks_[node];
+  }
+
+  bool BufferPool::allocateSlab(size_t node) {
+    auto chunks = std::max<size_t>(kHugePageSize / chunk_size_, 1);
+    auto size = (chunks * chunk_size_ + kHugePageSize - 1) / kHugePageSize
+              * kHugePageSize;
+    auto *memory = static_cast<uint8_t *>(mapHugePages(size));
+    if (memory == nullptr) {
+      return false;
+    }
+    slabs_.push_back({memory, size});
+    auto &free = freeChunks(node);
+    // chunks are taken from the back, in order of addresses
+    for (auto i = chunks; i > 0; --i) {
+      free.push_back(
+          new BufferSlice::Chunk(memory + (i - 1) * chunk_size_,  // NOLINT
+                                 node));
+    }
+    return true;
+  }
+
+}  // namespace libp2p::basic
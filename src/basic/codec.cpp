@@ -0,0 +1,98 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/basic/codec.hpp>
+
+#include <algorithm>
+
+#include <zlib.h>
+
+OUTCOME_CPP_DEFINE_CATEGORY(libp2p::basic, CodecError, e) {
+  using E = libp2p::basic::CodecError;
+  switch (e) {
+    case E::COMPRESS_FAILED:
+      return "compression failed";
+    case E::DECOMPRESS_FAILED:
+      return "decompression failed, input is corrupted";
+    case E::DECOMPRESSED_TOO_LARGE:
+      return "decompressed data exceeds the limit";
+  }
+  return "unknown error";
+}
+
+namespace libp2p::basic {
+  namespace {
+    /// Output grows by this step, up to the limit
+    constexpr size_t kInflateStep = 16 * 1024;
+
+    class DeflateCodec : public Codec {
+     public:
+      explicit DeflateCodec(int level) : level_{level} {}
+
+      outcome::result<Bytes> compress(BytesIn input) const override {
+        z_stream z{};
+        if (deflateInit(&z, level_) != Z_OK) {
+          return CodecError::COMPRESS_FAILED;
+        }
+        Bytes output(deflateBound(&z, input.size()));
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+        z.next_in = const_cast<Bytef *>(input.data());
+        z.avail_in = input.size();
+        z.next_out = output.data();
+        z.avail_out = output.size();
+        auto r = deflate(&z, Z_FINISH);
+        output.resize(z.total_out);
+        deflateEnd(&z);
+        if (r != Z_STREAM_END) {
+          return CodecError::COMPRESS_FAILED;
+        }
+        return output;
+      }
+
+      outcome::result<Bytes> decompress(BytesIn input,
+                                        size_t limit) const override {
+        z_stream z{};
+        if (inflateInit(&z) != Z_OK) {
+          return CodecError::DECOMPRESS_FAILED;
+        }
+        Bytes output;
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+        z.next_in = const_cast<Bytef *>(input.data());
+        z.avail_in = input.size();
+        auto r = Z_OK;
+        while (r == Z_OK) {
+          if (output.size() == z.total_out) {
+            if (output.size() > limit) {
+              break;
+            }
+            // one byte over limit tells too large output from exact one
+            output.resize(std::min(output.size() + kInflateStep, limit + 1));
+          }
+          z.next_out = output.data() + z.total_out;
+          z.avail_out = output.size() - z.total_out;
+          r = inflate(&z, Z_NO_FLUSH);
+        }
+        auto size = z.total_out;
+        inflateEnd(&z);
+        if (size > limit) {
+          return CodecError::DECOMPRESSED_TOO_LARGE;
+        }
+        if (r != Z_STREAM_END) {
+          return CodecError::DECOMPRESS_FAILED;
+        }
+        output.resize(size);
+        return output;
+      }
+
+     private:
+      int level_;
+    };
+  }  // namespace
+
+  std::shared_ptr<Codec> deflateCodec(int level) {
+    return std::make_shared<DeflateCodec>(level);
+  }
+}  // namespace libp2p::basic
@@ -0,0 +1,34 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/basic/cpu_affinity.hpp>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace libp2p::basic {
+
+  outcome::result<void> pinCurrentThread(size_t cpu) {
+#ifdef __linux__
+    if (cpu >= CPU_SETSIZE) {
+      return std::errc::invalid_argument;
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    if (auto r = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+        r != 0) {
+      return std::error_code{r, std::system_category()};
+    }
+    return outcome::success();
+#else
+    return std::errc::not_supported;
+#endif
+  }
+
+}  // namespace libp2p::basic
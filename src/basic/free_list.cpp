@@ -0,0 +1,50 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/basic/free_list.hpp>
+
+namespace libp2p::basic {
+
+  FreeList::FreeList(size_t max_free) : max_free_{max_free} {}
+
+  FreeList::~FreeList() {
+    for (auto *block : free_) {
+      ::operator delete(block);
+    }
+  }
+
+  void *FreeList::allocate(size_t size) {
+    {
+      std::lock_guard lock{mutex_};
+      if (block_size_ == 0) {
+        block_size_ = size;
+      }
+      if (size == block_size_ and not free_.empty()) {
+        auto *block = free_.back();
+        free_.pop_back();
+        return block;
+      }
+    }
+    return ::operator new(size);
+  }
+
+  void FreeList::deallocate(void *block, size_t size) {
+    {
+      std::lock_guard lock{mutex_};
+      if (size == block_size_ and free_.size() < max_free_) {
+        free_.push_back(block);
+        return;
+      }
+    }
+    ::operator delete(block);
+  }
+
+  size_t FreeList::freeBlocks() const {
+    std::lock_guard lock{mutex_};
+    return free_.size();
+  }
+
+}  // namespace libp2p::basic
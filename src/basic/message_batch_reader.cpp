@@ -0,0 +1,105 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/basic/message_batch_reader.hpp>
+
+#include <algorithm>
+
+#include <boost/assert.hpp>
+
+#include <libp2p/basic/message_read_writer_error.hpp>
+#include <libp2p/basic/varint_prefix_reader.hpp>
+
+namespace libp2p::basic {
+
+  MessageBatchReader::MessageBatchReader(std::shared_ptr<Reader> reader,
+                                         size_t max_message_size)
+      : reader_{std::move(reader)}, max_message_size_{max_message_size} {
+    BOOST_ASSERT(reader_ != nullptr);
+  }
+
+  void MessageBatchReader::readMany(ReadCallbackFunc cb) {
+    // views of previous batch are released, rest of partial message moves to
+    // the beginning
+    if (consumed_ != 0) {
+      std::copy(buffer_.begin() + consumed_,
+                buffer_.begin() + size_,
+                buffer_.begin());
+      size_ -= consumed_;
+      consumed_ = 0;
+    }
+    messages_.clear();
+    if (size_ == 0 and buffer_.size() > kMaxReusedBuffer) {
+      Bytes{}.swap(buffer_);
+    }
+    // complete messages were delivered by previous callback
+    auto needed = decode();
+    if (not needed) {
+      return reader_->deferReadCallback(
+          needed.error(),
+          [cb{std::move(cb)}](outcome::result<size_t> r) { cb(r.error()); });
+    }
+    readSome(needed.value(), std::move(cb));
+  }
+
+  void MessageBatchReader::readSome(size_t needed, ReadCallbackFunc cb) {
+    needed = std::max(needed, kMinReadSize);
+    if (buffer_.size() < size_ + needed) {
+      buffer_.resize(size_ + needed);
+    }
+    auto out = BytesOut{buffer_}.subspan(size_);
+    reader_->readSome(
+        out,
+        out.size(),
+        [weak_self{weak_from_this()},
+         cb{std::move(cb)}](outcome::result<size_t> r) mutable {
+          auto self = weak_self.lock();
+          if (not self) {
+            return;
+          }
+          if (not r) {
+            return cb(r.error());
+          }
+          self->size_ += r.value();
+          auto needed = self->decode();
+          if (not needed) {
+            return cb(needed.error());
+          }
+          if (self->messages_.empty()) {
+            return self->readSome(needed.value(), std::move(cb));
+          }
+          cb(Messages{self->messages_});
+        });
+  }
+
+  outcome::result<size_t> MessageBatchReader::decode() {
+    BytesIn rest = BytesIn{buffer_}.first(size_).subspan(consumed_);
+    while (not rest.empty()) {
+      VarintPrefixReader varint;
+      auto data = rest;
+      switch (varint.consume(data)) {
+        case VarintPrefixReader::kUnderflow:
+          return 1;
+        case VarintPrefixReader::kReady:
+          break;
+        default:
+          return MessageReadWriterError::VARINT_EXPECTED;
+      }
+      if (varint.value() > max_message_size_) {
+        return MessageReadWriterError::MESSAGE_TOO_LONG;
+      }
+      auto length = static_cast<size_t>(varint.value());
+      if (data.size() < length) {
+        return length - data.size();
+      }
+      messages_.emplace_back(data.first(length));
+      consumed_ += varint.size() + length;
+      rest = data.subspan(length);
+    }
+    return 0;
+  }
+
+}  // namespace libp2p::basic
@@ -17,6 +17,8 @@ OUTCOME_CPP_DEFINE_CATEGORY(libp2p::basic, MessageReadWriterError, e) {
       return "varint expected at the beginning of Protobuf message";
     case E::INTERNAL_ERROR:
       return "internal error happened";
+    case E::MESSAGE_TOO_LONG:
+      return "message length exceeds the limit";
   }
   return "unknown error";
 }
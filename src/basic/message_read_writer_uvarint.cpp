@@ -14,6 +14,7 @@
 #include <libp2p/basic/varint_reader.hpp>
 #include <libp2p/basic/write_return_size.hpp>
 #include <libp2p/multi/uvarint.hpp>
+#include <qtils/append.hpp>
 
 namespace libp2p::basic {
   MessageReadWriterUvarint::MessageReadWriterUvarint(
@@ -33,7 +34,7 @@ namespace libp2p::basic {
 
           auto msg_len = varint_res.value().toUInt64();
           if (0 != msg_len) {
-            auto buffer = std::make_shared<std::vector<uint8_t>>(msg_len, 0);
+            auto buffer = self->takeBuffer(msg_len);
             self->conn_->read(
                 *buffer,
                 msg_len,
@@ -49,15 +50,25 @@ namespace libp2p::basic {
         });
   }
 
+  std::shared_ptr<std::vector<uint8_t>> MessageReadWriterUvarint::takeBuffer(
+      size_t size) {
+    if (size > kMaxReusedBuffer) {
+      return std::make_shared<std::vector<uint8_t>>(size, 0);
+    }
+    if (buffer_ == nullptr or buffer_.use_count() != 1) {
+      buffer_ = std::make_shared<std::vector<uint8_t>>();
+    }
+    buffer_->resize(size);
+    return buffer_;
+  }
+
   void MessageReadWriterUvarint::write(BytesIn buffer,
                                        Writer::WriteCallbackFunc cb) {
     auto varint_len = multi::UVarint{static_cast<uint64_t>(buffer.size())};
 
     auto msg_bytes = std::make_shared<std::vector<uint8_t>>();
     msg_bytes->reserve(varint_len.size() + buffer.size());
-    msg_bytes->insert(msg_bytes->end(),
-                      std::make_move_iterator(varint_len.toVector().begin()),
-                      std::make_move_iterator(varint_len.toVector().end()));
+    qtils::append(*msg_bytes, varint_len.toBytes());
     msg_bytes->insert(msg_bytes->end(), buffer.begin(), buffer.end());
 
     writeReturnSize(conn_,
@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+#include <algorithm>
 #include <cassert>
 #include <cstring>
 
@@ -11,186 +12,119 @@
 
 namespace libp2p::basic {
 
-  ReadBuffer::ReadBuffer(size_t alloc_granularity)
-      : alloc_granularity_(alloc_granularity),
-        total_size_(0),
-        first_byte_offset_(0),
-        capacity_remains_(0) {
-    assert(alloc_granularity > 0);
+  ReadBuffer::ReadBuffer(std::shared_ptr<BufferPool> pool)
+      : pool_(std::move(pool)) {
+    assert(pool_);
   }
 
-  void ReadBuffer::add(BytesIn bytes) {
-    size_t sz = bytes.size();
-    if (sz == 0) {
-      return;
-    }
-
-    if (capacity_remains_ >= sz) {
-      assert(!fragments_.empty());
-
-      auto &vec = fragments_.back();
-      vec.insert(vec.end(), bytes.begin(), bytes.end());
-
-      capacity_remains_ -= sz;
-    } else if (capacity_remains_ > 0) {
-      auto &vec = fragments_.back();
-
-      size_t new_capacity = vec.size() + sz + alloc_granularity_;
-      vec.reserve(new_capacity);
-      vec.insert(vec.end(), bytes.begin(), bytes.end());
-
-      capacity_remains_ = alloc_granularity_;
-    } else {
-      fragments_.emplace_back();
-      auto &vec = fragments_.back();
-
-      size_t new_capacity = sz + alloc_granularity_;
-
-      vec.reserve(new_capacity);
-      vec.insert(vec.end(), bytes.begin(), bytes.end());
+  const std::shared_ptr<BufferPool> &ReadBuffer::defaultPool() {
+    static auto pool = BufferPool::create(kDefaultChunkSize);
+    return pool;
+  }
 
-      capacity_remains_ = alloc_granularity_;
+  void ReadBuffer::add(BytesIn bytes) {
+    total_size_ += bytes.size();
+    while (not bytes.empty()) {
+      if (first_chunk_ == chunks_.size()
+          or last_chunk_size_ == chunks_.back().size()) {
+        chunks_.emplace_back(pool_->allocate());
+        last_chunk_size_ = 0;
+      }
+      auto &chunk = chunks_.back();
+      auto n = std::min(bytes.size(), chunk.size() - last_chunk_size_);
+      memcpy(chunk.data() + last_chunk_size_, bytes.data(), n);  // NOLINT
+      last_chunk_size_ += n;
+      bytes = bytes.subspan(n);
     }
-
-    total_size_ += sz;
   }
 
   size_t ReadBuffer::consume(BytesOut out) {
-    if (empty()) {
-      return 0;
-    }
-
-    size_t n_bytes = out.size();
-    if (n_bytes >= total_size_) {
-      return consumeAll(out);
-    }
-
-    auto remains = n_bytes;
+    auto n_bytes = std::min(out.size(), total_size_);
     auto *p = out.data();
-
+    auto remains = n_bytes;
     while (remains > 0) {
-      auto consumed = consumePart(p, remains);
-
-      assert(consumed <= remains);
-
-      remains -= consumed;
-      p += consumed;  // NOLINT
+      auto part = peek();
+      auto n = std::min(remains, part.size());
+      memcpy(p, part.data(), n);
+      skip(n);
+      remains -= n;
+      p += n;  // NOLINT
     }
-
-    total_size_ -= n_bytes;
     return n_bytes;
   }
 
   size_t ReadBuffer::addAndConsume(BytesIn in, BytesOut out) {
-    if (in.empty()) {
-      return consume(out);
-    }
+    auto consumed = consume(out);
+    out = out.subspan(consumed);
+    // out remains only if buffer is drained, so new data goes directly to it
+    auto n = std::min(in.size(), out.size());
+    if (n != 0) {
+      memcpy(out.data(), in.data(), n);
+    }
+    add(in.subspan(n));
+    return consumed + n;
+  }
 
-    if (out.empty()) {
-      add(in);
-      return 0;
+  BytesIn ReadBuffer::peek() const {
+    if (first_chunk_ == chunks_.size()) {
+      return {};
     }
+    auto *front = chunks_[first_chunk_].data() + first_byte_offset_;  // NOLINT
+    return BytesIn{front, frontSize()};
+  }
 
-    if (empty()) {
-      if (in.size() <= out.size()) {
-        memcpy(out.data(), in.data(), in.size());
-        return in.size();
+  void ReadBuffer::skip(size_t n) {
+    assert(n <= total_size_);
+    total_size_ -= n;
+    while (n > 0) {
+      auto part = std::min(n, frontSize());
+      first_byte_offset_ += part;
+      n -= part;
+      if (frontSize() == 0) {
+        chunks_[first_chunk_].reset();
+        ++first_chunk_;
+        first_byte_offset_ = 0;
       }
-      memcpy(out.data(), in.data(), out.size());
-      in = in.subspan(out.size());
-      add(in);
-      return out.size();
     }
-
-    auto out_size = static_cast<size_t>(out.size());
-    size_t consumed = 0;
-
-    if (out_size <= total_size_) {
-      consumed = consume(out);
-      add(in);
-      return consumed;
+    if (total_size_ == 0) {
+      // release partially filled chunk too
+      chunks_.clear();
+      first_chunk_ = 0;
+      first_byte_offset_ = 0;
+      last_chunk_size_ = 0;
+    } else if (first_chunk_ * 2 > chunks_.size()) {
+      chunks_.erase(chunks_.begin(),
+                    chunks_.begin() + static_cast<ptrdiff_t>(first_chunk_));
+      first_chunk_ = 0;
     }
+  }
 
-    consumed = consumeAll(out);
-    auto out_remains = out.subspan(consumed);
-    return consumed + addAndConsume(in, out_remains);
+  BufferSlice ReadBuffer::take(size_t n) {
+    n = std::min(n, frontSize());
+    if (n == 0) {
+      return {};
+    }
+    auto slice = chunks_[first_chunk_].subslice(first_byte_offset_, n);
+    skip(n);
+    return slice;
   }
 
   void ReadBuffer::clear() {
     total_size_ = 0;
     first_byte_offset_ = 0;
-    capacity_remains_ = 0;
-    std::deque<Fragment>{}.swap(fragments_);
+    last_chunk_size_ = 0;
+    first_chunk_ = 0;
+    std::vector<BufferSlice>{}.swap(chunks_);
   }
 
-  size_t ReadBuffer::consumeAll(BytesOut out) {
-    assert(!fragments_.empty());
-    auto *p = out.data();
-    auto n = fragments_.front().size() - first_byte_offset_;
-    assert(n <= fragments_.front().size());
-
-    memcpy(p, fragments_.front().data() + first_byte_offset_, n);  // NOLINT
-
-    auto it = ++fragments_.begin();
-    while (it != fragments_.end()) {
-      p += n;  // NOLINT
-      n = it->size();
-      memcpy(p, it->data(), n);
-      ++it;
-    }
-
-    auto ret = total_size_;
-
-    total_size_ = 0;
-    first_byte_offset_ = 0;
-    capacity_remains_ = 0;
-
-    // Find one fragment if not too large to avoid further allocations
-    bool keep_one_fragment = false;
-    bool is_first = true;
-    for (auto &f : fragments_) {
-      if (f.capacity() <= alloc_granularity_ * 2) {
-        f.clear();
-        capacity_remains_ = f.capacity();
-        if (!is_first) {
-          fragments_.front() = std::move(f);
-        }
-        keep_one_fragment = true;
-        break;
-      }
-      if (is_first) {
-        is_first = false;
-      }
-    }
-    fragments_.resize(keep_one_fragment ? 1 : 0);
-
-    return ret;
-  }
-
-  size_t ReadBuffer::consumePart(uint8_t *out, size_t n) {
-    if (fragments_.empty()) {
+  size_t ReadBuffer::frontSize() const {
+    if (first_chunk_ == chunks_.size()) {
       return 0;
     }
-
-    auto &f = fragments_.front();
-
-    assert(f.size() > first_byte_offset_);
-
-    auto fragment_size = f.size() - first_byte_offset_;
-    if (n > fragment_size) {
-      n = fragment_size;
-    }
-
-    memcpy(out, f.data() + first_byte_offset_, n);  // NOLINT
-
-    if (n < fragment_size) {
-      first_byte_offset_ += n;
-    } else {
-      first_byte_offset_ = 0;
-      fragments_.pop_front();
-    }
-
-    return n;
+    auto end = first_chunk_ + 1 == chunks_.size()
+                 ? last_chunk_size_
+                 : chunks_[first_chunk_].size();
+    return end - first_byte_offset_;
   }
 
   FixedBufferCollector::FixedBufferCollector(size_t expected_size,
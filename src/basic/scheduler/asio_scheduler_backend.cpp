@@ -16,7 +16,7 @@ namespace libp2p::basic {
       std::shared_ptr<boost::asio::io_context> io_context)
       : io_context_(std::move(io_context)), timer_(*io_context_) {}
 
-  void AsioSchedulerBackend::post(std::function<void()> &&cb) {
+  void AsioSchedulerBackend::post(Callback &&cb) {
     boost::asio::post(*io_context_, std::move(cb));
   }
 
@@ -44,4 +44,28 @@ namespace libp2p::basic {
         decltype(timer_)::clock_type::now().time_since_epoch());
   }
 
+  size_t runBusyPolling(boost::asio::io_context &io_context,
+                        BusyPollConfig config) {
+    using Clock = std::chrono::steady_clock;
+    size_t handlers = 0;
+    auto last_handler = Clock::now();
+    while (not io_context.stopped()) {
+      if (auto n = io_context.poll(); n != 0) {
+        handlers += n;
+        last_handler = Clock::now();
+        continue;
+      }
+      if (io_context.stopped()) {
+        break;
+      }
+      if (Clock::now() - last_handler < config.budget) {
+        continue;
+      }
+      // nothing ready within budget, sleep till the next handler
+      handlers += io_context.run_one();
+      last_handler = Clock::now();
+    }
+    return handlers;
+  }
+
 }  // namespace libp2p::basic
@@ -7,8 +7,8 @@
 #include <libp2p/basic/scheduler/manual_scheduler_backend.hpp>
 
 namespace libp2p::basic {
-  void ManualSchedulerBackend::post(std::function<void()> &&cb) {
-    deferred_callbacks_.emplace_back(cb);
+  void ManualSchedulerBackend::post(Callback &&cb) {
+    deferred_callbacks_.emplace_back(std::move(cb));
   }
 
   void ManualSchedulerBackend::setTimer(
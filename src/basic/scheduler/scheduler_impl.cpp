@@ -6,11 +6,25 @@
 
 #include <libp2p/basic/scheduler/scheduler_impl.hpp>
 
+#include <libp2p/common/metrics/registry.hpp>
+
 namespace libp2p::basic {
+  namespace {
+    /// Delay between due time of timers and their calls
+    metrics::Histogram &lagHistogram() {
+      static auto &histogram = metrics::Registry::instance().histogram(
+          "libp2p_scheduler_lag_seconds",
+          "Delay between due time of timers and their calls");
+      return histogram;
+    }
+  }  // namespace
 
   SchedulerImpl::SchedulerImpl(std::shared_ptr<SchedulerBackend> backend,
                                Scheduler::Config config)
-      : backend_{std::move(backend)}, config_{config} {}
+      : backend_{std::move(backend)},
+        config_{config},
+        watchdog_{config.stall_threshold},
+        deferred_{config} {}
 
   std::chrono::milliseconds SchedulerImpl::now() const {
     return backend_->now();
@@ -19,7 +33,9 @@ namespace libp2p::basic {
   Scheduler::Handle SchedulerImpl::scheduleImpl(
       Callback &&cb,
       std::chrono::milliseconds delay_from_now,
-      bool make_handle) {
+      bool make_handle,
+      Priority priority,
+      const Origin &origin) {
     if (not cb) {
       throw std::logic_error{"SchedulerImpl::scheduleImpl empty cb arg"};
     }
@@ -29,31 +45,47 @@ namespace libp2p::basic {
       abs = backend_->now() + delay_from_now;
     }
     if (not make_handle) {
-      backend_->post(
-          [weak_self{weak_from_this()}, cb{std::move(cb)}, abs]() mutable {
-            auto self = weak_self.lock();
-            if (not self) {
-              return;
-            }
-            self->callbacks_.emplace(abs, std::move(cb));
-            self->pulse();
-          });
+      backend_->post([weak_self{weak_from_this()},
+                      cb{std::move(cb)},
+                      abs,
+                      priority,
+                      origin]() mutable {
+        auto self = weak_self.lock();
+        if (not self) {
+          return;
+        }
+        Pending pending{std::move(cb), origin, priority};
+        if (abs == Time::zero()) {
+          self->defer(std::move(pending));
+          return;
+        }
+        self->callbacks_.emplace(abs, std::move(pending));
+        self->pulse();
+      });
       return Cancel{};
     }
     auto cancel = std::make_shared<CancelCb>(std::move(cb));
     std::weak_ptr weak_cancel{cancel};
-    backend_->post(
-        [weak_self{weak_from_this()}, abs, cancel{std::move(cancel)}] {
-          auto self = weak_self.lock();
-          if (not self) {
-            return;
-          }
-          if (cancel->cancelled.test()) {
-            return;
-          }
-          cancel->it = self->callbacks_.emplace(abs, cancel);
-          self->pulse();
-        });
+    backend_->post([weak_self{weak_from_this()},
+                    abs,
+                    cancel{std::move(cancel)},
+                    priority,
+                    origin] {
+      auto self = weak_self.lock();
+      if (not self) {
+        return;
+      }
+      if (cancel->cancelled.test()) {
+        return;
+      }
+      Pending pending{cancel, origin, priority};
+      if (abs == Time::zero()) {
+        self->defer(std::move(pending));
+        return;
+      }
+      cancel->it = self->callbacks_.emplace(abs, std::move(pending));
+      self->pulse();
+    });
     return cancelFn(
         [weak_self{weak_from_this()}, weak_cancel{std::move(weak_cancel)}] {
           auto cancel = weak_cancel.lock();
@@ -84,38 +116,105 @@ namespace libp2p::basic {
         });
   }
 
+  void SchedulerImpl::armImpl(Timer &timer,
+                              Callback &&cb,
+                              std::chrono::milliseconds delay_from_now,
+                              const Origin &origin) {
+    if (not cb) {
+      throw std::logic_error{"SchedulerImpl::arm empty cb arg"};
+    }
+    auto now = backend_->now();
+    auto due = now + std::max(delay_from_now, Time{1});
+    timers_.insert(timer, due, std::move(cb), origin);
+    setTimer(now, due);
+  }
+
   void SchedulerImpl::pulse() {
-    callReady(Time::zero());
-    while (not callbacks_.empty()) {
+    while (not callbacks_.empty() or not timers_.empty()) {
       auto now = backend_->now();
-      if (callReady(now) != 0) {
+      if (callReady(now) + fireTimers(now) != 0) {
         continue;
       }
-      auto min = callbacks_.begin()->first;
-      if (now < timer_ and timer_ <= min + config_.max_timer_threshold) {
-        return;
+      auto min = Time::max();
+      if (not callbacks_.empty()) {
+        min = callbacks_.begin()->first;
+      }
+      if (not timers_.empty()) {
+        min = std::min(min, timers_.nextDue());
       }
-      timer_ = std::max(now + config_.max_timer_threshold, min);
-      backend_->setTimer(timer_, weak_from_this());
+      setTimer(now, min);
       return;
     }
   }
 
+  void SchedulerImpl::setTimer(Time now, Time min) {
+    if (now < timer_ and timer_ <= min + config_.max_timer_threshold) {
+      return;
+    }
+    timer_ = std::max(now + config_.max_timer_threshold, min);
+    backend_->setTimer(timer_, weak_from_this());
+  }
+
+  size_t SchedulerImpl::fireTimers(Time now) {
+    return timers_.fire(
+        now, [&](Time lag, Callback &cb, const Origin &origin) {
+          lagHistogram().observe(lag);
+          watchdog_.run(cb, origin);
+        });
+  }
+
   size_t SchedulerImpl::callReady(Time now) {
     size_t removed = 0;
     while (not callbacks_.empty() and callbacks_.begin()->first <= now) {
       auto node = callbacks_.extract(callbacks_.begin());
       ++removed;
-      if (auto cb = std::get_if<Callback>(&node.mapped())) {
-        (*cb)();
-      } else {
-        auto &cancel = std::get<std::shared_ptr<CancelCb>>(node.mapped());
-        if (cancel->cancelled.test_and_set()) {
-          continue;
+      lagHistogram().observe(now - node.key());
+      auto &pending = node.mapped();
+      if (pending.priority == Priority::BACKGROUND) {
+        if (auto cancel = std::get_if<CancelCbPtr>(&pending.cb)) {
+          (*cancel)->it.reset();
         }
-        cancel->cb();
+        defer(std::move(pending));
+        continue;
       }
+      call(pending);
     }
     return removed;
   }
+
+  void SchedulerImpl::call(Pending &pending) {
+    if (auto cb = std::get_if<Callback>(&pending.cb)) {
+      watchdog_.run(*cb, pending.origin);
+      return;
+    }
+    auto &cancel = std::get<CancelCbPtr>(pending.cb);
+    if (cancel->cancelled.test_and_set()) {
+      return;
+    }
+    watchdog_.run(cancel->cb, pending.origin);
+  }
+
+  void SchedulerImpl::defer(Pending &&pending) {
+    deferred_.push(pending.priority, std::move(pending));
+    postDrain();
+  }
+
+  void SchedulerImpl::postDrain() {
+    if (drain_posted_) {
+      return;
+    }
+    drain_posted_ = true;
+    backend_->post([weak_self{weak_from_this()}] {
+      if (auto self = weak_self.lock()) {
+        self->drain();
+      }
+    });
+  }
+
+  void SchedulerImpl::drain() {
+    drain_posted_ = false;
+    if (deferred_.drain([&](Pending &pending) { call(pending); })) {
+      postDrain();
+    }
+  }
 }  // namespace libp2p::basic
@@ -0,0 +1,334 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/basic/scheduler/timer_wheel_scheduler.hpp>
+
+#include <bit>
+#include <stdexcept>
+
+#include <libp2p/common/metrics/registry.hpp>
+
+namespace libp2p::basic {
+  namespace {
+    constexpr uint64_t kMask = TimerWheelScheduler::kSlots - 1;
+
+    constexpr size_t shiftOf(size_t level) {
+      return TimerWheelScheduler::kSlotBits * level;
+    }
+
+    constexpr size_t kCompactMinSize = 32;
+
+    /// Delay between due time of timers and their calls
+    metrics::Histogram &lagHistogram() {
+      static auto &histogram = metrics::Registry::instance().histogram(
+          "libp2p_scheduler_lag_seconds",
+          "Delay between due time of timers and their calls");
+      return histogram;
+    }
+  }  // namespace
+
+  TimerWheelScheduler::TimerWheelScheduler(
+      std::shared_ptr<SchedulerBackend> backend, Scheduler::Config config)
+      : backend_{std::move(backend)},
+        config_{config},
+        watchdog_{config.stall_threshold},
+        deferred_{config},
+        current_tick_{static_cast<uint64_t>(backend_->now().count())} {}
+
+  std::chrono::milliseconds TimerWheelScheduler::now() const {
+    return backend_->now();
+  }
+
+  size_t TimerWheelScheduler::size() const {
+    return size_;
+  }
+
+  Scheduler::Handle TimerWheelScheduler::scheduleImpl(
+      Callback &&cb,
+      std::chrono::milliseconds delay_from_now,
+      bool make_handle,
+      Priority priority,
+      const Origin &origin) {
+    if (not cb) {
+      throw std::logic_error{"TimerWheelScheduler::scheduleImpl empty cb arg"};
+    }
+
+    auto deferred = not(Time::zero() < delay_from_now);
+    if (deferred and not make_handle) {
+      backend_->post([weak_self{weak_from_this()},
+                      cb{std::move(cb)},
+                      priority,
+                      origin]() mutable {
+        if (auto self = weak_self.lock()) {
+          self->defer(priority, {nullptr, std::move(cb), origin});
+        }
+      });
+      return Cancel{};
+    }
+    auto entry = std::make_shared<Entry>(std::move(cb), origin, priority);
+    if (not deferred) {
+      entry->tick = (backend_->now() + delay_from_now).count();
+    }
+    std::weak_ptr<Entry> weak_entry;
+    if (make_handle) {
+      weak_entry = entry;
+    }
+    backend_->post(
+        [weak_self{weak_from_this()}, deferred, entry{std::move(entry)}] {
+          auto self = weak_self.lock();
+          if (not self) {
+            return;
+          }
+          if (deferred) {
+            auto priority = entry->priority;
+            self->defer(priority, {std::move(entry), {}, {}});
+            return;
+          }
+          if (entry->cancelled.test()) {
+            return;
+          }
+          self->insert(entry);
+          self->pulse();
+        });
+    if (not make_handle) {
+      return Cancel{};
+    }
+    return cancelFn(
+        [weak_self{weak_from_this()}, weak_entry{std::move(weak_entry)}] {
+          auto entry = weak_entry.lock();
+          if (not entry) {
+            return;
+          }
+          if (entry->cancelled.test_and_set()) {
+            return;
+          }
+          auto self = weak_self.lock();
+          if (not self) {
+            return;
+          }
+          self->backend_->post([weak_self, weak_entry] {
+            auto entry = weak_entry.lock();
+            if (not entry or not entry->linked) {
+              return;
+            }
+            auto self = weak_self.lock();
+            if (not self) {
+              return;
+            }
+            self->remove(*entry);
+          });
+        });
+  }
+
+  void TimerWheelScheduler::armImpl(Timer &timer,
+                                    Callback &&cb,
+                                    std::chrono::milliseconds delay_from_now,
+                                    const Origin &origin) {
+    if (not cb) {
+      throw std::logic_error{"TimerWheelScheduler::arm empty cb arg"};
+    }
+    auto now = backend_->now();
+    auto due = now + std::max(delay_from_now, Time{1});
+    timers_.insert(timer, due, std::move(cb), origin);
+    setTimer(now, due);
+  }
+
+  void TimerWheelScheduler::pulse() {
+    while (true) {
+      auto now = backend_->now();
+      advance(now.count());
+      fireTimers(now);
+      if (size_ == 0 and timers_.empty()) {
+        return;
+      }
+      auto next = Time::max();
+      if (size_ != 0) {
+        next = Time(nextTick());
+      }
+      if (not timers_.empty()) {
+        next = std::min(next, timers_.nextDue());
+      }
+      if (next <= backend_->now()) {
+        continue;
+      }
+      setTimer(now, next);
+      return;
+    }
+  }
+
+  void TimerWheelScheduler::setTimer(Time now, Time min) {
+    if (now < timer_ and timer_ <= min + config_.max_timer_threshold) {
+      return;
+    }
+    timer_ = std::max(now + config_.max_timer_threshold, min);
+    backend_->setTimer(timer_, weak_from_this());
+  }
+
+  size_t TimerWheelScheduler::fireTimers(Time now) {
+    return timers_.fire(
+        now, [&](Time lag, Callback &cb, const Origin &origin) {
+          lagHistogram().observe(lag);
+          watchdog_.run(cb, origin);
+        });
+  }
+
+  void TimerWheelScheduler::defer(Priority priority, Deferred &&deferred) {
+    deferred_.push(priority, std::move(deferred));
+    postDrain();
+  }
+
+  void TimerWheelScheduler::postDrain() {
+    if (drain_posted_) {
+      return;
+    }
+    drain_posted_ = true;
+    backend_->post([weak_self{weak_from_this()}] {
+      if (auto self = weak_self.lock()) {
+        self->drain();
+      }
+    });
+  }
+
+  void TimerWheelScheduler::drain() {
+    drain_posted_ = false;
+    auto more = deferred_.drain([&](Deferred &deferred) {
+      if (not deferred.entry) {
+        watchdog_.run(deferred.cb, deferred.origin);
+      } else if (not deferred.entry->cancelled.test_and_set()) {
+        watchdog_.run(deferred.entry->cb, deferred.entry->origin);
+      }
+    });
+    if (more) {
+      postDrain();
+    }
+  }
+
+  void TimerWheelScheduler::insert(EntryPtr entry) {
+    auto tick = std::max(entry->tick, current_tick_);
+    auto delta = tick - current_tick_;
+    size_t level = 0;
+    while (level + 1 < kLevels
+           and delta >= (uint64_t{1} << shiftOf(level + 1))) {
+      ++level;
+    }
+    if (delta >= (uint64_t{1} << shiftOf(kLevels))) {
+      // out of range, reinserted when the last level makes a full turn
+      constexpr auto kTop = shiftOf(kLevels - 1);
+      tick = ((current_tick_ >> kTop) + kSlots) << kTop;
+    }
+    auto index = (tick >> shiftOf(level)) & kMask;
+    auto &slot = wheel_.at(level).at(index);
+    entry->linked = true;
+    entry->level = static_cast<uint8_t>(level);
+    entry->slot = static_cast<uint8_t>(index);
+    entry->index = slot.entries.size();
+    slot.entries.emplace_back(std::move(entry));
+    ++slot.live;
+    occupied_.at(level) |= uint64_t{1} << index;
+    ++size_;
+  }
+
+  void TimerWheelScheduler::remove(Entry &entry) {
+    auto &slot = wheel_.at(entry.level).at(entry.slot);
+    entry.linked = false;
+    --size_;
+    --slot.live;
+    if (slot.live == 0) {
+      slot.entries.clear();
+      occupied_.at(entry.level) &= ~(uint64_t{1} << entry.slot);
+      return;
+    }
+    // keep the order of remaining entries
+    slot.entries.at(entry.index).reset();
+    if (slot.entries.size() >= kCompactMinSize
+        and slot.live * 2 < slot.entries.size()) {
+      std::erase(slot.entries, nullptr);
+      for (size_t i = 0; i < slot.entries.size(); ++i) {
+        slot.entries[i]->index = i;
+      }
+    }
+  }
+
+  std::vector<TimerWheelScheduler::EntryPtr> TimerWheelScheduler::take(
+      size_t level, size_t index) {
+    auto &slot = wheel_.at(level).at(index);
+    std::vector<EntryPtr> entries;
+    entries.swap(slot.entries);
+    size_ -= slot.live;
+    slot.live = 0;
+    occupied_.at(level) &= ~(uint64_t{1} << index);
+    for (auto &entry : entries) {
+      if (entry) {
+        entry->linked = false;
+      }
+    }
+    return entries;
+  }
+
+  void TimerWheelScheduler::cascade(size_t level) {
+    auto index = (current_tick_ >> shiftOf(level)) & kMask;
+    if (index == 0 and level + 1 < kLevels) {
+      cascade(level + 1);
+    }
+    for (auto &entry : take(level, index)) {
+      if (entry) {
+        insert(std::move(entry));
+      }
+    }
+  }
+
+  void TimerWheelScheduler::advance(uint64_t now) {
+    while (size_ != 0 and current_tick_ <= now) {
+      auto index = current_tick_ & kMask;
+      if (index == 0) {
+        cascade(1);
+      }
+      // callbacks may cancel, but schedule and remove only through backend
+      for (auto &entry : take(0, index)) {
+        if (not entry or entry->cancelled.test()) {
+          continue;
+        }
+        lagHistogram().observe(Time(now > entry->tick ? now - entry->tick : 0));
+        if (entry->priority == Priority::BACKGROUND) {
+          defer(Priority::BACKGROUND, {std::move(entry), {}, {}});
+          continue;
+        }
+        if (not entry->cancelled.test_and_set()) {
+          watchdog_.run(entry->cb, entry->origin);
+        }
+      }
+      ++current_tick_;
+      if (size_ != 0) {
+        current_tick_ = std::min(nextTick(), now + 1);
+      }
+    }
+    current_tick_ = std::max(current_tick_, now + 1);
+  }
+
+  uint64_t TimerWheelScheduler::nextTick() const {
+    if ((current_tick_ & kMask) == 0) {
+      return current_tick_;
+    }
+    for (size_t level = 0; level < kLevels; ++level) {
+      auto shift = shiftOf(level);
+      auto index = (current_tick_ >> shift) & kMask;
+      // current slots of upper levels are already cascaded
+      auto from = level == 0 ? index : index + 1;
+      auto ahead = from < kSlots ? occupied_.at(level) & (~uint64_t{0} << from)
+                                 : uint64_t{0};
+      if (ahead != 0) {
+        auto slot = static_cast<uint64_t>(std::countr_zero(ahead));
+        return ((current_tick_ >> shift) - index + slot) << shift;
+      }
+      if (occupied_.at(level) != 0) {
+        // slots behind become due after the next level turns
+        auto upper = shift + kSlotBits;
+        return ((current_tick_ >> upper) + 1) << upper;
+      }
+    }
+    return current_tick_;
+  }
+}  // namespace libp2p::basic
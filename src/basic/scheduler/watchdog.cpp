@@ -0,0 +1,56 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/basic/scheduler/watchdog.hpp>
+
+#include <libp2p/common/metrics/registry.hpp>
+#include <libp2p/log/logger.hpp>
+
+namespace libp2p::basic {
+  namespace {
+    auto log() {
+      static auto logger = log::createLogger("Scheduler");
+      return logger.get();
+    }
+
+    /// Execution time of scheduler callbacks
+    metrics::Histogram &durationHistogram() {
+      static auto &histogram = metrics::Registry::instance().histogram(
+          "libp2p_scheduler_callback_seconds",
+          "Execution time of scheduler callbacks");
+      return histogram;
+    }
+
+    /// Callbacks, which ran longer than stall threshold
+    metrics::Counter &stallCounter() {
+      static auto &counter = metrics::Registry::instance().counter(
+          "libp2p_scheduler_stalls_total",
+          "Scheduler callbacks, which ran longer than stall threshold");
+      return counter;
+    }
+  }  // namespace
+
+  CallbackWatchdog::CallbackWatchdog(std::chrono::milliseconds threshold)
+      : threshold_{threshold} {}
+
+  void CallbackWatchdog::run(Scheduler::Callback &cb,
+                             const Scheduler::Origin &origin) const {
+    auto started = std::chrono::steady_clock::now();
+    cb();
+    auto elapsed = std::chrono::steady_clock::now() - started;
+    durationHistogram().observe(elapsed);
+    if (threshold_ != threshold_.zero() and elapsed >= threshold_) {
+      stallCounter().inc();
+      log()->warn(
+          "callback scheduled at {}:{} ({}) blocked event loop for {}ms",
+          origin.file_name(),
+          origin.line(),
+          origin.function_name(),
+          std::chrono::duration_cast<std::chrono::milliseconds>(elapsed)
+              .count());
+    }
+  }
+}  // namespace libp2p::basic
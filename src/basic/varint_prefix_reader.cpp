@@ -6,6 +6,8 @@
 
 #include <libp2p/basic/varint_prefix_reader.hpp>
 
+#include <libp2p/multi/uvarint.hpp>
+
 namespace libp2p::basic {
 
   namespace {
@@ -54,6 +56,16 @@ namespace libp2p::basic {
   }
 
   VarintPrefixReader::State VarintPrefixReader::consume(BytesIn &buffer) {
+    // whole varint is usually in buffer, and is decoded at once
+    if (state_ == kUnderflow and got_bytes_ == 0) {
+      if (auto decoded = multi::UVarint::decode(buffer)) {
+        value_ = decoded->value;
+        got_bytes_ = static_cast<uint8_t>(decoded->size);
+        state_ = kReady;
+        buffer = buffer.subspan(decoded->size);
+        return state_;
+      }
+    }
     size_t consumed = 0;
     State s(state_);
     for (auto byte : buffer) {
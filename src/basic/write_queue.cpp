@@ -4,11 +4,27 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+#include <algorithm>
 #include <cassert>
+#include <utility>
 
 #include <libp2p/basic/write_queue.hpp>
+#include <libp2p/common/metrics/registry.hpp>
 
 namespace libp2p::basic {
+  namespace {
+    /// Unsent bytes of all write queues
+    metrics::Gauge &unsentBytesGauge() {
+      static auto &gauge = metrics::Registry::instance().gauge(
+          "libp2p_write_queue_unsent_bytes",
+          "Bytes enqueued to streams and not yet sent");
+      return gauge;
+    }
+  }  // namespace
+
+  WriteQueue::~WriteQueue() {
+    clear();
+  }
 
   bool WriteQueue::canEnqueue(size_t size) const {
     return (size + total_unsent_size_ <= size_limit_);
@@ -25,73 +41,89 @@ namespace libp2p::basic {
     assert(canEnqueue(data_sz));
 
     total_unsent_size_ += data_sz;
-    queue_.push_back({data, 0, 0, data_sz, std::move(cb)});
+    unsentBytesGauge().add(data_sz);
+
+    auto item = allocate();
+    item->data = data;
+    item->unsent = data_sz;
+    item->cb = std::move(cb);
+
+    if (tail_ == nullptr) {
+      head_ = item;
+    } else {
+      tail_->next = item;
+    }
+    tail_ = item;
+    if (active_ == nullptr) {
+      active_ = item;
+    }
+    ++items_count_;
   }
 
   size_t WriteQueue::dequeue(size_t window_size, DataRef &out) {
-    if (total_unsent_size_ == 0 || window_size == 0
-        || active_index_ >= queue_.size()) {
+    std::span<DataRef> chunks{&out, 1};
+    window_size = dequeueMany(window_size, chunks);
+    if (chunks.empty()) {
       out = DataRef{};
-      return window_size;
     }
+    return window_size;
+  }
 
-    assert(!queue_.empty());
+  size_t WriteQueue::dequeueMany(size_t window_size,
+                                 std::span<DataRef> &out) {
+    size_t n = 0;
 
-    auto &item = queue_[active_index_];
+    while (n < out.size() && window_size > 0 && active_ != nullptr) {
+      auto &item = *active_;
 
-    assert(item.unacknowledged + item.acknowledged + item.unsent
-           == static_cast<size_t>(item.data.size()));
-    assert(item.unsent > 0);
+      assert(item.unacknowledged + item.acknowledged + item.unsent
+             == static_cast<size_t>(item.data.size()));
+      assert(item.unsent > 0);
 
-    out = item.data.subspan(item.acknowledged + item.unacknowledged);
-    auto sz = static_cast<size_t>(out.size());
+      auto chunk = item.data.subspan(item.acknowledged + item.unacknowledged);
+      auto sz = std::min(static_cast<size_t>(chunk.size()), window_size);
 
-    assert(sz == item.unsent);
+      assert(static_cast<size_t>(chunk.size()) == item.unsent);
 
-    if (sz > window_size) {
-      sz = window_size;
-      out = out.subspan(0, window_size);
-    }
+      out[n++] = chunk.first(sz);
 
-    item.unsent -= sz;
-    item.unacknowledged += sz;
+      item.unsent -= sz;
+      item.unacknowledged += sz;
 
-    if (item.unsent == 0) {
-      ++active_index_;
-    }
+      if (item.unsent == 0) {
+        active_ = item.next;
+      }
 
-    assert(item.unacknowledged + item.acknowledged + item.unsent
-           == static_cast<size_t>(item.data.size()));
+      assert(total_unsent_size_ >= sz);
+      total_unsent_size_ -= sz;
+      unsentBytesGauge().sub(sz);
 
-    assert(total_unsent_size_ >= sz);
-    total_unsent_size_ -= sz;
+      window_size -= sz;
+    }
 
-    return window_size - sz;
+    out = out.first(n);
+    return window_size;
   }
 
   WriteQueue::AckResult WriteQueue::ackDataSent(size_t size) {
     AckResult result;
 
-    if (queue_.empty() || size == 0) {
+    if (head_ == nullptr || size == 0 || head_->unacknowledged == 0) {
       // inconsistency, must not be called if nothing to ack
       result.data_consistent = false;
       return result;
     }
 
-    auto &item = queue_.front();
+    auto &item = *head_;
 
     auto total_size = item.acknowledged + item.unacknowledged + item.unsent;
 
     assert(total_size == static_cast<size_t>(item.data.size()));
 
-    if (size > item.unacknowledged) {
-      // inconsistency, more data is acked than callback was put for
-      result.data_consistent = false;
-      return result;
-    }
-
-    item.unacknowledged -= size;
-    item.acknowledged += size;
+    // the rest of size, if any, belongs to items sent by the same frame
+    result.size_acked = std::min(size, item.unacknowledged);
+    item.unacknowledged -= result.size_acked;
+    item.acknowledged += result.size_acked;
 
     auto completed = (item.acknowledged == total_size);
 
@@ -107,35 +139,63 @@ namespace libp2p::basic {
     result.size_to_ack = total_size;
     result.data_consistent = true;
 
-    queue_.pop_front();
-    if (queue_.empty()) {
+    assert(active_ != head_);
+    head_ = item.next;
+    if (head_ == nullptr) {
       assert(total_unsent_size_ == 0);
-      active_index_ = 0;
-    } else if (active_index_ > 0) {
-      --active_index_;
+      tail_ = nullptr;
     }
+    --items_count_;
+    recycle(&item);
 
     return result;
   }
 
   std::vector<Writer::WriteCallbackFunc> WriteQueue::getAllCallbacks() {
     std::vector<Writer::WriteCallbackFunc> v;
-    v.reserve(queue_.size());
-    for (auto &item : queue_) {
-      if (!item.cb) {
+    v.reserve(items_count_);
+    for (auto item = head_; item != nullptr; item = item->next) {
+      if (!item->cb) {
         continue;
       }
       v.emplace_back();
-      item.cb.swap(v.back());
+      item->cb.swap(v.back());
     }
     return v;
   }
 
   void WriteQueue::clear() {
-    active_index_ = 0;
+    unsentBytesGauge().sub(total_unsent_size_);
     total_unsent_size_ = 0;
-    std::deque<Data> tmp_queue;
-    queue_.swap(tmp_queue);
+    for (auto list : {head_, free_}) {
+      while (list != nullptr) {
+        delete std::exchange(list, list->next);
+      }
+    }
+    head_ = tail_ = active_ = free_ = nullptr;
+    items_count_ = 0;
+    free_count_ = 0;
+  }
+
+  WriteQueue::Data *WriteQueue::allocate() {
+    if (free_ == nullptr) {
+      return new Data{};
+    }
+    --free_count_;
+    auto item = std::exchange(free_, free_->next);
+    item->next = nullptr;
+    return item;
+  }
+
+  void WriteQueue::recycle(Data *item) {
+    if (free_count_ >= kMaxFreeItems) {
+      delete item;
+      return;
+    }
+    *item = Data{};
+    item->next = free_;
+    free_ = item;
+    ++free_count_;
   }
 
 }  // namespace libp2p::basic
@@ -0,0 +1,52 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/common/metrics/memory_usage.hpp>
+
+#include <unordered_map>
+
+#include <boost/container_hash/hash.hpp>
+
+namespace libp2p::metrics {
+  namespace {
+    [[maybe_unused]] size_t keyHash(const TrafficKey &key) {
+      size_t seed = static_cast<size_t>(key.layer);
+      if (key.peer) {
+        boost::hash_combine(seed, std::hash<peer::PeerId>{}(*key.peer));
+      }
+      boost::hash_combine(seed, key.protocol);
+      return seed;
+    }
+  }  // namespace
+
+  MemoryUsage &MemoryUsage::operator+=(const MemoryUsage &other) {
+    read_buffer += other.read_buffer;
+    write_queue += other.write_queue;
+    pending_callbacks += other.pending_callbacks;
+    return *this;
+  }
+
+  std::vector<MemoryUsageEntry> dumpMemoryUsage() {
+    std::vector<MemoryUsageEntry> entries;
+#ifdef LIBP2P_METRICS_ENABLED
+    std::unordered_map<TrafficKey, size_t, decltype(&keyHash)> index{
+        0, &keyHash};
+    auto &state = MemoryReporter::Libp2pMetricsInstanceList::State::get();
+    std::lock_guard lock{state.mutex};
+    for (auto *reporter : state.list) {
+      auto [it, inserted] =
+          index.try_emplace(reporter->memoryKey(), entries.size());
+      if (inserted) {
+        entries.push_back({.key = it->first});
+      }
+      auto &entry = entries[it->second];
+      ++entry.objects;
+      entry.usage += reporter->memoryUsage();
+    }
+#endif
+    return entries;
+  }
+}  // namespace libp2p::metrics
@@ -0,0 +1,176 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/common/metrics/registry.hpp>
+
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+
+#include <fmt/format.h>
+
+#include <libp2p/common/metrics/instance_count.hpp>
+
+namespace libp2p::metrics {
+  namespace {
+    class PrometheusExporter : public Exporter {
+     public:
+      void counter(std::string_view name,
+                   std::string_view help,
+                   uint64_t value) override {
+        header(name, help, "counter");
+        fmt::format_to(out(), "{} {}\n", name, value);
+      }
+
+      void gauge(std::string_view name,
+                 std::string_view help,
+                 int64_t value) override {
+        header(name, help, "gauge");
+        fmt::format_to(out(), "{} {}\n", name, value);
+      }
+
+      void histogram(std::string_view name,
+                     std::string_view help,
+                     const Histogram::Snapshot &snapshot) override {
+        header(name, help, "histogram");
+        for (size_t i = 0; i < snapshot.bounds.size(); ++i) {
+          fmt::format_to(out(),
+                         "{}_bucket{{le=\"{}\"}} {}\n",
+                         name,
+                         snapshot.bounds[i],
+                         snapshot.counts[i]);
+        }
+        auto count = snapshot.counts.back();
+        fmt::format_to(out(), "{}_bucket{{le=\"+Inf\"}} {}\n", name, count);
+        fmt::format_to(out(), "{}_sum {}\n", name, snapshot.sum);
+        fmt::format_to(out(), "{}_count {}\n", name, count);
+      }
+
+      void instanceCount(std::string_view type, size_t count) override {
+        if (not instances_header_) {
+          header("libp2p_instances", "Live objects by type", "gauge");
+          instances_header_ = true;
+        }
+        fmt::format_to(
+            out(), "libp2p_instances{{type=\"{}\"}} {}\n", type, count);
+      }
+
+      std::string text;
+
+     private:
+      std::back_insert_iterator<std::string> out() {
+        return std::back_inserter(text);
+      }
+
+      void header(std::string_view name,
+                  std::string_view help,
+                  std::string_view type) {
+        fmt::format_to(out(), "# HELP {} {}\n", name, help);
+        fmt::format_to(out(), "# TYPE {} {}\n", name, type);
+      }
+
+      bool instances_header_ = false;
+    };
+  }  // namespace
+
+  Histogram::Histogram(std::vector<double> bounds)
+      : bounds_{std::move(bounds)},
+        counts_{std::make_unique<std::atomic<uint64_t>[]>(bounds_.size()
+                                                          + 1)} {
+    if (not std::is_sorted(bounds_.begin(), bounds_.end())) {
+      throw std::invalid_argument{"Histogram bounds must be sorted"};
+    }
+  }
+
+  void Histogram::observe(double value) {
+    auto bucket = std::lower_bound(bounds_.begin(), bounds_.end(), value)
+                - bounds_.begin();
+    counts_[bucket].fetch_add(1, std::memory_order_relaxed);
+    sum_.fetch_add(value, std::memory_order_relaxed);
+  }
+
+  Histogram::Snapshot Histogram::snapshot() const {
+    Snapshot snapshot{
+        .bounds = bounds_,
+        .counts = std::vector<uint64_t>(bounds_.size() + 1),
+        .sum = sum_.load(std::memory_order_relaxed),
+    };
+    uint64_t total = 0;
+    for (size_t i = 0; i < snapshot.counts.size(); ++i) {
+      total += counts_[i].load(std::memory_order_relaxed);
+      snapshot.counts[i] = total;
+    }
+    return snapshot;
+  }
+
+  const std::vector<double> &latencyBuckets() {
+    static const std::vector<double> buckets{
+        0.0001, 0.0005, 0.001, 0.005, 0.01, 0.05, 0.1, 0.5, 1, 5, 10};
+    return buckets;
+  }
+
+  Registry &Registry::instance() {
+    // never destroyed, metrics may be updated from static destructors
+    static auto *registry = new Registry();
+    return *registry;
+  }
+
+  Counter &Registry::counter(const std::string &name, std::string help) {
+    std::lock_guard lock{mutex_};
+    auto &entry = counters_[name];
+    if (not entry.metric) {
+      entry = {std::move(help), std::make_unique<Counter>()};
+    }
+    return *entry.metric;
+  }
+
+  Gauge &Registry::gauge(const std::string &name, std::string help) {
+    std::lock_guard lock{mutex_};
+    auto &entry = gauges_[name];
+    if (not entry.metric) {
+      entry = {std::move(help), std::make_unique<Gauge>()};
+    }
+    return *entry.metric;
+  }
+
+  Histogram &Registry::histogram(const std::string &name,
+                                 std::string help,
+                                 const std::vector<double> &bounds) {
+    std::lock_guard lock{mutex_};
+    auto &entry = histograms_[name];
+    if (not entry.metric) {
+      entry = {std::move(help), std::make_unique<Histogram>(bounds)};
+    }
+    return *entry.metric;
+  }
+
+  void Registry::collect(Exporter &exporter) const {
+    {
+      std::lock_guard lock{mutex_};
+      for (auto &[name, entry] : counters_) {
+        exporter.counter(name, entry.help, entry.metric->value());
+      }
+      for (auto &[name, entry] : gauges_) {
+        exporter.gauge(name, entry.help, entry.metric->value());
+      }
+      for (auto &[name, entry] : histograms_) {
+        exporter.histogram(name, entry.help, entry.metric->snapshot());
+      }
+    }
+    auto &instances = instance::State::get();
+    std::lock_guard lock{instances.mutex};
+    for (auto &[type, count] : instances.counts) {
+      exporter.instanceCount(type, count.load());
+    }
+  }
+
+  std::string Registry::exportText() const {
+    PrometheusExporter exporter;
+    collect(exporter);
+    return std::move(exporter.text);
+  }
+
+}  // namespace libp2p::metrics
@@ -0,0 +1,63 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/common/metrics/startup.hpp>
+
+#include <mutex>
+
+#include <fmt/format.h>
+
+#include <libp2p/common/metrics/registry.hpp>
+
+namespace libp2p::metrics {
+  namespace {
+    struct Phases {
+      std::mutex mutex;
+      std::vector<StartupPhaseTime> phases;
+
+      static Phases &get() {
+        // never destroyed, like registry
+        static auto *phases = new Phases();
+        return *phases;
+      }
+    };
+  }  // namespace
+
+  StartupPhase::StartupPhase(std::string name)
+      : name_{std::move(name)}, started_{std::chrono::steady_clock::now()} {}
+
+  StartupPhase::~StartupPhase() {
+    auto duration = std::chrono::steady_clock::now() - started_;
+    Registry::instance()
+        .histogram(fmt::format("libp2p_startup_{}_seconds", name_),
+                   fmt::format("Time of {} startup phase", name_))
+        .observe(duration);
+    auto &state = Phases::get();
+    std::lock_guard lock{state.mutex};
+    state.phases.push_back({std::move(name_), duration});
+  }
+
+  std::vector<StartupPhaseTime> startupPhases() {
+    auto &state = Phases::get();
+    std::lock_guard lock{state.mutex};
+    return state.phases;
+  }
+
+  std::string startupReport() {
+    std::string report;
+    for (auto &phase : startupPhases()) {
+      if (not report.empty()) {
+        report += ", ";
+      }
+      fmt::format_to(
+          std::back_inserter(report),
+          "{} {:.2f}ms",
+          phase.name,
+          std::chrono::duration<double, std::milli>(phase.duration).count());
+    }
+    return report;
+  }
+}  // namespace libp2p::metrics
@@ -0,0 +1,97 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/common/metrics/tracing.hpp>
+
+#include <atomic>
+#include <mutex>
+
+namespace libp2p::metrics {
+  namespace {
+    struct Installed {
+      /// Checked first, so that spans without tracer take no lock
+      std::atomic_bool enabled = false;
+      std::mutex mutex;
+      std::shared_ptr<Tracer> tracer;
+    };
+
+    Installed &installed() {
+      static auto *installed = new Installed{};
+      return *installed;
+    }
+
+    std::shared_ptr<Tracer> currentTracer() {
+      auto &state = installed();
+      if (not state.enabled.load(std::memory_order_relaxed)) {
+        return nullptr;
+      }
+      std::lock_guard lock{state.mutex};
+      return state.tracer;
+    }
+  }  // namespace
+
+  struct Span::Impl {
+    explicit Impl(std::shared_ptr<TraceSpan> span) : span{std::move(span)} {}
+
+    Impl(const Impl &) = delete;
+    Impl &operator=(const Impl &) = delete;
+
+    ~Impl() {
+      end({});
+    }
+
+    void end(std::error_code error) {
+      if (not ended) {
+        ended = true;
+        span->end(error);
+      }
+    }
+
+    std::shared_ptr<Tracer> tracer;
+    std::shared_ptr<TraceSpan> span;
+    bool ended = false;
+  };
+
+  void setTracer(std::shared_ptr<Tracer> tracer) {
+    auto &state = installed();
+    std::lock_guard lock{state.mutex};
+    state.enabled = tracer != nullptr;
+    state.tracer = std::move(tracer);
+  }
+
+  Span::Span(std::string_view name) {
+    if (auto tracer = currentTracer()) {
+      if (auto span = tracer->startSpan(name, nullptr)) {
+        impl_ = std::make_shared<Impl>(std::move(span));
+        impl_->tracer = std::move(tracer);
+      }
+    }
+  }
+
+  Span Span::child(std::string_view name) const {
+    Span child;
+    if (impl_ == nullptr) {
+      return child;
+    }
+    if (auto span = impl_->tracer->startSpan(name, impl_->span.get())) {
+      child.impl_ = std::make_shared<Impl>(std::move(span));
+      child.impl_->tracer = impl_->tracer;
+    }
+    return child;
+  }
+
+  void Span::setAttribute(std::string_view key, std::string_view value) const {
+    if (impl_ != nullptr and not impl_->ended) {
+      impl_->span->setAttribute(key, value);
+    }
+  }
+
+  void Span::end(std::error_code error) const {
+    if (impl_ != nullptr) {
+      impl_->end(error);
+    }
+  }
+}  // namespace libp2p::metrics
@@ -0,0 +1,206 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/common/metrics/traffic.hpp>
+
+#include <boost/container_hash/hash.hpp>
+
+namespace libp2p::metrics {
+  namespace {
+    constexpr size_t kBytes = 0;
+    constexpr size_t kFrames = 2;
+    constexpr size_t kMessages = 4;
+  }  // namespace
+
+  TrafficStats &TrafficStats::operator+=(const TrafficStats &other) {
+    bytes_read += other.bytes_read;
+    bytes_written += other.bytes_written;
+    frames_read += other.frames_read;
+    frames_written += other.frames_written;
+    messages_read += other.messages_read;
+    messages_written += other.messages_written;
+    return *this;
+  }
+
+  size_t Traffic::KeyHash::operator()(const TrafficKey &key) const {
+    size_t seed = static_cast<size_t>(key.layer);
+    if (key.peer) {
+      boost::hash_combine(seed, std::hash<peer::PeerId>{}(*key.peer));
+    }
+    boost::hash_combine(seed, key.protocol);
+    return seed;
+  }
+
+  TrafficStats Traffic::Cell::load() const {
+    auto get = [&](size_t i) {
+      return values[i].load(std::memory_order_relaxed);
+    };
+    return {
+        .bytes_read = get(kBytes),
+        .bytes_written = get(kBytes + 1),
+        .frames_read = get(kFrames),
+        .frames_written = get(kFrames + 1),
+        .messages_read = get(kMessages),
+        .messages_written = get(kMessages + 1),
+    };
+  }
+
+  Traffic::ShardOwner::ShardOwner() : shard{std::make_shared<Shard>()} {
+    auto &traffic = instance();
+    std::lock_guard lock{traffic.mutex_};
+    traffic.shards_.emplace_back(shard);
+  }
+
+  Traffic::ShardOwner::~ShardOwner() {
+    auto &traffic = instance();
+    std::lock_guard lock{traffic.mutex_};
+    for (auto &[key, cell] : shard->cells) {
+      traffic.retired_[key] += cell.load();
+    }
+    std::erase(traffic.shards_, shard);
+  }
+
+  Traffic &Traffic::instance() {
+    // never destroyed, threads may exit after static destructors
+    static auto *instance = new Traffic();
+    return *instance;
+  }
+
+  const TrafficKey *Traffic::intern(TrafficKey key) {
+    std::lock_guard lock{mutex_};
+    auto it = keys_.find(key);
+    if (it == keys_.end() and keys_.size() >= max_keys_) {
+      key = {.layer = key.layer, .protocol = std::string{kOtherProtocol}};
+      it = keys_.find(key);
+    }
+    if (it == keys_.end()) {
+      auto ptr = std::make_unique<TrafficKey>(key);
+      it = keys_.emplace(std::move(key), std::move(ptr)).first;
+    }
+    return it->second.get();
+  }
+
+  void Traffic::setMaxKeys(size_t max_keys) {
+    std::lock_guard lock{mutex_};
+    max_keys_ = max_keys;
+  }
+
+  size_t Traffic::keyCount() const {
+    std::lock_guard lock{mutex_};
+    return keys_.size();
+  }
+
+  Traffic::Cell &Traffic::cell(const TrafficKey *key) {
+    thread_local ShardOwner owner;
+    auto &shard = *owner.shard;
+    if (shard.last_key == key) {
+      return *shard.last_cell;
+    }
+    auto it = shard.cells.find(key);
+    if (it == shard.cells.end()) {
+      std::lock_guard lock{shard.mutex};
+      it = shard.cells.try_emplace(key).first;
+    }
+    shard.last_key = key;
+    shard.last_cell = &it->second;
+    return it->second;
+  }
+
+  void Traffic::add(const TrafficKey *key,
+                    bool read,
+                    uint64_t bytes,
+                    uint64_t frames,
+                    uint64_t messages) {
+    auto &c = cell(key);
+    auto direction = read ? 0 : 1;
+    if (bytes != 0) {
+      c.add(kBytes + direction, bytes);
+    }
+    if (frames != 0) {
+      c.add(kFrames + direction, frames);
+    }
+    if (messages != 0) {
+      c.add(kMessages + direction, messages);
+    }
+  }
+
+  std::unordered_map<const TrafficKey *, TrafficStats> Traffic::aggregate()
+      const {
+    std::lock_guard lock{mutex_};
+    auto result = retired_;
+    for (auto &shard : shards_) {
+      std::lock_guard shard_lock{shard->mutex};
+      for (auto &[key, cell] : shard->cells) {
+        result[key] += cell.load();
+      }
+    }
+    return result;
+  }
+
+  std::vector<std::pair<TrafficKey, TrafficStats>> Traffic::snapshot() const {
+    std::vector<std::pair<TrafficKey, TrafficStats>> result;
+    for (auto &[key, stats] : aggregate()) {
+      result.emplace_back(*key, stats);
+    }
+    return result;
+  }
+
+  TrafficStats Traffic::total(TrafficLayer layer) const {
+    TrafficStats result;
+    for (auto &[key, stats] : aggregate()) {
+      if (key->layer == layer) {
+        result += stats;
+      }
+    }
+    return result;
+  }
+
+  std::unordered_map<peer::PeerId, TrafficStats> Traffic::byPeer(
+      TrafficLayer layer) const {
+    std::unordered_map<peer::PeerId, TrafficStats> result;
+    for (auto &[key, stats] : aggregate()) {
+      if (key->layer == layer and key->peer) {
+        result[*key->peer] += stats;
+      }
+    }
+    return result;
+  }
+
+  std::unordered_map<peer::ProtocolName, TrafficStats> Traffic::byProtocol()
+      const {
+    std::unordered_map<peer::ProtocolName, TrafficStats> result;
+    for (auto &[key, stats] : aggregate()) {
+      if (key->layer == TrafficLayer::MUXED) {
+        result[key->protocol] += stats;
+      }
+    }
+    return result;
+  }
+
+  TrafficMeter::TrafficMeter(TrafficLayer layer)
+      : key_{Traffic::instance().intern({.layer = layer})} {}
+
+  void TrafficMeter::attribute(const peer::PeerId &peer) {
+    key_ = Traffic::instance().intern({.layer = key_->layer, .peer = peer});
+  }
+
+  void TrafficMeter::attribute(const peer::PeerId &peer,
+                               const peer::ProtocolName &protocol) {
+    key_ = Traffic::instance().intern(
+        {.layer = key_->layer, .peer = peer, .protocol = protocol});
+  }
+
+  void TrafficMeter::onRead(uint64_t bytes, uint64_t frames, uint64_t messages) {
+    Traffic::instance().add(key_, true, bytes, frames, messages);
+  }
+
+  void TrafficMeter::onWritten(uint64_t bytes,
+                               uint64_t frames,
+                               uint64_t messages) {
+    Traffic::instance().add(key_, false, bytes, frames, messages);
+  }
+
+}  // namespace libp2p::metrics
@@ -0,0 +1,259 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/connection/buffered_connection.hpp>
+
+#include <algorithm>
+
+#include <libp2p/basic/read_return_size.hpp>
+#include <libp2p/basic/write_return_size.hpp>
+#include <libp2p/common/ambigous_size.hpp>
+
+namespace libp2p::connection {
+
+  namespace {
+    /// Deeper buffered reads complete on the next tick, so that upper layer
+    /// reading one small frame after another doesn't overflow the stack
+    constexpr size_t kMaxSyncReads = 16;
+  }  // namespace
+
+  BufferedConnection::BufferedConnection(
+      std::shared_ptr<LayerConnection> connection,
+      std::shared_ptr<basic::Scheduler> scheduler,
+      Config config)
+      : connection_{std::move(connection)},
+        scheduler_{std::move(scheduler)},
+        config_{config} {
+    BOOST_ASSERT(connection_ != nullptr);
+    BOOST_ASSERT(scheduler_ != nullptr or config_.write_buffer == 0);
+  }
+
+  void BufferedConnection::flush() {
+    flush_timer_.cancel();
+    if (flushing_ or write_buffer_.empty()) {
+      return;
+    }
+    flushing_ = true;
+    // writes go on into the other buffer meanwhile
+    std::swap(write_buffer_, flush_buffer_);
+    // kept alive to close the connection after flush
+    writeReturnSize(connection_,
+                    flush_buffer_,
+                    [self{shared_from_this()}](outcome::result<size_t> result) {
+                      self->onFlushed(result.has_error() ? result.error()
+                                                         : std::error_code{});
+                    });
+  }
+
+  void BufferedConnection::onFlushed(std::error_code ec) {
+    flushing_ = false;
+    flush_buffer_.clear();
+    if (ec) {
+      write_error_ = ec;
+      write_buffer_.clear();
+      if (blocked_write_) {
+        auto cb = std::move(blocked_write_->second);
+        blocked_write_.reset();
+        cb(ec);
+      }
+    }
+    if (closing_) {
+      if (blocked_write_) {
+        auto cb = std::move(blocked_write_->second);
+        blocked_write_.reset();
+        cb(Error::CONNECTION_NOT_ACTIVE);
+      }
+      if (write_buffer_.empty()) {
+        std::ignore = connection_->close();
+      } else {
+        flush();
+      }
+      return;
+    }
+    if (ec) {
+      return;
+    }
+    if (write_buffer_.size() >= config_.write_buffer) {
+      flush();
+    }
+    if (blocked_write_) {
+      auto [in, cb] = std::move(*blocked_write_);
+      blocked_write_.reset();
+      BytesIn buffers[]{in};
+      return writeBuffered(buffers, std::move(cb));
+    }
+    armFlushTimer();
+  }
+
+  void BufferedConnection::armFlushTimer() {
+    if (flushing_ or write_buffer_.empty()) {
+      return;
+    }
+    // timer is cancelled when this is destroyed
+    scheduler_->arm(
+        flush_timer_, [this] { flush(); }, config_.write_delay);
+  }
+
+  bool BufferedConnection::isClosed() const {
+    return closing_ or connection_->isClosed();
+  }
+
+  outcome::result<void> BufferedConnection::close() {
+    if (closing_) {
+      return outcome::success();
+    }
+    if (flushing_ or not write_buffer_.empty()) {
+      closing_ = true;
+      flush();
+      return outcome::success();
+    }
+    return connection_->close();
+  }
+
+  void BufferedConnection::read(BytesOut out,
+                                size_t bytes,
+                                ReadCallbackFunc cb) {
+    ambigousSize(out, bytes);
+    readReturnSize(shared_from_this(), out, std::move(cb));
+  }
+
+  void BufferedConnection::readSome(BytesOut out,
+                                    size_t bytes,
+                                    ReadCallbackFunc cb) {
+    ambigousSize(out, bytes);
+    if (read_begin_ != read_end_) {
+      return serveRead(out, std::move(cb));
+    }
+    if (out.size() >= config_.read_buffer) {
+      // nothing to gain from copying
+      return connection_->readSome(out, out.size(), std::move(cb));
+    }
+    read_buffer_.resize(config_.read_buffer);
+    connection_->readSome(
+        read_buffer_,
+        read_buffer_.size(),
+        [weak{weak_from_this()}, out, cb{std::move(cb)}](
+            outcome::result<size_t> result) mutable {
+          auto self = weak.lock();
+          if (not self or result.has_error() or result.value() == 0) {
+            return cb(result);
+          }
+          self->read_begin_ = 0;
+          self->read_end_ = result.value();
+          self->serveRead(out, std::move(cb));
+        });
+  }
+
+  void BufferedConnection::serveRead(BytesOut out, ReadCallbackFunc cb) {
+    auto n = std::min(out.size(), read_end_ - read_begin_);
+    std::copy_n(read_buffer_.begin() + static_cast<ptrdiff_t>(read_begin_),
+                n,
+                out.begin());
+    read_begin_ += n;
+    if (read_begin_ == read_end_) {
+      read_begin_ = read_end_ = 0;
+    }
+    if (sync_reads_ >= kMaxSyncReads) {
+      return deferReadCallback(n, std::move(cb));
+    }
+    ++sync_reads_;
+    cb(n);
+    --sync_reads_;
+  }
+
+  void BufferedConnection::deferReadCallback(outcome::result<size_t> res,
+                                             ReadCallbackFunc cb) {
+    connection_->deferReadCallback(res, std::move(cb));
+  }
+
+  void BufferedConnection::writeSome(BytesIn in,
+                                     size_t bytes,
+                                     WriteCallbackFunc cb) {
+    ambigousSize(in, bytes);
+    BytesIn buffers[]{in};
+    writeSomeVectored(buffers, std::move(cb));
+  }
+
+  void BufferedConnection::writeSomeVectored(std::span<const BytesIn> in,
+                                             WriteCallbackFunc cb) {
+    if (config_.write_buffer == 0) {
+      return connection_->writeSomeVectored(in, std::move(cb));
+    }
+    if (write_error_) {
+      return deferWriteCallback(write_error_, std::move(cb));
+    }
+    if (closing_) {
+      return deferWriteCallback(Error::CONNECTION_NOT_ACTIVE, std::move(cb));
+    }
+    size_t total = 0;
+    for (const auto &buffer : in) {
+      total += buffer.size();
+    }
+    if (total >= config_.write_buffer and not flushing_
+        and write_buffer_.empty()) {
+      // nothing to coalesce with
+      return connection_->writeSomeVectored(in, std::move(cb));
+    }
+    writeBuffered(in, std::move(cb));
+  }
+
+  void BufferedConnection::writeBuffered(std::span<const BytesIn> in,
+                                         WriteCallbackFunc cb) {
+    if (write_buffer_.size() >= config_.write_buffer) {
+      // full buffer is flushed at once, so the flush is still in progress
+      BOOST_ASSERT(flushing_);
+      BOOST_ASSERT(not blocked_write_);
+      BytesIn first;
+      for (const auto &buffer : in) {
+        if (not buffer.empty()) {
+          first = buffer;
+          break;
+        }
+      }
+      blocked_write_.emplace(first, std::move(cb));
+      return;
+    }
+    if (write_buffer_.capacity() < config_.write_buffer) {
+      write_buffer_.reserve(config_.write_buffer);
+    }
+    size_t written = 0;
+    for (const auto &buffer : in) {
+      auto n = std::min<size_t>(buffer.size(),
+                                config_.write_buffer - write_buffer_.size());
+      write_buffer_.insert(
+          write_buffer_.end(), buffer.begin(), buffer.begin() + n);
+      written += n;
+      if (write_buffer_.size() == config_.write_buffer) {
+        break;
+      }
+    }
+    if (write_buffer_.size() == config_.write_buffer) {
+      flush();
+    } else {
+      armFlushTimer();
+    }
+    // intentionally used deferReadCallback, since it acquires bytes written
+    deferReadCallback(written, std::move(cb));
+  }
+
+  void BufferedConnection::deferWriteCallback(std::error_code ec,
+                                              WriteCallbackFunc cb) {
+    connection_->deferWriteCallback(ec, std::move(cb));
+  }
+
+  bool BufferedConnection::isInitiator() const {
+    return connection_->isInitiator();
+  }
+
+  outcome::result<multi::Multiaddress> BufferedConnection::localMultiaddr() {
+    return connection_->localMultiaddr();
+  }
+
+  outcome::result<multi::Multiaddress> BufferedConnection::remoteMultiaddr() {
+    return connection_->remoteMultiaddr();
+  }
+
+}  // namespace libp2p::connection
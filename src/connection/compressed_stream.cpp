@@ -0,0 +1,211 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/connection/compressed_stream.hpp>
+
+#include <algorithm>
+
+#include <boost/endian/conversion.hpp>
+
+#include <libp2p/basic/read.hpp>
+#include <libp2p/basic/write.hpp>
+
+namespace libp2p::connection {
+  namespace {
+    /// Compressed frames are rejected above this size, incompressible
+    /// payload grows by a few bytes
+    constexpr size_t kMaxCompressedFrameSize =
+        2 * CompressedStream::kMaxFrameSize;
+  }  // namespace
+
+  CompressedStream::CompressedStream(std::shared_ptr<Stream> stream,
+                                     std::shared_ptr<basic::Codec> codec)
+      : stream_{std::move(stream)}, codec_{std::move(codec)} {
+    BOOST_ASSERT(stream_ != nullptr);
+    BOOST_ASSERT(codec_ != nullptr);
+  }
+
+  void CompressedStream::read(BytesOut out,
+                              size_t bytes,
+                              ReadCallbackFunc cb) {
+    out = out.first(std::min(out.size(), bytes));
+    libp2p::read(shared_from_this(),
+                 out,
+                 [size{out.size()}, cb{std::move(cb)}](
+                     outcome::result<void> res) {
+                   if (res.has_error()) {
+                     return cb(res.error());
+                   }
+                   cb(size);
+                 });
+  }
+
+  void CompressedStream::readSome(BytesOut out,
+                                  size_t bytes,
+                                  ReadCallbackFunc cb) {
+    if (out.empty() or bytes == 0) {
+      return stream_->deferReadCallback(Error::STREAM_INVALID_ARGUMENT,
+                                        std::move(cb));
+    }
+    if (decoded_offset_ < decoded_.size()) {
+      return readDecoded(out, bytes, std::move(cb));
+    }
+    libp2p::read(stream_,
+                 read_header_,
+                 [weak{weak_from_this()}, out, bytes, cb{std::move(cb)}](
+                     outcome::result<void> res) mutable {
+                   auto self = weak.lock();
+                   if (not self) {
+                     return;
+                   }
+                   if (res.has_error()) {
+                     return cb(res.error());
+                   }
+                   auto size = boost::endian::load_big_u32(
+                       self->read_header_.data());
+                   if (size == 0 or size > kMaxCompressedFrameSize) {
+                     self->stream_->reset();
+                     return cb(Error::STREAM_PROTOCOL_ERROR);
+                   }
+                   self->read_frame_.resize(size);
+                   libp2p::read(
+                       self->stream_,
+                       self->read_frame_,
+                       [weak, out, bytes, cb{std::move(cb)}](
+                           outcome::result<void> res) mutable {
+                         auto self = weak.lock();
+                         if (not self) {
+                           return;
+                         }
+                         if (res.has_error()) {
+                           return cb(res.error());
+                         }
+                         self->onFrameRead(out, bytes, std::move(cb));
+                       });
+                 });
+  }
+
+  void CompressedStream::onFrameRead(BytesOut out,
+                                     size_t bytes,
+                                     ReadCallbackFunc cb) {
+    auto decoded = codec_->decompress(read_frame_, kMaxFrameSize);
+    if (decoded.has_error() or decoded.value().empty()) {
+      stream_->reset();
+      return cb(Error::STREAM_PROTOCOL_ERROR);
+    }
+    decoded_ = std::move(decoded.value());
+    decoded_offset_ = 0;
+    auto n = std::min({out.size(), bytes, decoded_.size()});
+    std::copy_n(decoded_.begin(), n, out.begin());
+    decoded_offset_ = n;
+    cb(n);
+  }
+
+  void CompressedStream::readDecoded(BytesOut out,
+                                     size_t bytes,
+                                     ReadCallbackFunc cb) {
+    auto n =
+        std::min({out.size(), bytes, decoded_.size() - decoded_offset_});
+    std::copy_n(decoded_.begin() + decoded_offset_, n, out.begin());
+    decoded_offset_ += n;
+    stream_->deferReadCallback(n, std::move(cb));
+  }
+
+  void CompressedStream::deferReadCallback(outcome::result<size_t> res,
+                                           ReadCallbackFunc cb) {
+    stream_->deferReadCallback(res, std::move(cb));
+  }
+
+  void CompressedStream::writeSome(BytesIn in,
+                                   size_t bytes,
+                                   WriteCallbackFunc cb) {
+    auto chunk = in.first(std::min({in.size(), bytes, kMaxFrameSize}));
+    if (chunk.empty()) {
+      return stream_->writeSome(in, bytes, std::move(cb));
+    }
+    auto compressed = codec_->compress(chunk);
+    if (compressed.has_error()) {
+      return stream_->deferWriteCallback(compressed.error(), std::move(cb));
+    }
+    write_frame_.resize(kHeaderSize);
+    boost::endian::store_big_u32(write_frame_.data(),
+                                 compressed.value().size());
+    write_frame_.insert(write_frame_.end(),
+                        compressed.value().begin(),
+                        compressed.value().end());
+    libp2p::write(stream_,
+                  write_frame_,
+                  [self{shared_from_this()},
+                   size{chunk.size()},
+                   cb{std::move(cb)}](outcome::result<void> res) {
+                    if (res.has_error()) {
+                      return cb(res.error());
+                    }
+                    cb(size);
+                  });
+  }
+
+  void CompressedStream::deferWriteCallback(std::error_code ec,
+                                            WriteCallbackFunc cb) {
+    stream_->deferWriteCallback(ec, std::move(cb));
+  }
+
+  bool CompressedStream::isClosedForRead() const {
+    return stream_->isClosedForRead();
+  }
+
+  bool CompressedStream::isClosedForWrite() const {
+    return stream_->isClosedForWrite();
+  }
+
+  bool CompressedStream::isClosed() const {
+    return stream_->isClosed();
+  }
+
+  void CompressedStream::close(VoidResultHandlerFunc cb) {
+    stream_->close(std::move(cb));
+  }
+
+  void CompressedStream::reset() {
+    stream_->reset();
+  }
+
+  void CompressedStream::adjustWindowSize(uint32_t new_size,
+                                          VoidResultHandlerFunc cb) {
+    stream_->adjustWindowSize(new_size, std::move(cb));
+  }
+
+  outcome::result<bool> CompressedStream::isInitiator() const {
+    return stream_->isInitiator();
+  }
+
+  outcome::result<peer::PeerId> CompressedStream::remotePeerId() const {
+    return stream_->remotePeerId();
+  }
+
+  outcome::result<multi::Multiaddress> CompressedStream::localMultiaddr()
+      const {
+    return stream_->localMultiaddr();
+  }
+
+  outcome::result<multi::Multiaddress> CompressedStream::remoteMultiaddr()
+      const {
+    return stream_->remoteMultiaddr();
+  }
+
+  void CompressedStream::attributeTraffic(const peer::ProtocolName &protocol) {
+    stream_->attributeTraffic(protocol);
+  }
+
+  bool CompressedStream::admitProtocol(const peer::ProtocolName &protocol) {
+    return stream_->admitProtocol(protocol);
+  }
+
+  void CompressedStream::setWriteWeight(uint8_t weight) {
+    stream_->setWriteWeight(weight);
+  }
+
+}  // namespace libp2p::connection
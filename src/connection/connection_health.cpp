@@ -0,0 +1,62 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/connection/connection_health.hpp>
+
+#include <ranges>
+
+namespace libp2p::connection {
+  ConnectionHealth::ConnectionHealth(
+      Config config, std::shared_ptr<basic::Scheduler> scheduler)
+      : config_{config},
+        scheduler_{std::move(scheduler)},
+        now_{scheduler_->now()} {
+    if (config_.tick == Time::zero()) {
+      config_.tick = Config{}.tick;
+    }
+    if (config_.batch == 0) {
+      config_.batch = Config{}.batch;
+    }
+  }
+
+  void ConnectionHealth::add(HealthCheck &check, Time interval) {
+    check.stopHealthCheck();
+    if (size_ == 0) {
+      // clock was not read while nothing was checked
+      now_ = scheduler_->now();
+      setTimer();
+    }
+    auto &list = lists_.try_emplace(interval, *this, interval).first->second;
+    check.active_ = now_;
+    list.append(check);
+    ++size_;
+  }
+
+  void ConnectionHealth::setTimer() {
+    // timer is cancelled when this is destroyed
+    scheduler_->arm(
+        timer_, [this] { onTick(); }, config_.tick);
+  }
+
+  void ConnectionHealth::onTick() {
+    now_ = scheduler_->now();
+    size_t handled = 0;
+    for (auto &list : lists_ | std::views::values) {
+      while (handled < config_.batch and list.head_ != nullptr
+             and list.head_->due_ <= now_) {
+        auto &check = *list.head_;
+        ++handled;
+        // check may be stopped or destroyed by its callback
+        list.remove(check);
+        list.append(check);
+        check.onHealthIdle(now_ - check.active_);
+      }
+    }
+    if (size_ != 0) {
+      setTimer();
+    }
+  }
+}  // namespace libp2p::connection
@@ -75,6 +75,26 @@ namespace libp2p::crypto::aes {
     return out_buffer;
   }
 
+  outcome::result<void> AesCtrImpl::cryptInPlace(BytesOut data) const {
+    if (initialization_error_.has_error()) {
+      return initialization_error_.error();
+    }
+    // counter mode is a stream cipher, output has the same size as input
+    int out_len{0};
+    if (1
+            != EVP_CipherUpdate(
+                ctx_, data.data(), &out_len, data.data(), data.size())
+        or static_cast<size_t>(out_len) != data.size()) {
+      switch (mode_) {
+        case Mode::ENCRYPT:
+          return OpenSslError::FAILED_ENCRYPT_UPDATE;
+        case Mode::DECRYPT:
+          return OpenSslError::FAILED_DECRYPT_UPDATE;
+      }
+    }
+    return outcome::success();
+  }
+
   outcome::result<Bytes> AesCtrImpl::finalize() {
     if (initialization_error_.has_error()) {
       return initialization_error_.error();
@@ -4,7 +4,6 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
-#include <openssl/aead.h>
 #include <libp2p/crypto/chachapoly/chachapoly_impl.hpp>
 #include <libp2p/crypto/error.hpp>
 
@@ -22,36 +21,60 @@ namespace libp2p::crypto::chachapoly {
         aead_{EVP_aead_chacha20_poly1305()},
         overhead_{EVP_AEAD_max_overhead(aead_)} {}
 
-  outcome::result<void> ChaCha20Poly1305Impl::init(EVP_AEAD_CTX *ctx,
-                                                   bool encrypt) {
-    IF1(EVP_AEAD_CTX_init_with_direction(
-            ctx,
-            aead_,
-            key_.data(),
-            key_.size(),
-            kTagSize,
-            encrypt ? evp_aead_seal : evp_aead_open),
-        "EVP_AEAD_CTX_init",
-        OpenSslError::FAILED_INITIALIZE_CONTEXT);
-    return outcome::success();
+  outcome::result<EVP_AEAD_CTX *> ChaCha20Poly1305Impl::context(
+      bool encrypt) {
+    auto &ctx = encrypt ? seal_ctx_ : open_ctx_;
+    auto &ready = encrypt ? seal_ready_ : open_ready_;
+    if (not ready) {
+      // key schedule is done once, all messages of the key reuse it
+      IF1(EVP_AEAD_CTX_init_with_direction(
+              ctx.get(),
+              aead_,
+              key_.data(),
+              key_.size(),
+              kTagSize,
+              encrypt ? evp_aead_seal : evp_aead_open),
+          "EVP_AEAD_CTX_init",
+          OpenSslError::FAILED_INITIALIZE_CONTEXT);
+      ready = true;
+    }
+    return ctx.get();
   }
 
   outcome::result<Bytes> ChaCha20Poly1305Impl::encrypt(const Nonce &nonce,
                                                        BytesIn plaintext,
                                                        BytesIn aad) {
-    bssl::ScopedEVP_AEAD_CTX ctx;
-    OUTCOME_TRY(init(ctx.get(), true));
     Bytes result;
-    // just reserving the space, possibly without actual memory allocation:
-    // ciphertext length equals to plaintext length
-    // one block size for EncryptFinal_ex (usually not required)
-    // 16 bytes for the tag
+    // ciphertext length equals to plaintext length plus the tag
     result.resize(plaintext.size() + overhead_);
+    OUTCOME_TRY(out_size, encrypt(nonce, plaintext, aad, result));
+    result.resize(out_size);
+    return result;
+  }
+
+  outcome::result<Bytes> ChaCha20Poly1305Impl::decrypt(const Nonce &nonce,
+                                                       BytesIn ciphertext,
+                                                       BytesIn aad) {
+    Bytes result;
+    // plain text should take less bytes than cipher text,
+    // at least it would not contain tag-length bytes (16).
+    result.resize(ciphertext.size());
+    OUTCOME_TRY(out_size, decrypt(nonce, ciphertext, aad, result));
+    result.resize(out_size);
+    return result;
+  }
+
+  outcome::result<size_t> ChaCha20Poly1305Impl::encrypt(const Nonce &nonce,
+                                                        BytesIn plaintext,
+                                                        BytesIn aad,
+                                                        BytesOut out) {
+    OUTCOME_TRY(ctx, context(true));
     size_t out_size = 0;
-    IF1(EVP_AEAD_CTX_seal(ctx.get(),
-                          result.data(),
+    // seal supports in-place operation when out and plaintext start together
+    IF1(EVP_AEAD_CTX_seal(ctx,
+                          out.data(),
                           &out_size,
-                          result.size(),
+                          out.size(),
                           nonce.data(),
                           nonce.size(),
                           plaintext.data(),
@@ -60,25 +83,19 @@ namespace libp2p::crypto::chachapoly {
                           aad.size()),
         "EVP_AEAD_CTX_seal",
         OpenSslError::FAILED_ENCRYPT_UPDATE);
-    result.resize(out_size);
-    return result;
+    return out_size;
   }
 
-  outcome::result<Bytes> ChaCha20Poly1305Impl::decrypt(const Nonce &nonce,
-                                                       BytesIn ciphertext,
-                                                       BytesIn aad) {
-    bssl::ScopedEVP_AEAD_CTX ctx;
-    OUTCOME_TRY(init(ctx.get(), false));
-    Bytes result;
-    // plain text should take less bytes than cipher text,
-    // at least it would not contain tag-length bytes (16).
-    // single block size for the case when len(in) == len(out)
-    result.resize(ciphertext.size());
+  outcome::result<size_t> ChaCha20Poly1305Impl::decrypt(const Nonce &nonce,
+                                                        BytesIn ciphertext,
+                                                        BytesIn aad,
+                                                        BytesOut out) {
+    OUTCOME_TRY(ctx, context(false));
     size_t out_size = 0;
-    IF1(EVP_AEAD_CTX_open(ctx.get(),
-                          result.data(),
+    IF1(EVP_AEAD_CTX_open(ctx,
+                          out.data(),
                           &out_size,
-                          result.size(),
+                          out.size(),
                           nonce.data(),
                           nonce.size(),
                           ciphertext.data(),
@@ -87,8 +104,7 @@ namespace libp2p::crypto::chachapoly {
                           aad.size()),
         "EVP_AEAD_CTX_open",
         OpenSslError::FAILED_DECRYPT_UPDATE);
-    result.resize(out_size);
-    return result;
+    return out_size;
   }
 
 }  // namespace libp2p::crypto::chachapoly
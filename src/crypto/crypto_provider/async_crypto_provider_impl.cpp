@@ -0,0 +1,120 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/crypto/crypto_provider/async_crypto_provider_impl.hpp>
+
+#include <atomic>
+#include <thread>
+
+#include <boost/asio/post.hpp>
+
+namespace libp2p::crypto {
+  namespace {
+    size_t threadsOf(const AsyncCryptoProviderImpl::Config &config) {
+      if (config.threads != 0) {
+        return config.threads;
+      }
+      return std::max<size_t>(1, std::thread::hardware_concurrency());
+    }
+  }  // namespace
+
+  AsyncCryptoProviderImpl::AsyncCryptoProviderImpl(
+      std::shared_ptr<CryptoProvider> crypto_provider,
+      std::shared_ptr<basic::Scheduler> scheduler,
+      Config config)
+      : crypto_provider_{std::move(crypto_provider)},
+        scheduler_{std::move(scheduler)},
+        config_{config},
+        pool_{threadsOf(config_)} {
+    if (config_.batch_chunk_size == 0) {
+      config_.batch_chunk_size = 1;
+    }
+  }
+
+  AsyncCryptoProviderImpl::~AsyncCryptoProviderImpl() {
+    pool_.stop();
+    pool_.join();
+  }
+
+  void AsyncCryptoProviderImpl::sign(Bytes message,
+                                     PrivateKey private_key,
+                                     SignCallback cb) {
+    boost::asio::post(pool_,
+                      [crypto_provider{crypto_provider_},
+                       scheduler{scheduler_},
+                       message{std::move(message)},
+                       private_key{std::move(private_key)},
+                       cb{std::move(cb)}]() mutable {
+                        auto res = crypto_provider->sign(message, private_key);
+                        scheduler->schedule(
+                            [res{std::move(res)}, cb{std::move(cb)}]() mutable {
+                              cb(std::move(res));
+                            });
+                      });
+  }
+
+  void AsyncCryptoProviderImpl::verify(Bytes message,
+                                       Bytes signature,
+                                       PublicKey public_key,
+                                       VerifyCallback cb) {
+    boost::asio::post(
+        pool_,
+        [crypto_provider{crypto_provider_},
+         scheduler{scheduler_},
+         message{std::move(message)},
+         signature{std::move(signature)},
+         public_key{std::move(public_key)},
+         cb{std::move(cb)}]() mutable {
+          auto res = crypto_provider->verify(message, signature, public_key);
+          scheduler->schedule([res, cb{std::move(cb)}] { cb(res); },
+                              basic::Scheduler::Priority::IO);
+        });
+  }
+
+  void AsyncCryptoProviderImpl::verifyBatch(std::vector<VerifyJob> jobs,
+                                            VerifyBatchCallback cb) {
+    if (jobs.empty()) {
+      return scheduler_->schedule([cb{std::move(cb)}] { cb({}); },
+                                  basic::Scheduler::Priority::IO);
+    }
+    struct Batch {
+      std::vector<VerifyJob> jobs;
+      std::vector<outcome::result<bool>> results;
+      std::atomic_size_t remaining;
+      VerifyBatchCallback cb;
+    };
+    auto chunk = config_.batch_chunk_size;
+    auto chunks = (jobs.size() + chunk - 1) / chunk;
+    auto batch = std::make_shared<Batch>();
+    batch->results.resize(jobs.size(), false);
+    batch->jobs = std::move(jobs);
+    batch->remaining = chunks;
+    batch->cb = std::move(cb);
+    for (size_t begin = 0; begin < batch->jobs.size(); begin += chunk) {
+      auto end = std::min(begin + chunk, batch->jobs.size());
+      boost::asio::post(pool_,
+                        [crypto_provider{crypto_provider_},
+                         scheduler{scheduler_},
+                         batch,
+                         begin,
+                         end] {
+                          for (auto i = begin; i < end; ++i) {
+                            auto &job = batch->jobs[i];
+                            batch->results[i] = crypto_provider->verify(
+                                job.message, job.signature, job.public_key);
+                          }
+                          if (batch->remaining.fetch_sub(1) != 1) {
+                            return;
+                          }
+                          scheduler->schedule(
+                              [batch] {
+                                batch->cb(std::move(batch->results));
+                              },
+                              basic::Scheduler::Priority::IO);
+                        });
+    }
+  }
+}  // namespace libp2p::crypto
@@ -51,11 +51,9 @@ namespace libp2p::crypto {
         rsa_provider_{std::move(rsa_provider)},
         ecdsa_provider_{std::move(ecdsa_provider)},
         secp256k1_provider_{std::move(secp256k1_provider)},
-        hmac_provider_{std::move(hmac_provider)} {
-    initialize();
-  }
+        hmac_provider_{std::move(hmac_provider)} {}
 
-  void CryptoProviderImpl::initialize() {
+  void CryptoProviderImpl::initialize() const {
     constexpr size_t kSeedBytesCount = 128 * 4;  // ripple uses such number
     auto bytes = random_provider_->randomBytes(kSeedBytesCount);
     // seeding random crypto_provider is required prior to calling
@@ -87,6 +85,7 @@ namespace libp2p::crypto {
 
   outcome::result<KeyPair> CryptoProviderImpl::generateRsa(
       common::RSAKeyType rsa_bitness) const {
+    std::call_once(initialized_, [this] { initialize(); });
     OUTCOME_TRY(rsa, rsa_provider_->generate(rsa_bitness));
 
     auto &&pub = rsa.public_key;
@@ -212,6 +211,40 @@ namespace libp2p::crypto {
     }
   }
 
+  namespace {
+    /// Key prepared by CryptoProviderImpl
+    struct Ed25519SigningKey : SigningKey {
+      std::shared_ptr<const ed25519::PreparedKey> prepared;
+    };
+  }  // namespace
+
+  outcome::result<std::shared_ptr<const SigningKey>>
+  CryptoProviderImpl::prepareSigningKey(const PrivateKey &private_key) const {
+    if (private_key.type != Key::Type::Ed25519) {
+      return CryptoProvider::prepareSigningKey(private_key);
+    }
+    ed25519::PrivateKey priv_key;
+    if (private_key.data.size() != priv_key.size()) {
+      return KeyValidatorError::WRONG_PRIVATE_KEY_SIZE;
+    }
+    std::copy_n(private_key.data.begin(), priv_key.size(), priv_key.begin());
+    OUTCOME_TRY(prepared, ed25519_provider_->prepare(priv_key));
+    auto key = std::make_shared<Ed25519SigningKey>();
+    key->private_key = private_key;
+    key->prepared = std::move(prepared);
+    return key;
+  }
+
+  outcome::result<Buffer> CryptoProviderImpl::sign(
+      BytesIn message, const SigningKey &key) const {
+    if (auto ed_key = dynamic_cast<const Ed25519SigningKey *>(&key)) {
+      OUTCOME_TRY(signature,
+                  ed25519_provider_->sign(message, *ed_key->prepared));
+      return {signature.begin(), signature.end()};
+    }
+    return sign(message, key.private_key);
+  }
+
   outcome::result<Buffer> CryptoProviderImpl::signRsa(
       BytesIn message, const PrivateKey &private_key) const {
     rsa::PrivateKey priv_key;
@@ -79,7 +79,9 @@ namespace libp2p::crypto::ecdsa {
       const PrehashedMessage &message,
       const Signature &signature,
       const PublicKey &public_key) const {
-    OUTCOME_TRY(ec_key, convertBytesToEcKey(public_key, d2i_EC_PUBKEY));
+    OUTCOME_TRY(ec_key, key_cache_.get(public_key, [&] {
+                  return convertBytesToEcKey(public_key, d2i_EC_PUBKEY);
+                }));
     OUTCOME_TRY(signature_status,
                 VerifyEcSignature(message, signature, ec_key));
     return signature_status;
@@ -11,11 +11,47 @@
 #include <libp2p/common/final_action.hpp>
 #include <libp2p/crypto/common_functions.hpp>
 #include <libp2p/crypto/error.hpp>
+#include <libp2p/crypto/verify_batch.hpp>
 
 namespace libp2p::crypto::ed25519 {
 
   using libp2p::common::FinalAction;
 
+  namespace {
+    /// Key prepared by Ed25519ProviderImpl
+    struct EvpPreparedKey : PreparedKey {
+      std::shared_ptr<EVP_PKEY> evp_pkey;
+    };
+
+    outcome::result<Signature> signWithKey(BytesIn message,
+                                           EVP_PKEY *evp_pkey) {
+      constexpr auto FAILED{CryptoProviderError::SIGNATURE_GENERATION_FAILED};
+
+      std::shared_ptr<EVP_MD_CTX> mctx{EVP_MD_CTX_new(), EVP_MD_CTX_free};
+      if (nullptr == mctx) {
+        return FAILED;
+      }
+
+      if (1
+          != EVP_DigestSignInit(
+              mctx.get(), nullptr, nullptr, nullptr, evp_pkey)) {
+        return FAILED;
+      }
+
+      Signature signature;
+      size_t signature_len{signature.size()};
+      if (1
+          != EVP_DigestSign(mctx.get(),
+                            signature.data(),
+                            &signature_len,
+                            message.data(),
+                            message.size())) {
+        return FAILED;
+      }
+      return signature;
+    }
+  }  // namespace
+
   outcome::result<Keypair> Ed25519ProviderImpl::generate() const {
     constexpr auto FAILED{KeyGeneratorError::KEY_GENERATION_FAILED};
 
@@ -75,30 +111,27 @@ namespace libp2p::crypto::ed25519 {
         evp_pkey,
         NewEvpPkeyFromBytes(
             EVP_PKEY_ED25519, private_key, EVP_PKEY_new_raw_private_key));
-    constexpr auto FAILED{CryptoProviderError::SIGNATURE_GENERATION_FAILED};
-
-    std::shared_ptr<EVP_MD_CTX> mctx{EVP_MD_CTX_new(), EVP_MD_CTX_free};
-    if (nullptr == mctx) {
-      return FAILED;
-    }
+    return signWithKey(message, evp_pkey.get());
+  }
 
-    if (1
-        != EVP_DigestSignInit(
-            mctx.get(), nullptr, nullptr, nullptr, evp_pkey.get())) {
-      return FAILED;
-    }
+  outcome::result<std::shared_ptr<const PreparedKey>>
+  Ed25519ProviderImpl::prepare(const PrivateKey &private_key) const {
+    OUTCOME_TRY(
+        evp_pkey,
+        NewEvpPkeyFromBytes(
+            EVP_PKEY_ED25519, private_key, EVP_PKEY_new_raw_private_key));
+    auto key = std::make_shared<EvpPreparedKey>();
+    key->private_key = private_key;
+    key->evp_pkey = std::move(evp_pkey);
+    return key;
+  }
 
-    Signature signature;
-    size_t signature_len{signature.size()};
-    if (1
-        != EVP_DigestSign(mctx.get(),
-                          signature.data(),
-                          &signature_len,
-                          message.data(),
-                          message.size())) {
-      return FAILED;
+  outcome::result<Signature> Ed25519ProviderImpl::sign(
+      BytesIn message, const PreparedKey &key) const {
+    if (auto evp_key = dynamic_cast<const EvpPreparedKey *>(&key)) {
+      return signWithKey(message, evp_key->evp_pkey.get());
     }
-    return signature;
+    return sign(message, key.private_key);
   }
 
   outcome::result<bool> Ed25519ProviderImpl::verify(
@@ -131,4 +164,11 @@ namespace libp2p::crypto::ed25519 {
 
     return FAILED;
   }
+
+  std::vector<outcome::result<bool>> Ed25519ProviderImpl::verifyBatch(
+      std::span<const VerifyJob> jobs) const {
+    return verifyBatchParallel(jobs, [this](const VerifyJob &job) {
+      return verify(job.message, job.signature, job.public_key);
+    });
+  }
 }  // namespace libp2p::crypto::ed25519
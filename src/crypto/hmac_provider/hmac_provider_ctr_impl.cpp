@@ -9,12 +9,9 @@
 #include <libp2p/crypto/hmac_provider/hmac_provider_ctr_impl.hpp>
 
 #include <openssl/hmac.h>
-#include <libp2p/common/final_action.hpp>
 #include <libp2p/crypto/error.hpp>
 #include <span>
 
-using libp2p::common::FinalAction;
-
 namespace libp2p::crypto::hmac {
 
   HmacProviderCtrImpl::HmacProviderCtrImpl(HashType hash_type, BytesIn key)
@@ -49,6 +46,9 @@ namespace libp2p::crypto::hmac {
 
   HmacProviderCtrImpl::~HmacProviderCtrImpl() {
     sinkCtx(HmacProviderCtrImpl::digestSize());
+    if (nullptr != digest_ctx_) {
+      HMAC_CTX_free(digest_ctx_);
+    }
   }
 
   outcome::result<void> HmacProviderCtrImpl::write(BytesIn data) {
@@ -68,16 +68,14 @@ namespace libp2p::crypto::hmac {
     if (out.size() != digestSize()) {
       return HmacProviderError::WRONG_DIGEST_SIZE;
     }
-    HMAC_CTX *ctx_copy = HMAC_CTX_new();
-    if (nullptr == ctx_copy) {
+    if (nullptr == digest_ctx_ and nullptr == (digest_ctx_ = HMAC_CTX_new())) {
       return HmacProviderError::FAILED_INITIALIZE_CONTEXT;
     }
-    if (1 != HMAC_CTX_copy(ctx_copy, hmac_ctx_)) {
+    if (1 != HMAC_CTX_copy(digest_ctx_, hmac_ctx_)) {
       return HmacProviderError::FAILED_INITIALIZE_CONTEXT;
     }
-    FinalAction free_ctx_copy([ctx_copy] { HMAC_CTX_free(ctx_copy); });
     unsigned len{0};
-    if (1 != HMAC_Final(ctx_copy, out.data(), &len)) {
+    if (1 != HMAC_Final(digest_ctx_, out.data(), &len)) {
       return HmacProviderError::FAILED_FINALIZE_DIGEST;
     }
     if (len != digestSize()) {
@@ -87,6 +85,11 @@ namespace libp2p::crypto::hmac {
   }
 
   outcome::result<void> HmacProviderCtrImpl::reset() {
+    // restart with the same key and hash, keeping the context
+    if (initialized_
+        and 1 == HMAC_Init_ex(hmac_ctx_, nullptr, 0, nullptr, nullptr)) {
+      return outcome::success();
+    }
     sinkCtx(digestSize());
     hmac_ctx_ = HMAC_CTX_new();
     if (nullptr == hmac_ctx_
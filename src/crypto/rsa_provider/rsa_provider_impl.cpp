@@ -156,19 +156,7 @@ namespace libp2p::crypto::rsa {
       BytesIn message,
       const Signature &signature,
       const PublicKey &public_key) const {
-    OUTCOME_TRY(x509_key, RsaProviderImpl::getPublicKeyFromBytes(public_key));
-
-    EVP_PKEY *key = X509_PUBKEY_get(x509_key.get());
-    if (!key) {
-      return CryptoProviderError::SIGNATURE_VERIFICATION_FAILED;
-    }
-    std::unique_ptr<EVP_PKEY, decltype(&EVP_PKEY_free)> key_ptr{key,
-                                                                EVP_PKEY_free};
-    std::unique_ptr<RSA, decltype(&RSA_free)> rsa{
-        EVP_PKEY_get1_RSA(key_ptr.get()), RSA_free};
-    if (!rsa) {
-      return CryptoProviderError::SIGNATURE_VERIFICATION_FAILED;
-    }
+    OUTCOME_TRY(rsa, verificationKey(public_key));
 
     OUTCOME_TRY(digest, sha256(message));
     int result = RSA_verify(NID_sha256,
@@ -191,4 +179,24 @@ namespace libp2p::crypto::rsa {
     return std::shared_ptr<X509_PUBKEY>{key_ptr, X509_PUBKEY_free};
   }
 
+  outcome::result<std::shared_ptr<RSA>> RsaProviderImpl::verificationKey(
+      const PublicKey &public_key) const {
+    return key_cache_.get(
+        public_key, [&]() -> outcome::result<std::shared_ptr<RSA>> {
+          OUTCOME_TRY(x509_key, getPublicKeyFromBytes(public_key));
+
+          EVP_PKEY *key = X509_PUBKEY_get(x509_key.get());
+          if (!key) {
+            return CryptoProviderError::SIGNATURE_VERIFICATION_FAILED;
+          }
+          std::unique_ptr<EVP_PKEY, decltype(&EVP_PKEY_free)> key_ptr{
+              key, EVP_PKEY_free};
+          std::shared_ptr<RSA> rsa{EVP_PKEY_get1_RSA(key_ptr.get()), RSA_free};
+          if (!rsa) {
+            return CryptoProviderError::SIGNATURE_VERIFICATION_FAILED;
+          }
+          return rsa;
+        });
+  }
+
 };  // namespace libp2p::crypto::rsa
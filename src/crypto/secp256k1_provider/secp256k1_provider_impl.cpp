@@ -8,6 +8,7 @@
 #include <libp2p/crypto/error.hpp>
 #include <libp2p/crypto/random_generator.hpp>
 #include <libp2p/crypto/sha/sha256.hpp>
+#include <libp2p/crypto/verify_batch.hpp>
 
 namespace libp2p::crypto::secp256k1 {
   Secp256k1ProviderImpl::Secp256k1ProviderImpl(
@@ -77,11 +78,17 @@ namespace libp2p::crypto::secp256k1 {
   outcome::result<bool> Secp256k1ProviderImpl::verify(
       BytesIn message, const Signature &signature, const PublicKey &key) const {
     OUTCOME_TRY(digest, sha256(message));
-    secp256k1_pubkey ffi_pub;
-    if (secp256k1_ec_pubkey_parse(ctx_.get(), &ffi_pub, key.data(), key.size())
-        == 0) {
-      return CryptoProviderError::SIGNATURE_VERIFICATION_FAILED;
-    }
+    OUTCOME_TRY(
+        ffi_pub,
+        key_cache_.get(key, [&]() -> outcome::result<secp256k1_pubkey> {
+          secp256k1_pubkey parsed;
+          if (secp256k1_ec_pubkey_parse(
+                  ctx_.get(), &parsed, key.data(), key.size())
+              == 0) {
+            return CryptoProviderError::SIGNATURE_VERIFICATION_FAILED;
+          }
+          return parsed;
+        }));
     secp256k1_ecdsa_signature ffi_sig;
     if (secp256k1_ecdsa_signature_parse_der(
             ctx_.get(), &ffi_sig, signature.data(), signature.size())
@@ -91,4 +98,11 @@ namespace libp2p::crypto::secp256k1 {
     return secp256k1_ecdsa_verify(ctx_.get(), &ffi_sig, digest.data(), &ffi_pub)
         == 1;
   }
+
+  std::vector<outcome::result<bool>> Secp256k1ProviderImpl::verifyBatch(
+      std::span<const VerifyJob> jobs) const {
+    return verifyBatchParallel(jobs, [this](const VerifyJob &job) {
+      return verify(job.message, job.signature, job.public_key);
+    });
+  }
 }  // namespace libp2p::crypto::secp256k1
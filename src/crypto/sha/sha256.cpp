@@ -8,6 +8,7 @@
 
 #include <libp2p/crypto/sha/sha256.hpp>
 
+#include <boost/assert.hpp>
 #include <openssl/sha.h>
 #include <libp2p/crypto/error.hpp>
 
@@ -75,10 +76,22 @@ namespace libp2p::crypto {
   }
 
   outcome::result<libp2p::common::Hash256> sha256(BytesIn input) {
-    Sha256 sha;
-    OUTCOME_TRY(sha.write(input));
-    outcome::result<libp2p::common::Hash256> result{outcome::success()};
-    OUTCOME_TRY(sha.digestOut(result.value()));
+    // one-shot function skips context setup and teardown, and like the
+    // context it uses SHA extensions of CPU where available
+    libp2p::common::Hash256 result;
+    if (nullptr == SHA256(input.data(), input.size(), result.data())) {
+      return HmacProviderError::FAILED_FINALIZE_DIGEST;
+    }
     return result;
   }
+
+  void sha256Batch(std::span<const BytesIn> inputs,
+                   std::span<libp2p::common::Hash256> out) {
+    BOOST_ASSERT(inputs.size() == out.size());
+    // OpenSSL has no public multi-buffer SHA-256, so inputs are hashed one
+    // by one with hardware accelerated one-shot hashing
+    for (size_t i = 0; i < inputs.size(); ++i) {
+      SHA256(inputs[i].data(), inputs[i].size(), out[i].data());
+    }
+  }
 }  // namespace libp2p::crypto
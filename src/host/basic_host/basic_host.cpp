@@ -6,7 +6,10 @@
 
 #include <libp2p/host/basic_host/basic_host.hpp>
 
+#include <algorithm>
+
 #include <boost/assert.hpp>
+#include <libp2p/common/metrics/tracing.hpp>
 #include <libp2p/crypto/key_marshaller/key_marshaller_impl.hpp>
 
 namespace libp2p::host {
@@ -18,6 +21,22 @@ namespace libp2p::host {
       std::shared_ptr<event::Bus> bus,
       std::shared_ptr<network::TransportManager> transport_manager,
       Libp2pClientVersion libp2p_client_version)
+      : BasicHost{std::move(idmgr),
+                  std::move(network),
+                  std::move(repo),
+                  std::move(bus),
+                  std::move(transport_manager),
+                  std::move(libp2p_client_version),
+                  nullptr} {}
+
+  BasicHost::BasicHost(
+      std::shared_ptr<peer::IdentityManager> idmgr,
+      std::unique_ptr<network::Network> network,
+      std::unique_ptr<peer::PeerRepository> repo,
+      std::shared_ptr<event::Bus> bus,
+      std::shared_ptr<network::TransportManager> transport_manager,
+      Libp2pClientVersion libp2p_client_version,
+      std::shared_ptr<basic::Scheduler> scheduler)
       : idmgr_{std::move(idmgr)},
         network_{std::move(network)},
         repo_{std::move(repo)},
@@ -29,6 +48,24 @@ namespace libp2p::host {
     BOOST_ASSERT(repo_ != nullptr);
     BOOST_ASSERT(bus_ != nullptr);
     BOOST_ASSERT(transport_manager_ != nullptr);
+    reachability_sub_ =
+        bus_->getChannel<event::network::AddressReachabilityChannel>()
+            .subscribe([this](const network::AddressReachability &r) {
+              if (r.reachability == network::Reachability::UNKNOWN) {
+                reachability_.erase(r.address);
+              } else {
+                reachability_.insert_or_assign(r.address, r.reachability);
+              }
+            });
+    disconnected_sub_ =
+        bus_->getChannel<event::network::OnPeerDisconnectedChannel>()
+            .subscribe([this](const peer::PeerId &peer_id) {
+              broadcast_streams_->remove(peer_id);
+            });
+    if (scheduler) {
+      keep_warm_ = std::make_shared<KeepWarm>(
+          *network_, *bus_, std::move(scheduler), KeepWarm::Config{});
+    }
   }
 
   std::string_view BasicHost::getLibp2pVersion() const {
@@ -83,6 +120,21 @@ namespace libp2p::host {
         std::make_move_iterator(unique_addresses.begin()),
         std::make_move_iterator(unique_addresses.end()));
 
+    if (not reachability_.empty()) {
+      auto reachability = [&](const multi::Multiaddress &addr) {
+        auto it = reachability_.find(addr);
+        return it == reachability_.end() ? network::Reachability::UNKNOWN
+                                         : it->second;
+      };
+      std::erase_if(unique_addr_list, [&](const multi::Multiaddress &addr) {
+        return reachability(addr) == network::Reachability::PRIVATE;
+      });
+      std::ranges::stable_partition(
+          unique_addr_list, [&](const multi::Multiaddress &addr) {
+            return reachability(addr) == network::Reachability::PUBLIC;
+          });
+    }
+
     return {getId(), std::move(unique_addr_list)};
   }
 
@@ -118,13 +170,10 @@ namespace libp2p::host {
       }
     }
 
-    auto res = repo_->getAddressRepository().getAddresses(p.id);
-    if (res.has_value()) {
-      for (auto &&ma : res.value()) {
-        if (auto tr = transport_manager_->findBest(ma); tr != nullptr) {
-          // we can dial to the peer
-          return Connectedness::CAN_CONNECT;
-        }
+    for (auto &&ma : repo_->getAddressRepository().peekAddresses(p.id)) {
+      if (auto tr = transport_manager_->findBest(ma); tr != nullptr) {
+        // we can dial to the peer
+        return Connectedness::CAN_CONNECT;
       }
     }
 
@@ -142,6 +191,55 @@ namespace libp2p::host {
   void BasicHost::newStream(const peer::PeerInfo &peer_info,
                             StreamProtocols protocols,
                             StreamAndProtocolOrErrorCb cb) {
+    if (metrics::Span span{"libp2p.new_stream"}) {
+      span.setAttribute("peer", peer_info.id.toBase58());
+      std::string names;
+      for (auto &protocol : protocols) {
+        names += names.empty() ? "" : " ";
+        names += protocol;
+      }
+      span.setAttribute("protocols", names);
+      cb = [span, cb{std::move(cb)}](StreamAndProtocolOrError r) {
+        if (r) {
+          span.setAttribute("protocol", r.value().protocol);
+        }
+        span.end(r.has_value() ? std::error_code{} : r.error());
+        cb(std::move(r));
+      };
+    }
+    if (keep_warm_) {
+      if (auto warm = keep_warm_->takeStream(peer_info.id, protocols)) {
+        return cb(std::move(warm.value()));
+      }
+    }
+    if (auto striped = striped_.find(peer_info.id);
+        striped != striped_.end()
+        and std::ranges::any_of(protocols, [&](const auto &protocol) {
+              return std::ranges::find(striped->second, protocol)
+                  != striped->second.end();
+            })) {
+      if (auto conn =
+              network_->getConnectionManager().getStripedConnection(
+                  peer_info.id)) {
+        return network_->getDialer().newStream(
+            std::move(conn), std::move(protocols), std::move(cb));
+      }
+    }
+    // protocol confirmed by peer (e.g. with identify) is negotiated without
+    // waiting for reply
+    auto supported = repo_->getProtocolRepository().supportsProtocols(
+        peer_info.id, {protocols.begin(), protocols.end()});
+    if (supported and not supported.value().empty()) {
+      for (auto &protocol : protocols) {
+        if (std::find(supported.value().begin(),
+                      supported.value().end(),
+                      protocol)
+            != supported.value().end()) {
+          return network_->getDialer().newStreamLazy(
+              peer_info, protocol, std::move(cb));
+        }
+      }
+    }
     network_->getDialer().newStream(
         peer_info, std::move(protocols), std::move(cb));
   }
@@ -213,6 +311,61 @@ namespace libp2p::host {
     network_->getDialer().dial(peer_info, handler);
   }
 
+  void BasicHost::stripeConnections(const peer::PeerInfo &peer_info,
+                                    size_t connections,
+                                    StreamProtocols protocols,
+                                    const ConnectionResultHandler &handler) {
+    auto &cmgr = network_->getConnectionManager();
+    cmgr.setStripe(peer_info.id, connections);
+    if (connections < 2) {
+      striped_.erase(peer_info.id);
+      return connect(peer_info, handler);
+    }
+    striped_.insert_or_assign(peer_info.id, std::move(protocols));
+    auto existing = std::max<size_t>(
+        cmgr.getConnectionsToPeer(peer_info.id).size(), 1);
+    auto &dialer = network_->getDialer();
+    dialer.dial(peer_info, handler);
+    // missing connections are dialed at once, not after the first one
+    for (auto i = existing; i < connections; ++i) {
+      dialer.dialAnother(peer_info, [](ConnectionResult) {});
+    }
+  }
+
+  void BasicHost::keepWarm(const peer::PeerInfo &peer_info,
+                           StreamProtocols protocols) {
+    if (not keep_warm_) {
+      return connect(peer_info, [](ConnectionResult) {});
+    }
+    keep_warm_->add(peer_info, std::move(protocols));
+  }
+
+  void BasicHost::stopKeepWarm(const peer::PeerId &peer_id) {
+    if (keep_warm_) {
+      keep_warm_->remove(peer_id);
+    }
+  }
+
+  void BasicHost::broadcast(StreamProtocols protocols,
+                            std::shared_ptr<const Bytes> payload,
+                            std::vector<peer::PeerInfo> peers,
+                            BroadcastConfig config,
+                            BroadcastHandler handler) {
+    std::make_shared<Broadcast>(
+        *this,
+        config.keep_streams ? broadcast_streams_ : nullptr,
+        std::move(protocols),
+        std::move(payload),
+        std::move(peers),
+        config.max_streams,
+        std::move(handler))
+        ->start();
+  }
+
+  std::vector<metrics::MemoryUsageEntry> BasicHost::dumpMemoryUsage() const {
+    return metrics::dumpMemoryUsage();
+  }
+
   void BasicHost::disconnect(const peer::PeerId &peer_id) {
     network_->closeConnections(peer_id);
   }
@@ -0,0 +1,152 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/host/basic_host/bootstrap.hpp>
+
+#include <algorithm>
+
+#include <boost/assert.hpp>
+
+namespace libp2p::host {
+
+  Bootstrap::Bootstrap(Host &host,
+                       std::shared_ptr<network::DnsaddrResolver> resolver,
+                       std::shared_ptr<basic::Scheduler> scheduler,
+                       Config config)
+      : host_{host},
+        resolver_{std::move(resolver)},
+        scheduler_{std::move(scheduler)},
+        config_{config} {
+    BOOST_ASSERT(resolver_ != nullptr);
+    BOOST_ASSERT(config_.max_dials != 0);
+  }
+
+  void Bootstrap::start(std::vector<multi::Multiaddress> addresses,
+                        PeerHandler on_peer,
+                        ReadyHandler on_ready) {
+    on_peer_ = std::move(on_peer);
+    on_ready_ = std::move(on_ready);
+    if (scheduler_ and config_.timeout != config_.timeout.zero()) {
+      timeout_ = scheduler_->scheduleWithHandle(
+          [weak{weak_from_this()}] {
+            if (auto self = weak.lock()) {
+              self->ready();
+            }
+          },
+          config_.timeout);
+    }
+    // resolver may complete synchronously, so that readyIfDone() must not
+    // complete before all addresses are added
+    ++resolving_;
+    for (auto &address : addresses) {
+      add(address, 0);
+    }
+    --resolving_;
+    dialNext();
+    readyIfDone();
+  }
+
+  void Bootstrap::add(const multi::Multiaddress &address, size_t depth) {
+    if (address.hasProtocol(multi::Protocol::Code::DNS_ADDR)) {
+      resolve(address, depth);
+      return;
+    }
+    auto peer_id_str = address.getPeerId();
+    if (not peer_id_str) {
+      return;
+    }
+    auto peer_id_res = peer::PeerId::fromBase58(peer_id_str.value());
+    if (not peer_id_res) {
+      return;
+    }
+    auto &peer_id = peer_id_res.value();
+    if (dialed_.contains(peer_id)) {
+      return;
+    }
+    auto [it, inserted] = candidates_.try_emplace(peer_id);
+    if (inserted) {
+      queue_.emplace_back(peer_id);
+    }
+    if (std::ranges::find(it->second, address) == it->second.end()) {
+      it->second.emplace_back(address);
+    }
+  }
+
+  void Bootstrap::resolve(const multi::Multiaddress &address, size_t depth) {
+    if (depth >= config_.max_dnsaddr_depth
+        or not resolved_.emplace(address).second) {
+      return;
+    }
+    ++resolving_;
+    resolver_->load(
+        address,
+        [self{shared_from_this()}, expected{address.getPeerId()}, depth](
+            outcome::result<std::vector<multi::Multiaddress>> result) {
+          --self->resolving_;
+          if (result) {
+            for (auto &resolved : result.value()) {
+              // /dnsaddr/<host>/p2p/<id> resolves only to addresses of <id>
+              if (expected and resolved.getPeerId() != expected) {
+                continue;
+              }
+              self->add(resolved, depth + 1);
+            }
+          }
+          self->dialNext();
+          self->readyIfDone();
+        });
+  }
+
+  void Bootstrap::dialNext() {
+    while (dialing_ < config_.max_dials and not queue_.empty()) {
+      auto node = candidates_.extract(queue_.front());
+      queue_.pop_front();
+      peer::PeerInfo peer_info{
+          .id = std::move(node.key()),
+          .addresses = std::move(node.mapped()),
+      };
+      dialed_.emplace(peer_info.id);
+      ++dialing_;
+      host_.connect(
+          peer_info,
+          [self{shared_from_this()}, peer_info](Host::ConnectionResult result) {
+            --self->dialing_;
+            if (result) {
+              ++self->connected_;
+              if (self->on_peer_) {
+                self->on_peer_(peer_info);
+              }
+              if (self->connected_ == self->config_.ready_after) {
+                self->ready();
+              }
+            }
+            self->dialNext();
+            self->readyIfDone();
+          });
+    }
+  }
+
+  void Bootstrap::readyIfDone() {
+    if (resolving_ == 0 and dialing_ == 0 and queue_.empty()) {
+      ready();
+    }
+  }
+
+  void Bootstrap::ready() {
+    if (not on_ready_) {
+      return;
+    }
+    timeout_.reset();
+    auto on_ready = std::move(on_ready_);
+    on_ready_ = nullptr;
+    if (connected_ == 0) {
+      on_ready(make_error_code(std::errc::host_unreachable));
+      return;
+    }
+    on_ready(connected_);
+  }
+
+}  // namespace libp2p::host
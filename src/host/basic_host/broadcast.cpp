@@ -0,0 +1,152 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/host/basic_host/broadcast.hpp>
+
+#include <boost/assert.hpp>
+#include <libp2p/basic/write.hpp>
+#include <libp2p/connection/stream.hpp>
+
+namespace libp2p::host {
+
+  std::optional<StreamAndProtocol> BroadcastStreams::take(
+      const peer::PeerId &peer_id, const StreamProtocols &protocols) {
+    auto it = streams_.find(peer_id);
+    if (it == streams_.end()) {
+      return std::nullopt;
+    }
+    auto &streams = it->second;
+    std::optional<StreamAndProtocol> result;
+    for (auto &protocol : protocols) {
+      auto node = streams.extract(protocol);
+      if (not node) {
+        continue;
+      }
+      // peer may have closed stream while it was kept
+      auto &stream = node.mapped();
+      if (not stream->isClosed() and not stream->isClosedForWrite()) {
+        result = StreamAndProtocol{std::move(stream), protocol};
+        break;
+      }
+    }
+    if (streams.empty()) {
+      streams_.erase(it);
+    }
+    return result;
+  }
+
+  void BroadcastStreams::put(const peer::PeerId &peer_id,
+                             StreamAndProtocol stream) {
+    auto &kept = streams_[peer_id][stream.protocol];
+    if (kept != nullptr and kept != stream.stream) {
+      // concurrent broadcasts opened two streams
+      kept->close([](outcome::result<void>) {});
+    }
+    kept = std::move(stream.stream);
+  }
+
+  void BroadcastStreams::remove(const peer::PeerId &peer_id) {
+    streams_.erase(peer_id);
+  }
+
+  Broadcast::Broadcast(Host &host,
+                       std::shared_ptr<BroadcastStreams> streams,
+                       StreamProtocols protocols,
+                       std::shared_ptr<const Bytes> payload,
+                       std::vector<peer::PeerInfo> peers,
+                       size_t max_streams,
+                       Host::BroadcastHandler handler)
+      : host_{host},
+        streams_{std::move(streams)},
+        protocols_{std::move(protocols)},
+        payload_{std::move(payload)},
+        peers_{std::move(peers)},
+        max_streams_{max_streams},
+        handler_{std::move(handler)} {
+    BOOST_ASSERT(payload_ != nullptr);
+    BOOST_ASSERT(max_streams_ != 0);
+    BOOST_ASSERT(handler_);
+    result_.peers.reserve(peers_.size());
+    for (auto &peer : peers_) {
+      // replaced when peer is done
+      result_.peers.emplace_back(
+          peer.id, make_error_code(std::errc::operation_in_progress));
+    }
+  }
+
+  void Broadcast::start() {
+    started_ = std::chrono::steady_clock::now();
+    if (peers_.empty()) {
+      return handler_(std::move(result_));
+    }
+    sendNext();
+  }
+
+  void Broadcast::sendNext() {
+    while (inflight_ < max_streams_ and next_ < peers_.size()) {
+      auto i = next_++;
+      ++inflight_;
+      if (streams_) {
+        if (auto kept = streams_->take(peers_[i].id, protocols_)) {
+          send(i, std::move(kept.value()), true);
+          continue;
+        }
+      }
+      open(i);
+    }
+  }
+
+  void Broadcast::open(size_t i) {
+    host_.newStream(peers_[i],
+                    protocols_,
+                    [self{shared_from_this()}, i](StreamAndProtocolOrError r) {
+                      if (not r) {
+                        return self->sent(i, r.error());
+                      }
+                      self->send(i, std::move(r.value()), false);
+                    });
+  }
+
+  void Broadcast::send(size_t i, StreamAndProtocol stream, bool kept) {
+    BytesIn bytes{*payload_};
+    // payload is kept alive by this until write completes
+    auto writer = stream.stream;
+    libp2p::write(
+        writer,
+        bytes,
+        [self{shared_from_this()}, i, stream{std::move(stream)}, kept](
+            outcome::result<void> res) mutable {
+          if (not res) {
+            stream.stream->reset();
+            if (kept) {
+              // kept stream could be closed by peer meanwhile
+              return self->open(i);
+            }
+            return self->sent(i, res.error());
+          }
+          if (self->streams_) {
+            self->streams_->put(self->peers_[i].id, std::move(stream));
+          } else {
+            stream.stream->close([](outcome::result<void>) {});
+          }
+          self->sent(i, outcome::success());
+        });
+  }
+
+  void Broadcast::sent(size_t i, outcome::result<void> result) {
+    BOOST_ASSERT(inflight_ != 0);
+    --inflight_;
+    ++done_;
+    result_.peers[i].second = result;
+    if (done_ == peers_.size()) {
+      result_.latency = std::chrono::duration_cast<std::chrono::microseconds>(
+          std::chrono::steady_clock::now() - started_);
+      return handler_(std::move(result_));
+    }
+    sendNext();
+  }
+
+}  // namespace libp2p::host
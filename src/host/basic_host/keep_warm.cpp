@@ -0,0 +1,232 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/host/basic_host/keep_warm.hpp>
+
+#include <algorithm>
+
+#include <boost/assert.hpp>
+#include <libp2p/connection/stream.hpp>
+
+namespace libp2p::host {
+
+  namespace {
+    /// Tag of connection manager protection
+    constexpr auto kProtectTag = "keep-warm";
+  }  // namespace
+
+  KeepWarm::KeepWarm(network::Network &network,
+                     event::Bus &bus,
+                     std::shared_ptr<basic::Scheduler> scheduler,
+                     Config config)
+      : network_{network},
+        scheduler_{std::move(scheduler)},
+        config_{config} {
+    BOOST_ASSERT(scheduler_ != nullptr);
+    connection_sub_ =
+        bus.getChannel<event::network::OnNewConnectionChannel>().subscribe(
+            [this](std::weak_ptr<connection::CapableConnection> weak) {
+              if (auto conn = weak.lock()) {
+                onConnection(conn);
+              }
+            });
+    disconnected_sub_ =
+        bus.getChannel<event::network::OnPeerDisconnectedChannel>().subscribe(
+            [this](const peer::PeerId &peer_id) { onDisconnected(peer_id); });
+  }
+
+  KeepWarm::~KeepWarm() {
+    auto &cmgr = network_.getConnectionManager();
+    for (auto &[peer_id, peer] : peers_) {
+      cmgr.unprotect(peer_id, kProtectTag);
+    }
+  }
+
+  void KeepWarm::add(const peer::PeerInfo &peer_info,
+                     StreamProtocols protocols) {
+    auto it = peers_.find(peer_info.id);
+    auto inserted = it == peers_.end();
+    if (inserted) {
+      it = peers_.emplace(peer_info.id, Peer{.info = peer_info}).first;
+    }
+    auto &peer = it->second;
+    peer.info = peer_info;
+    peer.protocols = std::move(protocols);
+    std::erase_if(peer.streams, [&](auto &p) {
+      if (std::ranges::find(peer.protocols, p.first) != peer.protocols.end()) {
+        return false;
+      }
+      p.second->close([](outcome::result<void>) {});
+      return true;
+    });
+    if (inserted) {
+      network_.getConnectionManager().protect(peer_info.id, kProtectTag);
+      setCloseWhenIdle(peer_info.id, false);
+    }
+    dial(peer_info.id);
+  }
+
+  void KeepWarm::remove(const peer::PeerId &peer_id) {
+    auto it = peers_.find(peer_id);
+    if (it == peers_.end()) {
+      return;
+    }
+    auto peer = std::move(it->second);
+    peers_.erase(it);
+    network_.getConnectionManager().unprotect(peer_id, kProtectTag);
+    setCloseWhenIdle(peer_id, true);
+    for (auto &[_, stream] : peer.streams) {
+      stream->close([](outcome::result<void>) {});
+    }
+  }
+
+  bool KeepWarm::contains(const peer::PeerId &peer_id) const {
+    return peers_.contains(peer_id);
+  }
+
+  std::optional<StreamAndProtocol> KeepWarm::takeStream(
+      const peer::PeerId &peer_id, const StreamProtocols &protocols) {
+    auto it = peers_.find(peer_id);
+    if (it == peers_.end()) {
+      return std::nullopt;
+    }
+    auto &streams = it->second.streams;
+    std::optional<StreamAndProtocol> result;
+    for (auto &protocol : protocols) {
+      auto node = streams.extract(protocol);
+      if (not node) {
+        continue;
+      }
+      // peer may have closed stream while it was waiting
+      auto &stream = node.mapped();
+      if (not stream->isClosed() and not stream->isClosedForWrite()) {
+        result = StreamAndProtocol{std::move(stream), protocol};
+        break;
+      }
+    }
+    openStreams(peer_id);
+    return result;
+  }
+
+  void KeepWarm::onConnection(
+      const std::shared_ptr<connection::CapableConnection> &conn) {
+    auto peer_id = conn->remotePeer();
+    if (not peer_id) {
+      return;
+    }
+    auto it = peers_.find(peer_id.value());
+    if (it == peers_.end()) {
+      return;
+    }
+    conn->setCloseWhenIdle(false);
+    it->second.retry = {};
+    it->second.redial.reset();
+    openStreams(peer_id.value());
+  }
+
+  void KeepWarm::onDisconnected(const peer::PeerId &peer_id) {
+    auto it = peers_.find(peer_id);
+    if (it == peers_.end()) {
+      return;
+    }
+    // streams were closed with connections
+    it->second.streams.clear();
+    dial(peer_id);
+  }
+
+  void KeepWarm::dial(const peer::PeerId &peer_id) {
+    auto &peer = peers_.at(peer_id);
+    if (peer.dialing) {
+      return;
+    }
+    peer.dialing = true;
+    peer.redial.reset();
+    network_.getDialer().dial(
+        peer.info,
+        [weak{weak_from_this()}, peer_id](
+            outcome::result<std::shared_ptr<connection::CapableConnection>>
+                r) {
+          if (auto self = weak.lock()) {
+            self->onDialed(peer_id, r.has_value());
+          }
+        });
+  }
+
+  void KeepWarm::onDialed(const peer::PeerId &peer_id, bool success) {
+    auto it = peers_.find(peer_id);
+    if (it == peers_.end()) {
+      return;
+    }
+    auto &peer = it->second;
+    peer.dialing = false;
+    if (success) {
+      peer.retry = {};
+      openStreams(peer_id);
+      return;
+    }
+    peer.retry = peer.retry == peer.retry.zero()
+                   ? config_.retry_base
+                   : std::min(peer.retry * 2, config_.retry_max);
+    peer.redial = scheduler_->scheduleWithHandle(
+        [weak{weak_from_this()}, peer_id] {
+          if (auto self = weak.lock(); self and self->contains(peer_id)) {
+            self->dial(peer_id);
+          }
+        },
+        peer.retry);
+  }
+
+  void KeepWarm::openStreams(const peer::PeerId &peer_id) {
+    auto &peer = peers_.at(peer_id);
+    for (auto &protocol : peer.protocols) {
+      if (peer.streams.contains(protocol)
+          or not peer.opening.emplace(protocol).second) {
+        continue;
+      }
+      network_.getDialer().newStream(
+          peer.info,
+          {protocol},
+          [weak{weak_from_this()}, peer_id, protocol](
+              StreamAndProtocolOrError r) {
+            if (auto self = weak.lock()) {
+              return self->onStream(peer_id, protocol, std::move(r));
+            }
+            if (r) {
+              r.value().stream->close([](outcome::result<void>) {});
+            }
+          });
+    }
+  }
+
+  void KeepWarm::onStream(const peer::PeerId &peer_id,
+                          const peer::ProtocolName &protocol,
+                          StreamAndProtocolOrError r) {
+    auto it = peers_.find(peer_id);
+    if (it != peers_.end()) {
+      it->second.opening.erase(protocol);
+    }
+    if (not r) {
+      // retried with the next connection or taken stream
+      return;
+    }
+    if (it == peers_.end()
+        or std::ranges::find(it->second.protocols, protocol)
+               == it->second.protocols.end()) {
+      r.value().stream->close([](outcome::result<void>) {});
+      return;
+    }
+    it->second.streams.insert_or_assign(protocol,
+                                        std::move(r.value().stream));
+  }
+
+  void KeepWarm::setCloseWhenIdle(const peer::PeerId &peer_id, bool close) {
+    for (auto &conn :
+         network_.getConnectionManager().getConnectionsToPeer(peer_id)) {
+      conn->setCloseWhenIdle(close);
+    }
+  }
+
+}  // namespace libp2p::host
@@ -13,10 +13,12 @@ namespace libp2p::layer {
 
   WsAdaptor::WsAdaptor(std::shared_ptr<basic::Scheduler> scheduler,
                        std::shared_ptr<boost::asio::io_context> io_context,
-                       WsConnectionConfig config)
+                       WsConnectionConfig config,
+                       std::shared_ptr<connection::ConnectionHealth> health)
       : scheduler_(std::move(scheduler)),
         io_context_(std::move(io_context)),
-        config_(std::move(config)) {
+        config_(std::move(config)),
+        health_(std::move(health)) {
     BOOST_ASSERT(scheduler_ != nullptr);
   }
 
@@ -29,7 +31,7 @@ namespace libp2p::layer {
       LayerAdaptor::LayerConnCallbackFunc cb) const {
     log_->info("upgrade inbound connection to websocket");
     auto ws = std::make_shared<connection::WsConnection>(
-        config_, io_context_, std::move(conn), scheduler_);
+        config_, io_context_, std::move(conn), scheduler_, health_);
     ws->ws_.async_accept(
         [=, cb{std::move(cb)}](boost::system::error_code ec) mutable {
           if (ec) {
@@ -46,7 +48,7 @@ namespace libp2p::layer {
       LayerAdaptor::LayerConnCallbackFunc cb) const {
     auto host = address.getProtocolsWithValues().begin()->second;
     auto ws = std::make_shared<connection::WsConnection>(
-        config_, io_context_, std::move(conn), scheduler_);
+        config_, io_context_, std::move(conn), scheduler_, health_);
     ws->ws_.async_handshake(
         host,
         "/",
@@ -18,14 +18,22 @@ namespace libp2p::connection {
       layer::WsConnectionConfig config,
       std::shared_ptr<boost::asio::io_context> io_context,
       std::shared_ptr<LayerConnection> connection,
-      std::shared_ptr<basic::Scheduler> scheduler)
+      std::shared_ptr<basic::Scheduler> scheduler,
+      std::shared_ptr<ConnectionHealth> health)
       : config_(std::move(config)),
         connection_(std::move(connection)),
         ws_(AsAsioReadWrite{std::move(io_context), connection_}),
-        scheduler_(std::move(scheduler)) {
+        scheduler_(std::move(scheduler)),
+        health_(std::move(health)) {
     BOOST_ASSERT(connection_ != nullptr);
     BOOST_ASSERT(scheduler_ != nullptr);
     ws_.binary(true);
+    ws_.auto_fragment(config_.auto_fragment);
+    ws_.write_buffer_bytes(config_.write_buffer_bytes);
+    boost::beast::websocket::permessage_deflate deflate;
+    deflate.client_enable = config_.permessage_deflate;
+    deflate.server_enable = config_.permessage_deflate;
+    ws_.set_option(deflate);
   }
 
   void WsConnection::start() {
@@ -36,7 +44,23 @@ namespace libp2p::connection {
     started_ = true;
 
     if (config_.ping_interval != std::chrono::milliseconds::zero()) {
-      setTimerPing();
+      // Set pong handler
+      using boost::beast::websocket::frame_type;
+      ws_.control_callback(
+          [weak = weak_from_this()](frame_type type,
+                                    boost::beast::string_view payload) {
+            if (type != frame_type::pong) {
+              return;
+            }
+            if (auto self = weak.lock()) {
+              self->onPong(bytestr(payload));
+            }
+          });
+      if (health_) {
+        health_->add(*this, config_.ping_interval);
+      } else {
+        setTimerPing();
+      }
     }
   }
 
@@ -48,6 +72,7 @@ namespace libp2p::connection {
     started_ = false;
     ping_handle_.reset();
     ping_timeout_handle_.reset();
+    stopHealthCheck();
   }
 
   void WsConnection::onPong(BytesIn payload) {
@@ -55,11 +80,14 @@ namespace libp2p::connection {
         // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
         reinterpret_cast<const uint8_t *>(&ping_counter_),
         sizeof(ping_counter_));
+    healthActive();
     if (std::equal(
             payload.begin(), payload.end(), expected.begin(), expected.end())) {
       SL_DEBUG(log_, "Correct pong has received for ping");
       ping_timeout_handle_.reset();
-      setTimerPing();
+      if (not health_) {
+        setTimerPing();
+      }
       return;
     }
     SL_DEBUG(log_, "Received unexpected pong. Ignoring");
@@ -103,6 +131,9 @@ namespace libp2p::connection {
       if (ec) {
         cb(ec);
       } else if (n != 0) {
+        if (auto self = weak.lock()) {
+          self->healthActive();
+        }
         cb(n);
       } else if (auto self = weak.lock()) {
         self->readSome(out, out.size(), std::move(cb));
@@ -132,48 +163,46 @@ namespace libp2p::connection {
   }
 
   void WsConnection::setTimerPing() {
-    // Set pong handler
-    using boost::beast::websocket::frame_type;
-    ws_.control_callback(
-        [weak = weak_from_this()](frame_type type,
-                                  boost::beast::string_view payload) {
-          if (type != frame_type::pong) {
-            return;
-          }
-          if (auto self = weak.lock()) {
-            self->onPong(bytestr(payload));
-          }
-        });
-
     ping_handle_ = scheduler_->scheduleWithHandle(
-        [wp = weak_from_this()]() mutable {
+        [wp = weak_from_this()] {
           if (auto self = wp.lock(); self and self->started_) {
-            ++self->ping_counter_;
+            self->sendPing();
+          }
+        },
+        config_.ping_interval);
+  }
 
-            // Send ping
-            self->ws_.async_ping(
+  void WsConnection::onHealthIdle(Time) {
+    // previous ping is still waiting for pong
+    if (started_ and not ping_timeout_handle_) {
+      sendPing();
+    }
+  }
+
+  void WsConnection::sendPing() {
+    ++ping_counter_;
+
+    // Send ping
+    ws_.async_ping(
+        {
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+            reinterpret_cast<const char *>(&ping_counter_),
+            sizeof(ping_counter_),
+        },
+        [](boost::system::error_code) {});
+
+    // Start timer of pong waiting
+    ping_timeout_handle_ = scheduler_->scheduleWithHandle(
+        [wp = weak_from_this()] {
+          if (auto self = wp.lock()) {
+            self->ws_.async_close(
                 {
-                    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
-                    reinterpret_cast<const char *>(&self->ping_counter_),
-                    sizeof(self->ping_counter_),
+                    boost::beast::websocket::close_code::policy_error,
+                    "Pong was not received on time",
                 },
                 [](boost::system::error_code) {});
-
-            // Start timer of pong waiting
-            self->ping_timeout_handle_ = self->scheduler_->scheduleWithHandle(
-                [wp] {
-                  if (auto self = wp.lock()) {
-                    self->ws_.async_close(
-                        {
-                            boost::beast::websocket::close_code::policy_error,
-                            "Pong was not received on time",
-                        },
-                        [](boost::system::error_code) {});
-                  }
-                },
-                self->config_.ping_timeout);
           }
         },
-        config_.ping_interval);
+        config_.ping_timeout);
   }
 }  // namespace libp2p::connection
@@ -6,16 +6,13 @@
 
 #include <libp2p/log/configurator.hpp>
 
+#include <fmt/format.h>
+
 namespace libp2p::log {
 
   namespace {
-    const std::string embedded_config(R"(
-# This is libp2p configuration part of logging system
-# ------------- Begin of libp2p config --------------
-groups:
-  - name: libp2p
-    level: off
-    children:
+    // groups of libp2p loggers, nested into libp2p group
+    const std::string embedded_groups(R"(    children:
       - name: muxer
         children:
           - name: mplex
@@ -41,12 +38,70 @@ groups:
           - name: listener_manager
           - name: libp2p_debug
           - name: scheduler
-# --------------- End of libp2p config ---------------)");
-  }
+)");
+
+    const std::string embedded_config(R"(
+# This is libp2p configuration part of logging system
+# ------------- Begin of libp2p config --------------
+groups:
+  - name: libp2p
+    level: off
+)" + embedded_groups);
+
+    std::string_view levelName(Level level) {
+      switch (level) {
+        case Level::TRACE:
+          return "trace";
+        case Level::DEBUG:
+          return "debug";
+        case Level::VERBOSE:
+          return "verbose";
+        case Level::INFO:
+          return "info";
+        case Level::WARN:
+          return "warning";
+        case Level::ERROR:
+          return "error";
+        case Level::CRITICAL:
+          return "critical";
+        default:
+          return "off";
+      }
+    }
+
+    std::string asyncSinkConfig(const AsyncSinkConfig &sink) {
+      std::string config = R"(
+# libp2p configuration with asynchronous sink
+sinks:
+  - name: libp2p_async
+)";
+      if (sink.path.empty()) {
+        config += "    type: console\n";
+      } else {
+        config += fmt::format("    type: file\n    path: {}\n", sink.path);
+      }
+      config += fmt::format(R"(    capacity: {}
+    buffer: {}
+    latency: {}
+groups:
+  - name: libp2p
+    sink: libp2p_async
+    level: {}
+)",
+                            sink.capacity,
+                            sink.buffer,
+                            sink.latency.count(),
+                            levelName(sink.level));
+      return config + embedded_groups;
+    }
+  }  // namespace
 
   Configurator::Configurator() : ConfiguratorFromYAML(embedded_config) {}
 
   Configurator::Configurator(std::string config)
       : soralog::ConfiguratorFromYAML(std::move(config)) {}
 
+  Configurator::Configurator(const AsyncSinkConfig &sink)
+      : soralog::ConfiguratorFromYAML(asyncSinkConfig(sink)) {}
+
 }  // namespace libp2p::log
@@ -28,4 +28,9 @@ namespace libp2p::multi {
                     && content_address < c.content_address)));
   }
 
+  ContentIdentifier ContentIdentifierView::toContentIdentifier() const {
+    return ContentIdentifier{
+        version, content_type, content_address.toMultihash()};
+  }
+
 }  // namespace libp2p::multi
@@ -110,11 +110,18 @@ namespace libp2p::multi {
 
   outcome::result<ContentIdentifier> ContentIdentifierCodec::decode(
       BytesIn bytes) {
+    OUTCOME_TRY(view, decodeView(bytes));
+    return view.toContentIdentifier();
+  }
+
+  outcome::result<ContentIdentifierView> ContentIdentifierCodec::decodeView(
+      BytesIn bytes) {
     if (bytes.size() == 34 and bytes[0] == 0x12 and bytes[1] == 0x20) {
-      OUTCOME_TRY(hash, Multihash::createFromBytes(bytes));
-      return ContentIdentifier(ContentIdentifier::Version::V0,
-                               MulticodecType::Code::DAG_PB,
-                               std::move(hash));
+      OUTCOME_TRY(hash, MultihashView::create(bytes));
+      return ContentIdentifierView{ContentIdentifier::Version::V0,
+                                   MulticodecType::Code::DAG_PB,
+                                   hash,
+                                   bytes};
     }
     auto version_opt = UVarint::create(bytes);
     if (!version_opt) {
@@ -131,12 +138,13 @@ namespace libp2p::multi {
       auto multicodec_length = UVarint::calculateSize(
           bytes.subspan(static_cast<ptrdiff_t>(version_length)));
       OUTCOME_TRY(hash,
-                  Multihash::createFromBytes(
+                  MultihashView::create(
                       bytes.subspan(version_length + multicodec_length)));
-      return ContentIdentifier(
+      return ContentIdentifierView{
           ContentIdentifier::Version::V1,
           MulticodecType::Code(multicodec_opt.value().toUInt64()),
-          std::move(hash));
+          hash,
+          bytes};
     }
     if (version <= 0) {
       return DecodeError::MALFORMED_VERSION;
@@ -6,22 +6,18 @@
 
 #include <libp2p/multi/converters/converter_utils.hpp>
 
+#include <charconv>
 #include <optional>
 
-#include <boost/algorithm/string.hpp>
-#include <boost/asio/ip/address_v4.hpp>
 #include <boost/asio/ip/address_v6.hpp>
 #include <boost/endian/conversion.hpp>
+#include <libp2p/common/byteutil.hpp>
 #include <libp2p/common/types.hpp>
 #include <libp2p/multi/converters/conversion_error.hpp>
-#include <libp2p/multi/converters/dns_converter.hpp>
-#include <libp2p/multi/converters/ip_v4_converter.hpp>
-#include <libp2p/multi/converters/ip_v6_converter.hpp>
-#include <libp2p/multi/converters/ipfs_converter.hpp>
-#include <libp2p/multi/converters/tcp_converter.hpp>
-#include <libp2p/multi/converters/udp_converter.hpp>
 #include <libp2p/multi/multiaddress_protocol_list.hpp>
 #include <libp2p/multi/multibase_codec/codecs/base58.hpp>
+#include <libp2p/multi/multibase_codec/codecs/base64.hpp>
+#include <libp2p/multi/multibase_codec/multibase_codec_impl.hpp>
 #include <libp2p/multi/uvarint.hpp>
 #include <qtils/bytestr.hpp>
 
@@ -44,9 +40,8 @@ inline void percentEncode(std::string &out, std::string_view str) {
   }
 }
 
-// https://github.com/multiformats/rust-multiaddr/blob/3c7e813c3b1fdd4187a9ca9ff67e10af0e79231d/src/protocol.rs#L203-L212
-inline std::string percentDecode(std::string_view str) {
-  auto f = [&](char c) -> std::optional<uint8_t> {
+namespace {
+  std::optional<uint8_t> unhexDigit(char c) {
     if (c >= '0' && c <= '9') {
       return c - '0';
     }
@@ -57,26 +52,74 @@ inline std::string percentDecode(std::string_view str) {
       return c - 'a' + 10;
     }
     return std::nullopt;
-  };
-  std::string out;
-  while (not str.empty()) {
-    if (str[0] == '%' and str.size() >= 3) {
-      auto x1 = f(str[1]), x2 = f(str[2]);
-      if (x1 and x2) {
-        out.push_back((*x1 << 4) | *x2);
-        str.remove_prefix(3);
-        continue;
+  }
+
+  /// Calls `f` for each decoded byte
+  // https://github.com/multiformats/rust-multiaddr/blob/3c7e813c3b1fdd4187a9ca9ff67e10af0e79231d/src/protocol.rs#L203-L212
+  template <typename F>
+  void percentDecode(std::string_view str, const F &f) {
+    while (not str.empty()) {
+      if (str[0] == '%' and str.size() >= 3) {
+        auto x1 = unhexDigit(str[1]), x2 = unhexDigit(str[2]);
+        if (x1 and x2) {
+          f((*x1 << 4) | *x2);
+          str.remove_prefix(3);
+          continue;
+        }
       }
+      f(str[0]);
+      str.remove_prefix(1);
     }
-    out.push_back(str[0]);
-    str.remove_prefix(1);
   }
-  return out;
-}
+
+  void appendUVarint(libp2p::Bytes &out, uint64_t value) {
+    do {
+      uint8_t byte = value & 0x7F;
+      value >>= 7;
+      if (value != 0) {
+        byte |= 0x80;
+      }
+      out.push_back(byte);
+    } while (value != 0);
+  }
+
+  template <typename T>
+  std::optional<T> parseDecimal(std::string_view str) {
+    T value{};
+    auto end = str.data() + str.size();
+    auto [ptr, ec] = std::from_chars(str.data(), end, value);
+    if (str.empty() or str[0] == '-' or ec != std::errc{} or ptr != end) {
+      return std::nullopt;
+    }
+    return value;
+  }
+
+  /// Dotted decimal, without leading zeros, as inet_pton accepts
+  bool appendIPv4(libp2p::Bytes &out, std::string_view str) {
+    for (int i = 0; i < 4; ++i) {
+      auto dot = i == 3 ? str.size() : str.find('.');
+      if (dot == std::string_view::npos) {
+        return false;
+      }
+      auto part = str.substr(0, dot);
+      if (part.size() > 3 or (part.size() > 1 and part[0] == '0')) {
+        return false;
+      }
+      auto octet = parseDecimal<uint16_t>(part);
+      if (not octet or *octet > 255) {
+        return false;
+      }
+      out.push_back(static_cast<uint8_t>(*octet));
+      str.remove_prefix(i == 3 ? dot : dot + 1);
+    }
+    return true;
+  }
+}  // namespace
 
 namespace libp2p::multi::converters {
 
-  outcome::result<Bytes> multiaddrToBytes(std::string_view str) {
+  outcome::result<void> appendMultiaddrBytes(Bytes &out,
+                                             std::string_view str) {
     if (str.empty() || str[0] != '/') {
       return ConversionError::ADDRESS_DOES_NOT_BEGIN_WITH_SLASH;
     }
@@ -87,82 +130,128 @@ namespace libp2p::multi::converters {
     }
 
     if (str.back() == '/') {
-      // for split does not recognize an empty token in the end
+      // single trailing slash is allowed
       str.remove_suffix(1);
     }
 
-    Bytes processed;
-
-    enum class WordType { PROTOCOL, ADDRESS };
-    WordType type = WordType::PROTOCOL;
-
-    const Protocol *protx = nullptr;
-
-    std::list<std::string> tokens;
-    boost::algorithm::split(tokens, str, boost::algorithm::is_any_of("/"));
+    // cuts next word from the front of `str`
+    auto next = [&] {
+      auto slash = str.find('/');
+      auto word = str.substr(0, slash);
+      str.remove_prefix(slash == std::string_view::npos ? str.size()
+                                                        : slash + 1);
+      return word;
+    };
 
-    for (auto &word : tokens) {
-      if (type == WordType::PROTOCOL) {
-        if (word.empty()) {
-          return ConversionError::EMPTY_PROTOCOL;
-        }
-        protx = ProtocolList::get(word);
-        if (protx != nullptr) {
-          auto code = UVarint(static_cast<uint64_t>(protx->code)).toVector();
-          for (auto byte : code) {
-            processed.emplace_back(byte);
-          }
-          if (protx->size != 0) {
-            type = WordType::ADDRESS;  // Since the next word will be an address
-          }
-        } else {
-          return ConversionError::NO_SUCH_PROTOCOL;
-        }
-      } else {
-        if (word.empty()) {
-          return ConversionError::EMPTY_ADDRESS;
-        }
-        OUTCOME_TRY(bytes, addressToBytes(*protx, word));
-        for (auto byte : bytes) {
-          processed.emplace_back(byte);
-        }
-        protx = nullptr;  // Since right now it doesn't need that
-        // assignment anymore.
-        type = WordType::PROTOCOL;  // Since the next word will be an protocol
+    bool last = false;
+    while (not last) {
+      last = str.find('/') == std::string_view::npos;
+      auto word = next();
+      if (word.empty()) {
+        return ConversionError::EMPTY_PROTOCOL;
       }
+      const auto *protocol = ProtocolList::get(word);
+      if (protocol == nullptr) {
+        return ConversionError::NO_SUCH_PROTOCOL;
+      }
+      appendUVarint(out, static_cast<uint64_t>(protocol->code));
+      if (protocol->size == 0) {
+        continue;
+      }
+      if (last) {
+        return ConversionError::EMPTY_ADDRESS;
+      }
+      last = str.find('/') == std::string_view::npos;
+      auto address = next();
+      if (address.empty()) {
+        return ConversionError::EMPTY_ADDRESS;
+      }
+      OUTCOME_TRY(appendAddressBytes(out, *protocol, address));
     }
+    return outcome::success();
+  }
 
-    if (type == WordType::ADDRESS) {
-      return ConversionError::EMPTY_ADDRESS;
-    }
-
+  outcome::result<Bytes> multiaddrToBytes(std::string_view str) {
+    Bytes processed;
+    // binary form is not longer than text in practice
+    processed.reserve(str.size());
+    OUTCOME_TRY(appendMultiaddrBytes(processed, str));
     return processed;
   }
 
-  outcome::result<Bytes> addressToBytes(const Protocol &protocol,
-                                        std::string_view addr) {
+  outcome::result<void> appendAddressBytes(Bytes &out,
+                                           const Protocol &protocol,
+                                           std::string_view addr) {
     // TODO(Akvinikym) 25.02.19 PRE-49: add more protocols
     switch (protocol.code) {
       case Protocol::Code::IP4:
-        return IPv4Converter::addressToBytes(addr);
-      case Protocol::Code::IP6:
-        return IPv6Converter::addressToBytes(addr);
+        if (not appendIPv4(out, addr)) {
+          return ConversionError::INVALID_ADDRESS;
+        }
+        return outcome::success();
+      case Protocol::Code::IP6: {
+        boost::system::error_code ec;
+        auto address = boost::asio::ip::make_address_v6(addr, ec);
+        if (ec) {
+          return ConversionError::INVALID_ADDRESS;
+        }
+        auto ip_bytes = address.to_bytes();
+        out.insert(out.end(), ip_bytes.begin(), ip_bytes.end());
+        return outcome::success();
+      }
       case Protocol::Code::TCP:
-        return TcpConverter::addressToBytes(addr);
-      case Protocol::Code::UDP:
-        return UdpConverter::addressToBytes(addr);
-      case Protocol::Code::P2P:
-        return IpfsConverter::addressToBytes(addr);
+      case Protocol::Code::UDP: {
+        auto port = parseDecimal<uint16_t>(addr);
+        if (not port) {
+          return ConversionError::INVALID_ADDRESS;
+        }
+        common::putUint16BE(out, *port);
+        return outcome::success();
+      }
+      case Protocol::Code::P2P: {
+        auto decoded = detail::decodeBase58(addr);
+        if (addr.empty() or not decoded) {
+          return ConversionError::INVALID_ADDRESS;
+        }
+        appendUVarint(out, decoded.value().size());
+        out.insert(out.end(), decoded.value().begin(), decoded.value().end());
+        return outcome::success();
+      }
+
+      case Protocol::Code::CERTHASH: {
+        auto decoded = MultibaseCodecImpl{}.decode(addr);
+        if (not decoded) {
+          return ConversionError::INVALID_ADDRESS;
+        }
+        appendUVarint(out, decoded.value().size());
+        out.insert(out.end(), decoded.value().begin(), decoded.value().end());
+        return outcome::success();
+      }
 
       case Protocol::Code::DNS:
       case Protocol::Code::DNS4:
       case Protocol::Code::DNS6:
       case Protocol::Code::DNS_ADDR:
       case Protocol::Code::UNIX:
-        return DnsConverter::addressToBytes(addr);
+        appendUVarint(out, addr.size());
+        out.insert(out.end(), addr.begin(), addr.end());
+        return outcome::success();
       case Protocol::Code::X_PARITY_WS:
-      case Protocol::Code::X_PARITY_WSS:
-        return DnsConverter::addressToBytes(percentDecode(addr));
+      case Protocol::Code::X_PARITY_WSS: {
+        size_t size = 0;
+        percentDecode(addr, [&](uint8_t) { ++size; });
+        appendUVarint(out, size);
+        percentDecode(addr, [&](uint8_t byte) { out.push_back(byte); });
+        return outcome::success();
+      }
+      case Protocol::Code::MEMORY: {
+        auto id = parseDecimal<uint64_t>(addr);
+        if (not id) {
+          return ConversionError::INVALID_ADDRESS;
+        }
+        common::putUint64BE(out, *id);
+        return outcome::success();
+      }
 
       case Protocol::Code::IP6_ZONE:
       case Protocol::Code::ONION3:
@@ -180,7 +269,15 @@ namespace libp2p::multi::converters {
     }
   }
 
-  outcome::result<std::string> bytesToMultiaddrString(BytesIn bytes) {
+  outcome::result<Bytes> addressToBytes(const Protocol &protocol,
+                                        std::string_view addr) {
+    Bytes bytes;
+    OUTCOME_TRY(appendAddressBytes(bytes, protocol, addr));
+    return bytes;
+  }
+
+  outcome::result<void> appendMultiaddrString(std::string &results,
+                                              BytesIn bytes) {
     auto read = [&](size_t n) -> outcome::result<BytesIn> {
       if (n > bytes.size()) {
         return ConversionError::INVALID_ADDRESS;
@@ -201,7 +298,7 @@ namespace libp2p::multi::converters {
       OUTCOME_TRY(n, uvar());
       return read(n);
     };
-    std::string results;
+    auto out = std::back_inserter(results);
     while (not bytes.empty()) {
       OUTCOME_TRY(protocol_num, uvar());
       const Protocol *protocol =
@@ -222,6 +319,14 @@ namespace libp2p::multi::converters {
           break;
         }
 
+        case Protocol::Code::CERTHASH: {
+          OUTCOME_TRY(data, read_uvar());
+          // canonical multibase of certhash
+          results += "/u";
+          results += detail::encodeBase64Url(data);
+          break;
+        }
+
         case Protocol::Code::DNS:
         case Protocol::Code::DNS4:
         case Protocol::Code::DNS6:
@@ -249,11 +354,9 @@ namespace libp2p::multi::converters {
         }
 
         case Protocol::Code::IP4: {
-          std::array<uint8_t, 4> arr{};
-          OUTCOME_TRY(data, read(arr.size()));
-          std::copy(data.begin(), data.end(), arr.begin());
-          results += "/";
-          results += boost::asio::ip::make_address_v4(arr).to_string();
+          OUTCOME_TRY(data, read(4));
+          fmt::format_to(
+              out, "/{}.{}.{}.{}", data[0], data[1], data[2], data[3]);
           break;
         }
 
@@ -269,8 +372,13 @@ namespace libp2p::multi::converters {
         case Protocol::Code::TCP:
         case Protocol::Code::UDP: {
           OUTCOME_TRY(data, read(sizeof(uint16_t)));
-          results += "/";
-          results += std::to_string(boost::endian::load_big_u16(data.data()));
+          fmt::format_to(out, "/{}", boost::endian::load_big_u16(data.data()));
+          break;
+        }
+
+        case Protocol::Code::MEMORY: {
+          OUTCOME_TRY(data, read(sizeof(uint64_t)));
+          fmt::format_to(out, "/{}", boost::endian::load_big_u64(data.data()));
           break;
         }
 
@@ -279,6 +387,14 @@ namespace libp2p::multi::converters {
       }
     }
 
+    return outcome::success();
+  }
+
+  outcome::result<std::string> bytesToMultiaddrString(BytesIn bytes) {
+    std::string results;
+    // text form is not longer than twice the binary one in practice
+    results.reserve(bytes.size() * 2);
+    OUTCOME_TRY(appendMultiaddrString(results, bytes));
     return results;
   }
 }  // namespace libp2p::multi::converters
@@ -6,16 +6,12 @@
 
 #include <libp2p/multi/converters/dns_converter.hpp>
 
-#include <libp2p/multi/uvarint.hpp>
+#include <libp2p/multi/converters/converter_utils.hpp>
 
 namespace libp2p::multi::converters {
   outcome::result<Bytes> DnsConverter::addressToBytes(std::string_view addr) {
-    outcome::result<Bytes> res = outcome::success();  // NRVO
-    auto &bytes = res.value();
-    bytes = UVarint(addr.size()).toVector();
-    bytes.reserve(bytes.size() + addr.size());
-    bytes.insert(bytes.end(), addr.begin(), addr.end());
-    return res;
+    return converters::addressToBytes(*ProtocolList::get(Protocol::Code::DNS),
+                                      addr);
   }
 
 }  // namespace libp2p::multi::converters
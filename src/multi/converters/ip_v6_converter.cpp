@@ -6,19 +6,12 @@
 
 #include <libp2p/multi/converters/ip_v6_converter.hpp>
 
-#include <boost/asio/ip/address_v6.hpp>
-#include <libp2p/multi/converters/conversion_error.hpp>
+#include <libp2p/multi/converters/converter_utils.hpp>
 
 namespace libp2p::multi::converters {
-
   outcome::result<Bytes> IPv6Converter::addressToBytes(std::string_view addr) {
-    boost::system::error_code ec;
-    auto address = boost::asio::ip::make_address_v6(addr, ec);
-    if (ec) {
-      return ConversionError::INVALID_ADDRESS;
-    }
-    auto ip_bytes = address.to_bytes();
-    return Bytes(ip_bytes.begin(), ip_bytes.end());
+    return converters::addressToBytes(*ProtocolList::get(Protocol::Code::IP6),
+                                      addr);
   }
 
 }  // namespace libp2p::multi::converters
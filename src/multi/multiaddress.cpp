@@ -12,6 +12,7 @@
 
 #include <boost/algorithm/string/classification.hpp>
 #include <boost/algorithm/string/split.hpp>
+#include <boost/container_hash/hash.hpp>
 #include <libp2p/multi/converters/converter_utils.hpp>
 
 using std::string_literals::operator""s;
@@ -34,6 +35,26 @@ namespace {
     }
     return occurrences;
   }
+
+  /**
+   * Find first "/<name>/" in the address without allocations
+   * @return position of value after the protocol name, or npos
+   */
+  size_t findProtocolValue(std::string_view address, std::string_view name) {
+    size_t from = 0;
+    while (true) {
+      auto pos = address.find(name, from);
+      if (pos == std::string_view::npos) {
+        return pos;
+      }
+      auto end = pos + name.size();
+      if (pos != 0 and address[pos - 1] == '/' and end < address.size()
+          and address[end] == '/') {
+        return end + 1;
+      }
+      from = pos + 1;
+    }
+  }
 }  // namespace
 
 OUTCOME_CPP_DEFINE_CATEGORY(libp2p::multi, Multiaddress::Error, e) {
@@ -66,9 +87,7 @@ namespace libp2p::multi {
     BOOST_ASSERT(str_res.has_value());
     auto &&str = str_res.value();
 
-    return Multiaddress{
-        std::move(str),
-        ByteBuffer{std::vector<uint8_t>{bytes.begin(), bytes.end()}}};
+    return Multiaddress{std::move(str), std::move(bytes)};
   }
 
   Multiaddress::FactoryResult Multiaddress::create(BytesIn bytes) {
@@ -86,13 +105,20 @@ namespace libp2p::multi {
   }
 
   Multiaddress::Multiaddress(std::string &&address, ByteBuffer &&bytes)
-      : stringified_address_{std::move(address)}, bytes_{std::move(bytes)} {}
+      : stringified_address_{std::move(address)}, bytes_{std::move(bytes)} {
+    rehash();
+  }
+
+  void Multiaddress::rehash() {
+    std_hash_ = boost::hash_range(bytes_.begin(), bytes_.end());
+  }
 
   void Multiaddress::encapsulate(const Multiaddress &address) {
     stringified_address_ += address.stringified_address_;
 
     const auto &other_bytes = address.bytes_;
     bytes_.insert(bytes_.end(), other_bytes.begin(), other_bytes.end());
+    rehash();
   }
 
   bool Multiaddress::decapsulate(const Multiaddress &address) {
@@ -151,6 +177,7 @@ namespace libp2p::multi {
                                    other_bytes.begin(),
                                    other_bytes.end());
     bytes_ = ByteBuffer{this_bytes.begin(), bytes_pos};
+    rehash();
 
     return true;
   }
@@ -164,11 +191,11 @@ namespace libp2p::multi {
   }
 
   boost::optional<std::string> Multiaddress::getPeerId() const {
-    auto peer_id = getValuesForProtocol(Protocol::Code::P2P);
-    if (peer_id.empty()) {
+    auto peer_id = peekFirstValueForProtocol(Protocol::Code::P2P);
+    if (not peer_id) {
       return {};
     }
-    return peer_id[0];
+    return std::string{peer_id.value()};
   }
 
   std::vector<std::string> Multiaddress::getValuesForProtocol(
@@ -252,20 +279,34 @@ namespace libp2p::multi {
   }
 
   bool Multiaddress::operator==(const Multiaddress &other) const {
-    return this->stringified_address_ == other.stringified_address_
-        && this->bytes_ == other.bytes_;
+    return this->std_hash_ == other.std_hash_
+        && this->bytes_ == other.bytes_
+        && this->stringified_address_ == other.stringified_address_;
   }
 
   outcome::result<std::string> Multiaddress::getFirstValueForProtocol(
       Protocol::Code proto) const {
-    // TODO(@warchant): refactor it to be more performant. this isn't best
-    // solution
-    auto vec = getValuesForProtocol(proto);
-    if (vec.empty()) {
+    OUTCOME_TRY(value, peekFirstValueForProtocol(proto));
+    return std::string{value};
+  }
+
+  outcome::result<std::string_view> Multiaddress::peekFirstValueForProtocol(
+      Protocol::Code proto) const {
+    auto protocol = ProtocolList::get(proto);
+    if (protocol == nullptr) {
       return Error::PROTOCOL_NOT_FOUND;
     }
-
-    return vec[0];
+    std::string_view address{stringified_address_};
+    auto value_pos = findProtocolValue(address, protocol->name);
+    if (value_pos == std::string_view::npos
+        and proto == Protocol::Code::P2P) {  // ipfs and p2p are equivalent
+      value_pos = findProtocolValue(address, "ipfs");
+    }
+    if (value_pos == std::string_view::npos) {
+      return Error::PROTOCOL_NOT_FOUND;
+    }
+    auto value_end = address.find('/', value_pos);
+    return address.substr(value_pos, value_end - value_pos);
   }
 
   bool Multiaddress::operator<(const Multiaddress &other) const {
@@ -289,8 +330,3 @@ namespace libp2p::multi {
   }
 
 }  // namespace libp2p::multi
-
-size_t std::hash<libp2p::multi::Multiaddress>::operator()(
-    const libp2p::multi::Multiaddress &x) const {
-  return std::hash<std::string_view>()(x.getStringAddress());
-}
@@ -35,7 +35,6 @@
 #include <libp2p/multi/multibase_codec/codecs/base64.hpp>
 
 #include <array>
-#include <regex>
 
 #include <boost/optional.hpp>
 #include <libp2p/multi/multibase_codec/codecs/base_error.hpp>
@@ -71,15 +70,22 @@ namespace {
     return n / 4 * 3;  // requires n&3==0, smaller
   }
 
-  const std::regex base64_regex{"^[a-zA-Z0-9\\+/]*={0,2}$"};
   /**
-   * Valid string must have multiple of 4 size and contain specific symbols
+   * Valid string must have multiple of 4 size and at most 2 padding chars at
+   * the end, other symbols are checked while decoding
    * @param string to be checked
    * @return true, if the string is valid base64 string, false otherwise
    */
   bool isValidBase64(std::string_view string) {
-    return string.size() % 4 == 0
-        && std::regex_match(string.data(), base64_regex);
+    if (string.size() % 4 != 0) {
+      return false;
+    }
+    auto padding = string.find('=');
+    if (padding == std::string_view::npos) {
+      return true;
+    }
+    return string.size() - padding <= 2
+        and string.find_first_not_of('=', padding) == std::string_view::npos;
   }
 }  // namespace
 
@@ -96,6 +102,7 @@ namespace libp2p::multi::detail {
     const auto tab = alphabet;
     size_t bytes_pos = 0u;
     size_t decoded_size = 0u;
+    out.reserve((len + 2) / 3 * 4);
 
     for (auto n = len / 3; n--;) {  // NOLINT
       out += tab[(bytes[bytes_pos + 0u] & 0xfcu) >> 2u];
@@ -141,8 +148,8 @@ namespace libp2p::multi::detail {
   boost::optional<std::vector<uint8_t>> decodeImpl(std::string_view src) {
     std::vector<uint8_t> out(decodedSize(src.size()));
 
-    std::vector<unsigned char> c3(3);
-    std::vector<unsigned char> c4(4);
+    std::array<unsigned char, 3> c3{};
+    std::array<unsigned char, 4> c4{};
     int i = 0;
     int j = 0;
     size_t in_pos = 0;
@@ -150,7 +157,7 @@ namespace libp2p::multi::detail {
     size_t bytes_pos = 0;
 
     while (len-- && src[in_pos] != '=') {  // NOLINT
-      const auto v = inverse_table.at(src[in_pos]);
+      const auto v = inverse_table[static_cast<uint8_t>(src[in_pos])];
       if (v == -1) {
         return {};
       }
@@ -201,4 +208,39 @@ namespace libp2p::multi::detail {
     }
     return Bytes{std::move(*decoded_bytes)};
   }
+
+  std::string encodeBase64Url(BytesIn bytes) {
+    auto dest = encodeBase64(bytes);
+    while (not dest.empty() and dest.back() == '=') {
+      dest.pop_back();
+    }
+    for (auto &c : dest) {
+      if (c == '+') {
+        c = '-';
+      } else if (c == '/') {
+        c = '_';
+      }
+    }
+    return dest;
+  }
+
+  outcome::result<Bytes> decodeBase64Url(std::string_view string) {
+    if (string.size() % 4 == 1) {
+      return BaseError::INVALID_BASE64_INPUT;
+    }
+    std::string padded;
+    padded.reserve((string.size() + 3) / 4 * 4);
+    for (auto c : string) {
+      if (c == '-') {
+        c = '+';
+      } else if (c == '_') {
+        c = '/';
+      } else if (c == '+' or c == '/' or c == '=') {
+        return BaseError::INVALID_BASE64_INPUT;
+      }
+      padded += c;
+    }
+    padded.append((4 - padded.size() % 4) % 4, '=');
+    return decodeBase64(padded);
+  }
 }  // namespace libp2p::multi::detail
@@ -38,6 +38,8 @@ namespace {
         return MultibaseCodec::Encoding::BASE58;
       case 'm':
         return MultibaseCodec::Encoding::BASE64;
+      case 'u':
+        return MultibaseCodec::Encoding::BASE64_URL;
       default:
         return boost::none;
     }
@@ -62,7 +64,9 @@ namespace {
       {MultibaseCodec::Encoding::BASE32_LOWER,
        {&encodeBase32Lower, &decodeBase32Lower}},
       {MultibaseCodec::Encoding::BASE58, {&encodeBase58, &decodeBase58}},
-      {MultibaseCodec::Encoding::BASE64, {&encodeBase64, &decodeBase64}}};
+      {MultibaseCodec::Encoding::BASE64, {&encodeBase64, &decodeBase64}},
+      {MultibaseCodec::Encoding::BASE64_URL,
+       {&encodeBase64Url, &decodeBase64Url}}};
 }  // namespace
 
 OUTCOME_CPP_DEFINE_CATEGORY(libp2p::multi, MultibaseCodecImpl::Error, e) {
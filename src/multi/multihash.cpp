@@ -6,6 +6,8 @@
 
 #include <libp2p/multi/multihash.hpp>
 
+#include <algorithm>
+
 #include <boost/container_hash/hash.hpp>
 #include <libp2p/basic/varint_prefix_reader.hpp>
 #include <libp2p/common/types.hpp>
@@ -91,32 +93,8 @@ namespace libp2p::multi {
   }
 
   outcome::result<Multihash> Multihash::createFromBytes(BytesIn b) {
-    if (b.size() < kHeaderSize) {
-      return Error::INPUT_TOO_SHORT;
-    }
-
-    basic::VarintPrefixReader vr;
-    if (vr.consume(b) != basic::VarintPrefixReader::kReady) {
-      return Error::INPUT_TOO_SHORT;
-    }
-
-    const auto type = static_cast<HashType>(vr.value());
-    if (b.empty()) {
-      return Error::INPUT_TOO_SHORT;
-    }
-
-    const uint8_t length = b[0];
-    BytesIn hash = b.subspan(1);
-
-    if (length == 0) {
-      return Error::ZERO_INPUT_LENGTH;
-    }
-
-    if (hash.size() != length) {
-      return Error::INCONSISTENT_LENGTH;
-    }
-
-    return Multihash::create(type, hash);
+    OUTCOME_TRY(view, MultihashView::create(b));
+    return view.toMultihash();
   }
 
   const HashType &Multihash::getType() const {
@@ -142,7 +120,12 @@ namespace libp2p::multi {
     if (data_ == other.data_) {
       return true;
     }
-    return a.bytes == b.bytes && a.type == b.type;
+    // cached hashes differ for almost all unequal multihashes, type is
+    // encoded in bytes
+    if (a.std_hash != b.std_hash) {
+      return false;
+    }
+    return a.bytes == b.bytes;
   }
 
   bool Multihash::operator!=(const Multihash &other) const {
@@ -158,4 +141,61 @@ namespace libp2p::multi {
     return a.type < b.type;
   }
 
+  MultihashView::MultihashView(HashType type, BytesIn bytes, size_t hash_offset)
+      : type_{type}, bytes_{bytes}, hash_offset_{hash_offset} {}
+
+  outcome::result<MultihashView> MultihashView::create(BytesIn bytes) {
+    if (bytes.size() < Multihash::kHeaderSize) {
+      return Multihash::Error::INPUT_TOO_SHORT;
+    }
+
+    auto b = bytes;
+    basic::VarintPrefixReader vr;
+    if (vr.consume(b) != basic::VarintPrefixReader::kReady) {
+      return Multihash::Error::INPUT_TOO_SHORT;
+    }
+
+    const auto type = static_cast<HashType>(vr.value());
+    if (b.empty()) {
+      return Multihash::Error::INPUT_TOO_SHORT;
+    }
+
+    const uint8_t length = b[0];
+    BytesIn hash = b.subspan(1);
+
+    if (length == 0) {
+      return Multihash::Error::ZERO_INPUT_LENGTH;
+    }
+
+    if (hash.size() != length) {
+      return Multihash::Error::INCONSISTENT_LENGTH;
+    }
+
+    if (length > Multihash::kMaxHashLength) {
+      return Multihash::Error::INPUT_TOO_LONG;
+    }
+
+    return MultihashView{type, bytes, bytes.size() - hash.size()};
+  }
+
+  HashType MultihashView::getType() const {
+    return type_;
+  }
+
+  BytesIn MultihashView::getHash() const {
+    return bytes_.subspan(hash_offset_);
+  }
+
+  BytesIn MultihashView::toBuffer() const {
+    return bytes_;
+  }
+
+  Multihash MultihashView::toMultihash() const {
+    return Multihash{type_, getHash()};
+  }
+
+  bool MultihashView::operator==(const MultihashView &other) const {
+    return std::ranges::equal(bytes_, other.bytes_);
+  }
+
 }  // namespace libp2p::multi
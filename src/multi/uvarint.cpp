@@ -6,56 +6,75 @@
 
 #include <libp2p/multi/uvarint.hpp>
 
+#include <bit>
+#include <cstring>
+
+#include <boost/endian/conversion.hpp>
+
 namespace libp2p::multi {
-  UVarint::UVarint(uint64_t number) {
-    do {
-      uint8_t byte = static_cast<uint8_t>(number) & 0x7f;
-      number >>= 7;
-      if (number != 0) {
-        byte |= 0x80;
+  namespace {
+    constexpr uint64_t kHighBits = 0x8080808080808080;
+
+    /// Decodes varint of at most 8 bytes from one little endian word
+    std::optional<UVarint::Decoded> decodeWord(const uint8_t *bytes) {
+      uint64_t word = 0;
+      memcpy(&word, bytes, sizeof(word));
+      word = boost::endian::little_to_native(word);
+      auto last = ~word & kHighBits;
+      if (last == 0) {
+        return std::nullopt;
       }
-      bytes_.push_back(byte);
-    } while (number != 0);
-  }
+      // high bit of the last byte of varint is the lowest one not set
+      size_t size = (std::countr_zero(last) + 1) / 8;
+      if (size < sizeof(word)) {
+        word &= (uint64_t{1} << (size * 8)) - 1;
+      }
+      uint64_t value = 0;
+      for (size_t i = 0; i < sizeof(word); ++i) {
+        value |= (word >> i) & (uint64_t{0x7f} << (i * 7));
+      }
+      return UVarint::Decoded{value, size};
+    }
+  }  // namespace
 
-  UVarint::UVarint(BytesIn varint_bytes)
-      : bytes_(varint_bytes.begin(),
-               // NOLINTNEXTLINE(cppcoreguidelines-narrowing-conversions)
-               varint_bytes.begin() + calculateSize(varint_bytes)) {}
+  UVarint::UVarint(BytesIn varint_bytes) {
+    if (auto decoded = decode(varint_bytes)) {
+      *this = UVarint{varint_bytes, *decoded};
+    }
+  }
 
-  UVarint::UVarint(BytesIn varint_bytes, size_t varint_size)
-      : bytes_(varint_bytes.begin(),
-               // NOLINTNEXTLINE(cppcoreguidelines-narrowing-conversions)
-               varint_bytes.begin() + varint_size) {}
+  UVarint::UVarint(BytesIn varint_bytes, Decoded decoded)
+      : value_{decoded.value}, size_{static_cast<uint8_t>(decoded.size)} {
+    memcpy(bytes_.data(), varint_bytes.data(), decoded.size);
+  }
 
   boost::optional<UVarint> UVarint::create(BytesIn varint_bytes) {
-    size_t size = calculateSize(varint_bytes);
-    if (size > 0) {
-      return UVarint{varint_bytes, size};
+    if (auto decoded = decode(varint_bytes)) {
+      return UVarint{varint_bytes, *decoded};
     }
     return {};
   }
 
-  uint64_t UVarint::toUInt64() const {
-    uint64_t res = 0;
-    size_t index = 0;
-    for (const auto &byte : bytes_) {
-      res += static_cast<uint64_t>((byte & 0x7f)) << index;
-      index += 7;
+  std::optional<UVarint::Decoded> UVarint::decode(BytesIn varint_bytes) {
+    if (varint_bytes.size() >= sizeof(uint64_t)) {
+      if (auto decoded = decodeWord(varint_bytes.data())) {
+        return decoded;
+      }
     }
-    return res;
-  }
-
-  BytesIn UVarint::toBytes() const & {
-    return bytes_;
-  }
-
-  const std::vector<uint8_t> &UVarint::toVector() const {
-    return bytes_;
+    auto size = calculateSize(varint_bytes);
+    if (size == 0) {
+      return std::nullopt;
+    }
+    uint64_t value = 0;
+    for (size_t i = 0; i < size; ++i) {
+      value |= static_cast<uint64_t>(varint_bytes[i] & 0x7f) << (i * 7);
+    }
+    return Decoded{value, size};
   }
 
-  size_t UVarint::size() const {
-    return bytes_.size();
+  Bytes UVarint::toVector() const {
+    auto bytes = toBytes();
+    return {bytes.begin(), bytes.end()};
   }
 
   UVarint &UVarint::operator=(uint64_t n) {
@@ -64,8 +83,7 @@ namespace libp2p::multi {
   }
 
   bool UVarint::operator==(const UVarint &r) const {
-    return std::equal(
-        bytes_.begin(), bytes_.end(), r.bytes_.begin(), r.bytes_.end());
+    return std::ranges::equal(toBytes(), r.toBytes());
   }
 
   bool UVarint::operator!=(const UVarint &r) const {
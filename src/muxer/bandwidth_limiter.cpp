@@ -0,0 +1,175 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/muxer/bandwidth_limiter.hpp>
+
+#include <algorithm>
+
+#include <libp2p/common/metrics/registry.hpp>
+
+namespace libp2p::muxer {
+  namespace {
+    metrics::Counter &limitedBytes(BandwidthDirection direction) {
+      static auto &upload = metrics::Registry::instance().counter(
+          "libp2p_bandwidth_upload_limited_bytes_total",
+          "Stream bytes sent through bandwidth limits");
+      static auto &download = metrics::Registry::instance().counter(
+          "libp2p_bandwidth_download_limited_bytes_total",
+          "Stream bytes acknowledged through bandwidth limits");
+      return direction == BandwidthDirection::UPLOAD ? upload : download;
+    }
+
+    metrics::Counter &throttled(BandwidthDirection direction) {
+      static auto &upload = metrics::Registry::instance().counter(
+          "libp2p_bandwidth_upload_throttled_total",
+          "Times streams waited for upload bandwidth");
+      static auto &download = metrics::Registry::instance().counter(
+          "libp2p_bandwidth_download_throttled_total",
+          "Times streams delayed window updates for download bandwidth");
+      return direction == BandwidthDirection::UPLOAD ? upload : download;
+    }
+
+    std::shared_ptr<TokenBucket> makeBucket(const BandwidthRate &rate) {
+      if (rate.bytes_per_second == 0) {
+        return nullptr;
+      }
+      return std::make_shared<TokenBucket>(rate);
+    }
+
+    bool unlimited(const BandwidthLimits::Direction &limits) {
+      return limits.total.bytes_per_second == 0
+         and limits.peer.bytes_per_second == 0
+         and std::all_of(
+                 limits.protocols.begin(),
+                 limits.protocols.end(),
+                 [](auto &p) { return p.second.bytes_per_second == 0; });
+    }
+  }  // namespace
+
+  TokenBucket::TokenBucket(BandwidthRate rate)
+      : rate_{static_cast<double>(rate.bytes_per_second)},
+        burst_{static_cast<double>(
+            rate.burst != 0 ? rate.burst : rate.bytes_per_second)},
+        tokens_{burst_},
+        updated_{Clock::now()} {}
+
+  size_t TokenBucket::available(size_t bytes) {
+    std::lock_guard lock{mutex_};
+    refill(Clock::now());
+    if (tokens_ <= 0) {
+      return 0;
+    }
+    return std::min(bytes, static_cast<size_t>(tokens_));
+  }
+
+  void TokenBucket::consume(size_t bytes) {
+    std::lock_guard lock{mutex_};
+    tokens_ -= static_cast<double>(bytes);
+  }
+
+  TokenBucket::Clock::duration TokenBucket::delay(size_t bytes) {
+    std::lock_guard lock{mutex_};
+    refill(Clock::now());
+    auto missing = std::min(static_cast<double>(bytes), burst_) - tokens_;
+    if (missing <= 0) {
+      return Clock::duration::zero();
+    }
+    return std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(missing / rate_));
+  }
+
+  void TokenBucket::refill(Clock::time_point now) {
+    std::chrono::duration<double> elapsed = now - updated_;
+    updated_ = now;
+    tokens_ = std::min(burst_, tokens_ + elapsed.count() * rate_);
+  }
+
+  BandwidthLimiter::BandwidthLimiter(
+      BandwidthDirection direction,
+      std::vector<std::shared_ptr<TokenBucket>> buckets)
+      : direction_{direction}, buckets_{std::move(buckets)} {}
+
+  size_t BandwidthLimiter::available(size_t bytes) const {
+    for (auto &bucket : buckets_) {
+      bytes = bucket->available(bytes);
+    }
+    return bytes;
+  }
+
+  void BandwidthLimiter::consume(size_t bytes) {
+    if (buckets_.empty() or bytes == 0) {
+      return;
+    }
+    for (auto &bucket : buckets_) {
+      bucket->consume(bytes);
+    }
+    limitedBytes(direction_).inc(bytes);
+  }
+
+  std::chrono::milliseconds BandwidthLimiter::throttle(size_t bytes) const {
+    // at least one tick, so that waiting stream does not spin
+    std::chrono::milliseconds delay{1};
+    for (auto &bucket : buckets_) {
+      delay = std::max(delay,
+                       std::chrono::ceil<std::chrono::milliseconds>(
+                           bucket->delay(bytes)));
+    }
+    throttled(direction_).inc();
+    return delay;
+  }
+
+  BandwidthManager::BandwidthManager(BandwidthLimits limits)
+      : limits_{std::move(limits)},
+        upload_{makeBucket(limits_.upload.total), {}, {}},
+        download_{makeBucket(limits_.download.total), {}, {}} {}
+
+  BandwidthLimiter BandwidthManager::limiter(
+      BandwidthDirection direction,
+      const peer::PeerId &peer,
+      const peer::ProtocolName &protocol) {
+    auto &limits = this->limits(direction);
+    if (unlimited(limits)) {
+      return {};
+    }
+    auto &buckets =
+        direction == BandwidthDirection::UPLOAD ? upload_ : download_;
+    std::vector<std::shared_ptr<TokenBucket>> chain;
+    std::lock_guard lock{mutex_};
+
+    // narrowest first, it is the most likely to be exhausted
+    if (auto it = limits.protocols.find(protocol);
+        it != limits.protocols.end()
+        and it->second.bytes_per_second != 0) {
+      auto &bucket = buckets.protocols[protocol];
+      if (not bucket) {
+        bucket = makeBucket(it->second);
+      }
+      chain.emplace_back(bucket);
+    }
+    if (limits.peer.bytes_per_second != 0) {
+      std::erase_if(buckets.peers,
+                    [](auto &p) { return p.second.expired(); });
+      auto &weak = buckets.peers[peer];
+      auto bucket = weak.lock();
+      if (not bucket) {
+        bucket = makeBucket(limits.peer);
+        weak = bucket;
+      }
+      chain.emplace_back(std::move(bucket));
+    }
+    if (buckets.total) {
+      chain.emplace_back(buckets.total);
+    }
+    return {direction, std::move(chain)};
+  }
+
+  const BandwidthLimits::Direction &BandwidthManager::limits(
+      BandwidthDirection direction) const {
+    return direction == BandwidthDirection::UPLOAD ? limits_.upload
+                                                   : limits_.download;
+  }
+
+}  // namespace libp2p::muxer
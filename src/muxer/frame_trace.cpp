@@ -0,0 +1,202 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/muxer/frame_trace.hpp>
+
+#include <fstream>
+#include <mutex>
+
+#include <libp2p/multi/uvarint.hpp>
+
+OUTCOME_CPP_DEFINE_CATEGORY(libp2p::muxer, FrameTrace::Error, e) {
+  using E = libp2p::muxer::FrameTrace::Error;
+  switch (e) {
+    case E::INVALID_TRACE:
+      return "FrameTrace: invalid trace";
+  }
+  return "FrameTrace: unknown error";
+}
+
+namespace libp2p::muxer {
+
+  namespace {
+    constexpr uint64_t kTraceVersion = 1;
+
+    void putUVarint(Bytes &out, uint64_t value) {
+      multi::UVarint varint{value};
+      auto bytes = varint.toBytes();
+      out.insert(out.end(), bytes.begin(), bytes.end());
+    }
+
+    /// Reads fields from the front of input
+    struct Reader {
+      boost::optional<uint64_t> uvarint() {
+        auto varint = multi::UVarint::create(input);
+        if (not varint) {
+          return boost::none;
+        }
+        input = input.subspan(varint->size());
+        return varint->toUInt64();
+      }
+
+      BytesIn input;
+    };
+
+    struct Installed {
+      /// Checked first, so that connections without sink take no lock
+      std::atomic_bool enabled = false;
+      std::mutex mutex;
+      std::shared_ptr<FrameTraceSink> sink;
+    };
+
+    Installed &installed() {
+      static auto *installed = new Installed{};
+      return *installed;
+    }
+
+    std::shared_ptr<FrameTraceSink> currentSink() {
+      auto &state = installed();
+      if (not state.enabled.load(std::memory_order_relaxed)) {
+        return nullptr;
+      }
+      std::lock_guard lock{state.mutex};
+      return state.sink;
+    }
+  }  // namespace
+
+  Bytes FrameTrace::encode() const {
+    Bytes out;
+    putUVarint(out, kTraceVersion);
+    putUVarint(out, muxer.size());
+    out.insert(out.end(), muxer.begin(), muxer.end());
+    putUVarint(out, (initiator ? 1 : 0) | (truncated ? 2 : 0));
+    putUVarint(out, frames.size());
+    std::chrono::microseconds time{};
+    for (auto &frame : frames) {
+      // times don't decrease, deltas are mostly one byte
+      putUVarint(out, (frame.time - time).count());
+      time = frame.time;
+      putUVarint(out, (frame.type << 1) | (frame.inbound ? 1 : 0));
+      putUVarint(out, frame.flags);
+      putUVarint(out, frame.stream_id);
+      putUVarint(out, frame.length);
+    }
+    return out;
+  }
+
+  outcome::result<FrameTrace> FrameTrace::decode(BytesIn bytes) {
+    Reader reader{bytes};
+    auto version = reader.uvarint();
+    if (version != kTraceVersion) {
+      return Error::INVALID_TRACE;
+    }
+    FrameTrace trace;
+    auto muxer_size = reader.uvarint();
+    if (not muxer_size or *muxer_size > reader.input.size()) {
+      return Error::INVALID_TRACE;
+    }
+    auto muxer = reader.input.first(*muxer_size);
+    trace.muxer.assign(muxer.begin(), muxer.end());
+    reader.input = reader.input.subspan(*muxer_size);
+    auto bits = reader.uvarint();
+    auto frames = reader.uvarint();
+    if (not bits or not frames) {
+      return Error::INVALID_TRACE;
+    }
+    trace.initiator = (*bits & 1) != 0;
+    trace.truncated = (*bits & 2) != 0;
+    // each frame takes 5 bytes at least
+    if (*frames > reader.input.size() / 5) {
+      return Error::INVALID_TRACE;
+    }
+    trace.frames.reserve(*frames);
+    std::chrono::microseconds time{};
+    for (uint64_t i = 0; i < *frames; ++i) {
+      auto delta = reader.uvarint();
+      auto type = reader.uvarint();
+      auto flags = reader.uvarint();
+      auto stream_id = reader.uvarint();
+      auto length = reader.uvarint();
+      if (not delta or not type or not flags or not stream_id or not length
+          or *type > 0x1ff or *flags > 0xffff) {
+        return Error::INVALID_TRACE;
+      }
+      time += std::chrono::microseconds(*delta);
+      trace.frames.emplace_back(TracedFrame{
+          .time = time,
+          .stream_id = *stream_id,
+          .length = *length,
+          .type = static_cast<uint8_t>(*type >> 1),
+          .flags = static_cast<uint16_t>(*flags),
+          .inbound = (*type & 1) != 0,
+      });
+    }
+    if (not reader.input.empty()) {
+      return Error::INVALID_TRACE;
+    }
+    return trace;
+  }
+
+  void setFrameTraceSink(std::shared_ptr<FrameTraceSink> sink) {
+    auto &state = installed();
+    std::lock_guard lock{state.mutex};
+    state.enabled = sink != nullptr;
+    state.sink = std::move(sink);
+  }
+
+  FrameRecorder::FrameRecorder(std::string_view muxer, bool initiator)
+      : sink_{currentSink()} {
+    if (sink_ != nullptr) {
+      trace_.muxer = muxer;
+      trace_.initiator = initiator;
+      start_ = std::chrono::steady_clock::now();
+    }
+  }
+
+  FrameRecorder::~FrameRecorder() {
+    if (sink_ != nullptr) {
+      sink_->onTrace(std::move(trace_));
+    }
+  }
+
+  void FrameRecorder::record(bool inbound,
+                             uint8_t type,
+                             uint16_t flags,
+                             uint64_t stream_id,
+                             uint64_t length) {
+    if (sink_ == nullptr) {
+      return;
+    }
+    if (trace_.frames.size() >= kMaxFrames) {
+      trace_.truncated = true;
+      return;
+    }
+    trace_.frames.emplace_back(TracedFrame{
+        .time = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start_),
+        .stream_id = stream_id,
+        .length = length,
+        .type = type,
+        .flags = flags,
+        .inbound = inbound,
+    });
+  }
+
+  FrameTraceFiles::FrameTraceFiles(std::filesystem::path dir)
+      : dir_{std::move(dir)} {}
+
+  void FrameTraceFiles::onTrace(FrameTrace trace) {
+    if (trace.frames.empty()) {
+      return;
+    }
+    auto bytes = trace.encode();
+    auto path = dir_ / (std::to_string(next_++) + ".trace");
+    std::ofstream file{path, std::ios::binary | std::ios::trunc};
+    file.write(reinterpret_cast<const char *>(bytes.data()),
+               static_cast<std::streamsize>(bytes.size()));
+  }
+
+}  // namespace libp2p::muxer
@@ -0,0 +1,102 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/muxer/memory_budget.hpp>
+
+#include <algorithm>
+#include <cassert>
+
+namespace libp2p::muxer {
+
+  MemoryScope::MemoryScope(size_t limit, std::shared_ptr<MemoryScope> parent)
+      : limit_{limit}, parent_{std::move(parent)} {}
+
+  bool MemoryScope::reserve(size_t bytes) {
+    auto used = used_.load(std::memory_order_relaxed);
+    do {
+      if (bytes > limit_ - std::min(used, limit_)) {
+        return false;
+      }
+    } while (not used_.compare_exchange_weak(
+        used, used + bytes, std::memory_order_relaxed));
+    if (parent_ and not parent_->reserve(bytes)) {
+      used_.fetch_sub(bytes, std::memory_order_relaxed);
+      return false;
+    }
+    return true;
+  }
+
+  void MemoryScope::release(size_t bytes) {
+    [[maybe_unused]] auto used =
+        used_.fetch_sub(bytes, std::memory_order_relaxed);
+    assert(used >= bytes);
+    if (parent_) {
+      parent_->release(bytes);
+    }
+  }
+
+  size_t MemoryScope::used() const {
+    return used_.load(std::memory_order_relaxed);
+  }
+
+  bool MemoryScope::underPressure() const {
+    if (used() >= limit_ / 4 * 3) {
+      return true;
+    }
+    return parent_ and parent_->underPressure();
+  }
+
+  MemoryReservation::MemoryReservation(std::shared_ptr<MemoryScope> scope)
+      : scope_{std::move(scope)} {}
+
+  MemoryReservation::~MemoryReservation() {
+    releaseAll();
+  }
+
+  bool MemoryReservation::reserve(size_t bytes) {
+    if (scope_ and not scope_->reserve(bytes)) {
+      return false;
+    }
+    size_ += bytes;
+    return true;
+  }
+
+  void MemoryReservation::release(size_t bytes) {
+    assert(bytes <= size_);
+    bytes = std::min(bytes, size_);
+    size_ -= bytes;
+    if (scope_) {
+      scope_->release(bytes);
+    }
+  }
+
+  void MemoryReservation::releaseAll() {
+    release(size_);
+  }
+
+  bool MemoryReservation::underPressure() const {
+    return scope_ and scope_->underPressure();
+  }
+
+  MemoryManager::MemoryManager(MemoryLimits limits)
+      : limits_{limits},
+        process_{std::make_shared<MemoryScope>(limits.process, nullptr)} {}
+
+  std::shared_ptr<MemoryScope> MemoryManager::connectionScope(
+      const peer::PeerId &peer) {
+    std::lock_guard lock{mutex_};
+    std::erase_if(peers_, [](auto &p) { return p.second.expired(); });
+    auto &weak = peers_[peer];
+    auto peer_scope = weak.lock();
+    if (not peer_scope) {
+      peer_scope = std::make_shared<MemoryScope>(limits_.peer, process_);
+      weak = peer_scope;
+    }
+    return std::make_shared<MemoryScope>(limits_.connection,
+                                         std::move(peer_scope));
+  }
+
+}  // namespace libp2p::muxer
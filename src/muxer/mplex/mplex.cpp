@@ -11,7 +11,12 @@
 #include <libp2p/muxer/mplex/mplexed_connection.hpp>
 
 namespace libp2p::muxer {
-  Mplex::Mplex(MuxedConnectionConfig config) : config_{config} {}
+  Mplex::Mplex(MuxedConnectionConfig config,
+               std::shared_ptr<MemoryManager> memory,
+               std::shared_ptr<StreamManager> streams)
+      : config_{config},
+        memory_{std::move(memory)},
+        streams_{std::move(streams)} {}
 
   peer::ProtocolName Mplex::getProtocolId() const {
     return "/mplex/6.7.0";
@@ -19,7 +24,17 @@ namespace libp2p::muxer {
 
   void Mplex::muxConnection(std::shared_ptr<connection::SecureConnection> conn,
                             CapConnCallbackFunc cb) const {
-    cb(std::make_shared<connection::MplexedConnection>(std::move(conn),
-                                                       config_));
+    std::shared_ptr<MemoryScope> scope;
+    std::shared_ptr<StreamScope> stream_scope;
+    if (auto peer = conn->remotePeer()) {
+      if (memory_) {
+        scope = memory_->connectionScope(peer.value());
+      }
+      if (streams_) {
+        stream_scope = streams_->peerScope(peer.value());
+      }
+    }
+    cb(std::make_shared<connection::MplexedConnection>(
+        std::move(conn), config_, std::move(scope), std::move(stream_scope)));
   }
 }  // namespace libp2p::muxer
@@ -6,9 +6,11 @@
 
 #include <libp2p/muxer/mplex/mplex_frame.hpp>
 
-#include <libp2p/basic/varint_reader.hpp>
+#include <algorithm>
+
 #include <libp2p/multi/uvarint.hpp>
 #include <libp2p/muxer/mplex/mplexed_connection.hpp>
+#include <qtils/append.hpp>
 
 namespace libp2p::connection {
   Bytes MplexFrame::toBytes() const {
@@ -18,12 +20,10 @@ namespace libp2p::connection {
     multi::UVarint id_and_flag_varint{id_and_flag};
     multi::UVarint length_varint{length};
 
-    result.insert(result.end(),
-                  id_and_flag_varint.toVector().begin(),
-                  id_and_flag_varint.toVector().end());
-    result.insert(result.end(),
-                  length_varint.toVector().begin(),
-                  length_varint.toVector().end());
+    result.reserve(id_and_flag_varint.size() + length_varint.size()
+                   + data.size());
+    qtils::append(result, id_and_flag_varint.toBytes());
+    qtils::append(result, length_varint.toBytes());
     result.insert(result.end(), data.begin(), data.end());
     return result;
   }
@@ -35,82 +35,82 @@ namespace libp2p::connection {
         .toBytes();
   }
 
-  outcome::result<MplexFrame> createFrame(uint64_t id_flag, Bytes data) {
-    using Flag = MplexFrame::Flag;
-
-    Flag flag;
-    switch (static_cast<uint8_t>(id_flag & 0x07)) {
-      case static_cast<uint8_t>(Flag::NEW_STREAM):
-        flag = Flag::NEW_STREAM;
-        break;
-      case static_cast<uint8_t>(Flag::MESSAGE_RECEIVER):
-        flag = Flag::MESSAGE_RECEIVER;
-        break;
-      case static_cast<uint8_t>(Flag::MESSAGE_INITIATOR):
-        flag = Flag::MESSAGE_INITIATOR;
-        break;
-      case static_cast<uint8_t>(Flag::CLOSE_RECEIVER):
-        flag = Flag::CLOSE_RECEIVER;
-        break;
-      case static_cast<uint8_t>(Flag::CLOSE_INITIATOR):
-        flag = Flag::CLOSE_INITIATOR;
-        break;
-      case static_cast<uint8_t>(Flag::RESET_RECEIVER):
-        flag = Flag::RESET_RECEIVER;
-        break;
-      case static_cast<uint8_t>(Flag::RESET_INITIATOR):
-        flag = Flag::RESET_INITIATOR;
-        break;
-      default:
-        return RawConnection::Error::CONNECTION_PROTOCOL_ERROR;
+  namespace {
+    std::optional<MplexFrame::Flag> parseFlag(uint64_t id_flag) {
+      using Flag = MplexFrame::Flag;
+      auto flag = static_cast<uint8_t>(id_flag & 0x07);
+      if (flag > static_cast<uint8_t>(Flag::RESET_INITIATOR)) {
+        return std::nullopt;
+      }
+      return static_cast<Flag>(flag);
     }
+  }  // namespace
 
-    return MplexFrame{flag,
-                      static_cast<MplexStream::StreamNumber>(id_flag >> 3),
-                      data.size(),
-                      std::move(data)};
-  }
+  MplexFrameDecoder::MplexFrameDecoder(size_t max_data_size)
+      : max_data_size_{max_data_size}, buffer_(kBufferSize) {}
 
-  void readFrame(std::shared_ptr<basic::ReadWriter> reader,
-                 std::function<void(outcome::result<MplexFrame>)> cb) {
-    // read first varint
-    basic::VarintReader::readVarint(
-        reader, [reader, cb{std::move(cb)}](auto &&varint_res) mutable {
-          if (varint_res.has_error()) {
-            return cb(varint_res.error());
-          }
+  BytesOut MplexFrameDecoder::buffer() {
+    if (begin_ != 0) {
+      std::copy(buffer_.begin() + begin_, buffer_.begin() + end_,
+                buffer_.begin());
+      end_ -= begin_;
+      begin_ = 0;
+    }
+    if (incomplete_ > buffer_.size()) {
+      buffer_.resize(incomplete_);
+    } else if (end_ == 0 and buffer_.size() > kBufferSize) {
+      // don't keep memory of large frame
+      buffer_.resize(kBufferSize);
+      buffer_.shrink_to_fit();
+    }
+    return BytesOut{buffer_}.subspan(end_);
+  }
 
-          // read second varint
-          basic::VarintReader::readVarint(
-              reader,
-              [reader,
-               cb{std::move(cb)},
-               id_flag =
-                   varint_res.value().toUInt64()](auto &&varint_res) mutable {
-                if (varint_res.has_error()) {
-                  return cb(varint_res.error());
-                }
+  void MplexFrameDecoder::onRead(size_t bytes) {
+    end_ += bytes;
+  }
 
-                auto length = varint_res.value().toUInt64();
-                if (length == 0) {
-                  // no data in this frame
-                  return cb(createFrame(id_flag, {}));
-                }
+  outcome::result<std::optional<MplexFrameDecoder::Frame>>
+  MplexFrameDecoder::next() {
+    auto bytes = BytesIn{buffer_}.subspan(begin_, end_ - begin_);
+    auto incomplete = [&](size_t size = 0)
+        -> outcome::result<std::optional<Frame>> {
+      // varints are incomplete or invalid
+      if (size == 0 and bytes.size() >= 2 * multi::UVarint::kMaxSize) {
+        return RawConnection::Error::CONNECTION_PROTOCOL_ERROR;
+      }
+      incomplete_ = size;
+      return std::nullopt;
+    };
 
-                // read data
-                std::shared_ptr<Bytes> data =
-                    std::make_shared<Bytes>(length, 0);
-                reader->read(*data,
-                             length,
-                             [id_flag, data, cb{std::move(cb)}](
-                                 auto &&read_res) mutable {
-                               if (!read_res) {
-                                 return cb(read_res.error());
-                               }
+    auto id_flag = multi::UVarint::decode(bytes);
+    if (not id_flag) {
+      return incomplete();
+    }
+    auto length = multi::UVarint::decode(bytes.subspan(id_flag->size));
+    if (not length) {
+      return incomplete();
+    }
+    if (length->value > max_data_size_) {
+      return RawConnection::Error::CONNECTION_PROTOCOL_ERROR;
+    }
+    auto header = id_flag->size + length->size;
+    auto size = header + length->value;
+    if (bytes.size() < size) {
+      return incomplete(size);
+    }
+    auto flag = parseFlag(id_flag->value);
+    if (not flag) {
+      return RawConnection::Error::CONNECTION_PROTOCOL_ERROR;
+    }
 
-                               cb(createFrame(id_flag, std::move(*data)));
-                             });
-              });
-        });
+    begin_ += size;
+    incomplete_ = 0;
+    return Frame{
+        .flag = *flag,
+        .stream_number =
+            static_cast<MplexStream::StreamNumber>(id_flag->value >> 3),
+        .data = bytes.subspan(header, length->value),
+    };
   }
 }  // namespace libp2p::connection
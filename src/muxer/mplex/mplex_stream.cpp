@@ -31,8 +31,22 @@ namespace libp2p::connection {
   }
 
   MplexStream::MplexStream(std::weak_ptr<MplexedConnection> connection,
-                           StreamId stream_id)
-      : connection_{std::move(connection)}, stream_id_{stream_id} {}
+                           StreamId stream_id,
+                           std::shared_ptr<muxer::MemoryScope> memory,
+                           size_t write_queue_limit,
+                           muxer::StreamPermit permit)
+      : connection_{std::move(connection)},
+        stream_id_{stream_id},
+        write_queue_limit_{write_queue_limit},
+        read_memory_{memory},
+        write_memory_{std::move(memory)},
+        permit_{std::move(permit)} {
+    if (auto conn = connection_.lock()) {
+      if (auto peer = conn->remotePeer()) {
+        meter_.attribute(peer.value());
+      }
+    }
+  }
 
   void MplexStream::read(BytesOut out, size_t bytes, ReadCallbackFunc cb) {
     ambigousSize(out, bytes);
@@ -59,7 +73,9 @@ namespace libp2p::connection {
       return true;
     }
     read_buffer_.consume(size);
+    read_memory_.release(size);
     receive_window_size_ += size;
+    meter_.onRead(0, 0, 1);
     readDone(size);
     return true;
   }
@@ -102,6 +118,11 @@ namespace libp2p::connection {
       return cb(Error::STREAM_INVALID_ARGUMENT);
     }
     if (is_writing_) {
+      // queued copies are exactly what is reserved
+      if (write_memory_.size() + in.size() > write_queue_limit_
+          or not write_memory_.reserve(in.size())) {
+        return cb(Error::STREAM_WRITE_OVERFLOW);
+      }
       std::vector<uint8_t> in_vector(in.begin(), in.end());
       std::lock_guard<std::mutex> lock(write_queue_mutex_);
       write_queue_.emplace_back(in_vector, bytes, cb);
@@ -122,6 +143,8 @@ namespace libp2p::connection {
             self->log_->error("write for stream {} failed: {}",
                               self->stream_id_.toString(),
                               write_res.error());
+          } else {
+            self->meter_.onWritten(write_res.value(), 1, 1);
           }
           cb(std::forward<decltype(write_res)>(write_res));
 
@@ -129,9 +152,14 @@ namespace libp2p::connection {
           // check if new write messages were received while stream was writing
           // and propagate these messages
           if (not self->write_queue_.empty()) {
-            auto [in, bytes, cb] = self->write_queue_.front();
+            auto [in, bytes, cb] = std::move(self->write_queue_.front());
             self->write_queue_.pop_front();
-            writeReturnSize(self, in, cb);
+            self->write_memory_.release(in.size());
+            // connection may wait for its queue to drain, keep data until then
+            auto data = std::make_shared<std::vector<uint8_t>>(std::move(in));
+            writeReturnSize(self, *data, [data, cb{std::move(cb)}](auto res) {
+              cb(res);
+            });
           }
         });
   }
@@ -192,6 +220,7 @@ namespace libp2p::connection {
     }
 
     is_reset_ = true;
+    permit_ = {};
     conn->streamReset(stream_id_);
   }
 
@@ -224,6 +253,35 @@ namespace libp2p::connection {
     return conn->remoteMultiaddr();
   }
 
+  void MplexStream::attributeTraffic(const peer::ProtocolName &protocol) {
+    if (auto conn = connection_.lock()) {
+      if (auto peer = conn->remotePeer()) {
+        meter_.attribute(peer.value(), protocol);
+      }
+    }
+  }
+
+  bool MplexStream::admitProtocol(const peer::ProtocolName &protocol) {
+    return permit_.admitProtocol(protocol);
+  }
+
+  metrics::MemoryUsage MplexStream::memoryUsage() const {
+    metrics::MemoryUsage usage{
+        .read_buffer = read_buffer_.size(),
+        .pending_callbacks = reading_ ? 1u : 0u,
+    };
+    std::lock_guard lock{write_queue_mutex_};
+    for (auto &[data, bytes, cb] : write_queue_) {
+      usage.write_queue += data.size();
+      ++usage.pending_callbacks;
+    }
+    return usage;
+  }
+
+  metrics::TrafficKey MplexStream::memoryKey() const {
+    return meter_.key();
+  }
+
   outcome::result<void> MplexStream::commitData(BytesIn data,
                                                 size_t data_size) {
     if (data_size == 0) {
@@ -234,7 +292,8 @@ namespace libp2p::connection {
       return Error::STREAM_RESET_BY_HOST;
     }
 
-    if (data_size > receive_window_size_) {
+    if (data_size > receive_window_size_
+        or not read_memory_.reserve(data_size)) {
       // we have received more data, than we can handle
       reset();
       return Error::STREAM_RECEIVE_OVERFLOW;
@@ -248,6 +307,7 @@ namespace libp2p::connection {
     }
     read_buffer_.commit(data_size);
     receive_window_size_ -= data_size;
+    meter_.onRead(data_size, 1);
 
     if (reading_.has_value()) {
       readTry();
@@ -6,18 +6,28 @@
 
 #include <libp2p/muxer/mplex/mplexed_connection.hpp>
 
+#include <algorithm>
+
 #include <boost/assert.hpp>
-#include <libp2p/basic/write_return_size.hpp>
-#include <libp2p/muxer/mplex/mplex_frame.hpp>
+#include <libp2p/multi/uvarint.hpp>
 
 namespace libp2p::connection {
   using StreamId = MplexStream::StreamId;
 
   MplexedConnection::MplexedConnection(
       std::shared_ptr<SecureConnection> connection,
-      muxer::MuxedConnectionConfig config)
-      : connection_{std::move(connection)}, config_{config} {
+      muxer::MuxedConnectionConfig config,
+      std::shared_ptr<muxer::MemoryScope> memory,
+      std::shared_ptr<muxer::StreamScope> streams)
+      : connection_{std::move(connection)},
+        config_{config},
+        memory_{std::move(memory)},
+        stream_limits_{std::move(streams)},
+        recorder_{"/mplex/6.7.0", connection_->isInitiator()} {
     BOOST_ASSERT(connection_);
+    if (auto peer = connection_->remotePeer()) {
+      meter_.attribute(peer.value());
+    }
   }
 
   void MplexedConnection::start() {
@@ -43,6 +53,10 @@ namespace libp2p::connection {
     if (streams_.size() >= config_.maximum_streams) {
       return Error::CONNECTION_TOO_MANY_STREAMS;
     }
+    auto permit = admitStream(muxer::StreamDirection::OUTBOUND);
+    if (not permit) {
+      return Error::CONNECTION_TOO_MANY_STREAMS;
+    }
 
     StreamId new_stream_id{last_issued_stream_number_++, true};
     auto new_stream_frame =
@@ -50,7 +64,11 @@ namespace libp2p::connection {
     write({std::move(new_stream_frame), [](auto &&) {}});
 
     auto new_stream =
-        std::make_shared<MplexStream>(shared_from_this(), new_stream_id);
+        std::make_shared<MplexStream>(shared_from_this(),
+                                      new_stream_id,
+                                      memory_,
+                                      config_.maximum_stream_write_queue_size,
+                                      std::move(permit.value()));
     streams_[new_stream_id] = new_stream;
     return new_stream;
   }
@@ -64,21 +82,34 @@ namespace libp2p::connection {
     if (streams_.size() >= config_.maximum_streams) {
       return cb(Error::CONNECTION_TOO_MANY_STREAMS);
     }
+    auto permit = admitStream(muxer::StreamDirection::OUTBOUND);
+    if (not permit) {
+      return cb(Error::CONNECTION_TOO_MANY_STREAMS);
+    }
 
     StreamId new_stream_id{last_issued_stream_number_++, true};
+    pending_permits_.emplace(new_stream_id, std::move(permit.value()));
     auto new_stream_frame =
         createFrameBytes(MplexFrame::Flag::NEW_STREAM, new_stream_id.number);
     write({std::move(new_stream_frame),
            [self{shared_from_this()}, cb{std::move(cb)}, new_stream_id](
                auto &&create_res) {
+             muxer::StreamPermit permit;
+             if (auto node = self->pending_permits_.extract(new_stream_id)) {
+               permit = std::move(node.mapped());
+             }
              if (!create_res) {
                self->log_->error("stream creation failed: {}",
                                  create_res.error());
                return cb(create_res.error());
              }
 
-             auto new_stream =
-                 std::make_shared<MplexStream>(self, new_stream_id);
+             auto new_stream = std::make_shared<MplexStream>(
+                 self,
+                 new_stream_id,
+                 self->memory_,
+                 self->config_.maximum_stream_write_queue_size,
+                 std::move(permit));
              self->streams_[new_stream_id] = new_stream;
              cb(std::move(new_stream));
            }});
@@ -115,6 +146,7 @@ namespace libp2p::connection {
 
   outcome::result<void> MplexedConnection::close() {
     is_active_ = false;
+    failBlockedWrites();
     resetAllStreams();
     streams_.clear();
     return connection_->close();
@@ -152,62 +184,256 @@ namespace libp2p::connection {
     connection_->deferWriteCallback(ec, std::move(cb));
   }
 
+  metrics::MemoryUsage MplexedConnection::memoryUsage() const {
+    metrics::MemoryUsage usage{.read_buffer = decoder_.capacity()};
+    auto add = [&](const WriteData &item) {
+      usage.write_queue += item.data.size();
+      ++usage.pending_callbacks;
+    };
+    std::for_each(write_queue_.begin(), write_queue_.end(), add);
+    std::for_each(writing_.items.begin(), writing_.items.end(), add);
+    for (auto &blocked : blocked_writes_) {
+      usage.write_queue += blocked.data.size();
+      ++usage.pending_callbacks;
+    }
+    return usage;
+  }
+
+  metrics::TrafficKey MplexedConnection::memoryKey() const {
+    return meter_.key();
+  }
+
   void MplexedConnection::write(WriteData data) {
-    write_queue_.push(std::move(data));
+    if (recorder_) {
+      recordWritten(data.data);
+    }
+    write_queue_.push_back(std::move(data));
     if (is_writing_) {
       return;
     }
     doWrite();
   }
 
+  void MplexedConnection::recordWritten(BytesIn frame) {
+    auto id_flag = multi::UVarint::decode(frame);
+    if (not id_flag) {
+      return;
+    }
+    auto length = multi::UVarint::decode(frame.subspan(id_flag->size));
+    if (not length) {
+      return;
+    }
+    recorder_.record(false,
+                     0,
+                     id_flag->value & 0x07,
+                     id_flag->value >> 3,
+                     length->value);
+  }
+
   void MplexedConnection::doWrite() {
     auto queue_empty = write_queue_.empty();
     if (queue_empty || isClosed()) {
       if (!queue_empty) {
-        decltype(write_queue_){}.swap(write_queue_);
+        write_queue_.clear();
+        queued_stream_bytes_ = 0;
       }
       is_writing_ = false;
       return;
     }
 
+    // coalesce queued frames into one vectored write
     is_writing_ = true;
-    const auto &write_data = write_queue_.front();
-    return writeReturnSize(
-        connection_, write_data.data, [self{shared_from_this()}](auto &&res) {
+    writing_ = {};
+    while (writing_.items.size() < kMaxFramesPerWrite
+           and not write_queue_.empty()) {
+      writing_.items.emplace_back(std::move(write_queue_.front()));
+      write_queue_.pop_front();
+    }
+    // buffers refer to items, no reallocations allowed
+    writing_.buffers.reserve(writing_.items.size());
+    for (auto &item : writing_.items) {
+      writing_.buffers.emplace_back(item.data);
+    }
+    continueWriting();
+  }
+
+  void MplexedConnection::continueWriting() {
+    connection_->writeSomeVectored(
+        writing_.unwritten(), [self{shared_from_this()}](auto &&res) {
           self->onWriteCompleted(std::forward<decltype(res)>(res));
         });
   }
 
   void MplexedConnection::onWriteCompleted(outcome::result<size_t> write_res) {
+    if (write_res) {
+      if (not writing_.advance(write_res.value())) {
+        log_->error("too large size written: {}", write_res.value());
+        write_res = Error::CONNECTION_INTERNAL_ERROR;
+      } else if (not writing_.unwritten().empty()) {
+        writing_.written += write_res.value();
+        return continueWriting();
+      } else {
+        meter_.onWritten(writing_.written + write_res.value(),
+                         writing_.items.size());
+      }
+    }
     if (!write_res) {
       log_->error("data write failed: {}", write_res.error());
     }
 
-    write_queue_.front().cb(std::forward<decltype(write_res)>(write_res));
-    write_queue_.pop();
+    auto items = std::move(writing_.items);
+    writing_ = {};
+    for (auto &item : items) {
+      queued_stream_bytes_ -= item.stream_bytes;
+    }
+    for (auto &item : items) {
+      if (!write_res) {
+        item.cb(write_res.error());
+      } else {
+        item.cb(item.data.size());
+      }
+    }
+    unblockWrites();
     doWrite();
   }
 
+  std::span<const BytesIn> MplexedConnection::WriteBatch::unwritten() const {
+    return std::span<const BytesIn>(buffers).subspan(unwritten_index);
+  }
+
+  bool MplexedConnection::WriteBatch::advance(size_t bytes) {
+    while (bytes > 0 && unwritten_index < buffers.size()) {
+      auto &buffer = buffers[unwritten_index];
+      if (bytes < buffer.size()) {
+        buffer = buffer.subspan(bytes);
+        return true;
+      }
+      bytes -= buffer.size();
+      ++unwritten_index;
+    }
+    return bytes == 0;
+  }
+
+  bool MplexedConnection::writeQueueFits(size_t bytes) const {
+    // a single write is allowed to exceed the limit, otherwise it would never
+    // be written
+    return queued_stream_bytes_ == 0
+        or queued_stream_bytes_ + bytes
+               <= config_.maximum_connection_write_queue_size;
+  }
+
+  void MplexedConnection::writeStreamData(StreamId stream_id,
+                                          BytesIn data,
+                                          WriteCallbackFunc cb) {
+    auto data_frame = createFrameBytes(stream_id.initiator
+                                           ? MplexFrame::Flag::MESSAGE_INITIATOR
+                                           : MplexFrame::Flag::MESSAGE_RECEIVER,
+                                       stream_id.number,
+                                       Bytes{data.begin(), data.end()});
+    queued_stream_bytes_ += data.size();
+    write({std::move(data_frame),
+           [cb{std::move(cb)}, bytes{data.size()}](auto &&write_res) {
+             if (!write_res) {
+               return cb(write_res.error());
+             }
+             cb(bytes);
+           },
+           data.size()});
+  }
+
+  void MplexedConnection::writeStreamClose(StreamId stream_id,
+                                           WriteCallbackFunc cb) {
+    write({createFrameBytes(stream_id.initiator
+                                ? MplexFrame::Flag::CLOSE_INITIATOR
+                                : MplexFrame::Flag::CLOSE_RECEIVER,
+                            stream_id.number),
+           std::move(cb)});
+  }
+
+  void MplexedConnection::unblockWrites() {
+    while (not blocked_writes_.empty()
+           and writeQueueFits(blocked_writes_.front().data.size())) {
+      auto blocked = std::move(blocked_writes_.front());
+      blocked_writes_.pop_front();
+      if (blocked.data.empty()) {
+        writeStreamClose(blocked.stream_id, std::move(blocked.cb));
+      } else {
+        writeStreamData(
+            blocked.stream_id, blocked.data, std::move(blocked.cb));
+      }
+    }
+  }
+
+  void MplexedConnection::failBlockedWrites(
+      boost::optional<StreamId> stream_id) {
+    std::vector<WriteCallbackFunc> callbacks;
+    std::erase_if(blocked_writes_, [&](BlockedWrite &blocked) {
+      if (stream_id and not(blocked.stream_id == *stream_id)) {
+        return false;
+      }
+      callbacks.emplace_back(std::move(blocked.cb));
+      return true;
+    });
+    for (auto &cb : callbacks) {
+      cb(Stream::Error::STREAM_RESET_BY_HOST);
+    }
+  }
+
   void MplexedConnection::readNextFrame() {
     if (isClosed()) {
       return;
     }
 
-    readFrame(connection_,
-              [self{shared_from_this()}](auto &&frame_res) mutable {
-                if (!frame_res) {
-                  self->log_->error("cannot read frame from the connection: {}",
-                                    frame_res.error());
-                  return self->closeSession();
-                }
+    auto buffer = decoder_.buffer();
+    connection_->readSome(buffer,
+                          buffer.size(),
+                          [self{shared_from_this()}](auto &&res) {
+                            self->onRead(std::forward<decltype(res)>(res));
+                          });
+  }
 
-                self->processFrame(std::move(frame_res.value()));
-              });
+  void MplexedConnection::onRead(outcome::result<size_t> res) {
+    if (isClosed()) {
+      return;
+    }
+    if (!res) {
+      log_->error("cannot read frame from the connection: {}", res.error());
+      return closeSession();
+    }
+    meter_.onRead(res.value());
+    decoder_.onRead(res.value());
+
+    // frames read at once are processed without reading again
+    while (true) {
+      auto frame_res = decoder_.next();
+      if (!frame_res) {
+        log_->error("cannot read frame from the connection: {}",
+                    frame_res.error());
+        return closeSession();
+      }
+      if (not frame_res.value()) {
+        break;
+      }
+      processFrame(*frame_res.value());
+      if (isClosed()) {
+        return;
+      }
+    }
+    readNextFrame();
   }
 
-  void MplexedConnection::processFrame(const MplexFrame &frame) {
+  void MplexedConnection::processFrame(const Frame &frame) {
     using Flag = MplexFrame::Flag;
 
+    meter_.onRead(0, 1);
+    if (recorder_) {
+      recorder_.record(true,
+                       0,
+                       static_cast<uint16_t>(frame.flag),
+                       frame.stream_number,
+                       frame.data.size());
+    }
+
     // we are initiators of this connection, if the other side is a receiver of
     // this connection (o rly?)
     auto this_side_is_initiator = (frame.flag != Flag::NEW_STREAM)
@@ -236,19 +462,27 @@ namespace libp2p::connection {
         log_->critical("garbage in frame's flag");
         return closeSession();
     }
-
-    readNextFrame();
   }
 
-  void MplexedConnection::processNewStreamFrame(const MplexFrame &frame,
+  void MplexedConnection::processNewStreamFrame(const Frame &frame,
                                                 StreamId stream_id) {
     if (streams_.size() >= config_.maximum_streams || !new_stream_handler_) {
       return resetStream(stream_id);
     }
+    auto permit = admitStream(muxer::StreamDirection::INBOUND);
+    if (not permit) {
+      log_->debug("stream limits exceeded, resetting stream {}",
+                  stream_id.toString());
+      return resetStream(stream_id);
+    }
 
     log_->info("accepting a new stream with {}", stream_id.toString());
-    auto new_stream =
-        std::make_shared<MplexStream>(weak_from_this(), stream_id);
+    auto new_stream = std::make_shared<MplexStream>(
+        weak_from_this(),
+        stream_id,
+        memory_,
+        config_.maximum_stream_write_queue_size,
+        std::move(permit.value()));
     streams_[stream_id] = new_stream;
     new_stream_handler_(std::move(new_stream));
   }
@@ -264,7 +498,7 @@ namespace libp2p::connection {
   }                                                      \
   auto(stream_var_name) = std::move(*stream_opt);
 
-  void MplexedConnection::processMessageFrame(const MplexFrame &frame,
+  void MplexedConnection::processMessageFrame(const Frame &frame,
                                               StreamId stream_id) {
     FIND_STREAM_OR_RESET(stream, stream_id)
 
@@ -277,7 +511,7 @@ namespace libp2p::connection {
     }
   }
 
-  void MplexedConnection::processCloseFrame(const MplexFrame &frame,
+  void MplexedConnection::processCloseFrame(const Frame &frame,
                                             StreamId stream_id) {
     FIND_STREAM_OR_RESET(stream, stream_id)
 
@@ -289,7 +523,7 @@ namespace libp2p::connection {
     stream->is_readable_ = true;
   }
 
-  void MplexedConnection::processResetFrame(const MplexFrame &frame,
+  void MplexedConnection::processResetFrame(const Frame &frame,
                                             StreamId stream_id) {
     if (auto stream_opt = findStream(stream_id); stream_opt) {
       (*stream_opt)->is_reset_ = true;
@@ -310,10 +544,20 @@ namespace libp2p::connection {
       streams_.erase(stream_id);
       (*stream_opt)->is_writable_ = false;
       (*stream_opt)->is_readable_ = false;
+      (*stream_opt)->permit_ = {};
+    }
+  }
+
+  std::optional<muxer::StreamPermit> MplexedConnection::admitStream(
+      muxer::StreamDirection direction) {
+    if (not stream_limits_) {
+      return muxer::StreamPermit{};
     }
+    return stream_limits_->admit(direction);
   }
 
   void MplexedConnection::resetStream(StreamId stream_id) {
+    failBlockedWrites(stream_id);
     write({createFrameBytes(stream_id.initiator
                                 ? MplexFrame::Flag::RESET_INITIATOR
                                 : MplexFrame::Flag::RESET_RECEIVER,
@@ -349,32 +593,33 @@ namespace libp2p::connection {
                                       BytesIn in,
                                       size_t bytes,
                                       basic::Writer::WriteCallbackFunc cb) {
-    Bytes data{in.begin(), in.begin() + bytes};
-    auto data_frame = createFrameBytes(stream_id.initiator
-                                           ? MplexFrame::Flag::MESSAGE_INITIATOR
-                                           : MplexFrame::Flag::MESSAGE_RECEIVER,
-                                       stream_id.number,
-                                       std::move(data));
-    write({std::move(data_frame), [cb{std::move(cb)}, bytes](auto &&write_res) {
-             if (!write_res) {
-               return cb(write_res.error());
-             }
-             cb(bytes);
-           }});
+    auto data = in.first(std::min(bytes, kMaxMessageSize));
+    if (not blocked_writes_.empty() or not writeQueueFits(data.size())) {
+      // the caller keeps the data until its callback is called
+      blocked_writes_.push_back({stream_id, data, std::move(cb)});
+      return;
+    }
+    writeStreamData(stream_id, data, std::move(cb));
   }
 
   void MplexedConnection::streamClose(
       StreamId stream_id, std::function<void(outcome::result<void>)> cb) {
-    auto close_frame =
-        createFrameBytes(stream_id.initiator ? MplexFrame::Flag::CLOSE_INITIATOR
-                                             : MplexFrame::Flag::CLOSE_RECEIVER,
-                         stream_id.number);
-    write({std::move(close_frame), [cb{std::move(cb)}](auto &&write_res) {
-             if (!write_res) {
-               return cb(write_res.error());
-             }
-             cb(outcome::success());
-           }});
+    auto on_written = [cb{std::move(cb)}](outcome::result<size_t> write_res) {
+      if (!write_res) {
+        return cb(write_res.error());
+      }
+      cb(outcome::success());
+    };
+    // close must follow blocked data of the stream
+    if (std::any_of(blocked_writes_.begin(),
+                    blocked_writes_.end(),
+                    [&](const BlockedWrite &blocked) {
+                      return blocked.stream_id == stream_id;
+                    })) {
+      blocked_writes_.push_back({stream_id, {}, std::move(on_written)});
+      return;
+    }
+    writeStreamClose(stream_id, std::move(on_written));
   }
 
   void MplexedConnection::streamReset(StreamId stream_id) {
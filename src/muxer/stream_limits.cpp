@@ -0,0 +1,197 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/muxer/stream_limits.hpp>
+
+#include <cassert>
+
+namespace libp2p::muxer {
+
+  namespace {
+    size_t index(StreamDirection direction) {
+      return direction == StreamDirection::INBOUND ? 0 : 1;
+    }
+
+    size_t limitOf(StreamCountLimit limit, StreamDirection direction) {
+      return direction == StreamDirection::INBOUND ? limit.inbound
+                                                   : limit.outbound;
+    }
+
+    std::unordered_map<peer::ProtocolName, StreamCountLimit> protocolLimits(
+        const StreamLimits &limits, bool peer) {
+      std::unordered_map<peer::ProtocolName, StreamCountLimit> result;
+      for (auto &[protocol, limit] : limits.protocols) {
+        auto &count = peer ? limit.peer : limit.process;
+        if (count.inbound != 0 or count.outbound != 0) {
+          result.emplace(protocol, count);
+        }
+      }
+      return result;
+    }
+  }  // namespace
+
+  StreamPermit::StreamPermit(std::shared_ptr<StreamScope> scope,
+                             StreamDirection direction)
+      : scope_{std::move(scope)}, direction_{direction} {}
+
+  StreamPermit::StreamPermit(StreamPermit &&other) noexcept
+      : scope_{std::move(other.scope_)},
+        direction_{other.direction_},
+        protocol_{std::move(other.protocol_)} {
+    other.protocol_.reset();
+  }
+
+  StreamPermit &StreamPermit::operator=(StreamPermit &&other) noexcept {
+    if (this != &other) {
+      release();
+      scope_ = std::move(other.scope_);
+      direction_ = other.direction_;
+      protocol_ = std::move(other.protocol_);
+      other.protocol_.reset();
+    }
+    return *this;
+  }
+
+  StreamPermit::~StreamPermit() {
+    release();
+  }
+
+  bool StreamPermit::admitProtocol(const peer::ProtocolName &protocol) {
+    if (not scope_) {
+      return true;
+    }
+    if (protocol_) {
+      scope_->remove(direction_, &protocol_.value());
+      protocol_.reset();
+    }
+    if (not scope_->add(direction_, &protocol)) {
+      return false;
+    }
+    protocol_ = protocol;
+    return true;
+  }
+
+  void StreamPermit::release() {
+    if (not scope_) {
+      return;
+    }
+    if (protocol_) {
+      scope_->remove(direction_, &protocol_.value());
+      protocol_.reset();
+    }
+    scope_->remove(direction_, nullptr);
+    scope_.reset();
+  }
+
+  bool StreamScope::Counter::add(StreamDirection direction) {
+    auto max = limitOf(limit, direction);
+    auto &counter = count[index(direction)];
+    if (max == 0) {
+      counter.fetch_add(1, std::memory_order_relaxed);
+      return true;
+    }
+    auto value = counter.load(std::memory_order_relaxed);
+    do {
+      if (value >= max) {
+        return false;
+      }
+    } while (not counter.compare_exchange_weak(
+        value, value + 1, std::memory_order_relaxed));
+    return true;
+  }
+
+  void StreamScope::Counter::remove(StreamDirection direction) {
+    [[maybe_unused]] auto value =
+        count[index(direction)].fetch_sub(1, std::memory_order_relaxed);
+    assert(value != 0);
+  }
+
+  StreamScope::StreamScope(
+      StreamCountLimit limit,
+      const std::unordered_map<peer::ProtocolName, StreamCountLimit>
+          &protocols,
+      std::shared_ptr<StreamScope> parent)
+      : total_{limit}, parent_{std::move(parent)} {
+    for (auto &[protocol, protocol_limit] : protocols) {
+      protocols_.try_emplace(protocol, protocol_limit);
+    }
+  }
+
+  std::optional<StreamPermit> StreamScope::admit(StreamDirection direction) {
+    if (not add(direction, nullptr)) {
+      return std::nullopt;
+    }
+    return StreamPermit{shared_from_this(), direction};
+  }
+
+  size_t StreamScope::count(StreamDirection direction) const {
+    return total_.count[index(direction)].load(std::memory_order_relaxed);
+  }
+
+  size_t StreamScope::count(StreamDirection direction,
+                            const peer::ProtocolName &protocol) const {
+    auto it = protocols_.find(protocol);
+    if (it == protocols_.end()) {
+      return 0;
+    }
+    return it->second.count[index(direction)].load(std::memory_order_relaxed);
+  }
+
+  StreamScope::Counter *StreamScope::counter(
+      const peer::ProtocolName *protocol) {
+    if (protocol == nullptr) {
+      return &total_;
+    }
+    auto it = protocols_.find(*protocol);
+    return it == protocols_.end() ? nullptr : &it->second;
+  }
+
+  bool StreamScope::add(StreamDirection direction,
+                        const peer::ProtocolName *protocol) {
+    auto counter = this->counter(protocol);
+    if (counter and not counter->add(direction)) {
+      return false;
+    }
+    if (parent_ and not parent_->add(direction, protocol)) {
+      if (counter) {
+        counter->remove(direction);
+      }
+      return false;
+    }
+    return true;
+  }
+
+  void StreamScope::remove(StreamDirection direction,
+                           const peer::ProtocolName *protocol) {
+    if (auto counter = this->counter(protocol)) {
+      counter->remove(direction);
+    }
+    if (parent_) {
+      parent_->remove(direction, protocol);
+    }
+  }
+
+  StreamManager::StreamManager(StreamLimits limits)
+      : peer_protocols_{protocolLimits(limits, true)},
+        process_{std::make_shared<StreamScope>(
+            limits.process, protocolLimits(limits, false), nullptr)},
+        peer_limit_{limits.peer} {}
+
+  std::shared_ptr<StreamScope> StreamManager::peerScope(
+      const peer::PeerId &peer) {
+    std::lock_guard lock{mutex_};
+    std::erase_if(peers_, [](auto &p) { return p.second.expired(); });
+    auto &weak = peers_[peer];
+    auto scope = weak.lock();
+    if (not scope) {
+      scope =
+          std::make_shared<StreamScope>(peer_limit_, peer_protocols_, process_);
+      weak = scope;
+    }
+    return scope;
+  }
+
+}  // namespace libp2p::muxer
@@ -12,8 +12,17 @@
 namespace libp2p::muxer {
   Yamux::Yamux(MuxedConnectionConfig config,
                std::shared_ptr<basic::Scheduler> scheduler,
-               std::shared_ptr<network::ConnectionManager> cmgr)
-      : config_{config}, scheduler_{std::move(scheduler)} {
+               std::shared_ptr<network::ConnectionManager> cmgr,
+               std::shared_ptr<MemoryManager> memory,
+               std::shared_ptr<BandwidthManager> bandwidth,
+               std::shared_ptr<connection::ConnectionHealth> health,
+               std::shared_ptr<StreamManager> streams)
+      : config_{config},
+        scheduler_{std::move(scheduler)},
+        memory_{std::move(memory)},
+        bandwidth_{std::move(bandwidth)},
+        health_{std::move(health)},
+        streams_{std::move(streams)} {
     assert(scheduler_);
     if (cmgr) {
       std::weak_ptr<network::ConnectionManager> w(cmgr);
@@ -38,12 +47,20 @@ namespace libp2p::muxer {
       log::createLogger("Yamux")->error("dead connection passed to muxer");
       return cb(std::errc::not_connected);
     }
-    if (auto res = conn->remotePeer(); res.has_error()) {
+    auto res = conn->remotePeer();
+    if (res.has_error()) {
       log::createLogger("Yamux")->error(
           "inactive connection passed to muxer: {}", res.error());
       return cb(res.error());
     }
     cb(std::make_shared<connection::YamuxedConnection>(
-        std::move(conn), scheduler_, close_cb_, config_));
+        std::move(conn),
+        scheduler_,
+        close_cb_,
+        config_,
+        memory_ ? memory_->connectionScope(res.value()) : nullptr,
+        bandwidth_,
+        health_,
+        streams_ ? streams_->peerScope(res.value()) : nullptr));
   }
 }  // namespace libp2p::muxer
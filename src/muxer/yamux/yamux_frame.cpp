@@ -5,6 +5,7 @@
  */
 
 #include <arpa/inet.h>
+#include <cassert>
 #include <cstring>
 #include <libp2p/common/byteutil.hpp>
 #include <libp2p/muxer/yamux/yamux_frame.hpp>
@@ -53,6 +54,12 @@ namespace libp2p::connection {
                                   0);
   }
 
+  void setSynFlag(Bytes &frame) {
+    assert(frame.size() >= YamuxFrame::kHeaderLength);
+    // flags are big-endian uint16 at offset 2, all of them in the low byte
+    frame[3] |= static_cast<uint8_t>(YamuxFrame::Flag::SYN);
+  }
+
   Bytes ackStreamMsg(YamuxFrame::StreamId stream_id) {
     TRACE("yamux ackStreamMsg, stream_id={}", stream_id);
     return YamuxFrame::frameBytes(YamuxFrame::kDefaultVersion,
@@ -8,7 +8,7 @@
 
 #include <cassert>
 
-#include <libp2p/log/logger.hpp>
+#include <libp2p/common/trace.hpp>
 
 namespace libp2p::connection {
 
@@ -64,7 +64,7 @@ namespace libp2p::connection {
     bytes_read = tail;
 
     if (read_data_stream_ == 0) {
-      log()->debug("discarding {} data bytes", head.size());
+      SL_DEBUG(log(), "discarding {} data bytes", head.size());
       return;
     }
 
@@ -116,6 +116,27 @@ namespace libp2p::connection {
     return on_header_(std::move(maybe_frame));
   }
 
+  std::pair<YamuxReadingState::StreamId, size_t>
+  YamuxReadingState::expectedData() const {
+    if (data_bytes_unread_ == 0) {
+      return {0, 0};
+    }
+    return {read_data_stream_, data_bytes_unread_};
+  }
+
+  std::pair<bool, bool> YamuxReadingState::onDataReadDirectly(size_t bytes) {
+    assert(bytes <= data_bytes_unread_);
+
+    data_bytes_unread_ -= std::min(bytes, data_bytes_unread_);
+    if (data_bytes_unread_ > 0) {
+      return {false, false};
+    }
+
+    std::pair<bool, bool> flags{rst_after_data_, fin_after_data_};
+    reset();
+    return flags;
+  }
+
   void YamuxReadingState::discardDataMessage() {
     read_data_stream_ = 0;
     rst_after_data_ = false;
@@ -6,6 +6,8 @@
 
 #include <libp2p/muxer/yamux/yamux_stream.hpp>
 
+#include <algorithm>
+#include <array>
 #include <cassert>
 
 #include <libp2p/basic/read_return_size.hpp>
@@ -29,19 +31,38 @@ namespace libp2p::connection {
       YamuxStreamFeedback &feedback,
       uint32_t stream_id,
       size_t maximum_window_size,
-      size_t write_queue_limit)
+      size_t write_queue_limit,
+      bool window_auto_tuning,
+      std::shared_ptr<muxer::MemoryScope> memory,
+      std::shared_ptr<muxer::BandwidthManager> bandwidth,
+      muxer::StreamPermit permit)
       : connection_(std::move(connection)),
         feedback_(feedback),
         stream_id_(stream_id),
         window_size_(YamuxFrame::kInitialWindowSize),
         peers_window_size_(YamuxFrame::kInitialWindowSize),
         maximum_window_size_(maximum_window_size),
+        window_auto_tuning_(window_auto_tuning),
+        epoch_started_(std::chrono::steady_clock::now()),
+        window_memory_(memory),
+        write_memory_(std::move(memory)),
+        bandwidth_(std::move(bandwidth)),
+        permit_(std::move(permit)),
         write_queue_(write_queue_limit) {
     assert(connection_);
     assert(stream_id_ > 0);
     assert(window_size_ <= maximum_window_size_);
     assert(peers_window_size_ <= maximum_window_size_);
     assert(write_queue_limit >= maximum_window_size_);
+    if (auto peer = connection_->remotePeer()) {
+      meter_.attribute(peer.value());
+      if (bandwidth_) {
+        upload_ = bandwidth_->limiter(
+            muxer::BandwidthDirection::UPLOAD, peer.value(), {});
+        download_ = bandwidth_->limiter(
+            muxer::BandwidthDirection::DOWNLOAD, peer.value(), {});
+      }
+    }
   }
 
   void YamuxStream::read(BytesOut out, size_t bytes, ReadCallbackFunc cb) {
@@ -166,6 +187,39 @@ namespace libp2p::connection {
     return connection_->remoteMultiaddr();
   }
 
+  void YamuxStream::attributeTraffic(const peer::ProtocolName &protocol) {
+    if (auto peer = connection_->remotePeer()) {
+      meter_.attribute(peer.value(), protocol);
+      if (bandwidth_) {
+        upload_ = bandwidth_->limiter(
+            muxer::BandwidthDirection::UPLOAD, peer.value(), protocol);
+        download_ = bandwidth_->limiter(
+            muxer::BandwidthDirection::DOWNLOAD, peer.value(), protocol);
+      }
+    }
+  }
+
+  bool YamuxStream::admitProtocol(const peer::ProtocolName &protocol) {
+    return permit_.admitProtocol(protocol);
+  }
+
+  void YamuxStream::setWriteWeight(uint8_t weight) {
+    write_weight_ = std::max<uint8_t>(weight, 1);
+  }
+
+  metrics::MemoryUsage YamuxStream::memoryUsage() const {
+    return {
+        .read_buffer = internal_read_buffer_.size(),
+        .write_queue = write_queue_.unsentBytes(),
+        .pending_callbacks = (read_cb_ ? 1u : 0u) + (window_size_cb_ ? 1u : 0u)
+                           + (close_cb_ ? 1u : 0u),
+    };
+  }
+
+  metrics::TrafficKey YamuxStream::memoryKey() const {
+    return meter_.key();
+  }
+
   void YamuxStream::increaseSendWindow(size_t delta) {
     if (delta > 0) {
       window_size_ += delta;
@@ -187,6 +241,7 @@ namespace libp2p::connection {
     }
 
     TRACE("stream {} read {} bytes", stream_id_, sz);
+    meter_.onRead(sz, 1);
 
     bool overflow = false;
     bool read_completed = false;
@@ -228,10 +283,11 @@ namespace libp2p::connection {
     if (!internal_read_buffer_.empty()) {
       overflow = (internal_read_buffer_.size() > peers_window_size_);
       if (overflow) {
-        log()->debug("read buffer overflow {} > {}, stream {}",
-                     internal_read_buffer_.size(),
-                     peers_window_size_,
-                     stream_id_);
+        SL_DEBUG(log(),
+                 "read buffer overflow {} > {}, stream {}",
+                 internal_read_buffer_.size(),
+                 peers_window_size_,
+                 stream_id_);
       } else {
         TRACE("stream {} receive window reduced by {} to {}",
               stream_id_,
@@ -248,7 +304,7 @@ namespace libp2p::connection {
     if (overflow) {
       doClose(Error::STREAM_RECEIVE_OVERFLOW, false);
     } else if (bytes_consumed > 0) {
-      feedback_.ackReceivedBytes(stream_id_, bytes_consumed);
+      ackConsumedBytes(bytes_consumed);
       TRACE("stream {} receive window increased by {} to {}",
             stream_id_,
             bytes_consumed,
@@ -261,6 +317,59 @@ namespace libp2p::connection {
     return overflow ? kRemoveStreamAndSendRst : kKeepStream;
   }
 
+  BytesOut YamuxStream::directReadBuffer() const {
+    if (!is_reading_ || is_direct_reading_ || close_reason_
+        || !internal_read_buffer_.empty()) {
+      return {};
+    }
+    return external_read_buffer_;
+  }
+
+  void YamuxStream::onDirectReadStarted() {
+    assert(is_reading_);
+    assert(!is_direct_reading_);
+    is_direct_reading_ = true;
+  }
+
+  void YamuxStream::onDirectReadCompleted(outcome::result<size_t> res) {
+    assert(is_direct_reading_);
+    is_direct_reading_ = false;
+
+    if (!is_reading_) {
+      return;
+    }
+
+    if (close_reason_ || !res) {
+      // close notification was postponed until client's buffer is released
+      auto cb_and_result = readCompleted();
+      if (!close_reason_) {
+        cb_and_result.second = res.error();
+      }
+      if (cb_and_result.first) {
+        cb_and_result.first(cb_and_result.second);
+      }
+      return;
+    }
+
+    auto bytes = res.value();
+    TRACE("stream {} read {} bytes directly", stream_id_, bytes);
+    meter_.onRead(bytes);
+
+    read_message_size_ = bytes;
+    auto cb_and_result = readCompleted();
+
+    ackConsumedBytes(bytes);
+
+    if (cb_and_result.first) {
+      cb_and_result.first(cb_and_result.second);
+    }
+  }
+
+  void YamuxStream::onReceiveOverflow() {
+    SL_DEBUG(log(), "receive window overflow, stream {}", stream_id_);
+    doClose(Error::STREAM_RECEIVE_OVERFLOW, true);
+  }
+
   YamuxStream::DataFromConnectionResult YamuxStream::onFINReceived() {
     if (isClosed()) {
       // already closed, maybe error
@@ -298,16 +407,25 @@ namespace libp2p::connection {
   }
 
   void YamuxStream::onDataWritten(size_t bytes) {
-    auto result = write_queue_.ackDataSent(bytes);
-    if (!result.data_consistent) {
-      log()->error("write queue ack failed, stream {}", stream_id_);
-      feedback_.resetStream(stream_id_);
-      doClose(Error::STREAM_INTERNAL_ERROR, true);
-      return;
-    }
+    meter_.onWritten(0, 1);
+
+    // one frame may carry data of several writes
+    while (bytes > 0 && !close_reason_) {
+      auto result = write_queue_.ackDataSent(bytes);
+      if (!result.data_consistent) {
+        log()->error("write queue ack failed, stream {}", stream_id_);
+        feedback_.resetStream(stream_id_);
+        doClose(Error::STREAM_INTERNAL_ERROR, true);
+        return;
+      }
 
-    if (result.cb) {
-      result.cb(result.size_to_ack);
+      bytes -= result.size_acked;
+      write_memory_.release(result.size_acked);
+      meter_.onWritten(result.size_acked);
+      if (result.cb) {
+        meter_.onWritten(0, 0, 1);
+        result.cb(result.size_to_ack);
+      }
     }
   }
 
@@ -328,7 +446,9 @@ namespace libp2p::connection {
     std::pair<ReadCallbackFunc, outcome::result<size_t>> read_cb_and_res{
         ReadCallbackFunc{}, 0};
 
-    if (notify_read_side && is_reading_) {
+    // if client's buffer is being filled directly, it will be notified on
+    // completion
+    if (notify_read_side && is_reading_ && !is_direct_reading_) {
       read_cb_and_res = readCompleted();
     }
 
@@ -337,6 +457,10 @@ namespace libp2p::connection {
     auto write_callbacks = write_queue_.getAllCallbacks();
 
     write_queue_.clear();
+    write_memory_.releaseAll();
+    permit_ = {};
+    upload_timer_.reset();
+    download_timer_.reset();
 
     auto close_cb_and_res = closeCompleted();
 
@@ -351,8 +475,14 @@ namespace libp2p::connection {
       read_cb_and_res.first(read_cb_and_res.second);
     }
 
-    for (const auto &cb : write_callbacks) {
-      cb(ec);
+    if (!write_callbacks.empty()) {
+      // data may still be referenced by the write operation in progress
+      feedback_.deferUntilDataReleased(
+          stream_id_, [write_callbacks{std::move(write_callbacks)}, ec] {
+            for (const auto &cb : write_callbacks) {
+              cb(ec);
+            }
+          });
     }
 
     if (window_size_cb) {
@@ -364,6 +494,92 @@ namespace libp2p::connection {
     }
   }
 
+  void YamuxStream::ackConsumedBytes(size_t bytes) {
+    // Like in go-yamux: if reader consumed whole window within a couple of
+    // round trips, the sender was limited by window rather than by reader,
+    // so the window is doubled. Slow readers give their growth back when
+    // it is needed by other streams
+    static constexpr size_t kGrowWithinRtts = 2;
+    if (window_auto_tuning_) {
+      epoch_consumed_ += bytes;
+      if (epoch_consumed_ >= peers_window_size_) {
+        auto now = std::chrono::steady_clock::now();
+        auto elapsed = now - epoch_started_;
+        auto rtt = feedback_.rtt();
+        bool fast = elapsed < rtt * kGrowWithinRtts;
+        epoch_started_ = now;
+        epoch_consumed_ = 0;
+        if (rtt == rtt.zero()) {
+          // round trip not measured yet
+        } else if (fast) {
+          auto granted = feedback_.growReceiveWindow(std::min(
+              peers_window_size_, maximum_window_size_ - peers_window_size_));
+          if (granted > 0 and not window_memory_.reserve(granted)) {
+            feedback_.shrinkReceiveWindow(granted);
+            granted = 0;
+          }
+          if (granted > 0) {
+            peers_window_size_ += granted;
+            window_growth_ += granted;
+            bytes += granted;
+            SL_DEBUG(log(),
+                     "stream {} receive window grown to {}",
+                     stream_id_,
+                     peers_window_size_);
+          }
+        } else if (window_growth_ > 0
+                   and (feedback_.receiveWindowPressure()
+                        or window_memory_.underPressure())) {
+          auto shrink = std::min({window_growth_,
+                                  peers_window_size_ / 2,
+                                  bytes});
+          peers_window_size_ -= shrink;
+          window_growth_ -= shrink;
+          bytes -= shrink;
+          feedback_.shrinkReceiveWindow(shrink);
+          window_memory_.release(shrink);
+          SL_DEBUG(log(),
+                   "stream {} receive window shrunk to {}",
+                   stream_id_,
+                   peers_window_size_);
+        }
+      }
+    }
+    if (bytes > 0) {
+      unacked_bytes_ += bytes;
+      ackPaced();
+    }
+  }
+
+  void YamuxStream::ackPaced() {
+    if (unacked_bytes_ == 0 or download_timer_) {
+      return;
+    }
+    auto bytes = unacked_bytes_;
+    if (download_.limited()) {
+      bytes = download_.available(bytes);
+      if (bytes < std::min(unacked_bytes_, kMinPacedBytes)) {
+        // remote side waits for window update meanwhile
+        download_timer_ = feedback_.scheduleCall(
+            [weak_self{weak_from_this()}] {
+              auto self = weak_self.lock();
+              if (not self) {
+                return;
+              }
+              self->download_timer_.reset();
+              if (self->is_readable_ and not self->close_reason_) {
+                self->ackPaced();
+              }
+            },
+            download_.throttle(std::min(unacked_bytes_, kMinPacedBytes)));
+        return;
+      }
+      download_.consume(bytes);
+    }
+    unacked_bytes_ -= bytes;
+    feedback_.ackReceivedBytes(stream_id_, bytes);
+  }
+
   void YamuxStream::doRead(BytesOut out, size_t bytes, ReadCallbackFunc cb) {
     assert(cb);
 
@@ -381,8 +597,9 @@ namespace libp2p::connection {
       assert(consumed > 0);
 
       if (is_readable_) {
-        feedback_.ackReceivedBytes(stream_id_, consumed);
+        ackConsumedBytes(consumed);
       }
+      meter_.onRead(0, 0, 1);
       return deferReadCallback(consumed, std::move(cb));
     }
 
@@ -430,6 +647,9 @@ namespace libp2p::connection {
             r.second = Error::STREAM_CLOSED_BY_PEER;
           }
         }
+        if (r.second) {
+          meter_.onRead(0, 0, 1);
+        }
       }
     }
     return r;
@@ -438,16 +658,35 @@ namespace libp2p::connection {
   void YamuxStream::doWrite() {
     size_t initial_window_size = window_size_;
 
-    BytesIn data;
-    while (!close_reason_) {
-      window_size_ = write_queue_.dequeue(window_size_, data);
+    std::array<BytesIn, kMaxChunksPerFrame> chunks;
+    while (!close_reason_ && !upload_timer_) {
+      auto limit = window_size_;
+      if (upload_.limited()) {
+        auto wanted = std::min(window_size_, write_queue_.unsentBytes());
+        limit = upload_.available(wanted);
+        if (wanted > 0 && limit < std::min(wanted, kMinPacedBytes)) {
+          upload_timer_ = feedback_.scheduleCall(
+              [weak_self{weak_from_this()}] {
+                if (auto self = weak_self.lock()) {
+                  self->upload_timer_.reset();
+                  self->doWrite();
+                }
+              },
+              upload_.throttle(std::min(wanted, kMinPacedBytes)));
+          break;
+        }
+      }
+      std::span<BytesIn> data{chunks};
+      auto left = write_queue_.dequeueMany(limit, data);
       if (data.empty()) {
         break;
       }
-      TRACE("stream {} dequeued {}/{} bytes to write",
+      window_size_ -= limit - left;
+      upload_.consume(limit - left);
+      TRACE("stream {} dequeued {} chunks, {} bytes unsent",
             stream_id_,
             data.size(),
-            write_queue_.unsentBytes() + data.size());
+            write_queue_.unsentBytes());
       feedback_.writeStreamData(stream_id_, data);
     }
 
@@ -458,7 +697,8 @@ namespace libp2p::connection {
             window_size_);
     }
 
-    if (!is_writable_ && !close_reason_ && window_size_ > 0) {
+    if (!is_writable_ && !close_reason_ && window_size_ > 0
+        && write_queue_.unsentBytes() == 0) {
       // closing stream for writes, sends FIN
       if (!fin_sent_) {
         fin_sent_ = true;
@@ -490,7 +730,7 @@ namespace libp2p::connection {
               outcome::result<size_t>) mutable { cb(std::move(res)); });
     }
 
-    if (!write_queue_.canEnqueue(bytes)) {
+    if (!write_queue_.canEnqueue(bytes) || !write_memory_.reserve(bytes)) {
       return deferWriteCallback(Error::STREAM_WRITE_OVERFLOW, std::move(cb));
     }
 
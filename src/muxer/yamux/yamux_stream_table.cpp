@@ -0,0 +1,129 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/muxer/yamux/yamux_stream_table.hpp>
+
+#include <utility>
+
+#include <libp2p/muxer/yamux/yamux_stream.hpp>
+
+namespace libp2p::connection {
+
+  YamuxStreamTable::Iterator YamuxStreamTable::find(StreamId id) {
+    auto index = slot(id);
+    return index != nullptr ? entries_.begin() + *index : entries_.end();
+  }
+
+  void YamuxStreamTable::insert(StreamId id,
+                                std::shared_ptr<YamuxStream> stream) {
+    if (auto index = slot(id)) {
+      entries_[*index].second = std::move(stream);
+      return;
+    }
+    auto index = static_cast<Index>(entries_.size());
+    entries_.emplace_back(id, std::move(stream));
+    place(id, index);
+  }
+
+  void YamuxStreamTable::erase(StreamId id) {
+    auto index_ptr = slot(id);
+    if (index_ptr == nullptr) {
+      return;
+    }
+    auto index = *index_ptr;
+    auto &window = windows_[id & 1];
+    auto key = id >> 1;
+    if (key >= window.base and key - window.base < window.slots.size()
+        and window.slots[key - window.base] == index) {
+      window.slots[key - window.base] = kNone;
+      trim(window);
+    } else {
+      overflow_.erase(id);
+    }
+
+    if (index + 1 != entries_.size()) {
+      entries_[index] = std::move(entries_.back());
+      *slot(entries_[index].first) = index;
+    }
+    entries_.pop_back();
+  }
+
+  void YamuxStreamTable::swap(YamuxStreamTable &other) noexcept {
+    entries_.swap(other.entries_);
+    windows_.swap(other.windows_);
+    overflow_.swap(other.overflow_);
+  }
+
+  const YamuxStreamTable::Index *YamuxStreamTable::slot(StreamId id) const {
+    auto &window = windows_[id & 1];
+    auto key = id >> 1;
+    if (key >= window.base and key - window.base < window.slots.size()) {
+      auto &index = window.slots[key - window.base];
+      if (index != kNone) {
+        return &index;
+      }
+    }
+    if (overflow_.empty()) {
+      return nullptr;
+    }
+    auto it = overflow_.find(id);
+    return it != overflow_.end() ? &it->second : nullptr;
+  }
+
+  YamuxStreamTable::Index *YamuxStreamTable::slot(StreamId id) {
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+    return const_cast<Index *>(std::as_const(*this).slot(id));
+  }
+
+  void YamuxStreamTable::place(StreamId id, Index index) {
+    auto parity = id & 1;
+    auto &window = windows_[parity];
+    auto key = id >> 1;
+    if (window.slots.empty()) {
+      window.base = key;
+      window.slots.push_back(index);
+      return;
+    }
+    if (key < window.base) {
+      // remote reopens old id, not stretching window for it
+      if (window.base - key + window.slots.size() > kMaxWindow) {
+        overflow_.emplace(id, index);
+        return;
+      }
+      window.slots.insert(window.slots.begin(), window.base - key, kNone);
+      window.base = key;
+      window.slots.front() = index;
+      return;
+    }
+    // long lived streams at the front go to overflow
+    while (not window.slots.empty() and key - window.base >= kMaxWindow) {
+      if (window.slots.front() != kNone) {
+        overflow_.emplace((window.base << 1) | parity, window.slots.front());
+      }
+      window.slots.pop_front();
+      ++window.base;
+      trim(window);
+    }
+    if (window.slots.empty()) {
+      window.base = key;
+    }
+    auto offset = key - window.base;
+    if (offset >= window.slots.size()) {
+      window.slots.resize(offset + 1, kNone);
+    }
+    window.slots[offset] = index;
+  }
+
+  void YamuxStreamTable::trim(Window &window) {
+    while (not window.slots.empty() and window.slots.front() == kNone) {
+      window.slots.pop_front();
+      ++window.base;
+    }
+    while (not window.slots.empty() and window.slots.back() == kNone) {
+      window.slots.pop_back();
+    }
+  }
+}  // namespace libp2p::connection
@@ -6,12 +6,14 @@
 
 #include <libp2p/muxer/yamux/yamuxed_connection.hpp>
 
+#include <algorithm>
+
 #include <boost/asio/error.hpp>
 
 #include <libp2p/basic/read_return_size.hpp>
-#include <libp2p/basic/write_return_size.hpp>
 #include <libp2p/common/ambigous_size.hpp>
-#include <libp2p/log/logger.hpp>
+#include <libp2p/common/metrics/registry.hpp>
+#include <libp2p/common/trace.hpp>
 
 namespace libp2p::connection {
 
@@ -21,6 +23,38 @@ namespace libp2p::connection {
       return logger;
     }
 
+    /// Adds delta to the entry of stream, there are few streams per read
+    void addWindow(std::vector<std::pair<uint32_t, size_t>> &windows,
+                   uint32_t stream_id,
+                   size_t delta) {
+      for (auto &[id, total] : windows) {
+        if (id == stream_id) {
+          total += delta;
+          return;
+        }
+      }
+      windows.emplace_back(stream_id, delta);
+    }
+
+    /// Free read buffers kept for new connections, so that about 4 MiB stay
+    /// allocated after a burst of connections closes
+    constexpr size_t kMaxFreeReadBuffers = 16;
+
+    /// Pooled read buffers, fit initial window plus some headers
+    const std::shared_ptr<basic::BufferPool> &readBufferPool() {
+      static auto pool = basic::BufferPool::create(
+          YamuxFrame::kInitialWindowSize + 4096, kMaxFreeReadBuffers);
+      return pool;
+    }
+
+    /// Frames waiting to be written by all yamux connections
+    metrics::Gauge &writeQueueGauge() {
+      static auto &gauge = metrics::Registry::instance().gauge(
+          "libp2p_yamux_write_queue_frames",
+          "Frames enqueued to yamux connections and not yet written");
+      return gauge;
+    }
+
     inline bool isOutbound(uint32_t our_stream_id, uint32_t their_stream_id) {
       // streams id oddness and evenness, depends on connection direction,
       // outbound or inbound, resp.
@@ -33,11 +67,15 @@ namespace libp2p::connection {
       std::shared_ptr<SecureConnection> connection,
       std::shared_ptr<basic::Scheduler> scheduler,
       ConnectionClosedCallback closed_callback,
-      muxer::MuxedConnectionConfig config)
+      muxer::MuxedConnectionConfig config,
+      std::shared_ptr<muxer::MemoryScope> memory,
+      std::shared_ptr<muxer::BandwidthManager> bandwidth,
+      std::shared_ptr<ConnectionHealth> health,
+      std::shared_ptr<muxer::StreamScope> streams)
       : config_(config),
         connection_(std::move(connection)),
         scheduler_(std::move(scheduler)),
-        raw_read_buffer_(std::make_shared<Buffer>()),
+        raw_read_buffer_(readBufferPool()->allocate()),
         reading_state_(
             [this](boost::optional<YamuxFrame> header) {
               return processHeader(std::move(header));
@@ -46,6 +84,10 @@ namespace libp2p::connection {
               if (!segment.empty()) {
                 processData(segment, stream_id);
               }
+              if (rst or fin) {
+                // flags apply after all data of the stream
+                flushData(stream_id);
+              }
               if (rst) {
                 processRst(stream_id);
               }
@@ -53,16 +95,26 @@ namespace libp2p::connection {
                 processFin(stream_id);
               }
             }),
+        recorder_("/yamux/1.0.0", connection_->isInitiator()),
+        health_(std::move(health)),
         closed_callback_(std::move(closed_callback)),
 
         // yes, sort of assert
-        remote_peer_(std::move(connection_->remotePeer().value())) {
+        remote_peer_(std::move(connection_->remotePeer().value())),
+        memory_(std::move(memory)),
+        bandwidth_(std::move(bandwidth)),
+        stream_limits_(std::move(streams)),
+        stream_memory_(std::make_shared<basic::FreeList>(kMaxFreeStreams)) {
     assert(scheduler_);
     assert(config_.maximum_streams > 0);
     assert(config_.maximum_window_size >= YamuxFrame::kInitialWindowSize);
 
-    raw_read_buffer_->resize(YamuxFrame::kInitialWindowSize + 4096);
     new_stream_id_ = (connection_->isInitiator() ? 1 : 2);
+    meter_.attribute(remote_peer_);
+  }
+
+  YamuxedConnection::~YamuxedConnection() {
+    writeQueueGauge().sub(queuedFrames());
   }
 
   void YamuxedConnection::start() {
@@ -74,8 +126,17 @@ namespace libp2p::connection {
 
     setTimerCleanup();
 
+    if (config_.window_auto_tuning) {
+      // receive windows are tuned by round trip time, measure it early
+      sendPing();
+    }
+
     if (config_.ping_interval != std::chrono::milliseconds::zero()) {
-      setTimerPing();
+      if (health_) {
+        health_->add(*this, config_.ping_interval);
+      } else {
+        setTimerPing();
+      }
     }
 
     continueReading();
@@ -87,6 +148,7 @@ namespace libp2p::connection {
       return;
     }
     started_ = false;
+    stopHealthCheck();
   }
 
   outcome::result<std::shared_ptr<Stream>> YamuxedConnection::newStream() {
@@ -98,12 +160,26 @@ namespace libp2p::connection {
       return Error::CONNECTION_TOO_MANY_STREAMS;
     }
 
+    auto permit = admitStream(muxer::StreamDirection::OUTBOUND);
+    if (not permit) {
+      return Error::CONNECTION_TOO_MANY_STREAMS;
+    }
+
     auto stream_id = new_stream_id_;
     new_stream_id_ += 2;
-    enqueue(newStreamMsg(stream_id));
+    // SYN waits for the first frame of stream, e.g. with multiselect
+    // proposal, to save a frame and a separate write
+    if (unsent_syn_.empty()) {
+      deferCall([weak{weak_from_this()}] {
+        if (auto self = weak.lock()) {
+          self->flushSyn();
+        }
+      });
+    }
+    unsent_syn_.emplace(stream_id);
 
     // Now we self-acked the new stream
-    return createStream(stream_id);
+    return createStream(stream_id, std::move(permit.value()));
   }
 
   void YamuxedConnection::newStream(StreamHandlerFunc cb) {
@@ -113,7 +189,10 @@ namespace libp2p::connection {
           [cb = std::move(cb)](auto) { cb(Error::CONNECTION_NOT_ACTIVE); });
     }
 
-    if (streams_.size() >= config_.maximum_streams) {
+    auto permit = streams_.size() < config_.maximum_streams
+                    ? admitStream(muxer::StreamDirection::OUTBOUND)
+                    : std::nullopt;
+    if (not permit) {
       return connection_->deferWriteCallback(
           std::error_code{}, [cb = std::move(cb)](auto) {
             cb(Error::CONNECTION_TOO_MANY_STREAMS);
@@ -124,13 +203,49 @@ namespace libp2p::connection {
     new_stream_id_ += 2;
     enqueue(newStreamMsg(stream_id));
     pending_outbound_streams_[stream_id] = std::move(cb);
-    inactivity_handle_.reset();
+    pending_permits_.emplace(stream_id, std::move(permit.value()));
+    inactivity_timer_.cancel();
   }
 
   void YamuxedConnection::onStream(NewStreamHandlerFunc cb) {
     new_stream_handler_ = std::move(cb);
   }
 
+  ConnectionLoad YamuxedConnection::load() const {
+    ConnectionLoad load{.streams = streams_.size()};
+    for (auto &[id, stream] : streams_) {
+      load.unsent_bytes += stream->unsentBytes();
+    }
+    if (rtt_ != rtt_.zero()) {
+      load.rtt = rtt_;
+    }
+    return load;
+  }
+
+  metrics::MemoryUsage YamuxedConnection::memoryUsage() const {
+    // stream data is not copied, it is reported by streams
+    metrics::MemoryUsage usage{
+        .read_buffer = raw_read_buffer_.size(),
+        .pending_callbacks = pending_outbound_streams_.size(),
+    };
+    auto add = [&](const WriteQueueItem &item) {
+      usage.write_queue += item.packet.size();
+    };
+    std::for_each(write_queue_.begin(), write_queue_.end(), add);
+    for (auto &[id, writes] : stream_writes_) {
+      std::for_each(writes.items.begin(), writes.items.end(), add);
+    }
+    if (writing_) {
+      std::for_each(writing_->items.begin(), writing_->items.end(), add);
+      usage.pending_callbacks += writing_->on_released.size();
+    }
+    return usage;
+  }
+
+  metrics::TrafficKey YamuxedConnection::memoryKey() const {
+    return meter_.key();
+  }
+
   outcome::result<peer::PeerId> YamuxedConnection::localPeer() const {
     return connection_->localPeer();
   }
@@ -198,8 +313,11 @@ namespace libp2p::connection {
 
   void YamuxedConnection::continueReading() {
     SL_TRACE(log(), "YamuxedConnection::continueReading");
-    connection_->readSome(*raw_read_buffer_,
-                          raw_read_buffer_->size(),
+    if (continueReadingDirectly()) {
+      return;
+    }
+    connection_->readSome(raw_read_buffer_.span(),
+                          raw_read_buffer_.size(),
                           [wptr = weak_from_this(), buffer = raw_read_buffer_](
                               outcome::result<size_t> res) {
                             auto self = wptr.lock();
@@ -209,36 +327,139 @@ namespace libp2p::connection {
                           });
   }
 
+  bool YamuxedConnection::continueReadingDirectly() {
+    if (config_.min_direct_read_size == 0) {
+      return false;
+    }
+
+    auto [stream_id, expected] = reading_state_.expectedData();
+    if (stream_id == 0 || expected < config_.min_direct_read_size) {
+      return false;
+    }
+
+    auto it = streams_.find(stream_id);
+    if (it == streams_.end()) {
+      return false;
+    }
+
+    auto out = it->second->directReadBuffer();
+    if (out.size() < config_.min_direct_read_size) {
+      return false;
+    }
+
+    auto stream = it->second;
+    // client's buffer bypasses overflow check of onDataReceived()
+    if (expected > stream->receiveWindow()) {
+      eraseStream(stream_id);
+      enqueue(resetStreamMsg(stream_id));
+      stream->onReceiveOverflow();
+      return !started_;
+    }
+
+    out = out.first(std::min<size_t>(out.size(), expected));
+
+    SL_TRACE(log(),
+             "reading {} bytes directly into stream {}",
+             out.size(),
+             stream_id);
+
+    stream->onDirectReadStarted();
+    connection_->readSome(
+        out,
+        out.size(),
+        [wptr = weak_from_this(), stream](outcome::result<size_t> res) {
+          if (auto self = wptr.lock()) {
+            self->onDirectRead(stream, res);
+          } else {
+            stream->onDirectReadCompleted(
+                make_error_code(boost::asio::error::operation_aborted));
+          }
+        });
+    return true;
+  }
+
+  void YamuxedConnection::onDirectRead(
+      const std::shared_ptr<YamuxStream> &stream,
+      outcome::result<size_t> res) {
+    if (!started_ || !res) {
+      if (!res) {
+        onReadError(res.error());
+      }
+      stream->onDirectReadCompleted(
+          res ? outcome::result<size_t>(Error::CONNECTION_NOT_ACTIVE) : res);
+      return;
+    }
+
+    auto stream_id = reading_state_.expectedData().first;
+    auto [rst, fin] = reading_state_.onDataReadDirectly(res.value());
+
+    SL_TRACE(log(), "read {} bytes directly", res.value());
+    meter_.onRead(res.value());
+
+    stream->onDirectReadCompleted(res);
+
+    if (!started_) {
+      return;
+    }
+
+    if (rst) {
+      processRst(stream_id);
+    }
+    if (fin) {
+      processFin(stream_id);
+    }
+
+    if (!started_) {
+      return;
+    }
+
+    continueReading();
+  }
+
+  void YamuxedConnection::onReadError(std::error_code ec) {
+    if (!started_) {
+      return;
+    }
+    if (ec == make_error_code(boost::asio::error::eof)) {
+      ec = Error::CONNECTION_CLOSED_BY_PEER;
+    }
+    close(ec, boost::none);
+  }
+
   void YamuxedConnection::onRead(outcome::result<size_t> res) {
     if (!started_) {
       return;
     }
 
     if (!res) {
-      if (res.error() == make_error_code(boost::asio::error::eof)) {
-        res.error() = Error::CONNECTION_CLOSED_BY_PEER;
-      }
-      close(std::move(res.error()), boost::none);
+      onReadError(res.error());
       return;
     }
 
     auto n = res.value();
-    BytesOut bytes_read(*raw_read_buffer_);
+    BytesOut bytes_read = raw_read_buffer_.span();
+    meter_.onRead(n);
+    healthActive();
 
     SL_TRACE(log(), "read {} bytes", n);
 
-    assert(n <= raw_read_buffer_->size());
+    assert(n <= raw_read_buffer_.size());
 
-    if (n < raw_read_buffer_->size()) {
+    if (n < raw_read_buffer_.size()) {
       bytes_read = bytes_read.first(n);
     }
 
+    batching_reads_ = true;
     reading_state_.onDataReceived(bytes_read);
+    flushData();
+    batching_reads_ = false;
 
     if (!started_) {
       return;
     }
 
+    flushWindows();
+
     std::vector<std::pair<StreamId, StreamHandlerFunc>> streams_created;
     streams_created.swap(fresh_streams_);
     for (const auto &[id, handler] : streams_created) {
@@ -280,8 +501,24 @@ namespace libp2p::connection {
     }
 
     SL_TRACE(log(), "YamuxedConnection::processHeader");
+    meter_.onRead(0, 1);
 
     auto &frame = header.value();
+    if (batching_reads_
+        and (frame.flags != 0 or frame.type == FrameType::GO_AWAY)) {
+      // frame may change state of streams, data received before it goes first
+      flushData();
+      if (!started_) {
+        return false;
+      }
+    }
+    if (recorder_) {
+      recorder_.record(true,
+                       static_cast<uint8_t>(frame.type),
+                       frame.flags,
+                       frame.stream_id,
+                       frame.length);
+    }
 
     if (frame.type == FrameType::GO_AWAY) {
       processGoAway(frame);
@@ -324,11 +561,59 @@ namespace libp2p::connection {
     assert(stream_id != 0);
     assert(!segment.empty());
 
+    if (!batching_reads_) {
+      return deliverData(segment, stream_id);
+    }
+    if (!streams_.contains(stream_id)) {
+      SL_DEBUG(log(), "stream {} no longer exists", stream_id);
+      reading_state_.discardDataMessage();
+      return;
+    }
+    // few streams per read
+    auto it = std::ranges::find(
+        received_data_, stream_id, &ReceivedData::stream_id);
+    if (it == received_data_.end()) {
+      received_data_.push_back({stream_id, segment, {}});
+      return;
+    }
+    if (it->joined.empty()) {
+      it->joined.assign(it->segment.begin(), it->segment.end());
+    }
+    it->joined.insert(it->joined.end(), segment.begin(), segment.end());
+  }
+
+  void YamuxedConnection::flushData(StreamId stream_id) {
+    auto it = std::ranges::find(
+        received_data_, stream_id, &ReceivedData::stream_id);
+    if (it == received_data_.end()) {
+      return;
+    }
+    auto data = std::move(*it);
+    received_data_.erase(it);
+    deliverData(data.joined.empty() ? data.segment : BytesOut{data.joined},
+                stream_id);
+  }
+
+  void YamuxedConnection::flushData() {
+    // streams don't parse frames, so nothing is added while delivering
+    for (auto &data : received_data_) {
+      if (!started_) {
+        break;
+      }
+      deliverData(data.joined.empty() ? data.segment : BytesOut{data.joined},
+                  data.stream_id);
+    }
+    received_data_.clear();
+  }
+
+  void YamuxedConnection::deliverData(BytesOut segment, StreamId stream_id) {
     auto it = streams_.find(stream_id);
     if (it == streams_.end()) {
       // this may be due to overflow in previous fragments of same message
       SL_DEBUG(log(), "stream {} no longer exists", stream_id);
-      reading_state_.discardDataMessage();
+      if (reading_state_.expectedData().first == stream_id) {
+        reading_state_.discardDataMessage();
+      }
       return;
     }
 
@@ -343,7 +628,6 @@ namespace libp2p::connection {
     }
 
     eraseStream(stream_id);
-    reading_state_.discardDataMessage();
 
     if (result == YamuxStream::kRemoveStreamAndSendRst) {
       // overflow, reset this stream
@@ -398,8 +682,17 @@ namespace libp2p::connection {
       return false;
     }
 
+    auto permit = admitStream(muxer::StreamDirection::INBOUND);
+    if (not permit) {
+      SL_DEBUG(log(),
+               "stream limits exceeded, resetting inbound stream {}",
+               frame.stream_id);
+      enqueue(resetStreamMsg(frame.stream_id));
+      return true;
+    }
+
     SL_DEBUG(log(), "creating inbound stream {}", frame.stream_id);
-    std::ignore = createStream(frame.stream_id);
+    std::ignore = createStream(frame.stream_id, std::move(permit.value()));
 
     enqueue(ackStreamMsg(frame.stream_id));
 
@@ -419,7 +712,22 @@ namespace libp2p::connection {
         SL_DEBUG(log(), "received ACK on zero stream id");
         ok = false;
       } else {
-        // pong has come. TODO(artem): measure latency
+        auto now = std::chrono::steady_clock::now();
+        if (frame.length == ping_counter_) {
+          // the latest ping is answered
+          auto sample = std::chrono::duration_cast<std::chrono::microseconds>(
+              now - ping_sent_at_);
+          rtt_ = rtt_ == rtt_.zero() ? sample : (rtt_ * 7 + sample) / 8;
+          SL_TRACE(log(), "ping #{} rtt {}us", ping_counter_, sample.count());
+        }
+        auto it = std::ranges::find(
+            pending_pings_, frame.length, &PendingPing::id);
+        if (it != pending_pings_.end()) {
+          auto ping = std::move(*it);
+          pending_pings_.erase(it);
+          ping.cb(std::chrono::duration_cast<std::chrono::microseconds>(
+              now - ping.sent_at));
+        }
         return true;
       }
 
@@ -452,7 +760,11 @@ namespace libp2p::connection {
 
     SL_DEBUG(log(), "creating outbound stream {}", frame.stream_id);
 
-    std::ignore = createStream(frame.stream_id);
+    muxer::StreamPermit permit;
+    if (auto node = pending_permits_.extract(frame.stream_id)) {
+      permit = std::move(node.mapped());
+    }
+    std::ignore = createStream(frame.stream_id, std::move(permit));
 
     // handler will be called after all inbound bytes processed
     fresh_streams_.emplace_back(frame.stream_id, std::move(stream_handler));
@@ -515,6 +827,11 @@ namespace libp2p::connection {
   }
 
   bool YamuxedConnection::processWindowUpdate(const YamuxFrame &frame) {
+    if (batching_reads_ and frame.flags == 0) {
+      // plain window update, order relative to other frames doesn't matter
+      addWindow(received_windows_, frame.stream_id, frame.length);
+      return true;
+    }
     auto it = streams_.find(frame.stream_id);
     if (it != streams_.end()) {
       it->second->increaseSendWindow(frame.length);
@@ -526,6 +843,55 @@ namespace libp2p::connection {
     return true;
   }
 
+  bool YamuxedConnection::openWith(StreamId stream_id, Buffer &frame) {
+    if (not unsent_syn_.empty() and unsent_syn_.erase(stream_id) != 0) {
+      setSynFlag(frame);
+      return true;
+    }
+    return false;
+  }
+
+  void YamuxedConnection::enqueueWindowUpdate(StreamId stream_id,
+                                              uint32_t bytes) {
+    auto frame = windowUpdateMsg(stream_id, bytes);
+    openWith(stream_id, frame);
+    if (auto it = stream_writes_.find(stream_id);
+        it != stream_writes_.end() and it->second.syn) {
+      return enqueueStreamFrame(std::move(frame), stream_id);
+    }
+    enqueue(std::move(frame));
+  }
+
+  void YamuxedConnection::flushSyn() {
+    if (not started_) {
+      return;
+    }
+    for (auto stream_id : std::exchange(unsent_syn_, {})) {
+      enqueue(newStreamMsg(stream_id));
+    }
+  }
+
+  void YamuxedConnection::flushWindows() {
+    for (auto &[stream_id, delta] : received_windows_) {
+      auto it = streams_.find(stream_id);
+      if (it != streams_.end()) {
+        it->second->increaseSendWindow(delta);
+      } else {
+        SL_DEBUG(log(), "flushWindows: stream {} not found", stream_id);
+      }
+      if (!started_) {
+        break;
+      }
+    }
+    received_windows_.clear();
+    for (auto &[stream_id, bytes] : acked_windows_) {
+      if (started_) {
+        enqueueWindowUpdate(stream_id, static_cast<uint32_t>(bytes));
+      }
+    }
+    acked_windows_.clear();
+  }
+
   void YamuxedConnection::close(
       std::error_code notify_streams_code,
       boost::optional<YamuxFrame::GoAwayError> reply_to_peer_code) {
@@ -541,9 +907,15 @@ namespace libp2p::connection {
 
     Streams streams;
     streams.swap(streams_);
+    window_growth_ = 0;
+    unsent_syn_.clear();
+
+    // streams are about to release their data
+    detachStreamData(0);
 
     PendingOutboundStreams pending_streams;
     pending_streams.swap(pending_outbound_streams_);
+    pending_permits_.clear();
 
     for (auto [_, stream] : streams) {
       stream->closedByConnection(notify_streams_code);
@@ -553,6 +925,10 @@ namespace libp2p::connection {
       cb(notify_streams_code);
     }
 
+    for (auto &ping : std::exchange(pending_pings_, {})) {
+      ping.cb(notify_streams_code);
+    }
+
     if (closed_callback_) {
       closed_callback_(remote_peer_, shared_from_this());
     }
@@ -561,21 +937,84 @@ namespace libp2p::connection {
     if (reply_to_peer_code) {
       enqueue(goAwayMsg(*reply_to_peer_code));
     } else {
-      write_queue_.clear();
+      clearWriteQueues();
       std::ignore = connection_->close();
     }
   }
 
-  void YamuxedConnection::writeStreamData(uint32_t stream_id, BytesIn data) {
-    auto packet = dataMsg(stream_id, data.size(), true);
-
-    // will add support for vector writes some time
-    packet.insert(packet.end(), data.begin(), data.end());
-    enqueue(std::move(packet), stream_id);
+  void YamuxedConnection::writeStreamData(uint32_t stream_id,
+                                          std::span<const BytesIn> data) {
+    // header and data chunks go to the wire as separate buffers
+    Payload payload;
+    size_t size = 0;
+    auto enqueue_frame = [&] {
+      auto frame = dataMsg(stream_id, size, false);
+      auto syn = openWith(stream_id, frame);
+      enqueueStreamFrame(
+          std::move(frame), stream_id, std::exchange(payload, {}), syn);
+      size = 0;
+    };
+    for (auto chunk : data) {
+      while (not chunk.empty()) {
+        auto part =
+            chunk.first(std::min(chunk.size(), kMaxDataFrameSize - size));
+        chunk = chunk.subspan(part.size());
+        payload.push_back(part);
+        size += part.size();
+        if (size == kMaxDataFrameSize) {
+          enqueue_frame();
+        }
+      }
+    }
+    if (size > 0) {
+      enqueue_frame();
+    }
   }
 
   void YamuxedConnection::ackReceivedBytes(uint32_t stream_id, uint32_t bytes) {
-    enqueue(windowUpdateMsg(stream_id, bytes));
+    if (batching_reads_) {
+      addWindow(acked_windows_, stream_id, bytes);
+      return;
+    }
+    enqueueWindowUpdate(stream_id, bytes);
+  }
+
+  bool YamuxedConnection::supportsPing() const {
+    return true;
+  }
+
+  void YamuxedConnection::ping(PingHandlerFunc cb) {
+    if (!started_) {
+      return connection_->deferWriteCallback(
+          std::error_code{},
+          [cb = std::move(cb)](auto) { cb(Error::CONNECTION_NOT_ACTIVE); });
+    }
+    sendPing();
+    pending_pings_.emplace_back(PendingPing{
+        .id = ping_counter_,
+        .sent_at = ping_sent_at_,
+        .cb = std::move(cb),
+    });
+  }
+
+  std::chrono::microseconds YamuxedConnection::rtt() const {
+    return rtt_;
+  }
+
+  size_t YamuxedConnection::growReceiveWindow(size_t bytes) {
+    bytes = std::min(bytes,
+                     config_.maximum_connection_window_growth - window_growth_);
+    window_growth_ += bytes;
+    return bytes;
+  }
+
+  void YamuxedConnection::shrinkReceiveWindow(size_t bytes) {
+    assert(bytes <= window_growth_);
+    window_growth_ -= bytes;
+  }
+
+  bool YamuxedConnection::receiveWindowPressure() const {
+    return window_growth_ >= config_.maximum_connection_window_growth;
   }
 
   void YamuxedConnection::deferCall(std::function<void()> cb) {
@@ -583,9 +1022,17 @@ namespace libp2p::connection {
                                     [cb = std::move(cb)](auto) { cb(); });
   }
 
+  basic::Scheduler::Handle YamuxedConnection::scheduleCall(
+      std::function<void()> cb, std::chrono::milliseconds delay) {
+    return scheduler_->scheduleWithHandle(std::move(cb), delay);
+  }
+
   void YamuxedConnection::resetStream(StreamId stream_id) {
     SL_DEBUG(log(), "RST from stream {}", stream_id);
-    enqueue(resetStreamMsg(stream_id));
+    // peer doesn't know about stream which sent nothing yet
+    if (unsent_syn_.erase(stream_id) == 0) {
+      enqueueStreamFrame(resetStreamMsg(stream_id), stream_id);
+    }
     eraseStream(stream_id);
   }
 
@@ -601,7 +1048,9 @@ namespace libp2p::connection {
       return;
     }
 
-    enqueue(closeStreamMsg(stream_id));
+    auto frame = closeStreamMsg(stream_id);
+    auto syn = openWith(stream_id, frame);
+    enqueueStreamFrame(std::move(frame), stream_id, {}, syn);
 
     auto &stream = it->second;
     assert(stream->isClosedForWrite());
@@ -611,109 +1060,359 @@ namespace libp2p::connection {
     }
   }
 
-  void YamuxedConnection::enqueue(Buffer packet, StreamId stream_id) {
-    if (is_writing_) {
-      write_queue_.push_back(WriteQueueItem{std::move(packet), stream_id});
-    } else {
-      doWrite(WriteQueueItem{std::move(packet), stream_id});
+  void YamuxedConnection::deferUntilDataReleased(uint32_t stream_id,
+                                                 std::function<void()> cb) {
+    detachStreamData(stream_id);
+    if (writing_) {
+      auto &items = writing_->items;
+      auto in_progress =
+          std::any_of(items.begin(), items.end(), [&](const auto &item) {
+            return item.stream_id == stream_id && !item.payload.empty();
+          });
+      if (in_progress) {
+        writing_->on_released.emplace_back(std::move(cb));
+        return;
+      }
     }
+    cb();
   }
 
-  void YamuxedConnection::doWrite(WriteQueueItem packet) {
+  void YamuxedConnection::detachStreamData(StreamId stream_id) {
+    auto detach = [](StreamWrites &writes) {
+      for (auto &item : writes.items) {
+        for (auto &chunk : item.payload) {
+          item.packet.insert(item.packet.end(), chunk.begin(), chunk.end());
+        }
+        item.payload.clear();
+      }
+    };
+    if (stream_id == 0) {
+      for (auto &[_, writes] : stream_writes_) {
+        detach(writes);
+      }
+    } else if (auto it = stream_writes_.find(stream_id);
+               it != stream_writes_.end()) {
+      detach(it->second);
+    }
+  }
+
+  void YamuxedConnection::enqueue(Buffer packet) {
+    write_queue_.push_back(WriteQueueItem{std::move(packet), {}, 0});
+    writeQueueGauge().add(1);
+    if (!is_writing_) {
+      doWrite();
+    }
+  }
+
+  void YamuxedConnection::enqueueStreamFrame(Buffer packet,
+                                             StreamId stream_id,
+                                             Payload payload,
+                                             bool syn) {
+    auto it = stream_writes_.find(stream_id);
+    if (it == stream_writes_.end()) {
+      if (payload.empty()) {
+        return enqueue(std::move(packet));
+      }
+      it = stream_writes_.emplace(stream_id, StreamWrites{}).first;
+      if (auto stream = streams_.find(stream_id); stream != streams_.end()) {
+        it->second.weight = stream->second->writeWeight();
+      }
+      it->second.syn = syn;
+      active_writers_.push_back(stream_id);
+    }
+    it->second.items.push_back(
+        WriteQueueItem{std::move(packet), std::move(payload), stream_id});
+    writeQueueGauge().add(1);
+    if (!is_writing_) {
+      doWrite();
+    }
+  }
+
+  void YamuxedConnection::takeStreamFrames(WriteBatch &batch) {
+    // Deficit round robin: each round a stream may write bytes in proportion
+    // to its weight, unused allowance is carried over while it has frames
+    while (batch.items.size() < kMaxFramesPerWrite
+           and not active_writers_.empty()) {
+      auto it = stream_writes_.find(active_writers_.front());
+      assert(it != stream_writes_.end());
+      auto &writes = it->second;
+      if (not writes.visited) {
+        writes.deficit += kWriteQuantumPerWeight * writes.weight;
+        writes.visited = true;
+      }
+      while (batch.items.size() < kMaxFramesPerWrite
+             and not writes.items.empty()) {
+        auto &item = writes.items.front();
+        auto size = item.packet.size() + item.payloadSize();
+        if (size > writes.deficit) {
+          break;
+        }
+        writes.deficit -= size;
+        batch.items.emplace_back(std::move(item));
+        writes.items.pop_front();
+        writes.syn = false;
+      }
+      if (writes.items.empty()) {
+        stream_writes_.erase(it);
+        active_writers_.pop_front();
+      } else if (batch.items.size() == kMaxFramesPerWrite) {
+        // the stream continues its turn in the next batch
+        break;
+      } else {
+        writes.visited = false;
+        active_writers_.push_back(active_writers_.front());
+        active_writers_.pop_front();
+      }
+    }
+  }
+
+  size_t YamuxedConnection::queuedFrames() const {
+    auto n = write_queue_.size();
+    for (auto &[_, writes] : stream_writes_) {
+      n += writes.items.size();
+    }
+    return n;
+  }
+
+  void YamuxedConnection::clearWriteQueues() {
+    writeQueueGauge().sub(queuedFrames());
+    write_queue_.clear();
+    stream_writes_.clear();
+    active_writers_.clear();
+  }
+
+  void YamuxedConnection::doWrite() {
     assert(!is_writing_);
+    assert(!writing_);
 
-    writing_buf_->assign(packet.packet.begin(), packet.packet.end());
-    auto cb = [wptr{weak_from_this()},
-               buf{writing_buf_},
-               packet = std::move(packet)](outcome::result<size_t> res) {
-      if (auto self = wptr.lock()) {
-        self->onDataWritten(res, packet.stream_id);
+    auto batch = std::make_shared<WriteBatch>();
+    batch->items.reserve(kMaxFramesPerWrite);
+
+    // control frames go first
+    while (batch->items.size() < kMaxFramesPerWrite
+           and not write_queue_.empty()) {
+      batch->items.emplace_back(std::move(write_queue_.front()));
+      write_queue_.pop_front();
+    }
+    takeStreamFrames(*batch);
+    writeQueueGauge().sub(batch->items.size());
+
+    size_t buffers = batch->items.size();
+    for (auto &item : batch->items) {
+      buffers += item.payload.size();
+    }
+    batch->buffers.reserve(buffers);
+
+    for (auto &item : batch->items) {
+      batch->buffers.emplace_back(item.packet);
+      if (recorder_) {
+        if (auto frame = parseFrame(item.packet)) {
+          recorder_.record(false,
+                           static_cast<uint8_t>(frame->type),
+                           frame->flags,
+                           frame->stream_id,
+                           frame->length);
+        }
       }
-    };
+      if (item.payload.empty()) {
+        continue;
+      }
+      batch->buffers.insert(
+          batch->buffers.end(), item.payload.begin(), item.payload.end());
+      auto it = streams_.find(item.stream_id);
+      if (it != streams_.end()) {
+        batch->streams.emplace_back(it->second);
+      }
+    }
 
+    writing_ = std::move(batch);
     is_writing_ = true;
-    writeReturnSize(connection_, *writing_buf_, cb);
+    continueWriting();
+  }
+
+  void YamuxedConnection::continueWriting() {
+    SL_TRACE(log(),
+             "writing {} frames, {} buffers remain",
+             writing_->items.size(),
+             writing_->unwritten().size());
+
+    connection_->writeSomeVectored(
+        writing_->unwritten(),
+        [wptr{weak_from_this()},
+         batch{writing_}](outcome::result<size_t> res) {
+          if (auto self = wptr.lock()) {
+            self->onDataWritten(res);
+          } else {
+            batch->release();
+          }
+        });
   }
 
-  void YamuxedConnection::onDataWritten(outcome::result<size_t> res,
-                                        StreamId stream_id) {
+  void YamuxedConnection::onDataWritten(outcome::result<size_t> res) {
+    assert(writing_);
+
+    if (res && !writing_->advance(res.value())) {
+      log()->error("onDataWritten : too large size arrived: {}", res.value());
+      res = Error::CONNECTION_INTERNAL_ERROR;
+    }
+
     if (!res) {
-      write_queue_.clear();
+      auto batch = std::move(writing_);
+      is_writing_ = false;
+      clearWriteQueues();
       std::ignore = connection_->close();
       // write error
       close(res.error(), boost::none);
+      batch->release();
+      return;
+    }
+
+    meter_.onWritten(res.value());
+
+    if (!writing_->unwritten().empty()) {
+      // partial write
+      continueWriting();
       return;
     }
 
     // this instance may be killed inside further callback
     auto self = shared_from_this();
 
-    if (stream_id != 0) {
-      // pass write ack to stream about data size written except header size
+    auto batch = std::move(writing_);
+    meter_.onWritten(0, batch->items.size());
 
-      auto sz = res.value();
-      if (sz < YamuxFrame::kHeaderLength) {
-        log()->error("onDataWritten : too small size arrived: {}", sz);
-        sz = 0;
-      } else {
-        sz -= YamuxFrame::kHeaderLength;
+    for (const auto &item : batch->items) {
+      // pass write ack to stream about data size written except header size
+      if (item.payload.empty()) {
+        continue;
       }
-
-      if (sz > 0) {
-        auto it = streams_.find(stream_id);
-        if (it == streams_.end()) {
-          SL_DEBUG(
-              log(), "onDataWritten : stream {} no longer exists", stream_id);
-        } else {
-          // stream can now call write callbacks
-          it->second->onDataWritten(sz);
-        }
+      auto it = streams_.find(item.stream_id);
+      if (it == streams_.end()) {
+        SL_DEBUG(log(),
+                 "onDataWritten : stream {} no longer exists",
+                 item.stream_id);
+      } else {
+        // stream can now call write callbacks
+        it->second->onDataWritten(item.payloadSize());
       }
     }
 
+    batch->release();
+
     is_writing_ = false;
 
-    if (not write_queue_.empty()) {
-      auto next_packet = std::move(write_queue_.front());
-      write_queue_.pop_front();
-      doWrite(std::move(next_packet));
+    if (not write_queue_.empty() or not active_writers_.empty()) {
+      doWrite();
     } else if (close_after_write_) {
       std::ignore = connection_->close();
     }
   }
 
-  std::shared_ptr<Stream> YamuxedConnection::createStream(StreamId stream_id) {
-    auto stream =
-        std::make_shared<YamuxStream>(shared_from_this(),
-                                      *this,
-                                      stream_id,
-                                      config_.maximum_window_size,
-                                      basic::WriteQueue::kDefaultSizeLimit);
-    streams_[stream_id] = stream;
-    inactivity_handle_.reset();
+  size_t YamuxedConnection::WriteQueueItem::payloadSize() const {
+    size_t size = 0;
+    for (auto &chunk : payload) {
+      size += chunk.size();
+    }
+    return size;
+  }
+
+  void YamuxedConnection::WriteBatch::release() {
+    auto callbacks = std::move(on_released);
+    on_released.clear();
+    for (const auto &cb : callbacks) {
+      cb();
+    }
+    streams.clear();
+  }
+
+  std::span<const BytesIn> YamuxedConnection::WriteBatch::unwritten() const {
+    return std::span<const BytesIn>(buffers).subspan(unwritten_index);
+  }
+
+  bool YamuxedConnection::WriteBatch::advance(size_t bytes) {
+    while (bytes > 0 && unwritten_index < buffers.size()) {
+      auto &buffer = buffers[unwritten_index];
+      if (bytes < buffer.size()) {
+        buffer = buffer.subspan(bytes);
+        return true;
+      }
+      bytes -= buffer.size();
+      ++unwritten_index;
+    }
+    return bytes == 0;
+  }
+
+  std::optional<muxer::StreamPermit> YamuxedConnection::admitStream(
+      muxer::StreamDirection direction) {
+    if (not stream_limits_) {
+      return muxer::StreamPermit{};
+    }
+    return stream_limits_->admit(direction);
+  }
+
+  std::shared_ptr<Stream> YamuxedConnection::createStream(
+      StreamId stream_id, muxer::StreamPermit permit) {
+    auto stream = std::allocate_shared<YamuxStream>(
+        basic::FreeListAllocator<YamuxStream>{stream_memory_},
+        shared_from_this(),
+        *this,
+        stream_id,
+        config_.maximum_window_size,
+        basic::WriteQueue::kDefaultSizeLimit,
+        config_.window_auto_tuning,
+        memory_,
+        bandwidth_,
+        std::move(permit));
+    streams_.insert(stream_id, stream);
+    inactivity_timer_.cancel();
     return stream;
   }
 
   void YamuxedConnection::eraseStream(StreamId stream_id) {
     SL_DEBUG(log(), "erasing stream {}", stream_id);
+    // the rest of its data message, maybe being read directly, is dropped
+    if (reading_state_.expectedData().first == stream_id) {
+      reading_state_.discardDataMessage();
+    }
+    detachStreamData(stream_id);
+    releaseReceiveWindow(stream_id);
     streams_.erase(stream_id);
     adjustExpireTimer();
   }
 
+  void YamuxedConnection::releaseReceiveWindow(StreamId stream_id) {
+    auto it = streams_.find(stream_id);
+    if (it != streams_.end()) {
+      shrinkReceiveWindow(it->second->receiveWindowGrowth());
+    }
+  }
+
   void YamuxedConnection::erasePendingOutboundStream(
       PendingOutboundStreams::iterator it) {
     SL_TRACE(log(), "erasing pending outbound stream {}", it->first);
+    pending_permits_.erase(it->first);
     pending_outbound_streams_.erase(it);
     adjustExpireTimer();
   }
 
+  void YamuxedConnection::setCloseWhenIdle(bool close) {
+    close_when_idle_ = close;
+    if (close) {
+      adjustExpireTimer();
+    } else {
+      inactivity_timer_.cancel();
+    }
+  }
+
   void YamuxedConnection::adjustExpireTimer() {
-    if (config_.no_streams_interval.count() > 0 && streams_.empty()
+    if (close_when_idle_ && config_.no_streams_interval.count() > 0
+        && streams_.empty()
         && pending_outbound_streams_.empty()) {
       SL_DEBUG(log(),
                "scheduling expire timer to {} msec",
                config_.no_streams_interval.count());
-      inactivity_handle_ = scheduler_->scheduleWithHandle(
+      scheduler_->arm(
+          inactivity_timer_,
           [weak_ptr(weak_from_this())] {
             if (auto self = weak_ptr.lock()) {
               self->onExpireTimer();
@@ -724,7 +1423,8 @@ namespace libp2p::connection {
   }
 
   void YamuxedConnection::onExpireTimer() {
-    if (streams_.empty() && pending_outbound_streams_.empty()) {
+    if (close_when_idle_ && streams_.empty()
+        && pending_outbound_streams_.empty()) {
       SL_DEBUG(log(), "closing expired connection");
       close(Error::CONNECTION_NOT_ACTIVE, YamuxFrame::GoAwayError::NORMAL);
     }
@@ -733,7 +1433,8 @@ namespace libp2p::connection {
   // TODO(turuslan): #240, yamux stream destructor
   void YamuxedConnection::setTimerCleanup() {
     static constexpr auto kCleanupInterval = std::chrono::seconds(150);
-    cleanup_handle_ = scheduler_->scheduleWithHandle(
+    scheduler_->arm(
+        cleanup_timer_,
         [weak_self{weak_from_this()}] {
           auto self = weak_self.lock();
           if (not self) {
@@ -746,12 +1447,14 @@ namespace libp2p::connection {
           for (auto &[id, stream] : self->streams_) {
             if (stream.use_count() == 1) {
               abandoned.push_back(id);
-              self->enqueue(resetStreamMsg(id));
+              self->enqueueStreamFrame(resetStreamMsg(id), id);
             }
           }
           if (!abandoned.empty()) {
             log()->info("cleaning up {} abandoned streams", abandoned.size());
             for (const auto id : abandoned) {
+              self->detachStreamData(id);
+              self->releaseReceiveWindow(id);
               self->streams_.erase(id);
             }
           }
@@ -761,7 +1464,8 @@ namespace libp2p::connection {
   }
 
   void YamuxedConnection::setTimerPing() {
-    ping_handle_ = scheduler_->scheduleWithHandle(
+    scheduler_->arm(
+        ping_timer_,
         [weak_self{weak_from_this()}] {
           auto self = weak_self.lock();
           if (not self) {
@@ -772,11 +1476,23 @@ namespace libp2p::connection {
           }
           // dont send pings if something is being written
           if (not self->is_writing_) {
-            self->enqueue(pingOutMsg(++self->ping_counter_));
-            SL_TRACE(log(), "written ping message #{}", self->ping_counter_);
+            self->sendPing();
           }
           self->setTimerPing();
         },
         config_.ping_interval);
   }
+
+  void YamuxedConnection::onHealthIdle(Time) {
+    // dont send pings if something is being written
+    if (started_ and not is_writing_) {
+      sendPing();
+    }
+  }
+
+  void YamuxedConnection::sendPing() {
+    ping_sent_at_ = std::chrono::steady_clock::now();
+    enqueue(pingOutMsg(++ping_counter_));
+    SL_TRACE(log(), "written ping message #{}", ping_counter_);
+  }
 }  // namespace libp2p::connection
@@ -0,0 +1,368 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/network/cares/ares_channel.hpp>
+
+#include <arpa/nameser.h>
+#include <netinet/in.h>
+#include <cstring>
+
+#include <boost/asio/post.hpp>
+
+namespace libp2p::network::c_ares {
+  namespace {
+    uint16_t read16(const unsigned char *p) {
+      return (uint16_t{p[0]} << 8) | p[1];
+    }
+
+    uint32_t read32(const unsigned char *p) {
+      return (uint32_t{read16(p)} << 16) | read16(p + 2);
+    }
+
+    /// Minimal TTL of answer records, c-ares does not parse it for TXT
+    std::optional<std::chrono::seconds> minAnswerTtl(const unsigned char *abuf,
+                                                     int alen) {
+      if (alen < NS_HFIXEDSZ) {
+        return std::nullopt;
+      }
+      const unsigned char *end = abuf + alen;
+      const unsigned char *p = abuf + NS_HFIXEDSZ;
+      auto skip_name = [&] {
+        char *name = nullptr;
+        long len = 0;
+        if (ARES_SUCCESS != ::ares_expand_name(p, abuf, alen, &name, &len)) {
+          return false;
+        }
+        ::ares_free_string(name);
+        p += len;
+        return p <= end;
+      };
+      for (auto i = read16(abuf + 4); i != 0; --i) {
+        if (not skip_name() or end - p < NS_QFIXEDSZ) {
+          return std::nullopt;
+        }
+        p += NS_QFIXEDSZ;
+      }
+      std::optional<uint32_t> ttl;
+      for (auto i = read16(abuf + 6); i != 0; --i) {
+        if (not skip_name() or end - p < NS_RRFIXEDSZ) {
+          return std::nullopt;
+        }
+        auto rr_ttl = read32(p + 4);
+        auto rd_len = read16(p + 8);
+        p += NS_RRFIXEDSZ;
+        if (end - p < rd_len) {
+          return std::nullopt;
+        }
+        p += rd_len;
+        ttl = std::min(ttl.value_or(rr_ttl), rr_ttl);
+      }
+      if (not ttl) {
+        return std::nullopt;
+      }
+      return std::chrono::seconds{*ttl};
+    }
+
+    /// TTL of results which must not be cached
+    constexpr std::chrono::steady_clock::duration kNotCached{0};
+
+    /// Only definite answers are cached, not timeouts or local failures
+    bool isCachedError(Ares::Error error) {
+      return error == Ares::Error::E_NO_DATA
+          or error == Ares::Error::E_NOT_FOUND;
+    }
+
+    Ares::Error queryError(int status) {
+      auto it = Ares::kQueryErrors.find(status);
+      if (it == Ares::kQueryErrors.end()) {
+        return Ares::Error::E_BAD_RESPONSE;
+      }
+      return it->second;
+    }
+
+    struct TxtQuery {
+      AresChannel *channel;
+      std::string uri;
+    };
+
+    struct AddressesQuery {
+      std::shared_ptr<boost::asio::io_context> io_context;
+      AresChannel::AddressesCallback callback;
+    };
+  }  // namespace
+
+  struct AresChannel::Socket {
+    Socket(boost::asio::io_context &io_context, ares_socket_t fd)
+        : fd{fd}, descriptor{io_context, fd} {}
+
+    ~Socket() {
+      descriptor.release();
+    }
+
+    ares_socket_t fd;
+    /// does not own fd, it is released before c-ares closes it
+    boost::asio::posix::stream_descriptor descriptor;
+    bool want_read = false;
+    bool want_write = false;
+    bool reading = false;
+    bool writing = false;
+  };
+
+  AresChannel::AresChannel(std::shared_ptr<boost::asio::io_context> io_context,
+                           const Ares &)
+      : io_context_{std::move(io_context)}, timer_{*io_context_} {
+    if (not Ares::initialized_.load()) {
+      return;
+    }
+    ::ares_options options{};
+    options.timeout = 30'000;
+    options.sock_state_cb = sockStateCallback;
+    options.sock_state_cb_data = this;
+    auto status = ::ares_init_options(
+        &channel_, &options, ARES_OPT_TIMEOUTMS | ARES_OPT_SOCK_STATE_CB);
+    if (ARES_SUCCESS != status) {
+      Ares::log()->error("Unable to initialize c-ares channel - {}",
+                         ::ares_strerror(status));
+      channel_ = nullptr;
+    }
+  }
+
+  AresChannel::~AresChannel() {
+    if (channel_ != nullptr) {
+      // completes pending queries and closes sockets
+      ::ares_destroy(channel_);
+    }
+  }
+
+  void AresChannel::resolveTxt(const std::string &uri, TxtCallback callback) {
+    if (auto cached = txt_cache_.get(uri, TxtCache::Clock::now())) {
+      post(*io_context_,
+           [callback{std::move(callback)}, reply{std::move(*cached)}] {
+             callback(reply);
+           });
+      return;
+    }
+    if (not txt_cache_.wait(uri, std::move(callback))) {
+      // the same query is in flight, its result will be shared
+      return;
+    }
+    if (not Ares::initialized_.load()) {
+      SL_DEBUG(
+          Ares::log(),
+          "Unable to execute DNS TXT request to {} due to c-ares library is "
+          "not initialized",
+          uri);
+      return finishTxt(uri, Ares::Error::NOT_INITIALIZED, kNotCached);
+    }
+    if (channel_ == nullptr) {
+      return finishTxt(uri, Ares::Error::CHANNEL_INIT_FAILURE, kNotCached);
+    }
+    ::ares_query(channel_,
+                 uri.c_str(),
+                 ns_c_in,
+                 ns_t_txt,
+                 txtCallback,
+                 new TxtQuery{this, uri});
+    updateTimer();
+  }
+
+  void AresChannel::resolveAddresses(const std::string &name,
+                                     std::optional<bool> v4,
+                                     AddressesCallback callback) {
+    std::optional<Ares::Error> error;
+    if (not Ares::initialized_.load()) {
+      error = Ares::Error::NOT_INITIALIZED;
+    } else if (channel_ == nullptr) {
+      error = Ares::Error::CHANNEL_INIT_FAILURE;
+    }
+    if (error) {
+      post(*io_context_, [callback{std::move(callback)}, error{*error}] {
+        callback(error);
+      });
+      return;
+    }
+    ::ares_addrinfo_hints hints{};
+    hints.ai_family = not v4 ? AF_UNSPEC : *v4 ? AF_INET : AF_INET6;
+    ::ares_getaddrinfo(channel_,
+                       name.c_str(),
+                       nullptr,
+                       &hints,
+                       addressesCallback,
+                       new AddressesQuery{io_context_, std::move(callback)});
+    updateTimer();
+  }
+
+  void AresChannel::sockStateCallback(void *arg,
+                                      ares_socket_t fd,
+                                      int readable,
+                                      int writable) {
+    auto &self = *static_cast<AresChannel *>(arg);
+    auto it = self.sockets_.find(fd);
+    if (readable == 0 and writable == 0) {
+      if (it != self.sockets_.end()) {
+        // cancels waits, c-ares is going to close the socket
+        it->second->descriptor.release();
+        self.sockets_.erase(it);
+      }
+      return;
+    }
+    if (it == self.sockets_.end()) {
+      it = self.sockets_
+               .emplace(fd, std::make_shared<Socket>(*self.io_context_, fd))
+               .first;
+    }
+    auto &socket = it->second;
+    socket->want_read = readable != 0;
+    socket->want_write = writable != 0;
+    self.watch(socket);
+  }
+
+  void AresChannel::watch(const std::shared_ptr<Socket> &socket) {
+    using Wait = boost::asio::posix::descriptor_base::wait_type;
+    auto wait = [&](Wait type, bool &pending, bool read) {
+      pending = true;
+      socket->descriptor.async_wait(
+          type,
+          [weak_self{weak_from_this()}, socket, &pending, read](
+              boost::system::error_code ec) {
+            pending = false;
+            if (ec) {
+              return;
+            }
+            auto self = weak_self.lock();
+            if (not self) {
+              return;
+            }
+            self->process(read ? socket->fd : ARES_SOCKET_BAD,
+                          read ? ARES_SOCKET_BAD : socket->fd);
+            // socket may be closed or replaced while processing
+            auto it = self->sockets_.find(socket->fd);
+            if (it != self->sockets_.end() and it->second == socket) {
+              self->watch(socket);
+            }
+          });
+    };
+    if (socket->want_read and not socket->reading) {
+      wait(Wait::wait_read, socket->reading, true);
+    }
+    if (socket->want_write and not socket->writing) {
+      wait(Wait::wait_write, socket->writing, false);
+    }
+  }
+
+  void AresChannel::process(ares_socket_t read_fd, ares_socket_t write_fd) {
+    ::ares_process_fd(channel_, read_fd, write_fd);
+    updateTimer();
+  }
+
+  void AresChannel::updateTimer() {
+    timeval tv{};
+    if (::ares_timeout(channel_, nullptr, &tv) == nullptr) {
+      timer_.cancel();
+      return;
+    }
+    timer_.expires_after(std::chrono::seconds{tv.tv_sec}
+                         + std::chrono::microseconds{tv.tv_usec});
+    timer_.async_wait(
+        [weak_self{weak_from_this()}](boost::system::error_code ec) {
+          if (ec) {
+            return;
+          }
+          if (auto self = weak_self.lock()) {
+            self->process(ARES_SOCKET_BAD, ARES_SOCKET_BAD);
+          }
+        });
+  }
+
+  void AresChannel::txtCallback(
+      void *arg, int status, int, unsigned char *abuf, int alen) {
+    std::unique_ptr<TxtQuery> query{static_cast<TxtQuery *>(arg)};
+    auto &self = *query->channel;
+    auto report_error = [&](Ares::Error error) {
+      self.finishTxt(query->uri,
+                     error,
+                     isCachedError(error) ? std::nullopt
+                                          : std::make_optional(kNotCached));
+    };
+    if (ARES_SUCCESS != status) {
+      report_error(queryError(status));
+      return;
+    }
+    ::ares_txt_reply *reply{nullptr};
+    auto parse_status = ::ares_parse_txt_reply(abuf, alen, &reply);
+    if (ARES_SUCCESS != parse_status) {
+      report_error(queryError(parse_status));
+      if (nullptr != reply) {
+        ::ares_free_data(reply);
+      }
+      return;
+    }
+    std::vector<std::string> result;
+    for (::ares_txt_reply *current = reply; current != nullptr;
+         current = current->next) {
+      std::string txt;
+      txt.resize(current->length);
+      std::memcpy(txt.data(), current->txt, current->length);
+      result.emplace_back(std::move(txt));
+    }
+    ::ares_free_data(reply);
+    self.finishTxt(query->uri, result, minAnswerTtl(abuf, alen));
+  }
+
+  void AresChannel::addressesCallback(void *arg,
+                                      int status,
+                                      int,
+                                      ::ares_addrinfo *result) {
+    std::unique_ptr<AddressesQuery> query{static_cast<AddressesQuery *>(arg)};
+    outcome::result<Addresses> r = queryError(status);
+    if (ARES_SUCCESS == status) {
+      Addresses addresses;
+      std::optional<int> ttl;
+      for (auto *node = result->nodes; node != nullptr; node = node->ai_next) {
+        if (node->ai_family == AF_INET) {
+          boost::asio::ip::address_v4::bytes_type bytes{};
+          std::memcpy(bytes.data(),
+                      &reinterpret_cast<sockaddr_in *>(node->ai_addr)->sin_addr,
+                      bytes.size());
+          addresses.addresses.emplace_back(boost::asio::ip::address_v4{bytes});
+        } else if (node->ai_family == AF_INET6) {
+          auto *addr = reinterpret_cast<sockaddr_in6 *>(node->ai_addr);
+          boost::asio::ip::address_v6::bytes_type bytes{};
+          std::memcpy(bytes.data(), &addr->sin6_addr, bytes.size());
+          addresses.addresses.emplace_back(
+              boost::asio::ip::address_v6{bytes, addr->sin6_scope_id});
+        } else {
+          continue;
+        }
+        ttl = std::min(ttl.value_or(node->ai_ttl), node->ai_ttl);
+      }
+      addresses.ttl = std::chrono::seconds{std::max(ttl.value_or(0), 0)};
+      if (addresses.addresses.empty()) {
+        r = Ares::Error::E_NO_DATA;
+      } else {
+        r = std::move(addresses);
+      }
+    }
+    if (result != nullptr) {
+      ::ares_freeaddrinfo(result);
+    }
+    post(*query->io_context,
+         [callback{std::move(query->callback)}, r{std::move(r)}] {
+           callback(r);
+         });
+  }
+
+  void AresChannel::finishTxt(const std::string &uri,
+                              const TxtCache::Result &result,
+                              std::optional<TxtCache::Clock::duration> ttl) {
+    for (auto &waiter :
+         txt_cache_.resolved(uri, result, TxtCache::Clock::now(), ttl)) {
+      post(*io_context_,
+           [waiter{std::move(waiter)}, result] { waiter(result); });
+    }
+  }
+
+}  // namespace libp2p::network::c_ares
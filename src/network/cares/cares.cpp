@@ -6,10 +6,6 @@
 
 #include <libp2p/network/cares/cares.hpp>
 
-#include <arpa/nameser.h>
-#include <cstring>
-#include <stdexcept>
-#include <thread>
 
 OUTCOME_CPP_DEFINE_CATEGORY(libp2p::network::c_ares, Ares::Error, e) {
   using E = libp2p::network::c_ares::Ares::Error;
@@ -18,8 +14,6 @@ OUTCOME_CPP_DEFINE_CATEGORY(libp2p::network::c_ares, Ares::Error, e) {
       return "C-ares library is not initialized";
     case E::CHANNEL_INIT_FAILURE:
       return "C-ares channel initialization failed";
-    case E::THREAD_FAILED:
-      return "Ares unable to start worker thread";
     case E::E_NO_DATA:
       return "The query completed but contains no answers";
     case E::E_BAD_QUERY:
@@ -59,11 +53,9 @@ OUTCOME_CPP_DEFINE_CATEGORY(libp2p::network::c_ares, Ares::Error, e) {
 }
 
 namespace libp2p::network::c_ares {
-
-  // linting of the three lines is disabled due to clang-tidy bug
+  // linting is disabled due to clang-tidy bug
   // https://bugs.llvm.org/show_bug.cgi?id=48040
-  std::atomic_bool Ares::initialized_{false};                          // NOLINT
-  std::list<std::shared_ptr<Ares::RequestContext>> Ares::requests_{};  // NOLINT
+  std::atomic_bool Ares::initialized_{false};  // NOLINT
 
   log::Logger Ares::log() {
     static log::Logger logger = log::createLogger("Ares");
@@ -94,132 +86,4 @@ namespace libp2p::network::c_ares {
     }
   }
 
-  void Ares::resolveTxt(
-      const std::string &uri,
-      const std::weak_ptr<boost::asio::io_context> &io_context,
-      Ares::TxtCallback callback) {
-    if (not initialized_.load()) {
-      SL_DEBUG(
-          log(),
-          "Unable to execute DNS TXT request to {} due to c-ares library is "
-          "not initialized",
-          uri);
-      reportError(io_context, std::move(callback), Error::NOT_INITIALIZED);
-      return;
-    }
-    int status{ARES_SUCCESS};
-    ::ares_options options{};
-    ::ares_channel channel{nullptr};
-    options.timeout = 30'000;
-    status = ares_init_options(&channel, &options, ARES_OPT_TIMEOUTMS);
-    if (ARES_SUCCESS != status) {
-      SL_DEBUG(log(),
-               "Unable to initialize c-ares channel for request to {} - {}",
-               uri,
-               ::ares_strerror(status));
-      reportError(io_context, std::move(callback), Error::CHANNEL_INIT_FAILURE);
-      return;
-    }
-
-    auto request =
-        std::make_shared<RequestContext>(io_context, uri, std::move(callback));
-    requests_.push_back(request);
-
-    try {
-      std::thread worker([channel, request] {
-        ::ares_query(channel,
-                     request->uri.c_str(),
-                     ns_c_in,
-                     ns_t_txt,
-                     Ares::txtCallback,
-                     request.get());
-        Ares::waitAresChannel(channel);
-        ::ares_destroy(channel);
-      });
-      worker.detach();
-    } catch (const std::runtime_error &e) {
-      log()->error("Ares unable to start worker thread - {}", e.what());
-      request->callback(Error::THREAD_FAILED);
-    }
-  }
-
-  void Ares::reportError(
-      const std::weak_ptr<boost::asio::io_context> &io_context,
-      Ares::TxtCallback callback,
-      Ares::Error error) {
-    if (auto ctx = io_context.lock()) {
-      post(*ctx, [callback{std::move(callback)}, error] { callback(error); });
-      return;
-    }
-    SL_DEBUG(log(), "IO context has expired");
-  }
-
-  void Ares::txtCallback(
-      void *arg, int status, int, unsigned char *abuf, int alen) {
-    auto *request_ptr{static_cast<RequestContext *>(arg)};
-    if (ARES_SUCCESS != status) {
-      reportError(request_ptr->io_context,
-                  request_ptr->callback,
-                  kQueryErrors.at(status));
-      removeRequest(request_ptr);
-      return;
-    }
-    ::ares_txt_reply *reply{nullptr};
-    auto parse_status = ::ares_parse_txt_reply(abuf, alen, &reply);
-    if (ARES_SUCCESS != parse_status) {
-      reportError(request_ptr->io_context,
-                  request_ptr->callback,
-                  kQueryErrors.at(parse_status));
-      removeRequest(request_ptr);
-      if (nullptr != reply) {
-        ::ares_free_data(reply);
-      }
-      return;
-    }
-    std::vector<std::string> result;
-    for (::ares_txt_reply *current = reply; current != nullptr;
-         current = current->next) {
-      std::string txt;
-      txt.resize(current->length);
-      std::memcpy(txt.data(), current->txt, current->length);
-      result.emplace_back(std::move(txt));
-    }
-    ::ares_free_data(reply);
-    if (auto ctx = request_ptr->io_context.lock()) {
-      post(*ctx,
-           [callback{std::move(request_ptr->callback)},
-            reply{std::move(result)}] { callback(reply); });
-    } else {
-      SL_DEBUG(log(), "IO context has expired");
-    }
-    removeRequest(request_ptr);
-  }
-
-  void Ares::waitAresChannel(::ares_channel channel) {
-    while (true) {
-      struct timeval *tvp{nullptr};  // NOLINT
-      struct timeval tv {};
-      fd_set read_fds;
-      fd_set write_fds;
-      int nfds{0};  // NOLINT
-
-      FD_ZERO(&read_fds);   // NOLINT
-      FD_ZERO(&write_fds);  // NOLINT
-      nfds = ::ares_fds(channel, &read_fds, &write_fds);
-      if (0 == nfds) {
-        break;
-      }
-      tvp = ::ares_timeout(channel, nullptr, &tv);
-      select(nfds, &read_fds, &write_fds, nullptr, tvp);
-      ::ares_process(channel, &read_fds, &write_fds);
-    }
-  }
-
-  void Ares::removeRequest(Ares::RequestContext *request_ptr) {
-    requests_.remove_if(
-        [&](const std::shared_ptr<Ares::RequestContext> &request_sptr) {
-          return request_ptr == request_sptr.get();
-        });
-  }
-
 }  // namespace libp2p::network::c_ares
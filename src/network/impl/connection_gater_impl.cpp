@@ -0,0 +1,223 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/network/impl/connection_gater_impl.hpp>
+
+#include <mutex>
+#include <optional>
+
+#include <boost/assert.hpp>
+
+#include <libp2p/common/metrics/registry.hpp>
+#include <libp2p/connection/capable_connection.hpp>
+
+namespace libp2p::network {
+  namespace {
+    void observeRejected() {
+      static auto &rejected = metrics::Registry::instance().counter(
+          "libp2p_gater_rejected_total",
+          "Dials and connections denied by connection gater");
+      rejected.inc();
+    }
+
+    bool bit(std::span<const uint8_t> bytes, size_t i) {
+      return ((bytes[i / 8] >> (7 - i % 8)) & 1) != 0;
+    }
+
+    /// Mapped ipv4 addresses are matched by ipv4 rules
+    boost::asio::ip::address unmapped(const boost::asio::ip::address &address) {
+      if (address.is_v6() and address.to_v6().is_v4_mapped()) {
+        return boost::asio::ip::make_address_v4(boost::asio::ip::v4_mapped,
+                                                address.to_v6());
+      }
+      return address;
+    }
+
+    /// Address of ip4 and ip6 multiaddresses, dns ones are checked when
+    /// connection is accepted or upgraded
+    std::optional<boost::asio::ip::address> ipOf(
+        const multi::Multiaddress &address) {
+      using multi::Protocol;
+      for (auto code : {Protocol::Code::IP4, Protocol::Code::IP6}) {
+        if (auto value = address.getFirstValueForProtocol(code)) {
+          boost::system::error_code ec;
+          auto ip = boost::asio::ip::make_address(value.value(), ec);
+          if (not ec) {
+            return ip;
+          }
+        }
+      }
+      return std::nullopt;
+    }
+  }  // namespace
+
+  ConnectionGaterImpl::ConnectionGaterImpl() : ConnectionGaterImpl{Config{}} {}
+
+  ConnectionGaterImpl::ConnectionGaterImpl(Config config) : config_{config} {}
+
+  void ConnectionGaterImpl::allowSubnet(const boost::asio::ip::address &address,
+                                        uint8_t prefix) {
+    setRule(address, prefix, Rule::ALLOW);
+  }
+
+  void ConnectionGaterImpl::denySubnet(const boost::asio::ip::address &address,
+                                       uint8_t prefix) {
+    setRule(address, prefix, Rule::DENY);
+  }
+
+  void ConnectionGaterImpl::removeSubnet(
+      const boost::asio::ip::address &address, uint8_t prefix) {
+    setRule(address, prefix, Rule::NONE);
+  }
+
+  void ConnectionGaterImpl::setRule(const boost::asio::ip::address &address,
+                                    uint8_t prefix,
+                                    Rule rule) {
+    auto ip = unmapped(address);
+    std::array<uint8_t, 16> bytes{};
+    size_t bits = 0;
+    if (ip.is_v4()) {
+      auto v4 = ip.to_v4().to_bytes();
+      std::copy(v4.begin(), v4.end(), bytes.begin());
+      bits = 32;
+    } else {
+      bytes = ip.to_v6().to_bytes();
+      bits = 128;
+    }
+    BOOST_ASSERT(prefix <= bits);
+    prefix = std::min<uint8_t>(prefix, bits);
+
+    std::unique_lock lock{mutex_};
+    auto &trie = ip.is_v4() ? v4_ : v6_;
+    uint32_t node = 0;
+    for (size_t i = 0; i < prefix; ++i) {
+      auto &child = trie[node].children[bit(bytes, i) ? 1 : 0];
+      if (child == 0) {
+        if (rule == Rule::NONE) {
+          // there is no such rule
+          return;
+        }
+        child = static_cast<uint32_t>(trie.size());
+        // `child` reference is not used after reallocation
+        node = child;
+        trie.emplace_back();
+        continue;
+      }
+      node = child;
+    }
+    auto &old = trie[node].rule;
+    if ((old == Rule::NONE) != (rule == Rule::NONE)) {
+      rule == Rule::NONE ? --subnet_rules_ : ++subnet_rules_;
+    }
+    old = rule;
+    has_subnets_ = subnet_rules_ != 0;
+  }
+
+  ConnectionGaterImpl::Rule ConnectionGaterImpl::match(
+      const Trie &trie, std::span<const uint8_t> bytes) {
+    auto rule = trie[0].rule;
+    uint32_t node = 0;
+    for (size_t i = 0; i < bytes.size() * 8; ++i) {
+      node = trie[node].children[bit(bytes, i) ? 1 : 0];
+      if (node == 0) {
+        break;
+      }
+      if (trie[node].rule != Rule::NONE) {
+        rule = trie[node].rule;
+      }
+    }
+    return rule;
+  }
+
+  bool ConnectionGaterImpl::allowAddress(
+      const boost::asio::ip::address &address) const {
+    if (not has_subnets_) {
+      return config_.allow_by_default;
+    }
+    auto ip = unmapped(address);
+    Rule rule = Rule::NONE;
+    {
+      std::shared_lock lock{mutex_};
+      if (ip.is_v4()) {
+        rule = match(v4_, ip.to_v4().to_bytes());
+      } else {
+        rule = match(v6_, ip.to_v6().to_bytes());
+      }
+    }
+    if (rule == Rule::NONE) {
+      return config_.allow_by_default;
+    }
+    return rule == Rule::ALLOW;
+  }
+
+  void ConnectionGaterImpl::blockPeer(const peer::PeerId &peer) {
+    std::unique_lock lock{mutex_};
+    blocked_peers_.emplace(peer);
+    has_peers_ = true;
+  }
+
+  void ConnectionGaterImpl::unblockPeer(const peer::PeerId &peer) {
+    std::unique_lock lock{mutex_};
+    blocked_peers_.erase(peer);
+    has_peers_ = not blocked_peers_.empty();
+  }
+
+  bool ConnectionGaterImpl::isPeerBlocked(const peer::PeerId &peer) const {
+    if (not has_peers_) {
+      return false;
+    }
+    std::shared_lock lock{mutex_};
+    return blocked_peers_.contains(peer);
+  }
+
+  bool ConnectionGaterImpl::allowDialPeer(const peer::PeerId &peer) const {
+    if (isPeerBlocked(peer)) {
+      observeRejected();
+      return false;
+    }
+    return true;
+  }
+
+  bool ConnectionGaterImpl::allowDialAddress(
+      const peer::PeerId &peer, const multi::Multiaddress &address) const {
+    auto ip = ipOf(address);
+    if (ip and not allowAddress(ip.value())) {
+      observeRejected();
+      return false;
+    }
+    return true;
+  }
+
+  bool ConnectionGaterImpl::allowAccept(
+      const boost::asio::ip::address &address) const {
+    if (not allowAddress(address)) {
+      observeRejected();
+      return false;
+    }
+    return true;
+  }
+
+  bool ConnectionGaterImpl::allowSecured(const peer::PeerId &peer,
+                                         bool initiator) const {
+    if (isPeerBlocked(peer)) {
+      observeRejected();
+      return false;
+    }
+    return true;
+  }
+
+  bool ConnectionGaterImpl::allowUpgraded(
+      connection::CapableConnection &conn) const {
+    // security of QUIC is not checked by upgrader
+    auto peer = conn.remotePeer();
+    if (peer and isPeerBlocked(peer.value())) {
+      observeRejected();
+      return false;
+    }
+    return true;
+  }
+
+}  // namespace libp2p::network
@@ -8,6 +8,8 @@
 
 #include <algorithm>
 
+#include <libp2p/network/impl/load_aware_connection_selector.hpp>
+
 namespace libp2p::network {
 
   namespace {
@@ -35,18 +37,34 @@ namespace libp2p::network {
 
   ConnectionManager::ConnectionSPtr
   ConnectionManagerImpl::getBestConnectionForPeer(const peer::PeerId &p) const {
-    // TODO(warchant): maybe make pluggable strategies
-
     auto it = connections_.find(p);
-    if (it != connections_.end()) {
-      for (const auto &conn : it->second) {
-        if (!conn->isClosed()) {
-          // for now, return first connection
-          return conn;
-        }
+    if (it == connections_.end()) {
+      return nullptr;
+    }
+    if (it->second.size() == 1) {
+      const auto &conn = *it->second.begin();
+      return conn->isClosed() ? nullptr : conn;
+    }
+    auto now = scheduler_->now();
+    auto &selected = selected_[p];
+    if (selected.connection and now < selected.until
+        and not selected.connection->isClosed()) {
+      return selected.connection;
+    }
+    std::vector<ConnectionSPtr> open;
+    open.reserve(it->second.size());
+    for (const auto &conn : it->second) {
+      if (not conn->isClosed()) {
+        open.emplace_back(conn);
       }
     }
-    return nullptr;
+    selected.connection = open.empty() ? nullptr : selector_->select(open);
+    selected.until = now + config_.selection_period;
+    return selected.connection;
+  }
+
+  void ConnectionManagerImpl::forgetSelected(const peer::PeerId &p) {
+    selected_.erase(p);
   }
 
   void ConnectionManagerImpl::addConnectionToPeer(
@@ -59,10 +77,45 @@ namespace libp2p::network {
     auto it = connections_.find(p);
     if (it == connections_.end()) {
       connections_.insert({p, {c}});
-    } else {
-      connections_[p].insert(c);
+      ++connection_count_;
+    } else if (it->second.insert(c).second) {
+      ++connection_count_;
+      forgetSelected(p);
+      drainRelayed(it->second);
     }
+    peers_.try_emplace(p, PeerMeta{.connected_at = scheduler_->now()});
     bus_->getChannel<event::network::OnNewConnectionChannel>().publish(c);
+    maybeTrim();
+  }
+
+  void ConnectionManagerImpl::drainRelayed(
+      const std::unordered_set<ConnectionSPtr> &connections) {
+    std::vector<std::weak_ptr<Connection>> relayed;
+    bool direct = false;
+    for (const auto &conn : connections) {
+      if (conn->isClosed()) {
+        continue;
+      }
+      if (connection::isRelayed(*conn)) {
+        relayed.emplace_back(conn);
+      } else {
+        direct = true;
+      }
+    }
+    if (not direct or relayed.empty()) {
+      return;
+    }
+    // new streams already go to direct connection, existing relayed ones
+    // are given time to finish
+    scheduler_->schedule(
+        [relayed{std::move(relayed)}] {
+          for (auto &weak : relayed) {
+            if (auto conn = weak.lock(); conn and not conn->isClosed()) {
+              (void)conn->close();
+            }
+          }
+        },
+        config_.relay_drain_period);
   }
 
   std::vector<ConnectionManager::ConnectionSPtr>
@@ -82,8 +135,20 @@ namespace libp2p::network {
   }
 
   ConnectionManagerImpl::ConnectionManagerImpl(
-      std::shared_ptr<libp2p::event::Bus> bus)
-      : bus_(std::move(bus)) {}
+      std::shared_ptr<libp2p::event::Bus> bus,
+      std::shared_ptr<basic::Scheduler> scheduler,
+      ConnectionManagerConfig config,
+      std::shared_ptr<ConnectionSelector> selector)
+      : bus_(std::move(bus)),
+        scheduler_(std::move(scheduler)),
+        config_(config),
+        selector_(selector ? std::move(selector)
+                           : std::make_shared<LoadAwareConnectionSelector>()) {
+    BOOST_ASSERT(bus_ != nullptr);
+    BOOST_ASSERT(scheduler_ != nullptr);
+    BOOST_ASSERT(config_.low_water <= config_.high_water);
+    BOOST_ASSERT(config_.trim_batch != 0);
+  }
 
   void ConnectionManagerImpl::collectGarbage() {
     for (auto it = connections_.begin(); it != connections_.end();) {
@@ -92,6 +157,7 @@ namespace libp2p::network {
         const auto &conn = *it2;
         if (conn->isClosed()) {
           it2 = cs.erase(it2);
+          --connection_count_;
         } else {
           ++it2;
         }
@@ -99,6 +165,8 @@ namespace libp2p::network {
 
       // if peer has no connections, remove peer
       if (cs.empty()) {
+        peers_.erase(it->first);
+        forgetSelected(it->first);
         it = connections_.erase(it);
       } else {
         ++it;
@@ -114,6 +182,9 @@ namespace libp2p::network {
 
     auto connections = std::move(it->second);
     connections_.erase(it);
+    connection_count_ -= connections.size();
+    peers_.erase(p);
+    forgetSelected(p);
 
     if (connections.empty()) {
       log()->error("inconsistency: iterator and no peers");
@@ -156,12 +227,176 @@ namespace libp2p::network {
     if (erased == 0) {
       log()->error("inconsistency in onConnectionClosed, connection not found");
     }
+    connection_count_ -= erased;
+    forgetSelected(peer_id);
 
     if (it->second.empty()) {
       connections_.erase(peer_id);
+      peers_.erase(peer_id);
       bus_->getChannel<event::network::OnPeerDisconnectedChannel>().publish(
           peer_id);
     }
   }
 
+  void ConnectionManagerImpl::tagPeer(const peer::PeerId &p,
+                                      const std::string &tag,
+                                      int value) {
+    auto it = peers_.find(p);
+    if (it == peers_.end()) {
+      return;
+    }
+    auto &meta = it->second;
+    auto &old = meta.tags[tag];
+    meta.score += value - old;
+    old = value;
+  }
+
+  void ConnectionManagerImpl::untagPeer(const peer::PeerId &p,
+                                        const std::string &tag) {
+    auto it = peers_.find(p);
+    if (it == peers_.end()) {
+      return;
+    }
+    auto &meta = it->second;
+    if (auto tag_it = meta.tags.find(tag); tag_it != meta.tags.end()) {
+      meta.score -= tag_it->second;
+      meta.tags.erase(tag_it);
+    }
+  }
+
+  void ConnectionManagerImpl::protect(const peer::PeerId &p,
+                                      const std::string &tag) {
+    protected_[p].emplace(tag);
+  }
+
+  bool ConnectionManagerImpl::unprotect(const peer::PeerId &p,
+                                        const std::string &tag) {
+    auto it = protected_.find(p);
+    if (it == protected_.end()) {
+      return false;
+    }
+    it->second.erase(tag);
+    if (it->second.empty()) {
+      protected_.erase(it);
+      return false;
+    }
+    return true;
+  }
+
+  bool ConnectionManagerImpl::isProtected(const peer::PeerId &p) const {
+    return protected_.contains(p);
+  }
+
+  void ConnectionManagerImpl::setStripe(const peer::PeerId &p, size_t width) {
+    if (width < 2) {
+      stripes_.erase(p);
+      return;
+    }
+    stripes_.insert_or_assign(p, Stripe{.width = width});
+  }
+
+  ConnectionManager::ConnectionSPtr ConnectionManagerImpl::getStripedConnection(
+      const peer::PeerId &p) {
+    auto stripe = stripes_.find(p);
+    auto it = connections_.find(p);
+    if (stripe == stripes_.end() or it == connections_.end()) {
+      return nullptr;
+    }
+    std::vector<ConnectionSPtr> open;
+    open.reserve(it->second.size());
+    for (const auto &conn : it->second) {
+      if (not conn->isClosed() and not connection::isRelayed(*conn)) {
+        open.emplace_back(conn);
+      }
+    }
+    if (open.empty()) {
+      return nullptr;
+    }
+    // order of set is stable while it is not modified
+    open.resize(std::min(open.size(), stripe->second.width));
+    return open[stripe->second.next++ % open.size()];
+  }
+
+  size_t ConnectionManagerImpl::countedConnections() const {
+    auto count = connection_count_;
+    for (const auto &[peer, stripe] : stripes_) {
+      if (auto it = connections_.find(peer);
+          it != connections_.end() and not it->second.empty()) {
+        count -= std::min(it->second.size(), stripe.width) - 1;
+      }
+    }
+    return count;
+  }
+
+  void ConnectionManagerImpl::maybeTrim() {
+    if (countedConnections() <= config_.high_water or trimming_
+        or trim_scheduled_) {
+      return;
+    }
+    auto now = scheduler_->now();
+    if (last_trim_ and now < *last_trim_ + config_.silence_period) {
+      trim_scheduled_ = true;
+      scheduler_->schedule(
+          [weak{weak_from_this()}] {
+            if (auto self = weak.lock()) {
+              self->trim_scheduled_ = false;
+              self->maybeTrim();
+            }
+          },
+          *last_trim_ + config_.silence_period - now);
+      return;
+    }
+    startTrim();
+  }
+
+  void ConnectionManagerImpl::startTrim() {
+    auto now = scheduler_->now();
+    trimming_ = true;
+    last_trim_ = now;
+    std::vector<Victim> victims;
+    victims.reserve(peers_.size());
+    for (auto &[peer, meta] : peers_) {
+      if (now < meta.connected_at + config_.grace_period
+          or protected_.contains(peer)) {
+        continue;
+      }
+      victims.emplace_back(Victim{meta.score, peer});
+    }
+    log()->debug("trimming {} connections, {} candidate peers",
+                 countedConnections(),
+                 victims.size());
+    victims_ = decltype(victims_){std::greater<>{}, std::move(victims)};
+    trimStep();
+  }
+
+  void ConnectionManagerImpl::trimStep() {
+    size_t disconnected = 0;
+    while (countedConnections() > config_.low_water and not victims_.empty()
+           and disconnected < config_.trim_batch) {
+      auto victim = victims_.top();
+      victims_.pop();
+      // peer could disconnect, get protected or retagged since round started
+      auto it = peers_.find(victim.peer);
+      if (it == peers_.end() or protected_.contains(victim.peer)) {
+        continue;
+      }
+      if (it->second.score != victim.score) {
+        victims_.push(Victim{it->second.score, victim.peer});
+        continue;
+      }
+      closeConnectionsToPeer(victim.peer);
+      ++disconnected;
+    }
+    if (countedConnections() > config_.low_water and not victims_.empty()) {
+      scheduler_->schedule([weak{weak_from_this()}] {
+        if (auto self = weak.lock()) {
+          self->trimStep();
+        }
+      });
+      return;
+    }
+    victims_ = {};
+    trimming_ = false;
+  }
+
 }  // namespace libp2p::network
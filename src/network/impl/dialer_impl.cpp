@@ -4,18 +4,116 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+#include <algorithm>
 #include <functional>
 #include <iostream>
+#include <tuple>
 
+#include <libp2p/common/metrics/registry.hpp>
 #include <libp2p/connection/stream.hpp>
 #include <libp2p/log/logger.hpp>
 #include <libp2p/network/impl/dialer_impl.hpp>
 
 namespace libp2p::network {
+  namespace {
+    /// Observes duration of one dial attempt to one address
+    void observeDial(std::chrono::steady_clock::time_point started,
+                     bool success) {
+      static auto &duration = metrics::Registry::instance().histogram(
+          "libp2p_dial_duration_seconds",
+          "Duration of dial attempts to one address");
+      static auto &failures = metrics::Registry::instance().counter(
+          "libp2p_dial_failures_total", "Failed dial attempts");
+      duration.observe(std::chrono::steady_clock::now() - started);
+      if (not success) {
+        failures.inc();
+      }
+    }
+
+    /// Observes number of backed off peers and dials rejected by backoff
+    void observeBackoff(const DialBackoff &backoff, bool rejected) {
+      static auto &peers = metrics::Registry::instance().gauge(
+          "libp2p_dial_backoff_peers",
+          "Peers backed off after failed dials to all their addresses");
+      static auto &rejects = metrics::Registry::instance().counter(
+          "libp2p_dial_backoff_rejected_total", "Dials rejected by backoff");
+      peers.set(static_cast<int64_t>(backoff.size()));
+      if (rejected) {
+        rejects.inc();
+      }
+    }
+
+    /**
+     * Orders addresses for dialing: the one that succeeded last time, then
+     * QUIC (no separate security and muxer handshakes), then the rest in
+     * original order. Addresses connected before go first within each group,
+     * faster ones first. Addresses in backoff after failures are dropped,
+     * unless no other address is left
+     */
+    void rankAddresses(std::deque<multi::Multiaddress> &addrs,
+                       const multi::Multiaddress *last,
+                       const peer::AddressRepository &repo,
+                       const peer::PeerId &peer_id) {
+      using Key = std::tuple<bool, int, std::chrono::milliseconds>;
+      auto now = std::chrono::steady_clock::now();
+      std::vector<std::pair<Key, multi::Multiaddress>> ranked;
+      ranked.reserve(addrs.size());
+      for (auto &addr : addrs) {
+        auto rank = 2;
+        if (last != nullptr and addr == *last) {
+          rank = 0;
+        } else if (addr.hasProtocol(multi::Protocol::Code::QUIC_V1)
+                   or addr.hasProtocol(multi::Protocol::Code::QUIC)) {
+          rank = 1;
+        }
+        auto stats = repo.dialStats(peer_id, addr);
+        auto backoff = stats and stats->backoff_until > now;
+        auto latency = stats and stats->latency
+                         ? *stats->latency
+                         : std::chrono::milliseconds::max();
+        ranked.emplace_back(Key{backoff, rank, latency}, std::move(addr));
+      }
+      std::ranges::stable_sort(
+          ranked, std::less{}, [](const auto &p) { return p.first; });
+      addrs.clear();
+      for (auto &[key, addr] : ranked) {
+        if (std::get<0>(key) and not addrs.empty()) {
+          break;
+        }
+        addrs.emplace_back(std::move(addr));
+      }
+    }
+
+    void closeConnection(
+        const outcome::result<std::shared_ptr<connection::CapableConnection>>
+            &result) {
+      if (result.has_value() and not result.value()->isClosed()) {
+        auto close_res = result.value()->close();
+        BOOST_ASSERT(close_res);
+      }
+    }
+  }  // namespace
 
   void DialerImpl::dial(const peer::PeerInfo &p, DialResultFunc cb) {
     SL_TRACE(log_, "Dialing to {}", p.id.toBase58().substr(46));
-    if (auto c = cmgr_->getBestConnectionForPeer(p.id); c != nullptr) {
+    if (gater_ != nullptr and not gater_->allowDialPeer(p.id)) {
+      scheduler_->schedule(
+          [cb{std::move(cb)}] { cb(std::errc::permission_denied); });
+      return;
+    }
+    auto c = cmgr_->getBestConnectionForPeer(p.id);
+    // relayed connection is not reused when direct addresses are given, e.g.
+    // by hole punching, which dials both sides at once
+    if (c != nullptr
+        and std::ranges::any_of(p.addresses,
+                                [](const auto &addr) {
+                                  return not addr.hasProtocol(
+                                      multi::Protocol::Code::P2P_CIRCUIT);
+                                })
+        and connection::isRelayed(*c)) {
+      c = nullptr;
+    }
+    if (c != nullptr) {
       // we have connection to this peer
 
       SL_TRACE(
@@ -48,26 +146,51 @@ namespace libp2p::network {
       return;
     }
 
+    // peer failed recently, and there is no new address to try
+    if (backoff_.blocked(p, std::chrono::steady_clock::now())) {
+      SL_TRACE(log_, "Dial to {} is backed off", p.id.toBase58().substr(46));
+      observeBackoff(backoff_, true);
+      scheduler_->schedule([cb{std::move(cb)}] {
+        cb(std::errc::resource_unavailable_try_again);
+      });
+      return;
+    }
+
+    auto dial_id = next_dial_id_++;
     DialCtx new_ctx{
+        .id = dial_id,
         .addr_queue = {p.addresses.begin(), p.addresses.end()},
         .addr_seen = {p.addresses.begin(), p.addresses.end()},
+        .span = metrics::Span{"libp2p.dial"},
     };
+    if (new_ctx.span) {
+      new_ctx.span.setAttribute("peer", p.id.toBase58());
+    }
+    auto last = last_dialled_.find(p.id);
+    rankAddresses(new_ctx.addr_queue,
+                  last != last_dialled_.end() ? &last->second : nullptr,
+                  *addr_repo_,
+                  p.id);
     new_ctx.callbacks.emplace_back(std::move(cb));
     bool scheduled = dialing_peers_.emplace(p.id, std::move(new_ctx)).second;
     BOOST_ASSERT(scheduled);
-    rotate(p.id);
+    rotate(p.id, dial_id);
   }
 
-  void DialerImpl::rotate(const peer::PeerId &peer_id) {
+  void DialerImpl::rotate(const peer::PeerId &peer_id, uint64_t dial_id) {
     auto ctx_found = dialing_peers_.find(peer_id);
-    if (dialing_peers_.end() == ctx_found) {
-      SL_ERROR(
-          log_, "State inconsistency - cannot dial {}", peer_id.toBase58());
+    if (dialing_peers_.end() == ctx_found
+        or ctx_found->second.id != dial_id) {
+      // dial finished before the scheduled rotation
       return;
     }
     auto &&ctx = ctx_found->second;
 
     if (ctx.addr_queue.empty()) {
+      if (ctx.in_flight != 0) {
+        // wait for attempts in flight
+        return;
+      }
       if (not ctx.dialled) {
         completeDial(peer_id, std::errc::address_family_not_supported);
         return;
@@ -80,64 +203,127 @@ namespace libp2p::network {
       completeDial(peer_id, std::errc::host_unreachable);
       return;
     }
+    if (ctx.in_flight >= kMaxParallelDials) {
+      // next attempt starts when one of current fails
+      return;
+    }
 
     auto addr = ctx.addr_queue.front();
     ctx.addr_queue.pop_front();
-    auto dial_handler =
-        [wp{weak_from_this()}, peer_id, addr](
-            outcome::result<std::shared_ptr<connection::CapableConnection>>
-                result) {
-          if (auto self = wp.lock()) {
-            auto ctx_found = self->dialing_peers_.find(peer_id);
-            if (self->dialing_peers_.end() == ctx_found) {
-              SL_ERROR(
-                  self->log_,
-                  "State inconsistency - uninteresting dial result for peer {}",
-                  peer_id.toBase58());
-              if (result.has_value() and not result.value()->isClosed()) {
-                auto close_res = result.value()->close();
-                BOOST_ASSERT(close_res);
-              }
-              return;
-            }
-
-            if (result.has_value()) {
-              self->listener_->onConnection(result);
-              self->completeDial(peer_id, result);
-              return;
-            }
-
-            self->addr_repo_->dialFailed(peer_id, addr);
-            // store an error otherwise and reschedule one more rotate
-            ctx_found->second.result = std::move(result);
-            self->scheduler_->schedule([wp, peer_id] {
-              if (auto self = wp.lock()) {
-                self->rotate(peer_id);
-              }
-            });
-            return;
-          }
-          // closing the connection when dialer and connection requester
-          // callback no more exist
-          if (result.has_value() and not result.value()->isClosed()) {
-            auto close_res = result.value()->close();
-            BOOST_ASSERT(close_res);
-          }
-        };
-    if (auto tr = tmgr_->findBest(addr); nullptr != tr) {
-      ctx.dialled = true;
-      SL_TRACE(log_,
-               "Dial to {} via {}",
-               peer_id.toBase58().substr(46),
-               addr.getStringAddress());
-      tr->dial(peer_id, addr, dial_handler);
-    } else {
-      scheduler_->schedule([wp{weak_from_this()}, peer_id] {
+    auto tr = tmgr_->findBest(addr);
+    if (gater_ != nullptr and not gater_->allowDialAddress(peer_id, addr)) {
+      tr = nullptr;
+    }
+    if (nullptr == tr) {
+      scheduler_->schedule([wp{weak_from_this()}, peer_id, dial_id] {
         if (auto self = wp.lock()) {
-          self->rotate(peer_id);
+          self->rotate(peer_id, dial_id);
         }
       });
+      return;
+    }
+    ctx.dialled = true;
+    ++ctx.in_flight;
+    if (not ctx.addr_queue.empty()) {
+      ctx.stagger_timer = scheduler_->scheduleWithHandle(
+          [wp{weak_from_this()}, peer_id, dial_id] {
+            if (auto self = wp.lock()) {
+              self->rotate(peer_id, dial_id);
+            }
+          },
+          kDialStagger);
     }
+    SL_TRACE(log_,
+             "Dial to {} via {}",
+             peer_id.toBase58().substr(46),
+             addr.getStringAddress());
+    auto attempt = ctx.span.child("libp2p.dial.attempt");
+    if (attempt) {
+      attempt.setAttribute("address", addr.getStringAddress());
+    }
+    // `ctx` may be erased by the time `dial` returns
+    tr->dial(peer_id,
+             addr,
+             [wp{weak_from_this()},
+              peer_id,
+              dial_id,
+              addr,
+              started{std::chrono::steady_clock::now()},
+              attempt](
+                 outcome::result<std::shared_ptr<connection::CapableConnection>>
+                     result) {
+               observeDial(started, result.has_value());
+               attempt.end(result.has_value() ? std::error_code{}
+                                              : result.error());
+               if (auto self = wp.lock()) {
+                 return self->onDialed(
+                     peer_id, dial_id, addr, started, std::move(result));
+               }
+               // closing the connection when dialer and connection requester
+               // callback no more exist
+               closeConnection(result);
+             });
+  }
+
+  void DialerImpl::onDialed(
+      const peer::PeerId &peer_id,
+      uint64_t dial_id,
+      const Multiaddress &addr,
+      std::chrono::steady_clock::time_point started,
+      outcome::result<std::shared_ptr<connection::CapableConnection>> result) {
+    if (result.has_value() and gater_ != nullptr
+        and not gater_->allowUpgraded(*result.value())) {
+      closeConnection(result);
+      result = std::errc::permission_denied;
+    }
+    if (result.has_error()) {
+      addr_repo_->dialFailed(peer_id, addr);
+    } else {
+      addr_repo_->dialSucceeded(
+          peer_id,
+          addr,
+          std::chrono::duration_cast<std::chrono::milliseconds>(
+              std::chrono::steady_clock::now() - started));
+    }
+    auto ctx_found = dialing_peers_.find(peer_id);
+    if (dialing_peers_.end() == ctx_found
+        or ctx_found->second.id != dial_id) {
+      // late attempt of finished dial, a new dial may be in progress
+      if (result.has_value()) {
+        SL_DEBUG(log_,
+                 "Closing connection to {} via {}, another dial attempt won",
+                 peer_id.toBase58().substr(46),
+                 addr.getStringAddress());
+        closeConnection(result);
+      }
+      return;
+    }
+    auto &&ctx = ctx_found->second;
+    --ctx.in_flight;
+
+    if (result.has_value()) {
+      if (last_dialled_.size() >= kMaxRememberedPeers
+          and not last_dialled_.contains(peer_id)) {
+        last_dialled_.erase(last_dialled_.begin());
+      }
+      last_dialled_.insert_or_assign(peer_id, addr);
+      listener_->onConnection(result);
+      completeDial(peer_id, result);
+      return;
+    }
+
+    if (auto last = last_dialled_.find(peer_id);
+        last != last_dialled_.end() and last->second == addr) {
+      last_dialled_.erase(last);
+    }
+    // store an error otherwise and start the next attempt without waiting
+    // for stagger timer
+    ctx.result = std::move(result);
+    scheduler_->schedule([wp{weak_from_this()}, peer_id, dial_id] {
+      if (auto self = wp.lock()) {
+        self->rotate(peer_id, dial_id);
+      }
+    });
   }
 
   void DialerImpl::completeDial(const peer::PeerId &peer_id,
@@ -145,6 +331,16 @@ namespace libp2p::network {
     if (auto ctx_found = dialing_peers_.find(peer_id);
         dialing_peers_.end() != ctx_found) {
       auto &&ctx = ctx_found->second;
+      if (result.has_value()) {
+        backoff_.succeeded(peer_id);
+      } else if (ctx.dialled) {
+        backoff_.failed(
+            {.id = peer_id,
+             .addresses = {ctx.addr_seen.begin(), ctx.addr_seen.end()}},
+            std::chrono::steady_clock::now());
+      }
+      observeBackoff(backoff_, false);
+      ctx.span.end(result.has_value() ? std::error_code{} : result.error());
       for (auto i = 0u; i < ctx.callbacks.size(); ++i) {
         scheduler_->schedule(
             [result, cb{std::move(ctx.callbacks[i])}] { cb(result); });
@@ -153,6 +349,95 @@ namespace libp2p::network {
     }
   }
 
+  void DialerImpl::dialAnother(const peer::PeerInfo &p, DialResultFunc cb) {
+    SL_TRACE(
+        log_, "Dialing another connection to {}", p.id.toBase58().substr(46));
+    if (gater_ != nullptr and not gater_->allowDialPeer(p.id)) {
+      scheduler_->schedule(
+          [cb{std::move(cb)}] { cb(std::errc::permission_denied); });
+      return;
+    }
+    // bulk transfers are striped over direct connections only
+    auto addrs = std::make_shared<std::deque<multi::Multiaddress>>();
+    for (const auto &addr : p.addresses) {
+      if (not addr.hasProtocol(multi::Protocol::Code::P2P_CIRCUIT)) {
+        addrs->emplace_back(addr);
+      }
+    }
+    if (addrs->empty()) {
+      scheduler_->schedule(
+          [cb{std::move(cb)}] { cb(std::errc::destination_address_required); });
+      return;
+    }
+    auto last = last_dialled_.find(p.id);
+    rankAddresses(*addrs,
+                  last != last_dialled_.end() ? &last->second : nullptr,
+                  *addr_repo_,
+                  p.id);
+    dialAnotherVia(p.id, std::move(addrs), std::move(cb));
+  }
+
+  void DialerImpl::dialAnotherVia(
+      const peer::PeerId &peer_id,
+      std::shared_ptr<std::deque<multi::Multiaddress>> addrs,
+      DialResultFunc cb) {
+    std::shared_ptr<transport::TransportAdaptor> tr;
+    while (not addrs->empty() and tr == nullptr) {
+      tr = tmgr_->findBest(addrs->front());
+      if (gater_ != nullptr
+          and not gater_->allowDialAddress(peer_id, addrs->front())) {
+        tr = nullptr;
+      }
+      if (tr == nullptr) {
+        addrs->pop_front();
+      }
+    }
+    if (tr == nullptr) {
+      scheduler_->schedule(
+          [cb{std::move(cb)}] { cb(std::errc::address_family_not_supported); });
+      return;
+    }
+    auto addr = addrs->front();
+    addrs->pop_front();
+    tr->dial(
+        peer_id,
+        addr,
+        [wp{weak_from_this()},
+         peer_id,
+         addr,
+         addrs,
+         cb{std::move(cb)},
+         started{std::chrono::steady_clock::now()}](
+            outcome::result<std::shared_ptr<connection::CapableConnection>>
+                result) mutable {
+          observeDial(started, result.has_value());
+          auto self = wp.lock();
+          if (not self) {
+            closeConnection(result);
+            return;
+          }
+          if (result.has_value() and self->gater_ != nullptr
+              and not self->gater_->allowUpgraded(*result.value())) {
+            closeConnection(result);
+            return cb(std::errc::permission_denied);
+          }
+          if (result.has_error()) {
+            self->addr_repo_->dialFailed(peer_id, addr);
+            if (addrs->empty()) {
+              return cb(result.error());
+            }
+            return self->dialAnotherVia(peer_id, addrs, std::move(cb));
+          }
+          self->addr_repo_->dialSucceeded(
+              peer_id,
+              addr,
+              std::chrono::duration_cast<std::chrono::milliseconds>(
+                  std::chrono::steady_clock::now() - started));
+          self->listener_->onConnection(result);
+          cb(std::move(result));
+        });
+  }
+
   void DialerImpl::newStream(const peer::PeerInfo &p,
                              StreamProtocols protocols,
                              StreamAndProtocolOrErrorCb cb) {
@@ -198,10 +483,50 @@ namespace libp2p::network {
             return cb(protocol_res.error());
           }
           auto &&protocol = protocol_res.value();
+          stream->attributeTraffic(protocol);
+          if (not stream->admitProtocol(protocol)) {
+            stream->reset();
+            return cb(connection::CapableConnection::Error::
+                          CONNECTION_TOO_MANY_STREAMS);
+          }
           cb(StreamAndProtocol{std::move(stream), std::move(protocol)});
         });
   }
 
+  void DialerImpl::newStreamLazy(const peer::PeerInfo &p,
+                                 const peer::ProtocolName &protocol,
+                                 StreamAndProtocolOrErrorCb cb) {
+    SL_TRACE(log_,
+             "New lazy stream to {} for {}",
+             p.id.toBase58().substr(46),
+             protocol);
+    dial(p,
+         [self{shared_from_this()}, protocol, cb{std::move(cb)}](
+             outcome::result<std::shared_ptr<connection::CapableConnection>>
+                 rconn) mutable {
+           if (!rconn) {
+             return cb(rconn.error());
+           }
+           auto stream_res = rconn.value()->newStream();
+           if (stream_res.has_error()) {
+             return cb(stream_res.error());
+           }
+           auto lazy_res = self->multiselect_->lazyStreamNegotiate(
+               std::move(stream_res.value()), protocol);
+           if (lazy_res.has_error()) {
+             return cb(lazy_res.error());
+           }
+           auto &&stream = lazy_res.value();
+           stream->attributeTraffic(protocol);
+           if (not stream->admitProtocol(protocol)) {
+             stream->reset();
+             return cb(connection::CapableConnection::Error::
+                           CONNECTION_TOO_MANY_STREAMS);
+           }
+           cb(StreamAndProtocol{std::move(stream), std::move(protocol)});
+         });
+  }
+
   DialerImpl::DialerImpl(
       std::shared_ptr<protocol_muxer::ProtocolMuxer> multiselect,
       std::shared_ptr<TransportManager> tmgr,
@@ -209,12 +534,29 @@ namespace libp2p::network {
       std::shared_ptr<ListenerManager> listener,
       std::shared_ptr<peer::AddressRepository> addr_repo,
       std::shared_ptr<basic::Scheduler> scheduler)
+      : DialerImpl{std::move(multiselect),
+                   std::move(tmgr),
+                   std::move(cmgr),
+                   std::move(listener),
+                   std::move(addr_repo),
+                   std::move(scheduler),
+                   nullptr} {}
+
+  DialerImpl::DialerImpl(
+      std::shared_ptr<protocol_muxer::ProtocolMuxer> multiselect,
+      std::shared_ptr<TransportManager> tmgr,
+      std::shared_ptr<ConnectionManager> cmgr,
+      std::shared_ptr<ListenerManager> listener,
+      std::shared_ptr<peer::AddressRepository> addr_repo,
+      std::shared_ptr<basic::Scheduler> scheduler,
+      std::shared_ptr<ConnectionGater> gater)
       : multiselect_(std::move(multiselect)),
         tmgr_{std::move(tmgr)},
         cmgr_{std::move(cmgr)},
         listener_{std::move(listener)},
         addr_repo_{std::move(addr_repo)},
         scheduler_{std::move(scheduler)},
+        gater_{std::move(gater)},
         log_{log::createLogger("DialerImpl")} {
     BOOST_ASSERT(multiselect_ != nullptr);
     BOOST_ASSERT(tmgr_ != nullptr);
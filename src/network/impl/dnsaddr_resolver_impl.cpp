@@ -25,10 +25,9 @@ OUTCOME_CPP_DEFINE_CATEGORY(libp2p::network, DnsaddrResolverImpl::Error, e) {
 
 namespace libp2p::network {
   DnsaddrResolverImpl::DnsaddrResolverImpl(
-      std::shared_ptr<boost::asio::io_context> io_context,
-      const c_ares::Ares &cares)
-      : io_context_{std::move(io_context)}, cares_{cares} {
-    BOOST_ASSERT(io_context_);
+      std::shared_ptr<c_ares::AresChannel> ares)
+      : ares_{std::move(ares)} {
+    BOOST_ASSERT(ares_);
   }
 
   void DnsaddrResolverImpl::load(multi::Multiaddress address,
@@ -75,7 +74,7 @@ namespace libp2p::network {
       cb(std::move(addresses));
     };
 
-    cares_.resolveTxt(host_uri, io_context_, handler);
+    ares_->resolveTxt(host_uri, handler);
   }
 
   outcome::result<std::string> DnsaddrResolverImpl::dnsaddrUriFromMultiaddr(
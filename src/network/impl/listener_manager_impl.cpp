@@ -22,10 +22,23 @@ namespace libp2p::network {
       std::shared_ptr<network::Router> router,
       std::shared_ptr<TransportManager> tmgr,
       std::shared_ptr<ConnectionManager> cmgr)
+      : ListenerManagerImpl{std::move(multiselect),
+                            std::move(router),
+                            std::move(tmgr),
+                            std::move(cmgr),
+                            nullptr} {}
+
+  ListenerManagerImpl::ListenerManagerImpl(
+      std::shared_ptr<protocol_muxer::ProtocolMuxer> multiselect,
+      std::shared_ptr<network::Router> router,
+      std::shared_ptr<TransportManager> tmgr,
+      std::shared_ptr<ConnectionManager> cmgr,
+      std::shared_ptr<ConnectionGater> gater)
       : multiselect_(std::move(multiselect)),
         router_(std::move(router)),
         tmgr_(std::move(tmgr)),
-        cmgr_(std::move(cmgr)) {
+        cmgr_(std::move(cmgr)),
+        gater_(std::move(gater)) {
     BOOST_ASSERT(multiselect_ != nullptr);
     BOOST_ASSERT(router_ != nullptr);
     BOOST_ASSERT(tmgr_ != nullptr);
@@ -186,6 +199,12 @@ namespace libp2p::network {
     }
     auto &&conn = rconn.value();
 
+    if (gater_ != nullptr and not gater_->allowUpgraded(*conn)) {
+      log()->debug("connection is denied by gater, closing");
+      std::ignore = conn->close();
+      return;
+    }
+
     auto rid = conn->remotePeer();
     if (!rid) {
       log()->warn("can not get remote peer id, {}", rid.error());
@@ -202,8 +221,8 @@ namespace libp2p::network {
           }
           auto &&stream = rstream.value();
 
-          auto protocols = this->router_->getSupportedProtocols();
-          if (protocols.empty()) {
+          auto protocols = this->router_->getSupportedProtocolsShared();
+          if (protocols->empty()) {
             log()->warn("no protocols are served, resetting inbound stream");
             stream->reset();
             return;
@@ -211,7 +230,7 @@ namespace libp2p::network {
 
           // negotiate protocols
           this->multiselect_->selectOneOf(
-              this->router_->getSupportedProtocols(),
+              std::move(protocols),
               stream,
               false /* not initiator */,
               true /* need to negotiate multistream itself - SPEC ???*/,
@@ -0,0 +1,55 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/network/impl/load_aware_connection_selector.hpp>
+
+namespace libp2p::network {
+
+  namespace {
+    struct Candidate {
+      bool relayed;
+      connection::ConnectionLoad load;
+
+      double cost() const {
+        return static_cast<double>(load.streams)
+             + static_cast<double>(load.unsent_bytes)
+                   / LoadAwareConnectionSelector::kBytesPerStream;
+      }
+
+      bool betterThan(const Candidate &other) const {
+        if (relayed != other.relayed) {
+          return not relayed;
+        }
+        if (load.rtt and other.load.rtt) {
+          auto rtt = static_cast<double>(load.rtt->count());
+          auto other_rtt = static_cast<double>(other.load.rtt->count());
+          if (rtt * LoadAwareConnectionSelector::kRttTolerance < other_rtt) {
+            return true;
+          }
+          if (other_rtt * LoadAwareConnectionSelector::kRttTolerance < rtt) {
+            return false;
+          }
+        }
+        return cost() < other.cost();
+      }
+    };
+  }  // namespace
+
+  ConnectionSelector::ConnectionSPtr LoadAwareConnectionSelector::select(
+      std::span<const ConnectionSPtr> connections) const {
+    ConnectionSPtr best;
+    Candidate best_candidate{};
+    for (const auto &conn : connections) {
+      Candidate candidate{connection::isRelayed(*conn), conn->load()};
+      if (not best or candidate.betterThan(best_candidate)) {
+        best = conn;
+        best_candidate = candidate;
+      }
+    }
+    return best;
+  }
+
+}  // namespace libp2p::network
@@ -11,6 +11,8 @@ OUTCOME_CPP_DEFINE_CATEGORY(libp2p::network, RouterImpl::Error, e) {
   switch (e) {
     case E::NO_HANDLER_FOUND:
       return "no handler was found for a given protocol";
+    case E::STREAM_LIMIT_EXCEEDED:
+      return "stream limit of the protocol exceeded";
   }
   return "unknown error";
 }
@@ -20,70 +22,102 @@ namespace libp2p::network {
                                       StreamAndProtocolCb cb,
                                       ProtocolPredicate predicate) {
     for (auto &protocol : protocols) {
-      proto_handlers_[protocol] = PredicateAndHandler{predicate, cb};
+      handlers_[protocol] = PredicateAndHandler{predicate, cb};
     }
+    update();
   }
 
   std::vector<peer::ProtocolName> RouterImpl::getSupportedProtocols() const {
-    std::vector<peer::ProtocolName> protos;
-    if (proto_handlers_.empty()) {
-      return protos;
-    }
+    return *protocols_;
+  }
 
-    std::string key_buffer;  // a workaround, recommended by the library's devs
-    protos.reserve(proto_handlers_.size());
-    for (auto it = proto_handlers_.begin(); it != proto_handlers_.end(); ++it) {
-      it.key(key_buffer);
-      protos.push_back(std::move(key_buffer));
-    }
-    return protos;
+  std::shared_ptr<const StreamProtocols>
+  RouterImpl::getSupportedProtocolsShared() const {
+    return protocols_;
   }
 
   void RouterImpl::removeProtocolHandlers(const peer::ProtocolName &protocol) {
-    proto_handlers_.erase_prefix(protocol);
+    auto it = handlers_.lower_bound(protocol);
+    while (it != handlers_.end() and it->first.starts_with(protocol)) {
+      it = handlers_.erase(it);
+    }
+    update();
   }
 
   void RouterImpl::removeAll() {
-    proto_handlers_.clear();
+    handlers_.clear();
+    update();
+  }
+
+  void RouterImpl::update() {
+    exact_.clear();
+    predicates_.clear();
+    StreamProtocols protocols;
+    protocols.reserve(handlers_.size());
+    for (auto it = handlers_.begin(); it != handlers_.end(); ++it) {
+      exact_.emplace(it->first, it);
+      if (it->second.predicate) {
+        predicates_.push_back(it);
+      }
+      protocols.push_back(it->first);
+    }
+    // negotiations in progress keep the previous list
+    protocols_ = std::make_shared<const StreamProtocols>(std::move(protocols));
+  }
+
+  RouterImpl::Handlers::const_iterator RouterImpl::longestPrefix(
+      std::string_view p) const {
+    for (auto size = p.size(); size > 0; --size) {
+      auto it = exact_.find(p.substr(0, size));
+      if (it != exact_.end()) {
+        return it->second;
+      }
+    }
+    return handlers_.end();
   }
 
   outcome::result<void> RouterImpl::handle(
       const peer::ProtocolName &p, std::shared_ptr<connection::Stream> stream) {
+    stream->attributeTraffic(p);
+    if (not stream->admitProtocol(p)) {
+      // listener resets the stream, handler is not called
+      return Error::STREAM_LIMIT_EXCEEDED;
+    }
+
     // firstly, try to find the longest prefix - even if it's not perfect match,
     // but a predicate one, it still will save the resources
-    auto matched_proto = proto_handlers_.longest_prefix(p);
-    if (matched_proto == proto_handlers_.end()) {
+    auto matched_proto = longestPrefix(p);
+    if (matched_proto == handlers_.cend()) {
       return Error::NO_HANDLER_FOUND;
     }
 
-    const auto &[predicate, cb] = matched_proto.value();
-    auto matched = matched_proto.key() == p or (predicate and predicate(p));
+    const auto &[predicate, cb] = matched_proto->second;
+    auto matched = matched_proto->first == p or (predicate and predicate(p));
     if (matched) {
       // perfect or predicate match
-      cb(StreamAndProtocol{std::move(stream), matched_proto.key()});
+      cb(StreamAndProtocol{std::move(stream), matched_proto->first});
       return outcome::success();
     }
 
-    // fallback: find all matches for the first two letters of the given (the
-    // first letter is a '/', so we need two) protocol and test them against the
-    // predicate; the longest match is to be called
-    auto matched_protos = proto_handlers_.equal_prefix_range_ks(p.data(), 2);
-
-    auto longest_match{matched_protos.second};
-    for (auto match = matched_protos.first; match != matched_protos.second;
-         ++match) {
-      if (match->predicate and match->predicate(p)
-          and (longest_match == matched_protos.second
-               or match.key().size() > longest_match.key().size())) {
+    // fallback: test handlers with predicates, which share the first two
+    // letters of the given (the first letter is a '/', so we need two)
+    // protocol; the longest match is to be called
+    auto first_letters = std::string_view{p}.substr(0, 2);
+    auto longest_match = handlers_.cend();
+    for (auto &match : predicates_) {
+      if (match->first.starts_with(first_letters)
+          and match->second.predicate(p)
+          and (longest_match == handlers_.cend()
+               or match->first.size() > longest_match->first.size())) {
         longest_match = match;
       }
     }
 
-    if (longest_match == matched_protos.second) {
+    if (longest_match == handlers_.cend()) {
       return Error::NO_HANDLER_FOUND;
     }
-    longest_match->handler(
-        StreamAndProtocol{std::move(stream), longest_match.key()});
+    longest_match->second.handler(
+        StreamAndProtocol{std::move(stream), longest_match->first});
     return outcome::success();
   }
 
@@ -6,13 +6,21 @@
 
 #include <libp2p/peer/address_repository/inmem_address_repository.hpp>
 
+#include <algorithm>
+
 #include <libp2p/peer/errors.hpp>
 
 namespace libp2p::peer {
 
   InmemAddressRepository::InmemAddressRepository(
       std::shared_ptr<network::DnsaddrResolver> dnsaddr_resolver)
-      : dnsaddr_resolver_{std::move(dnsaddr_resolver)} {
+      : InmemAddressRepository{std::move(dnsaddr_resolver), nullptr} {}
+
+  InmemAddressRepository::InmemAddressRepository(
+      std::shared_ptr<network::DnsaddrResolver> dnsaddr_resolver,
+      std::shared_ptr<PeerIndex> index)
+      : dnsaddr_resolver_{std::move(dnsaddr_resolver)},
+        index_{std::move(index)} {
     BOOST_ASSERT(dnsaddr_resolver_);
   }
 
@@ -69,16 +77,19 @@ namespace libp2p::peer {
       std::span<const multi::Multiaddress> ma,
       AddressRepository::Milliseconds ttl) {
     bool added = false;
-    auto &addresses = db_[p];
+    auto &peer = emplace(p);
 
-    auto expires_at = Clock::now() + ttl;
+    auto expires_at = expiresAt(ttl);
     for (const auto &m : ma) {
-      if (addresses.expires.emplace(m, expires_at).second) {
-        addresses.order.emplace_back(m);
+      if (not peer.find(m)) {
+        peer.addresses.emplace_back(m);
+        peer.expires.emplace_back(expires_at);
+        peer.stats.emplace_back();
         signal_added_(p, m);
         added = true;
       }
     }
+    schedule(p, peer);
 
     return added;
   }
@@ -88,19 +99,21 @@ namespace libp2p::peer {
       std::span<const multi::Multiaddress> ma,
       AddressRepository::Milliseconds ttl) {
     bool added = false;
-    auto &addresses = db_[p];
+    auto &peer = emplace(p);
 
-    auto expires_at = Clock::now() + ttl;
+    auto expires_at = expiresAt(ttl);
     for (const auto &m : ma) {
-      auto [addr_it, emplaced] = addresses.expires.emplace(m, expires_at);
-      if (emplaced) {
-        addresses.order.emplace_back(m);
+      if (auto i = peer.find(m)) {
+        peer.expires[*i] = expires_at;
+      } else {
+        peer.addresses.emplace_back(m);
+        peer.expires.emplace_back(expires_at);
+        peer.stats.emplace_back();
         signal_added_(p, m);
         added = true;
-      } else {
-        addr_it->second = expires_at;
       }
     }
+    schedule(p, peer);
 
     return added;
   }
@@ -111,12 +124,10 @@ namespace libp2p::peer {
     if (peer_it == db_.end()) {
       return PeerError::NOT_FOUND;
     }
-    auto &addresses = peer_it->second;
+    auto &peer = peer_it->second;
 
-    auto expires_at = Clock::now() + ttl;
-    for (auto &item : addresses.expires) {
-      item.second = expires_at;
-    }
+    std::ranges::fill(peer.expires, expiresAt(ttl));
+    schedule(p, peer);
 
     return outcome::success();
   }
@@ -128,13 +139,57 @@ namespace libp2p::peer {
       return;
     }
     auto &peer = peer_it->second;
-    if (not peer.expires.contains(addr)) {
+    auto i = peer.find(addr);
+    if (not i) {
       return;
     }
-    if (not peer.eraseOrder(addr)) {
+    auto &stats = peer.stats[*i];
+    auto now = Clock::now();
+    ++stats.failures;
+    ++stats.consecutive_failures;
+    stats.last_failure = now;
+    auto shift = std::min<size_t>(stats.consecutive_failures - 1, 16);
+    stats.backoff_until =
+        now
+        + std::min<Clock::duration>(kDialBackoff * (1 << shift),
+                                    kMaxDialBackoff);
+    peer.moveToBack(*i);
+  }
+
+  void InmemAddressRepository::dialSucceeded(const PeerId &peer_id,
+                                             const Multiaddress &addr,
+                                             Milliseconds latency) {
+    auto peer_it = db_.find(peer_id);
+    if (peer_it == db_.end()) {
       return;
     }
-    peer.order.emplace_back(addr);
+    auto &peer = peer_it->second;
+    auto i = peer.find(addr);
+    if (not i) {
+      return;
+    }
+    auto &stats = peer.stats[*i];
+    ++stats.successes;
+    stats.consecutive_failures = 0;
+    stats.backoff_until = {};
+    // exponential moving average, so single slow dial doesn't demote address
+    stats.latency =
+        stats.latency ? (*stats.latency * 3 + latency) / 4 : latency;
+    peer.moveToFront(*i);
+  }
+
+  std::optional<DialStats> InmemAddressRepository::dialStats(
+      const PeerId &peer_id, const Multiaddress &addr) const {
+    auto peer_it = db_.find(peer_id);
+    if (peer_it == db_.end()) {
+      return std::nullopt;
+    }
+    auto &peer = peer_it->second;
+    auto i = peer.find(addr);
+    if (not i) {
+      return std::nullopt;
+    }
+    return peer.stats[*i];
   }
 
   outcome::result<std::vector<multi::Multiaddress>>
@@ -143,52 +198,75 @@ namespace libp2p::peer {
     if (peer_it == db_.end()) {
       return PeerError::NOT_FOUND;
     }
-    return peer_it->second.order;
+    return peer_it->second.addresses;
+  }
+
+  std::span<const multi::Multiaddress> InmemAddressRepository::peekAddresses(
+      const PeerId &p) const {
+    auto peer_it = db_.find(p);
+    if (peer_it == db_.end()) {
+      return {};
+    }
+    return peer_it->second.addresses;
   }
 
   void InmemAddressRepository::clear(const PeerId &p) {
     auto it = db_.find(p);
     if (it != db_.end()) {
-      for (const auto &item : it->second.expires) {
-        signal_removed_(p, item.first);
+      auto &peer = it->second;
+      for (const auto &addr : peer.addresses) {
+        signal_removed_(p, addr);
       }
-      it->second = {};
+      peer.addresses.clear();
+      peer.expires.clear();
+      peer.stats.clear();
+      schedule(p, peer);
     }
   }
 
   void InmemAddressRepository::collectGarbage() {
     auto now = Clock::now();
-    auto peer = db_.begin();
-    auto peer_end = db_.end();
-
-    // for each peer
-    while (peer != peer_end) {
-      auto &maptr = peer->second;
+    while (not expiry_.empty() and expiry_.top().at <= now) {
+      auto expiry = expiry_.top();
+      expiry_.pop();
+      auto peer_it = db_.find(expiry.peer);
+      if (peer_it == db_.end() or peer_it->second.scheduled != expiry.at) {
+        continue;
+      }
+      auto &peer = peer_it->second;
+      peer.scheduled.reset();
 
       // remove all expired addresses
-      auto ma = maptr.expires.begin();
-      auto ma_end = maptr.expires.end();
-      while (ma != ma_end) {
-        if (now >= ma->second) {
-          signal_removed_(peer->first, ma->first);
-          maptr.eraseOrder(ma->first);
-          // erase returns element next to deleted
-          ma = maptr.expires.erase(ma);
+      for (size_t i = 0; i < peer.addresses.size();) {
+        if (now >= peer.expires[i]) {
+          signal_removed_(peer_it->first, peer.addresses[i]);
+          peer.erase(i);
         } else {
-          ++ma;
+          ++i;
         }
       }
 
       // peer has no more addresses
-      if (peer->second.expires.empty()) {
-        // erase returns element next to deleted
-        peer = db_.erase(peer);
+      if (peer.addresses.empty()) {
+        if (index_ != nullptr) {
+          index_->remove(peer_it->first, PeerIndex::ADDRESS);
+        }
+        db_.erase(peer_it);
       } else {
-        ++peer;
+        schedule(peer_it->first, peer);
       }
     }
   }
 
+  InmemAddressRepository::Peer &InmemAddressRepository::emplace(
+      const PeerId &peer_id) {
+    auto [it, inserted] = db_.try_emplace(peer_id);
+    if (inserted and index_ != nullptr) {
+      index_->add(peer_id, PeerIndex::ADDRESS);
+    }
+    return it->second;
+  }
+
   std::unordered_set<PeerId> InmemAddressRepository::getPeers() const {
     std::unordered_set<PeerId> peers;
     for (const auto &it : db_) {
@@ -198,12 +276,58 @@ namespace libp2p::peer {
     return peers;
   }
 
-  bool InmemAddressRepository::Peer::eraseOrder(const Multiaddress &addr) {
-    auto it = std::ranges::find(order, addr);
-    if (it == order.end()) {
-      return false;
+  Clock::time_point InmemAddressRepository::expiresAt(Milliseconds ttl) {
+    auto now = Clock::now();
+    if (ttl >= std::chrono::duration_cast<Milliseconds>(
+            Clock::time_point::max() - now)) {
+      return Clock::time_point::max();
+    }
+    return now + ttl;
+  }
+
+  void InmemAddressRepository::schedule(const PeerId &peer_id, Peer &peer) {
+    auto at = peer.addresses.empty() ? Clock::now()
+                                     : std::ranges::min(peer.expires);
+    if (at == Clock::time_point::max()) {
+      return;
+    }
+    if (peer.scheduled and *peer.scheduled <= at) {
+      return;
+    }
+    peer.scheduled = at;
+    expiry_.emplace(Expiry{at, peer_id});
+  }
+
+  std::optional<size_t> InmemAddressRepository::Peer::find(
+      const Multiaddress &addr) const {
+    auto it = std::ranges::find(addresses, addr);
+    if (it == addresses.end()) {
+      return std::nullopt;
     }
-    order.erase(it);
-    return true;
+    return it - addresses.begin();
+  }
+
+  void InmemAddressRepository::Peer::erase(size_t i) {
+    addresses.erase(addresses.begin() + i);
+    expires.erase(expires.begin() + i);
+    stats.erase(stats.begin() + i);
+  }
+
+  void InmemAddressRepository::Peer::moveToFront(size_t i) {
+    auto move = [i](auto &v) {
+      std::rotate(v.begin(), v.begin() + i, v.begin() + i + 1);
+    };
+    move(addresses);
+    move(expires);
+    move(stats);
+  }
+
+  void InmemAddressRepository::Peer::moveToBack(size_t i) {
+    auto move = [i](auto &v) {
+      std::rotate(v.begin() + i, v.begin() + i + 1, v.end());
+    };
+    move(addresses);
+    move(expires);
+    move(stats);
   }
 }  // namespace libp2p::peer
@@ -20,18 +20,48 @@ namespace libp2p::peer {
     return *keyPair_;
   }
 
+  const crypto::SigningKey &IdentityManagerImpl::getSigningKey() const {
+    BOOST_ASSERT(signingKey_ != nullptr);
+    return *signingKey_;
+  }
+
+  const crypto::ProtobufKey &IdentityManagerImpl::getMarshalledPublicKey()
+      const {
+    BOOST_ASSERT(marshalledPublicKey_ != nullptr);
+    return *marshalledPublicKey_;
+  }
+
   IdentityManagerImpl::IdentityManagerImpl(
       crypto::KeyPair keyPair,
-      const std::shared_ptr<crypto::marshaller::KeyMarshaller> &marshaller) {
+      const std::shared_ptr<crypto::marshaller::KeyMarshaller> &marshaller)
+      : IdentityManagerImpl{std::move(keyPair), marshaller, nullptr} {}
+
+  IdentityManagerImpl::IdentityManagerImpl(
+      crypto::KeyPair keyPair,
+      const std::shared_ptr<crypto::marshaller::KeyMarshaller> &marshaller,
+      const std::shared_ptr<crypto::CryptoProvider> &crypto_provider) {
     BOOST_ASSERT(!keyPair.publicKey.data.empty());
     BOOST_ASSERT(marshaller);
 
     keyPair_ = std::make_unique<crypto::KeyPair>(std::move(keyPair));
 
     // it is ok to use .value()
-    auto id = peer::PeerId::fromPublicKey(
-                  marshaller->marshal(keyPair_->publicKey).value())
-                  .value();
+    marshalledPublicKey_ = std::make_unique<crypto::ProtobufKey>(
+        marshaller->marshal(keyPair_->publicKey).value());
+    auto id = peer::PeerId::fromPublicKey(*marshalledPublicKey_).value();
     id_ = std::make_unique<peer::PeerId>(std::move(id));
+
+    if (crypto_provider) {
+      if (auto prepared =
+              crypto_provider->prepareSigningKey(keyPair_->privateKey)) {
+        signingKey_ = std::move(prepared.value());
+      }
+    }
+    if (not signingKey_) {
+      // signed with private key as is
+      auto key = std::make_shared<crypto::SigningKey>();
+      key->private_key = keyPair_->privateKey;
+      signingKey_ = std::move(key);
+    }
   }
 }  // namespace libp2p::peer
@@ -7,6 +7,7 @@
 #include <libp2p/peer/impl/peer_repository_impl.hpp>
 
 #include <libp2p/multi/multiaddress.hpp>
+#include <libp2p/peer/latency_repository/inmem_latency_repository.hpp>
 
 namespace {
 
@@ -24,12 +25,37 @@ namespace libp2p::peer {
       std::shared_ptr<AddressRepository> addr_repo,
       std::shared_ptr<KeyRepository> key_repo,
       std::shared_ptr<ProtocolRepository> protocol_repo)
+      : PeerRepositoryImpl(std::move(addr_repo),
+                           std::move(key_repo),
+                           std::move(protocol_repo),
+                           std::make_shared<InmemLatencyRepository>()) {}
+
+  PeerRepositoryImpl::PeerRepositoryImpl(
+      std::shared_ptr<AddressRepository> addr_repo,
+      std::shared_ptr<KeyRepository> key_repo,
+      std::shared_ptr<ProtocolRepository> protocol_repo,
+      std::shared_ptr<LatencyRepository> latency_repo)
+      : PeerRepositoryImpl(std::move(addr_repo),
+                           std::move(key_repo),
+                           std::move(protocol_repo),
+                           std::move(latency_repo),
+                           nullptr) {}
+
+  PeerRepositoryImpl::PeerRepositoryImpl(
+      std::shared_ptr<AddressRepository> addr_repo,
+      std::shared_ptr<KeyRepository> key_repo,
+      std::shared_ptr<ProtocolRepository> protocol_repo,
+      std::shared_ptr<LatencyRepository> latency_repo,
+      std::shared_ptr<PeerIndex> index)
       : addr_(std::move(addr_repo)),
         key_(std::move(key_repo)),
-        proto_(std::move(protocol_repo)) {
+        proto_(std::move(protocol_repo)),
+        latency_(std::move(latency_repo)),
+        index_(std::move(index)) {
     BOOST_ASSERT(addr_ != nullptr);
     BOOST_ASSERT(key_ != nullptr);
     BOOST_ASSERT(proto_ != nullptr);
+    BOOST_ASSERT(latency_ != nullptr);
   }
 
   AddressRepository &PeerRepositoryImpl::getAddressRepository() {
@@ -44,14 +70,30 @@ namespace libp2p::peer {
     return *proto_;
   }
 
+  LatencyRepository &PeerRepositoryImpl::getLatencyRepository() {
+    return *latency_;
+  }
+
   std::unordered_set<PeerId> PeerRepositoryImpl::getPeers() const {
     std::unordered_set<PeerId> peers;
+    if (index_ != nullptr) {
+      peers.reserve(index_->size());
+      index_->forEach([&](const PeerId &peer) { peers.emplace(peer); });
+      return peers;
+    }
     merge_sets<PeerId>(peers, addr_->getPeers());
     merge_sets<PeerId>(peers, key_->getPeers());
     merge_sets<PeerId>(peers, proto_->getPeers());
     return peers;
   }
 
+  void PeerRepositoryImpl::forEachPeer(const PeerVisitor &visitor) const {
+    if (index_ == nullptr) {
+      return PeerRepository::forEachPeer(visitor);
+    }
+    index_->forEach(visitor);
+  }
+
   PeerInfo PeerRepositoryImpl::getPeerInfo(const PeerId &peer_id) const {
     auto peer_addrs_res = addr_->getAddresses(peer_id);
     if (!peer_addrs_res) {
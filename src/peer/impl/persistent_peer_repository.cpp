@@ -0,0 +1,345 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/peer/impl/persistent_peer_repository.hpp>
+
+#include <boost/optional.hpp>
+
+#include <libp2p/multi/uvarint.hpp>
+
+namespace libp2p::peer {
+
+  namespace {
+    /// Peers are ordered by wall clock, as it must outlive restart
+    int64_t wallClock() {
+      return std::chrono::duration_cast<std::chrono::milliseconds>(
+                 std::chrono::system_clock::now().time_since_epoch())
+          .count();
+    }
+
+    void putUVarint(Bytes &out, uint64_t value) {
+      multi::UVarint varint{value};
+      auto bytes = varint.toBytes();
+      out.insert(out.end(), bytes.begin(), bytes.end());
+    }
+
+    void putBytes(Bytes &out, BytesIn bytes) {
+      putUVarint(out, bytes.size());
+      out.insert(out.end(), bytes.begin(), bytes.end());
+    }
+
+    /// Reads fields from the front of input
+    struct Reader {
+      boost::optional<uint64_t> uvarint() {
+        auto varint = multi::UVarint::create(input);
+        if (not varint) {
+          return boost::none;
+        }
+        input = input.subspan(varint->size());
+        return varint->toUInt64();
+      }
+
+      boost::optional<BytesIn> bytes() {
+        auto size = uvarint();
+        if (not size or *size > input.size()) {
+          return boost::none;
+        }
+        auto bytes = input.first(*size);
+        input = input.subspan(*size);
+        return bytes;
+      }
+
+      BytesIn input;
+    };
+
+    /// Columns of peer, lists are encoded as uvarint count and length
+    /// prefixed items, key is uvarint type and length prefixed data
+    struct Row {
+      Bytes peer;
+      Bytes addresses;
+      Bytes keys;
+      Bytes protocols;
+    };
+  }  // namespace
+
+  struct PersistentPeerRepository::Statements {
+    boost::optional<storage::SQLite::StatementHandle> upsert;
+    boost::optional<storage::SQLite::StatementHandle> erase;
+  };
+
+  PersistentPeerRepository::PersistentPeerRepository(
+      const Config &config,
+      std::shared_ptr<PeerRepository> repository,
+      std::shared_ptr<storage::SQLiteWriter> writer,
+      std::shared_ptr<storage::SQLiteReaderPool> readers,
+      std::shared_ptr<basic::Scheduler> scheduler)
+      : config_{config},
+        repository_{std::move(repository)},
+        writer_{std::move(writer)},
+        readers_{std::move(readers)},
+        scheduler_{std::move(scheduler)},
+        statements_{std::make_shared<Statements>()},
+        log_{log::createLogger("PersistentPeerRepository")} {
+    BOOST_ASSERT(repository_ != nullptr);
+    BOOST_ASSERT(writer_ != nullptr);
+    BOOST_ASSERT(readers_ != nullptr);
+    BOOST_ASSERT(scheduler_ != nullptr);
+  }
+
+  PersistentPeerRepository::~PersistentPeerRepository() {
+    flush();
+  }
+
+  void PersistentPeerRepository::start() {
+    writer_->post([](storage::SQLite &db) {
+      db << "CREATE TABLE IF NOT EXISTS peers ("
+            "peer BLOB PRIMARY KEY, "
+            "last_seen INTEGER NOT NULL, "
+            "addresses BLOB NOT NULL, "
+            "keys BLOB NOT NULL, "
+            "protocols BLOB NOT NULL)";
+      db << "CREATE INDEX IF NOT EXISTS peers_last_seen "
+            "ON peers(last_seen, peer)";
+    });
+    writer_->flush();
+
+    auto on_address = [weak_self{weak_from_this()}](const PeerId &peer_id,
+                                                    const Multiaddress &) {
+      if (auto self = weak_self.lock()) {
+        if (not self->loading_) {
+          self->markChanged(peer_id);
+        }
+      }
+    };
+    auto &addresses = repository_->getAddressRepository();
+    on_address_added_ = addresses.onAddressAdded(on_address);
+    on_address_removed_ = addresses.onAddressRemoved(on_address);
+
+    if (load(config_.hot_peers)) {
+      loadNext();
+    }
+    setFlushTimer();
+  }
+
+  void PersistentPeerRepository::markChanged(const PeerId &peer_id) {
+    changed_.emplace(peer_id);
+  }
+
+  void PersistentPeerRepository::flush() {
+    if (changed_.empty()) {
+      return;
+    }
+    std::vector<Row> rows;
+    rows.reserve(changed_.size());
+    for (auto &peer_id : changed_) {
+      Row row{peer_id.toVector(), {}, {}, {}};
+
+      auto addresses =
+          repository_->getAddressRepository().peekAddresses(peer_id);
+      putUVarint(row.addresses, addresses.size());
+      for (auto &address : addresses) {
+        putBytes(row.addresses, address.getBytesAddress());
+      }
+
+      auto keys = repository_->getKeyRepository().getPublicKeys(peer_id);
+      auto key_count = keys ? keys.value()->size() : 0;
+      putUVarint(row.keys, key_count);
+      if (key_count != 0) {
+        for (auto &key : *keys.value()) {
+          putUVarint(row.keys, static_cast<uint64_t>(key.type));
+          putBytes(row.keys, key.data);
+        }
+      }
+
+      auto protocols =
+          repository_->getProtocolRepository().getProtocols(peer_id);
+      auto protocol_count = protocols ? protocols.value().size() : 0;
+      putUVarint(row.protocols, protocol_count);
+      if (protocol_count != 0) {
+        for (auto &protocol : protocols.value()) {
+          putBytes(row.protocols,
+                   BytesIn{reinterpret_cast<const uint8_t *>(protocol.data()),
+                           protocol.size()});
+        }
+      }
+
+      // forgotten peers are erased
+      if (addresses.empty() and key_count == 0 and protocol_count == 0) {
+        row.addresses.clear();
+      }
+      rows.emplace_back(std::move(row));
+    }
+
+    auto posted = writer_->post(
+        [statements{statements_}, rows{std::move(rows)}, now{wallClock()}](
+            storage::SQLite &db) {
+          if (not statements->upsert) {
+            statements->upsert = db.createStatement(
+                "INSERT OR REPLACE INTO peers"
+                "(peer, last_seen, addresses, keys, protocols) "
+                "VALUES(?, ?, ?, ?, ?)");
+            statements->erase =
+                db.createStatement("DELETE FROM peers WHERE peer = ?");
+          }
+          for (auto &row : rows) {
+            if (row.addresses.empty()) {
+              db.execCommand(*statements->erase, row.peer);
+              continue;
+            }
+            db.execCommand(*statements->upsert,
+                           row.peer,
+                           sqlite_int64{now},
+                           row.addresses,
+                           row.keys,
+                           row.protocols);
+          }
+        });
+    if (not posted) {
+      // writer is busy, changes are written by next flush
+      log_->warn("writer queue is full, {} peers are not written",
+                 changed_.size());
+      return;
+    }
+    changed_.clear();
+  }
+
+  bool PersistentPeerRepository::load(size_t limit) {
+    std::vector<Row> rows;
+    try {
+      auto reader = readers_->acquire();
+      *reader << "SELECT peer, last_seen, addresses, keys, protocols "
+                 "FROM peers WHERE (last_seen, peer) < (?, ?) "
+                 "ORDER BY last_seen DESC, peer DESC LIMIT ?"
+              << sqlite_int64{cursor_seen_} << cursor_peer_
+              << sqlite_int64(limit)
+          >> [&](Bytes peer,
+                 sqlite_int64 last_seen,
+                 Bytes addresses,
+                 Bytes keys,
+                 Bytes protocols) {
+               cursor_seen_ = last_seen;
+               cursor_peer_ = peer;
+               rows.push_back({std::move(peer),
+                               std::move(addresses),
+                               std::move(keys),
+                               std::move(protocols)});
+             };
+    } catch (const std::exception &e) {
+      log_->error("cannot load peers: {}", e.what());
+      return false;
+    }
+
+    loading_ = true;
+    for (auto &row : rows) {
+      auto peer_id = PeerId::fromBytes(row.peer);
+      if (not peer_id) {
+        continue;
+      }
+      auto &id = peer_id.value();
+
+      // peer seen since start has fresher addresses
+      auto &address_repository = repository_->getAddressRepository();
+      Reader addresses{row.addresses};
+      auto address_count = addresses.uvarint().value_or(0);
+      if (address_repository.peekAddresses(id).empty()) {
+        std::vector<Multiaddress> loaded;
+        for (uint64_t i = 0; i < address_count; ++i) {
+          auto bytes = addresses.bytes();
+          if (not bytes) {
+            break;
+          }
+          if (auto address = Multiaddress::create(*bytes)) {
+            loaded.emplace_back(std::move(address.value()));
+          }
+        }
+        std::ignore = address_repository.upsertAddresses(
+            id, loaded, config_.address_ttl);
+      }
+
+      Reader keys{row.keys};
+      auto key_count = keys.uvarint().value_or(0);
+      for (uint64_t i = 0; i < key_count; ++i) {
+        auto type = keys.uvarint();
+        auto data = keys.bytes();
+        if (not type or not data) {
+          break;
+        }
+        crypto::PublicKey key{{static_cast<crypto::Key::Type>(*type),
+                               {data->begin(), data->end()}}};
+        std::ignore = repository_->getKeyRepository().addPublicKey(id, key);
+      }
+
+      Reader protocols{row.protocols};
+      auto protocol_count = protocols.uvarint().value_or(0);
+      std::vector<ProtocolName> loaded;
+      for (uint64_t i = 0; i < protocol_count; ++i) {
+        auto bytes = protocols.bytes();
+        if (not bytes) {
+          break;
+        }
+        loaded.emplace_back(bytes->begin(), bytes->end());
+      }
+      std::ignore =
+          repository_->getProtocolRepository().addProtocols(id, loaded);
+    }
+    loading_ = false;
+
+    log_->debug("loaded {} peers", rows.size());
+    return rows.size() == limit;
+  }
+
+  void PersistentPeerRepository::loadNext() {
+    load_timer_ = scheduler_->scheduleWithHandle(
+        [weak_self{weak_from_this()}] {
+          if (auto self = weak_self.lock()) {
+            if (self->load(self->config_.load_batch)) {
+              self->loadNext();
+            }
+          }
+        });
+  }
+
+  void PersistentPeerRepository::setFlushTimer() {
+    flush_timer_ = scheduler_->scheduleWithHandle(
+        [weak_self{weak_from_this()}] {
+          if (auto self = weak_self.lock()) {
+            self->flush();
+            self->setFlushTimer();
+          }
+        },
+        config_.flush_interval);
+  }
+
+  AddressRepository &PersistentPeerRepository::getAddressRepository() {
+    return repository_->getAddressRepository();
+  }
+
+  KeyRepository &PersistentPeerRepository::getKeyRepository() {
+    return repository_->getKeyRepository();
+  }
+
+  ProtocolRepository &PersistentPeerRepository::getProtocolRepository() {
+    return repository_->getProtocolRepository();
+  }
+
+  LatencyRepository &PersistentPeerRepository::getLatencyRepository() {
+    return repository_->getLatencyRepository();
+  }
+
+  std::unordered_set<PeerId> PersistentPeerRepository::getPeers() const {
+    return repository_->getPeers();
+  }
+
+  void PersistentPeerRepository::forEachPeer(
+      const PeerVisitor &visitor) const {
+    repository_->forEachPeer(visitor);
+  }
+
+  PeerInfo PersistentPeerRepository::getPeerInfo(const PeerId &peer_id) const {
+    return repository_->getPeerInfo(peer_id);
+  }
+
+}  // namespace libp2p::peer
@@ -10,8 +10,11 @@
 
 namespace libp2p::peer {
 
-  InmemKeyRepository::InmemKeyRepository()
-      : kp_(std::make_shared<std::unordered_set<crypto::KeyPair>>()){};
+  InmemKeyRepository::InmemKeyRepository() : InmemKeyRepository(nullptr) {}
+
+  InmemKeyRepository::InmemKeyRepository(std::shared_ptr<PeerIndex> index)
+      : kp_(std::make_shared<std::unordered_set<crypto::KeyPair>>()),
+        index_(std::move(index)) {}
 
   void InmemKeyRepository::clear(const PeerId &p) {
     auto it1 = pub_.find(p);
@@ -47,6 +50,9 @@ namespace libp2p::peer {
     auto ptr = std::make_shared<PubVec>();
     ptr->insert(pub);
     pub_.insert({p, std::move(ptr)});
+    if (index_ != nullptr) {
+      index_->add(p, PeerIndex::KEY);
+    }
 
     return outcome::success();
   }
@@ -0,0 +1,53 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/peer/latency_repository/inmem_latency_repository.hpp>
+
+#include <algorithm>
+
+namespace libp2p::peer {
+
+  void InmemLatencyRepository::recordRtt(const PeerId &p,
+                                         std::chrono::milliseconds rtt) {
+    auto &latency = latencies_.try_emplace(p).first->second;
+    if (latency.samples == 0) {
+      latency.ewma = rtt;
+    } else {
+      latency.ewma += (Latency::Milliseconds{rtt} - latency.ewma)
+                    * Latency::kEwmaSmoothing;
+    }
+    latency.last = rtt;
+    ++latency.samples;
+
+    auto bucket = std::lower_bound(Latency::kBucketBounds.begin(),
+                                   Latency::kBucketBounds.end(),
+                                   rtt)
+                - Latency::kBucketBounds.begin();
+    ++latency.histogram.at(bucket);
+  }
+
+  std::optional<Latency> InmemLatencyRepository::getLatency(
+      const PeerId &p) const {
+    auto it = latencies_.find(p);
+    if (it == latencies_.end()) {
+      return std::nullopt;
+    }
+    return it->second;
+  }
+
+  void InmemLatencyRepository::clear(const PeerId &p) {
+    latencies_.erase(p);
+  }
+
+  std::unordered_set<PeerId> InmemLatencyRepository::getPeers() const {
+    std::unordered_set<PeerId> peers;
+    for (const auto &it : latencies_) {
+      peers.insert(it.first);
+    }
+    return peers;
+  }
+
+}  // namespace libp2p::peer
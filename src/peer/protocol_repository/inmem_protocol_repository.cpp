@@ -6,15 +6,33 @@
 
 #include <libp2p/peer/protocol_repository/inmem_protocol_repository.hpp>
 
+#include <algorithm>
+#include <bit>
+
 #include <libp2p/peer/errors.hpp>
 
 namespace libp2p::peer {
+  namespace {
+    constexpr size_t kWordBits = 64;
+  }  // namespace
+
+  InmemProtocolRepository::InmemProtocolRepository(
+      std::shared_ptr<PeerIndex> index)
+      : index_{std::move(index)} {}
 
   outcome::result<void> InmemProtocolRepository::addProtocols(
       const PeerId &p, std::span<const ProtocolName> ms) {
-    auto s = getOrAllocateProtocolSet(p);
+    auto [it, inserted] = db_.try_emplace(p);
+    if (inserted and index_ != nullptr) {
+      index_->add(p, PeerIndex::PROTOCOL);
+    }
+    auto &bits = it->second;
     for (const auto &m : ms) {
-      s->insert(m);
+      auto id = intern(m);
+      if (bits.size() <= id / kWordBits) {
+        bits.resize(id / kWordBits + 1);
+      }
+      bits[id / kWordBits] |= uint64_t{1} << (id % kWordBits);
     }
 
     return outcome::success();
@@ -22,77 +40,131 @@ namespace libp2p::peer {
 
   outcome::result<void> InmemProtocolRepository::removeProtocols(
       const PeerId &p, std::span<const ProtocolName> ms) {
-    OUTCOME_TRY(s, getProtocolSet(p));
+    auto it = db_.find(p);
+    if (it == db_.end()) {
+      return PeerError::NOT_FOUND;
+    }
+    auto &bits = it->second;
 
     for (const auto &m : ms) {
-      s->erase(m);
+      auto id = find(m);
+      if (id and *id / kWordBits < bits.size()) {
+        bits[*id / kWordBits] &= ~(uint64_t{1} << (*id % kWordBits));
+      }
     }
 
     return outcome::success();
   }
 
-  outcome::result<std::vector<ProtocolName>>
+  outcome::result<std::vector<std::string_view>>
   InmemProtocolRepository::getProtocols(const PeerId &p) const {
-    OUTCOME_TRY(s, getProtocolSet(p));
-    return std::vector<ProtocolName>(s->begin(), s->end());
+    OUTCOME_TRY(bits, getProtocolBits(p));
+    std::vector<std::string_view> ret;
+    for (size_t word = 0; word < bits->size(); ++word) {
+      for (auto w = (*bits)[word]; w != 0; w &= w - 1) {
+        ret.emplace_back(names_[word * kWordBits + std::countr_zero(w)]);
+      }
+    }
+    return ret;
   }
 
-  outcome::result<std::vector<ProtocolName>>
+  outcome::result<std::vector<std::string_view>>
   InmemProtocolRepository::supportsProtocols(
       const PeerId &p, const std::set<ProtocolName> &protocols) const {
-    OUTCOME_TRY(s, getProtocolSet(p));
-
-    size_t size = std::min(protocols.size(), s->size());
-    std::vector<ProtocolName> ret;
-    ret.reserve(size);
-
-    std::set_intersection(protocols.begin(),
-                          protocols.end(),
-                          s->begin(),
-                          s->end(),
-                          std::back_inserter(ret));
+    OUTCOME_TRY(bits, getProtocolBits(p));
+
+    // protocols are ordered, so is intersection
+    std::vector<std::string_view> ret;
+    for (const auto &protocol : protocols) {
+      auto id = find(protocol);
+      if (id and test(*bits, *id)) {
+        ret.emplace_back(names_[*id]);
+      }
+    }
     return ret;
   }
 
   void InmemProtocolRepository::clear(const PeerId &p) {
-    auto r = getProtocolSet(p);
-    if (r) {
-      r.value()->clear();
+    auto it = db_.find(p);
+    if (it != db_.end()) {
+      std::fill(it->second.begin(), it->second.end(), 0);
     }
   }
 
-  outcome::result<InmemProtocolRepository::set_ptr>
-  InmemProtocolRepository::getProtocolSet(const PeerId &p) const {
-    auto it = db_.find(p);
-    if (it == db_.end()) {
-      return PeerError::NOT_FOUND;
+  bool InmemProtocolRepository::test(const ProtocolBits &bits,
+                                     ProtocolId id) {
+    return id / kWordBits < bits.size()
+       and (bits[id / kWordBits] >> (id % kWordBits) & 1) != 0;
+  }
+
+  InmemProtocolRepository::ProtocolId InmemProtocolRepository::intern(
+      const ProtocolName &name) {
+    if (auto id = find(name)) {
+      return *id;
     }
+    ProtocolId id = names_.size();
+    if (free_ids_.empty()) {
+      names_.emplace_back(name);
+    } else {
+      id = free_ids_.back();
+      free_ids_.pop_back();
+      names_[id] = name;
+    }
+    ids_.emplace(names_[id], id);
+    return id;
+  }
 
+  std::optional<InmemProtocolRepository::ProtocolId>
+  InmemProtocolRepository::find(std::string_view name) const {
+    auto it = ids_.find(name);
+    if (it == ids_.end()) {
+      return std::nullopt;
+    }
     return it->second;
   }
 
-  InmemProtocolRepository::set_ptr
-  InmemProtocolRepository::getOrAllocateProtocolSet(const PeerId &p) {
+  outcome::result<const InmemProtocolRepository::ProtocolBits *>
+  InmemProtocolRepository::getProtocolBits(const PeerId &p) const {
     auto it = db_.find(p);
     if (it == db_.end()) {
-      set_ptr m = std::make_shared<set>();
-      db_[p] = m;
-      return m;
+      return PeerError::NOT_FOUND;
     }
 
-    return it->second;
+    return &it->second;
   }
 
   void InmemProtocolRepository::collectGarbage() {
+    ProtocolBits used;
     auto peer = db_.begin();
     auto peerend = db_.end();
     while (peer != peerend) {
-      if (peer->second->empty()) {
+      auto &bits = peer->second;
+      if (std::all_of(
+              bits.begin(), bits.end(), [](uint64_t w) { return w == 0; })) {
+        if (index_ != nullptr) {
+          index_->remove(peer->first, PeerIndex::PROTOCOL);
+        }
         // erase returns element next to deleted
         peer = db_.erase(peer);
-      } else {
-        ++peer;
+        continue;
+      }
+      if (used.size() < bits.size()) {
+        used.resize(bits.size());
+      }
+      for (size_t word = 0; word < bits.size(); ++word) {
+        used[word] |= bits[word];
+      }
+      ++peer;
+    }
+
+    for (ProtocolId id = 0; id < names_.size(); ++id) {
+      auto it = ids_.find(names_[id]);
+      if (it == ids_.end() or it->second != id or test(used, id)) {
+        continue;
       }
+      ids_.erase(it);
+      names_[id].clear();
+      free_ids_.push_back(id);
     }
   }
 
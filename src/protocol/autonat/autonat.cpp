@@ -0,0 +1,374 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/protocol/autonat/autonat.hpp>
+
+#include <generated/protocol/autonat/protobuf/autonat.pb.h>
+#include <libp2p/basic/protobuf_message_read_writer.hpp>
+#include <libp2p/connection/stream.hpp>
+#include <libp2p/protocol/autonat/error.hpp>
+
+namespace libp2p::protocol::autonat {
+  namespace {
+    namespace pb = ::autonat::pb;
+
+    using network::Reachability;
+
+    pb::Message response(pb::Message::ResponseStatus status,
+                         std::string text = {}) {
+      pb::Message msg;
+      msg.set_type(pb::Message::DIAL_RESPONSE);
+      auto &response = *msg.mutable_dialresponse();
+      response.set_status(status);
+      if (not text.empty()) {
+        response.set_statustext(std::move(text));
+      }
+      return msg;
+    }
+
+    /// IP of address, which client is dialed back by
+    std::optional<std::string> ipOf(const Multiaddress &addr) {
+      auto protocols = addr.getProtocolsWithValues();
+      if (protocols.empty()) {
+        return std::nullopt;
+      }
+      auto &[protocol, value] = protocols.front();
+      if (protocol.code != multi::Protocol::Code::IP4
+          and protocol.code != multi::Protocol::Code::IP6) {
+        return std::nullopt;
+      }
+      return value;
+    }
+
+    bool isRelayed(const Multiaddress &addr) {
+      return addr.hasProtocol(multi::Protocol::Code::P2P_CIRCUIT);
+    }
+
+    outcome::result<Multiaddress> fromProto(const std::string &bytes) {
+      return Multiaddress::create(BytesIn{
+          reinterpret_cast<const uint8_t *>(bytes.data()), bytes.size()});
+    }
+  }  // namespace
+
+  /// Dial back to client, served by us
+  struct Autonat::DialBack {
+    PeerId peer;
+    std::vector<Multiaddress> addresses;
+    std::shared_ptr<connection::Stream> stream;
+    std::shared_ptr<ReadWriter> rw;
+    /// address being dialed, all are dialed when it reaches the end
+    size_t index = 0;
+    basic::Scheduler::Handle timer;
+  };
+
+  Autonat::Autonat(Host &host,
+                   event::Bus &bus,
+                   std::shared_ptr<network::TransportManager> transports,
+                   std::shared_ptr<basic::Scheduler> scheduler,
+                   AutonatConfig config)
+      : host_{host},
+        bus_{bus},
+        transports_{std::move(transports)},
+        scheduler_{std::move(scheduler)},
+        config_{config} {}
+
+  peer::ProtocolName Autonat::getProtocolId() const {
+    return kAutonatProto;
+  }
+
+  void Autonat::start() {
+    host_.setProtocolHandler(
+        {kAutonatProto},
+        [weak_self{weak_from_this()}](StreamAndProtocol stream) {
+          if (auto self = weak_self.lock()) {
+            self->handle(std::move(stream));
+          }
+        });
+  }
+
+  void Autonat::handle(StreamAndProtocol stream_and_protocol) {
+    auto stream = std::move(stream_and_protocol.stream);
+    auto rw = std::make_shared<ReadWriter>(stream);
+    rw->read<pb::Message>([weak_self{weak_from_this()}, stream, rw](
+                              outcome::result<pb::Message> r) {
+      auto self = weak_self.lock();
+      if (not self or not r) {
+        return stream->reset();
+      }
+      self->onDial(stream, rw, r.value());
+    });
+  }
+
+  void Autonat::onDial(std::shared_ptr<connection::Stream> stream,
+                       std::shared_ptr<ReadWriter> rw,
+                       const pb::Message &msg) {
+    auto reply = [&](const pb::Message &response) {
+      rw->write(response, [stream](outcome::result<size_t> r) {
+        if (not r) {
+          return stream->reset();
+        }
+        stream->close([](outcome::result<void>) {});
+      });
+    };
+    auto peer = stream->remotePeerId();
+    if (not peer or msg.type() != pb::Message::DIAL or not msg.has_dial()
+        or not msg.dial().has_peer()) {
+      return reply(response(pb::Message::E_BAD_REQUEST, "invalid request"));
+    }
+    auto &info = msg.dial().peer();
+    if (info.has_id()) {
+      auto id = PeerId::fromBytes(BytesIn{
+          reinterpret_cast<const uint8_t *>(info.id().data()),
+          info.id().size()});
+      if (not id or id.value() != peer.value()) {
+        return reply(response(pb::Message::E_BAD_REQUEST, "peer mismatch"));
+      }
+    }
+    // dialing other IPs would let client use us for amplification
+    auto observed = stream->remoteMultiaddr();
+    auto ip = observed and not isRelayed(observed.value())
+                ? ipOf(observed.value())
+                : std::nullopt;
+    if (not ip) {
+      return reply(response(pb::Message::E_DIAL_REFUSED, "no observed IP"));
+    }
+    std::vector<Multiaddress> addresses;
+    for (auto &bytes : info.addrs()) {
+      if (addresses.size() >= config_.max_addresses) {
+        break;
+      }
+      auto addr = fromProto(bytes);
+      if (addr and not isRelayed(addr.value()) and ipOf(addr.value()) == ip) {
+        addresses.emplace_back(std::move(addr.value()));
+      }
+    }
+    if (addresses.empty()) {
+      return reply(
+          response(pb::Message::E_DIAL_REFUSED, "no addresses to dial"));
+    }
+    if (dials_ >= config_.max_dials) {
+      return reply(response(pb::Message::E_DIAL_REFUSED, "too many dials"));
+    }
+    ++dials_;
+    dialBack(std::make_shared<DialBack>(DialBack{
+        .peer = peer.value(),
+        .addresses = std::move(addresses),
+        .stream = std::move(stream),
+        .rw = std::move(rw),
+    }));
+  }
+
+  void Autonat::dialBack(std::shared_ptr<DialBack> dial) {
+    for (; dial->index < dial->addresses.size(); ++dial->index) {
+      auto &addr = dial->addresses[dial->index];
+      auto transport = transports_->findBest(addr);
+      if (not transport) {
+        continue;
+      }
+      auto next = [weak_self{weak_from_this()}, dial, i{dial->index}] {
+        if (dial->index != i) {
+          return;
+        }
+        if (auto self = weak_self.lock()) {
+          ++dial->index;
+          self->dialBack(dial);
+        }
+      };
+      dial->timer = scheduler_->scheduleWithHandle(next, config_.dial_timeout);
+      // not reusing connection to client, so that reachability is checked
+      transport->dial(
+          dial->peer,
+          addr,
+          [weak_self{weak_from_this()}, dial, i{dial->index}, next](
+              outcome::result<std::shared_ptr<connection::CapableConnection>>
+                  r) {
+            if (r) {
+              (void)r.value()->close();
+            }
+            auto self = weak_self.lock();
+            if (not self or dial->index != i) {
+              return;
+            }
+            dial->timer.reset();
+            if (not r) {
+              return next();
+            }
+            auto msg = response(pb::Message::OK);
+            auto &bytes = dial->addresses[i].getBytesAddress();
+            msg.mutable_dialresponse()->set_addr(bytes.data(), bytes.size());
+            self->finishDial(dial, msg);
+          });
+      return;
+    }
+    finishDial(dial, response(pb::Message::E_DIAL_ERROR, "dial failed"));
+  }
+
+  void Autonat::finishDial(std::shared_ptr<DialBack> dial,
+                           const pb::Message &response) {
+    --dials_;
+    dial->index = dial->addresses.size();
+    dial->timer.reset();
+    dial->rw->write(response,
+                    [stream{dial->stream}](outcome::result<size_t> r) {
+                      if (not r) {
+                        return stream->reset();
+                      }
+                      stream->close([](outcome::result<void>) {});
+                    });
+  }
+
+  void Autonat::probe(const PeerId &server, ProbeCb cb) {
+    auto addresses = candidates();
+    // addresses, which are not ours anymore, are forgotten
+    std::erase_if(status_, [&](const auto &p) {
+      if (std::ranges::find(addresses, p.first) != addresses.end()) {
+        return false;
+      }
+      if (p.second.reachability != Reachability::UNKNOWN) {
+        bus_.getChannel<event::network::AddressReachabilityChannel>().publish(
+            network::AddressReachability{p.first, Reachability::UNKNOWN});
+      }
+      return true;
+    });
+    if (addresses.empty()) {
+      return cb(AutonatError::NO_ADDRESSES);
+    }
+    pb::Message msg;
+    msg.set_type(pb::Message::DIAL);
+    auto &info = *msg.mutable_dial()->mutable_peer();
+    auto &id = host_.getId().toVector();
+    info.set_id(id.data(), id.size());
+    for (auto &addr : addresses) {
+      auto &bytes = addr.getBytesAddress();
+      info.add_addrs(bytes.data(), bytes.size());
+    }
+    host_.newStream(
+        PeerInfo{.id = server},
+        {kAutonatProto},
+        [weak_self{weak_from_this()},
+         msg{std::move(msg)},
+         addresses{std::move(addresses)},
+         cb{std::move(cb)}](StreamAndProtocolOrError r) {
+          auto self = weak_self.lock();
+          if (not self) {
+            if (r) {
+              r.value().stream->reset();
+            }
+            return;
+          }
+          if (not r) {
+            return cb(r.error());
+          }
+          auto stream = std::move(r.value().stream);
+          auto rw = std::make_shared<ReadWriter>(stream);
+          auto timer = std::make_shared<basic::Scheduler::Handle>(
+              self->scheduler_->scheduleWithHandle(
+                  [stream] { stream->reset(); }, self->config_.timeout));
+          auto on_response = [weak_self, stream, timer, addresses, cb](
+                                 outcome::result<pb::Message> r) {
+            timer->reset();
+            auto self = weak_self.lock();
+            if (not self or not r) {
+              stream->reset();
+              if (not r) {
+                cb(r.error());
+              }
+              return;
+            }
+            stream->close([](outcome::result<void>) {});
+            self->onResponse(addresses, r.value(), cb);
+          };
+          rw->write(msg,
+                    [stream,
+                     rw,
+                     timer,
+                     cb,
+                     on_response{std::move(on_response)}](
+                        outcome::result<size_t> r) mutable {
+                      if (not r) {
+                        timer->reset();
+                        stream->reset();
+                        return cb(r.error());
+                      }
+                      rw->read<pb::Message>(std::move(on_response));
+                    });
+        });
+  }
+
+  void Autonat::onResponse(const std::vector<Multiaddress> &addresses,
+                           const pb::Message &msg,
+                           const ProbeCb &cb) {
+    if (msg.type() != pb::Message::DIAL_RESPONSE
+        or not msg.has_dialresponse()) {
+      return cb(AutonatError::UNEXPECTED_MESSAGE);
+    }
+    auto &response = msg.dialresponse();
+    switch (response.status()) {
+      case pb::Message::OK: {
+        auto addr = fromProto(response.addr());
+        if (not addr
+            or std::ranges::find(addresses, addr.value()) == addresses.end()) {
+          return cb(AutonatError::UNEXPECTED_MESSAGE);
+        }
+        observe(addr.value(), Reachability::PUBLIC);
+        return cb(std::move(addr.value()));
+      }
+      case pb::Message::E_DIAL_ERROR:
+        for (auto &addr : addresses) {
+          observe(addr, Reachability::PRIVATE);
+        }
+        return cb(AutonatError::DIAL_ERROR);
+      case pb::Message::E_DIAL_REFUSED:
+        return cb(AutonatError::DIAL_REFUSED);
+      case pb::Message::E_BAD_REQUEST:
+        return cb(AutonatError::BAD_REQUEST);
+      default:
+        return cb(AutonatError::INTERNAL_ERROR);
+    }
+  }
+
+  void Autonat::observe(const Multiaddress &address,
+                        Reachability reachability) {
+    auto &status = status_[address];
+    if (status.reachability == reachability) {
+      status.confidence =
+          std::min(status.confidence + 1, config_.max_confidence);
+      return;
+    }
+    if (status.confidence > 0) {
+      --status.confidence;
+      return;
+    }
+    status.reachability = reachability;
+    bus_.getChannel<event::network::AddressReachabilityChannel>().publish(
+        network::AddressReachability{address, reachability});
+  }
+
+  Reachability Autonat::reachability(const Multiaddress &address) const {
+    auto it = status_.find(address);
+    return it == status_.end() ? Reachability::UNKNOWN
+                               : it->second.reachability;
+  }
+
+  std::vector<Multiaddress> Autonat::candidates() const {
+    std::vector<Multiaddress> addresses;
+    auto add = [&](std::vector<Multiaddress> more) {
+      for (auto &addr : more) {
+        auto ip = ipOf(addr);
+        if (addresses.size() >= config_.max_addresses or isRelayed(addr)
+            or ip == "0.0.0.0" or ip == "::"
+            or std::ranges::find(addresses, addr) != addresses.end()) {
+          continue;
+        }
+        addresses.emplace_back(std::move(addr));
+      }
+    };
+    add(host_.getObservedAddresses());
+    add(host_.getAddresses());
+    add(host_.getAddressesInterfaces());
+    return addresses;
+  }
+}  // namespace libp2p::protocol::autonat
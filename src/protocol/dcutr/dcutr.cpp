@@ -0,0 +1,289 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/protocol/dcutr/dcutr.hpp>
+
+#include <boost/asio/error.hpp>
+#include <generated/protocol/dcutr/protobuf/holepunch.pb.h>
+#include <libp2p/basic/protobuf_message_read_writer.hpp>
+#include <libp2p/connection/stream.hpp>
+#include <libp2p/protocol/dcutr/error.hpp>
+
+namespace libp2p::protocol::dcutr {
+  namespace {
+    namespace pb = ::holepunch::pb;
+
+    pb::HolePunch message(pb::HolePunch::Type type,
+                          const std::vector<Multiaddress> &addresses) {
+      pb::HolePunch msg;
+      msg.set_type(type);
+      for (auto &addr : addresses) {
+        auto &bytes = addr.getBytesAddress();
+        msg.add_obsaddrs(bytes.data(), bytes.size());
+      }
+      return msg;
+    }
+
+    bool isDirect(const Multiaddress &addr) {
+      return not addr.hasProtocol(multi::Protocol::Code::P2P_CIRCUIT);
+    }
+  }  // namespace
+
+  /// One round of hole punching, initiated by us
+  struct Dcutr::Round {
+    PeerId peer;
+    Host::ConnectionResultHandler cb;
+    size_t attempt = 1;
+    std::shared_ptr<connection::Stream> stream;
+    std::shared_ptr<ReadWriter> rw;
+    basic::Scheduler::Handle timer;
+    bool timed_out = false;
+    basic::Scheduler::Time sent{};
+  };
+
+  Dcutr::Dcutr(Host &host,
+               std::shared_ptr<basic::Scheduler> scheduler,
+               DcutrConfig config)
+      : host_{host}, scheduler_{std::move(scheduler)}, config_{config} {}
+
+  peer::ProtocolName Dcutr::getProtocolId() const {
+    return kDcutrProto;
+  }
+
+  void Dcutr::start() {
+    host_.setProtocolHandler(
+        {kDcutrProto}, [weak_self{weak_from_this()}](StreamAndProtocol stream) {
+          if (auto self = weak_self.lock()) {
+            self->handle(std::move(stream));
+          }
+        });
+  }
+
+  void Dcutr::handle(StreamAndProtocol stream_and_protocol) {
+    auto stream = std::move(stream_and_protocol.stream);
+    auto peer = stream->remotePeerId();
+    auto local = localAddresses();
+    if (not peer or local.empty()) {
+      return stream->reset();
+    }
+    auto rw = std::make_shared<ReadWriter>(stream);
+    auto timer = std::make_shared<basic::Scheduler::Handle>(
+        scheduler_->scheduleWithHandle([stream] { stream->reset(); },
+                                       config_.timeout));
+    auto on_sync = [weak_self{weak_from_this()}, stream, timer](
+                       outcome::result<pb::HolePunch> r,
+                       PeerInfo remote) {
+      timer->reset();
+      auto self = weak_self.lock();
+      if (not self or not r or r.value().type() != pb::HolePunch::SYNC) {
+        return stream->reset();
+      }
+      stream->close([](outcome::result<void>) {});
+      // initiator waits half of round trip after sending SYNC, so both peers
+      // dial at once
+      self->host_.connect(remote, [](Host::ConnectionResult) {});
+    };
+    rw->read<pb::HolePunch>([weak_self{weak_from_this()},
+                             peer{peer.value()},
+                             local{std::move(local)},
+                             stream,
+                             rw,
+                             timer,
+                             on_sync{std::move(on_sync)}](
+                                outcome::result<pb::HolePunch> r) {
+      auto self = weak_self.lock();
+      if (not self or not r or r.value().type() != pb::HolePunch::CONNECT) {
+        timer->reset();
+        return stream->reset();
+      }
+      PeerInfo remote{.id = peer,
+                      .addresses = self->remoteAddresses(r.value())};
+      if (remote.addresses.empty()) {
+        timer->reset();
+        return stream->reset();
+      }
+      rw->write(message(pb::HolePunch::CONNECT, local),
+                [stream, rw, timer, remote, on_sync](
+                    outcome::result<size_t> r) mutable {
+                  if (not r) {
+                    timer->reset();
+                    return stream->reset();
+                  }
+                  rw->read<pb::HolePunch>(
+                      [remote{std::move(remote)}, on_sync](
+                          outcome::result<pb::HolePunch> r) {
+                        on_sync(std::move(r), remote);
+                      });
+                });
+    });
+  }
+
+  void Dcutr::upgrade(const PeerId &peer, Host::ConnectionResultHandler cb) {
+    attempt(std::make_shared<Round>(Round{.peer = peer, .cb = std::move(cb)}));
+  }
+
+  void Dcutr::attempt(std::shared_ptr<Round> round) {
+    auto local = localAddresses();
+    if (local.empty()) {
+      return round->cb(DcutrError::NO_ADDRESSES);
+    }
+    // stream goes over relayed connection, which is the only one to peer
+    host_.newStream(
+        PeerInfo{.id = round->peer},
+        {kDcutrProto},
+        [weak_self{weak_from_this()}, round, local{std::move(local)}](
+            StreamAndProtocolOrError r) {
+          auto self = weak_self.lock();
+          if (not self) {
+            if (r) {
+              r.value().stream->reset();
+            }
+            return abort(round);
+          }
+          if (not r) {
+            return self->retry(round, r.error());
+          }
+          round->stream = std::move(r.value().stream);
+          round->rw = std::make_shared<ReadWriter>(round->stream);
+          round->timed_out = false;
+          round->timer = self->scheduler_->scheduleWithHandle(
+              [weak_round{std::weak_ptr{round}}] {
+                if (auto round = weak_round.lock()) {
+                  round->timed_out = true;
+                  round->stream->reset();
+                }
+              },
+              self->config_.timeout);
+          round->sent = self->scheduler_->now();
+          round->rw->write(
+              message(pb::HolePunch::CONNECT, local),
+              [weak_self, round](outcome::result<size_t> r) {
+                auto self = weak_self.lock();
+                if (not self) {
+                  return abort(round);
+                }
+                if (not r) {
+                  return self->retry(round, r.error());
+                }
+                round->rw->read<pb::HolePunch>(
+                    [weak_self, round](outcome::result<pb::HolePunch> r) {
+                      auto self = weak_self.lock();
+                      if (not self) {
+                        return abort(round);
+                      }
+                      if (not r) {
+                        return self->retry(round, r.error());
+                      }
+                      self->onConnect(round, r.value());
+                    });
+              });
+        });
+  }
+
+  void Dcutr::onConnect(std::shared_ptr<Round> round,
+                        const pb::HolePunch &msg) {
+    if (msg.type() != pb::HolePunch::CONNECT) {
+      round->timer.reset();
+      round->stream->reset();
+      return round->cb(DcutrError::UNEXPECTED_MESSAGE);
+    }
+    auto rtt = scheduler_->now() - round->sent;
+    PeerInfo remote{.id = round->peer, .addresses = remoteAddresses(msg)};
+    if (remote.addresses.empty()) {
+      round->timer.reset();
+      round->stream->reset();
+      return round->cb(DcutrError::NO_ADDRESSES);
+    }
+    round->rw->write(
+        message(pb::HolePunch::SYNC, {}),
+        [weak_self{weak_from_this()}, round, rtt, remote{std::move(remote)}](
+            outcome::result<size_t> r) {
+          auto self = weak_self.lock();
+          if (not self) {
+            return abort(round);
+          }
+          if (not r) {
+            return self->retry(round, r.error());
+          }
+          round->timer.reset();
+          round->stream->close([](outcome::result<void>) {});
+          // peer dials as soon as SYNC arrives, which takes half of round trip
+          self->scheduler_->schedule(
+              [weak_self, round, remote] {
+                auto self = weak_self.lock();
+                if (not self) {
+                  return abort(round);
+                }
+                self->host_.connect(
+                    remote, [weak_self, round](Host::ConnectionResult r) {
+                      auto self = weak_self.lock();
+                      if (self and not r) {
+                        return self->retry(round, r.error());
+                      }
+                      round->cb(std::move(r));
+                    });
+              },
+              rtt / 2);
+        });
+  }
+
+  void Dcutr::abort(const std::shared_ptr<Round> &round) {
+    round->timer.reset();
+    if (round->stream) {
+      round->stream->reset();
+    }
+    round->cb(make_error_code(boost::asio::error::operation_aborted));
+  }
+
+  void Dcutr::retry(std::shared_ptr<Round> round, std::error_code error) {
+    round->timer.reset();
+    if (round->stream) {
+      round->stream->reset();
+      round->stream.reset();
+      round->rw.reset();
+    }
+    if (round->timed_out) {
+      error = make_error_code(DcutrError::TIMEOUT);
+    }
+    if (round->attempt >= config_.max_attempts) {
+      return round->cb(error);
+    }
+    ++round->attempt;
+    attempt(std::move(round));
+  }
+
+  std::vector<Multiaddress> Dcutr::localAddresses() const {
+    // observed addresses go first, as they are what NAT maps us to
+    auto addresses = host_.getObservedAddresses();
+    for (auto &addr : host_.getAddresses()) {
+      if (std::ranges::find(addresses, addr) == addresses.end()) {
+        addresses.emplace_back(addr);
+      }
+    }
+    std::erase_if(addresses, [](auto &addr) { return not isDirect(addr); });
+    if (addresses.size() > config_.max_addresses) {
+      addresses.erase(addresses.begin() + config_.max_addresses,
+                      addresses.end());
+    }
+    return addresses;
+  }
+
+  std::vector<Multiaddress> Dcutr::remoteAddresses(
+      const pb::HolePunch &msg) const {
+    std::vector<Multiaddress> addresses;
+    for (auto &bytes : msg.obsaddrs()) {
+      if (addresses.size() >= config_.max_addresses) {
+        break;
+      }
+      auto addr = Multiaddress::create(BytesIn{
+          reinterpret_cast<const uint8_t *>(bytes.data()), bytes.size()});
+      if (addr and isDirect(addr.value())) {
+        addresses.emplace_back(std::move(addr.value()));
+      }
+    }
+    return addresses;
+  }
+}  // namespace libp2p::protocol::dcutr
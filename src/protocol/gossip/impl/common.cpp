@@ -31,6 +31,8 @@ OUTCOME_CPP_DEFINE_CATEGORY(libp2p::protocol::gossip, Error, e) {
       return "cannot connect to peer";
     case E::VALIDATION_FAILED:
       return "validation failed";
+    case E::INVALID_PEER_RECORD:
+      return "invalid signed peer record";
     default:
       break;
   }
@@ -92,9 +94,9 @@ namespace libp2p::protocol::gossip {
   MessageId createMessageId(const Bytes &from,
                             const Bytes &seq,
                             const Bytes &data) {
-    MessageId msg_id(from);
-    msg_id.reserve(seq.size() + from.size());
-    msg_id.insert(msg_id.end(), seq.begin(), seq.end());
+    // message id == from + seq_no, fits inline
+    MessageId msg_id{from};
+    msg_id.append(seq);
     return msg_id;
   }
 
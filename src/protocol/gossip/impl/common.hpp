@@ -8,6 +8,7 @@
 
 #include <cstdint>
 #include <memory>
+#include <string_view>
 
 #include <libp2p/protocol/gossip/gossip.hpp>
 
@@ -24,7 +25,8 @@ namespace libp2p::protocol::gossip {
     READER_TIMEOUT,
     WRITER_TIMEOUT,
     CANNOT_CONNECT,
-    VALIDATION_FAILED
+    VALIDATION_FAILED,
+    INVALID_PEER_RECORD
   };
 
   /// Success indicator to be passed in outcome::result
@@ -33,6 +35,29 @@ namespace libp2p::protocol::gossip {
   /// Shared buffer used to broadcast messages
   using SharedBuffer = std::shared_ptr<const Bytes>;
 
+  /// Serialized message parts, written in order
+  using SharedBuffers = std::vector<SharedBuffer>;
+
+  /// Priority of outgoing RPC, lanes of stream are written in this order.
+  /// Forward and gossip RPCs of slow peers are dropped, the rest are not
+  enum class Lane : uint8_t {
+    /// Subscriptions, graft, prune, iwant and idontwant
+    CONTROL,
+    /// Messages published locally
+    PUBLISH,
+    /// Messages forwarded from other peers
+    FORWARD,
+    /// IHAVE announcements
+    GOSSIP,
+  };
+  constexpr size_t kLanes = 4;
+
+  /// RPC serialized for lane
+  struct LaneBuffers {
+    Lane lane;
+    SharedBuffers buffers;
+  };
+
   /// Time is scheduler's clock and counter
   using Time = std::chrono::milliseconds;
 
@@ -41,9 +66,6 @@ namespace libp2p::protocol::gossip {
 
   using TopicId = std::string;
 
-  // message id == string(seq_no + from)
-  using MessageId = Bytes;
-
   /// Remote peer and its context
   using PeerContextPtr = std::shared_ptr<struct PeerContext>;
 
@@ -57,9 +79,12 @@ namespace libp2p::protocol::gossip {
     /// Sequence number: big endian uint64_t converted to string
     const Bytes seq_no;
 
-    /// Arbitrary data
+    /// Arbitrary data, compressed if topic has codec
     const Bytes data;
 
+    /// Decompressed data if topic has codec
+    boost::optional<Bytes> decoded;
+
     /// Topic ids
     TopicId topic;
 
@@ -68,9 +93,18 @@ namespace libp2p::protocol::gossip {
     boost::optional<Bytes> signature;
     boost::optional<Bytes> key;
 
+    /// Serialized once as RPC publish field, then shared by all RPCs
+    /// forwarding the message
+    mutable SharedBuffer rpc_field{};
+
     /// Creates a new message from wire or storage
     TopicMessage(Bytes _from, Bytes _seq, Bytes _data);
 
+    /// Data for validators and subscribers
+    const Bytes &payload() const {
+      return decoded ? *decoded : data;
+    }
+
     /// Creates topic message from scratch before publishing
     TopicMessage(const peer::PeerId &_from,
                  uint64_t _seq,
@@ -78,6 +112,25 @@ namespace libp2p::protocol::gossip {
                  TopicId _topic);
   };
 
+  /// Fields of message received from wire, which point into received bytes,
+  /// so duplicates are dropped before anything is copied
+  struct TopicMessageView {
+    BytesIn from;
+    BytesIn seq_no;
+    BytesIn data;
+    std::string_view topic;
+    boost::optional<BytesIn> signature;
+    boost::optional<BytesIn> key;
+  };
+
+  /// Peer suggested in PRUNE for peer exchange (gossipsub v1.1 PX).
+  /// Points into received bytes
+  struct PxPeer {
+    peer::PeerId peer_id;
+    /// Signed peer record envelope, empty if the pruner has no record
+    BytesIn signed_record;
+  };
+
   /// Returns "zero" peer id, needed for consistency purposes
   const peer::PeerId &getEmptyPeer();
 
@@ -11,6 +11,7 @@
 #include <boost/range/algorithm/for_each.hpp>
 
 #include "message_builder.hpp"
+#include "message_parser.hpp"
 #include "message_receiver.hpp"
 
 namespace libp2p::protocol::gossip {
@@ -24,6 +25,22 @@ namespace libp2p::protocol::gossip {
               != container.end());
     }
 
+    /// Remote ip address of stream, for peer scoring
+    boost::optional<std::string> remoteIp(const connection::Stream &stream) {
+      auto address = stream.remoteMultiaddr();
+      if (!address) {
+        return boost::none;
+      }
+      for (auto code : {multi::Protocol::Code::IP4,
+                        multi::Protocol::Code::IP6}) {
+        auto ip = address.value().getFirstValueForProtocol(code);
+        if (ip) {
+          return std::move(ip.value());
+        }
+      }
+      return boost::none;
+    }
+
   }  // namespace
 
   Connectivity::Connectivity(Config config,
@@ -76,6 +93,7 @@ namespace libp2p::protocol::gossip {
 
   void Connectivity::stop() {
     started_ = false;
+    flush_timer_.reset();
     all_peers_.selectAll([](const PeerContextPtr &ctx) {
       for (auto &stream : ctx->inbound_streams) {
         stream->close();
@@ -111,6 +129,39 @@ namespace libp2p::protocol::gossip {
     }
   }
 
+  void Connectivity::addPxPeer(const peer::PeerId &id,
+                               std::span<const multi::Multiaddress> addresses,
+                               SharedBuffer signed_record,
+                               uint64_t record_seq) {
+    if (id == host_->getId()) {
+      return;
+    }
+
+    PeerContextPtr ctx;
+    if (auto found = all_peers_.find(id)) {
+      ctx = std::move(found.value());
+    } else {
+      ctx = std::make_shared<PeerContext>(id);
+      all_peers_.insert(ctx);
+    }
+
+    if (signed_record
+        && (!ctx->signed_record || record_seq > ctx->record_seq)) {
+      std::ignore =
+          host_->getPeerRepository().getAddressRepository().upsertAddresses(
+              id, addresses, config_.address_expiration_msec);
+      ctx->signed_record = std::move(signed_record);
+      ctx->record_seq = record_seq;
+    }
+
+    if (!started_ || ctx->banned_until != Time::zero()) {
+      // banned peers are dialed when unbanned
+      return;
+    }
+    log_.debug("dialing {} from peer exchange", ctx->str);
+    dial(ctx);
+  }
+
   void Connectivity::flush(const PeerContextPtr &ctx) const {
     assert(ctx);
     assert(ctx->message_builder);
@@ -129,9 +180,35 @@ namespace libp2p::protocol::gossip {
       return;
     }
 
-    // N.B. errors, if any, will be passed later in async manner
-    auto serialized = ctx->message_builder->serialize();
-    ctx->outbound_stream->write(std::move(serialized));
+    if (auto connection = ctx->datagram_connection.lock()) {
+      // lost datagrams are not resent, as IHAVE and IDONTWANT are hints
+      auto max_size = connection->maxDatagramSize();
+      for (auto &datagram : ctx->message_builder->takeDatagrams(max_size)) {
+        std::ignore = connection->sendDatagram(datagram);
+      }
+      if (ctx->message_builder->empty()) {
+        return;
+      }
+    }
+
+    if (ctx->outbound_stream->isWriting()
+        && !ctx->message_builder->urgent()
+        && ctx->message_builder->messagesSize()
+               < config_.write_coalescing_bytes) {
+      // will be flushed as one RPC after the current write
+      return;
+    }
+
+    // control is queued ahead of data, forwards may be shed for slow peer
+    auto serialized = ctx->message_builder->serializeLanes();
+    if (!serialized) {
+      // N.B. error will be passed later in async manner
+      ctx->outbound_stream->write(serialized.error());
+      return;
+    }
+    for (auto &rpc : serialized.value()) {
+      ctx->outbound_stream->write(std::move(rpc.buffers), rpc.lane);
+    }
   }
 
   peer::ProtocolName Connectivity::getProtocolId() const {
@@ -184,6 +261,9 @@ namespace libp2p::protocol::gossip {
 
     stream_id = ctx->inbound_streams.size() + 1;
     is_new_connection = (stream_id == 1 && !ctx->outbound_stream);
+    if (is_new_connection) {
+      ctx->ip = remoteIp(*stream);
+    }
 
     auto gossip_stream = std::make_shared<Stream>(stream_id,
                                                   config_,
@@ -193,11 +273,13 @@ namespace libp2p::protocol::gossip {
                                                   std::move(stream),
                                                   ctx);
 
+    gossip_stream->pauseReading(reading_paused_);
     gossip_stream->read();
 
     ctx->inbound_streams.push_back(std::move(gossip_stream));
 
     if (is_new_connection) {
+      useDatagrams(ctx);
       connected_peers_.insert(ctx);
       connected_cb_(true, ctx);
     }
@@ -301,6 +383,9 @@ namespace libp2p::protocol::gossip {
 
     size_t stream_id = 0;
     bool is_new_connection = ctx->inbound_streams.empty();
+    if (is_new_connection) {
+      ctx->ip = remoteIp(*stream);
+    }
 
     auto gossip_stream = std::make_shared<Stream>(stream_id,
                                                   config_,
@@ -310,11 +395,13 @@ namespace libp2p::protocol::gossip {
                                                   std::move(stream),
                                                   ctx);
 
+    gossip_stream->pauseReading(reading_paused_);
     gossip_stream->read();
 
     ctx->outbound_stream = std::move(gossip_stream);
 
     if (is_new_connection) {
+      useDatagrams(ctx);
       connected_peers_.insert(ctx);
       connected_cb_(true, ctx);
     }
@@ -378,6 +465,34 @@ namespace libp2p::protocol::gossip {
     banned_peers_expiration_.erase(it);
   }
 
+  void Connectivity::useDatagrams(const PeerContextPtr &ctx) {
+    if (!config_.datagram_control) {
+      return;
+    }
+    auto connection =
+        host_->getNetwork().getConnectionManager().getBestConnectionForPeer(
+            ctx->peer_id);
+    if (!connection || connection->maxDatagramSize() == 0) {
+      return;
+    }
+    ctx->datagram_connection = connection;
+    connection->onDatagram(
+        [wptr = weak_from_this(), weak_ctx = std::weak_ptr{ctx}](
+            BytesIn datagram) {
+          auto self = wptr.lock();
+          auto ctx = weak_ctx.lock();
+          if (!self || !ctx || !self->started_) {
+            return;
+          }
+          MessageParser parser;
+          if (!parser.parse(datagram)) {
+            self->log_.debug("ignoring bad datagram from {}", ctx->str);
+            return;
+          }
+          parser.dispatch(ctx, *self->msg_receiver_);
+        });
+  }
+
   void Connectivity::onStreamEvent(const PeerContextPtr &from,
                                    outcome::result<Success> event) {
     if (!started_) {
@@ -385,7 +500,8 @@ namespace libp2p::protocol::gossip {
     }
 
     if (event) {
-      // do nothing at the moment, keep it connected
+      // stream is writable again
+      flush(from);
       return;
     }
     log_.info("stream error='{}', peer={}", event.error(), from->str);
@@ -401,20 +517,51 @@ namespace libp2p::protocol::gossip {
       return;
     }
 
+    if (ctx->message_builder->messagesSize() >= config_.write_coalescing_bytes) {
+      flush(ctx);
+      return;
+    }
+
     if (low_latency) {
       writable_peers_low_latency_.insert(ctx);
+      if (config_.write_coalescing_window_msec > Time::zero()) {
+        flush();
+      }
     } else {
       writable_peers_on_heartbeat_.insert(ctx);
     }
   }
 
   void Connectivity::flush() {
+    if (config_.write_coalescing_window_msec == Time::zero()) {
+      flushLowLatency();
+      return;
+    }
+    if (flush_timer_ || writable_peers_low_latency_.empty()) {
+      return;
+    }
+    flush_timer_ = scheduler_->scheduleWithHandle(
+        [weak_self{weak_from_this()}] {
+          auto self = weak_self.lock();
+          if (!self) {
+            return;
+          }
+          self->flush_timer_.reset();
+          self->flushLowLatency();
+        },
+        config_.write_coalescing_window_msec);
+  }
+
+  void Connectivity::flushLowLatency() {
     writable_peers_low_latency_.selectAll(
         [this](const PeerContextPtr &ctx) { flush(ctx); });
     writable_peers_low_latency_.clear();
   }
 
-  void Connectivity::onHeartbeat(const std::map<TopicId, bool> &local_changes) {
+  void Connectivity::onHeartbeat(const std::map<TopicId, bool> &local_changes,
+                                 size_t slice,
+                                 size_t slices) {
+    assert(slice < slices);
     if (!started_) {
       return;
     }
@@ -435,11 +582,17 @@ namespace libp2p::protocol::gossip {
       dial(ctx);
     }
 
-    // connect if needed
-    auto sz = connected_peers_.size();
-    if (sz < config_.ideal_connections_num) {
-      auto peers = connectable_peers_.selectRandomPeers(
-          config_.ideal_connections_num - sz);
+    // connect if needed, a share of missing peers per slice
+    if (slice == 0) {
+      auto sz = connected_peers_.size();
+      dials_left_ = sz < config_.ideal_connections_num
+                      ? config_.ideal_connections_num - sz
+                      : 0;
+    }
+    auto dials = (dials_left_ + slices - slice - 1) / (slices - slice);
+    dials_left_ -= dials;
+    if (dials != 0) {
+      auto peers = connectable_peers_.selectRandomPeers(dials);
       for (auto &p : peers) {
         if (!p->outbound_stream) {
           log_.debug("dialing {}", p->str);
@@ -466,7 +619,7 @@ namespace libp2p::protocol::gossip {
           });
 
     } else {
-      flush();
+      flushLowLatency();
       writable_peers_on_heartbeat_.selectAll(
           [this](const PeerContextPtr &ctx) { flush(ctx); });
     }
@@ -485,6 +638,22 @@ namespace libp2p::protocol::gossip {
     }
   }
 
+  void Connectivity::pauseReading(bool pause) {
+    if (reading_paused_ == pause) {
+      return;
+    }
+    reading_paused_ = pause;
+    log_.debug("reading {}", pause ? "paused" : "resumed");
+    connected_peers_.selectAll([pause](const PeerContextPtr &ctx) {
+      if (ctx->outbound_stream) {
+        ctx->outbound_stream->pauseReading(pause);
+      }
+      for (auto &stream : ctx->inbound_streams) {
+        stream->pauseReading(pause);
+      }
+    });
+  }
+
   const PeerSet &Connectivity::getConnectedPeers() const {
     return connected_peers_;
   }
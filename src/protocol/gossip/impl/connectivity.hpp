@@ -49,6 +49,13 @@ namespace libp2p::protocol::gossip {
     void addBootstrapPeer(const peer::PeerId &id,
                           const boost::optional<multi::Multiaddress> &address);
 
+    /// Adds peer suggested in PRUNE and dials it at once, if not connected.
+    /// Newer peer record replaces addresses and is forwarded in PRUNE
+    void addPxPeer(const peer::PeerId &id,
+                   std::span<const multi::Multiaddress> addresses,
+                   SharedBuffer signed_record,
+                   uint64_t record_seq);
+
     /// Add peer to writable set, actual writes occur on flush() (piggybacking)
     /// The idea behind writable set and flush() is a compromise between
     /// latency and message rate
@@ -58,12 +65,18 @@ namespace libp2p::protocol::gossip {
     void flush();
 
     /// Performs periodic tasks and broadcasts heartbeat message to
-    /// all connected peers. The changes are subscribe/unsubscribe events
-    void onHeartbeat(const std::map<TopicId, bool> &local_changes);
+    /// all connected peers. The changes are subscribe/unsubscribe events.
+    /// Dials of heartbeat interval are spread over its slices
+    void onHeartbeat(const std::map<TopicId, bool> &local_changes,
+                     size_t slice,
+                     size_t slices);
 
     /// Returns connected peers
     const PeerSet &getConnectedPeers() const;
 
+    /// Pauses or resumes reading from all streams (backpressure)
+    void pauseReading(bool pause);
+
    private:
     using BannedPeers = std::set<std::pair<Time, PeerContextPtr>>;
 
@@ -83,6 +96,10 @@ namespace libp2p::protocol::gossip {
     void onNewStream(const PeerContextPtr &ctx,
                      StreamAndProtocolOrError rstream);
 
+    /// Receives and sends datagrams over peer connection, if configured
+    /// and supported by it
+    void useDatagrams(const PeerContextPtr &ctx);
+
     /// Async feedback from streams
     void onStreamEvent(const PeerContextPtr &from,
                        outcome::result<Success> event);
@@ -96,9 +113,14 @@ namespace libp2p::protocol::gossip {
     /// Unbans peer
     void unban(BannedPeers::iterator it);
 
-    /// Flushes outgoing messages into wire for a given peer, if connected
+    /// Flushes outgoing messages into wire for a given peer, if connected.
+    /// Messages are held while a write to peer is in progress, unless they
+    /// exceed coalescing size
     void flush(const PeerContextPtr &ctx) const;
 
+    /// Flushes low latency writable peers without delay
+    void flushLowLatency();
+
     const Config config_;
     std::shared_ptr<basic::Scheduler> scheduler_;
     std::shared_ptr<Host> host_;
@@ -106,6 +128,7 @@ namespace libp2p::protocol::gossip {
     ConnectionStatusFeedback connected_cb_;
     Stream::Feedback on_stream_event_;
     bool started_ = false;
+    bool reading_paused_ = false;
 
     /// All known peers
     PeerSet all_peers_;
@@ -126,6 +149,12 @@ namespace libp2p::protocol::gossip {
     /// Peers to be flushed on next heartbeat
     PeerSet writable_peers_on_heartbeat_;
 
+    /// Flushes low latency peers at the end of coalescing window
+    basic::Scheduler::Handle flush_timer_;
+
+    /// Dials left for the current heartbeat interval
+    size_t dials_left_ = 0;
+
     /// Renew addresses in address repo periodically within heartbeat timer
     std::chrono::milliseconds addresses_renewal_time_{0};
 
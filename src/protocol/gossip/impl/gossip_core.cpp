@@ -6,8 +6,12 @@
 
 #include "gossip_core.hpp"
 
+#include <algorithm>
 #include <cassert>
 
+#include <boost/asio/post.hpp>
+#include <libp2p/basic/codec.hpp>
+#include <libp2p/common/metrics/registry.hpp>
 #include <libp2p/crypto/crypto_provider.hpp>
 #include <libp2p/crypto/key_marshaller.hpp>
 #include <libp2p/peer/identity_manager.hpp>
@@ -16,9 +20,47 @@
 #include "connectivity.hpp"
 #include "local_subscriptions.hpp"
 #include "message_builder.hpp"
+#include "peer_record.hpp"
 #include "remote_subscriptions.hpp"
 
 namespace libp2p::protocol::gossip {
+  namespace {
+    /// Heartbeats, at least one, covering the lifetime
+    size_t historyLength(const Config &config, Time lifetime) {
+      auto interval =
+          std::max<int64_t>(config.heartbeat_interval_msec.count(), 1);
+      return std::max<int64_t>((lifetime.count() + interval - 1) / interval,
+                               1);
+    }
+
+    size_t heartbeatSlices(const Config &config) {
+      return std::max<size_t>(config.heartbeat_slices, 1);
+    }
+
+    /// Observes duration of one heartbeat tick
+    void observeHeartbeat(std::chrono::steady_clock::time_point started) {
+      static auto &duration = metrics::Registry::instance().histogram(
+          "libp2p_gossip_heartbeat_duration_seconds",
+          "Duration of gossip heartbeat ticks");
+      duration.observe(std::chrono::steady_clock::now() - started);
+    }
+
+    /// Messages of all gossip instances received again after the first time
+    metrics::Counter &duplicatesCounter() {
+      static auto &counter = metrics::Registry::instance().counter(
+          "libp2p_gossip_duplicate_messages_total",
+          "Gossip messages received again");
+      return counter;
+    }
+
+    /// IWANT requests ignored because peer reached its reply limit
+    metrics::Counter &iwantThrottledCounter() {
+      static auto &counter = metrics::Registry::instance().counter(
+          "libp2p_gossip_iwant_throttled_total",
+          "IWANT requests ignored over per peer reply limit");
+      return counter;
+    }
+  }  // namespace
 
   std::shared_ptr<Gossip> create(
       std::shared_ptr<basic::Scheduler> scheduler,
@@ -54,16 +96,28 @@ namespace libp2p::protocol::gossip {
         key_marshaller_(std::move(key_marshaller)),
         local_peer_id_(host_->getPeerInfo().id),
         msg_cache_(
-            config_.message_cache_lifetime_msec,
-            [sch = scheduler_] { return sch->now(); }
+            historyLength(config_, config_.message_cache_lifetime_msec),
+            config_.message_cache_gossip_windows
         ),
+        score_(config_.score),
         local_subscriptions_(std::make_shared<LocalSubscriptions>(
             [this](bool subscribe, const TopicId &topic) {
               onLocalSubscriptionChanged(subscribe, topic);
             }
         )),
         msg_seq_(scheduler_->now().count()),
-        log_("gossip", "Gossip", local_peer_id_.toBase58().substr(46)) {}
+        log_("gossip", "Gossip", local_peer_id_.toBase58().substr(46)) {
+    if (config_.validation_threads != 0) {
+      validation_pool_ =
+          std::make_unique<boost::asio::thread_pool>(config_.validation_threads);
+    }
+    if (config_.seen_filter_lifetime_msec > Time::zero()) {
+      seen_filter_.emplace(
+          historyLength(config_, config_.seen_filter_lifetime_msec),
+          config_.seen_filter_capacity,
+          config_.seen_filter_false_positive_rate);
+    }
+  }
   // clang-format on
 
   void GossipCore::addBootstrapPeer(
@@ -109,7 +163,7 @@ namespace libp2p::protocol::gossip {
     }
 
     remote_subscriptions_ = std::make_shared<RemoteSubscriptions>(
-        config_, *connectivity_, *scheduler_, log_);
+        config_, *connectivity_, score_, *scheduler_, log_);
 
     started_ = true;
 
@@ -117,8 +171,10 @@ namespace libp2p::protocol::gossip {
       remote_subscriptions_->onSelfSubscribed(true, topic);
     }
 
+    heartbeat_slice_ = 0;
     setTimerHeartbeat();
 
+    connectivity_->pauseReading(full_topics_ != 0);
     connectivity_->start();
   }
 
@@ -142,6 +198,35 @@ namespace libp2p::protocol::gossip {
 
   void GossipCore::setValidator(const TopicId &topic, Validator validator) {
     assert(validator);
+    auto shared = std::make_shared<Validator>(std::move(validator));
+    if (!validation_pool_) {
+      setAsyncValidator(
+          topic,
+          [shared](const Bytes &from, const Bytes &data, ValidationCallback cb) {
+            cb((*shared)(from, data) ? ValidationResult::ACCEPT
+                                     : ValidationResult::REJECT);
+          });
+      return;
+    }
+    setAsyncValidator(
+        topic,
+        [shared, pool{validation_pool_.get()}, scheduler{scheduler_}](
+            const Bytes &from, const Bytes &data, ValidationCallback cb) {
+          boost::asio::post(
+              *pool,
+              [shared, scheduler, &from, &data, cb{std::move(cb)}]() mutable {
+                auto result = (*shared)(from, data)
+                                ? ValidationResult::ACCEPT
+                                : ValidationResult::REJECT;
+                scheduler->schedule(
+                    [result, cb{std::move(cb)}] { cb(result); });
+              });
+        });
+  }
+
+  void GossipCore::setAsyncValidator(const TopicId &topic,
+                                     AsyncValidator validator) {
+    assert(validator);
     auto sub = subscribe({topic}, [](const SubscriptionData &) {});
     validators_[topic] = {std::move(validator), std::move(sub)};
   }
@@ -149,6 +234,42 @@ namespace libp2p::protocol::gossip {
   void GossipCore::setMessageIdFn(MessageIdFn fn) {
     assert(fn);
     create_message_id_ = std::move(fn);
+    default_message_id_ = false;
+  }
+
+  void GossipCore::setCodec(const TopicId &topic,
+                            std::shared_ptr<basic::Codec> codec,
+                            bool decoded_ids) {
+    if (codec == nullptr) {
+      codecs_.erase(topic);
+      return;
+    }
+    codecs_[topic] = {std::move(codec), decoded_ids};
+  }
+
+  MessageId GossipCore::messageId(const TopicMessage &msg,
+                                  const TopicCodec *codec) const {
+    const auto &data =
+        codec != nullptr && codec->decoded_ids ? msg.payload() : msg.data;
+    return create_message_id_(msg.from, msg.seq_no, data);
+  }
+
+  bool GossipCore::decode(const PeerContextPtr &from,
+                          TopicMessage &msg,
+                          const TopicCodec &codec) {
+    if (msg.decoded) {
+      return true;
+    }
+    auto res = codec.codec->decompress(msg.data, config_.max_message_size);
+    if (res.has_error()) {
+      log_.debug("cannot decompress message from {}: {}",
+                 from->str,
+                 res.error());
+      score_.invalidMessage(from->peer_id, msg.topic);
+      return false;
+    }
+    msg.decoded = std::move(res.value());
+    return true;
   }
 
   Subscription GossipCore::subscribe(TopicSet topics,
@@ -160,13 +281,72 @@ namespace libp2p::protocol::gossip {
                                            std::move(callback));
   }
 
+  Subscription GossipCore::subscribe(TopicSet topics,
+                                     std::shared_ptr<SubscriptionQueue> queue) {
+    assert(queue);
+    assert(!topics.empty());
+
+    // called by application thread draining the queue
+    queue->onResume([weak_self{weak_from_this()}, scheduler{scheduler_}] {
+      scheduler->schedule([weak_self] {
+        if (auto self = weak_self.lock()) {
+          self->onQueueResumed();
+        }
+      });
+    });
+    return local_subscriptions_->subscribe(std::move(topics),
+                                           std::move(queue));
+  }
+
+  void GossipCore::setAppScore(const peer::PeerId &peer, double score) {
+    score_.setAppScore(peer, score);
+  }
+
+  double GossipCore::peerScore(const peer::PeerId &peer) const {
+    return score_.score(peer);
+  }
+
+  std::map<TopicId, Gossip::TopicStats> GossipCore::topicStats() const {
+    return remote_subscriptions_->stats();
+  }
+
   bool GossipCore::publish(TopicId topic, Bytes data) {
     if (!started_) {
       return false;
     }
+    return publishMessage(std::move(topic), std::move(data));
+  }
+
+  bool GossipCore::publishMany(
+      std::span<std::pair<TopicId, Bytes>> messages) {
+    if (!started_) {
+      return false;
+    }
+    for (auto &[topic, data] : messages) {
+      publishMessage(std::move(topic), std::move(data));
+    }
+    // messages queued to each peer go out as one RPC
+    connectivity_->flush();
+    return true;
+  }
+
+  bool GossipCore::publishMessage(TopicId topic, Bytes data) {
+    const TopicCodec *codec = nullptr;
+    boost::optional<Bytes> decoded;
+    if (auto it = codecs_.find(topic); it != codecs_.end()) {
+      codec = &it->second;
+      auto res = codec->codec->compress(data);
+      if (res.has_error()) {
+        log_.warn("cannot compress message, topic {}: {}", topic, res.error());
+        return false;
+      }
+      decoded = std::move(data);
+      data = std::move(res.value());
+    }
 
     auto msg = std::make_shared<TopicMessage>(
         local_peer_id_, ++msg_seq_, std::move(data), std::move(topic));
+    msg->decoded = std::move(decoded);
 
     if (config_.sign_messages) {
       auto res = signMessage(*msg);
@@ -175,17 +355,16 @@ namespace libp2p::protocol::gossip {
       }
     }
 
-    MessageId msg_id = create_message_id_(msg->from, msg->seq_no, msg->data);
+    MessageId msg_id = messageId(*msg, codec);
 
-    [[maybe_unused]] bool inserted = msg_cache_.insert(msg, msg_id);
+    [[maybe_unused]] bool inserted = remember(msg, msg_id);
     assert(inserted);
 
     remote_subscriptions_->onNewMessage(boost::none, msg, msg_id);
 
     if (config_.echo_forward_mode) {
-      local_subscriptions_->forwardMessage(msg);
+      deliver(msg);
     }
-
     return true;
   }
 
@@ -193,7 +372,7 @@ namespace libp2p::protocol::gossip {
     const auto &keypair = idmgr_->getKeyPair();
     OUTCOME_TRY(signable, MessageBuilder::signableMessage(msg));
     OUTCOME_TRY(signature,
-                crypto_provider_->sign(signable, keypair.privateKey));
+                crypto_provider_->sign(signable, idmgr_->getSigningKey()));
     msg.signature = std::move(signature);
     if (idmgr_->getId().toMultihash().getType() != multi::HashType::identity) {
       OUTCOME_TRY(key, key_marshaller_->marshal(keypair.publicKey));
@@ -207,6 +386,10 @@ namespace libp2p::protocol::gossip {
                                   const TopicId &topic) {
     assert(started_);
 
+    if (score_.graylisted(peer->peer_id)) {
+      return;
+    }
+
     log_.debug("peer {} {}subscribed, topic {}",
                peer->str,
                (subscribe ? "" : "un"),
@@ -225,26 +408,62 @@ namespace libp2p::protocol::gossip {
 
     log_.debug("peer {} has msg for topic {}", from->str, topic);
 
-    if (remote_subscriptions_->hasTopic(topic)
-        && !msg_cache_.contains(msg_id)) {
-      log_.debug("requesting msg id {:x}", msg_id);
+    if (score_.belowGossipThreshold(from->peer_id)) {
+      return;
+    }
+
+    if (remote_subscriptions_->hasTopic(topic) && !seen(msg_id)) {
+      log_.debug("requesting msg id {:x}", msg_id.view());
 
       from->message_builder->addIWant(msg_id);
       connectivity_->peerIsWritable(from, false);
+      ihave_times_.try_emplace(msg_id, Clock::now());
     }
   }
 
   void GossipCore::onIWant(const PeerContextPtr &from,
                            const MessageId &msg_id) {
-    log_.debug("peer {} wants message {:x}", from->str, msg_id);
+    log_.debug("peer {} wants message {:x}", from->str, msg_id.view());
+
+    if (score_.belowGossipThreshold(from->peer_id)) {
+      return;
+    }
+
+    if (from->dontWant(msg_id, scheduler_->now())) {
+      return;
+    }
 
     auto msg_found = msg_cache_.getMessage(msg_id);
-    if (msg_found) {
-      from->message_builder->addMessage(*msg_found.value(), msg_id);
-      connectivity_->peerIsWritable(from, true);
-    } else {
+    if (!msg_found) {
       log_.debug("wanted message not in cache");
+      return;
+    }
+
+    // replies amplify requests, their rate is limited per peer
+    if (!from->allowIWantReply(scheduler_->now(),
+                               config_.heartbeat_interval_msec,
+                               config_.iwant_max_replies)) {
+      iwantThrottledCounter().inc();
+      return;
+    }
+
+    // cached message keeps its serialized field, which is spliced into RPC
+    from->message_builder->addMessage(*msg_found.value(), msg_id);
+    connectivity_->peerIsWritable(from, true);
+  }
+
+  void GossipCore::onIDontWant(const PeerContextPtr &from,
+                               const MessageId &msg_id) {
+    assert(started_);
+
+    if (score_.graylisted(from->peer_id)) {
+      return;
     }
+
+    from->addDontWant(msg_id,
+                      scheduler_->now(),
+                      config_.idontwant_lifetime_msec,
+                      config_.idontwant_max_messages);
   }
 
   void GossipCore::onGraft(const PeerContextPtr &from, const TopicId &topic) {
@@ -252,69 +471,311 @@ namespace libp2p::protocol::gossip {
 
     log_.debug("graft from peer {} for topic {}", from->str, topic);
 
+    if (score_.graylisted(from->peer_id)) {
+      return;
+    }
+
     remote_subscriptions_->onGraft(from, topic);
   }
 
   void GossipCore::onPrune(const PeerContextPtr &from,
                            const TopicId &topic,
-                           uint64_t backoff_time) {
+                           uint64_t backoff_time,
+                           std::span<const PxPeer> px) {
     assert(started_);
 
-    log_.debug("prune from peer {} for topic {}", from->str, topic);
+    log_.debug("prune from peer {} for topic {}, {} peers suggested",
+               from->str,
+               topic,
+               px.size());
+
+    if (score_.graylisted(from->peer_id)) {
+      return;
+    }
 
     remote_subscriptions_->onPrune(from, topic, backoff_time);
+
+    if (!px.empty()) {
+      acceptPx(from, px);
+    }
+  }
+
+  void GossipCore::acceptPx(const PeerContextPtr &from,
+                            std::span<const PxPeer> px) {
+    if (config_.prune_peers == 0
+        || score_.score(from->peer_id) < config_.score.accept_px_threshold) {
+      return;
+    }
+    if (px.size() > config_.prune_peers) {
+      px = px.first(config_.prune_peers);
+    }
+
+    for (const auto &peer : px) {
+      if (peer.signed_record.empty()) {
+        // dialed if addresses are already known
+        connectivity_->addPxPeer(peer.peer_id, {}, nullptr, 0);
+        continue;
+      }
+      auto record = openPeerRecord(
+          peer.signed_record, *crypto_provider_, *key_marshaller_);
+      if (!record || record.value().peer_id != peer.peer_id) {
+        log_.debug("invalid peer record of {} from {}",
+                   peer.peer_id.toBase58(),
+                   from->str);
+        continue;
+      }
+      connectivity_->addPxPeer(
+          peer.peer_id,
+          record.value().addresses,
+          std::make_shared<const Bytes>(peer.signed_record.begin(),
+                                        peer.signed_record.end()),
+          record.value().seq);
+    }
+  }
+
+  bool GossipCore::needTopicMessage(const PeerContextPtr &from,
+                                    const TopicMessageView &msg) {
+    assert(started_);
+
+    if (score_.graylisted(from->peer_id)) {
+      return false;
+    }
+
+    TopicId topic{msg.topic};
+    auto metrics = remote_subscriptions_->metrics(topic);
+    if (metrics == nullptr) {
+      return false;
+    }
+
+    // other ids need the message itself, duplicates are dropped after copy
+    if (!default_message_id_) {
+      return true;
+    }
+    if (auto it = codecs_.find(topic);
+        it != codecs_.end() && it->second.decoded_ids) {
+      return true;
+    }
+
+    MessageId msg_id{msg.from};
+    msg_id.append(msg.seq_no);
+    if (seen(msg_id)) {
+      log_.debug("ignoring message, already seen");
+      duplicatesCounter().inc();
+      ++metrics->received;
+      ++metrics->duplicates;
+      metrics->bytes_in += msg.data.size();
+      score_.duplicateDelivery(from->peer_id, topic, msg_id, scheduler_->now());
+      return false;
+    }
+    return true;
   }
 
   void GossipCore::onTopicMessage(const PeerContextPtr &from,
                                   TopicMessage::Ptr msg) {
     assert(started_);
 
+    dispatching_ = true;
+
+    if (score_.graylisted(from->peer_id)) {
+      return;
+    }
+
     // do we need this message?
-    auto subscribed = remote_subscriptions_->hasTopic(msg->topic);
-    if (!subscribed) {
+    auto metrics = remote_subscriptions_->metrics(msg->topic);
+    if (metrics == nullptr) {
       // ignore this message
       return;
     }
+    auto received = Clock::now();
+    ++metrics->received;
+    metrics->bytes_in += msg->data.size();
+
+    const TopicCodec *codec = nullptr;
+    if (auto it = codecs_.find(msg->topic); it != codecs_.end()) {
+      codec = &it->second;
+      // id of decoded message needs decoding first
+      if (codec->decoded_ids && !decode(from, *msg, *codec)) {
+        ++metrics->invalid;
+        return;
+      }
+    }
 
-    MessageId msg_id = create_message_id_(msg->from, msg->seq_no, msg->data);
-    log_.debug("message arrived, msg id={:x}", msg_id);
+    MessageId msg_id = messageId(*msg, codec);
+    log_.debug("message arrived, msg id={:x}", msg_id.view());
 
-    if (msg_cache_.contains(msg_id)) {
+    if (seen(msg_id)) {
       // already there, ignore
-      log_.debug("ignoring message, already in cache");
+      log_.debug("ignoring message, already seen");
+      duplicatesCounter().inc();
+      ++metrics->duplicates;
+      score_.duplicateDelivery(
+          from->peer_id, msg->topic, msg_id, scheduler_->now());
+      return;
+    }
+
+    auto first_seen = received;
+    if (auto it = ihave_times_.find(msg_id); it != ihave_times_.end()) {
+      first_seen = std::min(first_seen, it->second);
+      ihave_times_.erase(it);
+    }
+
+    // large messages are not to be sent by mesh peers which got them already,
+    // this goes before validation to reach them as early as possible
+    if (config_.idontwant_message_size_threshold != 0
+        && msg->data.size() >= config_.idontwant_message_size_threshold) {
+      remote_subscriptions_->sendDontWant(from, msg->topic, msg_id);
+    }
+
+    // duplicates are dropped above without decompression
+    if (codec != nullptr && !decode(from, *msg, *codec)) {
+      ++metrics->invalid;
       return;
     }
 
     // validate message. If no validator is set then we
     // suppose that the message is valid (we might not know topic details)
-    bool valid = true;
+    auto it = validators_.find(msg->topic);
+    if (it == validators_.end()) {
+      onValidated(from,
+                  msg,
+                  msg_id,
+                  ValidationResult::ACCEPT,
+                  first_seen,
+                  std::nullopt);
+      return;
+    }
 
-    if (!validators_.empty()) {
-      auto it = validators_.find(msg->topic);
-      if (it != validators_.end()) {
-        valid = it->second.validator(msg->from, msg->data);
-      }
+    if (validating_.contains(msg_id)) {
+      log_.debug("ignoring message, being validated");
+      return;
     }
 
-    if (!valid) {
+    auto &in_flight = validating_topics_[msg->topic];
+    if (in_flight >= config_.validation_queue_limit) {
+      log_.debug("ignoring message, validation queue is full");
+      return;
+    }
+    ++in_flight;
+    if (in_flight == config_.validation_queue_limit && ++full_topics_ == 1) {
+      connectivity_->pauseReading(true);
+    }
+    validating_.insert(msg_id);
+
+    // copied, as validator may be replaced while called
+    auto validator = it->second.validator;
+    validator(msg->from,
+              msg->payload(),
+              [weak_self{weak_from_this()},
+               from,
+               msg,
+               msg_id,
+               first_seen,
+               validation_started{Clock::now()}](ValidationResult result) {
+                auto self = weak_self.lock();
+                if (!self) {
+                  return;
+                }
+                self->onValidationEnd(msg->topic, msg_id);
+                self->onValidated(
+                    from, msg, msg_id, result, first_seen, validation_started);
+              });
+  }
+
+  void GossipCore::onValidationEnd(const TopicId &topic,
+                                   const MessageId &msg_id) {
+    validating_.erase(msg_id);
+    auto it = validating_topics_.find(topic);
+    if (it == validating_topics_.end()) {
+      return;
+    }
+    auto &in_flight = it->second;
+    if (in_flight == config_.validation_queue_limit && --full_topics_ == 0
+        && started_) {
+      connectivity_->pauseReading(false);
+    }
+    if (--in_flight == 0) {
+      validating_topics_.erase(it);
+    }
+  }
+
+  void GossipCore::deliver(const TopicMessage::Ptr &msg) {
+    auto paused = local_subscriptions_->forwardMessage(msg);
+    if (paused == 0) {
+      return;
+    }
+    auto was_paused = full_topics_ != 0;
+    full_topics_ += paused;
+    if (!was_paused && started_) {
+      connectivity_->pauseReading(true);
+    }
+  }
+
+  void GossipCore::onQueueResumed() {
+    assert(full_topics_ != 0);
+    if (--full_topics_ == 0 && started_) {
+      connectivity_->pauseReading(false);
+    }
+  }
+
+  void GossipCore::onValidated(
+      const PeerContextPtr &from,
+      const TopicMessage::Ptr &msg,
+      const MessageId &msg_id,
+      ValidationResult result,
+      Clock::time_point first_seen,
+      std::optional<Clock::time_point> validation_started) {
+    if (!started_) {
+      return;
+    }
+
+    auto now = Clock::now();
+    // lookup again, topic may be gone while validating
+    auto metrics = remote_subscriptions_->metrics(msg->topic);
+    if (metrics != nullptr && validation_started) {
+      metrics->validation_latency.observe(now - *validation_started);
+    }
+
+    if (result == ValidationResult::IGNORE) {
+      log_.debug("message ignored by validator");
+      return;
+    }
+
+    if (result == ValidationResult::REJECT) {
       log_.debug("message validation failed");
+      score_.invalidMessage(from->peer_id, msg->topic);
+      if (metrics != nullptr) {
+        ++metrics->invalid;
+      }
       return;
     }
 
-    if (!msg_cache_.insert(msg, msg_id)) {
+    if (!remember(msg, msg_id)) {
       log_.error("message cache error");
       return;
     }
 
+    score_.firstDelivery(from->peer_id, msg->topic, msg_id, scheduler_->now());
+
     log_.debug("forwarding message");
 
-    local_subscriptions_->forwardMessage(msg);
+    if (metrics != nullptr) {
+      ++metrics->delivered;
+      metrics->first_delivery_latency.observe(now - first_seen);
+    }
+    deliver(msg);
     remote_subscriptions_->onNewMessage(from, msg, msg_id);
+
+    if (!dispatching_) {
+      // validated asynchronously, no message end follows
+      connectivity_->flush();
+    }
   }
 
   void GossipCore::onMessageEnd(const PeerContextPtr &from) {
     assert(started_);
 
+    dispatching_ = false;
+
     log_.debug("finished dispatching message from peer {}", from->str);
 
     // Apply immediate send operation to affected peers
@@ -324,16 +785,36 @@ namespace libp2p::protocol::gossip {
   void GossipCore::onHeartbeat() {
     assert(started_);
 
-    // shift cache
-    msg_cache_.shift();
+    auto started = std::chrono::steady_clock::now();
+    auto slices = heartbeatSlices(config_);
+
+    // once per interval
+    if (heartbeat_slice_ == 0) {
+      // shift cache
+      msg_cache_.shift();
+      if (seen_filter_) {
+        seen_filter_->shift();
+      }
+
+      score_.onHeartbeat(scheduler_->now());
 
-    // heartbeat changes per topic
-    remote_subscriptions_->onHeartbeat();
+      // IWANT, which was not replied within operation timeout, is lost
+      auto expired = Clock::now() - config_.rw_timeout_msec;
+      std::erase_if(ihave_times_,
+                    [&](auto &p) { return p.second < expired; });
+    }
+
+    // heartbeat changes per topic, share of this tick
+    remote_subscriptions_->onHeartbeat(heartbeat_slice_, slices);
 
     // send changes to peers
-    connectivity_->onHeartbeat(broadcast_on_heartbeat_);
+    connectivity_->onHeartbeat(
+        broadcast_on_heartbeat_, heartbeat_slice_, slices);
     broadcast_on_heartbeat_.clear();
 
+    heartbeat_slice_ = (heartbeat_slice_ + 1) % slices;
+    observeHeartbeat(started);
+
     setTimerHeartbeat();
   }
 
@@ -342,6 +823,7 @@ namespace libp2p::protocol::gossip {
 
     if (connected) {
       log_.debug("peer {} connected", ctx->str);
+      score_.connected(ctx->peer_id, ctx->ip);
       // notify the new peer about all topics we subscribed to
       if (!local_subscriptions_->subscribedTo().empty()) {
         for (const auto &local_sub : local_subscriptions_->subscribedTo()) {
@@ -353,9 +835,26 @@ namespace libp2p::protocol::gossip {
     } else {
       log_.debug("peer {} disconnected", ctx->str);
       remote_subscriptions_->onPeerDisconnected(ctx);
+      score_.disconnected(ctx->peer_id, scheduler_->now());
     }
   }
 
+  bool GossipCore::seen(const MessageId &msg_id) const {
+    // exact while in cache, the filter answers for expired ones
+    return msg_cache_.contains(msg_id)
+        or (seen_filter_ and seen_filter_->contains(msg_id));
+  }
+
+  bool GossipCore::remember(TopicMessage::Ptr msg, const MessageId &msg_id) {
+    if (!msg_cache_.insert(std::move(msg), msg_id)) {
+      return false;
+    }
+    if (seen_filter_) {
+      seen_filter_->insert(msg_id);
+    }
+    return true;
+  }
+
   void GossipCore::onLocalSubscriptionChanged(bool subscribe,
                                               const TopicId &topic) {
     if (!started_) {
@@ -384,6 +883,8 @@ namespace libp2p::protocol::gossip {
           }
           self->onHeartbeat();
         },
-        config_.heartbeat_interval_msec);
+        std::max(config_.heartbeat_interval_msec
+                     / static_cast<int64_t>(heartbeatSlices(config_)),
+                 std::chrono::milliseconds{1}));
   }
 }  // namespace libp2p::protocol::gossip
@@ -9,14 +9,20 @@
 #include <libp2p/protocol/gossip/gossip.hpp>
 
 #include <map>
+#include <optional>
+#include <unordered_set>
+
+#include <boost/asio/thread_pool.hpp>
 
 #include <libp2p/basic/scheduler.hpp>
 #include <libp2p/host/host.hpp>
 #include <libp2p/log/sublogger.hpp>
 
 #include "message_cache.hpp"
+#include "seen_filter.hpp"
 #include "message_receiver.hpp"
 #include "peer_set.hpp"
+#include "score.hpp"
 
 namespace libp2p::protocol::gossip {
 
@@ -53,13 +59,41 @@ namespace libp2p::protocol::gossip {
     void start() override;
     void stop() override;
     void setValidator(const TopicId &topic, Validator validator) override;
+    void setAsyncValidator(const TopicId &topic,
+                           AsyncValidator validator) override;
     void setMessageIdFn(MessageIdFn fn) override;
+    void setCodec(const TopicId &topic,
+                  std::shared_ptr<basic::Codec> codec,
+                  bool decoded_ids) override;
     Subscription subscribe(TopicSet topics,
                            SubscriptionCallback callback) override;
+    Subscription subscribe(TopicSet topics,
+                           std::shared_ptr<SubscriptionQueue> queue) override;
     bool publish(TopicId topic, Bytes data) override;
+    bool publishMany(std::span<std::pair<TopicId, Bytes>> messages) override;
+    void setAppScore(const peer::PeerId &peer, double score) override;
+    double peerScore(const peer::PeerId &peer) const override;
+    std::map<TopicId, TopicStats> topicStats() const override;
 
     outcome::result<void> signMessage(TopicMessage &msg) const;
 
+    /// Compresses, signs, remembers and queues local message to peers.
+    /// Returns false if compression fails
+    bool publishMessage(TopicId topic, Bytes data);
+
+    struct TopicCodec {
+      std::shared_ptr<basic::Codec> codec;
+      bool decoded_ids;
+    };
+
+    /// Creates id of message, decoded_ids of topic codec taken into account
+    MessageId messageId(const TopicMessage &msg, const TopicCodec *codec) const;
+
+    /// Decompresses wire message, penalizes sender if it fails
+    bool decode(const PeerContextPtr &from,
+                TopicMessage &msg,
+                const TopicCodec &codec);
+
     // MessageReceiver overrides
     void onSubscription(const PeerContextPtr &from,
                         bool subscribe,
@@ -68,17 +102,53 @@ namespace libp2p::protocol::gossip {
                  const TopicId &topic,
                  const MessageId &msg_id) override;
     void onIWant(const PeerContextPtr &from, const MessageId &msg_id) override;
+    void onIDontWant(const PeerContextPtr &from,
+                     const MessageId &msg_id) override;
     void onGraft(const PeerContextPtr &from, const TopicId &topic) override;
     void onPrune(const PeerContextPtr &from,
                  const TopicId &topic,
-                 uint64_t backoff_time) override;
+                 uint64_t backoff_time,
+                 std::span<const PxPeer> px) override;
+    bool needTopicMessage(const PeerContextPtr &from,
+                          const TopicMessageView &msg) override;
     void onTopicMessage(const PeerContextPtr &from,
                         TopicMessage::Ptr msg) override;
     void onMessageEnd(const PeerContextPtr &from) override;
 
-    /// Periodic heartbeat timer fn
+    /// Dials peers suggested in PRUNE, verifies their signed records
+    void acceptPx(const PeerContextPtr &from, std::span<const PxPeer> px);
+
+    /// Releases validation queue slot of message
+    void onValidationEnd(const TopicId &topic, const MessageId &msg_id);
+
+    /// Delivers message to local subscribers, pauses reading if any queue
+    /// became full
+    void deliver(const TopicMessage::Ptr &msg);
+
+    /// Paused subscription queue was drained
+    void onQueueResumed();
+
+    using Clock = std::chrono::steady_clock;
+
+    /// Delivers and forwards message if accepted.
+    /// @param first_seen time of the first IHAVE of message or its receiving
+    /// @param validation_started none if message has no validator
+    void onValidated(const PeerContextPtr &from,
+                     const TopicMessage::Ptr &msg,
+                     const MessageId &msg_id,
+                     ValidationResult result,
+                     Clock::time_point first_seen,
+                     std::optional<Clock::time_point> validation_started);
+
+    /// Periodic heartbeat timer fn, does one slice of heartbeat work
     void onHeartbeat();
 
+    /// Message is in cache, or probably was there before
+    bool seen(const MessageId &msg_id) const;
+
+    /// Inserts new message into cache and seen filter
+    bool remember(TopicMessage::Ptr msg, const MessageId &msg_id);
+
     /// Local host subscribed or unsubscribed from topic
     void onLocalSubscriptionChanged(bool subscribe, const TopicId &topic);
 
@@ -93,6 +163,9 @@ namespace libp2p::protocol::gossip {
     /// Message ID function
     MessageIdFn create_message_id_;
 
+    /// Id is from + seq_no, so it is known before message is copied
+    bool default_message_id_ = true;
+
     /// Bootstrap peers to dial to
     std::unordered_map<peer::PeerId, boost::optional<multi::Multiaddress>>
         bootstrap_peers_;
@@ -112,9 +185,15 @@ namespace libp2p::protocol::gossip {
     /// This peer's id
     peer::PeerId local_peer_id_;
 
-    /// Message cache w/expiration
+    /// Message cache, shifted on heartbeat
     MessageCache msg_cache_;
 
+    /// Ids of messages expired from cache, if enabled in config
+    std::optional<SeenFilter> seen_filter_;
+
+    /// Peer scores
+    Score score_;
+
     /// Local subscriptions manager (this host subscribed to topics)
     std::shared_ptr<LocalSubscriptions> local_subscriptions_;
 
@@ -122,13 +201,31 @@ namespace libp2p::protocol::gossip {
     std::shared_ptr<RemoteSubscriptions> remote_subscriptions_;
 
     struct ValidatorAndLocalSub {
-      Validator validator;
+      AsyncValidator validator;
       Subscription sub;
     };
 
+    /// Codecs by topic
+    std::unordered_map<TopicId, TopicCodec> codecs_;
+
     /// Remote messages validators by topic
     std::unordered_map<TopicId, ValidatorAndLocalSub> validators_;
 
+    /// Times of the first IHAVE of messages requested with IWANT, for
+    /// first delivery latency
+    std::unordered_map<MessageId, Clock::time_point> ihave_times_;
+
+    /// Messages being validated, in total and by topic
+    std::unordered_set<MessageId> validating_;
+    std::unordered_map<TopicId, size_t> validating_topics_;
+
+    /// Topics with full validation queue and paused subscription queues,
+    /// reading is paused while nonzero
+    size_t full_topics_ = 0;
+
+    /// Messages of wire RPC are being dispatched, flush follows
+    bool dispatching_ = false;
+
     /// Network part of gossip component
     std::shared_ptr<Connectivity> connectivity_;
 
@@ -144,8 +241,14 @@ namespace libp2p::protocol::gossip {
     /// Heartbeat timer handle
     basic::Scheduler::Handle heartbeat_timer_;
 
+    /// Slice of heartbeat interval the next tick does
+    size_t heartbeat_slice_ = 0;
+
     /// Logger
     log::SubLogger log_;
+
+    /// Workers for synchronous validators, joined first on destruction
+    std::unique_ptr<boost::asio::thread_pool> validation_pool_;
   };
 
 }  // namespace libp2p::protocol::gossip
@@ -9,6 +9,20 @@
 #include <cassert>
 
 namespace libp2p::protocol::gossip {
+  namespace {
+    /// Keeps topic message alive while its queued handles are held
+    struct SharedMessage {
+      TopicMessage::Ptr msg;
+      Gossip::Message view;
+    };
+
+    SubscriptionQueue::MessagePtr share(const TopicMessage::Ptr &msg) {
+      auto shared = std::make_shared<SharedMessage>(
+          SharedMessage{msg, {msg->from, msg->topic, msg->payload()}});
+      return {shared, &shared->view};
+    }
+  }  // namespace
+
   LocalSubscriptions::LocalSubscriptions(OnSubscriptionSetChange change_fn)
       : change_fn_(std::move(change_fn)) {}
 
@@ -21,21 +35,49 @@ namespace libp2p::protocol::gossip {
         change_fn_(true, t);
       }
     }
-    filters_[lastTicket()] = std::move(topics);
+    filters_[lastTicket()] = {std::make_move_iterator(topics.begin()),
+                              std::make_move_iterator(topics.end())};
 
     return ret;
   }
 
-  const std::map<TopicId, size_t> &LocalSubscriptions::subscribedTo() {
+  Subscription LocalSubscriptions::subscribe(
+      TopicSet topics, std::shared_ptr<SubscriptionQueue> queue) {
+    assert(queue);
+    Subscription ret =
+        subscribe(std::move(topics), [](Gossip::SubscriptionData) {});
+    queues_[lastTicket()] = std::move(queue);
+    return ret;
+  }
+
+  const std::unordered_map<TopicId, size_t> &
+  LocalSubscriptions::subscribedTo() {
     return topics_;
   }
 
-  void LocalSubscriptions::forwardMessage(const TopicMessage::Ptr &msg) {
+  size_t LocalSubscriptions::forwardMessage(const TopicMessage::Ptr &msg) {
     assert(msg);
-    if (topics_.count(msg->topic) != 0) {
-      Gossip::Message tmp_msg{msg->from, msg->topic, msg->data};
-      publish(tmp_msg);
+    if (topics_.count(msg->topic) == 0) {
+      return 0;
     }
+    Gossip::Message tmp_msg{msg->from, msg->topic, msg->payload()};
+    publish(tmp_msg);
+
+    size_t paused = 0;
+    SubscriptionQueue::MessagePtr shared;
+    for (auto &[ticket, queue] : queues_) {
+      if (filters_.at(ticket).count(msg->topic) == 0) {
+        continue;
+      }
+      // one handle for all queues
+      if (!shared) {
+        shared = share(msg);
+      }
+      if (queue->push(shared) == SubscriptionQueue::PushResult::PAUSE) {
+        ++paused;
+      }
+    }
+    return paused;
   }
 
   void LocalSubscriptions::forwardEndOfSubscription() {
@@ -60,19 +102,20 @@ namespace libp2p::protocol::gossip {
 
     auto it = filters_.find(ticket);
     if (it != filters_.end()) {
-      TopicSet &s = it->second;
-      for (auto topics_it = topics_.begin(); topics_it != topics_.end();) {
-        if (s.count(topics_it->first) != 0) {
-          if (--topics_it->second == 0) {
-            change_fn_(false, topics_it->first);
-            topics_it = topics_.erase(topics_it);
-            continue;
-          }
+      for (auto &topic : it->second) {
+        auto topics_it = topics_.find(topic);
+        if (topics_it != topics_.end() && --topics_it->second == 0) {
+          topics_.erase(topics_it);
+          change_fn_(false, topic);
         }
-        ++topics_it;
       }
       filters_.erase(it);
     }
+
+    if (auto queue_it = queues_.find(ticket); queue_it != queues_.end()) {
+      queue_it->second->close();
+      queues_.erase(queue_it);
+    }
   }
 
 }  // namespace libp2p::protocol::gossip
@@ -6,9 +6,11 @@
 
 #pragma once
 
-#include <map>
+#include <unordered_map>
+#include <unordered_set>
 
 #include <libp2p/protocol/common/subscriptions.hpp>
+#include <libp2p/protocol/gossip/subscription_queue.hpp>
 
 #include "common.hpp"
 
@@ -28,11 +30,16 @@ namespace libp2p::protocol::gossip {
     Subscription subscribe(TopicSet topics,
                            Gossip::SubscriptionCallback callback);
 
+    /// Subscribes queue to topics, it is closed when unsubscribed
+    Subscription subscribe(TopicSet topics,
+                           std::shared_ptr<SubscriptionQueue> queue);
+
     /// Returns all topics (and counters) this host is subscribed to
-    const std::map<TopicId, size_t> &subscribedTo();
+    const std::unordered_map<TopicId, size_t> &subscribedTo();
 
-    /// Forwards data to subscriptions
-    void forwardMessage(const TopicMessage::Ptr &msg);
+    /// Forwards data to subscriptions.
+    /// Returns number of queues, which became full and pause reading
+    size_t forwardMessage(const TopicMessage::Ptr &msg);
 
     /// Forwards EOS to all subscribers
     void forwardEndOfSubscription();
@@ -49,10 +56,13 @@ namespace libp2p::protocol::gossip {
     OnSubscriptionSetChange change_fn_;
 
     /// Keeps track of topics this host is subscribed to
-    std::map<TopicId, size_t> topics_;
+    std::unordered_map<TopicId, size_t> topics_;
 
     /// Used by filter()
-    std::map<uint64_t, TopicSet> filters_;
+    std::unordered_map<uint64_t, std::unordered_set<TopicId>> filters_;
+
+    /// Queues of subscriptions by ticket
+    std::unordered_map<uint64_t, std::shared_ptr<SubscriptionQueue>> queues_;
   };
 
 }  // namespace libp2p::protocol::gossip
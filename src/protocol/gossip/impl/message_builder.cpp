@@ -8,15 +8,17 @@
 
 #include <libp2p/multi/uvarint.hpp>
 
+#include "peer_context.hpp"
+
 #include <generated/protocol/gossip/protobuf/rpc.pb.h>
 
 namespace libp2p::protocol::gossip {
 
   namespace {
     // helper needed since protobuf doesn't have a blob type
-    inline const char *toString(const Bytes &bytes) {
+    inline const char *toString(const MessageId &id) {
       // NOLINTNEXTLINE
-      return reinterpret_cast<const char *>(bytes.data());
+      return reinterpret_cast<const char *>(id.data());
     }
   }  // namespace
 
@@ -29,8 +31,14 @@ namespace libp2p::protocol::gossip {
     control_pb_msg_->Clear();
     empty_ = true;
     control_not_empty_ = false;
+    urgent_ = false;
     ihaves_.clear();
     iwant_.clear();
+    idontwant_.clear();
+    messages_.clear();
+    messages_size_ = 0;
+    published_.clear();
+    published_size_ = 0;
     messages_added_.clear();
   }
 
@@ -39,8 +47,14 @@ namespace libp2p::protocol::gossip {
     control_pb_msg_.reset();
     empty_ = true;
     control_not_empty_ = false;
+    urgent_ = false;
     decltype(ihaves_){}.swap(ihaves_);
     decltype(iwant_){}.swap(iwant_);
+    decltype(idontwant_){}.swap(idontwant_);
+    decltype(messages_){}.swap(messages_);
+    messages_size_ = 0;
+    decltype(published_){}.swap(published_);
+    published_size_ = 0;
     decltype(messages_added_){}.swap(messages_added_);
   }
 
@@ -55,7 +69,15 @@ namespace libp2p::protocol::gossip {
     return empty_;
   }
 
-  outcome::result<SharedBuffer> MessageBuilder::serialize() {
+  size_t MessageBuilder::messagesSize() const {
+    return messages_size_ + published_size_;
+  }
+
+  bool MessageBuilder::urgent() const {
+    return urgent_;
+  }
+
+  outcome::result<SharedBuffers> MessageBuilder::serialize() {
     create_protobuf_structures();
 
     for (auto &[topic, message_ids] : ihaves_) {
@@ -73,47 +95,173 @@ namespace libp2p::protocol::gossip {
       }
     }
 
+    if (!idontwant_.empty()) {
+      auto *dw = control_pb_msg_->add_idontwant();
+      for (auto &mid : idontwant_) {
+        dw->add_messageids(toString(mid), mid.size());
+      }
+    }
+
     if (control_not_empty_) {
       pb_msg_->set_allocated_control(control_pb_msg_.get());
     }
 
-    size_t msg_sz = pb_msg_->ByteSizeLong();
+    size_t pb_sz = pb_msg_->ByteSizeLong();
+    size_t msg_sz = pb_sz + messages_size_ + published_size_;
 
     auto varint_len = multi::UVarint{msg_sz};
     auto varint_vec = varint_len.toVector();
     size_t prefix_sz = varint_vec.size();
 
     auto buffer = std::make_shared<Bytes>();
-    buffer->resize(prefix_sz + msg_sz);
+    buffer->resize(prefix_sz + pb_sz);
     memcpy(buffer->data(), varint_vec.data(), prefix_sz);
 
     bool success =
         // NOLINTNEXTLINE
-        pb_msg_->SerializeToArray(buffer->data() + prefix_sz, msg_sz);
+        pb_msg_->SerializeToArray(buffer->data() + prefix_sz, pb_sz);
+
+    // fields may go in any order, so repeated publish field follows the rest
+    SharedBuffers buffers;
+    buffers.reserve(1 + published_.size() + messages_.size());
+    buffers.emplace_back(std::move(buffer));
+    buffers.insert(buffers.end(), published_.begin(), published_.end());
+    buffers.insert(buffers.end(), messages_.begin(), messages_.end());
 
     if (control_not_empty_) {
       std::ignore = pb_msg_->release_control();
     }
 
     static constexpr size_t kSizeThreshold = 8192;
-    if (msg_sz > kSizeThreshold) {
+    if (pb_sz > kSizeThreshold) {
       reset();
     } else {
       clear();
     }
 
     if (success) {
-      return buffer;
+      return buffers;
     }
     return Error::MESSAGE_SERIALIZE_ERROR;
   }
 
+  outcome::result<std::vector<LaneBuffers>> MessageBuilder::serializeLanes() {
+    std::vector<LaneBuffers> rpcs;
+    if (urgent_ or control_not_empty_ or not published_.empty()) {
+      auto lane = Lane::GOSSIP;
+      if (urgent_) {
+        lane = Lane::CONTROL;
+      } else if (not published_.empty()) {
+        lane = Lane::PUBLISH;
+      }
+      auto forwarded = std::move(messages_);
+      auto forwarded_size = messages_size_;
+      messages_.clear();
+      messages_size_ = 0;
+      OUTCOME_TRY(buffers, serialize());
+      rpcs.push_back({lane, std::move(buffers)});
+      messages_ = std::move(forwarded);
+      messages_size_ = forwarded_size;
+    }
+    if (not messages_.empty()) {
+      // RPC of publish fields only, its protobuf part is empty
+      SharedBuffers buffers;
+      buffers.reserve(1 + messages_.size());
+      buffers.emplace_back(std::make_shared<Bytes>(
+          multi::UVarint{messages_size_}.toVector()));
+      buffers.insert(buffers.end(), messages_.begin(), messages_.end());
+      rpcs.push_back({Lane::FORWARD, std::move(buffers)});
+    }
+    messages_.clear();
+    messages_size_ = 0;
+    messages_added_.clear();
+    empty_ = true;
+    return rpcs;
+  }
+
+  std::vector<Bytes> MessageBuilder::takeDatagrams(size_t max_size) {
+    std::vector<Bytes> datagrams;
+    if (ihaves_.empty() and idontwant_.empty()) {
+      return datagrams;
+    }
+
+    // sizes are estimated by upper bounds of tags and length prefixes,
+    // an id larger than datagram goes alone and is refused by connection
+    static constexpr size_t kRpcOverhead = 8;
+    static constexpr size_t kEntryOverhead = 8;
+    static constexpr size_t kIdOverhead = 4;
+
+    pubsub::pb::RPC rpc;
+    size_t size = kRpcOverhead;
+    auto fits = [&](size_t more) {
+      if (size == kRpcOverhead or size + more <= max_size) {
+        return true;
+      }
+      Bytes datagram(rpc.ByteSizeLong());
+      // NOLINTNEXTLINE
+      if (rpc.SerializeToArray(datagram.data(), datagram.size())) {
+        datagrams.emplace_back(std::move(datagram));
+      }
+      rpc.Clear();
+      size = kRpcOverhead;
+      return false;
+    };
+
+    for (auto &[topic, message_ids] : ihaves_) {
+      pubsub::pb::ControlIHave *ih = nullptr;
+      for (auto &mid : message_ids) {
+        auto entry_size = ih ? 0 : topic.size() + kEntryOverhead;
+        if (not fits(entry_size + mid.size() + kIdOverhead)) {
+          ih = nullptr;
+          entry_size = topic.size() + kEntryOverhead;
+        }
+        if (ih == nullptr) {
+          ih = rpc.mutable_control()->add_ihave();
+          ih->set_topicid(topic);
+          size += entry_size;
+        }
+        ih->add_messageids(toString(mid), mid.size());
+        size += mid.size() + kIdOverhead;
+      }
+    }
+
+    pubsub::pb::ControlIDontWant *dw = nullptr;
+    for (auto &mid : idontwant_) {
+      auto entry_size = dw ? 0 : kEntryOverhead;
+      if (not fits(entry_size + mid.size() + kIdOverhead)) {
+        dw = nullptr;
+        entry_size = kEntryOverhead;
+      }
+      if (dw == nullptr) {
+        dw = rpc.mutable_control()->add_idontwant();
+        size += entry_size;
+      }
+      dw->add_messageids(toString(mid), mid.size());
+      size += mid.size() + kIdOverhead;
+    }
+    // takes the last one
+    fits(max_size + 1);
+
+    ihaves_.clear();
+    idontwant_.clear();
+    control_not_empty_ =
+        not iwant_.empty()
+        or (control_pb_msg_ != nullptr
+            and (control_pb_msg_->graft_size() != 0
+                 or control_pb_msg_->prune_size() != 0));
+    urgent_ = control_not_empty_
+           or (pb_msg_ != nullptr and pb_msg_->subscriptions_size() != 0);
+    empty_ = not urgent_ and messages_.empty() and published_.empty();
+    return datagrams;
+  }
+
   void MessageBuilder::addSubscription(bool subscribe, const TopicId &topic) {
     create_protobuf_structures();
 
     auto *dst = pb_msg_->add_subscriptions();
     dst->set_subscribe(subscribe);
     dst->set_topicid(topic);
+    urgent_ = true;
     empty_ = false;
   }
 
@@ -126,6 +274,14 @@ namespace libp2p::protocol::gossip {
   void MessageBuilder::addIWant(const MessageId &msg_id) {
     iwant_.push_back(msg_id);
     control_not_empty_ = true;
+    urgent_ = true;
+    empty_ = false;
+  }
+
+  void MessageBuilder::addIDontWant(const MessageId &msg_id) {
+    idontwant_.push_back(msg_id);
+    control_not_empty_ = true;
+    urgent_ = true;
     empty_ = false;
   }
 
@@ -134,40 +290,85 @@ namespace libp2p::protocol::gossip {
 
     control_pb_msg_->add_graft()->set_topicid(topic);
     control_not_empty_ = true;
+    urgent_ = true;
     empty_ = false;
   }
 
-  void MessageBuilder::addPrune(const TopicId &topic) {
+  void MessageBuilder::addPrune(const TopicId &topic,
+                                const std::vector<PeerContextPtr> &px) {
     create_protobuf_structures();
 
-    control_pb_msg_->add_prune()->set_topicid(topic);
+    auto *prune = control_pb_msg_->add_prune();
+    prune->set_topicid(topic);
+    for (const auto &p : px) {
+      auto *peer = prune->add_peers();
+      const auto &peer_id = p->peer_id.toVector();
+      peer->set_peerid(peer_id.data(), peer_id.size());
+      if (p->signed_record) {
+        peer->set_signedpeerrecord(p->signed_record->data(),
+                                   p->signed_record->size());
+      }
+    }
     control_not_empty_ = true;
+    urgent_ = true;
     empty_ = false;
   }
 
   void MessageBuilder::addMessage(const TopicMessage &msg,
-                                  const MessageId &msg_id) {
+                                  const MessageId &msg_id,
+                                  bool published) {
     create_protobuf_structures();
 
     if (messages_added_.count(msg_id) != 0) {
       // prevent duplicates
       return;
     }
+
+    if (msg.rpc_field == nullptr) {
+      auto field = rpcField(msg);
+      if (!field) {
+        return;
+      }
+      msg.rpc_field = std::move(field.value());
+    }
     messages_added_.insert(msg_id);
+    if (published) {
+      published_.push_back(msg.rpc_field);
+      published_size_ += msg.rpc_field->size();
+    } else {
+      messages_.push_back(msg.rpc_field);
+      messages_size_ += msg.rpc_field->size();
+    }
+    empty_ = false;
+  }
 
-    auto *dst = pb_msg_->add_publish();
-    dst->set_from(msg.from.data(), msg.from.size());
-    dst->set_data(msg.data.data(), msg.data.size());
-    dst->set_seqno(msg.seq_no.data(), msg.seq_no.size());
-    dst->set_topic(msg.topic);
+  outcome::result<SharedBuffer> MessageBuilder::rpcField(
+      const TopicMessage &msg) {
+    pubsub::pb::Message pb_msg;
+    pb_msg.set_from(msg.from.data(), msg.from.size());
+    pb_msg.set_data(msg.data.data(), msg.data.size());
+    pb_msg.set_seqno(msg.seq_no.data(), msg.seq_no.size());
+    pb_msg.set_topic(msg.topic);
     if (msg.signature) {
-      dst->set_signature(msg.signature.value().data(),
-                         msg.signature.value().size());
+      pb_msg.set_signature(msg.signature.value().data(),
+                           msg.signature.value().size());
     }
     if (msg.key) {
-      dst->set_key(msg.key.value().data(), msg.key.value().size());
+      pb_msg.set_key(msg.key.value().data(), msg.key.value().size());
     }
-    empty_ = false;
+    // length delimited field number 2 of RPC
+    constexpr uint8_t kPublishTag = (2 << 3) | 2;
+    auto size = pb_msg.ByteSizeLong();
+    auto varint = multi::UVarint{size}.toVector();
+    auto field = std::make_shared<Bytes>();
+    field->resize(1 + varint.size() + size);
+    (*field)[0] = kPublishTag;
+    std::copy(varint.begin(), varint.end(), field->begin() + 1);
+    if (!pb_msg.SerializeToArray(&(*field)[1 + varint.size()],
+                                 static_cast<int>(size))) {
+      return Error::MESSAGE_SERIALIZE_ERROR;
+    }
+    return field;
   }
 
   outcome::result<Bytes> MessageBuilder::signableMessage(
@@ -38,8 +38,24 @@ namespace libp2p::protocol::gossip {
     /// Returns true if nothing added
     bool empty() const;
 
-    /// Serializes into byte buffer and clears internal state
-    outcome::result<SharedBuffer> serialize();
+    /// Returns size of messages added, control part is not counted
+    size_t messagesSize() const;
+
+    /// Returns true if there is control part to be written ahead of data
+    bool urgent() const;
+
+    /// Serializes into byte buffers and clears internal state.
+    /// Messages are not copied, their shared serialized fields follow
+    /// the length prefix and the rest of RPC
+    outcome::result<SharedBuffers> serialize();
+
+    /// Serializes as up to two RPCs: forwarded messages, which may be shed,
+    /// and the rest, laned by its most urgent part
+    outcome::result<std::vector<LaneBuffers>> serializeLanes();
+
+    /// Takes IHAVE and IDONTWANT into RPCs without length prefix, each not
+    /// larger than max_size, to be sent as datagrams
+    std::vector<Bytes> takeDatagrams(size_t max_size);
 
     /// Adds subscription notification
     void addSubscription(bool subscribe, const TopicId &topic);
@@ -50,17 +66,26 @@ namespace libp2p::protocol::gossip {
     /// Adds "I want" request
     void addIWant(const MessageId &msg_id);
 
+    /// Adds "I don't want" notification
+    void addIDontWant(const MessageId &msg_id);
+
     /// Adds graft request
     void addGraft(const TopicId &topic);
 
-    /// Adds prune request
-    void addPrune(const TopicId &topic);
+    /// Adds prune request with peers suggested instead of this host
+    void addPrune(const TopicId &topic,
+                  const std::vector<PeerContextPtr> &px = {});
 
-    /// Adds message to be forwarded
-    void addMessage(const TopicMessage &msg, const MessageId &msg_id);
+    /// Adds message to be forwarded, or published if it is local one
+    void addMessage(const TopicMessage &msg,
+                    const MessageId &msg_id,
+                    bool published = false);
 
     static outcome::result<Bytes> signableMessage(const TopicMessage &msg);
 
+    /// Serializes message as publish field of RPC
+    static outcome::result<SharedBuffer> rpcField(const TopicMessage &msg);
+
    private:
     /// Creates protobuf structures if needed
     void create_protobuf_structures();
@@ -74,12 +99,26 @@ namespace libp2p::protocol::gossip {
     bool empty_;
     bool control_not_empty_;
 
+    /// Control other than IHAVE, or subscriptions were added
+    bool urgent_ = false;
+
     /// Intermediate struct for building IHave messages
     std::map<TopicId, std::vector<MessageId>> ihaves_;
 
     /// Intermediate struct for building IWant request
     std::vector<MessageId> iwant_;
 
+    /// Intermediate struct for building IDontWant notification
+    std::vector<MessageId> idontwant_;
+
+    /// Serialized messages to be forwarded
+    SharedBuffers messages_;
+    size_t messages_size_ = 0;
+
+    /// Serialized messages published locally
+    SharedBuffers published_;
+    size_t published_size_ = 0;
+
     /// Used to prevent duplicate forwarding
     std::unordered_set<MessageId> messages_added_;
   };
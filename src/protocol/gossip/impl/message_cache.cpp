@@ -6,40 +6,50 @@
 
 #include "message_cache.hpp"
 
+#include <algorithm>
 #include <cassert>
 
-#include <boost/multi_index/hashed_index.hpp>
-#include <boost/multi_index/ordered_index.hpp>
-#include <boost/multi_index_container.hpp>
 #include <qtils/hex.hpp>
 
+#include <libp2p/common/metrics/registry.hpp>
+
 #define TRACE_ENABLED 0
 #include <libp2p/common/trace.hpp>
 
 namespace libp2p::protocol::gossip {
+  namespace {
+    /// Messages in caches of all gossip instances
+    metrics::Gauge &sizeGauge() {
+      static auto &gauge = metrics::Registry::instance().gauge(
+          "libp2p_gossip_message_cache_size", "Messages in gossip cache");
+      return gauge;
+    }
+  }  // namespace
 
-  MessageCache::MessageCache(Time message_lifetime, TimeFunction clock)
-      : message_lifetime_(message_lifetime), clock_(std::move(clock)) {
-    assert(message_lifetime_ > Time::zero());
-    table_ = std::make_unique<msg_cache_table::Table>();
+  MessageCache::MessageCache(size_t history_length, size_t history_gossip)
+      : history_gossip_(std::min(history_gossip, history_length)),
+        windows_(std::max<size_t>(history_length, 1)) {
+    assert(history_length > 0);
   }
 
-  MessageCache::~MessageCache() = default;
+  MessageCache::~MessageCache() {
+    sizeGauge().sub(messages_.size());
+  }
 
   bool MessageCache::contains(const MessageId &id) const {
-    return table_->get<ById>().count(id) != 0;
+    return messages_.contains(id);
   }
 
   boost::optional<TopicMessage::Ptr> MessageCache::getMessage(
       const MessageId &id) const {
-    auto &idx = table_->get<ById>();
-    auto it = idx.find(id);
-    if (it == idx.end()) {
-      TRACE(
-          "MessageCache: {:X} not found, current size {}", id, table_->size());
+    auto it = messages_.find(id);
+    if (it == messages_.end()) {
+      TRACE("MessageCache: {:X} not found, current size {}",
+            id,
+            messages_.size());
       return boost::none;
     }
-    return it->message;
+    return it->second;
   }
 
   bool MessageCache::insert(TopicMessage::Ptr message,
@@ -47,35 +57,41 @@ namespace libp2p::protocol::gossip {
     if (!message || msg_id.empty()) {
       return false;
     }
-    auto &idx = table_->get<ById>();
-    auto it = idx.find(msg_id);
-    if (it != idx.end()) {
+    if (not messages_.emplace(msg_id, std::move(message)).second) {
       return false;
     }
-    auto now = clock_();
-    idx.insert({msg_id, now + message_lifetime_, std::move(message)});
+    windows_[current_].push_back(msg_id);
+    sizeGauge().add(1);
     return true;
   }
 
   void MessageCache::shift() {
-    auto &idx = table_->get<ByTimestamp>();
-    if (idx.empty()) {
-      return;
+    TRACE("MessageCache: size before shift: {}", messages_.size());
+
+    current_ = (current_ + 1) % windows_.size();
+    auto &oldest = windows_[current_];
+    for (auto &id : oldest) {
+      messages_.erase(id);
     }
-    auto now = clock_();
+    sizeGauge().sub(oldest.size());
+    // keeps capacity for the next window
+    oldest.clear();
 
-    TRACE("MessageCache: size before shift: {}", table_->size());
+    TRACE("MessageCache: size after shift: {}", messages_.size());
+  }
 
-    if (idx.rbegin()->expires_at < now) {
-      table_->clear();
-    } else {
-      auto expired_until = idx.lower_bound(now);
-      if (expired_until != idx.end()) {
-        idx.erase(idx.begin(), expired_until);
+  std::vector<MessageId> MessageCache::gossipIds(const TopicId &topic) const {
+    std::vector<MessageId> ids;
+    auto n = windows_.size();
+    for (size_t i = 0; i < history_gossip_; ++i) {
+      for (auto &id : windows_[(current_ + n - i) % n]) {
+        auto it = messages_.find(id);
+        if (it != messages_.end() and it->second->topic == topic) {
+          ids.push_back(id);
+        }
       }
     }
-
-    TRACE("MessageCache: size after shift: {}", table_->size());
+    return ids;
   }
 
 }  // namespace libp2p::protocol::gossip
@@ -7,52 +7,21 @@
 #pragma once
 
 #include <functional>
-
-#include <boost/multi_index/hashed_index_fwd.hpp>
-#include <boost/multi_index/member.hpp>
-#include <boost/multi_index/ordered_index_fwd.hpp>
-#include <boost/multi_index_container_fwd.hpp>
+#include <unordered_map>
 
 #include "common.hpp"
 
 namespace libp2p::protocol::gossip {
 
-  struct ById;
-  struct ByTimestamp;
-
-  namespace msg_cache_table {
-
-    namespace mi = boost::multi_index;
-
-    struct Record {
-      MessageId message_id;
-      Time expires_at;
-      TopicMessage::Ptr message;
-    };
-
-    /// Table of Record with 2 indices (by key and expire time)
-    using Table = boost::multi_index_container<
-        Record,
-        mi::indexed_by<
-            // hashed_non_unique by id means unordered index
-            mi::hashed_unique<
-                mi::tag<ById>,
-                mi::member<Record, MessageId, &Record::message_id>,
-                std::hash<MessageId>>,
-            // ordered_non_unique by time means accending order
-            mi::ordered_non_unique<
-                mi::tag<ByTimestamp>,
-                mi::member<Record, Time, &Record::expires_at>>>>;
-
-  }  // namespace msg_cache_table
-
-  /// Message cache with expiration
+  /**
+   * Message cache as in gossipsub spec: ring of `history_length` windows of
+   * message ids, one window per heartbeat, and messages by id. Messages live
+   * for `history_length` shifts, the most recent `history_gossip` windows
+   * are announced to peers
+   */
   class MessageCache {
    public:
-    /// External time function
-    using TimeFunction = std::function<Time()>;
-
-    MessageCache(Time message_lifetime, TimeFunction clock);
+    MessageCache(size_t history_length, size_t history_gossip);
 
     ~MessageCache();
 
@@ -64,13 +33,24 @@ namespace libp2p::protocol::gossip {
     /// Inserts a new message into cache. If already there, returns false
     bool insert(TopicMessage::Ptr message, const MessageId &msg_id);
 
-    /// Purges expired messages and updates seen notification data
+    /// Purges messages of the oldest window and opens a new one
     void shift();
 
+    /// Ids of messages for the topic from the last `history_gossip` windows,
+    /// most recent first
+    std::vector<MessageId> gossipIds(const TopicId &topic) const;
+
+    size_t size() const {
+      return messages_.size();
+    }
+
    private:
-    const Time message_lifetime_;
-    TimeFunction clock_;
-    std::unique_ptr<msg_cache_table::Table> table_;
+    const size_t history_gossip_;
+    std::unordered_map<MessageId, TopicMessage::Ptr> messages_;
+    std::vector<std::vector<MessageId>> windows_;
+
+    /// Index of the current window in `windows_`
+    size_t current_ = 0;
   };
 
 }  // namespace libp2p::protocol::gossip
@@ -6,6 +6,10 @@
 
 #include "message_parser.hpp"
 
+#include <google/protobuf/arena.h>
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/wire_format_lite.h>
+
 #include <libp2p/log/logger.hpp>
 
 #include "message_receiver.hpp"
@@ -19,6 +23,109 @@ namespace libp2p::protocol::gossip {
       static auto logger = log::createLogger("gossip");
       return logger.get();
     }
+
+    /// Points into protobuf string
+    BytesIn toSpan(const std::string &s) {
+      // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+      return {reinterpret_cast<const uint8_t *>(s.data()), s.size()};
+    }
+
+    /// Ids are copied from protobuf strings without intermediate Bytes
+    MessageId toMessageId(const std::string &s) {
+      return toSpan(s);
+    }
+
+    using google::protobuf::io::CodedInputStream;
+    using google::protobuf::internal::WireFormatLite;
+
+    /// Reads length-delimited field without copying
+    bool readBytes(CodedInputStream &input, BytesIn &out) {
+      uint32_t size = 0;
+      if (!input.ReadVarint32(&size)) {
+        return false;
+      }
+      if (size == 0) {
+        out = {};
+        return true;
+      }
+      const void *data = nullptr;
+      int available = 0;
+      if (!input.GetDirectBufferPointer(&data, &available)
+          || static_cast<uint32_t>(available) < size) {
+        return false;
+      }
+      out = BytesIn{static_cast<const uint8_t *>(data), size};
+      return input.Skip(static_cast<int>(size));
+    }
+
+    bool isBytes(uint32_t tag) {
+      return WireFormatLite::GetTagWireType(tag)
+          == WireFormatLite::WIRETYPE_LENGTH_DELIMITED;
+    }
+
+    /// Parses pubsub::pb::Message fields as views into bytes.
+    /// Returns none if message is malformed, or false if it lacks
+    /// mandatory fields and is to be ignored
+    boost::optional<bool> parseMessage(BytesIn bytes, TopicMessageView &msg) {
+      using Message = pubsub::pb::Message;
+      CodedInputStream input{bytes.data(), static_cast<int>(bytes.size())};
+      boost::optional<BytesIn> from, data, seq_no, topic;
+      while (auto tag = input.ReadTag()) {
+        boost::optional<BytesIn> *field = nullptr;
+        if (isBytes(tag)) {
+          switch (WireFormatLite::GetTagFieldNumber(tag)) {
+            case Message::kFromFieldNumber:
+              field = &from;
+              break;
+            case Message::kDataFieldNumber:
+              field = &data;
+              break;
+            case Message::kSeqnoFieldNumber:
+              field = &seq_no;
+              break;
+            case Message::kTopicFieldNumber:
+              field = &topic;
+              break;
+            case Message::kSignatureFieldNumber:
+              field = &msg.signature;
+              break;
+            case Message::kKeyFieldNumber:
+              field = &msg.key;
+              break;
+            default:
+              break;
+          }
+        }
+        if (field == nullptr) {
+          if (!WireFormatLite::SkipField(&input, tag)) {
+            return boost::none;
+          }
+          continue;
+        }
+        BytesIn value;
+        if (!readBytes(input, value)) {
+          return boost::none;
+        }
+        *field = value;
+      }
+      if (!input.ConsumedEntireMessage()) {
+        return boost::none;
+      }
+      if (!from || !data || !seq_no || !topic) {
+        return false;
+      }
+      msg.from = *from;
+      msg.data = *data;
+      msg.seq_no = *seq_no;
+      // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+      msg.topic = {reinterpret_cast<const char *>(topic->data()),
+                   topic->size()};
+      return true;
+    }
+
+    Bytes toBytes(BytesIn bytes) {
+      return {bytes.begin(), bytes.end()};
+    }
   }  // namespace
 
   // need to define default ctor/dtor here in translation unit due to unique_ptr
@@ -27,13 +134,66 @@ namespace libp2p::protocol::gossip {
   MessageParser::~MessageParser() = default;
 
   bool MessageParser::parse(BytesIn bytes) {
-    if (!pb_msg_) {
-      pb_msg_ = std::make_unique<pubsub::pb::RPC>();
+    using RPC = pubsub::pb::RPC;
+    if (!arena_) {
+      arena_ = std::make_unique<google::protobuf::Arena>();
     } else {
-      pb_msg_->Clear();
+      // messages of the previous parse are freed at once
+      arena_->Reset();
     }
-    return pb_msg_->ParseFromArray(bytes.data(),
-                                   static_cast<int>(bytes.size()));
+    pb_msg_ = google::protobuf::Arena::CreateMessage<RPC>(arena_.get());
+    publish_.clear();
+
+    // top level fields are walked here, so that published messages are not
+    // copied into protobuf strings
+    CodedInputStream input{bytes.data(), static_cast<int>(bytes.size())};
+    while (auto tag = input.ReadTag()) {
+      auto field = WireFormatLite::GetTagFieldNumber(tag);
+      if (!isBytes(tag)) {
+        if (!WireFormatLite::SkipField(&input, tag)) {
+          return false;
+        }
+        continue;
+      }
+      if (field == RPC::kPublishFieldNumber) {
+        BytesIn message;
+        if (!readBytes(input, message)) {
+          return false;
+        }
+        TopicMessageView view;
+        auto parsed = parseMessage(message, view);
+        if (!parsed) {
+          return false;
+        }
+        if (parsed.value()) {
+          publish_.push_back(view);
+        }
+        continue;
+      }
+      google::protobuf::MessageLite *part = nullptr;
+      if (field == RPC::kSubscriptionsFieldNumber) {
+        part = pb_msg_->add_subscriptions();
+      } else if (field == RPC::kControlFieldNumber) {
+        // repeated occurrences of message field are merged
+        part = pb_msg_->mutable_control();
+      } else {
+        if (!WireFormatLite::SkipField(&input, tag)) {
+          return false;
+        }
+        continue;
+      }
+      uint32_t size = 0;
+      if (!input.ReadVarint32(&size)) {
+        return false;
+      }
+      auto limit = input.PushLimit(static_cast<int>(size));
+      if (!part->MergePartialFromCodedStream(&input)
+          || !input.ConsumedEntireMessage()) {
+        return false;
+      }
+      input.PopLimit(limit);
+    }
+    return input.ConsumedEntireMessage();
   }
 
   void MessageParser::dispatch(const PeerContextPtr &from,
@@ -61,7 +221,7 @@ namespace libp2p::protocol::gossip {
           if (msg_id.empty()) {
             continue;
           }
-          receiver.onIHave(from, topic, fromString(msg_id));
+          receiver.onIHave(from, topic, toMessageId(msg_id));
         }
       }
 
@@ -73,7 +233,16 @@ namespace libp2p::protocol::gossip {
           if (msg_id.empty()) {
             continue;
           }
-          receiver.onIWant(from, fromString(msg_id));
+          receiver.onIWant(from, toMessageId(msg_id));
+        }
+      }
+
+      for (const auto &dw : c.idontwant()) {
+        for (const auto &msg_id : dw.messageids()) {
+          if (msg_id.empty()) {
+            continue;
+          }
+          receiver.onIDontWant(from, toMessageId(msg_id));
         }
       }
 
@@ -94,29 +263,33 @@ namespace libp2p::protocol::gossip {
         }
         log()->debug(
             "prune backoff={}, {} peers", backoff_time, pr.peers_size());
+        std::vector<PxPeer> px;
+        px.reserve(pr.peers_size());
         for (const auto &peer : pr.peers()) {
-          // TODO(artem): meshsub 1.1.0 + signed peer records NYI
-
-          log()->debug("peer id size={}, signed peer record size={}",
-                       peer.peerid().size(),
-                       peer.signedpeerrecord().size());
+          auto peer_id = peer::PeerId::fromBytes(toSpan(peer.peerid()));
+          if (!peer_id) {
+            continue;
+          }
+          px.push_back({std::move(peer_id.value()),
+                        toSpan(peer.signedpeerrecord())});
         }
-        receiver.onPrune(from, pr.topicid(), backoff_time);
+        receiver.onPrune(from, pr.topicid(), backoff_time, px);
       }
     }
 
-    for (const auto &m : pb_msg_->publish()) {
-      if (!m.has_from() || !m.has_data() || !m.has_seqno() || !m.has_topic()) {
+    for (const auto &m : publish_) {
+      if (!receiver.needTopicMessage(from, m)) {
         continue;
       }
+      // the only copy of message from wire
       auto message = std::make_shared<TopicMessage>(
-          fromString(m.from()), fromString(m.seqno()), fromString(m.data()));
-      message->topic = m.topic();
-      if (m.has_signature()) {
-        message->signature = fromString(m.signature());
+          toBytes(m.from), toBytes(m.seq_no), toBytes(m.data));
+      message->topic = m.topic;
+      if (m.signature) {
+        message->signature = toBytes(*m.signature);
       }
-      if (m.has_key()) {
-        message->key = fromString(m.key());
+      if (m.key) {
+        message->key = toBytes(*m.key);
       }
       receiver.onTopicMessage(from, std::move(message));
     }
@@ -6,8 +6,14 @@
 
 #pragma once
 
+#include <vector>
+
 #include "common.hpp"
 
+namespace google::protobuf {
+  class Arena;
+}  // namespace google::protobuf
+
 namespace pubsub::pb {
   // protobuf message forward declaration
   class RPC;
@@ -18,6 +24,9 @@ namespace libp2p::protocol::gossip {
   class MessageReceiver;
 
   /// Protobuf message parser.
+  /// Subscriptions and control parts are parsed into arena, which is reused
+  /// by the next parse. Published messages are not parsed by protobuf, they
+  /// point into received bytes, which must outlive dispatch()
   class MessageParser {
    public:
     MessageParser();
@@ -27,12 +36,18 @@ namespace libp2p::protocol::gossip {
     /// Parses RPC protobuf message received from wire
     bool parse(BytesIn bytes);
 
-    /// Dispatches parts of parsed aggregate message to receiver
+    /// Dispatches parts of parsed aggregate message to receiver.
+    /// Published message is copied only if receiver needs it
     void dispatch(const PeerContextPtr &from, MessageReceiver &receiver);
 
    private:
-    /// Parsed protobuf message
-    std::unique_ptr<pubsub::pb::RPC> pb_msg_;
+    std::unique_ptr<google::protobuf::Arena> arena_;
+
+    /// Parsed protobuf message without publish field, owned by arena
+    pubsub::pb::RPC *pb_msg_ = nullptr;
+
+    /// Published messages, valid while received bytes are
+    std::vector<TopicMessageView> publish_;
   };
 
 }  // namespace libp2p::protocol::gossip
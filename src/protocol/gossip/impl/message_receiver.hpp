@@ -6,6 +6,8 @@
 
 #pragma once
 
+#include <span>
+
 #include "common.hpp"
 
 namespace libp2p::protocol::gossip {
@@ -29,15 +31,27 @@ namespace libp2p::protocol::gossip {
     virtual void onIWant(const PeerContextPtr &from,
                          const MessageId &msg_id) = 0;
 
+    /// "I don't want message" notification received (gossipsub v1.2)
+    virtual void onIDontWant(const PeerContextPtr &from,
+                             const MessageId &msg_id) = 0;
+
     /// Graft request received (gossip mesh control)
     virtual void onGraft(const PeerContextPtr &from, const TopicId &topic) = 0;
 
     /// Prune request received (gossip mesh control).
     /// the peer must not be bothered with GRAFT requests for at least
-    /// backoff_time seconds
+    /// backoff_time seconds, other peers of topic may be suggested instead
     virtual void onPrune(const PeerContextPtr &from,
                          const TopicId &topic,
-                         uint64_t backoff_time) = 0;
+                         uint64_t backoff_time,
+                         std::span<const PxPeer> px) = 0;
+
+    /// Message received, called before it is copied from wire.
+    /// Returns false if message is dropped, e.g. already seen
+    virtual bool needTopicMessage(const PeerContextPtr & /*from*/,
+                                  const TopicMessageView & /*msg*/) {
+      return true;
+    }
 
     /// Message received
     virtual void onTopicMessage(const PeerContextPtr &from,
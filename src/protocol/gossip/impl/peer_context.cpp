@@ -22,6 +22,47 @@ namespace libp2p::protocol::gossip {
         str(makeStringRepr(peer_id)),
         message_builder(std::make_shared<MessageBuilder>()) {}
 
+  void PeerContext::addDontWant(const MessageId &msg_id,
+                                Time now,
+                                Time lifetime,
+                                size_t limit) {
+    expireDontWant(now);
+    if (dont_want.size() >= limit) {
+      return;
+    }
+    if (dont_want.insert(msg_id).second) {
+      dont_want_expiration.emplace_back(now + lifetime, msg_id);
+    }
+  }
+
+  bool PeerContext::dontWant(const MessageId &msg_id, Time now) {
+    expireDontWant(now);
+    return dont_want.contains(msg_id);
+  }
+
+  bool PeerContext::allowIWantReply(Time now, Time window, size_t limit) {
+    if (limit == 0) {
+      return true;
+    }
+    if (now >= iwant_window_ends) {
+      iwant_window_ends = now + window;
+      iwant_replies = 0;
+    }
+    if (iwant_replies >= limit) {
+      return false;
+    }
+    ++iwant_replies;
+    return true;
+  }
+
+  void PeerContext::expireDontWant(Time now) {
+    while (!dont_want_expiration.empty()
+           && dont_want_expiration.front().first <= now) {
+      dont_want.erase(dont_want_expiration.front().second);
+      dont_want_expiration.pop_front();
+    }
+  }
+
   bool operator<(const PeerContextPtr &ctx, const peer::PeerId &peer) {
     if (!ctx) {
       return false;
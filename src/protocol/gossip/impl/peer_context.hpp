@@ -6,10 +6,17 @@
 
 #pragma once
 
+#include <deque>
+#include <unordered_set>
+
 #include <libp2p/common/metrics/instance_count.hpp>
 
 #include "common.hpp"
 
+namespace libp2p::connection {
+  class CapableConnection;
+}  // namespace libp2p::connection
+
 namespace libp2p::protocol::gossip {
 
   class MessageBuilder;
@@ -26,16 +33,34 @@ namespace libp2p::protocol::gossip {
     /// Builds message to be sent to this peer
     std::shared_ptr<MessageBuilder> message_builder;
 
+    /// Remote ip address of connection, if known
+    boost::optional<std::string> ip;
+
     /// Set of topics this peer is subscribed to
-    std::set<TopicId> subscribed_to;
+    std::unordered_set<TopicId> subscribed_to;
 
     /// Streams connected to peer
     std::shared_ptr<Stream> outbound_stream;
     std::vector<std::shared_ptr<Stream>> inbound_streams;
 
+    /// Connection carrying IHAVE and IDONTWANT as datagrams, if supported
+    std::weak_ptr<connection::CapableConnection> datagram_connection;
+
+    /// Messages the peer asked not to send (IDONTWANT), in order of arrival
+    std::unordered_set<MessageId> dont_want;
+    std::deque<std::pair<Time, MessageId>> dont_want_expiration;
+
+    /// Messages sent in reply to IWANT in the current window
+    size_t iwant_replies = 0;
+    Time iwant_window_ends{0};
+
     /// Dialing to this peer is banned until this timestamp
     Time banned_until{0};
 
+    /// Signed peer record received in peer exchange, forwarded to others
+    SharedBuffer signed_record;
+    uint64_t record_seq = 0;
+
     /// Current dial attempts
     unsigned dial_attempts = 0;
 
@@ -50,6 +75,21 @@ namespace libp2p::protocol::gossip {
 
     explicit PeerContext(peer::PeerId id);
 
+    /// Remembers message id for lifetime, ids above limit are ignored
+    void addDontWant(const MessageId &msg_id,
+                     Time now,
+                     Time lifetime,
+                     size_t limit);
+
+    /// Returns true if the peer asked not to send the message
+    bool dontWant(const MessageId &msg_id, Time now);
+
+    /// Forgets expired IDONTWANT ids
+    void expireDontWant(Time now);
+
+    /// Counts reply to IWANT, returns false if limit of window is reached
+    bool allowIWantReply(Time now, Time window, size_t limit);
+
     LIBP2P_METRICS_INSTANCE_COUNT_IF_ENABLED(
         libp2p::protocol::gossip::PeerContext);
   };
@@ -0,0 +1,133 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "peer_record.hpp"
+
+#include <array>
+
+#include <libp2p/multi/uvarint.hpp>
+
+#include <generated/protocol/gossip/protobuf/rpc.pb.h>
+
+namespace libp2p::protocol::gossip {
+
+  namespace {
+    /// Signature domain and multicodec of libp2p peer records
+    constexpr std::string_view kDomain = "libp2p-routing-state";
+    constexpr std::array<uint8_t, 2> kPayloadType{0x03, 0x01};
+
+    void appendField(Bytes &out, BytesIn field) {
+      multi::UVarint len{field.size()};
+      auto len_bytes = len.toBytes();
+      out.insert(out.end(), len_bytes.begin(), len_bytes.end());
+      out.insert(out.end(), field.begin(), field.end());
+    }
+
+    BytesIn toSpan(const std::string &s) {
+      // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+      return {reinterpret_cast<const uint8_t *>(s.data()), s.size()};
+    }
+
+    /// Signed data is length prefixed domain, payload type and payload
+    Bytes signedData(BytesIn payload_type, BytesIn payload) {
+      Bytes data;
+      data.reserve(kDomain.size() + payload_type.size() + payload.size() + 12);
+      appendField(data,
+                  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+                  {reinterpret_cast<const uint8_t *>(kDomain.data()),
+                   kDomain.size()});
+      appendField(data, payload_type);
+      appendField(data, payload);
+      return data;
+    }
+  }  // namespace
+
+  outcome::result<Bytes> signPeerRecord(
+      const PeerRecord &record,
+      const crypto::KeyPair &keypair,
+      crypto::CryptoProvider &crypto_provider,
+      crypto::marshaller::KeyMarshaller &key_marshaller) {
+    pubsub::pb::PeerRecord pb_record;
+    const auto &peer_id = record.peer_id.toVector();
+    pb_record.set_peer_id(peer_id.data(), peer_id.size());
+    pb_record.set_seq(record.seq);
+    for (const auto &address : record.addresses) {
+      const auto &bytes = address.getBytesAddress();
+      pb_record.add_addresses()->set_multiaddr(bytes.data(), bytes.size());
+    }
+    auto payload = pb_record.SerializeAsString();
+
+    OUTCOME_TRY(signature,
+                crypto_provider.sign(signedData(kPayloadType, toSpan(payload)),
+                                     keypair.privateKey));
+    OUTCOME_TRY(key, key_marshaller.marshal(keypair.publicKey));
+
+    pubsub::pb::Envelope envelope;
+    envelope.set_public_key(key.key.data(), key.key.size());
+    envelope.set_payload_type(kPayloadType.data(), kPayloadType.size());
+    envelope.set_payload(std::move(payload));
+    envelope.set_signature(signature.data(), signature.size());
+
+    Bytes out(envelope.ByteSizeLong());
+    if (!envelope.SerializeToArray(out.data(), static_cast<int>(out.size()))) {
+      return Error::MESSAGE_SERIALIZE_ERROR;
+    }
+    return out;
+  }
+
+  outcome::result<PeerRecord> openPeerRecord(
+      BytesIn envelope,
+      crypto::CryptoProvider &crypto_provider,
+      crypto::marshaller::KeyMarshaller &key_marshaller) {
+    pubsub::pb::Envelope pb_envelope;
+    if (!pb_envelope.ParseFromArray(envelope.data(),
+                                    static_cast<int>(envelope.size()))) {
+      return Error::INVALID_PEER_RECORD;
+    }
+    auto payload_type = toSpan(pb_envelope.payload_type());
+    if (!std::equal(payload_type.begin(),
+                    payload_type.end(),
+                    kPayloadType.begin(),
+                    kPayloadType.end())) {
+      return Error::INVALID_PEER_RECORD;
+    }
+    auto payload = toSpan(pb_envelope.payload());
+
+    crypto::ProtobufKey key{Bytes{pb_envelope.public_key().begin(),
+                                  pb_envelope.public_key().end()}};
+    OUTCOME_TRY(public_key, key_marshaller.unmarshalPublicKey(key));
+    OUTCOME_TRY(valid,
+                crypto_provider.verify(signedData(payload_type, payload),
+                                       toSpan(pb_envelope.signature()),
+                                       public_key));
+    if (!valid) {
+      return Error::INVALID_PEER_RECORD;
+    }
+
+    pubsub::pb::PeerRecord pb_record;
+    if (!pb_record.ParseFromArray(payload.data(),
+                                  static_cast<int>(payload.size()))) {
+      return Error::INVALID_PEER_RECORD;
+    }
+    OUTCOME_TRY(signer, peer::PeerId::fromPublicKey(key));
+    auto peer_id = peer::PeerId::fromBytes(toSpan(pb_record.peer_id()));
+    if (!peer_id || peer_id.value() != signer) {
+      // record of one peer signed by another
+      return Error::INVALID_PEER_RECORD;
+    }
+
+    PeerRecord record{.peer_id = std::move(peer_id.value()),
+                      .seq = pb_record.seq()};
+    for (const auto &address : pb_record.addresses()) {
+      auto ma = multi::Multiaddress::create(toSpan(address.multiaddr()));
+      if (ma) {
+        record.addresses.push_back(std::move(ma.value()));
+      }
+    }
+    return record;
+  }
+
+}  // namespace libp2p::protocol::gossip
@@ -0,0 +1,41 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <libp2p/crypto/crypto_provider.hpp>
+#include <libp2p/crypto/key_marshaller.hpp>
+
+#include "common.hpp"
+
+namespace libp2p::protocol::gossip {
+
+  /// Addresses of peer signed by its key, libp2p routing record in signed
+  /// envelope. Peers pass records of others in PRUNE peer exchange
+  struct PeerRecord {
+    peer::PeerId peer_id;
+
+    /// Newer records of the same peer have greater numbers
+    uint64_t seq = 0;
+
+    std::vector<multi::Multiaddress> addresses;
+  };
+
+  /// Serializes record into envelope signed by peer's key pair
+  outcome::result<Bytes> signPeerRecord(
+      const PeerRecord &record,
+      const crypto::KeyPair &keypair,
+      crypto::CryptoProvider &crypto_provider,
+      crypto::marshaller::KeyMarshaller &key_marshaller);
+
+  /// Parses envelope and verifies that the record is signed by its peer.
+  /// Unparsable addresses are skipped
+  outcome::result<PeerRecord> openPeerRecord(
+      BytesIn envelope,
+      crypto::CryptoProvider &crypto_provider,
+      crypto::marshaller::KeyMarshaller &key_marshaller);
+
+}  // namespace libp2p::protocol::gossip
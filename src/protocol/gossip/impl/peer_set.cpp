@@ -69,6 +69,22 @@ namespace libp2p::protocol::gossip {
     return ret;
   }
 
+  std::vector<PeerContextPtr> PeerSet::selectRandomPeers(
+      size_t n, const FilterCallback &filter) const {
+    std::vector<PeerContextPtr> filtered;
+    std::copy_if(
+        peers_.begin(), peers_.end(), std::back_inserter(filtered), filter);
+    std::vector<PeerContextPtr> ret;
+    if (n > 0 && !filtered.empty()) {
+      ret.reserve(n > filtered.size() ? filtered.size() : n);
+      std::mt19937 gen;
+      gen.seed(std::chrono::system_clock::now().time_since_epoch().count());
+      std::sample(
+          filtered.begin(), filtered.end(), std::back_inserter(ret), n, gen);
+    }
+    return ret;
+  }
+
   void PeerSet::selectAll(const SelectCallback &callback) const {
     boost::for_each(peers_, callback);
   }
@@ -46,6 +46,10 @@ namespace libp2p::protocol::gossip {
     /// Callback for peer filtering
     using FilterCallback = std::function<bool(const PeerContextPtr &)>;
 
+    /// Selects up to n random peers among filtered by external criteria
+    std::vector<PeerContextPtr> selectRandomPeers(
+        size_t n, const FilterCallback &filter) const;
+
     /// Selects all peers
     void selectAll(const SelectCallback &callback) const;
 
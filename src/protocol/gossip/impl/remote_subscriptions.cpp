@@ -7,6 +7,7 @@
 #include "remote_subscriptions.hpp"
 
 #include <algorithm>
+#include <cassert>
 
 #include "connectivity.hpp"
 #include "message_builder.hpp"
@@ -15,10 +16,12 @@ namespace libp2p::protocol::gossip {
 
   RemoteSubscriptions::RemoteSubscriptions(const Config &config,
                                            Connectivity &connectivity,
+                                           Score &score,
                                            basic::Scheduler &scheduler,
                                            log::SubLogger &log)
       : config_(config),
         connectivity_(connectivity),
+        score_(score),
         scheduler_(scheduler),
         log_(log) {}
 
@@ -84,7 +87,7 @@ namespace libp2p::protocol::gossip {
   }
 
   void RemoteSubscriptions::onPeerDisconnected(const PeerContextPtr &peer) {
-    std::set<std::string> subscribed_to;
+    decltype(peer->subscribed_to) subscribed_to;
     subscribed_to.swap(peer->subscribed_to);
 
     for (const auto &topic : subscribed_to) {
@@ -96,6 +99,22 @@ namespace libp2p::protocol::gossip {
     return table_.count(topic) != 0;
   }
 
+  TopicMetrics *RemoteSubscriptions::metrics(const TopicId &topic) {
+    auto it = table_.find(topic);
+    if (it == table_.end()) {
+      return nullptr;
+    }
+    return &it->second.metrics();
+  }
+
+  std::map<TopicId, Gossip::TopicStats> RemoteSubscriptions::stats() const {
+    std::map<TopicId, Gossip::TopicStats> stats;
+    for (auto &[topic, item] : table_) {
+      stats.emplace(topic, item.stats());
+    }
+    return stats;
+  }
+
   void RemoteSubscriptions::onGraft(const PeerContextPtr &peer,
                                     const TopicId &topic) {
     auto res = getItem(topic, false);
@@ -105,7 +124,7 @@ namespace libp2p::protocol::gossip {
       connectivity_.peerIsWritable(peer, true);
       return;
     }
-    res.value().onGraft(peer);
+    res.value().onGraft(peer, scheduler_.now());
   }
 
   void RemoteSubscriptions::onPrune(const PeerContextPtr &peer,
@@ -133,9 +152,30 @@ namespace libp2p::protocol::gossip {
     res.value().onNewMessage(from, msg, msg_id, now);
   }
 
-  void RemoteSubscriptions::onHeartbeat() {
+  void RemoteSubscriptions::sendDontWant(const PeerContextPtr &from,
+                                         const TopicId &topic,
+                                         const MessageId &msg_id) {
+    auto res = getItem(topic, false);
+    if (!res) {
+      return;
+    }
+    res.value().sendDontWant(from, msg_id);
+  }
+
+  void RemoteSubscriptions::onHeartbeat(size_t slice, size_t slices) {
+    assert(slice < slices);
+    if (slice == 0) {
+      heartbeat_next_.reset();
+      heartbeat_left_ = table_.size();
+    }
+    // topics added during the round wait for the next one, unless they are
+    // ahead of the cursor
+    auto budget = (heartbeat_left_ + slices - slice - 1) / (slices - slice);
+    auto it = heartbeat_next_ ? table_.lower_bound(*heartbeat_next_)
+                              : table_.begin();
     auto now = scheduler_.now();
-    for (auto it = table_.begin(); it != table_.end();) {
+    for (; budget != 0 and it != table_.end(); --budget) {
+      --heartbeat_left_;
       it->second.onHeartbeat(now);
       if (it->second.empty()) {
         // fanout interval expired - clean up
@@ -145,6 +185,11 @@ namespace libp2p::protocol::gossip {
         ++it;
       }
     }
+    if (it == table_.end()) {
+      heartbeat_left_ = 0;
+    } else {
+      heartbeat_next_ = it->first;
+    }
   }
 
   boost::optional<TopicSubscriptions &> RemoteSubscriptions::getItem(
@@ -155,7 +200,8 @@ namespace libp2p::protocol::gossip {
     }
     if (create_if_not_exist) {
       auto [it, _] = table_.emplace(
-          topic, TopicSubscriptions(topic, config_, connectivity_, log_));
+          topic,
+          TopicSubscriptions(topic, config_, connectivity_, score_, log_));
       TopicSubscriptions &item = it->second;
       connectivity_.getConnectedPeers().selectIf(
           [&item](const PeerContextPtr &ctx) { item.onPeerSubscribed(ctx); },
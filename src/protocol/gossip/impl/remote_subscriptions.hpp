@@ -6,6 +6,8 @@
 
 #pragma once
 
+#include <map>
+
 #include <libp2p/basic/scheduler.hpp>
 #include <libp2p/log/sublogger.hpp>
 
@@ -20,6 +22,7 @@ namespace libp2p::protocol::gossip {
     /// GossipCore and lives only within its scope
     RemoteSubscriptions(const Config &config,
                         Connectivity &connectivity,
+                        Score &score,
                         basic::Scheduler &scheduler,
                         log::SubLogger &log);
 
@@ -40,6 +43,13 @@ namespace libp2p::protocol::gossip {
     /// Returns if topic exists in the table
     bool hasTopic(const TopicId &topic) const;
 
+    /// Returns delivery counters of topic, nullptr if topic is not in the
+    /// table. Pointer is valid till the next heartbeat or unsubscription
+    TopicMetrics *metrics(const TopicId &topic);
+
+    /// Returns delivery counters of all topics in the table
+    std::map<TopicId, Gossip::TopicStats> stats() const;
+
     /// Remote peer adds topic into its mesh
     void onGraft(const PeerContextPtr &peer, const TopicId &topic);
 
@@ -54,8 +64,15 @@ namespace libp2p::protocol::gossip {
                       const TopicMessage::Ptr &msg,
                       const MessageId &msg_id);
 
-    /// Periodic job needed to update meshes and shift "I have" caches
-    void onHeartbeat();
+    /// Asks mesh peers of message topic not to send the message
+    void sendDontWant(const PeerContextPtr &from,
+                      const TopicId &topic,
+                      const MessageId &msg_id);
+
+    /// Periodic job needed to update meshes and shift "I have" caches.
+    /// Heartbeat interval is split into slices, each one handles its share
+    /// of topics in order, so every topic gets one call per interval
+    void onHeartbeat(size_t slice, size_t slices);
 
    private:
     /// Returns table item, creates a new one if needed
@@ -64,11 +81,18 @@ namespace libp2p::protocol::gossip {
 
     const Config &config_;
     Connectivity &connectivity_;
+    Score &score_;
     basic::Scheduler &scheduler_;
 
     // TODO(artem): bound table size (which may grow!)
     // by removing items not subscribed to locally. LRU(???)
-    std::unordered_map<TopicId, TopicSubscriptions> table_;
+    std::map<TopicId, TopicSubscriptions> table_;
+
+    /// Topic where the current heartbeat round continues, none from start
+    boost::optional<TopicId> heartbeat_next_;
+
+    /// Topics left for the current heartbeat round
+    size_t heartbeat_left_ = 0;
 
     log::SubLogger &log_;
   };
@@ -0,0 +1,364 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "score.hpp"
+
+#include <algorithm>
+
+namespace libp2p::protocol::gossip {
+
+  namespace {
+    double square(double x) {
+      return x * x;
+    }
+
+    void decayCounter(double &counter, double decay, double decay_to_zero) {
+      counter *= decay;
+      if (counter < decay_to_zero) {
+        counter = 0;
+      }
+    }
+  }  // namespace
+
+  Score::Score(const ScoreConfig &config) : config_(config) {}
+
+  double Score::score(const peer::PeerId &peer) const {
+    auto it = peers_.find(peer);
+    if (it == peers_.end()) {
+      return 0;
+    }
+    return it->second.score;
+  }
+
+  bool Score::belowGossipThreshold(const peer::PeerId &peer) const {
+    return enabled() and score(peer) < config_.gossip_threshold;
+  }
+
+  bool Score::belowPublishThreshold(const peer::PeerId &peer) const {
+    return enabled() and score(peer) < config_.publish_threshold;
+  }
+
+  bool Score::graylisted(const peer::PeerId &peer) const {
+    return enabled() and score(peer) < config_.graylist_threshold;
+  }
+
+  void Score::connected(const peer::PeerId &peer,
+                        const boost::optional<std::string> &ip) {
+    if (not enabled()) {
+      return;
+    }
+    auto &s = stats(peer);
+    s.expires.reset();
+    if (s.ip == ip) {
+      return;
+    }
+    leaveIp(peer, s);
+    s.ip = ip;
+    if (ip) {
+      ips_[ip.value()].push_back(peer);
+      updateIp(ip.value());
+    }
+  }
+
+  void Score::disconnected(const peer::PeerId &peer, Time now) {
+    if (not enabled()) {
+      return;
+    }
+    auto it = peers_.find(peer);
+    if (it == peers_.end()) {
+      return;
+    }
+    auto &s = it->second;
+    s.expires = now + config_.retain_score;
+    leaveIp(peer, s);
+    for (auto &[_, topic] : s.topics) {
+      topic.in_mesh = false;
+      topic.mesh_active = false;
+      updateTopic(s, topic);
+    }
+  }
+
+  void Score::graft(const peer::PeerId &peer, const TopicId &topic, Time now) {
+    if (not enabled()) {
+      return;
+    }
+    auto &s = stats(peer);
+    auto &t = topicStats(s, topic);
+    t.in_mesh = true;
+    t.graft_time = now;
+    t.mesh_time = Time::zero();
+    t.mesh_active = false;
+    updateTopic(s, t);
+  }
+
+  void Score::prune(const peer::PeerId &peer, const TopicId &topic) {
+    if (not enabled()) {
+      return;
+    }
+    auto &s = stats(peer);
+    auto &t = topicStats(s, topic);
+    auto &params = *t.params;
+    if (t.mesh_active
+        and t.mesh_message_deliveries
+                < params.mesh_message_deliveries_threshold) {
+      t.mesh_failure_penalty += square(params.mesh_message_deliveries_threshold
+                                       - t.mesh_message_deliveries);
+    }
+    t.in_mesh = false;
+    t.mesh_active = false;
+    updateTopic(s, t);
+  }
+
+  void Score::firstDelivery(const peer::PeerId &peer,
+                            const TopicId &topic,
+                            const MessageId &msg_id,
+                            Time now) {
+    if (not enabled()) {
+      return;
+    }
+    auto &s = stats(peer);
+    auto &t = topicStats(s, topic);
+    auto &params = *t.params;
+    t.first_message_deliveries =
+        std::min(t.first_message_deliveries + 1,
+                 params.first_message_deliveries_cap);
+    if (t.in_mesh) {
+      addMeshDelivery(t);
+    }
+    updateTopic(s, t);
+
+    auto window_ends = now + params.mesh_message_deliveries_window;
+    auto [it, inserted] =
+        deliveries_.emplace(msg_id, Delivery{window_ends, {peer}});
+    if (inserted) {
+      deliveries_expiration_.emplace_back(window_ends, msg_id);
+    }
+  }
+
+  void Score::duplicateDelivery(const peer::PeerId &peer,
+                                const TopicId &topic,
+                                const MessageId &msg_id,
+                                Time now) {
+    if (not enabled()) {
+      return;
+    }
+    auto it = deliveries_.find(msg_id);
+    if (it == deliveries_.end() or it->second.window_ends < now) {
+      return;
+    }
+    auto &peers = it->second.peers;
+    if (std::find(peers.begin(), peers.end(), peer) != peers.end()) {
+      return;
+    }
+    peers.push_back(peer);
+    auto &s = stats(peer);
+    auto &t = topicStats(s, topic);
+    if (t.in_mesh) {
+      addMeshDelivery(t);
+      updateTopic(s, t);
+    }
+  }
+
+  void Score::invalidMessage(const peer::PeerId &peer, const TopicId &topic) {
+    if (not enabled()) {
+      return;
+    }
+    auto &s = stats(peer);
+    auto &t = topicStats(s, topic);
+    t.invalid_message_deliveries += 1;
+    updateTopic(s, t);
+  }
+
+  void Score::setAppScore(const peer::PeerId &peer, double value) {
+    if (not enabled()) {
+      return;
+    }
+    auto &s = stats(peer);
+    s.app_score = value;
+    updatePeer(s);
+  }
+
+  void Score::addPenalty(const peer::PeerId &peer, double count) {
+    if (not enabled()) {
+      return;
+    }
+    auto &s = stats(peer);
+    s.behaviour_penalty += count;
+    updatePeer(s);
+  }
+
+  void Score::onHeartbeat(Time now) {
+    if (not enabled()) {
+      return;
+    }
+    while (not deliveries_expiration_.empty()
+           and deliveries_expiration_.front().first < now) {
+      deliveries_.erase(deliveries_expiration_.front().second);
+      deliveries_expiration_.pop_front();
+    }
+
+    if (not next_decay_) {
+      next_decay_ = now + config_.decay_interval;
+    } else if (next_decay_.value() <= now) {
+      next_decay_ = now + config_.decay_interval;
+      decay();
+    }
+
+    for (auto it = peers_.begin(); it != peers_.end();) {
+      auto &s = it->second;
+      if (s.expires and s.expires.value() < now) {
+        it = peers_.erase(it);
+        continue;
+      }
+      for (auto &[_, t] : s.topics) {
+        if (not t.in_mesh) {
+          continue;
+        }
+        t.mesh_time = now - t.graft_time;
+        if (t.mesh_time >= t.params->mesh_message_deliveries_activation) {
+          t.mesh_active = true;
+        }
+        updateTopic(s, t);
+      }
+      ++it;
+    }
+  }
+
+  const TopicScoreParams &Score::params(const TopicId &topic) const {
+    auto it = config_.topics.find(topic);
+    if (it == config_.topics.end()) {
+      return config_.default_topic;
+    }
+    return it->second;
+  }
+
+  Score::PeerStats &Score::stats(const peer::PeerId &peer) {
+    return peers_[peer];
+  }
+
+  Score::TopicStats &Score::topicStats(PeerStats &stats,
+                                       const TopicId &topic) {
+    auto it = stats.topics.find(topic);
+    if (it == stats.topics.end()) {
+      it = stats.topics.emplace(topic, TopicStats{&params(topic)}).first;
+    }
+    return it->second;
+  }
+
+  double Score::topicScore(const TopicStats &topic) const {
+    auto &params = *topic.params;
+    double score = 0;
+    if (topic.in_mesh) {
+      auto quantum =
+          std::max<int64_t>(params.time_in_mesh_quantum.count(), 1);
+      auto quanta = static_cast<double>(topic.mesh_time.count())
+                  / static_cast<double>(quantum);
+      score += std::min(quanta, params.time_in_mesh_cap)
+             * params.time_in_mesh_weight;
+    }
+    score += topic.first_message_deliveries
+           * params.first_message_deliveries_weight;
+    if (topic.in_mesh and topic.mesh_active
+        and topic.mesh_message_deliveries
+                < params.mesh_message_deliveries_threshold) {
+      score += square(params.mesh_message_deliveries_threshold
+                      - topic.mesh_message_deliveries)
+             * params.mesh_message_deliveries_weight;
+    }
+    score += topic.mesh_failure_penalty * params.mesh_failure_penalty_weight;
+    score += square(topic.invalid_message_deliveries)
+           * params.invalid_message_deliveries_weight;
+    return score * params.topic_weight;
+  }
+
+  void Score::updateTopic(PeerStats &stats, TopicStats &topic) {
+    auto score = topicScore(topic);
+    stats.topics_score += score - topic.score;
+    topic.score = score;
+    updatePeer(stats);
+  }
+
+  void Score::updatePeer(PeerStats &stats) {
+    auto score = stats.topics_score;
+    if (config_.topic_score_cap > 0) {
+      score = std::min(score, config_.topic_score_cap);
+    }
+    score += stats.app_score * config_.app_specific_weight;
+    if (stats.ip) {
+      auto peers = ips_[stats.ip.value()].size();
+      if (peers > config_.ip_colocation_factor_threshold) {
+        score += square(static_cast<double>(
+                     peers - config_.ip_colocation_factor_threshold))
+               * config_.ip_colocation_factor_weight;
+      }
+    }
+    if (stats.behaviour_penalty > config_.behaviour_penalty_threshold) {
+      score +=
+          square(stats.behaviour_penalty - config_.behaviour_penalty_threshold)
+          * config_.behaviour_penalty_weight;
+    }
+    stats.score = score;
+  }
+
+  void Score::addMeshDelivery(TopicStats &topic) {
+    topic.mesh_message_deliveries =
+        std::min(topic.mesh_message_deliveries + 1,
+                 topic.params->mesh_message_deliveries_cap);
+  }
+
+  void Score::leaveIp(const peer::PeerId &peer, PeerStats &stats) {
+    if (not stats.ip) {
+      return;
+    }
+    auto ip = std::move(stats.ip.value());
+    stats.ip.reset();
+    std::erase(ips_[ip], peer);
+    updateIp(ip);
+    updatePeer(stats);
+  }
+
+  void Score::updateIp(const std::string &ip) {
+    auto it = ips_.find(ip);
+    if (it == ips_.end()) {
+      return;
+    }
+    if (it->second.empty()) {
+      ips_.erase(it);
+      return;
+    }
+    for (auto &peer : it->second) {
+      updatePeer(peers_[peer]);
+    }
+  }
+
+  void Score::decay() {
+    auto zero = config_.decay_to_zero;
+    for (auto &[_, s] : peers_) {
+      // recomputed from scratch, which also drops accumulated rounding
+      s.topics_score = 0;
+      for (auto &item : s.topics) {
+        auto &t = item.second;
+        auto &params = *t.params;
+        decayCounter(t.first_message_deliveries,
+                     params.first_message_deliveries_decay,
+                     zero);
+        decayCounter(t.mesh_message_deliveries,
+                     params.mesh_message_deliveries_decay,
+                     zero);
+        decayCounter(
+            t.mesh_failure_penalty, params.mesh_failure_penalty_decay, zero);
+        decayCounter(t.invalid_message_deliveries,
+                     params.invalid_message_deliveries_decay,
+                     zero);
+        t.score = topicScore(t);
+        s.topics_score += t.score;
+      }
+      decayCounter(s.behaviour_penalty, config_.behaviour_penalty_decay, zero);
+      updatePeer(s);
+    }
+  }
+
+}  // namespace libp2p::protocol::gossip
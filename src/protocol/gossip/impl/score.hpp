@@ -0,0 +1,143 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <deque>
+#include <unordered_map>
+
+#include "common.hpp"
+
+namespace libp2p::protocol::gossip {
+
+  /**
+   * Gossipsub v1.1 peer score. Counters are updated on events, and only
+   * the affected topic term is recomputed, so `score()` is a lookup.
+   * Time in mesh and decay are applied on heartbeat
+   */
+  class Score {
+   public:
+    /// Config is stored by reference, score is a part of GossipCore
+    explicit Score(const ScoreConfig &config);
+
+    bool enabled() const {
+      return config_.enabled;
+    }
+
+    /// Current score of peer, zero if unknown or scoring is disabled
+    double score(const peer::PeerId &peer) const;
+
+    /// Gossip must not be exchanged with the peer
+    bool belowGossipThreshold(const peer::PeerId &peer) const;
+
+    /// Flood published messages must not be sent to the peer
+    bool belowPublishThreshold(const peer::PeerId &peer) const;
+
+    /// RPCs of the peer must be ignored
+    bool graylisted(const peer::PeerId &peer) const;
+
+    /// Peer connected from address (for P6)
+    void connected(const peer::PeerId &peer,
+                   const boost::optional<std::string> &ip);
+
+    /// Peer disconnected, its score is retained for a while
+    void disconnected(const peer::PeerId &peer, Time now);
+
+    /// Peer added to mesh
+    void graft(const peer::PeerId &peer, const TopicId &topic, Time now);
+
+    /// Peer removed from mesh, delivery deficit becomes penalty (P3b)
+    void prune(const peer::PeerId &peer, const TopicId &topic);
+
+    /// Peer delivered valid message first (P2, P3)
+    void firstDelivery(const peer::PeerId &peer,
+                       const TopicId &topic,
+                       const MessageId &msg_id,
+                       Time now);
+
+    /// Peer delivered already seen message (P3 if within window)
+    void duplicateDelivery(const peer::PeerId &peer,
+                           const TopicId &topic,
+                           const MessageId &msg_id,
+                           Time now);
+
+    /// Peer delivered invalid message (P4)
+    void invalidMessage(const peer::PeerId &peer, const TopicId &topic);
+
+    /// Sets application specific score (P5)
+    void setAppScore(const peer::PeerId &peer, double value);
+
+    /// Adds behaviour penalty (P7)
+    void addPenalty(const peer::PeerId &peer, double count);
+
+    /// Updates time in mesh, decays counters once per decay interval
+    void onHeartbeat(Time now);
+
+   private:
+    struct TopicStats {
+      const TopicScoreParams *params;
+      bool in_mesh = false;
+      Time graft_time{};
+      Time mesh_time{};
+      /// Mesh deliveries deficit is counted after activation interval
+      bool mesh_active = false;
+      double first_message_deliveries = 0;
+      double mesh_message_deliveries = 0;
+      double mesh_failure_penalty = 0;
+      double invalid_message_deliveries = 0;
+      /// Weighted term of the topic in peer score
+      double score = 0;
+    };
+
+    struct PeerStats {
+      std::unordered_map<TopicId, TopicStats> topics;
+      /// Sum of topic terms
+      double topics_score = 0;
+      double app_score = 0;
+      double behaviour_penalty = 0;
+      /// Ip address while connected
+      boost::optional<std::string> ip;
+      /// Disconnected peers are forgotten after this time
+      boost::optional<Time> expires;
+      double score = 0;
+    };
+
+    /// Peers delivered message within window since its first delivery
+    struct Delivery {
+      Time window_ends;
+      std::vector<peer::PeerId> peers;
+    };
+
+    const TopicScoreParams &params(const TopicId &topic) const;
+    PeerStats &stats(const peer::PeerId &peer);
+    TopicStats &topicStats(PeerStats &stats, const TopicId &topic);
+    double topicScore(const TopicStats &topic) const;
+
+    /// Recomputes term of one topic
+    void updateTopic(PeerStats &stats, TopicStats &topic);
+
+    /// Recomputes peer score from topic terms and P5-P7
+    void updatePeer(PeerStats &stats);
+
+    void addMeshDelivery(TopicStats &topic);
+
+    /// Removes peer from peers sharing its ip
+    void leaveIp(const peer::PeerId &peer, PeerStats &stats);
+
+    /// Updates P6 of peers sharing the ip
+    void updateIp(const std::string &ip);
+
+    void decay();
+
+    const ScoreConfig &config_;
+    std::unordered_map<peer::PeerId, PeerStats> peers_;
+    std::unordered_map<std::string, std::vector<peer::PeerId>> ips_;
+    std::unordered_map<MessageId, Delivery> deliveries_;
+    std::deque<std::pair<Time, MessageId>> deliveries_expiration_;
+    boost::optional<Time> next_decay_;
+  };
+
+}  // namespace libp2p::protocol::gossip
@@ -0,0 +1,85 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "seen_filter.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <string_view>
+
+namespace libp2p::protocol::gossip {
+
+  SeenFilter::SeenFilter(size_t history_length,
+                         size_t capacity,
+                         double false_positive_rate)
+      : shifts_per_bucket_{
+          (std::max<size_t>(history_length, 1) + kMaxBuckets - 2)
+          / (kMaxBuckets - 1)} {
+    assert(false_positive_rate > 0 and false_positive_rate < 1);
+    // the last bucket is being filled, the rest cover history
+    auto buckets =
+        std::min(kMaxBuckets, std::max<size_t>(history_length, 1) + 1);
+    auto per_bucket = std::max<double>(
+        static_cast<double>(capacity) * static_cast<double>(shifts_per_bucket_)
+            / static_cast<double>(std::max<size_t>(history_length, 1)),
+        1);
+    // lookup checks all buckets, so their rates add up
+    auto rate = false_positive_rate / static_cast<double>(buckets);
+    auto ln2 = std::log(2.0);
+    auto bits = std::ceil(-per_bucket * std::log(rate) / (ln2 * ln2));
+    bucket_bits_ = (static_cast<size_t>(bits) + 63) / 64 * 64;
+    hash_count_ = std::max<size_t>(
+        std::lround(static_cast<double>(bucket_bits_) / per_bucket * ln2), 1);
+    buckets_.resize(buckets, std::vector<uint64_t>(bucket_bits_ / 64));
+  }
+
+  SeenFilter::Hashes SeenFilter::hash(const MessageId &id) {
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    std::string_view str{reinterpret_cast<const char *>(id.data()), id.size()};
+    uint64_t h1 = std::hash<std::string_view>{}(str);
+    // splitmix64 finalizer derives independent second hash
+    uint64_t h2 = h1 + 0x9e3779b97f4a7c15;
+    h2 = (h2 ^ (h2 >> 30)) * 0xbf58476d1ce4e5b9;
+    h2 = (h2 ^ (h2 >> 27)) * 0x94d049bb133111eb;
+    h2 ^= h2 >> 31;
+    return {h1, h2 | 1};
+  }
+
+  bool SeenFilter::contains(const MessageId &id) const {
+    auto [h1, h2] = hash(id);
+    return std::any_of(buckets_.begin(), buckets_.end(), [&](auto &bucket) {
+      auto h = h1;
+      for (size_t i = 0; i < hash_count_; ++i, h += h2) {
+        auto bit = h % bucket_bits_;
+        if ((bucket[bit / 64] & (uint64_t{1} << (bit % 64))) == 0) {
+          return false;
+        }
+      }
+      return true;
+    });
+  }
+
+  void SeenFilter::insert(const MessageId &id) {
+    auto [h1, h2] = hash(id);
+    auto &bucket = buckets_[current_];
+    auto h = h1;
+    for (size_t i = 0; i < hash_count_; ++i, h += h2) {
+      auto bit = h % bucket_bits_;
+      bucket[bit / 64] |= uint64_t{1} << (bit % 64);
+    }
+  }
+
+  void SeenFilter::shift() {
+    if (++shifts_ < shifts_per_bucket_) {
+      return;
+    }
+    shifts_ = 0;
+    current_ = (current_ + 1) % buckets_.size();
+    std::fill(buckets_[current_].begin(), buckets_[current_].end(), 0);
+  }
+
+}  // namespace libp2p::protocol::gossip
@@ -0,0 +1,61 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <vector>
+
+#include "common.hpp"
+
+namespace libp2p::protocol::gossip {
+
+  /**
+   * Probabilistic set of seen message ids: ring of Bloom filters, each
+   * filled during `shifts_per_bucket` shifts. Ids are remembered for at
+   * least `history_length` shifts, memory doesn't depend on id length.
+   * False positive rate of whole set is close to configured one while
+   * buckets are filled with no more than their share of `capacity`
+   */
+  class SeenFilter {
+   public:
+    static constexpr size_t kMaxBuckets = 4;
+
+    /**
+     * @param history_length shifts the id is remembered for
+     * @param capacity expected ids inserted during `history_length` shifts
+     * @param false_positive_rate of `contains` while within capacity
+     */
+    SeenFilter(size_t history_length,
+               size_t capacity,
+               double false_positive_rate);
+
+    /// Returns false if id was definitely not inserted
+    bool contains(const MessageId &id) const;
+
+    void insert(const MessageId &id);
+
+    /// Called every heartbeat, rotates buckets
+    void shift();
+
+   private:
+    struct Hashes {
+      uint64_t h1;
+      uint64_t h2;
+    };
+
+    static Hashes hash(const MessageId &id);
+
+    const size_t shifts_per_bucket_;
+    size_t bucket_bits_ = 0;
+    size_t hash_count_ = 0;
+    std::vector<std::vector<uint64_t>> buckets_;
+
+    /// Index of the bucket being filled
+    size_t current_ = 0;
+    size_t shifts_ = 0;
+  };
+
+}  // namespace libp2p::protocol::gossip
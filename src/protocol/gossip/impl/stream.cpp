@@ -6,12 +6,13 @@
 
 #include "stream.hpp"
 
+#include <algorithm>
 #include <cassert>
 
-#include <libp2p/basic/varint_reader.hpp>
-#include <libp2p/basic/write_return_size.hpp>
+#include <libp2p/basic/message_read_writer_error.hpp>
+#include <libp2p/basic/write.hpp>
+#include <libp2p/common/metrics/registry.hpp>
 
-#include "message_parser.hpp"
 #include "peer_context.hpp"
 
 #define TRACE_ENABLED 0
@@ -30,11 +31,13 @@ namespace libp2p::protocol::gossip {
         timeout_(config.rw_timeout_msec),
         scheduler_(scheduler),
         max_message_size_(config.max_message_size),
+        max_pending_bytes_(config.max_pending_bytes),
         feedback_(feedback),
         msg_receiver_(msg_receiver),
         stream_(std::move(stream)),
         peer_(std::move(peer)),
-        read_buffer_(std::make_shared<std::vector<uint8_t>>()) {
+        reader_(std::make_shared<basic::MessageBatchReader>(
+            stream_, max_message_size_)) {
     assert(feedback_);
     assert(stream_);
   }
@@ -45,87 +48,94 @@ namespace libp2p::protocol::gossip {
       return;
     }
 
-    TRACE("reading length from {}:{}", peer_->str, stream_id_);
+    TRACE("reading messages from {}:{}", peer_->str, stream_id_);
 
-    // clang-format off
-    libp2p::basic::VarintReader::readVarint(
-        stream_,
-        [self_wptr = weak_from_this(), this]
-            (outcome::result<multi::UVarint> varint) {
+    reader_->readMany(
+        [self_wptr = weak_from_this(),
+         this](outcome::result<basic::MessageBatchReader::Messages> res) {
           if (self_wptr.expired()) {
             return;
           }
-          onLengthRead(std::move(varint));
-        }
-    );
-    // clang-format on
+          onMessagesRead(res);
+        });
 
     reading_ = true;
   }
 
-  void Stream::onLengthRead(outcome::result<multi::UVarint> varint) {
+  void Stream::onMessagesRead(
+      outcome::result<basic::MessageBatchReader::Messages> res) {
     if (!reading_) {
       return;
     }
-    if (varint.has_error()) {
-      reading_ = false;
-      feedback_(peer_, varint.error());
-      return;
-    }
-    auto msg_len = varint.value().toUInt64();
 
-    TRACE("reading {} bytes from {}:{}", msg_len, peer_->str, stream_id_);
+    reading_ = false;
 
-    if (msg_len > max_message_size_) {
-      feedback_(peer_, Error::MESSAGE_SIZE_ERROR);
+    if (!res) {
+      feedback_(peer_,
+                res.error() == basic::MessageReadWriterError::MESSAGE_TOO_LONG
+                    ? make_error_code(Error::MESSAGE_SIZE_ERROR)
+                    : res.error());
       return;
     }
 
-    read_buffer_->resize(msg_len);
+    TRACE("read {} messages from {}:{}",
+          res.value().size(),
+          peer_->str,
+          stream_id_);
 
-    stream_->read(std::span(read_buffer_->data(), msg_len),
-                  msg_len,
-                  [self_wptr = weak_from_this(), this, buffer = read_buffer_](
-                      auto &&res) {
-                    if (self_wptr.expired()) {
-                      return;
-                    }
-                    onMessageRead(std::forward<decltype(res)>(res));
-                  });
-  }
+    for (auto &message : res.value()) {
+      if (!parser_.parse(message)) {
+        feedback_(peer_, Error::MESSAGE_PARSE_ERROR);
+        return;
+      }
 
-  void Stream::onMessageRead(outcome::result<size_t> res) {
-    if (!reading_) {
-      return;
+      parser_.dispatch(peer_, msg_receiver_);
+      if (closed_) {
+        return;
+      }
     }
 
-    reading_ = false;
-
-    if (!res) {
-      feedback_(peer_, res.error());
+    if (read_paused_) {
+      read_deferred_ = true;
       return;
     }
 
-    TRACE("read {} bytes from {}:{}", res.value(), peer_->str, stream_id_);
+    // reads again
+    read();
+  }
 
-    if (read_buffer_->size() != res.value()) {
-      feedback_(peer_, Error::MESSAGE_PARSE_ERROR);
-      return;
+  void Stream::pauseReading(bool pause) {
+    read_paused_ = pause;
+    if (!pause && read_deferred_ && !closed_) {
+      read_deferred_ = false;
+      read();
     }
+  }
 
-    MessageParser parser;
-    if (!parser.parse(*read_buffer_)) {
-      feedback_(peer_, Error::MESSAGE_PARSE_ERROR);
-      return;
+  namespace {
+    size_t totalSize(const SharedBuffers &buffers) {
+      size_t size = 0;
+      for (auto &buffer : buffers) {
+        size += buffer->size();
+      }
+      return size;
     }
 
-    parser.dispatch(peer_, msg_receiver_);
-
-    // reads again
-    read();
-  }
+    /// Forwards and gossip dropped for slow peers
+    void observeShed(size_t bytes) {
+      static auto &dropped = metrics::Registry::instance().counter(
+          "libp2p_gossip_dropped_bytes_total",
+          "Bytes of forwards and gossip dropped for slow peers");
+      static auto &rpcs = metrics::Registry::instance().counter(
+          "libp2p_gossip_dropped_rpcs_total",
+          "RPCs of forwards and gossip dropped for slow peers");
+      dropped.inc(bytes);
+      rpcs.inc();
+    }
+  }  // namespace
 
-  void Stream::write(outcome::result<SharedBuffer> serialization_res) {
+  void Stream::write(outcome::result<SharedBuffers> serialization_res,
+                     Lane lane) {
     if (closed_) {
       return;
     }
@@ -140,33 +150,66 @@ namespace libp2p::protocol::gossip {
       return;
     }
 
-    auto &buffer = serialization_res.value();
-    if (buffer->empty()) {
+    auto &buffers = serialization_res.value();
+    auto size = totalSize(buffers);
+    if (size == 0) {
       return;
     }
 
     if (writing_bytes_ > 0) {
-      pending_bytes_ += buffer->size();
-      pending_buffers_.emplace_back(std::move(buffer));
+      if (!shed(size, lane)) {
+        return;
+      }
+      pending_bytes_ += size;
+      pending_buffers_[static_cast<size_t>(lane)].emplace_back(
+          std::move(buffers));
     } else {
-      beginWrite(std::move(buffer));
+      beginWrite(std::move(buffers));
     }
   }
 
-  void Stream::beginWrite(SharedBuffer buffer) {
-    assert(buffer);
+  bool Stream::shed(size_t bytes, Lane lane) {
+    if (max_pending_bytes_ == 0) {
+      return true;
+    }
+    // the oldest RPCs of the least important lanes go first: lanes below
+    // the new RPC's one, down to and including forwards
+    auto first = std::max(static_cast<size_t>(lane) + 1,
+                          static_cast<size_t>(Lane::FORWARD));
+    for (auto i = kLanes - 1; i >= first; --i) {
+      auto &queue = pending_buffers_[i];
+      while (pending_bytes_ + bytes > max_pending_bytes_ && !queue.empty()) {
+        auto dropped = totalSize(queue.front());
+        queue.pop_front();
+        pending_bytes_ -= dropped;
+        observeShed(dropped);
+      }
+    }
+    if (pending_bytes_ + bytes <= max_pending_bytes_
+        || lane < Lane::FORWARD) {
+      return true;
+    }
+    TRACE("dropping {} bytes to slow {}:{}", bytes, peer_->str, stream_id_);
+    observeShed(bytes);
+    return false;
+  }
 
-    writing_bytes_ = buffer->size();
+  void Stream::beginWrite(SharedBuffers buffers) {
+    writing_bytes_ = totalSize(buffers);
 
     TRACE("writing {} bytes to {}:{}", writing_bytes_, peer_->str, stream_id_);
 
+    std::vector<BytesIn> spans;
+    spans.reserve(buffers.size());
+    for (auto &buffer : buffers) {
+      spans.emplace_back(*buffer);
+    }
     // clang-format off
-    BytesIn span{*buffer};
-    writeReturnSize(
+    writeVectored(
         stream_,
-        span,
-        [self_wptr = weak_from_this(), this, buffer = std::move(buffer)]
-            (outcome::result<size_t> result)
+        std::move(spans),
+        [self_wptr = weak_from_this(), this, buffers = std::move(buffers)]
+            (outcome::result<void> result)
         {
           if (self_wptr.expired() || closed_) {
             return;
@@ -177,7 +220,8 @@ namespace libp2p::protocol::gossip {
     // clang-format on
 
     if (timeout_ > std::chrono::milliseconds::zero()) {
-      timeout_handle_ = scheduler_.scheduleWithHandle(
+      scheduler_.arm(
+          timeout_timer_,
           [self_wptr = weak_from_this(), this] {
             if (self_wptr.expired() || closed_) {
               return;
@@ -188,7 +232,7 @@ namespace libp2p::protocol::gossip {
     }
   }
 
-  void Stream::onMessageWritten(outcome::result<size_t> res) {
+  void Stream::onMessageWritten(outcome::result<void> res) {
     if (writing_bytes_ == 0) {
       return;
     }
@@ -198,35 +242,42 @@ namespace libp2p::protocol::gossip {
       return;
     }
 
-    TRACE("written {} bytes to {}:{}", res.value(), peer_->str, stream_id_);
-
-    if (writing_bytes_ != res.value()) {
-      feedback_(peer_, Error::MESSAGE_WRITE_ERROR);
-      return;
-    }
+    TRACE("written {} bytes to {}:{}", writing_bytes_, peer_->str, stream_id_);
 
     endWrite();
 
-    if (!pending_buffers_.empty()) {
-      SharedBuffer &buffer = pending_buffers_.front();
-      pending_bytes_ -= buffer->size();
-      beginWrite(std::move(buffer));
-      pending_buffers_.pop_front();
+    for (auto &queue : pending_buffers_) {
+      if (!queue.empty()) {
+        SharedBuffers buffers = std::move(queue.front());
+        queue.pop_front();
+        pending_bytes_ -= totalSize(buffers);
+        beginWrite(std::move(buffers));
+        return;
+      }
     }
+
+    // writable again, messages queued meanwhile may be flushed
+    feedback_(peer_, Success{});
+  }
+
+  bool Stream::isWriting() const {
+    return writing_bytes_ > 0;
   }
 
   void Stream::asyncPostError(Error error) {
-    scheduler_.schedule([this, self_wptr = weak_from_this(), error] {
-      if (self_wptr.expired() || closed_) {
-        return;
-      }
-      feedback_(peer_, error);
-    });
+    scheduler_.schedule(
+        [this, self_wptr = weak_from_this(), error] {
+          if (self_wptr.expired() || closed_) {
+            return;
+          }
+          feedback_(peer_, error);
+        },
+        basic::Scheduler::Priority::IO);
   }
 
   void Stream::endWrite() {
     writing_bytes_ = 0;
-    timeout_handle_.reset();
+    timeout_timer_.cancel();
   }
 
   void Stream::close() {
@@ -6,14 +6,16 @@
 
 #pragma once
 
+#include <array>
 #include <deque>
 
+#include <libp2p/basic/message_batch_reader.hpp>
 #include <libp2p/basic/scheduler.hpp>
 #include <libp2p/common/metrics/instance_count.hpp>
 #include <libp2p/connection/stream.hpp>
-#include <libp2p/multi/uvarint.hpp>
 
 #include "common.hpp"
+#include "message_parser.hpp"
 
 namespace libp2p::protocol::gossip {
 
@@ -41,46 +43,70 @@ namespace libp2p::protocol::gossip {
     /// Begins reading messages from stream
     void read();
 
+    /// Stops reading after the current batch of messages, resumes if paused
+    void pauseReading(bool pause);
+
     /// Writes an outgoing message to stream, if there is serialization error
-    /// it will be posted in asynchronous manner
-    void write(outcome::result<SharedBuffer> serialization_res);
+    /// it will be posted in asynchronous manner. Messages waiting for the
+    /// current write are queued by lane, so control goes out first
+    void write(outcome::result<SharedBuffers> serialization_res,
+               Lane lane = Lane::CONTROL);
+
+    /// Returns true if a write is in progress, the stream reports success
+    /// via feedback once all writes are done
+    bool isWriting() const;
 
     /// Closes the reader so that it will ignore further bytes from wire
     void close();
 
    private:
-    void onLengthRead(outcome::result<multi::UVarint> varint);
-    void onMessageRead(outcome::result<size_t> res);
-    void beginWrite(SharedBuffer buffer);
-    void onMessageWritten(outcome::result<size_t> res);
+    void onMessagesRead(
+        outcome::result<basic::MessageBatchReader::Messages> res);
+    void beginWrite(SharedBuffers buffers);
+    void onMessageWritten(outcome::result<void> res);
     void endWrite();
     void asyncPostError(Error error);
 
+    /// Drops queued forwards and gossip of lanes below `lane` to fit `bytes`
+    /// into pending bytes limit, returns false if the new RPC is dropped
+    /// instead
+    bool shed(size_t bytes, Lane lane);
+
     [[maybe_unused]] const size_t stream_id_;
     const Time timeout_;
     basic::Scheduler &scheduler_;
     const size_t max_message_size_;
+    const size_t max_pending_bytes_;
     const Feedback &feedback_;
     MessageReceiver &msg_receiver_;
     std::shared_ptr<connection::Stream> stream_;
     PeerContextPtr peer_;
 
-    std::deque<SharedBuffer> pending_buffers_;
+    /// RPCs waiting for the current write, by lane
+    std::array<std::deque<SharedBuffers>, kLanes> pending_buffers_;
 
     /// Number of bytes being awaited in active wrote operation
     size_t writing_bytes_ = 0;
 
-    // TODO(artem): limit pending bytes and close slow streams that way
+    /// Bytes in all lanes of pending_buffers_
     size_t pending_bytes_ = 0;
 
-    std::shared_ptr<Bytes> read_buffer_;
+    /// Delivers all messages received at once
+    std::shared_ptr<basic::MessageBatchReader> reader_;
+
+    /// Reused for all messages, so that its arena is allocated once
+    MessageParser parser_;
     /// Dont send feedback or schedule writes anymore
     bool closed_ = false;
 
     bool reading_ = false;
 
-    /// Handle for current operation timeout guard
-    basic::Scheduler::Handle timeout_handle_;
+    /// Next message is read after reading is resumed
+    bool read_paused_ = false;
+    bool read_deferred_ = false;
+
+    /// Current operation timeout guard
+    basic::Timer timeout_timer_;
 
    public:
     LIBP2P_METRICS_INSTANCE_COUNT_IF_ENABLED(libp2p::protocol::gossip::Stream);
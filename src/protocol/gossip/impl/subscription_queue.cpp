@@ -0,0 +1,108 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/protocol/gossip/subscription_queue.hpp>
+
+namespace libp2p::protocol::gossip {
+
+  SubscriptionQueue::SubscriptionQueue(Config config)
+      : config_{config}, queue_{config.capacity} {}
+
+  bool SubscriptionQueue::tryPop(MessagePtr &msg) {
+    if (!queue_.tryPop(msg)) {
+      return false;
+    }
+    popped();
+    return true;
+  }
+
+  bool SubscriptionQueue::pop(MessagePtr &msg) {
+    while (true) {
+      auto version = version_.load(std::memory_order_acquire);
+      if (tryPop(msg)) {
+        return true;
+      }
+      if (closed_.load()) {
+        return false;
+      }
+      version_.wait(version, std::memory_order_acquire);
+    }
+  }
+
+  size_t SubscriptionQueue::size() const {
+    return size_.load(std::memory_order_relaxed);
+  }
+
+  size_t SubscriptionQueue::dropped() const {
+    return dropped_.load(std::memory_order_relaxed);
+  }
+
+  bool SubscriptionQueue::closed() const {
+    return closed_.load();
+  }
+
+  SubscriptionQueue::PushResult SubscriptionQueue::push(MessagePtr msg) {
+    if (closed_.load()) {
+      return PushResult::DROPPED;
+    }
+    // counted before push, so that size is never less than actual
+    size_.fetch_add(1);
+    if (!queue_.tryPush(std::move(msg))) {
+      MessagePtr oldest;
+      if (config_.overflow != Overflow::DROP_OLDEST
+          || !queue_.tryPop(oldest)) {
+        size_.fetch_sub(1);
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return PushResult::DROPPED;
+      }
+      dropped_.fetch_add(1, std::memory_order_relaxed);
+      if (!queue_.tryPush(std::move(msg))) {
+        // freed cell may only be taken by another producer
+        size_.fetch_sub(2);
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return PushResult::DROPPED;
+      }
+      size_.fetch_sub(1);
+    }
+    notify();
+
+    if (config_.overflow != Overflow::PAUSE_READING
+        || size_.load() < queue_.capacity() || paused_.exchange(true)) {
+      return PushResult::PUSHED;
+    }
+    // consumers may have drained queue before the flag was set
+    if (size_.load() <= queue_.capacity() / 2 && paused_.exchange(false)) {
+      return PushResult::PUSHED;
+    }
+    return PushResult::PAUSE;
+  }
+
+  void SubscriptionQueue::close() {
+    closed_.store(true);
+    notify();
+    if (paused_.exchange(false) && resume_) {
+      resume_();
+    }
+  }
+
+  void SubscriptionQueue::onResume(std::function<void()> resume) {
+    resume_ = std::move(resume);
+  }
+
+  void SubscriptionQueue::popped() {
+    auto size = size_.fetch_sub(1) - 1;
+    if (paused_.load() && size <= queue_.capacity() / 2
+        && paused_.exchange(false) && resume_) {
+      resume_();
+    }
+  }
+
+  void SubscriptionQueue::notify() {
+    version_.fetch_add(1, std::memory_order_release);
+    version_.notify_all();
+  }
+
+}  // namespace libp2p::protocol::gossip
@@ -0,0 +1,53 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "topic_metrics.hpp"
+
+#include <algorithm>
+
+namespace libp2p::protocol::gossip {
+
+  LatencyCounts::LatencyCounts()
+      : counts_(metrics::latencyBuckets().size() + 1) {}
+
+  void LatencyCounts::observe(std::chrono::steady_clock::duration latency) {
+    auto &bounds = metrics::latencyBuckets();
+    auto seconds = std::chrono::duration<double>(latency).count();
+    auto bucket = std::lower_bound(bounds.begin(), bounds.end(), seconds)
+                - bounds.begin();
+    ++counts_[bucket];
+    sum_ += seconds;
+  }
+
+  metrics::Histogram::Snapshot LatencyCounts::snapshot() const {
+    metrics::Histogram::Snapshot snapshot{
+        .bounds = metrics::latencyBuckets(),
+        .counts = std::vector<uint64_t>(counts_.size()),
+        .sum = sum_,
+    };
+    uint64_t total = 0;
+    for (size_t i = 0; i < counts_.size(); ++i) {
+      total += counts_[i];
+      snapshot.counts[i] = total;
+    }
+    return snapshot;
+  }
+
+  Gossip::TopicStats TopicMetrics::stats(size_t mesh_size) const {
+    return {
+        .received = received,
+        .delivered = delivered,
+        .duplicates = duplicates,
+        .invalid = invalid,
+        .bytes_in = bytes_in,
+        .bytes_out = bytes_out,
+        .mesh_size = mesh_size,
+        .validation_latency = validation_latency.snapshot(),
+        .first_delivery_latency = first_delivery_latency.snapshot(),
+    };
+  }
+
+}  // namespace libp2p::protocol::gossip
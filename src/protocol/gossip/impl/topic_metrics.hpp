@@ -0,0 +1,53 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <chrono>
+#include <vector>
+
+#include "common.hpp"
+
+namespace libp2p::protocol::gossip {
+
+  /**
+   * Latency distribution over metrics::latencyBuckets(), plain counts
+   * instead of atomics of metrics::Histogram, so that it is movable and
+   * cheap to update from one thread
+   */
+  class LatencyCounts {
+   public:
+    LatencyCounts();
+
+    void observe(std::chrono::steady_clock::duration latency);
+
+    metrics::Histogram::Snapshot snapshot() const;
+
+   private:
+    /// Count per bucket, not cumulative, the last one is +Inf
+    std::vector<uint64_t> counts_;
+    double sum_ = 0;
+  };
+
+  /**
+   * Delivery counters of topic, kept in its TopicSubscriptions, so that the
+   * message is counted with a few increments, without lookups by name.
+   * Not thread-safe, updated from the io context thread
+   */
+  struct TopicMetrics {
+    uint64_t received = 0;
+    uint64_t delivered = 0;
+    uint64_t duplicates = 0;
+    uint64_t invalid = 0;
+    uint64_t bytes_in = 0;
+    uint64_t bytes_out = 0;
+    LatencyCounts validation_latency;
+    LatencyCounts first_delivery_latency;
+
+    Gossip::TopicStats stats(size_t mesh_size) const;
+  };
+
+}  // namespace libp2p::protocol::gossip
@@ -11,6 +11,7 @@
 
 #include "connectivity.hpp"
 #include "message_builder.hpp"
+#include "score.hpp"
 
 namespace libp2p::protocol::gossip {
 
@@ -32,10 +33,12 @@ namespace libp2p::protocol::gossip {
   TopicSubscriptions::TopicSubscriptions(TopicId topic,
                                          const Config &config,
                                          Connectivity &connectivity,
+                                         Score &score,
                                          log::SubLogger &log)
       : topic_(std::move(topic)),
         config_(config),
         connectivity_(connectivity),
+        score_(score),
         self_subscribed_(false),
         fanout_period_ends_(0),
         log_(log) {}
@@ -64,18 +67,37 @@ namespace libp2p::protocol::gossip {
     auto origin = peerFrom(*msg);
 
     mesh_peers_.selectAll(
-        [this, &msg, &msg_id, &from, &origin](const PeerContextPtr &ctx) {
+        [this, &msg, &msg_id, &from, &origin, now, is_published_locally](
+            const PeerContextPtr &ctx) {
           assert(ctx->message_builder);
 
-          if (needToForward(ctx, from, origin)) {
-            ctx->message_builder->addMessage(*msg, msg_id);
+          if (needToForward(ctx, from, origin)
+              && !ctx->dontWant(msg_id, now)) {
+            ctx->message_builder->addMessage(
+                *msg, msg_id, is_published_locally);
+            metrics_.bytes_out += msg->data.size();
 
             // forward immediately to those in mesh
             connectivity_.peerIsWritable(ctx, true);
           }
         });
 
-    auto peers = subscribed_peers_.selectRandomPeers(config_.D_max * 2);
+    if (is_published_locally && config_.flood_publish) {
+      subscribed_peers_.selectIf(
+          [this, &msg, &msg_id](const PeerContextPtr &ctx) {
+            ctx->message_builder->addMessage(*msg, msg_id, true);
+            metrics_.bytes_out += msg->data.size();
+            connectivity_.peerIsWritable(ctx, true);
+          },
+          [this](const PeerContextPtr &ctx) {
+            return !score_.belowPublishThreshold(ctx->peer_id);
+          });
+    }
+
+    auto peers = subscribed_peers_.selectRandomPeers(
+        config_.D_max * 2, [this](const PeerContextPtr &ctx) {
+          return !score_.belowGossipThreshold(ctx->peer_id);
+        });
     for (const auto &ctx : peers) {
       assert(ctx->message_builder);
 
@@ -95,33 +117,64 @@ namespace libp2p::protocol::gossip {
                subscribed_peers_.size());
   }
 
+  void TopicSubscriptions::sendDontWant(const PeerContextPtr &from,
+                                        const MessageId &msg_id) {
+    mesh_peers_.selectAll([this, &from, &msg_id](const PeerContextPtr &ctx) {
+      if (ctx->peer_id == from->peer_id) {
+        return;
+      }
+      ctx->message_builder->addIDontWant(msg_id);
+      connectivity_.peerIsWritable(ctx, true);
+    });
+  }
+
   void TopicSubscriptions::onHeartbeat(Time now) {
     if (self_subscribed_ && !subscribed_peers_.empty()) {
       // add/remove mesh members according to desired network density D
+      if (score_.enabled()) {
+        // peers with negative score are not kept in mesh
+        mesh_peers_.eraseIf([this](const PeerContextPtr &p) {
+          if (score_.score(p->peer_id) >= 0) {
+            return false;
+          }
+          removeFromMesh(p);
+          return true;
+        });
+      }
+
       size_t sz = mesh_peers_.size();
 
       if (sz < config_.D_min) {
-        auto peers = subscribed_peers_.selectRandomPeers(config_.D_min - sz);
+        auto peers = subscribed_peers_.selectRandomPeers(
+            config_.D_min - sz,
+            [this, now](const PeerContextPtr &p) { return canGraft(p, now); });
         for (auto &p : peers) {
-          auto it = dont_bother_until_.find(p);
-          if (it != dont_bother_until_.end()) {
-            if (it->second < now) {
-              dont_bother_until_.erase(it);
-            } else {
-              continue;
-            }
-          }
-
-          addToMesh(p);
+          addToMesh(p, now);
           subscribed_peers_.erase(p->peer_id);
         }
       } else if (sz > config_.D_max) {
-        auto peers = mesh_peers_.selectRandomPeers(sz - config_.D_max);
+        std::vector<PeerContextPtr> peers;
+        if (score_.enabled()) {
+          // prune the lowest scored peers
+          mesh_peers_.selectAll(
+              [&peers](const PeerContextPtr &p) { peers.push_back(p); });
+          std::sort(peers.begin(),
+                    peers.end(),
+                    [this](const PeerContextPtr &a, const PeerContextPtr &b) {
+                      return score_.score(a->peer_id)
+                           < score_.score(b->peer_id);
+                    });
+          peers.resize(sz - config_.D_max);
+        } else {
+          peers = mesh_peers_.selectRandomPeers(sz - config_.D_max);
+        }
         for (auto &p : peers) {
           removeFromMesh(p);
           mesh_peers_.erase(p->peer_id);
         }
       }
+
+      opportunisticGraft(now);
     }
 
     // fanout ends some time after this host ends publishing to the topic,
@@ -186,17 +239,26 @@ namespace libp2p::protocol::gossip {
     auto res = subscribed_peers_.erase(p->peer_id);
     if (!res) {
       res = mesh_peers_.erase(p->peer_id);
+      if (res) {
+        score_.prune(p->peer_id, topic_);
+      }
     }
     dont_bother_until_.erase(p);
   }
 
-  void TopicSubscriptions::onGraft(const PeerContextPtr &p) {
+  void TopicSubscriptions::onGraft(const PeerContextPtr &p, Time now) {
     auto res = mesh_peers_.find(p->peer_id);
     if (res) {
       // already there
       return;
     }
 
+    auto backoff = dont_bother_until_.find(p);
+    if (backoff != dont_bother_until_.end() && backoff->second >= now) {
+      // graft during prune backoff is a misbehaviour
+      score_.addPenalty(p->peer_id, 1);
+    }
+
     if (!subscribed_peers_.contains(p->peer_id)) {
       // subscribe first
       p->subscribed_to.insert(topic_);
@@ -205,31 +267,103 @@ namespace libp2p::protocol::gossip {
 
     bool mesh_is_full = (mesh_peers_.size() >= config_.D_max);
 
-    if (self_subscribed_ && !mesh_is_full) {
+    if (self_subscribed_ && !mesh_is_full && canGraft(p, now)) {
       mesh_peers_.insert(p);
       subscribed_peers_.erase(p->peer_id);
+      score_.graft(p->peer_id, topic_, now);
     } else {
       // we don't have mesh for the topic
-      p->message_builder->addPrune(topic_);
-      connectivity_.peerIsWritable(p, true);
+      sendPrune(p, true);
     }
   }
 
   void TopicSubscriptions::onPrune(const PeerContextPtr &p,
                                    Time dont_bother_until) {
-    mesh_peers_.erase(p->peer_id);
+    if (mesh_peers_.erase(p->peer_id)) {
+      score_.prune(p->peer_id, topic_);
+    }
     if (p->subscribed_to.count(topic_) != 0) {
       subscribed_peers_.insert(p);
       dont_bother_until_.insert({p, dont_bother_until});
     }
   }
 
-  void TopicSubscriptions::addToMesh(const PeerContextPtr &p) {
+  void TopicSubscriptions::sendPrune(const PeerContextPtr &p,
+                                     bool low_latency) {
+    std::vector<PeerContextPtr> px;
+    // peers with negative score don't get peer exchange
+    if (config_.prune_peers != 0 && score_.score(p->peer_id) >= 0) {
+      auto suggest = [this, &p](const PeerContextPtr &ctx) {
+        return ctx != p && score_.score(ctx->peer_id) >= 0;
+      };
+      px = mesh_peers_.selectRandomPeers(config_.prune_peers, suggest);
+      if (px.size() < config_.prune_peers) {
+        auto more = subscribed_peers_.selectRandomPeers(
+            config_.prune_peers - px.size(), suggest);
+        px.insert(px.end(), more.begin(), more.end());
+      }
+    }
+    p->message_builder->addPrune(topic_, px);
+    connectivity_.peerIsWritable(p, low_latency);
+  }
+
+  bool TopicSubscriptions::canGraft(const PeerContextPtr &p, Time now) {
+    auto it = dont_bother_until_.find(p);
+    if (it != dont_bother_until_.end()) {
+      if (it->second >= now) {
+        return false;
+      }
+      dont_bother_until_.erase(it);
+    }
+    return score_.score(p->peer_id) >= 0;
+  }
+
+  void TopicSubscriptions::opportunisticGraft(Time now) {
+    auto &config = config_.score;
+    if (!score_.enabled() || config.opportunistic_graft_ticks == 0) {
+      return;
+    }
+    if (++heartbeats_ < config.opportunistic_graft_ticks) {
+      return;
+    }
+    heartbeats_ = 0;
+    if (mesh_peers_.size() < 2) {
+      return;
+    }
+
+    std::vector<double> scores;
+    mesh_peers_.selectAll([this, &scores](const PeerContextPtr &p) {
+      scores.push_back(score_.score(p->peer_id));
+    });
+    auto middle = scores.begin() + static_cast<ptrdiff_t>(scores.size() / 2);
+    std::nth_element(scores.begin(), middle, scores.end());
+    auto median = *middle;
+    if (median >= config.opportunistic_graft_threshold) {
+      return;
+    }
+
+    auto peers = subscribed_peers_.selectRandomPeers(
+        config.opportunistic_graft_peers,
+        [this, now, median](const PeerContextPtr &p) {
+          return score_.score(p->peer_id) > median && canGraft(p, now);
+        });
+    for (auto &p : peers) {
+      addToMesh(p, now);
+      subscribed_peers_.erase(p->peer_id);
+    }
+    log_.debug("opportunistic graft of {} peers, median score {} for {}",
+               peers.size(),
+               median,
+               topic_);
+  }
+
+  void TopicSubscriptions::addToMesh(const PeerContextPtr &p, Time now) {
     assert(p->message_builder);
 
     p->message_builder->addGraft(topic_);
     connectivity_.peerIsWritable(p, false);
     mesh_peers_.insert(p);
+    score_.graft(p->peer_id, topic_, now);
     log_.debug("peer {} added to mesh (size={}) for topic {}",
                p->str,
                mesh_peers_.size(),
@@ -239,9 +373,9 @@ namespace libp2p::protocol::gossip {
   void TopicSubscriptions::removeFromMesh(const PeerContextPtr &p) {
     assert(p->message_builder);
 
-    p->message_builder->addPrune(topic_);
-    connectivity_.peerIsWritable(p, false);
+    sendPrune(p, false);
     subscribed_peers_.insert(p);
+    score_.prune(p->peer_id, topic_);
     log_.debug("peer {} removed from mesh (size={}) for topic {}",
                p->str,
                mesh_peers_.size(),
@@ -11,10 +11,12 @@
 #include <libp2p/log/sublogger.hpp>
 
 #include "peer_set.hpp"
+#include "topic_metrics.hpp"
 
 namespace libp2p::protocol::gossip {
 
   class Connectivity;
+  class Score;
 
   /// Per-topic subscriptions
   class TopicSubscriptions {
@@ -24,6 +26,7 @@ namespace libp2p::protocol::gossip {
     TopicSubscriptions(TopicId topic,
                        const Config &config,
                        Connectivity &connectivity,
+                       Score &score,
                        log::SubLogger &log);
 
     /// Returns true if no peers subscribed and not self-subscribed and
@@ -36,6 +39,9 @@ namespace libp2p::protocol::gossip {
                       const MessageId &msg_id,
                       Time now);
 
+    /// Sends IDONTWANT for message to mesh members except the sender
+    void sendDontWant(const PeerContextPtr &from, const MessageId &msg_id);
+
     /// Periodic job needed to update meshes and shift "I have" caches
     void onHeartbeat(Time now);
 
@@ -49,21 +55,40 @@ namespace libp2p::protocol::gossip {
     void onPeerUnsubscribed(const PeerContextPtr &p);
 
     /// Remote peer includes this host into its mesh
-    void onGraft(const PeerContextPtr &p);
+    void onGraft(const PeerContextPtr &p, Time now);
 
     /// Remote peer kicks this host out of its mesh
     void onPrune(const PeerContextPtr &p, Time dont_bother_until);
 
+    /// Delivery counters of topic
+    TopicMetrics &metrics() {
+      return metrics_;
+    }
+
+    Gossip::TopicStats stats() const {
+      return metrics_.stats(mesh_peers_.size());
+    }
+
    private:
     /// Adds a peer to mesh
-    void addToMesh(const PeerContextPtr &p);
+    void addToMesh(const PeerContextPtr &p, Time now);
 
     /// Removes a peer from mesh
     void removeFromMesh(const PeerContextPtr &p);
 
+    /// Sends prune with other peers of topic suggested instead of this host
+    void sendPrune(const PeerContextPtr &p, bool low_latency);
+
+    /// Peer can be grafted: not in prune backoff and score is not negative
+    bool canGraft(const PeerContextPtr &p, Time now);
+
+    /// Grafts peers above median score if mesh score is low
+    void opportunisticGraft(Time now);
+
     const TopicId topic_;
     const Config &config_;
     Connectivity &connectivity_;
+    Score &score_;
 
     /// This host subscribed to this topic or not, this affects mesh behavior
     bool self_subscribed_;
@@ -83,6 +108,11 @@ namespace libp2p::protocol::gossip {
     /// Prune backoff times per peer
     std::unordered_map<PeerContextPtr, Time> dont_bother_until_;
 
+    /// Heartbeats since last opportunistic graft check
+    size_t heartbeats_ = 0;
+
+    TopicMetrics metrics_;
+
     log::SubLogger &log_;
   };
 
@@ -28,12 +28,15 @@ namespace libp2p::protocol {
   }
 
   std::vector<multi::Multiaddress> Identify::getAllObservedAddresses() const {
-    return msg_processor_->getObservedAddresses().getAllAddresses();
+    auto addresses = msg_processor_->getObservedAddresses().getAllAddresses();
+    return {addresses.begin(), addresses.end()};
   }
 
   std::vector<multi::Multiaddress> Identify::getObservedAddressesFor(
       const multi::Multiaddress &address) const {
-    return msg_processor_->getObservedAddresses().getAddressesFor(address);
+    auto addresses =
+        msg_processor_->getObservedAddresses().getAddressesFor(address);
+    return {addresses.begin(), addresses.end()};
   }
 
   peer::ProtocolName Identify::getProtocolId() const {
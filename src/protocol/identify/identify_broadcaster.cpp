@@ -0,0 +1,112 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/protocol/identify/identify_broadcaster.hpp>
+
+#include <boost/assert.hpp>
+
+#include <libp2p/basic/write.hpp>
+#include <libp2p/protocol/identify/utils.hpp>
+
+namespace libp2p::protocol {
+  IdentifyBroadcaster::IdentifyBroadcaster(
+      Host &host,
+      network::ConnectionManager &conn_manager,
+      std::shared_ptr<basic::Scheduler> scheduler,
+      IdentifyBroadcastConfig config,
+      peer::ProtocolName protocol,
+      MakeMessage make_message)
+      : host_{host},
+        conn_manager_{conn_manager},
+        scheduler_{std::move(scheduler)},
+        config_{config},
+        protocol_{std::move(protocol)},
+        make_message_{std::move(make_message)} {
+    BOOST_ASSERT(config_.max_concurrent_streams != 0);
+    BOOST_ASSERT(make_message_);
+  }
+
+  void IdentifyBroadcaster::changed() {
+    if (timer_pending_) {
+      return;
+    }
+    if (scheduler_ == nullptr) {
+      return broadcast();
+    }
+    timer_pending_ = true;
+    timer_ = scheduler_->scheduleWithHandle(
+        [weak{weak_from_this()}] {
+          if (auto self = weak.lock()) {
+            self->timer_pending_ = false;
+            self->broadcast();
+          }
+        },
+        config_.debounce);
+  }
+
+  void IdentifyBroadcaster::broadcast() {
+    if (inflight_ != 0 or not queue_.empty()) {
+      dirty_ = true;
+      return;
+    }
+    dirty_ = false;
+    message_ = make_message_();
+    if (message_ == nullptr) {
+      return;
+    }
+    for (auto &peer : detail::getActivePeers(host_, conn_manager_)) {
+      queue_.emplace_back(std::move(peer));
+    }
+    sendNext();
+  }
+
+  void IdentifyBroadcaster::sendNext() {
+    while (inflight_ < config_.max_concurrent_streams and not queue_.empty()) {
+      auto peer = std::move(queue_.front());
+      queue_.pop_front();
+      ++inflight_;
+      host_.newStream(
+          peer,
+          {protocol_},
+          [self{shared_from_this()}, message{message_}](auto &&stream_res) {
+            if (not stream_res) {
+              return self->sent();
+            }
+            self->send(std::move(stream_res.value().stream), message);
+          });
+    }
+    if (dirty_ and inflight_ == 0 and queue_.empty()) {
+      broadcast();
+    }
+  }
+
+  void IdentifyBroadcaster::send(std::shared_ptr<connection::Stream> stream,
+                                 std::shared_ptr<const Bytes> message) {
+    // message is kept alive by the callback until write completes
+    BytesIn bytes{*message};
+    libp2p::write(
+        stream,
+        bytes,
+        [self{shared_from_this()}, stream, message](
+            outcome::result<void> res) {
+          if (not res) {
+            self->log_->debug("cannot write {} message: {}",
+                              self->protocol_,
+                              res.error());
+            stream->reset();
+          } else {
+            stream->close([](outcome::result<void>) {});
+          }
+          self->sent();
+        });
+  }
+
+  void IdentifyBroadcaster::sent() {
+    BOOST_ASSERT(inflight_ != 0);
+    --inflight_;
+    sendNext();
+  }
+}  // namespace libp2p::protocol
@@ -21,7 +21,18 @@ namespace libp2p::protocol {
   IdentifyDelta::IdentifyDelta(Host &host,
                                network::ConnectionManager &conn_manager,
                                event::Bus &bus)
-      : host_{host}, conn_manager_{conn_manager}, bus_{bus} {}
+      : IdentifyDelta{host, conn_manager, bus, nullptr} {}
+
+  IdentifyDelta::IdentifyDelta(Host &host,
+                               network::ConnectionManager &conn_manager,
+                               event::Bus &bus,
+                               std::shared_ptr<basic::Scheduler> scheduler,
+                               IdentifyBroadcastConfig config)
+      : host_{host},
+        conn_manager_{conn_manager},
+        bus_{bus},
+        scheduler_{std::move(scheduler)},
+        config_{config} {}
 
   peer::ProtocolName IdentifyDelta::getProtocolId() const {
     return kIdentifyDeltaProtocol;
@@ -38,12 +49,25 @@ namespace libp2p::protocol {
   }
 
   void IdentifyDelta::start() {
+    broadcaster_ = std::make_shared<IdentifyBroadcaster>(
+        host_,
+        conn_manager_,
+        scheduler_,
+        config_,
+        kIdentifyDeltaProtocol,
+        [weak{weak_from_this()}]() -> std::shared_ptr<const Bytes> {
+          if (auto self = weak.lock()) {
+            return self->makeDelta();
+          }
+          return nullptr;
+        });
+
     new_protos_sub_ =
         bus_.getChannel<event::network::ProtocolsAddedChannel>().subscribe(
             [self{weak_from_this()}](
                 std::vector<peer::ProtocolName> new_protos) {
               if (auto s = self.lock()) {
-                return self.lock()->sendDelta(
+                return s->protocolsChanged(
                     new_protos, std::span<const peer::ProtocolName>());
               }
             });
@@ -52,7 +76,7 @@ namespace libp2p::protocol {
             [self{weak_from_this()}](
                 std::vector<peer::ProtocolName> rm_protos) {
               if (auto s = self.lock()) {
-                return self.lock()->sendDelta(
+                return s->protocolsChanged(
                     std::span<const peer::ProtocolName>(), rm_protos);
               }
             });
@@ -132,40 +156,34 @@ namespace libp2p::protocol {
     }
   }
 
-  void IdentifyDelta::sendDelta(std::span<const peer::ProtocolName> added,
-                                std::span<const peer::ProtocolName> removed) {
-    auto msg = std::make_shared<identify::pb::Identify>();
+  void IdentifyDelta::protocolsChanged(
+      std::span<const peer::ProtocolName> added,
+      std::span<const peer::ProtocolName> removed) {
     for (const auto &proto : added) {
-      msg->mutable_delta()->add_added_protocols(proto);
+      removed_.erase(proto);
+      added_.insert(proto);
     }
     for (const auto &proto : removed) {
-      msg->mutable_delta()->add_rm_protocols(proto);
+      added_.erase(proto);
+      removed_.insert(proto);
     }
-
-    detail::streamToEachConnectedPeer(
-        host_,
-        conn_manager_,
-        {kIdentifyDeltaProtocol},
-        [self{shared_from_this()}, msg](auto s_res) {
-          if (!s_res) {
-            return;
-          }
-          self->sendDelta(std::move(s_res.value().stream), msg);
-        });
+    broadcaster_->changed();
   }
 
-  void IdentifyDelta::sendDelta(
-      std::shared_ptr<connection::Stream> stream,
-      const std::shared_ptr<identify::pb::Identify> &msg) const {
-    auto rw = std::make_shared<basic::ProtobufMessageReadWriter>(stream);
-    rw->write<identify::pb::Identify>(
-        *msg, [self{shared_from_this()}, s = std::move(stream)](auto &&res) {
-          if (!res) {
-            self->log_->error("cannot write Identify-Delta to peer {}, {}: {}",
-                              s->remotePeerId().value().toBase58(),
-                              s->remoteMultiaddr().value().getStringAddress(),
-                              res.error());
-          }
-        });
+  std::shared_ptr<const Bytes> IdentifyDelta::makeDelta() {
+    if (added_.empty() and removed_.empty()) {
+      return nullptr;
+    }
+    identify::pb::Identify msg;
+    auto &delta = *msg.mutable_delta();
+    for (const auto &proto : added_) {
+      delta.add_added_protocols(proto);
+    }
+    for (const auto &proto : removed_) {
+      delta.add_rm_protocols(proto);
+    }
+    added_.clear();
+    removed_.clear();
+    return detail::serializeWithLength(msg);
   }
 }  // namespace libp2p::protocol
@@ -12,8 +12,12 @@
 #include <boost/assert.hpp>
 
 #include <libp2p/basic/protobuf_message_read_writer.hpp>
+#include <libp2p/basic/write.hpp>
 #include <libp2p/common/types.hpp>
+#include <libp2p/multi/uvarint.hpp>
+#include <libp2p/network/listener_manager.hpp>
 #include <libp2p/network/network.hpp>
+#include <libp2p/network/reachability.hpp>
 #include <libp2p/peer/address_repository.hpp>
 #include <libp2p/protocol/identify/utils.hpp>
 
@@ -34,6 +38,21 @@ namespace {
         reinterpret_cast<const uint8_t *>(addr.data()),
         addr.size()));
   }
+
+  /// Key of Identify.observedAddr field: field number and length-delimited
+  /// wire type
+  constexpr uint8_t kObservedAddrKey =
+      (identify::pb::Identify::kObservedAddrFieldNumber << 3) | 2;
+
+  libp2p::Bytes serialize(const identify::pb::Identify &msg) {
+    libp2p::Bytes bytes(msg.ByteSizeLong());
+    msg.SerializeToArray(bytes.data(), static_cast<int>(bytes.size()));
+    return bytes;
+  }
+
+  void append(libp2p::Bytes &bytes, libp2p::BytesIn in) {
+    bytes.insert(bytes.end(), in.begin(), in.end());
+  }
 }  // namespace
 
 namespace libp2p::protocol {
@@ -47,6 +66,22 @@ namespace libp2p::protocol {
         identity_manager_{identity_manager},
         key_marshaller_{std::move(key_marshaller)} {
     BOOST_ASSERT(key_marshaller_);
+    auto reset_cache = [this](auto && /*ignored*/) {
+      cached_identify_.reset();
+    };
+    auto &bus = host_.getBus();
+    cache_subs_.push_back(
+        bus.getChannel<event::network::ListenAddressAddedChannel>().subscribe(
+            reset_cache));
+    cache_subs_.push_back(
+        bus.getChannel<event::network::ListenAddressRemovedChannel>()
+            .subscribe(reset_cache));
+    cache_subs_.push_back(
+        bus.getChannel<event::network::AddressReachabilityChannel>()
+            .subscribe(reset_cache));
+    cache_subs_.push_back(
+        bus.getChannel<event::peer::KeyPairChangedChannel>().subscribe(
+            reset_cache));
   }
 
   boost::signals2::connection IdentifyMessageProcessor::onIdentifyReceived(
@@ -55,60 +90,108 @@ namespace libp2p::protocol {
   }
 
   void IdentifyMessageProcessor::sendIdentify(StreamSPtr stream) {
-    identify::pb::Identify msg;
-
-    // set the protocols we speak on
-    for (const auto &proto : host_.getRouter().getSupportedProtocols()) {
-      msg.add_protocols(proto);
-    }
+    const auto &cached = cachedIdentify();
 
     // set an address of the other side, so that it knows, which address we used
     // to connect to it
-    if (auto remote_addr = stream->remoteMultiaddr()) {
-      msg.set_observedaddr(fromMultiaddrToString(remote_addr.value()));
+    auto remote_addr = stream->remoteMultiaddr();
+    BytesIn observed;
+    std::optional<multi::UVarint> observed_length;
+    if (remote_addr) {
+      observed = remote_addr.value().getBytesAddress();
+      observed_length.emplace(observed.size());
+    }
+    auto size = cached.head.size() + cached.tail.size();
+    if (observed_length) {
+      size += 1 + observed_length->size() + observed.size();
     }
+    multi::UVarint length{size};
+
+    auto msg = std::make_shared<Bytes>();
+    msg->reserve(length.size() + size);
+    append(*msg, length.toBytes());
+    append(*msg, cached.head);
+    if (observed_length) {
+      msg->push_back(kObservedAddrKey);
+      append(*msg, observed_length->toBytes());
+      append(*msg, observed);
+    }
+    append(*msg, cached.tail);
+
+    // message is kept alive by the callback until write completes
+    BytesIn bytes{*msg};
+    libp2p::write(stream,
+                  bytes,
+                  [self{shared_from_this()}, stream, msg](
+                      outcome::result<void> res) {
+                    self->identifySent(res, stream);
+                  });
+  }
+
+  std::shared_ptr<const Bytes> IdentifyMessageProcessor::serializeIdentify() {
+    return cachedIdentify().serialized;
+  }
+
+  const IdentifyMessageProcessor::CachedIdentify &
+  IdentifyMessageProcessor::cachedIdentify() {
+    auto protocols = host_.getRouter().getSupportedProtocolsShared();
+    if (cached_identify_) {
+      // router replaces the list on change, compare contents for routers,
+      // which build a new one for each call
+      auto &cached = cached_identify_.value();
+      if (cached.protocols == protocols
+          or *cached.protocols == *protocols) {
+        cached.protocols = std::move(protocols);
+        return cached;
+      }
+    }
+
+    identify::pb::Identify head;
+    // set our public key, marshalled once by the identity manager
+    const auto &marshalled_pubkey = identity_manager_.getMarshalledPublicKey();
+    head.set_publickey(marshalled_pubkey.key.data(),
+                       marshalled_pubkey.key.size());
 
     // set addresses we are available on
     for (const auto &addr : host_.getPeerInfo().addresses) {
-      msg.add_listenaddrs(fromMultiaddrToString(addr));
+      head.add_listenaddrs(fromMultiaddrToString(addr));
     }
 
-    // set our public key
-    auto marshalled_pubkey_res =
-        key_marshaller_->marshal(identity_manager_.getKeyPair().publicKey);
-    if (!marshalled_pubkey_res) {
-      log_->critical(
-          "cannot marshal public key, which was provided to us by the identity "
-          "manager: {}",
-          marshalled_pubkey_res.error());
-    } else {
-      auto &&marshalled_pubkey = marshalled_pubkey_res.value();
-      msg.set_publickey(marshalled_pubkey.key.data(),
-                        marshalled_pubkey.key.size());
+    // set the protocols we speak on
+    for (const auto &proto : *protocols) {
+      head.add_protocols(proto);
     }
 
     // set versions of Libp2p and our implementation
-    msg.set_protocolversion(std::string{host_.getLibp2pVersion()});
-    msg.set_agentversion(std::string{host_.getLibp2pClientVersion()});
-
-    // write the resulting Protobuf message
-    auto rw = std::make_shared<basic::ProtobufMessageReadWriter>(stream);
-    rw->write<identify::pb::Identify>(
-        msg,
-        [self{shared_from_this()},
-         stream = std::move(stream)](auto &&res) mutable {
-          self->identifySent(std::forward<decltype(res)>(res), stream);
-        });
+    identify::pb::Identify tail;
+    tail.set_protocolversion(std::string{host_.getLibp2pVersion()});
+    tail.set_agentversion(std::string{host_.getLibp2pClientVersion()});
+
+    auto &cached = cached_identify_.emplace(CachedIdentify{
+        .protocols = std::move(protocols),
+        .head = serialize(head),
+        .tail = serialize(tail),
+        .serialized = nullptr,
+    });
+    multi::UVarint length{cached.head.size() + cached.tail.size()};
+    auto serialized = std::make_shared<Bytes>();
+    serialized->reserve(length.size() + cached.head.size()
+                        + cached.tail.size());
+    append(*serialized, length.toBytes());
+    append(*serialized, cached.head);
+    append(*serialized, cached.tail);
+    cached.serialized = std::move(serialized);
+    return cached;
   }
 
   void IdentifyMessageProcessor::identifySent(
-      outcome::result<size_t> written_bytes, const StreamSPtr &stream) {
+      outcome::result<void> write_res, const StreamSPtr &stream) {
     auto [peer_id, peer_addr] = detail::getPeerIdentity(stream);
-    if (!written_bytes) {
+    if (!write_res) {
       log_->error("cannot write identify message to stream to peer {}, {}: {}",
                   peer_id,
                   peer_addr,
-                  written_bytes.error());
+                  write_res.error());
       return stream->reset();
     }
 
@@ -226,42 +309,23 @@ namespace libp2p::protocol {
     // peer id can be set in stream, derived from the received public key or
     // both; handle all possible cases
     boost::optional<peer::PeerId> stream_peer_id;
-    boost::optional<crypto::PublicKey> pubkey;
 
     // retrieve a peer id from the stream
     if (stream_peer_id_res) {
       stream_peer_id = std::move(stream_peer_id_res.value());
     }
 
-    // unmarshal a received public key
-    std::vector<uint8_t> pubkey_buf;
-    pubkey_buf.insert(pubkey_buf.end(), pubkey_str.begin(), pubkey_str.end());
-    auto pubkey_res =
-        key_marshaller_->unmarshalPublicKey(crypto::ProtobufKey{pubkey_buf});
-    if (!pubkey_res) {
-      log_->info("cannot unmarshal public key for peer {}: {}",
-                 stream_peer_id ? stream_peer_id->toBase58() : "",
-                 pubkey_res.error());
+    auto resolved = resolvePublicKey(pubkey_str, stream_peer_id);
+    if (resolved == nullptr) {
       return stream_peer_id;
     }
-    pubkey = std::move(pubkey_res.value());
-
-    // derive a peer id from the received public key; PeerId is made from
-    // Protobuf-marshalled key, so we use it here
-    auto msg_peer_id_res =
-        peer::PeerId::fromPublicKey(crypto::ProtobufKey{pubkey_buf});
-    if (!msg_peer_id_res) {
-      log_->info("cannot derive PeerId from the received key: {}",
-                 msg_peer_id_res.error());
-      return stream_peer_id;
-    }
-    auto msg_peer_id = std::move(msg_peer_id_res.value());
+    const auto &[pubkey, msg_peer_id] = *resolved;
 
     auto &key_repo = host_.getPeerRepository().getKeyRepository();
     if (!stream_peer_id) {
       // didn't know the ID before; memorize the key, from which it can be
       // derived later
-      auto add_res = key_repo.addPublicKey(msg_peer_id, *pubkey);
+      auto add_res = key_repo.addPublicKey(msg_peer_id, pubkey);
       if (!add_res) {
         log_->error("cannot add key to the repo of peer {}: {}",
                     msg_peer_id.toBase58(),
@@ -280,7 +344,7 @@ namespace libp2p::protocol {
     }
 
     // insert the derived key into key repository
-    auto add_res = key_repo.addPublicKey(*stream_peer_id, *pubkey);
+    auto add_res = key_repo.addPublicKey(*stream_peer_id, pubkey);
     if (!add_res) {
       log_->error("cannot add key to the repo of peer {}: {}",
                   stream_peer_id->toBase58(),
@@ -289,6 +353,43 @@ namespace libp2p::protocol {
     return stream_peer_id;
   }
 
+  const IdentifyMessageProcessor::ResolvedKey *
+  IdentifyMessageProcessor::resolvePublicKey(
+      std::string_view pubkey_str,
+      const boost::optional<peer::PeerId> &stream_peer_id) {
+    std::string cache_key{pubkey_str};
+    if (auto cached = key_cache_.get(cache_key)) {
+      return cached;
+    }
+
+    // unmarshal a received public key
+    std::vector<uint8_t> pubkey_buf;
+    pubkey_buf.insert(pubkey_buf.end(), pubkey_str.begin(), pubkey_str.end());
+    auto pubkey_res =
+        key_marshaller_->unmarshalPublicKey(crypto::ProtobufKey{pubkey_buf});
+    if (!pubkey_res) {
+      log_->info("cannot unmarshal public key for peer {}: {}",
+                 stream_peer_id ? stream_peer_id->toBase58() : "",
+                 pubkey_res.error());
+      return nullptr;
+    }
+
+    // derive a peer id from the received public key; PeerId is made from
+    // Protobuf-marshalled key, so we use it here
+    auto msg_peer_id_res =
+        peer::PeerId::fromPublicKey(crypto::ProtobufKey{pubkey_buf});
+    if (!msg_peer_id_res) {
+      log_->info("cannot derive PeerId from the received key: {}",
+                 msg_peer_id_res.error());
+      return nullptr;
+    }
+
+    return &key_cache_.put(
+        cache_key,
+        ResolvedKey{std::move(pubkey_res.value()),
+                    std::move(msg_peer_id_res.value())});
+  }
+
   void IdentifyMessageProcessor::consumeObservedAddresses(
       const std::string &address_str,
       const peer::PeerId &peer_id,
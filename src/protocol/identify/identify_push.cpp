@@ -9,8 +9,8 @@
 #include <string>
 
 #include <libp2p/network/listener_manager.hpp>
+#include <libp2p/network/reachability.hpp>
 #include <libp2p/peer/identity_manager.hpp>
-#include <libp2p/protocol/identify/utils.hpp>
 
 namespace {
   const std::string kIdentifyPushProtocol = "/ipfs/id/push/1.0.0";
@@ -19,7 +19,17 @@ namespace {
 namespace libp2p::protocol {
   IdentifyPush::IdentifyPush(
       std::shared_ptr<IdentifyMessageProcessor> msg_processor, event::Bus &bus)
-      : msg_processor_{std::move(msg_processor)}, bus_{bus} {}
+      : IdentifyPush{std::move(msg_processor), bus, nullptr} {}
+
+  IdentifyPush::IdentifyPush(
+      std::shared_ptr<IdentifyMessageProcessor> msg_processor,
+      event::Bus &bus,
+      std::shared_ptr<basic::Scheduler> scheduler,
+      IdentifyBroadcastConfig config)
+      : msg_processor_{std::move(msg_processor)},
+        bus_{bus},
+        scheduler_{std::move(scheduler)},
+        config_{config} {}
 
   peer::ProtocolName IdentifyPush::getProtocolId() const {
     return kIdentifyPushProtocol;
@@ -30,13 +40,25 @@ namespace libp2p::protocol {
   }
 
   void IdentifyPush::start() {
-    static constexpr uint8_t kChannelsAmount = 3;
+    static constexpr uint8_t kChannelsAmount = 4;
 
-    auto send_push = [self{weak_from_this()}](auto && /*ignored*/) {
-      if (self.expired()) {
-        return;
+    // pushed message has no observed address, so it is serialized once for
+    // all peers
+    broadcaster_ = std::make_shared<IdentifyBroadcaster>(
+        msg_processor_->getHost(),
+        msg_processor_->getConnectionManager(),
+        scheduler_,
+        config_,
+        kIdentifyPushProtocol,
+        [msg_processor{msg_processor_}] {
+          return msg_processor->serializeIdentify();
+        });
+
+    auto send_push = [broadcaster{std::weak_ptr{broadcaster_}}](
+                         auto && /*ignored*/) {
+      if (auto b = broadcaster.lock()) {
+        b->changed();
       }
-      self.lock()->sendPush();
     };
 
     sub_handles_.reserve(kChannelsAmount);
@@ -46,24 +68,11 @@ namespace libp2p::protocol {
     sub_handles_.push_back(
         bus_.getChannel<event::network::ListenAddressRemovedChannel>()
             .subscribe(send_push));
+    sub_handles_.push_back(
+        bus_.getChannel<event::network::AddressReachabilityChannel>()
+            .subscribe(send_push));
     sub_handles_.push_back(
         bus_.getChannel<event::peer::KeyPairChangedChannel>().subscribe(
             std::move(send_push)));
   }
-
-  void IdentifyPush::sendPush() {
-    detail::streamToEachConnectedPeer(
-        msg_processor_->getHost(),
-        msg_processor_->getConnectionManager(),
-        {kIdentifyPushProtocol},
-        [self{weak_from_this()}](auto &&s_res) {
-          if (!s_res) {
-            return;
-          }
-          if (auto t = self.lock()) {
-            return t->msg_processor_->sendIdentify(
-                std::move(s_res.value().stream));
-          }
-        });
-  }
 }  // namespace libp2p::protocol
@@ -7,38 +7,30 @@
 #include <libp2p/protocol/identify/observed_addresses.hpp>
 
 #include <algorithm>
+#include <tuple>
+
+#include <boost/asio/ip/address.hpp>
 
 namespace libp2p::protocol {
-  std::vector<multi::Multiaddress> ObservedAddresses::getAddressesFor(
-      const multi::Multiaddress &address) const {
-    std::vector<multi::Multiaddress> result;
+  namespace {
+    constexpr uint64_t kGroupTagShift = 56;
+    constexpr uint64_t kGroupValueMask = (uint64_t{1} << kGroupTagShift) - 1;
+  }  // namespace
 
+  std::span<const multi::Multiaddress> ObservedAddresses::getAddressesFor(
+      const multi::Multiaddress &address) const {
+    refresh(Clock::now());
     auto addr_entry_it = observed_addresses_.find(address);
     if (addr_entry_it == observed_addresses_.end()) {
-      return result;
-    }
-
-    auto now = Clock::now();
-    for (const auto &addr : addr_entry_it->second) {
-      if (addressIsActivated(addr, now)) {
-        result.push_back(addr.address);
-      }
+      return {};
     }
-
-    return result;
+    return addr_entry_it->second.activated;
   }
 
-  std::vector<multi::Multiaddress> ObservedAddresses::getAllAddresses() const {
-    std::vector<multi::Multiaddress> result;
-
-    for (const auto &it : observed_addresses_) {
-      auto addresses = getAddressesFor(it.first);
-      result.insert(result.end(),
-                    std::make_move_iterator(addresses.begin()),
-                    std::make_move_iterator(addresses.end()));
-    }
-
-    return result;
+  std::span<const multi::Multiaddress> ObservedAddresses::getAllAddresses()
+      const {
+    refresh(Clock::now());
+    return all_activated_;
   }
 
   void ObservedAddresses::add(multi::Multiaddress observed,
@@ -46,21 +38,19 @@ namespace libp2p::protocol {
                               const multi::Multiaddress &observer,
                               bool is_initiator) {
     auto now = Clock::now();
-    auto observer_group = observerGroup(observer);
-
-    Observation observation{now, is_initiator};
+    Observation observation{observerGroup(observer), now, is_initiator};
 
     auto local_addr_entry = observed_addresses_.find(local);
     if (local_addr_entry == observed_addresses_.end()) {
+      if (observed_addresses_.size() >= kMaxLocalAddresses) {
+        return;
+      }
       // this is the first time somebody was connecting to this local address
       local_addr_entry =
-          observed_addresses_
-              .emplace(std::make_pair(std::move(local),
-                                      std::vector<ObservedAddress>()))
-              .first;
+          observed_addresses_.emplace(std::move(local), LocalAddress{}).first;
     }
 
-    auto &addresses = local_addr_entry->second;
+    auto &addresses = local_addr_entry->second.observed;
     auto observed_addr_it =
         std::find_if(addresses.begin(),
                      addresses.end(),
@@ -68,57 +58,156 @@ namespace libp2p::protocol {
                        return observed_addr.address == observed;
                      });
     if (observed_addr_it == addresses.end()) {
+      if (addresses.size() >= kMaxObservedPerLocal) {
+        // evict least recently seen address, preferably not activated one
+        auto evicted = std::min_element(
+            addresses.begin(), addresses.end(), [](auto &l, auto &r) {
+              return std::tie(l.activated, l.last_seen)
+                   < std::tie(r.activated, r.last_seen);
+            });
+        auto was_activated = evicted->activated;
+        addresses.erase(evicted);
+        if (was_activated) {
+          rebuild(now);
+        }
+      }
       // this observed address was not mapped to that local address before
-      std::unordered_map<multi::Multiaddress, Observation> seen_by{
-          std::make_pair(std::move(observer_group), observation)};
       addresses.push_back(
-          ObservedAddress{std::move(observed), std::move(seen_by), now});
-      return;
+          ObservedAddress{std::move(observed), {observation}, now});
+      observed_addr_it = std::prev(addresses.end());
+    } else {
+      // update the address observation
+      auto &seen_by = observed_addr_it->seen_by;
+      auto seen_it = std::find_if(
+          seen_by.begin(), seen_by.end(), [&](const Observation &seen) {
+            return seen.group == observation.group;
+          });
+      if (seen_it != seen_by.end()) {
+        *seen_it = observation;
+      } else if (seen_by.size() < kMaxObserverGroups) {
+        seen_by.push_back(observation);
+      } else {
+        *std::min_element(seen_by.begin(),
+                          seen_by.end(),
+                          [](const Observation &l, const Observation &r) {
+                            return l.seen_time < r.seen_time;
+                          }) = observation;
+      }
+      observed_addr_it->last_seen = now;
     }
 
-    // update the address observation
-    observed_addr_it->seen_by[observer_group] = observation;
-    observed_addr_it->last_seen = now;
+    auto &addr = *observed_addr_it;
+    if (not addr.activated and addressIsActivated(addr, now)) {
+      addr.activated = true;
+      local_addr_entry->second.activated.push_back(addr.address);
+      all_activated_.push_back(addr.address);
+    }
+    if (addr.activated) {
+      next_expiry_ = std::min(next_expiry_, expiresAt(addr, now));
+    }
   }
 
   void ObservedAddresses::collectGarbage() {
     auto now = Clock::now();
-    for (auto &addr_entry : observed_addresses_) {
+    for (auto it = observed_addresses_.begin();
+         it != observed_addresses_.end();) {
       // firstly, remove the "outer" structures with observed addresses, which
       // were expired
-      auto &addresses = addr_entry.second;
-      addresses.erase(std::remove_if(addresses.begin(),
-                                     addresses.end(),
-                                     [now](const auto &observed_addr) {
-                                       return now - observed_addr.last_seen
-                                            > observed_addr.ttl;
-                                     }),
-                      addresses.end());
+      auto &addresses = it->second.observed;
+      std::erase_if(addresses, [now](const auto &observed_addr) {
+        return now - observed_addr.last_seen > observed_addr.ttl;
+      });
 
       // secondly, clear the "inner" structures with observation facts
-      for (auto &addr : addr_entry.second) {
-        auto it = addr.seen_by.begin();
-        while (it != addr.seen_by.end()) {
-          if (now - it->second.seen_time > addr.ttl * kActivationThresh) {
-            it = addr.seen_by.erase(it);
-          } else {
-            ++it;
-          }
-        }
+      for (auto &addr : addresses) {
+        std::erase_if(addr.seen_by, [&](const Observation &seen) {
+          return now - seen.seen_time > addr.ttl * kActivationThresh;
+        });
+      }
+
+      if (addresses.empty()) {
+        it = observed_addresses_.erase(it);
+      } else {
+        ++it;
       }
     }
+    rebuild(now);
   }
 
   bool ObservedAddresses::addressIsActivated(const ObservedAddress &address,
                                              Clock::time_point now) const {
-    return now - address.last_seen <= address.ttl
-        && address.seen_by.size() >= kActivationThresh;
+    if (now - address.last_seen > address.ttl) {
+      return false;
+    }
+    auto groups = std::count_if(
+        address.seen_by.begin(),
+        address.seen_by.end(),
+        [&](const Observation &seen) {
+          return now - seen.seen_time <= address.ttl * kActivationThresh;
+        });
+    return groups >= kActivationThresh;
+  }
+
+  ObservedAddresses::Clock::time_point ObservedAddresses::expiresAt(
+      const ObservedAddress &address, Clock::time_point now) {
+    // the earliest observation, which is not expired yet, may be the one
+    // to drop observer groups below threshold
+    auto expires = address.last_seen + address.ttl;
+    for (const auto &seen : address.seen_by) {
+      auto seen_expires = seen.seen_time + address.ttl * kActivationThresh;
+      if (seen_expires >= now) {
+        expires = std::min(expires, seen_expires);
+      }
+    }
+    return expires;
   }
 
-  multi::Multiaddress ObservedAddresses::observerGroup(
-      const multi::Multiaddress &addr) const {
-    // for now, we only use the root part of the multiaddress; in most cases, it
-    // is IP4, and this is the behaviour we want
-    return addr.splitFirst().first;
+  void ObservedAddresses::refresh(Clock::time_point now) const {
+    if (now > next_expiry_) {
+      rebuild(now);
+    }
+  }
+
+  void ObservedAddresses::rebuild(Clock::time_point now) const {
+    all_activated_.clear();
+    next_expiry_ = Clock::time_point::max();
+    for (auto &[local, entry] : observed_addresses_) {
+      entry.activated.clear();
+      for (auto &addr : entry.observed) {
+        addr.activated = addressIsActivated(addr, now);
+        if (addr.activated) {
+          entry.activated.push_back(addr.address);
+          all_activated_.push_back(addr.address);
+          next_expiry_ = std::min(next_expiry_, expiresAt(addr, now));
+        }
+      }
+    }
+  }
+
+  uint64_t ObservedAddresses::observerGroup(const multi::Multiaddress &addr) {
+    boost::system::error_code ec;
+    if (auto ip4 = addr.peekFirstValueForProtocol(multi::Protocol::Code::IP4)) {
+      auto ip = boost::asio::ip::make_address_v4(ip4.value(), ec);
+      if (not ec) {
+        // /16 network
+        return (uint64_t{4} << kGroupTagShift) | (ip.to_uint() >> 16);
+      }
+    }
+    if (auto ip6 = addr.peekFirstValueForProtocol(multi::Protocol::Code::IP6)) {
+      auto ip = boost::asio::ip::make_address_v6(ip6.value(), ec);
+      if (not ec) {
+        // /56 network
+        auto bytes = ip.to_bytes();
+        uint64_t prefix = 0;
+        for (size_t i = 0; i < kGroupTagShift / 8; ++i) {
+          prefix = (prefix << 8) | bytes[i];
+        }
+        return (uint64_t{6} << kGroupTagShift) | prefix;
+      }
+    }
+    // for other addresses, we only use the root part of the multiaddress
+    return (uint64_t{0xFF} << kGroupTagShift)
+         | (std::hash<multi::Multiaddress>{}(addr.splitFirst().first)
+            & kGroupValueMask);
   }
 }  // namespace libp2p::protocol
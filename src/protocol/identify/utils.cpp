@@ -6,7 +6,10 @@
 
 #include <libp2p/protocol/identify/utils.hpp>
 
+#include <google/protobuf/message_lite.h>
+
 #include <libp2p/multi/multiaddress.hpp>
+#include <libp2p/multi/uvarint.hpp>
 
 namespace libp2p::protocol::detail {
   std::tuple<std::string, std::string> getPeerIdentity(
@@ -48,4 +51,18 @@ namespace libp2p::protocol::detail {
       host.newStream(peer, protocols, handler);
     }
   }
+
+  std::shared_ptr<const Bytes> serializeWithLength(
+      const google::protobuf::MessageLite &msg) {
+    auto size = msg.ByteSizeLong();
+    multi::UVarint length{size};
+    auto bytes = std::make_shared<Bytes>();
+    bytes->reserve(length.size() + size);
+    bytes->insert(
+        bytes->end(), length.toBytes().begin(), length.toBytes().end());
+    bytes->resize(length.size() + size);
+    msg.SerializeToArray(bytes->data() + length.size(),
+                         static_cast<int>(size));
+    return bytes;
+  }
 }  // namespace libp2p::protocol::detail
@@ -39,6 +39,8 @@ OUTCOME_CPP_DEFINE_CATEGORY(libp2p::protocol::kademlia, Error, e) {
       return "internal error";
     case E::SESSION_CLOSED:
       return "session was closed";
+    case E::STORAGE_ERROR:
+      return "persistent storage failure";
   }
   return "unknown error (libp2p::protocol::kademlia::Error)";
 }
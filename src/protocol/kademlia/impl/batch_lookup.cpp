@@ -0,0 +1,50 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/protocol/kademlia/impl/batch_lookup.hpp>
+
+#include <algorithm>
+
+#include <libp2p/crypto/sha/sha256.hpp>
+
+namespace libp2p::protocol::kademlia {
+
+  BatchLookup::BatchLookup(size_t concurrency, Start start)
+      : concurrency_{std::max<size_t>(concurrency, 1)},
+        start_{std::move(start)} {
+    BOOST_ASSERT(start_);
+  }
+
+  void BatchLookup::lookup(const std::vector<ContentId> &keys) {
+    std::vector<BytesIn> inputs{keys.begin(), keys.end()};
+    std::vector<Hash256> hashes(keys.size());
+    crypto::sha256Batch(inputs, hashes);
+    for (size_t i = 0; i < keys.size(); ++i) {
+      queue_.emplace(hashes[i], keys[i]);
+    }
+    next();
+  }
+
+  void BatchLookup::next() {
+    // lookups completing synchronously don't recurse
+    if (starting_) {
+      return;
+    }
+    starting_ = true;
+    while (in_progress_ < concurrency_ and not queue_.empty()) {
+      auto key = std::move(queue_.begin()->second);
+      queue_.erase(queue_.begin());
+      ++in_progress_;
+      // batch lives while its lookups are in progress
+      start_(key, [self{shared_from_this()}] {
+        --self->in_progress_;
+        self->next();
+      });
+    }
+    starting_ = false;
+  }
+
+}  // namespace libp2p::protocol::kademlia
@@ -25,4 +25,8 @@ namespace libp2p::protocol::kademlia {
     return multi::ContentIdentifierCodec::encodeCIDV1(
         libp2p::multi::MulticodecType::Code::RAW, mhash_res.value());
   }
+
+  ContentId makeKey(const multi::ContentIdentifierView &cid) {
+    return {cid.bytes.begin(), cid.bytes.end()};
+  }
 }  // namespace libp2p::protocol::kademlia
@@ -6,23 +6,48 @@
 
 #include <libp2p/protocol/kademlia/impl/content_routing_table_impl.hpp>
 
-#include <boost/multi_index/hashed_index.hpp>
-#include <boost/multi_index/ordered_index.hpp>
-#include <boost/multi_index_container.hpp>
+#include <algorithm>
 
 namespace libp2p::protocol::kademlia {
 
+  namespace {
+    /// Takes free slot for the item, returns its handle
+    template <typename T>
+    uint32_t allocateSlot(std::vector<const T *> &slots,
+                          std::vector<uint32_t> &free_slots,
+                          const T *item) {
+      if (free_slots.empty()) {
+        slots.push_back(item);
+        return static_cast<uint32_t>(slots.size() - 1);
+      }
+      auto handle = free_slots.back();
+      free_slots.pop_back();
+      slots[handle] = item;
+      return handle;
+    }
+
+    template <typename T>
+    void freeSlot(std::vector<const T *> &slots,
+                  std::vector<uint32_t> &free_slots,
+                  uint32_t handle) {
+      slots[handle] = nullptr;
+      free_slots.push_back(handle);
+    }
+  }  // namespace
+
   ContentRoutingTableImpl::ContentRoutingTableImpl(
       const Config &config,
       basic::Scheduler &scheduler,
       std::shared_ptr<event::Bus> bus)
-      : config_(config), scheduler_(scheduler), bus_(std::move(bus)) {
+      : config_(config),
+        scheduler_(scheduler),
+        bus_(std::move(bus)),
+        expiry_(config_.providerWipingInterval) {
     BOOST_ASSERT(bus_ != nullptr);
-    table_ = std::make_unique<Table>();
   }
 
   void ContentRoutingTableImpl::start() {
-    setTimerCleanup();
+    setTimerCleanup(config_.providerWipingInterval);
   }
 
   ContentRoutingTableImpl::~ContentRoutingTableImpl() = default;
@@ -30,10 +55,12 @@ namespace libp2p::protocol::kademlia {
   std::vector<PeerId> ContentRoutingTableImpl::getProvidersFor(
       const ContentId &key, size_t limit) const {
     std::vector<PeerId> result;
-    auto &idx = table_->get<ByKey>();
-    auto [begin, end] = idx.equal_range(key);
-    for (auto it = begin; it != end; ++it) {
-      result.push_back(it->peer);
+    auto it = table_.find(key);
+    if (it == table_.end()) {
+      return result;
+    }
+    for (auto &provider : it->second.providers) {
+      result.push_back(*peers_[provider.peer]);
       if (limit > 0 and result.size() >= limit) {
         break;
       }
@@ -44,29 +71,35 @@ namespace libp2p::protocol::kademlia {
   void ContentRoutingTableImpl::addProvider(const ContentId &key,
                                             const peer::PeerId &peer) {
     auto expires = scheduler_.now() + config_.providerRecordTTL;
-    auto &idx = table_->get<ByKey>();
-    auto [begin, end] = idx.equal_range(key);
-    auto oldest = begin;
-    auto equal = idx.end();
-    size_t count = 0;
-    for (auto it = begin; it != end; ++it, ++count) {
-      if (it->peer == peer) {
-        equal = it;
-        break;
-      }
-      if (it->expire_time < oldest->expire_time) {
-        oldest = it;
-      }
+    auto [it, inserted] = table_.try_emplace(key);
+    auto &record = it->second;
+    if (inserted) {
+      record.handle = allocateSlot(keys_, free_keys_, &it->first);
     }
-    if (equal != idx.end()) {
-      // provider refreshed itself, so do our host
-      table_->modify(equal, [expires](Record &r) { r.expire_time = expires; });
-      return;
+    auto &providers = record.providers;
+    // stale entry of refreshed provider is skipped by sweep
+    expiry_.add(record.handle, expires);
+    if (auto peer_it = peer_records_.find(peer);
+        peer_it != peer_records_.end()) {
+      auto equal = std::find_if(
+          providers.begin(), providers.end(), [&](const Provider &provider) {
+            return provider.peer == peer_it->second.handle;
+          });
+      if (equal != providers.end()) {
+        // provider refreshed itself, so do our host
+        equal->expire_time = expires;
+        return;
+      }
     }
-    if (count >= config_.maxProvidersPerKey) {
-      idx.erase(oldest);
+    if (providers.size() >= config_.maxProvidersPerKey) {
+      auto oldest = std::min_element(
+          providers.begin(), providers.end(), [](auto &lhs, auto &rhs) {
+            return lhs.expire_time < rhs.expire_time;
+          });
+      releasePeer(oldest->peer);
+      providers.erase(oldest);
     }
-    table_->insert({key, peer, expires});
+    providers.push_back({acquirePeer(peer), expires});
     bus_->getChannel<event::protocol::kademlia::ProvideContentChannel>()
         .publish({key, peer});
   }
@@ -74,20 +107,55 @@ namespace libp2p::protocol::kademlia {
   void ContentRoutingTableImpl::onCleanupTimer() {
     auto current_time = scheduler_.now();
 
-    // cleanup expired records
-    auto &idx = table_->get<ByExpireTime>();
-    for (auto i = idx.begin(); i != idx.end();) {
-      if (i->expire_time > current_time) {
-        break;
-      }
-      auto ci = i++;
-      idx.erase(ci);
+    // cleanup expired records, a slice per tick not to block the thread
+    auto more = expiry_.sweep(
+        current_time, kSweepSlice, [&](const auto &entry) {
+          // handle of erased key may be reused, sweeping it is harmless
+          auto key = keys_[entry.key];
+          if (key == nullptr) {
+            return;
+          }
+          auto it = table_.find(*key);
+          auto &providers = it->second.providers;
+          for (auto i = providers.begin(); i != providers.end();) {
+            if (i->expire_time > current_time) {
+              ++i;
+              continue;
+            }
+            releasePeer(i->peer);
+            i = providers.erase(i);
+          }
+          if (providers.empty()) {
+            freeSlot(keys_, free_keys_, entry.key);
+            table_.erase(it);
+          }
+        });
+
+    setTimerCleanup(more ? std::chrono::milliseconds::zero()
+                         : config_.providerWipingInterval);
+  }
+
+  ContentRoutingTableImpl::Handle ContentRoutingTableImpl::acquirePeer(
+      const peer::PeerId &peer) {
+    auto [it, inserted] = peer_records_.try_emplace(peer);
+    if (inserted) {
+      it->second.handle = allocateSlot(peers_, free_peers_, &it->first);
     }
+    ++it->second.refs;
+    return it->second.handle;
+  }
 
-    setTimerCleanup();
+  void ContentRoutingTableImpl::releasePeer(Handle handle) {
+    auto it = peer_records_.find(*peers_[handle]);
+    BOOST_ASSERT(it != peer_records_.end());
+    if (--it->second.refs == 0) {
+      freeSlot(peers_, free_peers_, handle);
+      peer_records_.erase(it);
+    }
   }
 
-  void ContentRoutingTableImpl::setTimerCleanup() {
+  void ContentRoutingTableImpl::setTimerCleanup(
+      std::chrono::milliseconds delay) {
     cleanup_timer_ = scheduler_.scheduleWithHandle(
         [weak_self{weak_from_this()}] {
           auto self = weak_self.lock();
@@ -96,6 +164,7 @@ namespace libp2p::protocol::kademlia {
           }
           self->onCleanupTimer();
         },
-        config_.providerWipingInterval);
+        delay,
+        basic::Scheduler::Priority::BACKGROUND);
   }
 }  // namespace libp2p::protocol::kademlia
@@ -0,0 +1,216 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/protocol/kademlia/impl/content_routing_table_sqlite.hpp>
+
+#include <algorithm>
+
+#include <libp2p/protocol/kademlia/error.hpp>
+
+namespace libp2p::protocol::kademlia {
+
+  namespace {
+    /// Records must outlive restart, so wall clock is used instead of
+    /// scheduler time
+    Time wallClock() {
+      return std::chrono::duration_cast<Time>(
+          std::chrono::system_clock::now().time_since_epoch());
+    }
+  }  // namespace
+
+  ContentRoutingTableSqlite::ContentRoutingTableSqlite(
+      const Config &config,
+      basic::Scheduler &scheduler,
+      std::shared_ptr<event::Bus> bus,
+      std::shared_ptr<storage::SQLite> db)
+      : config_(config),
+        scheduler_(scheduler),
+        bus_(std::move(bus)),
+        db_(std::move(db)),
+        cache_(config_.storageCacheSize) {
+    BOOST_ASSERT(bus_ != nullptr);
+    BOOST_ASSERT(db_ != nullptr);
+
+    std::string journal_mode;
+    *db_ << "PRAGMA journal_mode = WAL" >> journal_mode;
+    *db_ << "PRAGMA synchronous = NORMAL";
+    *db_ << "CREATE TABLE IF NOT EXISTS kademlia_providers ("
+            "key BLOB NOT NULL, "
+            "peer BLOB NOT NULL, "
+            "expire_time INTEGER NOT NULL, "
+            "PRIMARY KEY(key, peer))";
+    *db_ << "CREATE INDEX IF NOT EXISTS kademlia_providers_expire_time "
+            "ON kademlia_providers(expire_time)";
+
+    begin_ = db_->createStatement("BEGIN");
+    commit_ = db_->createStatement("COMMIT");
+    rollback_ = db_->createStatement("ROLLBACK");
+    select_ = db_->createStatement(
+        "SELECT peer, expire_time FROM kademlia_providers WHERE key = ?");
+    upsert_ = db_->createStatement(
+        "INSERT OR REPLACE INTO kademlia_providers(key, peer, expire_time) "
+        "VALUES(?, ?, ?)");
+    delete_ = db_->createStatement(
+        "DELETE FROM kademlia_providers WHERE key = ? AND peer = ?");
+    delete_expired_ = db_->createStatement(
+        "DELETE FROM kademlia_providers WHERE expire_time <= ?");
+  }
+
+  ContentRoutingTableSqlite::~ContentRoutingTableSqlite() {
+    std::ignore = flush();
+  }
+
+  void ContentRoutingTableSqlite::start() {
+    setTimerCleanup();
+  }
+
+  std::vector<PeerId> ContentRoutingTableSqlite::getProvidersFor(
+      const ContentId &key, size_t limit) const {
+    std::vector<PeerId> result;
+    for (auto &provider : providers(key)) {
+      result.push_back(provider.peer);
+      if (limit > 0 and result.size() >= limit) {
+        break;
+      }
+    }
+    return result;
+  }
+
+  void ContentRoutingTableSqlite::addProvider(const ContentId &key,
+                                              const peer::PeerId &peer) {
+    auto expires = wallClock() + config_.providerRecordTTL;
+    auto &providers = this->providers(key);
+    auto equal =
+        std::find_if(providers.begin(), providers.end(), [&](auto &provider) {
+          return provider.peer == peer;
+        });
+    if (equal != providers.end()) {
+      // provider refreshed itself, so do our host
+      equal->expire_time = expires;
+      addChange({key, peer, expires});
+      return;
+    }
+    if (not providers.empty()
+        and providers.size() >= config_.maxProvidersPerKey) {
+      auto oldest = std::min_element(
+          providers.begin(), providers.end(), [](auto &a, auto &b) {
+            return a.expire_time < b.expire_time;
+          });
+      addChange({key, oldest->peer, boost::none});
+      providers.erase(oldest);
+    }
+    providers.push_back({peer, expires});
+    addChange({key, peer, expires});
+    bus_->getChannel<event::protocol::kademlia::ProvideContentChannel>()
+        .publish({key, peer});
+  }
+
+  outcome::result<void> ContentRoutingTableSqlite::flush() const {
+    flush_timer_.reset();
+    if (changes_.empty()) {
+      return outcome::success();
+    }
+
+    auto write = [&] {
+      if (db_->execCommand(begin_) < 0) {
+        return false;
+      }
+      for (auto &change : changes_) {
+        auto &peer = change.peer.toVector();
+        auto changed =
+            change.expire_time
+                ? db_->execCommand(
+                      upsert_,
+                      change.key,
+                      peer,
+                      sqlite_int64{change.expire_time.value().count()})
+                : db_->execCommand(delete_, change.key, peer);
+        if (changed < 0) {
+          db_->execCommand(rollback_);
+          return false;
+        }
+      }
+      if (db_->execCommand(commit_) < 0) {
+        db_->execCommand(rollback_);
+        return false;
+      }
+      return true;
+    };
+
+    if (not write()) {
+      // changes are kept to retry later
+      setFlushTimer();
+      return Error::STORAGE_ERROR;
+    }
+    changes_.clear();
+    return outcome::success();
+  }
+
+  std::vector<ContentRoutingTableSqlite::Provider> &
+  ContentRoutingTableSqlite::providers(const ContentId &key) const {
+    if (auto cached = cache_.get(key)) {
+      return *cached;
+    }
+    // database must not miss changes of evicted keys
+    std::ignore = flush();
+    std::vector<Provider> providers;
+    db_->execQuery(
+        select_,
+        [&](std::vector<uint8_t> peer, sqlite_int64 expire_time) {
+          if (auto peer_id = PeerId::fromBytes(peer)) {
+            providers.push_back({peer_id.value(), Time(expire_time)});
+          }
+        },
+        key);
+    return cache_.put(key, std::move(providers));
+  }
+
+  void ContentRoutingTableSqlite::addChange(Change change) {
+    changes_.emplace_back(std::move(change));
+    if (changes_.size() >= config_.storageFlushBatch) {
+      std::ignore = flush();
+      return;
+    }
+    if (not flush_timer_) {
+      setFlushTimer();
+    }
+  }
+
+  void ContentRoutingTableSqlite::setFlushTimer() const {
+    flush_timer_ = scheduler_.scheduleWithHandle(
+        [weak_self{weak_from_this()}] {
+          if (auto self = weak_self.lock()) {
+            std::ignore = self->flush();
+          }
+        },
+        config_.storageFlushInterval);
+  }
+
+  void ContentRoutingTableSqlite::onCleanupTimer() {
+    // pending changes are written first, then one statement deletes all
+    // expired records
+    auto now = wallClock();
+    std::ignore = flush();
+    db_->execCommand(delete_expired_, sqlite_int64{now.count()});
+    cache_.clear();
+
+    setTimerCleanup();
+  }
+
+  void ContentRoutingTableSqlite::setTimerCleanup() {
+    cleanup_timer_ = scheduler_.scheduleWithHandle(
+        [weak_self{weak_from_this()}] {
+          auto self = weak_self.lock();
+          if (not self) {
+            return;
+          }
+          self->onCleanupTimer();
+        },
+        config_.providerWipingInterval,
+        basic::Scheduler::Priority::BACKGROUND);
+  }
+
+}  // namespace libp2p::protocol::kademlia
@@ -0,0 +1,250 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/protocol/kademlia/impl/crawler.hpp>
+
+#include <algorithm>
+
+#include <libp2p/common/metrics/registry.hpp>
+#include <libp2p/protocol/kademlia/error.hpp>
+#include <libp2p/protocol/kademlia/impl/response_handler.hpp>
+#include <libp2p/protocol/kademlia/impl/session.hpp>
+
+namespace libp2p::protocol::kademlia {
+
+  namespace {
+    metrics::Counter &requestsCounter() {
+      static auto &counter = metrics::Registry::instance().counter(
+          "libp2p_kademlia_crawl_requests_total",
+          "FIND_NODE requests sent by crawler");
+      return counter;
+    }
+
+    metrics::Gauge &peersGauge() {
+      static auto &gauge = metrics::Registry::instance().gauge(
+          "libp2p_kademlia_crawl_peers",
+          "Peers of full routing table found by the last crawl");
+      return gauge;
+    }
+  }  // namespace
+
+  /// Passes FIND_NODE response of peer to crawler
+  class Crawler::Request : public ResponseHandler {
+   public:
+    Request(std::shared_ptr<Crawler> crawler, PeerId peer_id)
+        : crawler_{std::move(crawler)}, peer_id_{std::move(peer_id)} {}
+
+    Time responseTimeout() const override {
+      return crawler_->config_.responseTimeout;
+    }
+
+    bool match(const Message &msg) const override {
+      return msg.type == Message::Type::kFindNode;
+    }
+
+    void onResult(const std::shared_ptr<Session> &,
+                  outcome::result<Message> msg_res) override {
+      crawler_->onResponse(peer_id_, std::move(msg_res));
+    }
+
+   private:
+    std::shared_ptr<Crawler> crawler_;
+    PeerId peer_id_;
+  };
+
+  Crawler::Crawler(const Config &config,
+                   std::shared_ptr<Host> host,
+                   std::shared_ptr<basic::Scheduler> scheduler,
+                   std::weak_ptr<SessionHost> session_host,
+                   std::shared_ptr<PeerRoutingTable> seeds,
+                   std::shared_ptr<FullRoutingTable> table)
+      : config_(config),
+        host_(std::move(host)),
+        scheduler_(std::move(scheduler)),
+        session_host_(std::move(session_host)),
+        seeds_(std::move(seeds)),
+        table_(std::move(table)),
+        log_("Crawler", "kademlia") {
+    BOOST_ASSERT(host_ != nullptr);
+    BOOST_ASSERT(scheduler_ != nullptr);
+    BOOST_ASSERT(seeds_ != nullptr);
+    BOOST_ASSERT(table_ != nullptr);
+  }
+
+  Crawler::~Crawler() = default;
+
+  void Crawler::start() {
+    if (not crawling_) {
+      crawl();
+    }
+  }
+
+  void Crawler::crawl() {
+    crawling_ = true;
+    queue_.clear();
+    seen_.clear();
+    found_.clear();
+    seen_.emplace(host_->getId());
+
+    // peers of previous crawl are checked again, so gone ones are dropped
+    for (auto peers : {seeds_->getAllPeers(), table_->getAllPeers()}) {
+      for (auto &peer_id : peers) {
+        if (seen_.emplace(peer_id).second) {
+          queue_.emplace_back(peer_id);
+        }
+      }
+    }
+    log_.debug("crawl started from {} peers", queue_.size());
+
+    next_request_ = scheduler_->now();
+    next();
+  }
+
+  void Crawler::next() {
+    // requests failing synchronously don't recurse
+    if (starting_) {
+      return;
+    }
+    starting_ = true;
+    while (in_progress_ < std::max<size_t>(config_.crawlConcurrency, 1)
+           and not queue_.empty()) {
+      if (config_.crawlRate != 0) {
+        auto now = scheduler_->now();
+        if (now < next_request_) {
+          if (not timer_) {
+            timer_ = scheduler_->scheduleWithHandle(
+                [weak_self{weak_from_this()}] {
+                  if (auto self = weak_self.lock()) {
+                    self->timer_.reset();
+                    self->next();
+                  }
+                },
+                next_request_ - now);
+          }
+          break;
+        }
+        next_request_ =
+            std::max(next_request_, now - std::chrono::seconds{1})
+            + std::chrono::milliseconds{1000} / config_.crawlRate;
+      }
+      auto peer_id = std::move(queue_.front());
+      queue_.pop_front();
+      ++in_progress_;
+      request(peer_id);
+    }
+    starting_ = false;
+
+    if (queue_.empty() and in_progress_ == 0 and crawling_) {
+      finish();
+    }
+  }
+
+  void Crawler::request(const PeerId &peer_id) {
+    auto session_host = session_host_.lock();
+    auto peer_info = host_->getPeerRepository().getPeerInfo(peer_id);
+    if (not session_host or peer_info.addresses.empty()
+        or host_->connectedness(peer_info)
+               == Message::Connectedness::CAN_NOT_CONNECT) {
+      onRequestDone();
+      return;
+    }
+
+    Bytes frame;
+    if (not createFindNodeRequest(peer_id.toVector(), boost::none)
+                .serialize(frame)) {
+      onRequestDone();
+      return;
+    }
+    requestsCounter().inc();
+
+    auto holder = std::make_shared<
+        std::pair<std::shared_ptr<Crawler>, basic::Scheduler::Handle>>();
+    holder->first = shared_from_this();
+    holder->second = scheduler_->scheduleWithHandle(
+        [holder] {
+          if (auto self = std::move(holder->first)) {
+            holder->second.reset();
+            self->onRequestDone();
+          }
+        },
+        config_.connectionTimeout);
+
+    session_host->getSession(
+        peer_info,
+        [holder, peer_id, frame{std::move(frame)}](
+            SessionOrError session_res) {
+          auto self = std::move(holder->first);
+          if (not self) {
+            return;
+          }
+          holder->second.reset();
+          if (not session_res) {
+            self->onRequestDone();
+            return;
+          }
+          session_res.value()->write(frame,
+                                     std::make_shared<Request>(self, peer_id));
+        });
+  }
+
+  void Crawler::onResponse(const PeerId &peer_id,
+                           outcome::result<Message> msg_res) {
+    if (msg_res.has_value()) {
+      found_.emplace_back(peer_id);
+      auto &msg = msg_res.value();
+      if (msg.closer_peers) {
+        for (auto &peer : msg.closer_peers.value()) {
+          if (peer.conn_status == Message::Connectedness::CAN_NOT_CONNECT) {
+            continue;
+          }
+          auto add_addr_res =
+              host_->getPeerRepository()
+                  .getAddressRepository()
+                  .upsertAddresses(peer.info.id,
+                                   std::span(peer.info.addresses.data(),
+                                             peer.info.addresses.size()),
+                                   peer::ttl::kDay);
+          if (not add_addr_res) {
+            continue;
+          }
+          if (seen_.emplace(peer.info.id).second) {
+            queue_.emplace_back(peer.info.id);
+          }
+        }
+      }
+    }
+    onRequestDone();
+  }
+
+  void Crawler::onRequestDone() {
+    --in_progress_;
+    next();
+  }
+
+  void Crawler::finish() {
+    crawling_ = false;
+    log_.debug("crawl done, {} peers of {} responded",
+               found_.size(),
+               seen_.size());
+    // crawl failed entirely, i.e. no network, previous table is kept
+    if (not found_.empty()) {
+      table_->assign(found_);
+      peersGauge().set(static_cast<int64_t>(table_->size()));
+    }
+    found_.clear();
+    seen_.clear();
+
+    timer_ = scheduler_->scheduleWithHandle(
+        [weak_self{weak_from_this()}] {
+          if (auto self = weak_self.lock()) {
+            self->timer_.reset();
+            self->crawl();
+          }
+        },
+        config_.crawlInterval);
+  }
+
+}  // namespace libp2p::protocol::kademlia
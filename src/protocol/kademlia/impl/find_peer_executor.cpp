@@ -25,6 +25,7 @@ namespace libp2p::protocol::kademlia {
       std::shared_ptr<basic::Scheduler> scheduler,
       std::shared_ptr<SessionHost> session_host,
       const std::shared_ptr<PeerRoutingTable> &peer_routing_table,
+      std::shared_ptr<PeerLatencies> latencies,
       HashedKey target,
       FoundPeerInfoHandler handler)
       : config_(config),
@@ -33,17 +34,13 @@ namespace libp2p::protocol::kademlia {
         session_host_(std::move(session_host)),
         target_{std::move(target)},
         handler_(std::move(handler)),
+        query_(config_,
+               target_.hash,
+               std::move(latencies),
+               peer_routing_table->getNearestPeers(
+                   target_.hash, config_.query_initial_peers),
+               peer_routing_table),
         log_("KademliaExecutor", "kademlia", "FindPeer", ++instance_number) {
-    auto nearest_peer_ids = peer_routing_table->getNearestPeers(
-        target_.hash, config_.query_initial_peers);
-
-    nearest_peer_ids_.insert(std::move_iterator(nearest_peer_ids.begin()),
-                             std::move_iterator(nearest_peer_ids.end()));
-
-    for (auto &peer_id : nearest_peer_ids_) {
-      queue_.emplace(peer_id, target_.hash);
-    }
-
     log_.debug("created");
   }
 
@@ -104,39 +101,43 @@ namespace libp2p::protocol::kademlia {
 
   void FindPeerExecutor::spawn() {
     if (done_) {
+      stall_timer_.reset();
       return;
     }
 
     auto self_peer_id = host_->getId();
 
-    while (started_ and not done_ and not queue_.empty()
-           and requests_in_progress_ < config_.requestConcurency) {
-      auto peer_id = *queue_.top();
-      queue_.pop();
+    while (started_ and not done_) {
+      auto next = query_.next(scheduler_->now());
+      if (not next) {
+        break;
+      }
+      auto &peer_id = next.value();
 
       // Exclude yoursef, because not found locally anyway
       if (peer_id == self_peer_id) {
+        query_.onSkipped(peer_id);
         continue;
       }
 
       // Get peer info
       auto peer_info = host_->getPeerRepository().getPeerInfo(peer_id);
       if (peer_info.addresses.empty()) {
+        query_.onSkipped(peer_id);
         continue;
       }
 
       // Check if connectable
       auto connectedness = host_->connectedness(peer_info);
       if (connectedness == Message::Connectedness::CAN_NOT_CONNECT) {
+        query_.onSkipped(peer_id);
         continue;
       }
 
-      ++requests_in_progress_;
-
       log_.debug("connecting to {}; active {}, in queue {}",
                  peer_id.toBase58(),
-                 requests_in_progress_,
-                 queue_.size());
+                 query_.inProgress(),
+                 query_.waiting());
 
       auto holder =
           std::make_shared<std::pair<std::shared_ptr<FindPeerExecutor>,
@@ -144,57 +145,72 @@ namespace libp2p::protocol::kademlia {
 
       holder->first = shared_from_this();
       holder->second = scheduler_->scheduleWithHandle(
-          [holder] {
+          [holder, peer_id] {
             if (holder->first) {
               holder->second.reset();
-              holder->first->onConnected(Error::TIMEOUT);
+              holder->first->onConnected(peer_id, Error::TIMEOUT);
               holder->first.reset();
             }
           },
           config_.connectionTimeout);
 
-      host_->newStream(
-          peer_info, config_.protocols, [holder](auto &&stream_res) {
+      session_host_->getSession(
+          peer_info, [holder, peer_id](auto &&session_res) {
             if (holder->first) {
               holder->second.reset();
-              holder->first->onConnected(stream_res);
+              holder->first->onConnected(peer_id, session_res);
               holder->first.reset();
             }
           });
     }
 
-    if (requests_in_progress_ == 0) {
+    // https://github.com/libp2p/rust-libp2p/blob/9a45db3f82b760c93099e66ec77a7a772d1f6cd3/protocols/kad/src/query/peers/closest.rs#L336-L346
+    if (query_.finished() or query_.inProgress() == 0) {
       done(Error::VALUE_NOT_FOUND);
+      return;
+    }
+
+    // Stalled requests let the query spawn more
+    if (query_.waiting() != 0) {
+      stall_timer_ = scheduler_->scheduleWithHandle(
+          [wp = weak_from_this()] {
+            if (auto self = wp.lock()) {
+              self->stall_timer_.reset();
+              self->spawn();
+            }
+          },
+          query_.stallTimeout());
     }
   }
 
-  void FindPeerExecutor::onConnected(StreamAndProtocolOrError stream_res) {
-    if (not stream_res) {
-      --requests_in_progress_;
+  void FindPeerExecutor::onConnected(const PeerId &peer_id,
+                                     SessionOrError session_res) {
+    if (not session_res) {
+      query_.onFailure(peer_id, scheduler_->now());
 
       log_.debug("cannot connect to peer: {}; active {}, in queue {}",
-                 stream_res.error(),
-                 requests_in_progress_,
-                 queue_.size());
+                 session_res.error(),
+                 query_.inProgress(),
+                 query_.waiting());
 
       spawn();
       return;
     }
 
-    auto &stream = stream_res.value().stream;
+    auto &session = session_res.value();
+    auto stream = session->stream();
     assert(stream->remoteMultiaddr().has_value());
 
     std::string addr(stream->remoteMultiaddr().value().getStringAddress());
 
     log_.debug("connected to {}; active {}, in queue {}",
                addr,
-               requests_in_progress_,
-               queue_.size());
+               query_.inProgress(),
+               query_.waiting());
 
     log_.debug("outgoing stream with {}",
                stream->remotePeerId().value().toBase58());
 
-    auto session = session_host_->openSession(stream);
     session->write(*serialized_request_, shared_from_this());
   }
 
@@ -210,18 +226,17 @@ namespace libp2p::protocol::kademlia {
 
   void FindPeerExecutor::onResult(const std::shared_ptr<Session> &session,
                                   outcome::result<Message> msg_res) {
-    FinalAction respawn([this] {
-      --requests_in_progress_;
-      spawn();
-    });
+    FinalAction respawn([this] { spawn(); });
 
     // Check if gotten some message
     if (not msg_res) {
+      query_.onFailure(session->stream()->remotePeerId().value(),
+                       scheduler_->now());
       log_.warn("Result from {} is failed: {}; active {}, in queue {}",
                 session->stream()->remotePeerId().value().toBase58(),
                 msg_res.error(),
-                requests_in_progress_,
-                queue_.size());
+                query_.inProgress(),
+                query_.waiting());
       return;
     }
     auto &msg = msg_res.value();
@@ -239,12 +254,13 @@ namespace libp2p::protocol::kademlia {
 
     log_.debug("Result from {} is gotten; active {}, in queue {}",
                remote_peer_id.toBase58(),
-               requests_in_progress_,
-               queue_.size());
+               query_.inProgress(),
+               query_.waiting());
 
     succeeded_peers_.emplace_back(remote_peer_id);
 
     // Append gotten peer to queue
+    std::vector<PeerId> closer_peers;
     if (msg.closer_peers) {
       for (auto &peer : msg.closer_peers.value()) {
         // Skip non connectable peers
@@ -283,17 +299,10 @@ namespace libp2p::protocol::kademlia {
           continue;
         }
 
-        // New peer add to queue
-        if (auto [it, ok] = nearest_peer_ids_.emplace(peer.info.id); ok) {
-          queue_.emplace(*it, target_.hash);
-        }
+        closer_peers.emplace_back(peer.info.id);
       }
     }
-
-    if (succeeded_peers_.size() >= config_.replication_factor) {
-      // https://github.com/libp2p/rust-libp2p/blob/9a45db3f82b760c93099e66ec77a7a772d1f6cd3/protocols/kad/src/query/peers/closest.rs#L336-L346
-      done(Error::VALUE_NOT_FOUND);
-    }
+    query_.onSuccess(remote_peer_id, closer_peers, scheduler_->now());
   }
 
 }  // namespace libp2p::protocol::kademlia
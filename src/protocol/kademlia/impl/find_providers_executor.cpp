@@ -6,6 +6,8 @@
 
 #include <libp2p/protocol/kademlia/impl/find_providers_executor.hpp>
 
+#include <algorithm>
+
 #include <libp2p/common/final_action.hpp>
 #include <libp2p/protocol/kademlia/config.hpp>
 #include <libp2p/protocol/kademlia/error.hpp>
@@ -25,15 +27,27 @@ namespace libp2p::protocol::kademlia {
       std::shared_ptr<basic::Scheduler> scheduler,
       std::shared_ptr<SessionHost> session_host,
       const std::shared_ptr<PeerRoutingTable> &peer_routing_table,
+      std::shared_ptr<PeerLatencies> latencies,
       ContentId content_id,
-      FoundProvidersHandler handler)
+      size_t limit,
+      FoundProvidersHandler handler,
+      ProviderStreamHandler on_provider)
       : config_(config),
         host_(std::move(host)),
         scheduler_(std::move(scheduler)),
         session_host_(std::move(session_host)),
         content_id_(std::move(content_id)),
+        limit_(limit != 0 ? std::min(limit, config_.maxProvidersPerKey)
+                          : config_.maxProvidersPerKey),
         handler_(std::move(handler)),
+        on_provider_(std::move(on_provider)),
         target_{NodeId::hash(content_id_)},
+        query_(config_,
+               target_,
+               std::move(latencies),
+               peer_routing_table->getNearestPeers(
+                   target_, config_.query_initial_peers),
+               peer_routing_table),
         log_("KademliaExecutor",
              "kademlia",
              "FindProviders",
@@ -42,16 +56,6 @@ namespace libp2p::protocol::kademlia {
     BOOST_ASSERT(scheduler_ != nullptr);
     BOOST_ASSERT(session_host_ != nullptr);
 
-    auto nearest_peer_ids = peer_routing_table->getNearestPeers(
-        target_, config_.query_initial_peers);
-
-    nearest_peer_ids_.insert(std::move_iterator(nearest_peer_ids.begin()),
-                             std::move_iterator(nearest_peer_ids.end()));
-
-    for (auto &peer_id : nearest_peer_ids_) {
-      queue_.emplace(peer_id, target_);
-    }
-
     log_.debug("created");
   }
 
@@ -102,6 +106,7 @@ namespace libp2p::protocol::kademlia {
     if (not done_.compare_exchange_strong(x, true)) {
       return;
     }
+    cancel();
 
     std::vector<PeerInfo> result;
     for (auto &&peer_id : std::move(providers_)) {
@@ -116,99 +121,127 @@ namespace libp2p::protocol::kademlia {
     handler_(std::move(result));
   }
 
+  void FindProvidersExecutor::cancel() {
+    stall_timer_.reset();
+    for (auto &holder : connecting_) {
+      holder->second.reset();
+      holder->first.reset();
+    }
+    connecting_.clear();
+  }
+
   void FindProvidersExecutor::spawn() {
     if (done_) {
+      stall_timer_.reset();
       return;
     }
 
     auto self_peer_id = host_->getId();
 
-    while (started_ and not done_ and not queue_.empty()
-           and requests_in_progress_ < config_.requestConcurency) {
-      auto peer_id = *queue_.top();
-      queue_.pop();
+    std::erase_if(connecting_,
+                  [](auto &holder) { return holder->first == nullptr; });
+
+    while (started_ and not done_) {
+      auto next = query_.next(scheduler_->now());
+      if (not next) {
+        break;
+      }
+      auto &peer_id = next.value();
 
       // Exclude yoursef, because not found locally anyway
       if (peer_id == self_peer_id) {
+        query_.onSkipped(peer_id);
         continue;
       }
 
       // Get peer info
       auto peer_info = host_->getPeerRepository().getPeerInfo(peer_id);
       if (peer_info.addresses.empty()) {
+        query_.onSkipped(peer_id);
         continue;
       }
 
       // Check if connectable
       auto connectedness = host_->connectedness(peer_info);
       if (connectedness == Message::Connectedness::CAN_NOT_CONNECT) {
+        query_.onSkipped(peer_id);
         continue;
       }
 
-      ++requests_in_progress_;
-
       log_.debug("connecting to {}; active {}, in queue {}",
                  peer_id.toBase58(),
-                 requests_in_progress_,
-                 queue_.size());
+                 query_.inProgress(),
+                 query_.waiting());
 
-      auto holder =
-          std::make_shared<std::pair<std::shared_ptr<FindProvidersExecutor>,
-                                     basic::Scheduler::Handle>>();
+      auto holder = std::make_shared<Connecting>();
+      connecting_.emplace_back(holder);
 
+      // executor is moved out of holder, as it may cancel other holders
       holder->first = shared_from_this();
       holder->second = scheduler_->scheduleWithHandle(
-          [holder] {
-            if (holder->first) {
+          [holder, peer_id] {
+            if (auto self = std::move(holder->first)) {
               holder->second.reset();
-              holder->first->onConnected(Error::TIMEOUT);
-              holder->first.reset();
+              self->onConnected(peer_id, Error::TIMEOUT);
             }
           },
           config_.connectionTimeout);
 
-      host_->newStream(
-          peer_info, config_.protocols, [holder](auto &&stream_res) {
-            if (holder->first) {
+      session_host_->getSession(
+          peer_info, [holder, peer_id](auto &&session_res) {
+            if (auto self = std::move(holder->first)) {
               holder->second.reset();
-              holder->first->onConnected(stream_res);
-              holder->first.reset();
+              self->onConnected(peer_id, session_res);
             }
           });
     }
 
-    if (requests_in_progress_ == 0) {
+    if (query_.finished() or query_.inProgress() == 0) {
       done();
+      return;
+    }
+
+    // Stalled requests let the query spawn more
+    if (query_.waiting() != 0) {
+      stall_timer_ = scheduler_->scheduleWithHandle(
+          [wp = weak_from_this()] {
+            if (auto self = wp.lock()) {
+              self->stall_timer_.reset();
+              self->spawn();
+            }
+          },
+          query_.stallTimeout());
     }
   }
 
-  void FindProvidersExecutor::onConnected(StreamAndProtocolOrError stream_res) {
-    if (not stream_res) {
-      --requests_in_progress_;
+  void FindProvidersExecutor::onConnected(const PeerId &peer_id,
+                                          SessionOrError session_res) {
+    if (not session_res) {
+      query_.onFailure(peer_id, scheduler_->now());
 
       log_.debug("cannot connect to peer: {}; active {}, in queue {}",
-                 stream_res.error(),
-                 requests_in_progress_,
-                 queue_.size());
+                 session_res.error(),
+                 query_.inProgress(),
+                 query_.waiting());
 
       spawn();
       return;
     }
 
-    auto &stream = stream_res.value().stream;
+    auto &session = session_res.value();
+    auto stream = session->stream();
     assert(stream->remoteMultiaddr().has_value());
 
     std::string addr(stream->remoteMultiaddr().value().getStringAddress());
 
     log_.debug("connected to {}; active {}, in queue {}",
                addr,
-               requests_in_progress_,
-               queue_.size());
+               query_.inProgress(),
+               query_.waiting());
 
     log_.debug("outgoing stream with {}",
                stream->remotePeerId().value().toBase58());
 
-    auto session = session_host_->openSession(stream);
     session->write(*serialized_request_, shared_from_this());
   }
 
@@ -226,18 +259,17 @@ namespace libp2p::protocol::kademlia {
 
   void FindProvidersExecutor::onResult(const std::shared_ptr<Session> &session,
                                        outcome::result<Message> msg_res) {
-    FinalAction respawn([this] {
-      --requests_in_progress_;
-      spawn();
-    });
+    FinalAction respawn([this] { spawn(); });
 
     // Check if gotten some message
     if (not msg_res) {
+      query_.onFailure(session->stream()->remotePeerId().value(),
+                       scheduler_->now());
       log_.warn("Result from {} is failed: {}; active {}, in queue {}",
                 session->stream()->remotePeerId().value().toBase58(),
                 msg_res.error(),
-                requests_in_progress_,
-                queue_.size());
+                query_.inProgress(),
+                query_.waiting());
       return;
     }
     auto &msg = msg_res.value();
@@ -255,8 +287,8 @@ namespace libp2p::protocol::kademlia {
 
     log_.debug("Result from {} is gotten; active {}, in queue {}",
                remote_peer_id.toBase58(),
-               requests_in_progress_,
-               queue_.size());
+               query_.inProgress(),
+               query_.waiting());
 
     // Providers found
     if (msg.provider_peers) {
@@ -277,17 +309,25 @@ namespace libp2p::protocol::kademlia {
           continue;
         }
 
-        // Save provider
-        providers_.emplace(peer.info.id);
+        // Save provider, new one is passed on at once
+        if (providers_.emplace(peer.info.id).second and on_provider_
+            and not done_) {
+          auto peer_info = host_->getPeerRepository().getPeerInfo(peer.info.id);
+          if (host_->connectedness(peer_info)
+              != Message::Connectedness::CAN_NOT_CONNECT) {
+            on_provider_(peer_info);
+          }
+        }
       }
 
       // If we have enough providers, that's all
-      if (providers_.size() >= config_.maxProvidersPerKey) {
+      if (providers_.size() >= limit_) {
         done();
       }
     }
 
     // Append gotten peer to queue
+    std::vector<PeerId> closer_peers;
     if (msg.closer_peers) {
       for (auto &peer : msg.closer_peers.value()) {
         // Skip non connectable peers
@@ -322,11 +362,10 @@ namespace libp2p::protocol::kademlia {
         }
 
         // New peer add to queue
-        if (auto [it, ok] = nearest_peer_ids_.emplace(peer.info.id); ok) {
-          queue_.emplace(*it, target_);
-        }
+        closer_peers.emplace_back(peer.info.id);
       }
     }
+    query_.onSuccess(remote_peer_id, closer_peers, scheduler_->now());
   }
 
 }  // namespace libp2p::protocol::kademlia
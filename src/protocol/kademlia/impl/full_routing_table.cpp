@@ -0,0 +1,135 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/protocol/kademlia/impl/full_routing_table.hpp>
+
+#include <algorithm>
+#include <climits>
+
+namespace libp2p::protocol::kademlia {
+
+  namespace {
+    /// Fills bits of hash after prefix with given value
+    Hash256 fillSuffix(Hash256 hash, size_t bits, bool ones) {
+      for (size_t i = bits; i < hash.size() * CHAR_BIT; ++i) {
+        auto mask = static_cast<uint8_t>(0x80 >> (i % CHAR_BIT));
+        if (ones) {
+          hash[i / CHAR_BIT] |= mask;
+        } else {
+          hash[i / CHAR_BIT] &= ~mask;
+        }
+      }
+      return hash;
+    }
+  }  // namespace
+
+  FullRoutingTable::FullRoutingTable(std::shared_ptr<PeerRoutingTable> fallback)
+      : fallback_{std::move(fallback)} {
+    BOOST_ASSERT(fallback_ != nullptr);
+  }
+
+  void FullRoutingTable::assign(const std::vector<peer::PeerId> &peers) {
+    auto ids = NodeId::fromPeers(peers);
+    peers_.clear();
+    peers_.reserve(peers.size());
+    for (size_t i = 0; i < peers.size(); ++i) {
+      peers_.push_back({ids[i].getData(), peers[i]});
+    }
+    std::ranges::sort(peers_, {}, &Entry::hash);
+    auto dup = std::ranges::unique(peers_, {}, &Entry::hash);
+    peers_.erase(dup.begin(), dup.end());
+  }
+
+  outcome::result<bool> FullRoutingTable::update(
+      const peer::PeerId &peer, bool /*is_permanent*/, bool /*is_connected*/) {
+    auto hash = NodeId{peer}.getData();
+    auto it = std::ranges::lower_bound(peers_, hash, {}, &Entry::hash);
+    if (it != peers_.end() and it->hash == hash) {
+      return false;
+    }
+    peers_.insert(it, {hash, peer});
+    return true;
+  }
+
+  void FullRoutingTable::remove(const peer::PeerId &peer) {
+    auto hash = NodeId{peer}.getData();
+    auto it = std::ranges::lower_bound(peers_, hash, {}, &Entry::hash);
+    if (it != peers_.end() and it->hash == hash) {
+      peers_.erase(it);
+    }
+  }
+
+  std::vector<peer::PeerId> FullRoutingTable::getAllPeers() const {
+    std::vector<peer::PeerId> peers;
+    peers.reserve(peers_.size());
+    for (auto &entry : peers_) {
+      peers.emplace_back(entry.peer);
+    }
+    return peers;
+  }
+
+  std::pair<size_t, size_t> FullRoutingTable::prefixRange(
+      const Hash256 &target, size_t bits) const {
+    auto begin = std::ranges::lower_bound(
+        peers_, fillSuffix(target, bits, false), {}, &Entry::hash);
+    auto end = std::ranges::upper_bound(
+        peers_, fillSuffix(target, bits, true), {}, &Entry::hash);
+    return {begin - peers_.begin(), end - peers_.begin()};
+  }
+
+  std::vector<peer::PeerId> FullRoutingTable::getNearestPeers(
+      const NodeId &node, size_t count) {
+    if (peers_.empty()) {
+      return fallback_->getNearestPeers(node, count);
+    }
+
+    // peers sharing longer prefix with target are closer than the rest, so
+    // the narrowest range holding enough peers holds the closest ones
+    auto &target = node.getData();
+    std::pair<size_t, size_t> range{0, peers_.size()};
+    for (size_t bits = 1; bits <= target.size() * CHAR_BIT; ++bits) {
+      auto narrower = prefixRange(target, bits);
+      if (narrower.second - narrower.first < count) {
+        break;
+      }
+      range = narrower;
+    }
+
+    std::vector<const Entry *> closest;
+    closest.reserve(range.second - range.first);
+    for (auto i = range.first; i < range.second; ++i) {
+      closest.push_back(&peers_[i]);
+    }
+    auto n = std::min(count, closest.size());
+    std::partial_sort(closest.begin(),
+                      closest.begin() + static_cast<ptrdiff_t>(n),
+                      closest.end(),
+                      [&](const Entry *a, const Entry *b) {
+                        return xor_distance(a->hash, target)
+                             < xor_distance(b->hash, target);
+                      });
+
+    std::vector<peer::PeerId> peers;
+    peers.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+      peers.emplace_back(closest[i]->peer);
+    }
+    return peers;
+  }
+
+  size_t FullRoutingTable::size() const {
+    return peers_.size();
+  }
+
+  void FullRoutingTable::onResponse(const peer::PeerId &peer, Time rtt) {
+    fallback_->onResponse(peer, rtt);
+  }
+
+  void FullRoutingTable::onFailure(const peer::PeerId &peer) {
+    fallback_->onFailure(peer);
+  }
+
+}  // namespace libp2p::protocol::kademlia
@@ -31,37 +31,36 @@ namespace libp2p::protocol::kademlia {
       std::shared_ptr<SessionHost> session_host,
       std::shared_ptr<ContentRoutingTable> content_routing_table,
       const std::shared_ptr<PeerRoutingTable> &peer_routing_table,
+      std::shared_ptr<PeerLatencies> latencies,
       std::shared_ptr<ExecutorsFactory> executor_factory,
-      std::shared_ptr<Validator> validator,
+      std::shared_ptr<ValidationPool> validation_pool,
       ContentId key,
-      FoundValueHandler handler)
+      FoundValueHandler handler,
+      ValueStreamHandler on_value)
       : config_(config),
         host_(std::move(host)),
         scheduler_(std::move(scheduler)),
         session_host_(std::move(session_host)),
         content_routing_table_(std::move(content_routing_table)),
         executor_factory_(std::move(executor_factory)),
-        validator_(std::move(validator)),
+        validation_pool_(std::move(validation_pool)),
         key_(std::move(key)),
         handler_(std::move(handler)),
+        on_value_(std::move(on_value)),
         target_{NodeId::hash(key_)},
+        query_(config_,
+               target_,
+               std::move(latencies),
+               peer_routing_table->getNearestPeers(
+                   target_, config_.query_initial_peers),
+               peer_routing_table),
         log_("KademliaExecutor", "kademlia", "GetValue", ++instance_number) {
     BOOST_ASSERT(host_ != nullptr);
     BOOST_ASSERT(scheduler_ != nullptr);
     BOOST_ASSERT(session_host_ != nullptr);
     BOOST_ASSERT(content_routing_table_ != nullptr);
     BOOST_ASSERT(executor_factory_ != nullptr);
-    BOOST_ASSERT(validator_ != nullptr);
-
-    auto nearest_peer_ids = peer_routing_table->getNearestPeers(
-        target_, config_.query_initial_peers);
-
-    nearest_peer_ids_.insert(std::move_iterator(nearest_peer_ids.begin()),
-                             std::move_iterator(nearest_peer_ids.end()));
-
-    for (auto &peer_id : nearest_peer_ids_) {
-      queue_.emplace(peer_id, target_);
-    }
+    BOOST_ASSERT(validation_pool_ != nullptr);
 
     received_records_ = std::make_unique<Table>();
     log_.debug("created");
@@ -101,61 +100,66 @@ namespace libp2p::protocol::kademlia {
 
   void GetValueExecutor::spawn() {
     if (done_) {
+      stall_timer_.reset();
       return;
     }
 
     auto self_peer_id = host_->getId();
 
-    while (started_ and not done_ and not queue_.empty()
-           and requests_in_progress_ < config_.requestConcurency) {
-      auto peer_id = *queue_.top();
-      queue_.pop();
+    std::erase_if(connecting_,
+                  [](auto &holder) { return holder->first == nullptr; });
+
+    while (started_ and not done_) {
+      auto next = query_.next(scheduler_->now());
+      if (not next) {
+        break;
+      }
+      auto &peer_id = next.value();
 
       // Exclude yoursef, because not found locally anyway
       if (peer_id == self_peer_id) {
+        query_.onSkipped(peer_id);
         continue;
       }
 
       // Get peer info
       auto peer_info = host_->getPeerRepository().getPeerInfo(peer_id);
       if (peer_info.addresses.empty()) {
+        query_.onSkipped(peer_id);
         continue;
       }
 
       // Check if connectable
       auto connectedness = host_->connectedness(peer_info);
       if (connectedness == Message::Connectedness::CAN_NOT_CONNECT) {
+        query_.onSkipped(peer_id);
         continue;
       }
 
-      ++requests_in_progress_;
-
       log_.debug("connecting to {}; active {}, in queue {}",
                  peer_info.id.toBase58(),
-                 requests_in_progress_,
-                 queue_.size());
+                 query_.inProgress(),
+                 query_.waiting());
 
-      auto holder =
-          std::make_shared<std::pair<std::shared_ptr<GetValueExecutor>,
-                                     basic::Scheduler::Handle>>();
+      auto holder = std::make_shared<Connecting>();
+      connecting_.emplace_back(holder);
 
+      // executor is moved out of holder, as it may cancel other holders
       holder->first = shared_from_this();
       holder->second = scheduler_->scheduleWithHandle(
-          [holder] {
-            if (holder->first) {
+          [holder, peer_id] {
+            if (auto self = std::move(holder->first)) {
               holder->second.reset();
-              holder->first->onConnected(Error::TIMEOUT);
-              holder->first.reset();
+              self->onConnected(peer_id, Error::TIMEOUT);
             }
           },
           config_.connectionTimeout);
 
-      host_->newStream(
-          peer_info, config_.protocols, [holder](auto &&stream_res) {
-            if (holder->first) {
+      session_host_->getSession(
+          peer_info, [holder, peer_id](auto &&session_res) {
+            if (auto self = std::move(holder->first)) {
               holder->second.reset();
-              holder->first->onConnected(stream_res);
-              holder->first.reset();
+              self->onConnected(peer_id, session_res);
             }
           });
     }
@@ -164,11 +168,29 @@ namespace libp2p::protocol::kademlia {
       return;
     }
 
-    if (requests_in_progress_ != 0) {
+    if (not query_.finished() and query_.inProgress() != 0) {
+      // Stalled requests let the query spawn more
+      if (query_.waiting() != 0) {
+        stall_timer_ = scheduler_->scheduleWithHandle(
+            [wp = weak_from_this()] {
+              if (auto self = wp.lock()) {
+                self->stall_timer_.reset();
+                self->spawn();
+              }
+            },
+            query_.stallTimeout());
+      }
+      return;
+    }
+    stall_timer_.reset();
+
+    // query is over, pending records decide the result
+    if (validating_ != 0 or selecting_) {
       return;
     }
     if (received_records_->empty()) {
       done_ = true;
+      cancel();
       log_.debug("done");
       handler_(Error::VALUE_NOT_FOUND);
       return;
@@ -176,32 +198,33 @@ namespace libp2p::protocol::kademlia {
     finish();
   }
 
-  void GetValueExecutor::onConnected(StreamAndProtocolOrError stream_res) {
-    if (not stream_res) {
-      --requests_in_progress_;
+  void GetValueExecutor::onConnected(const PeerId &peer_id,
+                                     SessionOrError session_res) {
+    if (not session_res) {
+      query_.onFailure(peer_id, scheduler_->now());
 
       log_.debug("cannot connect to peer: {}; active {}, in queue {}",
-                 stream_res.error(),
-                 requests_in_progress_,
-                 queue_.size());
+                 session_res.error(),
+                 query_.inProgress(),
+                 query_.waiting());
 
       spawn();
       return;
     }
 
-    auto &stream = stream_res.value().stream;
+    auto &session = session_res.value();
+    auto stream = session->stream();
     assert(stream->remoteMultiaddr().has_value());
 
     std::string addr(stream->remoteMultiaddr().value().getStringAddress());
     log_.debug("connected to {}; active {}, in queue {}",
                addr,
-               requests_in_progress_,
-               queue_.size());
+               query_.inProgress(),
+               query_.waiting());
 
     log_.debug("outgoing stream with {}",
                stream->remotePeerId().value().toBase58());
 
-    auto session = session_host_->openSession(stream);
     session->write(*serialized_request_, shared_from_this());
   }
 
@@ -221,18 +244,17 @@ namespace libp2p::protocol::kademlia {
       return;
     }
 
-    FinalAction respawn([this] {
-      --requests_in_progress_;
-      spawn();
-    });
+    FinalAction respawn([this] { spawn(); });
 
     // Check if gotten some message
     if (not msg_res) {
+      query_.onFailure(session->stream()->remotePeerId().value(),
+                       scheduler_->now());
       log_.warn("Result from {} failed: {}; active {}, in queue {}",
                 session->stream()->remotePeerId().value().toBase58(),
                 msg_res.error(),
-                requests_in_progress_,
-                queue_.size());
+                query_.inProgress(),
+                query_.waiting());
       return;
     }
     auto &msg = msg_res.value();
@@ -250,10 +272,11 @@ namespace libp2p::protocol::kademlia {
 
     log_.debug("Result from {} is gotten; active {}, in queue {}",
                remote_peer_id.toBase58(),
-               requests_in_progress_,
-               queue_.size());
+               query_.inProgress(),
+               query_.waiting());
 
     // Append gotten peer to queue
+    std::vector<PeerId> closer_peers;
     if (msg.closer_peers) {
       for (auto &peer : msg.closer_peers.value()) {
         // Skip non connectable peers
@@ -282,46 +305,108 @@ namespace libp2p::protocol::kademlia {
           continue;
         }
 
-        // New peer add to queue
-        if (auto [it, ok] = nearest_peer_ids_.emplace(peer.info.id); ok) {
-          queue_.emplace(*it, target_);
-        }
+        closer_peers.emplace_back(peer.info.id);
       }
     }
+    query_.onSuccess(remote_peer_id, closer_peers, scheduler_->now());
 
     if (msg.record) {
-      auto &value = msg.record.value().value;
+      auto value = std::move(msg.record.value().value);
+      ++validating_;
+      validation_pool_->validate(
+          key_,
+          value,
+          [self{shared_from_this()}, peer{remote_peer_id}, value](
+              outcome::result<void> res) mutable {
+            self->onValidated(peer, std::move(value), res);
+          });
+    }
+  }
+
+  void GetValueExecutor::onValidated(const PeerId &peer,
+                                     Value value,
+                                     outcome::result<void> res) {
+    --validating_;
+    if (done_) {
+      return;
+    }
 
-      auto validation_res = validator_->validate(key_, value);
-      if (not validation_res.has_value()) {
-        log_.debug("Result from {} is invalid", remote_peer_id.toBase58());
+    FinalAction respawn([this] { spawn(); });
+
+    if (not res.has_value()) {
+      log_.debug("Result from {} is invalid", peer.toBase58());
+      return;
+    }
+
+    auto &idx_by_value = received_records_->get<ByValue>();
+    auto is_new_value = idx_by_value.find(value) == idx_by_value.end();
+    if (not received_records_->insert({peer, value}).second) {
+      return;
+    }
+    if (is_new_value and on_value_) {
+      on_value_(value);
+      if (done_) {
         return;
       }
+    }
 
-      received_records_->insert({remote_peer_id, value});
+    // enough peers agree, slow ones are not waited for
+    if (idx_by_value.count(value) >= config_.valueLookupsQuorum) {
+      finish();
+    }
+  }
 
-      if (received_records_->size() >= config_.valueLookupsQuorum) {
-        finish();
-      }
+  void GetValueExecutor::cancel() {
+    stall_timer_.reset();
+    for (auto &holder : connecting_) {
+      holder->second.reset();
+      holder->first.reset();
     }
+    connecting_.clear();
   }
 
   void GetValueExecutor::finish() {
+    if (selecting_) {
+      return;
+    }
+    selecting_ = true;
+
     std::vector<Value> values;
     std::transform(received_records_->begin(),
                    received_records_->end(),
                    std::back_inserter(values),
                    [](auto &record) { return record.value; });
 
-    auto index_res = validator_->select(key_, values);
-    if (not index_res.has_value()) {
-      log_.debug("Can't select best value of {} provided", values.size());
+    validation_pool_->select(
+        key_,
+        std::move(values),
+        [self{shared_from_this()}](outcome::result<Value> best) mutable {
+          self->onSelected(std::move(best));
+        });
+  }
+
+  void GetValueExecutor::onSelected(outcome::result<Value> best_res) {
+    selecting_ = false;
+    if (done_) {
+      return;
+    }
+    if (not best_res.has_value()) {
+      log_.debug("Can't select best value of {} provided",
+                 received_records_->size());
+      // retried on next record, if query goes on
+      if (validating_ == 0
+          and (query_.finished() or query_.inProgress() == 0)) {
+        done_ = true;
+        cancel();
+        handler_(Error::VALUE_NOT_FOUND);
+      }
       return;
     }
-    auto &best = values[index_res.value()];
+    auto &best = best_res.value();
 
     // Return result to upstear
     done_ = true;
+    cancel();
     log_.debug("done");
     handler_(best);
 
@@ -17,11 +17,13 @@
 #include <libp2p/protocol/kademlia/common.hpp>
 #include <libp2p/protocol/kademlia/error.hpp>
 #include <libp2p/protocol/kademlia/impl/add_provider_executor.hpp>
+#include <libp2p/protocol/kademlia/impl/batch_lookup.hpp>
 #include <libp2p/protocol/kademlia/impl/content_routing_table.hpp>
 #include <libp2p/protocol/kademlia/impl/find_peer_executor.hpp>
 #include <libp2p/protocol/kademlia/impl/find_providers_executor.hpp>
 #include <libp2p/protocol/kademlia/impl/get_value_executor.hpp>
 #include <libp2p/protocol/kademlia/impl/put_value_executor.hpp>
+#include <libp2p/protocol/kademlia/impl/routing_table_snapshot.hpp>
 #include <libp2p/protocol/kademlia/message.hpp>
 
 namespace libp2p::protocol::kademlia {
@@ -46,6 +48,19 @@ namespace libp2p::protocol::kademlia {
         bus_(std::move(bus)),
         random_generator_(std::move(random_generator)),
         self_id_(host_->getId()),
+        latencies_(
+            std::make_shared<PeerLatencies>(config_.query_latency_peers)),
+        session_pool_(
+            std::make_shared<SessionPool>(config_, host_, scheduler_)),
+        validation_pool_(std::make_shared<ValidationPool>(
+            validator_, scheduler_, config_.validationThreads)),
+        request_pool_(config_.requestThreads != 0
+                          ? std::make_unique<RequestPool>(
+                              scheduler_, config_.requestThreads)
+                          : nullptr),
+        find_node_cache_(config_.responseCacheTtl, config_.responseCacheSize),
+        get_providers_cache_(config_.responseCacheTtl,
+                             config_.responseCacheSize),
         log_("Kademlia", "kademlia") {
     BOOST_ASSERT(host_ != nullptr);
     BOOST_ASSERT(storage_ != nullptr);
@@ -115,10 +130,64 @@ namespace libp2p::protocol::kademlia {
                   self->peer_routing_table_->update(peer, false, false);
             });
 
-    // start random walking
+    // nearest peers of cached responses may change
+    auto clear_caches = [weak_self{weak_from_this()}](const PeerId &) {
+      if (auto self = weak_self.lock()) {
+        self->find_node_cache_.clear();
+        self->get_providers_cache_.clear();
+        ++self->response_generation_;
+        self->nearest_snapshot_.reset();
+      }
+    };
+    on_peer_added_ =
+        bus_->getChannel<event::protocol::kademlia::PeerAddedChannel>()
+            .subscribe(clear_caches);
+    on_peer_removed_ =
+        bus_->getChannel<event::protocol::kademlia::PeerRemovedChannel>()
+            .subscribe(clear_caches);
+    on_provided_ =
+        bus_->getChannel<event::protocol::kademlia::ProvideContentChannel>()
+            .subscribe([weak_self{weak_from_this()}](
+                           std::pair<const ContentId &, const PeerId &> data) {
+              if (auto self = weak_self.lock()) {
+                self->get_providers_cache_.erase(data.first);
+                ++self->response_generation_;
+              }
+            });
+
+    // warm restart from snapshot
+    if (not config_.routingTableSnapshotPath.empty()) {
+      loadRoutingTable();
+      snapshot_.handle = scheduler_->scheduleWithHandle(
+          [this] { saveRoutingTable(); },
+          config_.routingTableSnapshotInterval);
+    }
+
+    // start random walking, or refreshing of stale buckets
     if (config_.randomWalk.enabled) {
-      randomWalk();
+      if (config_.bucketRefreshInterval != 0s) {
+        refreshBuckets();
+      } else {
+        randomWalk();
+      }
     }
+
+    // accelerated client mode
+    if (config_.fullRoutingTable) {
+      auto table = std::make_shared<FullRoutingTable>(peer_routing_table_);
+      full_routing_table_ = table;
+      crawler_ = std::make_shared<Crawler>(config_,
+                                           host_,
+                                           scheduler_,
+                                           weak_from_this(),
+                                           peer_routing_table_,
+                                           std::move(table));
+      crawler_->start();
+    }
+  }
+
+  const std::shared_ptr<PeerRoutingTable> &KademliaImpl::lookupTable() const {
+    return full_routing_table_ ? full_routing_table_ : peer_routing_table_;
   }
 
   outcome::result<void> KademliaImpl::bootstrap() {
@@ -149,6 +218,38 @@ namespace libp2p::protocol::kademlia {
 
   outcome::result<void> KademliaImpl::getValue(const Key &key,
                                                FoundValueHandler handler) {
+    return streamValues(key, nullptr, std::move(handler));
+  }
+
+  outcome::result<void> KademliaImpl::getValues(const std::vector<Key> &keys,
+                                                BatchValueHandler handler) {
+    log_.debug("CALL: GetValues ({} keys)", keys.size());
+
+    auto batch = std::make_shared<BatchLookup>(
+        config_.batchLookupConcurrency,
+        [weak_self{weak_from_this()}, handler](
+            const Key &key, BatchLookup::OnDone on_done) {
+          auto self = weak_self.lock();
+          if (not self) {
+            return;
+          }
+          auto res = self->getValue(
+              key, [key, handler, on_done](outcome::result<Value> res) {
+                handler(key, std::move(res));
+                on_done();
+              });
+          if (res.has_error()) {
+            handler(key, res.error());
+            on_done();
+          }
+        });
+    batch->lookup(keys);
+    return outcome::success();
+  }
+
+  outcome::result<void> KademliaImpl::streamValues(const Key &key,
+                                                   ValueStreamHandler on_value,
+                                                   FoundValueHandler handler) {
     log_.debug("CALL: GetValue ({})", multi::detail::encodeBase58(key));
 
     // Check if has actual value locally
@@ -156,16 +257,21 @@ namespace libp2p::protocol::kademlia {
       auto &[value, ts] = res.value();
       if (scheduler_->now() < ts) {
         if (handler) {
-          scheduler_->schedule(
-              [handler{std::move(handler)}, value{std::move(value)}]() mutable {
-                handler(std::move(value));
-              });
+          scheduler_->schedule([on_value{std::move(on_value)},
+                                handler{std::move(handler)},
+                                value{std::move(value)}]() mutable {
+            if (on_value) {
+              on_value(value);
+            }
+            handler(std::move(value));
+          });
           return outcome::success();
         }
       }
     }
 
-    auto get_value_executor = createGetValueExecutor(key, handler);
+    auto get_value_executor =
+        createGetValueExecutor(key, std::move(handler), std::move(on_value));
 
     return get_value_executor->start();
   }
@@ -185,8 +291,66 @@ namespace libp2p::protocol::kademlia {
     return add_provider_executor->start();
   }
 
+  outcome::result<void> KademliaImpl::provideBatch(
+      const std::vector<Key> &keys) {
+    log_.debug("CALL: ProvideBatch ({} keys)", keys.size());
+
+    for (auto &key : keys) {
+      content_routing_table_->addProvider(key, self_id_);
+    }
+
+    if (not reprovider_) {
+      reprovider_ = std::make_shared<Reprovider>(config_,
+                                                 host_,
+                                                 scheduler_,
+                                                 weak_from_this(),
+                                                 lookupTable());
+    }
+    reprovider_->provide(keys);
+    return outcome::success();
+  }
+
   outcome::result<void> KademliaImpl::findProviders(
       const Key &key, size_t limit, FoundProvidersHandler handler) {
+    return streamProviders(key, limit, nullptr, std::move(handler));
+  }
+
+  outcome::result<void> KademliaImpl::findProvidersBatch(
+      const std::vector<Key> &keys,
+      size_t limit,
+      BatchProvidersHandler handler) {
+    log_.debug("CALL: FindProvidersBatch ({} keys)", keys.size());
+
+    auto batch = std::make_shared<BatchLookup>(
+        config_.batchLookupConcurrency,
+        [weak_self{weak_from_this()}, limit, handler](
+            const Key &key, BatchLookup::OnDone on_done) {
+          auto self = weak_self.lock();
+          if (not self) {
+            return;
+          }
+          auto res = self->findProviders(
+              key,
+              limit,
+              [key, handler, on_done](
+                  outcome::result<std::vector<PeerInfo>> res) {
+                handler(key, std::move(res));
+                on_done();
+              });
+          if (res.has_error()) {
+            handler(key, res.error());
+            on_done();
+          }
+        });
+    batch->lookup(keys);
+    return outcome::success();
+  }
+
+  outcome::result<void> KademliaImpl::streamProviders(
+      const Key &key,
+      size_t limit,
+      ProviderStreamHandler on_provider,
+      FoundProvidersHandler handler) {
     log_.debug("CALL: FindProviders ({})", multi::detail::encodeBase58(key));
 
     // Try to find locally
@@ -213,10 +377,16 @@ namespace libp2p::protocol::kademlia {
           }
         }
         if (result.size() >= limit) {
-          scheduler_->schedule(
-              [handler = std::move(handler), result = std::move(result)] {
-                handler(result);
-              });
+          scheduler_->schedule([on_provider = std::move(on_provider),
+                                handler = std::move(handler),
+                                result = std::move(result)] {
+            if (on_provider) {
+              for (auto &provider : result) {
+                on_provider(provider);
+              }
+            }
+            handler(result);
+          });
 
           log_.info("Found {} providers locally from host!", result.size());
           return outcome::success();
@@ -224,8 +394,8 @@ namespace libp2p::protocol::kademlia {
       }
     }
 
-    auto find_providers_executor =
-        createGetProvidersExecutor(key, std::move(handler));
+    auto find_providers_executor = createGetProvidersExecutor(
+        key, limit, std::move(handler), std::move(on_provider));
 
     return find_providers_executor->start();
   }
@@ -329,15 +499,31 @@ namespace libp2p::protocol::kademlia {
       log_.warn("incoming PutValue failed: no record in message");
       return;
     }
-    auto &[key, value, ts] = msg.record.value();
+    auto key = msg.record.value().key;
+    auto value = msg.record.value().value;
 
     log_.debug("MSG: PutValue ({})", multi::detail::encodeBase58(key));
 
-    auto validation_res = validator_->validate(key, value);
-    if (not validation_res) {
-      log_.warn("incoming PutValue failed: {}", validation_res.error());
-      return;
-    }
+    validation_pool_->validate(
+        std::move(key),
+        std::move(value),
+        [weak_self{weak_from_this()}, session, msg{std::move(msg)}](
+            outcome::result<void> res) mutable {
+          auto self = weak_self.lock();
+          if (not self) {
+            return;
+          }
+          if (not res) {
+            self->log_.warn("incoming PutValue failed: {}", res.error());
+            return;
+          }
+          self->onPutValueValidated(session, std::move(msg));
+        });
+  }
+
+  void KademliaImpl::onPutValueValidated(
+      const std::shared_ptr<Session> &session, Message &&msg) {
+    auto &[key, value, ts] = msg.record.value();
 
     auto res = storage_->putValue(key, value);
     if (!res) {
@@ -385,6 +571,12 @@ namespace libp2p::protocol::kademlia {
           std::move(msg.key), std::move(value), std::to_string(expire.count())};
     }
 
+    if (request_pool_ != nullptr) {
+      // storage is not thread-safe, only serialization is offloaded
+      respondOnWorker(
+          session, std::move(msg), [](Message &) { return false; }, nullptr);
+      return;
+    }
     session->write(msg, weak_from_this());
   }
 
@@ -407,6 +599,10 @@ namespace libp2p::protocol::kademlia {
         }
       }
     }
+
+    // there is no response, but remote may send more messages, e.g. batch
+    // of announcements
+    session->read(weak_from_this());
   }
 
   void KademliaImpl::onGetProviders(const std::shared_ptr<Session> &session,
@@ -418,6 +614,15 @@ namespace libp2p::protocol::kademlia {
 
     log_.debug("MSG: GetProviders ({})", multi::detail::encodeBase58(msg.key));
 
+    // response doesn't depend on anything else in request
+    auto cacheable = not msg.record and not msg.provider_peers;
+    if (cacheable) {
+      if (auto frame = get_providers_cache_.get(msg.key, scheduler_->now())) {
+        session->write(*frame, weak_from_this());
+        return;
+      }
+    }
+
     auto peer_ids = content_routing_table_->getProvidersFor(
         msg.key, config_.closerPeerCount * 2);
 
@@ -442,8 +647,27 @@ namespace libp2p::protocol::kademlia {
       }
     }
 
+    if (request_pool_ != nullptr) {
+      respondOnWorker(
+          session,
+          std::move(msg),
+          [snapshot{nearestPeersSnapshot()},
+           count{config_.closerPeerCount}](Message &response) {
+            auto peers = snapshot->nearest(NodeId::hash(response.key), count);
+            if (peers.empty()) {
+              // closer peers of request are echoed
+              return false;
+            }
+            response.closer_peers = std::move(peers);
+            return true;
+          },
+          cacheable ? &get_providers_cache_ : nullptr);
+      return;
+    }
+
     peer_ids = peer_routing_table_->getNearestPeers(
         NodeId::hash(msg.key), config_.closerPeerCount * 2);
+    auto closer_peers_found = false;
 
     if (not peer_ids.empty()) {
       std::vector<Message::Peer> peers;
@@ -463,10 +687,13 @@ namespace libp2p::protocol::kademlia {
 
       if (not peers.empty()) {
         msg.closer_peers = std::move(peers);
+        closer_peers_found = true;
       }
     }
 
-    session->write(msg, weak_from_this());
+    // otherwise closer peers of request are echoed
+    cacheable = cacheable and closer_peers_found;
+    respond(session, msg, cacheable ? &get_providers_cache_ : nullptr);
   }
 
   void KademliaImpl::onFindNode(const std::shared_ptr<Session> &session,
@@ -493,6 +720,31 @@ namespace libp2p::protocol::kademlia {
 
     log_.debug("MSG: FindNode ({})", multi::detail::encodeBase58(msg.key));
 
+    // response doesn't depend on anything else in request
+    auto cacheable = not msg.record and not msg.provider_peers;
+    if (cacheable) {
+      if (auto frame = find_node_cache_.get(msg.key, scheduler_->now())) {
+        session->write(*frame, weak_from_this());
+        return;
+      }
+    }
+
+    if (request_pool_ != nullptr) {
+      respondOnWorker(
+          session,
+          std::move(msg),
+          [snapshot{nearestPeersSnapshot()},
+           count{config_.closerPeerCount}](Message &response) {
+            auto peers = snapshot->nearest(NodeId::hash(response.key), count);
+            if (not peers.empty()) {
+              response.closer_peers = std::move(peers);
+            }
+            return true;
+          },
+          cacheable ? &find_node_cache_ : nullptr);
+      return;
+    }
+
     auto ids = peer_routing_table_->getNearestPeers(
         NodeId::hash(msg.key), config_.closerPeerCount * 2);
 
@@ -515,7 +767,76 @@ namespace libp2p::protocol::kademlia {
       msg.closer_peers = std::move(peers);
     }
 
-    session->write(msg, weak_from_this());
+    respond(session, msg, cacheable ? &find_node_cache_ : nullptr);
+  }
+
+  void KademliaImpl::respond(const std::shared_ptr<Session> &session,
+                             const Message &msg,
+                             ResponseCache *cache) {
+    if (cache == nullptr) {
+      session->write(msg, weak_from_this());
+      return;
+    }
+    Bytes frame;
+    if (not msg.serialize(frame)) {
+      return;
+    }
+    session->write(frame, weak_from_this());
+    cache->put(msg.key, std::move(frame), scheduler_->now());
+  }
+
+  void KademliaImpl::respondOnWorker(const std::shared_ptr<Session> &session,
+                                     Message &&msg,
+                                     RequestPool::Fill fill,
+                                     ResponseCache *cache) {
+    std::optional<ContentId> key;
+    if (cache != nullptr) {
+      key = msg.key;
+    }
+    request_pool_->respond(
+        std::move(msg),
+        std::move(fill),
+        [weak_self{weak_from_this()},
+         session,
+         cache,
+         key{std::move(key)},
+         generation{response_generation_}](Bytes frame,
+                                           bool cacheable) mutable {
+          auto self = weak_self.lock();
+          if (not self) {
+            return;
+          }
+          session->write(frame, weak_self);
+          // tables changed meanwhile, so response may be stale
+          if (key and cacheable and generation == self->response_generation_) {
+            cache->put(*key, std::move(frame), self->scheduler_->now());
+          }
+        });
+  }
+
+  std::shared_ptr<const NearestPeersSnapshot>
+  KademliaImpl::nearestPeersSnapshot() {
+    auto now = scheduler_->now();
+    if (nearest_snapshot_ != nullptr
+        and now - nearest_snapshot_time_ < config_.nearestPeersSnapshotTtl) {
+      return nearest_snapshot_;
+    }
+    auto peer_ids = peer_routing_table_->getAllPeers();
+    auto node_ids = NodeId::fromPeers(peer_ids);
+    std::vector<NearestPeersSnapshot::Entry> entries;
+    entries.reserve(peer_ids.size());
+    for (size_t i = 0; i < peer_ids.size(); ++i) {
+      auto info = host_->getPeerRepository().getPeerInfo(peer_ids[i]);
+      if (info.addresses.empty()) {
+        continue;
+      }
+      auto connectedness = host_->connectedness(info);
+      entries.push_back({node_ids[i], {std::move(info), connectedness}});
+    }
+    nearest_snapshot_ =
+        std::make_shared<const NearestPeersSnapshot>(std::move(entries));
+    nearest_snapshot_time_ = now;
+    return nearest_snapshot_;
   }
 
   void KademliaImpl::onPing(const std::shared_ptr<Session> &session,
@@ -534,6 +855,10 @@ namespace libp2p::protocol::kademlia {
             multi::Multihash::create(multi::HashType::sha256, hash).value())
             .value();
 
+    return findAndAddPeer(peer_id);
+  }
+
+  outcome::result<void> KademliaImpl::findAndAddPeer(const PeerId &peer_id) {
     FoundPeerInfoHandler handler = [wp = weak_from_this()](
                                        outcome::result<PeerInfo> res,
                                        const std::vector<PeerId> &) {
@@ -564,7 +889,107 @@ namespace libp2p::protocol::kademlia {
 
     // Schedule next walking
     random_walking_.handle =
-        scheduler_->scheduleWithHandle([this] { randomWalk(); }, delay);
+        scheduler_->scheduleWithHandle([this] { randomWalk(); },
+                                       delay,
+                                       basic::Scheduler::Priority::BACKGROUND);
+  }
+
+  void KademliaImpl::refreshBuckets() {
+    // ids sharing longer prefix with local one take too long to generate
+    constexpr size_t kMaxRefreshCpl = 15;
+
+    auto stale = peer_routing_table_->staleBuckets(
+        scheduler_->now() - config_.bucketRefreshInterval, kMaxRefreshCpl);
+    if (not stale.empty()) {
+      log_.debug("refreshing {} stale buckets", stale.size());
+    }
+
+    NodeId local{self_id_};
+    for (auto cpl : stale) {
+      // random peer ids until one falls into bucket,
+      // i.e. 2^(cpl+1) attempts on average
+      common::Hash256 hash;
+      while (true) {
+        random_generator_->fillRandomly(hash);
+        auto peer_id =
+            peer::PeerId::fromHash(
+                multi::Multihash::create(multi::HashType::sha256, hash).value())
+                .value();
+        if (local.commonPrefixLen(NodeId{peer_id}) == cpl) {
+          [[maybe_unused]] auto result = findAndAddPeer(peer_id);
+          break;
+        }
+      }
+    }
+
+    random_walking_.handle = scheduler_->scheduleWithHandle(
+        [this] { refreshBuckets(); },
+        config_.bucketRefreshCheck,
+        basic::Scheduler::Priority::BACKGROUND);
+  }
+
+  void KademliaImpl::loadRoutingTable() {
+    auto peers_res = loadRoutingTableSnapshot(config_.routingTableSnapshotPath);
+    if (not peers_res) {
+      log_.debug("routing table snapshot is not loaded: {}", peers_res.error());
+      return;
+    }
+    for (auto &peer_info : peers_res.value()) {
+      if (peer_info.id == self_id_) {
+        continue;
+      }
+      addPeer(peer_info, false);
+      snapshot_.unchecked.emplace_back(std::move(peer_info));
+    }
+    log_.debug("{} peers loaded from routing table snapshot",
+               snapshot_.unchecked.size());
+    checkLiveness();
+  }
+
+  void KademliaImpl::saveRoutingTable() {
+    std::vector<PeerInfo> peers;
+    for (auto &peer_id : peer_routing_table_->getAllPeers()) {
+      if (peer_id == self_id_) {
+        continue;
+      }
+      auto peer_info = host_->getPeerRepository().getPeerInfo(peer_id);
+      if (not peer_info.addresses.empty()) {
+        peers.emplace_back(std::move(peer_info));
+      }
+    }
+    auto res =
+        saveRoutingTableSnapshot(config_.routingTableSnapshotPath, peers);
+    if (not res) {
+      log_.warn("routing table snapshot is not saved: {}", res.error());
+    }
+
+    snapshot_.handle = scheduler_->scheduleWithHandle(
+        [this] { saveRoutingTable(); }, config_.routingTableSnapshotInterval);
+  }
+
+  void KademliaImpl::checkLiveness() {
+    while (not snapshot_.unchecked.empty()
+           and snapshot_.checking < config_.routingTableLivenessChecks) {
+      auto peer_info = std::move(snapshot_.unchecked.front());
+      snapshot_.unchecked.pop_front();
+      ++snapshot_.checking;
+      host_->connect(
+          peer_info,
+          [weak_self{weak_from_this()}, peer_id{peer_info.id}](auto &&res) {
+            auto self = weak_self.lock();
+            if (not self) {
+              return;
+            }
+            --self->snapshot_.checking;
+            if (not res) {
+              self->log_.debug("{} from snapshot is unreachable: {}",
+                               peer_id.toBase58(),
+                               res.error());
+              self->peer_routing_table_->remove(peer_id);
+            }
+            self->checkLiveness();
+          });
+    }
   }
 
   std::shared_ptr<Session> KademliaImpl::openSession(
@@ -573,6 +998,10 @@ namespace libp2p::protocol::kademlia {
         scheduler_, stream, config_.responseTimeout);
   }
 
+  void KademliaImpl::getSession(const PeerInfo &peer, OnSession on_session) {
+    session_pool_->getSession(peer, std::move(on_session));
+  }
+
   void KademliaImpl::handleProtocol(StreamAndProtocol stream_and_protocol) {
     auto &stream = stream_and_protocol.stream;
 
@@ -601,48 +1030,60 @@ namespace libp2p::protocol::kademlia {
   }
 
   std::shared_ptr<GetValueExecutor> KademliaImpl::createGetValueExecutor(
-      ContentId key, FoundValueHandler handler) {
+      ContentId key, FoundValueHandler handler, ValueStreamHandler on_value) {
+    peer_routing_table_->onLookup(NodeId::hash(key), scheduler_->now());
     return std::make_shared<GetValueExecutor>(config_,
                                               host_,
                                               scheduler_,
                                               shared_from_this(),
                                               content_routing_table_,
-                                              peer_routing_table_,
+                                              lookupTable(),
+                                              latencies_,
                                               shared_from_this(),
-                                              validator_,
+                                              validation_pool_,
                                               std::move(key),
-                                              std::move(handler));
+                                              std::move(handler),
+                                              std::move(on_value));
   }
 
   std::shared_ptr<AddProviderExecutor> KademliaImpl::createAddProviderExecutor(
       ContentId content_id) {
+    peer_routing_table_->onLookup(NodeId::hash(content_id), scheduler_->now());
     return std::make_shared<AddProviderExecutor>(config_,
                                                  host_,
                                                  scheduler_,
                                                  shared_from_this(),
-                                                 peer_routing_table_,
+                                                 lookupTable(),
                                                  std::move(content_id));
   }
 
   std::shared_ptr<FindProvidersExecutor>
   KademliaImpl::createGetProvidersExecutor(ContentId content_id,
-                                           FoundProvidersHandler handler) {
+                                           size_t limit,
+                                           FoundProvidersHandler handler,
+                                           ProviderStreamHandler on_provider) {
+    peer_routing_table_->onLookup(NodeId::hash(content_id), scheduler_->now());
     return std::make_shared<FindProvidersExecutor>(config_,
                                                    host_,
                                                    scheduler_,
                                                    shared_from_this(),
-                                                   peer_routing_table_,
+                                                   lookupTable(),
+                                                   latencies_,
                                                    std::move(content_id),
-                                                   std::move(handler));
+                                                   limit,
+                                                   std::move(handler),
+                                                   std::move(on_provider));
   }
 
   std::shared_ptr<FindPeerExecutor> KademliaImpl::createFindPeerExecutor(
       HashedKey key, FoundPeerInfoHandler handler) {
+    peer_routing_table_->onLookup(key.hash, scheduler_->now());
     return std::make_shared<FindPeerExecutor>(config_,
                                               host_,
                                               scheduler_,
                                               shared_from_this(),
-                                              peer_routing_table_,
+                                              lookupTable(),
+                                              latencies_,
                                               std::move(key),
                                               std::move(handler));
   }
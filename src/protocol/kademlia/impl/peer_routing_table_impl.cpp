@@ -6,6 +6,7 @@
 
 #include <libp2p/protocol/kademlia/impl/peer_routing_table_impl.hpp>
 
+#include <algorithm>
 #include <numeric>
 
 OUTCOME_CPP_DEFINE_CATEGORY(libp2p::protocol::kademlia,
@@ -33,13 +34,8 @@ namespace libp2p::protocol::kademlia {
     return peers_.size();
   }
 
-  void Bucket::append(const Bucket &bucket) {
-    peers_.insert(peers_.end(), bucket.peers_.begin(), bucket.peers_.end());
-  }
-
-  void Bucket::sort(const NodeId &node_id) {
-    XorDistanceComparator cmp{node_id};
-    peers_.sort(cmp);
+  const std::vector<BucketPeerInfo> &Bucket::peers() const {
+    return peers_;
   }
 
   auto findPeer(auto &peers, const peer::PeerId &p) {
@@ -55,9 +51,7 @@ namespace libp2p::protocol::kademlia {
     auto it = findPeer(peers_, pid);
     if (it != peers_.end()) {
       it->is_connected = true;
-      if (it != peers_.begin()) {
-        peers_.splice(peers_.begin(), peers_, it);
-      }
+      std::rotate(peers_.begin(), it, std::next(it));
       return false;
     }
     return true;
@@ -69,28 +63,47 @@ namespace libp2p::protocol::kademlia {
     peers_.emplace(peers_.begin(), pid, is_replaceable, is_connected);
   }
 
-  boost::optional<PeerId> Bucket::removeReplaceableItem() {
-    boost::optional<PeerId> result;
+  bool Bucket::onResponse(const PeerId &pid, Time rtt) {
+    auto it = findPeer(peers_, pid);
+    if (it == peers_.end()) {
+      return false;
+    }
+    it->failures = 0;
+    // moving average with weight of 1/4 for new sample, as PeerLatencies
+    it->rtt = it->rtt == Time::zero() ? rtt : it->rtt + (rtt - it->rtt) / 4;
+    return true;
+  }
+
+  bool Bucket::onFailure(const PeerId &pid) {
+    auto it = findPeer(peers_, pid);
+    if (it == peers_.end()) {
+      return false;
+    }
+    ++it->failures;
+    return true;
+  }
 
+  boost::optional<PeerId> Bucket::removeReplaceableItem(size_t max_failures) {
+    auto worst = peers_.rend();
     for (auto it = peers_.rbegin(); it != peers_.rend(); ++it) {
       // https://github.com/libp2p/rust-libp2p/blob/3837e33cd4c40ae703138e6aed6f6c9d52928a80/protocols/kad/src/kbucket/bucket.rs#L310-L366
-      if (it->is_replaceable and not it->is_connected) {
-        result = std::move(it->peer_id);
-        peers_.erase((++it).base());
-        break;
+      if (not it->is_replaceable
+          or (it->is_connected and it->failures < max_failures)) {
+        continue;
+      }
+      // from the least recent, so it wins ties
+      if (worst == peers_.rend()
+          or std::tie(it->failures, it->rtt)
+                 > std::tie(worst->failures, worst->rtt)) {
+        worst = it;
       }
     }
-
-    return result;
-  }
-
-  void Bucket::truncate(size_t limit) {
-    if (limit == 0) {
-      peers_.clear();
-    } else if (peers_.size() > limit) {
-      peers_.erase(std::next(peers_.begin(), static_cast<long>(limit)),
-                   peers_.end());
+    if (worst == peers_.rend()) {
+      return boost::none;
     }
+    auto result = std::move(worst->peer_id);
+    peers_.erase((++worst).base());
+    return result;
   }
 
   std::vector<peer::PeerId> Bucket::peerIds() const {
@@ -155,9 +168,20 @@ namespace libp2p::protocol::kademlia {
       return ((distance[j / 8] >> (7 - j % 8)) & 1) != 0;
     };
     auto bucket_index = getBucketIndex(node_id);
-    Bucket result;
-    auto done = [&] { return result.size() >= count; };
-    auto append = [&](size_t i) { result.append(buckets_.at(i)); };
+    nearest_.clear();
+    // failing peers don't count, so that farther responsive peers are found
+    size_t responsive = 0;
+    auto done = [&] { return responsive >= count; };
+    auto append = [&](size_t i) {
+      for (auto &peer : buckets_.at(i).peers()) {
+        auto failing = peer.failures >= config_.routingTableMaxFailures;
+        if (not failing) {
+          ++responsive;
+        }
+        nearest_.emplace_back(Nearest{
+            failing, peer.node_id.distance(node_id), &peer.peer_id});
+      }
+    };
     if (bucket_index) {
       if (auto i = *bucket_index) {
         append(i);
@@ -176,9 +200,20 @@ namespace libp2p::protocol::kademlia {
         append(i);
       }
     }
-    result.sort(node_id);
-    result.truncate(count);
-    return result.peerIds();
+    // byte arrays compare lexicographically, as big endian distances
+    auto middle = nearest_.begin()
+                + static_cast<std::ptrdiff_t>(std::min(count, nearest_.size()));
+    std::partial_sort(
+        nearest_.begin(), middle, nearest_.end(), [](auto &a, auto &b) {
+          return std::tie(a.failing, a.distance)
+               < std::tie(b.failing, b.distance);
+        });
+    std::vector<peer::PeerId> result;
+    result.reserve(std::min(count, nearest_.size()));
+    for (auto it = nearest_.begin(); it != middle; ++it) {
+      result.emplace_back(*it->peer);
+    }
+    return result;
   }
 
   namespace {
@@ -186,8 +221,9 @@ namespace libp2p::protocol::kademlia {
                                       const peer::PeerId &pid,
                                       bool is_replaceable,
                                       bool is_connected,
+                                      size_t max_failures,
                                       event::Bus &bus) {
-      const auto removed = bucket.removeReplaceableItem();
+      const auto removed = bucket.removeReplaceableItem(max_failures);
       if (!removed.has_value()) {
         return PeerRoutingTableImpl::Error::PEER_REJECTED_NO_CAPACITY;
       }
@@ -225,7 +261,12 @@ namespace libp2p::protocol::kademlia {
       return true;
     }
 
-    return replacePeer(bucket, pid, not is_permanent, is_connected, *bus_);
+    return replacePeer(bucket,
+                       pid,
+                       not is_permanent,
+                       is_connected,
+                       config_.routingTableMaxFailures,
+                       *bus_);
   }
 
   size_t PeerRoutingTableImpl::size() const {
@@ -246,6 +287,42 @@ namespace libp2p::protocol::kademlia {
   }
 
   // https://github.com/libp2p/rust-libp2p/blob/3837e33cd4c40ae703138e6aed6f6c9d52928a80/protocols/kad/src/kbucket.rs#L141-L150
+  void PeerRoutingTableImpl::onLookup(const NodeId &target, Time now) {
+    if (auto bucket_index = getBucketIndex(target)) {
+      last_lookup_.at(*bucket_index) = now;
+    }
+  }
+
+  void PeerRoutingTableImpl::onResponse(const peer::PeerId &peer, Time rtt) {
+    if (auto bucket_index = getBucketIndex(NodeId{peer})) {
+      buckets_.at(*bucket_index).onResponse(peer, rtt);
+    }
+  }
+
+  void PeerRoutingTableImpl::onFailure(const peer::PeerId &peer) {
+    if (auto bucket_index = getBucketIndex(NodeId{peer})) {
+      buckets_.at(*bucket_index).onFailure(peer);
+    }
+  }
+
+  std::vector<size_t> PeerRoutingTableImpl::staleBuckets(
+      Time since, size_t max_cpl) const {
+    // buckets deeper than the deepest nonempty one have nothing to refresh
+    size_t deepest = 0;
+    for (size_t cpl = 0; cpl < kBucketCount; ++cpl) {
+      if (buckets_.at(kBucketCount - 1 - cpl).size() != 0) {
+        deepest = cpl;
+      }
+    }
+    std::vector<size_t> stale;
+    for (size_t cpl = 0; cpl <= std::min(deepest, max_cpl); ++cpl) {
+      if (last_lookup_.at(kBucketCount - 1 - cpl) < since) {
+        stale.push_back(cpl);
+      }
+    }
+    return stale;
+  }
+
   std::optional<size_t> PeerRoutingTableImpl::getBucketIndex(
       const NodeId &key) const {
     if (local_ == key) {
@@ -94,11 +94,11 @@ namespace libp2p::protocol::kademlia {
           },
           config_.connectionTimeout);
 
-      host_->newStream(
-          peer_info, config_.protocols, [holder](auto &&stream_res) {
+      session_host_->getSession(
+          peer_info, [holder](auto &&session_res) {
             if (holder->first) {
               holder->second.reset();
-              holder->first->onConnected(stream_res);
+              holder->first->onConnected(session_res);
               holder->first.reset();
             }
           });
@@ -110,12 +110,12 @@ namespace libp2p::protocol::kademlia {
     }
   }
 
-  void PutValueExecutor::onConnected(StreamAndProtocolOrError stream_res) {
-    if (not stream_res) {
+  void PutValueExecutor::onConnected(SessionOrError session_res) {
+    if (not session_res) {
       --requests_in_progress_;
 
       log_.debug("cannot connect to peer: {}; active {}, in queue {}",
-                 stream_res.error(),
+                 session_res.error(),
                  requests_in_progress_,
                  addressees_.size() - addressees_idx_);
 
@@ -123,7 +123,8 @@ namespace libp2p::protocol::kademlia {
       return;
     }
 
-    auto &stream = stream_res.value().stream;
+    auto &session = session_res.value();
+    auto stream = session->stream();
     assert(stream->remoteMultiaddr().has_value());
 
     std::string addr(stream->remoteMultiaddr().value().getStringAddress());
@@ -136,7 +137,6 @@ namespace libp2p::protocol::kademlia {
     log_.debug("outgoing stream with {}",
                stream->remotePeerId().value().toBase58());
 
-    auto session = session_host_->openSession(stream);
     session->write(*serialized_request_, shared_from_this());
   }
 
@@ -0,0 +1,239 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/protocol/kademlia/impl/query.hpp>
+
+#include <algorithm>
+
+#include <boost/assert.hpp>
+
+namespace libp2p::protocol::kademlia {
+
+  PeerLatencies::PeerLatencies(size_t limit)
+      : limit_(std::max<size_t>(limit, 1)) {}
+
+  void PeerLatencies::update(const PeerId &peer, Time latency) {
+    auto it = latencies_.find(peer);
+    if (it == latencies_.end()) {
+      if (latencies_.size() >= limit_) {
+        sum_ -= latencies_.begin()->second;
+        latencies_.erase(latencies_.begin());
+      }
+      latencies_.emplace(peer, latency);
+      sum_ += latency;
+      return;
+    }
+    // moving average with weight of 1/4 for new sample
+    auto average = it->second + (latency - it->second) / 4;
+    sum_ += average - it->second;
+    it->second = average;
+  }
+
+  boost::optional<Time> PeerLatencies::get(const PeerId &peer) const {
+    auto it = latencies_.find(peer);
+    if (it == latencies_.end()) {
+      return boost::none;
+    }
+    return it->second;
+  }
+
+  boost::optional<Time> PeerLatencies::average() const {
+    if (latencies_.empty()) {
+      return boost::none;
+    }
+    return sum_ / static_cast<Time::rep>(latencies_.size());
+  }
+
+  Query::Query(const Config &config,
+               const NodeId &target,
+               std::shared_ptr<PeerLatencies> latencies,
+               const std::vector<PeerId> &peers,
+               std::shared_ptr<PeerRoutingTable> routing_table)
+      : config_(config),
+        target_(target),
+        latencies_(std::move(latencies)),
+        routing_table_(std::move(routing_table)),
+        paths_(std::max<size_t>(config_.query_disjoint_paths, 1)) {
+    BOOST_ASSERT(latencies_ != nullptr);
+    // peers are sorted by distance, so paths get equally close peers
+    auto node_ids = NodeId::fromPeers(peers);
+    for (size_t i = 0; i < peers.size(); ++i) {
+      add(peers[i], node_ids[i], i % paths_.size());
+    }
+    for (size_t path = 0; path < paths_.size(); ++path) {
+      updatePath(path);
+    }
+  }
+
+  boost::optional<PeerId> Query::next(Time now) {
+    auto window = std::max<size_t>(config_.requestConcurency, 1);
+    for (size_t i = 0; i < paths_.size(); ++i) {
+      auto path = (next_path_ + i) % paths_.size();
+      if (paths_[path].finished
+          or paths_[path].in_progress >= concurrency(path, now)) {
+        continue;
+      }
+
+      // Fastest known peer among closest waiting ones
+      Candidate *best = nullptr;
+      boost::optional<Time> best_latency;
+      size_t considered = 0;
+      for (auto &candidate : candidates_) {
+        if (candidate.path != path or candidate.state != State::WAITING) {
+          continue;
+        }
+        auto latency = latencies_->get(candidate.peer);
+        if (best == nullptr
+            or (latency and (not best_latency or *latency < *best_latency))) {
+          best = &candidate;
+          best_latency = latency;
+        }
+        if (++considered >= window) {
+          break;
+        }
+      }
+      if (best == nullptr) {
+        continue;
+      }
+
+      best->state = State::IN_PROGRESS;
+      best->started = now;
+      ++paths_[path].in_progress;
+      ++in_progress_;
+      --waiting_;
+      next_path_ = (path + 1) % paths_.size();
+      return best->peer;
+    }
+    return boost::none;
+  }
+
+  void Query::onSuccess(const PeerId &peer,
+                        const std::vector<PeerId> &closer_peers,
+                        Time now) {
+    auto candidate = end(peer);
+    if (candidate == nullptr) {
+      return;
+    }
+    auto rtt = now - candidate->started;
+    latencies_->update(peer, rtt);
+    if (routing_table_) {
+      routing_table_->onResponse(peer, rtt);
+    }
+    candidate->state = State::SUCCEEDED;
+    auto path = candidate->path;
+    auto node_ids = NodeId::fromPeers(closer_peers);
+    for (size_t i = 0; i < closer_peers.size(); ++i) {
+      add(closer_peers[i], node_ids[i], path);
+    }
+    updatePath(path);
+  }
+
+  void Query::onSkipped(const PeerId &peer) {
+    auto candidate = end(peer);
+    if (candidate == nullptr) {
+      return;
+    }
+    candidate->state = State::FAILED;
+    updatePath(candidate->path);
+  }
+
+  void Query::onFailure(const PeerId &peer, Time now) {
+    auto candidate = end(peer);
+    if (candidate == nullptr) {
+      return;
+    }
+    latencies_->update(peer, now - candidate->started);
+    if (routing_table_) {
+      routing_table_->onFailure(peer);
+    }
+    candidate->state = State::FAILED;
+    updatePath(candidate->path);
+  }
+
+  bool Query::finished() const {
+    return std::all_of(paths_.begin(), paths_.end(), [](const Path &path) {
+      return path.finished;
+    });
+  }
+
+  size_t Query::inProgress() const {
+    return in_progress_;
+  }
+
+  size_t Query::waiting() const {
+    return waiting_;
+  }
+
+  Time Query::stallTimeout() const {
+    auto average = latencies_->average();
+    if (not average) {
+      return config_.query_stall_timeout;
+    }
+    return std::min<Time>(*average * 2, config_.query_stall_timeout);
+  }
+
+  void Query::add(const PeerId &peer, const NodeId &node_id, size_t path) {
+    if (not seen_.emplace(peer).second) {
+      return;
+    }
+    Candidate candidate{peer, node_id.distance(target_), path};
+    auto it = std::upper_bound(candidates_.begin(),
+                               candidates_.end(),
+                               candidate.distance,
+                               [](const Hash256 &distance, const Candidate &c) {
+                                 return distance < c.distance;
+                               });
+    candidates_.insert(it, std::move(candidate));
+    ++waiting_;
+  }
+
+  Query::Candidate *Query::end(const PeerId &peer) {
+    auto it = std::find_if(
+        candidates_.begin(), candidates_.end(), [&](const Candidate &c) {
+          return c.state == State::IN_PROGRESS and c.peer == peer;
+        });
+    if (it == candidates_.end()) {
+      return nullptr;
+    }
+    --paths_[it->path].in_progress;
+    --in_progress_;
+    return &*it;
+  }
+
+  void Query::updatePath(size_t path) {
+    // finished when K closest candidates, which have not failed, responded
+    size_t responded = 0;
+    bool finished = true;
+    for (auto &candidate : candidates_) {
+      if (candidate.path != path or candidate.state == State::FAILED) {
+        continue;
+      }
+      if (candidate.state != State::SUCCEEDED) {
+        finished = false;
+        break;
+      }
+      if (++responded >= config_.replication_factor) {
+        break;
+      }
+    }
+    paths_[path].finished = finished;
+  }
+
+  size_t Query::concurrency(size_t path, Time now) const {
+    auto stall_timeout = stallTimeout();
+    size_t stalled = 0;
+    for (auto &candidate : candidates_) {
+      if (candidate.path == path and candidate.state == State::IN_PROGRESS
+          and now - candidate.started >= stall_timeout) {
+        ++stalled;
+      }
+    }
+    return std::min(
+        config_.requestConcurency + stalled,
+        std::max(config_.query_max_concurrency, config_.requestConcurency));
+  }
+
+}  // namespace libp2p::protocol::kademlia
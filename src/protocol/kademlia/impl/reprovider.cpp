@@ -0,0 +1,232 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/protocol/kademlia/impl/reprovider.hpp>
+
+#include <algorithm>
+#include <bit>
+
+#include <libp2p/common/metrics/registry.hpp>
+#include <libp2p/protocol/kademlia/impl/session.hpp>
+
+namespace libp2p::protocol::kademlia {
+
+  namespace {
+    metrics::Counter &keysCounter() {
+      static auto &counter = metrics::Registry::instance().counter(
+          "libp2p_kademlia_reprovide_keys_total",
+          "Keys taken for announcement by batch reprovider");
+      return counter;
+    }
+
+    metrics::Counter &messagesCounter() {
+      static auto &counter = metrics::Registry::instance().counter(
+          "libp2p_kademlia_reprovide_messages_total",
+          "ADD_PROVIDER messages written by batch reprovider");
+      return counter;
+    }
+
+    metrics::Counter &failuresCounter() {
+      static auto &counter = metrics::Registry::instance().counter(
+          "libp2p_kademlia_reprovide_failures_total",
+          "ADD_PROVIDER messages batch reprovider failed to deliver");
+      return counter;
+    }
+
+    metrics::Gauge &queueGauge() {
+      static auto &gauge = metrics::Registry::instance().gauge(
+          "libp2p_kademlia_reprovide_queue",
+          "Keys waiting for announcement by batch reprovider");
+      return gauge;
+    }
+  }  // namespace
+
+  ProviderBatches batchProviderRecords(const std::vector<ContentId> &keys,
+                                       const std::vector<PeerId> &candidates,
+                                       size_t closest) {
+    std::vector<NodeId> nodes;
+    nodes.reserve(candidates.size());
+    for (auto &peer_id : candidates) {
+      nodes.emplace_back(peer_id);
+    }
+    std::vector<size_t> order(candidates.size());
+    auto count = std::min(closest, candidates.size());
+
+    ProviderBatches batches;
+    for (auto &key : keys) {
+      auto target = NodeId::hash(key);
+      for (size_t i = 0; i < order.size(); ++i) {
+        order[i] = i;
+      }
+      std::partial_sort(order.begin(),
+                        order.begin() + static_cast<ptrdiff_t>(count),
+                        order.end(),
+                        [&](size_t a, size_t b) {
+                          return nodes[a].distance(target)
+                               < nodes[b].distance(target);
+                        });
+      for (size_t i = 0; i < count; ++i) {
+        batches[candidates[order[i]]].push_back(key);
+      }
+    }
+    return batches;
+  }
+
+  size_t reproviderRegionBits(size_t known_peers, size_t closest) {
+    if (closest == 0 or known_peers <= closest) {
+      return 0;
+    }
+    // each region holds about closest known peers
+    return std::bit_width(known_peers / closest) - 1;
+  }
+
+  Reprovider::Reprovider(const Config &config,
+                         std::shared_ptr<Host> host,
+                         std::shared_ptr<basic::Scheduler> scheduler,
+                         std::weak_ptr<SessionHost> session_host,
+                         std::shared_ptr<PeerRoutingTable> peer_routing_table)
+      : config_(config),
+        host_(std::move(host)),
+        scheduler_(std::move(scheduler)),
+        session_host_(std::move(session_host)),
+        peer_routing_table_(std::move(peer_routing_table)),
+        log_("Reprovider", "kademlia") {
+    BOOST_ASSERT(host_ != nullptr);
+    BOOST_ASSERT(scheduler_ != nullptr);
+    BOOST_ASSERT(peer_routing_table_ != nullptr);
+  }
+
+  Reprovider::~Reprovider() {
+    queueGauge().sub(static_cast<int64_t>(queue_.size()));
+  }
+
+  void Reprovider::provide(const std::vector<ContentId> &keys) {
+    auto before = queue_.size();
+    std::vector<BytesIn> inputs{keys.begin(), keys.end()};
+    std::vector<Hash256> hashes(keys.size());
+    crypto::sha256Batch(inputs, hashes);
+    for (size_t i = 0; i < keys.size(); ++i) {
+      queue_.emplace(hashes[i], keys[i]);
+    }
+    queueGauge().add(static_cast<int64_t>(queue_.size() - before));
+
+    if (batches_in_progress_ == 0 and not pacing_timer_) {
+      announceRegion();
+    }
+  }
+
+  void Reprovider::announceRegion() {
+    if (queue_.empty() or batches_in_progress_ != 0) {
+      return;
+    }
+
+    auto bits = reproviderRegionBits(peer_routing_table_->size(),
+                                     config_.closerPeerCount);
+    auto first = NodeId::prehashed(queue_.begin()->first);
+    std::vector<ContentId> keys;
+    for (auto it = queue_.begin();
+         it != queue_.end()
+         and keys.size() < std::max<size_t>(config_.reprovideBatchSize, 1)
+         and NodeId::prehashed(it->first).commonPrefixLen(first) >= bits;) {
+      keys.emplace_back(std::move(it->second));
+      it = queue_.erase(it);
+    }
+    keysCounter().inc(keys.size());
+    queueGauge().sub(static_cast<int64_t>(keys.size()));
+
+    // one lookup for the whole region, from its middle
+    auto candidates = peer_routing_table_->getNearestPeers(
+        NodeId::hash(keys[keys.size() / 2]), config_.closerPeerCount * 2);
+    std::erase(candidates, host_->getId());
+    auto batches =
+        batchProviderRecords(keys, candidates, config_.closerPeerCount);
+
+    log_.debug("region of {} keys to {} peers, {} keys in queue",
+               keys.size(),
+               batches.size(),
+               queue_.size());
+
+    region_messages_ = 0;
+    batches_in_progress_ = batches.size() + 1;
+    for (auto &[peer_id, peer_keys] : batches) {
+      sendBatch(peer_id, peer_keys);
+    }
+    // region is finished even if it had no batches
+    onBatchDone(0, true);
+  }
+
+  void Reprovider::sendBatch(const PeerId &peer_id,
+                             const std::vector<ContentId> &keys) {
+    auto session_host = session_host_.lock();
+    auto peer_info = host_->getPeerRepository().getPeerInfo(peer_id);
+    if (not session_host or peer_info.addresses.empty()
+        or host_->connectedness(peer_info)
+               == Message::Connectedness::CAN_NOT_CONNECT) {
+      onBatchDone(keys.size(), false);
+      return;
+    }
+
+    auto frames = std::make_shared<Bytes>();
+    auto self_peer_info = host_->getPeerInfo();
+    for (auto &key : keys) {
+      Bytes frame;
+      if (createAddProviderRequest(self_peer_info, key).serialize(frame)) {
+        frames->insert(frames->end(), frame.begin(), frame.end());
+      }
+    }
+    auto messages = keys.size();
+    region_messages_ += messages;
+
+    auto holder = std::make_shared<
+        std::pair<std::shared_ptr<Reprovider>, basic::Scheduler::Handle>>();
+    auto finish = [holder, messages](bool success) {
+      if (holder->first) {
+        holder->second.reset();
+        holder->first->onBatchDone(messages, success);
+        holder->first.reset();
+      }
+    };
+
+    holder->first = shared_from_this();
+    holder->second = scheduler_->scheduleWithHandle(
+        [finish] { finish(false); },
+        config_.connectionTimeout + config_.responseTimeout);
+
+    session_host->getSession(
+        peer_info, [finish, frames](SessionOrError session_res) {
+          if (not session_res) {
+            finish(false);
+            return;
+          }
+          session_res.value()->send(
+              *frames,
+              [finish, frames](outcome::result<void> r) {
+                finish(r.has_value());
+              });
+        });
+  }
+
+  void Reprovider::onBatchDone(size_t messages, bool success) {
+    (success ? messagesCounter() : failuresCounter()).inc(messages);
+    if (--batches_in_progress_ != 0) {
+      return;
+    }
+
+    auto delay = config_.reprovideRate == 0
+                   ? std::chrono::milliseconds::zero()
+                   : std::chrono::milliseconds(region_messages_ * 1000
+                                               / config_.reprovideRate);
+    pacing_timer_ = scheduler_->scheduleWithHandle(
+        [weak_self{weak_from_this()}] {
+          if (auto self = weak_self.lock()) {
+            self->pacing_timer_.reset();
+            self->announceRegion();
+          }
+        },
+        delay);
+  }
+
+}  // namespace libp2p::protocol::kademlia
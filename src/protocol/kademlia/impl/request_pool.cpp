@@ -0,0 +1,73 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/protocol/kademlia/impl/request_pool.hpp>
+
+#include <algorithm>
+
+#include <boost/asio/post.hpp>
+
+namespace libp2p::protocol::kademlia {
+
+  NearestPeersSnapshot::NearestPeersSnapshot(std::vector<Entry> entries)
+      : entries_{std::move(entries)} {}
+
+  Message::Peers NearestPeersSnapshot::nearest(const NodeId &node,
+                                               size_t count) const {
+    std::vector<std::pair<common::Hash256, const Entry *>> distances;
+    distances.reserve(entries_.size());
+    for (auto &entry : entries_) {
+      distances.emplace_back(entry.node_id.distance(node), &entry);
+    }
+    auto middle =
+        distances.begin()
+        + static_cast<std::ptrdiff_t>(std::min(count, distances.size()));
+    // byte arrays compare lexicographically, as big endian distances
+    std::partial_sort(
+        distances.begin(), middle, distances.end(), [](auto &a, auto &b) {
+          return a.first < b.first;
+        });
+    Message::Peers peers;
+    peers.reserve(middle - distances.begin());
+    for (auto it = distances.begin(); it != middle; ++it) {
+      peers.emplace_back(it->second->peer);
+    }
+    return peers;
+  }
+
+  RequestPool::RequestPool(std::shared_ptr<basic::Scheduler> scheduler,
+                           size_t threads)
+      : scheduler_{std::move(scheduler)}, pool_{threads} {
+    BOOST_ASSERT(scheduler_ != nullptr);
+    BOOST_ASSERT(threads != 0);
+  }
+
+  RequestPool::~RequestPool() {
+    pool_.stop();
+    pool_.join();
+  }
+
+  void RequestPool::respond(Message msg, Fill fill, Handler handler) {
+    boost::asio::post(pool_,
+                      [scheduler{scheduler_},
+                       msg{std::move(msg)},
+                       fill{std::move(fill)},
+                       handler{std::move(handler)}]() mutable {
+                        auto cacheable = fill(msg);
+                        Bytes frame;
+                        if (not msg.serialize(frame)) {
+                          return;
+                        }
+                        scheduler->schedule([frame{std::move(frame)},
+                                             cacheable,
+                                             handler{std::move(handler)}]()
+                                                mutable {
+                          handler(std::move(frame), cacheable);
+                        });
+                      });
+  }
+
+}  // namespace libp2p::protocol::kademlia
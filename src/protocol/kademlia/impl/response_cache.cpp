@@ -0,0 +1,65 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/protocol/kademlia/impl/response_cache.hpp>
+
+#include <libp2p/common/metrics/registry.hpp>
+
+namespace libp2p::protocol::kademlia {
+
+  namespace {
+    metrics::Counter &hitsCounter() {
+      static auto &counter = metrics::Registry::instance().counter(
+          "libp2p_kademlia_response_cache_hits_total",
+          "Kademlia requests answered with cached response");
+      return counter;
+    }
+  }  // namespace
+
+  ResponseCache::ResponseCache(Time ttl, size_t max_size)
+      : ttl_(ttl), max_size_(max_size) {}
+
+  std::optional<BytesIn> ResponseCache::get(const ContentId &key,
+                                            Time now) const {
+    auto it = entries_.find(key);
+    if (it == entries_.end() or it->second.expires <= now) {
+      return std::nullopt;
+    }
+    hitsCounter().inc();
+    return BytesIn{it->second.frame};
+  }
+
+  void ResponseCache::put(const ContentId &key, Bytes frame, Time now) {
+    if (ttl_ == Time::zero() or max_size_ == 0) {
+      return;
+    }
+    // evict expired and the oldest if full
+    while (not order_.empty()) {
+      auto &[oldest, expires] = order_.front();
+      if (expires > now and entries_.size() < max_size_) {
+        break;
+      }
+      auto it = entries_.find(oldest);
+      if (it != entries_.end() and it->second.expires == expires) {
+        entries_.erase(it);
+      }
+      order_.pop_front();
+    }
+    auto expires = now + ttl_;
+    entries_.insert_or_assign(key, Entry{std::move(frame), expires});
+    order_.emplace_back(key, expires);
+  }
+
+  void ResponseCache::erase(const ContentId &key) {
+    entries_.erase(key);
+  }
+
+  void ResponseCache::clear() {
+    entries_.clear();
+    order_.clear();
+  }
+
+}  // namespace libp2p::protocol::kademlia
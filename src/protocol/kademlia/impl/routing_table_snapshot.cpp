@@ -0,0 +1,136 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/protocol/kademlia/impl/routing_table_snapshot.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+
+#include <libp2p/multi/uvarint.hpp>
+#include <libp2p/protocol/kademlia/error.hpp>
+
+namespace libp2p::protocol::kademlia {
+
+  namespace {
+    constexpr uint64_t kSnapshotVersion = 1;
+
+    void putUVarint(Bytes &out, uint64_t value) {
+      multi::UVarint varint{value};
+      auto bytes = varint.toBytes();
+      out.insert(out.end(), bytes.begin(), bytes.end());
+    }
+
+    void putBytes(Bytes &out, BytesIn bytes) {
+      putUVarint(out, bytes.size());
+      out.insert(out.end(), bytes.begin(), bytes.end());
+    }
+
+    /// Reads fields from the front of input
+    struct Reader {
+      boost::optional<uint64_t> uvarint() {
+        auto varint = multi::UVarint::create(input);
+        if (not varint) {
+          return boost::none;
+        }
+        input = input.subspan(varint->size());
+        return varint->toUInt64();
+      }
+
+      boost::optional<BytesIn> bytes() {
+        auto size = uvarint();
+        if (not size or *size > input.size()) {
+          return boost::none;
+        }
+        auto bytes = input.first(*size);
+        input = input.subspan(*size);
+        return bytes;
+      }
+
+      BytesIn input;
+    };
+  }  // namespace
+
+  Bytes encodeRoutingTableSnapshot(const std::vector<PeerInfo> &peers) {
+    Bytes out;
+    putUVarint(out, kSnapshotVersion);
+    putUVarint(out, peers.size());
+    for (auto &peer : peers) {
+      putBytes(out, peer.id.toVector());
+      putUVarint(out, peer.addresses.size());
+      for (auto &address : peer.addresses) {
+        putBytes(out, address.getBytesAddress());
+      }
+    }
+    return out;
+  }
+
+  outcome::result<std::vector<PeerInfo>> decodeRoutingTableSnapshot(
+      BytesIn bytes) {
+    Reader reader{bytes};
+    auto version = reader.uvarint();
+    if (version != kSnapshotVersion) {
+      return Error::MESSAGE_DESERIALIZE_ERROR;
+    }
+    auto count = reader.uvarint();
+    if (not count) {
+      return Error::MESSAGE_DESERIALIZE_ERROR;
+    }
+    std::vector<PeerInfo> peers;
+    for (uint64_t i = 0; i < *count; ++i) {
+      auto id_bytes = reader.bytes();
+      if (not id_bytes) {
+        return Error::MESSAGE_DESERIALIZE_ERROR;
+      }
+      OUTCOME_TRY(id, PeerId::fromBytes(*id_bytes));
+      PeerInfo peer{std::move(id), {}};
+      auto addresses = reader.uvarint();
+      if (not addresses) {
+        return Error::MESSAGE_DESERIALIZE_ERROR;
+      }
+      for (uint64_t j = 0; j < *addresses; ++j) {
+        auto address_bytes = reader.bytes();
+        if (not address_bytes) {
+          return Error::MESSAGE_DESERIALIZE_ERROR;
+        }
+        OUTCOME_TRY(address, multi::Multiaddress::create(*address_bytes));
+        peer.addresses.emplace_back(std::move(address));
+      }
+      peers.emplace_back(std::move(peer));
+    }
+    return peers;
+  }
+
+  outcome::result<void> saveRoutingTableSnapshot(
+      const std::string &path, const std::vector<PeerInfo> &peers) {
+    auto bytes = encodeRoutingTableSnapshot(peers);
+    auto tmp_path = path + ".tmp";
+    {
+      std::ofstream file{tmp_path, std::ios::binary | std::ios::trunc};
+      file.write(reinterpret_cast<const char *>(bytes.data()),
+                 static_cast<std::streamsize>(bytes.size()));
+      if (not file.good()) {
+        return Error::STORAGE_ERROR;
+      }
+    }
+    if (std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+      return Error::STORAGE_ERROR;
+    }
+    return outcome::success();
+  }
+
+  outcome::result<std::vector<PeerInfo>> loadRoutingTableSnapshot(
+      const std::string &path) {
+    std::ifstream file{path, std::ios::binary};
+    if (not file.is_open()) {
+      return Error::STORAGE_ERROR;
+    }
+    Bytes bytes{std::istreambuf_iterator<char>{file},
+                std::istreambuf_iterator<char>{}};
+    return decodeRoutingTableSnapshot(bytes);
+  }
+
+}  // namespace libp2p::protocol::kademlia
@@ -8,7 +8,7 @@
 
 #include <qtils/bytes.hpp>
 
-#include <libp2p/basic/message_read_writer_uvarint.hpp>
+#include <libp2p/basic/message_batch_reader.hpp>
 #include <libp2p/basic/write.hpp>
 #include <libp2p/protocol/kademlia/error.hpp>
 #include <libp2p/protocol/kademlia/impl/response_handler.hpp>
@@ -21,39 +21,56 @@ namespace libp2p::protocol::kademlia {
       : scheduler_{std::move(scheduler)},
         stream_{std::move(stream)},
         operations_timeout_{operations_timeout},
-        framing_{std::make_shared<basic::MessageReadWriterUvarint>(stream_)} {}
+        reader_{std::make_shared<basic::MessageBatchReader>(stream_)} {}
 
   Session::~Session() {
     stream_->reset();
   }
 
   void Session::read(OnRead on_read) {
+    if (not received_.empty()) {
+      auto r = std::move(received_.front());
+      received_.pop_front();
+      stream_->deferReadCallback(
+          0,
+          [self{shared_from_this()}, on_read{std::move(on_read)}, r](
+              outcome::result<size_t>) { on_read(r); });
+      return;
+    }
     setTimer();
-    framing_->read([self{shared_from_this()}, on_read{std::move(on_read)}](
-                       basic::MessageReadWriter::ReadCallback r) {
-      self->timer_.reset();
-      if (not r) {
-        on_read(r.error());
-        return;
-      }
-      Message msg;
-      if (not msg.deserialize(*r.value())) {
-        on_read(Error::MESSAGE_DESERIALIZE_ERROR);
-        return;
-      }
-      on_read(std::move(msg));
-    });
+    reader_->readMany(
+        [self{shared_from_this()}, on_read{std::move(on_read)}](
+            outcome::result<basic::MessageBatchReader::Messages> frames) {
+          self->timer_.cancel();
+          if (not frames) {
+            on_read(frames.error());
+            return;
+          }
+          // responses to pipelined requests often come together
+          for (auto &frame : frames.value()) {
+            Message msg;
+            if (not msg.deserialize(frame)) {
+              self->received_.emplace_back(Error::MESSAGE_DESERIALIZE_ERROR);
+              break;
+            }
+            self->received_.emplace_back(std::move(msg));
+          }
+          auto r = std::move(self->received_.front());
+          self->received_.pop_front();
+          on_read(std::move(r));
+        });
   }
 
   void Session::write(BytesIn frame, OnWrite on_write) {
     setTimer();
+    // frame may be released by caller before written
     auto buf = std::make_shared<Bytes>(qtils::asVec(frame));
     libp2p::write(stream_,
-                  frame,
+                  *buf,
                   [self{shared_from_this()},
                    on_write{std::move(on_write)},
                    buf](outcome::result<void> r) {
-                    self->timer_.reset();
+                    self->timer_.cancel();
                     if (not r) {
                       on_write(r.error());
                       return;
@@ -93,7 +110,12 @@ namespace libp2p::protocol::kademlia {
     if (not msg.serialize(pb)) {
       return;
     }
-    write(pb,
+    write(pb, std::move(weak_session_host));
+  }
+
+  void Session::write(BytesIn frame,
+                      std::weak_ptr<SessionHost> weak_session_host) {
+    write(frame,
           [self{shared_from_this()},
            weak_session_host{std::move(weak_session_host)}](
               outcome::result<void> r) {
@@ -106,19 +128,106 @@ namespace libp2p::protocol::kademlia {
 
   void Session::write(BytesIn frame,
                       std::shared_ptr<ResponseHandler> response_handler) {
-    write(
-        frame,
-        [self{shared_from_this()}, response_handler](outcome::result<void> r) {
+    if (closed()) {
+      response_handler->onResult(shared_from_this(), Error::SESSION_CLOSED);
+      return;
+    }
+    requests_.push_back({qtils::asVec(frame), nullptr});
+    response_handlers_.emplace_back(std::move(response_handler));
+    writeRequests();
+    readResponse();
+  }
+
+  void Session::send(BytesIn frames, OnWrite on_write) {
+    if (closed()) {
+      on_write(Error::SESSION_CLOSED);
+      return;
+    }
+    requests_.push_back({qtils::asVec(frames), std::move(on_write)});
+    writeRequests();
+  }
+
+  void Session::write(BytesIn frame) {
+    write(frame, [self{shared_from_this()}](outcome::result<void> r) {});
+  }
+
+  bool Session::closed() const {
+    return failed_ or stream_->isClosed();
+  }
+
+  void Session::writeRequests() {
+    if (writing_ or requests_.empty()) {
+      return;
+    }
+    writing_ = true;
+    // requests queued while previous write was in progress go out at once
+    auto requests = std::make_shared<std::vector<Request>>(
+        std::make_move_iterator(requests_.begin()),
+        std::make_move_iterator(requests_.end()));
+    requests_.clear();
+    std::vector<BytesIn> buffers;
+    buffers.reserve(requests->size());
+    for (auto &request : *requests) {
+      buffers.emplace_back(request.frames);
+    }
+    libp2p::writeVectored(
+        stream_,
+        std::move(buffers),
+        [self{shared_from_this()}, requests](outcome::result<void> r) {
+          self->writing_ = false;
+          for (auto &request : *requests) {
+            if (request.on_write) {
+              request.on_write(r);
+            }
+          }
           if (not r) {
-            response_handler->onResult(self, r.error());
+            self->fail(r.error());
             return;
           }
-          self->read(std::move(response_handler));
+          self->writeRequests();
         });
   }
 
-  void Session::write(BytesIn frame) {
-    write(frame, [self{shared_from_this()}](outcome::result<void> r) {});
+  void Session::readResponse() {
+    if (reading_ or failed_ or response_handlers_.empty()) {
+      return;
+    }
+    reading_ = true;
+    read([self{shared_from_this()}](outcome::result<Message> r) {
+      self->reading_ = false;
+      if (self->response_handlers_.empty()) {
+        return;
+      }
+      auto response_handler = self->response_handlers_.front();
+      if (r and not response_handler->match(r.value())) {
+        r = Error::UNEXPECTED_MESSAGE_TYPE;
+      }
+      if (not r) {
+        // order of responses is lost, so are all pending requests
+        self->fail(r.error());
+        return;
+      }
+      self->response_handlers_.pop_front();
+      response_handler->onResult(self, std::move(r));
+      self->readResponse();
+    });
+  }
+
+  void Session::fail(const std::error_code &error) {
+    failed_ = true;
+    auto requests = std::move(requests_);
+    requests_.clear();
+    stream_->reset();
+    for (auto &request : requests) {
+      if (request.on_write) {
+        request.on_write(error);
+      }
+    }
+    auto response_handlers = std::move(response_handlers_);
+    response_handlers_.clear();
+    for (auto &response_handler : response_handlers) {
+      response_handler->onResult(shared_from_this(), error);
+    }
   }
 
   void Session::setTimer() {
@@ -129,7 +238,8 @@ namespace libp2p::protocol::kademlia {
     if (not scheduler) {
       return;
     }
-    timer_ = scheduler->scheduleWithHandle(
+    scheduler->arm(
+        timer_,
         [weak_self = weak_from_this()] {
           auto self = weak_self.lock();
           if (not self) {
@@ -0,0 +1,139 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/protocol/kademlia/impl/session_pool.hpp>
+
+#include <algorithm>
+
+#include <libp2p/protocol/kademlia/error.hpp>
+
+namespace libp2p::protocol::kademlia {
+
+  SessionPool::SessionPool(const Config &config,
+                           std::shared_ptr<Host> host,
+                           std::shared_ptr<basic::Scheduler> scheduler)
+      : config_(config),
+        host_(std::move(host)),
+        scheduler_(std::move(scheduler)) {
+    BOOST_ASSERT(host_ != nullptr);
+    BOOST_ASSERT(scheduler_ != nullptr);
+  }
+
+  void SessionPool::getSession(const PeerInfo &peer, OnSession on_session) {
+    auto opening_it = opening_.find(peer.id);
+    size_t streams = opening_it != opening_.end() ? opening_it->second : 0;
+
+    if (auto it = sessions_.find(peer.id); it != sessions_.end()) {
+      auto &entries = it->second;
+      std::erase_if(entries,
+                    [](const Entry &entry) { return entry.session->closed(); });
+      streams += entries.size();
+      auto least_loaded = std::min_element(
+          entries.begin(), entries.end(), [](auto &a, auto &b) {
+            return a.session->pending() < b.session->pending();
+          });
+      if (least_loaded != entries.end()) {
+        auto pending = least_loaded->session->pending();
+        if (pending == 0
+            or (streams >= config_.maxStreamsPerPeer
+                and pending < config_.maxPipelinedRequests)) {
+          least_loaded->used = scheduler_->now();
+          on_session(least_loaded->session);
+          return;
+        }
+      }
+    }
+
+    openSession(
+        peer, streams < config_.maxStreamsPerPeer, std::move(on_session));
+  }
+
+  size_t SessionPool::sessions(const PeerId &peer_id) const {
+    auto it = sessions_.find(peer_id);
+    return it != sessions_.end() ? it->second.size() : 0;
+  }
+
+  void SessionPool::openSession(const PeerInfo &peer,
+                                bool keep,
+                                OnSession on_session) {
+    if (keep) {
+      ++opening_[peer.id];
+    }
+    host_->newStream(
+        peer,
+        config_.protocols,
+        [weak_self{weak_from_this()},
+         peer_id{peer.id},
+         keep,
+         on_session{std::move(on_session)}](auto &&stream_res) {
+          auto self = weak_self.lock();
+          if (not self) {
+            on_session(Error::SESSION_CLOSED);
+            return;
+          }
+          self->onStream(peer_id, keep, std::move(stream_res), on_session);
+        });
+  }
+
+  void SessionPool::onStream(const PeerId &peer_id,
+                             bool keep,
+                             StreamAndProtocolOrError stream_res,
+                             const OnSession &on_session) {
+    if (keep) {
+      auto it = opening_.find(peer_id);
+      if (it != opening_.end() and --it->second == 0) {
+        opening_.erase(it);
+      }
+    }
+    if (not stream_res) {
+      on_session(stream_res.error());
+      return;
+    }
+    auto session = std::make_shared<Session>(
+        scheduler_, stream_res.value().stream, config_.responseTimeout);
+    if (keep) {
+      sessions_[peer_id].push_back({session, scheduler_->now()});
+      if (not cleanup_timer_) {
+        setCleanupTimer();
+      }
+    }
+    on_session(std::move(session));
+  }
+
+  void SessionPool::onCleanupTimer() {
+    auto now = scheduler_->now();
+    for (auto it = sessions_.begin(); it != sessions_.end();) {
+      std::erase_if(it->second, [&](const Entry &entry) {
+        return entry.session->closed()
+            or (entry.session->pending() == 0
+                and now - entry.used >= config_.streamIdleTimeout);
+      });
+      if (it->second.empty()) {
+        it = sessions_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+    if (not sessions_.empty()) {
+      setCleanupTimer();
+    }
+  }
+
+  void SessionPool::setCleanupTimer() {
+    cleanup_timer_ = scheduler_->scheduleWithHandle(
+        [weak_self{weak_from_this()}] {
+          auto self = weak_self.lock();
+          if (not self) {
+            return;
+          }
+          self->cleanup_timer_.reset();
+          self->onCleanupTimer();
+        },
+        config_.streamIdleTimeout,
+        basic::Scheduler::Priority::BACKGROUND);
+  }
+
+}  // namespace libp2p::protocol::kademlia
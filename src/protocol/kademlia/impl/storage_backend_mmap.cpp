@@ -0,0 +1,434 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/protocol/kademlia/impl/storage_backend_mmap.hpp>
+
+#include <array>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+
+#include <boost/endian/conversion.hpp>
+
+#include <libp2p/protocol/kademlia/error.hpp>
+
+namespace libp2p::protocol::kademlia {
+
+  namespace {
+    /// Log starts with magic, then records of 4-byte key size, 4-byte value
+    /// size or kErased, 8-byte time of put, key and value, all
+    /// little-endian. Key size is written last, so zero key size marks end
+    /// of log, and record torn by crash is not loaded
+    constexpr std::array<uint8_t, 8> kMagic{'K', 'A', 'D', 'L', 'O', 'G', 0, 1};
+    constexpr size_t kRecordHeaderSize = 16;
+    constexpr uint32_t kErased = std::numeric_limits<uint32_t>::max();
+
+    constexpr size_t kInitialCapacity = 1 << 20;
+
+    /// Smaller logs are not compacted
+    constexpr size_t kMinCompactedSize = kInitialCapacity;
+
+    /// Values must outlive restart, so wall clock is used instead of
+    /// scheduler time
+    Time wallClock() {
+      return std::chrono::duration_cast<Time>(
+          std::chrono::system_clock::now().time_since_epoch());
+    }
+  }  // namespace
+
+  outcome::result<std::unique_ptr<StorageBackendMmap::Log>>
+  StorageBackendMmap::Log::open(
+      const std::string &path,
+      const std::function<void(BytesIn key, boost::optional<Location> location)>
+          &on_record) {
+    std::error_code ec;
+    auto exists = std::filesystem::exists(path, ec);
+    if (ec) {
+      return Error::STORAGE_ERROR;
+    }
+    size_t capacity = kInitialCapacity;
+    if (exists) {
+      capacity = std::filesystem::file_size(path, ec);
+      if (ec or capacity < kMagic.size()) {
+        return Error::STORAGE_ERROR;
+      }
+    } else {
+      std::ofstream file{path, std::ios::binary | std::ios::trunc};
+      if (not file.good()) {
+        return Error::STORAGE_ERROR;
+      }
+    }
+
+    std::unique_ptr<Log> log{new Log{path, capacity}};
+    OUTCOME_TRY(log->map(capacity));
+    auto data = log->data();
+    if (not exists) {
+      std::copy(kMagic.begin(), kMagic.end(), data);
+    } else if (not std::equal(kMagic.begin(), kMagic.end(), data)) {
+      return Error::STORAGE_ERROR;
+    }
+
+    auto offset = kMagic.size();
+    while (capacity - offset >= kRecordHeaderSize) {
+      auto header = data + offset;
+      uint32_t key_size = boost::endian::load_little_u32(header);
+      if (key_size == 0) {
+        break;
+      }
+      uint32_t value_size = boost::endian::load_little_u32(header + 4);
+      Time stored_at{boost::endian::load_little_s64(header + 8)};
+      auto erased = value_size == kErased;
+      auto size =
+          kRecordHeaderSize + key_size + (erased ? 0 : size_t{value_size});
+      if (size > capacity - offset) {
+        break;
+      }
+      if (on_record) {
+        auto key = header + kRecordHeaderSize;
+        on_record(BytesIn{key, key_size},
+                  erased ? boost::optional<Location>{}
+                         : Location{offset + kRecordHeaderSize + key_size,
+                                    value_size,
+                                    stored_at});
+      }
+      offset += size;
+    }
+    log->end_ = offset;
+    return log;
+  }
+
+  StorageBackendMmap::Log::Log(std::string path, size_t capacity)
+      : path_{std::move(path)}, capacity_{capacity}, end_{kMagic.size()} {}
+
+  outcome::result<void> StorageBackendMmap::Log::map(size_t capacity) {
+    // previous mapping is kept if any step fails
+    std::error_code ec;
+    std::filesystem::resize_file(path_, capacity, ec);
+    if (ec) {
+      return Error::STORAGE_ERROR;
+    }
+    try {
+      boost::interprocess::file_mapping mapping{
+          path_.c_str(), boost::interprocess::read_write};
+      boost::interprocess::mapped_region region{
+          mapping, boost::interprocess::read_write};
+      mapping_.swap(mapping);
+      region_.swap(region);
+    } catch (const boost::interprocess::interprocess_exception &) {
+      return Error::STORAGE_ERROR;
+    }
+    capacity_ = capacity;
+    return outcome::success();
+  }
+
+  uint8_t *StorageBackendMmap::Log::data() const {
+    return static_cast<uint8_t *>(region_.get_address());
+  }
+
+  outcome::result<StorageBackendMmap::Location>
+  StorageBackendMmap::Log::append(BytesIn key,
+                                  boost::optional<BytesIn> value,
+                                  Time stored_at) {
+    auto value_size = value ? value->size() : 0;
+    if (key.empty() or value_size >= kErased) {
+      return Error::STORAGE_ERROR;
+    }
+    auto size = kRecordHeaderSize + key.size() + value_size;
+    if (size > capacity_ - end_) {
+      auto capacity = capacity_;
+      while (size > capacity - end_) {
+        capacity *= 2;
+      }
+      OUTCOME_TRY(map(capacity));
+    }
+
+    auto header = data() + end_;
+    std::copy(key.begin(), key.end(), header + kRecordHeaderSize);
+    if (value) {
+      std::copy(value->begin(),
+                value->end(),
+                header + kRecordHeaderSize + key.size());
+    }
+    boost::endian::store_little_u32(
+        header + 4, value ? static_cast<uint32_t>(value_size) : kErased);
+    boost::endian::store_little_s64(header + 8, stored_at.count());
+    boost::endian::store_little_u32(header, static_cast<uint32_t>(key.size()));
+
+    Location location{end_ + kRecordHeaderSize + key.size(),
+                      static_cast<uint32_t>(value_size),
+                      stored_at};
+    end_ += size;
+    return location;
+  }
+
+  BytesIn StorageBackendMmap::Log::view(const Location &location) const {
+    return {data() + location.offset, location.value_size};
+  }
+
+  outcome::result<void> StorageBackendMmap::Log::sync() {
+    if (not region_.flush(0, end_, false)) {
+      return Error::STORAGE_ERROR;
+    }
+    return outcome::success();
+  }
+
+  outcome::result<void> StorageBackendMmap::Log::rename(
+      const std::string &path) {
+    std::error_code ec;
+    std::filesystem::rename(path_, path, ec);
+    if (ec) {
+      return Error::STORAGE_ERROR;
+    }
+    path_ = path;
+    return outcome::success();
+  }
+
+  const std::string &StorageBackendMmap::Log::path() const {
+    return path_;
+  }
+
+  size_t StorageBackendMmap::Log::size() const {
+    return end_;
+  }
+
+  outcome::result<std::shared_ptr<StorageBackendMmap>>
+  StorageBackendMmap::create(const Config &config,
+                             std::string path,
+                             std::shared_ptr<basic::Scheduler> scheduler) {
+    Index index;
+    size_t garbage = 0;
+    OUTCOME_TRY(log,
+                Log::open(path,
+                          [&](BytesIn key, boost::optional<Location> location) {
+                            indexRecord(index,
+                                        garbage,
+                                        Key{key.begin(), key.end()},
+                                        location);
+                          }));
+    std::shared_ptr<StorageBackendMmap> backend{
+        new StorageBackendMmap{config,
+                               std::move(log),
+                               std::move(index),
+                               garbage,
+                               std::move(scheduler)}};
+    backend->maybeCompact();
+    return backend;
+  }
+
+  StorageBackendMmap::StorageBackendMmap(
+      const Config &config,
+      std::unique_ptr<Log> log,
+      Index index,
+      size_t garbage,
+      std::shared_ptr<basic::Scheduler> scheduler)
+      : config_(config),
+        log_(std::move(log)),
+        index_(std::move(index)),
+        garbage_(garbage),
+        scheduler_(std::move(scheduler)) {
+    BOOST_ASSERT(log_ != nullptr);
+    BOOST_ASSERT(scheduler_ != nullptr);
+  }
+
+  StorageBackendMmap::~StorageBackendMmap() {
+    abortCompaction();
+    std::ignore = log_->sync();
+  }
+
+  outcome::result<void> StorageBackendMmap::putValue(Key key, Value value) {
+    return write(key, BytesIn{value}, wallClock());
+  }
+
+  outcome::result<Value> StorageBackendMmap::getValue(const Key &key) const {
+    OUTCOME_TRY(view, viewValue(key));
+    return Value{view.begin(), view.end()};
+  }
+
+  outcome::result<void> StorageBackendMmap::erase(const Key &key) {
+    return write(key, boost::none, {});
+  }
+
+  std::vector<std::pair<Key, Time>> StorageBackendMmap::storedValues() const {
+    std::vector<std::pair<Key, Time>> values;
+    values.reserve(index_.size());
+    auto now = wallClock();
+    for (auto &[key, location] : index_) {
+      values.emplace_back(key, std::max(now - location.stored_at, Time::zero()));
+    }
+    return values;
+  }
+
+  outcome::result<BytesIn> StorageBackendMmap::viewValue(const Key &key) const {
+    auto it = index_.find(key);
+    if (it == index_.end()) {
+      return Error::VALUE_NOT_FOUND;
+    }
+    return log_->view(it->second);
+  }
+
+  outcome::result<void> StorageBackendMmap::compact() {
+    if (not compaction_) {
+      OUTCOME_TRY(startCompaction());
+    }
+    auto res = compactStep(compaction_->keys.size());
+    if (not res) {
+      abortCompaction();
+    }
+    return res;
+  }
+
+  size_t StorageBackendMmap::logSize() const {
+    return log_->size();
+  }
+
+  size_t StorageBackendMmap::garbageSize() const {
+    return garbage_;
+  }
+
+  size_t StorageBackendMmap::recordSize(const Key &key,
+                                        const Location &location) {
+    return kRecordHeaderSize + key.size() + location.value_size;
+  }
+
+  void StorageBackendMmap::indexRecord(Index &index,
+                                       size_t &garbage,
+                                       Key key,
+                                       boost::optional<Location> location) {
+    auto it = index.find(key);
+    if (it != index.end()) {
+      garbage += recordSize(key, it->second);
+    }
+    if (not location) {
+      // erase record itself is garbage
+      garbage += recordSize(key, {});
+      if (it != index.end()) {
+        index.erase(it);
+      }
+      return;
+    }
+    if (it != index.end()) {
+      it->second = location.value();
+    } else {
+      index.emplace(std::move(key), location.value());
+    }
+  }
+
+  outcome::result<void> StorageBackendMmap::write(
+      const Key &key, boost::optional<BytesIn> value, Time stored_at) {
+    auto append = [&](Log &log,
+                      Index &index,
+                      size_t &garbage) -> outcome::result<void> {
+      if (not value and not index.contains(key)) {
+        return outcome::success();
+      }
+      OUTCOME_TRY(location, log.append(key, value, stored_at));
+      indexRecord(index,
+                  garbage,
+                  key,
+                  value ? boost::make_optional(location) : boost::none);
+      return outcome::success();
+    };
+
+    OUTCOME_TRY(append(*log_, index_, garbage_));
+
+    // changes are written to compacted log too, copied records are outdated
+    if (compaction_) {
+      auto &compaction = compaction_.value();
+      if (not append(*compaction.log, compaction.index, compaction.garbage)) {
+        abortCompaction();
+      }
+    }
+
+    maybeCompact();
+    return outcome::success();
+  }
+
+  void StorageBackendMmap::maybeCompact() {
+    if (compaction_ or config_.storageCompactionGarbage == 0
+        or log_->size() < kMinCompactedSize
+        or garbage_ * 100 < log_->size() * config_.storageCompactionGarbage) {
+      return;
+    }
+    if (not startCompaction()) {
+      return;
+    }
+    scheduleCompactStep();
+  }
+
+  outcome::result<void> StorageBackendMmap::startCompaction() {
+    auto path = log_->path() + ".compact";
+    std::error_code ec;
+    std::filesystem::remove(path, ec);
+    OUTCOME_TRY(log, Log::open(path, {}));
+
+    Compaction compaction{std::move(log)};
+    compaction.keys.reserve(index_.size());
+    for (auto &[key, location] : index_) {
+      compaction.keys.emplace_back(key);
+    }
+    compaction_ = std::move(compaction);
+    return outcome::success();
+  }
+
+  void StorageBackendMmap::abortCompaction() {
+    compaction_timer_.reset();
+    if (not compaction_) {
+      return;
+    }
+    auto path = compaction_->log->path();
+    compaction_.reset();
+    std::error_code ec;
+    std::filesystem::remove(path, ec);
+  }
+
+  outcome::result<void> StorageBackendMmap::compactStep(size_t batch) {
+    auto &compaction = compaction_.value();
+    auto end = std::min(compaction.keys.size(), compaction.next + batch);
+    for (; compaction.next < end; ++compaction.next) {
+      auto &key = compaction.keys[compaction.next];
+      auto it = index_.find(key);
+
+      // erased, or written to both logs since compaction started
+      if (it == index_.end() or compaction.index.contains(key)) {
+        continue;
+      }
+      OUTCOME_TRY(location,
+                  compaction.log->append(
+                      key, log_->view(it->second), it->second.stored_at));
+      compaction.index.emplace(key, location);
+    }
+    if (compaction.next < compaction.keys.size()) {
+      return outcome::success();
+    }
+
+    compaction_timer_.reset();
+    OUTCOME_TRY(compaction.log->sync());
+    OUTCOME_TRY(compaction.log->rename(log_->path()));
+    log_ = std::move(compaction.log);
+    index_ = std::move(compaction.index);
+    garbage_ = compaction.garbage;
+    compaction_.reset();
+    return outcome::success();
+  }
+
+  void StorageBackendMmap::scheduleCompactStep() {
+    compaction_timer_ = scheduler_->scheduleWithHandle(
+        [weak_self{weak_from_this()}] {
+          auto self = weak_self.lock();
+          if (not self or not self->compaction_) {
+            return;
+          }
+          if (not self->compactStep(self->config_.storageCompactionBatch)) {
+            self->abortCompaction();
+            return;
+          }
+          if (self->compaction_) {
+            self->scheduleCompactStep();
+          }
+        });
+  }
+
+}  // namespace libp2p::protocol::kademlia
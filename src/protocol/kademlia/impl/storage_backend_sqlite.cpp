@@ -0,0 +1,162 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/protocol/kademlia/impl/storage_backend_sqlite.hpp>
+
+#include <libp2p/protocol/kademlia/error.hpp>
+
+namespace libp2p::protocol::kademlia {
+
+  namespace {
+    /// Values must outlive restart, so wall clock is used instead of
+    /// scheduler time
+    Time wallClock() {
+      return std::chrono::duration_cast<Time>(
+          std::chrono::system_clock::now().time_since_epoch());
+    }
+  }  // namespace
+
+  StorageBackendSqlite::StorageBackendSqlite(
+      const Config &config,
+      std::shared_ptr<storage::SQLite> db,
+      std::shared_ptr<basic::Scheduler> scheduler)
+      : config_(config),
+        db_(std::move(db)),
+        scheduler_(std::move(scheduler)),
+        cache_(config_.storageCacheSize) {
+    BOOST_ASSERT(db_ != nullptr);
+    BOOST_ASSERT(scheduler_ != nullptr);
+
+    std::string journal_mode;
+    *db_ << "PRAGMA journal_mode = WAL" >> journal_mode;
+    *db_ << "PRAGMA synchronous = NORMAL";
+    *db_ << "CREATE TABLE IF NOT EXISTS kademlia_values ("
+            "key BLOB PRIMARY KEY, "
+            "value BLOB NOT NULL, "
+            "stored_at INTEGER NOT NULL)";
+
+    begin_ = db_->createStatement("BEGIN");
+    commit_ = db_->createStatement("COMMIT");
+    rollback_ = db_->createStatement("ROLLBACK");
+    select_ =
+        db_->createStatement("SELECT value FROM kademlia_values WHERE key = ?");
+    select_ages_ =
+        db_->createStatement("SELECT key, stored_at FROM kademlia_values");
+    upsert_ = db_->createStatement(
+        "INSERT OR REPLACE INTO kademlia_values(key, value, stored_at) "
+        "VALUES(?, ?, ?)");
+    delete_ = db_->createStatement("DELETE FROM kademlia_values WHERE key = ?");
+  }
+
+  StorageBackendSqlite::~StorageBackendSqlite() {
+    std::ignore = flush();
+  }
+
+  outcome::result<void> StorageBackendSqlite::putValue(Key key, Value value) {
+    cache_.put(key, value);
+    addChange(key, {std::move(value), wallClock()});
+    return outcome::success();
+  }
+
+  outcome::result<Value> StorageBackendSqlite::getValue(const Key &key) const {
+    if (auto it = changes_.find(key); it != changes_.end()) {
+      if (not it->second.value) {
+        return Error::VALUE_NOT_FOUND;
+      }
+      return it->second.value.value();
+    }
+    if (auto value = cache_.get(key)) {
+      return *value;
+    }
+    boost::optional<Value> value;
+    if (not db_->execQuery(
+            select_, [&](Value stored) { value = std::move(stored); }, key)) {
+      return Error::STORAGE_ERROR;
+    }
+    if (not value) {
+      return Error::VALUE_NOT_FOUND;
+    }
+    return cache_.put(key, std::move(value.value()));
+  }
+
+  outcome::result<void> StorageBackendSqlite::erase(const Key &key) {
+    cache_.erase(key);
+    addChange(key, {boost::none, {}});
+    return outcome::success();
+  }
+
+  std::vector<std::pair<Key, Time>> StorageBackendSqlite::storedValues()
+      const {
+    std::vector<std::pair<Key, Time>> values;
+    auto now = wallClock();
+    db_->execQuery(select_ages_, [&](Key key, sqlite_int64 stored_at) {
+      values.emplace_back(std::move(key),
+                          std::max(now - Time(stored_at), Time::zero()));
+    });
+    return values;
+  }
+
+  outcome::result<void> StorageBackendSqlite::flush() {
+    flush_timer_.reset();
+    if (changes_.empty()) {
+      return outcome::success();
+    }
+
+    auto write = [&] {
+      if (db_->execCommand(begin_) < 0) {
+        return false;
+      }
+      for (auto &[key, change] : changes_) {
+        auto changed =
+            change.value
+                ? db_->execCommand(upsert_,
+                                   key,
+                                   change.value.value(),
+                                   sqlite_int64{change.stored_at.count()})
+                : db_->execCommand(delete_, key);
+        if (changed < 0) {
+          db_->execCommand(rollback_);
+          return false;
+        }
+      }
+      if (db_->execCommand(commit_) < 0) {
+        db_->execCommand(rollback_);
+        return false;
+      }
+      return true;
+    };
+
+    if (not write()) {
+      // changes are kept to retry later
+      setFlushTimer();
+      return Error::STORAGE_ERROR;
+    }
+    changes_.clear();
+    return outcome::success();
+  }
+
+  void StorageBackendSqlite::addChange(const Key &key, Change change) {
+    changes_[key] = std::move(change);
+    if (changes_.size() >= config_.storageFlushBatch) {
+      std::ignore = flush();
+      return;
+    }
+    if (not flush_timer_) {
+      setFlushTimer();
+    }
+  }
+
+  void StorageBackendSqlite::setFlushTimer() {
+    flush_timer_ = scheduler_->scheduleWithHandle(
+        [weak_self{weak_from_this()}] {
+          if (auto self = weak_self.lock()) {
+            std::ignore = self->flush();
+          }
+        },
+        config_.storageFlushInterval);
+  }
+
+}  // namespace libp2p::protocol::kademlia
@@ -6,11 +6,6 @@
 
 #include <libp2p/protocol/kademlia/impl/storage_impl.hpp>
 
-#include <boost/multi_index/hashed_index.hpp>
-#include <boost/multi_index/ordered_index.hpp>
-#include <boost/multi_index_container.hpp>
-#include <unordered_map>
-
 #include <libp2p/protocol/kademlia/config.hpp>
 #include <libp2p/protocol/kademlia/error.hpp>
 
@@ -21,15 +16,24 @@ namespace libp2p::protocol::kademlia {
                            std::shared_ptr<basic::Scheduler> scheduler)
       : config_(config),
         backend_(std::move(backend)),
-        scheduler_(std::move(scheduler)) {
+        scheduler_(std::move(scheduler)),
+        expiry_(config_.storageWipingInterval) {
     BOOST_ASSERT(backend_ != nullptr);
     BOOST_ASSERT(scheduler_ != nullptr);
     BOOST_ASSERT(config_.storageRecordTTL > config_.storageWipingInterval);
 
-    table_ = std::make_unique<Table>();
+    // Values of previous run live for the rest of their TTL
+    auto now = scheduler_->now();
+    for (auto &[key, age] : backend_->storedValues()) {
+      if (age >= config_.storageRecordTTL) {
+        std::ignore = backend_->erase(key);
+        continue;
+      }
+      auto expire_time = now + config_.storageRecordTTL - age;
+      table_.emplace(key, Record{expire_time, now});
+      expiry_.add(key, expire_time);
+    }
 
-    refresh_timer_ =
-        scheduler_->scheduleWithHandle([this] { setTimerRefresh(); });
     refresh_timer_ = scheduler_->scheduleWithHandle(
         [this] { onRefreshTimer(); }, config_.storageWipingInterval);
   }
@@ -42,71 +46,52 @@ namespace libp2p::protocol::kademlia {
     auto now = scheduler_->now();
     auto expire_time = now + config_.storageRecordTTL;
 
-    auto &idx = table_->get<ByKey>();
-
-    if (auto it = idx.find(key); it == idx.end()) {
-      table_->insert({key, expire_time, now});
-    } else {
-      table_->modify(it, [expire_time, now](auto &record) {
-        record.expire_time = expire_time;
-        record.updated_at = now;
-      });
-    }
+    // stale entry of refreshed record is skipped by sweep
+    expiry_.add(key, expire_time);
+    table_.insert_or_assign(std::move(key), Record{expire_time, now});
 
     return outcome::success();
   }
 
   outcome::result<ValueAndTime> StorageImpl::getValue(const Key &key) const {
-    auto &idx = table_->get<ByKey>();
-    auto it = idx.find(key);
-    if (it == idx.end()) {
+    auto it = table_.find(key);
+    if (it == table_.end()) {
       return Error::VALUE_NOT_FOUND;
     }
     OUTCOME_TRY(value, backend_->getValue(key));
-    return {value, it->expire_time};
+    return {value, it->second.expire_time};
   }
 
   bool StorageImpl::hasValue(const Key &key) const {
-    auto &idx = table_->get<ByKey>();
-    auto it = idx.find(key);
-    if (it == idx.end()) {
+    auto it = table_.find(key);
+    if (it == table_.end()) {
       return false;
     }
-    return it->expire_time > scheduler_->now();
+    return it->second.expire_time > scheduler_->now();
   }
 
   void StorageImpl::onRefreshTimer() {
     auto now = scheduler_->now();
 
-    // cleanup expired records
-    auto &idx_by_expiration = table_->get<ByExpireTime>();
-    for (auto i = idx_by_expiration.begin(); i != idx_by_expiration.end();) {
-      if (i->expire_time > now) {
-        break;
+    // cleanup expired records, a slice per tick not to block the thread
+    auto more = expiry_.sweep(now, kSweepSlice, [&](const auto &entry) {
+      auto it = table_.find(entry.key);
+      if (it == table_.end() or it->second.expire_time > now) {
+        return;
       }
-
-      auto ci = i++;
-      if (backend_->erase(ci->key)) {
-        idx_by_expiration.erase(ci);
-      }
-    }
-
-    // refresh if time arrived
-    auto &idx_by_refresing = table_->get<ByRefreshTime>();
-    for (auto i = idx_by_refresing.begin(); i != idx_by_refresing.end(); ++i) {
-      if (i->refresh_time > now) {
-        break;
+      if (backend_->erase(entry.key)) {
+        table_.erase(it);
+      } else {
+        // retry with the next sweep
+        expiry_.add(entry.key, now + config_.storageWipingInterval);
       }
+    });
 
-      idx_by_refresing.modify(i, [this](auto &record) {
-        record.refresh_time += config_.storageRefreshInterval;
-      });
-    }
-
-    setTimerRefresh();
+    setTimerRefresh(more ? std::chrono::milliseconds::zero()
+                         : config_.storageWipingInterval);
   }
 
-  void StorageImpl::setTimerRefresh() {
+  void StorageImpl::setTimerRefresh(std::chrono::milliseconds delay) {
     refresh_timer_ = scheduler_->scheduleWithHandle(
         [weak_self{weak_from_this()}] {
           auto self = weak_self.lock();
@@ -115,6 +100,6 @@ namespace libp2p::protocol::kademlia {
           }
           self->onRefreshTimer();
         },
-        config_.storageRefreshInterval);
+        delay);
   }
 }  // namespace libp2p::protocol::kademlia
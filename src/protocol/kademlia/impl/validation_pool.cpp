@@ -0,0 +1,86 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/protocol/kademlia/impl/validation_pool.hpp>
+
+#include <boost/asio/post.hpp>
+
+#include <libp2p/protocol/kademlia/error.hpp>
+
+namespace libp2p::protocol::kademlia {
+
+  namespace {
+    outcome::result<Value> selectBest(Validator &validator,
+                                      const Key &key,
+                                      std::vector<Value> &values) {
+      OUTCOME_TRY(index, validator.select(key, values));
+      if (index >= values.size()) {
+        return Error::INTERNAL_ERROR;
+      }
+      return std::move(values[index]);
+    }
+  }  // namespace
+
+  ValidationPool::ValidationPool(std::shared_ptr<Validator> validator,
+                                 std::shared_ptr<basic::Scheduler> scheduler,
+                                 size_t threads)
+      : validator_{std::move(validator)}, scheduler_{std::move(scheduler)} {
+    BOOST_ASSERT(validator_ != nullptr);
+    BOOST_ASSERT(scheduler_ != nullptr);
+    if (threads != 0) {
+      pool_ = std::make_unique<boost::asio::thread_pool>(threads);
+    }
+  }
+
+  ValidationPool::~ValidationPool() {
+    if (pool_) {
+      pool_->stop();
+      pool_->join();
+    }
+  }
+
+  void ValidationPool::validate(Key key,
+                                Value value,
+                                ValidateHandler handler) {
+    if (not pool_) {
+      return handler(validator_->validate(key, value));
+    }
+    boost::asio::post(*pool_,
+                      [validator{validator_},
+                       scheduler{scheduler_},
+                       key{std::move(key)},
+                       value{std::move(value)},
+                       handler{std::move(handler)}]() mutable {
+                        auto res = validator->validate(key, value);
+                        scheduler->schedule(
+                            [res, handler{std::move(handler)}] {
+                              handler(res);
+                            });
+                      });
+  }
+
+  void ValidationPool::select(Key key,
+                              std::vector<Value> values,
+                              SelectHandler handler) {
+    if (not pool_) {
+      return handler(selectBest(*validator_, key, values));
+    }
+    boost::asio::post(
+        *pool_,
+        [validator{validator_},
+         scheduler{scheduler_},
+         key{std::move(key)},
+         values{std::move(values)},
+         handler{std::move(handler)}]() mutable {
+          auto res = selectBest(*validator, key, values);
+          scheduler->schedule(
+              [res{std::move(res)}, handler{std::move(handler)}]() mutable {
+                handler(std::move(res));
+              });
+        });
+  }
+
+}  // namespace libp2p::protocol::kademlia
@@ -6,6 +6,7 @@
 
 #include <libp2p/protocol/kademlia/message.hpp>
 
+#include <array>
 #include <functional>
 
 #include <generated/protocol/kademlia/protobuf/kademlia.pb.h>
@@ -29,6 +30,9 @@ namespace libp2p::protocol::kademlia {
 
   namespace {
 
+    /// Arena memory on stack, enough for typical FIND_NODE response
+    constexpr size_t kArenaInitialBlock = 8 << 10;
+
     inline void assign_blob(std::vector<uint8_t> &dst, const std::string &src) {
       auto sz = src.size();
       if (sz == 0) {
@@ -54,6 +58,7 @@ namespace libp2p::protocol::kademlia {
       }
 
       std::vector<multi::Multiaddress> addresses;
+      addresses.reserve(src.addrs_size());
       for (const auto &addr : src.addrs()) {
         auto res = multi::Multiaddress::create(BytesIn(
             // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
@@ -62,7 +67,7 @@ namespace libp2p::protocol::kademlia {
         if (!res) {
           return Message::Error::INVALID_ADDRESSES;
         }
-        addresses.push_back(res.value());
+        addresses.push_back(std::move(res.value()));
       }
 
       return Message::Peer{PeerInfo{peer_id_res.value(), std::move(addresses)},
@@ -107,7 +112,14 @@ namespace libp2p::protocol::kademlia {
 
   bool Message::deserialize(BytesIn pb) {
     clear();
-    pb::Message pb_msg;
+    // parsed peers, addresses and strings are allocated in arena, which
+    // starts on stack and is released at once
+    std::array<char, kArenaInitialBlock> initial_block;
+    google::protobuf::ArenaOptions arena_options;
+    arena_options.initial_block = initial_block.data();
+    arena_options.initial_block_size = initial_block.size();
+    google::protobuf::Arena arena{arena_options};
+    auto &pb_msg = *google::protobuf::Arena::Create<pb::Message>(&arena);
     if (!pb_msg.ParseFromArray(pb.data(), static_cast<int>(pb.size()))) {
       error_message_ = "Invalid protobuf data";
       return false;
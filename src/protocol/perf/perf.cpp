@@ -0,0 +1,195 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/protocol/perf/perf.hpp>
+
+#include <boost/endian/conversion.hpp>
+#include <libp2p/basic/read.hpp>
+#include <libp2p/basic/write.hpp>
+
+namespace libp2p::protocol {
+  using Clock = std::chrono::steady_clock;
+
+  struct Perf::Session {
+    std::shared_ptr<connection::Stream> stream;
+    /// big endian size of download
+    std::array<uint8_t, sizeof(uint64_t)> header{};
+    /// bytes left to write
+    uint64_t write_left = 0;
+    /// bytes expected to read, client only
+    uint64_t read_expected = 0;
+    Bytes buffer;
+    Clock::time_point started = Clock::now();
+    PerfResult result;
+    Callback cb;
+
+    void finish(outcome::result<PerfResult> r) {
+      if (not r) {
+        stream->reset();
+      }
+      if (auto cb = std::exchange(this->cb, nullptr)) {
+        cb(std::move(r));
+      }
+    }
+  };
+
+  Perf::Perf(Host &host, PerfConfig config)
+      : host_{host},
+        config_{config},
+        zeros_(std::max<size_t>(config_.buffer_size, 1)) {}
+
+  peer::ProtocolName Perf::getProtocolId() const {
+    return kProtocolId;
+  }
+
+  void Perf::start() {
+    host_.setProtocolHandler(
+        {kProtocolId}, [weak_self{weak_from_this()}](StreamAndProtocol stream) {
+          if (auto self = weak_self.lock()) {
+            self->handle(std::move(stream));
+          }
+        });
+  }
+
+  void Perf::handle(StreamAndProtocol stream) {
+    auto session = std::make_shared<Session>();
+    session->stream = std::move(stream.stream);
+    session->buffer.resize(zeros_.size());
+    read(session->stream,
+         session->header,
+         [self{shared_from_this()}, session](outcome::result<void> r) {
+           if (not r) {
+             return session->stream->reset();
+           }
+           session->write_left =
+               boost::endian::load_big_u64(session->header.data());
+           if (session->write_left > self->config_.max_download) {
+             return session->stream->reset();
+           }
+           self->serveRead(session);
+         });
+  }
+
+  void Perf::serveRead(std::shared_ptr<Session> session) {
+    auto &stream = *session->stream;
+    stream.readSome(
+        session->buffer,
+        session->buffer.size(),
+        [self{shared_from_this()}, session](outcome::result<size_t> r) {
+          if (not r) {
+            // client is done uploading
+            if (session->stream->isClosedForRead()) {
+              return self->serveWrite(session);
+            }
+            return session->stream->reset();
+          }
+          self->serveRead(session);
+        });
+  }
+
+  void Perf::serveWrite(std::shared_ptr<Session> session) {
+    if (session->write_left == 0) {
+      return session->stream->close([](outcome::result<void>) {});
+    }
+    auto n = std::min<uint64_t>(session->write_left, zeros_.size());
+    session->stream->writeSome(
+        BytesIn{zeros_}.first(n),
+        n,
+        [self{shared_from_this()}, session](outcome::result<size_t> r) {
+          if (not r) {
+            return session->stream->reset();
+          }
+          session->write_left -= r.value();
+          self->serveWrite(session);
+        });
+  }
+
+  void Perf::run(const peer::PeerInfo &peer,
+                 uint64_t upload,
+                 uint64_t download,
+                 Callback cb) {
+    auto session = std::make_shared<Session>();
+    session->write_left = upload;
+    session->read_expected = download;
+    session->buffer.resize(zeros_.size());
+    session->cb = std::move(cb);
+    boost::endian::store_big_u64(session->header.data(), download);
+    host_.newStream(
+        peer,
+        {kProtocolId},
+        [self{shared_from_this()}, session](StreamAndProtocolOrError r) {
+          if (not r) {
+            if (auto cb = std::exchange(session->cb, nullptr)) {
+              cb(r.error());
+            }
+            return;
+          }
+          session->stream = std::move(r.value().stream);
+          auto now = Clock::now();
+          session->result.stream_setup = now - session->started;
+          session->started = now;
+          write(session->stream,
+                session->header,
+                [self, session](outcome::result<void> r) {
+                  if (not r) {
+                    return session->finish(r.error());
+                  }
+                  self->upload(session);
+                });
+        });
+  }
+
+  void Perf::upload(std::shared_ptr<Session> session) {
+    if (session->write_left == 0) {
+      return session->stream->close([self{shared_from_this()},
+                                     session](outcome::result<void> r) {
+        if (not r) {
+          return session->finish(r.error());
+        }
+        auto now = Clock::now();
+        session->result.upload = now - session->started;
+        session->started = now;
+        self->download(session);
+      });
+    }
+    auto n = std::min<uint64_t>(session->write_left, zeros_.size());
+    session->stream->writeSome(
+        BytesIn{zeros_}.first(n),
+        n,
+        [self{shared_from_this()}, session](outcome::result<size_t> r) {
+          if (not r) {
+            return session->finish(r.error());
+          }
+          session->write_left -= r.value();
+          session->result.uploaded += r.value();
+          self->upload(session);
+        });
+  }
+
+  void Perf::download(std::shared_ptr<Session> session) {
+    auto &stream = *session->stream;
+    stream.readSome(
+        session->buffer,
+        session->buffer.size(),
+        [self{shared_from_this()}, session](outcome::result<size_t> r) {
+          auto &result = session->result;
+          if (not r) {
+            // server closes stream once it sent all bytes
+            if (session->stream->isClosedForRead()
+                and result.downloaded == session->read_expected) {
+              result.download = Clock::now() - session->started;
+              return session->finish(result);
+            }
+            return session->finish(r.error());
+          }
+          result.downloaded += r.value();
+          if (result.downloaded > session->read_expected) {
+            return session->finish(std::errc::message_size);
+          }
+          self->download(session);
+        });
+  }
+}  // namespace libp2p::protocol
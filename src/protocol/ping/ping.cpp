@@ -40,11 +40,28 @@ namespace libp2p::protocol {
     if (!remote_peer) {
       return cb(remote_peer.error());
     }
+    // measured round trip times are stored for latency-aware peer selection
+    auto on_rtt = [weak{weak_from_this()},
+                   peer{remote_peer.value()}](std::chrono::milliseconds rtt) {
+      if (auto self = weak.lock()) {
+        self->host_.getPeerRepository().getLatencyRepository().recordRtt(peer,
+                                                                         rtt);
+      }
+    };
+    if (conn->supportsPing()) {
+      // muxer pings need neither stream nor protocol negotiation
+      auto session = std::make_shared<PingClientSession>(
+          scheduler_, bus_, conn, config_, std::move(on_rtt));
+      session->start();
+      return cb(std::move(session));
+    }
     auto peer_info = host_.getPeerRepository().getPeerInfo(remote_peer.value());
     return host_.newStream(
         peer_info,
         {detail::kPingProto},
-        [self{shared_from_this()}, cb = std::move(cb)](auto &&stream_res) {
+        [self{shared_from_this()},
+         cb = std::move(cb),
+         on_rtt = std::move(on_rtt)](auto &&stream_res) mutable {
           if (!stream_res) {
             return cb(stream_res.error());
           }
@@ -53,7 +70,8 @@ namespace libp2p::protocol {
               self->bus_,
               std::move(stream_res.value().stream),
               self->rand_gen_,
-              self->config_);
+              self->config_,
+              std::move(on_rtt));
           session->start();
           cb(std::move(session));
         });
@@ -16,19 +16,36 @@ namespace libp2p::protocol {
       libp2p::event::Bus &bus,
       std::shared_ptr<connection::Stream> stream,
       std::shared_ptr<crypto::random::RandomGenerator> rand_gen,
-      PingConfig config)
+      PingConfig config,
+      OnRtt on_rtt)
       : scheduler_{scheduler},
         bus_{bus},
         channel_{bus_.getChannel<event::protocol::PeerIsDeadChannel>()},
         stream_{std::move(stream)},
         rand_gen_{std::move(rand_gen)},
         config_{config},
+        on_rtt_{std::move(on_rtt)},
         write_buffer_(config_.message_size, 0),
         read_buffer_(config_.message_size, 0) {
     BOOST_ASSERT(stream_);
     BOOST_ASSERT(rand_gen_);
   }
 
+  PingClientSession::PingClientSession(
+      std::shared_ptr<basic::Scheduler> scheduler,
+      libp2p::event::Bus &bus,
+      const std::shared_ptr<connection::CapableConnection> &conn,
+      PingConfig config,
+      OnRtt on_rtt)
+      : scheduler_{std::move(scheduler)},
+        bus_{bus},
+        channel_{bus_.getChannel<event::protocol::PeerIsDeadChannel>()},
+        conn_{conn},
+        config_{config},
+        on_rtt_{std::move(on_rtt)} {
+    BOOST_ASSERT(conn->supportsPing());
+  }
+
   void PingClientSession::start() {
     BOOST_ASSERT(!is_started_);
     is_started_ = true;
@@ -41,6 +58,9 @@ namespace libp2p::protocol {
   }
 
   void PingClientSession::write() {
+    if (not stream_) {
+      return ping();
+    }
     if (not is_started_ or closed_ or stream_->isClosedForWrite()) {
       return;
     }
@@ -54,6 +74,7 @@ namespace libp2p::protocol {
         config_.timeout);
 
     write_buffer_ = rand_gen_->randomBytes(config_.message_size);
+    sent_at_ = scheduler_->now();
     writeReturnSize(stream_,
                     write_buffer_,
                     [self{shared_from_this()}](outcome::result<size_t> r) {
@@ -98,7 +119,49 @@ namespace libp2p::protocol {
       // thus declare it dead
       return close();
     }
+    if (on_rtt_) {
+      on_rtt_(scheduler_->now() - sent_at_);
+    }
+    pinged();
+  }
+
+  void PingClientSession::ping() {
+    auto conn = conn_.lock();
+    if (not is_started_ or closed_ or not conn or conn->isClosed()) {
+      return;
+    }
 
+    timer_ = scheduler_->scheduleWithHandle(
+        [weak{weak_from_this()}] {
+          if (auto self = weak.lock()) {
+            self->pingCompleted(std::errc::timed_out);
+          }
+        },
+        config_.timeout);
+
+    conn->ping([self{shared_from_this()}](
+                   outcome::result<std::chrono::microseconds> r) {
+      self->pingCompleted(r);
+    });
+  }
+
+  void PingClientSession::pingCompleted(
+      outcome::result<std::chrono::microseconds> r) {
+    if (closed_) {
+      // late pong after timeout
+      return;
+    }
+    timer_.reset();
+    if (r.has_error()) {
+      return close();
+    }
+    if (on_rtt_) {
+      on_rtt_(std::chrono::duration_cast<std::chrono::milliseconds>(r.value()));
+    }
+    pinged();
+  }
+
+  void PingClientSession::pinged() {
     timer_ = scheduler_->scheduleWithHandle(
         [weak{weak_from_this()}] {
           if (auto self = weak.lock()) {
@@ -113,6 +176,14 @@ namespace libp2p::protocol {
       return;
     }
     closed_ = true;
+    if (not stream_) {
+      if (auto conn = conn_.lock()) {
+        if (auto peer_id_res = conn->remotePeer()) {
+          channel_.publish(peer_id_res.value());
+        }
+      }
+      return;
+    }
     if (auto peer_id_res = stream_->remotePeerId()) {
       channel_.publish(peer_id_res.value());
     }
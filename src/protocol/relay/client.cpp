@@ -0,0 +1,167 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/protocol/relay/client.hpp>
+
+#include <libp2p/basic/protobuf_message_read_writer.hpp>
+#include <libp2p/connection/stream.hpp>
+#include <libp2p/protocol/relay/common.hpp>
+
+#include "messages.hpp"
+
+namespace libp2p::protocol::relay {
+  namespace {
+    using ReadWriter = basic::ProtobufMessageReadWriter;
+
+    using HopCb = std::function<void(
+        outcome::result<
+            std::pair<std::shared_ptr<connection::Stream>, pb::HopMessage>>)>;
+
+    /// Sends hop request to relay, and reads OK response
+    void hop(Host &host,
+             const peer::PeerInfo &relay,
+             pb::HopMessage request,
+             HopCb cb) {
+      auto on_stream = [request{std::move(request)}, cb{std::move(cb)}](
+                           StreamAndProtocolOrError r) mutable {
+        if (not r) {
+          return cb(r.error());
+        }
+        auto stream = std::move(r.value().stream);
+        auto rw = std::make_shared<ReadWriter>(stream);
+        auto on_response =
+            [stream, cb](outcome::result<pb::HopMessage> r) mutable {
+              if (not r) {
+                stream->reset();
+                return cb(r.error());
+              }
+              auto &msg = r.value();
+              if (msg.type() != pb::HopMessage::STATUS) {
+                stream->reset();
+                return cb(RelayError::UNEXPECTED_MESSAGE);
+              }
+              if (auto status = checkStatus(msg.status()); not status) {
+                stream->reset();
+                return cb(status.error());
+              }
+              cb(std::make_pair(std::move(stream), std::move(msg)));
+            };
+        rw->write(request,
+                  [stream, rw, cb, on_response{std::move(on_response)}](
+                      outcome::result<size_t> r) mutable {
+                    if (not r) {
+                      stream->reset();
+                      return cb(r.error());
+                    }
+                    rw->read<pb::HopMessage>(std::move(on_response));
+                  });
+      };
+      host.newStream(relay, {kHopProto}, std::move(on_stream));
+    }
+  }  // namespace
+
+  RelayClient::RelayClient(Host &host) : host_{host} {}
+
+  peer::ProtocolName RelayClient::getProtocolId() const {
+    return kStopProto;
+  }
+
+  void RelayClient::start(CircuitHandler handler) {
+    handler_ = std::move(handler);
+    host_.setProtocolHandler(
+        {kStopProto}, [weak_self{weak_from_this()}](StreamAndProtocol stream) {
+          if (auto self = weak_self.lock()) {
+            self->handle(std::move(stream));
+          }
+        });
+  }
+
+  void RelayClient::handle(StreamAndProtocol stream_and_protocol) {
+    auto stream = std::move(stream_and_protocol.stream);
+    if (not handler_) {
+      return stream->reset();
+    }
+    auto rw = std::make_shared<ReadWriter>(stream);
+    rw->read<pb::StopMessage>([weak_self{weak_from_this()}, stream, rw](
+                                  outcome::result<pb::StopMessage> r) {
+      auto self = weak_self.lock();
+      if (not self or not r) {
+        return stream->reset();
+      }
+      auto &msg = r.value();
+      pb::StopMessage response;
+      response.set_type(pb::StopMessage::STATUS);
+      auto peer = msg.has_peer() ? fromProto(msg.peer())
+                                 : outcome::result<PeerId>{
+                                     RelayError::MALFORMED_MESSAGE};
+      if (msg.type() != pb::StopMessage::CONNECT) {
+        response.set_status(pb::UNEXPECTED_MESSAGE);
+      } else if (not peer) {
+        response.set_status(pb::MALFORMED_MESSAGE);
+      } else {
+        response.set_status(pb::OK);
+      }
+      auto ok = response.status() == pb::OK;
+      auto limit = fromProto(msg.limit());
+      rw->write(response,
+                [weak_self, stream, peer, limit, ok](
+                    outcome::result<size_t> r) {
+                  auto self = weak_self.lock();
+                  if (not self or not r) {
+                    return stream->reset();
+                  }
+                  if (not ok) {
+                    return stream->close([](outcome::result<void>) {});
+                  }
+                  self->handler_(peer.value(), limit, stream);
+                });
+    });
+  }
+
+  void RelayClient::reserve(const peer::PeerInfo &relay, ReserveCb cb) {
+    pb::HopMessage request;
+    request.set_type(pb::HopMessage::RESERVE);
+    hop(host_, relay, std::move(request), [cb{std::move(cb)}](auto r) {
+      if (not r) {
+        return cb(r.error());
+      }
+      auto &[stream, msg] = r.value();
+      stream->close([](outcome::result<void>) {});
+      if (not msg.has_reservation()) {
+        return cb(RelayError::MALFORMED_MESSAGE);
+      }
+      auto &proto = msg.reservation();
+      Reservation reservation{
+          .expire = std::chrono::system_clock::time_point{std::chrono::seconds{
+              proto.expire()}},
+          .addresses = {},
+          .limit = fromProto(msg.limit()),
+      };
+      for (auto &bytes : proto.addrs()) {
+        auto addr = Multiaddress::create(BytesIn{
+            reinterpret_cast<const uint8_t *>(bytes.data()), bytes.size()});
+        if (addr) {
+          reservation.addresses.emplace_back(std::move(addr.value()));
+        }
+      }
+      cb(std::move(reservation));
+    });
+  }
+
+  void RelayClient::connect(const peer::PeerInfo &relay,
+                            const PeerId &peer,
+                            ConnectCb cb) {
+    pb::HopMessage request;
+    request.set_type(pb::HopMessage::CONNECT);
+    toProto(peer, *request.mutable_peer());
+    hop(host_, relay, std::move(request), [cb{std::move(cb)}](auto r) {
+      if (not r) {
+        return cb(r.error());
+      }
+      cb(std::move(r.value().first));
+    });
+  }
+}  // namespace libp2p::protocol::relay
@@ -0,0 +1,64 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <generated/protocol/relay/protobuf/relay.pb.h>
+#include <libp2p/peer/peer_id.hpp>
+#include <libp2p/protocol/relay/config.hpp>
+#include <libp2p/protocol/relay/error.hpp>
+
+namespace libp2p::protocol::relay {
+  namespace pb = ::relay::pb;
+
+  inline outcome::result<void> checkStatus(pb::Status status) {
+    switch (status) {
+      case pb::OK:
+        return outcome::success();
+      case pb::RESERVATION_REFUSED:
+        return RelayError::RESERVATION_REFUSED;
+      case pb::RESOURCE_LIMIT_EXCEEDED:
+        return RelayError::RESOURCE_LIMIT_EXCEEDED;
+      case pb::PERMISSION_DENIED:
+        return RelayError::PERMISSION_DENIED;
+      case pb::CONNECTION_FAILED:
+        return RelayError::CONNECTION_FAILED;
+      case pb::NO_RESERVATION:
+        return RelayError::NO_RESERVATION;
+      case pb::UNEXPECTED_MESSAGE:
+        return RelayError::UNEXPECTED_MESSAGE;
+      default:
+        return RelayError::MALFORMED_MESSAGE;
+    }
+  }
+
+  inline void toProto(const Limit &limit, pb::Limit &proto) {
+    if (limit.duration.count() != 0) {
+      proto.set_duration(limit.duration.count());
+    }
+    if (limit.data != 0) {
+      proto.set_data(limit.data);
+    }
+  }
+
+  inline Limit fromProto(const pb::Limit &proto) {
+    return {
+        .duration = std::chrono::seconds{proto.duration()},
+        .data = proto.data(),
+    };
+  }
+
+  inline void toProto(const PeerId &peer, pb::Peer &proto) {
+    auto &bytes = peer.toVector();
+    proto.set_id(bytes.data(), bytes.size());
+  }
+
+  inline outcome::result<PeerId> fromProto(const pb::Peer &proto) {
+    auto &id = proto.id();
+    return PeerId::fromBytes(
+        {reinterpret_cast<const uint8_t *>(id.data()), id.size()});
+  }
+}  // namespace libp2p::protocol::relay
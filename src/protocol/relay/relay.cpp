@@ -0,0 +1,272 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/protocol/relay/relay.hpp>
+
+#include <libp2p/basic/buffer_pool.hpp>
+#include <libp2p/basic/protobuf_message_read_writer.hpp>
+#include <libp2p/connection/stream.hpp>
+#include <libp2p/protocol/relay/common.hpp>
+#include <libp2p/protocol/relay/splice.hpp>
+
+#include "messages.hpp"
+
+namespace libp2p::protocol::relay {
+  namespace {
+    pb::HopMessage status(pb::Status status) {
+      pb::HopMessage msg;
+      msg.set_type(pb::HopMessage::STATUS);
+      msg.set_status(status);
+      return msg;
+    }
+  }  // namespace
+
+  Relay::Relay(Host &host,
+               std::shared_ptr<basic::Scheduler> scheduler,
+               RelayConfig config)
+      : host_{host},
+        scheduler_{std::move(scheduler)},
+        config_{config},
+        pool_{basic::BufferPool::create(config_.buffer_size,
+                                        config_.max_free_buffers)} {}
+
+  peer::ProtocolName Relay::getProtocolId() const {
+    return kHopProto;
+  }
+
+  void Relay::start() {
+    host_.setProtocolHandler(
+        {kHopProto}, [weak_self{weak_from_this()}](StreamAndProtocol stream) {
+          if (auto self = weak_self.lock()) {
+            self->handle(std::move(stream));
+          }
+        });
+  }
+
+  void Relay::handle(StreamAndProtocol stream_and_protocol) {
+    auto &stream = stream_and_protocol.stream;
+    auto peer = stream->remotePeerId();
+    if (not peer) {
+      return stream->reset();
+    }
+    auto rw = std::make_shared<ReadWriter>(stream);
+    rw->read<pb::HopMessage>(
+        [weak_self{weak_from_this()}, stream, rw, peer{peer.value()}](
+            outcome::result<pb::HopMessage> r) {
+          auto self = weak_self.lock();
+          if (not self or not r) {
+            return stream->reset();
+          }
+          self->onHop(stream, rw, peer, r.value());
+        });
+  }
+
+  void Relay::onHop(std::shared_ptr<connection::Stream> stream,
+                    std::shared_ptr<ReadWriter> rw,
+                    const PeerId &peer,
+                    const pb::HopMessage &msg) {
+    switch (msg.type()) {
+      case pb::HopMessage::RESERVE:
+        return reserve(std::move(stream), std::move(rw), peer);
+      case pb::HopMessage::CONNECT: {
+        auto dst = msg.has_peer() ? fromProto(msg.peer())
+                                  : outcome::result<PeerId>{
+                                      RelayError::MALFORMED_MESSAGE};
+        if (not dst) {
+          return reply(stream, rw, status(pb::MALFORMED_MESSAGE));
+        }
+        return connect(std::move(stream), std::move(rw), peer, dst.value());
+      }
+      default:
+        return reply(stream, rw, status(pb::UNEXPECTED_MESSAGE));
+    }
+  }
+
+  void Relay::reserve(std::shared_ptr<connection::Stream> stream,
+                      std::shared_ptr<ReadWriter> rw,
+                      const PeerId &peer) {
+    auto now = scheduler_->now();
+    if (not reservations_.contains(peer)
+        and reservations_.size() >= config_.max_reservations) {
+      std::erase_if(reservations_,
+                    [&](const auto &p) { return p.second <= now; });
+      if (reservations_.size() >= config_.max_reservations) {
+        return reply(stream, rw, status(pb::RESERVATION_REFUSED));
+      }
+    }
+    reservations_.insert_or_assign(peer, now + config_.reservation_ttl);
+
+    auto msg = status(pb::OK);
+    auto &reservation = *msg.mutable_reservation();
+    auto expire = std::chrono::system_clock::now() + config_.reservation_ttl;
+    reservation.set_expire(std::chrono::duration_cast<std::chrono::seconds>(
+                               expire.time_since_epoch())
+                               .count());
+    auto p2p = Multiaddress::create("/p2p/" + host_.getId().toBase58());
+    for (auto addr : host_.getAddresses()) {
+      if (p2p) {
+        addr.encapsulate(p2p.value());
+      }
+      auto &bytes = addr.getBytesAddress();
+      reservation.add_addrs(bytes.data(), bytes.size());
+    }
+    toProto(config_.limit, *msg.mutable_limit());
+    reply(std::move(stream), std::move(rw), msg);
+  }
+
+  void Relay::connect(std::shared_ptr<connection::Stream> stream,
+                      std::shared_ptr<ReadWriter> rw,
+                      const PeerId &src,
+                      const PeerId &dst) {
+    if (not hasReservation(dst)) {
+      return reply(stream, rw, status(pb::NO_RESERVATION));
+    }
+    auto busy = [&](const PeerId &peer) {
+      auto it = peer_circuits_.find(peer);
+      return it != peer_circuits_.end()
+         and it->second >= config_.max_circuits_per_peer;
+    };
+    if (circuits_ >= config_.max_circuits or busy(src) or busy(dst)) {
+      return reply(stream, rw, status(pb::RESOURCE_LIMIT_EXCEEDED));
+    }
+    acquireCircuit(src, dst);
+
+    auto on_stop = [weak_self{weak_from_this()}, stream, rw, src, dst](
+                       StreamAndProtocolOrError r) {
+      auto self = weak_self.lock();
+      if (not self) {
+        if (r) {
+          r.value().stream->reset();
+        }
+        return stream->reset();
+      }
+      auto fail = [&] {
+        self->releaseCircuit(src, dst);
+        self->reply(stream, rw, status(pb::CONNECTION_FAILED));
+      };
+      if (not r) {
+        return fail();
+      }
+      auto dst_stream = std::move(r.value().stream);
+      auto dst_rw = std::make_shared<ReadWriter>(dst_stream);
+      // target is reset if it doesn't accept in time
+      auto timeout = std::make_shared<basic::Scheduler::Handle>(
+          self->scheduler_->scheduleWithHandle(
+              [dst_stream] { dst_stream->reset(); },
+              self->config_.connect_timeout));
+      auto on_status = [weak_self,
+                        stream,
+                        rw,
+                        src,
+                        dst,
+                        dst_stream,
+                        timeout](outcome::result<pb::StopMessage> r) {
+        timeout->reset();
+        auto self = weak_self.lock();
+        if (not self) {
+          dst_stream->reset();
+          return stream->reset();
+        }
+        if (not r or r.value().type() != pb::StopMessage::STATUS
+            or r.value().status() != pb::OK) {
+          dst_stream->reset();
+          self->releaseCircuit(src, dst);
+          return self->reply(stream, rw, status(pb::CONNECTION_FAILED));
+        }
+        auto msg = status(pb::OK);
+        toProto(self->config_.limit, *msg.mutable_limit());
+        rw->write(msg,
+                  [weak_self, stream, src, dst, dst_stream](
+                      outcome::result<size_t> r) {
+                    auto self = weak_self.lock();
+                    if (not self or not r) {
+                      stream->reset();
+                      dst_stream->reset();
+                      if (self) {
+                        self->releaseCircuit(src, dst);
+                      }
+                      return;
+                    }
+                    self->splice(stream, dst_stream, src, dst);
+                  });
+      };
+      pb::StopMessage connect;
+      connect.set_type(pb::StopMessage::CONNECT);
+      toProto(src, *connect.mutable_peer());
+      toProto(self->config_.limit, *connect.mutable_limit());
+      dst_rw->write(connect,
+                    [dst_rw, on_status{std::move(on_status)}](
+                        outcome::result<size_t> r) mutable {
+                      if (not r) {
+                        return on_status(r.error());
+                      }
+                      dst_rw->read<pb::StopMessage>(std::move(on_status));
+                    });
+    };
+    host_.newStream(PeerInfo{.id = dst}, {kStopProto}, std::move(on_stop));
+  }
+
+  void Relay::splice(std::shared_ptr<connection::Stream> src_stream,
+                     std::shared_ptr<connection::Stream> dst_stream,
+                     const PeerId &src,
+                     const PeerId &dst) {
+    auto splice = std::make_shared<Splice>(std::move(src_stream),
+                                           std::move(dst_stream),
+                                           pool_,
+                                           config_.limit.data);
+    std::shared_ptr<basic::Scheduler::Handle> timer;
+    if (config_.limit.duration.count() != 0) {
+      timer = std::make_shared<basic::Scheduler::Handle>(
+          scheduler_->scheduleWithHandle(
+              [weak_splice{std::weak_ptr{splice}}] {
+                if (auto splice = weak_splice.lock()) {
+                  splice->stop();
+                }
+              },
+              config_.limit.duration));
+    }
+    splice->start([weak_self{weak_from_this()}, src, dst, timer] {
+      if (timer) {
+        timer->reset();
+      }
+      if (auto self = weak_self.lock()) {
+        self->releaseCircuit(src, dst);
+      }
+    });
+  }
+
+  void Relay::reply(std::shared_ptr<connection::Stream> stream,
+                    std::shared_ptr<ReadWriter> rw,
+                    const pb::HopMessage &msg) {
+    rw->write(msg, [stream](outcome::result<size_t> r) {
+      if (not r) {
+        return stream->reset();
+      }
+      stream->close([](outcome::result<void>) {});
+    });
+  }
+
+  bool Relay::hasReservation(const PeerId &peer) const {
+    auto it = reservations_.find(peer);
+    return it != reservations_.end() and it->second > scheduler_->now();
+  }
+
+  void Relay::acquireCircuit(const PeerId &src, const PeerId &dst) {
+    ++circuits_;
+    ++peer_circuits_[src];
+    ++peer_circuits_[dst];
+  }
+
+  void Relay::releaseCircuit(const PeerId &src, const PeerId &dst) {
+    --circuits_;
+    for (auto *peer : {&src, &dst}) {
+      auto it = peer_circuits_.find(*peer);
+      if (--it->second == 0) {
+        peer_circuits_.erase(it);
+      }
+    }
+  }
+}  // namespace libp2p::protocol::relay
@@ -0,0 +1,117 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/protocol/relay/splice.hpp>
+
+#include <libp2p/basic/write.hpp>
+#include <libp2p/connection/stream.hpp>
+
+namespace libp2p::protocol::relay {
+  Splice::Splice(std::shared_ptr<connection::Stream> a,
+                 std::shared_ptr<connection::Stream> b,
+                 std::shared_ptr<basic::BufferPool> pool,
+                 uint64_t max_bytes)
+      : directions_{Direction{.from = a, .to = b},
+                    Direction{.from = b, .to = a}},
+        pool_{std::move(pool)},
+        max_bytes_{max_bytes} {}
+
+  void Splice::start(OnDone on_done) {
+    on_done_ = std::move(on_done);
+    for (size_t i = 0; i < directions_.size(); ++i) {
+      directions_[i].buffer = pool_->allocate();
+      read(i);
+    }
+  }
+
+  void Splice::stop() {
+    if (stopped_) {
+      return;
+    }
+    stopped_ = true;
+    for (auto &direction : directions_) {
+      direction.from->reset();
+    }
+    finish();
+  }
+
+  void Splice::read(size_t i) {
+    auto &direction = directions_[i];
+    auto out = direction.buffer.span();
+    if (max_bytes_ != 0) {
+      auto left = max_bytes_ - direction.forwarded;
+      if (left == 0) {
+        // data limit is enforced by reset, as there is no way to tell why
+        // stream was closed
+        return stop();
+      }
+      out = out.first(std::min<uint64_t>(out.size(), left));
+    }
+    direction.from->readSome(
+        out,
+        out.size(),
+        [self{shared_from_this()}, i](outcome::result<size_t> r) {
+          self->onRead(i, r);
+        });
+  }
+
+  void Splice::onRead(size_t i, outcome::result<size_t> r) {
+    if (stopped_) {
+      return;
+    }
+    auto &direction = directions_[i];
+    if (not r) {
+      if (not direction.from->isClosedForRead()) {
+        return stop();
+      }
+      // half-close is forwarded
+      auto on_close = [self{shared_from_this()}, i](outcome::result<void> r) {
+        if (not r) {
+          return self->stop();
+        }
+        self->done(i);
+      };
+      direction.to->close(std::move(on_close));
+      return;
+    }
+    direction.forwarded += r.value();
+    libp2p::write(direction.to,
+                  direction.buffer.span().first(r.value()),
+                  [self{shared_from_this()}, i](outcome::result<void> r) {
+                    self->onWritten(i, r);
+                  });
+  }
+
+  void Splice::onWritten(size_t i, outcome::result<void> r) {
+    if (stopped_) {
+      return;
+    }
+    if (not r) {
+      return stop();
+    }
+    read(i);
+  }
+
+  void Splice::done(size_t i) {
+    if (stopped_) {
+      return;
+    }
+    auto &direction = directions_[i];
+    direction.done = true;
+    direction.buffer.reset();
+    if (directions_[1 - i].done) {
+      stopped_ = true;
+      finish();
+    }
+  }
+
+  void Splice::finish() {
+    if (auto on_done = std::move(on_done_)) {
+      on_done_ = nullptr;
+      on_done();
+    }
+  }
+}  // namespace libp2p::protocol::relay
@@ -0,0 +1,326 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/protocol/request_response/request_response.hpp>
+
+#include <libp2p/basic/message_read_writer_uvarint.hpp>
+#include <libp2p/common/metrics/registry.hpp>
+#include <libp2p/connection/stream.hpp>
+
+namespace libp2p::protocol {
+  namespace {
+    /// "/ipfs/ping/1.0.0" gives "libp2p_request_response_ipfs_ping_1_0_0_"
+    std::string metricPrefix(std::string_view protocol) {
+      std::string prefix = "libp2p_request_response_";
+      for (auto c : protocol) {
+        if (std::isalnum(static_cast<unsigned char>(c))) {
+          prefix += c;
+        } else if (not prefix.ends_with('_')) {
+          prefix += '_';
+        }
+      }
+      if (not prefix.ends_with('_')) {
+        prefix += '_';
+      }
+      return prefix;
+    }
+
+    /// Bucket bounds in bytes, from 64B to 4MiB
+    const std::vector<double> &sizeBuckets() {
+      static const std::vector<double> buckets{
+          64, 256, 1 << 10, 4 << 10, 16 << 10, 64 << 10, 256 << 10, 1 << 20,
+          4 << 20};
+      return buckets;
+    }
+  }  // namespace
+
+  struct RequestResponse::Call {
+    PeerId peer;
+    Bytes request;
+    std::vector<ResponseCb> cbs;
+    std::shared_ptr<connection::Stream> stream;
+    basic::Scheduler::Handle timer;
+    std::chrono::milliseconds started{};
+    bool done = false;
+  };
+
+  RequestResponse::RequestResponse(Host &host,
+                                   std::shared_ptr<basic::Scheduler> scheduler,
+                                   StreamProtocols protocols,
+                                   Handler handler,
+                                   RequestResponseConfig config)
+      : host_{host},
+        scheduler_{std::move(scheduler)},
+        protocols_{std::move(protocols)},
+        handler_{std::move(handler)},
+        config_{config},
+        metrics_{makeMetrics(protocols_.at(0))} {}
+
+  RequestResponse::Metrics RequestResponse::makeMetrics(
+      const peer::ProtocolName &protocol) {
+    auto &registry = metrics::Registry::instance();
+    auto prefix = metricPrefix(protocol);
+    return {
+        .latency = registry.histogram(prefix + "latency_seconds",
+                                      "Duration of requests to " + protocol),
+        .request_size = registry.histogram(prefix + "request_bytes",
+                                           "Size of requests to " + protocol,
+                                           sizeBuckets()),
+        .response_size = registry.histogram(
+            prefix + "response_bytes",
+            "Size of responses to " + protocol,
+            sizeBuckets()),
+        .failures = registry.counter(prefix + "failures_total",
+                                     "Failed requests to " + protocol),
+        .timeouts = registry.counter(prefix + "timeouts_total",
+                                     "Timed out requests to " + protocol),
+        .deduplicated = registry.counter(
+            prefix + "deduplicated_total",
+            "Requests to " + protocol + " joined to the ones in flight"),
+    };
+  }
+
+  peer::ProtocolName RequestResponse::getProtocolId() const {
+    return protocols_.at(0);
+  }
+
+  void RequestResponse::start() {
+    host_.setProtocolHandler(
+        protocols_, [weak_self{weak_from_this()}](StreamAndProtocol stream) {
+          if (auto self = weak_self.lock()) {
+            self->handle(std::move(stream));
+          }
+        });
+  }
+
+  void RequestResponse::handle(StreamAndProtocol stream) {
+    if (not handler_) {
+      return stream.stream->reset();
+    }
+    auto rw =
+        std::make_shared<basic::MessageReadWriterUvarint>(stream.stream);
+    serve(std::move(stream.stream), std::move(rw));
+  }
+
+  void RequestResponse::serve(
+      std::shared_ptr<connection::Stream> stream,
+      std::shared_ptr<basic::MessageReadWriterUvarint> rw) {
+    auto on_request = [weak_self{weak_from_this()}, stream, rw](
+                          basic::MessageReadWriter::ReadCallback r) {
+      auto self = weak_self.lock();
+      if (not self or not r) {
+        // peer is done with the stream
+        if (stream->isClosedForRead()) {
+          return stream->close([](outcome::result<void>) {});
+        }
+        return stream->reset();
+      }
+      auto peer = stream->remotePeerId();
+      if (not peer) {
+        return stream->reset();
+      }
+      auto respond = [weak_self, stream, rw](outcome::result<Bytes> r) {
+        if (not r) {
+          return stream->reset();
+        }
+        auto response = std::make_shared<Bytes>(std::move(r.value()));
+        auto on_written = [weak_self, stream, rw, response](
+                              outcome::result<size_t> r) {
+          auto self = weak_self.lock();
+          if (not self or not r) {
+            return stream->reset();
+          }
+          // client may send next request over the same stream
+          self->serve(stream, rw);
+        };
+        rw->write(*response, std::move(on_written));
+      };
+      self->handler_(peer.value(), *r.value(), std::move(respond));
+    };
+    rw->read(std::move(on_request));
+  }
+
+  void RequestResponse::request(const PeerId &peer,
+                                Bytes request,
+                                ResponseCb cb) {
+    auto &state = peers_[peer];
+    if (config_.deduplicate) {
+      auto it = state.calls.find(request);
+      if (it != state.calls.end()) {
+        metrics_.deduplicated.inc();
+        it->second->cbs.emplace_back(std::move(cb));
+        return;
+      }
+    }
+    auto slot = state.outstanding < config_.max_outstanding;
+    if (not slot and state.queue.size() >= config_.max_queued) {
+      metrics_.failures.inc();
+      return scheduler_->schedule([cb{std::move(cb)}] {
+        cb(RequestResponseError::TOO_MANY_REQUESTS);
+      });
+    }
+    auto call = std::make_shared<Call>(
+        Call{.peer = peer, .request = std::move(request)});
+    call->cbs.emplace_back(std::move(cb));
+    if (config_.deduplicate) {
+      state.calls.emplace(call->request, call);
+    }
+    if (slot) {
+      start(call);
+    } else {
+      state.queue.emplace_back(std::move(call));
+    }
+  }
+
+  void RequestResponse::start(const std::shared_ptr<Call> &call) {
+    auto &state = peers_[call->peer];
+    ++state.outstanding;
+    call->started = scheduler_->now();
+    call->timer = scheduler_->scheduleWithHandle(
+        [weak_self{weak_from_this()}, call] {
+          if (auto self = weak_self.lock()) {
+            self->finish(call, RequestResponseError::TIMEOUT);
+          }
+        },
+        config_.timeout);
+    while (not state.idle.empty()) {
+      auto stream = std::move(state.idle.back());
+      state.idle.pop_back();
+      if (not stream->isClosed()) {
+        return send(call, std::move(stream), true);
+      }
+    }
+    open(call);
+  }
+
+  void RequestResponse::open(const std::shared_ptr<Call> &call) {
+    host_.newStream(
+        call->peer,
+        protocols_,
+        [weak_self{weak_from_this()}, call](StreamAndProtocolOrError r) {
+          auto self = weak_self.lock();
+          if (not self or call->done) {
+            if (r) {
+              r.value().stream->reset();
+            }
+            return;
+          }
+          if (not r) {
+            return self->finish(call, r.error());
+          }
+          self->send(call, std::move(r.value().stream), false);
+        });
+  }
+
+  void RequestResponse::send(const std::shared_ptr<Call> &call,
+                             std::shared_ptr<connection::Stream> stream,
+                             bool reused) {
+    call->stream = stream;
+    metrics_.request_size.observe(static_cast<double>(call->request.size()));
+    auto rw = std::make_shared<basic::MessageReadWriterUvarint>(stream);
+    // callbacks of stream abandoned by retry are ignored
+    auto current = [call, sent{stream.get()}] {
+      return not call->done and call->stream.get() == sent;
+    };
+    auto on_response = [weak_self{weak_from_this()}, current, call, reused](
+                           basic::MessageReadWriter::ReadCallback r) {
+      auto self = weak_self.lock();
+      if (not self or not current()) {
+        return;
+      }
+      if (not r) {
+        return self->fail(call, reused, r.error());
+      }
+      self->finish(call, BytesIn{*r.value()});
+    };
+    rw->write(call->request,
+              [weak_self{weak_from_this()},
+               current,
+               call,
+               reused,
+               rw,
+               on_response{std::move(on_response)}](
+                  outcome::result<size_t> r) mutable {
+                auto self = weak_self.lock();
+                if (not self or not current()) {
+                  return;
+                }
+                if (not r) {
+                  return self->fail(call, reused, r.error());
+                }
+                rw->read(std::move(on_response));
+              });
+  }
+
+  void RequestResponse::fail(const std::shared_ptr<Call> &call,
+                             bool reused,
+                             std::error_code ec) {
+    if (not reused) {
+      return finish(call, ec);
+    }
+    // idle stream may have been closed by peer meanwhile
+    auto stream = std::move(call->stream);
+    stream->reset();
+    open(call);
+  }
+
+  void RequestResponse::finish(const std::shared_ptr<Call> &call,
+                               outcome::result<BytesIn> response) {
+    if (call->done) {
+      return;
+    }
+    call->done = true;
+    call->timer.reset();
+    auto &state = peers_[call->peer];
+    if (auto stream = std::move(call->stream)) {
+      if (not response) {
+        stream->reset();
+      } else if (config_.reuse_streams
+                 and state.idle.size() < config_.max_idle_streams) {
+        state.idle.emplace_back(std::move(stream));
+      } else {
+        stream->close([](outcome::result<void>) {});
+      }
+    }
+    if (response) {
+      metrics_.latency.observe(scheduler_->now() - call->started);
+      metrics_.response_size.observe(
+          static_cast<double>(response.value().size()));
+    } else {
+      metrics_.failures.inc();
+      if (response.error() == RequestResponseError::TIMEOUT) {
+        metrics_.timeouts.inc();
+      }
+    }
+    if (config_.deduplicate) {
+      auto it = state.calls.find(call->request);
+      if (it != state.calls.end() and it->second == call) {
+        state.calls.erase(it);
+      }
+    }
+    --state.outstanding;
+    // queued call may finish synchronously, so state is looked up again
+    while (true) {
+      auto it = peers_.find(call->peer);
+      if (it == peers_.end()
+          or it->second.outstanding >= config_.max_outstanding
+          or it->second.queue.empty()) {
+        break;
+      }
+      auto next = std::move(it->second.queue.front());
+      it->second.queue.pop_front();
+      start(next);
+    }
+    auto it = peers_.find(call->peer);
+    if (it != peers_.end() and it->second.outstanding == 0
+        and it->second.queue.empty() and it->second.idle.empty()) {
+      peers_.erase(it);
+    }
+    for (auto &cb : call->cbs) {
+      cb(response);
+    }
+  }
+}  // namespace libp2p::protocol
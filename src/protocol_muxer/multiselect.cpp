@@ -5,6 +5,8 @@
  */
 
 #include <libp2p/log/logger.hpp>
+#include <libp2p/protocol_muxer/multiselect/lazy_connection.hpp>
+#include <libp2p/protocol_muxer/multiselect/lazy_stream.hpp>
 #include <libp2p/protocol_muxer/multiselect/multiselect_instance.hpp>
 #include <libp2p/protocol_muxer/multiselect/simple_stream_negotiate.hpp>
 
@@ -33,6 +35,19 @@ namespace libp2p::protocol_muxer::multiselect {
                                std::move(cb));
   }
 
+  void Multiselect::selectOneOf(
+      std::shared_ptr<const StreamProtocols> protocols,
+      std::shared_ptr<basic::ReadWriter> connection,
+      bool is_initiator,
+      bool negotiate_multiselect,
+      ProtocolHandlerFunc cb) {
+    getInstance()->selectOneOf(std::move(protocols),
+                               std::move(connection),
+                               is_initiator,
+                               negotiate_multiselect,
+                               std::move(cb));
+  }
+
   void Multiselect::simpleStreamNegotiate(
       const std::shared_ptr<connection::Stream> &stream,
       const peer::ProtocolName &protocol_id,
@@ -49,6 +64,32 @@ namespace libp2p::protocol_muxer::multiselect {
     simpleStreamNegotiateImpl(stream, protocol_id, std::move(cb));
   }
 
+  outcome::result<std::shared_ptr<connection::Stream>>
+  Multiselect::lazyStreamNegotiate(std::shared_ptr<connection::Stream> stream,
+                                   const peer::ProtocolName &protocol_id) {
+    assert(stream);
+    assert(!protocol_id.empty());
+
+    SL_TRACE(log(), "lazy negotiating outbound stream for {}", protocol_id);
+
+    OUTCOME_TRY(lazy, LazyStream::create(std::move(stream), protocol_id));
+    return lazy;
+  }
+
+  outcome::result<std::shared_ptr<connection::LayerConnection>>
+  Multiselect::lazyConnectionNegotiate(
+      std::shared_ptr<connection::LayerConnection> connection,
+      const peer::ProtocolName &protocol_id) {
+    assert(connection);
+    assert(!protocol_id.empty());
+
+    SL_TRACE(log(), "lazy negotiating security protocol {}", protocol_id);
+
+    OUTCOME_TRY(lazy,
+                LazyConnection::create(std::move(connection), protocol_id));
+    return lazy;
+  }
+
   void Multiselect::instanceClosed(Instance instance,
                                    const ProtocolHandlerFunc &cb,
                                    outcome::result<peer::ProtocolName> result) {
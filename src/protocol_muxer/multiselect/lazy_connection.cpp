@@ -0,0 +1,238 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/protocol_muxer/multiselect/lazy_connection.hpp>
+
+#include <libp2p/basic/write.hpp>
+#include <libp2p/log/logger.hpp>
+#include <libp2p/protocol_muxer/multiselect/serializing.hpp>
+#include <libp2p/protocol_muxer/protocol_muxer.hpp>
+
+namespace libp2p::protocol_muxer::multiselect {
+
+  namespace {
+    const log::Logger &log() {
+      static log::Logger logger = log::createLogger("Multiselect");
+      return logger;
+    }
+  }  // namespace
+
+  outcome::result<std::shared_ptr<LazyConnection>> LazyConnection::create(
+      std::shared_ptr<connection::LayerConnection> connection,
+      const peer::ProtocolName &protocol) {
+    OUTCOME_TRY(header, detail::createMessage(kProtocolId));
+    OUTCOME_TRY(message, detail::createMessage(protocol));
+    auto prefix_size = message.size() - protocol.size() - 1;
+    auto first_part_size = header.size() + prefix_size;
+    header.insert(header.end(), message.begin(), message.end());
+    return std::make_shared<LazyConnection>(
+        std::move(connection), std::move(header), first_part_size);
+  }
+
+  LazyConnection::LazyConnection(
+      std::shared_ptr<connection::LayerConnection> connection,
+      MsgBuf proposal,
+      size_t first_part_size)
+      : connection_{std::move(connection)},
+        proposal_{std::move(proposal)},
+        first_part_size_{first_part_size} {
+    BOOST_ASSERT(connection_ != nullptr);
+    BOOST_ASSERT(first_part_size_ < proposal_.size());
+  }
+
+  void LazyConnection::read(BytesOut out, size_t bytes, ReadCallbackFunc cb) {
+    doRead({out, bytes, false, std::move(cb)});
+  }
+
+  void LazyConnection::readSome(BytesOut out,
+                                size_t bytes,
+                                ReadCallbackFunc cb) {
+    doRead({out, bytes, true, std::move(cb)});
+  }
+
+  void LazyConnection::doRead(PendingRead read) {
+    if (negotiated_) {
+      if (negotiated_->has_error()) {
+        return connection_->deferReadCallback(negotiated_->error(),
+                                              std::move(read.cb));
+      }
+      if (read.some) {
+        return connection_->readSome(read.out, read.bytes, std::move(read.cb));
+      }
+      return connection_->read(read.out, read.bytes, std::move(read.cb));
+    }
+    if (pending_read_) {
+      return connection_->deferReadCallback(
+          make_error_code(std::errc::operation_in_progress),
+          std::move(read.cb));
+    }
+    pending_read_ = std::move(read);
+    if (proposal_state_ == ProposalState::kNotSent) {
+      sendProposal();
+    }
+    if (not reading_reply_) {
+      readReply();
+    }
+  }
+
+  void LazyConnection::deferReadCallback(outcome::result<size_t> res,
+                                         ReadCallbackFunc cb) {
+    connection_->deferReadCallback(res, std::move(cb));
+  }
+
+  void LazyConnection::writeSome(BytesIn in,
+                                 size_t bytes,
+                                 WriteCallbackFunc cb) {
+    if (negotiated_ and negotiated_->has_error()) {
+      return connection_->deferWriteCallback(negotiated_->error(),
+                                             std::move(cb));
+    }
+    switch (proposal_state_) {
+      case ProposalState::kSent:
+        return connection_->writeSome(in, bytes, std::move(cb));
+      case ProposalState::kSending:
+        if (pending_write_) {
+          return connection_->deferWriteCallback(
+              make_error_code(std::errc::operation_in_progress),
+              std::move(cb));
+        }
+        pending_write_ = PendingWrite{in, bytes, std::move(cb)};
+        return;
+      case ProposalState::kNotSent:
+        break;
+    }
+    if (bytes == 0 or in.size() < bytes) {
+      return connection_->writeSome(in, bytes, std::move(cb));
+    }
+    // handshake message goes right after proposal, without waiting for reply
+    proposal_state_ = ProposalState::kSending;
+    BytesIn proposal{proposal_.data(), proposal_.size()};
+    writeVectored(connection_,
+                  {proposal, in.first(bytes)},
+                  [self{shared_from_this()}, bytes, cb{std::move(cb)}](
+                      outcome::result<void> res) {
+                    self->onProposalSent(res);
+                    if (res.has_error()) {
+                      return cb(res.error());
+                    }
+                    cb(bytes);
+                  });
+  }
+
+  void LazyConnection::writeSomeVectored(std::span<const BytesIn> in,
+                                         WriteCallbackFunc cb) {
+    auto failed = negotiated_ and negotiated_->has_error();
+    if (proposal_state_ == ProposalState::kSent and not failed) {
+      return connection_->writeSomeVectored(in, std::move(cb));
+    }
+    // proposal goes with the first buffer
+    LayerConnection::writeSomeVectored(in, std::move(cb));
+  }
+
+  void LazyConnection::deferWriteCallback(std::error_code ec,
+                                          WriteCallbackFunc cb) {
+    connection_->deferWriteCallback(ec, std::move(cb));
+  }
+
+  void LazyConnection::sendProposal() {
+    proposal_state_ = ProposalState::kSending;
+    BytesIn proposal{proposal_.data(), proposal_.size()};
+    writeVectored(connection_,
+                  {proposal},
+                  [self{shared_from_this()}](outcome::result<void> res) {
+                    self->onProposalSent(res);
+                  });
+  }
+
+  void LazyConnection::onProposalSent(outcome::result<void> res) {
+    proposal_state_ = ProposalState::kSent;
+    if (res.has_error()) {
+      // reply read fails as well and reports the error
+      SL_DEBUG(log(), "lazy proposal write failed: {}", res.error());
+    }
+    if (pending_write_) {
+      auto write = std::move(pending_write_.value());
+      pending_write_.reset();
+      writeSome(write.in, write.bytes, std::move(write.cb));
+    }
+  }
+
+  void LazyConnection::readReply() {
+    reading_reply_ = true;
+    reply_.resize(proposal_.size());
+    BytesOut out{reply_.data(), reply_.size()};
+    out = out.first(first_part_size_);
+    connection_->read(
+        out,
+        out.size(),
+        [self{shared_from_this()}](outcome::result<size_t> res) {
+          self->onReplyRead(res, true);
+        });
+  }
+
+  void LazyConnection::onReplyRead(outcome::result<size_t> res,
+                                   bool first_part) {
+    if (res.has_error()) {
+      return onNegotiated(res.error());
+    }
+    BytesIn expected{proposal_.data(), proposal_.size()};
+    BytesIn got{reply_.data(), reply_.size()};
+    if (first_part) {
+      expected = expected.first(first_part_size_);
+      got = got.first(first_part_size_);
+    }
+    if (not std::equal(
+            expected.begin(), expected.end(), got.begin(), got.end())) {
+      SL_DEBUG(log(), "lazy security proposal was not accepted by peer");
+      return onNegotiated(ProtocolMuxer::Error::NEGOTIATION_FAILED);
+    }
+    if (not first_part) {
+      return onNegotiated(outcome::success());
+    }
+    BytesOut out{reply_.data(), reply_.size()};
+    out = out.subspan(first_part_size_);
+    connection_->read(
+        out,
+        out.size(),
+        [self{shared_from_this()}](outcome::result<size_t> res) {
+          self->onReplyRead(res, false);
+        });
+  }
+
+  void LazyConnection::onNegotiated(outcome::result<void> res) {
+    reading_reply_ = false;
+    negotiated_ = res;
+    if (res.has_error()) {
+      std::ignore = connection_->close();
+    }
+    if (pending_read_) {
+      auto read = std::move(pending_read_.value());
+      pending_read_.reset();
+      doRead(std::move(read));
+    }
+  }
+
+  bool LazyConnection::isClosed() const {
+    return connection_->isClosed();
+  }
+
+  outcome::result<void> LazyConnection::close() {
+    return connection_->close();
+  }
+
+  bool LazyConnection::isInitiator() const {
+    return connection_->isInitiator();
+  }
+
+  outcome::result<multi::Multiaddress> LazyConnection::localMultiaddr() {
+    return connection_->localMultiaddr();
+  }
+
+  outcome::result<multi::Multiaddress> LazyConnection::remoteMultiaddr() {
+    return connection_->remoteMultiaddr();
+  }
+
+}  // namespace libp2p::protocol_muxer::multiselect
@@ -0,0 +1,254 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/protocol_muxer/multiselect/lazy_stream.hpp>
+
+#include <libp2p/basic/write.hpp>
+#include <libp2p/log/logger.hpp>
+#include <libp2p/protocol_muxer/multiselect/serializing.hpp>
+#include <libp2p/protocol_muxer/protocol_muxer.hpp>
+
+namespace libp2p::protocol_muxer::multiselect {
+
+  namespace {
+    const log::Logger &log() {
+      static log::Logger logger = log::createLogger("Multiselect");
+      return logger;
+    }
+  }  // namespace
+
+  outcome::result<std::shared_ptr<LazyStream>> LazyStream::create(
+      std::shared_ptr<connection::Stream> stream,
+      const peer::ProtocolName &protocol) {
+    OUTCOME_TRY(header, detail::createMessage(kProtocolId));
+    OUTCOME_TRY(message, detail::createMessage(protocol));
+    auto prefix_size = message.size() - protocol.size() - 1;
+    auto first_part_size = header.size() + prefix_size;
+    header.insert(header.end(), message.begin(), message.end());
+    return std::make_shared<LazyStream>(
+        std::move(stream), std::move(header), first_part_size);
+  }
+
+  LazyStream::LazyStream(std::shared_ptr<connection::Stream> stream,
+                         MsgBuf proposal,
+                         size_t first_part_size)
+      : stream_{std::move(stream)},
+        proposal_{std::move(proposal)},
+        first_part_size_{first_part_size} {
+    BOOST_ASSERT(stream_ != nullptr);
+    BOOST_ASSERT(first_part_size_ < proposal_.size());
+  }
+
+  void LazyStream::read(BytesOut out, size_t bytes, ReadCallbackFunc cb) {
+    doRead({out, bytes, false, std::move(cb)});
+  }
+
+  void LazyStream::readSome(BytesOut out, size_t bytes, ReadCallbackFunc cb) {
+    doRead({out, bytes, true, std::move(cb)});
+  }
+
+  void LazyStream::doRead(PendingRead read) {
+    if (negotiated_) {
+      if (negotiated_->has_error()) {
+        return stream_->deferReadCallback(negotiated_->error(),
+                                          std::move(read.cb));
+      }
+      if (read.some) {
+        return stream_->readSome(read.out, read.bytes, std::move(read.cb));
+      }
+      return stream_->read(read.out, read.bytes, std::move(read.cb));
+    }
+    if (pending_read_) {
+      return stream_->deferReadCallback(
+          connection::Stream::Error::STREAM_IS_READING, std::move(read.cb));
+    }
+    pending_read_ = std::move(read);
+    if (proposal_state_ == ProposalState::kNotSent) {
+      sendProposal();
+    }
+    if (not reading_reply_) {
+      readReply();
+    }
+  }
+
+  void LazyStream::deferReadCallback(outcome::result<size_t> res,
+                                     ReadCallbackFunc cb) {
+    stream_->deferReadCallback(res, std::move(cb));
+  }
+
+  void LazyStream::writeSome(BytesIn in, size_t bytes, WriteCallbackFunc cb) {
+    if (negotiated_ and negotiated_->has_error()) {
+      return stream_->deferWriteCallback(negotiated_->error(), std::move(cb));
+    }
+    switch (proposal_state_) {
+      case ProposalState::kSent:
+        return stream_->writeSome(in, bytes, std::move(cb));
+      case ProposalState::kSending:
+        if (pending_write_) {
+          return stream_->deferWriteCallback(
+              connection::Stream::Error::STREAM_WRITE_OVERFLOW, std::move(cb));
+        }
+        pending_write_ = PendingWrite{in, bytes, std::move(cb)};
+        return;
+      case ProposalState::kNotSent:
+        break;
+    }
+    if (bytes == 0 or in.size() < bytes) {
+      return stream_->writeSome(in, bytes, std::move(cb));
+    }
+    // application data goes right after proposal, without waiting for reply
+    proposal_state_ = ProposalState::kSending;
+    BytesIn proposal{proposal_.data(), proposal_.size()};
+    writeVectored(stream_,
+                  {proposal, in.first(bytes)},
+                  [self{shared_from_this()}, bytes, cb{std::move(cb)}](
+                      outcome::result<void> res) {
+                    self->onProposalSent(res);
+                    if (res.has_error()) {
+                      return cb(res.error());
+                    }
+                    cb(bytes);
+                  });
+  }
+
+  void LazyStream::deferWriteCallback(std::error_code ec,
+                                      WriteCallbackFunc cb) {
+    stream_->deferWriteCallback(ec, std::move(cb));
+  }
+
+  void LazyStream::sendProposal() {
+    proposal_state_ = ProposalState::kSending;
+    BytesIn proposal{proposal_.data(), proposal_.size()};
+    writeVectored(stream_,
+                  {proposal},
+                  [self{shared_from_this()}](outcome::result<void> res) {
+                    self->onProposalSent(res);
+                  });
+  }
+
+  void LazyStream::onProposalSent(outcome::result<void> res) {
+    proposal_state_ = ProposalState::kSent;
+    if (res.has_error()) {
+      // reply read fails as well and reports the error
+      SL_DEBUG(log(), "lazy proposal write failed: {}", res.error());
+    }
+    if (pending_write_) {
+      auto write = std::move(pending_write_.value());
+      pending_write_.reset();
+      writeSome(write.in, write.bytes, std::move(write.cb));
+    }
+  }
+
+  void LazyStream::readReply() {
+    reading_reply_ = true;
+    reply_.resize(proposal_.size());
+    BytesOut out{reply_.data(), reply_.size()};
+    out = out.first(first_part_size_);
+    stream_->read(
+        out,
+        out.size(),
+        [self{shared_from_this()}](outcome::result<size_t> res) {
+          self->onReplyRead(res, true);
+        });
+  }
+
+  void LazyStream::onReplyRead(outcome::result<size_t> res, bool first_part) {
+    if (res.has_error()) {
+      return onNegotiated(res.error());
+    }
+    BytesIn expected{proposal_.data(), proposal_.size()};
+    BytesIn got{reply_.data(), reply_.size()};
+    if (first_part) {
+      expected = expected.first(first_part_size_);
+      got = got.first(first_part_size_);
+    }
+    if (not std::equal(expected.begin(),
+                       expected.end(),
+                       got.begin(),
+                       got.end())) {
+      SL_DEBUG(log(), "lazy proposal was not accepted by peer");
+      return onNegotiated(ProtocolMuxer::Error::NEGOTIATION_FAILED);
+    }
+    if (not first_part) {
+      return onNegotiated(outcome::success());
+    }
+    BytesOut out{reply_.data(), reply_.size()};
+    out = out.subspan(first_part_size_);
+    stream_->read(
+        out,
+        out.size(),
+        [self{shared_from_this()}](outcome::result<size_t> res) {
+          self->onReplyRead(res, false);
+        });
+  }
+
+  void LazyStream::onNegotiated(outcome::result<void> res) {
+    reading_reply_ = false;
+    negotiated_ = res;
+    if (res.has_error()) {
+      stream_->reset();
+    }
+    if (pending_read_) {
+      auto read = std::move(pending_read_.value());
+      pending_read_.reset();
+      doRead(std::move(read));
+    }
+  }
+
+  bool LazyStream::isClosedForRead() const {
+    return stream_->isClosedForRead();
+  }
+
+  bool LazyStream::isClosedForWrite() const {
+    return stream_->isClosedForWrite();
+  }
+
+  bool LazyStream::isClosed() const {
+    return stream_->isClosed();
+  }
+
+  void LazyStream::close(VoidResultHandlerFunc cb) {
+    stream_->close(std::move(cb));
+  }
+
+  void LazyStream::reset() {
+    stream_->reset();
+  }
+
+  void LazyStream::adjustWindowSize(uint32_t new_size,
+                                    VoidResultHandlerFunc cb) {
+    stream_->adjustWindowSize(new_size, std::move(cb));
+  }
+
+  outcome::result<bool> LazyStream::isInitiator() const {
+    return stream_->isInitiator();
+  }
+
+  outcome::result<peer::PeerId> LazyStream::remotePeerId() const {
+    return stream_->remotePeerId();
+  }
+
+  outcome::result<multi::Multiaddress> LazyStream::localMultiaddr() const {
+    return stream_->localMultiaddr();
+  }
+
+  outcome::result<multi::Multiaddress> LazyStream::remoteMultiaddr() const {
+    return stream_->remoteMultiaddr();
+  }
+
+  void LazyStream::attributeTraffic(const peer::ProtocolName &protocol) {
+    stream_->attributeTraffic(protocol);
+  }
+
+  bool LazyStream::admitProtocol(const peer::ProtocolName &protocol) {
+    return stream_->admitProtocol(protocol);
+  }
+
+  void LazyStream::setWriteWeight(uint8_t weight) {
+    stream_->setWriteWeight(weight);
+  }
+
+}  // namespace libp2p::protocol_muxer::multiselect
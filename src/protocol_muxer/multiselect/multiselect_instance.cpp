@@ -32,15 +32,59 @@ namespace libp2p::protocol_muxer::multiselect {
       bool negotiate_multiselect,
       Multiselect::ProtocolHandlerFunc cb) {
     assert(!protocols.empty());
+
+    // assignment reuses strings of previous negotiation
+    owned_protocols_.assign(protocols.begin(), protocols.end());
+    shared_protocols_.reset();
+    protocols_.assign(owned_protocols_.begin(), owned_protocols_.end());
+
+    start(std::move(connection),
+          is_initiator,
+          negotiate_multiselect,
+          std::move(cb));
+  }
+
+  void MultiselectInstance::selectOneOf(
+      std::shared_ptr<const StreamProtocols> protocols,
+      std::shared_ptr<basic::ReadWriter> connection,
+      bool is_initiator,
+      bool negotiate_multiselect,
+      Multiselect::ProtocolHandlerFunc cb) {
+    assert(protocols);
+    assert(!protocols->empty());
+
+    protocols_.assign(protocols->begin(), protocols->end());
+    shared_protocols_ = std::move(protocols);
+
+    start(std::move(connection),
+          is_initiator,
+          negotiate_multiselect,
+          std::move(cb));
+  }
+
+  void MultiselectInstance::start(
+      std::shared_ptr<basic::ReadWriter> connection,
+      bool is_initiator,
+      bool negotiate_multiselect,
+      Multiselect::ProtocolHandlerFunc cb) {
     assert(connection);
     assert(cb);
 
-    protocols_.assign(protocols.begin(), protocols.end());
-
     connection_ = std::move(connection);
 
     callback_ = std::move(cb);
 
+    span_ = metrics::Span{"libp2p.multiselect"};
+    if (span_) {
+      span_.setAttribute("initiator", is_initiator ? "true" : "false");
+      std::string names;
+      for (auto &protocol : protocols_) {
+        names += names.empty() ? "" : " ";
+        names += protocol;
+      }
+      span_.setAttribute("protocols", names);
+    }
+
     is_initiator_ = is_initiator;
 
     multistream_negotiated_ = !negotiate_multiselect;
@@ -159,7 +203,7 @@ namespace libp2p::protocol_muxer::multiselect {
 
       if (wait_for_reply_sent_.has_value()) {
         // reply was sent successfully, closing with success
-        return close(protocols_[wait_for_reply_sent_.value()]);
+        return close(std::string{protocols_[wait_for_reply_sent_.value()]});
       }
     }
   }
@@ -170,6 +214,10 @@ namespace libp2p::protocol_muxer::multiselect {
     write_queue_.clear();
     Multiselect::ProtocolHandlerFunc callback;
     callback.swap(callback_);
+    if (result) {
+      span_.setAttribute("protocol", result.value());
+    }
+    span_.end(result.has_value() ? std::error_code{} : result.error());
 
     owner_.instanceClosed(shared_from_this(), callback, std::move(result));
   }
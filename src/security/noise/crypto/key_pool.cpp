@@ -0,0 +1,145 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/security/noise/crypto/key_pool.hpp>
+
+#include <libp2p/common/metrics/registry.hpp>
+
+namespace libp2p::security::noise {
+
+  namespace {
+    metrics::Counter &missesCounter() {
+      static auto &counter = metrics::Registry::instance().counter(
+          "libp2p_noise_key_pool_misses_total",
+          "Noise handshake keys generated in place for empty key pool");
+      return counter;
+    }
+  }  // namespace
+
+  KeyPool::KeyPool(std::shared_ptr<DiffieHellman> dh,
+                   size_t capacity,
+                   std::shared_ptr<basic::Scheduler> scheduler)
+      : dh_{std::move(dh)},
+        capacity_{capacity},
+        scheduler_{std::move(scheduler)} {}
+
+  KeyPool::~KeyPool() {
+    {
+      std::lock_guard lock{mutex_};
+      stop_ = true;
+    }
+    refill_cv_.notify_one();
+    if (thread_.joinable()) {
+      thread_.join();
+    }
+  }
+
+  void KeyPool::start() {
+    if (scheduler_) {
+      scheduleRefill();
+      return;
+    }
+    if (not thread_.joinable()) {
+      thread_ = std::thread{[this] { refillLoop(); }};
+    }
+  }
+
+  outcome::result<DHKey> KeyPool::take() {
+    std::unique_lock lock{mutex_};
+    if (not keys_.empty()) {
+      auto key = std::move(keys_.front());
+      keys_.pop_front();
+      lock.unlock();
+      refill();
+      return key;
+    }
+    lock.unlock();
+    missesCounter().inc();
+    refill();
+    return dh_->generate();
+  }
+
+  size_t KeyPool::size() const {
+    std::lock_guard lock{mutex_};
+    return keys_.size();
+  }
+
+  void KeyPool::refill() {
+    if (scheduler_) {
+      scheduleRefill();
+    } else {
+      refill_cv_.notify_one();
+    }
+  }
+
+  void KeyPool::refillLoop() {
+    std::unique_lock lock{mutex_};
+    while (true) {
+      refill_cv_.wait(lock,
+                      [this] { return stop_ or keys_.size() < capacity_; });
+      if (stop_) {
+        return;
+      }
+      lock.unlock();
+      auto key = dh_->generate();
+      lock.lock();
+      if (key.has_value()) {
+        keys_.emplace_back(std::move(key.value()));
+      } else {
+        // retry on next take instead of spinning
+        refill_cv_.wait(lock);
+      }
+    }
+  }
+
+  void KeyPool::scheduleRefill() {
+    // scheduler calls back on the thread of take(), so no lock is needed
+    if (refill_scheduled_ or size() >= capacity_) {
+      return;
+    }
+    refill_scheduled_ = true;
+    // precomputed keys must not delay handshakes in progress
+    scheduler_->schedule(
+        [weak_self{weak_from_this()}] {
+          auto self = weak_self.lock();
+          if (not self) {
+            return;
+          }
+          self->refill_scheduled_ = false;
+          auto key = self->dh_->generate();
+          if (not key.has_value()) {
+            return;
+          }
+          {
+            std::lock_guard lock{self->mutex_};
+            self->keys_.emplace_back(std::move(key.value()));
+          }
+          self->scheduleRefill();
+        },
+        basic::Scheduler::Priority::BACKGROUND);
+  }
+
+  PooledDiffieHellman::PooledDiffieHellman(std::shared_ptr<DiffieHellman> dh,
+                                           std::shared_ptr<KeyPool> pool)
+      : dh_{std::move(dh)}, pool_{std::move(pool)} {}
+
+  outcome::result<DHKey> PooledDiffieHellman::generate() {
+    return pool_->take();
+  }
+
+  outcome::result<Bytes> PooledDiffieHellman::dh(const Bytes &private_key,
+                                                 const Bytes &public_key) {
+    return dh_->dh(private_key, public_key);
+  }
+
+  int PooledDiffieHellman::dhSize() const {
+    return dh_->dhSize();
+  }
+
+  std::string PooledDiffieHellman::dhName() const {
+    return dh_->dhName();
+  }
+}  // namespace libp2p::security::noise
@@ -0,0 +1,144 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/security/noise/crypto/noise_aesgcm.hpp>
+
+#include <boost/assert.hpp>
+#include <libp2p/crypto/error.hpp>
+
+namespace libp2p::security::noise {
+  using crypto::OpenSslError;
+
+  constexpr size_t kTagSize = 16;
+
+  NoiseAESGCMImpl::NoiseAESGCMImpl(Key32 key) : key_{key} {}
+
+  NoiseAESGCMImpl::Nonce NoiseAESGCMImpl::toNonce(uint64_t n) {
+    Nonce nonce{};
+    for (size_t i = nonce.size(); i > 4; --i, n >>= 8) {
+      nonce[i - 1] = static_cast<uint8_t>(n & 0xff);
+    }
+    return nonce;
+  }
+
+  outcome::result<EVP_AEAD_CTX *> NoiseAESGCMImpl::context(bool encrypt) {
+    auto &ctx = encrypt ? seal_ctx_ : open_ctx_;
+    auto &ready = encrypt ? seal_ready_ : open_ready_;
+    if (not ready) {
+      // key expansion is done once, all messages of the key reuse it
+      if (1
+          != EVP_AEAD_CTX_init_with_direction(
+              ctx.get(),
+              EVP_aead_aes_256_gcm(),
+              key_.data(),
+              key_.size(),
+              kTagSize,
+              encrypt ? evp_aead_seal : evp_aead_open)) {
+        return OpenSslError::FAILED_INITIALIZE_CONTEXT;
+      }
+      ready = true;
+    }
+    return ctx.get();
+  }
+
+  outcome::result<Bytes> NoiseAESGCMImpl::encrypt(BytesIn precompiled_out,
+                                                  uint64_t nonce,
+                                                  BytesIn plaintext,
+                                                  BytesIn aad) {
+    auto res = spanToVec(precompiled_out);
+    auto prefix = res.size();
+    res.resize(prefix + plaintext.size() + kTagSize);
+    OUTCOME_TRY(size,
+                encryptInto(nonce,
+                            plaintext,
+                            aad,
+                            BytesOut{res}.subspan(prefix)));
+    res.resize(prefix + size);
+    return res;
+  }
+
+  outcome::result<Bytes> NoiseAESGCMImpl::decrypt(BytesIn precompiled_out,
+                                                  uint64_t nonce,
+                                                  BytesIn ciphertext,
+                                                  BytesIn aad) {
+    auto res = spanToVec(precompiled_out);
+    auto prefix = res.size();
+    res.resize(prefix + ciphertext.size());
+    OUTCOME_TRY(size,
+                decryptInto(nonce,
+                            ciphertext,
+                            aad,
+                            BytesOut{res}.subspan(prefix)));
+    res.resize(prefix + size);
+    return res;
+  }
+
+  outcome::result<size_t> NoiseAESGCMImpl::encryptInto(uint64_t nonce,
+                                                       BytesIn plaintext,
+                                                       BytesIn aad,
+                                                       BytesOut out) {
+    OUTCOME_TRY(ctx, context(true));
+    auto n = toNonce(nonce);
+    size_t out_size = 0;
+    if (1
+        != EVP_AEAD_CTX_seal(ctx,
+                             out.data(),
+                             &out_size,
+                             out.size(),
+                             n.data(),
+                             n.size(),
+                             plaintext.data(),
+                             plaintext.size(),
+                             aad.data(),
+                             aad.size())) {
+      return OpenSslError::FAILED_ENCRYPT_UPDATE;
+    }
+    return out_size;
+  }
+
+  outcome::result<size_t> NoiseAESGCMImpl::decryptInto(uint64_t nonce,
+                                                       BytesIn ciphertext,
+                                                       BytesIn aad,
+                                                       BytesOut out) {
+    OUTCOME_TRY(ctx, context(false));
+    auto n = toNonce(nonce);
+    size_t out_size = 0;
+    if (1
+        != EVP_AEAD_CTX_open(ctx,
+                             out.data(),
+                             &out_size,
+                             out.size(),
+                             n.data(),
+                             n.size(),
+                             ciphertext.data(),
+                             ciphertext.size(),
+                             aad.data(),
+                             aad.size())) {
+      return OpenSslError::FAILED_DECRYPT_UPDATE;
+    }
+    return out_size;
+  }
+
+  outcome::result<void> NoiseAESGCMImpl::encryptManyInto(
+      uint64_t first_nonce,
+      std::span<const BytesIn> plaintexts,
+      BytesIn aad,
+      std::span<const BytesOut> outs) {
+    BOOST_ASSERT(plaintexts.size() == outs.size());
+    for (size_t i = 0; i < plaintexts.size(); ++i) {
+      OUTCOME_TRY(encryptInto(first_nonce + i, plaintexts[i], aad, outs[i]));
+    }
+    return outcome::success();
+  }
+
+  std::shared_ptr<AEADCipher> NamedAESGCMImpl::cipher(Key32 key) {
+    return std::make_shared<NoiseAESGCMImpl>(key);
+  }
+
+  std::string NamedAESGCMImpl::cipherName() const {
+    return "AESGCM";
+  }
+}  // namespace libp2p::security::noise
@@ -6,6 +6,8 @@
 
 #include <libp2p/security/noise/crypto/noise_ccp1305.hpp>
 
+#include <boost/assert.hpp>
+
 namespace libp2p::security::noise {
 
   NoiseCCP1305Impl::NoiseCCP1305Impl(Key32 key)
@@ -35,6 +37,33 @@ namespace libp2p::security::noise {
     return res;
   }
 
+  outcome::result<size_t> NoiseCCP1305Impl::encryptInto(uint64_t nonce,
+                                                        BytesIn plaintext,
+                                                        BytesIn aad,
+                                                        BytesOut out) {
+    return ccp_->encrypt(ccp_->uint64toNonce(nonce), plaintext, aad, out);
+  }
+
+  outcome::result<size_t> NoiseCCP1305Impl::decryptInto(uint64_t nonce,
+                                                        BytesIn ciphertext,
+                                                        BytesIn aad,
+                                                        BytesOut out) {
+    return ccp_->decrypt(ccp_->uint64toNonce(nonce), ciphertext, aad, out);
+  }
+
+  outcome::result<void> NoiseCCP1305Impl::encryptManyInto(
+      uint64_t first_nonce,
+      std::span<const BytesIn> plaintexts,
+      BytesIn aad,
+      std::span<const BytesOut> outs) {
+    BOOST_ASSERT(plaintexts.size() == outs.size());
+    for (size_t i = 0; i < plaintexts.size(); ++i) {
+      OUTCOME_TRY(ccp_->encrypt(
+          ccp_->uint64toNonce(first_nonce + i), plaintexts[i], aad, outs[i]));
+    }
+    return outcome::success();
+  }
+
   std::shared_ptr<AEADCipher> NamedCCPImpl::cipher(Key32 key) {
     return std::make_shared<NoiseCCP1305Impl>(key);
   }
@@ -76,6 +76,31 @@ namespace libp2p::security::noise {
     return dec_res;
   }
 
+  outcome::result<size_t> CipherState::encryptInto(BytesIn plaintext,
+                                                   BytesIn aad,
+                                                   BytesOut out) {
+    auto enc_res = cipher_->encryptInto(nonce_, plaintext, aad, out);
+    ++nonce_;
+    return enc_res;
+  }
+
+  outcome::result<size_t> CipherState::decryptInto(BytesIn ciphertext,
+                                                   BytesIn aad,
+                                                   BytesOut out) {
+    auto dec_res = cipher_->decryptInto(nonce_, ciphertext, aad, out);
+    ++nonce_;
+    return dec_res;
+  }
+
+  outcome::result<void> CipherState::encryptManyInto(
+      std::span<const BytesIn> plaintexts,
+      BytesIn aad,
+      std::span<const BytesOut> outs) {
+    auto enc_res = cipher_->encryptManyInto(nonce_, plaintexts, aad, outs);
+    nonce_ += plaintexts.size();
+    return enc_res;
+  }
+
   outcome::result<void> CipherState::rekey() {
     Key32 zeroed;
     memset(zeroed.data(), 0u, zeroed.size());
@@ -4,11 +4,14 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+#include <algorithm>
+#include <array>
 #include <memory>
 
 #include <libp2p/security/noise/handshake.hpp>
 
 #include <libp2p/common/byteutil.hpp>
+#include <libp2p/common/metrics/registry.hpp>
 #include <libp2p/peer/peer_id.hpp>
 #include <libp2p/security/noise/crypto/cipher_suite.hpp>
 #include <libp2p/security/noise/crypto/noise_ccp1305.hpp>
@@ -38,12 +41,42 @@ namespace libp2p::security::noise {
   namespace {
     template <typename T>
     void unused(T &&) {}
+
+    /// The first muxer of initiator which responder supports
+    boost::optional<peer::ProtocolName> matchMuxers(
+        const std::vector<peer::ProtocolName> &initiator,
+        const std::vector<peer::ProtocolName> &responder) {
+      for (const auto &muxer : initiator) {
+        if (std::ranges::find(responder, muxer) != responder.end()) {
+          return muxer;
+        }
+      }
+      return boost::none;
+    }
+
+    /// Calls f and adds its duration to total
+    template <typename F>
+    auto timed(std::chrono::steady_clock::duration &total, F &&f) {
+      auto started = std::chrono::steady_clock::now();
+      auto result = f();
+      total += std::chrono::steady_clock::now() - started;
+      return result;
+    }
   }  // namespace
 
-  std::shared_ptr<CipherSuite> defaultCipherSuite() {
-    auto dh = std::make_shared<NoiseDiffieHellmanImpl>();
+  std::shared_ptr<CipherSuite> defaultCipherSuite(
+      std::shared_ptr<KeyPool> key_pool,
+      std::shared_ptr<NamedAEADCipher> cipher) {
+    std::shared_ptr<DiffieHellman> dh =
+        std::make_shared<NoiseDiffieHellmanImpl>();
+    if (key_pool) {
+      dh = std::make_shared<PooledDiffieHellman>(std::move(dh),
+                                                 std::move(key_pool));
+    }
     auto hash = std::make_shared<NoiseSHA256HasherImpl>();
-    auto cipher = std::make_shared<NamedCCPImpl>();
+    if (not cipher) {
+      cipher = std::make_shared<NamedCCPImpl>();
+    }
     return std::make_shared<CipherSuiteImpl>(
         std::move(dh), std::move(hash), std::move(cipher));
   }
@@ -53,18 +86,30 @@ namespace libp2p::security::noise {
       std::unique_ptr<security::noise::HandshakeMessageMarshaller>
           noise_marshaller,
       crypto::KeyPair local_key,
+      std::shared_ptr<const crypto::SigningKey> signing_key,
       std::shared_ptr<connection::LayerConnection> connection,
       bool is_initiator,
       boost::optional<peer::PeerId> remote_peer_id,
       SecurityAdaptor::SecConnCallbackFunc cb,
-      std::shared_ptr<crypto::marshaller::KeyMarshaller> key_marshaller)
+      std::shared_ptr<crypto::marshaller::KeyMarshaller> key_marshaller,
+      std::shared_ptr<basic::Scheduler> scheduler,
+      NoiseConfig config,
+      std::shared_ptr<KeyPool> key_pool,
+      std::vector<peer::ProtocolName> muxers,
+      std::shared_ptr<NamedAEADCipher> cipher)
       : crypto_provider_{std::move(crypto_provider)},
         noise_marshaller_{std::move(noise_marshaller)},
         local_key_{std::move(local_key)},
+        signing_key_{std::move(signing_key)},
         conn_{std::move(connection)},
         initiator_{is_initiator},
         connection_cb_{std::move(cb)},
         key_marshaller_{std::move(key_marshaller)},
+        scheduler_{std::move(scheduler)},
+        config_{config},
+        key_pool_{std::move(key_pool)},
+        muxers_{std::move(muxers)},
+        cipher_{std::move(cipher)},
         read_buffer_{std::make_shared<Bytes>(kMaxMsgLen)},
         rw_{std::make_shared<InsecureReadWriter>(conn_, read_buffer_)},
         handshake_state_{std::make_unique<HandshakeState>()},
@@ -99,36 +144,61 @@ namespace libp2p::security::noise {
     std::copy(prefix.begin(), prefix.end(), std::back_inserter(to_sign));
     std::copy(pubkey.begin(), pubkey.end(), std::back_inserter(to_sign));
 
-    OUTCOME_TRY(signed_payload,
-                crypto_provider_->sign(to_sign, local_key_.privateKey));
+    OUTCOME_TRY(signed_payload, timed(times_.signature, [&] {
+                  if (signing_key_) {
+                    return crypto_provider_->sign(to_sign, *signing_key_);
+                  }
+                  return crypto_provider_->sign(to_sign, local_key_.privateKey);
+                }));
     security::noise::HandshakeMessage payload{
         .identity_key = local_key_.publicKey,
         .identity_sig = std::move(signed_payload),
-        .data = {}};
-    return noise_marshaller_->marshal(payload);
+        .data = {},
+        .stream_muxers = muxers_};
+    return timed(times_.marshal,
+                 [&] { return noise_marshaller_->marshal(payload); });
   }
 
   void Handshake::sendHandshakeMessage(BytesIn payload,
                                        basic::Writer::WriteCallbackFunc cb) {
-    IO_OUTCOME_TRY(
-        write_result, handshake_state_->writeMessage({}, payload), cb);
+    // message is built after reserved length prefix and written as is
+    constexpr std::array<uint8_t, kLengthPrefixSize> kReserved{};
+    IO_OUTCOME_TRY(write_result,
+                   timed(times_.dh,
+                         [&] {
+                           return handshake_state_->writeMessage(kReserved,
+                                                                 payload);
+                         }),
+                   cb);
     auto write_cb = [self{shared_from_this()},
                      cb{std::move(cb)},
-                     wr{write_result}](outcome::result<size_t> result) {
+                     cs1{write_result.cs1},
+                     cs2{write_result.cs2},
+                     started{Clock::now()}](outcome::result<size_t> result) {
+      self->times_.io += Clock::now() - started;
       IO_OUTCOME_TRY(bytes_written, result, cb);
-      if (wr.cs1 and wr.cs2) {
-        self->setCipherStates(wr.cs1, wr.cs2);
+      if (cs1 and cs2) {
+        self->setCipherStates(cs1, cs2);
       }
       cb(bytes_written);
     };
-    rw_->write(write_result.data, write_cb);
+    rw_->writeFramed(std::move(write_result.data), std::move(write_cb));
   }
 
   void Handshake::readHandshakeMessage(
       basic::MessageReadWriter::ReadCallbackFunc cb) {
-    auto read_cb = [self{shared_from_this()}, cb{std::move(cb)}](auto result) {
+    auto read_cb = [self{shared_from_this()},
+                    cb{std::move(cb)},
+                    started{Clock::now()}](auto result) {
+      self->times_.io += Clock::now() - started;
       IO_OUTCOME_TRY(buffer, result, cb);
-      IO_OUTCOME_TRY(rr, self->handshake_state_->readMessage({}, *buffer), cb);
+      IO_OUTCOME_TRY(rr,
+                     timed(self->times_.dh,
+                           [&] {
+                             return self->handshake_state_->readMessage(
+                                 {}, *buffer);
+                           }),
+                     cb);
       if (rr.cs1 and rr.cs2) {
         self->setCipherStates(rr.cs1, rr.cs2);
       }
@@ -141,8 +211,12 @@ namespace libp2p::security::noise {
 
   outcome::result<void> Handshake::handleRemoteHandshakePayload(
       BytesIn payload) {
-    OUTCOME_TRY(remote_payload, noise_marshaller_->unmarshal(payload));
-    OUTCOME_TRY(remote_id, peer::PeerId::fromPublicKey(remote_payload.second));
+    OUTCOME_TRY(remote_payload, timed(times_.marshal, [&] {
+                  return noise_marshaller_->unmarshal(payload);
+                }));
+    OUTCOME_TRY(remote_id, timed(times_.marshal, [&] {
+                  return peer::PeerId::fromPublicKey(remote_payload.second);
+                }));
     auto &&handy_payload = remote_payload.first;
     if (initiator_ and remote_peer_id_ != remote_id) {
       SL_DEBUG(log_,
@@ -161,32 +235,32 @@ namespace libp2p::security::noise {
     std::copy(remote_static.begin(),
               remote_static.end(),
               std::back_inserter(to_verify));
-    OUTCOME_TRY(
-        signature_correct,
-        crypto_provider_->verify(
-            to_verify, handy_payload.identity_sig, handy_payload.identity_key));
+    OUTCOME_TRY(signature_correct, timed(times_.signature, [&] {
+                  return crypto_provider_->verify(to_verify,
+                                                  handy_payload.identity_sig,
+                                                  handy_payload.identity_key);
+                }));
     if (not signature_correct) {
       SL_TRACE(log_, "Remote peer's payload signature verification failed");
       return std::errc::owner_dead;
     }
     remote_peer_id_ = remote_id;
     remote_peer_pubkey_ = handy_payload.identity_key;
+    const auto &remote_muxers = handy_payload.stream_muxers;
+    muxer_ = initiator_ ? matchMuxers(muxers_, remote_muxers)
+                        : matchMuxers(remote_muxers, muxers_);
     return outcome::success();
   }
 
   outcome::result<void> Handshake::runHandshake() {
-    auto cipher_suite = defaultCipherSuite();
-    OUTCOME_TRY(keypair, cipher_suite->generate());
+    // static and ephemeral keys both come from the pool, if any
+    auto cipher_suite = defaultCipherSuite(key_pool_, cipher_);
+    OUTCOME_TRY(keypair,
+                timed(times_.dh, [&] { return cipher_suite->generate(); }));
     HandshakeStateConfig config(
-        defaultCipherSuite(), handshakeXX, initiator_, keypair);
+        std::move(cipher_suite), handshakeXX, initiator_, keypair);
     OUTCOME_TRY(handshake_state_->init(std::move(config)));
     OUTCOME_TRY(payload, generateHandshakePayload(keypair));
-    const size_t dh25519_len = 32;
-    const size_t poly1305_tag_size = 16;
-    const size_t length_prefix_size = 2;
-    size_t max_msg_size =
-        2 * dh25519_len + payload.size() + 2 * poly1305_tag_size;
-    std::vector<uint8_t> buffer(max_msg_size + length_prefix_size);
     if (initiator_) {
       //
       // Outgoing connection. Stage 0
@@ -253,7 +327,7 @@ namespace libp2p::security::noise {
                     auto handle_result =
                         self->handleRemoteHandshakePayload(*plaintext);
                     if (handle_result.has_error()) {
-                      self->hscb(handle_result.error());
+                      return self->hscb(handle_result.error());
                     }
                     self->hscb(true);
                   });
@@ -263,7 +337,28 @@ namespace libp2p::security::noise {
     return outcome::success();
   }
 
+  void Handshake::observePhases() const {
+    auto &registry = metrics::Registry::instance();
+    static auto &dh = registry.histogram(
+        "libp2p_noise_handshake_dh_seconds",
+        "Time of noise handshakes in key generation, DH and encryption");
+    static auto &signature =
+        registry.histogram("libp2p_noise_handshake_signature_seconds",
+                           "Time of noise handshakes in identity signatures");
+    static auto &marshal =
+        registry.histogram("libp2p_noise_handshake_marshal_seconds",
+                           "Time of noise handshakes in payload marshalling");
+    static auto &io =
+        registry.histogram("libp2p_noise_handshake_io_seconds",
+                           "Time of noise handshakes waiting for I/O");
+    dh.observe(times_.dh);
+    signature.observe(times_.signature);
+    marshal.observe(times_.marshal);
+    io.observe(times_.io);
+  }
+
   void Handshake::hscb(outcome::result<bool> secured) {
+    observePhases();
     if (secured.has_error()) {
       log_->error("handshake failed, {}", secured.error());
       return connection_cb_(secured.error());
@@ -283,7 +378,10 @@ namespace libp2p::security::noise {
         remote_peer_pubkey_.value(),
         key_marshaller_,
         enc_,
-        dec_);
+        dec_,
+        scheduler_,
+        config_,
+        muxer_);
     log_->info("Handshake succeeded");
     connection_cb_(std::move(secured_connection));
   }
@@ -7,6 +7,8 @@
 #include <libp2p/security/noise/handshake_message_marshaller_impl.hpp>
 
 #include <generated/security/noise/protobuf/noise.pb.h>
+#include <libp2p/common/bytestr.hpp>
+#include <libp2p/multi/uvarint.hpp>
 OUTCOME_CPP_DEFINE_CATEGORY(libp2p::security::noise,
                             HandshakeMessageMarshallerImpl::Error,
                             e) {
@@ -21,22 +23,108 @@ OUTCOME_CPP_DEFINE_CATEGORY(libp2p::security::noise,
 }
 
 namespace libp2p::security::noise {
+  namespace {
+    using multi::UVarint;
+
+    /// Wire type of bytes, strings and embedded messages
+    constexpr uint8_t kLengthDelimited = 2;
+
+    /// NoiseHandshakePayload fields
+    constexpr uint64_t kIdentityKey = 1;
+    constexpr uint64_t kIdentitySig = 2;
+    constexpr uint64_t kData = 3;
+    constexpr uint64_t kExtensions = 4;
+    /// NoiseExtensions field
+    constexpr uint64_t kStreamMuxers = 2;
+
+    constexpr uint8_t tag(uint64_t field) {
+      return static_cast<uint8_t>((field << 3) | kLengthDelimited);
+    }
+
+    /// Size of length delimited field, proto3 omits empty singular ones
+    size_t fieldSize(size_t size) {
+      return 1 + UVarint{size}.size() + size;
+    }
+
+    /// Writes length delimited field and advances out
+    void writeField(BytesOut &out, uint64_t field, BytesIn bytes) {
+      UVarint length{static_cast<uint64_t>(bytes.size())};
+      out[0] = tag(field);
+      std::ranges::copy(length.toBytes(), out.begin() + 1);
+      out = out.subspan(1 + length.size());
+      std::ranges::copy(bytes, out.begin());
+      out = out.subspan(bytes.size());
+    }
+
+    /// Reads next field of message, skips other wire types
+    outcome::result<void> readFields(
+        BytesIn in, const std::function<void(uint64_t, BytesIn)> &on_field) {
+      using Error = HandshakeMessageMarshallerImpl::Error;
+      while (not in.empty()) {
+        auto key = UVarint::decode(in);
+        if (not key) {
+          return Error::MESSAGE_DESERIALIZING_ERROR;
+        }
+        in = in.subspan(key->size);
+        auto wire_type = key->value & 7;
+        size_t skip = 0;
+        if (wire_type == 0) {
+          auto value = UVarint::decode(in);
+          if (not value) {
+            return Error::MESSAGE_DESERIALIZING_ERROR;
+          }
+          skip = value->size;
+        } else if (wire_type == 1) {
+          skip = 8;
+        } else if (wire_type == 5) {
+          skip = 4;
+        } else if (wire_type == kLengthDelimited) {
+          auto length = UVarint::decode(in);
+          if (not length or length->value > in.size() - length->size) {
+            return Error::MESSAGE_DESERIALIZING_ERROR;
+          }
+          in = in.subspan(length->size);
+          on_field(key->value >> 3, in.first(length->value));
+          skip = length->value;
+        } else {
+          return Error::MESSAGE_DESERIALIZING_ERROR;
+        }
+        if (skip > in.size()) {
+          return Error::MESSAGE_DESERIALIZING_ERROR;
+        }
+        in = in.subspan(skip);
+      }
+      return outcome::success();
+    }
+  }  // namespace
 
   HandshakeMessageMarshallerImpl::HandshakeMessageMarshallerImpl(
-      std::shared_ptr<crypto::marshaller::KeyMarshaller> marshaller)
-      : marshaller_{std::move(marshaller)} {};
+      std::shared_ptr<crypto::marshaller::KeyMarshaller> marshaller,
+      std::shared_ptr<const LocalKey> local_key)
+      : marshaller_{std::move(marshaller)}, local_key_{std::move(local_key)} {};
 
   outcome::result<protobuf::NoiseHandshakePayload>
   HandshakeMessageMarshallerImpl::handyToProto(
       const HandshakeMessage &msg) const {
     protobuf::NoiseHandshakePayload proto_msg;
 
-    OUTCOME_TRY(proto_pubkey_bytes, marshaller_->marshal(msg.identity_key));
-    proto_msg.set_identity_key(proto_pubkey_bytes.key.data(),
-                               proto_pubkey_bytes.key.size());
+    if (local_key_ and msg.identity_key == local_key_->key) {
+      proto_msg.set_identity_key(local_key_->proto.key.data(),
+                                 local_key_->proto.key.size());
+    } else {
+      OUTCOME_TRY(proto_pubkey_bytes, marshaller_->marshal(msg.identity_key));
+      proto_msg.set_identity_key(proto_pubkey_bytes.key.data(),
+                                 proto_pubkey_bytes.key.size());
+    }
     proto_msg.set_identity_sig(msg.identity_sig.data(),
                                msg.identity_sig.size());
     proto_msg.set_data(msg.data.data(), msg.data.size());
+    if (not msg.stream_muxers.empty()) {
+      auto &extensions = *proto_msg.mutable_extensions();
+      for (const auto &muxer : msg.stream_muxers) {
+        extensions.add_stream_muxers(muxer);
+      }
+    }
     return proto_msg;
   }
 
@@ -48,21 +136,65 @@ namespace libp2p::security::noise {
     crypto::ProtobufKey proto_key{std::move(key_bytes)};
     OUTCOME_TRY(pubkey, marshaller_->unmarshalPublicKey(proto_key));
 
+    const auto &muxers = proto_msg.extensions().stream_muxers();
     return std::make_pair(
         HandshakeMessage{
             .identity_key = std::move(pubkey),
             .identity_sig = {proto_msg.identity_sig().begin(),
                              proto_msg.identity_sig().end()},
-            .data = {proto_msg.data().begin(), proto_msg.data().end()}},
+            .data = {proto_msg.data().begin(), proto_msg.data().end()},
+            .stream_muxers = {muxers.begin(), muxers.end()}},
         std::move(proto_key));
   }
 
   outcome::result<Bytes> HandshakeMessageMarshallerImpl::marshal(
       const HandshakeMessage &msg) const {
-    OUTCOME_TRY(proto_msg, handyToProto(msg));
-    Bytes out_msg(proto_msg.ByteSizeLong());
-    if (not proto_msg.SerializeToArray(out_msg.data(),
-                                       static_cast<int>(out_msg.size()))) {
+    // fields are written straight into the output, as protobuf would
+    // serialize them, without intermediate message and its strings
+    std::optional<crypto::ProtobufKey> marshalled_key;
+    BytesIn identity_key;
+    if (local_key_ and msg.identity_key == local_key_->key) {
+      identity_key = local_key_->proto.key;
+    } else {
+      OUTCOME_TRY(proto_key, marshaller_->marshal(msg.identity_key));
+      identity_key = marshalled_key.emplace(std::move(proto_key)).key;
+    }
+    size_t extensions_size = 0;
+    for (const auto &muxer : msg.stream_muxers) {
+      extensions_size += fieldSize(muxer.size());
+    }
+    size_t size = 0;
+    for (auto field_size :
+         {identity_key.size(), msg.identity_sig.size(), msg.data.size()}) {
+      if (field_size != 0) {
+        size += fieldSize(field_size);
+      }
+    }
+    if (not msg.stream_muxers.empty()) {
+      size += fieldSize(extensions_size);
+    }
+
+    Bytes out_msg(size);
+    BytesOut out{out_msg};
+    if (not identity_key.empty()) {
+      writeField(out, kIdentityKey, identity_key);
+    }
+    if (not msg.identity_sig.empty()) {
+      writeField(out, kIdentitySig, msg.identity_sig);
+    }
+    if (not msg.data.empty()) {
+      writeField(out, kData, msg.data);
+    }
+    if (not msg.stream_muxers.empty()) {
+      UVarint length{extensions_size};
+      out[0] = tag(kExtensions);
+      std::ranges::copy(length.toBytes(), out.begin() + 1);
+      out = out.subspan(1 + length.size());
+      for (const auto &muxer : msg.stream_muxers) {
+        writeField(out, kStreamMuxers, bytestr(muxer));
+      }
+    }
+    if (not out.empty()) {
       return Error::MESSAGE_SERIALIZING_ERROR;
     }
     return out_msg;
@@ -70,11 +202,39 @@ namespace libp2p::security::noise {
 
   outcome::result<std::pair<HandshakeMessage, crypto::ProtobufKey>>
   HandshakeMessageMarshallerImpl::unmarshal(BytesIn msg_bytes) const {
-    protobuf::NoiseHandshakePayload proto_msg;
-    if (not proto_msg.ParseFromArray(msg_bytes.data(),
-                                     static_cast<int>(msg_bytes.size()))) {
+    // fields are views into msg_bytes until copied into the message,
+    // the last of repeated singular fields wins, as in protobuf
+    BytesIn identity_key;
+    BytesIn identity_sig;
+    BytesIn data;
+    std::vector<peer::ProtocolName> muxers;
+    outcome::result<void> extensions = outcome::success();
+    OUTCOME_TRY(readFields(msg_bytes, [&](uint64_t field, BytesIn bytes) {
+      if (field == kIdentityKey) {
+        identity_key = bytes;
+      } else if (field == kIdentitySig) {
+        identity_sig = bytes;
+      } else if (field == kData) {
+        data = bytes;
+      } else if (field == kExtensions and extensions) {
+        extensions = readFields(bytes, [&](uint64_t field, BytesIn bytes) {
+          if (field == kStreamMuxers) {
+            muxers.emplace_back(bytes.begin(), bytes.end());
+          }
+        });
+      }
+    }));
+    if (not extensions) {
       return Error::MESSAGE_DESERIALIZING_ERROR;
     }
-    return protoToHandy(proto_msg);
+    crypto::ProtobufKey proto_key{{identity_key.begin(), identity_key.end()}};
+    OUTCOME_TRY(pubkey, marshaller_->unmarshalPublicKey(proto_key));
+    return std::make_pair(
+        HandshakeMessage{
+            .identity_key = std::move(pubkey),
+            .identity_sig = {identity_sig.begin(), identity_sig.end()},
+            .data = {data.begin(), data.end()},
+            .stream_muxers = std::move(muxers)},
+        std::move(proto_key));
   }
 }  // namespace libp2p::security::noise
@@ -6,6 +6,10 @@
 
 #include <arpa/inet.h>
 
+#include <algorithm>
+
+#include <boost/assert.hpp>
+
 #include <libp2p/security/noise/insecure_rw.hpp>
 
 #include <libp2p/basic/write_return_size.hpp>
@@ -28,10 +32,25 @@
   IO_OUTCOME_TRY_NAME(UNIQUE_NAME(name), name, res, cb)
 
 namespace libp2p::security::noise {
+  namespace {
+    /// Frames of length prefixed messages shared by all connections
+    const std::shared_ptr<basic::BufferPool> &outbufPool() {
+      static auto pool =
+          basic::BufferPool::create(kLengthPrefixSize + kMaxMsgLen);
+      return pool;
+    }
+  }  // namespace
+
   InsecureReadWriter::InsecureReadWriter(
       std::shared_ptr<connection::LayerConnection> connection,
-      std::shared_ptr<Bytes> buffer)
-      : connection_{std::move(connection)}, buffer_{std::move(buffer)} {}
+      std::shared_ptr<Bytes> buffer,
+      size_t read_ahead)
+      : connection_{std::move(connection)}, buffer_{std::move(buffer)} {
+    if (read_ahead != 0) {
+      // the largest message fits after a partial one is moved to the front
+      ahead_.resize(std::max(read_ahead, kLengthPrefixSize + kMaxMsgLen));
+    }
+  }
 
   void InsecureReadWriter::read(basic::MessageReadWriter::ReadCallbackFunc cb) {
     buffer_->resize(kMaxMsgLen);  // ensure buffer capacity
@@ -57,23 +76,109 @@ namespace libp2p::security::noise {
     connection_->read(*buffer_, kLengthPrefixSize, std::move(read_cb));
   }
 
+  std::optional<BytesOut> InsecureReadWriter::takeFrame() {
+    auto available = ahead_end_ - ahead_begin_;
+    if (available < kLengthPrefixSize) {
+      return std::nullopt;
+    }
+    auto *prefix = ahead_.data() + ahead_begin_;
+    size_t frame_len = (size_t{prefix[0]} << 8u) | prefix[1];
+    if (available < kLengthPrefixSize + frame_len) {
+      return std::nullopt;
+    }
+    BytesOut frame{prefix + kLengthPrefixSize, frame_len};
+    ahead_begin_ += kLengthPrefixSize + frame_len;
+    if (ahead_begin_ == ahead_end_) {
+      ahead_begin_ = ahead_end_ = 0;
+    }
+    return frame;
+  }
+
+  void InsecureReadWriter::readFrame(ReadFrameCallback cb) {
+    BOOST_ASSERT(not ahead_.empty());
+    if (auto frame = takeFrame()) {
+      return cb(*frame);
+    }
+    if (ahead_begin_ != 0) {
+      std::copy(ahead_.begin() + static_cast<ptrdiff_t>(ahead_begin_),
+                ahead_.begin() + static_cast<ptrdiff_t>(ahead_end_),
+                ahead_.begin());
+      ahead_end_ -= ahead_begin_;
+      ahead_begin_ = 0;
+    }
+    auto out = BytesOut{ahead_}.subspan(ahead_end_);
+    connection_->readSome(
+        out,
+        out.size(),
+        [self{shared_from_this()},
+         cb{std::move(cb)}](outcome::result<size_t> result) mutable {
+          IO_OUTCOME_TRY(read_bytes, result, cb);
+          if (read_bytes == 0) {
+            return cb(std::errc::broken_pipe);
+          }
+          self->ahead_end_ += read_bytes;
+          self->readFrame(std::move(cb));
+        });
+  }
+
+  size_t InsecureReadWriter::readAheadCapacity() const {
+    return ahead_.capacity();
+  }
+
   void InsecureReadWriter::write(BytesIn buffer,
                                  basic::Writer::WriteCallbackFunc cb) {
     if (buffer.size() > static_cast<int64_t>(kMaxMsgLen)) {
       return cb(std::errc::message_size);
     }
-    outbuf_.clear();
-    outbuf_.reserve(kLengthPrefixSize + buffer.size());
-    common::putUint16BE(outbuf_, buffer.size());
-    outbuf_.insert(outbuf_.end(), buffer.begin(), buffer.end());
+    auto frame = allocateFrame(buffer.size());
+    std::copy(buffer.begin(), buffer.end(), frame.begin() + kLengthPrefixSize);
+    writeFrame(std::move(frame), std::move(cb));
+  }
+
+  basic::BufferSlice InsecureReadWriter::allocateFrame(size_t size) {
+    BOOST_ASSERT(size <= kMaxMsgLen);
+    auto frame = outbufPool()->allocate(kLengthPrefixSize + size);
+    auto length = static_cast<uint16_t>(size);
+    frame.data()[0] = static_cast<uint8_t>(length >> 8u);
+    frame.data()[1] = static_cast<uint8_t>(length & 0xffu);
+    return frame;
+  }
+
+  void InsecureReadWriter::writeFrame(basic::BufferSlice frame,
+                                      basic::Writer::WriteCallbackFunc cb) {
+    auto span = frame.span();
+    auto write_cb = [self{shared_from_this()},
+                     frame{std::move(frame)},
+                     cb{std::move(cb)}](outcome::result<size_t> result) {
+      IO_OUTCOME_TRY(written_bytes, result, cb);
+      if (frame.size() != written_bytes) {
+        return cb(std::errc::broken_pipe);
+      }
+      cb(written_bytes - kLengthPrefixSize);
+    };
+    writeReturnSize(connection_, span, std::move(write_cb));
+  }
+
+  void InsecureReadWriter::writeFramed(Bytes frame,
+                                       basic::Writer::WriteCallbackFunc cb) {
+    if (frame.size() < kLengthPrefixSize
+        or frame.size() - kLengthPrefixSize > kMaxMsgLen) {
+      return cb(std::errc::message_size);
+    }
+    auto length = static_cast<uint16_t>(frame.size() - kLengthPrefixSize);
+    frame[0] = static_cast<uint8_t>(length >> 8u);
+    frame[1] = static_cast<uint8_t>(length & 0xffu);
+    // moved vector keeps its storage
+    BytesIn span{frame};
     auto write_cb = [self{shared_from_this()},
+                     frame{std::move(frame)},
                      cb{std::move(cb)}](outcome::result<size_t> result) {
       IO_OUTCOME_TRY(written_bytes, result, cb);
-      if (self->outbuf_.size() != written_bytes) {
+      if (frame.size() != written_bytes) {
         return cb(std::errc::broken_pipe);
       }
       cb(written_bytes - kLengthPrefixSize);
     };
-    writeReturnSize(connection_, outbuf_, std::move(write_cb));
+    writeReturnSize(connection_, span, std::move(write_cb));
   }
 }  // namespace libp2p::security::noise
@@ -4,22 +4,68 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+#include <libp2p/security/noise/crypto/key_pool.hpp>
+#include <libp2p/security/noise/crypto/noise_aesgcm.hpp>
+#include <libp2p/security/noise/crypto/noise_dh.hpp>
 #include <libp2p/security/noise/handshake.hpp>
 #include <libp2p/security/noise/handshake_message_marshaller_impl.hpp>
 #include <libp2p/security/noise/noise.hpp>
 
 namespace libp2p::security {
   peer::ProtocolName Noise::getProtocolId() const {
-    return kProtocolId;
+    return protocol_id_;
   }
 
   Noise::Noise(
       crypto::KeyPair local_key,
       std::shared_ptr<crypto::CryptoProvider> crypto_provider,
-      std::shared_ptr<crypto::marshaller::KeyMarshaller> key_marshaller)
+      std::shared_ptr<crypto::marshaller::KeyMarshaller> key_marshaller,
+      std::shared_ptr<basic::Scheduler> scheduler,
+      NoiseConfig config)
+      : Noise{std::move(local_key),
+              std::move(crypto_provider),
+              std::move(key_marshaller),
+              std::move(scheduler),
+              config,
+              kProtocolId,
+              nullptr} {}
+
+  Noise::Noise(
+      crypto::KeyPair local_key,
+      std::shared_ptr<crypto::CryptoProvider> crypto_provider,
+      std::shared_ptr<crypto::marshaller::KeyMarshaller> key_marshaller,
+      std::shared_ptr<basic::Scheduler> scheduler,
+      NoiseConfig config,
+      peer::ProtocolName protocol_id,
+      std::shared_ptr<noise::NamedAEADCipher> cipher)
       : local_key_{std::move(local_key)},
         crypto_provider_{std::move(crypto_provider)},
-        key_marshaller_{std::move(key_marshaller)} {}
+        key_marshaller_{std::move(key_marshaller)},
+        scheduler_{std::move(scheduler)},
+        config_{config},
+        protocol_id_{std::move(protocol_id)},
+        cipher_{std::move(cipher)} {
+    using LocalKey = noise::HandshakeMessageMarshallerImpl::LocalKey;
+    if (auto proto_key = key_marshaller_->marshal(local_key_.publicKey)) {
+      local_proto_key_ = std::make_shared<const LocalKey>(
+          LocalKey{local_key_.publicKey, std::move(proto_key.value())});
+    }
+    if (auto signing_key =
+            crypto_provider_->prepareSigningKey(local_key_.privateKey)) {
+      signing_key_ = std::move(signing_key.value());
+    }
+    if (config_.key_pool_size != 0) {
+      key_pool_ = std::make_shared<noise::KeyPool>(
+          std::make_shared<noise::NoiseDiffieHellmanImpl>(),
+          config_.key_pool_size,
+          config_.key_pool_thread ? nullptr : scheduler_);
+      key_pool_->start();
+    }
+  }
+
+  void Noise::offerMuxers(std::vector<peer::ProtocolName> muxers) {
+    muxers_ = std::move(muxers);
+  }
 
   void Noise::secureInbound(
       std::shared_ptr<connection::LayerConnection> inbound,
@@ -27,16 +73,22 @@ namespace libp2p::security {
     log_->info("securing inbound connection");
     auto noise_marshaller =
         std::make_unique<noise::HandshakeMessageMarshallerImpl>(
-            key_marshaller_);
+            key_marshaller_, local_proto_key_);
     auto handshake =
         std::make_shared<noise::Handshake>(crypto_provider_,
                                            std::move(noise_marshaller),
                                            local_key_,
+                                           signing_key_,
                                            inbound,
                                            false,
                                            boost::none,
                                            std::move(cb),
-                                           key_marshaller_);
+                                           key_marshaller_,
+                                           scheduler_,
+                                           config_,
+                                           key_pool_,
+                                           muxers_,
+                                           cipher_);
     handshake->connect();
   }
 
@@ -47,16 +99,36 @@ namespace libp2p::security {
     log_->info("securing outbound connection");
     auto noise_marshaller =
         std::make_unique<noise::HandshakeMessageMarshallerImpl>(
-            key_marshaller_);
+            key_marshaller_, local_proto_key_);
     auto handshake =
         std::make_shared<noise::Handshake>(crypto_provider_,
                                            std::move(noise_marshaller),
                                            local_key_,
+                                           signing_key_,
                                            outbound,
                                            true,
                                            p,
                                            std::move(cb),
-                                           key_marshaller_);
+                                           key_marshaller_,
+                                           scheduler_,
+                                           config_,
+                                           key_pool_,
+                                           muxers_,
+                                           cipher_);
     handshake->connect();
   }
+
+  NoiseAesGcm::NoiseAesGcm(
+      crypto::KeyPair local_key,
+      std::shared_ptr<crypto::CryptoProvider> crypto_provider,
+      std::shared_ptr<crypto::marshaller::KeyMarshaller> key_marshaller,
+      std::shared_ptr<basic::Scheduler> scheduler,
+      NoiseConfig config)
+      : Noise{std::move(local_key),
+              std::move(crypto_provider),
+              std::move(key_marshaller),
+              std::move(scheduler),
+              config,
+              kProtocolId,
+              std::make_shared<noise::NamedAESGCMImpl>()} {}
 }  // namespace libp2p::security
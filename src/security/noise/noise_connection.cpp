@@ -8,6 +8,7 @@
 
 #include <libp2p/basic/read_return_size.hpp>
 #include <libp2p/common/ambigous_size.hpp>
+#include <libp2p/common/trace.hpp>
 #include <libp2p/crypto/x25519_provider/x25519_provider_impl.hpp>
 #include <libp2p/security/noise/crypto/interfaces.hpp>
 
@@ -15,11 +16,10 @@
 #define UNIQUE_NAME(base) base##__LINE__
 #endif  // UNIQUE_NAME
 
-#define OUTCOME_CB_I(var, res)                \
-  auto && (var) = (res);                      \
-  if ((var).has_error()) {                    \
-    self->eraseWriteBuffer(ctx.write_buffer); \
-    return cb((var).error());                 \
+#define OUTCOME_CB_I(var, res) \
+  auto && (var) = (res);       \
+  if ((var).has_error()) {     \
+    return cb((var).error());  \
   }
 
 #define OUTCOME_CB_NAME_I(var, val, res) \
@@ -29,36 +29,81 @@
 #define OUTCOME_CB(name, res) OUTCOME_CB_NAME_I(UNIQUE_NAME(name), name, res)
 
 namespace libp2p::connection {
+
+  namespace {
+    const log::Logger &log() {
+      static auto logger = log::createLogger("NoiseConnection");
+      return logger;
+    }
+
+    outcome::result<peer::PeerId> peerIdOf(
+        const crypto::marshaller::KeyMarshaller &key_marshaller,
+        const crypto::PublicKey &key) {
+      OUTCOME_TRY(proto_key, key_marshaller.marshal(key));
+      return peer::PeerId::fromPublicKey(proto_key);
+    }
+  }  // namespace
+
   NoiseConnection::NoiseConnection(
       std::shared_ptr<LayerConnection> original_connection,
       crypto::PublicKey localPubkey,
       crypto::PublicKey remotePubkey,
       std::shared_ptr<crypto::marshaller::KeyMarshaller> key_marshaller,
       std::shared_ptr<security::noise::CipherState> encoder,
-      std::shared_ptr<security::noise::CipherState> decoder)
+      std::shared_ptr<security::noise::CipherState> decoder,
+      std::shared_ptr<basic::Scheduler> scheduler,
+      security::NoiseConfig config,
+      boost::optional<peer::ProtocolName> muxer)
       : connection_{std::move(original_connection)},
         local_{std::move(localPubkey)},
         remote_{std::move(remotePubkey)},
         key_marshaller_{std::move(key_marshaller)},
+        local_peer_{peerIdOf(*key_marshaller_, local_)},
+        remote_peer_{peerIdOf(*key_marshaller_, remote_)},
         encoder_cs_{std::move(encoder)},
         decoder_cs_{std::move(decoder)},
-        frame_buffer_{std::make_shared<Bytes>(security::noise::kMaxMsgLen)},
+        frame_buffer_{std::make_shared<Bytes>(
+            config.read_ahead == 0 ? security::noise::kMaxMsgLen : 0)},
         framer_{std::make_shared<security::noise::InsecureReadWriter>(
-            connection_, frame_buffer_)} {
+            connection_, frame_buffer_, config.read_ahead)},
+        scheduler_{std::move(scheduler)},
+        config_{config},
+        muxer_{std::move(muxer)} {
     BOOST_ASSERT(connection_);
     BOOST_ASSERT(key_marshaller_);
     BOOST_ASSERT(encoder_cs_);
     BOOST_ASSERT(decoder_cs_);
     BOOST_ASSERT(frame_buffer_);
     BOOST_ASSERT(framer_);
+    BOOST_ASSERT(scheduler_ or not coalescing());
     frame_buffer_->resize(0);
   }
 
   bool NoiseConnection::isClosed() const {
-    return connection_->isClosed();
+    return closing_ or connection_->isClosed();
   }
 
   outcome::result<void> NoiseConnection::close() {
+    if (closing_) {
+      return outcome::success();
+    }
+    closing_ = true;
+    flush_handle_.reset();
+    if (not write_error_) {
+      write_error_ = make_error_code(std::errc::not_connected);
+    }
+    if (blocked_write_) {
+      // bytes of blocked write were not copied, so it was not completed yet
+      auto cb = std::move(blocked_write_->second);
+      blocked_write_.reset();
+      deferWriteCallback(write_error_, std::move(cb));
+    }
+    if (flushing_ or not coalesce_buffer_.empty()) {
+      // coalesced writes were completed already, so they are sent before
+      // close, underlying connection is closed by onFlushed()
+      flush();
+      return outcome::success();
+    }
     return connection_->close();
   }
 
@@ -72,12 +117,63 @@ namespace libp2p::connection {
   void NoiseConnection::readSome(BytesOut out,
                                  size_t bytes,
                                  libp2p::basic::Reader::ReadCallbackFunc cb) {
-    OperationContext context{.bytes_served = 0,
-                             .total_bytes = bytes,
-                             .write_buffer = write_buffers_.end()};
+    if (config_.read_ahead != 0) {
+      ambigousSize(out, bytes);
+      return readAhead(out, std::move(cb));
+    }
+    OperationContext context{.bytes_served = 0, .total_bytes = bytes};
     readSome(out, bytes, context, std::move(cb));
   }
 
+  void NoiseConnection::readAhead(BytesOut out, ReadCallbackFunc cb) {
+    auto n = takePlaintext(out);
+    if (n.has_error() or n.value() != 0 or out.empty()) {
+      return cb(n);
+    }
+    framer_->readFrame([self{shared_from_this()}, out, cb{std::move(cb)}](
+                           outcome::result<BytesOut> _frame) mutable {
+      OUTCOME_CB(frame, _frame);
+      auto decrypted = self->decoder_cs_->decryptInto(frame, {}, frame);
+      if (decrypted.has_error()) {
+        self->read_error_ = decrypted.error();
+        return cb(decrypted.error());
+      }
+      self->plaintext_ = frame.first(decrypted.value());
+      self->readAhead(out, std::move(cb));
+    });
+  }
+
+  outcome::result<size_t> NoiseConnection::takePlaintext(BytesOut out) {
+    if (read_error_) {
+      return read_error_;
+    }
+    size_t n = 0;
+    while (true) {
+      auto k = std::min(out.size() - n, plaintext_.size());
+      std::copy_n(
+          plaintext_.begin(), k, out.begin() + static_cast<ptrdiff_t>(n));
+      plaintext_ = plaintext_.subspan(k);
+      n += k;
+      if (n == out.size()) {
+        return n;
+      }
+      auto frame = framer_->takeFrame();
+      if (not frame) {
+        return n;
+      }
+      auto decrypted = decoder_cs_->decryptInto(*frame, {}, *frame);
+      if (decrypted.has_error()) {
+        if (n == 0) {
+          return decrypted.error();
+        }
+        // bytes already copied are returned first
+        read_error_ = decrypted.error();
+        return n;
+      }
+      plaintext_ = frame->first(decrypted.value());
+    }
+  }
+
   void NoiseConnection::readSome(BytesOut out,
                                  size_t bytes,
                                  OperationContext ctx,
@@ -94,8 +190,14 @@ namespace libp2p::connection {
         [self{shared_from_this()}, out, bytes, cb{std::move(cb)}, ctx](
             auto _data) mutable {
           OUTCOME_CB(data, _data);
-          OUTCOME_CB(decrypted, self->decoder_cs_->decrypt({}, *data, {}));
-          self->frame_buffer_->assign(decrypted.begin(), decrypted.end());
+          // framer reads into frame_buffer_, decrypt it in place
+          BOOST_ASSERT(data == self->frame_buffer_);
+          auto decrypted = self->decoder_cs_->decryptInto(*data, {}, *data);
+          if (decrypted.has_error()) {
+            data->clear();
+            return cb(decrypted.error());
+          }
+          data->resize(decrypted.value());
           self->readSome(out, bytes, ctx, std::move(cb));
         });
   }
@@ -104,44 +206,190 @@ namespace libp2p::connection {
                               size_t bytes,
                               NoiseConnection::OperationContext ctx,
                               basic::Writer::WriteCallbackFunc cb) {
-    auto *self{this};  // for OUTCOME_CB
     if (0 == bytes) {
       BOOST_ASSERT(ctx.bytes_served >= ctx.total_bytes);
-      eraseWriteBuffer(ctx.write_buffer);
       return cb(ctx.total_bytes);
     }
     auto n{std::min(bytes, security::noise::kMaxPlainText)};
-    OUTCOME_CB(encrypted, encoder_cs_->encrypt({}, in.subspan(0, n), {}));
-    if (write_buffers_.end() == ctx.write_buffer) {
-      constexpr auto dummy_size = 1;
-      constexpr auto dummy_value = 0x0;
-      ctx.write_buffer =
-          write_buffers_.emplace(write_buffers_.end(), dummy_size, dummy_value);
-    }
-    ctx.write_buffer->swap(encrypted);
-    framer_->write(*ctx.write_buffer,
-                   [self{shared_from_this()},
-                    in{in.subspan(static_cast<int64_t>(n))},
-                    bytes{bytes - n},
-                    cb{std::move(cb)},
-                    ctx](auto _n) mutable {
-                     OUTCOME_CB(n, _n);
-                     ctx.bytes_served += n;
-                     self->write(in, bytes, ctx, std::move(cb));
-                   });
+    // seal directly into the pooled frame after its length prefix
+    auto frame = security::noise::InsecureReadWriter::allocateFrame(
+        n + security::noise::kTagSize);
+    auto ciphertext = frame.span().subspan(security::noise::kLengthPrefixSize);
+    OUTCOME_CB(encrypted,
+               encoder_cs_->encryptInto(in.subspan(0, n), {}, ciphertext));
+    BOOST_ASSERT(encrypted == ciphertext.size());
+    framer_->writeFrame(std::move(frame),
+                        [self{shared_from_this()},
+                         in{in.subspan(static_cast<int64_t>(n))},
+                         bytes{bytes - n},
+                         cb{std::move(cb)},
+                         ctx](auto _n) mutable {
+                          OUTCOME_CB(n, _n);
+                          ctx.bytes_served += n;
+                          self->write(in, bytes, ctx, std::move(cb));
+                        });
   }
 
   void NoiseConnection::writeSome(BytesIn in,
                                   size_t bytes,
                                   libp2p::basic::Writer::WriteCallbackFunc cb) {
-    OperationContext context{
-        .bytes_served = 0,
-        .total_bytes = bytes,
-        .write_buffer = write_buffers_.end(),
-    };
+    if (coalescing()) {
+      BytesIn buffers[]{in.first(bytes)};
+      return writeCoalesced(buffers, std::move(cb));
+    }
+    OperationContext context{.bytes_served = 0, .total_bytes = bytes};
     write(in, bytes, context, std::move(cb));
   }
 
+  void NoiseConnection::writeSomeVectored(
+      std::span<const BytesIn> in,
+      libp2p::basic::Writer::WriteCallbackFunc cb) {
+    if (coalescing()) {
+      return writeCoalesced(in, std::move(cb));
+    }
+    size_t non_empty = 0;
+    BytesIn single;
+    for (const auto &buffer : in) {
+      if (not buffer.empty()) {
+        ++non_empty;
+        single = buffer;
+      }
+    }
+    if (non_empty <= 1) {
+      return writeSome(single, single.size(), std::move(cb));
+    }
+    // plaintext is encrypted synchronously inside write(), so the buffer
+    // may be reused by the next call
+    gather_buffer_.clear();
+    for (const auto &buffer : in) {
+      auto n = std::min<size_t>(
+          buffer.size(), security::noise::kMaxPlainText - gather_buffer_.size());
+      gather_buffer_.insert(
+          gather_buffer_.end(), buffer.begin(), buffer.begin() + n);
+      if (gather_buffer_.size() == security::noise::kMaxPlainText) {
+        break;
+      }
+    }
+    writeSome(gather_buffer_, gather_buffer_.size(), std::move(cb));
+  }
+
+  bool NoiseConnection::coalescing() const {
+    return config_.write_coalescing_delay.count() > 0;
+  }
+
+  void NoiseConnection::writeCoalesced(std::span<const BytesIn> in,
+                                       WriteCallbackFunc cb) {
+    using security::noise::kMaxPlainText;
+    if (write_error_) {
+      return deferWriteCallback(write_error_, std::move(cb));
+    }
+    if (coalesce_buffer_.size() == kMaxPlainText) {
+      // full buffer is flushed at once, so the flush is still in progress
+      BOOST_ASSERT(flushing_);
+      BOOST_ASSERT(not blocked_write_);
+      BytesIn first;
+      for (const auto &buffer : in) {
+        if (not buffer.empty()) {
+          first = buffer;
+          break;
+        }
+      }
+      blocked_write_.emplace(first, std::move(cb));
+      return;
+    }
+    if (coalesce_buffer_.capacity() < kMaxPlainText) {
+      coalesce_buffer_.reserve(kMaxPlainText);
+    }
+    size_t written = 0;
+    for (const auto &buffer : in) {
+      auto n = std::min<size_t>(buffer.size(),
+                                kMaxPlainText - coalesce_buffer_.size());
+      coalesce_buffer_.insert(
+          coalesce_buffer_.end(), buffer.begin(), buffer.begin() + n);
+      written += n;
+      if (coalesce_buffer_.size() == kMaxPlainText) {
+        break;
+      }
+    }
+    if (coalesce_buffer_.size() == kMaxPlainText) {
+      flush();
+    } else {
+      armFlushTimer();
+    }
+    // intentionally used deferReadCallback, since it acquires bytes written
+    deferReadCallback(written, std::move(cb));
+  }
+
+  void NoiseConnection::flush() {
+    flush_handle_.reset();
+    if (flushing_ or coalesce_buffer_.empty()) {
+      return;
+    }
+    auto frame = security::noise::InsecureReadWriter::allocateFrame(
+        coalesce_buffer_.size() + security::noise::kTagSize);
+    auto ciphertext = frame.span().subspan(security::noise::kLengthPrefixSize);
+    auto encrypted =
+        encoder_cs_->encryptInto(coalesce_buffer_, {}, ciphertext);
+    coalesce_buffer_.clear();
+    if (encrypted.has_error()) {
+      return onFlushed(encrypted.error());
+    }
+    flushing_ = true;
+    framer_->writeFrame(
+        std::move(frame),
+        [self{shared_from_this()}](outcome::result<size_t> result) {
+          self->onFlushed(result.has_error() ? result.error()
+                                             : std::error_code{});
+        });
+  }
+
+  void NoiseConnection::onFlushed(std::error_code ec) {
+    flushing_ = false;
+    if (closing_) {
+      if (not ec) {
+        flush();
+      }
+      if (not flushing_) {
+        std::ignore = connection_->close();
+      }
+      return;
+    }
+    if (ec) {
+      SL_DEBUG(log(), "coalesced write failed: {}", ec);
+      write_error_ = ec;
+      coalesce_buffer_.clear();
+      if (blocked_write_) {
+        auto cb = std::move(blocked_write_->second);
+        blocked_write_.reset();
+        cb(ec);
+      }
+      return;
+    }
+    if (coalesce_buffer_.size() == security::noise::kMaxPlainText) {
+      flush();
+    }
+    if (blocked_write_) {
+      auto [in, cb] = std::move(*blocked_write_);
+      blocked_write_.reset();
+      BytesIn buffers[]{in};
+      return writeCoalesced(buffers, std::move(cb));
+    }
+    armFlushTimer();
+  }
+
+  void NoiseConnection::armFlushTimer() {
+    if (flushing_ or flush_handle_ or coalesce_buffer_.empty()) {
+      return;
+    }
+    flush_handle_ = scheduler_->scheduleWithHandle(
+        [weak_self{weak_from_this()}] {
+          if (auto self = weak_self.lock()) {
+            self->flush();
+          }
+        },
+        config_.write_coalescing_delay);
+  }
+
   void NoiseConnection::deferReadCallback(outcome::result<size_t> res,
                                           ReadCallbackFunc cb) {
     connection_->deferReadCallback(res, std::move(cb));
@@ -167,13 +415,11 @@ namespace libp2p::connection {
   }
 
   outcome::result<libp2p::peer::PeerId> NoiseConnection::localPeer() const {
-    OUTCOME_TRY(proto_local_key, key_marshaller_->marshal(local_));
-    return peer::PeerId::fromPublicKey(proto_local_key);
+    return local_peer_;
   }
 
   outcome::result<libp2p::peer::PeerId> NoiseConnection::remotePeer() const {
-    OUTCOME_TRY(proto_remote_key, key_marshaller_->marshal(remote_));
-    return peer::PeerId::fromPublicKey(proto_remote_key);
+    return remote_peer_;
   }
 
   outcome::result<libp2p::crypto::PublicKey> NoiseConnection::remotePublicKey()
@@ -181,11 +427,29 @@ namespace libp2p::connection {
     return remote_;
   }
 
-  void NoiseConnection::eraseWriteBuffer(BufferList::iterator &iterator) {
-    if (write_buffers_.end() == iterator) {
-      return;
+  boost::optional<peer::ProtocolName> NoiseConnection::negotiatedMuxer()
+      const {
+    return muxer_;
+  }
+
+  metrics::MemoryUsage NoiseConnection::memoryUsage() const {
+    metrics::MemoryUsage usage{
+        .read_buffer =
+            frame_buffer_->capacity() + framer_->readAheadCapacity(),
+        .write_queue = gather_buffer_.capacity() + coalesce_buffer_.capacity(),
+    };
+    if (blocked_write_) {
+      usage.write_queue += blocked_write_->first.size();
+      ++usage.pending_callbacks;
+    }
+    return usage;
+  }
+
+  metrics::TrafficKey NoiseConnection::memoryKey() const {
+    metrics::TrafficKey key{.layer = metrics::TrafficLayer::SECURE};
+    if (auto peer = remotePeer()) {
+      key.peer = std::move(peer.value());
     }
-    write_buffers_.erase(iterator);
-    iterator = write_buffers_.end();
+    return key;
   }
 }  // namespace libp2p::connection
@@ -75,6 +75,11 @@ namespace libp2p::connection {
     return original_connection_->writeSome(in, bytes, std::move(f));
   }
 
+  void PlaintextConnection::writeSomeVectored(std::span<const BytesIn> in,
+                                              Writer::WriteCallbackFunc f) {
+    return original_connection_->writeSomeVectored(in, std::move(f));
+  }
+
   void PlaintextConnection::deferReadCallback(outcome::result<size_t> res,
                                               ReadCallbackFunc cb) {
     original_connection_->deferReadCallback(res, std::move(cb));
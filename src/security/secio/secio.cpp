@@ -169,7 +169,7 @@ namespace libp2p::security {
         cb)
     SECIO_OUTCOME_TRY(
         local_corpus_signature,
-        crypto_provider_->sign(local_corpus, idmgr_->getKeyPair().privateKey),
+        crypto_provider_->sign(local_corpus, idmgr_->getSigningKey()),
         conn,
         cb)
     secio::ExchangeMessage local_exchange{
@@ -16,6 +16,7 @@
 #include <libp2p/crypto/aes_ctr/aes_ctr_impl.hpp>
 #include <libp2p/crypto/error.hpp>
 #include <libp2p/crypto/hmac_provider.hpp>
+#include <libp2p/crypto/hmac_provider/hmac_provider_ctr_impl.hpp>
 
 OUTCOME_CPP_DEFINE_CATEGORY(libp2p::connection, SecioConnection::Error, e) {
   using E = libp2p::connection::SecioConnection::Error;
@@ -142,6 +143,12 @@ namespace libp2p::connection {
       return Error::UNSUPPORTED_CIPHER;
     }
 
+    OUTCOME_TRY(macSize());
+    local_mac_ = std::make_unique<crypto::hmac::HmacProviderCtrImpl>(
+        hash_type_, local_stretched_key_.mac_key);
+    remote_mac_ = std::make_unique<crypto::hmac::HmacProviderCtrImpl>(
+        hash_type_, remote_stretched_key_.mac_key);
+
     read_buffer_ = std::make_shared<Bytes>(kMaxFrameSize);
 
     return outcome::success();
@@ -188,12 +195,8 @@ namespace libp2p::connection {
   }
 
   inline void SecioConnection::popUserData(BytesOut out, size_t bytes) {
-    auto to{out.begin()};
-    for (size_t read = 0; read < bytes; ++read) {
-      *to = user_data_buffer_.front();
-      user_data_buffer_.pop();
-      ++to;
-    }
+    std::copy_n(user_data_.begin(), bytes, out.begin());
+    user_data_ = user_data_.subspan(bytes);
   }
 
   void SecioConnection::read(BytesOut out,
@@ -217,8 +220,8 @@ namespace libp2p::connection {
     size_t out_size{out.empty() ? 0 : static_cast<size_t>(out.size())};
     size_t read_limit{out_size < bytes ? out_size : bytes};
 
-    if (not user_data_buffer_.empty()) {
-      auto bytes_available{user_data_buffer_.size()};
+    if (not user_data_.empty()) {
+      auto bytes_available{user_data_.size()};
       size_t to_read{bytes_available < read_limit ? bytes_available
                                                   : read_limit};
       popUserData(out, to_read);
@@ -286,20 +289,29 @@ namespace libp2p::connection {
                 const auto data_size{frame_len - mac_size};
                 auto data_span{std::span(buffer->data(), data_size)};
                 auto mac_span{std::span(*buffer).subspan(data_size, mac_size)};
-                IO_OUTCOME_TRY(remote_mac, self->macRemote(data_span), cb);
-                if (BytesIn(remote_mac) != BytesIn(mac_span)) {
+                std::array<uint8_t, kMaxMacSize> remote_mac{};
+                auto remote_mac_span = std::span(remote_mac).first(mac_size);
+                auto mac_res =
+                    mac(*self->remote_mac_, data_span, remote_mac_span);
+                if (mac_res.has_error()) {
+                  cb(mac_res.error());
+                  return;
+                }
+                if (BytesIn(remote_mac_span) != BytesIn(mac_span)) {
                   self->log_->error(
                       "Signature does not validate for the received frame");
                   cb(Error::INVALID_MAC);
                   return;
                 }
-                IO_OUTCOME_TRY(decrypted_bytes,
-                               (*self->remote_decryptor_)->crypt(data_span),
-                               cb);
-                size_t decrypted_bytes_len{decrypted_bytes.size()};
-                for (auto &&e : decrypted_bytes) {
-                  self->user_data_buffer_.emplace(std::forward<decltype(e)>(e));
+                auto decrypt_res =
+                    (*self->remote_decryptor_)->cryptInPlace(data_span);
+                if (decrypt_res.has_error()) {
+                  cb(decrypt_res.error());
+                  return;
                 }
+                // user data is read from the buffer before the next frame
+                self->user_data_ = data_span;
+                size_t decrypted_bytes_len{data_size};
                 SL_TRACE(self->log_,
                          "Frame decrypted successfully {} -> {}",
                          frame_len,
@@ -316,25 +328,32 @@ namespace libp2p::connection {
 
     if (!isInitialized()) {
       cb(Error::CONN_NOT_INITIALIZED);
+      return;
     }
+    ambigousSize(in, bytes);
     IO_OUTCOME_TRY(mac_size, macSize(), cb);
     size_t frame_len{bytes + mac_size};
-    Bytes frame_buffer;
-    constexpr size_t len_field_size{kLenMarkerSize};
-    frame_buffer.reserve(len_field_size + frame_len);
-
+    if (not write_buffer_ or write_buffer_.use_count() != 1) {
+      write_buffer_ = std::make_shared<Bytes>();
+    }
+    auto &frame_buffer = *write_buffer_;
+    frame_buffer.clear();
     common::putUint32BE(frame_buffer, frame_len);
-    IO_OUTCOME_TRY(encrypted_data, (*local_encryptor_)->crypt(in), cb);
-    IO_OUTCOME_TRY(mac_data, macLocal(encrypted_data), cb);
-    frame_buffer.insert(frame_buffer.end(),
-                        std::make_move_iterator(encrypted_data.begin()),
-                        std::make_move_iterator(encrypted_data.end()));
-    frame_buffer.insert(frame_buffer.end(),
-                        std::make_move_iterator(mac_data.begin()),
-                        std::make_move_iterator(mac_data.end()));
+    frame_buffer.insert(frame_buffer.end(), in.begin(), in.end());
+    frame_buffer.resize(kLenMarkerSize + frame_len);
+    auto data_span = std::span(frame_buffer).subspan(kLenMarkerSize, bytes);
+    auto mac_span = std::span(frame_buffer).subspan(kLenMarkerSize + bytes);
+    if (auto r = (*local_encryptor_)->cryptInPlace(data_span); r.has_error()) {
+      return cb(r.error());
+    }
+    if (auto r = mac(*local_mac_, data_span, mac_span); r.has_error()) {
+      return cb(r.error());
+    }
     basic::Writer::WriteCallbackFunc cb_wrapper =
-        [user_cb{std::move(cb)}, bytes, raw_bytes{frame_buffer.size()}](
-            auto &&res) {
+        [user_cb{std::move(cb)},
+         bytes,
+         raw_bytes{frame_buffer.size()},
+         buffer{write_buffer_}](auto &&res) {
           if (not res) {
             return user_cb(res);  // pulling out the error occurred
           }
@@ -366,14 +385,11 @@ namespace libp2p::connection {
     }
   }
 
-  outcome::result<Bytes> SecioConnection::macLocal(BytesIn message) const {
-    return hmac_provider_->calculateDigest(
-        hash_type_, local_stretched_key_.mac_key, message);
-  }
-
-  outcome::result<Bytes> SecioConnection::macRemote(BytesIn message) const {
-    return hmac_provider_->calculateDigest(
-        hash_type_, remote_stretched_key_.mac_key, message);
+  outcome::result<void> SecioConnection::mac(
+      crypto::hmac::HmacProviderCtrImpl &hmac, BytesIn message, BytesOut out) {
+    OUTCOME_TRY(hmac.write(message));
+    OUTCOME_TRY(hmac.digestOut(out));
+    return hmac.reset();
   }
 
 }  // namespace libp2p::connection
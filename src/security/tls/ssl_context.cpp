@@ -4,13 +4,21 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+#include <mutex>
+
 #include <boost/asio/ssl/context.hpp>
 #include <libp2p/common/asio_buffer.hpp>
+#include <libp2p/common/metrics/startup.hpp>
+#include <libp2p/common/types.hpp>
 #include <libp2p/peer/identity_manager.hpp>
 #include <libp2p/security/tls/ssl_context.hpp>
 #include <libp2p/security/tls/tls_details.hpp>
 #include <qtils/bytes.hpp>
 
+#include "tls_connection.hpp"
+#include "tls_kernel.hpp"
+#include "tls_sessions.hpp"
+
 namespace libp2p::security {
   constexpr qtils::BytesN<1 + 6> kAlpn{6, 'l', 'i', 'b', 'p', '2', 'p'};
 
@@ -28,12 +36,88 @@ namespace libp2p::security {
                                        : SSL_TLSEXT_ERR_ALERT_FATAL;
   }
 
+  int alpnMuxersIndex() {
+    static const int index =
+        SSL_get_ex_new_index(0, nullptr, nullptr, nullptr, nullptr);
+    return index;
+  }
+
+  /// Selects muxer offered by client, or doesn't acknowledge ALPN so that
+  /// muxer is negotiated with multiselect. List of server ends with "libp2p"
+  static int alpnSelectMuxer(SSL *ssl,
+                             const unsigned char **out,
+                             unsigned char *outlen,
+                             const unsigned char *in,
+                             unsigned int inlen,
+                             void *) {
+    const auto *muxers =
+        static_cast<const Bytes *>(SSL_get_ex_data(ssl, alpnMuxersIndex()));
+    if (muxers == nullptr or muxers->empty()) {
+      return SSL_TLSEXT_ERR_NOACK;
+    }
+    uint8_t *out2 = nullptr;
+    int r = SSL_select_next_proto(
+        &out2, outlen, muxers->data(), muxers->size(), in, inlen);
+    *out = out2;
+    return r == OPENSSL_NPN_NEGOTIATED ? SSL_TLSEXT_ERR_OK
+                                       : SSL_TLSEXT_ERR_NOACK;
+  }
+
+  struct SslContext::Contexts {
+    std::shared_ptr<peer::IdentityManager> idmgr;
+    std::shared_ptr<crypto::marshaller::KeyMarshaller> key_marshaller;
+    TlsConfig config;
+
+    std::once_flag built;
+    std::shared_ptr<boost::asio::ssl::context> tls;
+    std::shared_ptr<boost::asio::ssl::context> quic;
+    std::shared_ptr<TlsSessions> tls_sessions;
+
+    void build();
+  };
+
   SslContext::SslContext(
-      const peer::IdentityManager &idmgr,
-      const crypto::marshaller::KeyMarshaller &key_marshaller) {
+      std::shared_ptr<peer::IdentityManager> idmgr,
+      std::shared_ptr<crypto::marshaller::KeyMarshaller> key_marshaller)
+      : SslContext{std::move(idmgr), std::move(key_marshaller), TlsConfig{}} {}
+
+  SslContext::SslContext(
+      std::shared_ptr<peer::IdentityManager> idmgr,
+      std::shared_ptr<crypto::marshaller::KeyMarshaller> key_marshaller,
+      const TlsConfig &config)
+      : contexts_{std::make_shared<Contexts>()} {
+    contexts_->idmgr = std::move(idmgr);
+    contexts_->key_marshaller = std::move(key_marshaller);
+    contexts_->config = config;
+  }
+
+  std::shared_ptr<boost::asio::ssl::context> SslContext::tls() const {
+    return contexts().tls;
+  }
+
+  std::shared_ptr<boost::asio::ssl::context> SslContext::quic() const {
+    return contexts().quic;
+  }
+
+  std::shared_ptr<TlsSessions> SslContext::tlsSessions() const {
+    return contexts().tls_sessions;
+  }
+
+  const TlsConfig &SslContext::config() const {
+    return contexts_->config;
+  }
+
+  const SslContext::Contexts &SslContext::contexts() const {
+    std::call_once(contexts_->built, [&] { contexts_->build(); });
+    return *contexts_;
+  }
+
+  void SslContext::Contexts::build() {
+    metrics::StartupPhase phase{"ssl_context"};
     using boost::asio::ssl::context;
-    auto r = tls_details::makeCertificate(idmgr.getKeyPair(), key_marshaller);
-    auto make = [&] {
+    auto r =
+        tls_details::sharedCertificate(idmgr->getKeyPair(), *key_marshaller);
+    auto make = [&](bool kernel_tls) {
       auto ctx = std::make_shared<context>(context::tlsv13);
       ctx->set_options(context::no_compression | context::no_sslv2
                        | context::no_sslv3 | context::no_tlsv1_1
@@ -42,8 +126,8 @@ namespace libp2p::security {
                            | boost::asio::ssl::verify_fail_if_no_peer_cert
                            | boost::asio::ssl::verify_client_once);
       ctx->set_verify_callback(&tls_details::verifyCallback);
-      ctx->use_certificate(asioBuffer(r.certificate), context::asn1);
-      ctx->use_private_key(asioBuffer(r.private_key), context::asn1);
+      ctx->use_certificate(asioBuffer(r->certificate), context::asn1);
+      ctx->use_private_key(asioBuffer(r->private_key), context::asn1);
       // NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
       static FILE *keylog = [] {
         FILE *f = nullptr;
@@ -54,18 +138,41 @@ namespace libp2p::security {
         }
         return f;
       }();
-      if (keylog) {
+      if (keylog or kernel_tls) {
         SSL_CTX_set_keylog_callback(
-            ctx->native_handle(), +[](const SSL *, const char *line) {
-              fputs(line, keylog);
-              fputc('\n', keylog);
+            ctx->native_handle(), +[](const SSL *ssl, const char *line) {
+              if (keylog) {
+                fputs(line, keylog);
+                fputc('\n', keylog);
+              }
+              tls_kernel::onKeylog(ssl, line);
             });
       }
       return ctx;
     };
-    tls = make();
-    quic = make();
+    tls = make(config.kernel_tls);
+    SSL_CTX_set_alpn_select_cb(tls->native_handle(), alpnSelectMuxer, nullptr);
+    if (config.session_resumption) {
+      auto *ctx = tls->native_handle();
+      // required by server to resume sessions with verified client certificate
+      SSL_CTX_set_session_id_context(ctx, kAlpn.data() + 1, kAlpn.size() - 1);
+      SSL_CTX_set_timeout(ctx, config.session_lifetime.count());
+      TicketKeys::install(ctx, config.ticket_key_rotation);
+      // client sessions are kept per peer by `TlsSessions`
+      SSL_CTX_set_session_cache_mode(
+          ctx, SSL_SESS_CACHE_CLIENT | SSL_SESS_CACHE_NO_INTERNAL);
+      SSL_CTX_sess_set_new_cb(ctx, &connection::TlsConnection::onNewSession);
+      tls_sessions = std::make_shared<TlsSessions>(config.max_sessions);
+    } else {
+      tls->set_options(SSL_OP_NO_TICKET);
+      SSL_CTX_set_session_cache_mode(tls->native_handle(), SSL_SESS_CACHE_OFF);
+    }
+    quic = make(false);
     SSL_CTX_set_alpn_protos(quic->native_handle(), kAlpn.data(), kAlpn.size());
     SSL_CTX_set_alpn_select_cb(quic->native_handle(), alpnSelect, nullptr);
+    // tickets let reconnects resume the session, 0-RTT data is enabled by
+    // `QuicConfig::early_data`
+    SSL_CTX_set_session_cache_mode(quic->native_handle(),
+                                   SSL_SESS_CACHE_CLIENT);
   }
 }  // namespace libp2p::security
@@ -10,8 +10,10 @@
 #include <libp2p/security/tls/ssl_context.hpp>
 #include <libp2p/security/tls/tls_details.hpp>
 #include <libp2p/security/tls/tls_errors.hpp>
+#include <libp2p/transport/tcp/tcp_connection.hpp>
 
 #include "tls_connection.hpp"
+#include "tls_sessions.hpp"
 
 namespace libp2p::security {
 
@@ -26,7 +28,7 @@ namespace libp2p::security {
       : idmgr_(std::move(idmgr)),
         io_context_(std::move(io_context)),
         key_marshaller_{std::move(key_marshaller)},
-        ssl_context_{ssl_context.tls} {
+        ssl_context_{ssl_context} {
     assert(idmgr_);
     assert(io_context_);
     assert(key_marshaller_);
@@ -49,6 +51,26 @@ namespace libp2p::security {
     asyncHandshake(std::move(outbound), p, std::move(cb));
   }
 
+  void TlsAdaptor::offerMuxers(std::vector<peer::ProtocolName> muxers) {
+    Bytes alpn;
+    auto append = [&](std::string_view protocol) {
+      if (protocol.empty() or protocol.size() > 0xFF) {
+        return;
+      }
+      alpn.push_back(static_cast<uint8_t>(protocol.size()));
+      alpn.insert(alpn.end(), protocol.begin(), protocol.end());
+    };
+    for (const auto &muxer : muxers) {
+      append(muxer);
+    }
+    if (alpn.empty()) {
+      alpn_.reset();
+      return;
+    }
+    append(tls_details::kAlpnLibp2p);
+    alpn_ = std::make_shared<const Bytes>(std::move(alpn));
+  }
+
   void TlsAdaptor::asyncHandshake(
       std::shared_ptr<connection::LayerConnection> conn,
       boost::optional<peer::PeerId> remote_peer,
@@ -62,11 +84,25 @@ namespace libp2p::security {
       SL_DEBUG(log(), "securing inbound connection");
     }
 
+    // kernel encrypts records written to socket, so only plain TCP connection
+    // can be offloaded, not one wrapped by other layer
+    int kernel_fd = -1;
+    if (ssl_context_.config().kernel_tls) {
+      if (auto *tcp = dynamic_cast<transport::TcpConnection *>(conn.get())) {
+        kernel_fd = tcp->socket_.native_handle();
+        // kernel TLS rejects MSG_ZEROCOPY sends
+        tcp->zero_copy_threshold_ = 0;
+      }
+    }
+
     auto tls_conn = std::make_shared<TlsConnection>(std::move(conn),
-                                                    ssl_context_,
+                                                    ssl_context_.tls(),
                                                     *idmgr_,
                                                     io_context_,
-                                                    std::move(remote_peer));
+                                                    std::move(remote_peer),
+                                                    alpn_,
+                                                    ssl_context_.tlsSessions(),
+                                                    kernel_fd);
     tls_conn->asyncHandshake(std::move(cb), key_marshaller_);
   }
 
@@ -9,25 +9,75 @@
 #include <libp2p/basic/read_return_size.hpp>
 #include <libp2p/common/ambigous_size.hpp>
 #include <libp2p/common/asio_buffer.hpp>
+#include <libp2p/common/metrics/registry.hpp>
+#include <libp2p/security/tls/ssl_context.hpp>
 #include <libp2p/security/tls/tls_details.hpp>
+#include <openssl/mem.h>
+
+#include "tls_kernel.hpp"
+#include "tls_sessions.hpp"
 
 namespace libp2p::connection {
 
   using TlsError = security::TlsError;
   using security::tls_details::log;
 
+  namespace {
+    void observeSslHandshake(std::chrono::steady_clock::time_point started) {
+      static auto &histogram = metrics::Registry::instance().histogram(
+          "libp2p_tls_handshake_ssl_seconds",
+          "Time of TLS handshakes inside SSL, key exchange and I/O included");
+      histogram.observe(std::chrono::steady_clock::now() - started);
+    }
+  }  // namespace
+
+  /// Index of SSL ex data with connection, which receives session tickets
+  static int connectionIndex() {
+    static const int index =
+        SSL_get_ex_new_index(0, nullptr, nullptr, nullptr, nullptr);
+    return index;
+  }
+
   TlsConnection::TlsConnection(
       std::shared_ptr<LayerConnection> original_connection,
       std::shared_ptr<boost::asio::ssl::context> ssl_context,
       const peer::IdentityManager &idmgr,
       std::shared_ptr<boost::asio::io_context> io_context,
-      boost::optional<peer::PeerId> remote_peer)
+      boost::optional<peer::PeerId> remote_peer,
+      std::shared_ptr<const Bytes> alpn,
+      std::shared_ptr<security::TlsSessions> sessions,
+      int kernel_fd)
       : local_peer_(idmgr.getId()),
         original_connection_(std::move(original_connection)),
         ssl_context_(std::move(ssl_context)),
         socket_{AsAsioReadWrite{std::move(io_context), original_connection_},
                 *ssl_context_},
-        remote_peer_(std::move(remote_peer)) {}
+        remote_peer_(std::move(remote_peer)),
+        alpn_(std::move(alpn)),
+        sessions_(std::move(sessions)),
+        kernel_fd_{kernel_fd} {
+    auto *ssl = socket_.native_handle();
+    if (kernel_fd_ >= 0) {
+      SSL_set_ex_data(ssl, security::tls_kernel::secretIndex(), &write_secret_);
+    }
+    if (sessions_ != nullptr and original_connection_->isInitiator()
+        and remote_peer_.has_value()) {
+      SSL_set_ex_data(ssl, connectionIndex(), this);
+      if (auto resumed = sessions_->take(*remote_peer_)) {
+        SSL_set_session(ssl, resumed->session.get());
+        resumed_pubkey_ = std::move(resumed->key);
+      }
+    }
+    if (alpn_ == nullptr) {
+      return;
+    }
+    if (original_connection_->isInitiator()) {
+      SSL_set_alpn_protos(ssl, alpn_->data(), alpn_->size());
+    } else {
+      SSL_set_ex_data(
+          ssl, security::alpnMuxersIndex(), const_cast<Bytes *>(alpn_.get()));
+    }
+  }
 
   void TlsConnection::asyncHandshake(
       HandshakeCallback cb,
@@ -38,8 +88,10 @@ namespace libp2p::connection {
                                       : boost::asio::ssl::stream_base::server,
                             [self = shared_from_this(),
                              cb = std::move(cb),
-                             key_marshaller = std::move(key_marshaller)](
+                             key_marshaller = std::move(key_marshaller),
+                             started = std::chrono::steady_clock::now()](
                                 const boost::system::error_code &error) {
+                              observeSslHandshake(started);
                               self->onHandshakeResult(
                                   error, cb, *key_marshaller);
                             });
@@ -54,31 +106,48 @@ namespace libp2p::connection {
       ec = error;
     }
     while (!ec) {
-      X509 *cert = SSL_get_peer_certificate(socket_.native_handle());
-      if (cert == nullptr) {
-        ec = TlsError::TLS_NO_CERTIFICATE;
-        break;
-      }
-      auto id_res = security::tls_details::verifyPeerAndExtractIdentity(
-          cert, key_marshaller);
-      if (!id_res) {
-        ec = id_res.error();
-        break;
-      }
-      auto &id = id_res.value();
-      if (remote_peer_.has_value()) {
-        if (remote_peer_.value() != id.peer_id) {
-          SL_DEBUG(log(),
-                   "peer ids mismatch: expected={}, got={}",
-                   remote_peer_.value().toBase58(),
-                   id.peer_id.toBase58());
-          ec = TlsError::TLS_UNEXPECTED_PEER_ID;
+      if (resumed_pubkey_ and SSL_session_reused(socket_.native_handle())) {
+        // libp2p extension was verified by handshake which issued ticket
+        remote_pubkey_ = std::move(resumed_pubkey_);
+      } else {
+        X509 *cert = SSL_get_peer_certificate(socket_.native_handle());
+        if (cert == nullptr) {
+          ec = TlsError::TLS_NO_CERTIFICATE;
           break;
         }
-      } else {
-        remote_peer_ = std::move(id.peer_id);
+        auto id_res = security::tls_details::verifyPeerAndExtractIdentity(
+            cert, key_marshaller);
+        if (!id_res) {
+          ec = id_res.error();
+          break;
+        }
+        auto &id = id_res.value();
+        if (remote_peer_.has_value()) {
+          if (remote_peer_.value() != id.peer_id) {
+            SL_DEBUG(log(),
+                     "peer ids mismatch: expected={}, got={}",
+                     remote_peer_.value().toBase58(),
+                     id.peer_id.toBase58());
+            ec = TlsError::TLS_UNEXPECTED_PEER_ID;
+            break;
+          }
+        } else {
+          remote_peer_ = std::move(id.peer_id);
+        }
+        remote_pubkey_ = std::move(id.public_key);
+      }
+
+      const unsigned char *alpn = nullptr;
+      unsigned int alpn_size = 0;
+      SSL_get0_alpn_selected(socket_.native_handle(), &alpn, &alpn_size);
+      std::string_view selected{reinterpret_cast<const char *>(alpn),
+                                alpn_size};
+      if (not selected.empty()
+          and selected != security::tls_details::kAlpnLibp2p) {
+        muxer_ = std::string{selected};
       }
-      remote_pubkey_ = std::move(id.public_key);
+
+      offloadToKernel();
 
       SL_DEBUG(log(),
                "handshake success for {}bound connection to {}",
@@ -96,6 +165,31 @@ namespace libp2p::connection {
     return cb(*ec);
   }
 
+  void TlsConnection::offloadToKernel() {
+    if (kernel_fd_ < 0) {
+      return;
+    }
+    auto *ssl = socket_.native_handle();
+    SSL_set_ex_data(ssl, security::tls_kernel::secretIndex(), nullptr);
+    kernel_tx_ = security::tls_kernel::enableTx(ssl, kernel_fd_, write_secret_);
+    write_sequence_ = SSL_get_write_sequence(ssl);
+    OPENSSL_cleanse(write_secret_.data(), write_secret_.size());
+    write_secret_.clear();
+    SL_DEBUG(log(), "kernel tls tx {}", kernel_tx_ ? "enabled" : "unavailable");
+  }
+
+  int TlsConnection::onNewSession(SSL *ssl, SSL_SESSION *session) {
+    auto *self =
+        static_cast<TlsConnection *>(SSL_get_ex_data(ssl, connectionIndex()));
+    if (self == nullptr or not self->remote_peer_
+        or not self->remote_pubkey_) {
+      return 0;
+    }
+    self->sessions_->put(*self->remote_peer_, session, *self->remote_pubkey_);
+    // sessions took ownership
+    return 1;
+  }
+
   outcome::result<peer::PeerId> TlsConnection::localPeer() const {
     return local_peer_;
   }
@@ -114,6 +208,10 @@ namespace libp2p::connection {
     return remote_pubkey_.value();
   }
 
+  boost::optional<peer::ProtocolName> TlsConnection::negotiatedMuxer() const {
+    return muxer_;
+  }
+
   bool TlsConnection::isInitiator() const {
     return original_connection_->isInitiator();
   }
@@ -153,6 +251,18 @@ namespace libp2p::connection {
                                Reader::ReadCallbackFunc cb) {
     ambigousSize(out, bytes);
     SL_TRACE(log(), "reading some up to {} bytes", bytes);
+    if (kernel_tx_) {
+      // SSL writes key update response with key unknown to kernel
+      cb = [cb{std::move(cb)}, self{shared_from_this()}](
+               outcome::result<size_t> r) {
+        if (r and SSL_get_write_sequence(self->socket_.native_handle())
+                      != self->write_sequence_) {
+          std::ignore = self->close();
+          return cb(TlsError::TLS_KERNEL_KEY_UPDATE);
+        }
+        cb(r);
+      };
+    }
     socket_.async_read_some(asioBuffer(out),
                             closeOnError(*this, std::move(cb)));
   }
@@ -167,6 +277,10 @@ namespace libp2p::connection {
                                 Writer::WriteCallbackFunc cb) {
     ambigousSize(in, bytes);
     SL_TRACE(log(), "writing some up to {} bytes", bytes);
+    if (kernel_tx_) {
+      // kernel encrypts plaintext written to socket
+      return original_connection_->writeSome(in, bytes, std::move(cb));
+    }
     socket_.async_write_some(asioBuffer(in),
                              closeOnError(*this, std::move(cb)));
   }
@@ -19,12 +19,17 @@
 #include <libp2p/peer/identity_manager.hpp>
 #include <libp2p/security/tls/tls_errors.hpp>
 
+namespace libp2p::security {
+  class TlsSessions;
+}  // namespace libp2p::security
+
 namespace libp2p::connection {
 
   /// Secure connection of TLS 1.3 protocol
-  class TlsConnection : public SecureConnection,
-                        public std::enable_shared_from_this<TlsConnection>,
-                        private boost::noncopyable {
+  class TlsConnection final
+      : public SecureConnection,
+        public std::enable_shared_from_this<TlsConnection>,
+        private boost::noncopyable {
    public:
     using ssl_socket_t = boost::asio::ssl::stream<AsAsioReadWrite>;
 
@@ -39,11 +44,18 @@ namespace libp2p::connection {
     /// \param io_context Asio io context
     /// \param remote_peer Expected peer id of remote peer, has value for
     /// outbound connections
+    /// \param alpn Muxers offered via ALPN in wire format, may be null
+    /// \param sessions Sessions of dialed peers, null if resumption is off
+    /// \param kernel_fd TCP socket of original connection, if record
+    /// encryption should move to kernel after handshake, or -1
     TlsConnection(std::shared_ptr<LayerConnection> original_connection,
                   std::shared_ptr<boost::asio::ssl::context> ssl_context,
                   const peer::IdentityManager &idmgr,
                   std::shared_ptr<boost::asio::io_context> io_context,
-                  boost::optional<peer::PeerId> remote_peer);
+                  boost::optional<peer::PeerId> remote_peer,
+                  std::shared_ptr<const Bytes> alpn,
+                  std::shared_ptr<security::TlsSessions> sessions,
+                  int kernel_fd = -1);
 
     /// Performs async handshake and passes its result into callback. This fn is
     /// distinct from the ctor because it uses shared_from_this()
@@ -67,6 +79,9 @@ namespace libp2p::connection {
     /// Returns remote public key, must exist after successful handshake
     outcome::result<crypto::PublicKey> remotePublicKey() const override;
 
+    /// Returns muxer selected via ALPN
+    boost::optional<peer::ProtocolName> negotiatedMuxer() const override;
+
     /// Returns true if connection is outbound
     bool isInitiator() const override;
 
@@ -98,6 +113,9 @@ namespace libp2p::connection {
     /// Closes the socket
     outcome::result<void> close() override;
 
+    /// Callback of `SSL_CTX_sess_set_new_cb`, keeps session of dialed peer
+    static int onNewSession(SSL *ssl, SSL_SESSION *session);
+
    private:
     /// Async handshake callback. Performs libp2p-specific verification and
     /// extraction of remote peer's identity fields
@@ -106,6 +124,9 @@ namespace libp2p::connection {
         const HandshakeCallback &cb,
         const crypto::marshaller::KeyMarshaller &key_marshaller);
 
+    /// Moves record encryption to kernel if it was asked and is supported
+    void offloadToKernel();
+
     /// Local peer id
     const peer::PeerId local_peer_;
 
@@ -124,6 +145,30 @@ namespace libp2p::connection {
     /// Remote public key, extracted from peer certificate during handshake
     boost::optional<crypto::PublicKey> remote_pubkey_;
 
+    /// Offered muxers, referenced by SSL while handshaking
+    std::shared_ptr<const Bytes> alpn_;
+
+    /// Muxer selected via ALPN
+    boost::optional<peer::ProtocolName> muxer_;
+
+    /// Sessions of dialed peers
+    std::shared_ptr<security::TlsSessions> sessions_;
+
+    /// Key of peer from resumed session, verified by previous handshake
+    boost::optional<crypto::PublicKey> resumed_pubkey_;
+
+    /// Socket to offload record encryption to, -1 if not asked
+    int kernel_fd_;
+
+    /// Write traffic secret, received from keylog for kernel offload
+    Bytes write_secret_;
+
+    /// Records are encrypted by kernel, writes bypass SSL
+    bool kernel_tx_ = false;
+
+    /// Write sequence of SSL at offload, SSL must not write after it
+    uint64_t write_sequence_ = 0;
+
    public:
     LIBP2P_METRICS_INSTANCE_COUNT_IF_ENABLED(libp2p::connection::TlsConnection);
   };
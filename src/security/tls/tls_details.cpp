@@ -8,7 +8,11 @@
 #include <openssl/x509_vfy.h>
 #include <boost/asio/ssl/verify_context.hpp>
 #include <boost/optional.hpp>
+#include <chrono>
+#include <mutex>
+#include <unordered_map>
 
+#include <libp2p/common/metrics/registry.hpp>
 #include <libp2p/crypto/ecdsa_provider/ecdsa_provider_impl.hpp>
 #include <libp2p/crypto/ed25519_provider/ed25519_provider_impl.hpp>
 #include <libp2p/security/tls/tls_details.hpp>
@@ -18,6 +22,20 @@ namespace libp2p::security::tls_details {
 
   namespace {
 
+    metrics::Histogram &marshalHistogram() {
+      static auto &histogram = metrics::Registry::instance().histogram(
+          "libp2p_tls_handshake_marshal_seconds",
+          "Time of TLS handshakes in parsing libp2p certificate extension");
+      return histogram;
+    }
+
+    metrics::Histogram &signatureHistogram() {
+      static auto &histogram = metrics::Registry::instance().histogram(
+          "libp2p_tls_handshake_signature_seconds",
+          "Time of TLS handshakes in verifying libp2p certificate extension");
+      return histogram;
+    }
+
     // Helper useful for auto-cleanup of OpenSSL object ptrs
     template <class Obj>
     struct Cleanup {  // NOLINT
@@ -218,7 +236,9 @@ namespace libp2p::security::tls_details {
 
     void assignIssuer(X509 *cert) {
       X509_gmtime_adj(X509_get_notBefore(cert), 0);
-      X509_gmtime_adj(X509_get_notAfter(cert), 10LL * 60 * 60 * 24 * 365);
+      X509_gmtime_adj(
+          X509_get_notAfter(cert),
+          std::chrono::seconds{kCertificateValidity}.count());
       X509_NAME *name = X509_get_subject_name(cert);
       if (name == nullptr) {
         throw std::runtime_error("cannot get certificate subject name");
@@ -296,6 +316,7 @@ namespace libp2p::security::tls_details {
       const crypto::KeyPair &host_key_pair,
       const crypto::marshaller::KeyMarshaller &key_marshaller) {
     CertificateAndKey ret;
+    ret.not_after = std::chrono::system_clock::now() + kCertificateValidity;
 
     // 1. Generate ECDSA keypair for certificate / ssl context
     auto cert_keys = crypto::ecdsa::EcdsaProviderImpl{}.generate().value();
@@ -327,6 +348,24 @@ namespace libp2p::security::tls_details {
     return ret;
   }
 
+  std::shared_ptr<const CertificateAndKey> sharedCertificate(
+      const crypto::KeyPair &host_key_pair,
+      const crypto::marshaller::KeyMarshaller &key_marshaller) {
+    static std::mutex mutex;
+    static std::unordered_map<crypto::PublicKey,
+                              std::shared_ptr<const CertificateAndKey>>
+        cache;
+    std::lock_guard lock{mutex};
+    auto &cached = cache[host_key_pair.publicKey];
+    if (cached == nullptr
+        or std::chrono::system_clock::now() + kCertificateRenewal
+               >= cached->not_after) {
+      cached = std::make_shared<const CertificateAndKey>(
+          makeCertificate(host_key_pair, key_marshaller));
+    }
+    return cached;
+  }
+
   namespace {
 
     struct KeyAndSignature {
@@ -432,6 +471,7 @@ namespace libp2p::security::tls_details {
   outcome::result<PubkeyAndPeerId> verifyPeerAndExtractIdentity(
       X509 *peer_certificate,
       const crypto::marshaller::KeyMarshaller &key_marshaller) {
+    auto started = std::chrono::steady_clock::now();
     // 1. Extract fields from cert extension
     OUTCOME_TRY(bin_fields, extractExtensionFields(peer_certificate));
 
@@ -455,11 +495,15 @@ namespace libp2p::security::tls_details {
       return TlsError::TLS_INCOMPATIBLE_CERTIFICATE_EXTENSION;
     }
 
+    auto parsed = std::chrono::steady_clock::now();
+    marshalHistogram().observe(parsed - started);
+
     // 3. Verify
     OUTCOME_TRY(verifyExtensionSignature(peer_certificate,
                                          peer_pubkey_res.value(),
                                          bin_fields.signature,
                                          peer_id_res.value()));
+    signatureHistogram().observe(std::chrono::steady_clock::now() - parsed);
 
     return PubkeyAndPeerId{std::move(peer_pubkey_res.value()),
                            std::move(peer_id_res.value())};
@@ -559,6 +603,8 @@ OUTCOME_CPP_DEFINE_CATEGORY(libp2p::security, TlsError, e) {
       return "Remote peer not available";
     case E::TLS_REMOTE_PUBKEY_NOT_AVAILABLE:
       return "Remote public key not available";
+    case E::TLS_KERNEL_KEY_UPDATE:
+      return "Key update on connection encrypted by kernel";
     default:
       break;
   }
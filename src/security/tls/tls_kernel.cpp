@@ -0,0 +1,146 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "tls_kernel.hpp"
+
+#include <array>
+#include <cstring>
+#include <string_view>
+
+#include <openssl/hkdf.h>
+#include <openssl/mem.h>
+#include <qtils/unhex.hpp>
+
+#if defined(__linux__) && __has_include(<linux/tls.h>)
+#define LIBP2P_KERNEL_TLS
+#include <linux/tls.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#ifndef TCP_ULP
+#define TCP_ULP 31
+#endif
+#ifndef SOL_TLS
+#define SOL_TLS 282
+#endif
+#endif
+
+namespace libp2p::security::tls_kernel {
+  int secretIndex() {
+    static const int index =
+        SSL_get_ex_new_index(0, nullptr, nullptr, nullptr, nullptr);
+    return index;
+  }
+
+  void onKeylog(const SSL *ssl, const char *line) {
+    auto *secret = static_cast<Bytes *>(SSL_get_ex_data(ssl, secretIndex()));
+    if (secret == nullptr) {
+      return;
+    }
+    // "<label> <client random> <secret>" in hex
+    std::string_view label = SSL_is_server(ssl) ? "SERVER_TRAFFIC_SECRET_0 "
+                                                : "CLIENT_TRAFFIC_SECRET_0 ";
+    std::string_view view{line};
+    if (not view.starts_with(label)) {
+      return;
+    }
+    auto space = view.rfind(' ');
+    if (auto r = qtils::unhex(view.substr(space + 1))) {
+      *secret = std::move(r.value());
+    }
+  }
+
+  bool expandLabel(const EVP_MD *md,
+                   BytesIn secret,
+                   std::string_view label,
+                   BytesOut out) {
+    constexpr std::string_view kPrefix{"tls13 "};
+    Bytes info;
+    info.reserve(4 + kPrefix.size() + label.size());
+    info.push_back(static_cast<uint8_t>(out.size() >> 8));
+    info.push_back(static_cast<uint8_t>(out.size()));
+    info.push_back(static_cast<uint8_t>(kPrefix.size() + label.size()));
+    info.insert(info.end(), kPrefix.begin(), kPrefix.end());
+    info.insert(info.end(), label.begin(), label.end());
+    info.push_back(0);
+    return 1
+        == HKDF_expand(out.data(),
+                       out.size(),
+                       md,
+                       secret.data(),
+                       secret.size(),
+                       info.data(),
+                       info.size());
+  }
+
+#ifdef LIBP2P_KERNEL_TLS
+  namespace {
+    /**
+     * Derives key and iv of traffic secret into kernel crypto info of cipher
+     * and sets it as TX state of socket
+     */
+    template <typename Info>
+    bool offload(int fd,
+                 uint16_t type,
+                 const EVP_MD *md,
+                 BytesIn secret,
+                 uint64_t seq) {
+      Info info{};
+      info.info.version = TLS_1_3_VERSION;
+      info.info.cipher_type = type;
+      // nonce of TLS 1.3 record is iv xor sequence, kernel takes iv as salt
+      // and implicit part
+      std::array<uint8_t, 12> iv{};
+      static_assert(sizeof(info.salt) + sizeof(info.iv) == iv.size());
+      bool ok = expandLabel(md, secret, "key", info.key)
+             and expandLabel(md, secret, "iv", iv);
+      if (ok) {
+        memcpy(info.salt, iv.data(), sizeof(info.salt));
+        memcpy(info.iv, iv.data() + sizeof(info.salt), sizeof(info.iv));
+        for (size_t i = sizeof(info.rec_seq); i != 0; --i, seq >>= 8) {
+          info.rec_seq[i - 1] = static_cast<uint8_t>(seq);
+        }
+        // socket with tls ulp and no keys still sends plaintext as tcp does
+        ok = setsockopt(fd, SOL_TCP, TCP_ULP, "tls", sizeof("tls")) == 0
+          and setsockopt(fd, SOL_TLS, TLS_TX, &info, sizeof(info)) == 0;
+      }
+      OPENSSL_cleanse(&info, sizeof(info));
+      OPENSSL_cleanse(iv.data(), iv.size());
+      return ok;
+    }
+  }  // namespace
+#endif
+
+  bool enableTx(SSL *ssl, int fd, BytesIn secret) {
+#ifdef LIBP2P_KERNEL_TLS
+    if (fd < 0 or secret.empty() or SSL_version(ssl) != TLS1_3_VERSION) {
+      return false;
+    }
+    const auto *cipher = SSL_get_current_cipher(ssl);
+    if (cipher == nullptr) {
+      return false;
+    }
+    auto seq = SSL_get_write_sequence(ssl);
+    switch (SSL_CIPHER_get_protocol_id(cipher)) {
+      case 0x1301:  // TLS_AES_128_GCM_SHA256
+        return offload<tls12_crypto_info_aes_gcm_128>(
+            fd, TLS_CIPHER_AES_GCM_128, EVP_sha256(), secret, seq);
+      case 0x1302:  // TLS_AES_256_GCM_SHA384
+        return offload<tls12_crypto_info_aes_gcm_256>(
+            fd, TLS_CIPHER_AES_GCM_256, EVP_sha384(), secret, seq);
+#ifdef TLS_CIPHER_CHACHA20_POLY1305
+      case 0x1303:  // TLS_CHACHA20_POLY1305_SHA256
+        return offload<tls12_crypto_info_chacha20_poly1305>(
+            fd, TLS_CIPHER_CHACHA20_POLY1305, EVP_sha256(), secret, seq);
+#endif
+      default:
+        return false;
+    }
+#else
+    return false;
+#endif
+  }
+}  // namespace libp2p::security::tls_kernel
@@ -0,0 +1,45 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <string_view>
+
+#include <openssl/ssl.h>
+
+#include <libp2p/common/types.hpp>
+
+namespace libp2p::security::tls_kernel {
+  /// Index of SSL ex data with `Bytes`, which receives write traffic secret
+  /// of connection to be offloaded
+  int secretIndex();
+
+  /// Keylog callback, keeps write traffic secret of SSL which asked for it
+  void onKeylog(const SSL *ssl, const char *line);
+
+  /**
+   * HKDF-Expand-Label of TLS 1.3 with empty context, derives record key
+   * ("key") and iv ("iv") of traffic secret
+   * @param md - hash of cipher suite
+   * @param out - receives as many bytes as its size
+   */
+  bool expandLabel(const EVP_MD *md,
+                   BytesIn secret,
+                   std::string_view label,
+                   BytesOut out);
+
+  /**
+   * Moves record encryption of TLS 1.3 connection to kernel (kTLS TX), so
+   * that plaintext written to the socket is sent as records.
+   * Must be called once handshake is done and SSL has written everything.
+   * Decryption stays in SSL.
+   * @param fd - TCP socket the records are written to
+   * @param secret - write traffic secret of connection
+   * @return false if kernel, socket or cipher doesn't support it, then SSL
+   * keeps encrypting
+   */
+  bool enableTx(SSL *ssl, int fd, BytesIn secret);
+}  // namespace libp2p::security::tls_kernel
@@ -0,0 +1,144 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "tls_sessions.hpp"
+
+#include <cstring>
+#include <stdexcept>
+
+#include <openssl/evp.h>
+#include <openssl/hmac.h>
+#include <openssl/rand.h>
+
+namespace libp2p::security {
+
+  TlsSessions::TlsSessions(size_t capacity) : sessions_{capacity} {}
+
+  void TlsSessions::put(const peer::PeerId &peer,
+                        SSL_SESSION *session,
+                        crypto::PublicKey key) {
+    sessions_.put(peer,
+                  Session{
+                      std::shared_ptr<SSL_SESSION>{session, SSL_SESSION_free},
+                      std::move(key),
+                  });
+  }
+
+  std::optional<TlsSessions::Session> TlsSessions::take(
+      const peer::PeerId &peer) {
+    auto session = sessions_.get(peer);
+    if (session == nullptr) {
+      return std::nullopt;
+    }
+    auto result = std::move(*session);
+    sessions_.erase(peer);
+    return result;
+  }
+
+  TicketKeys::TicketKeys(std::chrono::seconds rotation)
+      : rotation_{rotation}, rotated_{Clock::now()}, current_{generate()} {}
+
+  void TicketKeys::install(SSL_CTX *ctx, std::chrono::seconds rotation) {
+    // NOLINTNEXTLINE(cppcoreguidelines-owning-memory)
+    SSL_CTX_set_ex_data(ctx, index(), new TicketKeys{rotation});
+    SSL_CTX_set_tlsext_ticket_key_cb(ctx, callback);
+  }
+
+  TicketKeys *TicketKeys::of(const SSL_CTX *ctx) {
+    return static_cast<TicketKeys *>(SSL_CTX_get_ex_data(ctx, index()));
+  }
+
+  int TicketKeys::index() {
+    static const int index = SSL_CTX_get_ex_new_index(
+        0,
+        nullptr,
+        nullptr,
+        nullptr,
+        +[](void *, void *ptr, CRYPTO_EX_DATA *, int, long, void *) {
+          // NOLINTNEXTLINE(cppcoreguidelines-owning-memory)
+          delete static_cast<TicketKeys *>(ptr);
+        });
+    return index;
+  }
+
+  TicketKeys::Key TicketKeys::generate() {
+    Key key{};
+    if (RAND_bytes(key.name.data(), key.name.size()) != 1
+        or RAND_bytes(key.aes.data(), key.aes.size()) != 1
+        or RAND_bytes(key.hmac.data(), key.hmac.size()) != 1) {
+      throw std::runtime_error{"TicketKeys: RAND_bytes failed"};
+    }
+    return key;
+  }
+
+  void TicketKeys::rotate(Clock::time_point now) {
+    if (now - rotated_ < rotation_) {
+      return;
+    }
+    // tickets older than two rotations are rejected
+    previous_ = now - rotated_ < 2 * rotation_
+                  ? std::make_optional(current_)
+                  : std::nullopt;
+    current_ = generate();
+    rotated_ = now;
+  }
+
+  int TicketKeys::callback(SSL *ssl,
+                           uint8_t *name,
+                           uint8_t *iv,
+                           EVP_CIPHER_CTX *cipher,
+                           HMAC_CTX *hmac,
+                           int encrypt) {
+    auto *self = of(SSL_get_SSL_CTX(ssl));
+    if (self == nullptr) {
+      return -1;
+    }
+    self->rotate(Clock::now());
+    auto init = [&](const Key &key) {
+      return HMAC_Init_ex(hmac,
+                          key.hmac.data(),
+                          key.hmac.size(),
+                          EVP_sha256(),
+                          nullptr)
+          == 1;
+    };
+    if (encrypt != 0) {
+      const auto &key = self->current_;
+      if (RAND_bytes(iv, EVP_CIPHER_iv_length(EVP_aes_256_cbc())) != 1) {
+        return -1;
+      }
+      std::memcpy(name, key.name.data(), key.name.size());
+      if (EVP_EncryptInit_ex(
+              cipher, EVP_aes_256_cbc(), nullptr, key.aes.data(), iv)
+              != 1
+          or not init(key)) {
+        return -1;
+      }
+      return 1;
+    }
+    auto matches = [&](const Key &key) {
+      return std::memcmp(name, key.name.data(), key.name.size()) == 0;
+    };
+    const Key *key = nullptr;
+    if (matches(self->current_)) {
+      key = &self->current_;
+    } else if (self->previous_ and matches(*self->previous_)) {
+      key = &*self->previous_;
+    } else {
+      // unknown key, full handshake
+      return 0;
+    }
+    if (EVP_DecryptInit_ex(
+            cipher, EVP_aes_256_cbc(), nullptr, key->aes.data(), iv)
+            != 1
+        or not init(*key)) {
+      return -1;
+    }
+    // ask to issue new ticket, encrypted with current key, as client doesn't
+    // reuse the one it resumed with
+    return 2;
+  }
+}  // namespace libp2p::security
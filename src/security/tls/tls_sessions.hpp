@@ -0,0 +1,87 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <memory>
+#include <optional>
+
+#include <openssl/ssl.h>
+
+#include <libp2p/common/lru_cache.hpp>
+#include <libp2p/crypto/key.hpp>
+#include <libp2p/peer/peer_id.hpp>
+
+namespace libp2p::security {
+
+  /// Sessions of dialed peers, next dial to the peer resumes its session
+  class TlsSessions {
+   public:
+    struct Session {
+      std::shared_ptr<SSL_SESSION> session;
+      /// Peer key verified by the handshake which created the session
+      crypto::PublicKey key;
+    };
+
+    explicit TlsSessions(size_t capacity);
+
+    /// Keeps session of peer, takes ownership of session reference
+    void put(const peer::PeerId &peer,
+             SSL_SESSION *session,
+             crypto::PublicKey key);
+
+    /// Session of peer, removed from cache as TLS 1.3 tickets are single use
+    std::optional<Session> take(const peer::PeerId &peer);
+
+   private:
+    LruCache<peer::PeerId, Session> sessions_;
+  };
+
+  /// Keys encrypting session tickets issued by server, rotated periodically
+  class TicketKeys {
+   public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit TicketKeys(std::chrono::seconds rotation);
+
+    /// Attaches keys to context, context owns them
+    static void install(SSL_CTX *ctx, std::chrono::seconds rotation);
+
+    /// Keys attached to context, null if none
+    static TicketKeys *of(const SSL_CTX *ctx);
+
+    /// Generates new current key if rotation interval passed since the last
+    /// one, the replaced key is kept unless two intervals passed
+    void rotate(Clock::time_point now);
+
+   private:
+
+    struct Key {
+      std::array<uint8_t, 16> name;
+      std::array<uint8_t, 32> aes;
+      std::array<uint8_t, 32> hmac;
+    };
+
+    /// Callback of `SSL_CTX_set_tlsext_ticket_key_cb`
+    static int callback(SSL *ssl,
+                        uint8_t *name,
+                        uint8_t *iv,
+                        EVP_CIPHER_CTX *cipher,
+                        HMAC_CTX *hmac,
+                        int encrypt);
+
+    static int index();
+
+    static Key generate();
+
+    Clock::duration rotation_;
+    Clock::time_point rotated_;
+    Key current_;
+    std::optional<Key> previous_;
+  };
+}  // namespace libp2p::security
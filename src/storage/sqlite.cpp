@@ -14,6 +14,13 @@ namespace libp2p::storage {
   SQLite::SQLite(const std::string &db_file, const std::string &logger_tag)
       : db_(db_file), db_file_(db_file), log_(log::createLogger(logger_tag)) {}
 
+  SQLite::SQLite(const std::string &db_file,
+                 const std::string &logger_tag,
+                 const ::sqlite::sqlite_config &config)
+      : db_(db_file, config),
+        db_file_(db_file),
+        log_(log::createLogger(logger_tag)) {}
+
   SQLite::~SQLite() {
     // without the following, all the prepared statements
     // might be executed when db_'s destructor is called
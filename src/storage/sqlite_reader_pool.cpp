@@ -0,0 +1,59 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/storage/sqlite_reader_pool.hpp>
+
+#include <algorithm>
+
+namespace libp2p::storage {
+
+  SQLiteReaderPool::Lease::Lease(SQLiteReaderPool &pool,
+                                 std::unique_ptr<SQLite> db)
+      : pool_{&pool}, db_{std::move(db)} {}
+
+  SQLiteReaderPool::Lease::Lease(Lease &&other) noexcept
+      : pool_{other.pool_}, db_{std::move(other.db_)} {}
+
+  SQLiteReaderPool::Lease::~Lease() {
+    if (db_) {
+      pool_->release(std::move(db_));
+    }
+  }
+
+  SQLite &SQLiteReaderPool::Lease::operator*() const {
+    return *db_;
+  }
+
+  SQLite *SQLiteReaderPool::Lease::operator->() const {
+    return db_.get();
+  }
+
+  SQLiteReaderPool::SQLiteReaderPool(const std::string &db_file, size_t size) {
+    ::sqlite::sqlite_config config;
+    config.flags = ::sqlite::OpenFlags::READONLY;
+    for (size_t i = 0; i < std::max<size_t>(size, 1); ++i) {
+      free_.emplace_back(
+          std::make_unique<SQLite>(db_file, "sqlite_reader", config));
+    }
+  }
+
+  SQLiteReaderPool::Lease SQLiteReaderPool::acquire() {
+    std::unique_lock lock{mutex_};
+    released_.wait(lock, [this] { return not free_.empty(); });
+    auto db = std::move(free_.back());
+    free_.pop_back();
+    return Lease{*this, std::move(db)};
+  }
+
+  void SQLiteReaderPool::release(std::unique_ptr<SQLite> db) {
+    {
+      std::lock_guard lock{mutex_};
+      free_.emplace_back(std::move(db));
+    }
+    released_.notify_one();
+  }
+
+}  // namespace libp2p::storage
@@ -0,0 +1,121 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/storage/sqlite_writer.hpp>
+
+#include <future>
+
+namespace libp2p::storage {
+
+  SQLiteWriter::SQLiteWriter(const std::string &db_file, const Config &config)
+      : config_{config},
+        db_{db_file, "sqlite_writer"},
+        queue_{config_.queue_capacity} {
+    std::string journal_mode;
+    db_ << "PRAGMA journal_mode = WAL" >> journal_mode;
+    db_ << "PRAGMA synchronous = NORMAL";
+    begin_ = db_.createStatement("BEGIN");
+    commit_ = db_.createStatement("COMMIT");
+    rollback_ = db_.createStatement("ROLLBACK");
+    thread_ = std::thread{[this] { run(); }};
+  }
+
+  SQLiteWriter::~SQLiteWriter() {
+    {
+      std::lock_guard lock{mutex_};
+      stop_ = true;
+    }
+    wakeup_.notify_one();
+    thread_.join();
+  }
+
+  bool SQLiteWriter::post(Command command, OnCommit on_commit) {
+    return push({std::move(command), std::move(on_commit)});
+  }
+
+  bool SQLiteWriter::flush() {
+    std::promise<bool> committed;
+    auto future = committed.get_future();
+    while (not push({{},
+                     [&committed](bool ok) { committed.set_value(ok); },
+                     true})) {
+      std::this_thread::yield();
+    }
+    return future.get();
+  }
+
+  bool SQLiteWriter::push(Item &&item) {
+    if (not queue_.tryPush(std::move(item))) {
+      return false;
+    }
+    // either writer sees the command, or producer sees writer sleeping
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (sleeping_.load()) {
+      std::lock_guard lock{mutex_};
+      wakeup_.notify_one();
+    }
+    return true;
+  }
+
+  bool SQLiteWriter::pop(Item &item,
+                         std::chrono::steady_clock::time_point deadline) {
+    while (not queue_.tryPop(item)) {
+      std::unique_lock lock{mutex_};
+      sleeping_.store(true);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      auto popped = queue_.tryPop(item);
+      if (popped or stop_ or std::chrono::steady_clock::now() >= deadline) {
+        sleeping_.store(false);
+        return popped;
+      }
+      if (deadline == std::chrono::steady_clock::time_point::max()) {
+        wakeup_.wait(lock);
+      } else {
+        wakeup_.wait_until(lock, deadline);
+      }
+      sleeping_.store(false);
+    }
+    return true;
+  }
+
+  void SQLiteWriter::run() {
+    Item item;
+    std::vector<OnCommit> on_commits;
+    // remaining commands are committed on stop, as pop drains queue first
+    while (pop(item, std::chrono::steady_clock::time_point::max())) {
+      auto deadline = std::chrono::steady_clock::now() + config_.interval;
+      auto ok = db_.execCommand(begin_) >= 0;
+      size_t count = 0;
+      auto urgent = false;
+      do {
+        if (item.command) {
+          try {
+            item.command(db_);
+          } catch (...) {
+            // command throwing rolls back its transaction
+            ok = false;
+          }
+        }
+        if (item.on_commit) {
+          on_commits.emplace_back(std::move(item.on_commit));
+        }
+        urgent = item.urgent;
+        item = {};
+        ++count;
+      } while (not urgent and count < config_.batch and pop(item, deadline));
+
+      ok = ok and db_.execCommand(commit_) >= 0;
+      if (not ok) {
+        db_.execCommand(rollback_);
+      }
+      for (auto &on_commit : on_commits) {
+        on_commit(ok);
+      }
+      on_commits.clear();
+    }
+  }
+
+}  // namespace libp2p::storage
@@ -0,0 +1,155 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/transport/impl/inbound_gate.hpp>
+
+#include <algorithm>
+
+#include <boost/assert.hpp>
+#include <boost/container_hash/hash.hpp>
+
+#include <libp2p/common/metrics/registry.hpp>
+
+namespace libp2p::transport {
+  namespace {
+    void observeRejected() {
+      static auto &rejected = metrics::Registry::instance().counter(
+          "libp2p_inbound_rejected_total",
+          "Inbound connections closed before upgrade due to limits");
+      rejected.inc();
+    }
+
+    /// Zeroes bits after `prefix` bits
+    template <size_t N>
+    void mask(std::array<uint8_t, N> &bytes, size_t prefix) {
+      for (size_t i = 0; i < N; ++i) {
+        if (prefix >= 8) {
+          prefix -= 8;
+          continue;
+        }
+        bytes[i] &= static_cast<uint8_t>(0xFF << (8 - prefix));
+        prefix = 0;
+      }
+    }
+  }  // namespace
+
+  size_t InboundGate::SubnetHash::operator()(const Subnet &subnet) const {
+    return boost::hash_range(subnet.begin(), subnet.end());
+  }
+
+  InboundGate::InboundGate(InboundGateConfig config)
+      : InboundGate{config, nullptr} {}
+
+  InboundGate::InboundGate(InboundGateConfig config,
+                           std::shared_ptr<network::ConnectionGater> gater)
+      : config_{config}, gater_{std::move(gater)} {
+    BOOST_ASSERT(config_.accept_burst != 0);
+    BOOST_ASSERT(config_.max_inflight_upgrades != 0);
+  }
+
+  bool InboundGate::admit(const boost::asio::ip::address &address) {
+    return admit(address, Clock::now());
+  }
+
+  bool InboundGate::admit(const boost::asio::ip::address &address,
+                          Clock::time_point now) {
+    if (gater_ != nullptr and not gater_->allowAccept(address)) {
+      return false;
+    }
+    auto subnet = subnetOf(address);
+    auto it = buckets_.find(subnet);
+    if (it == buckets_.end()) {
+      if (buckets_.size() >= config_.max_tracked_subnets) {
+        forgetIdle(now);
+      }
+      it = buckets_
+               .emplace(subnet,
+                        Bucket{static_cast<double>(config_.accept_burst), now})
+               .first;
+    }
+    auto &bucket = it->second;
+    refill(bucket, now);
+    if (bucket.tokens < 1) {
+      observeRejected();
+      return false;
+    }
+    bucket.tokens -= 1;
+    return true;
+  }
+
+  bool InboundGate::enqueue(StartUpgrade start) {
+    if (inflight_ < config_.max_inflight_upgrades) {
+      this->start(std::move(start));
+      return true;
+    }
+    if (queue_.size() >= config_.max_queued_upgrades) {
+      observeRejected();
+      return false;
+    }
+    queue_.emplace_back(std::move(start));
+    return true;
+  }
+
+  InboundGate::Subnet InboundGate::subnetOf(
+      const boost::asio::ip::address &address) const {
+    Subnet subnet{};
+    if (address.is_v4()) {
+      auto bytes = address.to_v4().to_bytes();
+      mask(bytes, config_.ipv4_prefix);
+      std::ranges::copy(bytes, subnet.begin());
+      subnet.back() = 4;
+    } else {
+      auto bytes = address.to_v6().to_bytes();
+      mask(bytes, config_.ipv6_prefix);
+      std::ranges::copy(bytes, subnet.begin());
+      subnet.back() = 6;
+    }
+    return subnet;
+  }
+
+  void InboundGate::refill(Bucket &bucket, Clock::time_point now) const {
+    if (now <= bucket.updated) {
+      return;
+    }
+    std::chrono::duration<double> elapsed = now - bucket.updated;
+    bucket.tokens =
+        std::min(bucket.tokens + elapsed.count() * config_.accept_rate,
+                 static_cast<double>(config_.accept_burst));
+    bucket.updated = now;
+  }
+
+  void InboundGate::forgetIdle(Clock::time_point now) {
+    for (auto it = buckets_.begin(); it != buckets_.end();) {
+      refill(it->second, now);
+      if (it->second.tokens >= static_cast<double>(config_.accept_burst)) {
+        it = buckets_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+
+  void InboundGate::start(StartUpgrade start) {
+    ++inflight_;
+    Permit permit = cancelFn([weak{weak_from_this()}] {
+      if (auto self = weak.lock()) {
+        self->release();
+      }
+    });
+    start(std::move(permit));
+  }
+
+  void InboundGate::release() {
+    BOOST_ASSERT(inflight_ != 0);
+    --inflight_;
+    if (not queue_.empty() and inflight_ < config_.max_inflight_upgrades) {
+      auto next = std::move(queue_.front());
+      queue_.pop_front();
+      start(std::move(next));
+    }
+  }
+
+}  // namespace libp2p::transport
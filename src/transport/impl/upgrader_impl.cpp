@@ -17,6 +17,8 @@ OUTCOME_CPP_DEFINE_CATEGORY(libp2p::transport, UpgraderImpl::Error, e) {
       return "success";
     case E::NO_ADAPTOR_FOUND:
       return "can not find suitable adaptor";
+    case E::CONNECTION_GATED:
+      return "remote peer is denied by connection gater";
   }
   return "unknown error";
 }
@@ -36,6 +38,9 @@ namespace {
     }
     return nullptr;
   }
+
+  /// Rejecting peers are forgotten at once when there are too many of them
+  constexpr size_t kMaxOptimisticRejected = 1024;
 }  // namespace
 
 namespace libp2p::transport {
@@ -44,11 +49,57 @@ namespace libp2p::transport {
       std::vector<LayerAdaptorSPtr> layer_adaptors,
       std::vector<SecAdaptorSPtr> security_adaptors,
       std::vector<MuxAdaptorSPtr> muxer_adaptors)
-      : protocol_muxer_{std::move(protocol_muxer)},
+      : UpgraderImpl{std::move(protocol_muxer),
+                     std::move(layer_adaptors),
+                     std::move(security_adaptors),
+                     std::move(muxer_adaptors),
+                     UpgraderConfig{}} {}
+
+  UpgraderImpl::UpgraderImpl(
+      std::shared_ptr<protocol_muxer::ProtocolMuxer> protocol_muxer,
+      std::vector<LayerAdaptorSPtr> layer_adaptors,
+      std::vector<SecAdaptorSPtr> security_adaptors,
+      std::vector<MuxAdaptorSPtr> muxer_adaptors,
+      UpgraderConfig config)
+      : UpgraderImpl{std::move(protocol_muxer),
+                     std::move(layer_adaptors),
+                     std::move(security_adaptors),
+                     std::move(muxer_adaptors),
+                     std::move(config),
+                     nullptr} {}
+
+  UpgraderImpl::UpgraderImpl(
+      std::shared_ptr<protocol_muxer::ProtocolMuxer> protocol_muxer,
+      std::vector<LayerAdaptorSPtr> layer_adaptors,
+      std::vector<SecAdaptorSPtr> security_adaptors,
+      std::vector<MuxAdaptorSPtr> muxer_adaptors,
+      UpgraderConfig config,
+      std::shared_ptr<basic::Scheduler> scheduler)
+      : UpgraderImpl{std::move(protocol_muxer),
+                     std::move(layer_adaptors),
+                     std::move(security_adaptors),
+                     std::move(muxer_adaptors),
+                     std::move(config),
+                     std::move(scheduler),
+                     nullptr} {}
+
+  UpgraderImpl::UpgraderImpl(
+      std::shared_ptr<protocol_muxer::ProtocolMuxer> protocol_muxer,
+      std::vector<LayerAdaptorSPtr> layer_adaptors,
+      std::vector<SecAdaptorSPtr> security_adaptors,
+      std::vector<MuxAdaptorSPtr> muxer_adaptors,
+      UpgraderConfig config,
+      std::shared_ptr<basic::Scheduler> scheduler,
+      std::shared_ptr<network::ConnectionGater> gater)
+      : config_{std::move(config)},
+        scheduler_{std::move(scheduler)},
+        gater_{std::move(gater)},
+        protocol_muxer_{std::move(protocol_muxer)},
         layer_adaptors_{std::move(layer_adaptors)},
         security_adaptors_{std::move(security_adaptors)},
         muxer_adaptors_{std::move(muxer_adaptors)} {
     BOOST_ASSERT(protocol_muxer_ != nullptr);
+    BOOST_ASSERT(scheduler_ != nullptr or config_.buffering.write_buffer == 0);
 
     BOOST_ASSERT(std::all_of(layer_adaptors_.begin(),
                              layer_adaptors_.end(),
@@ -78,6 +129,11 @@ namespace libp2p::transport {
         muxer_adaptors_.end(),
         std::back_inserter(muxer_protocols_),
         [](const auto &adaptor) { return adaptor->getProtocolId(); });
+
+    // security protocols which support it agree on muxer during handshake
+    for (const auto &adaptor : security_adaptors_) {
+      adaptor->offerMuxers(muxer_protocols_);
+    }
   }
 
   void UpgraderImpl::upgradeLayersInbound(RawSPtr conn,
@@ -188,11 +244,40 @@ namespace libp2p::transport {
         });
   }
 
+  UpgraderImpl::LayerSPtr UpgraderImpl::buffered(LayerSPtr conn) const {
+    if (not config_.buffering.enabled()) {
+      return conn;
+    }
+    return std::make_shared<connection::BufferedConnection>(
+        std::move(conn), scheduler_, config_.buffering);
+  }
+
+  UpgraderImpl::OnSecuredCallbackFunc UpgraderImpl::gated(
+      OnSecuredCallbackFunc cb) const {
+    if (gater_ == nullptr) {
+      return cb;
+    }
+    return [gater{gater_}, cb{std::move(cb)}](outcome::result<SecSPtr> res) {
+      if (res.has_value()) {
+        auto &conn = res.value();
+        auto peer = conn->remotePeer();
+        if (peer.has_value()
+            and not gater->allowSecured(peer.value(), conn->isInitiator())) {
+          std::ignore = conn->close();
+          return cb(Error::CONNECTION_GATED);
+        }
+      }
+      cb(std::move(res));
+    };
+  }
+
   void UpgraderImpl::upgradeToSecureInbound(LayerSPtr conn,
                                             OnSecuredCallbackFunc cb) {
     BOOST_ASSERT_MSG(!conn->isInitiator(),
                      "connection is initiator, and upgrade for inbound is "
                      "called (should be upgrade for outbound)");
+    conn = buffered(std::move(conn));
+    cb = gated(std::move(cb));
 
     protocol_muxer_->selectOneOf(
         security_protocols_,
@@ -221,6 +306,12 @@ namespace libp2p::transport {
     BOOST_ASSERT_MSG(conn->isInitiator(),
                      "connection is NOT initiator, and upgrade for outbound is "
                      "called (should be upgrade for inbound)");
+    conn = buffered(std::move(conn));
+    cb = gated(std::move(cb));
+
+    if (secureOptimistic(conn, remoteId, cb)) {
+      return;
+    }
 
     protocol_muxer_->selectOneOf(
         security_protocols_,
@@ -244,7 +335,50 @@ namespace libp2p::transport {
         });
   }
 
+  bool UpgraderImpl::secureOptimistic(const LayerSPtr &conn,
+                                      const peer::PeerId &remoteId,
+                                      OnSecuredCallbackFunc &cb) {
+    if (not config_.optimistic_security
+        or optimistic_rejected_.contains(remoteId)) {
+      return false;
+    }
+    const auto &protocol = config_.optimistic_security.value();
+    auto adaptor = findAdaptor(security_adaptors_, protocol);
+    if (adaptor == nullptr) {
+      return false;
+    }
+    auto lazy_res = protocol_muxer_->lazyConnectionNegotiate(conn, protocol);
+    if (not lazy_res) {
+      return false;
+    }
+    adaptor->secureOutbound(
+        std::move(lazy_res.value()),
+        remoteId,
+        [weak{weak_from_this()}, remoteId, cb{std::move(cb)}](
+            outcome::result<SecSPtr> res) {
+          if (res.has_error()
+              and res.error()
+                      == protocol_muxer::ProtocolMuxer::Error::
+                          NEGOTIATION_FAILED) {
+            if (auto self = weak.lock()) {
+              if (self->optimistic_rejected_.size()
+                  >= kMaxOptimisticRejected) {
+                self->optimistic_rejected_.clear();
+              }
+              self->optimistic_rejected_.emplace(remoteId);
+            }
+          }
+          cb(std::move(res));
+        });
+    return true;
+  }
+
   void UpgraderImpl::upgradeToMuxed(SecSPtr conn, OnMuxedCallbackFunc cb) {
+    if (auto muxer = conn->negotiatedMuxer()) {
+      if (auto adaptor = findAdaptor(muxer_adaptors_, muxer.value())) {
+        return muxConnection(adaptor, std::move(conn), std::move(cb));
+      }
+    }
     return protocol_muxer_->selectOneOf(
         muxer_protocols_,
         conn,
@@ -261,17 +395,23 @@ namespace libp2p::transport {
             return cb(Error::NO_ADAPTOR_FOUND);
           }
 
-          return adaptor->muxConnection(
-              std::move(conn),
-              [cb = std::move(cb)](outcome::result<CapSPtr> conn_res) {
-                if (!conn_res) {
-                  return cb(conn_res.error());
-                }
-
-                auto &&conn = conn_res.value();
-                conn->start();
-                return cb(std::move(conn));
-              });
+          return muxConnection(adaptor, std::move(conn), std::move(cb));
+        });
+  }
+
+  void UpgraderImpl::muxConnection(const MuxAdaptorSPtr &adaptor,
+                                   SecSPtr conn,
+                                   OnMuxedCallbackFunc cb) {
+    return adaptor->muxConnection(
+        std::move(conn),
+        [cb = std::move(cb)](outcome::result<CapSPtr> conn_res) {
+          if (!conn_res) {
+            return cb(conn_res.error());
+          }
+
+          auto &&conn = conn_res.value();
+          conn->start();
+          return cb(std::move(conn));
         });
   }
 }  // namespace libp2p::transport
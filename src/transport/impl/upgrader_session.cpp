@@ -6,7 +6,24 @@
 
 #include <libp2p/transport/impl/upgrader_session.hpp>
 
+#include <libp2p/common/metrics/registry.hpp>
+
 namespace libp2p::transport {
+  namespace {
+    void observeHandshake(std::chrono::steady_clock::time_point started,
+                          bool success) {
+      static auto &duration = metrics::Registry::instance().histogram(
+          "libp2p_security_handshake_duration_seconds",
+          "Duration of security handshakes");
+      static auto &failures = metrics::Registry::instance().counter(
+          "libp2p_security_handshake_failures_total",
+          "Failed security handshakes");
+      duration.observe(std::chrono::steady_clock::now() - started);
+      if (not success) {
+        failures.inc();
+      }
+    }
+  }  // namespace
 
   UpgraderSession::UpgraderSession(
       std::shared_ptr<transport::Upgrader> upgrader,
@@ -18,7 +35,21 @@ namespace libp2p::transport {
         raw_(std::move(raw)),
         handler_(std::move(handler)) {}
 
+  void UpgraderSession::startSpan(std::string_view name) {
+    span_ = metrics::Span{name};
+    if (not span_) {
+      return;
+    }
+    handler_ = [span{span_}, handler{std::move(handler_)}](
+                   outcome::result<std::shared_ptr<connection::CapableConnection>>
+                       res) {
+      span.end(res.has_value() ? std::error_code{} : res.error());
+      handler(std::move(res));
+    };
+  }
+
   void UpgraderSession::upgradeInbound() {
+    startSpan("libp2p.upgrade.inbound");
     if (layers_.empty()) {
       return secureInbound(raw_);
     }
@@ -37,6 +68,10 @@ namespace libp2p::transport {
 
   void UpgraderSession::upgradeOutbound(const multi::Multiaddress &address,
                                         const peer::PeerId &remoteId) {
+    startSpan("libp2p.upgrade.outbound");
+    if (span_) {
+      span_.setAttribute("peer", remoteId.toBase58());
+    }
     if (layers_.empty()) {
       return secureOutbound(raw_, remoteId);
     }
@@ -55,7 +90,12 @@ namespace libp2p::transport {
 
   void UpgraderSession::secureInbound(
       std::shared_ptr<connection::LayerConnection> conn) {
-    auto on_sec_upgraded = [self{shared_from_this()}](auto &&res) {
+    auto on_sec_upgraded = [self{shared_from_this()},
+                            started{std::chrono::steady_clock::now()},
+                            span{span_.child("libp2p.security.handshake")}](
+                               auto &&res) {
+      observeHandshake(started, res.has_value());
+      span.end(res.has_value() ? std::error_code{} : res.error());
       if (!res) {
         return self->handler_(res.as_failure());
       }
@@ -70,7 +110,12 @@ namespace libp2p::transport {
   void UpgraderSession::secureOutbound(
       std::shared_ptr<connection::LayerConnection> conn,
       const peer::PeerId &remoteId) {
-    auto on_sec_upgraded = [self{shared_from_this()}](auto &&res) {
+    auto on_sec_upgraded = [self{shared_from_this()},
+                            started{std::chrono::steady_clock::now()},
+                            span{span_.child("libp2p.security.handshake")}](
+                               auto &&res) {
+      observeHandshake(started, res.has_value());
+      span.end(res.has_value() ? std::error_code{} : res.error());
       if (!res) {
         return self->handler_(res.as_failure());
       }
@@ -88,6 +133,10 @@ namespace libp2p::transport {
       return handler_(rsecure.error());
     }
 
+    if (auto peer = rsecure.value()->remotePeer()) {
+      raw_->attributeTraffic(peer.value());
+    }
+
     upgrader_->upgradeToMuxed(
         rsecure.value(), [self{shared_from_this()}](auto &&res) {
           self->handler_(std::forward<decltype(res)>(res));
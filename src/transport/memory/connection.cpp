@@ -0,0 +1,150 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/transport/memory/connection.hpp>
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/post.hpp>
+
+#include <libp2p/transport/memory/error.hpp>
+#include <libp2p/transport/memory/stream.hpp>
+
+namespace libp2p::transport {
+  MemoryConnection::MemoryConnection(Endpoint local,
+                                     const Endpoint &remote,
+                                     bool initiator)
+      : local_{std::move(local)},
+        remote_address_{remote.address},
+        remote_peer_{remote.peer},
+        remote_key_{remote.key},
+        initiator_{initiator},
+        closed_{std::make_shared<std::atomic_bool>(false)} {}
+
+  MemoryConnection::~MemoryConnection() {
+    std::ignore = close();
+  }
+
+  std::pair<std::shared_ptr<MemoryConnection>,
+            std::shared_ptr<MemoryConnection>>
+  MemoryConnection::makePair(Endpoint dialer, Endpoint listener) {
+    auto dialer_end =
+        std::make_shared<MemoryConnection>(dialer, listener, true);
+    auto listener_end = std::make_shared<MemoryConnection>(
+        std::move(listener), dialer, false);
+    dialer_end->remote_ = listener_end;
+    listener_end->remote_ = dialer_end;
+    listener_end->closed_ = dialer_end->closed_;
+    return {std::move(dialer_end), std::move(listener_end)};
+  }
+
+  void MemoryConnection::read(BytesOut out,
+                              size_t bytes,
+                              ReadCallbackFunc cb) {
+    throw std::logic_error{"MemoryConnection::read must not be called"};
+  }
+
+  void MemoryConnection::readSome(BytesOut out,
+                                  size_t bytes,
+                                  ReadCallbackFunc cb) {
+    throw std::logic_error{"MemoryConnection::readSome must not be called"};
+  }
+
+  void MemoryConnection::deferReadCallback(outcome::result<size_t> res,
+                                           ReadCallbackFunc cb) {
+    post(*local_.io_context, [cb{std::move(cb)}, res] { cb(res); });
+  }
+
+  void MemoryConnection::writeSome(BytesIn in,
+                                   size_t bytes,
+                                   WriteCallbackFunc cb) {
+    throw std::logic_error{"MemoryConnection::writeSome must not be called"};
+  }
+
+  void MemoryConnection::deferWriteCallback(std::error_code ec,
+                                            WriteCallbackFunc cb) {
+    deferReadCallback(ec, std::move(cb));
+  }
+
+  bool MemoryConnection::isClosed() const {
+    return *closed_;
+  }
+
+  outcome::result<void> MemoryConnection::close() {
+    *closed_ = true;
+    for (auto &weak_stream : streams_) {
+      if (auto stream = weak_stream.lock()) {
+        stream->reset();
+      }
+    }
+    streams_.clear();
+    return outcome::success();
+  }
+
+  bool MemoryConnection::isInitiator() const noexcept {
+    return initiator_;
+  }
+
+  outcome::result<Multiaddress> MemoryConnection::remoteMultiaddr() {
+    return remote_address_;
+  }
+
+  outcome::result<Multiaddress> MemoryConnection::localMultiaddr() {
+    return local_.address;
+  }
+
+  outcome::result<PeerId> MemoryConnection::localPeer() const {
+    return local_.peer;
+  }
+
+  outcome::result<PeerId> MemoryConnection::remotePeer() const {
+    return remote_peer_;
+  }
+
+  outcome::result<crypto::PublicKey> MemoryConnection::remotePublicKey()
+      const {
+    return remote_key_;
+  }
+
+  void MemoryConnection::start() {}
+
+  void MemoryConnection::stop() {}
+
+  void MemoryConnection::newStream(CapableConnection::StreamHandlerFunc cb) {
+    auto r = newStream();
+    post(*local_.io_context, [cb{std::move(cb)}, r{std::move(r)}] { cb(r); });
+  }
+
+  outcome::result<std::shared_ptr<libp2p::connection::Stream>>
+  MemoryConnection::newStream() {
+    auto remote = remote_.lock();
+    if (*closed_ or not remote) {
+      return MemoryError::CONN_CLOSED;
+    }
+    auto [local_end, remote_end] =
+        connection::MemoryStream::makePair(shared_from_this(), remote);
+    std::erase_if(streams_, [](const auto &s) { return s.expired(); });
+    streams_.emplace_back(local_end);
+    post(*remote->ioContext(),
+         [remote, remote_end{std::move(remote_end)}]() mutable {
+           remote->onRemoteStream(std::move(remote_end));
+         });
+    return local_end;
+  }
+
+  void MemoryConnection::onStream(NewStreamHandlerFunc cb) {
+    on_stream_ = std::move(cb);
+  }
+
+  void MemoryConnection::onRemoteStream(
+      std::shared_ptr<connection::MemoryStream> stream) {
+    if (*closed_ or not on_stream_) {
+      return stream->reset();
+    }
+    std::erase_if(streams_, [](const auto &s) { return s.expired(); });
+    streams_.emplace_back(stream);
+    on_stream_(std::move(stream));
+  }
+}  // namespace libp2p::transport
@@ -0,0 +1,136 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/transport/memory/listener.hpp>
+
+#include <charconv>
+#include <mutex>
+#include <unordered_map>
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/post.hpp>
+
+#include <libp2p/transport/memory/error.hpp>
+
+namespace libp2p::transport {
+  namespace {
+    /// Listeners of the process by id
+    struct Registry {
+      std::mutex mutex;
+      std::unordered_map<uint64_t, std::weak_ptr<MemoryListener>> listeners;
+      uint64_t next_id = 1;
+    };
+
+    Registry &registry() {
+      static Registry registry;
+      return registry;
+    }
+  }  // namespace
+
+  namespace detail {
+    outcome::result<uint64_t> asMemory(const Multiaddress &ma) {
+      auto parts = ma.getProtocolsWithValues();
+      if (parts.empty() or parts[0].first.code != multi::Protocol::Code::MEMORY
+          or (parts.size() > 1
+              and (parts.size() > 2
+                   or parts[1].first.code != multi::Protocol::Code::P2P))) {
+        return MemoryError::INVALID_ADDRESS;
+      }
+      auto &value = parts[0].second;
+      uint64_t id = 0;
+      auto end = value.data() + value.size();
+      auto [ptr, ec] = std::from_chars(value.data(), end, id);
+      if (ec != std::errc{} or ptr != end) {
+        return MemoryError::INVALID_ADDRESS;
+      }
+      return id;
+    }
+  }  // namespace detail
+
+  MemoryListener::MemoryListener(MemoryConnection::Endpoint local,
+                                 TransportListener::HandlerFunc handler)
+      : local_{std::move(local)}, handler_{std::move(handler)} {}
+
+  MemoryListener::~MemoryListener() {
+    std::ignore = close();
+  }
+
+  bool MemoryListener::isClosed() const {
+    return not id_;
+  }
+
+  outcome::result<void> MemoryListener::close() {
+    if (not id_) {
+      return outcome::success();
+    }
+    auto &reg = registry();
+    std::unique_lock lock{reg.mutex};
+    reg.listeners.erase(*id_);
+    id_.reset();
+    return outcome::success();
+  }
+
+  outcome::result<void> MemoryListener::listen(const Multiaddress &address) {
+    OUTCOME_TRY(id, detail::asMemory(address));
+    if (id_) {
+      return MemoryError::ADDRESS_IN_USE;
+    }
+    auto &reg = registry();
+    std::unique_lock lock{reg.mutex};
+    if (id == 0) {
+      while (reg.listeners.contains(reg.next_id)) {
+        ++reg.next_id;
+      }
+      id = reg.next_id++;
+    }
+    auto it = reg.listeners.find(id);
+    if (it != reg.listeners.end() and not it->second.expired()) {
+      return MemoryError::ADDRESS_IN_USE;
+    }
+    reg.listeners.insert_or_assign(id, weak_from_this());
+    id_ = id;
+    OUTCOME_TRY(ma, Multiaddress::create("/memory/" + std::to_string(id)));
+    local_.address = std::move(ma);
+    return outcome::success();
+  }
+
+  bool MemoryListener::canListen(const Multiaddress &ma) const {
+    return detail::asMemory(ma).has_value();
+  }
+
+  outcome::result<Multiaddress> MemoryListener::getListenMultiaddr() const {
+    if (not id_) {
+      return MemoryError::CONN_CLOSED;
+    }
+    return local_.address;
+  }
+
+  std::shared_ptr<MemoryListener> MemoryListener::find(uint64_t id) {
+    auto &reg = registry();
+    std::unique_lock lock{reg.mutex};
+    auto it = reg.listeners.find(id);
+    if (it == reg.listeners.end()) {
+      return nullptr;
+    }
+    return it->second.lock();
+  }
+
+  std::shared_ptr<MemoryConnection> MemoryListener::accept(
+      MemoryConnection::Endpoint dialer) {
+    auto [dialer_end, listener_end] =
+        MemoryConnection::makePair(std::move(dialer), local_);
+    post(*local_.io_context,
+         [weak_self{weak_from_this()}, conn{std::move(listener_end)}] {
+           auto self = weak_self.lock();
+           if (not self or self->isClosed()) {
+             std::ignore = conn->close();
+             return;
+           }
+           self->handler_(conn);
+         });
+    return dialer_end;
+  }
+}  // namespace libp2p::transport
@@ -0,0 +1,226 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/transport/memory/stream.hpp>
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/post.hpp>
+
+#include <libp2p/basic/read_return_size.hpp>
+#include <libp2p/common/ambigous_size.hpp>
+#include <libp2p/transport/memory/connection.hpp>
+
+namespace libp2p::connection {
+  namespace {
+    using Callback = basic::Reader::ReadCallbackFunc;
+
+    /// Callback with its result, called after pipe is unlocked
+    using Completion = std::pair<Callback, outcome::result<size_t>>;
+
+    void post(boost::asio::io_context &io, Completion completion) {
+      boost::asio::post(io,
+                        [cb{std::move(completion.first)},
+                         r{completion.second}]() mutable { cb(r); });
+    }
+
+    /// Copies pending write into pending read, completing both
+    void transfer(MemoryStream::Pipe::Direction &direction,
+                  std::vector<std::pair<size_t, Completion>> &completions,
+                  size_t writer) {
+      auto &[in, write_cb] = *direction.writing;
+      auto &[out, read_cb] = *direction.reading;
+      auto n = std::min(in.size(), out.size());
+      std::copy_n(in.begin(), n, out.begin());
+      completions.emplace_back(writer, Completion{std::move(write_cb), n});
+      completions.emplace_back(1 - writer, Completion{std::move(read_cb), n});
+      direction.writing.reset();
+      direction.reading.reset();
+    }
+  }  // namespace
+
+  MemoryStream::MemoryStream(std::shared_ptr<transport::MemoryConnection> conn,
+                             std::shared_ptr<Pipe> pipe,
+                             size_t end)
+      : conn_{std::move(conn)}, pipe_{std::move(pipe)}, end_{end} {}
+
+  MemoryStream::~MemoryStream() {
+    reset();
+  }
+
+  std::pair<std::shared_ptr<MemoryStream>, std::shared_ptr<MemoryStream>>
+  MemoryStream::makePair(
+      std::shared_ptr<transport::MemoryConnection> initiator,
+      std::shared_ptr<transport::MemoryConnection> responder) {
+    auto pipe = std::make_shared<Pipe>();
+    pipe->io_contexts = {initiator->ioContext(), responder->ioContext()};
+    return {std::make_shared<MemoryStream>(std::move(initiator), pipe, 0),
+            std::make_shared<MemoryStream>(std::move(responder), pipe, 1)};
+  }
+
+  void MemoryStream::read(BytesOut out,
+                          size_t bytes,
+                          basic::Reader::ReadCallbackFunc cb) {
+    ambigousSize(out, bytes);
+    readReturnSize(shared_from_this(), out, std::move(cb));
+  }
+
+  void MemoryStream::readSome(BytesOut out,
+                              size_t bytes,
+                              basic::Reader::ReadCallbackFunc cb) {
+    ambigousSize(out, bytes);
+    std::vector<std::pair<size_t, Completion>> completions;
+    {
+      std::unique_lock lock{pipe_->mutex};
+      auto &direction = pipe_->directions[1 - end_];
+      if (direction.reading) {
+        throw std::logic_error{"MemoryStream::readSome already in progress"};
+      }
+      if (pipe_->reset) {
+        completions.emplace_back(
+            end_, Completion{std::move(cb), Error::STREAM_RESET_BY_HOST});
+      } else if (out.empty()) {
+        completions.emplace_back(end_, Completion{std::move(cb), size_t{0}});
+      } else if (direction.writing) {
+        direction.reading.emplace(out, std::move(cb));
+        transfer(direction, completions, 1 - end_);
+      } else if (direction.closed) {
+        completions.emplace_back(
+            end_, Completion{std::move(cb), Error::STREAM_CLOSED_BY_PEER});
+      } else {
+        direction.reading.emplace(out, std::move(cb));
+      }
+    }
+    for (auto &[end, completion] : completions) {
+      post(*pipe_->io_contexts.at(end), std::move(completion));
+    }
+  }
+
+  void MemoryStream::deferReadCallback(outcome::result<size_t> res,
+                                       basic::Reader::ReadCallbackFunc cb) {
+    post(*conn_->ioContext(), Completion{std::move(cb), res});
+  }
+
+  void MemoryStream::writeSome(BytesIn in,
+                               size_t bytes,
+                               basic::Writer::WriteCallbackFunc cb) {
+    ambigousSize(in, bytes);
+    std::vector<std::pair<size_t, Completion>> completions;
+    {
+      std::unique_lock lock{pipe_->mutex};
+      auto &direction = pipe_->directions[end_];
+      if (direction.writing) {
+        throw std::logic_error{"MemoryStream::writeSome already in progress"};
+      }
+      if (pipe_->reset) {
+        completions.emplace_back(
+            end_, Completion{std::move(cb), Error::STREAM_RESET_BY_HOST});
+      } else if (direction.closed) {
+        completions.emplace_back(
+            end_, Completion{std::move(cb), Error::STREAM_NOT_WRITABLE});
+      } else if (in.empty()) {
+        completions.emplace_back(end_, Completion{std::move(cb), size_t{0}});
+      } else {
+        direction.writing.emplace(in, std::move(cb));
+        if (direction.reading) {
+          transfer(direction, completions, end_);
+        }
+      }
+    }
+    for (auto &[end, completion] : completions) {
+      post(*pipe_->io_contexts.at(end), std::move(completion));
+    }
+  }
+
+  void MemoryStream::deferWriteCallback(std::error_code ec,
+                                        WriteCallbackFunc cb) {
+    deferReadCallback(ec, std::move(cb));
+  }
+
+  bool MemoryStream::isClosedForRead() const {
+    std::unique_lock lock{pipe_->mutex};
+    return pipe_->reset or pipe_->directions[1 - end_].closed;
+  }
+
+  bool MemoryStream::isClosedForWrite() const {
+    std::unique_lock lock{pipe_->mutex};
+    return pipe_->reset or pipe_->directions[end_].closed;
+  }
+
+  bool MemoryStream::isClosed() const {
+    return isClosedForRead() and isClosedForWrite();
+  }
+
+  void MemoryStream::close(Stream::VoidResultHandlerFunc cb) {
+    std::optional<Callback> reader;
+    {
+      std::unique_lock lock{pipe_->mutex};
+      auto &direction = pipe_->directions[end_];
+      direction.closed = true;
+      if (direction.reading) {
+        reader = std::move(direction.reading->second);
+        direction.reading.reset();
+      }
+    }
+    if (reader) {
+      post(*pipe_->io_contexts.at(1 - end_),
+           Completion{std::move(*reader), Error::STREAM_CLOSED_BY_PEER});
+    }
+    cb(outcome::success());
+  }
+
+  void MemoryStream::reset() {
+    std::vector<std::pair<size_t, Completion>> completions;
+    {
+      std::unique_lock lock{pipe_->mutex};
+      if (pipe_->reset) {
+        return;
+      }
+      pipe_->reset = true;
+      auto error = [&](size_t end) {
+        return end == end_ ? Error::STREAM_RESET_BY_HOST
+                           : Error::STREAM_RESET_BY_PEER;
+      };
+      for (size_t writer = 0; writer < 2; ++writer) {
+        auto &direction = pipe_->directions.at(writer);
+        if (direction.writing) {
+          completions.emplace_back(
+              writer,
+              Completion{std::move(direction.writing->second), error(writer)});
+          direction.writing.reset();
+        }
+        if (direction.reading) {
+          auto reader = 1 - writer;
+          completions.emplace_back(
+              reader,
+              Completion{std::move(direction.reading->second), error(reader)});
+          direction.reading.reset();
+        }
+      }
+    }
+    for (auto &[end, completion] : completions) {
+      post(*pipe_->io_contexts.at(end), std::move(completion));
+    }
+  }
+
+  void MemoryStream::adjustWindowSize(uint32_t new_size,
+                                      Stream::VoidResultHandlerFunc cb) {}
+
+  outcome::result<bool> MemoryStream::isInitiator() const {
+    return end_ == 0;
+  }
+
+  outcome::result<PeerId> MemoryStream::remotePeerId() const {
+    return conn_->remotePeer();
+  }
+
+  outcome::result<Multiaddress> MemoryStream::localMultiaddr() const {
+    return conn_->localMultiaddr();
+  }
+
+  outcome::result<Multiaddress> MemoryStream::remoteMultiaddr() const {
+    return conn_->remoteMultiaddr();
+  }
+}  // namespace libp2p::connection
@@ -0,0 +1,61 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/transport/memory/transport.hpp>
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/post.hpp>
+
+#include <libp2p/peer/identity_manager.hpp>
+#include <libp2p/transport/memory/error.hpp>
+#include <libp2p/transport/memory/listener.hpp>
+
+namespace libp2p::transport {
+  MemoryTransport::MemoryTransport(
+      std::shared_ptr<boost::asio::io_context> io_context,
+      const peer::IdentityManager &id_mgr)
+      : io_context_{std::move(io_context)},
+        local_peer_{id_mgr.getId()},
+        local_key_{id_mgr.getKeyPair().publicKey} {}
+
+  void MemoryTransport::dial(const PeerId &peer,
+                             Multiaddress address,
+                             TransportAdaptor::HandlerFunc cb) {
+    using Result =
+        outcome::result<std::shared_ptr<connection::CapableConnection>>;
+    auto result = [&]() -> Result {
+      OUTCOME_TRY(id, detail::asMemory(address));
+      auto listener = MemoryListener::find(id);
+      if (not listener) {
+        return MemoryError::NO_LISTENER;
+      }
+      if (listener->peer() != peer) {
+        return MemoryError::PEER_MISMATCH;
+      }
+      OUTCOME_TRY(local, Multiaddress::create("/memory/0"));
+      return listener->accept({io_context_, local, local_peer_, local_key_});
+    }();
+    post(*io_context_,
+         [cb{std::move(cb)}, result{std::move(result)}] { cb(result); });
+  }
+
+  std::shared_ptr<TransportListener> MemoryTransport::createListener(
+      TransportListener::HandlerFunc handler) {
+    auto local = Multiaddress::create("/memory/0").value();
+    return std::make_shared<MemoryListener>(
+        MemoryConnection::Endpoint{
+            io_context_, std::move(local), local_peer_, local_key_},
+        std::move(handler));
+  }
+
+  bool MemoryTransport::canDial(const Multiaddress &ma) const {
+    return detail::asMemory(ma).has_value();
+  }
+
+  peer::ProtocolName MemoryTransport::getProtocolId() const {
+    return "/memory/1.0.0";
+  }
+}  // namespace libp2p::transport
@@ -98,7 +98,18 @@ namespace libp2p::transport {
   void QuicConnection::stop() {}
 
   void QuicConnection::newStream(CapableConnection::StreamHandlerFunc cb) {
-    cb(newStream());
+    if (not conn_ctx_) {
+      return cb(QuicError::CONN_CLOSED);
+    }
+    conn_ctx_->engine->newStream(
+        conn_ctx_,
+        [cb{std::move(cb)}](
+            outcome::result<std::shared_ptr<connection::QuicStream>> r) {
+          if (not r) {
+            return cb(r.error());
+          }
+          cb(r.value());
+        });
   }
 
   outcome::result<std::shared_ptr<libp2p::connection::Stream>>
@@ -114,7 +125,58 @@ namespace libp2p::transport {
     on_stream_ = std::move(cb);
   }
 
+  size_t QuicConnection::maxDatagramSize() const {
+    if (not conn_ctx_) {
+      return 0;
+    }
+    return conn_ctx_->engine->maxDatagramSize(conn_ctx_);
+  }
+
+  outcome::result<void> QuicConnection::sendDatagram(BytesIn datagram) {
+    if (not conn_ctx_) {
+      return QuicError::CONN_CLOSED;
+    }
+    return conn_ctx_->engine->sendDatagram(conn_ctx_, datagram);
+  }
+
+  void QuicConnection::onDatagram(DatagramHandler handler) {
+    on_datagram_ = std::move(handler);
+  }
+
+  void QuicConnection::onRemoteChanged(RemoteChangedHandler handler) {
+    on_remote_changed_ = std::move(handler);
+  }
+
   void QuicConnection::onClose() {
     conn_ctx_ = nullptr;
   }
+
+  void QuicConnection::datagramIn(BytesIn datagram) {
+    if (not on_datagram_) {
+      return;
+    }
+    post(*io_context_,
+         [weak_self{weak_from_this()}, datagram{Bytes(datagram.begin(),
+                                                      datagram.end())}] {
+           if (auto self = weak_self.lock()) {
+             if (self->on_datagram_) {
+               self->on_datagram_(datagram);
+             }
+           }
+         });
+  }
+
+  void QuicConnection::remoteChanged(Multiaddress remote) {
+    remote_ = std::move(remote);
+    if (not on_remote_changed_) {
+      return;
+    }
+    post(*io_context_, [weak_self{weak_from_this()}, remote{remote_}] {
+      if (auto self = weak_self.lock()) {
+        if (self->on_remote_changed_) {
+          self->on_remote_changed_(remote);
+        }
+      }
+    });
+  }
 }  // namespace libp2p::transport
@@ -4,7 +4,12 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+#include <algorithm>
+#include <array>
+#include <cstring>
+
 #include <boost/asio/ssl/context.hpp>
+#include <fmt/format.h>
 #include <libp2p/common/asio_buffer.hpp>
 #include <libp2p/common/asio_cb.hpp>
 #include <libp2p/muxer/muxed_connection_config.hpp>
@@ -14,18 +19,103 @@
 #include <libp2p/transport/quic/engine.hpp>
 #include <libp2p/transport/quic/error.hpp>
 #include <libp2p/transport/quic/init.hpp>
+#include <libp2p/transport/quic/send_batch.hpp>
 #include <libp2p/transport/quic/stream.hpp>
 #include <libp2p/transport/tcp/tcp_util.hpp>
+#include <openssl/rand.h>
 #include <qtils/option_take.hpp>
 
+#ifdef __linux__
+#include <netinet/udp.h>
+#include <sys/socket.h>
+#ifndef UDP_SEGMENT
+#define UDP_SEGMENT 103
+#endif
+#ifndef UDP_GRO
+#define UDP_GRO 104
+#endif
+#endif
+
 namespace libp2p::transport::lsquic {
+  namespace {
+    /// Peer address of current path of connection
+    boost::asio::ip::udp::endpoint peerEndpoint(lsquic_conn_t *conn) {
+      boost::asio::ip::udp::endpoint endpoint;
+      const sockaddr *local = nullptr;
+      const sockaddr *peer = nullptr;
+      if (lsquic_conn_get_sockaddr(conn, &local, &peer) == 0
+          and peer != nullptr) {
+        auto len = peer->sa_family == AF_INET ? sizeof(sockaddr_in)
+                                              : sizeof(sockaddr_in6);
+        memcpy(endpoint.data(), peer, len);
+      }
+      return endpoint;
+    }
+  }  // namespace
+
+  lsquic_engine_settings engineSettings(
+      const muxer::MuxedConnectionConfig &mux_config,
+      const QuicConfig &config,
+      unsigned flags) {
+    lsquic_engine_settings settings{};
+    lsquic_engine_init_settings(&settings, flags);
+    auto or_default = [](auto value, auto fallback) {
+      return value != decltype(value){} ? value : fallback;
+    };
+    auto stream_window =
+        or_default(config.initial_stream_window, mux_config.maximum_window_size);
+    settings.es_init_max_stream_data_bidi_remote = stream_window;
+    settings.es_init_max_stream_data_bidi_local = stream_window;
+    settings.es_init_max_streams_bidi =
+        or_default(config.max_streams, mux_config.maximum_streams);
+    settings.es_idle_timeout =
+        or_default(config.idle_timeout,
+                   std::chrono::duration_cast<std::chrono::seconds>(
+                       mux_config.no_streams_interval))
+            .count();
+    settings.es_handshake_to =
+        std::chrono::microseconds{mux_config.dial_timeout}.count();
+    if (config.congestion_control != QuicCongestionControl::DEFAULT) {
+      settings.es_cc_algo = static_cast<unsigned>(config.congestion_control);
+    }
+    settings.es_pace_packets = config.pacing ? 1 : 0;
+    settings.es_datagrams = config.datagrams ? 1 : 0;
+    settings.es_allow_migration = config.migration ? 1 : 0;
+    if (config.max_stream_window != 0) {
+      settings.es_max_sfcw = config.max_stream_window;
+    }
+    if (config.initial_connection_window != 0) {
+      settings.es_init_max_data = config.initial_connection_window;
+    }
+    if (config.max_connection_window != 0) {
+      settings.es_max_cfcw = config.max_connection_window;
+    }
+    if (config.base_packet_size != 0) {
+      settings.es_base_plpmtu = config.base_packet_size;
+    }
+    if (config.max_packet_size != 0) {
+      settings.es_max_plpmtu = config.max_packet_size;
+    }
+    std::array<char, 256> settings_error{};
+    if (lsquic_engine_check_settings(
+            &settings, flags, settings_error.data(), settings_error.size())
+        != 0) {
+      throw std::invalid_argument{
+          fmt::format("invalid quic settings: {}", settings_error.data())};
+    }
+    return settings;
+  }
+
   Engine::Engine(std::shared_ptr<boost::asio::io_context> io_context,
                  std::shared_ptr<boost::asio::ssl::context> ssl_context,
                  const muxer::MuxedConnectionConfig &mux_config,
+                 const QuicConfig &config,
                  PeerId local_peer,
                  std::shared_ptr<crypto::marshaller::KeyMarshaller> key_codec,
                  boost::asio::ip::udp::socket &&socket,
-                 bool client)
+                 bool client,
+                 size_t cid_index,
+                 size_t cid_count)
       : io_context_{std::move(io_context)},
         ssl_context_{std::move(ssl_context)},
         local_peer_{std::move(local_peer)},
@@ -33,8 +123,29 @@ namespace libp2p::transport::lsquic {
         socket_{std::move(socket)},
         timer_{*io_context_},
         socket_local_{socket_.local_endpoint()},
-        local_{detail::makeQuicAddr(socket_local_).value()} {
+        local_{detail::makeQuicAddr(socket_local_).value()},
+        cid_index_{cid_index},
+        cid_count_{cid_count},
+        early_data_{config.early_data} {
     socket_.non_blocking(true);
+#ifdef __linux__
+    int on = 1;
+    gro_ = setsockopt(
+               socket_.native_handle(), SOL_UDP, UDP_GRO, &on, sizeof(on))
+        == 0;
+    int segment = 0;
+    socklen_t segment_len = sizeof(segment);
+    gso_ = getsockopt(socket_.native_handle(),
+                      SOL_UDP,
+                      UDP_SEGMENT,
+                      &segment,
+                      &segment_len)
+        == 0;
+#endif
+
+    // servers accept 0-RTT data only when it is opted in
+    SSL_CTX_set_early_data_enabled(ssl_context_->native_handle(),
+                                   early_data_ ? 1 : 0);
 
     lsquicInit();
 
@@ -43,18 +154,7 @@ namespace libp2p::transport::lsquic {
       flags |= LSENG_SERVER;
     }
 
-    lsquic_engine_settings settings{};
-    lsquic_engine_init_settings(&settings, flags);
-    settings.es_init_max_stream_data_bidi_remote =
-        mux_config.maximum_window_size;
-    settings.es_init_max_stream_data_bidi_local =
-        mux_config.maximum_window_size;
-    settings.es_init_max_streams_bidi = mux_config.maximum_streams;
-    settings.es_idle_timeout = std::chrono::duration_cast<std::chrono::seconds>(
-                                   mux_config.no_streams_interval)
-                                   .count();
-    settings.es_handshake_to =
-        std::chrono::microseconds{mux_config.dial_timeout}.count();
+    auto settings = engineSettings(mux_config, config, flags);
 
     static lsquic_stream_if stream_if{};
     stream_if.on_new_conn = +[](void *void_self, lsquic_conn_t *conn) {
@@ -62,11 +162,32 @@ namespace libp2p::transport::lsquic {
       auto op = qtils::optionTake(self->connecting_);
       // NOLINTNEXTLINE(cppcoreguidelines-owning-memory)
       auto conn_ctx = new ConnCtx{self, conn, std::move(op)};
+      conn_ctx->remote = peerEndpoint(conn);
       // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
       auto _conn_ctx = reinterpret_cast<lsquic_conn_ctx_t *>(conn_ctx);
       lsquic_conn_set_ctx(conn, _conn_ctx);
-      if (not op) {
+      if (not conn_ctx->connecting) {
         stream_if.on_hsk_done(conn, LSQ_HSK_OK);
+        return _conn_ctx;
+      }
+      conn_ctx->peer = conn_ctx->connecting->peer;
+      if (conn_ctx->connecting->early_key) {
+        // identity was verified by the connection which issued the ticket,
+        // handshake verifies it again
+        auto op = qtils::optionTake(conn_ctx->connecting).value();
+        auto quic_conn = std::make_shared<QuicConnection>(
+            self->io_context_,
+            conn_ctx,
+            true,
+            self->local_,
+            detail::makeQuicAddr(op.remote).value(),
+            self->local_peer_,
+            op.peer,
+            *op.early_key);
+        conn_ctx->conn = quic_conn;
+        conn_ctx->early = true;
+        post(*self->io_context_,
+             [cb{std::move(op.cb)}, quic_conn] { cb(quic_conn); });
       }
       return _conn_ctx;
     };
@@ -76,6 +197,10 @@ namespace libp2p::transport::lsquic {
       if (auto op = qtils::optionTake(conn_ctx->connecting)) {
         op->cb(QuicError::CONN_CLOSED);
       }
+      for (auto &cb : conn_ctx->pending_streams) {
+        cb(QuicError::CONN_CLOSED);
+      }
+      conn_ctx->pending_streams.clear();
       if (auto conn = conn_ctx->conn.lock()) {
         conn->onClose();
       }
@@ -89,6 +214,23 @@ namespace libp2p::transport::lsquic {
       auto self = conn_ctx->engine;
       auto ok = status == LSQ_HSK_OK or status == LSQ_HSK_RESUMED_OK;
       auto op = qtils::optionTake(conn_ctx->connecting);
+      if (conn_ctx->early) {
+        // connection was already reported, check the peer is the same
+        auto early = conn_ctx->conn.lock();
+        auto verified = [&] {
+          if (not ok or not early) {
+            return false;
+          }
+          auto cert = SSL_get_peer_certificate(lsquic_conn_ssl(conn));
+          auto info = security::tls_details::verifyPeerAndExtractIdentity(
+              cert, *self->key_codec_);
+          return info and info.value().peer_id == early->remotePeer().value();
+        }();
+        if (not verified) {
+          lsquic_conn_close(conn);
+        }
+        return;
+      }
       auto res = [&]() -> outcome::result<std::shared_ptr<QuicConnection>> {
         if (not ok) {
           return QuicError::HANDSHAKE_FAILED;
@@ -105,7 +247,7 @@ namespace libp2p::transport::lsquic {
             conn_ctx,
             op.has_value(),
             self->local_,
-            detail::makeQuicAddr(op->remote).value(),
+            detail::makeQuicAddr(conn_ctx->remote).value(),
             self->local_peer_,
             info.peer_id,
             info.public_key);
@@ -129,11 +271,19 @@ namespace libp2p::transport::lsquic {
       // NOLINTNEXTLINE(cppcoreguidelines-owning-memory)
       auto stream_ctx = new StreamCtx{self, stream};
       if (auto conn = conn_ctx->conn.lock()) {
-        auto stream = std::make_shared<QuicStream>(
-            conn, stream_ctx, conn_ctx->new_stream.has_value());
+        // stream requested before handshake, created by lsquic after it
+        auto local = conn_ctx->new_stream.has_value()
+                  or (not conn_ctx->pending_streams.empty()
+                      and (lsquic_stream_id(stream) & 1)
+                              == (conn->isInitiator() ? 0 : 1));
+        auto stream = std::make_shared<QuicStream>(conn, stream_ctx, local);
         stream_ctx->stream = stream;
         if (conn_ctx->new_stream) {
           *conn_ctx->new_stream = stream;
+        } else if (local) {
+          auto cb = std::move(conn_ctx->pending_streams.front());
+          conn_ctx->pending_streams.pop_front();
+          post(*self->io_context_, [cb{std::move(cb)}, stream] { cb(stream); });
         } else {
           conn->onStream()(stream);
         }
@@ -143,6 +293,22 @@ namespace libp2p::transport::lsquic {
       // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
       return reinterpret_cast<lsquic_stream_ctx_t *>(stream_ctx);
     };
+    stream_if.on_sess_resume_info =
+        +[](lsquic_conn_t *conn, const unsigned char *buf, size_t size) {
+          // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+          auto conn_ctx =
+              reinterpret_cast<ConnCtx *>(lsquic_conn_get_ctx(conn));
+          if (not conn_ctx or not conn_ctx->peer) {
+            return;
+          }
+          auto quic_conn = conn_ctx->conn.lock();
+          if (not quic_conn) {
+            return;
+          }
+          conn_ctx->engine->cacheSessionTicket(
+              *conn_ctx->peer,
+              {Bytes{buf, buf + size}, quic_conn->remotePublicKey().value()});
+        };
     stream_if.on_close =
         +[](lsquic_stream_t *stream, lsquic_stream_ctx_t *_stream_ctx) {
           // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
@@ -161,16 +327,62 @@ namespace libp2p::transport::lsquic {
           lsquic_stream_wantread(stream, 0);
           // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
           auto stream_ctx = reinterpret_cast<StreamCtx *>(_stream_ctx);
-          auto op = qtils::optionTake(stream_ctx->reading).value();
-          auto n = lsquic_stream_read(stream, op.out.data(), op.out.size());
+          auto &op = stream_ctx->reading.value();
+          auto rest = op.out.subspan(op.done);
+          auto n = lsquic_stream_read(stream, rest.data(), rest.size());
+          if (n == -1 and errno == EWOULDBLOCK) {
+            lsquic_stream_wantread(stream, 1);
+            return;
+          }
           outcome::result<size_t> r = QuicError::STREAM_CLOSED;
           if (n > 0) {
-            r = n;
+            op.done += n;
+            if (op.all and op.done < op.out.size()) {
+              // the rest is not received yet, don't wake reader up until then
+              lsquic_stream_wantread(stream, 1);
+              return;
+            }
+            r = op.done;
           }
+          auto cb = std::move(op.cb);
+          stream_ctx->reading.reset();
           post(*stream_ctx->engine->io_context_,
-               [cb{std::move(op.cb)}, r] { cb(r); });
+               [cb{std::move(cb)}, r] { cb(r); });
         };
 
+    stream_if.on_datagram =
+        +[](lsquic_conn_t *conn, const void *buf, size_t size) {
+          // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+          auto conn_ctx =
+              reinterpret_cast<ConnCtx *>(lsquic_conn_get_ctx(conn));
+          if (auto quic_conn = conn_ctx->conn.lock()) {
+            quic_conn->datagramIn(
+                BytesIn{static_cast<const uint8_t *>(buf), size});
+          }
+        };
+    stream_if.on_dg_write =
+        +[](lsquic_conn_t *conn, void *buf, size_t size) -> ssize_t {
+      // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+      auto conn_ctx = reinterpret_cast<ConnCtx *>(lsquic_conn_get_ctx(conn));
+      auto &queue = conn_ctx->datagrams;
+      // packet has less space than checked by sendDatagram, e.g. on
+      // smaller path MTU
+      while (not queue.empty() and queue.front().size() > size) {
+        queue.pop_front();
+      }
+      if (queue.empty()) {
+        lsquic_conn_want_datagram_write(conn, 0);
+        return -1;
+      }
+      auto datagram = std::move(queue.front());
+      queue.pop_front();
+      memcpy(buf, datagram.data(), datagram.size());
+      if (queue.empty()) {
+        lsquic_conn_want_datagram_write(conn, 0);
+      }
+      return static_cast<ssize_t>(datagram.size());
+    };
+
     lsquic_engine_api api{};
     api.ea_settings = &settings;
 
@@ -179,42 +391,25 @@ namespace libp2p::transport::lsquic {
     api.ea_packets_out = +[](void *void_self,
                              const lsquic_out_spec *out_spec,
                              unsigned n_packets_out) {
-      auto self = static_cast<Engine *>(void_self);
-      // https://github.com/cbodley/nexus/blob/d1d8486f713fd089917331239d755932c7c8ed8e/src/socket.cc#L218
-      int r = 0;
-      for (auto &spec : std::span{out_spec, n_packets_out}) {
-        msghdr msg{};
-        msg.msg_iov = spec.iov;
-        msg.msg_iovlen = spec.iovlen;
-        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
-        msg.msg_name = const_cast<sockaddr *>(spec.dest_sa);
-        msg.msg_namelen = spec.dest_sa->sa_family == AF_INET
-                            ? sizeof(sockaddr_in)
-                            : sizeof(sockaddr_in6);
-        auto n = sendmsg(self->socket_.native_handle(), &msg, 0);
-        if (n == -1) {
-          if (errno == EAGAIN or errno == EWOULDBLOCK) {
-            auto cb = [weak_self{self->weak_from_this()}](
-                          boost::system::error_code ec) {
-              auto self = weak_self.lock();
-              if (not self) {
-                return;
-              }
-              if (ec) {
-                return;
-              }
-              lsquic_engine_send_unsent_packets(self->engine_);
-            };
-            self->socket_.async_wait(boost::asio::socket_base::wait_write,
-                                     std::move(cb));
-          }
-          break;
-        }
-        ++r;
-      }
-      return r;
+      return static_cast<Engine *>(void_self)->packetsOut(
+          std::span{out_spec, n_packets_out});
     };
     api.ea_packets_out_ctx = this;
+    if (cid_count_ > 1) {
+      api.ea_generate_scid = +[](void *void_self,
+                                 lsquic_conn_t *,
+                                 lsquic_cid_t *cid,
+                                 unsigned len) {
+        auto self = static_cast<Engine *>(void_self);
+        cid->len = len;
+        RAND_bytes(cid->idbuf, static_cast<int>(len));
+        if (len != 0) {
+          auto n = self->cid_count_;
+          cid->idbuf[0] = cid->idbuf[0] % (256 / n) * n + self->cid_index_;
+        }
+      };
+      api.ea_gen_scid_ctx = this;
+    }
     api.ea_get_ssl_ctx = +[](void *void_self, const sockaddr *) {
       auto self = static_cast<Engine *>(void_self);
       return self->ssl_context_->native_handle();
@@ -246,6 +441,14 @@ namespace libp2p::transport::lsquic {
     }
     connecting_ = Connecting{remote, peer, std::move(cb)};
     start();
+    std::optional<SessionTicket> ticket;
+    if (auto it = session_tickets_.find(peer); it != session_tickets_.end()) {
+      ticket = std::move(it->second);
+      session_tickets_.erase(it);
+      if (early_data_) {
+        connecting_->early_key = ticket->key;
+      }
+    }
     lsquic_engine_connect(engine_,
                           N_LSQVER,
                           socket_local_.data(),
@@ -254,8 +457,8 @@ namespace libp2p::transport::lsquic {
                           nullptr,
                           nullptr,
                           0,
-                          nullptr,
-                          0,
+                          ticket ? ticket->resume.data() : nullptr,
+                          ticket ? ticket->resume.size() : 0,
                           nullptr,
                           0);
     if (auto op = qtils::optionTake(connecting_)) {
@@ -264,6 +467,61 @@ namespace libp2p::transport::lsquic {
     process();
   }
 
+  void Engine::newStream(ConnCtx *conn_ctx, OnNewStream cb) {
+    auto pending = lsquic_conn_n_pending_streams(conn_ctx->ls_conn);
+    if (conn_ctx->new_stream) {
+      throw std::logic_error{"Engine::newStream invalid state"};
+    }
+    conn_ctx->new_stream.emplace();
+    lsquic_conn_make_stream(conn_ctx->ls_conn);
+    auto stream = qtils::optionTake(conn_ctx->new_stream).value();
+    if (not stream
+        and lsquic_conn_n_pending_streams(conn_ctx->ls_conn) > pending) {
+      // e.g. before handshake, on_new_stream will be called later
+      conn_ctx->pending_streams.emplace_back(std::move(cb));
+      return;
+    }
+    outcome::result<std::shared_ptr<QuicStream>> r =
+        QuicError::CANT_OPEN_STREAM;
+    if (stream) {
+      r = stream;
+    }
+    post(*io_context_, [cb{std::move(cb)}, r] { cb(r); });
+  }
+
+  size_t Engine::maxDatagramSize(ConnCtx *conn_ctx) const {
+    // keeps current state, fails if datagrams were not negotiated
+    auto want = conn_ctx->datagrams.empty() ? 0 : 1;
+    if (lsquic_conn_want_datagram_write(conn_ctx->ls_conn, want) < 0) {
+      return 0;
+    }
+    return kMaxDatagramSize;
+  }
+
+  outcome::result<void> Engine::sendDatagram(ConnCtx *conn_ctx,
+                                             BytesIn datagram) {
+    if (datagram.size() > kMaxDatagramSize) {
+      return QuicError::DATAGRAM_TOO_LARGE;
+    }
+    if (lsquic_conn_want_datagram_write(conn_ctx->ls_conn, 1) < 0) {
+      return QuicError::DATAGRAMS_UNSUPPORTED;
+    }
+    if (conn_ctx->datagrams.size() >= kMaxQueuedDatagrams) {
+      conn_ctx->datagrams.pop_front();
+    }
+    conn_ctx->datagrams.emplace_back(datagram.begin(), datagram.end());
+    process();
+    return outcome::success();
+  }
+
+  void Engine::cacheSessionTicket(const PeerId &peer, SessionTicket ticket) {
+    if (session_tickets_.size() >= kMaxSessionTickets
+        and not session_tickets_.contains(peer)) {
+      session_tickets_.erase(session_tickets_.begin());
+    }
+    session_tickets_.insert_or_assign(peer, std::move(ticket));
+  }
+
   outcome::result<std::shared_ptr<QuicStream>> Engine::newStream(
       ConnCtx *conn_ctx) {
     if (conn_ctx->new_stream) {
@@ -304,13 +562,32 @@ namespace libp2p::transport::lsquic {
   void Engine::readLoop() {
     // https://github.com/cbodley/nexus/blob/d1d8486f713fd089917331239d755932c7c8ed8e/src/socket.cc#L293
     while (true) {
-      socklen_t len = socket_local_.size();
+#ifdef __linux__
+      std::array<mmsghdr, Reading::kBatch> msgs{};
+      std::array<iovec, Reading::kBatch> iovs{};
+      std::array<std::array<char, CMSG_SPACE(sizeof(int))>, Reading::kBatch>
+          controls{};
+      for (size_t i = 0; i < Reading::kBatch; ++i) {
+        iovs[i] = {reading_.bufs[i].data(), reading_.bufs[i].size()};
+        auto &hdr = msgs[i].msg_hdr;
+        hdr.msg_iov = &iovs[i];
+        hdr.msg_iovlen = 1;
+        hdr.msg_name = reading_.remotes[i].data();
+        hdr.msg_namelen = reading_.remotes[i].capacity();
+        hdr.msg_control = controls[i].data();
+        hdr.msg_controllen = controls[i].size();
+      }
+      auto n = recvmmsg(
+          socket_.native_handle(), msgs.data(), msgs.size(), 0, nullptr);
+#else
+      socklen_t len = reading_.remotes[0].capacity();
       auto n = recvfrom(socket_.native_handle(),
-                        reading_.buf.data(),
-                        reading_.buf.size(),
+                        reading_.bufs[0].data(),
+                        reading_.bufs[0].size(),
                         0,
-                        reading_.remote.data(),
+                        reading_.remotes[0].data(),
                         &len);
+#endif
       if (n == -1) {
         if (errno == EAGAIN or errno == EWOULDBLOCK) {
           auto cb =
@@ -329,14 +606,123 @@ namespace libp2p::transport::lsquic {
         }
         return;
       }
+#ifdef __linux__
+      for (size_t i = 0; i < static_cast<size_t>(n); ++i) {
+        size_t segment_size = 0;
+        auto &hdr = msgs[i].msg_hdr;
+        for (auto cmsg = CMSG_FIRSTHDR(&hdr); cmsg != nullptr;
+             cmsg = CMSG_NXTHDR(&hdr, cmsg)) {
+          if (cmsg->cmsg_level == SOL_UDP and cmsg->cmsg_type == UDP_GRO) {
+            int gro = 0;
+            memcpy(&gro, CMSG_DATA(cmsg), sizeof(gro));
+            segment_size = gro;
+          }
+        }
+        packetIn(BytesIn{reading_.bufs[i]}.first(msgs[i].msg_len),
+                 segment_size,
+                 reading_.remotes[i]);
+      }
+#else
+      packetIn(BytesIn{reading_.bufs[0]}.first(n), 0, reading_.remotes[0]);
+#endif
+      // one pass over connections per batch of datagrams
+      process();
+    }
+  }
+
+  void Engine::packetIn(BytesIn datagram,
+                        size_t segment_size,
+                        const boost::asio::ip::udp::endpoint &remote) {
+    if (admit_remote_ and not admit_remote_(remote.address())) {
+      return;
+    }
+    if (segment_size == 0) {
+      segment_size = datagram.size();
+    }
+    while (not datagram.empty()) {
+      auto packet = datagram.first(std::min(segment_size, datagram.size()));
+      datagram = datagram.subspan(packet.size());
       lsquic_engine_packet_in(engine_,
-                              reading_.buf.data(),
-                              n,
+                              packet.data(),
+                              packet.size(),
                               socket_local_.data(),
-                              reading_.remote.data(),
+                              remote.data(),
                               this,
                               0);
-      process();
     }
   }
+
+  void Engine::checkPath(ConnCtx *conn_ctx) {
+    auto remote = peerEndpoint(conn_ctx->ls_conn);
+    if (remote == conn_ctx->remote or remote.port() == 0) {
+      // packets probe new path, which is not validated yet
+      return;
+    }
+    conn_ctx->remote = remote;
+    auto quic_conn = conn_ctx->conn.lock();
+    if (not quic_conn) {
+      return;
+    }
+    if (auto addr = detail::makeQuicAddr(remote)) {
+      quic_conn->remoteChanged(std::move(addr.value()));
+    }
+  }
+
+  int Engine::packetsOut(std::span<const lsquic_out_spec> specs) {
+    for (auto &spec : specs) {
+      // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+      auto conn_ctx = reinterpret_cast<ConnCtx *>(spec.conn_ctx);
+      // mini connections of handshake have no context yet
+      if (conn_ctx != nullptr
+          and (spec.dest_sa->sa_family != conn_ctx->remote.data()->sa_family
+               or memcmp(spec.dest_sa,
+                         conn_ctx->remote.data(),
+                         conn_ctx->remote.size())
+                      != 0)) {
+        checkPath(conn_ctx);
+      }
+    }
+    // https://github.com/cbodley/nexus/blob/d1d8486f713fd089917331239d755932c7c8ed8e/src/socket.cc#L218
+    auto wait_write = [&] {
+      auto cb = [weak_self{weak_from_this()}](boost::system::error_code ec) {
+        auto self = weak_self.lock();
+        if (not self) {
+          return;
+        }
+        if (ec) {
+          return;
+        }
+        lsquic_engine_send_unsent_packets(self->engine_);
+      };
+      socket_.async_wait(boost::asio::socket_base::wait_write, std::move(cb));
+    };
+#ifdef __linux__
+    auto result = sendBatch(specs, gso_, [&](mmsghdr *msgs, unsigned n) {
+      return sendmmsg(socket_.native_handle(), msgs, n, 0);
+    });
+#else
+    SendBatchResult result;
+    for (auto &spec : specs) {
+      msghdr msg{};
+      msg.msg_iov = spec.iov;
+      msg.msg_iovlen = spec.iovlen;
+      // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+      msg.msg_name = const_cast<sockaddr *>(spec.dest_sa);
+      msg.msg_namelen = sockaddrLen(spec.dest_sa);
+      if (sendmsg(socket_.native_handle(), &msg, 0) == -1) {
+        if (errno == EAGAIN or errno == EWOULDBLOCK) {
+          result.wait_writable = true;
+          break;
+        }
+        // dropped as lost on the path, see `sendBatch`
+        ++result.dropped;
+      }
+      ++result.sent;
+    }
+#endif
+    if (result.wait_writable) {
+      wait_write();
+    }
+    return static_cast<int>(result.sent);
+  }
 }  // namespace libp2p::transport::lsquic
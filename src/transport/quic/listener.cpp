@@ -4,47 +4,146 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+#include <boost/asio/executor_work_guard.hpp>
+#include <boost/asio/io_context.hpp>
+#include <libp2p/network/connection_gater.hpp>
 #include <libp2p/transport/quic/connection.hpp>
 #include <libp2p/transport/quic/engine.hpp>
 #include <libp2p/transport/quic/listener.hpp>
+#include <libp2p/transport/socket_option.hpp>
 #include <libp2p/transport/tcp/tcp_util.hpp>
 
+#ifdef __linux__
+#include <linux/filter.h>
+#include <sys/socket.h>
+#ifndef SO_ATTACH_REUSEPORT_CBPF
+#define SO_ATTACH_REUSEPORT_CBPF 51
+#endif
+#endif
+
 namespace libp2p::transport {
+  namespace {
+    using ReusePort = IntegerSocketOption<SOL_SOCKET, SO_REUSEPORT>;
+
+    /**
+     * Selects socket of SO_REUSEPORT group by the 1st byte of short header
+     * packet connection id, which engines set to their index.
+     * Long header packets, i.e. handshake, fall back to 4-tuple hash.
+     */
+    void attachCidSteering(boost::asio::ip::udp::socket &socket, size_t n) {
+#ifdef __linux__
+      std::array<sock_filter, 6> code{{
+          // A = packet[0]
+          {BPF_LD | BPF_B | BPF_ABS, 0, 0, 0},
+          // long header
+          {BPF_JMP | BPF_JSET | BPF_K, 3, 0, 0x80},
+          // A = 1st byte of connection id
+          {BPF_LD | BPF_B | BPF_ABS, 0, 0, 1},
+          {BPF_ALU | BPF_MOD | BPF_K, 0, 0, static_cast<uint32_t>(n)},
+          {BPF_RET | BPF_A, 0, 0, 0},
+          // out of range index, kernel uses hash
+          {BPF_RET | BPF_K, 0, 0, 0xffffffff},
+      }};
+      sock_fprog prog{static_cast<unsigned short>(code.size()), code.data()};
+      // best effort, kernel hash still keeps 4-tuple on one socket
+      std::ignore = setsockopt(socket.native_handle(),
+                               SOL_SOCKET,
+                               SO_ATTACH_REUSEPORT_CBPF,
+                               &prog,
+                               sizeof(prog));
+#endif
+    }
+  }  // namespace
+
   QuicListener::QuicListener(
       std::shared_ptr<boost::asio::io_context> io_context,
       std::shared_ptr<boost::asio::ssl::context> ssl_context,
       const muxer::MuxedConnectionConfig &mux_config,
+      const QuicConfig &config,
       PeerId local_peer,
       std::shared_ptr<crypto::marshaller::KeyMarshaller> key_codec,
+      std::shared_ptr<network::ConnectionGater> gater,
       TransportListener::HandlerFunc handler)
       : io_context_{std::move(io_context)},
         ssl_context_{std::move(ssl_context)},
         mux_config_{mux_config},
+        config_{config},
         local_peer_{std::move(local_peer)},
         key_codec_{std::move(key_codec)},
+        gater_{std::move(gater)},
         handler_{std::move(handler)} {}
 
+  QuicListener::~QuicListener() {
+    std::ignore = close();
+  }
+
   outcome::result<void> QuicListener::listen(const Multiaddress &address) {
     OUTCOME_TRY(info, detail::asQuic(address));
-    if (server_) {
+    if (not servers_.empty()) {
       return std::errc::already_connected;
     }
     OUTCOME_TRY(endpoint, info.asUdp());
-    boost::asio::ip::udp::socket socket{*io_context_, endpoint.protocol()};
-    boost::system::error_code ec;
-    socket.bind(endpoint, ec);
-    if (ec) {
-      return ec;
+    // connection ids steer by 1st byte
+    auto n = std::clamp<size_t>(config_.listen_sockets, 1, 256);
+    std::vector<std::shared_ptr<boost::asio::io_context>> ios;
+    std::vector<boost::asio::ip::udp::socket> sockets;
+    for (size_t i = 0; i < n; ++i) {
+      auto io = i == 0 or not config_.listen_threads
+                  ? io_context_
+                  : std::make_shared<boost::asio::io_context>();
+      boost::asio::ip::udp::socket socket{*io, endpoint.protocol()};
+      boost::system::error_code ec;
+      if (n > 1) {
+        socket.set_option(ReusePort{1}, ec);
+        if (ec) {
+          return ec;
+        }
+      }
+      socket.bind(endpoint, ec);
+      if (ec) {
+        return ec;
+      }
+      if (i == 0) {
+        // other sockets join the group on the same, maybe ephemeral, port
+        endpoint = socket.local_endpoint();
+        if (n > 1) {
+          attachCidSteering(socket, n);
+        }
+      }
+      ios.emplace_back(std::move(io));
+      sockets.emplace_back(std::move(socket));
+    }
+    for (size_t i = 0; i < n; ++i) {
+      auto server = std::make_shared<lsquic::Engine>(ios[i],
+                                                     ssl_context_,
+                                                     mux_config_,
+                                                     config_,
+                                                     local_peer_,
+                                                     key_codec_,
+                                                     std::move(sockets[i]),
+                                                     false,
+                                                     i,
+                                                     n);
+      server->onAccept(handler_);
+      if (gater_ != nullptr) {
+        // engines run on own threads, gater is thread-safe
+        server->admitRemote(
+            [gater{gater_}](const boost::asio::ip::address &address) {
+              return gater->allowAccept(address);
+            });
+      }
+      servers_.emplace_back(server);
+      if (ios[i] == io_context_) {
+        server->start();
+        continue;
+      }
+      post(*ios[i], [server] { server->start(); });
+      worker_io_.emplace_back(ios[i]);
+      workers_.emplace_back([io{ios[i]}] {
+        auto work = boost::asio::make_work_guard(*io);
+        io->run();
+      });
     }
-    server_ = std::make_shared<lsquic::Engine>(io_context_,
-                                               ssl_context_,
-                                               mux_config_,
-                                               local_peer_,
-                                               key_codec_,
-                                               std::move(socket),
-                                               false);
-    server_->onAccept(handler_);
-    server_->start();
     return outcome::success();
   }
 
@@ -53,18 +152,27 @@ namespace libp2p::transport {
   }
 
   outcome::result<Multiaddress> QuicListener::getListenMultiaddr() const {
-    if (not server_) {
+    if (servers_.empty()) {
       return std::errc::not_connected;
     }
-    return server_->local();
+    return servers_.front()->local();
   }
 
   bool QuicListener::isClosed() const {
-    return not server_;
+    return servers_.empty();
   }
 
   outcome::result<void> QuicListener::close() {
-    server_.reset();
+    for (auto &io : worker_io_) {
+      io->stop();
+    }
+    for (auto &worker : workers_) {
+      worker.join();
+    }
+    workers_.clear();
+    // engines of workers are destroyed after their threads stopped
+    servers_.clear();
+    worker_io_.clear();
     return outcome::success();
   }
 }  // namespace libp2p::transport
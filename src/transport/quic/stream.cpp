@@ -5,7 +5,6 @@
  */
 
 #include <lsquic.h>
-#include <libp2p/basic/read_return_size.hpp>
 #include <libp2p/common/ambigous_size.hpp>
 #include <libp2p/transport/quic/connection.hpp>
 #include <libp2p/transport/quic/engine.hpp>
@@ -30,7 +29,32 @@ namespace libp2p::connection {
                         size_t bytes,
                         basic::Reader::ReadCallbackFunc cb) {
     ambigousSize(out, bytes);
-    readReturnSize(shared_from_this(), out, std::move(cb));
+    outcome::result<size_t> r = QuicError::STREAM_CLOSED;
+    if (not stream_ctx_) {
+      return cb(r);
+    }
+    if (stream_ctx_->reading) {
+      throw std::logic_error{"QuicStream::read already in progress"};
+    }
+    // drain what is already received, then keep reading into the rest of
+    // buffer from `on_read` without waking caller up per chunk
+    size_t done = 0;
+    while (done < out.size()) {
+      auto rest = out.subspan(done);
+      auto n =
+          lsquic_stream_read(stream_ctx_->ls_stream, rest.data(), rest.size());
+      if (n == -1 and errno == EWOULDBLOCK) {
+        stream_ctx_->reading.emplace(
+            StreamCtx::Reading{out, std::move(cb), true, done});
+        lsquic_stream_wantread(stream_ctx_->ls_stream, 1);
+        return;
+      }
+      if (n <= 0) {
+        return deferReadCallback(r, std::move(cb));
+      }
+      done += n;
+    }
+    deferReadCallback(done, std::move(cb));
   }
 
   void QuicStream::readSome(BytesOut out,
@@ -77,6 +101,28 @@ namespace libp2p::connection {
     deferReadCallback(r, std::move(cb));
   }
 
+  void QuicStream::writeSomeVectored(std::span<const BytesIn> in,
+                                     basic::Writer::WriteCallbackFunc cb) {
+    outcome::result<size_t> r = QuicError::STREAM_CLOSED;
+    if (not stream_ctx_) {
+      return cb(r);
+    }
+    std::vector<iovec> iov;
+    iov.reserve(in.size());
+    for (auto &buffer : in) {
+      // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+      iov.emplace_back(
+          iovec{const_cast<uint8_t *>(buffer.data()), buffer.size()});
+    }
+    auto n = lsquic_stream_writev(
+        stream_ctx_->ls_stream, iov.data(), static_cast<int>(iov.size()));
+    if (n > 0 and lsquic_stream_flush(stream_ctx_->ls_stream) == 0) {
+      r = n;
+    }
+    stream_ctx_->engine->process();
+    deferReadCallback(r, std::move(cb));
+  }
+
   void QuicStream::deferWriteCallback(std::error_code ec,
                                       WriteCallbackFunc cb) {
     conn_->deferWriteCallback(ec, std::move(cb));
@@ -4,6 +4,8 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+#include <libp2p/common/metrics/startup.hpp>
+#include <libp2p/network/cares/ares_channel.hpp>
 #include <libp2p/peer/identity_manager.hpp>
 #include <libp2p/security/tls/ssl_context.hpp>
 #include <libp2p/transport/quic/connection.hpp>
@@ -17,16 +19,39 @@ namespace libp2p::transport {
       std::shared_ptr<boost::asio::io_context> io_context,
       const security::SslContext &ssl_context,
       const muxer::MuxedConnectionConfig &mux_config,
+      const QuicConfig &config,
       const peer::IdentityManager &id_mgr,
-      std::shared_ptr<crypto::marshaller::KeyMarshaller> key_codec)
+      std::shared_ptr<crypto::marshaller::KeyMarshaller> key_codec,
+      std::shared_ptr<network::c_ares::AresChannel> ares)
+      : QuicTransport{std::move(io_context),
+                      ssl_context,
+                      mux_config,
+                      config,
+                      id_mgr,
+                      std::move(key_codec),
+                      std::move(ares),
+                      nullptr} {}
+
+  QuicTransport::QuicTransport(
+      std::shared_ptr<boost::asio::io_context> io_context,
+      const security::SslContext &ssl_context,
+      const muxer::MuxedConnectionConfig &mux_config,
+      const QuicConfig &config,
+      const peer::IdentityManager &id_mgr,
+      std::shared_ptr<crypto::marshaller::KeyMarshaller> key_codec,
+      std::shared_ptr<network::c_ares::AresChannel> ares,
+      std::shared_ptr<network::ConnectionGater> gater)
       : io_context_{std::move(io_context)},
-        ssl_context_{ssl_context.quic},
+        ssl_context_{ssl_context},
         mux_config_{mux_config},
+        config_{config},
         local_peer_{id_mgr.getId()},
         key_codec_{std::move(key_codec)},
+        ares_{std::move(ares)},
+        gater_{std::move(gater)},
         resolver_{*io_context_},
-        client4_{makeClient(boost::asio::ip::udp::v4())},
-        client6_{makeClient(boost::asio::ip::udp::v6())} {}
+        dns_cache_{std::make_shared<detail::ResolveCache<
+            boost::asio::ip::udp::resolver>>()} {}
 
   void QuicTransport::dial(const PeerId &peer,
                            Multiaddress address,
@@ -48,9 +73,7 @@ namespace libp2p::transport {
             return cb(r.error());
           }
           auto remote = r.value().begin()->endpoint();
-          auto v4 = remote.protocol() == boost::asio::ip::udp::v4();
-          auto &client = v4 ? self->client4_ : self->client6_;
-          client->connect(
+          self->client(remote.protocol())->connect(
               remote,
               peer,
               [cb{std::move(cb)}](
@@ -61,16 +84,18 @@ namespace libp2p::transport {
                 cb(r.value());
               });
         };
-    detail::resolve(resolver_, info, std::move(connect));
+    detail::resolve(resolver_, ares_, dns_cache_, info, std::move(connect));
   }
 
   std::shared_ptr<TransportListener> QuicTransport::createListener(
       TransportListener::HandlerFunc handler) {
     return std::make_shared<QuicListener>(io_context_,
-                                          ssl_context_,
+                                          ssl_context_.quic(),
                                           mux_config_,
+                                          config_,
                                           local_peer_,
                                           key_codec_,
+                                          gater_,
                                           std::move(handler));
   }
 
@@ -82,17 +107,25 @@ namespace libp2p::transport {
     return "/quic/1.0.0";
   }
 
-  std::shared_ptr<lsquic::Engine> QuicTransport::makeClient(
-      boost::asio::ip::udp protocol) const {
-    return std::make_shared<lsquic::Engine>(io_context_,
-                                            ssl_context_,
-                                            mux_config_,
-                                            local_peer_,
-                                            key_codec_,
-                                            boost::asio::ip::udp::socket{
-                                                *io_context_,
-                                                protocol,
-                                            },
-                                            true);
+  const std::shared_ptr<lsquic::Engine> &QuicTransport::client(
+      boost::asio::ip::udp protocol) {
+    auto &client = protocol == boost::asio::ip::udp::v4() ? client4_ : client6_;
+    if (not client) {
+      metrics::StartupPhase phase{"quic_client"};
+      client = std::make_shared<lsquic::Engine>(io_context_,
+                                                ssl_context_.quic(),
+                                                mux_config_,
+                                                config_,
+                                                local_peer_,
+                                                key_codec_,
+                                                boost::asio::ip::udp::socket{
+                                                    *io_context_,
+                                                    protocol,
+                                                },
+                                                true,
+                                                0,
+                                                1);
+    }
+    return client;
   }
 }  // namespace libp2p::transport
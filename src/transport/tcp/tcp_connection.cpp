@@ -6,10 +6,18 @@
 
 #include <libp2p/transport/tcp/tcp_connection.hpp>
 
+#if defined(SO_ZEROCOPY) and defined(MSG_ZEROCOPY)
+#include <cstring>
+
+#include <linux/errqueue.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#define LIBP2P_TCP_ZERO_COPY
+#endif
+
 #include <libp2p/basic/read_return_size.hpp>
 #include <libp2p/common/ambigous_size.hpp>
 #include <libp2p/common/asio_buffer.hpp>
-#include <libp2p/transport/tcp/bytes_counter.hpp>
 #include <libp2p/transport/tcp/tcp_util.hpp>
 
 #define TRACE_ENABLED 0
@@ -18,30 +26,45 @@
 namespace libp2p::transport {
 
   namespace {
-    auto &log() {
+    const log::Logger &log() {
       static auto logger = log::createLogger("TcpConnection");
-      return *logger;
+      return logger;
     }
   }  // namespace
 
-  TcpConnection::TcpConnection(boost::asio::io_context &ctx,
-                               ProtoAddrVec layers,
+  TcpConnection::TcpConnection(ProtoAddrVec layers,
                                boost::asio::ip::tcp::socket &&socket)
-      : context_(ctx),
-        layers_{std::move(layers)},
+      : TcpConnection{std::move(layers), std::move(socket), TcpSocketOptions{}} {
+  }
+
+  TcpConnection::TcpConnection(ProtoAddrVec layers,
+                               boost::asio::ip::tcp::socket &&socket,
+                               TcpSocketOptions options)
+      : layers_{std::move(layers)},
+        options_{options},
         socket_(std::move(socket)),
         connection_phase_done_{false},
-        deadline_timer_(context_) {
+        deadline_timer_(socket_.get_executor()),
+        meter_{metrics::TrafficLayer::RAW} {
+    if (options_.zero_copy_threshold != 0 and zeroCopyEnabled(socket_)) {
+      zero_copy_threshold_ = options_.zero_copy_threshold;
+    }
     std::ignore = saveMultiaddresses();
   }
 
   TcpConnection::TcpConnection(boost::asio::io_context &ctx,
                                ProtoAddrVec layers)
-      : context_(ctx),
-        layers_{std::move(layers)},
-        socket_(context_),
+      : TcpConnection{ctx, std::move(layers), TcpSocketOptions{}} {}
+
+  TcpConnection::TcpConnection(boost::asio::io_context &ctx,
+                               ProtoAddrVec layers,
+                               TcpSocketOptions options)
+      : layers_{std::move(layers)},
+        options_{options},
+        socket_(ctx),
         connection_phase_done_{false},
-        deadline_timer_(context_) {}
+        deadline_timer_(socket_.get_executor()),
+        meter_{metrics::TrafficLayer::RAW} {}
 
   outcome::result<void> TcpConnection::close() {
     closed_by_host_ = true;
@@ -52,7 +75,7 @@ namespace libp2p::transport {
   void TcpConnection::close(std::error_code reason) {
     if (!close_reason_) {
       close_reason_ = reason;
-      log().debug("{} closing with reason: {}", debug_str_, *close_reason_);
+      SL_DEBUG(log(), "{} closing with reason: {}", debug_str_, *close_reason_);
     }
     if (socket_.is_open()) {
       boost::system::error_code ec;
@@ -90,15 +113,18 @@ namespace libp2p::transport {
 
   namespace {
     template <typename Callback>
-    auto closeOnError(TcpConnection &conn, Callback cb) {
-      return [cb{std::move(cb)}, wptr{conn.weak_from_this()}](auto ec,
-                                                              size_t result) {
+    auto closeOnError(TcpConnection &conn, Callback cb, bool read) {
+      return [cb{std::move(cb)}, wptr{conn.weak_from_this()}, read](
+                 auto ec, size_t result) {
         if (ec) {
           cb(ec);
           if (auto self = wptr.lock()) {
             self->close(ec);
           }
         } else {
+          if (auto self = wptr.lock()) {
+            self->onTransferred(read, result);
+          }
           cb(result);
         }
       };
@@ -141,11 +167,11 @@ namespace libp2p::transport {
             }
           });
     }
-    boost::asio::async_connect(
-        socket_,
+    connectNext(
         iterator,
+        iterator.begin(),
         [wptr{weak_from_this()}, cb{std::move(cb)}](
-            auto &&ec, const Tcp::endpoint &endpoint) {
+            const ErrorCode &ec, const Tcp::endpoint &endpoint) {
           auto self = wptr.lock();
           if (!self || self->closed_by_host_) {
             return;
@@ -166,9 +192,52 @@ namespace libp2p::transport {
             self->deadline_timer_.cancel();
           }
           self->initiator_ = true;
+          if (not ec) {
+            applyConnected(self->socket_, self->options_);
+            if (self->options_.zero_copy_threshold != 0
+                and zeroCopyEnabled(self->socket_)) {
+              self->zero_copy_threshold_ = self->options_.zero_copy_threshold;
+            }
+          }
           std::ignore = self->saveMultiaddresses();
-          cb(std::forward<decltype(ec)>(ec),
-             std::forward<decltype(endpoint)>(endpoint));
+          cb(ec, endpoint);
+        });
+  }
+
+  void TcpConnection::connectNext(ResolverResultsType endpoints,
+                                  ResolverResultsType::const_iterator it,
+                                  ConnectCallbackFunc cb) {
+    if (it == endpoints.end()) {
+      return cb(boost::asio::error::not_found, Tcp::endpoint{});
+    }
+    Tcp::endpoint endpoint = *it;
+    ErrorCode ec;
+    socket_.close(ec);
+    socket_.open(endpoint.protocol(), ec);
+    if (ec) {
+      return cb(ec, endpoint);
+    }
+    applyBeforeConnect(socket_, options_);
+    socket_.async_connect(
+        endpoint,
+        [wptr{weak_from_this()},
+         endpoints{std::move(endpoints)},
+         it,
+         endpoint,
+         cb{std::move(cb)}](const ErrorCode &ec) mutable {
+          auto self = wptr.lock();
+          if (not self) {
+            return;
+          }
+          auto next = std::next(it);
+          // stop trying if closed or timed out
+          if (ec and next != endpoints.end() and self->socket_.is_open()
+              and not self->closed_by_host_
+              and not self->connection_phase_done_) {
+            return self->connectNext(
+                std::move(endpoints), next, std::move(cb));
+          }
+          cb(ec, endpoint);
         });
   }
 
@@ -183,31 +252,169 @@ namespace libp2p::transport {
   void TcpConnection::readSome(BytesOut out,
                                size_t bytes,
                                TcpConnection::ReadCallbackFunc cb) {
-    ByteCounter::getInstance().incrementBytesRead(bytes);
     ambigousSize(out, bytes);
     TRACE("{} read some up to {}", debug_str_, bytes);
     socket_.async_read_some(asioBuffer(out),
-                            closeOnError(*this, std::move(cb)));
+                            closeOnError(*this, std::move(cb), true));
   }
 
   void TcpConnection::writeSome(BytesIn in,
                                 size_t bytes,
                                 TcpConnection::WriteCallbackFunc cb) {
-    ByteCounter::getInstance().incrementBytesWritten(bytes);
     ambigousSize(in, bytes);
     TRACE("{} write some up to {}", debug_str_, bytes);
+    if (useZeroCopy(in.size())) {
+      return writeZeroCopy({asioBuffer(in)}, std::move(cb));
+    }
     socket_.async_write_some(asioBuffer(in),
-                             closeOnError(*this, std::move(cb)));
+                             closeOnError(*this, std::move(cb), false));
+  }
+
+  void TcpConnection::writeSomeVectored(std::span<const BytesIn> in,
+                                        TcpConnection::WriteCallbackFunc cb) {
+    std::vector<boost::asio::const_buffer> buffers;
+    buffers.reserve(in.size());
+    size_t bytes = 0;
+    for (const auto &buffer : in) {
+      if (not buffer.empty()) {
+        buffers.emplace_back(asioBuffer(buffer));
+        bytes += buffer.size();
+      }
+    }
+    TRACE("{} write some up to {} from {} buffers",
+          debug_str_,
+          bytes,
+          buffers.size());
+    if (useZeroCopy(bytes)) {
+      return writeZeroCopy(std::move(buffers), std::move(cb));
+    }
+    socket_.async_write_some(buffers,
+                             closeOnError(*this, std::move(cb), false));
+  }
+
+  bool TcpConnection::useZeroCopy(size_t bytes) const {
+    return zero_copy_threshold_ != 0 and bytes >= zero_copy_threshold_;
+  }
+
+  void TcpConnection::writeZeroCopy(
+      std::vector<boost::asio::const_buffer> buffers, WriteCallbackFunc cb) {
+#ifdef LIBP2P_TCP_ZERO_COPY
+    auto send_buffers = buffers;
+    socket_.async_send(
+        send_buffers,
+        MSG_ZEROCOPY,
+        [weak{weak_from_this()}, buffers{std::move(buffers)}, cb{std::move(cb)}](
+            const ErrorCode &ec, size_t bytes) mutable {
+          auto self = weak.lock();
+          if (self and ec == boost::asio::error::no_buffer_space) {
+            // out of memory for pinned pages, send a copy
+            return self->socket_.async_write_some(
+                buffers, closeOnError(*self, std::move(cb), false));
+          }
+          if (ec or not self) {
+            cb(ec);
+            if (self) {
+              self->close(ec);
+            }
+            return;
+          }
+          self->onTransferred(false, bytes);
+          self->zero_copy_writes_.emplace_back(ZeroCopyWrite{
+              .id = self->zero_copy_next_++,
+              .bytes = bytes,
+              .cb = std::move(cb),
+          });
+          self->onZeroCopyCompleted();
+        });
+#else
+    socket_.async_write_some(buffers,
+                             closeOnError(*this, std::move(cb), false));
+#endif
+  }
+
+  void TcpConnection::onZeroCopyCompleted() {
+#ifdef LIBP2P_TCP_ZERO_COPY
+    if (not zero_copy_writes_.empty() and not zero_copy_waiting_) {
+      zero_copy_waiting_ = true;
+      // started before reading, so that completions queued after reading
+      // wake it, edge triggered reactor doesn't report earlier ones
+      socket_.async_wait(
+          Tcp::socket::wait_error,
+          [weak{weak_from_this()}](const ErrorCode &ec) {
+            auto self = weak.lock();
+            if (not self) {
+              return;
+            }
+            self->zero_copy_waiting_ = false;
+            if (not ec and self->socket_.is_open()) {
+              return self->onZeroCopyCompleted();
+            }
+            // buffers are released by kernel with socket
+            auto writes = std::move(self->zero_copy_writes_);
+            self->zero_copy_writes_.clear();
+            std::error_code reason = ec;
+            if (self->close_reason_) {
+              reason = *self->close_reason_;
+            }
+            for (auto &write : writes) {
+              write.cb(reason);
+            }
+          });
+    }
+    auto fd = socket_.native_handle();
+    while (true) {
+      alignas(cmsghdr) char control[128];
+      msghdr msg{};
+      msg.msg_control = control;
+      msg.msg_controllen = sizeof(control);
+      if (::recvmsg(fd, &msg, MSG_ERRQUEUE | MSG_DONTWAIT) < 0) {
+        break;
+      }
+      for (auto *cmsg = CMSG_FIRSTHDR(&msg); cmsg != nullptr;
+           cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+        if (not(cmsg->cmsg_level == SOL_IP and cmsg->cmsg_type == IP_RECVERR)
+            and not(cmsg->cmsg_level == SOL_IPV6
+                    and cmsg->cmsg_type == IPV6_RECVERR)) {
+          continue;
+        }
+        sock_extended_err err{};
+        memcpy(&err, CMSG_DATA(cmsg), sizeof(err));
+        if (err.ee_origin != SO_EE_ORIGIN_ZEROCOPY or err.ee_errno != 0) {
+          continue;
+        }
+        if ((err.ee_code & SO_EE_CODE_ZEROCOPY_COPIED) != 0) {
+          // kernel copies anyway (e.g. loopback), so writes would only
+          // complete later
+          zero_copy_threshold_ = 0;
+        }
+        // sends [ee_info, ee_data] completed, sequence numbers wrap
+        for (auto &write : zero_copy_writes_) {
+          if (write.id - err.ee_info <= err.ee_data - err.ee_info) {
+            write.completed = true;
+          }
+        }
+      }
+    }
+    // completions are reported in order of writes
+    while (not zero_copy_writes_.empty()
+           and zero_copy_writes_.front().completed) {
+      auto write = std::move(zero_copy_writes_.front());
+      zero_copy_writes_.pop_front();
+      write.cb(write.bytes);
+    }
+#endif
   }
 
   void TcpConnection::deferReadCallback(outcome::result<size_t> res,
                                         ReadCallbackFunc cb) {
-    boost::asio::post(context_, [res, cb{std::move(cb)}] { cb(res); });
+    boost::asio::post(socket_.get_executor(),
+                      [res, cb{std::move(cb)}] { cb(res); });
   }
 
   void TcpConnection::deferWriteCallback(std::error_code ec,
                                          WriteCallbackFunc cb) {
-    boost::asio::post(context_, [ec, cb{std::move(cb)}] { cb(ec); });
+    boost::asio::post(socket_.get_executor(),
+                      [ec, cb{std::move(cb)}] { cb(ec); });
   }
 
   outcome::result<void> TcpConnection::saveMultiaddresses() {
@@ -242,12 +449,26 @@ namespace libp2p::transport {
     return outcome::success();
   }
 
+  void TcpConnection::attributeTraffic(const peer::PeerId &peer) {
+    meter_.attribute(peer);
+  }
+
+  void TcpConnection::onTransferred(bool read, size_t bytes) {
+    if (read) {
+      meter_.onRead(bytes);
+    } else {
+      meter_.onWritten(bytes);
+    }
+  }
+
   uint64_t TcpConnection::getBytesRead() {
-    return ByteCounter::getInstance().getBytesRead();
+    using metrics::Traffic;
+    return Traffic::instance().total(metrics::TrafficLayer::RAW).bytes_read;
   }
 
   uint64_t TcpConnection::getBytesWritten() {
-    return ByteCounter::getInstance().getBytesWritten();
+    using metrics::Traffic;
+    return Traffic::instance().total(metrics::TrafficLayer::RAW).bytes_written;
   }
 
 }  // namespace libp2p::transport
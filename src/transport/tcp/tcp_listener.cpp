@@ -11,15 +11,33 @@
 #include <libp2p/transport/tcp/tcp_util.hpp>
 
 namespace libp2p::transport {
+  namespace {
+    /// Connections accepted on io_context of listener per wakeup, so that
+    /// burst of them doesn't delay other handlers for long
+    constexpr size_t kAcceptBatch = 64;
+
+    bool wouldBlock(const boost::system::error_code &ec) {
+      return ec == boost::asio::error::would_block
+          or ec == boost::asio::error::try_again;
+    }
+  }  // namespace
 
   TcpListener::TcpListener(boost::asio::io_context &context,
                            std::shared_ptr<Upgrader> upgrader,
+                           std::shared_ptr<InboundGate> gate,
+                           TcpSocketOptions options,
                            TransportListener::HandlerFunc handler)
       : context_(context),
         upgrader_(std::move(upgrader)),
+        gate_(std::move(gate)),
+        options_(options),
         handle_(std::move(handler)),
         acceptor_(context_) {}
 
+  TcpListener::~TcpListener() {
+    stopShards();
+  }
+
   outcome::result<void> TcpListener::listen(
       const multi::Multiaddress &address) {
     OUTCOME_TRY(info, detail::asTcp(address));
@@ -30,13 +48,20 @@ namespace libp2p::transport {
     OUTCOME_TRY(endpoint, info.first.asTcp());
 
     // TODO(@warchant): replace with parser PRE-129
-    using namespace boost::asio;  // NOLINT
     try {
-      // setup acceptor, throws
-      acceptor_.open(endpoint.protocol());
-      acceptor_.set_option(ip::tcp::acceptor::reuse_address(true));
-      acceptor_.bind(endpoint);
-      acceptor_.listen();
+      open(acceptor_, endpoint);
+
+      // port 0 is chosen by first bind, other sockets share it
+      auto bound = acceptor_.local_endpoint();
+      for (size_t i = 1; i < listenSockets(options_); ++i) {
+        auto shard = std::make_unique<Shard>();
+        open(shard->acceptor, bound);
+        doAccept(*shard);
+        shard->thread = std::thread{[&context = shard->context] {
+          context.run();
+        }};
+        shards_.emplace_back(std::move(shard));
+      }
 
       // start listening
       doAccept();
@@ -46,10 +71,25 @@ namespace libp2p::transport {
       log::createLogger("Listener")
           ->error(
               "Cannot listen to {}: {}", address.getStringAddress(), e.code());
+      stopShards();
+      boost::system::error_code ec;
+      acceptor_.close(ec);
       return e.code();
     }
   }
 
+  void TcpListener::open(boost::asio::ip::tcp::acceptor &acceptor,
+                         const boost::asio::ip::tcp::endpoint &endpoint) {
+    acceptor.open(endpoint.protocol());
+    acceptor.set_option(
+        boost::asio::ip::tcp::acceptor::reuse_address(true));
+    applyBeforeListen(acceptor, options_);
+    acceptor.bind(endpoint);
+    acceptor.listen();
+    // ready connections are accepted until would block
+    acceptor.non_blocking(true);
+  }
+
   bool TcpListener::canListen(const multi::Multiaddress &ma) const {
     return detail::asTcp(ma).has_value();
   }
@@ -68,6 +108,7 @@ namespace libp2p::transport {
   }
 
   outcome::result<void> TcpListener::close() {
+    stopShards();
     boost::system::error_code ec;
     acceptor_.close(ec);
     if (ec) {
@@ -76,6 +117,18 @@ namespace libp2p::transport {
     return outcome::success();
   }
 
+  void TcpListener::stopShards() {
+    for (auto &shard : shards_) {
+      shard->context.stop();
+    }
+    for (auto &shard : shards_) {
+      if (shard->thread.joinable()) {
+        shard->thread.join();
+      }
+    }
+    shards_.clear();
+  }
+
   void TcpListener::doAccept() {
     using namespace boost::asio;    // NOLINT
     using namespace boost::system;  // NOLINT
@@ -84,23 +137,109 @@ namespace libp2p::transport {
       return;
     }
 
-    acceptor_.async_accept(
-        [self{this->shared_from_this()}](const boost::system::error_code &ec,
-                                         ip::tcp::socket sock) {
+    acceptor_.async_wait(
+        socket_base::wait_read,
+        [self{this->shared_from_this()}](const error_code &ec) {
           if (ec) {
             return self->handle_(ec);
           }
+          for (size_t i = 0; i < kAcceptBatch; ++i) {
+            error_code accept_ec;
+            auto sock = self->acceptor_.accept(self->context_, accept_ec);
+            if (wouldBlock(accept_ec)) {
+              break;
+            }
+            if (accept_ec) {
+              return self->handle_(accept_ec);
+            }
+            self->onAccepted(std::move(sock));
+          }
+          self->doAccept();
+        });
+  }
 
-          auto conn = std::make_shared<TcpConnection>(
-              self->context_, self->layers_, std::move(sock));
+  void TcpListener::doAccept(Shard &shard) {
+    using namespace boost::asio;    // NOLINT
+    using namespace boost::system;  // NOLINT
 
-          auto session = std::make_shared<UpgraderSession>(
-              self->upgrader_, self->layers_, std::move(conn), self->handle_);
+    // listener outlives shard threads, they are joined by close and
+    // destructor
+    shard.acceptor.async_wait(
+        socket_base::wait_read, [this, &shard](const error_code &ec) {
+          if (ec) {
+            return;
+          }
+          while (true) {
+            error_code accept_ec;
+            // socket is bound to listener io_context, as its connection is
+            auto sock = shard.acceptor.accept(context_, accept_ec);
+            if (wouldBlock(accept_ec)) {
+              break;
+            }
+            if (accept_ec) {
+              return post(context_, [weak{weak_from_this()}, accept_ec] {
+                if (auto self = weak.lock()) {
+                  self->handle_(accept_ec);
+                }
+              });
+            }
+            post(context_,
+                 [weak{weak_from_this()}, sock{std::move(sock)}]() mutable {
+                   if (auto self = weak.lock()) {
+                     self->onAccepted(std::move(sock));
+                   }
+                 });
+          }
+          doAccept(shard);
+        });
+  }
 
-          session->upgradeInbound();
+  void TcpListener::onAccepted(boost::asio::ip::tcp::socket sock) {
+    applyConnected(sock, options_);
 
-          self->doAccept();
+    if (gate_ == nullptr) {
+      return upgrade(
+          std::make_shared<TcpConnection>(layers_, std::move(sock), options_),
+          nullptr);
+    }
+
+    // reject before any crypto is done
+    boost::system::error_code endpoint_ec;
+    auto endpoint = sock.remote_endpoint(endpoint_ec);
+    if (endpoint_ec or not gate_->admit(endpoint.address())) {
+      sock.close(endpoint_ec);
+      return;
+    }
+
+    auto conn =
+        std::make_shared<TcpConnection>(layers_, std::move(sock), options_);
+    auto queued = gate_->enqueue(
+        [weak{weak_from_this()}, conn](InboundGate::Permit permit) {
+          if (auto self = weak.lock()) {
+            return self->upgrade(conn, std::move(permit));
+          }
+          std::ignore = conn->close();
+        });
+    if (not queued) {
+      std::ignore = conn->close();
+    }
+  }
+
+  void TcpListener::upgrade(std::shared_ptr<TcpConnection> conn,
+                            InboundGate::Permit permit) {
+    auto session = std::make_shared<UpgraderSession>(
+        upgrader_,
+        layers_,
+        std::move(conn),
+        [handle{handle_}, permit{std::move(permit)}](
+            outcome::result<std::shared_ptr<connection::CapableConnection>>
+                res) mutable {
+          // next queued upgrade may start
+          permit.reset();
+          handle(std::move(res));
         });
-  };
+
+    session->upgradeInbound();
+  }
 
 }  // namespace libp2p::transport
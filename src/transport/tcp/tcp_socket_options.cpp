@@ -0,0 +1,148 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/transport/tcp/tcp_socket_options.hpp>
+
+#include <algorithm>
+
+#include <libp2p/transport/socket_option.hpp>
+
+namespace libp2p::transport {
+  namespace {
+    template <int Name>
+    using TcpOption = IntegerSocketOption<IPPROTO_TCP, Name>;
+
+    template <typename Socket>
+    void setBuffers(Socket &socket, const TcpSocketOptions &options) {
+      boost::system::error_code ec;
+      if (options.send_buffer != 0) {
+        socket.set_option(
+            boost::asio::socket_base::send_buffer_size{options.send_buffer},
+            ec);
+      }
+      if (options.receive_buffer != 0) {
+        socket.set_option(boost::asio::socket_base::receive_buffer_size{
+                              options.receive_buffer},
+                          ec);
+      }
+    }
+
+    void setKeepalive(boost::asio::ip::tcp::socket &socket,
+                      const TcpSocketOptions &options) {
+      boost::system::error_code ec;
+      socket.set_option(boost::asio::socket_base::keep_alive{true}, ec);
+#if defined(TCP_KEEPIDLE)
+      if (options.keepalive_idle.count() != 0) {
+        socket.set_option(TcpOption<TCP_KEEPIDLE>(
+                              static_cast<int>(options.keepalive_idle.count())),
+                          ec);
+      }
+#elif defined(TCP_KEEPALIVE)
+      if (options.keepalive_idle.count() != 0) {
+        socket.set_option(TcpOption<TCP_KEEPALIVE>(
+                              static_cast<int>(options.keepalive_idle.count())),
+                          ec);
+      }
+#endif
+#ifdef TCP_KEEPINTVL
+      if (options.keepalive_interval.count() != 0) {
+        socket.set_option(TcpOption<TCP_KEEPINTVL>(static_cast<int>(
+                              options.keepalive_interval.count())),
+                          ec);
+      }
+#endif
+#ifdef TCP_KEEPCNT
+      if (options.keepalive_count != 0) {
+        socket.set_option(TcpOption<TCP_KEEPCNT>(options.keepalive_count),
+                          ec);
+      }
+#endif
+    }
+  }  // namespace
+
+  void applyBeforeConnect(boost::asio::ip::tcp::socket &socket,
+                          const TcpSocketOptions &options) {
+    setBuffers(socket, options);
+#ifdef TCP_FASTOPEN_CONNECT
+    if (options.fast_open_connect) {
+      boost::system::error_code ec;
+      socket.set_option(TcpOption<TCP_FASTOPEN_CONNECT>(1), ec);
+    }
+#endif
+  }
+
+  void applyConnected(boost::asio::ip::tcp::socket &socket,
+                      const TcpSocketOptions &options) {
+    boost::system::error_code ec;
+    if (options.no_delay) {
+      socket.set_option(boost::asio::ip::tcp::no_delay{true}, ec);
+    }
+#ifdef TCP_QUICKACK
+    if (options.quick_ack) {
+      socket.set_option(TcpOption<TCP_QUICKACK>(1), ec);
+    }
+#endif
+#ifdef TCP_NOTSENT_LOWAT
+    if (options.not_sent_lowat != 0) {
+      socket.set_option(TcpOption<TCP_NOTSENT_LOWAT>(options.not_sent_lowat),
+                        ec);
+    }
+#endif
+#ifdef SO_BUSY_POLL
+    if (options.busy_poll.count() != 0) {
+      socket.set_option(IntegerSocketOption<SOL_SOCKET, SO_BUSY_POLL>(
+                            static_cast<int>(options.busy_poll.count())),
+                        ec);
+    }
+#endif
+    if (options.keepalive) {
+      setKeepalive(socket, options);
+    }
+#if defined(SO_ZEROCOPY) and defined(MSG_ZEROCOPY)
+    if (options.zero_copy_threshold != 0) {
+      socket.set_option(IntegerSocketOption<SOL_SOCKET, SO_ZEROCOPY>(1), ec);
+    }
+#endif
+  }
+
+  bool zeroCopyEnabled(boost::asio::ip::tcp::socket &socket) {
+#if defined(SO_ZEROCOPY) and defined(MSG_ZEROCOPY)
+    boost::system::error_code ec;
+    IntegerSocketOption<SOL_SOCKET, SO_ZEROCOPY> option;
+    socket.get_option(option, ec);
+    return not ec and option.value() != 0;
+#else
+    return false;
+#endif
+  }
+
+  void applyBeforeListen(boost::asio::ip::tcp::acceptor &acceptor,
+                         const TcpSocketOptions &options) {
+    setBuffers(acceptor, options);
+#ifdef TCP_FASTOPEN
+    if (options.fast_open_queue != 0) {
+      boost::system::error_code ec;
+      acceptor.set_option(TcpOption<TCP_FASTOPEN>(options.fast_open_queue),
+                          ec);
+    }
+#endif
+#ifdef SO_REUSEPORT
+    if (listenSockets(options) > 1) {
+      // throws as listen() does, sockets can't share port without it
+      acceptor.set_option(IntegerSocketOption<SOL_SOCKET, SO_REUSEPORT>(1));
+    }
+#endif
+  }
+
+  size_t listenSockets(const TcpSocketOptions &options) {
+#ifdef SO_REUSEPORT
+    return std::max(options.reuse_port_acceptors, 1);
+#else
+    return 1;
+#endif
+  }
+
+}  // namespace libp2p::transport
@@ -6,6 +6,8 @@
 
 #include <libp2p/transport/tcp/tcp_transport.hpp>
 
+#include <libp2p/common/metrics/tracing.hpp>
+#include <libp2p/network/cares/ares_channel.hpp>
 #include <libp2p/transport/impl/upgrader_session.hpp>
 #include <libp2p/transport/tcp/tcp_util.hpp>
 
@@ -19,7 +21,12 @@ namespace libp2p::transport {
       return handler(r.error());
     }
     auto &[info, layers] = r.value();
-    auto conn = std::make_shared<TcpConnection>(*context_, layers);
+    auto conn =
+        std::make_shared<TcpConnection>(*context_, layers, socket_options_);
+    metrics::Span resolve_span{"libp2p.tcp.resolve"};
+    if (resolve_span) {
+      resolve_span.setAttribute("address", address.getStringAddress());
+    }
     auto connect =
         [=,
          self{shared_from_this()},
@@ -27,13 +34,19 @@ namespace libp2p::transport {
          layers = std::move(layers)](
             outcome::result<boost::asio::ip::tcp::resolver::results_type>
                 r) mutable {
+          resolve_span.end(r.has_value() ? std::error_code{} : r.error());
           if (not r) {
             return handler(r.error());
           }
+          metrics::Span connect_span{"libp2p.tcp.connect"};
+          if (connect_span) {
+            connect_span.setAttribute("address", address.getStringAddress());
+          }
           conn->connect(
               r.value(),
               [=, handler{std::move(handler)}, layers = std::move(layers)](
                   auto ec, auto &e) mutable {
+                connect_span.end(ec);
                 if (ec) {
                   std::ignore = conn->close();
                   return handler(ec);
@@ -49,13 +62,16 @@ namespace libp2p::transport {
               },
               mux_config_.dial_timeout);
         };
-    resolve(resolver_, info, std::move(connect));
+    resolve(resolver_, ares_, dns_cache_, info, std::move(connect));
   }
 
   std::shared_ptr<TransportListener> TcpTransport::createListener(
       TransportListener::HandlerFunc handler) {
-    return std::make_shared<TcpListener>(
-        *context_, upgrader_, std::move(handler));
+    return std::make_shared<TcpListener>(*context_,
+                                         upgrader_,
+                                         inbound_gate_,
+                                         socket_options_,
+                                         std::move(handler));
   }
 
   bool TcpTransport::canDial(const multi::Multiaddress &ma) const {
@@ -65,10 +81,49 @@ namespace libp2p::transport {
   TcpTransport::TcpTransport(std::shared_ptr<boost::asio::io_context> context,
                              const muxer::MuxedConnectionConfig &mux_config,
                              std::shared_ptr<Upgrader> upgrader)
+      : TcpTransport{std::move(context),
+                     mux_config,
+                     std::move(upgrader),
+                     nullptr} {}
+
+  TcpTransport::TcpTransport(std::shared_ptr<boost::asio::io_context> context,
+                             const muxer::MuxedConnectionConfig &mux_config,
+                             std::shared_ptr<Upgrader> upgrader,
+                             std::shared_ptr<InboundGate> inbound_gate)
+      : TcpTransport{std::move(context),
+                     mux_config,
+                     std::move(upgrader),
+                     std::move(inbound_gate),
+                     TcpSocketOptions{}} {}
+
+  TcpTransport::TcpTransport(std::shared_ptr<boost::asio::io_context> context,
+                             const muxer::MuxedConnectionConfig &mux_config,
+                             std::shared_ptr<Upgrader> upgrader,
+                             std::shared_ptr<InboundGate> inbound_gate,
+                             TcpSocketOptions socket_options)
+      : TcpTransport{std::move(context),
+                     mux_config,
+                     std::move(upgrader),
+                     std::move(inbound_gate),
+                     socket_options,
+                     nullptr} {}
+
+  TcpTransport::TcpTransport(
+      std::shared_ptr<boost::asio::io_context> context,
+      const muxer::MuxedConnectionConfig &mux_config,
+      std::shared_ptr<Upgrader> upgrader,
+      std::shared_ptr<InboundGate> inbound_gate,
+      TcpSocketOptions socket_options,
+      std::shared_ptr<network::c_ares::AresChannel> ares)
       : context_{std::move(context)},
         mux_config_{mux_config},
         upgrader_{std::move(upgrader)},
-        resolver_{*context_} {}
+        inbound_gate_{std::move(inbound_gate)},
+        socket_options_{socket_options},
+        ares_{std::move(ares)},
+        resolver_{*context_},
+        dns_cache_{std::make_shared<detail::ResolveCache<
+            boost::asio::ip::tcp::resolver>>()} {}
 
   peer::ProtocolName TcpTransport::getProtocolId() const {
     return "/tcp/1.0.0";
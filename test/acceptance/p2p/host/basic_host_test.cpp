@@ -5,10 +5,14 @@
  */
 
 #include <gtest/gtest.h>
+#include <libp2p/basic/scheduler/manual_scheduler_backend.hpp>
+#include <libp2p/basic/scheduler/scheduler_impl.hpp>
 #include <libp2p/host/basic_host/basic_host.hpp>
 #include <qtils/test/outcome.hpp>
 
+#include "mock/libp2p/connection/capable_connection_mock.hpp"
 #include "mock/libp2p/connection/stream_mock.hpp"
+#include "mock/libp2p/network/connection_manager_mock.hpp"
 #include "mock/libp2p/network/dialer_mock.hpp"
 #include "mock/libp2p/network/listener_mock.hpp"
 #include "mock/libp2p/network/network_mock.hpp"
@@ -16,6 +20,7 @@
 #include "mock/libp2p/peer/address_repository_mock.hpp"
 #include "mock/libp2p/peer/identity_manager_mock.hpp"
 #include "mock/libp2p/peer/peer_repository_mock.hpp"
+#include "mock/libp2p/peer/protocol_repository_mock.hpp"
 
 #include <libp2p/common/literals.hpp>
 #include "testutil/gmock_actions.hpp"
@@ -43,6 +48,8 @@ struct BasicHostTest : public ::testing::Test {
   std::shared_ptr<peer::AddressRepositoryMock> addr_repo =
       std::make_shared<peer::AddressRepositoryMock>();
 
+  peer::ProtocolRepositoryMock proto_repo;
+
   std::unique_ptr<Host> host = std::make_unique<host::BasicHost>(
       idmgr,
       std::make_unique<network::NetworkMock>(),
@@ -56,6 +63,14 @@ struct BasicHostTest : public ::testing::Test {
 
   network::NetworkMock &network = (network::NetworkMock &)host->getNetwork();
 
+  /// Peers support no known protocols, so streams are negotiated as usual
+  void expectUnknownProtocols() {
+    EXPECT_CALL(repo, getProtocolRepository())
+        .WillRepeatedly(ReturnRef(proto_repo));
+    EXPECT_CALL(proto_repo, supportsProtocols(_, _))
+        .WillRepeatedly(Return(std::vector<std::string_view>{}));
+  }
+
   /// VARS
   peer::PeerId id = "1"_peerid;
 
@@ -150,6 +165,7 @@ TEST_F(BasicHostTest, NewStream) {
   peer::PeerInfo pinfo{"2"_peerid, {ma1}};
   peer::ProtocolName protocol = "/proto/1.0.0";
 
+  expectUnknownProtocols();
   EXPECT_CALL(network, getDialer()).WillOnce(ReturnRef(*dialer));
   EXPECT_CALL(*dialer, newStream(pinfo, StreamProtocols{protocol}, _))
       .WillOnce(Arg2CallbackWithArg(StreamAndProtocol{stream, protocol}));
@@ -163,3 +179,136 @@ TEST_F(BasicHostTest, NewStream) {
 
   ASSERT_TRUE(executed);
 }
+
+/**
+ * @given host with scheduler and a warm peer with pre-opened protocol
+ * @when dial to peer fails, and redial succeeds
+ * @then peer is redialed after backoff, pre-opened stream is negotiated and
+ * returned by newStream, and replaced by a new one
+ */
+TEST_F(BasicHostTest, KeepWarm) {
+  auto backend = std::make_shared<basic::ManualSchedulerBackend>();
+  auto scheduler = std::make_shared<basic::SchedulerImpl>(
+      backend, basic::SchedulerImpl::Config{});
+  auto network_mock = std::make_unique<network::NetworkMock>();
+  auto &network = *network_mock;
+  network::ConnectionManagerMock cmgr;
+  host::BasicHost warm_host{
+      idmgr,
+      std::move(network_mock),
+      std::make_unique<peer::PeerRepositoryMock>(),
+      std::make_shared<libp2p::event::Bus>(),
+      std::make_shared<libp2p::network::TransportManagerMock>(),
+      Libp2pClientVersion{},
+      scheduler};
+  peer::PeerInfo pinfo{"2"_peerid, {ma1}};
+  peer::ProtocolName protocol = "/proto/1.0.0";
+
+  EXPECT_CALL(network, getDialer()).WillRepeatedly(ReturnRef(*dialer));
+  EXPECT_CALL(network, getConnectionManager()).WillRepeatedly(ReturnRef(cmgr));
+  EXPECT_CALL(cmgr, getConnectionsToPeer(pinfo.id))
+      .WillRepeatedly(
+          Return(std::vector<network::ConnectionManager::ConnectionSPtr>{}));
+  EXPECT_CALL(cmgr, protect(pinfo.id, _)).Times(1);
+
+  size_t dials = 0;
+  network::Dialer::DialResultFunc dial_cb;
+  EXPECT_CALL(*dialer, dial(pinfo, _))
+      .WillRepeatedly([&](auto &, network::Dialer::DialResultFunc cb) {
+        ++dials;
+        dial_cb = std::move(cb);
+      });
+  size_t streams = 0;
+  EXPECT_CALL(*dialer, newStream(pinfo, StreamProtocols{protocol}, _))
+      .WillRepeatedly([&](auto &, auto, StreamAndProtocolOrErrorCb cb) {
+        ++streams;
+        cb(StreamAndProtocol{stream, protocol});
+      });
+
+  warm_host.keepWarm(pinfo, {protocol});
+  ASSERT_EQ(dials, 1);
+  dial_cb(make_error_code(std::errc::connection_refused));
+  backend->shift(host::KeepWarm::Config{}.retry_base / 2);
+  ASSERT_EQ(dials, 1);
+  backend->shift(host::KeepWarm::Config{}.retry_base);
+  ASSERT_EQ(dials, 2);
+  dial_cb(std::make_shared<connection::CapableConnectionMock>());
+  ASSERT_EQ(streams, 1);
+
+  EXPECT_CALL(*stream, isClosed()).WillRepeatedly(Return(false));
+  EXPECT_CALL(*stream, isClosedForWrite()).WillRepeatedly(Return(false));
+  bool executed = false;
+  warm_host.newStream(pinfo, {protocol}, [&](StreamAndProtocolOrError r) {
+    ASSERT_TRUE(r);
+    ASSERT_EQ(r.value().stream, stream);
+    executed = true;
+  });
+  ASSERT_TRUE(executed);
+  ASSERT_EQ(streams, 2);
+
+  EXPECT_CALL(cmgr, unprotect(pinfo.id, _)).WillOnce(Return(false));
+  EXPECT_CALL(*stream, close(_)).Times(1);
+  warm_host.stopKeepWarm(pinfo.id);
+}
+
+/**
+ * @given default host and 3 peers
+ * @when payload is broadcast over at most 2 streams, keeping streams
+ * @then the third stream is opened after the first is done, each peer
+ * outcome is reported, and the next broadcast writes on the kept stream
+ */
+TEST_F(BasicHostTest, Broadcast) {
+  std::vector<peer::PeerInfo> peers{
+      {"2"_peerid, {ma1}}, {"3"_peerid, {ma2}}, {"4"_peerid, {ma3}}};
+  peer::ProtocolName protocol = "/proto/1.0.0";
+  auto payload = std::make_shared<const Bytes>(Bytes{1, 2, 3});
+
+  expectUnknownProtocols();
+  EXPECT_CALL(network, getDialer()).WillRepeatedly(ReturnRef(*dialer));
+  std::vector<StreamAndProtocolOrErrorCb> opening;
+  EXPECT_CALL(*dialer,
+              newStream(::testing::A<const peer::PeerInfo &>(),
+                        StreamProtocols{protocol},
+                        _))
+      .WillRepeatedly([&](auto &, auto, StreamAndProtocolOrErrorCb cb) {
+        opening.emplace_back(std::move(cb));
+      });
+  size_t writes = 0;
+  EXPECT_CALL(*stream, writeSome(_, _, _))
+      .WillRepeatedly([&](BytesIn in, size_t, auto cb) {
+        EXPECT_EQ(in.data(), payload->data());
+        ++writes;
+        cb(in.size());
+      });
+  EXPECT_CALL(*stream, isClosed()).WillRepeatedly(Return(false));
+  EXPECT_CALL(*stream, isClosedForWrite()).WillRepeatedly(Return(false));
+  EXPECT_CALL(*stream, close(_)).Times(0);
+
+  std::optional<Host::BroadcastResult> result;
+  Host::BroadcastConfig config{.max_streams = 2, .keep_streams = true};
+  host->broadcast({protocol}, payload, peers, config, [&](auto r) {
+    result = std::move(r);
+  });
+  ASSERT_EQ(opening.size(), 2);
+  opening[0](StreamAndProtocol{stream, protocol});
+  ASSERT_EQ(opening.size(), 3);
+  opening[1](make_error_code(std::errc::connection_refused));
+  ASSERT_FALSE(result);
+  opening[2](StreamAndProtocol{stream, protocol});
+  ASSERT_EQ(writes, 2);
+  ASSERT_TRUE(result);
+  ASSERT_EQ(result->peers.size(), 3);
+  EXPECT_EQ(result->peers[0].first, peers[0].id);
+  EXPECT_TRUE(result->peers[0].second);
+  EXPECT_FALSE(result->peers[1].second);
+  EXPECT_EQ(result->peers[2].first, peers[2].id);
+
+  result.reset();
+  host->broadcast({protocol}, payload, {peers[0]}, config, [&](auto r) {
+    result = std::move(r);
+  });
+  ASSERT_EQ(opening.size(), 3);
+  ASSERT_EQ(writes, 3);
+  ASSERT_TRUE(result);
+  EXPECT_TRUE(result->peers[0].second);
+}
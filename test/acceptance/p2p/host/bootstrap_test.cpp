@@ -0,0 +1,137 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/host/basic_host/bootstrap.hpp>
+
+#include <gtest/gtest.h>
+#include <libp2p/basic/scheduler/manual_scheduler_backend.hpp>
+#include <libp2p/basic/scheduler/scheduler_impl.hpp>
+
+#include "mock/libp2p/host/host_mock.hpp"
+#include "mock/libp2p/network/dnsaddr_resolver_mock.hpp"
+#include "testutil/libp2p/peer.hpp"
+
+using namespace libp2p;
+
+using ::testing::_;
+using ::testing::Invoke;
+
+struct BootstrapTest : public ::testing::Test {
+  void SetUp() override {
+    EXPECT_CALL(host, connect(_, _))
+        .WillRepeatedly(Invoke([this](const peer::PeerInfo &peer_info,
+                                      const Host::ConnectionResultHandler &cb) {
+          dials.emplace_back(peer_info, cb);
+        }));
+  }
+
+  static multi::Multiaddress address(const peer::PeerId &peer_id, int port) {
+    return multi::Multiaddress::create(fmt::format(
+                                           "/ip4/1.2.3.4/tcp/{}/p2p/{}",
+                                           port,
+                                           peer_id.toBase58()))
+        .value();
+  }
+
+  std::shared_ptr<host::Bootstrap> make(host::Bootstrap::Config config) {
+    return std::make_shared<host::Bootstrap>(host, resolver, scheduler, config);
+  }
+
+  void start(std::vector<multi::Multiaddress> addresses) {
+    bootstrap->start(
+        std::move(addresses),
+        [this](const peer::PeerInfo &peer_info) {
+          connected.emplace_back(peer_info.id);
+        },
+        [this](outcome::result<size_t> r) { ready.emplace_back(r); });
+  }
+
+  void complete(size_t i, bool success) {
+    auto cb = dials.at(i).second;
+    if (success) {
+      cb(std::shared_ptr<connection::CapableConnection>{});
+    } else {
+      cb(make_error_code(std::errc::connection_refused));
+    }
+  }
+
+  HostMock host;
+  std::shared_ptr<network::DnsaddrResolverMock> resolver =
+      std::make_shared<network::DnsaddrResolverMock>();
+  std::shared_ptr<basic::ManualSchedulerBackend> backend =
+      std::make_shared<basic::ManualSchedulerBackend>();
+  std::shared_ptr<basic::SchedulerImpl> scheduler =
+      std::make_shared<basic::SchedulerImpl>(backend,
+                                             basic::Scheduler::Config{});
+  std::shared_ptr<host::Bootstrap> bootstrap;
+  std::vector<std::pair<peer::PeerInfo, Host::ConnectionResultHandler>> dials;
+  std::vector<peer::PeerId> connected;
+  std::vector<outcome::result<size_t>> ready;
+};
+
+/**
+ * @given three bootstrap peers, two of them behind /dnsaddr/, and
+ * concurrency cap of two dials
+ * @when dnsaddr is resolved and dials complete
+ * @then at most two peers are dialed at once, addresses of the same peer are
+ * dialed together, failed dial is replaced with the third peer, and ready is
+ * signalled once, after the second connection
+ */
+TEST_F(BootstrapTest, FirstNSucceeded) {
+  bootstrap = make({.max_dials = 2, .ready_after = 2});
+  auto p1 = testutil::randomPeerId();
+  auto p2 = testutil::randomPeerId();
+  auto p3 = testutil::randomPeerId();
+  auto dnsaddr = multi::Multiaddress::create("/dnsaddr/bootstrap.libp2p.io");
+  network::DnsaddrResolver::AddressesCallback resolved;
+  EXPECT_CALL(*resolver, load(dnsaddr.value(), _))
+      .WillOnce(Invoke([&](auto, auto cb) { resolved = cb; }));
+
+  start({address(p1, 1), dnsaddr.value()});
+  ASSERT_EQ(dials.size(), 1);
+  EXPECT_EQ(dials[0].first.id, p1);
+
+  resolved(std::vector{address(p2, 2), address(p3, 3), address(p2, 4)});
+  ASSERT_EQ(dials.size(), 2);
+  EXPECT_EQ(dials[1].first.id, p2);
+  EXPECT_EQ(dials[1].first.addresses,
+            (std::vector{address(p2, 2), address(p2, 4)}));
+
+  complete(0, false);
+  ASSERT_EQ(dials.size(), 3);
+  EXPECT_EQ(dials[2].first.id, p3);
+  EXPECT_TRUE(ready.empty());
+
+  complete(2, true);
+  EXPECT_TRUE(ready.empty());
+  complete(1, true);
+  ASSERT_EQ(ready.size(), 1);
+  ASSERT_TRUE(ready[0]);
+  EXPECT_EQ(ready[0].value(), 2);
+  EXPECT_EQ(connected, (std::vector{p3, p2}));
+}
+
+/**
+ * @given bootstrap peers, which don't respond
+ * @when timeout passes, then all of dials fail
+ * @then ready is signalled once, with error
+ */
+TEST_F(BootstrapTest, Timeout) {
+  bootstrap = make({.timeout = std::chrono::seconds{1}});
+  start({address(testutil::randomPeerId(), 1),
+         address(testutil::randomPeerId(), 2),
+         multi::Multiaddress::create("/ip4/1.2.3.4/tcp/3").value()});
+  ASSERT_EQ(dials.size(), 2);
+
+  backend->shift(std::chrono::seconds{1});
+  ASSERT_EQ(ready.size(), 1);
+  EXPECT_EQ(ready[0].error(), make_error_code(std::errc::host_unreachable));
+
+  complete(0, false);
+  complete(1, false);
+  EXPECT_EQ(ready.size(), 1);
+  EXPECT_EQ(bootstrap->connected(), 0);
+}
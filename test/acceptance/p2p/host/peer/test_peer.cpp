@@ -180,13 +180,15 @@ Peer::sptr<host::BasicHost> Peer::makeHost(const crypto::KeyPair &keyPair) {
 
   auto bus = std::make_shared<libp2p::event::Bus>();
 
-  auto cmgr = std::make_shared<network::ConnectionManagerImpl>(bus);
+  auto cmgr = std::make_shared<network::ConnectionManagerImpl>(
+      bus, scheduler_, network::ConnectionManagerConfig{});
 
   auto listener = std::make_shared<network::ListenerManagerImpl>(
       multiselect, std::move(router), tmgr, cmgr);
 
   auto dnsaddr_resolver =
-      std::make_shared<network::DnsaddrResolverImpl>(context_, cares_);
+      std::make_shared<network::DnsaddrResolverImpl>(
+          std::make_shared<network::c_ares::AresChannel>(context_, cares_));
 
   auto addr_repo =
       std::make_shared<peer::InmemAddressRepository>(dnsaddr_resolver);
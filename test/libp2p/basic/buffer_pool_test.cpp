@@ -0,0 +1,164 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <gtest/gtest.h>
+
+#include <libp2p/basic/buffer_pool.hpp>
+#include <libp2p/basic/free_list.hpp>
+
+using libp2p::basic::BufferPool;
+using libp2p::basic::BufferSlice;
+using libp2p::basic::FreeList;
+using libp2p::basic::FreeListAllocator;
+
+/**
+ * @given buffer pool
+ * @when slice is allocated and released
+ * @then the chunk is kept for reuse and is returned by the next allocation
+ */
+TEST(BufferPoolTest, ChunkIsReused) {
+  auto pool = BufferPool::create(1024, 4);
+
+  auto *data = [&] {
+    auto slice = pool->allocate(100);
+    EXPECT_EQ(slice.size(), 100);
+    EXPECT_EQ(pool->chunksInUse(), 1);
+    EXPECT_EQ(pool->freeChunks(), 0);
+    return slice.data();
+  }();
+
+  ASSERT_EQ(pool->chunksInUse(), 0);
+  ASSERT_EQ(pool->freeChunks(), 1);
+
+  auto slice = pool->allocate();
+  ASSERT_EQ(slice.data(), data);
+  ASSERT_EQ(slice.size(), pool->chunkSize());
+  ASSERT_EQ(pool->freeChunks(), 0);
+}
+
+/**
+ * @given slice of pooled chunk
+ * @when subslices and copies are made
+ * @then they share memory, and the chunk is released with the last reference
+ */
+TEST(BufferPoolTest, SlicesShareChunk) {
+  auto pool = BufferPool::create(1024, 4);
+
+  auto slice = pool->allocate();
+  slice.data()[10] = 42;
+
+  auto sub = slice.subslice(10, 20);
+  ASSERT_EQ(sub.size(), 20);
+  ASSERT_EQ(sub.data()[0], 42);
+  ASSERT_EQ(slice.useCount(), 2);
+
+  BufferSlice copy = sub;
+  ASSERT_EQ(slice.useCount(), 3);
+
+  BufferSlice moved = std::move(copy);
+  ASSERT_TRUE(copy.empty());
+  ASSERT_EQ(slice.useCount(), 3);
+
+  slice.reset();
+  sub.reset();
+  ASSERT_EQ(pool->chunksInUse(), 1);
+  ASSERT_EQ(moved.data()[0], 42);
+
+  moved.reset();
+  ASSERT_EQ(pool->chunksInUse(), 0);
+  ASSERT_EQ(pool->freeChunks(), 1);
+}
+
+/**
+ * @given pool with limit of free chunks
+ * @when more chunks are released
+ * @then extra chunks are deallocated
+ */
+TEST(BufferPoolTest, FreeChunksLimit) {
+  auto pool = BufferPool::create(64, 2);
+  {
+    std::vector<BufferSlice> slices;
+    for (auto i = 0; i < 5; ++i) {
+      slices.emplace_back(pool->allocate());
+    }
+    ASSERT_EQ(pool->chunksInUse(), 5);
+  }
+  ASSERT_EQ(pool->chunksInUse(), 0);
+  ASSERT_EQ(pool->freeChunks(), 2);
+}
+
+/**
+ * @given slice which outlives its pool handle
+ * @when the slice is released
+ * @then the pool is still valid till then
+ */
+TEST(BufferPoolTest, SliceKeepsPoolAlive) {
+  auto slice = BufferPool::create(64, 2)->allocate(10);
+  ASSERT_EQ(slice.useCount(), 1);
+  slice.data()[9] = 1;
+  slice.reset();
+  ASSERT_TRUE(slice.empty());
+}
+
+/**
+ * @given pool with huge pages and NUMA local free chunks
+ * @when slices are allocated
+ * @then chunks are carved from one slab, all of them are kept for reuse
+ * regardless of free chunks limit
+ */
+TEST(BufferPoolTest, HugePageSlab) {
+  auto pool = BufferPool::create(
+      BufferPool::kHugePageSize / 4, 1, {.huge_pages = true, .numa_local = true});
+  {
+    auto first = pool->allocate();
+    auto second = pool->allocate();
+    first.data()[0] = 1;
+    second.data()[pool->chunkSize() - 1] = 2;
+    if (pool->freeChunks() == 0) {
+      GTEST_SKIP() << "huge pages are not available";
+    }
+    ASSERT_EQ(pool->freeChunks(), 2);
+    ASSERT_EQ(second.data() - first.data(),
+              static_cast<ptrdiff_t>(pool->chunkSize()));
+  }
+  ASSERT_EQ(pool->chunksInUse(), 0);
+  ASSERT_EQ(pool->freeChunks(), 4);
+}
+
+/**
+ * @given free list allocator
+ * @when shared object is released and another one is allocated
+ * @then memory of the first one is reused, up to free blocks limit
+ */
+TEST(BufferPoolTest, FreeListReusesBlocks) {
+  auto free_list = std::make_shared<FreeList>(1);
+  FreeListAllocator<int> allocator{free_list};
+  auto *first = [&] {
+    auto object = std::allocate_shared<int>(allocator, 1);
+    return object.get();
+  }();
+  ASSERT_EQ(free_list->freeBlocks(), 1);
+  auto second = std::allocate_shared<int>(allocator, 2);
+  ASSERT_EQ(second.get(), first);
+  ASSERT_EQ(free_list->freeBlocks(), 0);
+  {
+    auto third = std::allocate_shared<int>(allocator, 3);
+    auto fourth = std::allocate_shared<int>(allocator, 4);
+  }
+  ASSERT_EQ(free_list->freeBlocks(), 1);
+}
+
+/**
+ * @given object allocated from free list
+ * @when the object outlives free list handle
+ * @then the free list is still valid till the object is released
+ */
+TEST(BufferPoolTest, ObjectKeepsFreeListAlive) {
+  auto object = std::allocate_shared<int>(
+      FreeListAllocator<int>{std::make_shared<FreeList>(1)}, 1);
+  *object = 2;
+  object.reset();
+}
@@ -0,0 +1,43 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <gtest/gtest.h>
+
+#include <libp2p/basic/codec.hpp>
+
+using libp2p::Bytes;
+using libp2p::basic::CodecError;
+using libp2p::basic::deflateCodec;
+
+/**
+ * @given deflate codec and compressible data
+ * @when data is compressed and decompressed
+ * @then compressed data is smaller, decompressed data is equal to original
+ */
+TEST(CodecTest, DeflateRoundTrip) {
+  auto codec = deflateCodec();
+  Bytes data(100000, 'a');
+  auto compressed = codec->compress(data).value();
+  EXPECT_LT(compressed.size(), data.size());
+  EXPECT_EQ(codec->decompress(compressed, data.size()).value(), data);
+}
+
+/**
+ * @given compressed data
+ * @when it is decompressed with limit below its size, or corrupted
+ * @then decompression fails
+ */
+TEST(CodecTest, DeflateLimitAndCorruption) {
+  auto codec = deflateCodec();
+  Bytes data(100000, 'a');
+  auto compressed = codec->compress(data).value();
+  EXPECT_EQ(codec->decompress(compressed, data.size() - 1).error(),
+            make_error_code(CodecError::DECOMPRESSED_TOO_LARGE));
+
+  compressed.resize(compressed.size() / 2);
+  EXPECT_EQ(codec->decompress(compressed, data.size()).error(),
+            make_error_code(CodecError::DECOMPRESS_FAILED));
+}
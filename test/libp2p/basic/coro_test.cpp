@@ -0,0 +1,118 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/basic/coro/awaiter.hpp>
+
+#include <gtest/gtest.h>
+
+#include <libp2p/basic/scheduler/manual_scheduler_backend.hpp>
+#include <libp2p/basic/scheduler/scheduler_impl.hpp>
+#include "mock/libp2p/connection/stream_mock.hpp"
+
+using namespace libp2p;
+using connection::StreamMock;
+using ::testing::_;
+using ::testing::NiceMock;
+
+namespace {
+  coro::Task<size_t> depth(size_t n) {
+    if (n == 0) {
+      co_return 0;
+    }
+    co_return 1 + co_await depth(n - 1);
+  }
+}  // namespace
+
+/**
+ * @given chain of nested tasks completing without suspension
+ * @when top task is spawned
+ * @then each task resumes the one awaiting it and result is computed
+ */
+TEST(CoroTest, DeepTaskChain) {
+  size_t result = 0;
+  coro::spawn([](size_t &result) -> coro::Task<> {
+    result = co_await depth(1000);
+  }(result));
+  ASSERT_EQ(result, 1000);
+}
+
+/**
+ * @given stream completing first read immediately and second one later
+ * @when coroutine reads twice
+ * @then first read doesn't suspend, second resumes coroutine from callback
+ */
+TEST(CoroTest, ReadSome) {
+  auto stream = std::make_shared<NiceMock<StreamMock>>();
+  basic::Reader::ReadCallbackFunc pending;
+  EXPECT_CALL(*stream, readSome(_, _, _))
+      .WillOnce([](BytesOut out, size_t, auto cb) {
+        out[0] = 1;
+        cb(1);
+      })
+      .WillOnce([&](BytesOut, size_t, auto cb) { pending = std::move(cb); });
+
+  std::vector<outcome::result<size_t>> results;
+  Bytes buffer(4);
+  coro::spawn([](auto stream, BytesOut buffer, auto &results) -> coro::Task<> {
+    results.emplace_back(co_await coro::readSome(stream, buffer));
+    results.emplace_back(co_await coro::readSome(stream, buffer));
+  }(stream, buffer, results));
+
+  ASSERT_EQ(results.size(), 1);
+  ASSERT_EQ(results[0].value(), 1);
+  ASSERT_EQ(buffer[0], 1);
+  ASSERT_TRUE(pending);
+  pending(3);
+  ASSERT_EQ(results.size(), 2);
+  ASSERT_EQ(results[1].value(), 3);
+}
+
+/**
+ * @given stream writing one byte per call
+ * @when coroutine writes buffer
+ * @then all bytes are written in order
+ */
+TEST(CoroTest, WriteAll) {
+  auto stream = std::make_shared<NiceMock<StreamMock>>();
+  Bytes written;
+  ON_CALL(*stream, writeSome(_, _, _))
+      .WillByDefault([&](BytesIn in, size_t, auto cb) {
+        written.push_back(in[0]);
+        cb(1);
+      });
+
+  Bytes data{1, 2, 3, 4, 5};
+  std::optional<outcome::result<void>> result;
+  coro::spawn([](auto stream, BytesIn data, auto &result) -> coro::Task<> {
+    result = co_await coro::write(stream, data);
+  }(stream, data, result));
+
+  ASSERT_TRUE(result);
+  ASSERT_TRUE(result->has_value());
+  ASSERT_EQ(written, data);
+}
+
+/**
+ * @given scheduler over manual backend
+ * @when coroutine sleeps
+ * @then it is resumed when time comes
+ */
+TEST(CoroTest, Sleep) {
+  auto backend = std::make_shared<basic::ManualSchedulerBackend>();
+  auto scheduler = std::make_shared<basic::SchedulerImpl>(
+      backend, basic::Scheduler::Config{});
+
+  bool woken = false;
+  coro::spawn([](auto &scheduler, bool &woken) -> coro::Task<> {
+    co_await coro::sleep(scheduler, std::chrono::milliseconds(100));
+    woken = true;
+  }(*scheduler, woken));
+
+  backend->shift(std::chrono::milliseconds(50));
+  ASSERT_FALSE(woken);
+  backend->shift(std::chrono::milliseconds(50));
+  ASSERT_TRUE(woken);
+}
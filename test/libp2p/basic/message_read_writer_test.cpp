@@ -4,6 +4,8 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+#include <libp2p/basic/message_batch_reader.hpp>
+#include <libp2p/basic/message_read_writer_error.hpp>
 #include <libp2p/basic/message_read_writer_uvarint.hpp>
 
 #include <gtest/gtest.h>
@@ -62,6 +64,42 @@ TEST_F(MessageReadWriterTest, Read) {
   ASSERT_TRUE(operation_completed_);
 }
 
+/**
+ * @given message read writer
+ * @when two messages are read, first buffer is released before second read,
+ * then third is read while second buffer is still held
+ * @then released buffer is reused, held buffer is not
+ */
+TEST_F(MessageReadWriterTest, ReuseReleasedBuffer) {
+  EXPECT_CALL(*conn_mock_, read(_, 1, _))
+      .Times(3)
+      .WillRepeatedly(ReadPut(len_varint_.toBytes()));
+  EXPECT_CALL(*conn_mock_, read(_, kMsgLength, _))
+      .Times(3)
+      .WillRepeatedly(ReadPut(msg_bytes_));
+
+  std::shared_ptr<Bytes> held;
+  const Bytes *first = nullptr;
+  msg_rw_->read([&](auto &&res) {
+    ASSERT_TRUE(res);
+    first = res.value().get();
+  });
+  msg_rw_->read([&](auto &&res) {
+    ASSERT_TRUE(res);
+    ASSERT_EQ(res.value().get(), first);
+    held = res.value();
+  });
+  msg_rw_->read([&](auto &&res) {
+    ASSERT_TRUE(res);
+    ASSERT_NE(res.value().get(), held.get());
+    ASSERT_EQ(*res.value(), msg_bytes_);
+    operation_completed_ = true;
+  });
+
+  ASSERT_TRUE(operation_completed_);
+  ASSERT_EQ(*held, msg_bytes_);
+}
+
 ACTION_P2(CheckWrite, buf, varint) {
   ASSERT_EQ(arg0.size(), buf.size());
 
@@ -83,3 +121,60 @@ TEST_F(MessageReadWriterTest, Write) {
 
   ASSERT_TRUE(operation_completed_);
 }
+
+/**
+ * @given three messages and a half of fourth are available in connection
+ * @when messages are read in batches
+ * @then three messages come with one callback, fourth with next one after
+ * the rest of it is received
+ */
+TEST_F(MessageReadWriterTest, ReadMany) {
+  Bytes first;
+  for (auto i = 0; i < 3; ++i) {
+    first.insert(first.end(),
+                 msg_with_varint_bytes_.begin(),
+                 msg_with_varint_bytes_.end());
+  }
+  Bytes second{msg_with_varint_bytes_.begin() + 3,
+               msg_with_varint_bytes_.end()};
+  first.insert(first.end(),
+               msg_with_varint_bytes_.begin(),
+               msg_with_varint_bytes_.begin() + 3);
+  EXPECT_CALL(*conn_mock_, readSome(_, _, _))
+      .WillOnce(ReadPut(first))
+      .WillOnce(ReadPut(second));
+
+  auto reader = std::make_shared<MessageBatchReader>(conn_mock_);
+  size_t messages = 0;
+  auto on_read = [&](outcome::result<MessageBatchReader::Messages> res) {
+    ASSERT_TRUE(res);
+    for (auto &message : res.value()) {
+      ASSERT_EQ(Bytes(message.begin(), message.end()), msg_bytes_);
+      ++messages;
+    }
+  };
+  reader->readMany(on_read);
+  ASSERT_EQ(messages, 3);
+  reader->readMany(on_read);
+  ASSERT_EQ(messages, 4);
+}
+
+/**
+ * @given message longer than limit of reader
+ * @when it is read
+ * @then read fails with MESSAGE_TOO_LONG
+ */
+TEST_F(MessageReadWriterTest, ReadManyTooLong) {
+  EXPECT_CALL(*conn_mock_, readSome(_, _, _))
+      .WillOnce(ReadPut(msg_with_varint_bytes_));
+
+  auto reader =
+      std::make_shared<MessageBatchReader>(conn_mock_, kMsgLength - 1);
+  reader->readMany([this](outcome::result<MessageBatchReader::Messages> res) {
+    ASSERT_EQ(res.error(),
+              make_error_code(MessageReadWriterError::MESSAGE_TOO_LONG));
+    operation_completed_ = true;
+  });
+
+  ASSERT_TRUE(operation_completed_);
+}
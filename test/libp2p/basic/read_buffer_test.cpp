@@ -0,0 +1,114 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <gtest/gtest.h>
+
+#include <numeric>
+
+#include <libp2p/basic/read_buffer.hpp>
+
+using libp2p::Bytes;
+using libp2p::BytesIn;
+using libp2p::basic::BufferPool;
+using libp2p::basic::ReadBuffer;
+
+struct ReadBufferTest : public ::testing::Test {
+  std::shared_ptr<BufferPool> pool = BufferPool::create(4, 4);
+  ReadBuffer buffer{pool};
+  Bytes data = [] {
+    Bytes data(10);
+    std::iota(data.begin(), data.end(), 0);
+    return data;
+  }();
+};
+
+/**
+ * @given read buffer of 4 byte chunks
+ * @when data spanning several chunks is added and consumed in parts
+ * @then data is consumed in order, consumed chunks are returned to pool
+ */
+TEST_F(ReadBufferTest, ConsumeAcrossChunks) {
+  buffer.add(data);
+  EXPECT_EQ(buffer.size(), 10);
+  EXPECT_EQ(pool->chunksInUse(), 3);
+
+  Bytes out(5);
+  EXPECT_EQ(buffer.consume(out), 5);
+  EXPECT_EQ(out, Bytes(data.begin(), data.begin() + 5));
+  EXPECT_EQ(pool->chunksInUse(), 2);
+
+  out.resize(10);
+  EXPECT_EQ(buffer.consume(out), 5);
+  EXPECT_EQ(Bytes(out.begin(), out.begin() + 5),
+            Bytes(data.begin() + 5, data.end()));
+  EXPECT_TRUE(buffer.empty());
+  EXPECT_EQ(pool->chunksInUse(), 0);
+}
+
+/**
+ * @given read buffer with data
+ * @when more data is added while reading into larger output
+ * @then buffered data goes first, then new data, remainder is buffered
+ */
+TEST_F(ReadBufferTest, AddAndConsume) {
+  buffer.add(BytesIn{data}.first(3));
+  Bytes out(5);
+  EXPECT_EQ(buffer.addAndConsume(BytesIn{data}.subspan(3), out), 5);
+  EXPECT_EQ(out, Bytes(data.begin(), data.begin() + 5));
+  EXPECT_EQ(buffer.size(), 5);
+
+  out.assign(5, 0);
+  EXPECT_EQ(buffer.consume(out), 5);
+  EXPECT_EQ(out, Bytes(data.begin() + 5, data.end()));
+}
+
+/**
+ * @given read buffer with data
+ * @when data is peeked and taken
+ * @then contiguous part of the 1st chunk is returned without copying,
+ * taken slice keeps its chunk
+ */
+TEST_F(ReadBufferTest, PeekAndTake) {
+  buffer.add(data);
+  buffer.skip(1);
+  auto part = buffer.peek();
+  EXPECT_EQ(Bytes(part.begin(), part.end()), Bytes({1, 2, 3}));
+
+  auto slice = buffer.take(10);
+  EXPECT_EQ(slice.data(), part.data());
+  EXPECT_EQ(slice.size(), 3);
+  EXPECT_EQ(buffer.size(), 6);
+  EXPECT_EQ(pool->chunksInUse(), 3);
+  slice.reset();
+  EXPECT_EQ(pool->chunksInUse(), 2);
+
+  buffer.clear();
+  EXPECT_EQ(pool->chunksInUse(), 0);
+  EXPECT_TRUE(buffer.peek().empty());
+}
+
+/**
+ * @given read buffer which is never drained
+ * @when data keeps being added and partially consumed
+ * @then data stays in order and only chunks holding unread data are in use
+ */
+TEST_F(ReadBufferTest, StreamingWithoutDrain) {
+  uint8_t next_in = 0;
+  uint8_t next_out = 0;
+  for (auto i = 0; i < 100; ++i) {
+    Bytes in(7);
+    std::iota(in.begin(), in.end(), next_in);
+    next_in += in.size();
+    buffer.add(in);
+    Bytes out(6);
+    ASSERT_EQ(buffer.consume(out), out.size());
+    for (auto byte : out) {
+      ASSERT_EQ(byte, next_out++);
+    }
+    ASSERT_LE(pool->chunksInUse(), (buffer.size() + 3) / 4 + 1);
+  }
+  EXPECT_EQ(buffer.size(), 100);
+}
@@ -0,0 +1,152 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+
+#include <libp2p/basic/mpmc_queue.hpp>
+#include <libp2p/basic/scheduler/asio_scheduler_backend.hpp>
+#include <libp2p/basic/scheduler/inbox.hpp>
+#include <libp2p/basic/scheduler/manual_scheduler_backend.hpp>
+#include <libp2p/basic/scheduler/scheduler_impl.hpp>
+
+using namespace libp2p::basic;
+
+/**
+ * @given queue of capacity 4
+ * @when more values are pushed than fit
+ * @then extra pushes fail and values are popped in order
+ */
+TEST(MpscQueueTest, BoundedFifo) {
+  MpscQueue<int> queue{3};
+  ASSERT_EQ(queue.capacity(), 4);
+  for (int i = 0; i < 4; ++i) {
+    ASSERT_TRUE(queue.tryPush(int{i}));
+  }
+  ASSERT_FALSE(queue.tryPush(4));
+
+  int value = -1;
+  ASSERT_TRUE(queue.tryPop(value));
+  ASSERT_EQ(value, 0);
+  ASSERT_TRUE(queue.tryPush(4));
+  for (int i = 1; i <= 4; ++i) {
+    ASSERT_TRUE(queue.tryPop(value));
+    ASSERT_EQ(value, i);
+  }
+  ASSERT_FALSE(queue.tryPop(value));
+}
+
+/**
+ * @given queue of capacity 64
+ * @when one thread pushes values, and 4 threads pop them
+ * @then each value is popped exactly once
+ */
+TEST(MpmcQueueTest, ManyConsumers) {
+  constexpr int kValues = 10000;
+  MpmcQueue<int> queue{64};
+  std::atomic<int> popped{0};
+  std::atomic<int64_t> sum{0};
+  std::vector<std::thread> consumers;
+  for (int i = 0; i < 4; ++i) {
+    consumers.emplace_back([&] {
+      int value = 0;
+      while (popped.load() != kValues) {
+        if (queue.tryPop(value)) {
+          sum += value;
+          ++popped;
+        }
+      }
+    });
+  }
+  for (int i = 1; i <= kValues;) {
+    if (queue.tryPush(int{i})) {
+      ++i;
+    }
+  }
+  for (auto &thread : consumers) {
+    thread.join();
+  }
+  ASSERT_EQ(sum.load(), int64_t{kValues} * (kValues + 1) / 2);
+  int value = 0;
+  ASSERT_FALSE(queue.tryPop(value));
+}
+
+/**
+ * @given inbox draining 2 messages per call
+ * @when 5 messages are posted
+ * @then one call is scheduled, and all messages are handled in order by
+ * several drains
+ */
+TEST(SchedulerInboxTest, DrainsInBatches) {
+  auto backend = std::make_shared<ManualSchedulerBackend>();
+  auto scheduler =
+      std::make_shared<SchedulerImpl>(backend, Scheduler::Config{});
+  std::vector<int> handled;
+  auto inbox = std::make_shared<SchedulerInbox<int>>(
+      scheduler, 8, [&](int &&value) { handled.push_back(value); }, 2);
+
+  for (int i = 0; i < 5; ++i) {
+    ASSERT_TRUE(inbox->post(int{i}));
+  }
+  ASSERT_TRUE(handled.empty());
+
+  backend->shift(std::chrono::milliseconds::zero());
+  ASSERT_EQ(handled, (std::vector<int>{0, 1, 2, 3, 4}));
+  ASSERT_TRUE(backend->empty());
+}
+
+/**
+ * @given inbox on asio scheduler
+ * @when several threads post many messages
+ * @then all messages are handled on scheduler thread, in order of each
+ * producer
+ */
+TEST(SchedulerInboxTest, ManyProducers) {
+  constexpr size_t kProducers = 4;
+  constexpr size_t kMessages = 10000;
+  struct Message {
+    size_t producer = 0;
+    size_t index = 0;
+  };
+
+  auto io = std::make_shared<boost::asio::io_context>(1);
+  auto backend = std::make_shared<AsioSchedulerBackend>(io);
+  auto scheduler =
+      std::make_shared<SchedulerImpl>(backend, Scheduler::Config{});
+  auto work = boost::asio::make_work_guard(*io);
+
+  std::vector<size_t> next(kProducers, 0);
+  size_t handled = 0;
+  bool ordered = true;
+  auto inbox = std::make_shared<SchedulerInbox<Message>>(
+      scheduler, 256, [&](Message &&message) {
+        ordered = ordered and message.index == next[message.producer];
+        ++next[message.producer];
+        if (++handled == kProducers * kMessages) {
+          io->stop();
+        }
+      });
+
+  std::vector<std::thread> producers;
+  for (size_t producer = 0; producer < kProducers; ++producer) {
+    producers.emplace_back([&, producer] {
+      for (size_t index = 0; index < kMessages; ++index) {
+        while (not inbox->post({producer, index})) {
+          std::this_thread::yield();
+        }
+      }
+    });
+  }
+  io->run_for(std::chrono::seconds(10));
+  for (auto &thread : producers) {
+    thread.join();
+  }
+
+  ASSERT_EQ(handled, kProducers * kMessages);
+  ASSERT_TRUE(ordered);
+}
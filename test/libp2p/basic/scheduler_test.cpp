@@ -4,11 +4,17 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+#include <thread>
+
 #include <gtest/gtest.h>
 
+#include <boost/asio/post.hpp>
+
 #include <libp2p/basic/scheduler/asio_scheduler_backend.hpp>
 #include <libp2p/basic/scheduler/manual_scheduler_backend.hpp>
 #include <libp2p/basic/scheduler/scheduler_impl.hpp>
+#include <libp2p/basic/scheduler/timer_wheel_scheduler.hpp>
+#include <libp2p/common/metrics/registry.hpp>
 #include <libp2p/common/shared_fn.hpp>
 
 #include "testutil/prepare_loggers.hpp"
@@ -103,6 +109,33 @@ TEST(Scheduler, BasicThings) {
   io->run_for(std::chrono::milliseconds(300));
 }
 
+/**
+ * @given io_context with posted handler and scheduler timers
+ * @when it is run with busy polling
+ * @then the handler and timers are executed, run returns when io_context
+ * runs out of work
+ */
+TEST(Scheduler, BusyPolling) {
+  using namespace libp2p::basic;
+
+  auto io = std::make_shared<boost::asio::io_context>(1);
+  auto backend = std::make_shared<AsioSchedulerBackend>(io);
+  auto scheduler =
+      std::make_shared<SchedulerImpl>(std::move(backend), Scheduler::Config{});
+
+  bool posted = false;
+  boost::asio::post(*io, [&] { posted = true; });
+  int timers = 0;
+  scheduler->schedule([&] { ++timers; }, std::chrono::milliseconds(1));
+  scheduler->schedule([&] { ++timers; }, std::chrono::milliseconds(20));
+
+  auto handlers =
+      runBusyPolling(*io, {.budget = std::chrono::microseconds(100)});
+  EXPECT_TRUE(posted);
+  EXPECT_EQ(timers, 2);
+  EXPECT_GE(handlers, 3);
+}
+
 TEST(Scheduler, ManualScheduler) {
   using namespace libp2p::basic;
 
@@ -114,3 +147,243 @@ TEST(Scheduler, ManualScheduler) {
 
   backend->run();
 }
+
+TEST(Scheduler, TimerWheelBasicThings) {
+  using namespace libp2p::basic;
+
+  auto io = std::make_shared<boost::asio::io_context>(1);
+  auto backend = std::make_shared<AsioSchedulerBackend>(io);
+  auto scheduler = std::make_shared<TimerWheelScheduler>(std::move(backend),
+                                                         Scheduler::Config{});
+
+  auto h = timers(scheduler);
+
+  io->run_for(std::chrono::milliseconds(300));
+}
+
+TEST(Scheduler, TimerWheelManualScheduler) {
+  using namespace libp2p::basic;
+
+  auto backend = std::make_shared<ManualSchedulerBackend>();
+  auto scheduler =
+      std::make_shared<TimerWheelScheduler>(backend, Scheduler::Config{});
+
+  auto h = timers(scheduler);
+
+  backend->run();
+}
+
+/**
+ * @given timer wheel scheduler
+ * @when timers with delays across all wheel levels (and beyond) are scheduled
+ * and some are cancelled
+ * @then each remaining timer fires once, not earlier than its time and not
+ * later than max timer threshold after it
+ */
+TEST(Scheduler, TimerWheelDelays) {
+  using namespace libp2p::basic;
+  using std::chrono::milliseconds;
+
+  auto backend = std::make_shared<ManualSchedulerBackend>();
+  Scheduler::Config config;
+  auto scheduler = std::make_shared<TimerWheelScheduler>(backend, config);
+
+  std::vector<milliseconds> delays{milliseconds(1),
+                                   milliseconds(63),
+                                   milliseconds(64),
+                                   milliseconds(65),
+                                   milliseconds(4095),
+                                   milliseconds(4161),
+                                   milliseconds(150'000),
+                                   milliseconds(1 << 24),
+                                   milliseconds((1 << 24) + 100'000)};
+  std::vector<milliseconds> fired(delays.size());
+  std::vector<Scheduler::Handle> handles;
+  auto start = backend->now();
+  for (size_t i = 0; i < delays.size(); ++i) {
+    handles.emplace_back(scheduler->scheduleWithHandle(
+        [&, i] {
+          EXPECT_EQ(fired[i], milliseconds::zero());
+          fired[i] = backend->now();
+        },
+        delays[i]));
+    // cancelled timers next to each of the others
+    handles.emplace_back(scheduler->scheduleWithHandle(
+        [] { ADD_FAILURE() << "cancelled timer called"; }, delays[i]));
+    handles.back().reset();
+  }
+
+  backend->run();
+
+  EXPECT_EQ(scheduler->size(), 0);
+  for (size_t i = 0; i < delays.size(); ++i) {
+    auto due = start + delays[i];
+    EXPECT_GE(fired[i], due) << i;
+    EXPECT_LE(fired[i], due + config.max_timer_threshold) << i;
+  }
+}
+
+template <typename S>
+void intrusiveTimers() {
+  using namespace libp2p::basic;
+  using std::chrono::milliseconds;
+
+  auto backend = std::make_shared<ManualSchedulerBackend>();
+  auto scheduler = std::make_shared<S>(backend, Scheduler::Config{});
+
+  Timer rearmed;
+  milliseconds rearmed_at{};
+  scheduler->arm(
+      rearmed,
+      [] { ADD_FAILURE() << "rearmed timer called"; },
+      milliseconds(50));
+  scheduler->arm(
+      rearmed, [&] { rearmed_at = backend->now(); }, milliseconds(100));
+
+  Timer cancelled;
+  scheduler->arm(
+      cancelled,
+      [] { ADD_FAILURE() << "cancelled timer called"; },
+      milliseconds(30));
+  cancelled.cancel();
+
+  {
+    Timer destroyed;
+    scheduler->arm(
+        destroyed,
+        [] { ADD_FAILURE() << "destroyed timer called"; },
+        milliseconds(30));
+  }
+
+  Timer periodic;
+  size_t ticks = 0;
+  std::function<void()> tick = [&] {
+    if (++ticks < 3) {
+      scheduler->arm(periodic, [&] { tick(); }, milliseconds(20));
+    }
+  };
+  scheduler->arm(periodic, [&] { tick(); }, milliseconds(20));
+
+  Timer outliving;
+  scheduler->arm(
+      outliving,
+      [] { ADD_FAILURE() << "outliving timer called"; },
+      milliseconds(1000));
+
+  auto start = backend->now();
+  for (auto i = 0; i < 20; ++i) {
+    backend->shift(milliseconds(10));
+  }
+  EXPECT_EQ(ticks, 3);
+  EXPECT_GE(rearmed_at, start + milliseconds(100));
+  EXPECT_LE(rearmed_at, start + milliseconds(120));
+  scheduler.reset();
+  outliving.cancel();
+}
+
+/**
+ * @given scheduler
+ * @when intrusive timers are armed, rearmed, cancelled and destroyed
+ * @then only the last arming of live timers fires, timer may outlive
+ * scheduler
+ */
+TEST(Scheduler, IntrusiveTimers) {
+  intrusiveTimers<libp2p::basic::SchedulerImpl>();
+  intrusiveTimers<libp2p::basic::TimerWheelScheduler>();
+}
+
+/**
+ * @given scheduler with stall threshold
+ * @when callback runs longer than threshold
+ * @then stall is counted, faster callbacks are not
+ */
+TEST(Scheduler, StallWatchdog) {
+  using namespace libp2p::basic;
+  using std::chrono::milliseconds;
+
+  auto stalls = [] {
+    return libp2p::metrics::Registry::instance()
+        .counter("libp2p_scheduler_stalls_total",
+                 "Scheduler callbacks, which ran longer than stall threshold")
+        .value();
+  };
+  auto backend = std::make_shared<ManualSchedulerBackend>();
+  Scheduler::Config config;
+  config.stall_threshold = milliseconds(5);
+  auto scheduler = std::make_shared<SchedulerImpl>(backend, config);
+
+  auto before = stalls();
+  scheduler->schedule([] {});
+  scheduler->schedule([] { std::this_thread::sleep_for(milliseconds(10)); });
+  backend->run();
+  EXPECT_EQ(stalls(), before + 1);
+}
+
+template <typename SchedulerType>
+void priorities() {
+  using namespace libp2p::basic;
+  using std::chrono::milliseconds;
+  using Priority = Scheduler::Priority;
+
+  auto backend = std::make_shared<ManualSchedulerBackend>();
+  auto scheduler =
+      std::make_shared<SchedulerType>(backend, Scheduler::Config{});
+  std::string order;
+  auto push = [&](char c) { return [&order, c] { order.push_back(c); }; };
+
+  scheduler->schedule(push('a'), Priority::BACKGROUND);
+  scheduler->schedule(push('b'), Priority::BACKGROUND);
+  scheduler->schedule(push('c'));
+  scheduler->schedule(push('d'), Priority::IO);
+  auto h = scheduler->scheduleWithHandle(
+      push('x'), milliseconds::zero(), Priority::BACKGROUND);
+  scheduler->schedule(push('e'), Priority::CONTROL);
+  scheduler->schedule(push('f'), Priority::IO);
+  h.reset();
+  backend->shift(std::chrono::milliseconds::zero());
+  EXPECT_EQ(order, "dfceab");
+
+  // due background callbacks wait for other classes too
+  order.clear();
+  auto walk = scheduler->scheduleWithHandle(
+      push('w'), milliseconds(10), Priority::BACKGROUND);
+  scheduler->schedule(push('t'), milliseconds(10));
+  backend->shift(milliseconds(10));
+  EXPECT_EQ(order, "tw");
+}
+
+/**
+ * @given scheduler
+ * @when callbacks of different priorities are deferred
+ * @then higher classes run first, background ones one per cycle after others
+ */
+TEST(Scheduler, Priorities) {
+  priorities<libp2p::basic::SchedulerImpl>();
+  priorities<libp2p::basic::TimerWheelScheduler>();
+}
+
+/**
+ * @given scheduler with small drain budget
+ * @when IO callbacks keep coming
+ * @then control and background callbacks still run after max skips
+ */
+TEST(Scheduler, PriorityStarvation) {
+  using namespace libp2p::basic;
+  using Priority = Scheduler::Priority;
+
+  auto backend = std::make_shared<ManualSchedulerBackend>();
+  Scheduler::Config config;
+  config.drain_budget = 1;
+  config.max_skips = 2;
+  auto scheduler = std::make_shared<SchedulerImpl>(backend, config);
+  std::string order;
+  auto push = [&](char c) { return [&order, c] { order.push_back(c); }; };
+
+  for (auto i = 0; i < 6; ++i) {
+    scheduler->schedule(push('i'), Priority::IO);
+  }
+  scheduler->schedule(push('c'), Priority::CONTROL);
+  scheduler->schedule(push('b'), Priority::BACKGROUND);
+  backend->shift(std::chrono::milliseconds::zero());
+  EXPECT_EQ(order, "iicbiiii");
+}
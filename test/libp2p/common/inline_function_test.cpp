@@ -0,0 +1,82 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/common/inline_function.hpp>
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <memory>
+
+using libp2p::InlineFunction;
+
+/**
+ * @given lambda capturing shared pointer
+ * @when function is created, copied and moved
+ * @then calls reach the same state, and capture is released with the last
+ * function
+ */
+TEST(InlineFunctionTest, CopyMoveAndRelease) {
+  auto counter = std::make_shared<int>(0);
+  std::weak_ptr<int> weak = counter;
+  InlineFunction<int(int)> f = [counter](int add) { return *counter += add; };
+  counter.reset();
+  auto copy = f;
+  EXPECT_EQ(f(1), 1);
+  EXPECT_EQ(copy(2), 3);
+  auto moved = std::move(f);
+  EXPECT_FALSE(f);
+  EXPECT_EQ(moved(3), 6);
+  copy = nullptr;
+  EXPECT_FALSE(weak.expired());
+  moved = {};
+  EXPECT_TRUE(weak.expired());
+}
+
+/**
+ * @given lambda larger than inline buffer
+ * @when function is copied, moved and assigned
+ * @then it behaves the same as an inline one
+ */
+TEST(InlineFunctionTest, LargeCallable) {
+  std::array<size_t, 16> values{};
+  values.back() = 7;
+  InlineFunction<size_t()> f = [values] { return values.back(); };
+  auto copy = f;
+  InlineFunction<size_t()> moved;
+  moved = std::move(f);
+  EXPECT_EQ(copy(), 7);
+  EXPECT_EQ(moved(), 7);
+  copy.swap(f);
+  EXPECT_FALSE(copy);
+  EXPECT_EQ(f(), 7);
+}
+
+/**
+ * @given empty std::function and null function pointer
+ * @when they are converted to InlineFunction
+ * @then InlineFunction is empty, and throws when called
+ */
+TEST(InlineFunctionTest, EmptyConversions) {
+  std::function<void()> empty;
+  void (*null)() = nullptr;
+  InlineFunction<void()> from_empty = empty;
+  InlineFunction<void()> from_null = null;
+  EXPECT_TRUE(from_empty == nullptr);
+  EXPECT_TRUE(from_null == nullptr);
+  EXPECT_THROW(from_empty(), std::bad_function_call);
+}
+
+/**
+ * @given callable taking argument by value
+ * @when it is called through InlineFunction
+ * @then argument is moved, not copied
+ */
+TEST(InlineFunctionTest, ForwardsArguments) {
+  InlineFunction<size_t(std::unique_ptr<int>)> f =
+      [](std::unique_ptr<int> p) { return static_cast<size_t>(*p); };
+  EXPECT_EQ(f(std::make_unique<int>(5)), 5);
+}
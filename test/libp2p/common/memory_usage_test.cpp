@@ -0,0 +1,81 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/common/metrics/memory_usage.hpp>
+
+#include <gtest/gtest.h>
+
+#include "testutil/libp2p/peer.hpp"
+
+using libp2p::metrics::dumpMemoryUsage;
+using libp2p::metrics::MemoryReporter;
+using libp2p::metrics::MemoryUsage;
+using libp2p::metrics::MemoryUsageEntry;
+using libp2p::metrics::TrafficKey;
+using libp2p::metrics::TrafficLayer;
+
+namespace {
+  struct ReporterStub : MemoryReporter {
+    ReporterStub(TrafficKey key, MemoryUsage usage)
+        : key{std::move(key)}, usage{usage} {}
+
+    MemoryUsage memoryUsage() const override {
+      return usage;
+    }
+
+    TrafficKey memoryKey() const override {
+      return key;
+    }
+
+    TrafficKey key;
+    MemoryUsage usage;
+  };
+
+  const MemoryUsageEntry *findEntry(const std::vector<MemoryUsageEntry> &dump,
+                                    const TrafficKey &key) {
+    for (auto &entry : dump) {
+      if (entry.key == key) {
+        return &entry;
+      }
+    }
+    return nullptr;
+  }
+}  // namespace
+
+/**
+ * @given live reporters of two peers
+ * @when memory usage is dumped
+ * @then usage is aggregated by peer and protocol, destroyed reporters are
+ * not reported
+ */
+TEST(MemoryUsage, AggregatedByPeerAndProtocol) {
+#ifndef LIBP2P_METRICS_ENABLED
+  GTEST_SKIP() << "reporters are listed only with metrics enabled";
+#endif
+  TrafficKey key1{TrafficLayer::MUXED, testutil::randomPeerId(), "/test/a"};
+  TrafficKey key2{TrafficLayer::MUXED, testutil::randomPeerId(), "/test/a"};
+  ReporterStub stream1{key1, {.read_buffer = 10, .pending_callbacks = 1}};
+  ReporterStub stream2{key2, {.write_queue = 5}};
+  {
+    ReporterStub stream3{key1, {.read_buffer = 1, .write_queue = 2}};
+    auto dump = dumpMemoryUsage();
+    auto entry = findEntry(dump, key1);
+    ASSERT_NE(entry, nullptr);
+    EXPECT_EQ(entry->objects, 2);
+    EXPECT_EQ(entry->usage,
+              (MemoryUsage{
+                  .read_buffer = 11, .write_queue = 2, .pending_callbacks = 1}));
+    EXPECT_EQ(entry->usage.bytes(), 13);
+  }
+
+  auto dump = dumpMemoryUsage();
+  auto entry = findEntry(dump, key1);
+  ASSERT_NE(entry, nullptr);
+  EXPECT_EQ(entry->objects, 1);
+  entry = findEntry(dump, key2);
+  ASSERT_NE(entry, nullptr);
+  EXPECT_EQ(entry->usage.write_queue, 5);
+}
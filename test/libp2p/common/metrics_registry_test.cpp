@@ -0,0 +1,203 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/common/metrics/registry.hpp>
+#include <libp2p/common/metrics/startup.hpp>
+#include <libp2p/common/metrics/tracing.hpp>
+
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+using libp2p::metrics::Histogram;
+using libp2p::metrics::Registry;
+using libp2p::metrics::startupPhases;
+using libp2p::metrics::startupReport;
+using libp2p::metrics::StartupPhase;
+using libp2p::metrics::setTracer;
+using libp2p::metrics::Span;
+using libp2p::metrics::Tracer;
+using libp2p::metrics::TraceSpan;
+
+/**
+ * @given registry
+ * @when metric is requested twice by name
+ * @then the same metric is returned
+ */
+TEST(MetricsRegistry, SameName) {
+  auto &registry = Registry::instance();
+  auto &counter = registry.counter("test_same_total", "help");
+  EXPECT_EQ(&counter, &registry.counter("test_same_total", "other help"));
+  EXPECT_EQ(&registry.gauge("test_same", "help"),
+            &registry.gauge("test_same", "help"));
+}
+
+/**
+ * @given histogram with bounds
+ * @when values are observed
+ * @then cumulative bucket counts and sum are reported
+ */
+TEST(MetricsRegistry, Histogram) {
+  Histogram histogram{{1, 2, 4}};
+  histogram.observe(0.5);
+  histogram.observe(1);
+  histogram.observe(3);
+  histogram.observe(10);
+  auto snapshot = histogram.snapshot();
+  EXPECT_EQ(snapshot.counts, (std::vector<uint64_t>{2, 2, 3, 4}));
+  EXPECT_DOUBLE_EQ(snapshot.sum, 14.5);
+}
+
+/**
+ * @given counter and gauge updated from several threads
+ * @when threads complete
+ * @then no updates are lost
+ */
+TEST(MetricsRegistry, Threads) {
+  auto &registry = Registry::instance();
+  auto &counter = registry.counter("test_threads_total", "help");
+  auto &gauge = registry.gauge("test_threads", "help");
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < 4; ++i) {
+    threads.emplace_back([&] {
+      for (size_t j = 0; j < 1000; ++j) {
+        counter.inc();
+        gauge.add(2);
+        gauge.sub(1);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(counter.value(), 4000);
+  EXPECT_EQ(gauge.value(), 4000);
+}
+
+/**
+ * @given metrics of all kinds
+ * @when exported as text
+ * @then prometheus exposition format is produced
+ */
+TEST(MetricsRegistry, ExportText) {
+  auto &registry = Registry::instance();
+  registry.counter("test_export_total", "Test counter").inc(3);
+  registry.gauge("test_export_gauge", "Test gauge").set(-2);
+  registry.histogram("test_export_seconds", "Test histogram", {0.1, 1})
+      .observe(std::chrono::milliseconds(500));
+  auto text = registry.exportText();
+  for (auto line : {
+           "# HELP test_export_total Test counter\n",
+           "# TYPE test_export_total counter\n",
+           "test_export_total 3\n",
+           "# TYPE test_export_gauge gauge\n",
+           "test_export_gauge -2\n",
+           "# TYPE test_export_seconds histogram\n",
+           "test_export_seconds_bucket{le=\"0.1\"} 0\n",
+           "test_export_seconds_bucket{le=\"1\"} 1\n",
+           "test_export_seconds_bucket{le=\"+Inf\"} 1\n",
+           "test_export_seconds_sum 0.5\n",
+           "test_export_seconds_count 1\n",
+       }) {
+    EXPECT_NE(text.find(line), std::string::npos) << line;
+  }
+}
+
+/**
+ * @given startup phases
+ * @when they end
+ * @then they are reported in order of ending and observed by histograms
+ */
+TEST(MetricsRegistry, StartupPhases) {
+  {
+    StartupPhase outer{"test_outer"};
+    StartupPhase inner{"test_inner"};
+  }
+  auto phases = startupPhases();
+  ASSERT_GE(phases.size(), 2);
+  EXPECT_EQ(phases[phases.size() - 2].name, "test_inner");
+  EXPECT_EQ(phases.back().name, "test_outer");
+  EXPECT_GE(phases.back().duration, phases[phases.size() - 2].duration);
+  auto report = startupReport();
+  EXPECT_NE(report.find("test_inner "), std::string::npos);
+  EXPECT_NE(report.find("ms, test_outer "), std::string::npos);
+  auto text = Registry::instance().exportText();
+  EXPECT_NE(text.find("libp2p_startup_test_outer_seconds_count 1\n"),
+            std::string::npos);
+}
+
+/// Records spans as "name parent key=value ... end=error"
+struct RecordingTracer : Tracer {
+  struct RecordedSpan : TraceSpan {
+    RecordedSpan(std::vector<std::string> &log, std::string record)
+        : log{log}, record{std::move(record)} {}
+
+    void setAttribute(std::string_view key, std::string_view value) override {
+      record += " ";
+      record += key;
+      record += "=";
+      record += value;
+    }
+
+    void end(std::error_code error) override {
+      log.emplace_back(record + " end=" + std::to_string(error.value()));
+    }
+
+    std::vector<std::string> &log;
+    std::string record;
+  };
+
+  std::shared_ptr<TraceSpan> startSpan(std::string_view name,
+                                       TraceSpan *parent) override {
+    std::string parent_name =
+        parent != nullptr ? static_cast<RecordedSpan *>(parent)->record : "-";
+    return std::make_shared<RecordedSpan>(
+        log, std::string{name} + " " + parent_name.substr(0, 4));
+  }
+
+  std::vector<std::string> log;
+};
+
+/**
+ * @given no tracer
+ * @when span is started
+ * @then span is empty
+ */
+TEST(MetricsTracing, NoTracer) {
+  Span span{"root"};
+  EXPECT_FALSE(span);
+  EXPECT_FALSE(span.child("child"));
+  span.setAttribute("key", "value");
+  span.end();
+}
+
+/**
+ * @given installed tracer
+ * @when spans are started, annotated and ended
+ * @then each span ends once, children refer to parent, copies share span
+ */
+TEST(MetricsTracing, Spans) {
+  auto tracer = std::make_shared<RecordingTracer>();
+  setTracer(tracer);
+  {
+    Span root{"root"};
+    ASSERT_TRUE(root);
+    root.setAttribute("peer", "Qm");
+    auto child = root.child("kid");
+    auto copy = child;
+    copy.end(std::make_error_code(std::errc::timed_out));
+    child.end();
+    child.setAttribute("late", "ignored");
+  }
+  setTracer(nullptr);
+  EXPECT_FALSE(Span{"root"});
+  EXPECT_EQ(tracer->log,
+            (std::vector<std::string>{
+                "kid root end="
+                    + std::to_string(static_cast<int>(std::errc::timed_out)),
+                "root - peer=Qm end=0",
+            }));
+}
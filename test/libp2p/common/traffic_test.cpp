@@ -0,0 +1,129 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/common/metrics/traffic.hpp>
+
+#include <gtest/gtest.h>
+#include <thread>
+
+#include "testutil/libp2p/peer.hpp"
+
+using libp2p::metrics::Traffic;
+using libp2p::metrics::TrafficLayer;
+using libp2p::metrics::TrafficMeter;
+using libp2p::metrics::TrafficStats;
+
+/**
+ * @given meters of different layers, peers and protocols
+ * @when traffic is counted
+ * @then it is broken down by layer, peer and protocol
+ */
+TEST(Traffic, Breakdown) {
+  auto &traffic = Traffic::instance();
+  auto peer1 = testutil::randomPeerId();
+  auto peer2 = testutil::randomPeerId();
+
+  TrafficMeter raw{TrafficLayer::RAW};
+  raw.attribute(peer1);
+  raw.onRead(100);
+  raw.onWritten(50);
+
+  TrafficMeter stream1{TrafficLayer::MUXED};
+  stream1.attribute(peer1, "/test/a");
+  stream1.onRead(10, 1, 1);
+
+  TrafficMeter stream2{TrafficLayer::MUXED};
+  stream2.attribute(peer2, "/test/b");
+  stream2.onWritten(20, 2, 1);
+
+  auto by_peer = traffic.byPeer(TrafficLayer::RAW);
+  EXPECT_EQ(by_peer[peer1], (TrafficStats{.bytes_read = 100,
+                                          .bytes_written = 50}));
+  EXPECT_EQ(by_peer.count(peer2), 0);
+
+  auto by_protocol = traffic.byProtocol();
+  EXPECT_EQ(by_protocol["/test/a"],
+            (TrafficStats{.bytes_read = 10,
+                          .frames_read = 1,
+                          .messages_read = 1}));
+  EXPECT_EQ(by_protocol["/test/b"],
+            (TrafficStats{.bytes_written = 20,
+                          .frames_written = 2,
+                          .messages_written = 1}));
+  EXPECT_EQ(traffic.byPeer(TrafficLayer::MUXED)[peer2].bytes_written, 20);
+}
+
+/**
+ * @given meter of one key used from several threads
+ * @when threads exit
+ * @then their counters are kept in totals
+ */
+TEST(Traffic, Threads) {
+  auto &traffic = Traffic::instance();
+  auto peer = testutil::randomPeerId();
+  constexpr size_t kThreads = 4;
+  constexpr size_t kWrites = 1000;
+
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < kThreads; ++i) {
+    threads.emplace_back([&] {
+      TrafficMeter meter{TrafficLayer::SECURE};
+      meter.attribute(peer);
+      for (size_t j = 0; j < kWrites; ++j) {
+        meter.onWritten(1, 1);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  auto stats = traffic.byPeer(TrafficLayer::SECURE)[peer];
+  EXPECT_EQ(stats.bytes_written, kThreads * kWrites);
+  EXPECT_EQ(stats.frames_written, kThreads * kWrites);
+}
+
+/**
+ * @given traffic with max keys reached
+ * @when meters of new peers and protocols count traffic
+ * @then no keys are added, traffic is counted by "other" keys of layers and
+ * kept in totals, and keys known before are still used
+ */
+TEST(Traffic, MaxKeys) {
+  auto &traffic = Traffic::instance();
+  auto known = testutil::randomPeerId();
+  TrafficMeter known_meter{TrafficLayer::RAW};
+  known_meter.attribute(known);
+  // "other" keys of layers are interned once cap is reached
+  traffic.setMaxKeys(traffic.keyCount());
+  auto raw_total = traffic.total(TrafficLayer::RAW).bytes_read;
+  auto keys = traffic.keyCount();
+
+  std::vector<libp2p::peer::PeerId> peers;
+  for (size_t i = 0; i < 10; ++i) {
+    auto &peer = peers.emplace_back(testutil::randomPeerId());
+    TrafficMeter raw{TrafficLayer::RAW};
+    raw.attribute(peer);
+    raw.onRead(1);
+    TrafficMeter stream{TrafficLayer::MUXED};
+    stream.attribute(peer, "/test/" + std::to_string(i));
+    stream.onWritten(2);
+  }
+  known_meter.attribute(known);
+  known_meter.onRead(5);
+
+  EXPECT_LE(traffic.keyCount(), keys + 2);
+  EXPECT_EQ(traffic.total(TrafficLayer::RAW).bytes_read, raw_total + 15);
+  auto by_peer = traffic.byPeer(TrafficLayer::RAW);
+  EXPECT_EQ(by_peer[known].bytes_read, 5);
+  for (auto &peer : peers) {
+    EXPECT_EQ(by_peer.count(peer), 0);
+  }
+  EXPECT_EQ(traffic.byProtocol()[std::string{Traffic::kOtherProtocol}]
+                .bytes_written,
+            20);
+  traffic.setMaxKeys(Traffic::kDefaultMaxKeys);
+}
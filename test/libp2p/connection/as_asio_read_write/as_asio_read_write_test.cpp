@@ -0,0 +1,103 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/connection/as_asio_read_write.hpp>
+
+#include <boost/asio/post.hpp>
+#include <boost/beast/http.hpp>
+#include <gtest/gtest.h>
+
+#include <libp2p/layer/websocket/ws_connection.hpp>
+
+#include "mock/libp2p/connection/layer_connection_mock.hpp"
+
+using libp2p::AsAsioReadWrite;
+using libp2p::Bytes;
+using libp2p::BytesIn;
+using libp2p::connection::LayerConnectionMock;
+namespace http = boost::beast::http;
+namespace websocket = boost::beast::websocket;
+
+namespace {
+  /// Records buffers of vectored writes, completes them by io context
+  class WriteRecorder : public LayerConnectionMock {
+   public:
+    explicit WriteRecorder(std::shared_ptr<boost::asio::io_context> io)
+        : io{std::move(io)} {}
+
+    void writeSomeVectored(std::span<const BytesIn> in,
+                           WriteCallbackFunc cb) override {
+      writes.emplace_back(in.begin(), in.end());
+      size_t bytes = 0;
+      for (auto &buffer : in) {
+        bytes += buffer.size();
+      }
+      boost::asio::post(*io, [cb{std::move(cb)}, bytes] { cb(bytes); });
+    }
+
+    std::shared_ptr<boost::asio::io_context> io;
+    std::vector<std::vector<BytesIn>> writes;
+  };
+}  // namespace
+
+struct AsAsioReadWriteTest : ::testing::Test {
+  /// Accepts websocket upgrade request, so stream writes frames as server
+  void accept() {
+    http::request<http::empty_body> request{http::verb::get, "/", 11};
+    request.set(http::field::host, "localhost");
+    request.set(http::field::upgrade, "websocket");
+    request.set(http::field::connection, "upgrade");
+    request.set(http::field::sec_websocket_key, "dGhlIHNhbXBsZSBub25jZQ==");
+    request.set(http::field::sec_websocket_version, "13");
+    boost::system::error_code accept_ec{AsAsioReadWrite::error()};
+    ws.async_accept(request, [&](boost::system::error_code ec) {
+      accept_ec = ec;
+    });
+    io->run();
+    io->restart();
+    ASSERT_FALSE(accept_ec) << accept_ec.message();
+    connection->writes.clear();
+  }
+
+  std::shared_ptr<boost::asio::io_context> io =
+      std::make_shared<boost::asio::io_context>();
+  std::shared_ptr<WriteRecorder> connection =
+      std::make_shared<WriteRecorder>(io);
+  websocket::stream<AsAsioReadWrite> ws{AsAsioReadWrite{io, connection}};
+};
+
+/**
+ * @given websocket server stream over connection, without fragmentation
+ * @when message is written
+ * @then its frame goes out by one vectored write of frame header followed by
+ * payload referring to caller's buffer, so payload is not copied
+ */
+TEST_F(AsAsioReadWriteTest, FrameIsOneVectoredWrite) {
+  ws.binary(true);
+  ws.auto_fragment(false);
+  accept();
+
+  Bytes payload(1000, 1);
+  boost::system::error_code write_ec{AsAsioReadWrite::error()};
+  size_t written = 0;
+  ws.async_write(boost::asio::buffer(payload),
+                 [&](boost::system::error_code ec, size_t n) {
+                   write_ec = ec;
+                   written = n;
+                 });
+  io->run();
+  ASSERT_FALSE(write_ec) << write_ec.message();
+  EXPECT_EQ(written, payload.size());
+
+  ASSERT_EQ(connection->writes.size(), 1);
+  auto &buffers = connection->writes.front();
+  ASSERT_EQ(buffers.size(), 2);
+  // FIN and binary opcode, 16 bit payload length
+  EXPECT_EQ(buffers[0].size(), 4);
+  EXPECT_EQ(buffers[0][0], 0x82);
+  EXPECT_EQ(buffers[1].data(), payload.data());
+  EXPECT_EQ(buffers[1].size(), payload.size());
+}
@@ -0,0 +1,160 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/connection/buffered_connection.hpp>
+
+#include <gtest/gtest.h>
+
+#include <libp2p/basic/scheduler/manual_scheduler_backend.hpp>
+#include <libp2p/basic/scheduler/scheduler_impl.hpp>
+
+#include "mock/libp2p/connection/layer_connection_mock.hpp"
+
+using libp2p::Bytes;
+using libp2p::BytesIn;
+using libp2p::BytesOut;
+using libp2p::basic::ManualSchedulerBackend;
+using libp2p::basic::SchedulerImpl;
+using libp2p::connection::BufferedConnection;
+using libp2p::connection::LayerConnectionMock;
+using testing::_;
+using testing::Invoke;
+using testing::Return;
+
+struct BufferedConnectionTest : ::testing::Test {
+  void SetUp() override {
+    EXPECT_CALL(*inner, readSome(_, _, _))
+        .WillRepeatedly(Invoke([this](BytesOut out, size_t bytes, auto cb) {
+          ++reads;
+          auto n = std::min(bytes, input.size() - input_position);
+          std::copy_n(input.begin() + static_cast<ptrdiff_t>(input_position),
+                      n,
+                      out.begin());
+          input_position += n;
+          cb(n);
+        }));
+    EXPECT_CALL(*inner, writeSome(_, _, _))
+        .WillRepeatedly(Invoke([this](BytesIn in, size_t bytes, auto cb) {
+          writes.emplace_back(in.begin(), in.begin() + bytes);
+          cb(bytes);
+        }));
+    EXPECT_CALL(*inner, deferReadCallback(_, _))
+        .WillRepeatedly(Invoke([this](auto res, auto cb) {
+          scheduler->schedule([res, cb{std::move(cb)}] { cb(res); });
+        }));
+  }
+
+  std::shared_ptr<BufferedConnection> make(BufferedConnection::Config config) {
+    return std::make_shared<BufferedConnection>(inner, scheduler, config);
+  }
+
+  std::shared_ptr<ManualSchedulerBackend> backend =
+      std::make_shared<ManualSchedulerBackend>();
+  std::shared_ptr<SchedulerImpl> scheduler =
+      std::make_shared<SchedulerImpl>(backend, SchedulerImpl::Config{});
+  std::shared_ptr<LayerConnectionMock> inner =
+      std::make_shared<LayerConnectionMock>();
+
+  Bytes input;
+  size_t input_position = 0;
+  size_t reads = 0;
+  std::vector<Bytes> writes;
+};
+
+/**
+ * @given buffered connection with 64 bytes read buffer
+ * @when upper layer reads small headers and bodies, then a large block
+ * @then small reads are served from one read of connection, large read
+ * takes the rest of buffer and is not buffered further
+ */
+TEST_F(BufferedConnectionTest, ReadAhead) {
+  for (size_t i = 0; i < 200; ++i) {
+    input.push_back(static_cast<uint8_t>(i));
+  }
+  auto conn = make({.read_buffer = 64});
+
+  Bytes received;
+  for (size_t size : {2, 12, 16, 30}) {
+    Bytes out(size);
+    conn->read(out, out.size(), [&](outcome::result<size_t> r) {
+      ASSERT_TRUE(r);
+      ASSERT_EQ(r.value(), out.size());
+    });
+    received.insert(received.end(), out.begin(), out.end());
+  }
+  ASSERT_EQ(reads, 1);
+
+  Bytes large(140);
+  conn->read(large, large.size(), [](outcome::result<size_t> r) {
+    ASSERT_TRUE(r);
+  });
+  received.insert(received.end(), large.begin(), large.end());
+  ASSERT_EQ(reads, 2);
+  ASSERT_EQ(received, input);
+}
+
+/**
+ * @given buffered connection with 16 bytes write buffer
+ * @when small writes are issued within one tick and buffer is then filled
+ * @then writes complete before they are written, small writes are written
+ * together on the next timer tick, full buffer is written at once, large
+ * write is not buffered
+ */
+TEST_F(BufferedConnectionTest, CoalescedWrites) {
+  auto conn = make({.write_buffer = 16});
+  size_t written = 0;
+  auto cb = [&](outcome::result<size_t> r) {
+    ASSERT_TRUE(r);
+    written += r.value();
+  };
+  Bytes a{1, 2}, b{3, 4, 5};
+  conn->writeSome(a, a.size(), cb);
+  conn->writeSome(b, b.size(), cb);
+  ASSERT_TRUE(writes.empty());
+  backend->shiftToTimer();
+  ASSERT_EQ(written, 5);
+  ASSERT_EQ(writes, (std::vector<Bytes>{{1, 2, 3, 4, 5}}));
+
+  conn->writeSome(b, b.size(), cb);
+  Bytes c(20, 6);
+  BytesIn buffers[]{a, c};
+  conn->writeSomeVectored(buffers, cb);
+  ASSERT_EQ(writes.size(), 2);
+  ASSERT_EQ(writes[1].size(), 16);
+  backend->shiftToTimer();
+  ASSERT_EQ(written, 5 + 16);
+
+  // nothing to coalesce with
+  conn->writeSome(c, c.size(), cb);
+  ASSERT_EQ(writes.size(), 3);
+  ASSERT_EQ(writes[2], c);
+}
+
+/**
+ * @given buffered connection with writes gathered
+ * @when it is closed
+ * @then gathered bytes are written before connection is closed, following
+ * writes fail
+ */
+TEST_F(BufferedConnectionTest, FlushOnClose) {
+  auto conn = make({.write_buffer = 16});
+  Bytes a{1, 2, 3};
+  conn->writeSome(a, a.size(), [](outcome::result<size_t>) {});
+  EXPECT_CALL(*inner, close()).WillOnce(Invoke([this] {
+    EXPECT_EQ(writes, (std::vector<Bytes>{{1, 2, 3}}));
+    return outcome::success();
+  }));
+  ASSERT_TRUE(conn->close());
+  ASSERT_TRUE(conn->isClosed());
+
+  EXPECT_CALL(*inner, deferWriteCallback(_, _))
+      .WillOnce(Invoke([](std::error_code ec, auto cb) { cb(ec); }));
+  bool failed = false;
+  conn->writeSome(a, a.size(), [&](outcome::result<size_t> r) {
+    failed = r.has_error();
+  });
+  ASSERT_TRUE(failed);
+}
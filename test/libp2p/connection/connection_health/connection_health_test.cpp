@@ -0,0 +1,89 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/connection/connection_health.hpp>
+
+#include <gtest/gtest.h>
+
+#include <libp2p/basic/scheduler/manual_scheduler_backend.hpp>
+#include <libp2p/basic/scheduler/scheduler_impl.hpp>
+
+using libp2p::basic::ManualSchedulerBackend;
+using libp2p::basic::SchedulerImpl;
+using libp2p::connection::ConnectionHealth;
+using libp2p::connection::HealthCheck;
+using std::chrono::seconds;
+
+/// Counts idle callbacks
+struct CheckStub : HealthCheck {
+  void onHealthIdle(Time idle) override {
+    idles.push_back(idle);
+  }
+
+  std::vector<Time> idles;
+};
+
+struct ConnectionHealthTest : ::testing::Test {
+  /// Shifts by ticks, so that each tick is handled
+  void shift(seconds delta) {
+    for (seconds i{0}; i < delta; ++i) {
+      backend->shift(seconds{1});
+    }
+  }
+
+  std::shared_ptr<ManualSchedulerBackend> backend =
+      std::make_shared<ManualSchedulerBackend>();
+  std::shared_ptr<SchedulerImpl> scheduler =
+      std::make_shared<SchedulerImpl>(backend, SchedulerImpl::Config{});
+};
+
+/**
+ * @given idle and active connections checked with interval of 3 seconds
+ * @when 7 seconds pass, active one receives traffic each second
+ * @then idle one is reported after each interval with its idle time, active
+ * one is not reported
+ */
+TEST_F(ConnectionHealthTest, ActiveConnectionsAreNotReported) {
+  ConnectionHealth health{{.tick = seconds{1}}, scheduler};
+  CheckStub idle, active;
+  health.add(idle, seconds{3});
+  health.add(active, seconds{3});
+  ASSERT_EQ(health.size(), 2);
+
+  for (int i = 0; i < 7; ++i) {
+    shift(seconds{1});
+    active.healthActive();
+  }
+  ASSERT_EQ(idle.idles,
+            (std::vector<HealthCheck::Time>{seconds{3}, seconds{6}}));
+  ASSERT_TRUE(active.idles.empty());
+
+  active.stopHealthCheck();
+  shift(seconds{3});
+  ASSERT_TRUE(active.idles.empty());
+  ASSERT_EQ(health.size(), 1);
+}
+
+/**
+ * @given 3 idle connections and batch of 2
+ * @when interval passes
+ * @then 2 connections are reported on the tick, the last on the next tick
+ */
+TEST_F(ConnectionHealthTest, IdleConnectionsAreBatched) {
+  ConnectionHealth health{{.tick = seconds{1}, .batch = 2}, scheduler};
+  CheckStub checks[3];
+  for (auto &check : checks) {
+    health.add(check, seconds{2});
+  }
+
+  shift(seconds{2});
+  ASSERT_EQ(checks[0].idles.size(), 1);
+  ASSERT_EQ(checks[1].idles.size(), 1);
+  ASSERT_TRUE(checks[2].idles.empty());
+
+  shift(seconds{1});
+  ASSERT_EQ(checks[2].idles, (std::vector<HealthCheck::Time>{seconds{3}}));
+}
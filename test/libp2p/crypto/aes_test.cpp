@@ -147,3 +147,26 @@ TEST_F(AesTest, Stream) {
       out.end(), result_part_2.value().begin(), result_part_2.value().end());
   ASSERT_EQ(plain_text_256, out);
 }
+
+/**
+ * @given key, iv and plain text
+ * @when text is encrypted in place in two parts and decrypted in place
+ * @then buffer holds encrypted text and then plain text
+ */
+TEST_F(AesTest, CryptInPlace) {
+  Aes256Secret secret{};
+
+  std::copy(key_256.begin(), key_256.end(), secret.key.begin());
+  std::copy(iv.begin(), iv.end(), secret.iv.begin());
+
+  Bytes buffer = plain_text_256;
+  auto span = std::span(buffer);
+  aes::AesCtrImpl encryptor(secret, aes::AesCtrImpl::Mode::ENCRYPT);
+  ASSERT_TRUE(encryptor.cryptInPlace(span.first(20)));
+  ASSERT_TRUE(encryptor.cryptInPlace(span.subspan(20)));
+  ASSERT_EQ(buffer, cipher_text_256);
+
+  ASSERT_TRUE(aes::AesCtrImpl(secret, aes::AesCtrImpl::Mode::DECRYPT)
+                  .cryptInPlace(buffer));
+  ASSERT_EQ(buffer, plain_text_256);
+}
@@ -0,0 +1,113 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <gtest/gtest.h>
+#include <libp2p/basic/scheduler/asio_scheduler_backend.hpp>
+#include <libp2p/basic/scheduler/scheduler_impl.hpp>
+#include <libp2p/crypto/crypto_provider/async_crypto_provider_impl.hpp>
+#include <libp2p/crypto/crypto_provider/crypto_provider_impl.hpp>
+#include <libp2p/crypto/ecdsa_provider/ecdsa_provider_impl.hpp>
+#include <libp2p/crypto/ed25519_provider/ed25519_provider_impl.hpp>
+#include <libp2p/crypto/hmac_provider/hmac_provider_impl.hpp>
+#include <libp2p/crypto/random_generator/boost_generator.hpp>
+#include <libp2p/crypto/rsa_provider/rsa_provider_impl.hpp>
+#include <libp2p/crypto/secp256k1_provider/secp256k1_provider_impl.hpp>
+#include <qtils/test/outcome.hpp>
+
+using namespace libp2p::crypto;
+using libp2p::Bytes;
+using libp2p::basic::AsioSchedulerBackend;
+using libp2p::basic::Scheduler;
+using libp2p::basic::SchedulerImpl;
+
+class AsyncCryptoProviderTest : public testing::Test {
+ public:
+  void SetUp() override {
+    auto random = std::make_shared<random::BoostRandomGenerator>();
+    crypto_provider_ = std::make_shared<CryptoProviderImpl>(
+        random,
+        std::make_shared<ed25519::Ed25519ProviderImpl>(),
+        std::make_shared<rsa::RsaProviderImpl>(),
+        std::make_shared<ecdsa::EcdsaProviderImpl>(),
+        std::make_shared<secp256k1::Secp256k1ProviderImpl>(random),
+        std::make_shared<hmac::HmacProviderImpl>());
+    scheduler_ = std::make_shared<SchedulerImpl>(
+        std::make_shared<AsioSchedulerBackend>(io_), Scheduler::Config{});
+    async_ = std::make_shared<AsyncCryptoProviderImpl>(
+        crypto_provider_,
+        scheduler_,
+        AsyncCryptoProviderImpl::Config{.threads = 2, .batch_chunk_size = 3});
+    keys_ = crypto_provider_->generateKeys(Key::Type::Ed25519).value();
+  }
+
+  /// Runs io till the flag is set on the io thread
+  void runUntil(const bool &done) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (not done and std::chrono::steady_clock::now() < deadline) {
+      io_->restart();
+      io_->run_for(std::chrono::milliseconds(10));
+    }
+    ASSERT_TRUE(done);
+  }
+
+  std::shared_ptr<boost::asio::io_context> io_ =
+      std::make_shared<boost::asio::io_context>();
+  std::shared_ptr<CryptoProvider> crypto_provider_;
+  std::shared_ptr<Scheduler> scheduler_;
+  std::shared_ptr<AsyncCryptoProvider> async_;
+  KeyPair keys_;
+  Bytes message_{1, 2, 3, 4};
+};
+
+/**
+ * @given async crypto provider
+ * @when message is signed and then verified
+ * @then both callbacks are called on the scheduler thread with valid results
+ */
+TEST_F(AsyncCryptoProviderTest, SignVerify) {
+  auto thread = std::this_thread::get_id();
+  bool done = false;
+  async_->sign(message_, keys_.privateKey, [&](auto signature) {
+    EXPECT_EQ(std::this_thread::get_id(), thread);
+    ASSERT_OUTCOME_SUCCESS(sig, signature);
+    async_->verify(message_, sig, keys_.publicKey, [&](auto valid) {
+      EXPECT_EQ(std::this_thread::get_id(), thread);
+      ASSERT_OUTCOME_SUCCESS(ok, valid);
+      EXPECT_TRUE(ok);
+      done = true;
+    });
+  });
+  runUntil(done);
+}
+
+/**
+ * @given signatures of several messages, one of them corrupted
+ * @when they are verified as a batch spread across workers
+ * @then results are in order of jobs and only corrupted one is invalid
+ */
+TEST_F(AsyncCryptoProviderTest, VerifyBatch) {
+  constexpr size_t kJobs = 10;
+  constexpr size_t kBad = 7;
+  std::vector<AsyncCryptoProvider::VerifyJob> jobs;
+  for (size_t i = 0; i < kJobs; ++i) {
+    Bytes message{static_cast<uint8_t>(i)};
+    auto signature = crypto_provider_->sign(message, keys_.privateKey).value();
+    if (i == kBad) {
+      signature[0] ^= 1;
+    }
+    jobs.push_back({message, signature, keys_.publicKey});
+  }
+  bool done = false;
+  async_->verifyBatch(std::move(jobs), [&](auto results) {
+    ASSERT_EQ(results.size(), kJobs);
+    for (size_t i = 0; i < kJobs; ++i) {
+      ASSERT_OUTCOME_SUCCESS(ok, results[i]);
+      EXPECT_EQ(ok, i != kBad) << i;
+    }
+    done = true;
+  });
+  runUntil(done);
+}
@@ -14,6 +14,8 @@
 using libp2p::crypto::chachapoly::ChaCha20Poly1305Impl;
 using libp2p::crypto::chachapoly::Key;
 using libp2p::crypto::chachapoly::Nonce;
+using libp2p::BytesIn;
+using libp2p::BytesOut;
 
 using libp2p::crypto::asArray;
 using libp2p::common::operator""_unhex;
@@ -158,3 +160,53 @@ TEST_F(ChaChaPolyTest, Decrypt) {
   ASSERT_OUTCOME_SUCCESS(result, codec.decrypt(nonce, ciphertext, aad));
   ASSERT_EQ(result, plaintext);
 }
+
+/**
+ * @given CCP codec implementation
+ * @when the predefined input is encrypted and then decrypted in place
+ * @then the results equal to expected
+ */
+TEST_F(ChaChaPolyTest, InPlace) {
+  ChaCha20Poly1305Impl codec(key);
+
+  Bytes buffer = plaintext;
+  buffer.resize(ciphertext.size());
+  ASSERT_OUTCOME_SUCCESS(
+      encrypted,
+      codec.encrypt(nonce,
+                    BytesIn{buffer}.first(plaintext.size()),
+                    aad,
+                    BytesOut{buffer}));
+  ASSERT_EQ(encrypted, ciphertext.size());
+  ASSERT_EQ(buffer, ciphertext);
+
+  ASSERT_OUTCOME_SUCCESS(decrypted,
+                         codec.decrypt(nonce, buffer, aad, BytesOut{buffer}));
+  ASSERT_EQ(decrypted, plaintext.size());
+  buffer.resize(decrypted);
+  ASSERT_EQ(buffer, plaintext);
+}
+
+/**
+ * @given CCP codec implementation used for many messages
+ * @when messages are encrypted and decrypted with consecutive nonces
+ * @then each result equals to that of a fresh codec
+ */
+TEST_F(ChaChaPolyTest, ReusedContext) {
+  ChaCha20Poly1305Impl codec(key);
+
+  for (uint64_t n = 0; n < 3; ++n) {
+    auto message_nonce = codec.uint64toNonce(n);
+    ASSERT_OUTCOME_SUCCESS(encrypted,
+                           codec.encrypt(message_nonce, plaintext, aad));
+    ASSERT_OUTCOME_SUCCESS(
+        expected,
+        ChaCha20Poly1305Impl{key}.encrypt(message_nonce, plaintext, aad));
+    ASSERT_EQ(encrypted, expected);
+    ASSERT_OUTCOME_SUCCESS(decrypted,
+                           codec.decrypt(message_nonce, encrypted, aad));
+    ASSERT_EQ(decrypted, plaintext);
+  }
+  ASSERT_OUTCOME_SUCCESS(result, codec.encrypt(nonce, plaintext, aad));
+  ASSERT_EQ(result, ciphertext);
+}
@@ -111,6 +111,33 @@ TEST_P(KeyGeneratorTest, DerivePublicKeySuccess) {
   ASSERT_EQ(keys.publicKey.data, derived.data);
 }
 
+/**
+ * @given key pair of specified type
+ * @when private key is prepared and message is signed with prepared key
+ * @then signature is verified by public key, deterministic signatures are the
+ * same as of private key
+ */
+TEST_P(KeyGeneratorTest, SignPreparedKey) {
+  auto key_type = GetParam();
+
+  ASSERT_OUTCOME_SUCCESS(keys, crypto_provider_->generateKeys(key_type));
+  ASSERT_OUTCOME_SUCCESS(signing_key,
+                         crypto_provider_->prepareSigningKey(keys.privateKey));
+  auto message = "message"_v;
+  for (auto i = 0; i < 2; ++i) {
+    ASSERT_OUTCOME_SUCCESS(signature,
+                           crypto_provider_->sign(message, *signing_key));
+    ASSERT_OUTCOME_SUCCESS(
+        valid, crypto_provider_->verify(message, signature, keys.publicKey));
+    EXPECT_TRUE(valid);
+    if (key_type == Key::Type::Ed25519 or key_type == Key::Type::RSA) {
+      ASSERT_OUTCOME_SUCCESS(expected,
+                             crypto_provider_->sign(message, keys.privateKey));
+      EXPECT_EQ(signature, expected);
+    }
+  }
+}
+
 INSTANTIATE_TEST_SUITE_P(TestAllKeyTypes,
                          KeyGeneratorTest,
                          ::testing::Values(Key::Type::RSA,
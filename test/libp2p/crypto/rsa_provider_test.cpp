@@ -245,6 +245,25 @@ TEST_F(RsaProviderTest, InvalidPublicKeySignatureVerificationFailure) {
   ASSERT_FALSE(result);
 }
 
+/**
+ * @given Pre-generated RSA public key and signature
+ * @when Verifying repeatedly with the key, which is parsed once, interleaved
+ * with a key differing in one byte
+ * @then Each result is that of the key used
+ */
+TEST_F(RsaProviderTest, CachedKeyVerification) {
+  PublicKey invalid_key = public_key_;
+  invalid_key[32] ^= 8;
+  for (auto i = 0; i < 3; ++i) {
+    ASSERT_OUTCOME_SUCCESS(valid,
+                           provider_.verify(message_, signature_, public_key_));
+    ASSERT_TRUE(valid);
+    ASSERT_OUTCOME_SUCCESS(invalid,
+                           provider_.verify(message_, signature_, invalid_key));
+    ASSERT_FALSE(invalid);
+  }
+}
+
 /**
  * @given Pre-generated RSA private key
  * @when Signing message
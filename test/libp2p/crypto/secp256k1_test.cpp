@@ -7,6 +7,7 @@
 #include <gtest/gtest.h>
 #include <libp2p/crypto/random_generator/boost_generator.hpp>
 #include <libp2p/crypto/secp256k1_provider/secp256k1_provider_impl.hpp>
+#include <libp2p/crypto/verify_batch.hpp>
 #include <qtils/test/outcome.hpp>
 
 using libp2p::BytesOut;
@@ -126,3 +127,34 @@ TEST_F(Secp256k1ProviderTest, VerifyInvalidSignaturFailure) {
       provider_.verify(message_, signature, sample_public_key_));
   ASSERT_FALSE(verificationResult);
 }
+
+/**
+ * @given Batch of signed messages large enough to be verified in parallel,
+ * one of the messages is modified
+ * @when Verifying the batch
+ * @then Results are in order of jobs and only the modified one is invalid
+ */
+TEST_F(Secp256k1ProviderTest, VerifyBatch) {
+  using libp2p::crypto::kMinParallelVerifyBatch;
+  using libp2p::crypto::secp256k1::VerifyJob;
+  constexpr size_t kJobs = 4 * kMinParallelVerifyBatch;
+  constexpr size_t kBad = kJobs - 3;
+  std::vector<std::vector<uint8_t>> messages;
+  for (size_t i = 0; i < kJobs; ++i) {
+    messages.push_back({static_cast<uint8_t>(i), static_cast<uint8_t>(i >> 8)});
+  }
+  std::vector<VerifyJob> jobs;
+  for (auto &message : messages) {
+    ASSERT_OUTCOME_SUCCESS(signature,
+                           provider_.sign(message, sample_private_key_));
+    jobs.push_back({message, signature, sample_public_key_});
+  }
+  messages[kBad][0] ^= 1;
+
+  auto results = provider_.verifyBatch(jobs);
+  ASSERT_EQ(results.size(), kJobs);
+  for (size_t i = 0; i < kJobs; ++i) {
+    ASSERT_OUTCOME_SUCCESS(valid, results[i]);
+    EXPECT_EQ(valid, i != kBad) << i;
+  }
+}
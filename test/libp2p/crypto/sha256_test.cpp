@@ -0,0 +1,41 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/crypto/sha/sha256.hpp>
+
+#include <gtest/gtest.h>
+#include <libp2p/common/literals.hpp>
+
+using libp2p::Bytes;
+using libp2p::BytesIn;
+using libp2p::common::Hash256;
+using namespace libp2p::crypto;
+using namespace libp2p::common;
+
+/**
+ * @given empty input and short message
+ * @when their sha256 is taken one by one and as a batch
+ * @then all hashes match known digests
+ */
+TEST(Sha256Test, Batch) {
+  Bytes empty;
+  Bytes abc{'a', 'b', 'c'};
+  Bytes empty_digest{
+      "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855"_unhex};
+  Bytes abc_digest{
+      "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad"_unhex};
+
+  auto single = sha256(abc);
+  ASSERT_TRUE(single);
+  ASSERT_EQ(Bytes(single.value().begin(), single.value().end()), abc_digest);
+
+  std::vector<BytesIn> inputs{abc, empty, abc};
+  std::vector<Hash256> hashes(inputs.size());
+  sha256Batch(inputs, hashes);
+  ASSERT_EQ(Bytes(hashes[0].begin(), hashes[0].end()), abc_digest);
+  ASSERT_EQ(Bytes(hashes[1].begin(), hashes[1].end()), empty_digest);
+  ASSERT_EQ(hashes[2], hashes[0]);
+}
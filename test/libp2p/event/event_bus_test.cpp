@@ -50,3 +50,50 @@ TEST_F(EventBusTest, SubscribePublish) {
   ASSERT_EQ(int2, expected_int);
   ASSERT_EQ(str, expected_str);
 }
+
+/**
+ * @given channel with two subscribers
+ * @when first subscriber unsubscribes both of them and subscribes another one
+ * from its handler
+ * @then second subscriber is not called @and new subscriber is called only by
+ * next publish
+ */
+TEST_F(EventBusTest, ChangeSubscribersFromHandler) {
+  auto &channel = bus_.getChannel<Event1Channel>();
+
+  int calls1 = 0, calls2 = 0, calls3 = 0;
+  Handle h2, h3;
+  auto h1 = channel.subscribe([&](int) {
+    ++calls1;
+    h2.unsubscribe();
+    h3 = channel.subscribe([&](int) { ++calls3; });
+  });
+  h2 = channel.subscribe([&](int) { ++calls2; });
+
+  channel.publish(1);
+  EXPECT_EQ(calls1, 1);
+  EXPECT_EQ(calls2, 0);
+  EXPECT_EQ(calls3, 0);
+
+  h1.unsubscribe();
+  channel.publish(1);
+  EXPECT_EQ(calls1, 1);
+  EXPECT_EQ(calls3, 1);
+
+  h3.unsubscribe();
+  EXPECT_FALSE(channel.hasSubscribers());
+}
+
+/**
+ * @given subscription handle
+ * @when bus is destroyed before the handle
+ * @then handle is released safely
+ */
+TEST_F(EventBusTest, HandleOutlivesBus) {
+  Handle handle;
+  {
+    Bus bus;
+    handle = bus.getChannel<Event1Channel>().subscribe([](int) {});
+  }
+  handle.unsubscribe();
+}
@@ -0,0 +1,84 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/log/configurator.hpp>
+
+#include <filesystem>
+
+#include <gtest/gtest.h>
+#include <soralog/impl/sink_to_console.hpp>
+#include <soralog/impl/sink_to_file.hpp>
+#include <soralog/logging_system.hpp>
+
+using libp2p::log::AsyncSinkConfig;
+using libp2p::log::Configurator;
+using libp2p::log::Level;
+
+namespace {
+  /// Configures logging system by libp2p configurator with async sink
+  std::shared_ptr<soralog::LoggingSystem> configure(
+      const AsyncSinkConfig &sink) {
+    auto system = std::make_shared<soralog::LoggingSystem>(
+        std::make_shared<Configurator>(sink));
+    auto r = system->configure();
+    EXPECT_FALSE(r.has_error) << r.message;
+    EXPECT_FALSE(r.has_warning) << r.message;
+    return system;
+  }
+}  // namespace
+
+/**
+ * @given async sink config without path
+ * @when libp2p logging is configured with it
+ * @then YAML is valid, libp2p group and its children write to console sink
+ * at level of config
+ */
+TEST(LogConfiguratorTest, AsyncConsoleSink) {
+  auto system = configure(AsyncSinkConfig{});
+
+  auto sink = system->getSink("libp2p_async");
+  ASSERT_TRUE(sink);
+  EXPECT_TRUE(std::dynamic_pointer_cast<soralog::SinkToConsole>(sink));
+
+  auto group = system->getGroup("libp2p");
+  ASSERT_TRUE(group);
+  EXPECT_EQ(group->sink(), sink);
+  EXPECT_EQ(group->level(), Level::DEBUG);
+
+  auto yamux = system->getGroup("yamux");
+  ASSERT_TRUE(yamux);
+  EXPECT_EQ(yamux->sink(), sink);
+}
+
+/**
+ * @given async sink config with file path, custom buffers and level
+ * @when libp2p logging is configured with it
+ * @then YAML is valid, libp2p group writes to file sink at that level
+ */
+TEST(LogConfiguratorTest, AsyncFileSink) {
+  auto path = std::filesystem::temp_directory_path()
+            / "libp2p_log_configurator_test.log";
+  {
+    auto system = configure(AsyncSinkConfig{
+        .path = path.string(),
+        .capacity = 16,
+        .buffer = 1 << 16,
+        .latency = std::chrono::milliseconds{10},
+        .level = Level::WARN,
+    });
+
+    auto sink = system->getSink("libp2p_async");
+    ASSERT_TRUE(sink);
+    EXPECT_TRUE(std::dynamic_pointer_cast<soralog::SinkToFile>(sink));
+
+    auto group = system->getGroup("libp2p");
+    ASSERT_TRUE(group);
+    EXPECT_EQ(group->sink(), sink);
+    EXPECT_EQ(group->level(), Level::WARN);
+    EXPECT_TRUE(system->getGroup("noise"));
+  }
+  std::filesystem::remove(path);
+}
@@ -0,0 +1,56 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/log/fields.hpp>
+
+#include <gtest/gtest.h>
+
+#include "testutil/libp2p/peer.hpp"
+
+using libp2p::log::Fields;
+
+/**
+ * @given fields without values
+ * @when they are formatted
+ * @then nothing is written
+ */
+TEST(LogFieldsTest, Empty) {
+  ASSERT_EQ(fmt::format("{}", Fields{}), "");
+  ASSERT_EQ(fmt::format("a {} b", Fields{}), "a  b");
+}
+
+/**
+ * @given fields with all values
+ * @when they are formatted
+ * @then key=value pairs are written in order, separated by space
+ */
+TEST(LogFieldsTest, All) {
+  auto peer = testutil::randomPeerId();
+  ASSERT_EQ(fmt::format("{}",
+                        Fields{
+                            .peer = &peer,
+                            .stream = 7,
+                            .protocol = "/ipfs/id/1.0.0",
+                        }),
+            fmt::format("peer={} stream=7 protocol=/ipfs/id/1.0.0",
+                        peer.toBase58()));
+}
+
+/**
+ * @given fields with some of values
+ * @when they are formatted
+ * @then only pairs of present values are written, separator doesn't lead
+ */
+TEST(LogFieldsTest, Partial) {
+  auto peer = testutil::randomPeerId();
+  ASSERT_EQ(fmt::format("{}", Fields{.peer = &peer}),
+            fmt::format("peer={}", peer.toBase58()));
+  ASSERT_EQ(fmt::format("{}", Fields{.stream = 0}), "stream=0");
+  ASSERT_EQ(fmt::format("{}", Fields{.stream = 3, .protocol = "/echo"}),
+            "stream=3 protocol=/echo");
+  ASSERT_EQ(fmt::format("{}", Fields{.peer = &peer, .protocol = "/echo"}),
+            fmt::format("peer={} protocol=/echo", peer.toBase58()));
+}
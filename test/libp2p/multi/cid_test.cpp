@@ -303,3 +303,22 @@ const std::vector<ContentIdentifier> encodeDecodeSuite = {
 INSTANTIATE_TEST_SUITE_P(EncodeDecodeTest,
                          CidEncodeDecodeTest,
                          testing::ValuesIn(encodeDecodeSuite));
+
+/**
+ * @given encoded CID v1
+ * @when decoding view of it
+ * @then view references the buffer and converts to decoded CID
+ */
+TEST(CidTest, DecodeView) {
+  ContentIdentifier cid(ContentIdentifier::Version::V1,
+                        MulticodecType::Code::RAW,
+                        EXAMPLE_MULTIHASH);
+  ASSERT_OUTCOME_SUCCESS(bytes, ContentIdentifierCodec::encode(cid));
+  ASSERT_OUTCOME_SUCCESS(view, ContentIdentifierCodec::decodeView(bytes));
+  ASSERT_EQ(view.bytes.data(), bytes.data());
+  ASSERT_EQ(view.content_address.toBuffer().data(), bytes.data() + 2);
+  ASSERT_EQ(view.toContentIdentifier(), cid);
+
+  bytes.pop_back();
+  ASSERT_FALSE(ContentIdentifierCodec::decodeView(bytes));
+}
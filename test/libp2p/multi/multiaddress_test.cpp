@@ -269,3 +269,64 @@ TEST_F(MultiaddressTest, ParityWss) {
   ASSERT_OUTCOME_SUCCESS(address, Multiaddress::create(addr));
   ASSERT_EQ(address.getStringAddress(), addr);
 }
+
+/**
+ * @given multiaddr of WebTransport listener with certificate hashes
+ * @when it is parsed from string and from its bytes
+ * @then certhash values are decoded from multibase, and encoded back as
+ * url-safe base64
+ */
+TEST_F(MultiaddressTest, WebTransportCerthash) {
+  auto addr =
+      "/ip4/127.0.0.1/udp/1234/quic-v1/webtransport"
+      "/certhash/uEiAkH5a4DPGKUuOBjYw0CgwjvcJCJMD2K_1aluKR_tpevQ"
+      "/certhash/uEiCVXmXy5vQZDBhzLilJoMMR_vHOmK-QQvhNLdjg_ffg8w"s;
+  ASSERT_OUTCOME_SUCCESS(address, Multiaddress::create(addr));
+  ASSERT_EQ(address.getStringAddress(), addr);
+  ASSERT_OUTCOME_SUCCESS(from_bytes,
+                         Multiaddress::create(address.getBytesAddress()));
+  ASSERT_EQ(from_bytes.getStringAddress(), addr);
+  auto hashes = address.getValuesForProtocol(Protocol::Code::CERTHASH);
+  ASSERT_EQ(hashes.size(), 2);
+
+  // other multibases are accepted
+  auto base58 = Multiaddress::create(
+      "/ip4/127.0.0.1/udp/1234/quic-v1/webtransport/certhash/"
+      "zQmNpD9V1Hkfz9y3jTyjy2zrV4MYmx7BmYgUu8yuWvKUgKz");
+  ASSERT_TRUE(base58);
+  ASSERT_FALSE(Multiaddress::create(
+      "/ip4/127.0.0.1/udp/1234/quic-v1/webtransport/certhash/u"));
+}
+
+/**
+ * @given multiaddress with repeated protocol and ipfs part
+ * @when peeking first value for protocols
+ * @then first value of each is returned without copying
+ */
+TEST_F(MultiaddressTest, PeekFirstValueForProtocol) {
+  auto address = "/ip4/192.168.0.1/udp/228/udp/432/ipfs/mypeer"_multiaddr;
+  auto udp = address.peekFirstValueForProtocol(Protocol::Code::UDP);
+  ASSERT_TRUE(udp);
+  ASSERT_EQ(udp.value(), "228");
+  auto peer = address.peekFirstValueForProtocol(Protocol::Code::P2P);
+  ASSERT_TRUE(peer);
+  ASSERT_EQ(peer.value(), "mypeer");
+  ASSERT_FALSE(address.peekFirstValueForProtocol(Protocol::Code::TCP));
+}
+
+/**
+ * @given equal multiaddresses built in different ways
+ * @when hashing them
+ * @then hashes are equal
+ */
+TEST_F(MultiaddressTest, CachedHash) {
+  auto address = "/ip4/192.168.0.1"_multiaddr;
+  address.encapsulate("/udp/228"_multiaddr);
+  auto expected = "/ip4/192.168.0.1/udp/228"_multiaddr;
+  ASSERT_EQ(address, expected);
+  ASSERT_EQ(std::hash<Multiaddress>{}(address),
+            std::hash<Multiaddress>{}(expected));
+
+  ASSERT_TRUE(address.decapsulate("/udp/228"_multiaddr));
+  ASSERT_EQ(address.stdHash(), "/ip4/192.168.0.1"_multiaddr.stdHash());
+}
@@ -451,3 +451,44 @@ TEST_F(Base64Encoding, IncorrectBody) {
   auto error = multibase->decode(incorrect_encoded);
   ASSERT_FALSE(error.has_value());
 }
+
+class Base64UrlEncoding : public MultibaseCodecTest {
+ public:
+  MultibaseCodec::Encoding encoding = MultibaseCodec::Encoding::BASE64_URL;
+
+  const std::vector<std::pair<Bytes, std::string_view>> decode_encode_table{
+      {"66"_unhex, "uZg"},
+      {"666f"_unhex, "uZm8"},
+      {"666f6f"_unhex, "uZm9v"},
+      {"fbff"_unhex, "u-_8"},
+  };
+};
+
+/**
+ * @given table with url-safe base64-encoded strings without padding with
+ * their bytes representations
+ * @when encoding bytes @and decoding strings
+ * @then encoding/decoding succeed @and relevant bytes and strings are
+ * equivalent
+ */
+TEST_F(Base64UrlEncoding, SuccessEncodingDecoding) {
+  for (const auto &[decoded, encoded] : decode_encode_table) {
+    auto encoded_str = multibase->encode(decoded, encoding);
+    ASSERT_EQ(encoded_str, encoded);
+
+    auto decoded_bytes = decodeCorrect(encoded);
+    ASSERT_EQ(decoded_bytes, decoded);
+  }
+}
+
+/**
+ * @given strings with padding, symbols of standard base64 alphabet, or of
+ * impossible length
+ * @when trying to decode them
+ * @then decoding fails
+ */
+TEST_F(Base64UrlEncoding, IncorrectBody) {
+  ASSERT_FALSE(multibase->decode("uZg=="));
+  ASSERT_FALSE(multibase->decode("u+/8"));
+  ASSERT_FALSE(multibase->decode("uZm9vY"));
+}
@@ -116,3 +116,35 @@ TEST(Multihash, CompareDifferentHashes) {
   ASSERT_FALSE(hash1 < hash1);
   ASSERT_FALSE(hash2 < hash2);
 }
+
+/**
+ * @given multihashes created separately from the same and different hashes
+ * @when compare them for equality
+ * @then equal content is equal, different content or type is not
+ */
+TEST(Multihash, CompareEqual) {
+  std::vector<uint8_t> hash{2, 3, 4};
+  std::vector<uint8_t> other{2, 3, 5};
+  auto hash1 = Multihash::create(HashType::sha256, hash).value();
+  auto hash2 = Multihash::create(HashType::sha256, hash).value();
+  ASSERT_EQ(hash1, hash2);
+  ASSERT_EQ(hash1.stdHash(), hash2.stdHash());
+  ASSERT_NE(hash1, Multihash::create(HashType::sha256, other).value());
+  ASSERT_NE(hash1, Multihash::create(HashType::blake2s128, hash).value());
+}
+
+/**
+ * @given buffer with a multihash
+ * @when creating a view of it
+ * @then view references the buffer and converts to equal multihash
+ */
+TEST(Multihash, View) {
+  auto bytes = "1203020304"_unhex;
+  auto view = MultihashView::create(bytes).value();
+  ASSERT_EQ(view.getType(), HashType::sha256);
+  ASSERT_EQ(view.getHash().data(), bytes.data() + 2);
+  ASSERT_EQ(view.toMultihash(), "1203020304"_multihash);
+
+  ASSERT_FALSE(MultihashView::create("120302"_unhex));
+  ASSERT_FALSE(MultihashView::create("12000102"_unhex));
+}
@@ -12,6 +12,8 @@
 #include <qtils/unhex.hpp>
 
 using libp2p::Bytes;
+using libp2p::multi::converters::appendMultiaddrBytes;
+using libp2p::multi::converters::appendMultiaddrString;
 using libp2p::multi::converters::bytesToMultiaddrString;
 using libp2p::multi::converters::ConversionError;
 using libp2p::multi::converters::multiaddrToBytes;
@@ -50,6 +52,8 @@ TEST(AddressConverter, StringToBytes) {
   EXAMINE_STR_TO_BYTES("/udp/0", "91020000");
   EXAMINE_STR_TO_BYTES("/udp/1234", "910204D2");
 
+  EXAMINE_STR_TO_BYTES("/memory/1234", "890600000000000004D2");
+
   EXAMINE_STR_TO_BYTES("/ws", "DD03");
   EXAMINE_STR_TO_BYTES("/wss", "DE03");
 
@@ -98,6 +102,8 @@ TEST(AddressConverter, BytesToString) {
   EXAMINE_BYTES_TO_STR("/udp/0", "91020000");
   EXAMINE_BYTES_TO_STR("/udp/1234", "910204D2");
 
+  EXAMINE_BYTES_TO_STR("/memory/1234", "890600000000000004D2");
+
   EXAMINE_BYTES_TO_STR("/ws", "DD03");
   EXAMINE_BYTES_TO_STR("/wss", "DE03");
 
@@ -140,4 +146,22 @@ TEST(AddressConverter, InvalidAddresses) {
                        ConversionError::INVALID_ADDRESS);
   ASSERT_OUTCOME_ERROR(multiaddrToBytes("/tcp/udp"),
                        ConversionError::INVALID_ADDRESS);
+  ASSERT_OUTCOME_ERROR(multiaddrToBytes("/memory/-1"),
+                       ConversionError::INVALID_ADDRESS);
+}
+
+/**
+ * @given output buffers with previous content
+ * @when appending conversions of multiaddrs to them
+ * @then conversions are appended after previous content
+ */
+TEST(AddressConverter, AppendToOutput) {
+  Bytes bytes;
+  ASSERT_OUTCOME_SUCCESS(appendMultiaddrBytes(bytes, "/ip4/127.0.0.1"));
+  ASSERT_OUTCOME_SUCCESS(appendMultiaddrBytes(bytes, "/tcp/1234/ws"));
+  ASSERT_EQ(bytes, qtils::unhex("047F0000010604D2DD03").value());
+
+  std::string str = "/dns4/example.org";
+  ASSERT_OUTCOME_SUCCESS(appendMultiaddrString(str, bytes));
+  ASSERT_EQ(str, "/dns4/example.org/ip4/127.0.0.1/tcp/1234/ws");
 }
@@ -100,3 +100,31 @@ TEST(UVaring, DecodeOverflowFailure) {
   auto var = UVarint::create(overflow_encoded_data);
   ASSERT_FALSE(var);
 }
+
+/**
+ * @given varints of all sizes, followed by other data or not
+ * @when decoding them
+ * @then the same value and size are decoded by word at once and byte by byte
+ */
+TEST(UVarint, DecodeWordAndTail) {
+  uint64_t x = 0;
+  while (true) {
+    UVarint varint{x};
+    libp2p::Bytes bytes{varint.toBytes().begin(), varint.toBytes().end()};
+    auto tail = UVarint::decode(bytes);
+    bytes.resize(bytes.size() + 8, 0xff);
+    auto word = UVarint::decode(bytes);
+    ASSERT_TRUE(tail);
+    ASSERT_TRUE(word);
+    EXPECT_EQ(tail->value, x);
+    EXPECT_EQ(word->value, x);
+    EXPECT_EQ(tail->size, varint.size());
+    EXPECT_EQ(word->size, varint.size());
+    if (x > std::numeric_limits<uint64_t>::max() / 3) {
+      break;
+    }
+    x = x * 3 + 1;
+  }
+  EXPECT_FALSE(UVarint::decode("FFFFFFFFFFFFFFFF"_unhex));
+  EXPECT_FALSE(UVarint::decode("FFFFFFFFFFFFFFFFFF7F"_unhex));
+}
@@ -0,0 +1,70 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/muxer/bandwidth_limiter.hpp>
+
+#include <gtest/gtest.h>
+
+#include "testutil/libp2p/peer.hpp"
+
+using libp2p::muxer::BandwidthDirection;
+using libp2p::muxer::BandwidthLimits;
+using libp2p::muxer::BandwidthManager;
+using libp2p::muxer::TokenBucket;
+
+/**
+ * @given token bucket with burst of 100 bytes refilled at 1 byte per second
+ * @when its tokens are consumed
+ * @then no more bytes may pass, waiting time grows with bytes requested
+ */
+TEST(BandwidthLimiter, TokenBucket) {
+  TokenBucket bucket{{.bytes_per_second = 1, .burst = 100}};
+  ASSERT_EQ(bucket.available(1000), 100);
+  ASSERT_EQ(bucket.available(10), 10);
+  ASSERT_EQ(bucket.delay(100), TokenBucket::Clock::duration::zero());
+
+  bucket.consume(100);
+  ASSERT_EQ(bucket.available(10), 0);
+  ASSERT_GT(bucket.delay(10), std::chrono::seconds{9});
+  ASSERT_GT(bucket.delay(20), bucket.delay(10));
+  // waits for burst at most
+  ASSERT_LE(bucket.delay(1000), std::chrono::seconds{100});
+}
+
+/**
+ * @given bandwidth limits of upload per protocol, per peer and in total
+ * @when streams to two peers send data
+ * @then each stream is limited by narrowest of its buckets, download is not
+ * limited
+ */
+TEST(BandwidthLimiter, Manager) {
+  BandwidthLimits limits;
+  limits.upload.total = {.bytes_per_second = 1, .burst = 150};
+  limits.upload.peer = {.bytes_per_second = 1, .burst = 100};
+  limits.upload.protocols["/a"] = {.bytes_per_second = 1, .burst = 30};
+  BandwidthManager bandwidth{limits};
+  auto peer1 = testutil::randomPeerId();
+  auto peer2 = testutil::randomPeerId();
+
+  auto stream1 = bandwidth.limiter(BandwidthDirection::UPLOAD, peer1, {});
+  ASSERT_TRUE(stream1.limited());
+  // peer limit
+  ASSERT_EQ(stream1.available(1000), 100);
+  stream1.consume(100);
+  ASSERT_EQ(stream1.available(1000), 0);
+  ASSERT_GE(stream1.throttle(10), std::chrono::seconds{9});
+
+  // total limit
+  auto stream2 = bandwidth.limiter(BandwidthDirection::UPLOAD, peer2, {});
+  ASSERT_EQ(stream2.available(1000), 50);
+  // protocol limit
+  auto stream3 = bandwidth.limiter(BandwidthDirection::UPLOAD, peer2, "/a");
+  ASSERT_EQ(stream3.available(1000), 30);
+
+  auto download = bandwidth.limiter(BandwidthDirection::DOWNLOAD, peer1, {});
+  ASSERT_FALSE(download.limited());
+  ASSERT_EQ(download.available(1000), 1000);
+}
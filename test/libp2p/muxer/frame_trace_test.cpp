@@ -0,0 +1,94 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/muxer/frame_trace.hpp>
+
+#include <gtest/gtest.h>
+
+using libp2p::muxer::FrameRecorder;
+using libp2p::muxer::FrameTrace;
+using libp2p::muxer::FrameTraceSink;
+using libp2p::muxer::TracedFrame;
+using std::chrono::microseconds;
+
+namespace {
+  struct SinkMock : FrameTraceSink {
+    void onTrace(FrameTrace trace) override {
+      traces.emplace_back(std::move(trace));
+    }
+
+    std::vector<FrameTrace> traces;
+  };
+}  // namespace
+
+/**
+ * @given trace of yamux frames
+ * @when it is encoded and decoded
+ * @then the same trace is decoded, truncated encoding is rejected
+ */
+TEST(FrameTrace, EncodeDecode) {
+  FrameTrace trace{
+      .muxer = "/yamux/1.0.0",
+      .initiator = true,
+      .frames =
+          {
+              {.time = microseconds{0}, .stream_id = 1, .flags = 1},
+              {.time = microseconds{15},
+               .stream_id = 1,
+               .length = 65536,
+               .type = 0,
+               .flags = 4},
+              {.time = microseconds{2000000},
+               .stream_id = 1,
+               .length = 256 * 1024,
+               .type = 1,
+               .flags = 2,
+               .inbound = true},
+          },
+  };
+  auto bytes = trace.encode();
+  auto decoded = FrameTrace::decode(bytes);
+  ASSERT_TRUE(decoded) << decoded.error();
+  EXPECT_EQ(decoded.value().muxer, trace.muxer);
+  EXPECT_TRUE(decoded.value().initiator);
+  EXPECT_FALSE(decoded.value().truncated);
+  EXPECT_EQ(decoded.value().frames, trace.frames);
+
+  EXPECT_FALSE(
+      FrameTrace::decode(libp2p::BytesIn{bytes}.first(bytes.size() - 1)));
+  bytes.push_back(0);
+  EXPECT_FALSE(FrameTrace::decode(bytes));
+}
+
+/**
+ * @given sink installed after one recorder was created
+ * @when both recorders record frames and are destroyed
+ * @then only the later one passes its trace to sink
+ */
+TEST(FrameTrace, RecorderWithSink) {
+  auto sink = std::make_shared<SinkMock>();
+  {
+    FrameRecorder before{"/mplex/6.7.0", false};
+    libp2p::muxer::setFrameTraceSink(sink);
+    FrameRecorder after{"/mplex/6.7.0", false};
+    libp2p::muxer::setFrameTraceSink(nullptr);
+    EXPECT_FALSE(before);
+    ASSERT_TRUE(after);
+    before.record(true, 0, 0, 3, 0);
+    after.record(true, 0, 0, 3, 0);
+    after.record(false, 0, 1, 3, 100);
+  }
+  ASSERT_EQ(sink->traces.size(), 1);
+  auto &trace = sink->traces[0];
+  EXPECT_EQ(trace.muxer, "/mplex/6.7.0");
+  EXPECT_FALSE(trace.initiator);
+  ASSERT_EQ(trace.frames.size(), 2);
+  EXPECT_TRUE(trace.frames[0].inbound);
+  EXPECT_FALSE(trace.frames[1].inbound);
+  EXPECT_EQ(trace.frames[1].flags, 1);
+  EXPECT_EQ(trace.frames[1].length, 100);
+  EXPECT_LE(trace.frames[0].time, trace.frames[1].time);
+}
@@ -0,0 +1,71 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/muxer/memory_budget.hpp>
+
+#include <gtest/gtest.h>
+
+#include "testutil/libp2p/peer.hpp"
+
+using libp2p::muxer::MemoryLimits;
+using libp2p::muxer::MemoryManager;
+using libp2p::muxer::MemoryReservation;
+
+/**
+ * @given memory manager with connection, peer and process limits
+ * @when connections to two peers reserve memory
+ * @then each reservation fits into connection, peer and process limits,
+ * failed reservation reserves nothing
+ */
+TEST(MemoryBudget, Limits) {
+  MemoryManager memory{{.connection = 100, .peer = 150, .process = 220}};
+  auto peer1 = testutil::randomPeerId();
+  auto peer2 = testutil::randomPeerId();
+
+  auto conn1 = memory.connectionScope(peer1);
+  auto conn2 = memory.connectionScope(peer1);
+  auto conn3 = memory.connectionScope(peer2);
+
+  ASSERT_FALSE(conn1->reserve(101));
+  ASSERT_TRUE(conn1->reserve(100));
+  // peer limit
+  ASSERT_FALSE(conn2->reserve(51));
+  ASSERT_TRUE(conn2->reserve(50));
+  ASSERT_TRUE(conn3->reserve(50));
+  // process limit
+  ASSERT_FALSE(conn3->reserve(21));
+  ASSERT_EQ(conn3->used(), 50);
+  ASSERT_EQ(memory.processScope().used(), 200);
+  ASSERT_TRUE(conn3->underPressure());
+
+  conn1->release(100);
+  ASSERT_TRUE(conn3->reserve(50));
+  ASSERT_EQ(memory.processScope().used(), 150);
+}
+
+/**
+ * @given reservations in connection scope
+ * @when reservations are destroyed
+ * @then their memory is returned to all scopes
+ */
+TEST(MemoryBudget, Reservation) {
+  MemoryManager memory{MemoryLimits{}};
+  auto conn = memory.connectionScope(testutil::randomPeerId());
+  {
+    MemoryReservation reservation{conn};
+    ASSERT_TRUE(reservation.reserve(10));
+    ASSERT_TRUE(reservation.reserve(20));
+    reservation.release(5);
+    ASSERT_EQ(reservation.size(), 25);
+    ASSERT_EQ(memory.processScope().used(), 25);
+  }
+  ASSERT_EQ(conn->used(), 0);
+  ASSERT_EQ(memory.processScope().used(), 0);
+
+  MemoryReservation unlimited;
+  ASSERT_TRUE(unlimited.reserve(MemoryLimits::kDefaultProcessLimit * 2));
+  ASSERT_FALSE(unlimited.underPressure());
+}
@@ -0,0 +1,101 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/muxer/mplex/mplex_frame.hpp>
+
+#include <gtest/gtest.h>
+
+using libp2p::Bytes;
+using namespace libp2p::connection;
+using Flag = MplexFrame::Flag;
+
+namespace {
+  /// Copies bytes into decoder buffer, as read from the connection
+  void feed(MplexFrameDecoder &decoder, const Bytes &bytes) {
+    auto buffer = decoder.buffer();
+    ASSERT_GE(buffer.size(), bytes.size());
+    std::copy(bytes.begin(), bytes.end(), buffer.begin());
+    decoder.onRead(bytes.size());
+  }
+}  // namespace
+
+/**
+ * @given bytes of two frames and the beginning of a third one
+ * @when they are read at once
+ * @then two frames are parsed, the third one is parsed after the rest of it
+ * is read
+ */
+TEST(MplexFrameDecoder, ParsesFramesReadAtOnce) {
+  auto wire = createFrameBytes(Flag::NEW_STREAM, 1);
+  auto data = createFrameBytes(Flag::MESSAGE_INITIATOR, 1, Bytes(10, 1));
+  auto last = createFrameBytes(Flag::CLOSE_RECEIVER, 2, Bytes(3, 2));
+  wire.insert(wire.end(), data.begin(), data.end());
+  wire.insert(wire.end(), last.begin(), last.begin() + 2);
+
+  MplexFrameDecoder decoder{1024};
+  feed(decoder, wire);
+
+  auto frame = decoder.next().value();
+  ASSERT_TRUE(frame);
+  ASSERT_EQ(frame->flag, Flag::NEW_STREAM);
+  ASSERT_EQ(frame->stream_number, 1);
+  ASSERT_TRUE(frame->data.empty());
+
+  frame = decoder.next().value();
+  ASSERT_TRUE(frame);
+  ASSERT_EQ(frame->flag, Flag::MESSAGE_INITIATOR);
+  ASSERT_EQ(Bytes(frame->data.begin(), frame->data.end()), Bytes(10, 1));
+
+  ASSERT_FALSE(decoder.next().value());
+
+  feed(decoder, Bytes(last.begin() + 2, last.end()));
+  frame = decoder.next().value();
+  ASSERT_TRUE(frame);
+  ASSERT_EQ(frame->flag, Flag::CLOSE_RECEIVER);
+  ASSERT_EQ(frame->stream_number, 2);
+  ASSERT_EQ(Bytes(frame->data.begin(), frame->data.end()), Bytes(3, 2));
+}
+
+/**
+ * @given frame larger than the buffer
+ * @when it is read in parts
+ * @then buffer grows to fit it
+ */
+TEST(MplexFrameDecoder, LargeFrame) {
+  auto wire = createFrameBytes(
+      Flag::MESSAGE_RECEIVER, 3, Bytes(2 * MplexFrameDecoder::kBufferSize, 3));
+  MplexFrameDecoder decoder{wire.size()};
+
+  size_t offset = 0;
+  while (offset < wire.size()) {
+    auto buffer = decoder.buffer();
+    auto size = std::min(buffer.size(), wire.size() - offset);
+    std::copy_n(wire.begin() + offset, size, buffer.begin());
+    decoder.onRead(size);
+    offset += size;
+    if (offset < wire.size()) {
+      ASSERT_FALSE(decoder.next().value());
+    }
+  }
+  auto frame = decoder.next().value();
+  ASSERT_TRUE(frame);
+  ASSERT_EQ(frame->data.size(), 2 * MplexFrameDecoder::kBufferSize);
+}
+
+/**
+ * @given frames with too large data and with unknown flag
+ * @when they are parsed
+ * @then errors are returned
+ */
+TEST(MplexFrameDecoder, InvalidFrames) {
+  MplexFrameDecoder too_large{10};
+  feed(too_large, createFrameBytes(Flag::MESSAGE_RECEIVER, 1, Bytes(11)));
+  ASSERT_FALSE(too_large.next());
+
+  MplexFrameDecoder unknown_flag{10};
+  feed(unknown_flag, Bytes{(1 << 3) | 7, 0});
+  ASSERT_FALSE(unknown_flag.next());
+}
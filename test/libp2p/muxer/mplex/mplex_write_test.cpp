@@ -0,0 +1,159 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/muxer/mplex/mplexed_connection.hpp>
+
+#include <gtest/gtest.h>
+
+#include <libp2p/muxer/mplex/mplex_frame.hpp>
+#include "mock/libp2p/connection/secure_connection_mock.hpp"
+#include "testutil/libp2p/peer.hpp"
+
+using libp2p::Bytes;
+using libp2p::BytesIn;
+using namespace libp2p::connection;
+using Flag = MplexFrame::Flag;
+using testing::Return;
+
+namespace {
+  /// Flag and stream number of a frame with small stream number
+  using FrameHeader = std::pair<Flag, uint32_t>;
+
+  /// Records frames of vectored writes, completes them on demand
+  class WireMock : public SecureConnectionMock {
+   public:
+    void writeSomeVectored(std::span<const BytesIn> in,
+                           WriteCallbackFunc cb) override {
+      batches.emplace_back();
+      size_t bytes = 0;
+      for (auto &frame : in) {
+        bytes += frame.size();
+        batches.back().emplace_back(static_cast<Flag>(frame[0] & 7),
+                                    frame[0] >> 3);
+      }
+      pending = [cb{std::move(cb)}, bytes] { cb(bytes); };
+    }
+
+    void completeWrite() {
+      auto cb = std::move(pending);
+      pending = nullptr;
+      cb();
+    }
+
+    std::vector<std::vector<FrameHeader>> batches;
+    std::function<void()> pending;
+  };
+}  // namespace
+
+class MplexWriteTest : public ::testing::Test {
+ public:
+  void SetUp() override {
+    EXPECT_CALL(*wire, remotePeer()).WillRepeatedly(Return(peer));
+    EXPECT_CALL(*wire, isClosed()).WillRepeatedly(Return(false));
+  }
+
+  void TearDown() override {
+    while (wire->pending) {
+      wire->completeWrite();
+    }
+    EXPECT_CALL(*wire, close()).WillOnce(Return(outcome::success()));
+    std::ignore = connection->close();
+    wire->pending = nullptr;
+  }
+
+  void start(libp2p::muxer::MuxedConnectionConfig config = {}) {
+    connection = std::make_shared<MplexedConnection>(wire, config);
+    connection->start();
+  }
+
+  libp2p::peer::PeerId peer = testutil::randomPeerId();
+  std::shared_ptr<WireMock> wire = std::make_shared<WireMock>();
+  std::shared_ptr<MplexedConnection> connection;
+};
+
+/**
+ * @given connection writing a frame
+ * @when several streams queue frames meanwhile
+ * @then queued frames are written by one vectored write
+ */
+TEST_F(MplexWriteTest, CoalescesFrames) {
+  start();
+  auto stream1 = connection->newStream().value();
+  auto stream2 = connection->newStream().value();
+  Bytes data(100, 1);
+  size_t written = 0;
+  stream1->writeSome(data, data.size(), [&](auto res) { written += res.value(); });
+  stream2->writeSome(data, data.size(), [&](auto res) { written += res.value(); });
+  ASSERT_EQ(wire->batches.size(), 1);
+
+  wire->completeWrite();
+  ASSERT_EQ(wire->batches.size(), 2);
+  ASSERT_EQ(wire->batches[1],
+            (std::vector<FrameHeader>{{Flag::NEW_STREAM, 2},
+                                      {Flag::MESSAGE_INITIATOR, 1},
+                                      {Flag::MESSAGE_INITIATOR, 2}}));
+  wire->completeWrite();
+  ASSERT_EQ(written, 2 * data.size());
+}
+
+/**
+ * @given connection with write queue limit
+ * @when stream data would exceed the limit
+ * @then the write waits until the queue drains, close of that stream waits
+ * after it, other frames are not delayed
+ */
+TEST_F(MplexWriteTest, ConnectionQueueLimit) {
+  libp2p::muxer::MuxedConnectionConfig config;
+  config.maximum_connection_write_queue_size = 100;
+  start(config);
+  auto stream1 = connection->newStream().value();
+  auto stream2 = connection->newStream().value();
+  wire->completeWrite();
+  wire->completeWrite();
+
+  Bytes data(80, 1);
+  bool written1 = false;
+  bool written2 = false;
+  bool closed2 = false;
+  stream1->writeSome(data, data.size(), [&](auto res) { written1 = !!res; });
+  stream2->writeSome(data, data.size(), [&](auto res) { written2 = !!res; });
+  stream2->close([&](auto res) { closed2 = !!res; });
+  stream1->close([](auto) {});
+  ASSERT_EQ(wire->batches.back(),
+            (std::vector<FrameHeader>{{Flag::MESSAGE_INITIATOR, 1}}));
+
+  wire->completeWrite();
+  ASSERT_TRUE(written1);
+  ASSERT_FALSE(written2);
+  ASSERT_EQ(wire->batches.back(),
+            (std::vector<FrameHeader>{{Flag::CLOSE_INITIATOR, 1},
+                                      {Flag::MESSAGE_INITIATOR, 2},
+                                      {Flag::CLOSE_INITIATOR, 2}}));
+  wire->completeWrite();
+  ASSERT_TRUE(written2);
+  ASSERT_TRUE(closed2);
+}
+
+/**
+ * @given stream with write queue limit
+ * @when writes queued while stream is writing exceed the limit
+ * @then the exceeding write fails
+ */
+TEST_F(MplexWriteTest, StreamQueueLimit) {
+  libp2p::muxer::MuxedConnectionConfig config;
+  config.maximum_stream_write_queue_size = 100;
+  start(config);
+  auto stream = connection->newStream().value();
+
+  Bytes data(100, 1);
+  stream->writeSome(data, 10, [](auto) {});
+  stream->writeSome(data, data.size(), [](auto res) { ASSERT_TRUE(res); });
+  bool failed = false;
+  stream->writeSome(data, 1, [&](auto res) {
+    failed = res.error() == Stream::Error::STREAM_WRITE_OVERFLOW;
+  });
+  ASSERT_TRUE(failed);
+}
@@ -0,0 +1,109 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/muxer/stream_limits.hpp>
+
+#include <gtest/gtest.h>
+
+#include "testutil/libp2p/peer.hpp"
+
+using libp2p::muxer::StreamDirection;
+using libp2p::muxer::StreamLimits;
+using libp2p::muxer::StreamManager;
+using libp2p::muxer::StreamPermit;
+
+const auto kIn = StreamDirection::INBOUND;
+const auto kOut = StreamDirection::OUTBOUND;
+
+/**
+ * @given stream manager with peer and process limits
+ * @when streams with two peers are admitted
+ * @then each stream fits into peer and process limits of its direction,
+ * released permits count no more
+ */
+TEST(StreamLimits, PeerAndProcess) {
+  StreamManager streams{{.process = {.inbound = 3, .outbound = 1},
+                         .peer = {.inbound = 2}}};
+  auto peer1 = streams.peerScope(testutil::randomPeerId());
+  auto peer2 = streams.peerScope(testutil::randomPeerId());
+
+  auto in1 = peer1->admit(kIn);
+  auto in2 = peer1->admit(kIn);
+  ASSERT_TRUE(in1);
+  ASSERT_TRUE(in2);
+  // peer limit
+  ASSERT_FALSE(peer1->admit(kIn));
+  auto in3 = peer2->admit(kIn);
+  ASSERT_TRUE(in3);
+  // process limit
+  ASSERT_FALSE(peer2->admit(kIn));
+  ASSERT_EQ(peer2->count(kIn), 1);
+  ASSERT_EQ(streams.processScope().count(kIn), 3);
+
+  // directions are counted separately
+  auto out = peer2->admit(kOut);
+  ASSERT_TRUE(out);
+  ASSERT_FALSE(peer1->admit(kOut));
+
+  in1.reset();
+  ASSERT_TRUE(peer2->admit(kIn));
+  ASSERT_EQ(streams.processScope().count(kIn), 2);
+}
+
+/**
+ * @given stream manager with per protocol limits
+ * @when admitted streams negotiate protocols
+ * @then streams fit into protocol limits of peer and process, stream of
+ * protocol without limits is not counted
+ */
+TEST(StreamLimits, Protocols) {
+  StreamLimits limits;
+  limits.protocols["/a"] = {.process = {.inbound = 2}, .peer = {.inbound = 1}};
+  StreamManager streams{limits};
+  auto peer1 = streams.peerScope(testutil::randomPeerId());
+  auto peer2 = streams.peerScope(testutil::randomPeerId());
+
+  auto s1 = peer1->admit(kIn).value();
+  auto s2 = peer1->admit(kIn).value();
+  auto s3 = peer2->admit(kIn).value();
+  auto s4 = peer2->admit(kIn).value();
+  ASSERT_TRUE(s1.admitProtocol("/a"));
+  // peer limit
+  ASSERT_FALSE(s2.admitProtocol("/a"));
+  ASSERT_TRUE(s2.admitProtocol("/b"));
+  ASSERT_TRUE(s3.admitProtocol("/a"));
+  ASSERT_FALSE(s4.admitProtocol("/a"));
+  ASSERT_EQ(streams.processScope().count(kIn, "/a"), 2);
+  ASSERT_EQ(streams.processScope().count(kIn, "/b"), 0);
+
+  {
+    auto moved = std::move(s1);
+  }
+  ASSERT_EQ(peer1->count(kIn), 1);
+  ASSERT_EQ(peer1->count(kIn, "/a"), 0);
+  // protocol of stream may be changed
+  ASSERT_TRUE(s2.admitProtocol("/a"));
+  ASSERT_EQ(streams.processScope().count(kIn, "/a"), 2);
+
+  StreamPermit unlimited;
+  ASSERT_TRUE(unlimited.admitProtocol("/a"));
+}
+
+/**
+ * @given connections to the same peer
+ * @when they get stream scopes
+ * @then scope is shared while any connection holds it
+ */
+TEST(StreamLimits, PeerScopeShared) {
+  StreamManager streams{{.peer = {.outbound = 1}}};
+  auto peer = testutil::randomPeerId();
+  auto conn1 = streams.peerScope(peer);
+  auto conn2 = streams.peerScope(peer);
+  ASSERT_EQ(conn1, conn2);
+  auto permit = conn1->admit(kOut);
+  ASSERT_TRUE(permit);
+  ASSERT_FALSE(conn2->admit(kOut));
+}
@@ -0,0 +1,114 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/muxer/yamux/yamux_reading_state.hpp>
+
+#include <gtest/gtest.h>
+
+using libp2p::Bytes;
+using libp2p::BytesOut;
+using namespace libp2p::connection;
+
+class YamuxReadingStateTest : public ::testing::Test {
+ public:
+  static constexpr YamuxFrame::StreamId kStreamId = 3;
+
+  YamuxReadingState state{
+      [this](boost::optional<YamuxFrame> header) {
+        headers.push_back(header);
+        return header.has_value();
+      },
+      [this](BytesOut segment, YamuxFrame::StreamId, bool, bool fin) {
+        received.insert(received.end(), segment.begin(), segment.end());
+        fin_received = fin_received || fin;
+      }};
+
+  std::vector<boost::optional<YamuxFrame>> headers;
+  Bytes received;
+  bool fin_received = false;
+};
+
+/**
+ * @given data frame header with part of its payload
+ * @when the rest of payload is read directly into stream's buffer
+ * @then reading state expects the rest of payload, then returns FIN flag
+ * and expects next header
+ */
+TEST_F(YamuxReadingStateTest, DirectReadCompletesMessage) {
+  Bytes wire = YamuxFrame::frameBytes(YamuxFrame::kDefaultVersion,
+                                      YamuxFrame::FrameType::DATA,
+                                      YamuxFrame::Flag::FIN,
+                                      kStreamId,
+                                      100);
+  wire.insert(wire.end(), 10, 0x55);
+
+  BytesOut bytes(wire);
+  state.onDataReceived(bytes);
+
+  ASSERT_EQ(headers.size(), 1);
+  ASSERT_EQ(received.size(), 10);
+  ASSERT_FALSE(fin_received);
+
+  auto expected = state.expectedData();
+  ASSERT_EQ(expected.first, kStreamId);
+  ASSERT_EQ(expected.second, 90);
+
+  auto flags = state.onDataReadDirectly(40);
+  ASSERT_FALSE(flags.first);
+  ASSERT_FALSE(flags.second);
+  ASSERT_EQ(state.expectedData().second, 50);
+
+  flags = state.onDataReadDirectly(50);
+  ASSERT_FALSE(flags.first);
+  ASSERT_TRUE(flags.second);
+  ASSERT_EQ(state.expectedData().first, 0);
+  ASSERT_EQ(state.expectedData().second, 0);
+}
+
+/**
+ * @given data frame of discarded stream
+ * @when payload is partially received
+ * @then no stream expects the rest of payload
+ */
+TEST_F(YamuxReadingStateTest, DiscardedDataIsNotExpected) {
+  Bytes wire = dataMsg(kStreamId, 100, false);
+  wire.insert(wire.end(), 10, 0x55);
+
+  BytesOut bytes(wire);
+  state.onDataReceived(bytes);
+  state.discardDataMessage();
+
+  ASSERT_EQ(state.expectedData().first, 0);
+}
+
+/**
+ * @given data frame being read directly into stream's buffer
+ * @when the message is discarded before the read completes
+ * @then the read is accounted without flags, and the next header is expected
+ */
+TEST_F(YamuxReadingStateTest, DiscardedDuringDirectRead) {
+  Bytes wire = YamuxFrame::frameBytes(YamuxFrame::kDefaultVersion,
+                                      YamuxFrame::FrameType::DATA,
+                                      YamuxFrame::Flag::FIN,
+                                      kStreamId,
+                                      100);
+  BytesOut bytes(wire);
+  state.onDataReceived(bytes);
+  ASSERT_EQ(state.expectedData().first, kStreamId);
+
+  state.discardDataMessage();
+  auto flags = state.onDataReadDirectly(100);
+  ASSERT_FALSE(flags.first);
+  ASSERT_FALSE(flags.second);
+  ASSERT_EQ(state.expectedData().second, 0);
+
+  Bytes next = dataMsg(kStreamId, 1, false);
+  next.push_back(0x55);
+  bytes = next;
+  state.onDataReceived(bytes);
+  ASSERT_EQ(headers.size(), 2);
+  ASSERT_EQ(received, Bytes{0x55});
+}
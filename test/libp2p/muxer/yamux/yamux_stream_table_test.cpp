@@ -0,0 +1,64 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/muxer/yamux/yamux_stream_table.hpp>
+
+#include <gtest/gtest.h>
+
+using namespace libp2p::connection;
+using StreamId = YamuxStreamTable::StreamId;
+
+/**
+ * @given table with streams of both parities
+ * @when some streams are erased out of order
+ * @then the rest are found by their ids, erased ones are not
+ */
+TEST(YamuxStreamTable, FindsStreamsOfBothSides) {
+  YamuxStreamTable table;
+  for (StreamId id = 1; id <= 20; ++id) {
+    table.insert(id, nullptr);
+  }
+  for (StreamId id : {4, 1, 20, 7, 8}) {
+    table.erase(id);
+  }
+  ASSERT_EQ(table.size(), 15);
+  for (StreamId id = 1; id <= 20; ++id) {
+    auto erased = id == 4 or id == 1 or id == 20 or id == 7 or id == 8;
+    ASSERT_EQ(table.contains(id), not erased) << id;
+    if (not erased) {
+      ASSERT_EQ(table.find(id)->first, id);
+    }
+  }
+  ASSERT_EQ(table.find(21), table.end());
+}
+
+/**
+ * @given long lived stream
+ * @when many more streams are opened and closed after it
+ * @then long lived stream is still found, table keeps working for new ones
+ */
+TEST(YamuxStreamTable, LongLivedStreamMovesToOverflow) {
+  YamuxStreamTable table;
+  table.insert(1, nullptr);
+  StreamId id = 3;
+  for (size_t i = 0; i < YamuxStreamTable::kMaxWindow * 2; ++i, id += 2) {
+    table.insert(id, nullptr);
+    if (i % 2 == 0) {
+      table.erase(id);
+    }
+  }
+  ASSERT_TRUE(table.contains(1));
+  ASSERT_TRUE(table.contains(5));
+  ASSERT_FALSE(table.contains(3));
+  ASSERT_TRUE(table.contains(id - 2));
+  ASSERT_EQ(table.size(), 1 + YamuxStreamTable::kMaxWindow);
+
+  table.erase(1);
+  ASSERT_FALSE(table.contains(1));
+  for (auto &[stream_id, stream] : table) {
+    ASSERT_EQ(table.find(stream_id)->first, stream_id);
+  }
+}
@@ -0,0 +1,161 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/muxer/yamux/yamux_stream.hpp>
+
+#include <gtest/gtest.h>
+
+#include <libp2p/muxer/yamux/yamux_frame.hpp>
+#include "mock/libp2p/connection/secure_connection_mock.hpp"
+
+using libp2p::Bytes;
+using libp2p::BytesIn;
+using namespace libp2p::connection;
+using testing::_;
+
+namespace {
+  class FeedbackStub : public YamuxStreamFeedback {
+   public:
+    void writeStreamData(uint32_t, std::span<const BytesIn>) override {}
+
+    void ackReceivedBytes(uint32_t, uint32_t bytes) override {
+      acked += bytes;
+    }
+
+    std::chrono::microseconds rtt() const override {
+      return rtt_value;
+    }
+
+    size_t growReceiveWindow(size_t bytes) override {
+      bytes = std::min(bytes, budget - growth);
+      growth += bytes;
+      return bytes;
+    }
+
+    void shrinkReceiveWindow(size_t bytes) override {
+      growth -= bytes;
+    }
+
+    bool receiveWindowPressure() const override {
+      return growth >= budget;
+    }
+
+    void deferCall(std::function<void()> cb) override {
+      cb();
+    }
+
+    libp2p::basic::Scheduler::Handle scheduleCall(
+        std::function<void()>, std::chrono::milliseconds) override {
+      return {};
+    }
+
+    void resetStream(uint32_t) override {}
+
+    void streamClosed(uint32_t) override {}
+
+    void deferUntilDataReleased(uint32_t, std::function<void()> cb) override {
+      cb();
+    }
+
+    std::chrono::microseconds rtt_value{};
+    size_t budget = 0;
+    size_t growth = 0;
+    size_t acked = 0;
+  };
+}  // namespace
+
+class YamuxWindowTuningTest : public ::testing::Test {
+ public:
+  static constexpr size_t kWindow = YamuxFrame::kInitialWindowSize;
+
+  void SetUp() override {
+    EXPECT_CALL(*connection, remotePeer())
+        .WillRepeatedly([]() -> outcome::result<libp2p::peer::PeerId> {
+          return std::make_error_code(std::errc::not_connected);
+        });
+    EXPECT_CALL(*connection, deferReadCallback(_, _))
+        .WillRepeatedly([](auto res, auto cb) { cb(res); });
+    stream = std::make_shared<YamuxStream>(
+        connection, feedback, 1, 16 * kWindow, 16 * kWindow, true);
+  }
+
+  /// Peer sends bytes, then the reader consumes them
+  YamuxStream::DataFromConnectionResult receiveAndConsume(size_t bytes) {
+    Bytes data(bytes, 0x11);
+    auto r = stream->onDataReceived(data);
+    if (r != YamuxStream::kKeepStream) {
+      return r;
+    }
+    Bytes out(bytes);
+    stream->readSome(out, out.size(), [](auto res) { ASSERT_TRUE(res); });
+    return r;
+  }
+
+  std::shared_ptr<SecureConnectionMock> connection =
+      std::make_shared<SecureConnectionMock>();
+  FeedbackStub feedback;
+  std::shared_ptr<YamuxStream> stream;
+};
+
+/**
+ * @given stream whose reader consumes whole window within one round trip
+ * @when windows are consumed repeatedly
+ * @then receive window doubles each time until connection budget is spent,
+ * and peer may send the grown window without overflow
+ */
+TEST_F(YamuxWindowTuningTest, GrowsWhileReaderKeepsUp) {
+  feedback.rtt_value = std::chrono::seconds(10);
+  feedback.budget = 3 * kWindow;
+
+  ASSERT_EQ(receiveAndConsume(kWindow), YamuxStream::kKeepStream);
+  ASSERT_EQ(feedback.acked, 2 * kWindow);
+  ASSERT_EQ(stream->receiveWindowGrowth(), kWindow);
+
+  ASSERT_EQ(receiveAndConsume(2 * kWindow), YamuxStream::kKeepStream);
+  ASSERT_EQ(feedback.acked, 6 * kWindow);
+  ASSERT_EQ(stream->receiveWindowGrowth(), 3 * kWindow);
+
+  // budget is spent
+  ASSERT_EQ(receiveAndConsume(4 * kWindow), YamuxStream::kKeepStream);
+  ASSERT_EQ(feedback.acked, 10 * kWindow);
+  ASSERT_EQ(stream->receiveWindowGrowth(), 3 * kWindow);
+
+  ASSERT_EQ(receiveAndConsume(4 * kWindow + 1),
+            YamuxStream::kRemoveStreamAndSendRst);
+}
+
+/**
+ * @given stream with grown receive window
+ * @when round trip is unknown, then reader is slow without and with
+ * connection budget exhausted
+ * @then window stays the same unless the budget is exhausted, then it is
+ * halved by acknowledging less than consumed
+ */
+TEST_F(YamuxWindowTuningTest, ShrinksUnderPressure) {
+  feedback.rtt_value = std::chrono::seconds(10);
+  feedback.budget = 4 * kWindow;
+  ASSERT_EQ(receiveAndConsume(kWindow), YamuxStream::kKeepStream);
+  ASSERT_EQ(receiveAndConsume(2 * kWindow), YamuxStream::kKeepStream);
+  ASSERT_EQ(stream->receiveWindowGrowth(), 3 * kWindow);
+
+  feedback.acked = 0;
+  feedback.rtt_value = {};
+  ASSERT_EQ(receiveAndConsume(4 * kWindow), YamuxStream::kKeepStream);
+  ASSERT_EQ(feedback.acked, 4 * kWindow);
+
+  feedback.rtt_value = std::chrono::microseconds(1);
+  ASSERT_EQ(receiveAndConsume(4 * kWindow), YamuxStream::kKeepStream);
+  ASSERT_EQ(feedback.acked, 8 * kWindow);
+
+  feedback.budget = 3 * kWindow;
+  ASSERT_EQ(receiveAndConsume(4 * kWindow), YamuxStream::kKeepStream);
+  ASSERT_EQ(feedback.acked, 10 * kWindow);
+  ASSERT_EQ(stream->receiveWindowGrowth(), kWindow);
+  ASSERT_EQ(feedback.growth, kWindow);
+
+  ASSERT_EQ(receiveAndConsume(2 * kWindow + 1),
+            YamuxStream::kRemoveStreamAndSendRst);
+}
@@ -0,0 +1,305 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/muxer/yamux/yamuxed_connection.hpp>
+
+#include <gtest/gtest.h>
+
+#include <libp2p/muxer/yamux/yamux_frame.hpp>
+#include "mock/libp2p/basic/scheduler_mock.hpp"
+#include "mock/libp2p/connection/secure_connection_mock.hpp"
+#include "testutil/libp2p/peer.hpp"
+
+using libp2p::Bytes;
+using libp2p::BytesIn;
+using libp2p::basic::SchedulerMock;
+using namespace libp2p::connection;
+using testing::_;
+using testing::NiceMock;
+using testing::Return;
+
+namespace {
+  /// Records buffers of vectored writes, completes them by given bytes
+  class WireMock : public SecureConnectionMock {
+   public:
+    void writeSomeVectored(std::span<const BytesIn> in,
+                           WriteCallbackFunc cb) override {
+      writes.emplace_back(in.begin(), in.end());
+      pending = std::move(cb);
+    }
+
+    /// Completes pending write with bytes written
+    void complete(size_t bytes) {
+      auto cb = std::move(pending);
+      pending = nullptr;
+      cb(bytes);
+    }
+
+    /// Completes pending write as whole
+    void completeAll() {
+      complete(size(writes.back()));
+    }
+
+    static size_t size(const std::vector<BytesIn> &buffers) {
+      size_t bytes = 0;
+      for (auto &buffer : buffers) {
+        bytes += buffer.size();
+      }
+      return bytes;
+    }
+
+    /// Frames of write, with their payloads
+    static std::vector<std::pair<YamuxFrame, Bytes>> frames(
+        const std::vector<BytesIn> &buffers) {
+      Bytes bytes;
+      for (auto &buffer : buffers) {
+        bytes.insert(bytes.end(), buffer.begin(), buffer.end());
+      }
+      std::vector<std::pair<YamuxFrame, Bytes>> frames;
+      BytesIn rest{bytes};
+      while (not rest.empty()) {
+        auto frame = parseFrame(rest.first(YamuxFrame::kHeaderLength));
+        EXPECT_TRUE(frame);
+        if (not frame) {
+          break;
+        }
+        rest = rest.subspan(YamuxFrame::kHeaderLength);
+        Bytes payload;
+        if (frame->type == YamuxFrame::FrameType::DATA) {
+          payload.assign(rest.begin(), rest.begin() + frame->length);
+          rest = rest.subspan(frame->length);
+        }
+        frames.emplace_back(*frame, std::move(payload));
+      }
+      return frames;
+    }
+
+    std::vector<std::vector<BytesIn>> writes;
+    WriteCallbackFunc pending;
+  };
+}  // namespace
+
+class YamuxWriteBatchTest : public ::testing::Test {
+ public:
+  void SetUp() override {
+    EXPECT_CALL(*wire, remotePeer()).WillRepeatedly(Return(peer));
+    EXPECT_CALL(*wire, isInitiator_hack()).WillRepeatedly(Return(true));
+    ON_CALL(*wire, close()).WillByDefault(Return(outcome::success()));
+    ON_CALL(*wire, readSome(_, _, _))
+        .WillByDefault([](libp2p::BytesOut, size_t, auto) {});
+    libp2p::muxer::MuxedConnectionConfig config;
+    config.ping_interval = {};
+    config.window_auto_tuning = false;
+    connection =
+        std::make_shared<YamuxedConnection>(wire, scheduler, nullptr, config);
+    connection->start();
+  }
+
+  void TearDown() override {
+    while (wire->pending) {
+      wire->completeAll();
+    }
+    std::ignore = connection->close();
+    wire->pending = nullptr;
+  }
+
+  /// True if any buffer of write refers to bytes of data
+  static bool refers(const std::vector<BytesIn> &buffers, const Bytes &data) {
+    return std::ranges::any_of(buffers, [&](const BytesIn &buffer) {
+      return buffer.data() >= data.data()
+         and buffer.data() < data.data() + data.size();
+    });
+  }
+
+  libp2p::peer::PeerId peer = testutil::randomPeerId();
+  std::shared_ptr<WireMock> wire = std::make_shared<WireMock>();
+  std::shared_ptr<NiceMock<SchedulerMock>> scheduler =
+      std::make_shared<NiceMock<SchedulerMock>>();
+  std::shared_ptr<YamuxedConnection> connection;
+};
+
+/**
+ * @given write of two data frames of different streams
+ * @when connection writes it partially, ending inside payload of the first
+ * frame and then inside header of the second one
+ * @then the next writes continue from the first unwritten byte, payloads are
+ * not copied, and write callbacks are called once the whole batch is written
+ */
+TEST_F(YamuxWriteBatchTest, PartialWriteAcrossFrames) {
+  auto busy = connection->newStream().value();
+  auto first = connection->newStream().value();
+  auto second = connection->newStream().value();
+  Bytes busy_data(10, 0);
+  busy->writeSome(busy_data, busy_data.size(), [](auto) {});
+  ASSERT_EQ(wire->writes.size(), 1);
+
+  Bytes first_data(100, 1);
+  Bytes second_data(100, 2);
+  std::optional<outcome::result<size_t>> first_written;
+  std::optional<outcome::result<size_t>> second_written;
+  first->writeSome(first_data, first_data.size(), [&](auto res) {
+    first_written = res;
+  });
+  second->writeSome(second_data, second_data.size(), [&](auto res) {
+    second_written = res;
+  });
+  wire->completeAll();
+
+  ASSERT_EQ(wire->writes.size(), 2);
+  auto batch = wire->writes[1];
+  ASSERT_EQ(batch.size(), 4);
+  EXPECT_EQ(batch[1].data(), first_data.data());
+  EXPECT_EQ(batch[3].data(), second_data.data());
+  auto frames = WireMock::frames(batch);
+  ASSERT_EQ(frames.size(), 2);
+  EXPECT_EQ(frames[0].second, first_data);
+  EXPECT_EQ(frames[1].second, second_data);
+
+  wire->complete(YamuxFrame::kHeaderLength + 40);
+  ASSERT_EQ(wire->writes.size(), 3);
+  auto rest = wire->writes[2];
+  ASSERT_EQ(rest.size(), 3);
+  EXPECT_EQ(rest[0].data(), first_data.data() + 40);
+  EXPECT_EQ(rest[0].size(), 60);
+  EXPECT_FALSE(first_written);
+
+  wire->complete(60 + 5);
+  ASSERT_EQ(wire->writes.size(), 4);
+  auto header_rest = wire->writes[3];
+  ASSERT_EQ(header_rest.size(), 2);
+  EXPECT_EQ(header_rest[0].data(), batch[2].data() + 5);
+  EXPECT_EQ(header_rest[0].size(), YamuxFrame::kHeaderLength - 5);
+  EXPECT_EQ(header_rest[1].data(), second_data.data());
+  EXPECT_FALSE(first_written);
+  EXPECT_FALSE(second_written);
+
+  wire->completeAll();
+  ASSERT_TRUE(first_written);
+  EXPECT_EQ(first_written->value(), first_data.size());
+  ASSERT_TRUE(second_written);
+  EXPECT_EQ(second_written->value(), second_data.size());
+  EXPECT_FALSE(wire->pending);
+}
+
+/**
+ * @given write which reports more bytes than were given
+ * @when it completes
+ * @then connection is closed with error, and write callback gets error
+ */
+TEST_F(YamuxWriteBatchTest, WrittenMoreThanGiven) {
+  auto stream = connection->newStream().value();
+  Bytes data(10, 1);
+  std::optional<outcome::result<size_t>> written;
+  stream->writeSome(data, data.size(), [&](auto res) { written = res; });
+  ASSERT_EQ(wire->writes.size(), 1);
+
+  wire->complete(WireMock::size(wire->writes[0]) + 1);
+  EXPECT_TRUE(connection->isClosed());
+  ASSERT_TRUE(written);
+  EXPECT_TRUE(written->has_error());
+}
+
+/**
+ * @given stream data being written
+ * @when the stream is reset
+ * @then its write callback is not called while the write refers to the data,
+ * and is called with error once the write completes
+ */
+TEST_F(YamuxWriteBatchTest, CallbacksDeferredUntilDataReleased) {
+  auto stream = connection->newStream().value();
+  Bytes data(100, 1);
+  std::optional<outcome::result<size_t>> written;
+  stream->writeSome(data, data.size(), [&](auto res) { written = res; });
+  ASSERT_EQ(wire->writes.size(), 1);
+  ASSERT_TRUE(refers(wire->writes[0], data));
+
+  stream->reset();
+  EXPECT_FALSE(written);
+
+  wire->complete(YamuxFrame::kHeaderLength + 50);
+  EXPECT_FALSE(written);
+
+  wire->completeAll();
+  ASSERT_TRUE(written);
+  EXPECT_TRUE(written->has_error());
+}
+
+/**
+ * @given stream data queued behind a write in progress
+ * @when the stream is reset and its write callback is called
+ * @then queued frames no longer refer to the data, which caller may free,
+ * and go to the wire with bytes the data had
+ */
+TEST_F(YamuxWriteBatchTest, ResetDetachesQueuedData) {
+  auto busy = connection->newStream().value();
+  auto stream = connection->newStream().value();
+  Bytes busy_data(10, 0);
+  busy->writeSome(busy_data, busy_data.size(), [](auto) {});
+  ASSERT_EQ(wire->writes.size(), 1);
+
+  Bytes data(100, 1);
+  std::optional<outcome::result<size_t>> written;
+  stream->writeSome(data, data.size(), [&](auto res) { written = res; });
+  stream->reset();
+  ASSERT_TRUE(written);
+  EXPECT_TRUE(written->has_error());
+  // freed by caller
+  std::ranges::fill(data, 0xff);
+
+  wire->completeAll();
+  ASSERT_EQ(wire->writes.size(), 2);
+  EXPECT_FALSE(refers(wire->writes[1], data));
+  auto frames = WireMock::frames(wire->writes[1]);
+  ASSERT_EQ(frames.size(), 2);
+  EXPECT_EQ(frames[0].first.stream_id, 3);
+  EXPECT_EQ(frames[0].second, Bytes(100, 1));
+  EXPECT_EQ(frames[1].first.stream_id, 3);
+  EXPECT_TRUE(frames[1].first.flagIsSet(YamuxFrame::Flag::RST));
+}
+
+/**
+ * @given more frames queued than one write may carry
+ * @when they are written
+ * @then each write carries at most kMaxFramesPerWrite frames, and all frames
+ * are written in order
+ */
+TEST_F(YamuxWriteBatchTest, FramesPerWriteCapped) {
+  constexpr size_t kStreams = 40;
+  std::vector<std::shared_ptr<Stream>> streams;
+  for (size_t i = 0; i < kStreams; ++i) {
+    streams.emplace_back(connection->newStream().value());
+  }
+  Bytes data(10, 1);
+  size_t written = 0;
+  for (auto &stream : streams) {
+    stream->writeSome(data, data.size(), [&](auto res) {
+      ASSERT_TRUE(res);
+      ++written;
+    });
+  }
+
+  std::vector<size_t> frames_per_write;
+  std::vector<uint32_t> ids;
+  while (wire->pending) {
+    auto frames = WireMock::frames(wire->writes.back());
+    frames_per_write.push_back(frames.size());
+    for (auto &[frame, _] : frames) {
+      ids.push_back(frame.stream_id);
+    }
+    wire->completeAll();
+  }
+  // the first frame goes alone, the rest are split by the cap
+  ASSERT_EQ(frames_per_write,
+            (std::vector<size_t>{
+                1,
+                YamuxedConnection::kMaxFramesPerWrite,
+                kStreams - 1 - YamuxedConnection::kMaxFramesPerWrite}));
+  ASSERT_EQ(ids.size(), kStreams);
+  for (size_t i = 0; i < kStreams; ++i) {
+    EXPECT_EQ(ids[i], 2 * i + 1);
+  }
+  EXPECT_EQ(written, kStreams);
+}
@@ -0,0 +1,496 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/muxer/yamux/yamuxed_connection.hpp>
+
+#include <gtest/gtest.h>
+
+#include <libp2p/muxer/yamux/yamux_frame.hpp>
+#include "mock/libp2p/basic/scheduler_mock.hpp"
+#include "mock/libp2p/connection/secure_connection_mock.hpp"
+#include "testutil/libp2p/peer.hpp"
+
+using libp2p::Bytes;
+using libp2p::BytesIn;
+using libp2p::basic::SchedulerMock;
+using namespace libp2p::connection;
+using testing::_;
+using testing::NiceMock;
+using testing::Return;
+
+namespace {
+  /// Records frames of vectored writes, completes them on demand
+  class WireMock : public SecureConnectionMock {
+   public:
+    void writeSomeVectored(std::span<const BytesIn> in,
+                           WriteCallbackFunc cb) override {
+      batches.emplace_back();
+      size_t bytes = 0;
+      for (size_t i = 0; i < in.size(); ++i) {
+        bytes += in[i].size();
+        auto frame = libp2p::connection::parseFrame(in[i]);
+        ASSERT_TRUE(frame);
+        batches.back().push_back(*frame);
+        if (frame->type == YamuxFrame::FrameType::DATA and frame->length > 0
+            and in[i].size() == YamuxFrame::kHeaderLength) {
+          // payload buffers follow
+          size_t payload = 0;
+          while (payload < frame->length) {
+            ++i;
+            payload += in[i].size();
+          }
+          bytes += payload;
+        }
+      }
+      pending = [cb{std::move(cb)}, bytes] { cb(bytes); };
+    }
+
+    void completeWrite() {
+      auto cb = std::move(pending);
+      pending = nullptr;
+      cb();
+    }
+
+    std::vector<std::vector<YamuxFrame>> batches;
+    std::function<void()> pending;
+  };
+}  // namespace
+
+class YamuxWriteSchedulingTest : public ::testing::Test {
+ public:
+  void SetUp() override {
+    EXPECT_CALL(*wire, remotePeer()).WillRepeatedly(Return(peer));
+    EXPECT_CALL(*wire, isInitiator_hack()).WillRepeatedly(Return(true));
+    ON_CALL(*wire, close()).WillByDefault(Return(outcome::success()));
+    ON_CALL(*wire, readSome(_, _, _))
+        .WillByDefault([this](libp2p::BytesOut out, size_t, auto cb) {
+          read_out = out;
+          read_cb = std::move(cb);
+        });
+    libp2p::muxer::MuxedConnectionConfig config;
+    config.ping_interval = {};
+    config.window_auto_tuning = false;
+    connection =
+        std::make_shared<YamuxedConnection>(wire, scheduler, nullptr, config);
+    connection->start();
+  }
+
+  void TearDown() override {
+    writeAll();
+    std::ignore = connection->close();
+    wire->pending = nullptr;
+  }
+
+  /// Completes writes until nothing is left to write
+  void writeAll() {
+    while (wire->pending) {
+      auto batches = wire->batches.size();
+      wire->completeWrite();
+      if (wire->batches.size() == batches) {
+        break;
+      }
+    }
+  }
+
+  /// Data frames with payload of the batch, in order, as stream ids
+  static std::vector<uint32_t> dataFrames(
+      const std::vector<YamuxFrame> &batch) {
+    std::vector<uint32_t> ids;
+    for (auto &frame : batch) {
+      if (frame.type == YamuxFrame::FrameType::DATA and frame.length > 0) {
+        ids.push_back(frame.stream_id);
+      }
+    }
+    return ids;
+  }
+
+  libp2p::peer::PeerId peer = testutil::randomPeerId();
+  std::shared_ptr<WireMock> wire = std::make_shared<WireMock>();
+  std::shared_ptr<NiceMock<SchedulerMock>> scheduler =
+      std::make_shared<NiceMock<SchedulerMock>>();
+  std::shared_ptr<YamuxedConnection> connection;
+  libp2p::BytesOut read_out;
+  libp2p::basic::Reader::ReadCallbackFunc read_cb;
+};
+
+/**
+ * @given bulk stream with whole send window queued and stream with small
+ * message queued after it
+ * @when frames are written
+ * @then small message is not delayed behind the bulk data, control frames go
+ * before data of both
+ */
+TEST_F(YamuxWriteSchedulingTest, StreamsTakeTurns) {
+  auto bulk = connection->newStream().value();
+  auto rpc = connection->newStream().value();
+  Bytes bulk_data(YamuxFrame::kInitialWindowSize, 1);
+  Bytes rpc_data(100, 2);
+  bulk->writeSome(bulk_data, bulk_data.size(), [](auto) {});
+  // the first frame of bulk stream goes to the wire at once
+  ASSERT_EQ(wire->batches.size(), 1);
+  rpc->writeSome(rpc_data, rpc_data.size(), [](auto) {});
+
+  wire->completeWrite();
+  ASSERT_EQ(wire->batches.size(), 2);
+  auto &batch = wire->batches[1];
+  ASSERT_EQ(dataFrames(batch), (std::vector<uint32_t>{1, 3, 1, 1, 1}));
+}
+
+/**
+ * @given two bulk streams, one with 4 times higher weight
+ * @when their frames are written
+ * @then heavier stream writes 4 frames per frame of the lighter one while
+ * both have data
+ */
+TEST_F(YamuxWriteSchedulingTest, Weights) {
+  auto heavy = connection->newStream().value();
+  auto light = connection->newStream().value();
+  heavy->setWriteWeight(64);
+  light->setWriteWeight(16);
+
+  Bytes data(YamuxFrame::kInitialWindowSize, 1);
+  light->writeSome(data, data.size(), [](auto) {});
+  heavy->writeSome(data, data.size(), [](auto) {});
+
+  writeAll();
+  std::vector<uint32_t> order;
+  for (auto &batch : wire->batches) {
+    auto ids = dataFrames(batch);
+    order.insert(order.end(), ids.begin(), ids.end());
+  }
+  // the first frame of light stream is written before heavy one is queued
+  ASSERT_EQ(order, (std::vector<uint32_t>{3, 3, 1, 1, 1, 1, 3, 1, 3, 3}));
+}
+
+/**
+ * @given stream with data blocked by send window
+ * @when peer's window updates for it arrive in one read
+ * @then they are applied at once, and the data is written in one frame
+ */
+TEST_F(YamuxWriteSchedulingTest, WindowUpdatesAreAggregated) {
+  auto stream = connection->newStream().value();
+  Bytes data(YamuxFrame::kInitialWindowSize + 3000, 1);
+  stream->writeSome(data, data.size(), [](auto) {});
+  writeAll();
+  ASSERT_TRUE(read_cb);
+
+  Bytes frames;
+  for (auto i = 0; i < 3; ++i) {
+    auto frame = windowUpdateMsg(1, 1000);
+    frames.insert(frames.end(), frame.begin(), frame.end());
+  }
+  std::ranges::copy(frames, read_out.begin());
+  auto written = wire->batches.size();
+  std::exchange(read_cb, nullptr)(frames.size());
+  writeAll();
+
+  std::vector<uint32_t> lengths;
+  for (auto i = written; i < wire->batches.size(); ++i) {
+    for (auto &frame : wire->batches[i]) {
+      if (frame.type == YamuxFrame::FrameType::DATA and frame.length > 0) {
+        lengths.push_back(frame.length);
+      }
+    }
+  }
+  ASSERT_EQ(lengths, (std::vector<uint32_t>{3000}));
+}
+
+/**
+ * @given stream with small writes queued while send window is exhausted
+ * @when peer's window update arrives
+ * @then the writes go to the wire in one frame, and all of them complete
+ */
+TEST_F(YamuxWriteSchedulingTest, SmallWritesShareFrame) {
+  auto stream = connection->newStream().value();
+  Bytes bulk(YamuxFrame::kInitialWindowSize, 1);
+  stream->writeSome(bulk, bulk.size(), [](auto) {});
+  writeAll();
+  ASSERT_TRUE(read_cb);
+
+  std::vector<Bytes> messages(10, Bytes(100, 2));
+  size_t completed = 0;
+  for (auto &message : messages) {
+    stream->writeSome(message, message.size(), [&](auto res) {
+      ASSERT_TRUE(res);
+      ++completed;
+    });
+  }
+
+  auto update = windowUpdateMsg(1, 1000);
+  std::ranges::copy(update, read_out.begin());
+  auto written = wire->batches.size();
+  std::exchange(read_cb, nullptr)(update.size());
+  writeAll();
+
+  std::vector<uint32_t> lengths;
+  for (auto i = written; i < wire->batches.size(); ++i) {
+    for (auto &frame : wire->batches[i]) {
+      if (frame.type == YamuxFrame::FrameType::DATA and frame.length > 0) {
+        lengths.push_back(frame.length);
+      }
+    }
+  }
+  ASSERT_EQ(lengths, (std::vector<uint32_t>{1000}));
+  ASSERT_EQ(completed, messages.size());
+}
+
+/**
+ * @given new outbound stream
+ * @when it writes data before anything else is sent
+ * @then SYN flag goes with the first data frame, without separate frame
+ */
+TEST_F(YamuxWriteSchedulingTest, SynWithData) {
+  auto stream = connection->newStream().value();
+  ASSERT_TRUE(wire->batches.empty());
+
+  Bytes data(100, 1);
+  stream->writeSome(data, data.size(), [](auto) {});
+  ASSERT_EQ(wire->batches.size(), 1);
+  auto &batch = wire->batches[0];
+  ASSERT_EQ(batch.size(), 1);
+  ASSERT_EQ(batch[0].type, YamuxFrame::FrameType::DATA);
+  ASSERT_EQ(batch[0].stream_id, 1);
+  ASSERT_EQ(batch[0].length, data.size());
+  ASSERT_TRUE(batch[0].flagIsSet(YamuxFrame::Flag::SYN));
+
+  stream->writeSome(data, data.size(), [](auto) {});
+  writeAll();
+  ASSERT_EQ(wire->batches.size(), 2);
+  ASSERT_FALSE(wire->batches[1][0].flagIsSet(YamuxFrame::Flag::SYN));
+}
+
+/**
+ * @given new outbound stream
+ * @when it writes nothing till deferred calls run
+ * @then SYN is sent alone, so that the stream may wait for peer's data
+ */
+TEST_F(YamuxWriteSchedulingTest, SynAloneWithoutData) {
+  std::vector<libp2p::basic::Writer::WriteCallbackFunc> deferred;
+  EXPECT_CALL(*wire, deferWriteCallback(_, _))
+      .WillRepeatedly(
+          [&](std::error_code, auto cb) { deferred.emplace_back(cb); });
+  auto stream = connection->newStream().value();
+  ASSERT_TRUE(wire->batches.empty());
+
+  for (auto &cb : std::exchange(deferred, {})) {
+    cb(std::error_code{});
+  }
+  ASSERT_EQ(wire->batches.size(), 1);
+  auto &batch = wire->batches[0];
+  ASSERT_EQ(batch.size(), 1);
+  ASSERT_EQ(batch[0].stream_id, 1);
+  ASSERT_EQ(batch[0].length, 0);
+  ASSERT_TRUE(batch[0].flagIsSet(YamuxFrame::Flag::SYN));
+}
+
+/**
+ * @given new outbound stream, whose first data frame waits behind a write of
+ * another stream
+ * @when the stream grows its receive window before the data frame is written
+ * @then window update goes to the wire after the data frame carrying SYN
+ */
+TEST_F(YamuxWriteSchedulingTest, WindowUpdateAfterSyn) {
+  auto busy = connection->newStream().value();
+  Bytes bulk(1000, 1);
+  busy->writeSome(bulk, bulk.size(), [](auto) {});
+  ASSERT_EQ(wire->batches.size(), 1);
+
+  auto stream = connection->newStream().value();
+  Bytes data(100, 2);
+  stream->writeSome(data, data.size(), [](auto) {});
+  stream->adjustWindowSize(2 * YamuxFrame::kInitialWindowSize, {});
+  writeAll();
+
+  std::vector<YamuxFrame> frames;
+  for (auto &batch : wire->batches) {
+    for (auto &frame : batch) {
+      if (frame.stream_id == 3) {
+        frames.push_back(frame);
+      }
+    }
+  }
+  ASSERT_EQ(frames.size(), 2);
+  ASSERT_EQ(frames[0].type, YamuxFrame::FrameType::DATA);
+  ASSERT_TRUE(frames[0].flagIsSet(YamuxFrame::Flag::SYN));
+  ASSERT_EQ(frames[1].type, YamuxFrame::FrameType::WINDOW_UPDATE);
+  ASSERT_FALSE(frames[1].flagIsSet(YamuxFrame::Flag::SYN));
+}
+
+/**
+ * @given new outbound stream, whose SYN is not sent yet
+ * @when the stream is reset before writing anything
+ * @then nothing of the stream goes to the wire, neither SYN nor RST
+ */
+TEST_F(YamuxWriteSchedulingTest, ResetBeforeFirstFrame) {
+  std::vector<libp2p::basic::Writer::WriteCallbackFunc> deferred;
+  EXPECT_CALL(*wire, deferWriteCallback(_, _))
+      .WillRepeatedly(
+          [&](std::error_code, auto cb) { deferred.emplace_back(cb); });
+  auto stream = connection->newStream().value();
+  stream->reset();
+
+  for (auto &cb : std::exchange(deferred, {})) {
+    cb(std::error_code{});
+  }
+  writeAll();
+  ASSERT_TRUE(wire->batches.empty());
+}
+
+/**
+ * @given connection with ping requested
+ * @when PING frame is written and peer acknowledges it
+ * @then callback gets round trip time, ping pending on close fails
+ */
+TEST_F(YamuxWriteSchedulingTest, Ping) {
+  ASSERT_TRUE(connection->supportsPing());
+  std::optional<outcome::result<std::chrono::microseconds>> rtt;
+  connection->ping([&](auto res) { rtt = res; });
+  writeAll();
+  ASSERT_EQ(wire->batches.size(), 1);
+  auto &frame = wire->batches[0][0];
+  ASSERT_EQ(frame.type, YamuxFrame::FrameType::PING);
+  ASSERT_TRUE(frame.flagIsSet(YamuxFrame::Flag::SYN));
+  ASSERT_FALSE(rtt);
+
+  auto pong = pingResponseMsg(frame.length);
+  std::ranges::copy(pong, read_out.begin());
+  std::exchange(read_cb, nullptr)(pong.size());
+  ASSERT_TRUE(rtt);
+  ASSERT_TRUE(rtt->has_value());
+
+  std::optional<outcome::result<std::chrono::microseconds>> failed;
+  connection->ping([&](auto res) { failed = res; });
+  std::ignore = connection->close();
+  ASSERT_TRUE(failed);
+  ASSERT_TRUE(failed->has_error());
+}
+
+/**
+ * @given two streams reading
+ * @when frames of both streams arrive interleaved in one read, the last one
+ * of the first stream with FIN
+ * @then each stream receives its data in one piece, and FIN after it
+ */
+TEST_F(YamuxWriteSchedulingTest, DataIsDeliveredPerStream) {
+  auto first = connection->newStream().value();
+  auto second = connection->newStream().value();
+  ASSERT_TRUE(read_cb);
+
+  Bytes frames;
+  auto append = [&](uint32_t stream_id, uint8_t byte, bool fin) {
+    auto header = dataMsg(stream_id, 1, false);
+    if (fin) {
+      header[3] |= static_cast<uint8_t>(YamuxFrame::Flag::FIN);
+    }
+    frames.insert(frames.end(), header.begin(), header.end());
+    frames.push_back(byte);
+  };
+  append(1, 'a', false);
+  append(3, 'b', false);
+  append(1, 'c', false);
+  append(3, 'd', false);
+  append(1, 'e', true);
+
+  Bytes first_out(10);
+  Bytes second_out(10);
+  std::vector<outcome::result<size_t>> first_reads;
+  std::vector<outcome::result<size_t>> second_reads;
+  first->readSome(first_out, first_out.size(), [&](auto res) {
+    first_reads.push_back(res);
+    first->readSome(first_out, first_out.size(), [&](auto res) {
+      first_reads.push_back(res);
+    });
+  });
+  second->readSome(second_out, second_out.size(), [&](auto res) {
+    second_reads.push_back(res);
+  });
+
+  std::ranges::copy(frames, read_out.begin());
+  std::exchange(read_cb, nullptr)(frames.size());
+
+  ASSERT_EQ(first_reads.size(), 2);
+  ASSERT_EQ(first_reads[0].value(), 3);
+  EXPECT_EQ(Bytes(first_out.begin(), first_out.begin() + 3),
+            (Bytes{'a', 'c', 'e'}));
+  EXPECT_TRUE(first_reads[1].has_error());
+  ASSERT_EQ(second_reads.size(), 1);
+  ASSERT_EQ(second_reads[0].value(), 2);
+  EXPECT_EQ(Bytes(second_out.begin(), second_out.begin() + 2),
+            (Bytes{'b', 'd'}));
+}
+
+/**
+ * @given stream reading into buffer large enough to be read directly
+ * @when data frame longer than stream's receive window arrives
+ * @then the stream is reset with overflow, its buffer is not read into, and
+ * the rest of frame is discarded by connection
+ */
+TEST_F(YamuxWriteSchedulingTest, DirectReadWindowOverflow) {
+  auto stream = connection->newStream().value();
+  Bytes out(2 * YamuxFrame::kInitialWindowSize);
+  std::optional<outcome::result<size_t>> read;
+  stream->readSome(out, out.size(), [&](auto res) { read = res; });
+
+  auto header = dataMsg(1, YamuxFrame::kInitialWindowSize + 1, false);
+  std::ranges::copy(header, read_out.begin());
+  std::exchange(read_cb, nullptr)(header.size());
+
+  ASSERT_TRUE(read);
+  ASSERT_TRUE(read->has_error());
+  EXPECT_EQ(read->error(), Stream::Error::STREAM_RECEIVE_OVERFLOW);
+  ASSERT_TRUE(read_cb);
+  EXPECT_NE(read_out.data(), out.data());
+  writeAll();
+  ASSERT_FALSE(wire->batches.empty());
+  auto &rst = wire->batches.back().back();
+  EXPECT_EQ(rst.stream_id, 1);
+  EXPECT_TRUE(rst.flagIsSet(YamuxFrame::Flag::RST));
+}
+
+/**
+ * @given data frame being read directly into stream's buffer
+ * @when the stream is reset before the read completes
+ * @then the read completes with error, the rest of frame is discarded, and
+ * frames after it are processed
+ */
+TEST_F(YamuxWriteSchedulingTest, ResetDuringDirectRead) {
+  auto stream = connection->newStream().value();
+  auto other = connection->newStream().value();
+  Bytes out(32 * 1024);
+  std::optional<outcome::result<size_t>> read;
+  stream->readSome(out, out.size(), [&](auto res) { read = res; });
+
+  size_t length = 20 * 1024;
+  auto header = dataMsg(1, length, false);
+  std::ranges::copy(header, read_out.begin());
+  std::exchange(read_cb, nullptr)(header.size());
+  ASSERT_TRUE(read_cb);
+  ASSERT_EQ(read_out.data(), out.data());
+
+  stream->reset();
+  EXPECT_FALSE(read);
+  std::exchange(read_cb, nullptr)(length / 2);
+  ASSERT_TRUE(read);
+  EXPECT_TRUE(read->has_error());
+
+  // the rest of payload and frame of other stream
+  ASSERT_TRUE(read_cb);
+  ASSERT_NE(read_out.data(), out.data());
+  Bytes frames(length / 2);
+  auto next = dataMsg(3, 1, false);
+  frames.insert(frames.end(), next.begin(), next.end());
+  frames.push_back('a');
+  Bytes other_out(1);
+  std::optional<outcome::result<size_t>> other_read;
+  other->readSome(other_out, other_out.size(), [&](auto res) {
+    other_read = res;
+  });
+  std::ranges::copy(frames, read_out.begin());
+  std::exchange(read_cb, nullptr)(frames.size());
+  ASSERT_TRUE(other_read);
+  ASSERT_EQ(other_read->value(), 1);
+  EXPECT_EQ(other_out, Bytes{'a'});
+}
@@ -0,0 +1,90 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/network/impl/connection_gater_impl.hpp>
+
+#include <gtest/gtest.h>
+#include <libp2p/common/literals.hpp>
+
+using libp2p::network::ConnectionGaterImpl;
+using namespace libp2p::common;
+
+namespace {
+  auto address(const char *str) {
+    return boost::asio::ip::make_address(str);
+  }
+}  // namespace
+
+/**
+ * @given gater denying 10.0.0.0/8 and allowing 10.1.0.0/16 within it
+ * @when addresses are accepted
+ * @then rule of the longest matching prefix applies, other addresses and
+ * mapped ipv4 ones are matched as ipv4
+ */
+TEST(ConnectionGaterTest, LongestPrefix) {
+  ConnectionGaterImpl gater;
+  EXPECT_TRUE(gater.allowAccept(address("10.0.0.1")));
+
+  gater.denySubnet(address("10.0.0.0"), 8);
+  gater.allowSubnet(address("10.1.0.0"), 16);
+  EXPECT_FALSE(gater.allowAccept(address("10.0.0.1")));
+  EXPECT_FALSE(gater.allowAccept(address("::ffff:10.2.0.1")));
+  EXPECT_TRUE(gater.allowAccept(address("10.1.2.3")));
+  EXPECT_TRUE(gater.allowAccept(address("11.0.0.1")));
+  EXPECT_TRUE(gater.allowAccept(address("::1")));
+
+  gater.denySubnet(address("2001:db8::"), 32);
+  EXPECT_FALSE(gater.allowAccept(address("2001:db8::1")));
+  EXPECT_TRUE(gater.allowAccept(address("2001:db9::1")));
+
+  gater.removeSubnet(address("10.0.0.0"), 8);
+  EXPECT_TRUE(gater.allowAccept(address("10.0.0.1")));
+  // removal of missing rule changes nothing
+  gater.removeSubnet(address("192.168.0.0"), 16);
+  EXPECT_FALSE(gater.allowAccept(address("2001:db8::1")));
+}
+
+/**
+ * @given gater denying by default and allowing 192.168.0.0/16
+ * @when addresses are accepted and dialed
+ * @then only addresses of allowed subnet pass, dns addresses are not checked
+ */
+TEST(ConnectionGaterTest, DenyByDefault) {
+  ConnectionGaterImpl gater{{.allow_by_default = false}};
+  EXPECT_FALSE(gater.allowAccept(address("192.168.1.1")));
+
+  gater.allowSubnet(address("192.168.0.0"), 16);
+  EXPECT_TRUE(gater.allowAccept(address("192.168.1.1")));
+  EXPECT_FALSE(gater.allowAccept(address("8.8.8.8")));
+
+  auto peer = "1"_peerid;
+  EXPECT_TRUE(
+      gater.allowDialAddress(peer, "/ip4/192.168.1.1/tcp/1"_multiaddr));
+  EXPECT_FALSE(gater.allowDialAddress(peer, "/ip4/8.8.8.8/tcp/1"_multiaddr));
+  EXPECT_TRUE(
+      gater.allowDialAddress(peer, "/dns4/example.com/tcp/1"_multiaddr));
+}
+
+/**
+ * @given blocked peer
+ * @when it is dialed or authenticated
+ * @then it is denied until unblocked, other peers are allowed
+ */
+TEST(ConnectionGaterTest, BlockedPeer) {
+  ConnectionGaterImpl gater;
+  auto peer = "1"_peerid;
+  EXPECT_TRUE(gater.allowSecured(peer, false));
+
+  gater.blockPeer(peer);
+  EXPECT_FALSE(gater.allowDialPeer(peer));
+  EXPECT_FALSE(gater.allowSecured(peer, false));
+  EXPECT_FALSE(gater.allowSecured(peer, true));
+  EXPECT_TRUE(gater.allowSecured("2"_peerid, false));
+
+  gater.unblockPeer(peer);
+  EXPECT_TRUE(gater.allowDialPeer(peer));
+  EXPECT_FALSE(gater.isPeerBlocked(peer));
+}
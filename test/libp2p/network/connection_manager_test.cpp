@@ -4,8 +4,12 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+#include <set>
+
 #include <gtest/gtest.h>
 
+#include <libp2p/basic/scheduler/manual_scheduler_backend.hpp>
+#include <libp2p/basic/scheduler/scheduler_impl.hpp>
 #include <libp2p/common/literals.hpp>
 #include <libp2p/network/connection_manager.hpp>
 #include <libp2p/network/impl/connection_manager_impl.hpp>
@@ -22,22 +26,30 @@ using namespace transport;
 using namespace connection;
 using namespace peer;
 using namespace common;
+using namespace basic;
 
 using testing::_;
 using testing::NiceMock;
 using testing::Return;
 
+const auto kDirect = "/ip4/127.0.0.1/tcp/1"_multiaddr;
+const auto kRelayed = "/ip4/127.0.0.1/tcp/2/p2p-circuit"_multiaddr;
+
 struct ConnectionManagerTest : public ::testing::Test {
   void SetUp() override {
     t = std::make_shared<TransportMock>();
 
     bus = std::make_shared<libp2p::event::Bus>();
 
-    cmgr = std::make_shared<ConnectionManagerImpl>(bus);
+    cmgr = std::make_shared<ConnectionManagerImpl>(
+        bus, scheduler, ConnectionManagerConfig{});
 
     conn11 = std::make_shared<CapableConnectionMock>();
     conn12 = std::make_shared<CapableConnectionMock>();
     conn2 = std::make_shared<CapableConnectionMock>();
+    for (auto &conn : {conn11, conn12, conn2}) {
+      ON_CALL(*conn, remoteMultiaddr()).WillByDefault(Return(kDirect));
+    }
 
     // given 3 peers. p1 has 2 conns, p2 has 1, p3 has 0
     cmgr->addConnectionToPeer(p1, conn11);
@@ -48,6 +60,12 @@ struct ConnectionManagerTest : public ::testing::Test {
   std::shared_ptr<libp2p::event::Bus> bus;
   std::shared_ptr<TransportMock> t;
 
+  std::shared_ptr<ManualSchedulerBackend> scheduler_backend =
+      std::make_shared<ManualSchedulerBackend>();
+
+  std::shared_ptr<Scheduler> scheduler =
+      std::make_shared<SchedulerImpl>(scheduler_backend, Scheduler::Config{});
+
   std::shared_ptr<ConnectionManager> cmgr;
 
   peer::PeerId p1 = testutil::randomPeerId();
@@ -138,6 +156,185 @@ TEST_F(ConnectionManagerTest, GarbageCollection) {
   ASSERT_EQ(cmgr->getConnectionsToPeer(p3).size(), 0);
 }
 
+/// Connection which can be closed by trimming
+std::shared_ptr<NiceMock<CapableConnectionMock>> openConnection() {
+  auto conn = std::make_shared<NiceMock<CapableConnectionMock>>();
+  ON_CALL(*conn, isClosed()).WillByDefault(Return(false));
+  ON_CALL(*conn, close()).WillByDefault(Return(outcome::success()));
+  ON_CALL(*conn, remoteMultiaddr()).WillByDefault(Return(kDirect));
+  return conn;
+}
+
+/**
+ * @given connection manager with watermarks 2 and 3, tagged peers and a
+ * protected one
+ * @when 4th connection arrives
+ * @then peers with the lowest scores are disconnected down to 2 connections,
+ * protected peer is kept
+ */
+TEST_F(ConnectionManagerTest, TrimLowestScore) {
+  cmgr = std::make_shared<ConnectionManagerImpl>(
+      bus,
+      scheduler,
+      ConnectionManagerConfig{
+          .low_water = 2, .high_water = 3, .grace_period = {}});
+  auto pa = testutil::randomPeerId();
+  auto pb = testutil::randomPeerId();
+  auto pc = testutil::randomPeerId();
+  auto pd = testutil::randomPeerId();
+  auto ca = openConnection();
+  auto cb = openConnection();
+  auto cc = openConnection();
+  auto cd = openConnection();
+  cmgr->addConnectionToPeer(pa, ca);
+  cmgr->addConnectionToPeer(pb, cb);
+  cmgr->addConnectionToPeer(pc, cc);
+  cmgr->tagPeer(pa, "a", 10);
+  cmgr->tagPeer(pb, "b", 1);
+  cmgr->tagPeer(pc, "c", 5);
+  cmgr->protect(pd, "d");
+
+  EXPECT_CALL(*ca, close()).Times(0);
+  EXPECT_CALL(*cb, close()).WillOnce(Return(outcome::success()));
+  EXPECT_CALL(*cc, close()).WillOnce(Return(outcome::success()));
+  EXPECT_CALL(*cd, close()).Times(0);
+  cmgr->addConnectionToPeer(pd, cd);
+  scheduler_backend->run();
+
+  ASSERT_EQ(cmgr->getConnections().size(), 2);
+  ASSERT_EQ(cmgr->getConnectionsToPeer(pa).size(), 1);
+  ASSERT_EQ(cmgr->getConnectionsToPeer(pd).size(), 1);
+  ASSERT_TRUE(cmgr->isProtected(pd));
+  ASSERT_FALSE(cmgr->unprotect(pd, "d"));
+  ASSERT_FALSE(cmgr->isProtected(pd));
+}
+
+/**
+ * @given connection manager with watermarks 2 and 3 and grace period
+ * @when 4 connections arrive within grace period, and 5th after it
+ * @then nothing is trimmed until grace period passes, then older peers are
+ * disconnected and the new one is kept
+ */
+TEST_F(ConnectionManagerTest, TrimAfterGracePeriod) {
+  constexpr std::chrono::minutes kGrace{1};
+  cmgr = std::make_shared<ConnectionManagerImpl>(
+      bus,
+      scheduler,
+      ConnectionManagerConfig{
+          .low_water = 2, .high_water = 3, .grace_period = kGrace});
+  std::vector<std::shared_ptr<NiceMock<CapableConnectionMock>>> conns;
+  for (auto i = 0; i < 4; ++i) {
+    conns.emplace_back(openConnection());
+    cmgr->addConnectionToPeer(testutil::randomPeerId(), conns.back());
+  }
+  scheduler_backend->run();
+  ASSERT_EQ(cmgr->getConnections().size(), 4);
+
+  scheduler_backend->shift(kGrace);
+  auto fresh_peer = testutil::randomPeerId();
+  cmgr->addConnectionToPeer(fresh_peer, openConnection());
+  scheduler_backend->run();
+  ASSERT_EQ(cmgr->getConnections().size(), 2);
+  ASSERT_EQ(cmgr->getConnectionsToPeer(fresh_peer).size(), 1);
+}
+
+/**
+ * @given peer connected through relay
+ * @when direct connection to it arrives
+ * @then direct connection is preferred, relayed one is closed after drain
+ * period
+ */
+TEST_F(ConnectionManagerTest, DrainRelayed) {
+  auto relayed = openConnection();
+  ON_CALL(*relayed, remoteMultiaddr()).WillByDefault(Return(kRelayed));
+  auto direct = openConnection();
+  cmgr->addConnectionToPeer(p3, relayed);
+  ASSERT_EQ(cmgr->getBestConnectionForPeer(p3), relayed);
+
+  bool closed = false;
+  EXPECT_CALL(*relayed, close()).WillOnce([&] {
+    closed = true;
+    return outcome::success();
+  });
+  EXPECT_CALL(*direct, close()).Times(0);
+  cmgr->addConnectionToPeer(p3, direct);
+  ASSERT_EQ(cmgr->getBestConnectionForPeer(p3), direct);
+  scheduler_backend->run();
+  ASSERT_FALSE(closed);
+
+  scheduler_backend->shift(ConnectionManagerConfig{}.relay_drain_period);
+  ASSERT_TRUE(closed);
+}
+
+/**
+ * @given peer with direct connections of different round trip times and loads
+ * @when best connection is requested
+ * @then the one with noticeably lower rtt is chosen, among similar ones the
+ * least loaded, choice is kept for selection period unless connections change
+ */
+TEST_F(ConnectionManagerTest, LoadAwareSelection) {
+  auto slow = openConnection();
+  auto busy = openConnection();
+  auto idle = openConnection();
+  using std::chrono::microseconds;
+  ON_CALL(*slow, load())
+      .WillByDefault(Return(ConnectionLoad{.rtt = microseconds{50000}}));
+  ON_CALL(*busy, load())
+      .WillByDefault(
+          Return(ConnectionLoad{.streams = 5, .rtt = microseconds{10000}}));
+  ON_CALL(*idle, load())
+      .WillByDefault(
+          Return(ConnectionLoad{.streams = 1, .rtt = microseconds{11000}}));
+  cmgr->addConnectionToPeer(p3, slow);
+  cmgr->addConnectionToPeer(p3, busy);
+  ASSERT_EQ(cmgr->getBestConnectionForPeer(p3), busy);
+
+  cmgr->addConnectionToPeer(p3, idle);
+  ASSERT_EQ(cmgr->getBestConnectionForPeer(p3), idle);
+
+  ON_CALL(*idle, load())
+      .WillByDefault(Return(ConnectionLoad{
+          .streams = 1, .unsent_bytes = 1 << 20, .rtt = microseconds{11000}}));
+  ASSERT_EQ(cmgr->getBestConnectionForPeer(p3), idle);
+  scheduler_backend->shift(ConnectionManagerConfig{}.selection_period);
+  ASSERT_EQ(cmgr->getBestConnectionForPeer(p3), busy);
+}
+
+/**
+ * @given connection manager with watermarks 2 and 3, and stripe of 3
+ * connections to one peer
+ * @when connections to 2 other peers arrive
+ * @then stripe counts as one connection and nothing is trimmed, striped
+ * connections are given out in turn
+ */
+TEST_F(ConnectionManagerTest, StripeTrimmedAsOne) {
+  cmgr = std::make_shared<ConnectionManagerImpl>(
+      bus,
+      scheduler,
+      ConnectionManagerConfig{
+          .low_water = 2, .high_water = 3, .grace_period = {}});
+  auto striped = testutil::randomPeerId();
+  cmgr->setStripe(striped, 3);
+  std::set<ConnectionManager::ConnectionSPtr> stripe;
+  for (auto i = 0; i < 3; ++i) {
+    auto conn = openConnection();
+    EXPECT_CALL(*conn, close()).Times(0);
+    stripe.emplace(conn);
+    cmgr->addConnectionToPeer(striped, conn);
+  }
+  cmgr->addConnectionToPeer(testutil::randomPeerId(), openConnection());
+  cmgr->addConnectionToPeer(testutil::randomPeerId(), openConnection());
+  scheduler_backend->run();
+  ASSERT_EQ(cmgr->getConnections().size(), 5);
+
+  std::set<ConnectionManager::ConnectionSPtr> given;
+  for (auto i = 0; i < 3; ++i) {
+    given.emplace(cmgr->getStripedConnection(striped));
+  }
+  ASSERT_EQ(given, stripe);
+  ASSERT_EQ(cmgr->getStripedConnection(p1), nullptr);
+}
+
 int main(int argc, char *argv[]) {
   if (std::getenv("TRACE_DEBUG") != nullptr) {
     testutil::prepareLoggers(soralog::Level::TRACE);
@@ -0,0 +1,59 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <gtest/gtest.h>
+#include <libp2p/common/literals.hpp>
+#include <libp2p/network/dial_backoff.hpp>
+
+using libp2p::network::DialBackoff;
+using libp2p::peer::PeerInfo;
+using namespace libp2p::common;
+using std::chrono_literals::operator""s;
+
+struct DialBackoffTest : public ::testing::Test {
+  DialBackoff backoff{DialBackoff::Config{
+      .base = 1s, .max = 3s, .capacity = 2}};
+  DialBackoff::Clock::time_point now{};
+  PeerInfo peer{.id = "1"_peerid,
+                .addresses = {"/ip4/127.0.0.1/tcp/1"_multiaddr}};
+};
+
+/**
+ * @given peer, which failed to dial
+ * @when it fails again after backoff
+ * @then backoff doubles up to max, success forgets failures
+ */
+TEST_F(DialBackoffTest, Exponential) {
+  EXPECT_FALSE(backoff.blocked(peer, now));
+  backoff.failed(peer, now);
+  EXPECT_TRUE(backoff.blocked(peer, now));
+  EXPECT_FALSE(backoff.blocked(peer, now + 1s));
+
+  backoff.failed(peer, now + 1s);
+  EXPECT_TRUE(backoff.blocked(peer, now + 2s));
+  EXPECT_FALSE(backoff.blocked(peer, now + 3s));
+
+  backoff.failed(peer, now + 3s);
+  EXPECT_TRUE(backoff.blocked(peer, now + 5s));
+  EXPECT_FALSE(backoff.blocked(peer, now + 6s));
+
+  backoff.succeeded(peer.id);
+  EXPECT_EQ(backoff.size(), 0);
+  backoff.failed(peer, now + 6s);
+  EXPECT_FALSE(backoff.blocked(peer, now + 7s));
+}
+
+/**
+ * @given peer, which failed to dial
+ * @when it is dialed with address, which was not tried
+ * @then dial is not blocked
+ */
+TEST_F(DialBackoffTest, NewAddress) {
+  backoff.failed(peer, now);
+  auto with_new = peer;
+  with_new.addresses.emplace_back("/ip4/127.0.0.1/tcp/2"_multiaddr);
+  EXPECT_FALSE(backoff.blocked(with_new, now));
+}
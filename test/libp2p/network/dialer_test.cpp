@@ -42,6 +42,7 @@ using ::testing::Truly;
 struct DialerTest : public ::testing::Test {
   void SetUp() override {
     testutil::prepareLoggers();
+    ON_CALL(*connection, remoteMultiaddr()).WillByDefault(Return(ma1));
     dialer = std::make_shared<DialerImpl>(
         proto_muxer, tmgr, cmgr, listener, addr_repo, scheduler);
   }
@@ -122,6 +123,137 @@ TEST_F(DialerTest, DialAllTheAddresses) {
   ASSERT_TRUE(executed);
 }
 
+/**
+ * @given a peer with TCP and QUIC addresses, QUIC dial hangs
+ * @when stagger delay passes
+ * @then QUIC is dialed first, TCP is dialed in parallel after the delay and
+ * wins, late QUIC connection is closed
+ */
+TEST_F(DialerTest, DialStaggeredParallel) {
+  auto ma_quic = "/ip4/127.0.0.1/udp/1/quic-v1"_multiaddr;
+  auto late_connection = std::make_shared<CapableConnectionMock>();
+  EXPECT_CALL(*cmgr, getBestConnectionForPeer(pid)).WillOnce(Return(nullptr));
+  EXPECT_CALL(*tmgr, findBest(_)).WillRepeatedly(Return(transport));
+  EXPECT_CALL(*listener, onConnection(_)).Times(1);
+
+  TransportAdaptor::HandlerFunc quic_handler;
+  EXPECT_CALL(*transport, dial(pid, ma_quic, _))
+      .WillOnce([&](auto &&, auto &&, auto handler) {
+        quic_handler = std::move(handler);
+      });
+  bool executed = false;
+  dialer->dial({.id = pid, .addresses = {ma1, ma_quic}}, [&](auto &&rconn) {
+    ASSERT_OUTCOME_SUCCESS(conn, rconn);
+    ASSERT_EQ(conn, connection);
+    executed = true;
+  });
+  ASSERT_TRUE(quic_handler);
+
+  TransportAdaptor::HandlerFunc tcp_handler;
+  EXPECT_CALL(*transport, dial(pid, ma1, _))
+      .WillOnce([&](auto &&, auto &&, auto handler) {
+        tcp_handler = std::move(handler);
+      });
+  scheduler_backend->shift(DialerImpl::kDialStagger);
+  ASSERT_TRUE(tcp_handler);
+
+  tcp_handler(connection);
+  scheduler_backend->run();
+  ASSERT_TRUE(executed);
+
+  EXPECT_CALL(*late_connection, isClosed()).WillOnce(Return(false));
+  EXPECT_CALL(*late_connection, close()).WillOnce(Return(outcome::success()));
+  quic_handler(late_connection);
+}
+
+/**
+ * @given dial which was won by TCP, while its QUIC attempt still hangs, and
+ * the next dial to the same peer in progress
+ * @when late QUIC attempt of the first dial fails, and then the attempt of
+ * the next dial fails too
+ * @then the next dial is not affected by the late attempt, and fails with
+ * error of its own attempt
+ */
+TEST_F(DialerTest, LateAttemptOfFinishedDialIgnored) {
+  auto ma_quic = "/ip4/127.0.0.1/udp/1/quic-v1"_multiaddr;
+  EXPECT_CALL(*cmgr, getBestConnectionForPeer(pid))
+      .Times(2)
+      .WillRepeatedly(Return(nullptr));
+  EXPECT_CALL(*tmgr, findBest(_)).WillRepeatedly(Return(transport));
+  EXPECT_CALL(*listener, onConnection(_)).Times(1);
+
+  TransportAdaptor::HandlerFunc quic_handler;
+  EXPECT_CALL(*transport, dial(pid, ma_quic, _))
+      .WillOnce([&](auto &&, auto &&, auto handler) {
+        quic_handler = std::move(handler);
+      });
+  EXPECT_CALL(*transport, dial(pid, ma1, _))
+      .WillOnce(Arg2CallbackWithArg(outcome::success(connection)));
+  bool first = false;
+  dialer->dial({.id = pid, .addresses = {ma1, ma_quic}}, [&](auto &&rconn) {
+    ASSERT_OUTCOME_SUCCESS(conn, rconn);
+    ASSERT_EQ(conn, connection);
+    first = true;
+  });
+  scheduler_backend->shift(DialerImpl::kDialStagger);
+  scheduler_backend->run();
+  ASSERT_TRUE(first);
+  ASSERT_TRUE(quic_handler);
+
+  TransportAdaptor::HandlerFunc next_handler;
+  EXPECT_CALL(*transport, dial(pid, ma2, _))
+      .WillOnce([&](auto &&, auto &&, auto handler) {
+        next_handler = std::move(handler);
+      });
+  std::optional<Dialer::DialResult> next;
+  dialer->dial({.id = pid, .addresses = {ma2}},
+               [&](Dialer::DialResult r) { next = std::move(r); });
+  ASSERT_TRUE(next_handler);
+
+  quic_handler(make_error_code(std::errc::connection_refused));
+  scheduler_backend->run();
+  EXPECT_FALSE(next);
+
+  next_handler(make_error_code(std::errc::host_unreachable));
+  scheduler_backend->run();
+  ASSERT_TRUE(next);
+  ASSERT_TRUE(next->has_error());
+  EXPECT_EQ(next->error(), make_error_code(std::errc::host_unreachable));
+}
+
+/**
+ * @given a peer with two addresses, the first one is in backoff after failures
+ * @when dial
+ * @then only the second address is dialed
+ */
+TEST_F(DialerTest, DialSkipsBackoff) {
+  EXPECT_CALL(*cmgr, getBestConnectionForPeer(pid)).WillOnce(Return(nullptr));
+  EXPECT_CALL(*addr_repo, dialStats(pid, ma1))
+      .WillOnce(Return(peer::DialStats{
+          .failures = 1,
+          .consecutive_failures = 1,
+          .backoff_until =
+              std::chrono::steady_clock::now() + std::chrono::minutes(1),
+      }));
+  EXPECT_CALL(*addr_repo, dialStats(pid, ma2))
+      .WillOnce(Return(std::nullopt));
+  EXPECT_CALL(*addr_repo, dialSucceeded(pid, ma2, _));
+  EXPECT_CALL(*listener, onConnection(_)).Times(1);
+  EXPECT_CALL(*tmgr, findBest(ma2)).WillOnce(Return(transport));
+  EXPECT_CALL(*transport, dial(pid, ma1, _)).Times(0);
+  EXPECT_CALL(*transport, dial(pid, ma2, _))
+      .WillOnce(Arg2CallbackWithArg(outcome::success(connection)));
+
+  bool executed = false;
+  dialer->dial(pinfo_two_addrs, [&](auto &&rconn) {
+    ASSERT_OUTCOME_SUCCESS(conn, rconn);
+    (void)conn;
+    executed = true;
+  });
+  scheduler_backend->run();
+  ASSERT_TRUE(executed);
+}
+
 /**
  * @given no known connections to peer, have 1 transport, 1 address supplied
  * @when dial
@@ -177,6 +309,49 @@ TEST_F(DialerTest, DialNoAddresses) {
   ASSERT_TRUE(executed);
 }
 
+/**
+ * @given dial to all addresses of peer failed
+ * @when peer is dialed again with the same and with new address
+ * @then the same addresses are rejected by backoff, dial with new address
+ * goes through
+ */
+TEST_F(DialerTest, DialBackoff) {
+  EXPECT_CALL(*cmgr, getBestConnectionForPeer(pid))
+      .WillRepeatedly(Return(nullptr));
+  EXPECT_CALL(*tmgr, findBest(_)).WillRepeatedly(Return(transport));
+  EXPECT_CALL(*transport, dial(pid, ma1, _))
+      .WillOnce(
+          Arg2CallbackWithArg(make_error_code(std::errc::connection_refused)));
+
+  size_t executed = 0;
+  dialer->dial(pinfo, [&](auto &&rconn) {
+    ASSERT_OUTCOME_ERROR(rconn, std::errc::connection_refused);
+    ++executed;
+  });
+  scheduler_backend->run();
+  dialer->dial(pinfo, [&](auto &&rconn) {
+    ASSERT_OUTCOME_ERROR(rconn, std::errc::resource_unavailable_try_again);
+    ++executed;
+  });
+  scheduler_backend->run();
+  ASSERT_EQ(executed, 2);
+
+  // dial with new address tries all addresses again
+  EXPECT_CALL(*transport, dial(pid, ma1, _))
+      .WillOnce(
+          Arg2CallbackWithArg(make_error_code(std::errc::connection_refused)));
+  EXPECT_CALL(*transport, dial(pid, ma2, _))
+      .WillOnce(Arg2CallbackWithArg(outcome::success(connection)));
+  EXPECT_CALL(*listener, onConnection(_)).Times(1);
+  dialer->dial(pinfo_two_addrs, [&](auto &&rconn) {
+    ASSERT_OUTCOME_SUCCESS(conn, rconn);
+    (void)conn;
+    ++executed;
+  });
+  scheduler_backend->run();
+  ASSERT_EQ(executed, 3);
+}
+
 /**
  * @given no known connections to peer, have 1 tcp transport, 1 UDP address
  * supplied
@@ -224,6 +399,34 @@ TEST_F(DialerTest, DialExistingConnection) {
   ASSERT_TRUE(executed);
 }
 
+/**
+ * @given existing relayed connection to peer
+ * @when dial with direct address
+ * @then new direct connection is dialed
+ */
+TEST_F(DialerTest, DialDirectOverRelayed) {
+  auto relayed = std::make_shared<CapableConnectionMock>();
+  EXPECT_CALL(*relayed, remoteMultiaddr())
+      .WillRepeatedly(Return("/ip4/127.0.0.1/tcp/3/p2p-circuit"_multiaddr));
+  EXPECT_CALL(*cmgr, getBestConnectionForPeer(pinfo.id))
+      .WillOnce(Return(relayed));
+  EXPECT_CALL(*listener, onConnection(_)).Times(1);
+  EXPECT_CALL(*tmgr, findBest(ma1)).WillOnce(Return(transport));
+  EXPECT_CALL(*transport, dial(pinfo.id, ma1, _))
+      .WillOnce(Arg2CallbackWithArg(outcome::success(connection)));
+
+  bool executed = false;
+  dialer->dial(pinfo, [&](auto &&rconn) {
+    ASSERT_OUTCOME_SUCCESS(conn, rconn);
+    ASSERT_EQ(conn, connection);
+    executed = true;
+  });
+
+  scheduler_backend->run();
+
+  ASSERT_TRUE(executed);
+}
+
 ///
 /// All tests that use newStream assume connections already exist, because
 /// newStream uses dial to get connection, and dial is already tested for all
@@ -0,0 +1,59 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <gtest/gtest.h>
+#include <libp2p/network/dns_cache.hpp>
+
+using libp2p::network::DnsCache;
+using std::chrono_literals::operator""s;
+
+struct DnsCacheTest : public ::testing::Test {
+  using Cache = DnsCache<int>;
+
+  Cache cache{Cache::Config{
+      .ttl = 10s, .max_ttl = 60s, .negative_ttl = 1s, .capacity = 2}};
+  Cache::Clock::time_point now{};
+};
+
+/**
+ * @given cache with results of lookups
+ * @when time passes
+ * @then results expire after their ttl, failures expire earlier
+ */
+TEST_F(DnsCacheTest, Expiry) {
+  cache.resolved("a", 1, now);
+  cache.resolved("b", std::errc::host_unreachable, now);
+  ASSERT_EQ(cache.get("a", now + 9s), outcome::result<int>{1});
+  ASSERT_TRUE(cache.get("b", now));
+  ASSERT_FALSE(cache.get("b", now + 1s));
+  ASSERT_FALSE(cache.get("a", now + 10s));
+
+  cache.resolved("c", 3, now, 600s);
+  ASSERT_TRUE(cache.get("c", now + 59s));
+  ASSERT_FALSE(cache.get("c", now + 60s));
+
+  cache.resolved("d", 4, now, 0s);
+  ASSERT_FALSE(cache.get("d", now));
+}
+
+/**
+ * @given cache
+ * @when the same name is looked up several times before query completes
+ * @then only the first lookup starts query, and all get its result
+ */
+TEST_F(DnsCacheTest, Coalesce) {
+  std::vector<int> results;
+  auto cb = [&](outcome::result<int> r) { results.push_back(r.value()); };
+  ASSERT_TRUE(cache.wait("a", cb));
+  ASSERT_FALSE(cache.wait("a", cb));
+  ASSERT_TRUE(cache.wait("b", cb));
+
+  for (auto &waiter : cache.resolved("a", 1, now)) {
+    waiter(1);
+  }
+  ASSERT_EQ(results, (std::vector<int>{1, 1}));
+  ASSERT_TRUE(cache.wait("a", cb));
+}
@@ -190,3 +190,18 @@ TEST_F(RouterTest, RemoveAll) {
   this->removeAll();
   ASSERT_TRUE(this->getSupportedProtocols().empty());
 }
+
+/**
+ * @given router with protocol set
+ * @when shared protocols are taken and handlers change
+ * @then the taken list stays the same, and a new one reflects the change
+ */
+TEST_F(RouterTest, SharedProtocolsSnapshot) {
+  setHandlerWithFail(kDefaultProtocol);
+  auto before = this->getSupportedProtocolsShared();
+  ASSERT_EQ(before, this->getSupportedProtocolsShared());
+
+  setHandlerWithFail(kAnotherProtocol);
+  ASSERT_EQ(*before, std::vector<ProtocolName>{kDefaultProtocol});
+  ASSERT_EQ(this->getSupportedProtocolsShared()->size(), 2);
+}
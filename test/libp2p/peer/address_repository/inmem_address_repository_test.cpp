@@ -186,3 +186,77 @@ TEST_F(InmemAddressRepository_Test, GetPeers) {
   auto s = db->getPeers();
   EXPECT_EQ(s.size(), 2);
 }
+
+/**
+ * @given peer with 3 addresses
+ * @when dial to first address fails and second address is upserted
+ * @then failed address is peeked last, upsert keeps order
+ */
+TEST_F(InmemAddressRepository_Test, PeekDialOrder) {
+  ASSERT_OUTCOME_SUCCESS(
+      db->addAddresses(p1, std::vector<Multiaddress>{ma1, ma2, ma3}, 1000ms));
+  db->dialFailed(p1, ma1);
+  ASSERT_OUTCOME_SUCCESS(
+      db->upsertAddresses(p1, std::vector<Multiaddress>{ma2}, 10ms));
+
+  auto view = db->peekAddresses(p1);
+  EXPECT_EQ(std::vector(view.begin(), view.end()),
+            std::vector<Multiaddress>({ma2, ma3, ma1}));
+  EXPECT_TRUE(db->peekAddresses(p2).empty());
+
+  // ttl moved with address
+  std::this_thread::sleep_for(50ms);
+  collectGarbage();
+  view = db->peekAddresses(p1);
+  EXPECT_EQ(std::vector(view.begin(), view.end()),
+            std::vector<Multiaddress>({ma3, ma1}));
+}
+
+/**
+ * @given peer with permanent address
+ * @when garbage is collected
+ * @then address is kept
+ */
+TEST_F(InmemAddressRepository_Test, PermanentAddress) {
+  ASSERT_OUTCOME_SUCCESS(
+      db->addAddresses(p1, std::vector<Multiaddress>{ma1}, ttl::kPermanent));
+  collectGarbage();
+  EXPECT_EQ(db->peekAddresses(p1).size(), 1);
+}
+
+/**
+ * @given peer with 2 addresses
+ * @when dials to first address fail repeatedly, and dial to it succeeds later
+ * @then backoff doubles with each failure, success resets it, moves address
+ * to front and records latency
+ */
+TEST_F(InmemAddressRepository_Test, DialStats) {
+  ASSERT_OUTCOME_SUCCESS(
+      db->addAddresses(p1, std::vector<Multiaddress>{ma1, ma2}, 1000ms));
+  EXPECT_EQ(db->dialStats(p1, ma1)->failures, 0);
+  EXPECT_FALSE(db->dialStats(p1, ma3));
+
+  auto now = std::chrono::steady_clock::now();
+  db->dialFailed(p1, ma1);
+  auto first = db->dialStats(p1, ma1)->backoff_until - now;
+  db->dialFailed(p1, ma1);
+  auto stats = db->dialStats(p1, ma1).value();
+  EXPECT_EQ(stats.failures, 2);
+  EXPECT_EQ(stats.consecutive_failures, 2);
+  EXPECT_TRUE(stats.last_failure);
+  EXPECT_GE(first, InmemAddressRepository::kDialBackoff);
+  EXPECT_GE(stats.backoff_until - now,
+            2 * InmemAddressRepository::kDialBackoff);
+
+  db->dialSucceeded(p1, ma1, 100ms);
+  db->dialSucceeded(p1, ma1, 20ms);
+  stats = db->dialStats(p1, ma1).value();
+  EXPECT_EQ(stats.successes, 2);
+  EXPECT_EQ(stats.consecutive_failures, 0);
+  EXPECT_LE(stats.backoff_until, std::chrono::steady_clock::now());
+  EXPECT_EQ(stats.latency, 80ms);
+  EXPECT_DOUBLE_EQ(stats.successRate(), 0.5);
+  auto view = db->peekAddresses(p1);
+  EXPECT_EQ(std::vector(view.begin(), view.end()),
+            std::vector<Multiaddress>({ma1, ma2}));
+}
@@ -0,0 +1,64 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <gtest/gtest.h>
+#include <libp2p/common/literals.hpp>
+#include <libp2p/peer/latency_repository/inmem_latency_repository.hpp>
+
+using namespace libp2p::peer;
+using namespace libp2p::common;
+using std::chrono_literals::operator""ms;
+
+struct InmemLatencyRepository_Test : public ::testing::Test {
+  std::unique_ptr<LatencyRepository> db =
+      std::make_unique<InmemLatencyRepository>();
+
+  const PeerId p1 = PeerId::fromHash("12051203020304"_multihash).value();
+  const PeerId p2 = PeerId::fromHash("12051203FFFFFF"_multihash).value();
+};
+
+/**
+ * @given empty repository
+ * @when round trip times of a peer are recorded
+ * @then average starts from first sample and moves towards the new ones
+ * @and samples are counted in histogram buckets
+ */
+TEST_F(InmemLatencyRepository_Test, RecordRtt) {
+  ASSERT_FALSE(db->getLatency(p1));
+
+  db->recordRtt(p1, 100ms);
+  db->recordRtt(p1, 200ms);
+  db->recordRtt(p1, 5000ms);
+
+  auto latency = db->getLatency(p1);
+  ASSERT_TRUE(latency);
+  EXPECT_EQ(latency->samples, 3);
+  EXPECT_EQ(latency->last, 5000ms);
+  EXPECT_DOUBLE_EQ(latency->ewma.count(), 100 + 10 + 0.1 * (5000 - 110));
+
+  // 100ms and 200ms are upper bounds of their buckets
+  EXPECT_EQ(latency->histogram[6], 1);
+  EXPECT_EQ(latency->histogram[7], 1);
+  EXPECT_EQ(latency->histogram.back(), 1);
+
+  ASSERT_FALSE(db->getLatency(p2));
+}
+
+/**
+ * @given repository with latencies of two peers
+ * @when one peer is cleared
+ * @then only the other peer is known
+ */
+TEST_F(InmemLatencyRepository_Test, Clear) {
+  db->recordRtt(p1, 1ms);
+  db->recordRtt(p2, 1ms);
+  ASSERT_EQ(db->getPeers().size(), 2);
+
+  db->clear(p1);
+  ASSERT_FALSE(db->getLatency(p1));
+  ASSERT_TRUE(db->getLatency(p2));
+  ASSERT_EQ(db->getPeers(), std::unordered_set<PeerId>{p2});
+}
@@ -0,0 +1,115 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/peer/impl/persistent_peer_repository.hpp>
+
+#include <filesystem>
+
+#include <gtest/gtest.h>
+#include <qtils/test/outcome.hpp>
+
+#include <libp2p/common/literals.hpp>
+#include <libp2p/peer/address_repository/inmem_address_repository.hpp>
+#include <libp2p/peer/impl/peer_repository_impl.hpp>
+#include <libp2p/peer/key_repository/inmem_key_repository.hpp>
+#include <libp2p/peer/protocol_repository/inmem_protocol_repository.hpp>
+#include "mock/libp2p/basic/scheduler_mock.hpp"
+#include "mock/libp2p/network/dnsaddr_resolver_mock.hpp"
+#include "testutil/prepare_loggers.hpp"
+
+using namespace libp2p;
+using namespace libp2p::peer;
+using namespace libp2p::common;
+using ::testing::NiceMock;
+
+struct PersistentPeerRepositoryTest : public ::testing::Test {
+  void SetUp() override {
+    testutil::prepareLoggers();
+    remove();
+    // writer creates database before readers are opened
+    writer = std::make_shared<storage::SQLiteWriter>(
+        kTestDbFile, storage::SQLiteWriter::Config{});
+    readers = std::make_shared<storage::SQLiteReaderPool>(kTestDbFile, 1);
+  }
+
+  void TearDown() override {
+    readers.reset();
+    writer.reset();
+    remove();
+  }
+
+  void remove() {
+    for (auto suffix : {"", "-wal", "-shm"}) {
+      std::filesystem::remove(kTestDbFile + suffix);
+    }
+  }
+
+  /// Repository as after restart, on the same database
+  std::shared_ptr<PersistentPeerRepository> repository() {
+    auto inmem = std::make_shared<PeerRepositoryImpl>(
+        std::make_shared<InmemAddressRepository>(
+            std::make_shared<network::DnsaddrResolverMock>()),
+        std::make_shared<InmemKeyRepository>(),
+        std::make_shared<InmemProtocolRepository>());
+    auto repository = std::make_shared<PersistentPeerRepository>(
+        config, inmem, writer, readers, scheduler);
+    repository->start();
+    return repository;
+  }
+
+  const std::string kTestDbFile = "test_peer_repository.sqlite";
+  PersistentPeerRepository::Config config;
+  std::shared_ptr<storage::SQLiteWriter> writer;
+  std::shared_ptr<storage::SQLiteReaderPool> readers;
+  std::shared_ptr<NiceMock<basic::SchedulerMock>> scheduler =
+      std::make_shared<NiceMock<basic::SchedulerMock>>();
+
+  const PeerId peer = PeerId::fromHash("12051203020304"_multihash).value();
+  const Multiaddress address = "/ip4/127.0.0.1/tcp/8080"_multiaddr;
+  const ProtocolName protocol = "/ipfs/kad/1.0.0";
+};
+
+/**
+ * @given repository with address and protocol of peer
+ * @when changes are written and repository is recreated
+ * @then address and protocol of peer are loaded
+ */
+TEST_F(PersistentPeerRepositoryTest, PeersSurviveRestart) {
+  auto before = repository();
+  ASSERT_OUTCOME_SUCCESS(before->getAddressRepository().upsertAddresses(
+      peer, std::span(&address, 1), ttl::kDay));
+  ASSERT_OUTCOME_SUCCESS(before->getProtocolRepository().addProtocols(
+      peer, std::span(&protocol, 1)));
+  before->markChanged(peer);
+  before.reset();
+  ASSERT_TRUE(writer->flush());
+
+  auto after = repository();
+  auto addresses = after->getAddressRepository().peekAddresses(peer);
+  ASSERT_EQ(std::vector<Multiaddress>(addresses.begin(), addresses.end()),
+            std::vector<Multiaddress>{address});
+  ASSERT_OUTCOME_SUCCESS(protocols,
+                         after->getProtocolRepository().getProtocols(peer));
+  ASSERT_EQ(protocols, std::vector<std::string_view>{protocol});
+}
+
+/**
+ * @given peer loaded from database
+ * @when all its addresses are cleared and changes are written
+ * @then peer is not loaded after restart
+ */
+TEST_F(PersistentPeerRepositoryTest, ForgottenPeersAreErased) {
+  auto before = repository();
+  ASSERT_OUTCOME_SUCCESS(before->getAddressRepository().upsertAddresses(
+      peer, std::span(&address, 1), ttl::kDay));
+  before->flush();
+  before->getAddressRepository().clear(peer);
+  before.reset();
+  ASSERT_TRUE(writer->flush());
+
+  auto after = repository();
+  ASSERT_TRUE(after->getAddressRepository().peekAddresses(peer).empty());
+}
@@ -34,6 +34,11 @@ struct InmemProtocolRepository_Test : public ::testing::Test {
     return std::vector<ProtocolName>{arg...};
   }
 
+  template <typename... T>
+  std::vector<std::string_view> views(T &&...arg) {
+    return std::vector<std::string_view>{arg...};
+  }
+
   template <typename... T>
   std::set<ProtocolName> set(T &&...arg) {
     return std::set<ProtocolName>{arg...};
@@ -98,26 +103,26 @@ TEST_F(InmemProtocolRepository_Test, Supports) {
   // one of
   {
     ASSERT_OUTCOME_SUCCESS(v, db->supportsProtocols(p1, set(s1)));
-    EXPECT_EQ(v, vec(s1));
+    EXPECT_EQ(v, views(s1));
   }
 
   // forward order
   {
     ASSERT_OUTCOME_SUCCESS(v, db->supportsProtocols(p1, set(s1, s2)));
-    EXPECT_EQ(v, vec(s1, s2));
+    EXPECT_EQ(v, views(s1, s2));
   }
 
   // reverse order
   {
     ASSERT_OUTCOME_SUCCESS(v, db->supportsProtocols(p1, set(s2, s1)));
-    EXPECT_EQ(v, vec(s1, s2));
+    EXPECT_EQ(v, views(s1, s2));
   }
 
   // non existing
   {
     ASSERT_OUTCOME_SUCCESS(db->removeProtocols(p1, vec(s1)));
     ASSERT_OUTCOME_SUCCESS(v, db->supportsProtocols(p1, set(s1, s2)));
-    EXPECT_EQ(v, vec(s2));
+    EXPECT_EQ(v, views(s2));
   }
 }
 
@@ -130,7 +135,7 @@ TEST_F(InmemProtocolRepository_Test, Remove) {
   ASSERT_OUTCOME_SUCCESS(db->addProtocols(p1, vec(s1, s2)));
   ASSERT_OUTCOME_SUCCESS(db->removeProtocols(p1, vec(s1)));
   ASSERT_OUTCOME_SUCCESS(v, db->getProtocols(p1));
-  EXPECT_EQ(v, vec(s2));
+  EXPECT_EQ(v, views(s2));
 }
 
 /**
@@ -159,3 +164,47 @@ TEST_F(InmemProtocolRepository_Test, GetPeers) {
   auto s = db->getPeers();
   EXPECT_EQ(s.size(), 2);
 }
+
+/**
+ * @given p1 with s1 and p2 with s2
+ * @when p1 is cleared, garbage is collected and p2 adds s1 again
+ * @then released protocol is interned again, p2 supports both protocols
+ */
+TEST_F(InmemProtocolRepository_Test, ReinternAfterCollectGarbage) {
+  ASSERT_OUTCOME_SUCCESS(db->addProtocols(p1, vec(s1)));
+  ASSERT_OUTCOME_SUCCESS(db->addProtocols(p2, vec(s2)));
+  db->clear(p1);
+  db->collectGarbage();
+
+  {
+    ASSERT_OUTCOME_SUCCESS(v, db->supportsProtocols(p2, set(s1, s2)));
+    EXPECT_EQ(v, views(s2));
+  }
+
+  ASSERT_OUTCOME_SUCCESS(db->addProtocols(p2, vec(s1)));
+  ASSERT_OUTCOME_SUCCESS(v, db->supportsProtocols(p2, set(s1, s2)));
+  EXPECT_EQ(v, views(s1, s2));
+}
+
+/**
+ * @given repository sharing peer index with key repository
+ * @when peers are added and p1 is evicted by garbage collection
+ * @then index keeps peers stored by any of repositories
+ */
+TEST_F(InmemProtocolRepository_Test, PeerIndex) {
+  auto index = std::make_shared<PeerIndex>();
+  db = std::make_unique<InmemProtocolRepository>(index);
+  ASSERT_OUTCOME_SUCCESS(db->addProtocols(p1, {}));
+  ASSERT_OUTCOME_SUCCESS(db->addProtocols(p2, vec(s1)));
+  index->add(p2, PeerIndex::KEY);
+  EXPECT_EQ(index->size(), 2);
+
+  db->collectGarbage();
+  std::vector<PeerId> peers;
+  index->forEach([&](const PeerId &peer) { peers.emplace_back(peer); });
+  EXPECT_EQ(peers, std::vector{p2});
+
+  db->clear(p2);
+  db->collectGarbage();
+  EXPECT_EQ(index->size(), 1);
+}
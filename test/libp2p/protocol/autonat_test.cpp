@@ -0,0 +1,227 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <gtest/gtest.h>
+#include <boost/asio/io_context.hpp>
+#include <libp2p/basic/scheduler/manual_scheduler_backend.hpp>
+#include <libp2p/basic/scheduler/scheduler_impl.hpp>
+#include <libp2p/common/literals.hpp>
+#include <libp2p/protocol/autonat/autonat.hpp>
+#include <libp2p/protocol/autonat/error.hpp>
+#include <libp2p/transport/memory/connection.hpp>
+#include <libp2p/transport/memory/stream.hpp>
+
+#include "mock/libp2p/connection/capable_connection_mock.hpp"
+#include "mock/libp2p/host/host_mock.hpp"
+#include "mock/libp2p/network/transport_manager_mock.hpp"
+#include "mock/libp2p/transport/transport_mock.hpp"
+#include "testutil/libp2p/peer.hpp"
+
+using libp2p::AutonatError;
+using libp2p::HostMock;
+using libp2p::Multiaddress;
+using libp2p::StreamAndProtocol;
+using libp2p::StreamAndProtocolOrErrorCb;
+using libp2p::basic::ManualSchedulerBackend;
+using libp2p::basic::SchedulerImpl;
+using libp2p::connection::CapableConnectionMock;
+using libp2p::connection::MemoryStream;
+using libp2p::network::AddressReachability;
+using libp2p::network::Reachability;
+using libp2p::network::TransportManagerMock;
+using libp2p::peer::PeerId;
+using libp2p::peer::PeerInfo;
+using libp2p::protocol::autonat::Autonat;
+using libp2p::protocol::autonat::AutonatConfig;
+using libp2p::protocol::autonat::kAutonatProto;
+using libp2p::transport::MemoryConnection;
+using libp2p::transport::TransportAdaptor;
+using libp2p::transport::TransportMock;
+using testing::_;
+using testing::Return;
+using namespace libp2p::common;
+
+class AutonatTest : public testing::Test {
+ public:
+  void SetUp() override {
+    std::tie(client_conn, server_conn) = MemoryConnection::makePair(
+        {io, "/ip4/1.1.1.1/tcp/5"_multiaddr, client_peer, {}},
+        {io, "/ip4/2.2.2.2/tcp/1"_multiaddr, server_peer, {}});
+    ON_CALL(client_host, getId()).WillByDefault(Return(client_peer));
+    ON_CALL(client_host, getObservedAddresses())
+        .WillByDefault(Return(std::vector{public_addr}));
+    // server doesn't dial IPs other than observed one
+    ON_CALL(client_host, getAddresses())
+        .WillByDefault(Return(std::vector{
+            private_addr, "/ip4/0.0.0.0/tcp/1"_multiaddr}));
+    // streams opened by client are handled by server
+    ON_CALL(client_host, newStream(_, _, _))
+        .WillByDefault([&](const PeerInfo &peer,
+                           auto &&,
+                           StreamAndProtocolOrErrorCb cb) {
+          EXPECT_EQ(peer.id, server_peer);
+          auto [client_end, server_end] =
+              MemoryStream::makePair(client_conn, server_conn);
+          server->handle({server_end, kAutonatProto});
+          cb(StreamAndProtocol{client_end, kAutonatProto});
+        });
+    ON_CALL(*transports, findBest(_)).WillByDefault(Return(transport));
+    ON_CALL(*dialed, close()).WillByDefault(Return(outcome::success()));
+    sub = bus.getChannel<libp2p::event::network::AddressReachabilityChannel>()
+              .subscribe([&](const AddressReachability &r) {
+                events.emplace_back(r.address, r.reachability);
+              });
+  }
+
+  void makeAutonat(AutonatConfig config = {}) {
+    client = std::make_shared<Autonat>(
+        client_host, bus, transports, scheduler, config);
+    server = std::make_shared<Autonat>(
+        server_host, bus, transports, scheduler, config);
+  }
+
+  /// Dial back succeeds or fails
+  void expectDial(bool success) {
+    EXPECT_CALL(*transport, dial(client_peer, public_addr, _))
+        .WillOnce([&, success](auto &&, auto &&, auto cb) {
+          if (success) {
+            cb(dialed);
+          } else {
+            cb(make_error_code(std::errc::connection_refused));
+          }
+        });
+  }
+
+  outcome::result<Multiaddress> probe() {
+    std::optional<outcome::result<Multiaddress>> result;
+    client->probe(server_peer, [&](auto r) { result = r; });
+    run();
+    if (not result) {
+      ADD_FAILURE() << "probe not completed";
+      return AutonatError::INTERNAL_ERROR;
+    }
+    return result.value();
+  }
+
+  /// Runs io_context and scheduler till both are idle
+  void run() {
+    while (true) {
+      backend->shift(std::chrono::milliseconds{0});
+      io->restart();
+      if (io->poll() == 0) {
+        break;
+      }
+    }
+  }
+
+  std::shared_ptr<boost::asio::io_context> io =
+      std::make_shared<boost::asio::io_context>();
+  std::shared_ptr<ManualSchedulerBackend> backend =
+      std::make_shared<ManualSchedulerBackend>();
+  std::shared_ptr<SchedulerImpl> scheduler =
+      std::make_shared<SchedulerImpl>(backend, SchedulerImpl::Config{});
+  libp2p::event::Bus bus;
+  PeerId client_peer = testutil::randomPeerId();
+  PeerId server_peer = testutil::randomPeerId();
+  Multiaddress public_addr = "/ip4/1.1.1.1/tcp/1"_multiaddr;
+  Multiaddress private_addr = "/ip4/10.0.0.1/tcp/1"_multiaddr;
+  std::shared_ptr<MemoryConnection> client_conn, server_conn;
+  testing::NiceMock<HostMock> client_host, server_host;
+  std::shared_ptr<TransportManagerMock> transports =
+      std::make_shared<testing::NiceMock<TransportManagerMock>>();
+  std::shared_ptr<TransportMock> transport = std::make_shared<TransportMock>();
+  std::shared_ptr<CapableConnectionMock> dialed =
+      std::make_shared<testing::NiceMock<CapableConnectionMock>>();
+  std::vector<std::pair<Multiaddress, Reachability>> events;
+  libp2p::event::Handle sub;
+  std::shared_ptr<Autonat> client, server;
+};
+
+/**
+ * @given client with public and private addresses
+ * @when server dials public one back
+ * @then public address is confirmed, private one is not dialed
+ */
+TEST_F(AutonatTest, Public) {
+  makeAutonat();
+  expectDial(true);
+  EXPECT_CALL(*dialed, close()).WillOnce(Return(outcome::success()));
+  auto result = probe();
+  ASSERT_TRUE(result) << result.error();
+  EXPECT_EQ(result.value(), public_addr);
+  EXPECT_EQ(client->reachability(public_addr), Reachability::PUBLIC);
+  EXPECT_EQ(client->reachability(private_addr), Reachability::UNKNOWN);
+  EXPECT_EQ(events,
+            (decltype(events){{public_addr, Reachability::PUBLIC}}));
+}
+
+/**
+ * @given client behind NAT
+ * @when server fails to dial it back, and succeeds later
+ * @then addresses become private, and change only after enough successes
+ */
+TEST_F(AutonatTest, Confidence) {
+  makeAutonat({.max_confidence = 1});
+  for (auto i = 0; i < 2; ++i) {
+    expectDial(false);
+    EXPECT_EQ(probe().error(), make_error_code(AutonatError::DIAL_ERROR));
+  }
+  EXPECT_EQ(client->reachability(public_addr), Reachability::PRIVATE);
+  EXPECT_EQ(client->reachability(private_addr), Reachability::PRIVATE);
+
+  expectDial(true);
+  EXPECT_TRUE(probe());
+  EXPECT_EQ(client->reachability(public_addr), Reachability::PRIVATE);
+
+  expectDial(true);
+  EXPECT_TRUE(probe());
+  EXPECT_EQ(client->reachability(public_addr), Reachability::PUBLIC);
+  EXPECT_EQ(events,
+            (decltype(events){
+                {public_addr, Reachability::PRIVATE},
+                {private_addr, Reachability::PRIVATE},
+                {public_addr, Reachability::PUBLIC},
+            }));
+}
+
+/**
+ * @given server, which serves no dial backs
+ * @when client probes
+ * @then dial is refused, reachability stays unknown
+ */
+TEST_F(AutonatTest, Refused) {
+  makeAutonat({.max_dials = 0});
+  EXPECT_CALL(*transport, dial(_, _, _)).Times(0);
+  EXPECT_EQ(probe().error(), make_error_code(AutonatError::DIAL_REFUSED));
+  EXPECT_EQ(client->reachability(public_addr), Reachability::UNKNOWN);
+  EXPECT_TRUE(events.empty());
+}
+
+/**
+ * @given dial back, which hangs
+ * @when dial timeout passes
+ * @then dial error is responded, late connection is closed
+ */
+TEST_F(AutonatTest, DialTimeout) {
+  makeAutonat();
+  TransportAdaptor::HandlerFunc dial_cb;
+  EXPECT_CALL(*transport, dial(client_peer, public_addr, _))
+      .WillOnce([&](auto &&, auto &&, auto cb) { dial_cb = std::move(cb); });
+  std::optional<outcome::result<Multiaddress>> result;
+  client->probe(server_peer, [&](auto r) { result = r; });
+  run();
+  ASSERT_TRUE(dial_cb);
+  EXPECT_FALSE(result);
+
+  backend->shift(AutonatConfig{}.dial_timeout);
+  run();
+  ASSERT_TRUE(result);
+  EXPECT_EQ(result.value().error(),
+            make_error_code(AutonatError::DIAL_ERROR));
+
+  EXPECT_CALL(*dialed, close()).WillOnce(Return(outcome::success()));
+  dial_cb(dialed);
+}
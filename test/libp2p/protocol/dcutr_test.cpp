@@ -0,0 +1,226 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <gtest/gtest.h>
+#include <boost/asio/io_context.hpp>
+#include <libp2p/basic/scheduler/manual_scheduler_backend.hpp>
+#include <libp2p/basic/scheduler/scheduler_impl.hpp>
+#include <libp2p/common/literals.hpp>
+#include <libp2p/protocol/dcutr/dcutr.hpp>
+#include <libp2p/protocol/dcutr/error.hpp>
+#include <libp2p/transport/memory/connection.hpp>
+#include <libp2p/transport/memory/stream.hpp>
+
+#include "mock/libp2p/connection/capable_connection_mock.hpp"
+#include "mock/libp2p/host/host_mock.hpp"
+#include "testutil/libp2p/peer.hpp"
+
+using libp2p::DcutrError;
+using libp2p::Host;
+using libp2p::HostMock;
+using libp2p::Multiaddress;
+using libp2p::StreamAndProtocol;
+using libp2p::StreamAndProtocolOrErrorCb;
+using libp2p::basic::ManualSchedulerBackend;
+using libp2p::basic::SchedulerImpl;
+using libp2p::connection::CapableConnectionMock;
+using libp2p::connection::MemoryStream;
+using libp2p::connection::Stream;
+using libp2p::peer::PeerId;
+using libp2p::peer::PeerInfo;
+using libp2p::protocol::dcutr::Dcutr;
+using libp2p::protocol::dcutr::DcutrConfig;
+using libp2p::transport::MemoryConnection;
+using testing::_;
+using testing::Return;
+using namespace libp2p::common;
+
+class DcutrTest : public testing::Test {
+ public:
+  void SetUp() override {
+    std::tie(a_conn, b_conn) = MemoryConnection::makePair(
+        {io, "/memory/1/p2p-circuit"_multiaddr, a_peer, {}},
+        {io, "/memory/2/p2p-circuit"_multiaddr, b_peer, {}});
+    ON_CALL(a_host, getObservedAddresses())
+        .WillByDefault(Return(std::vector{a_addr}));
+    ON_CALL(b_host, getObservedAddresses())
+        .WillByDefault(Return(std::vector{b_addr}));
+    // relayed addresses are not punched to
+    ON_CALL(b_host, getAddresses())
+        .WillByDefault(Return(std::vector{"/memory/2/p2p-circuit"_multiaddr}));
+    // streams opened by "a" are handled by "b"
+    ON_CALL(a_host, newStream(_, _, _))
+        .WillByDefault([&](const PeerInfo &peer,
+                           auto &&,
+                           StreamAndProtocolOrErrorCb cb) {
+          EXPECT_EQ(peer.id, b_peer);
+          auto [a_end, b_end] = MemoryStream::makePair(a_conn, b_conn);
+          if (b_responds) {
+            b->handle({b_end, libp2p::protocol::dcutr::kDcutrProto});
+          } else {
+            hanging.emplace_back(b_end);
+          }
+          cb(StreamAndProtocol{a_end, libp2p::protocol::dcutr::kDcutrProto});
+        });
+    ON_CALL(b_host, connect(_, _))
+        .WillByDefault([&](const PeerInfo &peer, auto &&cb) {
+          EXPECT_EQ(peer.id, a_peer);
+          EXPECT_EQ(peer.addresses, std::vector{a_addr});
+          ++b_dials;
+          cb(direct_b);
+        });
+  }
+
+  void TearDown() override {
+    for (auto &stream : hanging) {
+      stream->reset();
+    }
+    run();
+  }
+
+  void makeDcutr(DcutrConfig config = {}) {
+    a = std::make_shared<Dcutr>(a_host, scheduler, config);
+    b = std::make_shared<Dcutr>(b_host, scheduler, config);
+  }
+
+  /// Runs io_context and scheduler till both are idle
+  void run() {
+    while (true) {
+      backend->shift(std::chrono::milliseconds{0});
+      io->restart();
+      if (io->poll() == 0) {
+        break;
+      }
+    }
+  }
+
+  std::optional<Host::ConnectionResult> upgrade() {
+    std::optional<Host::ConnectionResult> result;
+    a->upgrade(b_peer, [&](Host::ConnectionResult r) { result = r; });
+    run();
+    return result;
+  }
+
+  std::shared_ptr<boost::asio::io_context> io =
+      std::make_shared<boost::asio::io_context>();
+  std::shared_ptr<ManualSchedulerBackend> backend =
+      std::make_shared<ManualSchedulerBackend>();
+  std::shared_ptr<SchedulerImpl> scheduler =
+      std::make_shared<SchedulerImpl>(backend, SchedulerImpl::Config{});
+  PeerId a_peer = testutil::randomPeerId();
+  PeerId b_peer = testutil::randomPeerId();
+  Multiaddress a_addr = "/ip4/1.1.1.1/tcp/1"_multiaddr;
+  Multiaddress b_addr = "/ip4/2.2.2.2/tcp/2"_multiaddr;
+  std::shared_ptr<MemoryConnection> a_conn, b_conn;
+  testing::NiceMock<HostMock> a_host, b_host;
+  std::shared_ptr<CapableConnectionMock> direct_a =
+      std::make_shared<CapableConnectionMock>();
+  std::shared_ptr<CapableConnectionMock> direct_b =
+      std::make_shared<CapableConnectionMock>();
+  bool b_responds = true;
+  size_t b_dials = 0;
+  std::vector<std::shared_ptr<Stream>> hanging;
+  std::shared_ptr<Dcutr> a, b;
+};
+
+/**
+ * @given peers connected through relay
+ * @when one of them upgrades connection
+ * @then both dial each other by observed addresses
+ */
+TEST_F(DcutrTest, Upgrade) {
+  makeDcutr();
+  EXPECT_CALL(a_host, connect(_, _))
+      .WillOnce([&](const PeerInfo &peer, auto &&cb) {
+        EXPECT_EQ(peer.id, b_peer);
+        EXPECT_EQ(peer.addresses, std::vector{b_addr});
+        cb(direct_a);
+      });
+  auto result = upgrade();
+  ASSERT_TRUE(result);
+  ASSERT_TRUE(result.value());
+  EXPECT_EQ(result.value().value(), direct_a);
+  EXPECT_EQ(b_dials, 1);
+}
+
+/**
+ * @given peers connected through relay, direct dial fails
+ * @when one of them upgrades connection
+ * @then hole punching is retried up to max attempts
+ */
+TEST_F(DcutrTest, Retry) {
+  makeDcutr({.max_attempts = 2});
+  EXPECT_CALL(a_host, connect(_, _))
+      .Times(2)
+      .WillRepeatedly([&](const PeerInfo &, auto &&cb) {
+        cb(make_error_code(std::errc::connection_refused));
+      });
+  auto result = upgrade();
+  ASSERT_TRUE(result);
+  EXPECT_EQ(result.value().error(),
+            make_error_code(std::errc::connection_refused));
+  EXPECT_EQ(b_dials, 2);
+}
+
+/**
+ * @given peer without direct addresses
+ * @when it upgrades connection
+ * @then upgrade fails without talking to other peer
+ */
+TEST_F(DcutrTest, NoAddresses) {
+  makeDcutr();
+  ON_CALL(a_host, getObservedAddresses())
+      .WillByDefault(Return(std::vector<Multiaddress>{}));
+  EXPECT_CALL(a_host, newStream(_, _, _)).Times(0);
+  auto result = upgrade();
+  ASSERT_TRUE(result);
+  EXPECT_EQ(result.value().error(),
+            make_error_code(DcutrError::NO_ADDRESSES));
+}
+
+/**
+ * @given peer, which doesn't respond
+ * @when other peer upgrades connection
+ * @then upgrade fails after timeout
+ */
+TEST_F(DcutrTest, Timeout) {
+  makeDcutr({.max_attempts = 1});
+  b_responds = false;
+  std::optional<Host::ConnectionResult> result;
+  a->upgrade(b_peer, [&](Host::ConnectionResult r) { result = r; });
+  run();
+  EXPECT_FALSE(result);
+  backend->shift(DcutrConfig{}.timeout);
+  run();
+  ASSERT_TRUE(result);
+  EXPECT_EQ(result.value().error(), make_error_code(DcutrError::TIMEOUT));
+  EXPECT_EQ(b_dials, 0);
+}
+
+/**
+ * @given peer, which doesn't respond
+ * @when other peer upgrades connection, and its dcutr is destroyed while
+ * waiting for response
+ * @then upgrade fails instead of hanging, when stream fails
+ */
+TEST_F(DcutrTest, DestroyedDuringUpgrade) {
+  makeDcutr();
+  b_responds = false;
+  std::optional<Host::ConnectionResult> result;
+  a->upgrade(b_peer, [&](Host::ConnectionResult r) { result = r; });
+  run();
+  EXPECT_FALSE(result);
+
+  a.reset();
+  for (auto &stream : std::exchange(hanging, {})) {
+    stream->reset();
+  }
+  run();
+  ASSERT_TRUE(result);
+  EXPECT_EQ(result.value().error(),
+            make_error_code(boost::asio::error::operation_aborted));
+  EXPECT_EQ(b_dials, 0);
+}
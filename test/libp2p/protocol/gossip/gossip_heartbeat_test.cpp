@@ -0,0 +1,157 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/protocol/gossip/gossip.hpp>
+
+#include <set>
+
+#include <gtest/gtest.h>
+
+#include <libp2p/basic/scheduler/manual_scheduler_backend.hpp>
+#include <libp2p/basic/scheduler/scheduler_impl.hpp>
+
+#include "mock/libp2p/host/host_mock.hpp"
+#include "mock/libp2p/peer/address_repository_mock.hpp"
+#include "mock/libp2p/peer/peer_repository_mock.hpp"
+#include "testutil/libp2p/peer.hpp"
+
+namespace g = libp2p::protocol::gossip;
+
+using libp2p::Bytes;
+using libp2p::Host;
+using libp2p::StreamAndProtocolOrErrorCb;
+using libp2p::peer::AddressRepositoryMock;
+using libp2p::peer::PeerId;
+using libp2p::peer::PeerInfo;
+using libp2p::peer::PeerRepositoryMock;
+using testing::_;
+using testing::AnyNumber;
+using testing::Invoke;
+using testing::NiceMock;
+using testing::Return;
+using testing::ReturnRef;
+
+/**
+ * Gossip without connected peers, with heartbeat interval split into slices.
+ * Dials are recorded and never complete
+ */
+struct GossipHeartbeatTest : public ::testing::Test {
+  void SetUp() override {
+    EXPECT_CALL(*host, getId()).WillRepeatedly(Return(local_id));
+    EXPECT_CALL(*host, getPeerInfo())
+        .WillRepeatedly(Return(PeerInfo{local_id, {}}));
+    EXPECT_CALL(*host, setProtocolHandler(_, _, _)).Times(AnyNumber());
+    EXPECT_CALL(*host, getPeerRepository())
+        .WillRepeatedly(ReturnRef(peer_repo));
+    EXPECT_CALL(peer_repo, getAddressRepository())
+        .WillRepeatedly(ReturnRef(addr_repo));
+    EXPECT_CALL(peer_repo, getPeerInfo(_))
+        .WillRepeatedly(
+            Invoke([](const PeerId &peer) { return PeerInfo{peer, {}}; }));
+    EXPECT_CALL(*host, connectedness(_))
+        .WillRepeatedly(Return(Host::Connectedness::CAN_CONNECT));
+    EXPECT_CALL(*host, newStream(_, _, _))
+        .WillRepeatedly(
+            Invoke([this](const PeerInfo &peer, auto, auto cb) {
+              dialed.push_back(peer.id);
+              dial_cbs.push_back(std::move(cb));
+            }));
+
+    config.heartbeat_interval_msec = std::chrono::milliseconds{1000};
+    config.heartbeat_slices = kSlices;
+    config.datagram_control = false;
+  }
+
+  void TearDown() override {
+    gossip->stop();
+  }
+
+  void start() {
+    gossip = g::create(scheduler, host, nullptr, nullptr, nullptr, config);
+    gossip->start();
+  }
+
+  /// Runs one heartbeat tick
+  void tick() {
+    backend->shift(config.heartbeat_interval_msec / kSlices);
+  }
+
+  static constexpr size_t kSlices = 4;
+
+  g::Config config;
+  std::shared_ptr<libp2p::basic::ManualSchedulerBackend> backend =
+      std::make_shared<libp2p::basic::ManualSchedulerBackend>();
+  std::shared_ptr<libp2p::basic::SchedulerImpl> scheduler =
+      std::make_shared<libp2p::basic::SchedulerImpl>(
+          backend, libp2p::basic::Scheduler::Config{});
+  PeerId local_id = testutil::randomPeerId();
+  std::shared_ptr<libp2p::HostMock> host =
+      std::make_shared<libp2p::HostMock>();
+  PeerRepositoryMock peer_repo;
+  NiceMock<AddressRepositoryMock> addr_repo;
+  std::shared_ptr<g::Gossip> gossip;
+
+  std::vector<PeerId> dialed;
+  std::vector<StreamAndProtocolOrErrorCb> dial_cbs;
+};
+
+/**
+ * @given fanout topics whose fanout period ends within a heartbeat interval
+ * @when ticks of the next interval run
+ * @then each tick maintains its share of topics, every topic is maintained
+ * once, so all expired topics are removed by the end of the interval
+ */
+TEST_F(GossipHeartbeatTest, SlicesCoverTopicsOnce) {
+  constexpr size_t kTopics = 10;
+  config.seen_cache_lifetime_msec = config.heartbeat_interval_msec * 11 / 10;
+  start();
+  for (size_t i = 0; i < kTopics; ++i) {
+    ASSERT_TRUE(gossip->publish(fmt::format("topic{}", i), Bytes{1}));
+  }
+  ASSERT_EQ(gossip->topicStats().size(), kTopics);
+
+  // fanout period didn't end yet
+  for (size_t i = 0; i < kSlices; ++i) {
+    tick();
+  }
+  ASSERT_EQ(gossip->topicStats().size(), kTopics);
+
+  // ceil(left / remaining slices) each tick
+  std::vector<size_t> left;
+  for (size_t i = 0; i < kSlices; ++i) {
+    tick();
+    left.push_back(gossip->topicStats().size());
+  }
+  EXPECT_EQ(left, (std::vector<size_t>{7, 4, 2, 0}));
+}
+
+/**
+ * @given more connectable peers than one tick dials
+ * @when ticks of one heartbeat interval run
+ * @then missing connections are dialed in shares of the interval, each peer
+ * once, and the next interval doesn't dial peers being connected
+ */
+TEST_F(GossipHeartbeatTest, SlicesDialPeersOnce) {
+  constexpr size_t kPeers = 6;
+  config.ideal_connections_num = kPeers;
+  start();
+  for (size_t i = 0; i < kPeers; ++i) {
+    gossip->addBootstrapPeer(testutil::randomPeerId(), boost::none);
+  }
+
+  std::vector<size_t> dials;
+  for (size_t i = 0; i < kSlices; ++i) {
+    tick();
+    dials.push_back(dialed.size());
+  }
+  EXPECT_EQ(dials, (std::vector<size_t>{2, 4, 5, 6}));
+  EXPECT_EQ(std::set<PeerId>(dialed.begin(), dialed.end()).size(), kPeers);
+
+  for (size_t i = 0; i < kSlices; ++i) {
+    tick();
+  }
+  EXPECT_EQ(dialed.size(), kPeers);
+}
@@ -6,6 +6,8 @@
 
 #include "src/protocol/gossip/impl/local_subscriptions.hpp"
 
+#include <thread>
+
 #include <fmt/format.h>
 #include <gtest/gtest.h>
 
@@ -142,3 +144,87 @@ TEST(Gossip, MultipleSubscriptons) {
     s->checkExpected();
   }
 }
+
+/**
+ * @given queue subscriptions with each overflow policy, capacity 2
+ * @when 3 messages are forwarded
+ * @then queues keep the first or the last messages, shared without copy,
+ * and the pausing queue asks to resume once drained to half
+ */
+TEST(Gossip, QueueOverflow) {
+  using Queue = g::SubscriptionQueue;
+  auto subs = createSubscriptions();
+  auto newest = std::make_shared<Queue>(
+      Queue::Config{.capacity = 2, .overflow = Queue::Overflow::DROP_NEWEST});
+  auto oldest = std::make_shared<Queue>(
+      Queue::Config{.capacity = 2, .overflow = Queue::Overflow::DROP_OLDEST});
+  auto pausing = std::make_shared<Queue>(
+      Queue::Config{.capacity = 2, .overflow = Queue::Overflow::PAUSE_READING});
+  size_t resumed = 0;
+  pausing->onResume([&] { ++resumed; });
+  auto sub1 = subs->subscribe({"1"}, newest);
+  auto sub2 = subs->subscribe({"1"}, oldest);
+  auto sub3 = subs->subscribe({"1"}, pausing);
+
+  std::vector<g::TopicMessage::Ptr> messages;
+  std::vector<size_t> paused;
+  for (uint64_t seq = 0; seq < 3; ++seq) {
+    auto &msg = messages.emplace_back(std::make_shared<g::TopicMessage>(
+        testutil::randomPeerId(), seq, g::fromString("data"), "1"));
+    paused.push_back(subs->forwardMessage(msg));
+  }
+  ASSERT_EQ(paused, (std::vector<size_t>{0, 1, 0}));
+
+  auto pop = [](Queue &queue) {
+    Queue::MessagePtr msg;
+    EXPECT_TRUE(queue.tryPop(msg));
+    return msg;
+  };
+  ASSERT_EQ(newest->dropped(), 1);
+  ASSERT_EQ(&pop(*newest)->data, &messages[0]->data);
+  ASSERT_EQ(&pop(*newest)->data, &messages[1]->data);
+  ASSERT_EQ(oldest->dropped(), 1);
+  ASSERT_EQ(&pop(*oldest)->data, &messages[1]->data);
+  ASSERT_EQ(&pop(*oldest)->data, &messages[2]->data);
+
+  ASSERT_EQ(pausing->size(), 2);
+  pop(*pausing);
+  ASSERT_EQ(resumed, 1);
+  pop(*pausing);
+  ASSERT_EQ(resumed, 1);
+}
+
+/**
+ * @given queue subscription drained by 2 application threads
+ * @when messages are forwarded and subscription is cancelled
+ * @then threads get all messages, and stop when queue is closed
+ */
+TEST(Gossip, QueueWorkers) {
+  constexpr size_t kMessages = 100;
+  auto subs = createSubscriptions();
+  auto queue = std::make_shared<g::SubscriptionQueue>(
+      g::SubscriptionQueue::Config{.capacity = kMessages});
+  auto sub = subs->subscribe({"1"}, queue);
+
+  std::atomic<size_t> received{0};
+  std::vector<std::thread> workers;
+  for (int i = 0; i < 2; ++i) {
+    workers.emplace_back([&] {
+      g::SubscriptionQueue::MessagePtr msg;
+      while (queue->pop(msg)) {
+        EXPECT_EQ(msg->topic, "1");
+        ++received;
+      }
+    });
+  }
+  for (uint64_t seq = 0; seq < kMessages; ++seq) {
+    forwardTestMessage(subs, "1", seq);
+  }
+  sub.cancel();
+  for (auto &worker : workers) {
+    worker.join();
+  }
+  ASSERT_TRUE(queue->closed());
+  ASSERT_EQ(received.load(), kMessages);
+  ASSERT_EQ(queue->dropped(), 0);
+}
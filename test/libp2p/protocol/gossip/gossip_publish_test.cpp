@@ -0,0 +1,196 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/protocol/gossip/gossip.hpp>
+
+#include "src/protocol/gossip/impl/message_builder.hpp"
+
+#include <generated/protocol/gossip/protobuf/rpc.pb.h>
+#include <gtest/gtest.h>
+
+#include <libp2p/basic/scheduler/manual_scheduler_backend.hpp>
+#include <libp2p/basic/scheduler/scheduler_impl.hpp>
+#include <libp2p/multi/uvarint.hpp>
+
+#include "mock/libp2p/connection/stream_mock.hpp"
+#include "mock/libp2p/host/host_mock.hpp"
+#include "testutil/libp2p/peer.hpp"
+
+namespace g = libp2p::protocol::gossip;
+
+using libp2p::Bytes;
+using libp2p::BytesIn;
+using libp2p::BytesOut;
+using libp2p::StreamAndProtocol;
+using libp2p::StreamAndProtocolCb;
+using libp2p::StreamAndProtocolOrErrorCb;
+using libp2p::connection::StreamMock;
+using libp2p::multi::Multiaddress;
+using libp2p::multi::UVarint;
+using libp2p::peer::PeerInfo;
+using testing::_;
+using testing::AnyNumber;
+using testing::Invoke;
+using testing::Return;
+
+/**
+ * Gossip with remote peer in mesh of topic: remote peer's subscription and
+ * GRAFT are read from inbound stream, RPCs to it are written to outbound one
+ */
+struct GossipPublishTest : public ::testing::Test {
+  void SetUp() override {
+    EXPECT_CALL(*host, getId()).WillRepeatedly(Return(local_id));
+    EXPECT_CALL(*host, getPeerInfo())
+        .WillRepeatedly(Return(PeerInfo{local_id, {}}));
+    EXPECT_CALL(*host, setProtocolHandler(_, _, _))
+        .WillOnce(Invoke([this](auto, StreamAndProtocolCb cb, auto) {
+          handler = std::move(cb);
+        }));
+    EXPECT_CALL(*host, newStream(_, _, _))
+        .WillOnce(Invoke([this](auto, auto, StreamAndProtocolOrErrorCb cb) {
+          dialed = std::move(cb);
+        }));
+
+    for (auto &stream : {inbound, outbound}) {
+      EXPECT_CALL(*stream, isClosedForRead()).WillRepeatedly(Return(false));
+      EXPECT_CALL(*stream, isClosedForWrite()).WillRepeatedly(Return(false));
+      EXPECT_CALL(*stream, remotePeerId()).WillRepeatedly(Return(remote_id));
+      EXPECT_CALL(*stream, remoteMultiaddr())
+          .WillRepeatedly(
+              Return(Multiaddress::create("/ip4/10.0.0.1/tcp/4001").value()));
+      EXPECT_CALL(*stream, close(_)).Times(AnyNumber());
+      EXPECT_CALL(*stream, reset()).Times(AnyNumber());
+    }
+    EXPECT_CALL(*inbound, readSome(_, _, _))
+        .WillRepeatedly(Invoke([this](BytesOut out, size_t, auto cb) {
+          read_out = out;
+          read_cb = std::move(cb);
+        }));
+    // remote peer sends nothing on outbound stream
+    EXPECT_CALL(*outbound, readSome(_, _, _)).Times(AnyNumber());
+    EXPECT_CALL(*outbound, writeSome(_, _, _))
+        .WillRepeatedly(Invoke([this](BytesIn in, size_t, auto cb) {
+          written.insert(written.end(), in.begin(), in.end());
+          write_cb = std::move(cb);
+          write_size = in.size();
+        }));
+
+    config.datagram_control = false;
+    gossip = g::create(scheduler, host, nullptr, nullptr, nullptr, config);
+    gossip->start();
+    subscription = gossip->subscribe({topic}, [](auto) {});
+
+    ASSERT_TRUE(handler);
+    handler(StreamAndProtocol{inbound, config.protocol_version});
+    ASSERT_TRUE(dialed);
+    dialed(StreamAndProtocol{outbound, config.protocol_version});
+
+    g::MessageBuilder builder;
+    builder.addSubscription(true, topic);
+    builder.addGraft(topic);
+    receive(builder);
+    completeWrites();
+    written.clear();
+  }
+
+  void TearDown() override {
+    gossip->stop();
+  }
+
+  /// Completes pending read of inbound stream with RPC
+  void receive(g::MessageBuilder &builder) {
+    auto buffers = builder.serialize().value();
+    Bytes rpc;
+    for (auto &buffer : buffers) {
+      rpc.insert(rpc.end(), buffer->begin(), buffer->end());
+    }
+    ASSERT_TRUE(read_cb);
+    ASSERT_LE(rpc.size(), read_out.size());
+    std::copy(rpc.begin(), rpc.end(), read_out.begin());
+    auto cb = std::move(read_cb);
+    read_cb = nullptr;
+    cb(rpc.size());
+  }
+
+  /// Completes writes to outbound stream until none is pending
+  void completeWrites() {
+    while (write_cb) {
+      auto cb = std::move(write_cb);
+      write_cb = nullptr;
+      cb(write_size);
+    }
+  }
+
+  /// Splits written bytes into RPCs
+  std::vector<pubsub::pb::RPC> writtenRpcs() {
+    std::vector<pubsub::pb::RPC> rpcs;
+    BytesIn bytes{written};
+    while (!bytes.empty()) {
+      auto length = UVarint::create(bytes);
+      EXPECT_TRUE(length);
+      if (!length) {
+        break;
+      }
+      bytes = bytes.subspan(length->size());
+      auto size = length->toUInt64();
+      EXPECT_LE(size, bytes.size());
+      if (size > bytes.size()) {
+        break;
+      }
+      EXPECT_TRUE(rpcs.emplace_back().ParseFromArray(bytes.data(), size));
+      bytes = bytes.subspan(size);
+    }
+    return rpcs;
+  }
+
+  g::Config config;
+  std::shared_ptr<libp2p::basic::SchedulerImpl> scheduler =
+      std::make_shared<libp2p::basic::SchedulerImpl>(
+          std::make_shared<libp2p::basic::ManualSchedulerBackend>(),
+          libp2p::basic::Scheduler::Config{});
+  libp2p::peer::PeerId local_id = testutil::randomPeerId();
+  libp2p::peer::PeerId remote_id = testutil::randomPeerId();
+  std::shared_ptr<libp2p::HostMock> host =
+      std::make_shared<libp2p::HostMock>();
+  std::shared_ptr<StreamMock> inbound = std::make_shared<StreamMock>();
+  std::shared_ptr<StreamMock> outbound = std::make_shared<StreamMock>();
+  StreamAndProtocolCb handler;
+  StreamAndProtocolOrErrorCb dialed;
+  std::shared_ptr<g::Gossip> gossip;
+  g::TopicId topic = "topic";
+  libp2p::protocol::Subscription subscription;
+
+  BytesOut read_out;
+  libp2p::basic::Reader::ReadCallbackFunc read_cb;
+
+  /// Bytes written to outbound stream
+  Bytes written;
+  libp2p::basic::Writer::WriteCallbackFunc write_cb;
+  size_t write_size = 0;
+};
+
+/**
+ * @given remote peer in mesh of topic
+ * @when batch of messages is published at once
+ * @then all of them are sent to the peer as one RPC, in order
+ */
+TEST_F(GossipPublishTest, PublishManySendsOneRpc) {
+  std::vector<std::pair<g::TopicId, Bytes>> messages{
+      {topic, {1}},
+      {topic, {2, 2}},
+      {topic, {3, 3, 3}},
+  };
+  ASSERT_TRUE(gossip->publishMany(messages));
+  completeWrites();
+
+  auto rpcs = writtenRpcs();
+  ASSERT_EQ(rpcs.size(), 1);
+  ASSERT_EQ(rpcs[0].publish_size(), 3);
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_EQ(rpcs[0].publish(i).topic(), topic);
+    EXPECT_EQ(rpcs[0].publish(i).data(), std::string(i + 1, char(i + 1)));
+  }
+}
@@ -0,0 +1,139 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/protocol/gossip/impl/score.hpp"
+
+#include <gtest/gtest.h>
+
+#include "testutil/libp2p/peer.hpp"
+
+namespace g = libp2p::protocol::gossip;
+
+using std::chrono::seconds;
+
+class GossipScoreTest : public ::testing::Test {
+ public:
+  void SetUp() override {
+    config.enabled = true;
+    config.default_topic.time_in_mesh_weight = 1;
+    config.default_topic.time_in_mesh_quantum = seconds(1);
+    config.default_topic.time_in_mesh_cap = 10;
+    config.default_topic.first_message_deliveries_weight = 1;
+    config.default_topic.first_message_deliveries_decay = 0.5;
+    config.default_topic.mesh_message_deliveries_weight = -1;
+    config.default_topic.mesh_message_deliveries_threshold = 3;
+    config.default_topic.mesh_message_deliveries_activation = seconds(2);
+    config.default_topic.mesh_message_deliveries_window = seconds(1);
+    config.default_topic.mesh_failure_penalty_weight = -1;
+    config.default_topic.invalid_message_deliveries_weight = -1;
+    config.decay_interval = seconds(100);
+    config.behaviour_penalty_weight = -1;
+    config.ip_colocation_factor_weight = -1;
+    config.ip_colocation_factor_threshold = 1;
+  }
+
+  g::MessageId id(int i) {
+    return g::fromString("message " + std::to_string(i));
+  }
+
+  g::ScoreConfig config;
+  g::Time now{seconds(1000)};
+  libp2p::peer::PeerId peer1 = testutil::randomPeerId();
+  libp2p::peer::PeerId peer2 = testutil::randomPeerId();
+  const g::TopicId topic = "topic";
+};
+
+/**
+ * @given score with default params
+ * @when scoring is disabled
+ * @then all scores are zero and no thresholds apply
+ */
+TEST_F(GossipScoreTest, Disabled) {
+  config.enabled = false;
+  g::Score score{config};
+  score.invalidMessage(peer1, topic);
+  score.addPenalty(peer1, 100);
+  ASSERT_EQ(score.score(peer1), 0);
+  ASSERT_FALSE(score.graylisted(peer1));
+}
+
+/**
+ * @given peer in mesh
+ * @when it stays in mesh, delivers messages first and within window, then
+ * is pruned with delivery deficit
+ * @then P1, P2, P3 and P3b are applied as events happen
+ */
+TEST_F(GossipScoreTest, MeshDeliveries) {
+  g::Score score{config};
+  score.connected(peer1, boost::none);
+  score.connected(peer2, boost::none);
+  score.graft(peer1, topic, now);
+  score.graft(peer2, topic, now);
+
+  // P2 for peer2, P3 for both
+  score.firstDelivery(peer2, topic, id(1), now);
+  score.duplicateDelivery(peer1, topic, id(1), now);
+  score.duplicateDelivery(peer1, topic, id(1), now);
+  ASSERT_EQ(score.score(peer1), 0);
+  ASSERT_EQ(score.score(peer2), 1);
+
+  // P1, P3 activated: 3 quanta in mesh, deficit of 2 deliveries
+  now += seconds(3);
+  score.onHeartbeat(now);
+  ASSERT_EQ(score.score(peer1), 3 - 4);
+  ASSERT_EQ(score.score(peer2), 3 + 1 - 4);
+
+  // duplicate out of window is not counted
+  score.duplicateDelivery(peer1, topic, id(2), now);
+  ASSERT_EQ(score.score(peer1), 3 - 4);
+
+  // P3b is kept after prune
+  score.prune(peer1, topic);
+  ASSERT_EQ(score.score(peer1), -4);
+}
+
+/**
+ * @given peers misbehaving
+ * @when they send invalid messages, graft in backoff, share ip
+ * @then P4, P6, P7 are negative, thresholds apply, decay recovers score
+ */
+TEST_F(GossipScoreTest, Penalties) {
+  config.graylist_threshold = -5;
+  config.decay_interval = seconds(1);
+  config.decay_to_zero = 0.1;
+  config.behaviour_penalty_decay = 0.5;
+  config.default_topic.invalid_message_deliveries_decay = 0.5;
+  g::Score score{config};
+
+  score.invalidMessage(peer1, topic);
+  score.invalidMessage(peer1, topic);
+  ASSERT_EQ(score.score(peer1), -4);
+  score.addPenalty(peer1, 2);
+  ASSERT_EQ(score.score(peer1), -8);
+  ASSERT_TRUE(score.graylisted(peer1));
+
+  score.connected(peer1, std::string{"1.2.3.4"});
+  score.connected(peer2, std::string{"1.2.3.4"});
+  ASSERT_EQ(score.score(peer2), -1);
+  ASSERT_EQ(score.score(peer1), -9);
+
+  score.setAppScore(peer2, 3);
+  ASSERT_EQ(score.score(peer2), 2);
+
+  score.onHeartbeat(now);
+  now += seconds(1);
+  score.onHeartbeat(now);
+  // counters halved
+  ASSERT_EQ(score.score(peer1), -1 - 1 - 1);
+  ASSERT_FALSE(score.graylisted(peer1));
+
+  // disconnected peer leaves ip, score retained for a while
+  score.disconnected(peer1, now);
+  now += config.retain_score + seconds(1);
+  score.onHeartbeat(now);
+  ASSERT_EQ(score.score(peer1), 0);
+  ASSERT_EQ(score.score(peer2), 3);
+}
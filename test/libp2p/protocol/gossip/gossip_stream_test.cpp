@@ -0,0 +1,170 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/protocol/gossip/impl/stream.hpp"
+#include "src/protocol/gossip/impl/message_receiver.hpp"
+#include "src/protocol/gossip/impl/peer_context.hpp"
+
+#include <gtest/gtest.h>
+
+#include <libp2p/basic/scheduler/manual_scheduler_backend.hpp>
+#include <libp2p/basic/scheduler/scheduler_impl.hpp>
+
+#include "mock/libp2p/connection/stream_mock.hpp"
+#include "testutil/libp2p/peer.hpp"
+
+namespace g = libp2p::protocol::gossip;
+
+using libp2p::Bytes;
+using libp2p::BytesIn;
+using libp2p::connection::StreamMock;
+using testing::_;
+using testing::Invoke;
+using testing::Return;
+
+namespace {
+  /// Stream is only written to in these tests
+  struct NoReceiver : g::MessageReceiver {
+    void onSubscription(const g::PeerContextPtr &,
+                        bool,
+                        const g::TopicId &) override {}
+    void onIHave(const g::PeerContextPtr &,
+                 const g::TopicId &,
+                 const g::MessageId &) override {}
+    void onIWant(const g::PeerContextPtr &, const g::MessageId &) override {}
+    void onIDontWant(const g::PeerContextPtr &,
+                     const g::MessageId &) override {}
+    void onGraft(const g::PeerContextPtr &, const g::TopicId &) override {}
+    void onPrune(const g::PeerContextPtr &,
+                 const g::TopicId &,
+                 uint64_t,
+                 std::span<const g::PxPeer>) override {}
+    void onTopicMessage(const g::PeerContextPtr &,
+                        g::TopicMessage::Ptr) override {}
+    void onMessageEnd(const g::PeerContextPtr &) override {}
+  };
+}  // namespace
+
+struct GossipStreamTest : public ::testing::Test {
+  void SetUp() override {
+    EXPECT_CALL(*mock, isClosedForWrite()).WillRepeatedly(Return(false));
+    EXPECT_CALL(*mock, writeSome(_, _, _))
+        .WillRepeatedly(Invoke([this](BytesIn in, size_t, auto cb) {
+          written.push_back(in[0]);
+          write_cb = std::move(cb);
+          write_size = in.size();
+        }));
+    config.max_pending_bytes = 250;
+    makeStream();
+  }
+
+  void makeStream() {
+    stream = std::make_shared<g::Stream>(
+        0, config, *scheduler, feedback, receiver, mock, peer);
+  }
+
+  /// Writes RPC of 100 bytes tagged by its first byte
+  void write(uint8_t tag, g::Lane lane) {
+    auto bytes = std::make_shared<Bytes>(100, tag);
+    stream->write(g::SharedBuffers{bytes}, lane);
+  }
+
+  /// Completes writes until none is pending
+  void completeAll() {
+    while (write_cb) {
+      auto cb = std::move(write_cb);
+      write_cb = nullptr;
+      cb(write_size);
+    }
+  }
+
+  g::Config config;
+  std::shared_ptr<libp2p::basic::SchedulerImpl> scheduler =
+      std::make_shared<libp2p::basic::SchedulerImpl>(
+          std::make_shared<libp2p::basic::ManualSchedulerBackend>(),
+          libp2p::basic::Scheduler::Config{});
+  g::Stream::Feedback feedback = [](g::PeerContextPtr,
+                                    outcome::result<g::Success>) {};
+  NoReceiver receiver;
+  std::shared_ptr<StreamMock> mock = std::make_shared<StreamMock>();
+  g::PeerContextPtr peer =
+      std::make_shared<g::PeerContext>(testutil::randomPeerId());
+  std::shared_ptr<g::Stream> stream;
+
+  /// Tags of written RPCs, in order
+  std::vector<uint8_t> written;
+  libp2p::basic::Writer::WriteCallbackFunc write_cb;
+  size_t write_size = 0;
+};
+
+/**
+ * @given stream with write in progress
+ * @when RPCs of all lanes are queued, least important first
+ * @then they are written by lane: control, publish, forward, gossip
+ */
+TEST_F(GossipStreamTest, LaneOrder) {
+  config.max_pending_bytes = 0;
+  makeStream();
+  write(0, g::Lane::CONTROL);
+  write(1, g::Lane::GOSSIP);
+  write(2, g::Lane::FORWARD);
+  write(3, g::Lane::PUBLISH);
+  write(4, g::Lane::CONTROL);
+
+  completeAll();
+  EXPECT_EQ(written, (std::vector<uint8_t>{0, 4, 3, 2, 1}));
+}
+
+/**
+ * @given stream with write in progress, and gossip and forward queued up to
+ * pending bytes limit
+ * @when control RPCs are queued beyond the limit
+ * @then gossip is shed first, forward next, and control is written
+ */
+TEST_F(GossipStreamTest, ControlShedsGossipThenForward) {
+  write(0, g::Lane::CONTROL);
+  write(1, g::Lane::GOSSIP);
+  write(2, g::Lane::FORWARD);
+  write(3, g::Lane::CONTROL);
+  write(4, g::Lane::CONTROL);
+
+  completeAll();
+  EXPECT_EQ(written, (std::vector<uint8_t>{0, 3, 4}));
+}
+
+/**
+ * @given stream with write in progress, and publish and gossip queued up to
+ * pending bytes limit
+ * @when forwards are queued beyond the limit
+ * @then gossip is shed for the first forward, the second forward is dropped
+ * since publish is never shed
+ */
+TEST_F(GossipStreamTest, ForwardShedsOnlyGossip) {
+  write(0, g::Lane::CONTROL);
+  write(1, g::Lane::PUBLISH);
+  write(2, g::Lane::GOSSIP);
+  write(3, g::Lane::FORWARD);
+  write(4, g::Lane::FORWARD);
+
+  completeAll();
+  EXPECT_EQ(written, (std::vector<uint8_t>{0, 1, 3}));
+}
+
+/**
+ * @given stream with write in progress, and forwards queued up to pending
+ * bytes limit
+ * @when gossip is queued beyond the limit
+ * @then gossip is dropped, forwards are kept
+ */
+TEST_F(GossipStreamTest, GossipDropped) {
+  write(0, g::Lane::CONTROL);
+  write(1, g::Lane::FORWARD);
+  write(2, g::Lane::FORWARD);
+  write(3, g::Lane::GOSSIP);
+
+  completeAll();
+  EXPECT_EQ(written, (std::vector<uint8_t>{0, 1, 2}));
+}
@@ -4,16 +4,38 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+#include "src/protocol/gossip/impl/message_builder.hpp"
 #include "src/protocol/gossip/impl/message_cache.hpp"
+#include "src/protocol/gossip/impl/message_parser.hpp"
+#include "src/protocol/gossip/impl/message_receiver.hpp"
+#include "src/protocol/gossip/impl/peer_context.hpp"
+#include "src/protocol/gossip/impl/peer_record.hpp"
 #include "src/protocol/gossip/impl/peer_set.hpp"
+#include "src/protocol/gossip/impl/seen_filter.hpp"
+#include "src/protocol/gossip/impl/topic_metrics.hpp"
+
+#include <algorithm>
+#include <set>
 
 #include <gtest/gtest.h>
 
+#include <libp2p/crypto/crypto_provider/crypto_provider_impl.hpp>
+#include <libp2p/crypto/ecdsa_provider/ecdsa_provider_impl.hpp>
+#include <libp2p/crypto/ed25519_provider/ed25519_provider_impl.hpp>
+#include <libp2p/crypto/hmac_provider/hmac_provider_impl.hpp>
+#include <libp2p/crypto/key_marshaller/key_marshaller_impl.hpp>
+#include <libp2p/crypto/key_validator/key_validator_impl.hpp>
+#include <libp2p/crypto/random_generator/boost_generator.hpp>
+#include <libp2p/crypto/rsa_provider/rsa_provider_impl.hpp>
+#include <libp2p/crypto/secp256k1_provider/secp256k1_provider_impl.hpp>
+#include <libp2p/multi/uvarint.hpp>
+
 #include "testutil/libp2p/peer.hpp"
 
 namespace g = libp2p::protocol::gossip;
 
 using libp2p::Bytes;
+using libp2p::BytesIn;
 
 /**
  * @given An arbitrary TopicMessage
@@ -42,6 +64,30 @@ TEST(Gossip, TopicMessageHasValidFields) {
   ASSERT_EQ(id.size(), 42);
 }
 
+/**
+ * @given message ids shorter and longer than inline storage
+ * @when ids are built in parts, copied and extended
+ * @then contents equal concatenation, copies are not affected by extension
+ */
+TEST(Gossip, MessageIdStorage) {
+  Bytes part(30, 1);
+  g::MessageId id{part};
+  ASSERT_EQ(id, g::MessageId{part});
+  id.append(part);
+  Bytes whole(part);
+  whole.insert(whole.end(), part.begin(), part.end());
+  ASSERT_EQ(id, g::MessageId{whole});
+  ASSERT_EQ(id.size(), whole.size());
+
+  auto copy = id;
+  id.append(part);
+  ASSERT_EQ(copy, g::MessageId{whole});
+  ASSERT_EQ(id.size(), whole.size() + part.size());
+  ASSERT_FALSE(id == copy);
+  ASSERT_EQ(std::hash<g::MessageId>{}(copy),
+            std::hash<g::MessageId>{}(g::MessageId{whole}));
+}
+
 /**
  * @given NP peers subscribed to NT topics in arbitrary manner
  * @when We insert them into PeerSet
@@ -150,27 +196,24 @@ TEST(Gossip, PeerSet) {
 }
 
 /**
- * @given Empty MessageCache
- * @when We insert messages into it on different timestamp
- * @then We see that all messages are both inserted and expired properly
+ * @given Empty MessageCache of 3 windows
+ * @when We insert messages into it between shifts
+ * @then We see that all messages are both inserted and expired properly,
+ * only messages of the recent windows are gossiped
  */
 TEST(Gossip, MessageCache) {
-  constexpr g::Time msg_lifetime{20};
-  constexpr g::Time timer_interval{msg_lifetime / 2};
-
-  g::Time current_time{1234567890000ll};  // typically timestamp
-  g::Time stop_time = current_time + g::Time{400};
-  auto clock = [&current_time]() -> g::Time { return current_time; };
+  constexpr size_t history_length = 3;
+  constexpr size_t history_gossip = 2;
 
   // 1. Create the cache
 
-  g::MessageCache cache(msg_lifetime, clock);
+  g::MessageCache cache(history_length, history_gossip);
 
-  // 2. Keep track of inserted messages
+  // 2. Keep track of inserted messages, window by window
 
   uint64_t seq = 0;
   const auto fake_body = g::fromString("schnapps");
-  std::vector<std::pair<g::Time, g::MessageId>> inserted_messages;
+  std::vector<std::vector<g::MessageId>> windows;
 
   // insert helper function
   auto insertMessage = [&](const g::TopicId &topic) {
@@ -178,33 +221,475 @@ TEST(Gossip, MessageCache) {
         testutil::randomPeerId(), seq++, fake_body, topic);
     auto msg_id = g::createMessageId(msg->from, msg->seq_no, msg->data);
     ASSERT_TRUE(cache.insert(msg, msg_id));
-    inserted_messages.emplace_back(current_time, std::move(msg_id));
+    ASSERT_FALSE(cache.insert(msg, msg_id));
+    windows.back().push_back(std::move(msg_id));
   };
 
   const g::TopicId topic_1("t1");
   const g::TopicId topic_2("t2");
 
-  // 3. While increasing timestamp, insert messages into cache and
+  // 3. While shifting, insert messages into cache and
   // check their presence and expiration
 
-  for (; current_time <= stop_time; ++current_time) {
-    insertMessage(topic_1);
-    if (current_time.count() % 2 == 1) {
-      insertMessage(topic_2);
-    }
-    if (current_time.count() % timer_interval.count() == 0) {
-      cache.shift();
+  for (size_t shift = 0; shift < 10; ++shift) {
+    windows.emplace_back();
+    for (size_t i = 0; i <= shift; ++i) {
+      insertMessage(i % 2 == 0 ? topic_1 : topic_2);
     }
-    if (current_time.count() % (timer_interval.count() * 10) == 0) {
-      for (auto it = inserted_messages.rbegin(); it != inserted_messages.rend();
-           ++it) {
-        auto msg = cache.getMessage(it->second);
-        if (it->first < current_time - msg_lifetime) {
-          ASSERT_FALSE(msg);
-          break;
+
+    auto gossip = cache.gossipIds(topic_2);
+    std::vector<g::MessageId> expected_gossip;
+    for (size_t age = 0; age < windows.size(); ++age) {
+      auto &window = windows[windows.size() - 1 - age];
+      for (size_t i = 0; i < window.size(); ++i) {
+        ASSERT_EQ(cache.contains(window[i]), age < history_length);
+        if (age < history_gossip and i % 2 == 1) {
+          expected_gossip.push_back(window[i]);
         }
-        ASSERT_TRUE(msg);
       }
     }
+    ASSERT_EQ(gossip, expected_gossip);
+
+    cache.shift();
+  }
+  ASSERT_EQ(cache.size(), windows[8].size() + windows[9].size());
+}
+
+/**
+ * @given SeenFilter remembering ids for 6 shifts
+ * @when ids are inserted within capacity and filter is shifted
+ * @then inserted ids are found for at least 6 shifts and forgotten
+ * afterwards, unknown ids are rarely found
+ */
+TEST(Gossip, SeenFilter) {
+  constexpr size_t history_length = 6;
+  constexpr size_t capacity = 6000;
+  g::SeenFilter filter(history_length, capacity, 0.01);
+
+  auto id = [](size_t i) {
+    return g::fromString("message " + std::to_string(i));
+  };
+  for (size_t i = 0; i < capacity / history_length; ++i) {
+    filter.insert(id(i));
+  }
+
+  for (size_t shift = 0; shift < history_length; ++shift) {
+    for (size_t i = 0; i < capacity / history_length; ++i) {
+      ASSERT_TRUE(filter.contains(id(i)));
+    }
+    filter.shift();
+  }
+
+  // fill the filter with other ids
+  size_t next = capacity;
+  for (size_t shift = 0; shift < history_length; ++shift) {
+    for (size_t i = 0; i < capacity / history_length; ++i) {
+      filter.insert(id(next++));
+    }
+    filter.shift();
+  }
+
+  size_t false_positives = 0;
+  for (size_t i = 0; i < capacity; ++i) {
+    if (filter.contains(id(i))) {
+      ++false_positives;
+    }
+  }
+  ASSERT_LT(false_positives, capacity / 50);
+}
+
+/**
+ * @given topic metrics
+ * @when message counters are incremented and latencies are observed
+ * @then stats report counters, mesh size, and cumulative latency buckets
+ */
+TEST(Gossip, TopicMetrics) {
+  using std::chrono::milliseconds;
+  g::TopicMetrics metrics;
+  ++metrics.received;
+  ++metrics.delivered;
+  metrics.bytes_in += 100;
+  metrics.bytes_out += 300;
+  metrics.validation_latency.observe(milliseconds{1});
+  metrics.first_delivery_latency.observe(milliseconds{2});
+  metrics.first_delivery_latency.observe(milliseconds{2000});
+
+  auto stats = metrics.stats(6);
+  EXPECT_EQ(stats.received, 1);
+  EXPECT_EQ(stats.delivered, 1);
+  EXPECT_EQ(stats.duplicates, 0);
+  EXPECT_EQ(stats.bytes_in, 100);
+  EXPECT_EQ(stats.bytes_out, 300);
+  EXPECT_EQ(stats.mesh_size, 6);
+
+  auto &validation = stats.validation_latency;
+  ASSERT_EQ(validation.counts.size(), validation.bounds.size() + 1);
+  EXPECT_EQ(validation.counts.back(), 1);
+  EXPECT_DOUBLE_EQ(validation.sum, 0.001);
+  for (size_t i = 0; i < validation.bounds.size(); ++i) {
+    // 1ms is on bound, as bounds are inclusive
+    EXPECT_EQ(validation.counts[i], validation.bounds[i] >= 0.001 ? 1 : 0);
+  }
+
+  auto &delivery = stats.first_delivery_latency;
+  EXPECT_EQ(delivery.counts.back(), 2);
+  auto at_1s =
+      std::ranges::find(delivery.bounds, 1.0) - delivery.bounds.begin();
+  EXPECT_EQ(delivery.counts[at_1s], 1);
+  EXPECT_DOUBLE_EQ(delivery.sum, 2.002);
+}
+
+namespace {
+  /// Records dispatched parts of RPC
+  struct ReceiverStub : g::MessageReceiver {
+    void onSubscription(const g::PeerContextPtr &,
+                        bool subscribe,
+                        const g::TopicId &topic) override {
+      subscriptions.emplace_back(subscribe, topic);
+    }
+    void onIHave(const g::PeerContextPtr &,
+                 const g::TopicId &,
+                 const g::MessageId &msg_id) override {
+      ihaves.push_back(msg_id);
+    }
+    void onIWant(const g::PeerContextPtr &, const g::MessageId &) override {}
+    void onIDontWant(const g::PeerContextPtr &,
+                     const g::MessageId &msg_id) override {
+      dont_wants.push_back(msg_id);
+    }
+    void onGraft(const g::PeerContextPtr &, const g::TopicId &) override {}
+    void onPrune(const g::PeerContextPtr &,
+                 const g::TopicId &,
+                 uint64_t,
+                 std::span<const g::PxPeer> px) override {
+      for (const auto &peer : px) {
+        prune_peers.emplace_back(peer.peer_id,
+                                 Bytes{peer.signed_record.begin(),
+                                          peer.signed_record.end()});
+      }
+    }
+    bool needTopicMessage(const g::PeerContextPtr &,
+                          const g::TopicMessageView &msg) override {
+      return !unwanted.contains(g::TopicId{msg.topic});
+    }
+    void onTopicMessage(const g::PeerContextPtr &,
+                        g::TopicMessage::Ptr msg) override {
+      messages.push_back(std::move(msg));
+    }
+    void onMessageEnd(const g::PeerContextPtr &) override {}
+
+    std::set<g::TopicId> unwanted;
+    std::vector<std::pair<bool, g::TopicId>> subscriptions;
+    std::vector<g::MessageId> ihaves;
+    std::vector<g::MessageId> dont_wants;
+    std::vector<g::TopicMessage::Ptr> messages;
+    std::vector<std::pair<libp2p::peer::PeerId, Bytes>> prune_peers;
+  };
+}  // namespace
+
+/**
+ * @given message forwarded to two peers with different control parts
+ * @when their RPCs are serialized
+ * @then message is serialized once and shared by both RPCs, which are
+ * parsed back with all their parts
+ */
+TEST(Gossip, MessageBuilderSharesMessages) {
+  auto msg = std::make_shared<g::TopicMessage>(
+      testutil::randomPeerId(), 1, g::fromString("data"), "topic");
+  auto msg_id = g::createMessageId(msg->from, msg->seq_no, msg->data);
+
+  g::MessageBuilder builder1;
+  builder1.addMessage(*msg, msg_id);
+  builder1.addMessage(*msg, msg_id);
+  builder1.addSubscription(true, "topic");
+  g::MessageBuilder builder2;
+  builder2.addIHave("topic", msg_id);
+  builder2.addMessage(*msg, msg_id);
+
+  auto messages_size = builder1.messagesSize();
+  ASSERT_GT(messages_size, msg->data.size());
+  ASSERT_EQ(builder2.messagesSize(), messages_size);
+
+  auto buffers1 = builder1.serialize().value();
+  auto buffers2 = builder2.serialize().value();
+  ASSERT_EQ(buffers1.size(), 2);
+  ASSERT_EQ(buffers2.size(), 2);
+  ASSERT_EQ(buffers1[1], buffers2[1]);
+  ASSERT_EQ(buffers1[1]->size(), messages_size);
+  ASSERT_EQ(builder1.messagesSize(), 0);
+
+  for (auto &[buffers, subscriptions] :
+       {std::pair{buffers1, 1}, std::pair{buffers2, 0}}) {
+    Bytes rpc;
+    for (auto &buffer : buffers) {
+      rpc.insert(rpc.end(), buffer->begin(), buffer->end());
+    }
+    auto length = libp2p::multi::UVarint::create(rpc).value();
+    ASSERT_EQ(length.size() + length.toUInt64(), rpc.size());
+
+    g::MessageParser parser;
+    ASSERT_TRUE(parser.parse(BytesIn{rpc}.subspan(length.size())));
+    ReceiverStub receiver;
+    parser.dispatch(nullptr, receiver);
+    ASSERT_EQ(receiver.messages.size(), 1);
+    ASSERT_EQ(receiver.messages[0]->data, msg->data);
+    ASSERT_EQ(receiver.messages[0]->topic, msg->topic);
+    ASSERT_EQ(receiver.subscriptions.size(), subscriptions);
+    ASSERT_EQ(receiver.ihaves.size(), 1 - subscriptions);
+  }
+}
+
+/**
+ * @given RPC with signed message and message of unwanted topic
+ * @when it is parsed twice by the same parser
+ * @then signed message is delivered with all its fields, the other one is
+ * dropped before copy, truncated RPC is rejected
+ */
+TEST(Gossip, MessageParserPublish) {
+  auto wanted = std::make_shared<g::TopicMessage>(
+      testutil::randomPeerId(), 1, g::fromString("wanted"), "topic1");
+  wanted->signature = g::fromString("signature");
+  wanted->key = g::fromString("key");
+  auto unwanted = std::make_shared<g::TopicMessage>(
+      testutil::randomPeerId(), 2, g::fromString("unwanted"), "topic2");
+
+  g::MessageBuilder builder;
+  builder.addSubscription(true, "topic1");
+  for (auto &msg : {wanted, unwanted}) {
+    builder.addMessage(*msg,
+                       g::createMessageId(msg->from, msg->seq_no, msg->data));
+  }
+  Bytes rpc;
+  for (auto &buffer : builder.serialize().value()) {
+    rpc.insert(rpc.end(), buffer->begin(), buffer->end());
+  }
+  auto length = libp2p::multi::UVarint::create(rpc).value();
+  BytesIn body = BytesIn{rpc}.subspan(length.size());
+
+  g::MessageParser parser;
+  for (auto i = 0; i < 2; ++i) {
+    ASSERT_TRUE(parser.parse(body));
+    ReceiverStub receiver;
+    receiver.unwanted.emplace("topic2");
+    parser.dispatch(nullptr, receiver);
+    ASSERT_EQ(receiver.subscriptions.size(), 1);
+    ASSERT_EQ(receiver.messages.size(), 1);
+    auto &msg = *receiver.messages[0];
+    ASSERT_EQ(msg.from, wanted->from);
+    ASSERT_EQ(msg.seq_no, wanted->seq_no);
+    ASSERT_EQ(msg.data, wanted->data);
+    ASSERT_EQ(msg.topic, wanted->topic);
+    ASSERT_TRUE(msg.signature == wanted->signature);
+    ASSERT_TRUE(msg.key == wanted->key);
+  }
+
+  ASSERT_FALSE(parser.parse(body.first(body.size() - 1)));
+}
+
+/**
+ * @given builder with graft, local message and forwarded message
+ * @when it is serialized by lanes
+ * @then forwarded message goes alone into forward lane, the rest goes into
+ * control lane, both RPCs are parsed back
+ */
+TEST(Gossip, MessageBuilderLanes) {
+  auto published = std::make_shared<g::TopicMessage>(
+      testutil::randomPeerId(), 1, g::fromString("own"), "topic");
+  auto forwarded = std::make_shared<g::TopicMessage>(
+      testutil::randomPeerId(), 2, g::fromString("forwarded"), "topic");
+
+  g::MessageBuilder builder;
+  builder.addIHave("topic", g::fromString("id"));
+  ASSERT_FALSE(builder.urgent());
+  builder.addGraft("topic");
+  ASSERT_TRUE(builder.urgent());
+  builder.addMessage(*published,
+                     g::createMessageId(
+                         published->from, published->seq_no, published->data),
+                     true);
+  builder.addMessage(*forwarded,
+                     g::createMessageId(
+                         forwarded->from, forwarded->seq_no, forwarded->data));
+
+  auto rpcs = builder.serializeLanes().value();
+  ASSERT_TRUE(builder.empty());
+  ASSERT_FALSE(builder.urgent());
+  ASSERT_EQ(rpcs.size(), 2);
+  ASSERT_EQ(rpcs[0].lane, g::Lane::CONTROL);
+  ASSERT_EQ(rpcs[1].lane, g::Lane::FORWARD);
+
+  for (auto &[rpc_buffers, data] :
+       {std::pair{rpcs[0].buffers, published->data},
+        std::pair{rpcs[1].buffers, forwarded->data}}) {
+    Bytes rpc;
+    for (auto &buffer : rpc_buffers) {
+      rpc.insert(rpc.end(), buffer->begin(), buffer->end());
+    }
+    auto length = libp2p::multi::UVarint::create(rpc).value();
+    ASSERT_EQ(length.size() + length.toUInt64(), rpc.size());
+
+    g::MessageParser parser;
+    ASSERT_TRUE(parser.parse(BytesIn{rpc}.subspan(length.size())));
+    ReceiverStub receiver;
+    parser.dispatch(nullptr, receiver);
+    ASSERT_EQ(receiver.messages.size(), 1);
+    ASSERT_EQ(receiver.messages[0]->data, data);
+  }
+}
+
+/**
+ * @given builder with many IHAVE, IDONTWANT and a graft
+ * @when datagrams are taken from it
+ * @then each datagram fits size and is parsed as RPC, all ids are taken,
+ * graft is left to stream
+ */
+TEST(Gossip, MessageBuilderDatagrams) {
+  constexpr size_t kMaxSize = 200;
+  g::MessageBuilder builder;
+  std::vector<g::MessageId> ihaves, dont_wants;
+  for (int i = 0; i < 20; ++i) {
+    ihaves.push_back(g::fromString("ihave" + std::to_string(i)));
+    builder.addIHave(i % 2 == 0 ? "topic1" : "topic2", ihaves.back());
+    dont_wants.push_back(g::fromString("idontwant" + std::to_string(i)));
+    builder.addIDontWant(dont_wants.back());
+  }
+  builder.addGraft("topic1");
+
+  auto datagrams = builder.takeDatagrams(kMaxSize);
+  ASSERT_GT(datagrams.size(), 1);
+  ASSERT_FALSE(builder.empty());
+  ASSERT_TRUE(builder.urgent());
+
+  ReceiverStub receiver;
+  for (auto &datagram : datagrams) {
+    ASSERT_LE(datagram.size(), kMaxSize);
+    g::MessageParser parser;
+    ASSERT_TRUE(parser.parse(datagram));
+    parser.dispatch(nullptr, receiver);
+  }
+  std::sort(ihaves.begin(), ihaves.end());
+  std::sort(receiver.ihaves.begin(), receiver.ihaves.end());
+  ASSERT_EQ(receiver.ihaves, ihaves);
+  ASSERT_EQ(receiver.dont_wants, dont_wants);
+
+  ASSERT_TRUE(builder.takeDatagrams(kMaxSize).empty());
+}
+
+/**
+ * @given IDONTWANT notifications built into RPC
+ * @when the RPC is parsed
+ * @then receiver gets them, and peer context keeps them until expiration
+ */
+TEST(Gossip, IDontWant) {
+  auto id1 = g::fromString("id1");
+  auto id2 = g::fromString("id2");
+  g::MessageBuilder builder;
+  builder.addIDontWant(id1);
+  builder.addIDontWant(id2);
+  auto buffers = builder.serialize().value();
+  ASSERT_EQ(buffers.size(), 1);
+  auto &rpc = *buffers[0];
+  auto length = libp2p::multi::UVarint::create(rpc).value();
+
+  g::MessageParser parser;
+  ASSERT_TRUE(parser.parse(BytesIn{rpc}.subspan(length.size())));
+  ReceiverStub receiver;
+  parser.dispatch(nullptr, receiver);
+  ASSERT_EQ(receiver.dont_wants, (std::vector<g::MessageId>{id1, id2}));
+
+  using std::chrono::seconds;
+  g::PeerContext ctx{testutil::randomPeerId()};
+  ctx.addDontWant(id1, g::Time{seconds(1)}, seconds(3), 2);
+  ctx.addDontWant(id2, g::Time{seconds(2)}, seconds(3), 2);
+  ctx.addDontWant(g::fromString("id3"), g::Time{seconds(2)}, seconds(3), 2);
+  ASSERT_TRUE(ctx.dontWant(id1, g::Time{seconds(3)}));
+  ASSERT_FALSE(ctx.dontWant(g::fromString("id3"), g::Time{seconds(3)}));
+  ASSERT_FALSE(ctx.dontWant(id1, g::Time{seconds(4)}));
+  ASSERT_TRUE(ctx.dontWant(id2, g::Time{seconds(4)}));
+}
+
+/**
+ * @given peer context with IWANT reply limit
+ * @when peer requests more messages than limit within window
+ * @then requests over limit are refused until the next window
+ */
+TEST(Gossip, IWantReplyLimit) {
+  using std::chrono::seconds;
+  g::PeerContext ctx{testutil::randomPeerId()};
+  ASSERT_TRUE(ctx.allowIWantReply(g::Time{seconds(1)}, seconds(1), 2));
+  ASSERT_TRUE(ctx.allowIWantReply(g::Time{seconds(1)}, seconds(1), 2));
+  ASSERT_FALSE(ctx.allowIWantReply(g::Time{seconds(1)}, seconds(1), 2));
+  ASSERT_TRUE(ctx.allowIWantReply(g::Time{seconds(2)}, seconds(1), 2));
+  ASSERT_TRUE(ctx.allowIWantReply(g::Time{seconds(2)}, seconds(1), 0));
+}
+
+/**
+ * @given peer record signed by its peer and topic peer without record
+ * @when they are suggested in PRUNE, which is parsed back
+ * @then both peers are dispatched, the record is verified with its addresses,
+ * tampered record or record of another peer is rejected
+ */
+TEST(Gossip, PruneSignedPeerRecords) {
+  namespace crypto = libp2p::crypto;
+  auto random = std::make_shared<crypto::random::BoostRandomGenerator>();
+  std::shared_ptr<crypto::CryptoProvider> crypto_provider =
+      std::make_shared<crypto::CryptoProviderImpl>(
+      random,
+      std::make_shared<crypto::ed25519::Ed25519ProviderImpl>(),
+      std::make_shared<crypto::rsa::RsaProviderImpl>(),
+      std::make_shared<crypto::ecdsa::EcdsaProviderImpl>(),
+      std::make_shared<crypto::secp256k1::Secp256k1ProviderImpl>(random),
+      std::make_shared<crypto::hmac::HmacProviderImpl>());
+  crypto::marshaller::KeyMarshallerImpl marshaller{
+      std::make_shared<crypto::validator::KeyValidatorImpl>(crypto_provider)};
+
+  auto keypair =
+      crypto_provider->generateKeys(crypto::Key::Type::Ed25519).value();
+  auto peer_id = libp2p::peer::PeerId::fromPublicKey(
+                     marshaller.marshal(keypair.publicKey).value())
+                     .value();
+  g::PeerRecord record{
+      .peer_id = peer_id,
+      .seq = 7,
+      .addresses = {libp2p::multi::Multiaddress::create("/ip4/127.0.0.1/tcp/1")
+                        .value()}};
+  auto envelope =
+      g::signPeerRecord(record, keypair, *crypto_provider, marshaller).value();
+
+  auto with_record = std::make_shared<g::PeerContext>(peer_id);
+  with_record->signed_record = std::make_shared<const Bytes>(envelope);
+  auto without_record =
+      std::make_shared<g::PeerContext>(testutil::randomPeerId());
+
+  g::MessageBuilder builder;
+  builder.addPrune("topic", {with_record, without_record});
+  Bytes rpc;
+  for (auto &buffer : builder.serialize().value()) {
+    rpc.insert(rpc.end(), buffer->begin(), buffer->end());
   }
+  auto length = libp2p::multi::UVarint::create(rpc).value();
+  g::MessageParser parser;
+  ASSERT_TRUE(parser.parse(BytesIn{rpc}.subspan(length.size())));
+  ReceiverStub receiver;
+  parser.dispatch(nullptr, receiver);
+
+  ASSERT_EQ(receiver.prune_peers.size(), 2);
+  ASSERT_EQ(receiver.prune_peers[0].first, peer_id);
+  ASSERT_EQ(receiver.prune_peers[1].first, without_record->peer_id);
+  ASSERT_TRUE(receiver.prune_peers[1].second.empty());
+  auto opened = g::openPeerRecord(
+      receiver.prune_peers[0].second, *crypto_provider, marshaller);
+  ASSERT_TRUE(opened);
+  ASSERT_EQ(opened.value().peer_id, peer_id);
+  ASSERT_EQ(opened.value().seq, record.seq);
+  ASSERT_EQ(opened.value().addresses, record.addresses);
+
+  auto tampered = envelope;
+  tampered.back() ^= 1;
+  ASSERT_FALSE(g::openPeerRecord(tampered, *crypto_provider, marshaller));
+
+  record.peer_id = without_record->peer_id;
+  auto foreign =
+      g::signPeerRecord(record, keypair, *crypto_provider, marshaller).value();
+  ASSERT_FALSE(g::openPeerRecord(foreign, *crypto_provider, marshaller));
 }
@@ -0,0 +1,243 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/protocol/gossip/gossip.hpp>
+
+#include "src/protocol/gossip/impl/message_builder.hpp"
+
+#include <gtest/gtest.h>
+
+#include <libp2p/basic/scheduler/manual_scheduler_backend.hpp>
+#include <libp2p/basic/scheduler/scheduler_impl.hpp>
+
+#include "mock/libp2p/connection/stream_mock.hpp"
+#include "mock/libp2p/host/host_mock.hpp"
+#include "testutil/libp2p/peer.hpp"
+
+namespace g = libp2p::protocol::gossip;
+
+using libp2p::Bytes;
+using libp2p::BytesOut;
+using libp2p::StreamAndProtocol;
+using libp2p::StreamAndProtocolCb;
+using libp2p::connection::StreamMock;
+using libp2p::multi::Multiaddress;
+using libp2p::peer::PeerInfo;
+using testing::_;
+using testing::AnyNumber;
+using testing::Invoke;
+using testing::Return;
+using ValidationResult = g::Gossip::ValidationResult;
+
+/**
+ * Gossip with one inbound stream from remote peer, messages of topic are
+ * read from the stream and validated asynchronously
+ */
+struct GossipValidationTest : public ::testing::Test {
+  void SetUp() override {
+    EXPECT_CALL(*host, getId()).WillRepeatedly(Return(local_id));
+    EXPECT_CALL(*host, getPeerInfo())
+        .WillRepeatedly(Return(PeerInfo{local_id, {}}));
+    EXPECT_CALL(*host, setProtocolHandler(_, _, _))
+        .WillOnce(Invoke([this](auto, StreamAndProtocolCb cb, auto) {
+          handler = std::move(cb);
+        }));
+    // outbound stream is never opened
+    EXPECT_CALL(*host, newStream(_, _, _)).Times(AnyNumber());
+
+    EXPECT_CALL(*stream, isClosedForRead()).WillRepeatedly(Return(false));
+    EXPECT_CALL(*stream, isClosedForWrite()).WillRepeatedly(Return(false));
+    EXPECT_CALL(*stream, remotePeerId()).WillRepeatedly(Return(remote_id));
+    EXPECT_CALL(*stream, remoteMultiaddr())
+        .WillRepeatedly(
+            Return(Multiaddress::create("/ip4/10.0.0.1/tcp/4001").value()));
+    EXPECT_CALL(*stream, readSome(_, _, _))
+        .WillRepeatedly(Invoke([this](BytesOut out, size_t, auto cb) {
+          ++reads;
+          read_out = out;
+          read_cb = std::move(cb);
+        }));
+    EXPECT_CALL(*stream, close(_)).Times(AnyNumber());
+    EXPECT_CALL(*stream, reset()).Times(AnyNumber());
+  }
+
+  void TearDown() override {
+    gossip->stop();
+  }
+
+  /// Starts gossip subscribed to topic with async validator, and accepts
+  /// inbound stream
+  void start() {
+    config.datagram_control = false;
+    gossip = g::create(scheduler, host, nullptr, nullptr, nullptr, config);
+    gossip->setAsyncValidator(
+        topic, [this](const Bytes &, const Bytes &data, auto cb) {
+          validating.emplace_back(data, std::move(cb));
+        });
+    gossip->start();
+    subscription = gossip->subscribe({topic}, [this](auto msg) {
+      if (msg) {
+        delivered.push_back(msg->data);
+      }
+    });
+    ASSERT_TRUE(handler);
+    handler(StreamAndProtocol{stream, config.protocol_version});
+    ASSERT_EQ(reads, 1);
+  }
+
+  /// Completes pending stream read with RPC of message published by remote
+  /// peer
+  void receive(uint8_t seq, Bytes data) {
+    g::TopicMessage msg{remote_id.toVector(), Bytes{0, seq}, std::move(data)};
+    msg.topic = topic;
+    g::MessageId msg_id{msg.from};
+    msg_id.append(msg.seq_no);
+    g::MessageBuilder builder;
+    builder.addMessage(msg, msg_id);
+    auto buffers = builder.serialize().value();
+    Bytes rpc;
+    for (auto &buffer : buffers) {
+      rpc.insert(rpc.end(), buffer->begin(), buffer->end());
+    }
+    ASSERT_TRUE(read_cb);
+    ASSERT_LE(rpc.size(), read_out.size());
+    std::copy(rpc.begin(), rpc.end(), read_out.begin());
+    auto cb = std::move(read_cb);
+    read_cb = nullptr;
+    cb(rpc.size());
+  }
+
+  /// Completes the oldest pending validation
+  void complete(ValidationResult result) {
+    ASSERT_FALSE(validating.empty());
+    auto cb = std::move(validating.front().second);
+    validating.erase(validating.begin());
+    cb(result);
+  }
+
+  g::Gossip::TopicStats stats() {
+    return gossip->topicStats().at(topic);
+  }
+
+  g::Config config;
+  std::shared_ptr<libp2p::basic::SchedulerImpl> scheduler =
+      std::make_shared<libp2p::basic::SchedulerImpl>(
+          std::make_shared<libp2p::basic::ManualSchedulerBackend>(),
+          libp2p::basic::Scheduler::Config{});
+  libp2p::peer::PeerId local_id = testutil::randomPeerId();
+  libp2p::peer::PeerId remote_id = testutil::randomPeerId();
+  std::shared_ptr<libp2p::HostMock> host =
+      std::make_shared<libp2p::HostMock>();
+  std::shared_ptr<StreamMock> stream = std::make_shared<StreamMock>();
+  StreamAndProtocolCb handler;
+  std::shared_ptr<g::Gossip> gossip;
+  g::TopicId topic = "topic";
+  libp2p::protocol::Subscription subscription;
+
+  /// Stream reads requested, the last one is pending
+  size_t reads = 0;
+  BytesOut read_out;
+  libp2p::basic::Reader::ReadCallbackFunc read_cb;
+
+  /// Data and callbacks of validations in progress
+  std::vector<std::pair<Bytes, g::Gossip::ValidationCallback>> validating;
+  std::vector<Bytes> delivered;
+};
+
+/**
+ * @given gossip with async validator of topic
+ * @when message is received and validator accepts it later
+ * @then message is delivered to subscriber only after validation
+ */
+TEST_F(GossipValidationTest, AcceptDelivers) {
+  start();
+  receive(1, {1, 2, 3});
+  ASSERT_EQ(validating.size(), 1);
+  EXPECT_EQ(validating[0].first, (Bytes{1, 2, 3}));
+  EXPECT_TRUE(delivered.empty());
+
+  complete(ValidationResult::ACCEPT);
+  EXPECT_EQ(delivered, (std::vector<Bytes>{{1, 2, 3}}));
+  EXPECT_EQ(stats().delivered, 1);
+  EXPECT_EQ(stats().invalid, 0);
+}
+
+/**
+ * @given gossip with async validator of topic
+ * @when validator rejects received message
+ * @then message is not delivered and is counted as invalid
+ */
+TEST_F(GossipValidationTest, RejectDrops) {
+  start();
+  receive(1, {1});
+  complete(ValidationResult::REJECT);
+  EXPECT_TRUE(delivered.empty());
+  EXPECT_EQ(stats().delivered, 0);
+  EXPECT_EQ(stats().invalid, 1);
+}
+
+/**
+ * @given gossip with async validator of topic
+ * @when validator ignores received message, and it arrives again
+ * @then message is neither delivered nor counted as invalid, and is not
+ * remembered, so that it is validated again
+ */
+TEST_F(GossipValidationTest, IgnoreDrops) {
+  start();
+  receive(1, {1});
+  complete(ValidationResult::IGNORE);
+  EXPECT_TRUE(delivered.empty());
+  EXPECT_EQ(stats().invalid, 0);
+
+  receive(1, {1});
+  EXPECT_EQ(validating.size(), 1);
+}
+
+/**
+ * @given message of topic being validated
+ * @when the same message arrives again
+ * @then it is not validated again, and is delivered once when accepted
+ */
+TEST_F(GossipValidationTest, DuplicateWhileValidating) {
+  start();
+  receive(1, {1});
+  receive(1, {1});
+  EXPECT_EQ(validating.size(), 1);
+
+  complete(ValidationResult::ACCEPT);
+  EXPECT_EQ(delivered.size(), 1);
+
+  receive(1, {1});
+  EXPECT_TRUE(validating.empty());
+  EXPECT_EQ(delivered.size(), 1);
+  EXPECT_EQ(stats().duplicates, 1);
+}
+
+/**
+ * @given gossip with validation queue limit of two messages per topic
+ * @when the limit is reached
+ * @then stream is not read until a validation completes
+ */
+TEST_F(GossipValidationTest, FullQueuePausesReading) {
+  config.validation_queue_limit = 2;
+  start();
+  receive(1, {1});
+  EXPECT_EQ(reads, 2);
+  receive(2, {2});
+  EXPECT_EQ(validating.size(), 2);
+  EXPECT_EQ(reads, 2);
+  EXPECT_FALSE(read_cb);
+
+  complete(ValidationResult::ACCEPT);
+  EXPECT_EQ(reads, 3);
+  receive(3, {3});
+  EXPECT_EQ(reads, 3);
+
+  complete(ValidationResult::IGNORE);
+  complete(ValidationResult::ACCEPT);
+  EXPECT_EQ(reads, 4);
+  EXPECT_EQ(delivered, (std::vector<Bytes>{{1}, {3}}));
+}
@@ -10,6 +10,8 @@
 
 #include <generated/protocol/identify/protobuf/identify.pb.h>
 
+#include <libp2p/basic/scheduler/manual_scheduler_backend.hpp>
+#include <libp2p/basic/scheduler/scheduler_impl.hpp>
 #include <libp2p/common/literals.hpp>
 #include <libp2p/multi/uvarint.hpp>
 
@@ -56,8 +58,8 @@ class IdentifyDeltaTest : public testing::Test {
 
     added_proto_len_ = UVarint{msg_added_protos_.ByteSizeLong()};
     msg_added_protos_bytes_.insert(msg_added_protos_bytes_.end(),
-                                   added_proto_len_.toVector().begin(),
-                                   added_proto_len_.toVector().end());
+                                   added_proto_len_.toBytes().begin(),
+                                   added_proto_len_.toBytes().end());
     msg_added_protos_bytes_.insert(
         msg_added_protos_bytes_.end(), msg_added_protos_.ByteSizeLong(), 0);
     msg_added_protos_.SerializeToArray(
@@ -66,8 +68,8 @@ class IdentifyDeltaTest : public testing::Test {
 
     added_rm_proto_len_ = UVarint{msg_added_rm_protos_.ByteSizeLong()};
     msg_added_rm_protos_bytes_.insert(msg_added_rm_protos_bytes_.end(),
-                                      added_rm_proto_len_.toVector().begin(),
-                                      added_rm_proto_len_.toVector().end());
+                                      added_rm_proto_len_.toBytes().begin(),
+                                      added_rm_proto_len_.toBytes().end());
     msg_added_rm_protos_bytes_.insert(msg_added_rm_protos_bytes_.end(),
                                       msg_added_rm_protos_.ByteSizeLong(),
                                       0);
@@ -135,13 +137,69 @@ TEST_F(IdentifyDeltaTest, Send) {
 
   EXPECT_CALL(*stream_,
               writeSome(Truly(if_added), msg_added_protos_bytes_.size(), _))
-      .WillOnce(InvokeArgument<2>(outcome::success()));
+      .WillOnce(InvokeArgument<2>(outcome::success(
+          msg_added_protos_bytes_.size())));
 
   id_delta_->start();
   bus_.getChannel<event::network::ProtocolsAddedChannel>().publish(
       added_protos_);
 }
 
+/**
+ * @given Identify-Delta with debounce window
+ * @when protocols are added and removed several times within the window
+ * @then one Identify-Delta message with all changes is sent after the window
+ */
+TEST_F(IdentifyDeltaTest, SendCoalesced) {
+  auto backend = std::make_shared<basic::ManualSchedulerBackend>();
+  auto scheduler = std::make_shared<basic::SchedulerImpl>(
+      backend, basic::Scheduler::Config{});
+  id_delta_ = std::make_shared<IdentifyDelta>(
+      host_,
+      conn_manager_,
+      bus_,
+      scheduler,
+      IdentifyBroadcastConfig{.debounce = std::chrono::milliseconds{100}});
+
+  EXPECT_CALL(conn_manager_, getConnections())
+      .WillOnce(Return(std::vector<std::shared_ptr<CapableConnection>>{conn_}));
+  EXPECT_CALL(*conn_, remotePeer()).WillOnce(Return(kRemotePeerId));
+  EXPECT_CALL(host_, getPeerRepository()).WillOnce(ReturnRef(peer_repo_));
+  EXPECT_CALL(peer_repo_, getPeerInfo(kRemotePeerId))
+      .WillOnce(Return(kPeerInfo));
+  EXPECT_CALL(host_,
+              newStream(kPeerInfo, StreamProtocols{kIdentifyDeltaProtocol}, _))
+      .WillOnce(InvokeArgument<2>(
+          StreamAndProtocol{stream_, kIdentifyDeltaProtocol}));
+
+  auto if_added_removed = [&](BytesIn actual) {
+    auto expected = BytesIn(msg_added_rm_protos_bytes_);
+    return std::equal(
+        actual.begin(), actual.end(), expected.begin(), expected.end());
+  };
+  bool written = false;
+  EXPECT_CALL(*stream_,
+              writeSome(Truly(if_added_removed),
+                        msg_added_rm_protos_bytes_.size(),
+                        _))
+      .WillOnce(testing::DoAll(testing::Assign(&written, true),
+                               InvokeArgument<2>(outcome::success(
+                                   msg_added_rm_protos_bytes_.size()))));
+
+  id_delta_->start();
+  auto &added = bus_.getChannel<event::network::ProtocolsAddedChannel>();
+  auto &removed = bus_.getChannel<event::network::ProtocolsRemovedChannel>();
+  added.publish({added_protos_[0]});
+  added.publish(removed_protos_);
+  removed.publish(removed_protos_);
+  added.publish({added_protos_[1]});
+
+  backend->shift(std::chrono::milliseconds{50});
+  ASSERT_FALSE(written);
+  backend->shift(std::chrono::milliseconds{50});
+  ASSERT_TRUE(written);
+}
+
 ACTION_P(ReadPut, buf) {
   std::copy(buf.begin(), buf.end(), arg0.begin());
   arg2(buf.size());
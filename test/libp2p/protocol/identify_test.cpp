@@ -70,14 +70,15 @@ class IdentifyTest : public testing::Test {
 
     identify_pb_msg_bytes_.insert(
         identify_pb_msg_bytes_.end(),
-        std::make_move_iterator(pb_msg_len_varint_->toVector().begin()),
-        std::make_move_iterator(pb_msg_len_varint_->toVector().end()));
+        std::make_move_iterator(pb_msg_len_varint_->toBytes().begin()),
+        std::make_move_iterator(pb_msg_len_varint_->toBytes().end()));
     identify_pb_msg_bytes_.insert(
         identify_pb_msg_bytes_.end(), identify_pb_msg_.ByteSizeLong(), 0);
     identify_pb_msg_.SerializeToArray(
         identify_pb_msg_bytes_.data() + pb_msg_len_varint_->size(),
         identify_pb_msg_.ByteSizeLong());
 
+    EXPECT_CALL(host_, getBus()).WillRepeatedly(ReturnRef(bus_));
     id_msg_processor_ = std::make_shared<IdentifyMessageProcessor>(
         host_, conn_manager_, id_manager_, key_marshaller_);
     IdentifyConfig config;
@@ -116,6 +117,7 @@ class IdentifyTest : public testing::Test {
   multi::Multiaddress observer_address_ = "/ip4/1.1.1.1/tcp/1234"_multiaddr;
 
   std::vector<uint8_t> marshalled_pubkey_{0x11, 0x22, 0x33, 0x44};
+  ProtobufKey marshalled_key_{marshalled_pubkey_};
   std::vector<uint8_t> pubkey_data_{0x55, 0x66, 0x77, 0x88};
   PublicKey pubkey_{{Key::Type::RSA, pubkey_data_}};
   KeyPair key_pair_{pubkey_, PrivateKey{}};
@@ -174,11 +176,8 @@ TEST_F(IdentifyTest, Send) {
 
   EXPECT_CALL(host_, getPeerInfo()).WillOnce(Return(kOwnPeerInfo));
 
-  EXPECT_CALL(id_manager_, getKeyPair()).WillOnce(ReturnRef(Const(key_pair_)));
-  EXPECT_CALL(
-      *std::static_pointer_cast<marshaller::KeyMarshallerMock>(key_marshaller_),
-      marshal(pubkey_))
-      .WillOnce(Return(ProtobufKey{marshalled_pubkey_}));
+  EXPECT_CALL(id_manager_, getMarshalledPublicKey())
+      .WillOnce(ReturnRef(Const(marshalled_key_)));
 
   EXPECT_CALL(host_, getLibp2pVersion()).WillOnce(Return(kLibp2pVersion));
   EXPECT_CALL(host_, getLibp2pClientVersion()).WillOnce(Return(kClientVersion));
@@ -192,6 +191,67 @@ TEST_F(IdentifyTest, Send) {
   identify_->handle(StreamAndProtocol{stream_, {}});
 }
 
+/**
+ * @given Identify object, which has sent its message
+ * @when the other peers open streams over Identify protocol
+ * @then cached message is sent with observed address of each stream @and it
+ * is built again only after our listen addresses change
+ */
+TEST_F(IdentifyTest, SendCached) {
+  EXPECT_CALL(host_, getRouter()).WillRepeatedly(ReturnRef(router_));
+  EXPECT_CALL(router_, getSupportedProtocols())
+      .Times(3)
+      .WillRepeatedly(Return(protocols_));
+  EXPECT_CALL(*stream_, remotePeerId()).WillRepeatedly(Return(kRemotePeerId));
+  EXPECT_CALL(*stream_, remoteMultiaddr())
+      .WillRepeatedly(Return(outcome::success(remote_multiaddr_)));
+
+  // message is built for the first stream and after address change
+  EXPECT_CALL(host_, getPeerInfo())
+      .Times(2)
+      .WillRepeatedly(Return(kOwnPeerInfo));
+  EXPECT_CALL(id_manager_, getMarshalledPublicKey())
+      .Times(2)
+      .WillRepeatedly(ReturnRef(Const(marshalled_key_)));
+  EXPECT_CALL(host_, getLibp2pVersion())
+      .Times(2)
+      .WillRepeatedly(Return(kLibp2pVersion));
+  EXPECT_CALL(host_, getLibp2pClientVersion())
+      .Times(2)
+      .WillRepeatedly(Return(kClientVersion));
+
+  EXPECT_CALL(*stream_, writeSome(_, _, _))
+      .Times(2)
+      .WillRepeatedly(Success(
+          BytesIn(identify_pb_msg_bytes_.data(), identify_pb_msg_bytes_.size()),
+          outcome::success(identify_pb_msg_bytes_.size())));
+  identify_->handle(StreamAndProtocol{stream_, {}});
+
+  // the other peer observes us at another address
+  auto other_stream = std::make_shared<NiceMock<StreamMock>>();
+  EXPECT_CALL(*other_stream, remotePeerId())
+      .WillRepeatedly(Return(kRemotePeerId));
+  EXPECT_CALL(*other_stream, remoteMultiaddr())
+      .WillRepeatedly(Return(outcome::success(observer_address_)));
+  auto other_msg = identify_pb_msg_;
+  other_msg.set_observedaddr(
+      std::string(observer_address_.getBytesAddress().begin(),
+                  observer_address_.getBytesAddress().end()));
+  UVarint other_length{other_msg.ByteSizeLong()};
+  Bytes other_bytes{other_length.toBytes().begin(),
+                    other_length.toBytes().end()};
+  auto other_pb = other_msg.SerializeAsString();
+  other_bytes.insert(other_bytes.end(), other_pb.begin(), other_pb.end());
+  EXPECT_CALL(*other_stream, writeSome(_, _, _))
+      .WillOnce(Success(BytesIn(other_bytes.data(), other_bytes.size()),
+                        outcome::success(other_bytes.size())));
+  identify_->handle(StreamAndProtocol{other_stream, {}});
+
+  bus_.getChannel<event::network::ListenAddressAddedChannel>().publish(
+      listen_addresses_.front());
+  identify_->handle(StreamAndProtocol{stream_, {}});
+}
+
 ACTION_P(ReadPut, buf) {
   std::copy(buf.begin(), buf.end(), arg0.begin());
   arg2(buf.size());
@@ -307,3 +367,77 @@ TEST_F(IdentifyTest, Receive) {
   bus_.getChannel<event::network::OnNewConnectionChannel>().publish(
       std::weak_ptr<CapableConnection>(connection_));
 }
+
+/**
+ * @given Identify object
+ * @when the same peer is identified twice
+ * @then its public key is unmarshalled only once @and stored both times
+ */
+TEST_F(IdentifyTest, ReceiveSameKeyTwice) {
+  EXPECT_CALL(host_, setProtocolHandler(StreamProtocols{kIdentifyProto}, _, _))
+      .WillOnce(Return());
+
+  EXPECT_CALL(*connection_, remotePeer())
+      .WillRepeatedly(Return(kRemotePeerId));
+  EXPECT_CALL(*connection_, remoteMultiaddr())
+      .WillRepeatedly(Return(remote_multiaddr_));
+  EXPECT_CALL(host_,
+              newStream(kRemotePeerInfo, StreamProtocols{kIdentifyProto}, _))
+      .WillRepeatedly(
+          InvokeArgument<2>(StreamAndProtocol{stream_, kIdentifyProto}));
+
+  EXPECT_CALL(*stream_, read(_, 1, _))
+      .WillRepeatedly(ReadPut(std::span(identify_pb_msg_bytes_.data(), 1)));
+  EXPECT_CALL(*stream_, read(_, pb_msg_len_varint_->toUInt64(), _))
+      .WillRepeatedly(ReadPut(std::span(
+          identify_pb_msg_bytes_.data() + pb_msg_len_varint_->size(),
+          identify_pb_msg_bytes_.size() - pb_msg_len_varint_->size())));
+  EXPECT_CALL(*stream_, remotePeerId()).WillRepeatedly(Return(kRemotePeerId));
+  EXPECT_CALL(*stream_, remoteMultiaddr())
+      .WillRepeatedly(Return(outcome::success(remote_multiaddr_)));
+  EXPECT_CALL(*stream_, close(_)).WillRepeatedly(Close(outcome::success()));
+  EXPECT_CALL(*stream_, localMultiaddr())
+      .WillRepeatedly(Return(listen_addresses_[0]));
+  EXPECT_CALL(*stream_, isInitiator()).WillRepeatedly(Return(true));
+
+  EXPECT_CALL(
+      *std::static_pointer_cast<marshaller::KeyMarshallerMock>(key_marshaller_),
+      unmarshalPublicKey(ProtobufKey{marshalled_pubkey_}))
+      .WillOnce(Return(pubkey_));
+
+  EXPECT_CALL(host_, getPeerRepository()).WillRepeatedly(ReturnRef(peer_repo_));
+  EXPECT_CALL(peer_repo_, getKeyRepository())
+      .WillRepeatedly(ReturnRef(key_repo_));
+  EXPECT_CALL(key_repo_, addPublicKey(kRemotePeerId, pubkey_))
+      .Times(2)
+      .WillRepeatedly(Return(outcome::success()));
+  EXPECT_CALL(peer_repo_, getProtocolRepository())
+      .WillRepeatedly(ReturnRef(proto_repo_));
+  EXPECT_CALL(proto_repo_, addProtocols(kRemotePeerId, _))
+      .WillRepeatedly(Return(outcome::success()));
+
+  EXPECT_CALL(host_, getNetwork()).WillRepeatedly(ReturnRef(network_));
+  EXPECT_CALL(network_, getListener()).WillRepeatedly(ReturnRef(listener_));
+  EXPECT_CALL(listener_, getListenAddressesInterfaces())
+      .WillRepeatedly(Return(std::vector<Multiaddress>{}));
+  EXPECT_CALL(listener_, getListenAddresses())
+      .WillRepeatedly(Return(listen_addresses_));
+  EXPECT_CALL(host_, getAddresses()).WillRepeatedly(Return(listen_addresses_));
+
+  EXPECT_CALL(peer_repo_, getAddressRepository())
+      .WillRepeatedly(ReturnRef(addr_repo_));
+  EXPECT_CALL(addr_repo_, updateAddresses(kRemotePeerId, _))
+      .WillRepeatedly(Return(outcome::success()));
+  EXPECT_CALL(addr_repo_, getAddresses(kRemotePeerId))
+      .WillRepeatedly(
+          Return(std::vector<multi::Multiaddress>{remote_multiaddr_}));
+  EXPECT_CALL(conn_manager_, getBestConnectionForPeer(kRemotePeerId))
+      .WillRepeatedly(Return(connection_));
+  EXPECT_CALL(addr_repo_, upsertAddresses(kRemotePeerId, _, _))
+      .WillRepeatedly(Return(outcome::success()));
+
+  identify_->start();
+  auto &channel = bus_.getChannel<event::network::OnNewConnectionChannel>();
+  channel.publish(std::weak_ptr<CapableConnection>(connection_));
+  channel.publish(std::weak_ptr<CapableConnection>(connection_));
+}
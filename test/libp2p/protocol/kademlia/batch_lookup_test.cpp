@@ -0,0 +1,70 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/protocol/kademlia/impl/batch_lookup.hpp>
+
+#include <gtest/gtest.h>
+
+#include <libp2p/protocol/kademlia/node_id.hpp>
+
+using namespace libp2p;
+using namespace protocol::kademlia;
+
+/**
+ * @given batch lookup with concurrency of 2
+ * @when 5 keys, one of them duplicated, are looked up
+ * @then at most 2 lookups run at once, each key is looked up once in order
+ * of hash
+ */
+TEST(BatchLookupTest, ConcurrencyAndOrder) {
+  std::vector<ContentId> started;
+  std::vector<BatchLookup::OnDone> pending;
+  auto batch = std::make_shared<BatchLookup>(
+      2, [&](const ContentId &key, BatchLookup::OnDone on_done) {
+        started.push_back(key);
+        pending.push_back(std::move(on_done));
+      });
+
+  std::vector<ContentId> keys{makeKeySha256("key1"),
+                              makeKeySha256("key2"),
+                              makeKeySha256("key3"),
+                              makeKeySha256("key4"),
+                              makeKeySha256("key2")};
+  batch->lookup(keys);
+  ASSERT_EQ(started.size(), 2);
+  ASSERT_EQ(batch->queued(), 2);
+
+  while (not pending.empty()) {
+    auto on_done = std::move(pending.front());
+    pending.erase(pending.begin());
+    on_done();
+    ASSERT_LE(batch->inProgress(), 2);
+  }
+  ASSERT_EQ(started.size(), 4);
+  ASSERT_EQ(batch->queued(), 0);
+  ASSERT_EQ(batch->inProgress(), 0);
+
+  ASSERT_TRUE(std::ranges::is_sorted(started, [](auto &a, auto &b) {
+    return NodeId::hash(a).getData() < NodeId::hash(b).getData();
+  }));
+}
+
+/**
+ * @given batch lookup, which lookups complete synchronously
+ * @when keys are looked up
+ * @then all of them are looked up without recursion
+ */
+TEST(BatchLookupTest, SynchronousCompletion) {
+  size_t started = 0;
+  auto batch = std::make_shared<BatchLookup>(
+      1, [&](const ContentId &, BatchLookup::OnDone on_done) {
+        ++started;
+        on_done();
+      });
+  batch->lookup({makeKeySha256("key1"), makeKeySha256("key2")});
+  ASSERT_EQ(started, 2);
+  ASSERT_EQ(batch->inProgress(), 0);
+}
@@ -29,7 +29,7 @@ struct ContentRoutingTableTest : public ::testing::Test {
     config_ = std::make_unique<Config>();
 
     scheduler_ = std::make_shared<basic::SchedulerMock>();
-    EXPECT_CALL(*scheduler_, scheduleImpl(_, _, _)).Times(AnyNumber());
+    EXPECT_CALL(*scheduler_, scheduleImpl(_, _, _, _, _)).Times(AnyNumber());
     EXPECT_CALL(*scheduler_, now()).Times(AnyNumber());
 
     bus_ = std::make_shared<Bus>();
@@ -93,3 +93,74 @@ TEST_F(ContentRoutingTableTest, Provide) {
     }
   }
 }
+
+/**
+ * @given providers of a key added at different times
+ * @when cleanup timer fires after TTL of the first one, then of the second
+ * @then expired providers are removed, the rest stay
+ */
+TEST_F(ContentRoutingTableTest, Expire) {
+  using namespace std::chrono_literals;
+  config_->providerRecordTTL = 10s;
+  config_->providerWipingInterval = 1s;
+
+  std::chrono::milliseconds now = 0s;
+  basic::Scheduler::Callback timer;
+  EXPECT_CALL(*scheduler_, now()).WillRepeatedly([&] { return now; });
+  EXPECT_CALL(*scheduler_, scheduleImpl(_, _, _, _, _))
+      .WillRepeatedly([&](auto &&cb, auto, auto, auto) {
+        timer = std::move(cb);
+        return basic::Scheduler::Handle{};
+      });
+  auto table =
+      std::make_shared<ContentRoutingTableImpl>(*config_, *scheduler_, bus_);
+  table->start();
+
+  auto early = testutil::randomPeerId();
+  table->addProvider(cid, early);
+  now = 5s;
+  auto late = testutil::randomPeerId();
+  table->addProvider(cid, late);
+
+  now = 12s;
+  std::exchange(timer, {})();
+  ASSERT_EQ(table->getProvidersFor(cid), std::vector<PeerId>{late});
+
+  now = 17s;
+  std::exchange(timer, {})();
+  ASSERT_TRUE(table->getProvidersFor(cid).empty());
+}
+
+/**
+ * @given peer providing two keys, added at different times
+ * @when provider record of the first key expires
+ * @then the peer is still provider of the second key
+ */
+TEST_F(ContentRoutingTableTest, ExpireSharedProvider) {
+  using namespace std::chrono_literals;
+  config_->providerRecordTTL = 10s;
+  config_->providerWipingInterval = 1s;
+
+  std::chrono::milliseconds now = 0s;
+  basic::Scheduler::Callback timer;
+  EXPECT_CALL(*scheduler_, now()).WillRepeatedly([&] { return now; });
+  EXPECT_CALL(*scheduler_, scheduleImpl(_, _, _, _, _))
+      .WillRepeatedly([&](auto &&cb, auto, auto, auto) {
+        timer = std::move(cb);
+        return basic::Scheduler::Handle{};
+      });
+  auto table =
+      std::make_shared<ContentRoutingTableImpl>(*config_, *scheduler_, bus_);
+  table->start();
+
+  auto peer = testutil::randomPeerId();
+  auto other_cid = makeKeySha256("other_key");
+  table->addProvider(cid, peer);
+  now = 5s;
+  table->addProvider(other_cid, peer);
+
+  now = 12s;
+  std::exchange(timer, {})();
+  ASSERT_TRUE(table->getProvidersFor(cid).empty());
+  ASSERT_EQ(table->getProvidersFor(other_cid), std::vector<PeerId>{peer});
+}
@@ -0,0 +1,413 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/protocol/kademlia/impl/find_providers_executor.hpp>
+#include <libp2p/protocol/kademlia/impl/get_value_executor.hpp>
+#include <libp2p/protocol/kademlia/impl/put_value_executor.hpp>
+
+#include <gtest/gtest.h>
+
+#include <libp2p/basic/scheduler/manual_scheduler_backend.hpp>
+#include <libp2p/basic/scheduler/scheduler_impl.hpp>
+#include <libp2p/protocol/kademlia/error.hpp>
+
+#include "mock/libp2p/connection/stream_mock.hpp"
+#include "mock/libp2p/host/host_mock.hpp"
+#include "mock/libp2p/peer/address_repository_mock.hpp"
+#include "mock/libp2p/peer/peer_repository_mock.hpp"
+#include "testutil/libp2p/peer.hpp"
+
+using namespace libp2p;
+using namespace protocol::kademlia;
+using connection::StreamMock;
+using testing::_;
+using testing::AnyNumber;
+using testing::Invoke;
+using testing::Return;
+
+namespace {
+  /// Accepts non-empty values, selects the largest one
+  struct TestValidator : Validator {
+    outcome::result<void> validate(const Key &, const Value &value) override {
+      if (value.empty()) {
+        return Error::CONTENT_VALIDATION_FAILED;
+      }
+      return outcome::success();
+    }
+
+    outcome::result<size_t> select(const Key &,
+                                   const std::vector<Value> &values) override {
+      return std::max_element(values.begin(), values.end()) - values.begin();
+    }
+  };
+
+  /// Returns initial peers of lookup
+  struct TestPeerRoutingTable : PeerRoutingTable {
+    outcome::result<bool> update(const PeerId &, bool, bool) override {
+      return true;
+    }
+    void remove(const PeerId &) override {}
+    std::vector<PeerId> getAllPeers() const override {
+      return peers;
+    }
+    std::vector<PeerId> getNearestPeers(const NodeId &, size_t) override {
+      return peers;
+    }
+    size_t size() const override {
+      return peers.size();
+    }
+
+    std::vector<PeerId> peers;
+  };
+
+  /// Remembers providers added
+  struct TestContentRoutingTable : ContentRoutingTable {
+    void start() override {}
+    void addProvider(const ContentId &, const PeerId &peer) override {
+      providers.push_back(peer);
+    }
+    std::vector<PeerId> getProvidersFor(const ContentId &,
+                                        size_t) const override {
+      return {};
+    }
+
+    std::vector<PeerId> providers;
+  };
+
+  /// Keeps session requests pending until test completes them
+  struct TestSessionHost : SessionHost {
+    void onMessage(const std::shared_ptr<Session> &, Message &&) override {}
+    std::shared_ptr<Session> openSession(
+        std::shared_ptr<connection::Stream>) override {
+      return nullptr;
+    }
+    void getSession(const PeerInfo &peer, OnSession on_session) override {
+      requested.emplace_back(peer.id, std::move(on_session));
+    }
+
+    std::vector<std::pair<PeerId, OnSession>> requested;
+  };
+
+  /// Creates put value executors for outdated peers, records addressees
+  struct TestExecutorsFactory : ExecutorsFactory {
+    TestExecutorsFactory(const Config &config,
+                         std::shared_ptr<Host> host,
+                         std::shared_ptr<basic::Scheduler> scheduler,
+                         std::shared_ptr<SessionHost> session_host)
+        : config{config},
+          host{std::move(host)},
+          scheduler{std::move(scheduler)},
+          session_host{std::move(session_host)} {}
+
+    std::shared_ptr<PutValueExecutor> createPutValueExecutor(
+        ContentId key,
+        ContentValue value,
+        std::vector<PeerId> addressees) override {
+      updated.insert(updated.end(), addressees.begin(), addressees.end());
+      return std::make_shared<PutValueExecutor>(config,
+                                                host,
+                                                scheduler,
+                                                session_host,
+                                                std::move(key),
+                                                std::move(value),
+                                                std::move(addressees));
+    }
+    std::shared_ptr<GetValueExecutor> createGetValueExecutor(
+        ContentId, FoundValueHandler, ValueStreamHandler) override {
+      return nullptr;
+    }
+    std::shared_ptr<AddProviderExecutor> createAddProviderExecutor(
+        ContentId) override {
+      return nullptr;
+    }
+    std::shared_ptr<FindProvidersExecutor> createGetProvidersExecutor(
+        ContentId,
+        size_t,
+        FoundProvidersHandler,
+        ProviderStreamHandler) override {
+      return nullptr;
+    }
+    std::shared_ptr<FindPeerExecutor> createFindPeerExecutor(
+        HashedKey, FoundPeerInfoHandler) override {
+      return nullptr;
+    }
+
+    const Config &config;
+    std::shared_ptr<Host> host;
+    std::shared_ptr<basic::Scheduler> scheduler;
+    std::shared_ptr<SessionHost> session_host;
+    std::vector<PeerId> updated;
+  };
+}  // namespace
+
+/**
+ * Lookup executors over peers, which are connected when session is requested
+ * and respond when test calls `respond`
+ */
+struct ExecutorsTest : public ::testing::Test {
+  void SetUp() override {
+    config.requestConcurency = 4;
+    config.valueLookupsQuorum = 2;
+    std::generate_n(std::back_inserter(peer_routing_table->peers),
+                    4,
+                    testutil::randomPeerId);
+
+    EXPECT_CALL(*host, getId()).WillRepeatedly(Return(local_id));
+    EXPECT_CALL(*host, getPeerInfo())
+        .WillRepeatedly(Return(PeerInfo{local_id, {address}}));
+    EXPECT_CALL(*host, getPeerRepository())
+        .WillRepeatedly(testing::ReturnRef(peer_repository));
+    EXPECT_CALL(*host, connectedness(_))
+        .WillRepeatedly(Return(Host::Connectedness::CAN_CONNECT));
+    EXPECT_CALL(peer_repository, getPeerInfo(_))
+        .WillRepeatedly(Invoke([this](const PeerId &peer) {
+          return PeerInfo{peer, {address}};
+        }));
+    EXPECT_CALL(peer_repository, getAddressRepository())
+        .WillRepeatedly(testing::ReturnRef(address_repository));
+    EXPECT_CALL(address_repository, upsertAddresses(_, _, _))
+        .WillRepeatedly(Return(outcome::success()));
+  }
+
+  void TearDown() override {
+    // pending connections hold executors by their timers
+    auto requested = std::move(session_host->requested);
+    for (auto &[peer, on_session] : requested) {
+      on_session(Error::TIMEOUT);
+    }
+  }
+
+  /// Delivers response of peer to executor
+  void respond(const std::shared_ptr<ResponseHandler> &executor,
+               const PeerId &peer,
+               Message msg) {
+    auto stream = std::make_shared<StreamMock>();
+    EXPECT_CALL(*stream, remotePeerId()).WillRepeatedly(Return(peer));
+    EXPECT_CALL(*stream, reset()).Times(AnyNumber());
+    auto session =
+        std::make_shared<Session>(scheduler, stream, config.responseTimeout);
+    responded.push_back(peer);
+    executor->onResult(session, std::move(msg));
+  }
+
+  /// Fails connections of peers, which did not respond
+  void failPending() {
+    auto requested = std::move(session_host->requested);
+    for (auto &[peer, on_session] : requested) {
+      if (std::find(responded.begin(), responded.end(), peer)
+          == responded.end()) {
+        on_session(Error::TIMEOUT);
+      }
+    }
+  }
+
+  Message valueResponse(Value value) {
+    Message msg;
+    msg.type = Message::Type::kGetValue;
+    msg.key = key;
+    msg.record = Message::Record{key, std::move(value), ""};
+    return msg;
+  }
+
+  Message providersResponse(const std::vector<PeerId> &providers) {
+    Message msg;
+    msg.type = Message::Type::kGetProviders;
+    msg.key = key;
+    msg.provider_peers.emplace();
+    for (auto &provider : providers) {
+      msg.provider_peers->push_back(
+          {{provider, {address}}, Message::Connectedness::CAN_CONNECT});
+    }
+    return msg;
+  }
+
+  std::shared_ptr<GetValueExecutor> getValue() {
+    return std::make_shared<GetValueExecutor>(
+        config,
+        host,
+        scheduler,
+        session_host,
+        content_routing_table,
+        peer_routing_table,
+        latencies,
+        executors_factory,
+        validation_pool,
+        key,
+        [this](outcome::result<Value> res) { found_value.push_back(res); },
+        [this](const Value &value) { streamed_values.push_back(value); });
+  }
+
+  std::shared_ptr<FindProvidersExecutor> findProviders(size_t limit) {
+    return std::make_shared<FindProvidersExecutor>(
+        config,
+        host,
+        scheduler,
+        session_host,
+        peer_routing_table,
+        latencies,
+        key,
+        limit,
+        [this](outcome::result<std::vector<PeerInfo>> res) {
+          found_providers.push_back(res);
+        },
+        [this](const PeerInfo &peer) { streamed_providers.push_back(peer.id); });
+  }
+
+  const std::vector<PeerId> &peers() const {
+    return peer_routing_table->peers;
+  }
+
+  Config config;
+  std::shared_ptr<basic::SchedulerImpl> scheduler =
+      std::make_shared<basic::SchedulerImpl>(
+          std::make_shared<basic::ManualSchedulerBackend>(),
+          basic::Scheduler::Config{});
+  PeerId local_id = testutil::randomPeerId();
+  multi::Multiaddress address =
+      multi::Multiaddress::create("/ip4/10.0.0.1/tcp/4001").value();
+  std::shared_ptr<HostMock> host = std::make_shared<HostMock>();
+  peer::PeerRepositoryMock peer_repository;
+  peer::AddressRepositoryMock address_repository;
+  std::shared_ptr<TestSessionHost> session_host =
+      std::make_shared<TestSessionHost>();
+  std::shared_ptr<TestPeerRoutingTable> peer_routing_table =
+      std::make_shared<TestPeerRoutingTable>();
+  std::shared_ptr<TestContentRoutingTable> content_routing_table =
+      std::make_shared<TestContentRoutingTable>();
+  std::shared_ptr<TestExecutorsFactory> executors_factory =
+      std::make_shared<TestExecutorsFactory>(
+          config, host, scheduler, session_host);
+  std::shared_ptr<ValidationPool> validation_pool =
+      std::make_shared<ValidationPool>(
+          std::make_shared<TestValidator>(), scheduler, 0);
+  std::shared_ptr<PeerLatencies> latencies =
+      std::make_shared<PeerLatencies>(100);
+  ContentId key = makeKeySha256("key");
+  std::vector<PeerId> responded;
+
+  std::vector<outcome::result<Value>> found_value;
+  std::vector<Value> streamed_values;
+  std::vector<outcome::result<std::vector<PeerInfo>>> found_providers;
+  std::vector<PeerId> streamed_providers;
+};
+
+/**
+ * @given value lookup with quorum of two peers
+ * @when two peers respond with the same value while others are connecting
+ * @then value is streamed once, lookup completes without waiting for the
+ * others, and their pending connections no longer hold the executor
+ */
+TEST_F(ExecutorsTest, GetValueCompletesOnQuorum) {
+  auto executor = getValue();
+  ASSERT_TRUE(executor->start());
+  ASSERT_EQ(session_host->requested.size(), 4);
+
+  respond(executor, peers()[0], valueResponse({1}));
+  EXPECT_EQ(streamed_values, (std::vector<Value>{{1}}));
+  EXPECT_TRUE(found_value.empty());
+
+  respond(executor, peers()[1], valueResponse({1}));
+  EXPECT_EQ(streamed_values, (std::vector<Value>{{1}}));
+  ASSERT_EQ(found_value.size(), 1);
+  EXPECT_EQ(found_value[0].value(), (Value{1}));
+  EXPECT_EQ(content_routing_table->providers,
+            (std::vector<PeerId>{peers()[0], peers()[1]}));
+  EXPECT_TRUE(executors_factory->updated.empty());
+
+  std::weak_ptr<GetValueExecutor> weak = executor;
+  executor.reset();
+  EXPECT_TRUE(weak.expired());
+  failPending();
+  EXPECT_EQ(found_value.size(), 1);
+}
+
+/**
+ * @given value lookup with quorum of two peers
+ * @when peers respond with distinct and invalid values, and the rest fail
+ * @then each valid value is streamed as it arrives, the best one is found
+ * when query is over, and peer with outdated value is updated
+ */
+TEST_F(ExecutorsTest, GetValueStreamsDistinctValues) {
+  auto executor = getValue();
+  ASSERT_TRUE(executor->start());
+
+  respond(executor, peers()[0], valueResponse({1}));
+  respond(executor, peers()[1], valueResponse({}));
+  respond(executor, peers()[2], valueResponse({2}));
+  EXPECT_EQ(streamed_values, (std::vector<Value>{{1}, {2}}));
+  EXPECT_TRUE(found_value.empty());
+
+  failPending();
+  ASSERT_EQ(found_value.size(), 1);
+  EXPECT_EQ(found_value[0].value(), (Value{2}));
+  EXPECT_EQ(content_routing_table->providers,
+            (std::vector<PeerId>{peers()[2]}));
+  EXPECT_EQ(executors_factory->updated, (std::vector<PeerId>{peers()[0]}));
+}
+
+/**
+ * @given value lookup
+ * @when all peers fail
+ * @then value is not found
+ */
+TEST_F(ExecutorsTest, GetValueNotFound) {
+  auto executor = getValue();
+  ASSERT_TRUE(executor->start());
+  failPending();
+  ASSERT_EQ(found_value.size(), 1);
+  EXPECT_EQ(found_value[0].error(), make_error_code(Error::VALUE_NOT_FOUND));
+  EXPECT_TRUE(streamed_values.empty());
+}
+
+/**
+ * @given providers lookup with limit of two
+ * @when peers respond with providers while others are connecting
+ * @then each provider is streamed once, lookup completes when the limit is
+ * reached, and pending connections no longer hold the executor
+ */
+TEST_F(ExecutorsTest, FindProvidersCompletesOnLimit) {
+  auto provider1 = testutil::randomPeerId();
+  auto provider2 = testutil::randomPeerId();
+  auto executor = findProviders(2);
+  ASSERT_TRUE(executor->start());
+  ASSERT_EQ(session_host->requested.size(), 4);
+
+  respond(executor, peers()[0], providersResponse({provider1}));
+  EXPECT_EQ(streamed_providers, (std::vector<PeerId>{provider1}));
+  EXPECT_TRUE(found_providers.empty());
+
+  respond(executor, peers()[1], providersResponse({provider1, provider2}));
+  EXPECT_EQ(streamed_providers, (std::vector<PeerId>{provider1, provider2}));
+  ASSERT_EQ(found_providers.size(), 1);
+  EXPECT_EQ(found_providers[0].value().size(), 2);
+
+  std::weak_ptr<FindProvidersExecutor> weak = executor;
+  executor.reset();
+  EXPECT_TRUE(weak.expired());
+  failPending();
+  EXPECT_EQ(found_providers.size(), 1);
+}
+
+/**
+ * @given providers lookup with limit larger than providers known
+ * @when peers respond and the rest fail
+ * @then providers found are returned when query is over
+ */
+TEST_F(ExecutorsTest, FindProvidersQueryOver) {
+  auto provider = testutil::randomPeerId();
+  auto executor = findProviders(3);
+  ASSERT_TRUE(executor->start());
+
+  respond(executor, peers()[0], providersResponse({provider}));
+  respond(executor, peers()[1], providersResponse({}));
+  EXPECT_TRUE(found_providers.empty());
+
+  failPending();
+  EXPECT_EQ(streamed_providers, (std::vector<PeerId>{provider}));
+  ASSERT_EQ(found_providers.size(), 1);
+  ASSERT_EQ(found_providers[0].value().size(), 1);
+  EXPECT_EQ(found_providers[0].value()[0].id, provider);
+}
@@ -0,0 +1,84 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/protocol/kademlia/impl/full_routing_table.hpp>
+
+#include <algorithm>
+
+#include <gtest/gtest.h>
+
+#include "testutil/libp2p/peer.hpp"
+
+using namespace libp2p;
+using namespace protocol::kademlia;
+
+/// Routing table used until crawl is done
+struct FallbackTable : PeerRoutingTable {
+  outcome::result<bool> update(const PeerId &, bool, bool) override {
+    return false;
+  }
+  void remove(const PeerId &) override {}
+  std::vector<PeerId> getAllPeers() const override {
+    return peers;
+  }
+  std::vector<PeerId> getNearestPeers(const NodeId &, size_t) override {
+    return peers;
+  }
+  size_t size() const override {
+    return peers.size();
+  }
+  std::vector<PeerId> peers{testutil::randomPeerId()};
+};
+
+/**
+ * @given full routing table
+ * @when crawl is not done yet
+ * @then nearest peers are taken from fallback table
+ */
+TEST(FullRoutingTableTest, Fallback) {
+  auto fallback = std::make_shared<FallbackTable>();
+  FullRoutingTable table{fallback};
+  auto target = NodeId::hash(std::vector<uint8_t>{1, 2, 3});
+  ASSERT_EQ(table.getNearestPeers(target, 20), fallback->peers);
+}
+
+/**
+ * @given full routing table of crawled peers
+ * @when nearest peers of targets are requested
+ * @then they are equal to closest peers found by sorting all of them
+ */
+TEST(FullRoutingTableTest, NearestPeers) {
+  std::vector<PeerId> peers;
+  std::generate_n(std::back_inserter(peers), 500, testutil::randomPeerId);
+  FullRoutingTable table{std::make_shared<FallbackTable>()};
+  table.assign(peers);
+  ASSERT_EQ(table.size(), peers.size());
+
+  for (uint8_t i = 0; i < 10; ++i) {
+    auto target = NodeId::hash(std::vector<uint8_t>{i});
+    auto sorted = peers;
+    std::sort(sorted.begin(), sorted.end(), [&](auto &a, auto &b) {
+      return NodeId{a}.distance(target) < NodeId{b}.distance(target);
+    });
+    sorted.resize(20);
+    ASSERT_EQ(table.getNearestPeers(target, 20), sorted);
+  }
+}
+
+/**
+ * @given full routing table
+ * @when peers are updated and removed
+ * @then each peer is stored once
+ */
+TEST(FullRoutingTableTest, UpdateRemove) {
+  FullRoutingTable table{std::make_shared<FallbackTable>()};
+  auto peer = testutil::randomPeerId();
+  ASSERT_TRUE(table.update(peer, false, false).value());
+  ASSERT_FALSE(table.update(peer, false, false).value());
+  ASSERT_EQ(table.size(), 1);
+  table.remove(peer);
+  ASSERT_EQ(table.size(), 0);
+}
@@ -0,0 +1,108 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/protocol/kademlia/impl/storage_backend_mmap.hpp>
+
+#include <filesystem>
+
+#include <gtest/gtest.h>
+#include <qtils/test/outcome.hpp>
+
+#include <libp2p/protocol/kademlia/error.hpp>
+#include "mock/libp2p/basic/scheduler_mock.hpp"
+#include "testutil/prepare_loggers.hpp"
+
+using namespace libp2p;
+using namespace protocol::kademlia;
+using ::testing::NiceMock;
+
+struct MmapStorageTest : public ::testing::Test {
+  void SetUp() override {
+    testutil::prepareLoggers();
+    std::string name =
+        ::testing::UnitTest::GetInstance()->current_test_info()->name();
+    path = (std::filesystem::temp_directory_path()
+            / ("kademlia_mmap_storage_test_" + name))
+               .string();
+    std::filesystem::remove(path);
+  }
+
+  void TearDown() override {
+    std::filesystem::remove(path);
+  }
+
+  /// Backend as after restart, on the same file
+  std::shared_ptr<StorageBackendMmap> backend() {
+    auto res = StorageBackendMmap::create(config, path, scheduler);
+    EXPECT_TRUE(res.has_value());
+    return res.value();
+  }
+
+  Config config;
+  std::string path;
+  std::shared_ptr<NiceMock<basic::SchedulerMock>> scheduler =
+      std::make_shared<NiceMock<basic::SchedulerMock>>();
+  ContentId key1 = makeKeySha256("key1");
+  ContentId key2 = makeKeySha256("key2");
+  Value value{1, 2, 3};
+};
+
+/**
+ * @given backend with values put and erased
+ * @when backend is recreated on the same file
+ * @then latest values are loaded, erased ones are not
+ */
+TEST_F(MmapStorageTest, ValuesSurviveRestart) {
+  auto before = backend();
+  ASSERT_OUTCOME_SUCCESS(before->putValue(key1, {9}));
+  ASSERT_OUTCOME_SUCCESS(before->putValue(key1, value));
+  ASSERT_OUTCOME_SUCCESS(before->putValue(key2, value));
+  ASSERT_OUTCOME_SUCCESS(before->erase(key2));
+  before.reset();
+
+  auto after = backend();
+  ASSERT_OUTCOME_SUCCESS(stored, after->getValue(key1));
+  ASSERT_EQ(stored, value);
+  ASSERT_OUTCOME_ERROR(after->getValue(key2), Error::VALUE_NOT_FOUND);
+
+  auto stored_values = after->storedValues();
+  ASSERT_EQ(stored_values.size(), 1);
+  ASSERT_EQ(stored_values[0].first, key1);
+  ASSERT_LT(stored_values[0].second, config.storageRecordTTL);
+}
+
+/**
+ * @given backend which log grew beyond initial mapping by overwrites
+ * @when log is compacted
+ * @then garbage is dropped, live values are kept, also after restart
+ */
+TEST_F(MmapStorageTest, CompactionKeepsLiveValues) {
+  // compacted at once instead of scheduler
+  config.storageCompactionGarbage = 0;
+  auto before = backend();
+  Value large(4096, 0);
+  for (size_t i = 0; i < 512; ++i) {
+    large[0] = static_cast<uint8_t>(i);
+    ASSERT_OUTCOME_SUCCESS(before->putValue(key1, large));
+  }
+  ASSERT_OUTCOME_SUCCESS(before->putValue(key2, value));
+  ASSERT_GT(before->garbageSize(), before->logSize() / 2);
+
+  auto size = before->logSize();
+  ASSERT_OUTCOME_SUCCESS(before->compact());
+  ASSERT_LT(before->logSize(), size / 100);
+  ASSERT_EQ(before->garbageSize(), 0);
+  ASSERT_OUTCOME_SUCCESS(view, before->viewValue(key1));
+  ASSERT_EQ(Value(view.begin(), view.end()), large);
+  before.reset();
+
+  auto after = backend();
+  ASSERT_OUTCOME_SUCCESS(stored1, after->getValue(key1));
+  ASSERT_EQ(stored1, large);
+  ASSERT_OUTCOME_SUCCESS(stored2, after->getValue(key2));
+  ASSERT_EQ(stored2, value);
+  ASSERT_FALSE(std::filesystem::exists(path + ".compact"));
+}
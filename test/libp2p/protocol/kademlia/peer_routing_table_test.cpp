@@ -22,6 +22,7 @@ using libp2p::event::Bus;
 
 using ::testing::Return;
 using ::testing::ReturnRef;
+using std::chrono::milliseconds;
 
 struct PeerRoutingTableTest : public ::testing::Test {
   void SetUp() override {
@@ -318,3 +319,128 @@ TEST_F(PeerRoutingTableTest, Find) {
     EXPECT_EQ(found[0].toHex(), peer.toHex()) << "failed to lookup known node";
   }
 }
+
+/**
+ * @given routing table with peers in far buckets
+ * @when some buckets are looked up
+ * @then only buckets not looked up since given time and not deeper than
+ * the deepest nonempty one are stale
+ */
+TEST_F(PeerRoutingTableTest, StaleBuckets) {
+  NodeId local{self_id};
+  auto peerWithCpl = [&](size_t cpl) {
+    while (true) {
+      auto peer = testutil::randomPeerId();
+      if (local.commonPrefixLen(NodeId{peer}) == cpl) {
+        return peer;
+      }
+    }
+  };
+  ASSERT_OUTCOME_SUCCESS(table_->update(peerWithCpl(0), false));
+  ASSERT_OUTCOME_SUCCESS(table_->update(peerWithCpl(2), false));
+
+  ASSERT_EQ(table_->staleBuckets(milliseconds{1}, 15),
+            (std::vector<size_t>{0, 1, 2}));
+  ASSERT_EQ(table_->staleBuckets(milliseconds{1}, 1),
+            (std::vector<size_t>{0, 1}));
+
+  table_->onLookup(NodeId{peerWithCpl(1)}, milliseconds{10});
+  ASSERT_EQ(table_->staleBuckets(milliseconds{5}, 15),
+            (std::vector<size_t>{0, 2}));
+  ASSERT_EQ(table_->staleBuckets(milliseconds{20}, 15),
+            (std::vector<size_t>{0, 1, 2}));
+}
+
+namespace {
+  /// Random peers in the farthest bucket from local peer
+  std::vector<PeerId> peersOfFirstBucket(const PeerId &local, size_t n) {
+    std::vector<PeerId> peers;
+    while (peers.size() != n) {
+      auto peer_id = testutil::randomPeerId();
+      if (NodeId(peer_id).commonPrefixLen(NodeId(local)) == 0) {
+        peers.push_back(peer_id);
+      }
+    }
+    return peers;
+  }
+}  // namespace
+
+/**
+ * @given full bucket of connected peers
+ * @when one of them fails requests in a row
+ * @then new peer is rejected until failures reach the limit, then it
+ * replaces failing peer, response resets failures
+ */
+TEST_F(PeerRoutingTableTest, FailingPeerReplaced) {
+  config_->maxBucketSize = 3;
+  config_->routingTableMaxFailures = 2;
+  auto peers = peersOfFirstBucket(self_id, 5);
+  for (size_t i = 0; i < 3; ++i) {
+    ASSERT_OUTCOME_SUCCESS(table_->update(peers[i], false, true));
+  }
+
+  table_->onFailure(peers[1]);
+  ASSERT_OUTCOME_ERROR(table_->update(peers[3], false),
+                       PeerRoutingTableImpl::Error::PEER_REJECTED_NO_CAPACITY);
+  table_->onFailure(peers[0]);
+  table_->onResponse(peers[0], milliseconds{10});
+  table_->onFailure(peers[0]);
+  table_->onFailure(peers[1]);
+  ASSERT_OUTCOME_SUCCESS(table_->update(peers[3], false));
+
+  auto all = table_->getAllPeers();
+  std::unordered_set<PeerId> peerset{all.begin(), all.end()};
+  EXPECT_TRUE(hasPeer(peerset, peers[0]));
+  EXPECT_FALSE(hasPeer(peerset, peers[1]));
+  EXPECT_TRUE(hasPeer(peerset, peers[3]));
+}
+
+/**
+ * @given full bucket of replaceable peers with known round trip times
+ * @when new peer is added
+ * @then the slowest peer is replaced, not the least recent one
+ */
+TEST_F(PeerRoutingTableTest, SlowestPeerReplaced) {
+  config_->maxBucketSize = 3;
+  auto peers = peersOfFirstBucket(self_id, 4);
+  for (size_t i = 0; i < 3; ++i) {
+    ASSERT_OUTCOME_SUCCESS(table_->update(peers[i], false));
+  }
+  table_->onResponse(peers[0], milliseconds{20});
+  table_->onResponse(peers[1], milliseconds{80});
+  table_->onResponse(peers[2], milliseconds{40});
+
+  ASSERT_OUTCOME_SUCCESS(table_->update(peers[3], false));
+  auto all = table_->getAllPeers();
+  std::unordered_set<PeerId> peerset{all.begin(), all.end()};
+  EXPECT_TRUE(hasPeer(peerset, peers[0]));
+  EXPECT_FALSE(hasPeer(peerset, peers[1]));
+  EXPECT_TRUE(hasPeer(peerset, peers[2]));
+}
+
+/**
+ * @given routing table with peers
+ * @when the peer nearest to target fails requests in a row
+ * @then it goes after responsive peers, even farther ones, until it responds
+ */
+TEST_F(PeerRoutingTableTest, FailingPeersLast) {
+  config_->routingTableMaxFailures = 1;
+  std::vector<PeerId> peers;
+  std::generate_n(std::back_inserter(peers), 10, testutil::randomPeerId);
+  for (auto &peer : peers) {
+    ASSERT_OUTCOME_SUCCESS(table_->update(peer, false));
+  }
+  NodeId target{peers[0]};
+
+  auto nearest = table_->getNearestPeers(target, 4);
+  ASSERT_EQ(nearest.size(), 4);
+  EXPECT_EQ(nearest[0], peers[0]);
+
+  table_->onFailure(peers[0]);
+  EXPECT_EQ(table_->getNearestPeers(target, 3),
+            (std::vector<PeerId>{nearest[1], nearest[2], nearest[3]}));
+  EXPECT_EQ(table_->getNearestPeers(target, 10).back(), peers[0]);
+
+  table_->onResponse(peers[0], milliseconds{10});
+  EXPECT_EQ(table_->getNearestPeers(target, 4), nearest);
+}
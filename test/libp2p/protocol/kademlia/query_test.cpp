@@ -0,0 +1,134 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/protocol/kademlia/impl/query.hpp>
+
+#include <algorithm>
+
+#include <gtest/gtest.h>
+
+#include "testutil/libp2p/peer.hpp"
+
+using namespace libp2p;
+using namespace protocol::kademlia;
+using std::chrono::milliseconds;
+
+struct QueryTest : public ::testing::Test {
+  void SetUp() override {
+    config.requestConcurency = 1;
+    config.query_max_concurrency = 2;
+    config.replication_factor = 2;
+    config.query_stall_timeout = milliseconds(100);
+  }
+
+  /// Random peers sorted by distance to target
+  std::vector<PeerId> peers(size_t n) {
+    std::vector<PeerId> peers;
+    for (size_t i = 0; i < n; ++i) {
+      peers.emplace_back(testutil::randomPeerId());
+    }
+    std::sort(peers.begin(), peers.end(), [&](auto &a, auto &b) {
+      return NodeId(a).distance(target) < NodeId(b).distance(target);
+    });
+    return peers;
+  }
+
+  Config config;
+  NodeId target = NodeId::hash(std::vector<uint8_t>{1, 2, 3});
+  std::shared_ptr<PeerLatencies> latencies =
+      std::make_shared<PeerLatencies>(100);
+  Time now{1000};
+};
+
+/**
+ * @given query with initial peers and one request at a time
+ * @when peers respond with closer peers and fail
+ * @then peers are queried from closest, query is finished when K closest
+ * responded, farther peers are not queried
+ */
+TEST_F(QueryTest, FinishedWhenClosestResponded) {
+  auto p = peers(5);
+  Query query{config, target, latencies, {p[1], p[3], p[4]}};
+
+  ASSERT_EQ(query.next(now).value(), p[1]);
+  ASSERT_FALSE(query.next(now));
+  query.onSuccess(p[1], {p[0], p[2]}, now);
+  ASSERT_EQ(query.waiting(), 4);
+
+  ASSERT_EQ(query.next(now).value(), p[0]);
+  query.onFailure(p[0], now);
+  ASSERT_FALSE(query.finished());
+
+  ASSERT_EQ(query.next(now).value(), p[2]);
+  ASSERT_EQ(query.inProgress(), 1);
+  query.onSuccess(p[2], {}, now);
+  ASSERT_TRUE(query.finished());
+  ASSERT_EQ(query.waiting(), 2);
+}
+
+/**
+ * @given query with one request at a time
+ * @when request is stalled
+ * @then one more request is spawned, up to the max concurrency
+ */
+TEST_F(QueryTest, StalledRequests) {
+  auto p = peers(3);
+  Query query{config, target, latencies, p};
+
+  ASSERT_EQ(query.next(now).value(), p[0]);
+  ASSERT_FALSE(query.next(now + milliseconds(99)));
+  ASSERT_EQ(query.next(now + milliseconds(100)).value(), p[1]);
+  ASSERT_FALSE(query.next(now + milliseconds(300)));
+
+  // stall timeout is twice the average latency
+  query.onSuccess(p[1], {}, now + milliseconds(140));
+  ASSERT_EQ(latencies->average().value(), milliseconds(40));
+  ASSERT_EQ(query.stallTimeout(), milliseconds(80));
+}
+
+/**
+ * @given peers with known latency
+ * @when next peer is chosen among closest waiting ones
+ * @then the fastest one is queried first
+ */
+TEST_F(QueryTest, FastPeersFirst) {
+  config.requestConcurency = 2;
+  auto p = peers(3);
+  latencies->update(p[1], milliseconds(50));
+  latencies->update(p[2], milliseconds(10));
+  Query query{config, target, latencies, p};
+
+  // p[2] is out of window of two closest waiting peers at first
+  ASSERT_EQ(query.next(now).value(), p[1]);
+  ASSERT_EQ(query.next(now).value(), p[2]);
+  query.onSuccess(p[1], {}, now);
+  ASSERT_EQ(query.next(now).value(), p[0]);
+}
+
+/**
+ * @given query with two disjoint paths
+ * @when peers of one path respond with closer peers
+ * @then closer peers are queried by the same path, query is finished when
+ * both paths are finished
+ */
+TEST_F(QueryTest, DisjointPaths) {
+  config.query_disjoint_paths = 2;
+  config.replication_factor = 1;
+  auto p = peers(3);
+  Query query{config, target, latencies, {p[1], p[2]}};
+
+  ASSERT_EQ(query.next(now).value(), p[1]);
+  ASSERT_EQ(query.next(now).value(), p[2]);
+  ASSERT_FALSE(query.next(now));
+
+  query.onSuccess(p[2], {p[0]}, now);
+  ASSERT_EQ(query.next(now).value(), p[0]);
+  query.onSuccess(p[0], {}, now);
+  ASSERT_FALSE(query.finished());
+
+  query.onSuccess(p[1], {p[0]}, now);
+  ASSERT_TRUE(query.finished());
+}
@@ -0,0 +1,54 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/protocol/kademlia/impl/reprovider.hpp>
+
+#include <gtest/gtest.h>
+
+#include "testutil/libp2p/peer.hpp"
+
+using namespace libp2p;
+using namespace protocol::kademlia;
+
+/**
+ * @given known peers and number of closest peers per key
+ * @when region bits are estimated
+ * @then each region holds about that number of known peers
+ */
+TEST(ReproviderTest, RegionBits) {
+  ASSERT_EQ(reproviderRegionBits(0, 6), 0);
+  ASSERT_EQ(reproviderRegionBits(6, 6), 0);
+  ASSERT_EQ(reproviderRegionBits(12, 6), 1);
+  ASSERT_EQ(reproviderRegionBits(47, 6), 2);
+  ASSERT_EQ(reproviderRegionBits(48, 6), 3);
+}
+
+/**
+ * @given keys of region and candidate peers looked up once
+ * @when keys are batched by peer
+ * @then each key goes to its closest candidates only
+ */
+TEST(ReproviderTest, BatchByClosestPeers) {
+  std::vector<PeerId> candidates;
+  std::generate_n(std::back_inserter(candidates), 5, testutil::randomPeerId);
+  std::vector<ContentId> keys{
+      makeKeySha256("key1"), makeKeySha256("key2"), makeKeySha256("key3")};
+
+  auto batches = batchProviderRecords(keys, candidates, 2);
+
+  for (auto &key : keys) {
+    auto target = NodeId::hash(key);
+    auto sorted = candidates;
+    std::sort(sorted.begin(), sorted.end(), [&](auto &a, auto &b) {
+      return NodeId{a}.distance(target) < NodeId{b}.distance(target);
+    });
+    for (size_t i = 0; i < sorted.size(); ++i) {
+      auto &batch = batches[sorted[i]];
+      auto sent = std::count(batch.begin(), batch.end(), key);
+      ASSERT_EQ(sent, i < 2 ? 1 : 0);
+    }
+  }
+}
@@ -0,0 +1,103 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/protocol/kademlia/impl/request_pool.hpp>
+
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include <libp2p/basic/scheduler/asio_scheduler_backend.hpp>
+#include <libp2p/basic/scheduler/scheduler_impl.hpp>
+#include <libp2p/multi/uvarint.hpp>
+#include "testutil/libp2p/peer.hpp"
+
+using namespace libp2p;
+using namespace protocol::kademlia;
+
+namespace {
+  std::vector<NearestPeersSnapshot::Entry> randomEntries(size_t n) {
+    std::vector<NearestPeersSnapshot::Entry> entries;
+    for (size_t i = 0; i < n; ++i) {
+      auto peer_id = testutil::randomPeerId();
+      entries.push_back({NodeId{peer_id}, {{peer_id, {}}}});
+    }
+    return entries;
+  }
+}  // namespace
+
+/**
+ * @given snapshot of 100 peers
+ * @when nearest peers to random node are taken
+ * @then they are the nearest ones by full sort, in order of distance, and
+ * all peers are returned if there are fewer than asked
+ */
+TEST(RequestPoolTest, SnapshotNearest) {
+  auto entries = randomEntries(100);
+  NearestPeersSnapshot snapshot{entries};
+  NodeId target{testutil::randomPeerId()};
+
+  std::sort(entries.begin(), entries.end(), [&](auto &a, auto &b) {
+    return a.node_id.distance(target) < b.node_id.distance(target);
+  });
+  auto nearest = snapshot.nearest(target, 20);
+  ASSERT_EQ(nearest.size(), 20);
+  for (size_t i = 0; i < nearest.size(); ++i) {
+    EXPECT_EQ(nearest[i].info.id, entries[i].peer.info.id);
+  }
+
+  EXPECT_EQ(snapshot.nearest(target, 1000).size(), 100);
+  EXPECT_TRUE(NearestPeersSnapshot{{}}.nearest(target, 20).empty());
+}
+
+/**
+ * @given pool with worker thread on asio scheduler
+ * @when FIND_NODE response is completed
+ * @then response is filled on worker, handler gets serialized response and
+ * whether it may be cached on scheduler thread
+ */
+TEST(RequestPoolTest, OnWorkers) {
+  auto io = std::make_shared<boost::asio::io_context>(1);
+  auto scheduler = std::make_shared<basic::SchedulerImpl>(
+      std::make_shared<basic::AsioSchedulerBackend>(io),
+      basic::Scheduler::Config{});
+  auto work = boost::asio::make_work_guard(*io);
+  RequestPool pool{scheduler, 1};
+  auto snapshot =
+      std::make_shared<const NearestPeersSnapshot>(randomEntries(30));
+
+  auto request = createFindNodeRequest({1, 2, 3}, boost::none);
+  std::thread::id fill_thread, handler_thread;
+  Bytes frame;
+  bool cached = false;
+  pool.respond(
+      request,
+      [&, snapshot](Message &msg) {
+        fill_thread = std::this_thread::get_id();
+        msg.closer_peers = snapshot->nearest(NodeId::hash(msg.key), 20);
+        return true;
+      },
+      [&](Bytes response, bool cacheable) {
+        handler_thread = std::this_thread::get_id();
+        frame = std::move(response);
+        cached = cacheable;
+        io->stop();
+      });
+  io->run_for(std::chrono::seconds(10));
+
+  ASSERT_EQ(handler_thread, std::this_thread::get_id());
+  ASSERT_NE(fill_thread, std::this_thread::get_id());
+  ASSERT_TRUE(cached);
+  auto length = multi::UVarint::decode(frame);
+  ASSERT_TRUE(length);
+  ASSERT_EQ(length->size + length->value, frame.size());
+  Message response;
+  ASSERT_TRUE(response.deserialize(BytesIn{frame}.subspan(length->size)));
+  EXPECT_EQ(response.type, Message::Type::kFindNode);
+  EXPECT_EQ(response.key, request.key);
+  ASSERT_TRUE(response.closer_peers);
+  EXPECT_EQ(response.closer_peers->size(), 20);
+}
@@ -0,0 +1,72 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/protocol/kademlia/impl/response_cache.hpp>
+
+#include <gtest/gtest.h>
+
+#include <libp2p/protocol/kademlia/content_id.hpp>
+
+using libp2p::Bytes;
+using libp2p::protocol::kademlia::ContentId;
+using libp2p::protocol::kademlia::makeKeySha256;
+using libp2p::protocol::kademlia::ResponseCache;
+using namespace std::chrono_literals;
+
+namespace {
+  auto bytes(const std::optional<libp2p::BytesIn> &frame) {
+    return frame ? std::optional<Bytes>{{frame->begin(), frame->end()}}
+                 : std::nullopt;
+  }
+}  // namespace
+
+/**
+ * @given cached response
+ * @when it is requested before and after TTL
+ * @then it is returned before TTL only
+ */
+TEST(ResponseCacheTest, Expires) {
+  ResponseCache cache{1s, 10};
+  auto key = makeKeySha256("a");
+  cache.put(key, {1, 2, 3}, 0ms);
+  ASSERT_EQ(bytes(cache.get(key, 999ms)), (Bytes{1, 2, 3}));
+  ASSERT_FALSE(cache.get(key, 1s));
+}
+
+/**
+ * @given full cache
+ * @when another response is cached
+ * @then the oldest one is evicted
+ */
+TEST(ResponseCacheTest, EvictsOldest) {
+  ResponseCache cache{1s, 2};
+  std::vector<ContentId> keys{
+      makeKeySha256("a"), makeKeySha256("b"), makeKeySha256("c")};
+  for (uint8_t i = 0; i < keys.size(); ++i) {
+    cache.put(keys[i], {i}, 0ms);
+  }
+  ASSERT_EQ(cache.size(), 2);
+  ASSERT_FALSE(cache.get(keys[0], 0ms));
+  ASSERT_EQ(bytes(cache.get(keys[2], 0ms)), (Bytes{2}));
+}
+
+/**
+ * @given response cached again after being erased
+ * @when cache evicts the oldest entries
+ * @then the fresh response stays
+ */
+TEST(ResponseCacheTest, EraseAndPutAgain) {
+  ResponseCache cache{1s, 2};
+  auto a = makeKeySha256("a");
+  auto b = makeKeySha256("b");
+  cache.put(a, {1}, 0ms);
+  cache.erase(a);
+  ASSERT_FALSE(cache.get(a, 0ms));
+  cache.put(a, {2}, 100ms);
+  cache.put(b, {3}, 200ms);
+  ASSERT_EQ(bytes(cache.get(a, 200ms)), (Bytes{2}));
+  ASSERT_EQ(bytes(cache.get(b, 200ms)), (Bytes{3}));
+}
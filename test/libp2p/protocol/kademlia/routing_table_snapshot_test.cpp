@@ -0,0 +1,60 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/protocol/kademlia/impl/routing_table_snapshot.hpp>
+
+#include <cstdio>
+
+#include <gtest/gtest.h>
+#include <qtils/test/outcome.hpp>
+
+#include <libp2p/common/literals.hpp>
+#include <libp2p/protocol/kademlia/error.hpp>
+#include "testutil/libp2p/peer.hpp"
+
+using namespace libp2p;
+using namespace protocol::kademlia;
+using namespace common;
+
+/**
+ * @given peers with addresses
+ * @when snapshot of them is encoded and decoded
+ * @then the same peers are decoded, truncated snapshot is rejected
+ */
+TEST(RoutingTableSnapshotTest, EncodeDecode) {
+  std::vector<PeerInfo> peers{
+      {testutil::randomPeerId(),
+       {"/ip4/127.0.0.1/tcp/1000"_multiaddr, "/ip6/::1/udp/1000"_multiaddr}},
+      {testutil::randomPeerId(), {}},
+  };
+
+  auto bytes = encodeRoutingTableSnapshot(peers);
+  ASSERT_OUTCOME_SUCCESS(decoded, decodeRoutingTableSnapshot(bytes));
+  ASSERT_EQ(decoded, peers);
+
+  bytes.pop_back();
+  ASSERT_OUTCOME_ERROR(decodeRoutingTableSnapshot(bytes),
+                       Error::MESSAGE_DESERIALIZE_ERROR);
+}
+
+/**
+ * @given snapshot saved to file
+ * @when it is loaded
+ * @then the same peers are loaded, missing file is an error
+ */
+TEST(RoutingTableSnapshotTest, SaveLoad) {
+  std::string path = "routing_table_snapshot_test.bin";
+  std::vector<PeerInfo> peers{
+      {testutil::randomPeerId(), {"/ip4/127.0.0.1/tcp/1000"_multiaddr}},
+  };
+
+  ASSERT_OUTCOME_SUCCESS(saveRoutingTableSnapshot(path, peers));
+  ASSERT_OUTCOME_SUCCESS(loaded, loadRoutingTableSnapshot(path));
+  ASSERT_EQ(loaded, peers);
+  std::remove(path.c_str());
+
+  ASSERT_OUTCOME_ERROR(loadRoutingTableSnapshot(path), Error::STORAGE_ERROR);
+}
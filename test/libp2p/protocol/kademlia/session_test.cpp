@@ -0,0 +1,175 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/protocol/kademlia/impl/session.hpp>
+
+#include <gtest/gtest.h>
+
+#include <libp2p/protocol/kademlia/error.hpp>
+#include <libp2p/protocol/kademlia/impl/response_handler.hpp>
+#include "mock/libp2p/connection/stream_mock.hpp"
+
+using namespace libp2p;
+using namespace protocol::kademlia;
+using connection::StreamMock;
+using ::testing::_;
+using ::testing::AtLeast;
+using ::testing::NiceMock;
+using ::testing::Return;
+
+/// Records responses matched to request
+struct Handler : ResponseHandler {
+  explicit Handler(Message::Type type) : type{type} {}
+
+  Time responseTimeout() const override {
+    return Time::zero();
+  }
+
+  bool match(const Message &msg) const override {
+    return msg.type == type;
+  }
+
+  void onResult(const std::shared_ptr<Session> &,
+                outcome::result<Message> msg_res) override {
+    results.emplace_back(std::move(msg_res));
+  }
+
+  Message::Type type;
+  std::vector<outcome::result<Message>> results;
+};
+
+struct SessionTest : public ::testing::Test {
+  void SetUp() override {
+    ON_CALL(*stream, isClosed()).WillByDefault(Return(false));
+    ON_CALL(*stream, writeSome(_, _, _))
+        .WillByDefault([this](BytesIn in, size_t, auto cb) {
+          written.insert(written.end(), in.begin(), in.end());
+          cb(in.size());
+        });
+    ON_CALL(*stream, readSome(_, _, _))
+        .WillByDefault([this](BytesOut out, size_t, auto cb) {
+          pending_read = {out, std::move(cb)};
+          deliver();
+        });
+    ON_CALL(*stream, deferReadCallback(_, _))
+        .WillByDefault([](outcome::result<size_t> r, auto cb) { cb(r); });
+    session = std::make_shared<Session>(
+        std::weak_ptr<basic::Scheduler>{}, stream, Time::zero());
+  }
+
+  static Bytes frame(Message::Type type) {
+    Message msg;
+    msg.type = type;
+    Bytes bytes;
+    EXPECT_TRUE(msg.serialize(bytes));
+    return bytes;
+  }
+
+  /// Remote side sends messages at once
+  void respond(std::initializer_list<Message::Type> types) {
+    for (auto type : types) {
+      auto bytes = frame(type);
+      incoming.insert(incoming.end(), bytes.begin(), bytes.end());
+    }
+    deliver();
+  }
+
+  void deliver() {
+    auto [out, cb] = pending_read;
+    if (not cb or incoming.empty()) {
+      return;
+    }
+    pending_read = {};
+    auto n = std::min(out.size(), incoming.size());
+    std::copy_n(incoming.begin(), n, out.begin());
+    incoming.erase(incoming.begin(), incoming.begin() + n);
+    cb(n);
+  }
+
+  std::shared_ptr<NiceMock<StreamMock>> stream =
+      std::make_shared<NiceMock<StreamMock>>();
+  std::shared_ptr<Session> session;
+  Bytes written;
+  Bytes incoming;
+  std::pair<BytesOut, basic::Reader::ReadCallbackFunc> pending_read;
+};
+
+/**
+ * @given session with two requests sent before any response
+ * @when responses arrive
+ * @then both requests are written at once and responses are given to
+ * handlers in order of requests
+ */
+TEST_F(SessionTest, PipelinedRequests) {
+  auto find_node = std::make_shared<Handler>(Message::Type::kFindNode);
+  auto get_value = std::make_shared<Handler>(Message::Type::kGetValue);
+  session->write(frame(Message::Type::kFindNode), find_node);
+  session->write(frame(Message::Type::kGetValue), get_value);
+
+  auto expected = frame(Message::Type::kFindNode);
+  auto second = frame(Message::Type::kGetValue);
+  expected.insert(expected.end(), second.begin(), second.end());
+  ASSERT_EQ(written, expected);
+  ASSERT_EQ(session->pending(), 2);
+
+  respond({Message::Type::kFindNode});
+  ASSERT_EQ(find_node->results.size(), 1);
+  ASSERT_TRUE(find_node->results[0]);
+  ASSERT_TRUE(get_value->results.empty());
+
+  respond({Message::Type::kGetValue});
+  ASSERT_EQ(get_value->results.size(), 1);
+  ASSERT_TRUE(get_value->results[0]);
+  ASSERT_EQ(session->pending(), 0);
+  ASSERT_FALSE(session->closed());
+}
+
+/**
+ * @given session with two pipelined requests
+ * @when both responses arrive in one read
+ * @then both handlers get their responses without reading stream again
+ */
+TEST_F(SessionTest, BatchedResponses) {
+  auto find_node = std::make_shared<Handler>(Message::Type::kFindNode);
+  auto get_value = std::make_shared<Handler>(Message::Type::kGetValue);
+  session->write(frame(Message::Type::kFindNode), find_node);
+  session->write(frame(Message::Type::kGetValue), get_value);
+
+  // second response is not read from stream again
+  EXPECT_CALL(*stream, readSome(_, _, _)).Times(0);
+  respond({Message::Type::kFindNode, Message::Type::kGetValue});
+  ASSERT_EQ(find_node->results.size(), 1);
+  ASSERT_TRUE(find_node->results[0]);
+  ASSERT_EQ(get_value->results.size(), 1);
+  ASSERT_TRUE(get_value->results[0]);
+  ASSERT_EQ(session->pending(), 0);
+}
+
+/**
+ * @given session with two pipelined requests
+ * @when response doesn't match the first request
+ * @then both requests fail and session is closed
+ */
+TEST_F(SessionTest, UnexpectedResponseFailsPending) {
+  auto find_node = std::make_shared<Handler>(Message::Type::kFindNode);
+  auto get_value = std::make_shared<Handler>(Message::Type::kGetValue);
+  session->write(frame(Message::Type::kFindNode), find_node);
+  session->write(frame(Message::Type::kGetValue), get_value);
+
+  EXPECT_CALL(*stream, reset()).Times(AtLeast(1));
+  respond({Message::Type::kGetValue});
+  ASSERT_EQ(find_node->results.size(), 1);
+  ASSERT_EQ(find_node->results[0].error(),
+            make_error_code(Error::UNEXPECTED_MESSAGE_TYPE));
+  ASSERT_EQ(get_value->results.size(), 1);
+  ASSERT_FALSE(get_value->results[0]);
+  ASSERT_TRUE(session->closed());
+
+  auto late = std::make_shared<Handler>(Message::Type::kFindNode);
+  session->write(frame(Message::Type::kFindNode), late);
+  ASSERT_EQ(late->results.size(), 1);
+  ASSERT_EQ(late->results[0].error(), make_error_code(Error::SESSION_CLOSED));
+}
@@ -0,0 +1,94 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/protocol/kademlia/impl/content_routing_table_sqlite.hpp>
+#include <libp2p/protocol/kademlia/impl/storage_backend_sqlite.hpp>
+
+#include <gtest/gtest.h>
+#include <qtils/test/outcome.hpp>
+
+#include <libp2p/protocol/kademlia/error.hpp>
+#include "mock/libp2p/basic/scheduler_mock.hpp"
+#include "testutil/libp2p/peer.hpp"
+#include "testutil/prepare_loggers.hpp"
+
+using namespace libp2p;
+using namespace protocol::kademlia;
+using libp2p::event::Bus;
+using ::testing::NiceMock;
+
+struct SqliteStorageTest : public ::testing::Test {
+  void SetUp() override {
+    testutil::prepareLoggers();
+    db = std::make_shared<storage::SQLite>(":memory:");
+  }
+
+  /// Backend as after restart, on the same database
+  std::shared_ptr<StorageBackendSqlite> backend() {
+    return std::make_shared<StorageBackendSqlite>(config, db, scheduler);
+  }
+
+  std::shared_ptr<ContentRoutingTableSqlite> table() {
+    return std::make_shared<ContentRoutingTableSqlite>(
+        config, *scheduler, bus, db);
+  }
+
+  Config config;
+  std::shared_ptr<storage::SQLite> db;
+  std::shared_ptr<NiceMock<basic::SchedulerMock>> scheduler =
+      std::make_shared<NiceMock<basic::SchedulerMock>>();
+  std::shared_ptr<Bus> bus = std::make_shared<Bus>();
+  ContentId key1 = makeKeySha256("key1");
+  ContentId key2 = makeKeySha256("key2");
+  Value value{1, 2, 3};
+};
+
+/**
+ * @given backend with values put and erased
+ * @when backend is recreated on the same database
+ * @then values written by batch are loaded, erased ones are not
+ */
+TEST_F(SqliteStorageTest, ValuesSurviveRestart) {
+  auto before = backend();
+  ASSERT_OUTCOME_SUCCESS(before->putValue(key1, value));
+  ASSERT_OUTCOME_SUCCESS(before->putValue(key2, value));
+  ASSERT_OUTCOME_SUCCESS(before->erase(key2));
+  ASSERT_OUTCOME_SUCCESS(before->flush());
+  before.reset();
+
+  auto after = backend();
+  ASSERT_OUTCOME_SUCCESS(stored, after->getValue(key1));
+  ASSERT_EQ(stored, value);
+  ASSERT_OUTCOME_ERROR(after->getValue(key2), Error::VALUE_NOT_FOUND);
+
+  auto stored_values = after->storedValues();
+  ASSERT_EQ(stored_values.size(), 1);
+  ASSERT_EQ(stored_values[0].first, key1);
+  ASSERT_LT(stored_values[0].second, config.storageRecordTTL);
+}
+
+/**
+ * @given routing table with more providers of key than allowed
+ * @when table is recreated on the same database
+ * @then the most recent providers are loaded
+ */
+TEST_F(SqliteStorageTest, ProvidersSurviveRestart) {
+  config.maxProvidersPerKey = 2;
+  std::vector<PeerId> peers;
+  std::generate_n(std::back_inserter(peers), 3, testutil::randomPeerId);
+
+  auto before = table();
+  for (auto &peer : peers) {
+    before->addProvider(key1, peer);
+  }
+  ASSERT_EQ(before->getProvidersFor(key1).size(), 2);
+  before.reset();
+
+  auto providers = table()->getProvidersFor(key1);
+  ASSERT_EQ(providers.size(), 2);
+  ASSERT_EQ(std::count(providers.begin(), providers.end(), peers[0]), 0);
+  ASSERT_TRUE(table()->getProvidersFor(key2).empty());
+}
@@ -0,0 +1,99 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/protocol/kademlia/impl/validation_pool.hpp>
+
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include <libp2p/basic/scheduler/asio_scheduler_backend.hpp>
+#include <libp2p/basic/scheduler/manual_scheduler_backend.hpp>
+#include <libp2p/basic/scheduler/scheduler_impl.hpp>
+#include <libp2p/protocol/kademlia/error.hpp>
+
+using namespace libp2p;
+using namespace protocol::kademlia;
+
+/// Accepts non-empty values, selects the largest one, remembers threads
+struct TestValidator : Validator {
+  outcome::result<void> validate(const Key &, const Value &value) override {
+    threads.push_back(std::this_thread::get_id());
+    if (value.empty()) {
+      return Error::CONTENT_VALIDATION_FAILED;
+    }
+    return outcome::success();
+  }
+
+  outcome::result<size_t> select(const Key &,
+                                 const std::vector<Value> &values) override {
+    threads.push_back(std::this_thread::get_id());
+    return std::max_element(values.begin(), values.end()) - values.begin();
+  }
+
+  std::vector<std::thread::id> threads;
+};
+
+/**
+ * @given pool without threads
+ * @when records are validated and selected
+ * @then validator is called in place, handlers are called before return
+ */
+TEST(ValidationPoolTest, InPlace) {
+  auto validator = std::make_shared<TestValidator>();
+  auto scheduler = std::make_shared<basic::SchedulerImpl>(
+      std::make_shared<basic::ManualSchedulerBackend>(),
+      basic::Scheduler::Config{});
+  ValidationPool pool{validator, scheduler, 0};
+
+  boost::optional<outcome::result<void>> valid, invalid;
+  pool.validate({1}, {1}, [&](outcome::result<void> res) { valid = res; });
+  pool.validate({1}, {}, [&](outcome::result<void> res) { invalid = res; });
+  ASSERT_TRUE(valid and valid->has_value());
+  ASSERT_TRUE(invalid and invalid->has_error());
+
+  boost::optional<Value> best;
+  pool.select({1}, {{1}, {3}, {2}}, [&](outcome::result<Value> res) {
+    best = res.value();
+  });
+  ASSERT_EQ(best, Value{3});
+  ASSERT_EQ(validator->threads,
+            std::vector<std::thread::id>(3, std::this_thread::get_id()));
+}
+
+/**
+ * @given pool with worker thread on asio scheduler
+ * @when record is validated and values are selected
+ * @then validator runs on worker, handlers run on scheduler thread
+ */
+TEST(ValidationPoolTest, OnWorkers) {
+  auto validator = std::make_shared<TestValidator>();
+  auto io = std::make_shared<boost::asio::io_context>(1);
+  auto scheduler = std::make_shared<basic::SchedulerImpl>(
+      std::make_shared<basic::AsioSchedulerBackend>(io),
+      basic::Scheduler::Config{});
+  auto work = boost::asio::make_work_guard(*io);
+  ValidationPool pool{validator, scheduler, 1};
+
+  std::vector<std::thread::id> handler_threads;
+  boost::optional<Value> best;
+  pool.validate({1}, {1}, [&](outcome::result<void> res) {
+    EXPECT_TRUE(res.has_value());
+    handler_threads.push_back(std::this_thread::get_id());
+    pool.select({1}, {{1}, {3}}, [&](outcome::result<Value> res) {
+      handler_threads.push_back(std::this_thread::get_id());
+      best = res.value();
+      io->stop();
+    });
+  });
+  io->run_for(std::chrono::seconds(10));
+
+  ASSERT_EQ(best, Value{3});
+  ASSERT_EQ(handler_threads,
+            std::vector<std::thread::id>(2, std::this_thread::get_id()));
+  ASSERT_EQ(validator->threads.size(), 2);
+  ASSERT_NE(validator->threads[0], std::this_thread::get_id());
+}
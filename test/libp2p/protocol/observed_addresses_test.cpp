@@ -17,8 +17,8 @@ class ObservedAddressesTest : public testing::Test {
  public:
   void SetUp() override {
     // for the purpose of testing, add some addresses to our object; in order
-    // for the address to be "activated" 4 different observers must report about
-    // it
+    // for the address to be "activated" observers from 4 different networks
+    // must report about it
     observed_addresses_.add(observed_ma1, local_ma1, observer_ma1, true);
     observed_addresses_.add(observed_ma1, local_ma1, observer_ma2, true);
     observed_addresses_.add(observed_ma1, local_ma1, observer_ma3, true);
@@ -33,9 +33,9 @@ class ObservedAddressesTest : public testing::Test {
   multi::Multiaddress local_ma1 = "/ip4/92.134.23.14/tcp/225"_multiaddr,
                       local_ma2 = "/ip4/123.251.78.90/udp/228"_multiaddr,
                       observer_ma1 = "/ip4/123.251.78.91/udp/228"_multiaddr,
-                      observer_ma2 = "/ip4/123.251.78.92/udp/228"_multiaddr,
-                      observer_ma3 = "/ip4/123.251.78.93/udp/228"_multiaddr,
-                      observer_ma4 = "/ip4/123.251.78.94/udp/228"_multiaddr,
+                      observer_ma2 = "/ip4/124.251.78.92/udp/228"_multiaddr,
+                      observer_ma3 = "/ip4/125.251.78.93/udp/228"_multiaddr,
+                      observer_ma4 = "/ip4/126.251.78.94/udp/228"_multiaddr,
                       observed_ma1 = "/ip4/123.251.78.96/udp/228"_multiaddr,
                       observed_ma2 = "/ip4/123.251.78.97/udp/228"_multiaddr;
 };
@@ -69,3 +69,41 @@ TEST_F(ObservedAddressesTest, GetAllAddresses) {
   ASSERT_NE(std::find(addresses.begin(), addresses.end(), observed_ma2),
             addresses.end());
 }
+
+/**
+ * @given observed address reported by 3 networks
+ * @when another peer from one of those /16 networks reports it
+ * @then the address is not activated
+ */
+TEST_F(ObservedAddressesTest, SameNetworkCountedOnce) {
+  observed_addresses_.add(
+      observed_ma2, local_ma2, "/ip4/123.251.1.1/tcp/1"_multiaddr, true);
+  ASSERT_TRUE(observed_addresses_.getAddressesFor(local_ma2).empty());
+
+  observed_addresses_.add(
+      observed_ma2, local_ma2, "/ip6/2001:db8::1/tcp/1"_multiaddr, true);
+  auto addresses = observed_addresses_.getAddressesFor(local_ma2);
+  ASSERT_EQ(addresses.size(), 1);
+  ASSERT_EQ(addresses[0], observed_ma2);
+}
+
+/**
+ * @given observed addresses object
+ * @when more observed addresses than the limit are reported for one local
+ * address
+ * @then least recently seen not activated addresses are evicted, activated
+ * one is kept
+ */
+TEST_F(ObservedAddressesTest, BoundedPerLocalAddress) {
+  for (size_t i = 0; i < ObservedAddresses::kMaxObservedPerLocal * 2; ++i) {
+    auto observed = multi::Multiaddress::create(
+        "/ip4/10.0.0." + std::to_string(i) + "/tcp/1");
+    ASSERT_TRUE(observed);
+    observed_addresses_.add(observed.value(), local_ma1, observer_ma1, true);
+  }
+
+  auto addresses = observed_addresses_.getAddressesFor(local_ma1);
+  ASSERT_EQ(addresses.size(), 1);
+  ASSERT_EQ(addresses[0], observed_ma1);
+  ASSERT_EQ(observed_addresses_.getAllAddresses().size(), 1);
+}
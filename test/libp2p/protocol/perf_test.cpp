@@ -0,0 +1,99 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <gtest/gtest.h>
+#include <boost/asio/io_context.hpp>
+#include <libp2p/common/literals.hpp>
+#include <libp2p/protocol/perf/perf.hpp>
+#include <libp2p/transport/memory/connection.hpp>
+#include <libp2p/transport/memory/stream.hpp>
+
+#include "mock/libp2p/host/host_mock.hpp"
+#include "testutil/libp2p/peer.hpp"
+
+using libp2p::HostMock;
+using libp2p::StreamAndProtocol;
+using libp2p::StreamAndProtocolOrErrorCb;
+using libp2p::connection::MemoryStream;
+using libp2p::peer::PeerId;
+using libp2p::protocol::Perf;
+using libp2p::protocol::PerfConfig;
+using libp2p::protocol::PerfResult;
+using libp2p::transport::MemoryConnection;
+using testing::_;
+using namespace libp2p::common;
+
+class PerfTest : public testing::Test {
+ public:
+  void SetUp() override {
+    std::tie(client_conn, server_conn) = MemoryConnection::makePair(
+        {io, "/memory/1"_multiaddr, client_peer, {}},
+        {io, "/memory/2"_multiaddr, server_peer, {}});
+    ON_CALL(host, newStream(_, _, _))
+        .WillByDefault([&](auto &&, auto &&, StreamAndProtocolOrErrorCb cb) {
+          auto [client_end, server_end] =
+              MemoryStream::makePair(client_conn, server_conn);
+          server->handle({server_end, Perf::kProtocolId});
+          cb(StreamAndProtocol{client_end, Perf::kProtocolId});
+        });
+  }
+
+  /// Runs perf and io_context till it is idle
+  outcome::result<PerfResult> run(uint64_t upload, uint64_t download) {
+    std::optional<outcome::result<PerfResult>> result;
+    client->run({server_peer, {}},
+                upload,
+                download,
+                [&](outcome::result<PerfResult> r) { result = std::move(r); });
+    io->run();
+    EXPECT_TRUE(result.has_value());
+    return result.value();
+  }
+
+  std::shared_ptr<boost::asio::io_context> io =
+      std::make_shared<boost::asio::io_context>();
+  testing::NiceMock<HostMock> host;
+  PeerId client_peer = testutil::randomPeerId();
+  PeerId server_peer = testutil::randomPeerId();
+  std::shared_ptr<MemoryConnection> client_conn, server_conn;
+  std::shared_ptr<Perf> server = std::make_shared<Perf>(
+      host, PerfConfig{.buffer_size = 1000, .max_download = 1 << 20});
+  std::shared_ptr<Perf> client =
+      std::make_shared<Perf>(host, PerfConfig{.buffer_size = 700});
+};
+
+/**
+ * @given perf client and server with buffers smaller than transfers
+ * @when client uploads and downloads
+ * @then all bytes are transferred both ways
+ */
+TEST_F(PerfTest, UploadDownload) {
+  auto r = run(12345, 54321);
+  ASSERT_TRUE(r) << r.error().message();
+  EXPECT_EQ(r.value().uploaded, 12345);
+  EXPECT_EQ(r.value().downloaded, 54321);
+}
+
+/**
+ * @given perf client and server
+ * @when client neither uploads nor downloads
+ * @then run succeeds with nothing transferred
+ */
+TEST_F(PerfTest, Empty) {
+  auto r = run(0, 0);
+  ASSERT_TRUE(r) << r.error().message();
+  EXPECT_EQ(r.value().uploaded, 0);
+  EXPECT_EQ(r.value().downloaded, 0);
+}
+
+/**
+ * @given server limiting download size
+ * @when client requests more
+ * @then server resets stream and run fails
+ */
+TEST_F(PerfTest, DownloadLimit) {
+  EXPECT_FALSE(run(10, (1 << 20) + 1));
+}
@@ -13,6 +13,7 @@
 #include <libp2p/common/literals.hpp>
 #include <libp2p/common/types.hpp>
 #include <libp2p/event/bus.hpp>
+#include <libp2p/peer/latency_repository/inmem_latency_repository.hpp>
 #include <libp2p/peer/peer_id.hpp>
 #include <libp2p/protocol/ping/common.hpp>
 
@@ -49,13 +50,13 @@ class PingTest : public testing::Test {
   static constexpr uint32_t kPingMsgSize = 32;
 
   void setTimer(bool timeout) {
-    EXPECT_CALL(*scheduler_, scheduleImpl(_, kInterval, true))
-        .WillRepeatedly([](auto cb, auto, auto) {
+    EXPECT_CALL(*scheduler_, scheduleImpl(_, kInterval, true, _, _))
+        .WillRepeatedly([](auto cb, auto, auto, auto) {
           cb();
           return Scheduler::Handle{};
         });
-    EXPECT_CALL(*scheduler_, scheduleImpl(_, kTimeout, true))
-        .WillRepeatedly([timeout](auto cb, auto, auto) {
+    EXPECT_CALL(*scheduler_, scheduleImpl(_, kTimeout, true, _, _))
+        .WillRepeatedly([timeout](auto cb, auto, auto, auto) {
           if (timeout) {
             cb();
           }
@@ -81,6 +82,7 @@ class PingTest : public testing::Test {
   PeerId peer_id_ = "xxxMyPeerxxx"_peerid;
   PeerInfo peer_info_{peer_id_, {}};
   PeerRepositoryMock peer_repo_;
+  InmemLatencyRepository latency_repo_;
 
   std::vector<uint8_t> buffer_ = std::vector<uint8_t>(kPingMsgSize, 0xE3);
 };
@@ -122,12 +124,21 @@ TEST_F(PingTest, PingServer) {
  * @given Ping protocol handler
  * @when a stream over the Ping protocol is initiated from our side
  * @then a Ping message is sent over that stream @and we expect to get it back
+ * @and round trip time is recorded
  */
 TEST_F(PingTest, PingClient) {
   setTimer(false);
 
   EXPECT_CALL(*conn_, remotePeer()).WillOnce(Return(peer_id_));
-  EXPECT_CALL(host_, getPeerRepository()).WillOnce(ReturnRef(peer_repo_));
+  EXPECT_CALL(host_, getPeerRepository())
+      .Times(2)
+      .WillRepeatedly(ReturnRef(peer_repo_));
+  EXPECT_CALL(peer_repo_, getLatencyRepository())
+      .WillOnce(ReturnRef(latency_repo_));
+  EXPECT_CALL(*scheduler_, now())
+      .WillOnce(Return(10ms))
+      .WillOnce(Return(25ms))
+      .WillRepeatedly(Return(40ms));
   EXPECT_CALL(peer_repo_, getPeerInfo(peer_id_)).WillOnce(Return(peer_info_));
   EXPECT_CALL(host_, newStream(peer_info_, StreamProtocols{kPingProto}, _))
       .WillOnce(InvokeArgument<2>(StreamAndProtocol{stream_, kPingProto}));
@@ -157,6 +168,11 @@ TEST_F(PingTest, PingClient) {
 
   ping_->startPinging(conn_,
                       [](auto &&session_res) { ASSERT_TRUE(session_res); });
+
+  auto latency = latency_repo_.getLatency(peer_id_);
+  ASSERT_TRUE(latency);
+  ASSERT_EQ(latency->last, 15ms);
+  ASSERT_EQ(latency->samples, 1);
 }
 
 /**
@@ -197,3 +213,38 @@ TEST_F(PingTest, PingClientTimeoutExpired) {
   ASSERT_TRUE(dead_peer_id);
   ASSERT_EQ(*dead_peer_id, peer_id_);
 }
+
+/**
+ * @given Ping protocol handler and connection, which muxer has ping frames
+ * @when pinging the connection
+ * @then no stream is opened, muxer pings are sent @and round trip time is
+ * recorded @and peer is declared dead once ping fails
+ */
+TEST_F(PingTest, PingClientMuxerPing) {
+  setTimer(false);
+
+  EXPECT_CALL(*conn_, supportsPing()).WillRepeatedly(Return(true));
+  EXPECT_CALL(*conn_, isClosed()).WillRepeatedly(Return(false));
+  EXPECT_CALL(*conn_, remotePeer()).Times(2).WillRepeatedly(Return(peer_id_));
+  EXPECT_CALL(host_, getPeerRepository()).WillOnce(ReturnRef(peer_repo_));
+  EXPECT_CALL(peer_repo_, getLatencyRepository())
+      .WillOnce(ReturnRef(latency_repo_));
+  EXPECT_CALL(host_, newStream(_, _, _)).Times(0);
+  EXPECT_CALL(*conn_, ping(_))
+      .WillOnce(InvokeArgument<0>(std::chrono::microseconds{15000}))
+      .WillOnce(InvokeArgument<0>(
+          make_error_code(boost::asio::error::connection_reset)));
+
+  boost::optional<peer::PeerId> dead_peer_id;
+  auto h = bus_.getChannel<event::protocol::PeerIsDeadChannel>().subscribe(
+      [&dead_peer_id](auto &&peer_id) mutable { dead_peer_id = peer_id; });
+
+  ping_->startPinging(conn_,
+                      [](auto &&session_res) { ASSERT_TRUE(session_res); });
+
+  auto latency = latency_repo_.getLatency(peer_id_);
+  ASSERT_TRUE(latency);
+  ASSERT_EQ(latency->last, 15ms);
+  ASSERT_TRUE(dead_peer_id);
+  ASSERT_EQ(*dead_peer_id, peer_id_);
+}
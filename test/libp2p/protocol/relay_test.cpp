@@ -0,0 +1,268 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <gtest/gtest.h>
+#include <boost/asio/io_context.hpp>
+#include <libp2p/basic/read.hpp>
+#include <libp2p/basic/scheduler/manual_scheduler_backend.hpp>
+#include <libp2p/basic/scheduler/scheduler_impl.hpp>
+#include <libp2p/basic/write.hpp>
+#include <libp2p/common/literals.hpp>
+#include <libp2p/protocol/relay/client.hpp>
+#include <libp2p/protocol/relay/error.hpp>
+#include <libp2p/protocol/relay/relay.hpp>
+#include <libp2p/transport/memory/connection.hpp>
+#include <libp2p/transport/memory/stream.hpp>
+#include <qtils/bytestr.hpp>
+
+#include "mock/libp2p/host/host_mock.hpp"
+#include "testutil/libp2p/peer.hpp"
+
+using libp2p::HostMock;
+using libp2p::RelayError;
+using libp2p::StreamAndProtocol;
+using libp2p::StreamAndProtocolOrErrorCb;
+using libp2p::basic::ManualSchedulerBackend;
+using libp2p::basic::SchedulerImpl;
+using libp2p::connection::MemoryStream;
+using libp2p::connection::Stream;
+using libp2p::peer::PeerId;
+using libp2p::peer::PeerInfo;
+using libp2p::protocol::BaseProtocol;
+using libp2p::protocol::relay::Limit;
+using libp2p::protocol::relay::Relay;
+using libp2p::protocol::relay::RelayClient;
+using libp2p::protocol::relay::RelayConfig;
+using libp2p::transport::MemoryConnection;
+using qtils::byte2str;
+using qtils::str2byte;
+using testing::_;
+using testing::Return;
+using namespace libp2p::common;
+
+struct Node {
+  PeerId peer = testutil::randomPeerId();
+  testing::NiceMock<HostMock> host;
+};
+
+class RelayTest : public testing::Test {
+ public:
+  void SetUp() override {
+    ON_CALL(relay_node.host, getId()).WillByDefault(Return(relay_node.peer));
+    ON_CALL(relay_node.host, getAddresses())
+        .WillByDefault(Return(
+            std::vector{"/ip4/127.0.0.1/tcp/4001"_multiaddr}));
+    connect(src, relay_node, [&] { return relay; });
+    connect(dst, relay_node, [&] { return relay; });
+    connect(relay_node, dst, [&] { return dst_client; });
+    src_client = std::make_shared<RelayClient>(src.host);
+    dst_client = std::make_shared<RelayClient>(dst.host);
+    dst_client->start(
+        [&](const PeerId &peer, const Limit &limit, std::shared_ptr<Stream> s) {
+          EXPECT_EQ(peer, src.peer);
+          EXPECT_EQ(limit, config.limit);
+          dst_stream = std::move(s);
+        });
+  }
+
+  void TearDown() override {
+    for (auto &stream : {src_stream, dst_stream}) {
+      if (stream) {
+        stream->reset();
+      }
+    }
+    run();
+  }
+
+  /// Streams opened by "from" are handled by protocol of "to"
+  template <typename F>
+  void connect(Node &from, Node &to, F protocol) {
+    auto [from_end, to_end] = MemoryConnection::makePair(
+        {io, "/memory/1"_multiaddr, from.peer, {}},
+        {io, "/memory/2"_multiaddr, to.peer, {}});
+    ON_CALL(from.host, newStream(_, _, _))
+        .WillByDefault([=, from_end{from_end}, to_end{to_end}](
+                           const PeerInfo &peer,
+                           auto &&,
+                           StreamAndProtocolOrErrorCb cb) {
+          EXPECT_EQ(peer.id, to_end->localPeer().value());
+          auto [from_stream, to_stream] =
+              MemoryStream::makePair(from_end, to_end);
+          std::shared_ptr<BaseProtocol> handler = protocol();
+          handler->handle({to_stream, handler->getProtocolId()});
+          cb(StreamAndProtocol{from_stream, handler->getProtocolId()});
+        });
+    conns.emplace_back(from_end);
+    conns.emplace_back(to_end);
+  }
+
+  void makeRelay() {
+    relay = std::make_shared<Relay>(relay_node.host, scheduler, config);
+  }
+
+  void reserve() {
+    bool reserved = false;
+    dst_client->reserve({relay_node.peer, {}}, [&](auto r) {
+      ASSERT_TRUE(r) << r.error();
+      EXPECT_EQ(r.value().limit, config.limit);
+      ASSERT_EQ(r.value().addresses.size(), 1);
+      EXPECT_EQ(r.value().addresses[0].getStringAddress(),
+                "/ip4/127.0.0.1/tcp/4001/p2p/" + relay_node.peer.toBase58());
+      reserved = true;
+    });
+    run();
+    ASSERT_TRUE(reserved);
+  }
+
+  outcome::result<void> connectCircuit() {
+    std::optional<outcome::result<void>> result;
+    src_client->connect({relay_node.peer, {}}, dst.peer, [&](auto r) {
+      if (not r) {
+        result = r.error();
+        return;
+      }
+      src_stream = r.value();
+      result = outcome::success();
+    });
+    run();
+    if (not result) {
+      ADD_FAILURE() << "connect not completed";
+      return outcome::success();
+    }
+    return result.value();
+  }
+
+  /// Writes to one stream, reads from another what arrives
+  std::string transfer(std::shared_ptr<Stream> from,
+                       std::shared_ptr<Stream> to,
+                       std::string_view data) {
+    libp2p::write(from, str2byte(data), [](outcome::result<void>) {});
+    std::string received;
+    std::vector<uint8_t> buf(data.size());
+    std::function<void()> read = [&] {
+      to->readSome(buf, buf.size(), [&](outcome::result<size_t> r) {
+        if (r) {
+          received += byte2str(std::span{buf}.first(r.value()));
+          if (received.size() < data.size()) {
+            read();
+          }
+        }
+      });
+    };
+    read();
+    run();
+    return received;
+  }
+
+  /// Runs io_context and scheduler till both are idle
+  void run() {
+    while (true) {
+      backend->shift(std::chrono::milliseconds{0});
+      io->restart();
+      if (io->poll() == 0) {
+        break;
+      }
+    }
+  }
+
+  std::shared_ptr<boost::asio::io_context> io =
+      std::make_shared<boost::asio::io_context>();
+  std::shared_ptr<ManualSchedulerBackend> backend =
+      std::make_shared<ManualSchedulerBackend>();
+  std::shared_ptr<SchedulerImpl> scheduler =
+      std::make_shared<SchedulerImpl>(backend, SchedulerImpl::Config{});
+  Node src, relay_node, dst;
+  std::vector<std::shared_ptr<MemoryConnection>> conns;
+  RelayConfig config;
+  std::shared_ptr<Relay> relay;
+  std::shared_ptr<RelayClient> src_client, dst_client;
+  std::shared_ptr<Stream> src_stream, dst_stream;
+};
+
+/**
+ * @given peer with reservation on relay
+ * @when other peer connects to it through relay
+ * @then bytes are relayed both ways, and close is relayed
+ */
+TEST_F(RelayTest, ReserveConnect) {
+  makeRelay();
+  reserve();
+  EXPECT_EQ(relay->reservations(), 1);
+  ASSERT_TRUE(connectCircuit());
+  ASSERT_TRUE(dst_stream);
+  EXPECT_EQ(relay->circuits(), 1);
+
+  EXPECT_EQ(transfer(src_stream, dst_stream, "hello"), "hello");
+  EXPECT_EQ(transfer(dst_stream, src_stream, "world"), "world");
+
+  src_stream->close([](outcome::result<void> r) { EXPECT_TRUE(r); });
+  run();
+  EXPECT_EQ(transfer(dst_stream, src_stream, "bye"), "bye");
+  dst_stream->close([](outcome::result<void> r) { EXPECT_TRUE(r); });
+  run();
+  EXPECT_EQ(relay->circuits(), 0);
+}
+
+/**
+ * @given peer without reservation
+ * @when other peer connects to it through relay
+ * @then connect fails
+ */
+TEST_F(RelayTest, NoReservation) {
+  makeRelay();
+  EXPECT_EQ(connectCircuit().error(),
+            make_error_code(RelayError::NO_RESERVATION));
+  EXPECT_FALSE(dst_stream);
+  EXPECT_EQ(relay->circuits(), 0);
+}
+
+/**
+ * @given relay without reservation slots
+ * @when peer reserves
+ * @then reservation is refused
+ */
+TEST_F(RelayTest, ReservationRefused) {
+  config.max_reservations = 0;
+  makeRelay();
+  std::optional<std::error_code> error;
+  dst_client->reserve({relay_node.peer, {}}, [&](auto r) {
+    ASSERT_FALSE(r);
+    error = r.error();
+  });
+  run();
+  EXPECT_EQ(error, make_error_code(RelayError::RESERVATION_REFUSED));
+}
+
+/**
+ * @given circuit limited to 4 bytes in each direction
+ * @when more bytes are written
+ * @then only 4 of them are relayed, and circuit is reset
+ */
+TEST_F(RelayTest, DataLimit) {
+  config.limit.data = 4;
+  makeRelay();
+  reserve();
+  ASSERT_TRUE(connectCircuit());
+  EXPECT_EQ(transfer(src_stream, dst_stream, "12345678"), "1234");
+  EXPECT_EQ(relay->circuits(), 0);
+  EXPECT_TRUE(dst_stream->isClosedForRead());
+}
+
+/**
+ * @given circuit limited in duration
+ * @when duration passes
+ * @then circuit is reset
+ */
+TEST_F(RelayTest, DurationLimit) {
+  makeRelay();
+  reserve();
+  ASSERT_TRUE(connectCircuit());
+  EXPECT_EQ(relay->circuits(), 1);
+  backend->shift(config.limit.duration);
+  run();
+  EXPECT_EQ(relay->circuits(), 0);
+  EXPECT_TRUE(src_stream->isClosedForWrite());
+}
@@ -0,0 +1,215 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <gtest/gtest.h>
+#include <boost/asio/io_context.hpp>
+#include <libp2p/basic/scheduler/manual_scheduler_backend.hpp>
+#include <libp2p/basic/scheduler/scheduler_impl.hpp>
+#include <libp2p/common/literals.hpp>
+#include <libp2p/protocol/request_response/request_response.hpp>
+#include <libp2p/transport/memory/connection.hpp>
+#include <libp2p/transport/memory/stream.hpp>
+#include <qtils/bytestr.hpp>
+
+#include "mock/libp2p/host/host_mock.hpp"
+#include "testutil/libp2p/peer.hpp"
+
+using libp2p::Bytes;
+using libp2p::BytesIn;
+using libp2p::HostMock;
+using libp2p::RequestResponseError;
+using libp2p::StreamAndProtocol;
+using libp2p::StreamAndProtocolOrErrorCb;
+using libp2p::basic::ManualSchedulerBackend;
+using libp2p::basic::SchedulerImpl;
+using libp2p::connection::MemoryStream;
+using libp2p::peer::PeerId;
+using libp2p::protocol::RequestResponse;
+using libp2p::protocol::RequestResponseConfig;
+using libp2p::transport::MemoryConnection;
+using qtils::byte2str;
+using qtils::str2byte;
+using testing::_;
+using namespace libp2p::common;
+
+const std::string kProtocol = "/test/request-response/1.0.0";
+
+Bytes bytes(std::string_view s) {
+  auto b = str2byte(s);
+  return {b.begin(), b.end()};
+}
+
+class RequestResponseTest : public testing::Test {
+ public:
+  void SetUp() override {
+    std::tie(client_conn, server_conn) = MemoryConnection::makePair(
+        {io, "/memory/1"_multiaddr, client_peer, {}},
+        {io, "/memory/2"_multiaddr, server_peer, {}});
+    server = std::make_shared<RequestResponse>(
+        host,
+        scheduler,
+        libp2p::StreamProtocols{kProtocol},
+        [&](const PeerId &peer, BytesIn request, auto respond) {
+          EXPECT_EQ(peer, client_peer);
+          requests.emplace_back(byte2str(request));
+          responds.emplace_back(std::move(respond));
+          if (auto_respond) {
+            reply(requests.size() - 1);
+          }
+        });
+    // streams opened by client are handled by server
+    ON_CALL(host, newStream(_, _, _))
+        .WillByDefault([&](auto &&, auto &&, StreamAndProtocolOrErrorCb cb) {
+          auto [client_end, server_end] =
+              MemoryStream::makePair(client_conn, server_conn);
+          server->handle({server_end, kProtocol});
+          cb(StreamAndProtocol{client_end, kProtocol});
+        });
+  }
+
+  void TearDown() override {
+    // idle streams are reset, and handlers posted by reset are run
+    client.reset();
+    run();
+  }
+
+  void makeClient(RequestResponseConfig config) {
+    client = std::make_shared<RequestResponse>(
+        host, scheduler, libp2p::StreamProtocols{kProtocol}, nullptr, config);
+  }
+
+  /// Sends "re:<request>" for request with given index
+  void reply(size_t i) {
+    responds.at(i)(bytes("re:" + requests.at(i)));
+  }
+
+  /// Requests and stores response or error
+  void request(std::string_view req) {
+    client->request(
+        server_peer, bytes(req), [&](outcome::result<BytesIn> r) {
+          responses.emplace_back(r ? byte2str(r.value())
+                                   : "error:" + r.error().message());
+        });
+  }
+
+  /// Runs io_context and scheduler till both are idle
+  void run() {
+    while (true) {
+      backend->shift(std::chrono::milliseconds{0});
+      io->restart();
+      if (io->poll() == 0) {
+        break;
+      }
+    }
+  }
+
+  std::shared_ptr<boost::asio::io_context> io =
+      std::make_shared<boost::asio::io_context>();
+  std::shared_ptr<ManualSchedulerBackend> backend =
+      std::make_shared<ManualSchedulerBackend>();
+  std::shared_ptr<SchedulerImpl> scheduler =
+      std::make_shared<SchedulerImpl>(backend, SchedulerImpl::Config{});
+  testing::NiceMock<HostMock> host;
+  PeerId client_peer = testutil::randomPeerId();
+  PeerId server_peer = testutil::randomPeerId();
+  std::shared_ptr<MemoryConnection> client_conn, server_conn;
+  std::shared_ptr<RequestResponse> server, client;
+  bool auto_respond = true;
+  std::vector<std::string> requests;
+  std::vector<RequestResponse::Respond> responds;
+  std::vector<std::string> responses;
+};
+
+/**
+ * @given client which does not reuse streams
+ * @when it sends two requests one after another
+ * @then server responds both, over two streams
+ */
+TEST_F(RequestResponseTest, RequestPerStream) {
+  makeClient({.reuse_streams = false});
+  EXPECT_CALL(host, newStream(_, _, _)).Times(2);
+  request("a");
+  run();
+  request("b");
+  run();
+  EXPECT_EQ(requests, (std::vector<std::string>{"a", "b"}));
+  EXPECT_EQ(responses, (std::vector<std::string>{"re:a", "re:b"}));
+}
+
+/**
+ * @given client which reuses streams
+ * @when it sends two requests one after another
+ * @then both are sent over one stream
+ */
+TEST_F(RequestResponseTest, ReuseStream) {
+  makeClient({.reuse_streams = true});
+  EXPECT_CALL(host, newStream(_, _, _)).Times(1);
+  request("a");
+  run();
+  request("b");
+  run();
+  EXPECT_EQ(responses, (std::vector<std::string>{"re:a", "re:b"}));
+}
+
+/**
+ * @given client which deduplicates requests
+ * @when same request is sent twice while first one is in flight
+ * @then server gets it once, and both callbacks get response
+ */
+TEST_F(RequestResponseTest, Deduplicate) {
+  makeClient({.deduplicate = true});
+  request("a");
+  request("a");
+  request("b");
+  run();
+  EXPECT_EQ(requests, (std::vector<std::string>{"a", "b"}));
+  EXPECT_EQ(responses, (std::vector<std::string>{"re:a", "re:a", "re:b"}));
+}
+
+/**
+ * @given client with one outstanding and one queued request per peer
+ * @when three requests are sent
+ * @then second waits for first response, third is rejected
+ */
+TEST_F(RequestResponseTest, OutstandingLimit) {
+  makeClient({.max_outstanding = 1, .max_queued = 1});
+  auto_respond = false;
+  request("a");
+  request("b");
+  request("c");
+  run();
+  EXPECT_EQ(requests, (std::vector<std::string>{"a"}));
+  EXPECT_EQ(responses.size(), 1);
+  EXPECT_TRUE(responses.at(0).starts_with("error:"));
+
+  reply(0);
+  run();
+  EXPECT_EQ(requests, (std::vector<std::string>{"a", "b"}));
+  reply(1);
+  run();
+  EXPECT_EQ(responses.size(), 3);
+  EXPECT_EQ(responses.at(1), "re:a");
+  EXPECT_EQ(responses.at(2), "re:b");
+}
+
+/**
+ * @given server which does not respond
+ * @when timeout passes
+ * @then request fails with timeout
+ */
+TEST_F(RequestResponseTest, Timeout) {
+  makeClient({.timeout = std::chrono::seconds{1}});
+  auto_respond = false;
+  request("a");
+  run();
+  EXPECT_TRUE(responses.empty());
+  backend->shift(std::chrono::seconds{1});
+  run();
+  EXPECT_EQ(responses,
+            (std::vector{"error:"
+                         + make_error_code(RequestResponseError::TIMEOUT)
+                               .message()}));
+}
@@ -0,0 +1,141 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/protocol_muxer/multiselect/lazy_connection.hpp>
+
+#include <gtest/gtest.h>
+
+#include <libp2p/protocol_muxer/multiselect/serializing.hpp>
+#include <libp2p/protocol_muxer/protocol_muxer.hpp>
+#include "mock/libp2p/connection/layer_connection_mock.hpp"
+
+using namespace libp2p;
+using namespace protocol_muxer::multiselect;
+using connection::LayerConnectionMock;
+using protocol_muxer::ProtocolMuxer;
+using ::testing::_;
+using ::testing::NiceMock;
+using ::testing::Return;
+
+struct LazyConnectionTest : public ::testing::Test {
+  void SetUp() override {
+    ON_CALL(*connection, writeSome(_, _, _))
+        .WillByDefault([this](BytesIn in, size_t bytes, auto cb) {
+          ++writes;
+          written.insert(written.end(), in.begin(), in.begin() + bytes);
+          cb(bytes);
+        });
+    ON_CALL(*connection, read(_, _, _))
+        .WillByDefault([this](BytesOut out, size_t, auto cb) {
+          pending_read = {out, std::move(cb)};
+          deliver();
+        });
+    ON_CALL(*connection, deferReadCallback(_, _))
+        .WillByDefault([](outcome::result<size_t> res, auto cb) { cb(res); });
+    ON_CALL(*connection, deferWriteCallback(_, _))
+        .WillByDefault([](std::error_code ec, auto cb) { cb(ec); });
+    lazy = LazyConnection::create(connection, std::string{kProtocol}).value();
+  }
+
+  /// Message as multiselect serializes it
+  static Bytes message(std::string_view protocol) {
+    auto msg = detail::createMessage(protocol).value();
+    return {msg.begin(), msg.end()};
+  }
+
+  static Bytes proposal() {
+    auto bytes = message(kProtocolId);
+    auto protocol = message(kProtocol);
+    bytes.insert(bytes.end(), protocol.begin(), protocol.end());
+    return bytes;
+  }
+
+  /// Remote side sends bytes
+  void respond(BytesIn bytes) {
+    incoming.insert(incoming.end(), bytes.begin(), bytes.end());
+    deliver();
+  }
+
+  void deliver() {
+    auto [out, cb] = pending_read;
+    if (not cb or incoming.size() < out.size()) {
+      return;
+    }
+    pending_read = {};
+    std::copy_n(incoming.begin(), out.size(), out.begin());
+    incoming.erase(incoming.begin(), incoming.begin() + out.size());
+    cb(out.size());
+  }
+
+  static constexpr std::string_view kProtocol = "/noise";
+
+  std::shared_ptr<NiceMock<LayerConnectionMock>> connection =
+      std::make_shared<NiceMock<LayerConnectionMock>>();
+  std::shared_ptr<LazyConnection> lazy;
+  Bytes written;
+  size_t writes = 0;
+  Bytes incoming;
+  std::pair<BytesOut, basic::Reader::ReadCallbackFunc> pending_read;
+};
+
+/**
+ * @given lazy connection
+ * @when the first handshake message is written before any reply from peer
+ * @then multistream header, proposal and handshake message are written at
+ * once, and handshake reads reply following the echoed proposal
+ */
+TEST_F(LazyConnectionTest, HandshakeInOneFlight) {
+  Bytes handshake{0, 2, 1, 2};
+  boost::optional<outcome::result<size_t>> write_res;
+  lazy->writeSome(
+      handshake, handshake.size(), [&](auto res) { write_res = res; });
+  ASSERT_TRUE(write_res);
+  ASSERT_EQ(write_res->value(), handshake.size());
+  auto expected = proposal();
+  expected.insert(expected.end(), handshake.begin(), handshake.end());
+  ASSERT_EQ(written, expected);
+  ASSERT_EQ(writes, 1);
+
+  Bytes response(2);
+  boost::optional<outcome::result<size_t>> read_res;
+  lazy->read(response, response.size(), [&](auto res) { read_res = res; });
+  ASSERT_FALSE(read_res);
+
+  auto reply = proposal();
+  reply.insert(reply.end(), {7, 8});
+  respond(reply);
+  ASSERT_TRUE(read_res);
+  ASSERT_EQ(read_res->value(), 2);
+  ASSERT_EQ(response, (Bytes{7, 8}));
+}
+
+/**
+ * @given lazy connection with the first handshake message written
+ * @when peer replies "na"
+ * @then handshake read fails without waiting for more bytes, connection is
+ * closed and further writes fail
+ */
+TEST_F(LazyConnectionTest, NotAccepted) {
+  Bytes handshake{0, 2, 1, 2};
+  lazy->writeSome(handshake, handshake.size(), [](auto) {});
+
+  EXPECT_CALL(*connection, close()).WillOnce(Return(outcome::success()));
+  Bytes response(2);
+  boost::optional<outcome::result<size_t>> read_res;
+  lazy->read(response, response.size(), [&](auto res) { read_res = res; });
+  auto reply = message(kProtocolId);
+  auto na = message(kNA);
+  reply.insert(reply.end(), na.begin(), na.end());
+  respond(reply);
+  ASSERT_TRUE(read_res);
+  ASSERT_EQ(read_res->error(), ProtocolMuxer::Error::NEGOTIATION_FAILED);
+
+  boost::optional<outcome::result<size_t>> write_res;
+  lazy->writeSome(
+      handshake, handshake.size(), [&](auto res) { write_res = res; });
+  ASSERT_TRUE(write_res);
+  ASSERT_EQ(write_res->error(), ProtocolMuxer::Error::NEGOTIATION_FAILED);
+}
@@ -0,0 +1,158 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/protocol_muxer/multiselect/lazy_stream.hpp>
+
+#include <gtest/gtest.h>
+
+#include <libp2p/protocol_muxer/multiselect/serializing.hpp>
+#include "mock/libp2p/connection/stream_mock.hpp"
+
+using namespace libp2p;
+using namespace protocol_muxer::multiselect;
+using connection::StreamMock;
+using protocol_muxer::ProtocolMuxer;
+using ::testing::_;
+using ::testing::NiceMock;
+
+struct LazyStreamTest : public ::testing::Test {
+  void SetUp() override {
+    ON_CALL(*stream, writeSome(_, _, _))
+        .WillByDefault([this](BytesIn in, size_t bytes, auto cb) {
+          written.insert(written.end(), in.begin(), in.begin() + bytes);
+          cb(bytes);
+        });
+    ON_CALL(*stream, read(_, _, _))
+        .WillByDefault([this](BytesOut out, size_t, auto cb) {
+          pending_read = {out, std::move(cb)};
+          deliver();
+        });
+    ON_CALL(*stream, deferReadCallback(_, _))
+        .WillByDefault([](outcome::result<size_t> res, auto cb) { cb(res); });
+    ON_CALL(*stream, deferWriteCallback(_, _))
+        .WillByDefault([](std::error_code ec, auto cb) { cb(ec); });
+    lazy = LazyStream::create(stream, std::string{kProtocol}).value();
+  }
+
+  /// Message as multiselect serializes it
+  static Bytes message(std::string_view protocol) {
+    auto msg = detail::createMessage(protocol).value();
+    return {msg.begin(), msg.end()};
+  }
+
+  static Bytes proposal() {
+    auto bytes = message(kProtocolId);
+    auto protocol = message(kProtocol);
+    bytes.insert(bytes.end(), protocol.begin(), protocol.end());
+    return bytes;
+  }
+
+  /// Remote side sends bytes
+  void respond(BytesIn bytes) {
+    incoming.insert(incoming.end(), bytes.begin(), bytes.end());
+    deliver();
+  }
+
+  void deliver() {
+    auto [out, cb] = pending_read;
+    if (not cb or incoming.size() < out.size()) {
+      return;
+    }
+    pending_read = {};
+    std::copy_n(incoming.begin(), out.size(), out.begin());
+    incoming.erase(incoming.begin(), incoming.begin() + out.size());
+    cb(out.size());
+  }
+
+  static constexpr std::string_view kProtocol = "/test/1.0.0";
+
+  std::shared_ptr<NiceMock<StreamMock>> stream =
+      std::make_shared<NiceMock<StreamMock>>();
+  std::shared_ptr<LazyStream> lazy;
+  Bytes written;
+  Bytes incoming;
+  std::pair<BytesOut, basic::Reader::ReadCallbackFunc> pending_read;
+};
+
+/**
+ * @given lazy stream
+ * @when application writes before any reply from peer
+ * @then proposal and application data are written at once, and application
+ * reads data following the echoed proposal
+ */
+TEST_F(LazyStreamTest, WriteBeforeReply) {
+  Bytes request{1, 2, 3};
+  boost::optional<outcome::result<size_t>> write_res;
+  lazy->writeSome(request, request.size(), [&](auto res) { write_res = res; });
+  ASSERT_TRUE(write_res);
+  ASSERT_EQ(write_res->value(), request.size());
+  auto expected = proposal();
+  expected.insert(expected.end(), request.begin(), request.end());
+  ASSERT_EQ(written, expected);
+
+  Bytes response(2);
+  boost::optional<outcome::result<size_t>> read_res;
+  lazy->read(response, response.size(), [&](auto res) { read_res = res; });
+  ASSERT_FALSE(read_res);
+
+  auto reply = proposal();
+  reply.insert(reply.end(), {7, 8});
+  respond(reply);
+  ASSERT_TRUE(read_res);
+  ASSERT_EQ(read_res->value(), 2);
+  ASSERT_EQ(response, (Bytes{7, 8}));
+}
+
+/**
+ * @given lazy stream with application data written
+ * @when peer replies "na"
+ * @then the first read fails without waiting for more bytes, stream is reset
+ * and further writes fail
+ */
+TEST_F(LazyStreamTest, NotAccepted) {
+  Bytes request{1, 2, 3};
+  lazy->writeSome(request, request.size(), [](auto) {});
+
+  EXPECT_CALL(*stream, reset());
+  Bytes response(2);
+  boost::optional<outcome::result<size_t>> read_res;
+  lazy->read(response, response.size(), [&](auto res) { read_res = res; });
+  auto reply = message(kProtocolId);
+  auto na = message(kNA);
+  reply.insert(reply.end(), na.begin(), na.end());
+  respond(reply);
+  ASSERT_TRUE(read_res);
+  ASSERT_EQ(read_res->error(), ProtocolMuxer::Error::NEGOTIATION_FAILED);
+
+  boost::optional<outcome::result<size_t>> write_res;
+  lazy->writeSome(request, request.size(), [&](auto res) { write_res = res; });
+  ASSERT_TRUE(write_res);
+  ASSERT_EQ(write_res->error(), ProtocolMuxer::Error::NEGOTIATION_FAILED);
+}
+
+/**
+ * @given lazy stream
+ * @when application reads before writing
+ * @then proposal is sent alone, and application gets data after reply
+ */
+TEST_F(LazyStreamTest, ReadBeforeWrite) {
+  Bytes response(1);
+  boost::optional<outcome::result<size_t>> read_res;
+  lazy->read(response, response.size(), [&](auto res) { read_res = res; });
+  ASSERT_EQ(written, proposal());
+
+  auto reply = proposal();
+  reply.push_back(9);
+  respond(reply);
+  ASSERT_TRUE(read_res);
+  ASSERT_EQ(response, Bytes{9});
+
+  Bytes request{1};
+  lazy->writeSome(request, request.size(), [](auto) {});
+  auto expected = proposal();
+  expected.push_back(1);
+  ASSERT_EQ(written, expected);
+}
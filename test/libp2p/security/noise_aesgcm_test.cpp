@@ -0,0 +1,62 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/security/noise/crypto/noise_aesgcm.hpp>
+
+#include <gtest/gtest.h>
+#include <libp2p/common/literals.hpp>
+#include <qtils/test/outcome.hpp>
+
+using libp2p::Bytes;
+using libp2p::BytesIn;
+using libp2p::BytesOut;
+using libp2p::common::operator""_unhex;
+using libp2p::security::noise::Key32;
+using libp2p::security::noise::NamedAESGCMImpl;
+
+/**
+ * @given zero key and zero counter, which is all zero nonce of noise spec
+ * @when 16 zero bytes are encrypted
+ * @then ciphertext and tag are of GCM spec test case 14
+ */
+TEST(NoiseAESGCMTest, SpecVector) {
+  auto cipher = NamedAESGCMImpl{}.cipher(Key32{});
+  ASSERT_OUTCOME_SUCCESS(enc, cipher->encrypt({}, 0, Bytes(16), {}));
+  EXPECT_EQ(enc,
+            "cea7403d4d606b6e074ec5d3baf39d18"
+            "d0d1c8a799996bf0265b98b5d48ab919"_unhex);
+}
+
+/**
+ * @given cipher of random key
+ * @when message is encrypted in place with counter and associated data
+ * @then it decrypts with the same counter only and tampering is detected
+ */
+TEST(NoiseAESGCMTest, RoundTrip) {
+  Key32 key{};
+  for (size_t i = 0; i < key.size(); ++i) {
+    key[i] = static_cast<uint8_t>(i * 7);
+  }
+  auto cipher = NamedAESGCMImpl{}.cipher(key);
+  Bytes aad{1, 2, 3};
+  Bytes plaintext(100, 0x42);
+  Bytes buffer = plaintext;
+  buffer.resize(plaintext.size() + 16);
+  constexpr uint64_t kNonce = 0x0102030405060708;
+  ASSERT_OUTCOME_SUCCESS(
+      size,
+      cipher->encryptInto(
+          kNonce, BytesIn{buffer}.first(plaintext.size()), aad, buffer));
+  ASSERT_EQ(size, buffer.size());
+
+  auto other = NamedAESGCMImpl{}.cipher(key);
+  EXPECT_OUTCOME_ERROR(other->decrypt({}, kNonce + 1, buffer, aad));
+  ASSERT_OUTCOME_SUCCESS(dec, other->decrypt({}, kNonce, buffer, aad));
+  EXPECT_EQ(dec, plaintext);
+
+  buffer[5] ^= 1;
+  EXPECT_OUTCOME_ERROR(other->decrypt({}, kNonce, buffer, aad));
+}
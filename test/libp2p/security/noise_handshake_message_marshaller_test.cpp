@@ -0,0 +1,109 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <generated/security/noise/protobuf/noise.pb.h>
+#include <gtest/gtest.h>
+#include <libp2p/security/noise/handshake_message_marshaller_impl.hpp>
+#include <qtils/test/outcome.hpp>
+#include "mock/libp2p/crypto/key_marshaller_mock.hpp"
+
+using libp2p::Bytes;
+using libp2p::crypto::Key;
+using libp2p::crypto::ProtobufKey;
+using libp2p::crypto::PublicKey;
+using libp2p::crypto::marshaller::KeyMarshallerMock;
+using libp2p::security::noise::HandshakeMessage;
+using libp2p::security::noise::HandshakeMessageMarshallerImpl;
+using libp2p::security::noise::protobuf::NoiseHandshakePayload;
+using testing::_;
+using testing::Return;
+
+class NoiseHandshakeMessageMarshallerTest : public testing::Test {
+ public:
+  std::shared_ptr<KeyMarshallerMock> key_marshaller =
+      std::make_shared<KeyMarshallerMock>();
+  PublicKey pk{{Key::Type::Ed25519, Bytes(32, 1)}};
+  ProtobufKey proto_key{Bytes(200, 2)};
+  HandshakeMessage msg{.identity_key = pk,
+                       .identity_sig = Bytes(64, 3),
+                       .data = {},
+                       .stream_muxers = {"/yamux/1.0.0", "/mplex/6.7.0"}};
+};
+
+/**
+ * @given handshake message
+ * @when it is marshalled
+ * @then bytes are the same protobuf serializes, and unmarshal back
+ */
+TEST_F(NoiseHandshakeMessageMarshallerTest, SameAsProtobuf) {
+  HandshakeMessageMarshallerImpl marshaller{key_marshaller};
+  EXPECT_CALL(*key_marshaller, marshal(pk)).WillOnce(Return(proto_key));
+  EXPECT_CALL(*key_marshaller, unmarshalPublicKey(proto_key))
+      .WillOnce(Return(pk));
+
+  NoiseHandshakePayload proto_msg;
+  proto_msg.set_identity_key(proto_key.key.data(), proto_key.key.size());
+  proto_msg.set_identity_sig(msg.identity_sig.data(), msg.identity_sig.size());
+  for (const auto &muxer : msg.stream_muxers) {
+    proto_msg.mutable_extensions()->add_stream_muxers(muxer);
+  }
+  Bytes expected(proto_msg.ByteSizeLong());
+  proto_msg.SerializeToArray(expected.data(), expected.size());
+
+  ASSERT_OUTCOME_SUCCESS(bytes, marshaller.marshal(msg));
+  EXPECT_EQ(bytes, expected);
+  ASSERT_OUTCOME_SUCCESS(decoded, marshaller.unmarshal(bytes));
+  EXPECT_EQ(decoded.first.identity_key, pk);
+  EXPECT_EQ(decoded.first.identity_sig, msg.identity_sig);
+  EXPECT_EQ(decoded.first.data, msg.data);
+  EXPECT_EQ(decoded.first.stream_muxers, msg.stream_muxers);
+  EXPECT_EQ(decoded.second, proto_key);
+}
+
+/**
+ * @given marshaller with cached local key
+ * @when message with local key is marshalled
+ * @then key marshaller is not called
+ */
+TEST_F(NoiseHandshakeMessageMarshallerTest, CachedLocalKey) {
+  HandshakeMessageMarshallerImpl marshaller{
+      key_marshaller,
+      std::make_shared<const HandshakeMessageMarshallerImpl::LocalKey>(
+          HandshakeMessageMarshallerImpl::LocalKey{pk, proto_key})};
+  EXPECT_CALL(*key_marshaller, marshal(testing::An<const PublicKey &>()))
+      .Times(0);
+  ASSERT_OUTCOME_SUCCESS(bytes, marshaller.marshal(msg));
+  NoiseHandshakePayload proto_msg;
+  ASSERT_TRUE(proto_msg.ParseFromArray(bytes.data(), bytes.size()));
+  EXPECT_EQ(proto_msg.identity_key().size(), proto_key.key.size());
+}
+
+/**
+ * @given bytes with unknown fields and truncated bytes
+ * @when they are unmarshalled
+ * @then unknown fields are skipped, truncated message is an error
+ */
+TEST_F(NoiseHandshakeMessageMarshallerTest, UnknownAndTruncated) {
+  HandshakeMessageMarshallerImpl marshaller{key_marshaller};
+  EXPECT_CALL(*key_marshaller, unmarshalPublicKey(proto_key))
+      .WillOnce(Return(pk));
+
+  NoiseHandshakePayload proto_msg;
+  proto_msg.set_identity_key(proto_key.key.data(), proto_key.key.size());
+  proto_msg.set_data("data");
+  Bytes bytes(proto_msg.ByteSizeLong());
+  proto_msg.SerializeToArray(bytes.data(), bytes.size());
+  // field 15 varint and field 16 fixed32
+  Bytes unknown{0x78, 0x96, 0x01, 0x85, 0x01, 1, 2, 3, 4};
+  bytes.insert(bytes.begin(), unknown.begin(), unknown.end());
+
+  ASSERT_OUTCOME_SUCCESS(decoded, marshaller.unmarshal(bytes));
+  EXPECT_EQ(decoded.first.data, (Bytes{'d', 'a', 't', 'a'}));
+  EXPECT_TRUE(decoded.first.stream_muxers.empty());
+
+  bytes.pop_back();
+  EXPECT_OUTCOME_ERROR(marshaller.unmarshal(bytes));
+}
@@ -0,0 +1,70 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/security/noise/crypto/key_pool.hpp>
+
+#include <set>
+#include <thread>
+
+#include <gtest/gtest.h>
+#include <libp2p/basic/scheduler/manual_scheduler_backend.hpp>
+#include <libp2p/basic/scheduler/scheduler_impl.hpp>
+#include <libp2p/security/noise/crypto/noise_dh.hpp>
+#include <qtils/test/outcome.hpp>
+
+using libp2p::Bytes;
+using libp2p::basic::ManualSchedulerBackend;
+using libp2p::basic::SchedulerImpl;
+using libp2p::security::noise::KeyPool;
+using libp2p::security::noise::NoiseDiffieHellmanImpl;
+
+constexpr size_t kCapacity = 4;
+
+/**
+ * @given key pool refilled on the scheduler
+ * @when more keys are taken than the pool holds
+ * @then every key is distinct and the pool fills up again
+ */
+TEST(NoiseKeyPoolTest, SchedulerRefill) {
+  auto backend = std::make_shared<ManualSchedulerBackend>();
+  auto scheduler =
+      std::make_shared<SchedulerImpl>(backend, SchedulerImpl::Config{});
+  auto pool = std::make_shared<KeyPool>(
+      std::make_shared<NoiseDiffieHellmanImpl>(), kCapacity, scheduler);
+  pool->start();
+  backend->shift(std::chrono::milliseconds{0});
+  ASSERT_EQ(pool->size(), kCapacity);
+
+  std::set<Bytes> keys;
+  for (size_t i = 0; i < 2 * kCapacity; ++i) {
+    ASSERT_OUTCOME_SUCCESS(key, pool->take());
+    ASSERT_TRUE(keys.insert(key.priv).second);
+  }
+  ASSERT_EQ(pool->size(), 0);
+  backend->shift(std::chrono::milliseconds{0});
+  ASSERT_EQ(pool->size(), kCapacity);
+}
+
+/**
+ * @given key pool refilled on its own thread
+ * @when keys are taken
+ * @then every key is distinct and the pool fills up again
+ */
+TEST(NoiseKeyPoolTest, ThreadRefill) {
+  auto pool = std::make_shared<KeyPool>(
+      std::make_shared<NoiseDiffieHellmanImpl>(), kCapacity, nullptr);
+  pool->start();
+
+  std::set<Bytes> keys;
+  for (size_t i = 0; i < 2 * kCapacity; ++i) {
+    ASSERT_OUTCOME_SUCCESS(key, pool->take());
+    ASSERT_TRUE(keys.insert(key.priv).second);
+  }
+  for (size_t i = 0; i < 1000 and pool->size() != kCapacity; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds{1});
+  }
+  ASSERT_EQ(pool->size(), kCapacity);
+}
@@ -0,0 +1,87 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/security/noise/insecure_rw.hpp>
+
+#include <gtest/gtest.h>
+#include <libp2p/security/noise/crypto/state.hpp>
+
+#include "mock/libp2p/connection/layer_connection_mock.hpp"
+
+using libp2p::Bytes;
+using libp2p::BytesIn;
+using libp2p::BytesOut;
+using libp2p::connection::LayerConnectionMock;
+using libp2p::security::noise::InsecureReadWriter;
+using libp2p::security::noise::kMaxMsgLen;
+using testing::_;
+using testing::Invoke;
+
+namespace {
+  Bytes frame(size_t size, uint8_t fill) {
+    Bytes bytes(2 + size, fill);
+    bytes[0] = static_cast<uint8_t>(size >> 8u);
+    bytes[1] = static_cast<uint8_t>(size & 0xffu);
+    return bytes;
+  }
+}  // namespace
+
+/**
+ * @given stream of noise messages larger than read-ahead buffer
+ * @when messages are read with readFrame() and takeFrame()
+ * @then all messages are returned in order by one read per buffer fill,
+ * message split between reads is moved to the front of buffer
+ */
+TEST(NoiseReadAheadTest, FramesOfBuffer) {
+  std::vector<Bytes> frames{frame(5, 1), frame(65000, 2), frame(65000, 3)};
+  Bytes stream;
+  for (auto &f : frames) {
+    stream.insert(stream.end(), f.begin(), f.end());
+  }
+  size_t position = 0;
+  size_t reads = 0;
+  auto connection = std::make_shared<LayerConnectionMock>();
+  EXPECT_CALL(*connection, readSome(_, _, _))
+      .WillRepeatedly(Invoke([&](BytesOut out, size_t bytes, auto cb) {
+        ++reads;
+        auto n = std::min(bytes, stream.size() - position);
+        std::copy_n(stream.begin() + static_cast<ptrdiff_t>(position),
+                    n,
+                    out.begin());
+        position += n;
+        cb(n);
+      }));
+  // rounded up to the largest message
+  auto framer = std::make_shared<InsecureReadWriter>(
+      connection, std::make_shared<Bytes>(), 1);
+  ASSERT_EQ(framer->readAheadCapacity(), 2 + kMaxMsgLen);
+
+  std::vector<Bytes> received;
+  auto read = [&] {
+    framer->readFrame([&](outcome::result<BytesOut> r) {
+      ASSERT_TRUE(r);
+      received.emplace_back(r.value().begin(), r.value().end());
+    });
+    while (auto f = framer->takeFrame()) {
+      received.emplace_back(f->begin(), f->end());
+    }
+  };
+  read();
+  ASSERT_EQ(reads, 1);
+  ASSERT_EQ(received.size(), 2);
+  read();
+  ASSERT_EQ(reads, 2);
+  ASSERT_EQ(received.size(), 3);
+  ASSERT_EQ(position, stream.size());
+  for (size_t i = 0; i < frames.size(); ++i) {
+    ASSERT_EQ(received[i], Bytes(frames[i].begin() + 2, frames[i].end()));
+  }
+  ASSERT_FALSE(framer->takeFrame());
+
+  // closed connection
+  framer->readFrame(
+      [](outcome::result<BytesOut> r) { ASSERT_FALSE(r); });
+}
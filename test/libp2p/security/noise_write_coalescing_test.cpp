@@ -0,0 +1,149 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/security/noise/noise_connection.hpp>
+
+#include <gtest/gtest.h>
+#include <libp2p/basic/scheduler/manual_scheduler_backend.hpp>
+#include <libp2p/basic/scheduler/scheduler_impl.hpp>
+#include <libp2p/security/noise/crypto/cipher_suite.hpp>
+#include <libp2p/security/noise/crypto/noise_aesgcm.hpp>
+#include <libp2p/security/noise/crypto/noise_dh.hpp>
+#include <libp2p/security/noise/crypto/noise_sha256.hpp>
+
+#include "mock/libp2p/connection/layer_connection_mock.hpp"
+#include "mock/libp2p/crypto/key_marshaller_mock.hpp"
+
+using namespace libp2p;
+using connection::LayerConnectionMock;
+using connection::NoiseConnection;
+using crypto::marshaller::KeyMarshallerMock;
+using security::noise::kMaxPlainText;
+using testing::_;
+using testing::An;
+using testing::Invoke;
+using testing::Return;
+
+struct NoiseWriteCoalescingTest : public ::testing::Test {
+  void SetUp() override {
+    EXPECT_CALL(*marshaller, marshal(An<const crypto::PublicKey &>()))
+        .WillRepeatedly(Return(make_error_code(std::errc::invalid_argument)));
+    EXPECT_CALL(*layer, deferReadCallback(_, _))
+        .WillRepeatedly(Invoke([](auto res, auto cb) { cb(res); }));
+    EXPECT_CALL(*layer, deferWriteCallback(_, _))
+        .WillRepeatedly(Invoke([](auto ec, auto cb) { cb(ec); }));
+    EXPECT_CALL(*layer, writeSome(_, _, _))
+        .WillRepeatedly(Invoke([this](BytesIn in, size_t, auto cb) {
+          frames.emplace_back(in.size(), std::move(cb));
+        }));
+    EXPECT_CALL(*layer, close()).WillRepeatedly(Invoke([this] {
+      ++closed;
+      return outcome::success();
+    }));
+    auto suite = std::make_shared<security::noise::CipherSuiteImpl>(
+        std::make_shared<security::noise::NoiseDiffieHellmanImpl>(),
+        std::make_shared<security::noise::NoiseSHA256HasherImpl>(),
+        std::make_shared<security::noise::NamedAESGCMImpl>());
+    security::noise::Key32 key{};
+    connection = std::make_shared<NoiseConnection>(
+        layer,
+        crypto::PublicKey{},
+        crypto::PublicKey{},
+        marshaller,
+        std::make_shared<security::noise::CipherState>(suite, key),
+        std::make_shared<security::noise::CipherState>(suite, key),
+        scheduler,
+        security::NoiseConfig{
+            .write_coalescing_delay = std::chrono::milliseconds{10},
+        },
+        boost::none);
+  }
+
+  /// Writes bytes to noise connection, returns completion result
+  std::optional<outcome::result<size_t>> write(size_t size) {
+    std::optional<outcome::result<size_t>> result;
+    Bytes bytes(size, 1);
+    connection->writeSome(
+        bytes, bytes.size(), [&](outcome::result<size_t> r) { result = r; });
+    return result;
+  }
+
+  /// Completes write of frame to underlying connection
+  void complete(size_t i) {
+    auto &[size, cb] = frames.at(i);
+    cb(size);
+  }
+
+  std::shared_ptr<LayerConnectionMock> layer =
+      std::make_shared<LayerConnectionMock>();
+  std::shared_ptr<KeyMarshallerMock> marshaller =
+      std::make_shared<KeyMarshallerMock>();
+  std::shared_ptr<basic::ManualSchedulerBackend> backend =
+      std::make_shared<basic::ManualSchedulerBackend>();
+  std::shared_ptr<basic::SchedulerImpl> scheduler =
+      std::make_shared<basic::SchedulerImpl>(backend,
+                                             basic::Scheduler::Config{});
+  std::shared_ptr<NoiseConnection> connection;
+  std::vector<std::pair<size_t, basic::Writer::WriteCallbackFunc>> frames;
+  size_t closed = 0;
+};
+
+/**
+ * @given noise connection with completed coalesced writes not sent yet
+ * @when connection is closed
+ * @then coalesced bytes are sent as one message, underlying connection is
+ * closed after that message is written, and following writes fail
+ */
+TEST_F(NoiseWriteCoalescingTest, CloseFlushes) {
+  ASSERT_EQ(write(3), outcome::result<size_t>{3});
+  ASSERT_EQ(write(4), outcome::result<size_t>{4});
+  EXPECT_TRUE(frames.empty());
+
+  ASSERT_TRUE(connection->close());
+  EXPECT_EQ(closed, 0);
+  EXPECT_TRUE(connection->isClosed());
+  ASSERT_EQ(frames.size(), 1);
+  EXPECT_EQ(frames[0].first,
+            security::noise::kLengthPrefixSize + 7 + security::noise::kTagSize);
+  auto after_close = write(1);
+  ASSERT_TRUE(after_close);
+  EXPECT_TRUE(after_close->has_error());
+
+  complete(0);
+  EXPECT_EQ(closed, 1);
+  // flush timer was cancelled by close
+  backend->shift(std::chrono::milliseconds{10});
+  EXPECT_EQ(frames.size(), 1);
+}
+
+/**
+ * @given noise connection with full message being sent, next full message
+ * waiting for it, and write blocked until buffer is free
+ * @when connection is closed
+ * @then blocked write fails, since its bytes were not taken, waiting message
+ * is sent, and underlying connection is closed once it is written
+ */
+TEST_F(NoiseWriteCoalescingTest, CloseFailsBlockedWrite) {
+  ASSERT_EQ(write(kMaxPlainText), outcome::result<size_t>{kMaxPlainText});
+  ASSERT_EQ(frames.size(), 1);
+  ASSERT_EQ(write(kMaxPlainText), outcome::result<size_t>{kMaxPlainText});
+  std::optional<outcome::result<size_t>> blocked_result;
+  Bytes bytes(5, 1);
+  connection->writeSome(bytes, bytes.size(), [&](outcome::result<size_t> r) {
+    blocked_result = r;
+  });
+  EXPECT_FALSE(blocked_result);
+
+  ASSERT_TRUE(connection->close());
+  ASSERT_TRUE(blocked_result);
+  EXPECT_TRUE(blocked_result->has_error());
+
+  complete(0);
+  ASSERT_EQ(frames.size(), 2);
+  EXPECT_EQ(closed, 0);
+  complete(1);
+  EXPECT_EQ(closed, 1);
+}
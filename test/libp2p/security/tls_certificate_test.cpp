@@ -0,0 +1,127 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/security/tls/ssl_context.hpp>
+
+#include <optional>
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ssl/context.hpp>
+#include <gtest/gtest.h>
+
+#include <libp2p/crypto/crypto_provider/crypto_provider_impl.hpp>
+#include <libp2p/crypto/ecdsa_provider/ecdsa_provider_impl.hpp>
+#include <libp2p/crypto/ed25519_provider/ed25519_provider_impl.hpp>
+#include <libp2p/crypto/hmac_provider/hmac_provider_impl.hpp>
+#include <libp2p/crypto/key_marshaller/key_marshaller_impl.hpp>
+#include <libp2p/crypto/key_validator/key_validator_impl.hpp>
+#include <libp2p/crypto/random_generator/boost_generator.hpp>
+#include <libp2p/crypto/rsa_provider/rsa_provider_impl.hpp>
+#include <libp2p/crypto/secp256k1_provider/secp256k1_provider_impl.hpp>
+#include <libp2p/peer/impl/identity_manager_impl.hpp>
+#include <libp2p/security/tls/tls_adaptor.hpp>
+#include <libp2p/security/tls/tls_details.hpp>
+
+namespace crypto = libp2p::crypto;
+namespace tls_details = libp2p::security::tls_details;
+
+using libp2p::Bytes;
+using libp2p::security::SslContext;
+using libp2p::security::TlsAdaptor;
+
+struct TlsCertificateTest : public ::testing::Test {
+  /// Host identity with its TLS adaptor
+  struct Host {
+    std::shared_ptr<libp2p::peer::IdentityManager> idmgr;
+    std::optional<SslContext> ssl;
+    std::shared_ptr<TlsAdaptor> adaptor;
+  };
+
+  /// Creates host with its own identity manager and ssl context of keys
+  Host host(const crypto::KeyPair &keys) {
+    Host host;
+    host.idmgr =
+        std::make_shared<libp2p::peer::IdentityManagerImpl>(keys, marshaller);
+    host.ssl.emplace(host.idmgr, marshaller);
+    host.adaptor =
+        std::make_shared<TlsAdaptor>(host.idmgr, io, *host.ssl, marshaller);
+    return host;
+  }
+
+  crypto::KeyPair generateKeys() {
+    return crypto_provider->generateKeys(crypto::Key::Type::Ed25519).value();
+  }
+
+  /// DER of certificate which context presents
+  static Bytes certificate(boost::asio::ssl::context &ctx) {
+    auto *cert = SSL_CTX_get0_certificate(ctx.native_handle());
+    EXPECT_NE(cert, nullptr);
+    if (cert == nullptr) {
+      return {};
+    }
+    Bytes der(i2d_X509(cert, nullptr));
+    auto *out = der.data();
+    i2d_X509(cert, &out);
+    return der;
+  }
+
+  std::shared_ptr<boost::asio::io_context> io =
+      std::make_shared<boost::asio::io_context>();
+  std::shared_ptr<crypto::random::BoostRandomGenerator> random =
+      std::make_shared<crypto::random::BoostRandomGenerator>();
+  std::shared_ptr<crypto::CryptoProvider> crypto_provider =
+      std::make_shared<crypto::CryptoProviderImpl>(
+          random,
+          std::make_shared<crypto::ed25519::Ed25519ProviderImpl>(),
+          std::make_shared<crypto::rsa::RsaProviderImpl>(),
+          std::make_shared<crypto::ecdsa::EcdsaProviderImpl>(),
+          std::make_shared<crypto::secp256k1::Secp256k1ProviderImpl>(random),
+          std::make_shared<crypto::hmac::HmacProviderImpl>());
+  std::shared_ptr<crypto::marshaller::KeyMarshaller> marshaller =
+      std::make_shared<crypto::marshaller::KeyMarshallerImpl>(
+          std::make_shared<crypto::validator::KeyValidatorImpl>(
+              crypto_provider));
+};
+
+/**
+ * @given two hosts with the same identity, each with its own ssl context and
+ * TLS adaptor
+ * @when their contexts are built
+ * @then certificate is generated once, and both TLS and QUIC contexts of both
+ * hosts present it
+ */
+TEST_F(TlsCertificateTest, SameIdentitySharesCertificate) {
+  auto keys = generateKeys();
+  auto first = host(keys);
+  auto second = host(keys);
+
+  auto shared = tls_details::sharedCertificate(keys, *marshaller);
+  EXPECT_EQ(tls_details::sharedCertificate(keys, *marshaller), shared);
+
+  auto der = certificate(*first.ssl->tls());
+  EXPECT_EQ(der, shared->certificate);
+  EXPECT_EQ(certificate(*first.ssl->quic()), der);
+  EXPECT_EQ(certificate(*second.ssl->tls()), der);
+  EXPECT_EQ(certificate(*second.ssl->quic()), der);
+}
+
+/**
+ * @given two hosts with different identities
+ * @when their contexts are built
+ * @then each presents its own certificate
+ */
+TEST_F(TlsCertificateTest, DifferentIdentitiesDontShare) {
+  auto first_keys = generateKeys();
+  auto second_keys = generateKeys();
+  auto first = host(first_keys);
+  auto second = host(second_keys);
+
+  EXPECT_NE(tls_details::sharedCertificate(first_keys, *marshaller),
+            tls_details::sharedCertificate(second_keys, *marshaller));
+  EXPECT_NE(certificate(*first.ssl->tls()), certificate(*second.ssl->tls()));
+  EXPECT_NE(certificate(*first.ssl->quic()),
+            certificate(*second.ssl->quic()));
+}
@@ -0,0 +1,196 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/security/tls/tls_kernel.hpp"
+
+#include <array>
+#include <memory>
+
+#include <gtest/gtest.h>
+#include <openssl/ssl.h>
+#include <openssl/x509.h>
+#include <qtils/unhex.hpp>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using libp2p::Bytes;
+namespace tls_kernel = libp2p::security::tls_kernel;
+
+/**
+ * Traffic secret and its record key and iv, RFC 8448, section 3
+ */
+struct KeyIvVector {
+  std::string_view secret;
+  std::string_view key;
+  std::string_view iv;
+};
+
+/**
+ * @given traffic secrets of TLS_AES_128_GCM_SHA256 from RFC 8448
+ * @when key and iv are derived by HKDF-Expand-Label
+ * @then they equal ones of the RFC
+ */
+TEST(TlsKernel, ExpandLabel) {
+  std::array vectors{
+      // server handshake traffic secret
+      KeyIvVector{
+          "b67b7d690cc16c4e75e54213cb2d37b4e9c912bcded9105d42befd59d391ad38",
+          "3fce516009c21727d0f2e4e86ee403bc",
+          "5d313eb2671276ee13000b30",
+      },
+      // server application traffic secret
+      KeyIvVector{
+          "a11af9f05531f856ad47116b45a950328204b4f44bfb6b3a4b4f1f3fcb631643",
+          "9f02283b6c9c07efc26bb9f2ac92e356",
+          "cf782b88dd83549aadf1e984",
+      },
+  };
+  for (auto &vector : vectors) {
+    auto secret = qtils::unhex(vector.secret).value();
+    Bytes key(16);
+    Bytes iv(12);
+    ASSERT_TRUE(tls_kernel::expandLabel(EVP_sha256(), secret, "key", key));
+    ASSERT_TRUE(tls_kernel::expandLabel(EVP_sha256(), secret, "iv", iv));
+    EXPECT_EQ(key, qtils::unhex(vector.key).value());
+    EXPECT_EQ(iv, qtils::unhex(vector.iv).value());
+  }
+}
+
+/**
+ * TLS 1.3 client and server connected by memory BIO pair, server has self
+ * signed certificate which client doesn't verify
+ */
+struct TlsKernelHandshakeTest : public ::testing::Test {
+  void SetUp() override {
+    std::unique_ptr<EVP_PKEY_CTX, decltype(&EVP_PKEY_CTX_free)> pkey_ctx{
+        EVP_PKEY_CTX_new_id(EVP_PKEY_ED25519, nullptr), EVP_PKEY_CTX_free};
+    EVP_PKEY *pkey = nullptr;
+    ASSERT_EQ(EVP_PKEY_keygen_init(pkey_ctx.get()), 1);
+    ASSERT_EQ(EVP_PKEY_keygen(pkey_ctx.get(), &pkey), 1);
+    key.reset(pkey);
+    cert.reset(X509_new());
+    X509_set_version(cert.get(), X509_VERSION_3);
+    ASN1_INTEGER_set(X509_get_serialNumber(cert.get()), 1);
+    X509_gmtime_adj(X509_getm_notBefore(cert.get()), 0);
+    X509_gmtime_adj(X509_getm_notAfter(cert.get()), 3600);
+    X509_set_pubkey(cert.get(), key.get());
+    ASSERT_NE(X509_sign(cert.get(), key.get(), nullptr), 0);
+
+    for (auto *ctx : {client_ctx.get(), server_ctx.get()}) {
+      SSL_CTX_set_min_proto_version(ctx, TLS1_3_VERSION);
+      SSL_CTX_set_keylog_callback(ctx, &tls_kernel::onKeylog);
+    }
+    ASSERT_EQ(SSL_CTX_use_certificate(server_ctx.get(), cert.get()), 1);
+    ASSERT_EQ(SSL_CTX_use_PrivateKey(server_ctx.get(), key.get()), 1);
+
+    client.reset(SSL_new(client_ctx.get()));
+    server.reset(SSL_new(server_ctx.get()));
+    SSL_set_connect_state(client.get());
+    SSL_set_accept_state(server.get());
+    BIO *client_bio = nullptr;
+    BIO *server_bio = nullptr;
+    ASSERT_EQ(BIO_new_bio_pair(&client_bio, 0, &server_bio, 0), 1);
+    SSL_set_bio(client.get(), client_bio, client_bio);
+    SSL_set_bio(server.get(), server_bio, server_bio);
+  }
+
+  /// Runs both sides until handshake is done
+  bool handshake() {
+    for (int i = 0; i < 10; ++i) {
+      auto c = SSL_do_handshake(client.get());
+      auto s = SSL_do_handshake(server.get());
+      if (c == 1 and s == 1) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /// Writes by SSL of one side and reads by the other one
+  Bytes transfer(SSL *from, SSL *to, const Bytes &data) {
+    EXPECT_EQ(SSL_write(from, data.data(), data.size()), data.size());
+    Bytes out(data.size() + 1);
+    auto n = SSL_read(to, out.data(), out.size());
+    out.resize(n > 0 ? n : 0);
+    return out;
+  }
+
+  std::unique_ptr<EVP_PKEY, decltype(&EVP_PKEY_free)> key{nullptr,
+                                                         EVP_PKEY_free};
+  std::unique_ptr<X509, decltype(&X509_free)> cert{nullptr, X509_free};
+  std::unique_ptr<SSL_CTX, decltype(&SSL_CTX_free)> client_ctx{
+      SSL_CTX_new(TLS_method()), SSL_CTX_free};
+  std::unique_ptr<SSL_CTX, decltype(&SSL_CTX_free)> server_ctx{
+      SSL_CTX_new(TLS_method()), SSL_CTX_free};
+  std::unique_ptr<SSL, decltype(&SSL_free)> client{nullptr, SSL_free};
+  std::unique_ptr<SSL, decltype(&SSL_free)> server{nullptr, SSL_free};
+};
+
+/**
+ * @given client and server, only the client asked for its write secret
+ * @when handshake is done
+ * @then client received secret of size of cipher suite hash, which yields
+ * key and iv
+ */
+TEST_F(TlsKernelHandshakeTest, KeylogKeepsWriteSecret) {
+  Bytes secret;
+  SSL_set_ex_data(client.get(), tls_kernel::secretIndex(), &secret);
+  ASSERT_TRUE(handshake());
+  const auto *md = SSL_CIPHER_get_handshake_digest(
+      SSL_get_current_cipher(client.get()));
+  ASSERT_NE(md, nullptr);
+  ASSERT_EQ(secret.size(), EVP_MD_size(md));
+  Bytes key(16);
+  Bytes iv(12);
+  EXPECT_TRUE(tls_kernel::expandLabel(md, secret, "key", key));
+  EXPECT_TRUE(tls_kernel::expandLabel(md, secret, "iv", iv));
+}
+
+/**
+ * @given connection over socket which doesn't support kernel TLS
+ * @when record encryption is asked to move to kernel
+ * @then it is refused, socket keeps sending plaintext as before, and SSL keeps
+ * encrypting records
+ */
+TEST_F(TlsKernelHandshakeTest, FallbackToSsl) {
+  Bytes secret;
+  SSL_set_ex_data(client.get(), tls_kernel::secretIndex(), &secret);
+  ASSERT_TRUE(handshake());
+  ASSERT_FALSE(secret.empty());
+
+  // unix socket has no tcp ulp
+  std::array<int, 2> fds{};
+  ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, fds.data()), 0);
+  EXPECT_FALSE(tls_kernel::enableTx(client.get(), fds[0], secret));
+  EXPECT_FALSE(tls_kernel::enableTx(client.get(), -1, secret));
+  EXPECT_FALSE(tls_kernel::enableTx(client.get(), fds[0], {}));
+
+  uint8_t byte = 1;
+  ASSERT_EQ(write(fds[0], &byte, 1), 1);
+  byte = 0;
+  ASSERT_EQ(read(fds[1], &byte, 1), 1);
+  EXPECT_EQ(byte, 1);
+  close(fds[0]);
+  close(fds[1]);
+
+  Bytes data{1, 2, 3};
+  EXPECT_EQ(transfer(client.get(), server.get(), data), data);
+  EXPECT_EQ(transfer(server.get(), client.get(), data), data);
+}
+
+/**
+ * @given SSL before handshake
+ * @when record encryption is asked to move to kernel
+ * @then it is refused, as there is no TLS 1.3 cipher yet
+ */
+TEST_F(TlsKernelHandshakeTest, NoHandshakeNoOffload) {
+  std::array<int, 2> fds{};
+  ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, fds.data()), 0);
+  Bytes secret(32, 1);
+  EXPECT_FALSE(tls_kernel::enableTx(client.get(), fds[0], secret));
+  close(fds[0]);
+  close(fds[1]);
+}
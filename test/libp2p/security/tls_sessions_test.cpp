@@ -0,0 +1,341 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/security/tls/tls_adaptor.hpp>
+
+#include "src/security/tls/tls_sessions.hpp"
+
+#include <deque>
+#include <optional>
+#include <vector>
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/ssl/context.hpp>
+#include <gtest/gtest.h>
+
+#include <libp2p/crypto/crypto_provider/crypto_provider_impl.hpp>
+#include <libp2p/crypto/ecdsa_provider/ecdsa_provider_impl.hpp>
+#include <libp2p/crypto/ed25519_provider/ed25519_provider_impl.hpp>
+#include <libp2p/crypto/hmac_provider/hmac_provider_impl.hpp>
+#include <libp2p/crypto/key_marshaller/key_marshaller_impl.hpp>
+#include <libp2p/crypto/key_validator/key_validator_impl.hpp>
+#include <libp2p/crypto/random_generator/boost_generator.hpp>
+#include <libp2p/crypto/rsa_provider/rsa_provider_impl.hpp>
+#include <libp2p/crypto/secp256k1_provider/secp256k1_provider_impl.hpp>
+#include <libp2p/peer/impl/identity_manager_impl.hpp>
+#include <libp2p/security/tls/ssl_context.hpp>
+
+namespace crypto = libp2p::crypto;
+
+using libp2p::Bytes;
+using libp2p::BytesIn;
+using libp2p::BytesOut;
+using libp2p::connection::LayerConnection;
+using libp2p::connection::SecureConnection;
+using libp2p::multi::Multiaddress;
+using libp2p::security::SslContext;
+using libp2p::security::TicketKeys;
+using libp2p::security::TlsAdaptor;
+using libp2p::security::TlsConfig;
+
+/**
+ * One end of in-memory connection, written bytes are read by the other end.
+ * Callbacks are posted to io context.
+ */
+struct PipeConnection : LayerConnection {
+  PipeConnection(std::shared_ptr<boost::asio::io_context> io, bool initiator)
+      : io{std::move(io)}, initiator{initiator} {}
+
+  static std::pair<std::shared_ptr<PipeConnection>,
+                   std::shared_ptr<PipeConnection>>
+  pair(const std::shared_ptr<boost::asio::io_context> &io) {
+    auto a = std::make_shared<PipeConnection>(io, true);
+    auto b = std::make_shared<PipeConnection>(io, false);
+    a->peer = b;
+    b->peer = a;
+    return {a, b};
+  }
+
+  void read(BytesOut out, size_t bytes, ReadCallbackFunc cb) override {
+    readSome(out.first(bytes), bytes, std::move(cb));
+  }
+
+  void readSome(BytesOut out, size_t bytes, ReadCallbackFunc cb) override {
+    read_out = out.first(bytes);
+    read_cb = std::move(cb);
+    deliver();
+  }
+
+  void writeSome(BytesIn in, size_t bytes, WriteCallbackFunc cb) override {
+    auto other = peer.lock();
+    if (closed or not other) {
+      return deferWriteCallback(make_error_code(Error::CONNECTION_NOT_ACTIVE),
+                                std::move(cb));
+    }
+    other->incoming.insert(other->incoming.end(), in.begin(), in.end());
+    other->deliver();
+    boost::asio::post(*io, [cb{std::move(cb)}, bytes] { cb(bytes); });
+  }
+
+  void deferReadCallback(outcome::result<size_t> res,
+                         ReadCallbackFunc cb) override {
+    boost::asio::post(*io, [cb{std::move(cb)}, res] { cb(res); });
+  }
+
+  void deferWriteCallback(std::error_code ec, WriteCallbackFunc cb) override {
+    boost::asio::post(*io, [cb{std::move(cb)}, ec] { cb(ec); });
+  }
+
+  bool isClosed() const override {
+    return closed;
+  }
+
+  outcome::result<void> close() override {
+    closed = true;
+    return outcome::success();
+  }
+
+  bool isInitiator() const override {
+    return initiator;
+  }
+
+  outcome::result<Multiaddress> localMultiaddr() override {
+    return Multiaddress::create("/ip4/127.0.0.1/tcp/1");
+  }
+
+  outcome::result<Multiaddress> remoteMultiaddr() override {
+    return Multiaddress::create("/ip4/127.0.0.1/tcp/2");
+  }
+
+  /// Completes pending read with incoming bytes
+  void deliver() {
+    if (not read_cb or incoming.empty()) {
+      return;
+    }
+    auto n = std::min(read_out.size(), incoming.size());
+    std::copy_n(incoming.begin(), n, read_out.begin());
+    incoming.erase(incoming.begin(), incoming.begin() + n);
+    deferReadCallback(n, std::move(read_cb));
+    read_cb = nullptr;
+  }
+
+  std::shared_ptr<boost::asio::io_context> io;
+  bool initiator;
+  std::weak_ptr<PipeConnection> peer;
+  bool closed = false;
+  std::deque<uint8_t> incoming;
+  BytesOut read_out;
+  ReadCallbackFunc read_cb;
+};
+
+/**
+ * Client and server hosts with their TLS adaptors, connections between them
+ * are in memory
+ */
+struct TlsSessionsTest : public ::testing::Test {
+  struct Side {
+    crypto::KeyPair keys;
+    std::shared_ptr<libp2p::peer::IdentityManager> idmgr;
+    std::optional<SslContext> ssl;
+    std::shared_ptr<TlsAdaptor> adaptor;
+  };
+
+  struct Dial {
+    std::shared_ptr<SecureConnection> client;
+    std::shared_ptr<SecureConnection> server;
+    /// Server resumed the session
+    bool resumed = false;
+  };
+
+  /// Creates both sides with config
+  void init(const TlsConfig &config) {
+    for (auto *side : {&client, &server}) {
+      side->keys =
+          crypto_provider->generateKeys(crypto::Key::Type::Ed25519).value();
+      side->idmgr = std::make_shared<libp2p::peer::IdentityManagerImpl>(
+          side->keys, marshaller);
+      side->ssl.emplace(side->idmgr, marshaller, config);
+      side->adaptor =
+          std::make_shared<TlsAdaptor>(side->idmgr, io, *side->ssl, marshaller);
+    }
+    auto *ctx = serverCtx();
+    SSL_CTX_set_ex_data(ctx, fixtureIndex(), this);
+    SSL_CTX_set_info_callback(ctx, +[](const SSL *ssl, int where, int) {
+      if ((where & SSL_CB_HANDSHAKE_DONE) != 0) {
+        auto *self = static_cast<TlsSessionsTest *>(
+            SSL_CTX_get_ex_data(SSL_get_SSL_CTX(ssl), fixtureIndex()));
+        self->resumed = SSL_session_reused(ssl) == 1;
+      }
+    });
+  }
+
+  static int fixtureIndex() {
+    static const int index =
+        SSL_CTX_get_ex_new_index(0, nullptr, nullptr, nullptr, nullptr);
+    return index;
+  }
+
+  SSL_CTX *serverCtx() {
+    return server.ssl->tls()->native_handle();
+  }
+
+  /**
+   * Client dials server, then server writes a byte which client reads, so
+   * that client receives session tickets sent after handshake.
+   * Connections are kept open till the end of test.
+   */
+  Dial dial() {
+    Dial result;
+    resumed = false;
+    auto [a, b] = PipeConnection::pair(io);
+    client.adaptor->secureOutbound(
+        a, server.idmgr->getId(), [&](auto r) {
+          ASSERT_TRUE(r) << r.error().message();
+          result.client = r.value();
+        });
+    server.adaptor->secureInbound(b, [&](auto r) {
+      ASSERT_TRUE(r) << r.error().message();
+      result.server = r.value();
+    });
+    run();
+    result.resumed = resumed;
+    if (not result.client or not result.server) {
+      ADD_FAILURE() << "handshake not done";
+      return result;
+    }
+
+    Bytes out{1};
+    Bytes in(1);
+    bool written = false;
+    bool read = false;
+    result.server->writeSome(out, out.size(), [&](auto r) {
+      written = r.has_value();
+    });
+    result.client->readSome(in, in.size(), [&](auto r) {
+      read = r.has_value();
+    });
+    run();
+    EXPECT_TRUE(written);
+    EXPECT_TRUE(read);
+    EXPECT_EQ(in, out);
+    dials.push_back(result);
+    return result;
+  }
+
+  void run() {
+    io->restart();
+    io->run();
+  }
+
+  std::shared_ptr<boost::asio::io_context> io =
+      std::make_shared<boost::asio::io_context>();
+  std::shared_ptr<crypto::random::BoostRandomGenerator> random =
+      std::make_shared<crypto::random::BoostRandomGenerator>();
+  std::shared_ptr<crypto::CryptoProvider> crypto_provider =
+      std::make_shared<crypto::CryptoProviderImpl>(
+          random,
+          std::make_shared<crypto::ed25519::Ed25519ProviderImpl>(),
+          std::make_shared<crypto::rsa::RsaProviderImpl>(),
+          std::make_shared<crypto::ecdsa::EcdsaProviderImpl>(),
+          std::make_shared<crypto::secp256k1::Secp256k1ProviderImpl>(random),
+          std::make_shared<crypto::hmac::HmacProviderImpl>());
+  std::shared_ptr<crypto::marshaller::KeyMarshaller> marshaller =
+      std::make_shared<crypto::marshaller::KeyMarshallerImpl>(
+          std::make_shared<crypto::validator::KeyValidatorImpl>(
+              crypto_provider));
+  Side client;
+  Side server;
+  bool resumed = false;
+  std::vector<Dial> dials;
+};
+
+/**
+ * @given client and server with session resumption
+ * @when client dials server again
+ * @then session of first connection is resumed, and remote key and peer of
+ * client connection are the ones verified by first handshake
+ */
+TEST_F(TlsSessionsTest, Resume) {
+  init({});
+  ASSERT_NE(client.ssl->tlsSessions(), nullptr);
+
+  auto first = dial();
+  EXPECT_FALSE(first.resumed);
+  auto second = dial();
+  EXPECT_TRUE(second.resumed);
+  ASSERT_TRUE(second.client);
+  EXPECT_EQ(second.client->remotePublicKey().value(), server.keys.publicKey);
+  EXPECT_EQ(second.client->remotePeer().value(), server.idmgr->getId());
+  EXPECT_EQ(second.server->remotePeer().value(), client.idmgr->getId());
+
+  // renewed ticket is resumed too
+  EXPECT_TRUE(dial().resumed);
+}
+
+/**
+ * @given cached session of server
+ * @when it is taken
+ * @then it is removed from cache, as ticket is single use
+ */
+TEST_F(TlsSessionsTest, TakeRemoves) {
+  init({});
+  auto sessions = client.ssl->tlsSessions();
+  dial();
+  auto session = sessions->take(server.idmgr->getId());
+  ASSERT_TRUE(session);
+  EXPECT_EQ(session->key, server.keys.publicKey);
+  EXPECT_FALSE(sessions->take(server.idmgr->getId()));
+
+  // nothing to resume
+  EXPECT_FALSE(dial().resumed);
+}
+
+/**
+ * @given ticket issued by server
+ * @when ticket key is rotated once
+ * @then ticket is still accepted and renewed with current key, but after
+ * two rotation intervals without renewal it isn't
+ */
+TEST_F(TlsSessionsTest, TicketKeyRotation) {
+  TlsConfig config;
+  config.ticket_key_rotation = std::chrono::hours{1};
+  init(config);
+  auto *keys = TicketKeys::of(serverCtx());
+  ASSERT_NE(keys, nullptr);
+  auto now = TicketKeys::Clock::now();
+
+  dial();
+  keys->rotate(now + std::chrono::hours{1});
+  EXPECT_TRUE(dial().resumed);
+
+  // ticket renewed with key of first rotation
+  keys->rotate(now + std::chrono::hours{2});
+  EXPECT_TRUE(dial().resumed);
+
+  // the last ticket is encrypted with key of second rotation
+  keys->rotate(now + std::chrono::hours{4});
+  EXPECT_FALSE(dial().resumed);
+}
+
+/**
+ * @given client and server with session resumption disabled
+ * @when client dials server again
+ * @then there are neither sessions, nor tickets, and full handshake is done
+ */
+TEST_F(TlsSessionsTest, Disabled) {
+  TlsConfig config;
+  config.session_resumption = false;
+  init(config);
+  EXPECT_EQ(client.ssl->tlsSessions(), nullptr);
+  EXPECT_EQ(TicketKeys::of(serverCtx()), nullptr);
+
+  dial();
+  auto second = dial();
+  EXPECT_FALSE(second.resumed);
+  ASSERT_TRUE(second.client);
+  EXPECT_EQ(second.client->remotePublicKey().value(), server.keys.publicKey);
+}
@@ -0,0 +1,108 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/storage/sqlite_reader_pool.hpp>
+#include <libp2p/storage/sqlite_writer.hpp>
+
+#include <filesystem>
+
+#include <gtest/gtest.h>
+#include <boost/optional.hpp>
+
+#include "testutil/prepare_loggers.hpp"
+
+using libp2p::storage::SQLite;
+using libp2p::storage::SQLiteReaderPool;
+using libp2p::storage::SQLiteWriter;
+
+/// Fixture for tests of writer thread and readers on a file
+struct SQLiteWriterTest : public ::testing::Test {
+  void SetUp() override {
+    testutil::prepareLoggers();
+    remove();
+    SQLite db{kTestDbFile};
+    db << "create table countable(num integer)";
+  }
+
+  void TearDown() override {
+    remove();
+  }
+
+  void remove() {
+    for (auto suffix : {"", "-wal", "-shm"}) {
+      std::filesystem::remove(kTestDbFile + suffix);
+    }
+  }
+
+  int count(SQLite &db) {
+    int count = -1;
+    db << "select count(*) from countable" >> count;
+    return count;
+  }
+
+  const std::string kTestDbFile = "test_writer_db.sqlite";
+};
+
+/**
+ * @given writer committing batches of 4 commands
+ * @when 10 inserts are posted from several threads and flushed
+ * @then all inserts are committed, and reader sees them
+ */
+TEST_F(SQLiteWriterTest, BatchesCommands) {
+  SQLiteWriter writer{kTestDbFile, {.interval = std::chrono::seconds(10),
+                                    .batch = 4}};
+  auto insert = std::make_shared<boost::optional<SQLite::StatementHandle>>();
+  std::atomic_size_t committed = 0;
+
+  std::vector<std::thread> threads;
+  for (int thread = 0; thread < 2; ++thread) {
+    threads.emplace_back([&, thread] {
+      for (int i = 0; i < 5; ++i) {
+        auto posted = writer.post(
+            [insert, num{thread * 5 + i}](SQLite &db) {
+              if (not *insert) {
+                *insert = db.createStatement(
+                    "insert into countable(num) values(?)");
+              }
+              db.execCommand(insert->value(), num);
+            },
+            [&](bool ok) {
+              if (ok) {
+                ++committed;
+              }
+            });
+        EXPECT_TRUE(posted);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  ASSERT_TRUE(writer.flush());
+  ASSERT_EQ(committed, 10);
+
+  SQLiteReaderPool readers{kTestDbFile, 2};
+  auto reader = readers.acquire();
+  ASSERT_EQ(count(*reader), 10);
+}
+
+/**
+ * @given writer with long commit interval
+ * @when writer is destroyed with commands posted
+ * @then commands are committed before stop
+ */
+TEST_F(SQLiteWriterTest, CommitsOnStop) {
+  {
+    SQLiteWriter writer{kTestDbFile, {.interval = std::chrono::seconds(10)}};
+    for (int i = 0; i < 3; ++i) {
+      ASSERT_TRUE(writer.post([i](SQLite &db) {
+        db << "insert into countable(num) values(?)" << i;
+      }));
+    }
+  }
+  SQLite db{kTestDbFile};
+  ASSERT_EQ(count(db), 3);
+}
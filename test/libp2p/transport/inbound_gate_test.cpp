@@ -0,0 +1,82 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/transport/impl/inbound_gate.hpp>
+
+#include <gtest/gtest.h>
+#include <libp2p/network/impl/connection_gater_impl.hpp>
+
+using libp2p::network::ConnectionGaterImpl;
+using libp2p::transport::InboundGate;
+using libp2p::transport::InboundGateConfig;
+
+namespace {
+  auto address(const char *str) {
+    return boost::asio::ip::make_address(str);
+  }
+}  // namespace
+
+/**
+ * @given gate with burst of 2 connections and rate of 1 per second per /24
+ * @when connections arrive from one subnet and from another
+ * @then burst is accepted from each subnet, then one connection per second
+ */
+TEST(InboundGateTest, TokenBucketPerSubnet) {
+  auto gate = std::make_shared<InboundGate>(InboundGateConfig{
+      .accept_rate = 1, .accept_burst = 2, .ipv4_prefix = 24});
+  auto now = InboundGate::Clock::now();
+  EXPECT_TRUE(gate->admit(address("10.0.0.1"), now));
+  EXPECT_TRUE(gate->admit(address("10.0.0.2"), now));
+  EXPECT_FALSE(gate->admit(address("10.0.0.3"), now));
+  EXPECT_TRUE(gate->admit(address("10.0.1.1"), now));
+
+  now += std::chrono::seconds{1};
+  EXPECT_TRUE(gate->admit(address("10.0.0.1"), now));
+  EXPECT_FALSE(gate->admit(address("10.0.0.1"), now));
+}
+
+/**
+ * @given gate with gater denying 10.0.0.0/24
+ * @when connections arrive from denied subnet
+ * @then they are rejected without taking tokens of their bucket
+ */
+TEST(InboundGateTest, GaterBeforeBucket) {
+  auto gater = std::make_shared<ConnectionGaterImpl>();
+  auto gate = std::make_shared<InboundGate>(
+      InboundGateConfig{.accept_rate = 1, .accept_burst = 1, .ipv4_prefix = 16},
+      gater);
+  auto now = InboundGate::Clock::now();
+  gater->denySubnet(address("10.0.0.0"), 24);
+  EXPECT_FALSE(gate->admit(address("10.0.0.1"), now));
+  EXPECT_FALSE(gate->admit(address("10.0.0.2"), now));
+  EXPECT_TRUE(gate->admit(address("10.0.1.1"), now));
+}
+
+/**
+ * @given gate with 1 upgrade in flight and queue of 1
+ * @when 3 upgrades are requested
+ * @then first starts, second waits until first releases permit, third is
+ * rejected
+ */
+TEST(InboundGateTest, UpgradeConcurrencyCap) {
+  auto gate = std::make_shared<InboundGate>(InboundGateConfig{
+      .max_inflight_upgrades = 1, .max_queued_upgrades = 1});
+  InboundGate::Permit first, second;
+  ASSERT_TRUE(gate->enqueue([&](auto permit) { first = std::move(permit); }));
+  ASSERT_TRUE(gate->enqueue([&](auto permit) { second = std::move(permit); }));
+  ASSERT_FALSE(gate->enqueue([](auto) { ADD_FAILURE(); }));
+  ASSERT_TRUE(first);
+  ASSERT_FALSE(second);
+  ASSERT_EQ(gate->queued(), 1);
+
+  first.reset();
+  ASSERT_TRUE(second);
+  ASSERT_EQ(gate->inflight(), 1);
+  ASSERT_EQ(gate->queued(), 0);
+
+  second.reset();
+  ASSERT_EQ(gate->inflight(), 0);
+}
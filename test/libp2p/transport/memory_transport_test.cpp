@@ -0,0 +1,181 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <gtest/gtest.h>
+#include <boost/asio/io_context.hpp>
+#include <libp2p/basic/read.hpp>
+#include <libp2p/basic/write.hpp>
+#include <libp2p/common/literals.hpp>
+#include <libp2p/connection/stream.hpp>
+#include <libp2p/transport/memory/error.hpp>
+#include <libp2p/transport/memory/transport.hpp>
+#include <qtils/bytestr.hpp>
+
+#include "mock/libp2p/peer/identity_manager_mock.hpp"
+#include "testutil/libp2p/peer.hpp"
+
+using libp2p::MemoryError;
+using libp2p::Multiaddress;
+using libp2p::connection::CapableConnection;
+using libp2p::connection::Stream;
+using libp2p::crypto::KeyPair;
+using libp2p::peer::IdentityManagerMock;
+using libp2p::peer::PeerId;
+using libp2p::transport::MemoryTransport;
+using libp2p::transport::TransportListener;
+using qtils::byte2str;
+using qtils::str2byte;
+using testing::ReturnRef;
+using namespace libp2p::common;
+
+struct Node {
+  explicit Node(std::shared_ptr<boost::asio::io_context> io) {
+    EXPECT_CALL(id_mgr, getId()).WillRepeatedly(ReturnRef(peer));
+    EXPECT_CALL(id_mgr, getKeyPair()).WillRepeatedly(ReturnRef(keys));
+    transport = std::make_shared<MemoryTransport>(io, id_mgr);
+  }
+
+  PeerId peer = testutil::randomPeerId();
+  KeyPair keys;
+  IdentityManagerMock id_mgr;
+  std::shared_ptr<MemoryTransport> transport;
+};
+
+class MemoryTransportTest : public testing::Test {
+ public:
+  void SetUp() override {
+    listener = server.transport->createListener(
+        [&](outcome::result<std::shared_ptr<CapableConnection>> r) {
+          ASSERT_TRUE(r) << r.error();
+          server_conn = r.value();
+          server_conn->onStream([&](std::shared_ptr<Stream> stream) {
+            server_stream = std::move(stream);
+          });
+        });
+    ASSERT_TRUE(listener->listen(address));
+    address = listener->getListenMultiaddr().value();
+  }
+
+  /// Dials server and opens stream to it
+  void connect() {
+    client.transport->dial(
+        server.peer,
+        address,
+        [&](outcome::result<std::shared_ptr<CapableConnection>> r) {
+          ASSERT_TRUE(r) << r.error();
+          client_conn = r.value();
+          client_stream = client_conn->newStream().value();
+        });
+    io->run();
+    io->restart();
+    ASSERT_TRUE(client_stream);
+    ASSERT_TRUE(server_stream);
+  }
+
+  std::shared_ptr<boost::asio::io_context> io =
+      std::make_shared<boost::asio::io_context>();
+  Node server{io}, client{io};
+  std::shared_ptr<TransportListener> listener;
+  Multiaddress address = "/memory/0"_multiaddr;
+  std::shared_ptr<CapableConnection> server_conn, client_conn;
+  std::shared_ptr<Stream> server_stream, client_stream;
+};
+
+/**
+ * @given listener of "/memory/0"
+ * @when it listens
+ * @then it gets unique nonzero id, which can be dialed
+ */
+TEST_F(MemoryTransportTest, ListenPicksFreeId) {
+  EXPECT_NE(address, "/memory/0"_multiaddr);
+  EXPECT_TRUE(client.transport->canDial(address));
+  EXPECT_FALSE(client.transport->canDial("/ip4/127.0.0.1/tcp/1"_multiaddr));
+
+  auto other = server.transport->createListener([](auto &&) {});
+  auto r = other->listen(address);
+  ASSERT_FALSE(r);
+  EXPECT_EQ(r.error(), make_error_code(MemoryError::ADDRESS_IN_USE));
+}
+
+/**
+ * @given connected client and server
+ * @when client writes to stream
+ * @then server reads same bytes, and sees peer of client
+ */
+TEST_F(MemoryTransportTest, WriteRead) {
+  connect();
+  EXPECT_EQ(server_conn->remotePeer().value(), client.peer);
+  EXPECT_EQ(client_conn->remotePeer().value(), server.peer);
+  EXPECT_TRUE(client_stream->isInitiator().value());
+  EXPECT_FALSE(server_stream->isInitiator().value());
+
+  std::string_view req{"request"};
+  std::vector<uint8_t> buf(req.size());
+  bool written = false, read = false;
+  libp2p::read(server_stream, buf, [&](outcome::result<void> r) {
+    EXPECT_TRUE(r) << r.error();
+    read = true;
+  });
+  libp2p::write(client_stream, str2byte(req), [&](outcome::result<void> r) {
+    EXPECT_TRUE(r) << r.error();
+    written = true;
+  });
+  io->run();
+  EXPECT_TRUE(written);
+  EXPECT_TRUE(read);
+  EXPECT_EQ(byte2str(buf), req);
+}
+
+/**
+ * @given connected client and server, server waiting for data
+ * @when client closes stream, then resets it
+ * @then server read fails, and client write fails
+ */
+TEST_F(MemoryTransportTest, CloseReset) {
+  connect();
+  std::vector<uint8_t> buf(1);
+  std::optional<outcome::result<size_t>> read;
+  server_stream->readSome(
+      buf, buf.size(), [&](outcome::result<size_t> r) { read = r; });
+  client_stream->close([](outcome::result<void> r) { EXPECT_TRUE(r); });
+  io->run();
+  io->restart();
+  ASSERT_TRUE(read);
+  EXPECT_FALSE(*read);
+  EXPECT_TRUE(server_stream->isClosedForRead());
+  EXPECT_FALSE(server_stream->isClosedForWrite());
+
+  client_stream->reset();
+  std::optional<outcome::result<size_t>> written;
+  server_stream->writeSome(buf, buf.size(), [&](outcome::result<size_t> r) {
+    written = r;
+  });
+  io->run();
+  ASSERT_TRUE(written);
+  EXPECT_FALSE(*written);
+}
+
+/**
+ * @given no listener at address, or listener of other peer
+ * @when client dials it
+ * @then dial fails
+ */
+TEST_F(MemoryTransportTest, DialFails) {
+  std::vector<std::error_code> errors;
+  auto dial = [&](const PeerId &peer, const Multiaddress &ma) {
+    client.transport->dial(peer, ma, [&](auto r) {
+      ASSERT_FALSE(r);
+      errors.emplace_back(r.error());
+    });
+  };
+  dial(client.peer, address);
+  listener->close().value();
+  dial(server.peer, address);
+  io->run();
+  EXPECT_EQ(errors,
+            (std::vector{make_error_code(MemoryError::PEER_MISMATCH),
+                         make_error_code(MemoryError::NO_LISTENER)}));
+}
@@ -0,0 +1,153 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/transport/quic/send_batch.hpp>
+
+#include <algorithm>
+#include <deque>
+
+#include <arpa/inet.h>
+#include <gtest/gtest.h>
+
+using libp2p::transport::lsquic::sendBatch;
+
+#ifdef __linux__
+
+namespace {
+  /// Fields of `lsquic_out_spec` used by `sendBatch`
+  struct Spec {
+    const iovec *iov;
+    size_t iovlen;
+    const sockaddr *dest_sa;
+  };
+
+  sockaddr_in address(uint16_t port) {
+    sockaddr_in sa{};
+    sa.sin_family = AF_INET;
+    sa.sin_port = htons(port);
+    sa.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    return sa;
+  }
+
+  /// Fake `sendmmsg`, returns results in order, positive count is capped
+  struct FakeSend {
+    struct Call {
+      size_t msgs;
+      /// Segment size of the first message, if it was coalesced by GSO
+      size_t gso_segment;
+    };
+
+    int operator()(mmsghdr *msgs, unsigned n) {
+      size_t segment = 0;
+      if (auto cmsg = CMSG_FIRSTHDR(&msgs[0].msg_hdr)) {
+        uint16_t segment16 = 0;
+        memcpy(&segment16, CMSG_DATA(cmsg), sizeof(segment16));
+        segment = segment16;
+      }
+      calls.push_back({n, segment});
+      auto result = results.front();
+      results.pop_front();
+      if (result < 0) {
+        errno = -result;
+        return -1;
+      }
+      return std::min<int>(result, static_cast<int>(n));
+    }
+
+    /// Number of messages sent, or negated errno
+    std::deque<int> results;
+    std::vector<Call> calls;
+  };
+}  // namespace
+
+struct QuicSendBatchTest : public ::testing::Test {
+  /// Packet of size to address
+  void add(size_t size, const sockaddr_in &sa) {
+    auto &payload = payloads.emplace_back(size, 0);
+    auto &iov = iovs.emplace_back(iovec{payload.data(), payload.size()});
+    specs.push_back(
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        {&iov, 1, reinterpret_cast<const sockaddr *>(&sa)});
+  }
+
+  sockaddr_in a = address(1001);
+  sockaddr_in b = address(1002);
+  std::deque<std::vector<uint8_t>> payloads;
+  std::deque<iovec> iovs;
+  std::vector<Spec> specs;
+  FakeSend send;
+};
+
+/**
+ * @given four packets to two destinations, without GSO
+ * @when first send is partial, and next send fails with EHOSTUNREACH
+ * @then failed packet is dropped, rest is sent, and socket is not waited for
+ */
+TEST_F(QuicSendBatchTest, UnreachableDropped) {
+  add(100, a);
+  add(100, b);
+  add(100, a);
+  add(100, b);
+  send.results = {1, -EHOSTUNREACH, 2};
+  bool gso = false;
+
+  auto result = sendBatch(std::span<const Spec>{specs}, gso, send);
+
+  EXPECT_EQ(result.sent, 4);
+  EXPECT_EQ(result.dropped, 1);
+  EXPECT_FALSE(result.wait_writable);
+  ASSERT_EQ(send.calls.size(), 3);
+  EXPECT_EQ(send.calls[0].msgs, 4);
+  EXPECT_EQ(send.calls[1].msgs, 3);
+  EXPECT_EQ(send.calls[2].msgs, 2);
+}
+
+/**
+ * @given three packets
+ * @when first send is partial, and next send fails with EAGAIN
+ * @then sent packets are reported, and socket is waited for
+ */
+TEST_F(QuicSendBatchTest, FullBufferWaits) {
+  add(100, a);
+  add(100, b);
+  add(100, a);
+  send.results = {1, -EAGAIN};
+  bool gso = false;
+
+  auto result = sendBatch(std::span<const Spec>{specs}, gso, send);
+
+  EXPECT_EQ(result.sent, 1);
+  EXPECT_EQ(result.dropped, 0);
+  EXPECT_TRUE(result.wait_writable);
+  EXPECT_EQ(send.calls.size(), 2);
+}
+
+/**
+ * @given packets of equal size and a smaller last one to one destination
+ * @when they are sent with GSO, and the device fails it with EIO
+ * @then they are coalesced into one message, which is sent again without
+ * GSO as separate messages, and GSO stays disabled
+ */
+TEST_F(QuicSendBatchTest, GsoFallback) {
+  add(1200, a);
+  add(1200, a);
+  add(500, a);
+  add(1200, b);
+  send.results = {-EIO, 4};
+  bool gso = true;
+
+  auto result = sendBatch(std::span<const Spec>{specs}, gso, send);
+
+  EXPECT_EQ(result.sent, 4);
+  EXPECT_FALSE(gso);
+  ASSERT_EQ(send.calls.size(), 2);
+  EXPECT_EQ(send.calls[0].msgs, 2);
+  EXPECT_EQ(send.calls[0].gso_segment, 1200);
+  EXPECT_EQ(send.calls[1].msgs, 4);
+  EXPECT_EQ(send.calls[1].gso_segment, 0);
+}
+
+#endif
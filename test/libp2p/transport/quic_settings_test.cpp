@@ -0,0 +1,102 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/transport/quic/engine.hpp>
+
+#include <gtest/gtest.h>
+
+#include <libp2p/muxer/muxed_connection_config.hpp>
+
+using libp2p::muxer::MuxedConnectionConfig;
+using libp2p::transport::QuicCongestionControl;
+using libp2p::transport::QuicConfig;
+using libp2p::transport::lsquic::engineSettings;
+
+/**
+ * @given quic config with every engine setting set
+ * @when engine settings are made of it
+ * @then each value reaches its lsquic setting
+ */
+TEST(QuicSettings, ConfigReachesEngine) {
+  MuxedConnectionConfig mux_config;
+  QuicConfig config;
+  config.datagrams = true;
+  config.migration = false;
+  config.congestion_control = QuicCongestionControl::BBR;
+  config.pacing = false;
+  config.initial_stream_window = 1 << 20;
+  config.max_stream_window = 4 << 20;
+  config.initial_connection_window = 8 << 20;
+  config.max_connection_window = 16 << 20;
+  config.max_streams = 50;
+  config.idle_timeout = std::chrono::seconds{40};
+  config.base_packet_size = 1300;
+  config.max_packet_size = 1400;
+
+  for (unsigned flags : {0u, unsigned{LSENG_SERVER}}) {
+    auto settings = engineSettings(mux_config, config, flags);
+    EXPECT_EQ(settings.es_datagrams, 1);
+    EXPECT_EQ(settings.es_allow_migration, 0);
+    EXPECT_EQ(settings.es_cc_algo, 2);
+    EXPECT_EQ(settings.es_pace_packets, 0);
+    EXPECT_EQ(settings.es_init_max_stream_data_bidi_remote, 1 << 20);
+    EXPECT_EQ(settings.es_init_max_stream_data_bidi_local, 1 << 20);
+    EXPECT_EQ(settings.es_max_sfcw, 4 << 20);
+    EXPECT_EQ(settings.es_init_max_data, 8 << 20);
+    EXPECT_EQ(settings.es_max_cfcw, 16 << 20);
+    EXPECT_EQ(settings.es_init_max_streams_bidi, 50);
+    EXPECT_EQ(settings.es_idle_timeout, 40);
+    EXPECT_EQ(settings.es_base_plpmtu, 1300);
+    EXPECT_EQ(settings.es_max_plpmtu, 1400);
+    EXPECT_EQ(settings.es_handshake_to,
+              std::chrono::microseconds{mux_config.dial_timeout}.count());
+  }
+}
+
+/**
+ * @given quic config with zero engine settings
+ * @when engine settings are made of it
+ * @then settings shared with muxers come from muxer config, the rest keep
+ * lsquic defaults
+ */
+TEST(QuicSettings, ZeroKeepsDefaults) {
+  MuxedConnectionConfig mux_config;
+  mux_config.maximum_window_size = 2 << 20;
+  mux_config.maximum_streams = 30;
+  mux_config.no_streams_interval = std::chrono::seconds{20};
+  QuicConfig config;
+
+  lsquic_engine_settings defaults{};
+  lsquic_engine_init_settings(&defaults, 0);
+  auto settings = engineSettings(mux_config, config, 0);
+  EXPECT_EQ(settings.es_init_max_stream_data_bidi_remote, 2 << 20);
+  EXPECT_EQ(settings.es_init_max_stream_data_bidi_local, 2 << 20);
+  EXPECT_EQ(settings.es_init_max_streams_bidi, 30);
+  EXPECT_EQ(settings.es_idle_timeout, 20);
+  EXPECT_EQ(settings.es_cc_algo, defaults.es_cc_algo);
+  EXPECT_EQ(settings.es_max_sfcw, defaults.es_max_sfcw);
+  EXPECT_EQ(settings.es_init_max_data, defaults.es_init_max_data);
+  EXPECT_EQ(settings.es_max_cfcw, defaults.es_max_cfcw);
+  EXPECT_EQ(settings.es_base_plpmtu, defaults.es_base_plpmtu);
+  EXPECT_EQ(settings.es_max_plpmtu, defaults.es_max_plpmtu);
+  EXPECT_EQ(settings.es_datagrams, 0);
+  EXPECT_EQ(settings.es_allow_migration, 1);
+  EXPECT_EQ(settings.es_pace_packets, 1);
+}
+
+/**
+ * @given idle timeout above the QUIC limit of lsquic (600 seconds)
+ * @when engine settings are made of it
+ * @then they are rejected before engine is created
+ */
+TEST(QuicSettings, RejectsInvalid) {
+  MuxedConnectionConfig mux_config;
+  QuicConfig config;
+  config.idle_timeout = std::chrono::seconds{601};
+  EXPECT_THROW(engineSettings(mux_config, config, 0), std::invalid_argument);
+  EXPECT_THROW(engineSettings(mux_config, config, LSENG_SERVER),
+               std::invalid_argument);
+}
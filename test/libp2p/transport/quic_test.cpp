@@ -5,32 +5,47 @@
  */
 
 #include <gtest/gtest.h>
+#include <openssl/ssl.h>
+#include <optional>
+#include <boost/asio/ip/udp.hpp>
+#include <boost/asio/ssl/context.hpp>
 #include <boost/di/extension/scopes/shared.hpp>
 #include <libp2p/basic/read.hpp>
 #include <libp2p/basic/write.hpp>
 #include <libp2p/injector/host_injector.hpp>
+#include <libp2p/security/tls/ssl_context.hpp>
+#include <libp2p/transport/quic/connection.hpp>
 #include <qtils/bytestr.hpp>
 
 #include "testutil/prepare_loggers.hpp"
 
 using boost::asio::io_context;
+using libp2p::Bytes;
+using libp2p::BytesIn;
 using libp2p::Host;
 using libp2p::Multiaddress;
 using libp2p::StreamAndProtocol;
 using libp2p::StreamAndProtocolOrError;
+using libp2p::connection::CapableConnection;
 using libp2p::connection::Stream;
+using libp2p::network::TransportManager;
+using libp2p::peer::PeerInfo;
+using libp2p::security::SslContext;
+using libp2p::transport::QuicConfig;
 using qtils::byte2str;
 using qtils::str2byte;
 
-auto makeInjector(std::shared_ptr<io_context> io) {
+auto makeInjector(std::shared_ptr<io_context> io, const QuicConfig &config) {
   return libp2p::injector::makeHostInjector<
       boost::di::extension::shared_config>(
-      boost::di::bind<io_context>().to(io));
+      boost::di::bind<io_context>().to(io),
+      boost::di::bind<QuicConfig>().to(config)[boost::di::override]);
 }
-using Injector = decltype(makeInjector(nullptr));
+using Injector = decltype(makeInjector(nullptr, {}));
 
 struct Peer {
-  Peer(std::shared_ptr<io_context> io) : injector{makeInjector(io)} {
+  Peer(std::shared_ptr<io_context> io, const QuicConfig &config = {})
+      : injector{makeInjector(io, config)} {
     inject(io);
     inject(host);
   }
@@ -107,3 +122,389 @@ TEST(Quic, Test) {
   run();
   EXPECT_EQ(byte2str(res_out), res);
 }
+
+/**
+ * Client opens stream to server by dial address, runs until both peers have
+ * the stream
+ */
+void openStream(const std::shared_ptr<io_context> &io,
+                Peer &client,
+                Peer &server,
+                const Multiaddress &dial_addr) {
+  std::string protocol = "/test";
+  auto done = [io, &client, &server] {
+    if (client.stream and server.stream) {
+      io->stop();
+    }
+  };
+  server.host->setProtocolHandler(
+      {protocol}, [&server, done](StreamAndProtocol r) {
+        server.stream = r.stream;
+        done();
+      });
+  client.host->newStream(PeerInfo{server.host->getId(), {dial_addr}},
+                         {protocol},
+                         [&client, done](StreamAndProtocolOrError r) {
+                           EXPECT_TRUE(r) << r.error().message();
+                           if (r) {
+                             client.stream = r.value().stream;
+                           }
+                           done();
+                         });
+  io->restart();
+  io->run_for(std::chrono::seconds{1});
+}
+
+/**
+ * @given stream between client and server
+ * @when client writes several buffers by one vectored write, together larger
+ * than a packet, and server reads them by one whole-buffer read
+ * @then the write takes all buffers, and the read completes once, when all
+ * packets are received, with bytes of the buffers in order
+ */
+TEST(Quic, GatheredWriteWholeRead) {
+  testutil::prepareLoggers();
+  auto io = std::make_shared<io_context>();
+  Peer client{io}, server{io};
+  auto addr = Multiaddress::create("/ip4/127.0.0.1/udp/10004/quic-v1").value();
+  server.host->listen(addr).value();
+  server.host->start();
+  openStream(io, client, server, addr);
+  ASSERT_TRUE(client.stream);
+  ASSERT_TRUE(server.stream);
+
+  std::vector<Bytes> buffers{Bytes(1000, 1), Bytes(3000, 2), Bytes(6000, 3)};
+  std::vector<BytesIn> in(buffers.begin(), buffers.end());
+  Bytes expected;
+  for (auto &buffer : buffers) {
+    expected.insert(expected.end(), buffer.begin(), buffer.end());
+  }
+  Bytes out(expected.size());
+  std::optional<outcome::result<size_t>> written;
+  std::optional<outcome::result<size_t>> read;
+  size_t reads = 0;
+  auto done = [&] {
+    if (written and read) {
+      io->stop();
+    }
+  };
+  client.stream->writeSomeVectored(in, [&](outcome::result<size_t> r) {
+    written = r;
+    done();
+  });
+  server.stream->read(out, out.size(), [&](outcome::result<size_t> r) {
+    ++reads;
+    read = r;
+    done();
+  });
+  io->restart();
+  io->run_for(std::chrono::seconds{1});
+
+  ASSERT_TRUE(written);
+  EXPECT_EQ(written->value(), expected.size());
+  ASSERT_TRUE(read);
+  EXPECT_EQ(read->value(), out.size());
+  EXPECT_EQ(reads, 1);
+  EXPECT_EQ(out, expected);
+}
+
+/**
+ * UDP relay from client to server.
+ * Server sees client at address of relay socket, which may be replaced to
+ * change the address, as NAT rebinding does.
+ */
+struct UdpRelay {
+  using udp = boost::asio::ip::udp;
+  using Buffer = std::array<uint8_t, 64 << 10>;
+
+  UdpRelay(io_context &io, udp::endpoint server)
+      : io{io},
+        server{std::move(server)},
+        front{io, udp::endpoint{boost::asio::ip::address_v4::loopback(), 0}} {
+    rebind();
+    receiveFront();
+  }
+
+  /// Address client dials
+  Multiaddress frontAddr() const {
+    return quicAddr(front.local_endpoint());
+  }
+
+  /// Address server sees
+  Multiaddress backAddr() const {
+    return quicAddr(backs.back()->local_endpoint());
+  }
+
+  /// Sends next packets to server from new socket, replies to old sockets
+  /// are still relayed
+  void rebind() {
+    backs.emplace_back(std::make_shared<udp::socket>(
+        io, udp::endpoint{boost::asio::ip::address_v4::loopback(), 0}));
+    receiveBack(backs.back());
+  }
+
+  static Multiaddress quicAddr(const udp::endpoint &endpoint) {
+    return Multiaddress::create(fmt::format("/ip4/{}/udp/{}/quic-v1",
+                                            endpoint.address().to_string(),
+                                            endpoint.port()))
+        .value();
+  }
+
+  void receiveFront() {
+    front.async_receive_from(
+        boost::asio::buffer(front_buf),
+        client,
+        [this](boost::system::error_code ec, size_t size) {
+          if (ec) {
+            return;
+          }
+          backs.back()->send_to(
+              boost::asio::buffer(front_buf.data(), size), server, 0, ec);
+          receiveFront();
+        });
+  }
+
+  void receiveBack(std::shared_ptr<udp::socket> back) {
+    auto buf = std::make_shared<Buffer>();
+    auto from = std::make_shared<udp::endpoint>();
+    back->async_receive_from(
+        boost::asio::buffer(*buf),
+        *from,
+        [this, back, buf, from](boost::system::error_code ec, size_t size) {
+          if (ec) {
+            return;
+          }
+          front.send_to(boost::asio::buffer(buf->data(), size), client, 0, ec);
+          receiveBack(back);
+        });
+  }
+
+  io_context &io;
+  udp::endpoint server;
+  udp::socket front;
+  udp::endpoint client;
+  Buffer front_buf;
+  std::vector<std::shared_ptr<udp::socket>> backs;
+};
+
+/**
+ * @given stream between client and server, which sees client at address of
+ * relay
+ * @when the relay starts sending from another address
+ * @then the connection survives, stream still carries data both ways, and
+ * server connection reports and returns the new remote address
+ */
+TEST(Quic, PeerAddressChange) {
+  testutil::prepareLoggers();
+  auto io = std::make_shared<io_context>();
+  Peer client{io}, server{io};
+  auto addr = Multiaddress::create("/ip4/127.0.0.1/udp/10005/quic-v1").value();
+  server.host->listen(addr).value();
+  server.host->start();
+  UdpRelay relay{*io, {boost::asio::ip::address_v4::loopback(), 10005}};
+  openStream(io, client, server, relay.frontAddr());
+  ASSERT_TRUE(client.stream);
+  ASSERT_TRUE(server.stream);
+
+  auto connection =
+      std::dynamic_pointer_cast<libp2p::transport::QuicConnection>(
+          server.host->getNetwork()
+              .getConnectionManager()
+              .getBestConnectionForPeer(client.host->getId()));
+  ASSERT_TRUE(connection);
+  EXPECT_EQ(connection->remoteMultiaddr().value(), relay.backAddr());
+  std::optional<Multiaddress> changed;
+  connection->onRemoteChanged(
+      [&](const Multiaddress &remote) { changed = remote; });
+
+  // request and response, so both peers send on the current path
+  auto round_trip = [&] {
+    Bytes req{1, 2, 3}, res{4, 5, 6};
+    Bytes req_out(req.size()), res_out(res.size());
+    size_t wait_count = 4;
+    auto wait_done = [&] {
+      if (--wait_count == 0) {
+        io->stop();
+      }
+    };
+    libp2p::write(client.stream, req, RW_CB);
+    libp2p::read(server.stream, req_out, RW_CB);
+    libp2p::write(server.stream, res, RW_CB);
+    libp2p::read(client.stream, res_out, RW_CB);
+    io->restart();
+    io->run_for(std::chrono::seconds{1});
+    EXPECT_EQ(wait_count, 0);
+    EXPECT_EQ(req_out, req);
+    EXPECT_EQ(res_out, res);
+  };
+
+  relay.rebind();
+  round_trip();
+  // path validation completes, next packets go to the new path
+  io->restart();
+  io->run_for(std::chrono::milliseconds{100});
+  round_trip();
+  io->restart();
+  io->run_for(std::chrono::milliseconds{100});
+
+  ASSERT_TRUE(changed);
+  EXPECT_EQ(*changed, relay.backAddr());
+  EXPECT_EQ(connection->remoteMultiaddr().value(), relay.backAddr());
+  EXPECT_FALSE(connection->isClosed());
+}
+
+/**
+ * WebTransport addresses are parsed, but there is no WebTransport transport.
+ *
+ * QUIC transport neither listens on them nor dials them as libp2p QUIC.
+ */
+TEST(Quic, NoWebTransport) {
+  testutil::prepareLoggers();
+  auto io = std::make_shared<io_context>();
+  Peer peer{io};
+  auto addr =
+      Multiaddress::create("/ip4/127.0.0.1/udp/10002/quic-v1/webtransport")
+          .value();
+  EXPECT_FALSE(peer.host->listen(addr));
+  auto transports = peer.injector.create<std::shared_ptr<TransportManager>>();
+  EXPECT_EQ(transports->findBest(addr), nullptr);
+}
+
+/**
+ * Client dials server with quic transport directly, so that each dial makes
+ * a new connection. Server reports whether it resumed the session and
+ * accepted early data.
+ */
+struct QuicSessionsTest : public ::testing::Test {
+  struct Dial {
+    std::shared_ptr<CapableConnection> connection;
+    /// Server resumed the session
+    bool resumed = false;
+    /// Server accepted 0-RTT data
+    bool early_data = false;
+  };
+
+  void SetUp() override {
+    testutil::prepareLoggers();
+  }
+
+  /// Creates both peers with config, server listens
+  void init(const QuicConfig &config) {
+    client.emplace(io, config);
+    server.emplace(io, config);
+    server->host->listen(server_addr).value();
+    server->host->start();
+
+    auto *ctx = server->injector.create<SslContext>().quic()->native_handle();
+    SSL_CTX_set_ex_data(ctx, fixtureIndex(), this);
+    SSL_CTX_set_info_callback(ctx, +[](const SSL *ssl, int where, int) {
+      if ((where & SSL_CB_HANDSHAKE_DONE) != 0) {
+        auto *self = static_cast<QuicSessionsTest *>(
+            SSL_CTX_get_ex_data(SSL_get_SSL_CTX(ssl), fixtureIndex()));
+        self->resumed = SSL_session_reused(ssl) == 1;
+        self->early_data = SSL_early_data_accepted(ssl) == 1;
+        self->waitDone();
+      }
+    });
+  }
+
+  static int fixtureIndex() {
+    static const int index =
+        SSL_CTX_get_ex_new_index(0, nullptr, nullptr, nullptr, nullptr);
+    return index;
+  }
+
+  /**
+   * Client dials server and waits for both sides of handshake, then for
+   * session ticket sent after handshake.
+   * Connections are kept open till the end of test.
+   */
+  Dial dial() {
+    Dial result;
+    resumed = false;
+    early_data = false;
+    auto transports =
+        client->injector.create<std::shared_ptr<TransportManager>>();
+    auto transport = transports->findBest(server_addr);
+    EXPECT_NE(transport, nullptr);
+    if (not transport) {
+      return result;
+    }
+    wait_count = 2;
+    transport->dial(server->host->getId(), server_addr, [&](auto r) {
+      EXPECT_TRUE(r) << r.error().message();
+      if (r) {
+        result.connection = r.value();
+      }
+      waitDone();
+    });
+    run(std::chrono::seconds{1});
+    if (not result.connection) {
+      ADD_FAILURE() << "dial not done";
+      return result;
+    }
+    run(std::chrono::milliseconds{100});
+    result.resumed = resumed;
+    result.early_data = early_data;
+    connections.push_back(result.connection);
+    return result;
+  }
+
+  void run(std::chrono::milliseconds timeout) {
+    io->restart();
+    io->run_for(timeout);
+  }
+
+  void waitDone() {
+    if (wait_count != 0 and --wait_count == 0) {
+      io->stop();
+    }
+  }
+
+  std::shared_ptr<io_context> io = std::make_shared<io_context>();
+  std::optional<Peer> client;
+  std::optional<Peer> server;
+  Multiaddress server_addr =
+      Multiaddress::create("/ip4/127.0.0.1/udp/10003/quic-v1").value();
+  size_t wait_count = 0;
+  bool resumed = false;
+  bool early_data = false;
+  std::vector<std::shared_ptr<CapableConnection>> connections;
+};
+
+/**
+ * @given client and server with default config
+ * @when client dials server again
+ * @then the second dial resumes session received by the first one, but
+ * doesn't send 0-RTT data
+ */
+TEST_F(QuicSessionsTest, ResumeWithoutEarlyData) {
+  init({});
+  auto first = dial();
+  EXPECT_FALSE(first.resumed);
+  auto second = dial();
+  EXPECT_TRUE(second.resumed);
+  EXPECT_FALSE(second.early_data);
+  ASSERT_TRUE(second.connection);
+  EXPECT_EQ(second.connection->remotePeer().value(), server->host->getId());
+}
+
+/**
+ * @given client and server with early data enabled
+ * @when client dials server again
+ * @then the second dial resumes the session with 0-RTT data accepted, and
+ * remote peer is the one verified by the first handshake
+ */
+TEST_F(QuicSessionsTest, ResumeWithEarlyData) {
+  QuicConfig config;
+  config.early_data = true;
+  init(config);
+  auto first = dial();
+  EXPECT_FALSE(first.resumed);
+  EXPECT_FALSE(first.early_data);
+  auto second = dial();
+  EXPECT_TRUE(second.resumed);
+  EXPECT_TRUE(second.early_data);
+  ASSERT_TRUE(second.connection);
+  EXPECT_EQ(second.connection->remotePeer().value(), server->host->getId());
+}
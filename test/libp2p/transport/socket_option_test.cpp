@@ -0,0 +1,58 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/transport/socket_option.hpp>
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/udp.hpp>
+#include <gtest/gtest.h>
+
+using boost::asio::ip::udp;
+using libp2p::transport::IntegerSocketOption;
+
+#ifdef SO_REUSEPORT
+using ReusePort = IntegerSocketOption<SOL_SOCKET, SO_REUSEPORT>;
+
+/**
+ * @given udp sockets with SO_REUSEPORT set
+ * @when option is read back, and both sockets are bound to the same port
+ * @then option is set, and both binds succeed
+ */
+TEST(SocketOptionTest, ReusePort) {
+  boost::asio::io_context context;
+  udp::socket first{context, udp::v4()};
+  udp::socket second{context, udp::v4()};
+  first.set_option(ReusePort{1});
+  second.set_option(ReusePort{1});
+
+  ReusePort option;
+  first.get_option(option);
+  EXPECT_NE(option.value(), 0);
+
+  first.bind({boost::asio::ip::address_v4::loopback(), 0});
+  boost::system::error_code ec;
+  second.bind(first.local_endpoint(), ec);
+  EXPECT_FALSE(ec) << ec.message();
+}
+#endif
+
+/**
+ * @given udp socket
+ * @when integer option is set to a value
+ * @then same value is read back
+ */
+TEST(SocketOptionTest, Integer) {
+  boost::asio::io_context context;
+  udp::socket socket{context, udp::v4()};
+  using SendBuffer = IntegerSocketOption<SOL_SOCKET, SO_SNDBUF>;
+  SendBuffer before;
+  socket.get_option(before);
+  EXPECT_GT(before.value(), 0);
+  socket.set_option(SendBuffer{before.value() * 2});
+  SendBuffer after;
+  socket.get_option(after);
+  EXPECT_GE(after.value(), before.value() * 2);
+}
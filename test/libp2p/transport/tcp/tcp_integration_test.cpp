@@ -11,6 +11,7 @@
 #include <libp2p/basic/write_return_size.hpp>
 #include <libp2p/common/literals.hpp>
 #include <libp2p/transport/tcp.hpp>
+#include <libp2p/transport/tcp/tcp_connection.hpp>
 #include <memory>
 #include <qtils/test/outcome.hpp>
 #include "mock/libp2p/connection/capable_connection_mock.hpp"
@@ -357,6 +358,89 @@ TEST(TCP, OneTransportServerHandlesManyClients) {
   ASSERT_EQ(counter, 1);
 }
 
+/**
+ * @given listener with several SO_REUSEPORT listening sockets
+ * @when many clients dial it
+ * @then all connections are accepted on io_context of listener
+ */
+TEST(TCP, ReusePortAcceptorsAcceptManyClients) {
+  constexpr int kClients = 32;
+  int accepted = 0;
+  int dialed = 0;
+
+  auto context = std::make_shared<boost::asio::io_context>(1);
+  TcpSocketOptions options;
+  options.reuse_port_acceptors = 4;
+  auto transport = std::make_shared<TcpTransport>(
+      context, mux_config, makeUpgrader(), nullptr, options);
+  std::vector<std::shared_ptr<CapableConnection>> connections;
+  auto listener = transport->createListener([&](auto &&rconn) {
+    auto conn = expectConnectionValid(rconn);
+    EXPECT_FALSE(conn->isInitiator());
+    EXPECT_TRUE(context->get_executor().running_in_this_thread());
+    connections.emplace_back(conn);
+    ++accepted;
+  });
+  auto ma = "/ip4/127.0.0.1/tcp/40006"_multiaddr;
+  ASSERT_OUTCOME_SUCCESS(listener->listen(ma));
+
+  for (int i = 0; i < kClients; ++i) {
+    transport->dial(testutil::randomPeerId(), ma, [&](auto &&rconn) {
+      connections.emplace_back(expectConnectionValid(rconn));
+      ++dialed;
+    });
+  }
+
+  context->run_for(500ms);
+  ASSERT_OUTCOME_SUCCESS(listener->close());
+
+  ASSERT_EQ(dialed, kClients);
+  ASSERT_EQ(accepted, kClients);
+}
+
+/**
+ * @given connection with zero-copy sends of large writes
+ * @when megabytes are written to it
+ * @then writes complete after kernel releases buffers, peer receives the data
+ */
+TEST(TCP, ZeroCopyWrite) {
+  boost::asio::io_context context;
+  boost::asio::ip::tcp::acceptor acceptor{
+      context, {boost::asio::ip::make_address("127.0.0.1"), 0}};
+  boost::asio::ip::tcp::socket client{context};
+  boost::asio::ip::tcp::socket accepted{context};
+  client.connect(acceptor.local_endpoint());
+  acceptor.accept(accepted);
+  TcpSocketOptions options{.zero_copy_threshold = 1 << 16};
+  applyConnected(accepted, options);
+  auto conn = std::make_shared<TcpConnection>(
+      libp2p::ProtoAddrVec{}, std::move(accepted), options);
+
+  Bytes data(4 << 20);
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = static_cast<uint8_t>(i * 7);
+  }
+  bool written = false;
+  libp2p::writeReturnSize(conn, data, [&](outcome::result<size_t> r) {
+    EXPECT_TRUE(r);
+    written = true;
+  });
+  Bytes received(data.size());
+  bool read = false;
+  boost::asio::async_read(client,
+                          boost::asio::buffer(received),
+                          [&](boost::system::error_code ec, size_t) {
+                            EXPECT_FALSE(ec);
+                            read = true;
+                          });
+
+  while (not(written and read) and context.run_one_for(2s) != 0) {
+  }
+  ASSERT_TRUE(written);
+  ASSERT_TRUE(read);
+  ASSERT_EQ(received, data);
+}
+
 int main(int argc, char *argv[]) {
   if (std::getenv("TRACE_DEBUG") != nullptr) {
     testutil::prepareLoggers(soralog::Level::TRACE);
@@ -40,8 +40,8 @@ struct TcpListenerTest : public ::testing::Test {
   multi::Multiaddress ma = "/ip4/127.0.0.1/tcp/40005"_multiaddr;
 
   void SetUp() override {
-    listener =
-        std::make_shared<TcpListener>(*context, upgrader, [this](auto &&r) {
+    listener = std::make_shared<TcpListener>(
+        *context, upgrader, nullptr, TcpSocketOptions{}, [this](auto &&r) {
           cb.Call(std::forward<decltype(r)>(r));
         });
   }
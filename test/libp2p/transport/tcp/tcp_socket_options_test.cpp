@@ -0,0 +1,77 @@
+/**
+ * Copyright Quadrivium LLC
+ * All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libp2p/transport/tcp/tcp_socket_options.hpp>
+
+#include <gtest/gtest.h>
+#include <libp2p/transport/socket_option.hpp>
+
+using boost::asio::ip::tcp;
+using libp2p::transport::applyBeforeConnect;
+using libp2p::transport::applyConnected;
+using libp2p::transport::IntegerSocketOption;
+using libp2p::transport::TcpSocketOptions;
+
+/**
+ * @given socket options with buffer sizes, no delay and keepalive
+ * @when they are applied to open socket
+ * @then socket reports these options
+ */
+TEST(TcpSocketOptionsTest, Apply) {
+  boost::asio::io_context context;
+  tcp::socket socket{context};
+  socket.open(tcp::v4());
+  TcpSocketOptions options{
+      .send_buffer = 1 << 16,
+      .receive_buffer = 1 << 16,
+      .keepalive = true,
+  };
+  applyBeforeConnect(socket, options);
+  applyConnected(socket, options);
+
+  tcp::no_delay no_delay;
+  socket.get_option(no_delay);
+  EXPECT_TRUE(no_delay.value());
+
+  boost::asio::socket_base::keep_alive keep_alive;
+  socket.get_option(keep_alive);
+  EXPECT_TRUE(keep_alive.value());
+
+  // kernel may round or double requested size
+  boost::asio::socket_base::send_buffer_size send_buffer;
+  socket.get_option(send_buffer);
+  EXPECT_GE(send_buffer.value(), options.send_buffer);
+}
+
+#if defined(TCP_KEEPIDLE) and defined(TCP_KEEPINTVL) and defined(TCP_KEEPCNT)
+/**
+ * @given socket options with keepalive timings
+ * @when they are applied to open socket
+ * @then socket reports these timings
+ */
+TEST(TcpSocketOptionsTest, KeepaliveTimings) {
+  boost::asio::io_context context;
+  tcp::socket socket{context};
+  socket.open(tcp::v4());
+  TcpSocketOptions options{
+      .keepalive = true,
+      .keepalive_idle = std::chrono::seconds{30},
+      .keepalive_interval = std::chrono::seconds{5},
+      .keepalive_count = 3,
+  };
+  applyConnected(socket, options);
+
+  IntegerSocketOption<IPPROTO_TCP, TCP_KEEPIDLE> idle;
+  socket.get_option(idle);
+  EXPECT_EQ(idle.value(), 30);
+  IntegerSocketOption<IPPROTO_TCP, TCP_KEEPINTVL> interval;
+  socket.get_option(interval);
+  EXPECT_EQ(interval.value(), 5);
+  IntegerSocketOption<IPPROTO_TCP, TCP_KEEPCNT> count;
+  socket.get_option(count);
+  EXPECT_EQ(count.value(), 3);
+}
+#endif
@@ -297,3 +297,96 @@ TEST_F(UpgraderTest, UpgradeMuxFail) {
     ASSERT_FALSE(upgraded_conn_res);
   });
 }
+
+/**
+ * @given security adaptors and muxer agreed on during security handshake
+ * @when upgrader is created and upgrades connection to muxed
+ * @then muxers are offered to security adaptors, and muxer is used without
+ * multiselect negotiation
+ */
+TEST_F(UpgraderTest, UpgradeMuxNegotiatedInHandshake) {
+  for (auto &adaptor : security_adaptors_) {
+    EXPECT_CALL(*std::static_pointer_cast<SecurityAdaptorMock>(adaptor),
+                offerMuxers(muxer_protos_));
+  }
+  upgrader_ = std::make_shared<UpgraderImpl>(
+      muxer_, layer_adaptors_, security_adaptors_, muxer_adaptors_);
+
+  EXPECT_CALL(*sec_conn_, negotiatedMuxer()).WillOnce(Return(muxer_protos_[1]));
+  EXPECT_CALL(*muxer_, selectOneOf(_, _, _, _, _)).Times(0);
+  EXPECT_CALL(
+      *std::static_pointer_cast<MuxerAdaptorMock>(muxer_adaptors_[1]),
+      muxConnection(std::static_pointer_cast<SecureConnection>(sec_conn_), _))
+      .WillOnce(Arg1CallbackWithArg(muxed_conn_));
+
+  bool upgraded = false;
+  upgrader_->upgradeToMuxed(sec_conn_, [&](auto &&upgraded_conn_res) {
+    ASSERT_TRUE(upgraded_conn_res);
+    ASSERT_EQ(upgraded_conn_res.value(), muxed_conn_);
+    upgraded = true;
+  });
+  ASSERT_TRUE(upgraded);
+}
+
+/**
+ * @given upgrader with optimistic security protocol
+ * @when outbound connection is secured and peer rejects the proposal
+ * @then handshake runs on lazily negotiated connection without multiselect
+ * round trips, and the next connection to the peer negotiates as usual
+ */
+TEST_F(UpgraderTest, UpgradeSecureOptimistic) {
+  setAllOutbound();
+  upgrader_ = std::make_shared<UpgraderImpl>(
+      muxer_,
+      layer_adaptors_,
+      security_adaptors_,
+      muxer_adaptors_,
+      UpgraderConfig{.optimistic_security = security_protos_[1]});
+  auto &adaptor =
+      *std::static_pointer_cast<SecurityAdaptorMock>(security_adaptors_[1]);
+
+  EXPECT_CALL(*muxer_,
+              lazyConnectionNegotiate(
+                  std::static_pointer_cast<LayerConnection>(raw_conn_),
+                  security_protos_[1]))
+      .WillOnce(Return(layer1_conn_));
+  EXPECT_CALL(
+      adaptor,
+      secureOutbound(
+          std::static_pointer_cast<LayerConnection>(layer1_conn_), peer_id_, _))
+      .WillOnce(Arg2CallbackWithArg(
+          make_error_code(ProtocolMuxer::Error::NEGOTIATION_FAILED)));
+  EXPECT_CALL(*muxer_, selectOneOf(_, _, _, _, _)).Times(0);
+
+  bool failed = false;
+  upgrader_->upgradeToSecureOutbound(
+      raw_conn_, peer_id_, [&](auto &&upgraded_conn_res) {
+        ASSERT_FALSE(upgraded_conn_res);
+        failed = true;
+      });
+  ASSERT_TRUE(failed);
+  testing::Mock::VerifyAndClearExpectations(muxer_.get());
+
+  EXPECT_CALL(*muxer_, lazyConnectionNegotiate(_, _)).Times(0);
+  EXPECT_CALL(*muxer_,
+              selectOneOf(_,
+                          std::static_pointer_cast<ReadWriter>(layer2_conn_),
+                          true,
+                          true,
+                          _))
+      .WillOnce(Arg4CallbackWithArg(security_protos_[1]));
+  EXPECT_CALL(
+      adaptor,
+      secureOutbound(
+          std::static_pointer_cast<LayerConnection>(layer2_conn_), peer_id_, _))
+      .WillOnce(Arg2CallbackWithArg(sec_conn_));
+
+  bool upgraded = false;
+  upgrader_->upgradeToSecureOutbound(
+      layer2_conn_, peer_id_, [&](auto &&upgraded_conn_res) {
+        ASSERT_TRUE(upgraded_conn_res);
+        ASSERT_EQ(upgraded_conn_res.value(), sec_conn_);
+        upgraded = true;
+      });
+  ASSERT_TRUE(upgraded);
+}
@@ -17,7 +17,11 @@ namespace libp2p::basic {
 
     MOCK_METHOD(Cancel,
                 scheduleImpl,
-                (Callback &&, std::chrono::milliseconds, bool),
+                (Callback &&,
+                 std::chrono::milliseconds,
+                 bool,
+                 Priority,
+                 const Origin &),
                 (override));
   };
 
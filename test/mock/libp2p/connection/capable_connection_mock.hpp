@@ -25,6 +25,11 @@ namespace libp2p::connection {
     MOCK_METHOD0(start, void());
     MOCK_METHOD0(stop, void());
 
+    MOCK_CONST_METHOD0(load, ConnectionLoad());
+
+    MOCK_CONST_METHOD0(supportsPing, bool());
+    MOCK_METHOD1(ping, void(PingHandlerFunc));
+
     MOCK_CONST_METHOD0(localPeer, outcome::result<peer::PeerId>());
     MOCK_CONST_METHOD0(remotePeer, outcome::result<peer::PeerId>());
     MOCK_CONST_METHOD0(remotePublicKey, outcome::result<crypto::PublicKey>());
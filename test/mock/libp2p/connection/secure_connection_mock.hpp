@@ -6,6 +6,8 @@
 
 #pragma once
 
+#include <boost/optional/optional_io.hpp>
+
 #include <libp2p/connection/secure_connection.hpp>
 
 #include <gmock/gmock.h>
@@ -43,5 +45,8 @@ namespace libp2p::connection {
 
     MOCK_CONST_METHOD0(remotePublicKey,
                        outcome::result<crypto::PublicKey>(void));
+
+    MOCK_CONST_METHOD0(negotiatedMuxer,
+                       boost::optional<peer::ProtocolName>(void));
   };
 }  // namespace libp2p::connection
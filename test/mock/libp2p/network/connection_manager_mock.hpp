@@ -34,6 +34,21 @@ namespace libp2p::network {
         onConnectionClosed,
         void(const peer::PeerId &peer_id,
              const std::shared_ptr<connection::CapableConnection> &conn));
+
+    MOCK_METHOD3(tagPeer,
+                 void(const peer::PeerId &, const std::string &, int));
+
+    MOCK_METHOD2(untagPeer, void(const peer::PeerId &, const std::string &));
+
+    MOCK_METHOD2(protect, void(const peer::PeerId &, const std::string &));
+
+    MOCK_METHOD2(unprotect, bool(const peer::PeerId &, const std::string &));
+
+    MOCK_CONST_METHOD1(isProtected, bool(const peer::PeerId &));
+
+    MOCK_METHOD2(setStripe, void(const peer::PeerId &, size_t));
+
+    MOCK_METHOD1(getStripedConnection, ConnectionSPtr(const peer::PeerId &));
   };
 
 }  // namespace libp2p::network
@@ -20,6 +20,10 @@ namespace libp2p::network {
                  void(const peer::PeerInfo &,
                       StreamProtocols,
                       StreamAndProtocolOrErrorCb));
+    MOCK_METHOD3(newStream,
+                 void(std::shared_ptr<connection::CapableConnection>,
+                      StreamProtocols,
+                      StreamAndProtocolOrErrorCb));
   };
 
 }  // namespace libp2p::network
@@ -39,10 +39,23 @@ namespace libp2p::peer {
                 (const PeerId &, const Multiaddress &),
                 (override));
 
+    MOCK_METHOD(void,
+                dialSucceeded,
+                (const PeerId &, const Multiaddress &, Milliseconds),
+                (override));
+
+    MOCK_METHOD(std::optional<DialStats>,
+                dialStats,
+                (const PeerId &, const Multiaddress &),
+                (const, override));
+
     MOCK_CONST_METHOD1(
         getAddresses,
         outcome::result<std::vector<multi::Multiaddress>>(const PeerId &));
 
+    MOCK_CONST_METHOD1(peekAddresses,
+                       std::span<const multi::Multiaddress>(const PeerId &));
+
     MOCK_METHOD1(clear, void(const PeerId &p));
 
     MOCK_CONST_METHOD0(getPeers, std::unordered_set<PeerId>());
@@ -17,6 +17,8 @@ namespace libp2p::peer {
 
     MOCK_CONST_METHOD0(getId, const peer::PeerId &());
     MOCK_CONST_METHOD0(getKeyPair, const crypto::KeyPair &());
+    MOCK_CONST_METHOD0(getSigningKey, const crypto::SigningKey &());
+    MOCK_CONST_METHOD0(getMarshalledPublicKey, const crypto::ProtobufKey &());
   };
 
 }  // namespace libp2p::peer
@@ -22,10 +22,10 @@ namespace libp2p::peer {
 
     MOCK_CONST_METHOD1(
         getProtocols,
-        outcome::result<std::vector<ProtocolName>>(const PeerId &));
+        outcome::result<std::vector<std::string_view>>(const PeerId &));
 
     MOCK_CONST_METHOD2(supportsProtocols,
-                       outcome::result<std::vector<ProtocolName>>(
+                       outcome::result<std::vector<std::string_view>>(
                            const PeerId &, const std::set<ProtocolName> &));
 
     MOCK_CONST_METHOD2(addProtocols,
@@ -28,5 +28,15 @@ namespace libp2p::protocol_muxer {
              const peer::ProtocolName &,
              std::function<
                  void(outcome::result<std::shared_ptr<connection::Stream>>)>));
+
+    MOCK_METHOD2(lazyStreamNegotiate,
+                 outcome::result<std::shared_ptr<connection::Stream>>(
+                     std::shared_ptr<connection::Stream>,
+                     const peer::ProtocolName &));
+
+    MOCK_METHOD2(lazyConnectionNegotiate,
+                 outcome::result<std::shared_ptr<connection::LayerConnection>>(
+                     std::shared_ptr<connection::LayerConnection>,
+                     const peer::ProtocolName &));
   };
 }  // namespace libp2p::protocol_muxer
@@ -24,5 +24,7 @@ namespace libp2p::security {
                  void(std::shared_ptr<connection::LayerConnection>,
                       const peer::PeerId &,
                       SecConnCallbackFunc));
+
+    MOCK_METHOD1(offerMuxers, void(std::vector<peer::ProtocolName>));
   };
 }  // namespace libp2p::security